@@ -2,11 +2,11 @@
 
 #include "intrinsic/assets/id_utils.h"
 
-#include <map>
+#include <cstddef>
+#include <optional>
 #include <string>
 #include <vector>
 
-#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
@@ -17,84 +17,239 @@
 #include "intrinsic/assets/proto/id.pb.h"
 #include "intrinsic/util/status/annotate.h"
 #include "intrinsic/util/status/status_macros.h"
-#include "re2/re2.h"
-#include "re2/stringpiece.h"
 
 namespace intrinsic::assets {
 namespace {
 
-static LazyRE2 kNameExpr = {R"((?P<name>^[a-z]([a-z0-9_]?[a-z0-9])*$))"};
-static LazyRE2 kPackageExpr = {
-    R"((?P<package>^([a-z]([a-z0-9_]?[a-z0-9])*\.)+([a-z]([a-z0-9_]?[a-z0-9])*)+$))"};
-// Taken from semver.org.
-static LazyRE2 kVersionExpr = {
-    R"((?P<version>^(?P<major>0|[1-9]\d*)\.(?P<minor>0|[1-9]\d*)\.(?P<patch>0|[1-9]\d*)(?:-(?P<prerelease>(?:0|[1-9]\d*|\d*[a-zA-Z-][0-9a-zA-Z-]*)(?:\.(?:0|[1-9]\d*|\d*[a-zA-Z-][0-9a-zA-Z-]*))*))?(?:\+(?P<buildmetadata>[0-9a-zA-Z-]+(?:\.[0-9a-zA-Z-]+)*))?$))"};
-static LazyRE2 kIdExpr = {
-    R"((?P<id>^(?P<package>([a-z]([a-z0-9_]?[a-z0-9])*\.)+[a-z]([a-z0-9_]?[a-z0-9])*)\.(?P<name>[a-z]([a-z0-9_]?[a-z0-9])*)$))"};
-static LazyRE2 kIdVersionExpr = {
-    R"((?P<id_version>^(?P<id>(?P<package>([a-z]([a-z0-9_]?[a-z0-9])*\.)+[a-z]([a-z0-9_]?[a-z0-9])*)\.(?P<name>[a-z]([a-z0-9_]?[a-z0-9])*))\.(?P<version>(?P<major>0|[1-9]\d*)\.(?P<minor>0|[1-9]\d*)\.(?P<patch>0|[1-9]\d*)(?:-(?P<prerelease>(?:0|[1-9]\d*|\d*[a-zA-Z-][0-9a-zA-Z-]*)(?:\.(?:0|[1-9]\d*|\d*[a-zA-Z-][0-9a-zA-Z-]*))*))?(?:\+(?P<buildmetadata>[0-9a-zA-Z-]+(?:\.[0-9a-zA-Z-]+)*))?)$))"};
-
-static LazyRE2 kLabelExpr = {R"(^[a-z]([a-z0-9-]*[a-z0-9])*$)"};
-
-// Verifies that the specified string matches the specified regex pattern.
-absl::Status ValidateMatch(absl::string_view str, const RE2 *re) {
-  if (!RE2::FullMatch(str, *re)) {
-    return absl::InvalidArgumentError(absl::StrFormat(
-        "'%s' is not a valid %s.", str, re->CapturingGroupNames().at(1)));
+// The parsers below implement the formats described in id_utils.h by hand, in a
+// single pass and without allocating, since ids are parsed on hot lookup paths.
+
+bool IsLowerAlpha(char c) { return c >= 'a' && c <= 'z'; }
+
+bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+bool IsLowerAlnum(char c) { return IsLowerAlpha(c) || IsDigit(c); }
+
+// [0-9a-zA-Z-]
+bool IsSemverChar(char c) {
+  return IsLowerAlnum(c) || (c >= 'A' && c <= 'Z') || c == '-';
+}
+
+// Splits `s` at the first occurrence of `c`. If there is none, `found` is
+// false and `rest` is empty, pointing to the end of `s`, so that it stays
+// within the parsed string like any other part.
+struct Split {
+  absl::string_view first;
+  absl::string_view rest;
+  bool found;
+};
+Split SplitAtFirst(absl::string_view s, char c) {
+  const size_t pos = s.find(c);
+  if (pos == absl::string_view::npos) {
+    return {.first = s, .rest = s.substr(s.size()), .found = false};
   }
-  return absl::OkStatus();
+  return {.first = s.substr(0, pos), .rest = s.substr(pos + 1), .found = true};
+}
+
+// Calls `is_valid` for each of the '.'-separated segments of `s` and returns
+// the number of segments, or 0 if `is_valid` returns false for any of them.
+template <typename IsValidFn>
+int CountValidSegments(absl::string_view s, IsValidFn is_valid) {
+  int count = 0;
+  while (true) {
+    const Split split = SplitAtFirst(s, '.');
+    if (!is_valid(split.first)) {
+      return 0;
+    }
+    ++count;
+    if (!split.found) {
+      return count;
+    }
+    s = split.rest;
+  }
+}
+
+// ^[a-z]([a-z0-9_]?[a-z0-9])*$
+bool ParseName(absl::string_view name) {
+  if (name.empty() || !IsLowerAlpha(name.front()) || name.back() == '_') {
+    return false;
+  }
+  for (size_t i = 1; i < name.size(); ++i) {
+    if (name[i] == '_') {
+      if (name[i - 1] == '_') {
+        return false;
+      }
+    } else if (!IsLowerAlnum(name[i])) {
+      return false;
+    }
+  }
+  return true;
 }
 
-// Matches a string to a regex pattern and returns the specified named group.
-absl::StatusOr<std::string> GetNamedMatch(absl::string_view str, const RE2 *re,
-                                          absl::string_view group) {
-  int num_groups = re->NumberOfCapturingGroups() + 1;
-  std::vector<re2::StringPiece> matches(num_groups);
-  if (!re->Match(str, 0, str.size(), RE2::Anchor::UNANCHORED, matches.data(),
-                 num_groups)) {
-    return absl::InvalidArgumentError(absl::StrFormat(
-        "'%s' is not a valid %s.", str, re->CapturingGroupNames().at(1)));
+// At least two names, separated by periods.
+bool ParsePackage(absl::string_view package) {
+  return CountValidSegments(package, ParseName) >= 2;
+}
+
+// 0|[1-9]\d*
+bool ParseNumericIdentifier(absl::string_view s) {
+  if (s.empty() || (s.size() > 1 && s.front() == '0')) {
+    return false;
   }
+  for (char c : s) {
+    if (!IsDigit(c)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 0|[1-9]\d*|\d*[a-zA-Z-][0-9a-zA-Z-]*
+bool ParsePreReleaseIdentifier(absl::string_view s) {
+  bool numeric = true;
+  for (char c : s) {
+    if (!IsSemverChar(c)) {
+      return false;
+    }
+    numeric = numeric && IsDigit(c);
+  }
+  return numeric ? ParseNumericIdentifier(s) : !s.empty();
+}
 
-  auto group_it = re->NamedCapturingGroups().find(std::string(group));
-  if (group_it == re->NamedCapturingGroups().end()) {
-    return absl::InternalError(absl::StrFormat("Unknown group '%s'.", group));
+// [0-9a-zA-Z-]+
+bool ParseBuildIdentifier(absl::string_view s) {
+  if (s.empty()) {
+    return false;
   }
+  for (char c : s) {
+    if (!IsSemverChar(c)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// A version as described by semver.org. On success, sets the version fields
+// of `view`.
+bool ParseVersion(absl::string_view version, IdVersionView &view) {
+  const Split build = SplitAtFirst(version, '+');
+  if (build.found &&
+      CountValidSegments(build.rest, ParseBuildIdentifier) == 0) {
+    return false;
+  }
+  // The version core consists of digits and periods only, so the first hyphen
+  // starts the pre-release.
+  const Split pre_release = SplitAtFirst(build.first, '-');
+  if (pre_release.found &&
+      CountValidSegments(pre_release.rest, ParsePreReleaseIdentifier) == 0) {
+    return false;
+  }
+  const Split major = SplitAtFirst(pre_release.first, '.');
+  const Split minor = SplitAtFirst(major.rest, '.');
+  const absl::string_view patch = minor.rest;
+  if (!major.found || !minor.found || !ParseNumericIdentifier(major.first) ||
+      !ParseNumericIdentifier(minor.first) || !ParseNumericIdentifier(patch)) {
+    return false;
+  }
+  view.version = version;
+  view.version_major = major.first;
+  view.version_minor = minor.first;
+  view.version_patch = patch;
+  view.version_pre_release = pre_release.rest;
+  view.version_build_metadata = build.rest;
+  return true;
+}
 
-  return std::string(matches.at(group_it->second));
+absl::Status InvalidError(absl::string_view str, absl::string_view what) {
+  return absl::InvalidArgumentError(
+      absl::StrFormat("'%s' is not a valid %s.", str, what));
+}
+
+// ^[a-z]([a-z0-9-]*[a-z0-9])*$
+bool IsLabel(absl::string_view label) {
+  if (label.empty() || !IsLowerAlpha(label.front()) || label.back() == '-') {
+    return false;
+  }
+  for (char c : label) {
+    if (!IsLowerAlnum(c) && c != '-') {
+      return false;
+    }
+  }
+  return true;
 }
 
 }  // namespace
 
-IdVersionParts::IdVersionParts(const std::vector<re2::StringPiece> *matches) {
-  const std::map<std::string, int> &groups =
-      kIdVersionExpr->NamedCapturingGroups();
+std::optional<IdView> IdView::Parse(absl::string_view id) {
+  const size_t last_period = id.rfind('.');
+  if (last_period == absl::string_view::npos) {
+    return std::nullopt;
+  }
+  IdView view = {.id = id,
+                 .package = id.substr(0, last_period),
+                 .name = id.substr(last_period + 1)};
+  if (!ParsePackage(view.package) || !ParseName(view.name)) {
+    return std::nullopt;
+  }
+  return view;
+}
 
-  id_ = std::string(matches->at(groups.at("id")));
-  id_version_ = std::string(matches->at(groups.at("id_version")));
-  name_ = std::string(matches->at(groups.at("name")));
-  package_ = std::string(matches->at(groups.at("package")));
-  version_ = std::string(matches->at(groups.at("version")));
-  version_build_metadata_ =
-      std::string(matches->at(groups.at("buildmetadata")));
-  version_major_ = std::string(matches->at(groups.at("major")));
-  version_minor_ = std::string(matches->at(groups.at("minor")));
-  version_patch_ = std::string(matches->at(groups.at("patch")));
-  version_pre_release_ = std::string(matches->at(groups.at("prerelease")));
+std::optional<IdVersionView> IdVersionView::Parse(
+    absl::string_view id_version) {
+  // Names start with a letter and versions with a digit, so the version starts
+  // after the first period that is followed by a digit.
+  size_t version_start = 0;
+  for (size_t i = 0; i + 1 < id_version.size(); ++i) {
+    if (id_version[i] == '.' && IsDigit(id_version[i + 1])) {
+      version_start = i + 1;
+      break;
+    }
+  }
+  if (version_start == 0) {
+    return std::nullopt;
+  }
+  std::optional<IdView> id =
+      IdView::Parse(id_version.substr(0, version_start - 1));
+  if (!id.has_value()) {
+    return std::nullopt;
+  }
+  IdVersionView view;
+  if (!ParseVersion(id_version.substr(version_start), view)) {
+    return std::nullopt;
+  }
+  view.id_version = id_version;
+  view.id = id->id;
+  view.package = id->package;
+  view.name = id->name;
+  return view;
+}
+
+IdVersionParts::IdVersionParts(const IdVersionView &view)
+    : id_version_(view.id_version) {
+  const auto range = [&view](absl::string_view part) {
+    return Range{.pos = static_cast<size_t>(part.data() -
+                                            view.id_version.data()),
+                 .size = part.size()};
+  };
+  id_ = range(view.id);
+  name_ = range(view.name);
+  package_ = range(view.package);
+  version_ = range(view.version);
+  version_build_metadata_ = range(view.version_build_metadata);
+  version_major_ = range(view.version_major);
+  version_minor_ = range(view.version_minor);
+  version_patch_ = range(view.version_patch);
+  version_pre_release_ = range(view.version_pre_release);
 }
 
 absl::StatusOr<IdVersionParts> IdVersionParts::Create(
     absl::string_view id_version) {
-  int num_groups = kIdVersionExpr->NumberOfCapturingGroups() + 1;
-  std::vector<re2::StringPiece> matches(num_groups);
-  if (!kIdVersionExpr->Match(id_version, 0, id_version.size(),
-                             RE2::Anchor::UNANCHORED, matches.data(),
-                             num_groups)) {
-    return absl::InvalidArgumentError(
-        absl::StrFormat("'%s' is not a valid id_version.", id_version));
+  std::optional<IdVersionView> view = IdVersionView::Parse(id_version);
+  if (!view.has_value()) {
+    return InvalidError(id_version, "id_version");
   }
 
-  return IdVersionParts(&matches);
+  return IdVersionParts(*view);
 }
 
 absl::StatusOr<std::string> IdFrom(absl::string_view package,
@@ -176,73 +331,93 @@ absl::StatusOr<std::string> IdVersionFromProto(
 }
 
 absl::StatusOr<std::string> NameFrom(absl::string_view id) {
-  absl::StatusOr<std::string> name_or_status =
-      GetNamedMatch(id, kIdVersionExpr.get(), /*group=*/"name");
-  if (name_or_status.ok()) {
-    return *name_or_status;
+  if (std::optional<IdVersionView> view = IdVersionView::Parse(id);
+      view.has_value()) {
+    return std::string(view->name);
   }
-
-  return GetNamedMatch(id, kIdExpr.get(), /*group=*/"name");
+  if (std::optional<IdView> view = IdView::Parse(id); view.has_value()) {
+    return std::string(view->name);
+  }
+  return InvalidError(id, "id");
 }
 
 absl::StatusOr<std::string> PackageFrom(absl::string_view id) {
-  absl::StatusOr<std::string> package_or_status =
-      GetNamedMatch(id, kIdVersionExpr.get(), /*group=*/"package");
-  if (package_or_status.ok()) {
-    return *package_or_status;
+  if (std::optional<IdVersionView> view = IdVersionView::Parse(id);
+      view.has_value()) {
+    return std::string(view->package);
   }
-
-  return GetNamedMatch(id, kIdExpr.get(), /*group=*/"package");
+  if (std::optional<IdView> view = IdView::Parse(id); view.has_value()) {
+    return std::string(view->package);
+  }
+  return InvalidError(id, "id");
 }
 
 absl::StatusOr<std::string> VersionFrom(absl::string_view id_version) {
-  return GetNamedMatch(id_version, kIdVersionExpr.get(), /*group=*/"version");
+  std::optional<IdVersionView> view = IdVersionView::Parse(id_version);
+  if (!view.has_value()) {
+    return InvalidError(id_version, "id_version");
+  }
+  return std::string(view->version);
 }
 
 absl::StatusOr<std::string> RemoveVersionFrom(absl::string_view id) {
-  auto id_or_status = GetNamedMatch(id, kIdVersionExpr.get(), /*group=*/"id");
-  if (id_or_status.ok()) {
-    return *id_or_status;
+  if (std::optional<IdVersionView> view = IdVersionView::Parse(id);
+      view.has_value()) {
+    return std::string(view->id);
   }
 
   INTR_RETURN_IF_ERROR(ValidateId(id));
   return std::string(id);
 }
 
-bool IsId(absl::string_view id) { return ValidateId(id).ok(); }
+bool IsId(absl::string_view id) { return IdView::Parse(id).has_value(); }
 
 bool IsIdVersion(absl::string_view id_version) {
-  return ValidateIdVersion(id_version).ok();
+  return IdVersionView::Parse(id_version).has_value();
 }
 
-bool IsName(absl::string_view name) { return ValidateName(name).ok(); }
+bool IsName(absl::string_view name) { return ParseName(name); }
 
-bool IsPackage(absl::string_view package) {
-  return ValidatePackage(package).ok();
-}
+bool IsPackage(absl::string_view package) { return ParsePackage(package); }
 
 bool IsVersion(absl::string_view version) {
-  return ValidateVersion(version).ok();
+  IdVersionView unused;
+  return ParseVersion(version, unused);
 }
 
 absl::Status ValidateId(absl::string_view id) {
-  return ValidateMatch(id, kIdExpr.get());
+  if (!IsId(id)) {
+    return InvalidError(id, "id");
+  }
+  return absl::OkStatus();
 }
 
 absl::Status ValidateIdVersion(absl::string_view id_version) {
-  return ValidateMatch(id_version, kIdVersionExpr.get());
+  if (!IsIdVersion(id_version)) {
+    return InvalidError(id_version, "id_version");
+  }
+  return absl::OkStatus();
 }
 
 absl::Status ValidateName(absl::string_view name) {
-  return ValidateMatch(name, kNameExpr.get());
+  if (!IsName(name)) {
+    return InvalidError(name, "name");
+  }
+  return absl::OkStatus();
 }
 
 absl::Status ValidatePackage(absl::string_view package) {
-  return ValidateMatch(package, kPackageExpr.get());
+  if (!IsPackage(package)) {
+    return InvalidError(package, "package");
+  }
+  return absl::OkStatus();
 }
 
 absl::Status ValidateVersion(absl::string_view version) {
-  return ValidateMatch(version, kVersionExpr.get());
+  if (!IsVersion(version)) {
+    return InvalidError(version, "version");
+  }
+  return absl::OkStatus();
 }
 
 std::string ParentFromPackage(absl::string_view package) {
@@ -265,7 +440,7 @@ absl::StatusOr<std::string> ToLabel(absl::string_view s) {
 
   std::string label = absl::StrReplaceAll(s, {{"_", "-"}, {".", "--"}});
 
-  if (!RE2::FullMatch(label, *kLabelExpr)) {
+  if (!IsLabel(label)) {
     return absl::InvalidArgumentError(
         absl::StrFormat("Cannot convert '%s' into a label", s));
   }
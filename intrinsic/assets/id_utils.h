@@ -3,17 +3,55 @@
 #ifndef INTRINSIC_ASSETS_ID_UTILS_H_
 #define INTRINSIC_ASSETS_ID_UTILS_H_
 
+#include <cstddef>
+#include <optional>
 #include <string>
-#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "intrinsic/assets/proto/id.pb.h"
-#include "re2/stringpiece.h"
 
 namespace intrinsic::assets {
 
+// Views of the parts of an id, pointing into the parsed string, which must
+// outlive the view.
+//
+// See IsId for details about id formatting.
+struct IdView {
+  // Parses `id` in a single pass, without allocating. Returns std::nullopt if
+  // `id` is not a valid id.
+  static std::optional<IdView> Parse(absl::string_view id);
+
+  absl::string_view id;
+  absl::string_view package;
+  absl::string_view name;
+};
+
+// Views of the parts of an id_version, pointing into the parsed string, which
+// must outlive the view. Unlike IdVersionParts, parsing one does not allocate,
+// which makes it the better choice for hot lookup paths.
+//
+// See IsIdVersion for details about id_version formatting.
+struct IdVersionView {
+  // Parses `id_version` in a single pass, without allocating. Returns
+  // std::nullopt if `id_version` is not a valid id_version.
+  static std::optional<IdVersionView> Parse(absl::string_view id_version);
+
+  absl::string_view id_version;
+  absl::string_view id;
+  absl::string_view package;
+  absl::string_view name;
+  absl::string_view version;
+  absl::string_view version_major;
+  absl::string_view version_minor;
+  absl::string_view version_patch;
+  // Empty if the version has no pre-release.
+  absl::string_view version_pre_release;
+  // Empty if the version has no build metadata.
+  absl::string_view version_build_metadata;
+};
+
 // Provides access to all of the parts of an id_version.
 //
 // See IsIdVersion for details about id_version formatting.
@@ -22,12 +60,12 @@ class IdVersionParts {
   // Creates a new IdVersionParts from an id_version string.
   static absl::StatusOr<IdVersionParts> Create(absl::string_view id_version);
 
-  absl::string_view Id() const { return id_; }
+  absl::string_view Id() const { return Part(id_); }
 
   intrinsic_proto::assets::Id IdProto() const {
     intrinsic_proto::assets::Id id_proto;
-    id_proto.set_package(package_);
-    id_proto.set_name(name_);
+    id_proto.set_package(Package());
+    id_proto.set_name(Name());
     return id_proto;
   }
 
@@ -36,41 +74,54 @@ class IdVersionParts {
   intrinsic_proto::assets::IdVersion IdVersionProto() const {
     intrinsic_proto::assets::IdVersion id_version_proto;
     *id_version_proto.mutable_id() = IdProto();
-    id_version_proto.set_version(version_);
+    id_version_proto.set_version(Version());
     return id_version_proto;
   }
 
-  absl::string_view Name() const { return name_; }
+  absl::string_view Name() const { return Part(name_); }
 
-  absl::string_view Package() const { return package_; }
+  absl::string_view Package() const { return Part(package_); }
 
-  absl::string_view Version() const { return version_; }
+  absl::string_view Version() const { return Part(version_); }
 
   absl::string_view VersionBuildMetadata() const {
-    return version_build_metadata_;
+    return Part(version_build_metadata_);
   }
 
-  absl::string_view VersionMajor() const { return version_major_; }
+  absl::string_view VersionMajor() const { return Part(version_major_); }
 
-  absl::string_view VersionMinor() const { return version_minor_; }
+  absl::string_view VersionMinor() const { return Part(version_minor_); }
 
-  absl::string_view VersionPatch() const { return version_patch_; }
+  absl::string_view VersionPatch() const { return Part(version_patch_); }
 
-  absl::string_view VersionPreRelease() const { return version_pre_release_; }
+  absl::string_view VersionPreRelease() const {
+    return Part(version_pre_release_);
+  }
 
  private:
-  explicit IdVersionParts(const std::vector<re2::StringPiece> *matches);
+  // The position of a part in `id_version_`. Positions rather than views, so
+  // that copies and moves need no fixing up.
+  struct Range {
+    size_t pos = 0;
+    size_t size = 0;
+  };
+
+  explicit IdVersionParts(const IdVersionView &view);
+
+  absl::string_view Part(Range range) const {
+    return absl::string_view(id_version_).substr(range.pos, range.size);
+  }
 
-  std::string id_;
   std::string id_version_;
-  std::string name_;
-  std::string package_;
-  std::string version_;
-  std::string version_build_metadata_;
-  std::string version_major_;
-  std::string version_minor_;
-  std::string version_patch_;
-  std::string version_pre_release_;
+  Range id_;
+  Range name_;
+  Range package_;
+  Range version_;
+  Range version_build_metadata_;
+  Range version_major_;
+  Range version_minor_;
+  Range version_patch_;
+  Range version_pre_release_;
 };
 
 // Creates an id from package and name strings.
@@ -0,0 +1,264 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/assets/id_utils.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/string_view.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "re2/re2.h"
+
+namespace intrinsic::assets {
+namespace {
+
+using ::intrinsic::testing::EqualsProto;
+using ::intrinsic::testing::IsOkAndHolds;
+using ::intrinsic::testing::StatusIs;
+
+// The regular expressions that defined the formats before they were parsed
+// by hand. The parsers must accept exactly the same language.
+constexpr absl::string_view kNamePattern = R"([a-z]([a-z0-9_]?[a-z0-9])*)";
+constexpr absl::string_view kPackagePattern =
+    R"(([a-z]([a-z0-9_]?[a-z0-9])*\.)+([a-z]([a-z0-9_]?[a-z0-9])*)+)";
+constexpr absl::string_view kVersionPattern =
+    R"((0|[1-9]\d*)\.(0|[1-9]\d*)\.(0|[1-9]\d*))"
+    R"((?:-((?:0|[1-9]\d*|\d*[a-zA-Z-][0-9a-zA-Z-]*))"
+    R"((?:\.(?:0|[1-9]\d*|\d*[a-zA-Z-][0-9a-zA-Z-]*))*))?)"
+    R"((?:\+([0-9a-zA-Z-]+(?:\.[0-9a-zA-Z-]+)*))?)";
+constexpr absl::string_view kLabelPattern = R"([a-z]([a-z0-9-]*[a-z0-9])*)";
+
+// Calls `fn` with every string of up to `max_length` characters of
+// `alphabet`.
+void ForEachString(absl::string_view alphabet, int max_length,
+                   const std::function<void(const std::string&)>& fn) {
+  std::vector<std::string> current = {""};
+  fn("");
+  for (int length = 1; length <= max_length; ++length) {
+    std::vector<std::string> next;
+    next.reserve(current.size() * alphabet.size());
+    for (const std::string& prefix : current) {
+      for (char c : alphabet) {
+        next.push_back(prefix + c);
+        fn(next.back());
+      }
+    }
+    current = std::move(next);
+  }
+}
+
+TEST(IdUtilsTest, IsNameMatchesRegex) {
+  const RE2 re(kNamePattern);
+  ForEachString("a0_B-.", 6, [&re](const std::string& name) {
+    EXPECT_EQ(IsName(name), RE2::FullMatch(name, re)) << name;
+  });
+}
+
+TEST(IdUtilsTest, IsPackageMatchesRegex) {
+  const RE2 re(kPackagePattern);
+  ForEachString("a0_.", 8, [&re](const std::string& package) {
+    EXPECT_EQ(IsPackage(package), RE2::FullMatch(package, re)) << package;
+  });
+}
+
+TEST(IdUtilsTest, IsVersionMatchesRegex) {
+  const RE2 re(kVersionPattern);
+  ForEachString("01.-+aA", 7, [&re](const std::string& version) {
+    EXPECT_EQ(IsVersion(version), RE2::FullMatch(version, re)) << version;
+  });
+  // Longer versions that the enumeration does not reach.
+  for (const std::string version :
+       {"1.2.3-alpha.1+build.5", "1.2.3-0a.b-c", "10.20.30-00", "1.2.3-01",
+        "1.2.3-0", "1.2.3+001", "1.2.3-rc.01", "1.2.3-+", "1.2.3-a..b",
+        "1.2.3+a..b", "1.2.3+a.", "1.2.3-.a", "01.2.3", "1.2.3.4"}) {
+    EXPECT_EQ(IsVersion(version), RE2::FullMatch(version, re)) << version;
+  }
+}
+
+TEST(IdUtilsTest, IsIdMatchesRegex) {
+  const RE2 re(absl::StrCat("(", kPackagePattern, R"()\.()", kNamePattern,
+                            ")"));
+  ForEachString("a0_.", 8, [&re](const std::string& id) {
+    EXPECT_EQ(IsId(id), RE2::FullMatch(id, re)) << id;
+  });
+}
+
+TEST(IdUtilsTest, IsIdVersionMatchesRegex) {
+  const RE2 re(absl::StrCat("(", kPackagePattern, R"()\.()", kNamePattern,
+                            R"()\.()", kVersionPattern, ")"));
+  for (absl::string_view id :
+       {"ai.intrinsic.foo", "ai.intrinsic.foo_bar", "ai.intrinsic.foo__bar",
+        "ai.intrinsic_.foo", "a1.b2.c3", "ai.foo", "ai..foo",
+        "ai.intrinsic.1"}) {
+    ForEachString("01.-+a", 6, [&re, id](const std::string& version) {
+      const std::string id_version = absl::StrCat(id, ".", version);
+      EXPECT_EQ(IsIdVersion(id_version), RE2::FullMatch(id_version, re))
+          << id_version;
+    });
+  }
+}
+
+TEST(IdUtilsTest, ToLabelMatchesRegex) {
+  const RE2 re(kLabelPattern);
+  ForEachString("a0_.-", 6, [&re](const std::string& s) {
+    const std::string label =
+        absl::StrReplaceAll(s, {{"_", "-"}, {".", "--"}});
+    const bool convertible =
+        !absl::StrContains(s, "-") && !absl::StrContains(s, "_.") &&
+        !absl::StrContains(s, "._") && !absl::StrContains(s, "__") &&
+        RE2::FullMatch(label, re);
+    absl::StatusOr<std::string> result = ToLabel(s);
+    ASSERT_EQ(result.ok(), convertible) << s;
+    if (convertible) {
+      EXPECT_EQ(*result, label);
+      EXPECT_EQ(FromLabel(*result), s);
+    }
+  });
+}
+
+TEST(IdUtilsTest, Names) {
+  EXPECT_TRUE(IsName("foo"));
+  EXPECT_TRUE(IsName("foo_bar"));
+  EXPECT_TRUE(IsName("f1_2"));
+  EXPECT_FALSE(IsName(""));
+  EXPECT_FALSE(IsName("foo__bar"));
+  EXPECT_FALSE(IsName("foo_"));
+  EXPECT_FALSE(IsName("_foo"));
+  EXPECT_FALSE(IsName("1foo"));
+  EXPECT_FALSE(IsName("Foo"));
+  EXPECT_FALSE(IsName("foo-bar"));
+  EXPECT_THAT(ValidateName("foo__bar"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(IdUtilsTest, Packages) {
+  EXPECT_TRUE(IsPackage("ai.intrinsic"));
+  EXPECT_TRUE(IsPackage("ai.intrinsic.my_package"));
+  EXPECT_FALSE(IsPackage("ai"));
+  EXPECT_FALSE(IsPackage("ai."));
+  EXPECT_FALSE(IsPackage(".ai.intrinsic"));
+  EXPECT_FALSE(IsPackage("ai..intrinsic"));
+  EXPECT_FALSE(IsPackage("ai.intrinsic__x"));
+  EXPECT_FALSE(IsPackage("ai.1ntrinsic"));
+  EXPECT_EQ(ParentFromPackage("ai.intrinsic.foo"), "ai.intrinsic");
+  EXPECT_EQ(ParentFromPackage("ai.intrinsic"), "");
+}
+
+TEST(IdUtilsTest, Versions) {
+  EXPECT_TRUE(IsVersion("0.0.0"));
+  EXPECT_TRUE(IsVersion("1.2.3-alpha.1"));
+  EXPECT_TRUE(IsVersion("1.2.3+build.5"));
+  EXPECT_TRUE(IsVersion("1.2.3-alpha+build"));
+  EXPECT_FALSE(IsVersion("1.2.3-"));
+  EXPECT_FALSE(IsVersion("1.2.3+"));
+  EXPECT_FALSE(IsVersion("1.2.3-+build"));
+  EXPECT_FALSE(IsVersion("1.2.3-alpha."));
+  EXPECT_FALSE(IsVersion("1.2.3+build..5"));
+  EXPECT_FALSE(IsVersion("1.2.3-01"));
+  EXPECT_FALSE(IsVersion("1.2"));
+  EXPECT_FALSE(IsVersion("1.02.3"));
+}
+
+TEST(IdVersionPartsTest, WithoutPreReleaseOrBuildMetadata) {
+  ASSERT_OK_AND_ASSIGN(IdVersionParts parts,
+                       IdVersionParts::Create("ai.intrinsic.foo.1.0.0"));
+  EXPECT_EQ(parts.IdVersion(), "ai.intrinsic.foo.1.0.0");
+  EXPECT_EQ(parts.Id(), "ai.intrinsic.foo");
+  EXPECT_EQ(parts.Package(), "ai.intrinsic");
+  EXPECT_EQ(parts.Name(), "foo");
+  EXPECT_EQ(parts.Version(), "1.0.0");
+  EXPECT_EQ(parts.VersionMajor(), "1");
+  EXPECT_EQ(parts.VersionMinor(), "0");
+  EXPECT_EQ(parts.VersionPatch(), "0");
+  EXPECT_EQ(parts.VersionPreRelease(), "");
+  EXPECT_EQ(parts.VersionBuildMetadata(), "");
+}
+
+TEST(IdVersionPartsTest, AllParts) {
+  ASSERT_OK_AND_ASSIGN(
+      IdVersionParts parts,
+      IdVersionParts::Create("ai.intrinsic.my_pkg.foo_bar.10.20.30-rc.1+b.7"));
+  EXPECT_EQ(parts.Id(), "ai.intrinsic.my_pkg.foo_bar");
+  EXPECT_EQ(parts.Package(), "ai.intrinsic.my_pkg");
+  EXPECT_EQ(parts.Name(), "foo_bar");
+  EXPECT_EQ(parts.Version(), "10.20.30-rc.1+b.7");
+  EXPECT_EQ(parts.VersionMajor(), "10");
+  EXPECT_EQ(parts.VersionMinor(), "20");
+  EXPECT_EQ(parts.VersionPatch(), "30");
+  EXPECT_EQ(parts.VersionPreRelease(), "rc.1");
+  EXPECT_EQ(parts.VersionBuildMetadata(), "b.7");
+  EXPECT_THAT(parts.IdProto(), EqualsProto(R"pb(package: "ai.intrinsic.my_pkg"
+                                                 name: "foo_bar")pb"));
+  EXPECT_THAT(parts.IdVersionProto(),
+              EqualsProto(R"pb(id { package: "ai.intrinsic.my_pkg"
+                                    name: "foo_bar" }
+                               version: "10.20.30-rc.1+b.7")pb"));
+}
+
+TEST(IdVersionPartsTest, OnlyPreReleaseOrOnlyBuildMetadata) {
+  ASSERT_OK_AND_ASSIGN(IdVersionParts pre_release,
+                       IdVersionParts::Create("ai.intrinsic.foo.1.2.3-beta"));
+  EXPECT_EQ(pre_release.VersionPatch(), "3");
+  EXPECT_EQ(pre_release.VersionPreRelease(), "beta");
+  EXPECT_EQ(pre_release.VersionBuildMetadata(), "");
+
+  ASSERT_OK_AND_ASSIGN(
+      IdVersionParts build,
+      IdVersionParts::Create("ai.intrinsic.foo.1.2.3+exp.sha"));
+  EXPECT_EQ(build.VersionPatch(), "3");
+  EXPECT_EQ(build.VersionPreRelease(), "");
+  EXPECT_EQ(build.VersionBuildMetadata(), "exp.sha");
+}
+
+TEST(IdVersionPartsTest, SurvivesCopiesAndMoves) {
+  ASSERT_OK_AND_ASSIGN(IdVersionParts parts,
+                       IdVersionParts::Create("ai.intrinsic.foo.1.2.3-beta"));
+  IdVersionParts copy = parts;
+  IdVersionParts moved = std::move(parts);
+  EXPECT_EQ(copy.Name(), "foo");
+  EXPECT_EQ(copy.VersionPreRelease(), "beta");
+  EXPECT_EQ(moved.Package(), "ai.intrinsic");
+  EXPECT_EQ(moved.VersionBuildMetadata(), "");
+}
+
+TEST(IdVersionPartsTest, RejectsInvalid) {
+  for (absl::string_view id_version :
+       {"", "ai.intrinsic.foo", "ai.intrinsic.foo.1.0", "ai.foo__bar.1.0.0",
+        "ai.intrinsic.foo.1.0.0-", "ai.intrinsic.foo.1.0.0+",
+        "ai.intrinsic.foo.1.0.0-a..b", "intrinsic.1.0.0",
+        "ai.intrinsic.1.0.0"}) {
+    EXPECT_THAT(IdVersionParts::Create(id_version),
+                StatusIs(absl::StatusCode::kInvalidArgument))
+        << id_version;
+  }
+}
+
+TEST(IdUtilsTest, FromParts) {
+  EXPECT_THAT(IdFrom("ai.intrinsic", "foo"), IsOkAndHolds("ai.intrinsic.foo"));
+  EXPECT_THAT(IdFrom("ai", "foo"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(IdVersionFrom("ai.intrinsic", "foo", "1.0.0+b"),
+              IsOkAndHolds("ai.intrinsic.foo.1.0.0+b"));
+  EXPECT_THAT(IdVersionFrom("ai.intrinsic", "foo", "1.0"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(NameFrom("ai.intrinsic.foo.1.0.0"), IsOkAndHolds("foo"));
+  EXPECT_THAT(PackageFrom("ai.intrinsic.foo"), IsOkAndHolds("ai.intrinsic"));
+  EXPECT_THAT(VersionFrom("ai.intrinsic.foo.1.0.0-a"), IsOkAndHolds("1.0.0-a"));
+  EXPECT_THAT(RemoveVersionFrom("ai.intrinsic.foo.1.0.0"),
+              IsOkAndHolds("ai.intrinsic.foo"));
+  EXPECT_THAT(RemoveVersionFrom("ai.intrinsic.foo"),
+              IsOkAndHolds("ai.intrinsic.foo"));
+}
+
+}  // namespace
+}  // namespace intrinsic::assets
@@ -0,0 +1,142 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_EIGENMATH_FAST_ROTATION_UTILS_H_
+#define INTRINSIC_EIGENMATH_FAST_ROTATION_UTILS_H_
+
+#include <cmath>
+#include <cstddef>
+
+#include "intrinsic/eigenmath/types.h"
+
+// Variants of rotation_utils.h functions for hot loops, e.g. in real-time
+// control, that trade trigonometric calls and branches for short polynomials.
+// They are branch free, and their errors are bounded as documented. Use the
+// exact versions wherever these bounds are not good enough.
+
+namespace intrinsic {
+namespace eigenmath {
+
+namespace fast_rotation_internal {
+
+// Evaluates the polynomial with the given coefficients, lowest order first,
+// at `x`.
+template <typename T, size_t N>
+T Horner(const double (&coefficients)[N], T x) {
+  T result(coefficients[N - 1]);
+  for (size_t i = N - 1; i > 0; --i) {
+    result = result * x + T(coefficients[i - 1]);
+  }
+  return result;
+}
+
+// Taylor coefficients in x^2 of cos(x), up to x^18. For |x| <= pi/2 the error
+// is below 4e-15.
+inline constexpr double kCos[] = {
+    1.0,
+    -1.0 / 2,
+    1.0 / 24,
+    -1.0 / 720,
+    1.0 / 40320,
+    -1.0 / 3628800,
+    1.0 / 479001600,
+    -1.0 / 87178291200,
+    1.0 / 20922789888000,
+    -1.0 / 6402373705728000,
+};
+
+// Taylor coefficients in x^2 of sin(x) / x, up to x^18. For |x| <= pi/2 the
+// error is below 2e-16.
+inline constexpr double kSinc[] = {
+    1.0,
+    -1.0 / 6,
+    1.0 / 120,
+    -1.0 / 5040,
+    1.0 / 362880,
+    -1.0 / 39916800,
+    1.0 / 6227020800,
+    -1.0 / 1307674368000,
+    1.0 / 355687428096000,
+    -1.0 / 121645100408832000,
+};
+
+// Taylor coefficients in x^2 of atan(x) / x, up to x^32. For
+// |x| <= tan(pi/8) the error is below 2e-14.
+inline constexpr double kAtanOverX[] = {
+    1.0,        -1.0 / 3,  1.0 / 5,  -1.0 / 7,  1.0 / 9,  -1.0 / 11,
+    1.0 / 13,   -1.0 / 15, 1.0 / 17, -1.0 / 19, 1.0 / 21, -1.0 / 23,
+    1.0 / 25,   -1.0 / 27, 1.0 / 29, -1.0 / 31, 1.0 / 33,
+};
+
+}  // namespace fast_rotation_internal
+
+// Same as QuaternionToAngleAxisVector(), without trigonometric calls and
+// without a branch for small angles. `quaternion` need not be normalized.
+//
+// The angle is computed as 8 * atan(x) with x <= tan(pi/8), after halving it
+// twice with square roots, which keeps the polynomial short. The absolute
+// error is below 1e-13 for any rotation in double precision, and of the order
+// of the machine epsilon in single precision.
+template <typename T, int Options>
+Vector3<T> FastQuaternionToAngleAxisVector(
+    const Quaternion<T, Options>& quaternion) {
+  using std::sqrt;
+  // We choose the quaternion with positive 'w', i.e., the one with a smaller
+  // angle that represents this orientation. Multiplying by the sign avoids a
+  // branch.
+  const T sign = quaternion.w() < T(0) ? T(-1) : T(1);
+  const T w = sign * quaternion.w();
+  const Vector3<T> vec = sign * quaternion.vec();
+  const T s = vec.norm();
+  // atan2(s, w) = 2 * atan2(s, n + w) = 4 * atan2(s, m + n + w), where n and m
+  // are the norms of (s, w) and (s, n + w).
+  const T n = sqrt(s * s + w * w);
+  const T d = sqrt(s * s + (n + w) * (n + w)) + n + w;
+  const T x = s / d;
+  // angle = 2 * atan2(s, w) = 8 * x * atan(x) / x, and the result is
+  // vec * angle / s = vec * 8 * atan(x) / x / d, which is well defined for
+  // s = 0.
+  const T scale =
+      T(8) * fast_rotation_internal::Horner(
+                 fast_rotation_internal::kAtanOverX, x * x) /
+      d;
+  return scale * vec;
+}
+
+// Returns the quaternion of the rotation with the given angle-axis vector,
+// like Quaternion(AngleTimesAxisToAngleAxis(angle_times_axis)), without
+// trigonometric calls and without a branch for small angles.
+//
+// The quaternion is computed from sin and cos of a quarter of the angle with
+// the double angle formulas. The absolute error of its components is below
+// 1e-13 for angles up to 2 * pi in double precision. Larger angles are not
+// reduced and lose accuracy quickly.
+template <typename T>
+Quaternion<T> FastAngleAxisVectorToQuaternion(
+    const Vector3<T>& angle_times_axis) {
+  // q = angle / 4, so that half of the angle is 2 * q.
+  const T q_squared = angle_times_axis.squaredNorm() / T(16);
+  const T cos_q =
+      fast_rotation_internal::Horner(fast_rotation_internal::kCos, q_squared);
+  const T sinc_q =
+      fast_rotation_internal::Horner(fast_rotation_internal::kSinc, q_squared);
+  // cos(2q) = 1 - 2 sin(q)^2, and sin(2q) / (2q) = sinc(q) * cos(q).
+  const T w = T(1) - T(2) * q_squared * sinc_q * sinc_q;
+  const Vector3<T> vec = (T(0.5) * sinc_q * cos_q) * angle_times_axis;
+  return Quaternion<T>(w, vec.x(), vec.y(), vec.z());
+}
+
+// Normalizes `quaternion` with a single Newton step for 1 / norm, without a
+// square root or a division. Meant for quaternions that drifted slightly from
+// unit length, e.g. after a few compositions: if |norm^2 - 1| = e, the norm of
+// the result differs from 1 by at most 3/8 * e^2 + O(e^3). Use normalize()
+// for quaternions that may be far from unit length.
+template <typename T, int Options>
+void FastNormalizeQuaternion(Quaternion<T, Options>& quaternion) {
+  const T squared_norm = quaternion.squaredNorm();
+  quaternion.coeffs() *= T(0.5) * (T(3) - squared_norm);
+}
+
+}  // namespace eigenmath
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_EIGENMATH_FAST_ROTATION_UTILS_H_
@@ -0,0 +1,109 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+// Compares the fast rotation functions with their exact versions.
+//
+// Run with:
+//   bazel run -c opt //intrinsic/eigenmath:fast_rotation_utils_benchmark
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "intrinsic/eigenmath/fast_rotation_utils.h"
+#include "intrinsic/eigenmath/rotation_utils.h"
+#include "intrinsic/eigenmath/types.h"
+
+namespace intrinsic {
+namespace eigenmath {
+namespace {
+
+// Cycling through more inputs than fit in a branch predictor keeps the exact
+// versions from being measured with perfectly predicted branches.
+constexpr size_t kNumInputs = 4096;
+
+std::vector<Quaterniond> RandomQuaternions() {
+  std::mt19937 rng(1);
+  std::normal_distribution<double> normal;
+  std::vector<Quaterniond> quaternions;
+  for (size_t i = 0; i < kNumInputs; ++i) {
+    quaternions.push_back(
+        Quaterniond(normal(rng), normal(rng), normal(rng), normal(rng))
+            .normalized());
+  }
+  return quaternions;
+}
+
+std::vector<Vector3d> RandomAngleAxisVectors() {
+  std::vector<Vector3d> vectors;
+  for (const Quaterniond& quaternion : RandomQuaternions()) {
+    vectors.push_back(QuaternionToAngleAxisVector(quaternion));
+  }
+  return vectors;
+}
+
+void BM_QuaternionToAngleAxisVector(benchmark::State& state) {
+  const std::vector<Quaterniond> quaternions = RandomQuaternions();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        QuaternionToAngleAxisVector(quaternions[i++ % kNumInputs]));
+  }
+}
+BENCHMARK(BM_QuaternionToAngleAxisVector);
+
+void BM_FastQuaternionToAngleAxisVector(benchmark::State& state) {
+  const std::vector<Quaterniond> quaternions = RandomQuaternions();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        FastQuaternionToAngleAxisVector(quaternions[i++ % kNumInputs]));
+  }
+}
+BENCHMARK(BM_FastQuaternionToAngleAxisVector);
+
+void BM_AngleAxisVectorToQuaternion(benchmark::State& state) {
+  const std::vector<Vector3d> vectors = RandomAngleAxisVectors();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Quaterniond(
+        AngleTimesAxisToAngleAxis(vectors[i++ % kNumInputs])));
+  }
+}
+BENCHMARK(BM_AngleAxisVectorToQuaternion);
+
+void BM_FastAngleAxisVectorToQuaternion(benchmark::State& state) {
+  const std::vector<Vector3d> vectors = RandomAngleAxisVectors();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        FastAngleAxisVectorToQuaternion(vectors[i++ % kNumInputs]));
+  }
+}
+BENCHMARK(BM_FastAngleAxisVectorToQuaternion);
+
+void BM_NormalizeQuaternion(benchmark::State& state) {
+  std::vector<Quaterniond> quaternions = RandomQuaternions();
+  size_t i = 0;
+  for (auto _ : state) {
+    Quaterniond& quaternion = quaternions[i++ % kNumInputs];
+    quaternion.normalize();
+    benchmark::DoNotOptimize(quaternion);
+  }
+}
+BENCHMARK(BM_NormalizeQuaternion);
+
+void BM_FastNormalizeQuaternion(benchmark::State& state) {
+  std::vector<Quaterniond> quaternions = RandomQuaternions();
+  size_t i = 0;
+  for (auto _ : state) {
+    Quaterniond& quaternion = quaternions[i++ % kNumInputs];
+    FastNormalizeQuaternion(quaternion);
+    benchmark::DoNotOptimize(quaternion);
+  }
+}
+BENCHMARK(BM_FastNormalizeQuaternion);
+
+}  // namespace
+}  // namespace eigenmath
+}  // namespace intrinsic
@@ -0,0 +1,130 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/eigenmath/fast_rotation_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "intrinsic/eigenmath/rotation_utils.h"
+#include "intrinsic/eigenmath/types.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic {
+namespace eigenmath {
+namespace {
+
+constexpr int kNumSamples = 100000;
+
+Quaterniond RandomQuaternion(std::mt19937& rng) {
+  std::normal_distribution<double> normal;
+  return Quaterniond(normal(rng), normal(rng), normal(rng), normal(rng))
+      .normalized();
+}
+
+TEST(FastQuaternionToAngleAxisVectorTest, MatchesExactVersion) {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> scale(0.1, 10.0);
+  double max_error = 0;
+  for (int i = 0; i < kNumSamples; ++i) {
+    const Quaterniond quaternion = RandomQuaternion(rng);
+    Quaterniond scaled = quaternion;
+    scaled.coeffs() *= scale(rng);
+    max_error = std::max(
+        max_error, (FastQuaternionToAngleAxisVector(scaled) -
+                    QuaternionToAngleAxisVector(quaternion))
+                       .norm());
+  }
+  EXPECT_LT(max_error, 1e-14) << max_error;
+}
+
+TEST(FastQuaternionToAngleAxisVectorTest, SmallAndLimitAngles) {
+  EXPECT_EQ(FastQuaternionToAngleAxisVector(Quaterniond::Identity()),
+            Vector3d::Zero());
+  const Vector3d tiny(1e-12, -2e-12, 3e-12);
+  EXPECT_LT((FastQuaternionToAngleAxisVector(
+                 Quaterniond(1, tiny.x() / 2, tiny.y() / 2, tiny.z() / 2)) -
+             tiny)
+                .norm(),
+            1e-25);
+  // A rotation by pi, for which w = 0.
+  EXPECT_LT((FastQuaternionToAngleAxisVector(Quaterniond(0, 1, 0, 0)) -
+             Vector3d(M_PI, 0, 0))
+                .norm(),
+            1e-13);
+  // Both quaternions of a rotation give the same vector.
+  const Quaterniond quaternion(-0.5, 0.5, 0.5, 0.5);
+  const Quaterniond negated(0.5, -0.5, -0.5, -0.5);
+  EXPECT_LT((FastQuaternionToAngleAxisVector(quaternion) -
+             FastQuaternionToAngleAxisVector(negated))
+                .norm(),
+            1e-15);
+}
+
+TEST(FastQuaternionToAngleAxisVectorTest, Float) {
+  std::mt19937 rng(2);
+  float max_error = 0;
+  for (int i = 0; i < kNumSamples; ++i) {
+    const Quaterniond quaternion = RandomQuaternion(rng);
+    const Quaternionf quaternion_f = quaternion.cast<float>();
+    max_error = std::max(
+        max_error, (FastQuaternionToAngleAxisVector(quaternion_f) -
+                    QuaternionToAngleAxisVector(quaternion).cast<float>())
+                       .norm());
+  }
+  EXPECT_LT(max_error, 1e-5f);
+}
+
+TEST(FastAngleAxisVectorToQuaternionTest, MatchesExactVersion) {
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<double> angle(0, 2 * M_PI);
+  double max_error = 0;
+  for (int i = 0; i < kNumSamples; ++i) {
+    const Vector3d angle_times_axis =
+        angle(rng) * RandomQuaternion(rng).vec().normalized();
+    const Quaterniond exact(AngleTimesAxisToAngleAxis(angle_times_axis));
+    max_error = std::max(
+        max_error,
+        (FastAngleAxisVectorToQuaternion(angle_times_axis).coeffs() -
+         exact.coeffs())
+            .cwiseAbs()
+            .maxCoeff());
+  }
+  EXPECT_LT(max_error, 1e-14) << max_error;
+}
+
+TEST(FastAngleAxisVectorToQuaternionTest, InvertsFastLog) {
+  std::mt19937 rng(4);
+  for (int i = 0; i < 1000; ++i) {
+    Quaterniond quaternion = RandomQuaternion(rng);
+    if (quaternion.w() < 0) {
+      quaternion.coeffs() *= -1;
+    }
+    const Quaterniond round_trip = FastAngleAxisVectorToQuaternion(
+        FastQuaternionToAngleAxisVector(quaternion));
+    EXPECT_LT((round_trip.coeffs() - quaternion.coeffs()).norm(), 1e-12);
+  }
+  EXPECT_EQ(FastAngleAxisVectorToQuaternion(Vector3d(0, 0, 0)).coeffs(),
+            Quaterniond::Identity().coeffs());
+}
+
+TEST(FastNormalizeQuaternionTest, ErrorIsQuadratic) {
+  std::mt19937 rng(5);
+  for (const double drift : {1e-8, 1e-6, 1e-4, 1e-3}) {
+    double max_error = 0;
+    for (int i = 0; i < 1000; ++i) {
+      Quaterniond quaternion = RandomQuaternion(rng);
+      quaternion.coeffs() *= std::sqrt(1 + drift);
+      FastNormalizeQuaternion(quaternion);
+      max_error = std::max(max_error, std::abs(quaternion.norm() - 1));
+    }
+    EXPECT_LE(max_error, 0.375 * drift * drift * 1.01 + 1e-15)
+        << "drift " << drift;
+  }
+}
+
+}  // namespace
+}  // namespace eigenmath
+}  // namespace intrinsic
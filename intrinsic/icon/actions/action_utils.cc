@@ -2,17 +2,24 @@
 
 #include "intrinsic/icon/actions/action_utils.h"
 
+#include <memory>
 #include <string>
 #include <utility>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "google/protobuf/descriptor.pb.h"
 #include "intrinsic/icon/proto/types.pb.h"
 #include "intrinsic/icon/release/source_location.h"
+#include "intrinsic/util/status/status_macros.h"
 
 namespace intrinsic {
 namespace icon {
@@ -24,6 +31,41 @@ struct FeatureInterfaceNameFormatter {
     absl::StrAppend(out, intrinsic_proto::icon::FeatureInterfaceTypes_Name(t));
   }
 };
+
+// Signatures from GetOrBuildActionSignature(), keyed by action type name.
+class ActionSignatureCache {
+ public:
+  static ActionSignatureCache& Get() {
+    static auto* cache = new ActionSignatureCache();
+    return *cache;
+  }
+
+  std::shared_ptr<const intrinsic_proto::icon::ActionSignature> Find(
+      absl::string_view action_type_name) const ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    auto it = signatures_.find(action_type_name);
+    return it == signatures_.end() ? nullptr : it->second;
+  }
+
+  // Inserts `signature` unless there is one for its action type already, and
+  // returns the signature in the cache.
+  std::shared_ptr<const intrinsic_proto::icon::ActionSignature> Insert(
+      std::shared_ptr<const intrinsic_proto::icon::ActionSignature> signature)
+      ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    return signatures_
+        .try_emplace(signature->action_type_name(), std::move(signature))
+        .first->second;
+  }
+
+ private:
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<
+      std::string,
+      std::shared_ptr<const intrinsic_proto::icon::ActionSignature>>
+      signatures_ ABSL_GUARDED_BY(mutex_);
+};
+
 }  // namespace
 
 absl::Status ActionSignatureBuilder::SetFixedParametersTypeImpl(
@@ -99,5 +141,26 @@ absl::Status ActionSignatureBuilder::AddRealtimeSignal(
   return absl::OkStatus();
 }
 
+absl::StatusOr<std::shared_ptr<const intrinsic_proto::icon::ActionSignature>>
+GetOrBuildActionSignature(
+    absl::string_view action_type_name,
+    absl::FunctionRef<absl::StatusOr<intrinsic_proto::icon::ActionSignature>()>
+        build) {
+  ActionSignatureCache& cache = ActionSignatureCache::Get();
+  if (auto signature = cache.Find(action_type_name); signature != nullptr) {
+    return signature;
+  }
+  INTR_ASSIGN_OR_RETURN(intrinsic_proto::icon::ActionSignature signature,
+                        build());
+  if (signature.action_type_name() != action_type_name) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Expected the signature of action type \"", action_type_name,
+        "\", but got one of \"", signature.action_type_name(), "\""));
+  }
+  return cache.Insert(
+      std::make_shared<const intrinsic_proto::icon::ActionSignature>(
+          std::move(signature)));
+}
+
 }  // namespace icon
 }  // namespace intrinsic
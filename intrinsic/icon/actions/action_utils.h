@@ -3,12 +3,15 @@
 #ifndef INTRINSIC_ICON_ACTIONS_ACTION_UTILS_H_
 #define INTRINSIC_ICON_ACTIONS_ACTION_UTILS_H_
 
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <utility>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "google/protobuf/descriptor.pb.h"
@@ -180,6 +183,35 @@ class ActionSignatureBuilder {
   absl::flat_hash_set<std::string> realtime_signal_names_;
 };
 
+// Returns the signature of the action type `action_type_name`, which `build`
+// creates. Only the first successful call for an action type in this process
+// runs `build`; later calls share its signature, including its descriptor
+// sets. Use this wherever a signature is requested repeatedly, e.g.:
+//
+//   absl::StatusOr<std::shared_ptr<const ActionSignature>>
+//   MyActionSignature() {
+//     return GetOrBuildActionSignature(
+//         MyActionInfo::kActionTypeName,
+//         []() -> absl::StatusOr<ActionSignature> {
+//           ActionSignatureBuilder builder(MyActionInfo::kActionTypeName,
+//                                          MyActionInfo::kActionDescription);
+//           INTR_RETURN_IF_ERROR(
+//               builder.SetFixedParametersType<MyActionInfo::FixedParams>());
+//           return builder.Finish();
+//         });
+//   }
+//
+// Errors of `build` are returned and not cached. Returns InvalidArgumentError
+// if `build` returns the signature of a different action type.
+//
+// Thread safe. `build` runs without holding a lock, so concurrent first calls
+// may each run it; all of them return the same signature.
+absl::StatusOr<std::shared_ptr<const intrinsic_proto::icon::ActionSignature>>
+GetOrBuildActionSignature(
+    absl::string_view action_type_name,
+    absl::FunctionRef<absl::StatusOr<intrinsic_proto::icon::ActionSignature>()>
+        build);
+
 }  // namespace icon
 }  // namespace intrinsic
 
@@ -9,15 +9,26 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "google/protobuf/field_mask.pb.h"
 #include "grpcpp/client_context.h"
 #include "intrinsic/icon/cc_client/operational_status.h"
+#include "intrinsic/icon/cc_client/operational_status_watcher.h"
+#include "intrinsic/icon/cc_client/reaction_watcher.h"
 #include "intrinsic/icon/cc_client/robot_config.h"
+#include "intrinsic/icon/cc_client/session.h"
+#include "intrinsic/icon/cc_client/state_variable_snapshot.h"
+#include "intrinsic/icon/cc_client/state_variable_watcher.h"
+#include "intrinsic/icon/cc_client/status_watcher.h"
 #include "intrinsic/icon/common/part_properties.h"
 #include "intrinsic/icon/common/slot_part_map.h"
 #include "intrinsic/icon/control/logging_mode.h"
@@ -25,6 +36,7 @@
 #include "intrinsic/icon/proto/service.pb.h"
 #include "intrinsic/icon/proto/types.pb.h"
 #include "intrinsic/icon/release/grpc_time_support.h"
+#include "intrinsic/logging/proto/context.pb.h"
 #include "intrinsic/util/grpc/channel_interface.h"
 #include "intrinsic/util/proto_time.h"
 #include "intrinsic/util/status/status_conversion_grpc.h"
@@ -34,12 +46,78 @@
 namespace intrinsic {
 namespace icon {
 
+struct Client::Cache {
+  // Drops all cached data.
+  void Clear() ABSL_LOCKS_EXCLUDED(mutex) {
+    absl::MutexLock lock(&mutex);
+    config.reset();
+    action_signatures.reset();
+    action_signatures_by_name.clear();
+    part_compatibility.clear();
+    slot_part_map_compatibility.clear();
+    compatible_parts.clear();
+  }
+
+  absl::Mutex mutex;
+  std::optional<RobotConfig> config ABSL_GUARDED_BY(mutex);
+  // The complete, sorted result of ListActionSignatures(), if it was called.
+  std::optional<std::vector<intrinsic_proto::icon::ActionSignature>>
+      action_signatures ABSL_GUARDED_BY(mutex);
+  absl::flat_hash_map<std::string, intrinsic_proto::icon::ActionSignature>
+      action_signatures_by_name ABSL_GUARDED_BY(mutex);
+  // Keyed by part name and action type name.
+  absl::flat_hash_map<std::pair<std::string, std::string>, bool>
+      part_compatibility ABSL_GUARDED_BY(mutex);
+  // Keyed by action type name followed by the slots and parts of the
+  // SlotPartMap, in order.
+  absl::flat_hash_map<std::vector<std::string>, bool>
+      slot_part_map_compatibility ABSL_GUARDED_BY(mutex);
+  // Keyed by the action type names of the request, in order.
+  absl::flat_hash_map<std::vector<std::string>, std::vector<std::string>>
+      compatible_parts ABSL_GUARDED_BY(mutex);
+};
+
+struct Client::SharedReactionWatcher {
+  // Returns the ReactionWatcher of the live Sessions, or a new one if there
+  // are none.
+  std::shared_ptr<ReactionWatcher> Get() ABSL_LOCKS_EXCLUDED(mutex) {
+    absl::MutexLock lock(&mutex);
+    std::shared_ptr<ReactionWatcher> shared = watcher.lock();
+    if (shared == nullptr) {
+      shared = ReactionWatcher::Create();
+      watcher = shared;
+    }
+    return shared;
+  }
+
+  absl::Mutex mutex;
+  // Owned by the Sessions, so that its thread only runs while there are any.
+  std::weak_ptr<ReactionWatcher> watcher ABSL_GUARDED_BY(mutex);
+};
+
+namespace {
+
+std::vector<std::string> SlotPartMapCompatibilityKey(
+    const SlotPartMap& slot_part_map, absl::string_view action_type_name) {
+  std::vector<std::string> key;
+  key.reserve(1 + 2 * slot_part_map.size());
+  key.emplace_back(action_type_name);
+  for (const auto& [slot, part] : slot_part_map) {
+    key.push_back(slot);
+    key.push_back(part);
+  }
+  return key;
+}
+
+}  // namespace
+
 Client::Client(std::shared_ptr<ChannelInterface> icon_channel)
     : channel_(icon_channel),
       stub_(
           intrinsic_proto::icon::IconApi::NewStub(icon_channel->GetChannel())),
       timeout_(kClientDefaultTimeout),
-      client_context_factory_(icon_channel->GetClientContextFactory()) {}
+      client_context_factory_(icon_channel->GetClientContextFactory()),
+      reaction_watcher_(std::make_unique<SharedReactionWatcher>()) {}
 
 Client::Client(
     std::unique_ptr<intrinsic_proto::icon::IconApi::StubInterface> stub,
@@ -49,8 +127,48 @@ Client::Client(
       timeout_(kClientDefaultTimeout),
       client_context_factory_(std::move(client_context_factory)) {}
 
+Client::~Client() = default;
+Client::Client(Client&& other) = default;
+Client& Client::operator=(Client&& other) = default;
+
+void Client::EnableCache() {
+  if (cache_ == nullptr) {
+    cache_ = std::make_unique<Cache>();
+  }
+}
+
+void Client::InvalidateCache() const {
+  if (cache_ != nullptr) {
+    cache_->Clear();
+  }
+}
+
+absl::Status Client::PrefetchCache() const {
+  if (cache_ == nullptr) {
+    return absl::FailedPreconditionError(
+        "The cache is disabled, call EnableCache() first.");
+  }
+  // Both calls fill the cache.
+  INTR_RETURN_IF_ERROR(ListActionSignatures().status());
+  return GetConfig().status();
+}
+
 absl::StatusOr<intrinsic_proto::icon::ActionSignature>
 Client::GetActionSignatureByName(absl::string_view action_type_name) const {
+  if (cache_ != nullptr) {
+    absl::MutexLock lock(&cache_->mutex);
+    if (auto it = cache_->action_signatures_by_name.find(action_type_name);
+        it != cache_->action_signatures_by_name.end()) {
+      return it->second;
+    }
+    // The list of all signatures is complete, so there is nothing to ask the
+    // server.
+    if (cache_->action_signatures.has_value()) {
+      return absl::NotFoundError(
+          absl::StrCat("Could not get action signature: action type \"",
+                       action_type_name, "\" not found."));
+    }
+  }
   std::unique_ptr<::grpc::ClientContext> context = client_context_factory_();
   context->set_deadline(::grpc::DeadlineFromDuration(timeout_));
   intrinsic_proto::icon::GetActionSignatureByNameRequest request;
@@ -64,17 +182,33 @@ Client::GetActionSignatureByName(absl::string_view action_type_name) const {
         absl::StrCat("Could not get action signature: action type \"",
                      action_type_name, "\" not found."));
   }
+  if (cache_ != nullptr) {
+    absl::MutexLock lock(&cache_->mutex);
+    cache_->action_signatures_by_name.insert_or_assign(
+        std::string(action_type_name), response.action_signature());
+  }
   return response.action_signature();
 }
 
 absl::StatusOr<RobotConfig> Client::GetConfig() const {
+  if (cache_ != nullptr) {
+    absl::MutexLock lock(&cache_->mutex);
+    if (cache_->config.has_value()) {
+      return *cache_->config;
+    }
+  }
   std::unique_ptr<::grpc::ClientContext> context = client_context_factory_();
   context->set_deadline(::grpc::DeadlineFromDuration(timeout_));
   intrinsic_proto::icon::GetConfigRequest request;
   intrinsic_proto::icon::GetConfigResponse response;
   INTR_RETURN_IF_ERROR(
       ToAbslStatus(stub_->GetConfig(context.get(), request, &response)));
-  return RobotConfig(response);
+  RobotConfig config(std::move(response));
+  if (cache_ != nullptr) {
+    absl::MutexLock lock(&cache_->mutex);
+    cache_->config = config;
+  }
+  return config;
 }
 
 absl::StatusOr<intrinsic_proto::icon::GetStatusResponse> Client::GetStatus()
@@ -101,15 +235,35 @@ absl::StatusOr<intrinsic_proto::icon::PartStatus> Client::GetSinglePartStatus(
   return part_status_it->second;
 }
 
+absl::StatusOr<std::unique_ptr<StatusWatcher>> Client::WatchStatus(
+    absl::Span<const std::string> part_names,
+    const google::protobuf::FieldMask& fields, absl::Duration period,
+    StatusWatcher::UpdateCallback callback) const {
+  return StatusWatcher::Create(
+      stub_.get(), client_context_factory_, part_names, fields, period,
+      [this]() { return GetStatus(); }, std::move(callback));
+}
+
 absl::Status Client::RestartServer() const {
   std::unique_ptr<::grpc::ClientContext> context = client_context_factory_();
   context->set_deadline(::grpc::DeadlineFromDuration(timeout_));
   google::protobuf::Empty resp;
-  return ToAbslStatus(stub_->RestartServer(context.get(), {}, &resp));
+  INTR_RETURN_IF_ERROR(
+      ToAbslStatus(stub_->RestartServer(context.get(), {}, &resp)));
+  InvalidateCache();
+  return absl::OkStatus();
 }
 
 absl::StatusOr<bool> Client::IsActionCompatible(
     absl::string_view part_name, absl::string_view action_type_name) const {
+  std::pair<std::string, std::string> cache_key(part_name, action_type_name);
+  if (cache_ != nullptr) {
+    absl::MutexLock lock(&cache_->mutex);
+    if (auto it = cache_->part_compatibility.find(cache_key);
+        it != cache_->part_compatibility.end()) {
+      return it->second;
+    }
+  }
   std::unique_ptr<::grpc::ClientContext> context = client_context_factory_();
   context->set_deadline(::grpc::DeadlineFromDuration(timeout_));
   intrinsic_proto::icon::IsActionCompatibleRequest request;
@@ -120,12 +274,26 @@ absl::StatusOr<bool> Client::IsActionCompatible(
   intrinsic_proto::icon::IsActionCompatibleResponse response;
   INTR_RETURN_IF_ERROR(ToAbslStatus(
       stub_->IsActionCompatible(context.get(), request, &response)));
+  if (cache_ != nullptr) {
+    absl::MutexLock lock(&cache_->mutex);
+    cache_->part_compatibility.insert_or_assign(std::move(cache_key),
+                                                response.is_compatible());
+  }
   return response.is_compatible();
 }
 
 absl::StatusOr<bool> Client::IsActionCompatible(
     const SlotPartMap& slot_part_map,
     absl::string_view action_type_name) const {
+  std::vector<std::string> cache_key =
+      SlotPartMapCompatibilityKey(slot_part_map, action_type_name);
+  if (cache_ != nullptr) {
+    absl::MutexLock lock(&cache_->mutex);
+    if (auto it = cache_->slot_part_map_compatibility.find(cache_key);
+        it != cache_->slot_part_map_compatibility.end()) {
+      return it->second;
+    }
+  }
   std::unique_ptr<::grpc::ClientContext> context = client_context_factory_();
   context->set_deadline(::grpc::DeadlineFromDuration(timeout_));
   intrinsic_proto::icon::IsActionCompatibleRequest request;
@@ -135,11 +303,22 @@ absl::StatusOr<bool> Client::IsActionCompatible(
   intrinsic_proto::icon::IsActionCompatibleResponse response;
   INTR_RETURN_IF_ERROR(ToAbslStatus(
       stub_->IsActionCompatible(context.get(), request, &response)));
+  if (cache_ != nullptr) {
+    absl::MutexLock lock(&cache_->mutex);
+    cache_->slot_part_map_compatibility.insert_or_assign(
+        std::move(cache_key), response.is_compatible());
+  }
   return response.is_compatible();
 }
 
 absl::StatusOr<std::vector<intrinsic_proto::icon::ActionSignature>>
 Client::ListActionSignatures() const {
+  if (cache_ != nullptr) {
+    absl::MutexLock lock(&cache_->mutex);
+    if (cache_->action_signatures.has_value()) {
+      return *cache_->action_signatures;
+    }
+  }
   std::unique_ptr<::grpc::ClientContext> context = client_context_factory_();
   context->set_deadline(::grpc::DeadlineFromDuration(timeout_));
   intrinsic_proto::icon::ListActionSignaturesRequest request;
@@ -158,11 +337,28 @@ Client::ListActionSignatures() const {
         }
         return a.action_type_name() < b.action_type_name();
       });
+  if (cache_ != nullptr) {
+    absl::MutexLock lock(&cache_->mutex);
+    for (const intrinsic_proto::icon::ActionSignature& signature : out) {
+      cache_->action_signatures_by_name.insert_or_assign(
+          signature.action_type_name(), signature);
+    }
+    cache_->action_signatures = out;
+  }
   return out;
 }
 
 absl::StatusOr<std::vector<std::string>> Client::ListCompatibleParts(
     absl::Span<const std::string> action_type_names) const {
+  std::vector<std::string> cache_key(action_type_names.begin(),
+                                     action_type_names.end());
+  if (cache_ != nullptr) {
+    absl::MutexLock lock(&cache_->mutex);
+    if (auto it = cache_->compatible_parts.find(cache_key);
+        it != cache_->compatible_parts.end()) {
+      return it->second;
+    }
+  }
   std::unique_ptr<::grpc::ClientContext> context = client_context_factory_();
   context->set_deadline(::grpc::DeadlineFromDuration(timeout_));
   intrinsic_proto::icon::ListCompatiblePartsRequest request;
@@ -171,8 +367,13 @@ absl::StatusOr<std::vector<std::string>> Client::ListCompatibleParts(
   intrinsic_proto::icon::ListCompatiblePartsResponse response;
   INTR_RETURN_IF_ERROR(ToAbslStatus(
       stub_->ListCompatibleParts(context.get(), request, &response)));
-  return std::vector<std::string>(response.parts().begin(),
-                                  response.parts().end());
+  std::vector<std::string> parts(response.parts().begin(),
+                                 response.parts().end());
+  if (cache_ != nullptr) {
+    absl::MutexLock lock(&cache_->mutex);
+    cache_->compatible_parts.insert_or_assign(std::move(cache_key), parts);
+  }
+  return parts;
 }
 
 absl::StatusOr<std::vector<std::string>> Client::ListParts() const {
@@ -206,7 +407,10 @@ absl::Status Client::ClearFaults() const {
   context->set_deadline(::grpc::DeadlineFromDuration(timeout_));
   intrinsic_proto::icon::ClearFaultsRequest req;
   intrinsic_proto::icon::ClearFaultsResponse resp;
-  return ToAbslStatus(stub_->ClearFaults(context.get(), req, &resp));
+  INTR_RETURN_IF_ERROR(
+      ToAbslStatus(stub_->ClearFaults(context.get(), req, &resp)));
+  InvalidateCache();
+  return absl::OkStatus();
 }
 
 absl::StatusOr<OperationalStatus> Client::GetOperationalStatus() const {
@@ -219,6 +423,66 @@ absl::StatusOr<OperationalStatus> Client::GetOperationalStatus() const {
   return FromProto(resp.operational_status());
 }
 
+absl::StatusOr<std::unique_ptr<OperationalStatusWatcher>>
+Client::WatchOperationalStatus(
+    absl::Duration retry_period,
+    OperationalStatusWatcher::ChangeCallback callback) const {
+  return OperationalStatusWatcher::Create(
+      stub_.get(), client_context_factory_,
+      [this]() { return GetOperationalStatus(); }, retry_period,
+      std::move(callback));
+}
+
+absl::StatusOr<StateVariableIndex> Client::CompileStateVariables(
+    absl::Span<const std::string> paths) const {
+  if (paths.empty()) {
+    return absl::InvalidArgumentError("No state variable paths to compile");
+  }
+  std::unique_ptr<::grpc::ClientContext> context = client_context_factory_();
+  context->set_deadline(::grpc::DeadlineFromDuration(timeout_));
+  intrinsic_proto::icon::CompileStateVariablesRequest req;
+  req.mutable_state_variable_paths()->Add(paths.begin(), paths.end());
+  intrinsic_proto::icon::CompileStateVariablesResponse resp;
+  INTR_RETURN_IF_ERROR(
+      ToAbslStatus(stub_->CompileStateVariables(context.get(), req, &resp)));
+  return StateVariableIndex::FromProto(
+      std::vector<std::string>(paths.begin(), paths.end()), resp);
+}
+
+absl::StatusOr<StateVariableSnapshot> Client::ReadStateVariables(
+    const StateVariableIndex& index) const {
+  std::unique_ptr<::grpc::ClientContext> context = client_context_factory_();
+  context->set_deadline(::grpc::DeadlineFromDuration(timeout_));
+  intrinsic_proto::icon::ReadStateVariablesRequest req;
+  req.set_index_handle(index.handle());
+  intrinsic_proto::icon::ReadStateVariablesResponse resp;
+  INTR_RETURN_IF_ERROR(
+      ToAbslStatus(stub_->ReadStateVariables(context.get(), req, &resp)));
+  StateVariableSnapshot snapshot;
+  INTR_RETURN_IF_ERROR(FromProto(resp, index, snapshot));
+  return snapshot;
+}
+
+absl::StatusOr<std::unique_ptr<StateVariableWatcher>>
+Client::WatchStateVariables(StateVariableIndex index, absl::Duration period,
+                            StateVariableWatcher::Callback callback) const {
+  return StateVariableWatcher::Create(stub_.get(), client_context_factory_,
+                                      std::move(index), period,
+                                      std::move(callback));
+}
+
+absl::StatusOr<std::unique_ptr<Session>> Client::StartSession(
+    absl::Span<const std::string> parts,
+    const intrinsic_proto::data_logger::Context& context,
+    std::optional<absl::Time> deadline) const {
+  if (channel_ == nullptr || reaction_watcher_ == nullptr) {
+    return absl::FailedPreconditionError(
+        "StartSession() requires a Client constructed from a channel");
+  }
+  return Session::Start(channel_, reaction_watcher_->Get(), parts, context,
+                        deadline);
+}
+
 absl::Status Client::SetSpeedOverride(double new_speed_override) {
   std::unique_ptr<::grpc::ClientContext> context = client_context_factory_();
   context->set_deadline(::grpc::DeadlineFromDuration(timeout_));
@@ -246,6 +510,18 @@ absl::Status Client::SetLoggingMode(LoggingMode logging_mode) const {
   return ToAbslStatus(stub_->SetLoggingMode(context.get(), req, &resp));
 }
 
+absl::Status Client::SetLoggingMode(
+    LoggingMode logging_mode, const LoggingPolicy& logging_policy) const {
+  intrinsic_proto::icon::SetLoggingModeRequest req;
+  req.set_logging_mode(ToProto(logging_mode));
+  INTR_ASSIGN_OR_RETURN(*req.mutable_logging_policy(),
+                        ToProto(logging_policy));
+  std::unique_ptr<::grpc::ClientContext> context = client_context_factory_();
+  context->set_deadline(::grpc::DeadlineFromDuration(timeout_));
+  intrinsic_proto::icon::SetLoggingModeResponse resp;
+  return ToAbslStatus(stub_->SetLoggingMode(context.get(), req, &resp));
+}
+
 absl::StatusOr<LoggingMode> Client::GetLoggingMode() const {
   std::unique_ptr<::grpc::ClientContext> context = client_context_factory_();
   context->set_deadline(::grpc::DeadlineFromDuration(timeout_));
@@ -255,6 +531,15 @@ absl::StatusOr<LoggingMode> Client::GetLoggingMode() const {
   return FromProto(resp.logging_mode());
 }
 
+absl::StatusOr<LoggingPolicy> Client::GetLoggingPolicy() const {
+  std::unique_ptr<::grpc::ClientContext> context = client_context_factory_();
+  context->set_deadline(::grpc::DeadlineFromDuration(timeout_));
+  intrinsic_proto::icon::GetLoggingModeResponse resp;
+  INTR_RETURN_IF_ERROR(ToAbslStatus(stub_->GetLoggingMode(
+      context.get(), intrinsic_proto::icon::GetLoggingModeRequest(), &resp)));
+  return FromProto(resp.logging_policy());
+}
+
 absl::Status Client::SetPartProperties(
     const PartPropertyMap& property_map) const {
   std::unique_ptr<::grpc::ClientContext> context = client_context_factory_();
@@ -14,8 +14,14 @@
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "google/protobuf/field_mask.pb.h"
 #include "intrinsic/icon/cc_client/operational_status.h"
+#include "intrinsic/icon/cc_client/operational_status_watcher.h"
 #include "intrinsic/icon/cc_client/robot_config.h"
+#include "intrinsic/icon/cc_client/session.h"
+#include "intrinsic/icon/cc_client/state_variable_snapshot.h"
+#include "intrinsic/icon/cc_client/state_variable_watcher.h"
+#include "intrinsic/icon/cc_client/status_watcher.h"
 #include "intrinsic/icon/common/part_properties.h"
 #include "intrinsic/icon/common/slot_part_map.h"
 #include "intrinsic/icon/control/logging_mode.h"
@@ -23,6 +29,7 @@
 #include "intrinsic/icon/proto/service.grpc.pb.h"
 #include "intrinsic/icon/proto/service.pb.h"
 #include "intrinsic/icon/proto/types.pb.h"
+#include "intrinsic/logging/proto/context.pb.h"
 #include "intrinsic/util/grpc/channel_interface.h"
 #include "intrinsic/world/robot_payload/robot_payload.h"
 
@@ -57,6 +64,35 @@ class Client {
       ClientContextFactory client_context_factory =
           DefaultClientContextFactory);
 
+  ~Client();
+  Client(Client&& other);
+  Client& operator=(Client&& other);
+
+  // Makes the Client cache data that only changes when the server restarts:
+  // action signatures (GetActionSignatureByName(), ListActionSignatures()),
+  // the robot config (GetConfig()) and action compatibility
+  // (IsActionCompatible(), ListCompatibleParts()). Later calls return cached data instead of making a
+  // request where possible. Errors are not cached.
+  //
+  // RestartServer() and ClearFaults() invalidate the cache. Since a restart is
+  // delayed while sessions are open, call InvalidateCache() again once the
+  // server is back, and whenever it may have restarted for other reasons.
+  //
+  // Must be called before the Client is shared between threads. All other
+  // methods, including the cache-related ones below, are thread-safe.
+  void EnableCache();
+
+  // Drops all cached data. No-op if the cache is disabled.
+  void InvalidateCache() const;
+
+  // Fills the cache with all action signatures and the robot config, using two
+  // requests. GetActionSignatureByName() then answers all queries from the
+  // cache, including those for unknown action types.
+  //
+  // Returns FailedPreconditionError if the cache is disabled. Propagates gRPC
+  // communication errors.
+  absl::Status PrefetchCache() const;
+
   // Makes a request to the server to get an Action Sigature by action type
   // name.
   //
@@ -113,6 +149,33 @@ class Client {
   absl::StatusOr<intrinsic_proto::icon::PartStatus> GetSinglePartStatus(
       absl::string_view part_name) const;
 
+  // Watches the status of the Parts `part_names` (or of all Parts, if empty),
+  // and calls `callback` with only the fields that changed, see
+  // StatusWatcher. `fields` restricts the watched fields of PartStatus, e.g.
+  // to "joint_states"; all fields are watched if it is empty.
+  //
+  // The server sends only the changes over a single stream, so a monitoring
+  // process neither fetches nor handles the full status. Servers without the
+  // stream are polled with GetStatus() once per `period` instead.
+  //
+  // The watcher must not outlive this Client, and this Client must not be
+  // moved while the watcher exists.
+  //
+  // Example:
+  //
+  //  google::protobuf::FieldMask fields;
+  //  fields.add_paths("joint_states");
+  //  INTR_ASSIGN_OR_RETURN(
+  //      std::unique_ptr<StatusWatcher> watcher,
+  //      icon_client.WatchStatus({"robot_arm"}, fields, absl::Milliseconds(20),
+  //                              [](const PartStatusUpdate& update) {
+  //                                LOG(INFO) << update.status;
+  //                              }));
+  absl::StatusOr<std::unique_ptr<StatusWatcher>> WatchStatus(
+      absl::Span<const std::string> part_names,
+      const google::protobuf::FieldMask& fields, absl::Duration period,
+      StatusWatcher::UpdateCallback callback) const;
+
   // Makes a request to the server to determine if action type
   // `action_type_name` is compatible with part `part_name`.
   absl::StatusOr<bool> IsActionCompatible(
@@ -189,17 +252,101 @@ class Client {
   // Returns the operational state of the server.
   absl::StatusOr<OperationalStatus> GetOperationalStatus() const;
 
+  // Watches the operational state of the server, and calls `callback` (if not
+  // null) with every change, see OperationalStatusWatcher. Use this instead of
+  // polling GetOperationalStatus() to react to faults quickly.
+  //
+  // The server streams changes as they happen. Servers that cannot are polled
+  // every `retry_period`, which is also the delay before a broken stream is
+  // reopened.
+  //
+  // The watcher must not outlive this Client, and this Client must not be
+  // moved while the watcher exists.
+  //
+  // Example:
+  //
+  //  INTR_ASSIGN_OR_RETURN(
+  //      std::unique_ptr<OperationalStatusWatcher> watcher,
+  //      icon_client.WatchOperationalStatus(
+  //          absl::Seconds(1), [](const OperationalStatus& status) {
+  //            if (IsFaulted(status)) LOG(ERROR) << status;
+  //          }));
+  absl::StatusOr<std::unique_ptr<OperationalStatusWatcher>>
+  WatchOperationalStatus(
+      absl::Duration retry_period,
+      OperationalStatusWatcher::ChangeCallback callback = nullptr) const;
+
+  // Compiles the state variable `paths` (see state_variable_path.h) into an
+  // index on the server, so that their values can be read in one request with
+  // ReadStateVariables() or WatchStateVariables(). Compile the paths once and
+  // reuse the index for every read.
+  //
+  // Returns InvalidArgumentError if `paths` is empty or any path is malformed,
+  // and NotFoundError if a path refers to an unknown part or field.
+  // Propagates gRPC communication errors.
+  absl::StatusOr<StateVariableIndex> CompileStateVariables(
+      absl::Span<const std::string> paths) const;
+
+  // Returns the current values of the state variables of `index`, all sampled
+  // in the same control cycle.
+  //
+  // Returns NotFoundError if the server does not know the index, e.g. because
+  // it restarted since CompileStateVariables(). Propagates gRPC communication
+  // errors.
+  absl::StatusOr<StateVariableSnapshot> ReadStateVariables(
+      const StateVariableIndex& index) const;
+
+  // Samples the values of the state variables of `index` every `period` in
+  // the background, and calls `callback` (if not null) with each snapshot, see
+  // StateVariableWatcher. Use this instead of calling ReadStateVariables() in
+  // a loop to monitor signals.
+  //
+  // The watcher must not outlive this Client, and this Client must not be
+  // moved while the watcher exists.
+  //
+  // Returns InvalidArgumentError if `period` is not positive.
+  absl::StatusOr<std::unique_ptr<StateVariableWatcher>> WatchStateVariables(
+      StateVariableIndex index, absl::Duration period,
+      StateVariableWatcher::Callback callback = nullptr) const;
+
+  // Starts a Session for the `parts`, see Session::Start(). All Sessions
+  // started by this Client read their reaction events on the single thread of
+  // a shared ReactionWatcher, instead of a thread per Session. The ReactionWatcher is
+  // created with the first of them, and shut down when the last one is
+  // destroyed.
+  //
+  // Returns FailedPreconditionError if this Client was constructed from a
+  // stub, since each Session needs a stub of its own.
+  absl::StatusOr<std::unique_ptr<Session>> StartSession(
+      absl::Span<const std::string> parts,
+      const intrinsic_proto::data_logger::Context& context = {},
+      std::optional<absl::Time> deadline = std::nullopt) const;
+
   absl::Status SetSpeedOverride(double new_speed_override);
   absl::StatusOr<double> GetSpeedOverride() const;
 
+  // Sets the logging mode of all parts and clears the logging policy.
   absl::Status SetLoggingMode(LoggingMode logging_mode) const;
 
+  // Sets the logging mode, and refines it per part with `logging_policy`, see
+  // LoggingPolicy. Returns InvalidArgumentError if `logging_policy` is
+  // invalid.
+  absl::Status SetLoggingMode(LoggingMode logging_mode,
+                              const LoggingPolicy& logging_policy) const;
+
   absl::StatusOr<LoggingMode> GetLoggingMode() const;
 
+  absl::StatusOr<LoggingPolicy> GetLoggingPolicy() const;
+
   absl::Status SetPartProperties(const PartPropertyMap& property_map) const;
   absl::StatusOr<TimestampedPartProperties> GetPartProperties() const;
 
  private:
+  // See EnableCache(). Defined in client.cc.
+  struct Cache;
+  // See StartSession(). Defined in client.cc.
+  struct SharedReactionWatcher;
+
   // Hold onto the channel, if any, so that callers do not need to worry about
   // its lifetime.
   std::shared_ptr<ChannelInterface> channel_;
@@ -213,6 +360,12 @@ class Client {
   // Factory function that produces ::grpc::ClientContext objects before each
   // gRPC request.
   ClientContextFactory client_context_factory_;
+
+  // Nullptr unless EnableCache() was called.
+  std::unique_ptr<Cache> cache_;
+
+  // Nullptr if this Client was constructed from a stub, or moved from.
+  std::unique_ptr<SharedReactionWatcher> reaction_watcher_;
 };
 
 }  // namespace icon
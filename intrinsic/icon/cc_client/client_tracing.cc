@@ -0,0 +1,83 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/cc_client/client_tracing.h"
+
+#include <array>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "intrinsic/platform/pubsub/latency_histogram.h"
+
+namespace intrinsic::icon {
+namespace {
+
+std::atomic<bool> tracing_enabled = true;
+
+std::array<internal::LatencyHistogram, kNumClientTracePoints>& Histograms() {
+  // Never destroyed, so that threads may record during shutdown.
+  static auto* histograms =
+      new std::array<internal::LatencyHistogram, kNumClientTracePoints>();
+  return *histograms;
+}
+
+}  // namespace
+
+absl::string_view ClientTracePointName(ClientTracePoint point) {
+  switch (point) {
+    case ClientTracePoint::kSessionStart:
+      return "session_start";
+    case ClientTracePoint::kSessionRoundTrip:
+      return "session_round_trip";
+    case ClientTracePoint::kSessionResponseWait:
+      return "session_response_wait";
+    case ClientTracePoint::kReactionQueueDelay:
+      return "reaction_queue_delay";
+    case ClientTracePoint::kReactionCallback:
+      return "reaction_callback";
+    case ClientTracePoint::kStreamWrite:
+      return "stream_write";
+  }
+  return "unknown";
+}
+
+void SetClientTracingEnabled(bool enabled) {
+  tracing_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool ClientTracingEnabled() {
+  return tracing_enabled.load(std::memory_order_relaxed);
+}
+
+void RecordClientLatency(ClientTracePoint point, absl::Duration latency) {
+  if (!ClientTracingEnabled()) {
+    return;
+  }
+  Histograms()[static_cast<int>(point)].Record(latency);
+}
+
+LatencySummary SummarizeClientLatency(ClientTracePoint point) {
+  return Histograms()[static_cast<int>(point)].Summarize();
+}
+
+std::vector<std::pair<absl::string_view, LatencySummary>>
+SummarizeClientLatencies() {
+  std::vector<std::pair<absl::string_view, LatencySummary>> summaries;
+  summaries.reserve(kNumClientTracePoints);
+  for (int i = 0; i < kNumClientTracePoints; ++i) {
+    const auto point = static_cast<ClientTracePoint>(i);
+    summaries.emplace_back(ClientTracePointName(point),
+                           SummarizeClientLatency(point));
+  }
+  return summaries;
+}
+
+void ResetClientLatencies() {
+  for (internal::LatencyHistogram& histogram : Histograms()) {
+    histogram.Reset();
+  }
+}
+
+}  // namespace intrinsic::icon
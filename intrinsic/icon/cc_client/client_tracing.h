@@ -0,0 +1,89 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_CC_CLIENT_CLIENT_TRACING_H_
+#define INTRINSIC_ICON_CC_CLIENT_CLIENT_TRACING_H_
+
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/platform/pubsub/latency_histogram.h"
+
+namespace intrinsic::icon {
+
+// Points on the request path of the ICON client whose latency is traced.
+enum class ClientTracePoint {
+  // Session::Start(), until the session is ready for requests.
+  kSessionStart = 0,
+  // From sending a session request, e.g. AddActions(), until its response has
+  // been read.
+  kSessionRoundTrip,
+  // Time spent blocked reading a single session response.
+  kSessionResponseWait,
+  // From receiving a reaction event until its callback starts. This is the
+  // client-side queue delay, e.g. until RunWatcherLoop() is called, or until
+  // the executor of Session::DispatchReactionsOn() runs the callback.
+  kReactionQueueDelay,
+  // Run time of a single reaction callback.
+  kReactionCallback,
+  // StreamWriter::Write(), until the server acknowledged the value.
+  kStreamWrite,
+};
+
+inline constexpr int kNumClientTracePoints = 6;
+
+// Returns a name for `point` that is suitable as a metric name, e.g.
+// "session_round_trip".
+absl::string_view ClientTracePointName(ClientTracePoint point);
+
+// Latencies are recorded into process-wide histograms, see LatencyHistogram.
+// Recording takes a few relaxed atomic increments and never blocks, so
+// tracing is enabled by default. Counters are the `count` of each summary.
+
+// Enables or disables recording. Latencies that are being measured when
+// tracing gets disabled may still be recorded.
+void SetClientTracingEnabled(bool enabled);
+bool ClientTracingEnabled();
+
+// Records `latency` for `point`, if tracing is enabled.
+void RecordClientLatency(ClientTracePoint point, absl::Duration latency);
+
+// Returns the latencies recorded for `point` since the start of the process
+// or the last ResetClientLatencies().
+LatencySummary SummarizeClientLatency(ClientTracePoint point);
+
+// Returns the summaries of all points with their names, e.g. for exporting
+// them as metrics.
+std::vector<std::pair<absl::string_view, LatencySummary>>
+SummarizeClientLatencies();
+
+// Clears all histograms. Not atomic with respect to concurrent recording.
+void ResetClientLatencies();
+
+// Records the time between its construction and its destruction for `point`.
+// Does not read the clock if tracing is disabled.
+class ScopedClientTrace {
+ public:
+  explicit ScopedClientTrace(ClientTracePoint point)
+      : point_(point),
+        start_(ClientTracingEnabled() ? absl::Now() : absl::InfinitePast()) {}
+
+  ~ScopedClientTrace() {
+    if (start_ != absl::InfinitePast()) {
+      RecordClientLatency(point_, absl::Now() - start_);
+    }
+  }
+
+  ScopedClientTrace(const ScopedClientTrace&) = delete;
+  ScopedClientTrace& operator=(const ScopedClientTrace&) = delete;
+
+ private:
+  const ClientTracePoint point_;
+  const absl::Time start_;
+};
+
+}  // namespace intrinsic::icon
+
+#endif  // INTRINSIC_ICON_CC_CLIENT_CLIENT_TRACING_H_
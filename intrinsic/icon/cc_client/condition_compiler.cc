@@ -0,0 +1,148 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/cc_client/condition_compiler.h"
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "intrinsic/icon/cc_client/condition.h"
+#include "intrinsic/icon/proto/types.pb.h"
+
+namespace intrinsic {
+namespace icon {
+
+Condition ConditionCompiler::Simplify(const Condition& condition) {
+  return ToCondition(Intern(condition));
+}
+
+const intrinsic_proto::icon::Condition& ConditionCompiler::Compile(
+    const Condition& condition) {
+  return CompileNode(Intern(condition));
+}
+
+ConditionCompiler::NodeId ConditionCompiler::Intern(
+    const Condition& condition) {
+  return std::visit(
+      [this](const auto& arg) -> NodeId {
+        using T = std::decay_t<decltype(arg)>;
+        if constexpr (std::is_same_v<T, Comparison>) {
+          return InternComparison(arg);
+        } else if constexpr (std::is_same_v<T, NegatedCondition>) {
+          const NodeId negated = Intern(arg.GetCondition());
+          // Not(Not(c)) is c.
+          if (nodes_[negated].kind == NodeKind::kNot) {
+            return nodes_[negated].children.front();
+          }
+          return InternComposite(NodeKind::kNot, {negated});
+        } else {
+          static_assert(std::is_same_v<T, ConjunctionCondition>);
+          const NodeKind kind =
+              arg.GetOperation() == ConjunctionCondition::Operation::kAllOf
+                  ? NodeKind::kAllOf
+                  : NodeKind::kAnyOf;
+          std::vector<NodeId> operands;
+          absl::flat_hash_set<NodeId> seen;
+          auto add_operand = [&operands, &seen](NodeId operand) {
+            if (seen.insert(operand).second) {
+              operands.push_back(operand);
+            }
+          };
+          for (const Condition& operand : arg.GetConditions()) {
+            const NodeId id = Intern(operand);
+            // Interned nodes are flattened already, so one level suffices.
+            if (nodes_[id].kind == kind) {
+              for (NodeId nested : nodes_[id].children) {
+                add_operand(nested);
+              }
+            } else {
+              add_operand(id);
+            }
+          }
+          if (operands.size() == 1) {
+            return operands.front();
+          }
+          return InternComposite(kind, std::move(operands));
+        }
+      },
+      condition);
+}
+
+ConditionCompiler::NodeId ConditionCompiler::InternComparison(
+    const Comparison& comparison) {
+  auto [it, inserted] = comparison_ids_.try_emplace(comparison, nodes_.size());
+  if (inserted) {
+    nodes_.push_back({.kind = NodeKind::kComparison, .comparison = comparison});
+  }
+  return it->second;
+}
+
+ConditionCompiler::NodeId ConditionCompiler::InternComposite(
+    NodeKind kind, std::vector<NodeId> children) {
+  auto [it, inserted] =
+      composite_ids_.try_emplace(std::make_pair(kind, children), nodes_.size());
+  if (inserted) {
+    nodes_.push_back({.kind = kind, .children = std::move(children)});
+  }
+  return it->second;
+}
+
+const intrinsic_proto::icon::Condition& ConditionCompiler::CompileNode(
+    NodeId id) {
+  // Compiling does not add nodes, so `node` stays valid.
+  Node& node = nodes_[id];
+  if (node.proto != nullptr) {
+    return *node.proto;
+  }
+  auto proto = std::make_unique<intrinsic_proto::icon::Condition>();
+  switch (node.kind) {
+    case NodeKind::kComparison:
+      *proto->mutable_comparison() = ToProto(*node.comparison);
+      break;
+    case NodeKind::kAllOf:
+    case NodeKind::kAnyOf: {
+      intrinsic_proto::icon::ConjunctionCondition* conjunction =
+          proto->mutable_conjunction_condition();
+      conjunction->set_operation(
+          node.kind == NodeKind::kAllOf
+              ? intrinsic_proto::icon::ConjunctionCondition::ALL_OF
+              : intrinsic_proto::icon::ConjunctionCondition::ANY_OF);
+      for (NodeId child : node.children) {
+        *conjunction->add_conditions() = CompileNode(child);
+      }
+      break;
+    }
+    case NodeKind::kNot:
+      *proto->mutable_negated_condition()->mutable_condition() =
+          CompileNode(node.children.front());
+      break;
+  }
+  node.proto = std::move(proto);
+  return *node.proto;
+}
+
+Condition ConditionCompiler::ToCondition(NodeId id) const {
+  const Node& node = nodes_[id];
+  switch (node.kind) {
+    case NodeKind::kComparison:
+      return *node.comparison;
+    case NodeKind::kAllOf:
+    case NodeKind::kAnyOf: {
+      std::vector<Condition> operands;
+      operands.reserve(node.children.size());
+      for (NodeId child : node.children) {
+        operands.push_back(ToCondition(child));
+      }
+      return node.kind == NodeKind::kAllOf ? AllOf(operands) : AnyOf(operands);
+    }
+    case NodeKind::kNot:
+      break;
+  }
+  return Not(ToCondition(node.children.front()));
+}
+
+}  // namespace icon
+}  // namespace intrinsic
@@ -0,0 +1,95 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_CC_CLIENT_CONDITION_COMPILER_H_
+#define INTRINSIC_ICON_CC_CLIENT_CONDITION_COMPILER_H_
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "intrinsic/icon/cc_client/condition.h"
+#include "intrinsic/icon/proto/types.pb.h"
+
+namespace intrinsic {
+namespace icon {
+
+// Deduplicates and simplifies the conditions of many reactions.
+//
+// The compiler hash-conses all sub-conditions it sees into a DAG, so that
+// every distinct sub-condition is stored and converted to proto only once, no
+// matter how many reactions use it. While doing so, it applies rewrites that
+// do not change the meaning of a condition, but make its proto smaller:
+//
+// * Not(Not(c)) becomes c.
+// * Nested conjunctions with the same operation are flattened, e.g.
+//   AllOf({a, AllOf({b, c})}) becomes AllOf({a, b, c}).
+// * Repeated operands of a conjunction are dropped, e.g. AnyOf({a, b, a})
+//   becomes AnyOf({a, b}).
+// * Conjunctions with a single operand become that operand.
+//
+// The order of operands is kept.
+//
+// Example:
+//
+// ConditionCompiler compiler;
+// for (const Condition& condition : conditions) {
+//   INTR_RETURN_IF_ERROR(session->AddFreestandingReaction(
+//       ReactionDescriptor(compiler.Simplify(condition))));
+// }
+//
+// This class is not thread-safe.
+class ConditionCompiler {
+ public:
+  ConditionCompiler() = default;
+
+  ConditionCompiler(const ConditionCompiler&) = delete;
+  ConditionCompiler& operator=(const ConditionCompiler&) = delete;
+
+  // Returns the simplified form of `condition`.
+  Condition Simplify(const Condition& condition);
+
+  // Returns the proto of the simplified form of `condition`. The result is
+  // cached, so converting equal conditions again only costs their lookup.
+  // The returned reference is valid until this compiler is destroyed.
+  const intrinsic_proto::icon::Condition& Compile(const Condition& condition);
+
+  // Returns the number of distinct (simplified) sub-conditions seen so far.
+  size_t NumUniqueConditions() const { return nodes_.size(); }
+
+ private:
+  using NodeId = size_t;
+
+  enum class NodeKind { kComparison, kAllOf, kAnyOf, kNot };
+
+  struct Node {
+    NodeKind kind;
+    // Only set for kComparison.
+    std::optional<Comparison> comparison;
+    // Operands of kAllOf and kAnyOf, the negated condition of kNot.
+    std::vector<NodeId> children;
+    // Set once the node has been compiled.
+    std::unique_ptr<intrinsic_proto::icon::Condition> proto;
+  };
+
+  // Returns the node for the simplified form of `condition`, adding it if
+  // needed.
+  NodeId Intern(const Condition& condition);
+  NodeId InternComparison(const Comparison& comparison);
+  NodeId InternComposite(NodeKind kind, std::vector<NodeId> children);
+
+  const intrinsic_proto::icon::Condition& CompileNode(NodeId id);
+  Condition ToCondition(NodeId id) const;
+
+  std::vector<Node> nodes_;
+  absl::flat_hash_map<Comparison, NodeId> comparison_ids_;
+  absl::flat_hash_map<std::pair<NodeKind, std::vector<NodeId>>, NodeId>
+      composite_ids_;
+};
+
+}  // namespace icon
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_ICON_CC_CLIENT_CONDITION_COMPILER_H_
@@ -0,0 +1,284 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/cc_client/introspection.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "google/protobuf/repeated_field.h"
+#include "intrinsic/icon/cc_client/client.h"
+#include "intrinsic/icon/cc_client/robot_config.h"
+#include "intrinsic/icon/proto/generic_part_config.pb.h"
+#include "intrinsic/icon/proto/part_status.pb.h"
+#include "intrinsic/icon/proto/service.pb.h"
+#include "intrinsic/icon/proto/types.pb.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+namespace icon {
+namespace {
+
+// Calls `fn(i)` for every `i` in [0, `n`) on up to `max_threads` threads,
+// including the calling one.
+void ParallelFor(size_t n, int max_threads,
+                 absl::FunctionRef<void(size_t)> fn) {
+  std::atomic<size_t> next = 0;
+  auto work = [&]() {
+    for (size_t i = next++; i < n; i = next++) {
+      fn(i);
+    }
+  };
+  std::vector<Thread> threads;
+  const size_t num_threads = std::min<size_t>(std::max(max_threads, 1), n);
+  for (size_t t = 1; t < num_threads; ++t) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (Thread& thread : threads) {
+    thread.Join();
+  }
+}
+
+void WriteParameterInfo(
+    const intrinsic_proto::icon::ActionSignature::ParameterInfo&
+        parameter_info,
+    std::ostream& out) {
+  out << "Parameter name: " << parameter_info.parameter_name() << "\n"
+      << "Description: " << parameter_info.text_description() << "\n"
+      << "Type: " << parameter_info.value_message_type() << "\n";
+}
+
+void WriteFeatureInterfaces(
+    const google::protobuf::RepeatedField<int>& feature_interfaces,
+    std::ostream& out) {
+  for (int fi : feature_interfaces) {
+    out << "      " << intrinsic_proto::icon::FeatureInterfaceTypes_Name(fi)
+        << "\n";
+  }
+}
+
+}  // namespace
+
+absl::StatusOr<IntrospectionSnapshot> Introspect(const Client& client,
+                                                 int max_concurrent_requests) {
+  absl::StatusOr<std::vector<std::string>> parts;
+  absl::StatusOr<RobotConfig> config = absl::UnknownError("Not requested");
+  absl::StatusOr<intrinsic_proto::icon::GetStatusResponse> status;
+  absl::StatusOr<std::vector<intrinsic_proto::icon::ActionSignature>>
+      signatures;
+  std::vector<absl::StatusOr<std::vector<std::string>>> compatible_parts;
+  // The signatures are needed before their compatible parts can be listed, so
+  // that chain runs on the calling thread while the others are in flight.
+  ParallelFor(4, max_concurrent_requests, [&](size_t i) {
+    switch (i) {
+      case 0:
+        signatures = client.ListActionSignatures();
+        if (!signatures.ok()) return;
+        compatible_parts.resize(signatures->size());
+        ParallelFor(signatures->size(), max_concurrent_requests - 3,
+                    [&](size_t j) {
+                      compatible_parts[j] = client.ListCompatibleParts(
+                          {(*signatures)[j].action_type_name()});
+                    });
+        return;
+      case 1:
+        parts = client.ListParts();
+        return;
+      case 2:
+        config = client.GetConfig();
+        return;
+      case 3:
+        status = client.GetStatus();
+        return;
+    }
+  });
+  INTR_RETURN_IF_ERROR(parts.status());
+  INTR_RETURN_IF_ERROR(config.status());
+  INTR_RETURN_IF_ERROR(signatures.status());
+  INTR_RETURN_IF_ERROR(status.status());
+
+  std::vector<IntrospectionSnapshot::Action> actions;
+  actions.reserve(signatures->size());
+  for (size_t i = 0; i < signatures->size(); ++i) {
+    INTR_RETURN_IF_ERROR(compatible_parts[i].status());
+    actions.push_back({.signature = std::move((*signatures)[i]),
+                       .compatible_parts = *std::move(compatible_parts[i])});
+  }
+  return IntrospectionSnapshot{.parts = *std::move(parts),
+                               .config = *std::move(config),
+                               .actions = std::move(actions),
+                               .status = *std::move(status)};
+}
+
+void WriteActionSignature(
+    const intrinsic_proto::icon::ActionSignature& signature,
+    std::ostream& out) {
+  out << "Action type name: " << signature.action_type_name() << "\n"
+      << "Description: " << signature.text_description() << "\n\n";
+  if (signature.fixed_parameters_message_type().empty()) {
+    out << "Does not take parameters.\n";
+  } else {
+    out << "Parameter type: " << signature.fixed_parameters_message_type()
+        << "\n";
+  }
+  out << "\n";
+  if (signature.streaming_input_infos().empty()) {
+    out << "Does not take streaming inputs.\n";
+  } else {
+    out << "Streaming Inputs:\n";
+    for (const auto& streaming_input_info : signature.streaming_input_infos()) {
+      WriteParameterInfo(streaming_input_info, out);
+    }
+  }
+  out << "\n";
+  if (!signature.has_streaming_output_info()) {
+    out << "Does not provide a streaming output.\n";
+  } else {
+    out << "Streaming Output:\n";
+    WriteParameterInfo(signature.streaming_output_info(), out);
+  }
+  out << "\nState Variables:\n";
+  for (const auto& state_variable_info : signature.state_variable_infos()) {
+    out << state_variable_info.state_variable_name() << " ("
+        << intrinsic_proto::icon::ActionSignature::StateVariableInfo::Type_Name(
+               state_variable_info.type())
+        << ")\n"
+        << "  " << state_variable_info.text_description() << "\n";
+  }
+  out << "\nSlots:\n";
+  for (const auto& [slot_name, slot_info] : signature.part_slot_infos()) {
+    out << "  " << slot_name << "\n"
+        << "    Description: " << slot_info.description() << "\n"
+        << "    Required feature interfaces:\n";
+    if (slot_info.required_feature_interfaces().empty()) {
+      out << "      (none)\n";
+    } else {
+      WriteFeatureInterfaces(slot_info.required_feature_interfaces(), out);
+    }
+    if (!slot_info.optional_feature_interfaces().empty()) {
+      out << "    Optional feature interfaces:\n";
+      WriteFeatureInterfaces(slot_info.optional_feature_interfaces(), out);
+    }
+  }
+}
+
+absl::Status WriteParts(const IntrospectionSnapshot& snapshot,
+                        std::ostream& out) {
+  out << "Available Parts:\n";
+  for (const std::string& part : snapshot.parts) {
+    INTR_ASSIGN_OR_RETURN(
+        std::vector<intrinsic_proto::icon::FeatureInterfaceTypes>
+            feature_interfaces,
+        snapshot.config.GetPartFeatureInterfaces(part));
+    out << "  " << part << "\n"
+        << "    Supported feature interfaces:\n";
+    if (feature_interfaces.empty()) {
+      out << "      (none)\n";
+    }
+    for (intrinsic_proto::icon::FeatureInterfaceTypes fi : feature_interfaces) {
+      out << "      " << intrinsic_proto::icon::FeatureInterfaceTypes_Name(fi)
+          << "\n";
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status WritePartConfigs(const IntrospectionSnapshot& snapshot,
+                              std::ostream& out) {
+  for (const std::string& part : snapshot.parts) {
+    INTR_ASSIGN_OR_RETURN(intrinsic_proto::icon::GenericPartConfig config,
+                          snapshot.config.GetGenericPartConfig(part));
+    out << "GenericPartConfig for part '" << part << "':\n"
+        << absl::StrCat(config) << "\n";
+  }
+  return absl::OkStatus();
+}
+
+void WriteActions(const IntrospectionSnapshot& snapshot, std::ostream& out) {
+  out << "Available Actions:\n";
+  for (const IntrospectionSnapshot::Action& action : snapshot.actions) {
+    out << "\n";
+    WriteActionSignature(action.signature, out);
+    out << "\n";
+    if (action.compatible_parts.empty()) {
+      out << "No compatible Parts\n";
+    } else {
+      out << "Compatible Parts:\n";
+      for (const std::string& part : action.compatible_parts) {
+        out << "  " << part << "\n";
+      }
+    }
+  }
+}
+
+absl::Status WriteStatus(const IntrospectionSnapshot& snapshot,
+                         std::ostream& out) {
+  const intrinsic_proto::icon::GetStatusResponse& status = snapshot.status;
+  for (const std::string& part : snapshot.parts) {
+    auto part_status_it = status.part_status().find(part);
+    if (part_status_it == status.part_status().end()) {
+      return absl::NotFoundError(
+          absl::StrCat("No PartStatus for Part '", part, "'"));
+    }
+    const intrinsic_proto::icon::PartStatus& part_status =
+        part_status_it->second;
+    out << "Status for Part '" << part << "':\n";
+    if (!part_status.joint_states().empty()) {
+      out << "  Joint positions:\n";
+      for (int i = 0; i < part_status.joint_states_size(); ++i) {
+        out << absl::StreamFormat(
+            "    J%d: %6.3f\n", i,
+            part_status.joint_states(i).position_sensed());
+      }
+      // If there are joint states, there is also a Cartesian base_t_tip pose.
+      const intrinsic_proto::icon::Transform& base_t_tip =
+          part_status.base_t_tip_sensed();
+      out << "  base_T_tip:\n"
+          << absl::StreamFormat("    x: %6.3f\n", base_t_tip.pos().x())
+          << absl::StreamFormat("    y: %6.3f\n", base_t_tip.pos().y())
+          << absl::StreamFormat("    z: %6.3f\n", base_t_tip.pos().z())
+          << absl::StreamFormat("   qw: %6.3f\n", base_t_tip.rot().qw())
+          << absl::StreamFormat("   qx: %6.3f\n", base_t_tip.rot().qx())
+          << absl::StreamFormat("   qy: %6.3f\n", base_t_tip.rot().qy())
+          << absl::StreamFormat("   qz: %6.3f\n", base_t_tip.rot().qz());
+    }
+    if (part_status.has_gripper_state()) {
+      out << "  gripper state:\n    "
+          << intrinsic_proto::icon::GripperState::SensedState_Name(
+                 part_status.gripper_state().sensed_state())
+          << "\n";
+    }
+    if (part_status.has_adio_state()) {
+      out << "  ADIO state:\n"
+          << absl::StrCat(part_status.adio_state()) << "\n";
+    }
+    if (part_status.has_current_control_mode()) {
+      out << "  Control Mode: "
+          << intrinsic_proto::icon::PartControlMode_Name(
+                 part_status.current_control_mode())
+          << "\n";
+    }
+  }
+  if (status.has_safety_status()) {
+    out << "SafetyStatus:\n" << absl::StrCat(status.safety_status()) << "\n";
+  }
+  out << "Sessions:\n";
+  for (const auto& [session_id, session] : status.sessions()) {
+    out << "Session ID " << session_id << ":" << absl::StrCat(session) << "\n";
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace icon
+}  // namespace intrinsic
@@ -0,0 +1,75 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_CC_CLIENT_INTROSPECTION_H_
+#define INTRINSIC_ICON_CC_CLIENT_INTROSPECTION_H_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "intrinsic/icon/cc_client/client.h"
+#include "intrinsic/icon/cc_client/robot_config.h"
+#include "intrinsic/icon/proto/service.pb.h"
+
+namespace intrinsic {
+namespace icon {
+
+// The parts, actions and status of an ICON server at one point in time.
+struct IntrospectionSnapshot {
+  struct Action {
+    intrinsic_proto::icon::ActionSignature signature;
+    std::vector<std::string> compatible_parts;
+  };
+
+  std::vector<std::string> parts;
+  RobotConfig config;
+  // Sorted by action type name.
+  std::vector<Action> actions;
+  intrinsic_proto::icon::GetStatusResponse status;
+};
+
+// Fetches an IntrospectionSnapshot through `client`.
+//
+// Lists the parts, the action signatures, the config and the status
+// concurrently, and then the compatible parts of all actions, using up to
+// `max_concurrent_requests` requests at a time. Call Client::EnableCache() to
+// answer the signature, config and compatibility requests of later calls from
+// the cache; only the parts and the status are then requested again.
+//
+// Returns the first error of any request.
+absl::StatusOr<IntrospectionSnapshot> Introspect(
+    const Client& client, int max_concurrent_requests = 8);
+
+// The functions below write a human-readable representation of (a part of) an
+// IntrospectionSnapshot to `out`. Signatures contain FileDescriptorSets, which
+// result in very long DebugString() representations without giving much
+// information to a human reader, so these only print the message type names.
+
+// Writes the action type name, description, parameters, streaming inputs and
+// output, state variables and slots of `signature`.
+void WriteActionSignature(
+    const intrinsic_proto::icon::ActionSignature& signature,
+    std::ostream& out);
+
+// Writes all parts with their supported feature interfaces.
+absl::Status WriteParts(const IntrospectionSnapshot& snapshot,
+                        std::ostream& out);
+
+// Writes the GenericPartConfig of all parts.
+absl::Status WritePartConfigs(const IntrospectionSnapshot& snapshot,
+                              std::ostream& out);
+
+// Writes the signatures of all actions and their compatible parts.
+void WriteActions(const IntrospectionSnapshot& snapshot, std::ostream& out);
+
+// Writes the status of all parts, the safety status and the sessions. Returns
+// NotFoundError if the status lacks one of the parts.
+absl::Status WriteStatus(const IntrospectionSnapshot& snapshot,
+                         std::ostream& out);
+
+}  // namespace icon
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_ICON_CC_CLIENT_INTROSPECTION_H_
@@ -0,0 +1,118 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/cc_client/operational_status_watcher.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/support/sync_stream.h"
+#include "intrinsic/icon/cc_client/operational_status.h"
+#include "intrinsic/icon/proto/service.grpc.pb.h"
+#include "intrinsic/icon/proto/service.pb.h"
+#include "intrinsic/util/grpc/channel_interface.h"
+#include "intrinsic/util/grpc/stream_watcher.h"
+
+namespace intrinsic::icon {
+
+// static
+absl::StatusOr<std::unique_ptr<OperationalStatusWatcher>>
+OperationalStatusWatcher::Create(
+    intrinsic_proto::icon::IconApi::StubInterface* stub,
+    ClientContextFactory client_context_factory, PollFn poll,
+    absl::Duration retry_period, ChangeCallback callback) {
+  if (retry_period <= absl::ZeroDuration()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Retry period must be positive, got ",
+                     absl::FormatDuration(retry_period)));
+  }
+  // Private constructor, so no make_unique.
+  return absl::WrapUnique(new OperationalStatusWatcher(
+      stub, std::move(client_context_factory), std::move(poll), retry_period,
+      std::move(callback)));
+}
+
+OperationalStatusWatcher::OperationalStatusWatcher(
+    intrinsic_proto::icon::IconApi::StubInterface* stub,
+    ClientContextFactory client_context_factory, PollFn poll,
+    absl::Duration retry_period, ChangeCallback callback)
+    : stub_(stub), poll_(std::move(poll)), callback_(std::move(callback)) {
+  // Start watching only once all members are initialized.
+  watcher_ = std::make_unique<StreamWatcher>(
+      [this](::grpc::ClientContext* context) { return Stream(context); },
+      StreamWatcher::Options{
+          .name = "operational status",
+          .client_context_factory = std::move(client_context_factory),
+          .retry_delay = retry_period,
+          .poll =
+              [this](absl::Time) {
+                if (absl::StatusOr<OperationalStatus> status = poll_();
+                    status.ok()) {
+                  Update(*status);
+                }
+                return absl::OkStatus();
+              },
+          .poll_period = retry_period,
+      });
+}
+
+bool OperationalStatusWatcher::GetNewStatus(
+    const OperationalStatus** status) {
+  OperationalStatus* latest = nullptr;
+  if (!buffer_.TryGetNewActiveBuffer(&latest, &generation_)) {
+    return false;
+  }
+  latest_ = latest;
+  *status = latest;
+  return true;
+}
+
+absl::StatusOr<OperationalStatus> OperationalStatusWatcher::GetLatestStatus() {
+  const OperationalStatus* status = nullptr;
+  GetNewStatus(&status);
+  if (latest_ == nullptr) {
+    return absl::UnavailableError("No operational status received yet");
+  }
+  return *latest_;
+}
+
+absl::Status OperationalStatusWatcher::Stream(
+    ::grpc::ClientContext* context) {
+  const intrinsic_proto::icon::WatchOperationalStatusRequest request;
+  std::unique_ptr<::grpc::ClientReaderInterface<
+      intrinsic_proto::icon::WatchOperationalStatusResponse>>
+      stream = stub_->WatchOperationalStatus(context, request);
+  return ReadStream(
+      *stream,
+      [this](const intrinsic_proto::icon::WatchOperationalStatusResponse&
+                 response) {
+        absl::StatusOr<OperationalStatus> status =
+            FromProto(response.operational_status());
+        if (!status.ok()) {
+          LOG(WARNING) << "Ignoring invalid operational status: "
+                       << status.status();
+          return;
+        }
+        Update(*status);
+      });
+}
+
+void OperationalStatusWatcher::Update(const OperationalStatus& status) {
+  if (last_status_.has_value() && *last_status_ == status) {
+    return;
+  }
+  last_status_ = status;
+  *buffer_.GetFreeBuffer() = status;
+  buffer_.CommitFreeBuffer();
+  if (callback_ != nullptr) {
+    callback_(status);
+  }
+}
+
+}  // namespace intrinsic::icon
@@ -0,0 +1,94 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_CC_CLIENT_OPERATIONAL_STATUS_WATCHER_H_
+#define INTRINSIC_ICON_CC_CLIENT_OPERATIONAL_STATUS_WATCHER_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "grpcpp/client_context.h"
+#include "intrinsic/icon/cc_client/operational_status.h"
+#include "intrinsic/icon/proto/service.grpc.pb.h"
+#include "intrinsic/icon/utils/async_buffer.h"
+#include "intrinsic/util/grpc/channel_interface.h"
+#include "intrinsic/util/grpc/stream_watcher.h"
+
+namespace intrinsic::icon {
+
+// Keeps the latest OperationalStatus of the server up to date in the
+// background, and reports every change as soon as the server publishes it.
+//
+// A single thread reads the WatchOperationalStatus stream of the server and
+// publishes each change into a triple buffer, and calls the optional callback.
+// Reading the latest status is lock-free and does not make a request, so it is
+// cheap to check in a supervision loop. If the stream breaks, the watcher
+// reopens it after `retry_period`. Servers that do not implement the stream
+// are polled with GetOperationalStatus() every `retry_period` instead.
+//
+// Obtain an OperationalStatusWatcher from Client::WatchOperationalStatus(). It
+// must not outlive its Client.
+//
+// Only a single thread may read the status. Destroying the watcher cancels the
+// stream and waits for an outstanding callback to finish.
+class OperationalStatusWatcher {
+ public:
+  // Polls the status of a server without WatchOperationalStatus.
+  using PollFn = absl::AnyInvocable<absl::StatusOr<OperationalStatus>()>;
+  // Called on the thread of the watcher with each new status. Must not block
+  // for long, since that delays the next update.
+  using ChangeCallback = absl::AnyInvocable<void(const OperationalStatus&)>;
+
+  // Starts watching the status through `stub`, with ClientContexts from
+  // `client_context_factory`. `callback` may be null.
+  //
+  // Returns InvalidArgumentError if `retry_period` is not positive.
+  static absl::StatusOr<std::unique_ptr<OperationalStatusWatcher>> Create(
+      intrinsic_proto::icon::IconApi::StubInterface* stub,
+      ClientContextFactory client_context_factory, PollFn poll,
+      absl::Duration retry_period, ChangeCallback callback);
+
+  OperationalStatusWatcher(const OperationalStatusWatcher&) = delete;
+  OperationalStatusWatcher& operator=(const OperationalStatusWatcher&) =
+      delete;
+
+  // Sets `*status` to the latest status and returns true if it has changed
+  // since the last call. Otherwise, returns false and leaves `*status`
+  // unchanged; the status returned by the previous call stays valid until the
+  // next call.
+  bool GetNewStatus(const OperationalStatus** status);
+
+  // Returns the latest status, or UnavailableError if none was received yet.
+  absl::StatusOr<OperationalStatus> GetLatestStatus();
+
+ private:
+  OperationalStatusWatcher(
+      intrinsic_proto::icon::IconApi::StubInterface* stub,
+      ClientContextFactory client_context_factory, PollFn poll,
+      absl::Duration retry_period, ChangeCallback callback);
+
+  // Reads the stream until it ends, and returns its final status.
+  absl::Status Stream(::grpc::ClientContext* context);
+  // Publishes `status` if it differs from the last one.
+  void Update(const OperationalStatus& status);
+
+  intrinsic_proto::icon::IconApi::StubInterface* const stub_;
+  PollFn poll_;
+  ChangeCallback callback_;
+  AsyncBuffer<OperationalStatus> buffer_;
+  // Only accessed by the thread of `watcher_`.
+  std::optional<OperationalStatus> last_status_;
+  // Only accessed by the reader.
+  uint64_t generation_ = 0;
+  const OperationalStatus* latest_ = nullptr;
+  // Last, so that it stops before the members it uses are destroyed.
+  std::unique_ptr<StreamWatcher> watcher_;
+};
+
+}  // namespace intrinsic::icon
+
+#endif  // INTRINSIC_ICON_CC_CLIENT_OPERATIONAL_STATUS_WATCHER_H_
@@ -0,0 +1,176 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/cc_client/output_subscription.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/support/sync_stream.h"
+#include "intrinsic/icon/common/id_types.h"
+#include "intrinsic/icon/proto/service.grpc.pb.h"
+#include "intrinsic/icon/proto/service.pb.h"
+#include "intrinsic/icon/proto/streaming_output.pb.h"
+#include "intrinsic/util/grpc/channel_interface.h"
+#include "intrinsic/util/grpc/stream_watcher.h"
+#include "intrinsic/util/proto_time.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic::icon {
+
+// static
+absl::StatusOr<std::unique_ptr<OutputSubscription>> OutputSubscription::Create(
+    ::intrinsic_proto::icon::IconApi::StubInterface* stub,
+    ClientContextFactory client_context_factory, SessionId session_id,
+    absl::Span<const ActionInstanceId> action_ids, absl::Duration period,
+    FetchFn fetch) {
+  if (action_ids.empty()) {
+    return absl::InvalidArgumentError("No actions to subscribe to.");
+  }
+  if (period <= absl::ZeroDuration()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Period must be positive, got ",
+                     absl::FormatDuration(period)));
+  }
+  for (auto it = action_ids.begin(); it != action_ids.end(); ++it) {
+    if (std::find(action_ids.begin(), it, *it) != it) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Duplicate action id ", it->value()));
+    }
+  }
+  // Private constructor, so no make_unique.
+  return absl::WrapUnique(new OutputSubscription(
+      stub, std::move(client_context_factory), session_id, action_ids, period,
+      std::move(fetch)));
+}
+
+OutputSubscription::OutputSubscription(
+    ::intrinsic_proto::icon::IconApi::StubInterface* stub,
+    ClientContextFactory client_context_factory, SessionId session_id,
+    absl::Span<const ActionInstanceId> action_ids, absl::Duration period,
+    FetchFn fetch)
+    : stub_(stub),
+      session_id_(session_id),
+      period_(period),
+      fetch_(std::move(fetch)) {
+  subscribed_.reserve(action_ids.size());
+  for (ActionInstanceId id : action_ids) {
+    subscribed_.push_back(std::make_unique<Subscribed>(id));
+    subscribed_by_id_[id] = subscribed_.back().get();
+  }
+  // Start watching only once all members are initialized.
+  watcher_ = std::make_unique<StreamWatcher>(
+      [this](::grpc::ClientContext* context) { return Stream(context); },
+      StreamWatcher::Options{
+          .name = "action outputs",
+          .client_context_factory = std::move(client_context_factory),
+          .retry_delay = std::max(period, kMinStreamRetryDelay),
+          .poll = [this](absl::Time deadline) { return FetchAll(deadline); },
+          .poll_period = period,
+          // The session ended, or the server rejects the Actions or the
+          // period.
+          .is_permanent =
+              [](const absl::Status& status) {
+                return absl::IsAborted(status) || absl::IsNotFound(status) ||
+                       absl::IsInvalidArgument(status);
+              },
+      });
+}
+
+absl::StatusOr<bool> OutputSubscription::GetNewOutput(
+    ActionInstanceId id,
+    const ::intrinsic_proto::icon::StreamingOutput** output) {
+  INTR_ASSIGN_OR_RETURN(Subscribed * subscribed, Find(id));
+  ::intrinsic_proto::icon::StreamingOutput* latest = nullptr;
+  if (!subscribed->buffer.TryGetNewActiveBuffer(&latest,
+                                                &subscribed->generation)) {
+    return false;
+  }
+  subscribed->latest = latest;
+  *output = latest;
+  return true;
+}
+
+absl::StatusOr<::intrinsic_proto::icon::StreamingOutput>
+OutputSubscription::GetLatestOutput(ActionInstanceId id) {
+  const ::intrinsic_proto::icon::StreamingOutput* output = nullptr;
+  INTR_RETURN_IF_ERROR(GetNewOutput(id, &output).status());
+  // Find() succeeded above.
+  const ::intrinsic_proto::icon::StreamingOutput* latest =
+      subscribed_by_id_.at(id)->latest;
+  if (latest == nullptr) {
+    return absl::UnavailableError(absl::StrCat(
+        "No output received yet for action ", id.value()));
+  }
+  return *latest;
+}
+
+absl::StatusOr<OutputSubscription::Subscribed*> OutputSubscription::Find(
+    ActionInstanceId id) {
+  auto it = subscribed_by_id_.find(id);
+  if (it == subscribed_by_id_.end()) {
+    return absl::NotFoundError(
+        absl::StrCat("Not subscribed to outputs of action ", id.value()));
+  }
+  return it->second;
+}
+
+absl::Status OutputSubscription::Stream(::grpc::ClientContext* context) {
+  ::intrinsic_proto::icon::SubscribeOutputsRequest request;
+  request.set_session_id(session_id_.value());
+  for (const std::unique_ptr<Subscribed>& subscribed : subscribed_) {
+    request.add_action_ids(subscribed->id.value());
+  }
+  INTR_RETURN_IF_ERROR(ToProto(period_, request.mutable_period()));
+  std::unique_ptr<::grpc::ClientReaderInterface<
+      ::intrinsic_proto::icon::SubscribeOutputsResponse>>
+      stream = stub_->SubscribeOutputs(context, request);
+  return ReadStream(
+      *stream,
+      [this](::intrinsic_proto::icon::SubscribeOutputsResponse& response) {
+        auto it =
+            subscribed_by_id_.find(ActionInstanceId(response.action_id()));
+        if (it == subscribed_by_id_.end()) {
+          LOG(WARNING) << "Ignoring output of unsubscribed action "
+                       << response.action_id();
+          return;
+        }
+        Publish(*it->second, std::move(*response.mutable_output()));
+      });
+}
+
+absl::Status OutputSubscription::FetchAll(absl::Time deadline) {
+  for (const std::unique_ptr<Subscribed>& subscribed : subscribed_) {
+    absl::StatusOr<::intrinsic_proto::icon::StreamingOutput> output =
+        fetch_(subscribed->id, deadline);
+    if (absl::IsAborted(output.status())) {
+      return output.status();
+    }
+    if (output.ok()) {
+      Publish(*subscribed, *std::move(output));
+    }
+  }
+  return absl::OkStatus();
+}
+
+void OutputSubscription::Publish(
+    Subscribed& subscribed, ::intrinsic_proto::icon::StreamingOutput output) {
+  // Polling returns the same output until the Action writes a new one, and a
+  // reopened stream sends the latest one again.
+  if (output.timestamp_ns() <= subscribed.last_timestamp_ns) {
+    return;
+  }
+  subscribed.last_timestamp_ns = output.timestamp_ns();
+  *subscribed.buffer.GetFreeBuffer() = std::move(output);
+  subscribed.buffer.CommitFreeBuffer();
+}
+
+}  // namespace intrinsic::icon
@@ -0,0 +1,133 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_CC_CLIENT_OUTPUT_SUBSCRIPTION_H_
+#define INTRINSIC_ICON_CC_CLIENT_OUTPUT_SUBSCRIPTION_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "grpcpp/client_context.h"
+#include "intrinsic/icon/common/id_types.h"
+#include "intrinsic/icon/proto/service.grpc.pb.h"
+#include "intrinsic/icon/proto/streaming_output.pb.h"
+#include "intrinsic/icon/utils/async_buffer.h"
+#include "intrinsic/util/grpc/channel_interface.h"
+#include "intrinsic/util/grpc/stream_watcher.h"
+
+namespace intrinsic::icon {
+
+// Keeps the latest StreamingOutput of a set of Actions up to date in the
+// background, so that consumers can read it without a round trip to the
+// server.
+//
+// A single thread reads the SubscribeOutputs stream of the server, which sends
+// the new outputs of all Actions once per `period`, and publishes each new
+// output (i.e. one with a newer timestamp than the last one) into a triple
+// buffer per Action. Outputs that the Action publishes faster than that are
+// decimated. Reading the latest output is lock-free and does not block, which
+// makes it cheap to check for new outputs in a control loop. If the stream
+// breaks, the subscription reopens it. Servers that do not implement the
+// stream are polled with GetLatestStreamingOutput once per `period` and
+// Action instead.
+//
+// Obtain an OutputSubscription from Session::SubscribeOutputs(). It must not
+// outlive its Session.
+//
+// Only a single thread may read outputs of the same Action. Destroying the
+// subscription cancels the stream and waits for an outstanding fetch to
+// finish.
+class OutputSubscription {
+ public:
+  // Fetches the latest output of an Action from a server without
+  // SubscribeOutputs, waiting at most until the given deadline.
+  using FetchFn = absl::AnyInvocable<absl::StatusOr<
+      ::intrinsic_proto::icon::StreamingOutput>(ActionInstanceId, absl::Time)>;
+
+  // Starts streaming the outputs of `action_ids` in the session `session_id`
+  // through `stub`, with ClientContexts from `client_context_factory`.
+  // `fetch` is only used if the server does not implement SubscribeOutputs;
+  // errors of single fetches, e.g. because an Action is not active yet, are
+  // ignored. An AbortedError, which signals that the session ended, stops the
+  // subscription.
+  //
+  // Returns InvalidArgumentError if `action_ids` is empty or contains
+  // duplicates, or if `period` is not positive.
+  static absl::StatusOr<std::unique_ptr<OutputSubscription>> Create(
+      ::intrinsic_proto::icon::IconApi::StubInterface* stub,
+      ClientContextFactory client_context_factory, SessionId session_id,
+      absl::Span<const ActionInstanceId> action_ids, absl::Duration period,
+      FetchFn fetch);
+
+  OutputSubscription(const OutputSubscription&) = delete;
+  OutputSubscription& operator=(const OutputSubscription&) = delete;
+
+  // Sets `*output` to the latest output of the Action with `id` and returns
+  // true if it has changed since the last call for that Action. Otherwise,
+  // returns false and leaves `*output` unchanged; the output returned by the
+  // previous call stays valid until the next call.
+  //
+  // Returns NotFoundError if the subscription does not cover `id`.
+  absl::StatusOr<bool> GetNewOutput(
+      ActionInstanceId id,
+      const ::intrinsic_proto::icon::StreamingOutput** output);
+
+  // Returns the latest output of the Action with `id`.
+  //
+  // Returns NotFoundError if the subscription does not cover `id`, and
+  // UnavailableError if no output of that Action has been received yet.
+  absl::StatusOr<::intrinsic_proto::icon::StreamingOutput> GetLatestOutput(
+      ActionInstanceId id);
+
+  // Returns true if the subscription has stopped, e.g. because the session
+  // ended.
+  bool Stopped() const { return !watcher_->status().ok(); }
+
+ private:
+  struct Subscribed {
+    explicit Subscribed(ActionInstanceId id) : id(id) {}
+
+    ActionInstanceId id;
+    AsyncBuffer<::intrinsic_proto::icon::StreamingOutput> buffer;
+    // Only accessed by the thread of `watcher_`.
+    int64_t last_timestamp_ns = -1;
+    // Only accessed by the reader.
+    uint64_t generation = 0;
+    const ::intrinsic_proto::icon::StreamingOutput* latest = nullptr;
+  };
+
+  OutputSubscription(::intrinsic_proto::icon::IconApi::StubInterface* stub,
+                     ClientContextFactory client_context_factory,
+                     SessionId session_id,
+                     absl::Span<const ActionInstanceId> action_ids,
+                     absl::Duration period, FetchFn fetch);
+
+  absl::StatusOr<Subscribed*> Find(ActionInstanceId id);
+
+  // Reads the stream until it ends, and returns its final status.
+  absl::Status Stream(::grpc::ClientContext* context);
+  // Fetches all outputs once. Returns AbortedError if the session ended.
+  absl::Status FetchAll(absl::Time deadline);
+  // Publishes `output` if it is newer than the last one of `subscribed`.
+  void Publish(Subscribed& subscribed,
+               ::intrinsic_proto::icon::StreamingOutput output);
+
+  ::intrinsic_proto::icon::IconApi::StubInterface* const stub_;
+  const SessionId session_id_;
+  const absl::Duration period_;
+  FetchFn fetch_;
+  std::vector<std::unique_ptr<Subscribed>> subscribed_;
+  absl::flat_hash_map<ActionInstanceId, Subscribed*> subscribed_by_id_;
+  // Last, so that it stops before the members it uses are destroyed.
+  std::unique_ptr<StreamWatcher> watcher_;
+};
+
+}  // namespace intrinsic::icon
+
+#endif  // INTRINSIC_ICON_CC_CLIENT_OUTPUT_SUBSCRIPTION_H_
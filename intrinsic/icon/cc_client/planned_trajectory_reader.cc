@@ -0,0 +1,52 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/cc_client/planned_trajectory_reader.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/support/sync_stream.h"
+#include "intrinsic/icon/proto/joint_space.pb.h"
+#include "intrinsic/icon/proto/service.pb.h"
+#include "intrinsic/util/status/status_conversion_grpc.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic::icon {
+
+PlannedTrajectoryReader::PlannedTrajectoryReader(
+    std::unique_ptr<::grpc::ClientContext> context,
+    std::unique_ptr<::grpc::ClientReaderInterface<
+        ::intrinsic_proto::icon::GetPlannedTrajectoryResponse>>
+        stream)
+    : context_(std::move(context)), stream_(std::move(stream)) {}
+
+PlannedTrajectoryReader::~PlannedTrajectoryReader() {
+  if (finished_) {
+    return;
+  }
+  context_->TryCancel();
+  // Finish() may only be called once all messages have been read.
+  while (stream_->Read(&response_)) {
+  }
+  stream_->Finish();
+}
+
+absl::StatusOr<bool> PlannedTrajectoryReader::Next(
+    ::intrinsic_proto::icon::JointTrajectoryPVA* segment) {
+  if (finished_) {
+    return absl::FailedPreconditionError(
+        "All segments of the planned trajectory have been read.");
+  }
+  if (stream_->Read(&response_)) {
+    segment->Swap(response_.mutable_planned_trajectory_segment());
+    return true;
+  }
+  finished_ = true;
+  INTR_RETURN_IF_ERROR(ToAbslStatus(stream_->Finish()));
+  return false;
+}
+
+}  // namespace intrinsic::icon
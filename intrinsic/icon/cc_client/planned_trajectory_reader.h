@@ -0,0 +1,68 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_CC_CLIENT_PLANNED_TRAJECTORY_READER_H_
+#define INTRINSIC_ICON_CC_CLIENT_PLANNED_TRAJECTORY_READER_H_
+
+#include <memory>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/support/sync_stream.h"
+#include "intrinsic/icon/proto/joint_space.pb.h"
+#include "intrinsic/icon/proto/service.pb.h"
+
+namespace intrinsic::icon {
+
+// Reads the planned trajectory of an Action segment by segment, as the server
+// sends it, so that memory use stays proportional to the segment size instead
+// of the trajectory length.
+//
+// Obtain a PlannedTrajectoryReader from Session::ReadPlannedTrajectory(). It
+// must not outlive its Session.
+//
+// Example:
+//
+// std::unique_ptr<PlannedTrajectoryReader> reader =
+//     session->ReadPlannedTrajectory(action_id);
+// intrinsic_proto::icon::JointTrajectoryPVA segment;
+// while (true) {
+//   INTR_ASSIGN_OR_RETURN(bool has_segment, reader->Next(&segment));
+//   if (!has_segment) break;
+//   ... process segment ...
+// }
+class PlannedTrajectoryReader {
+ public:
+  PlannedTrajectoryReader(
+      std::unique_ptr<::grpc::ClientContext> context,
+      std::unique_ptr<::grpc::ClientReaderInterface<
+          ::intrinsic_proto::icon::GetPlannedTrajectoryResponse>>
+          stream);
+
+  // Cancels the request if not all segments have been read.
+  ~PlannedTrajectoryReader();
+
+  PlannedTrajectoryReader(const PlannedTrajectoryReader&) = delete;
+  PlannedTrajectoryReader& operator=(const PlannedTrajectoryReader&) = delete;
+
+  // Reads the next segment into `*segment` and returns true, or returns false
+  // once all segments have been read. Segments follow each other in time, see
+  // AppendTrajectoryProto() to join them.
+  //
+  // Returns the error of the request, if any, instead of false. Calling Next()
+  // again after it returned false or an error returns FailedPreconditionError.
+  absl::StatusOr<bool> Next(::intrinsic_proto::icon::JointTrajectoryPVA* segment);
+
+ private:
+  std::unique_ptr<::grpc::ClientContext> context_;
+  std::unique_ptr<::grpc::ClientReaderInterface<
+      ::intrinsic_proto::icon::GetPlannedTrajectoryResponse>>
+      stream_;
+  // Reused for all segments.
+  ::intrinsic_proto::icon::GetPlannedTrajectoryResponse response_;
+  bool finished_ = false;
+};
+
+}  // namespace intrinsic::icon
+
+#endif  // INTRINSIC_ICON_CC_CLIENT_PLANNED_TRAJECTORY_READER_H_
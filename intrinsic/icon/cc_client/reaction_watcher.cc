@@ -0,0 +1,146 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/cc_client/reaction_watcher.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/support/status.h"
+#include "intrinsic/icon/common/id_types.h"
+#include "intrinsic/icon/proto/service.grpc.pb.h"
+#include "intrinsic/icon/proto/service.pb.h"
+#include "intrinsic/icon/utils/trace_event.h"
+#include "intrinsic/util/status/status_conversion_grpc.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::icon {
+
+ReactionWatcher::Stream::Stream(std::shared_ptr<ReactionWatcher> watcher,
+                                std::unique_ptr<::grpc::ClientContext> context)
+    : watcher_(std::move(watcher)), context_(std::move(context)) {}
+
+ReactionWatcher::Stream::~Stream() {
+  if (!attached_ && ready_status_.ok()) {
+    // Watch() succeeded, but no operation is pending until Attach().
+    context_->TryCancel();
+    pending_ = Pending::kFinish;
+    reader_->Finish(&finish_status_, this);
+  }
+  finished_.WaitForNotification();
+}
+
+void ReactionWatcher::Stream::Attach(ResponseHandler on_response,
+                                     FinishHandler on_finish) {
+  on_response_ = std::move(on_response);
+  on_finish_ = std::move(on_finish);
+  attached_ = true;
+  pending_ = Pending::kRead;
+  reader_->Read(&response_, this);
+}
+
+void ReactionWatcher::Stream::WaitUntilFinished() {
+  finished_.WaitForNotification();
+}
+
+void ReactionWatcher::Stream::Proceed(bool ok) {
+  if (!ok && pending_ != Pending::kFinish) {
+    // The call ended, or failed to start.
+    pending_ = Pending::kFinish;
+    reader_->Finish(&finish_status_, this);
+    return;
+  }
+  switch (pending_) {
+    case Pending::kStart:
+      pending_ = Pending::kReady;
+      reader_->Read(&response_, this);
+      return;
+    case Pending::kReady:
+      if (response_.has_reaction_event()) {
+        FailReady(absl::InternalError(
+            "Should receive an empty reaction first to indicate that the "
+            "stream is ready."));
+        return;
+      }
+      // Wait for Attach() to read on.
+      ready_.Notify();
+      return;
+    case Pending::kRead:
+      on_response_(response_);
+      reader_->Read(&response_, this);
+      return;
+    case Pending::kFinish:
+      if (on_finish_ != nullptr) {
+        on_finish_(finish_status_);
+      }
+      if (ready_.HasBeenNotified()) {
+        finished_.Notify();
+        return;
+      }
+      if (ready_status_.ok()) {
+        ready_status_ = finish_status_.ok()
+                            ? absl::InternalError(
+                                  "Reaction stream ended before it was ready")
+                            : ToAbslStatus(finish_status_);
+      }
+      // Watch() may destroy the stream once `ready_` is notified.
+      finished_.Notify();
+      ready_.Notify();
+      return;
+  }
+}
+
+void ReactionWatcher::Stream::FailReady(absl::Status status) {
+  ready_status_ = std::move(status);
+  context_->TryCancel();
+  pending_ = Pending::kFinish;
+  reader_->Finish(&finish_status_, this);
+}
+
+// static
+std::shared_ptr<ReactionWatcher> ReactionWatcher::Create() {
+  // Private constructor, so no make_shared.
+  return std::shared_ptr<ReactionWatcher>(new ReactionWatcher());
+}
+
+ReactionWatcher::ReactionWatcher() {
+  // Start the thread only once all members are initialized.
+  thread_ = Thread(&ReactionWatcher::Run, this);
+}
+
+ReactionWatcher::~ReactionWatcher() {
+  cq_.Shutdown();
+  thread_.Join();
+}
+
+absl::StatusOr<std::unique_ptr<ReactionWatcher::Stream>>
+ReactionWatcher::Watch(intrinsic_proto::icon::IconApi::StubInterface* stub,
+                       std::unique_ptr<::grpc::ClientContext> context,
+                       SessionId session_id) {
+  // Private constructor, so no make_unique.
+  auto stream =
+      absl::WrapUnique(new Stream(shared_from_this(), std::move(context)));
+  intrinsic_proto::icon::WatchReactionsRequest request;
+  request.set_session_id(session_id.value());
+  stream->reader_ =
+      stub->PrepareAsyncWatchReactions(stream->context_.get(), request, &cq_);
+  stream->reader_->StartCall(stream.get());
+  stream->ready_.WaitForNotification();
+  INTR_RETURN_IF_ERROR(stream->ready_status_);
+  return stream;
+}
+
+void ReactionWatcher::Run() {
+  icon::TraceInitForThisThread("icon_reactions");
+  void* tag = nullptr;
+  bool ok = false;
+  while (cq_.Next(&tag, &ok)) {
+    static_cast<Stream*>(tag)->Proceed(ok);
+  }
+}
+
+}  // namespace intrinsic::icon
@@ -0,0 +1,135 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_CC_CLIENT_REACTION_WATCHER_H_
+#define INTRINSIC_ICON_CC_CLIENT_REACTION_WATCHER_H_
+
+#include <memory>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/notification.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/completion_queue.h"
+#include "grpcpp/support/async_stream.h"
+#include "grpcpp/support/status.h"
+#include "intrinsic/icon/common/id_types.h"
+#include "intrinsic/icon/proto/service.grpc.pb.h"
+#include "intrinsic/icon/proto/service.pb.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::icon {
+
+// Reads the WatchReactions streams of many Sessions on a single thread.
+//
+// By default, every Session reads its reaction events on a thread of its own,
+// which blocks in a synchronous Read() for the whole lifetime of the Session.
+// Sessions that are started with a ReactionWatcher instead share its thread,
+// which drives all of their streams through one completion queue and routes
+// each event to its Session. This saves a thread, and its stack, per Session
+// for clients that keep many Sessions open, e.g. in a SessionPool.
+//
+// Since all events are handled on one thread, a Session that blocks it delays
+// the reactions of all others. This happens when its event queue is full
+// because RunWatcherLoop() is not run, or when its executor blocks, see
+// Session::DispatchReactionsOn().
+//
+// Client::StartSession() shares a ReactionWatcher among the Sessions of a
+// Client. Otherwise, create one with Create() and pass it to Session::Start().
+// Sessions keep their ReactionWatcher alive. This class is thread-safe.
+class ReactionWatcher
+    : public std::enable_shared_from_this<ReactionWatcher> {
+ public:
+  // Called on the thread of the watcher with each reaction event of a stream.
+  // May move from the response.
+  using ResponseHandler = absl::AnyInvocable<void(
+      intrinsic_proto::icon::WatchReactionsResponse& response)>;
+  // Called on the thread of the watcher with the final status of a stream.
+  using FinishHandler = absl::AnyInvocable<void(const ::grpc::Status& status)>;
+
+  // The WatchReactions stream of one Session.
+  class Stream {
+   public:
+    // Waits for the stream to finish. Cancels it if Attach() was not called.
+    ~Stream();
+
+    Stream(const Stream&) = delete;
+    Stream& operator=(const Stream&) = delete;
+
+    // Starts passing the reaction events of the stream to `on_response`, and
+    // its final status to `on_finish`, once the stream ends. Must be called
+    // exactly once.
+    void Attach(ResponseHandler on_response, FinishHandler on_finish);
+
+    // Blocks until the stream has finished, that is, until `on_finish`
+    // returned. The server ends the stream when the action session ends.
+    void WaitUntilFinished();
+
+   private:
+    friend class ReactionWatcher;
+
+    // The operation that is pending on the completion queue, whose tag is the
+    // stream.
+    enum class Pending { kStart, kReady, kRead, kFinish };
+
+    Stream(std::shared_ptr<ReactionWatcher> watcher,
+           std::unique_ptr<::grpc::ClientContext> context);
+
+    // Handles the completion of the pending operation.
+    void Proceed(bool ok);
+
+    // Ends the stream before Attach() and reports `status` to Watch().
+    void FailReady(absl::Status status);
+
+    // Keeps the completion queue alive until the stream has finished.
+    const std::shared_ptr<ReactionWatcher> watcher_;
+    const std::unique_ptr<::grpc::ClientContext> context_;
+    std::unique_ptr<::grpc::ClientAsyncReaderInterface<
+        intrinsic_proto::icon::WatchReactionsResponse>>
+        reader_;
+    Pending pending_ = Pending::kStart;
+    intrinsic_proto::icon::WatchReactionsResponse response_;
+    ::grpc::Status finish_status_;
+    // The first response has been received, or the stream failed before.
+    absl::Notification ready_;
+    absl::Status ready_status_;
+    ResponseHandler on_response_;
+    FinishHandler on_finish_;
+    // Only accessed by the owner of the stream.
+    bool attached_ = false;
+    absl::Notification finished_;
+  };
+
+  static std::shared_ptr<ReactionWatcher> Create();
+
+  // Shuts down the completion queue. All streams have finished, since they
+  // keep the watcher alive.
+  ~ReactionWatcher();
+
+  ReactionWatcher(const ReactionWatcher&) = delete;
+  ReactionWatcher& operator=(const ReactionWatcher&) = delete;
+
+  // Opens the WatchReactions stream of the session with `session_id` through
+  // `stub`, and waits for the server to confirm that the stream is ready, so
+  // that no reaction of the session can be missed. Call Attach() on the result
+  // to start receiving events.
+  //
+  // Returns the status of the call if it ends early, and InternalError if the
+  // server does not confirm the stream.
+  absl::StatusOr<std::unique_ptr<Stream>> Watch(
+      intrinsic_proto::icon::IconApi::StubInterface* stub,
+      std::unique_ptr<::grpc::ClientContext> context, SessionId session_id);
+
+ private:
+  ReactionWatcher();
+
+  // Handles the completions of the streams until the queue is shut down.
+  void Run();
+
+  ::grpc::CompletionQueue cq_;
+  Thread thread_;
+};
+
+}  // namespace intrinsic::icon
+
+#endif  // INTRINSIC_ICON_CC_CLIENT_REACTION_WATCHER_H_
@@ -2,6 +2,8 @@
 
 #include "intrinsic/icon/cc_client/session.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -12,7 +14,9 @@
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/base/attributes.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/memory/memory.h"
@@ -21,6 +25,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
@@ -29,17 +34,24 @@
 #include "google/rpc/status.pb.h"
 #include "grpcpp/client_context.h"
 #include "grpcpp/support/sync_stream.h"
+#include "intrinsic/icon/cc_client/client_tracing.h"
 #include "intrinsic/icon/cc_client/condition.h"
+#include "intrinsic/icon/cc_client/output_subscription.h"
+#include "intrinsic/icon/cc_client/planned_trajectory_reader.h"
+#include "intrinsic/icon/cc_client/reaction_watcher.h"
 #include "intrinsic/icon/common/id_types.h"
 #include "intrinsic/icon/common/slot_part_map.h"
 #include "intrinsic/icon/proto/concatenate_trajectory_protos.h"
 #include "intrinsic/icon/proto/joint_space.pb.h"
+#include "intrinsic/icon/proto/joint_trajectory.h"
 #include "intrinsic/icon/proto/service.grpc.pb.h"
 #include "intrinsic/icon/proto/service.pb.h"
 #include "intrinsic/icon/proto/types.pb.h"
 #include "intrinsic/icon/release/source_location.h"
+#include "intrinsic/icon/utils/trace_event.h"
 #include "intrinsic/logging/proto/context.pb.h"
 #include "intrinsic/platform/common/buffers/realtime_write_queue.h"
+#include "intrinsic/util/allocation_tracking.h"
 #include "intrinsic/util/grpc/channel_interface.h"
 #include "intrinsic/util/proto_time.h"
 #include "intrinsic/util/status/status_conversion_grpc.h"
@@ -52,6 +64,8 @@ namespace icon {
 
 namespace {
 
+ABSL_CONST_INIT LazyAllocationTag kSessionAllocationTag("icon_session");
+
 constexpr char kAlreadyEndedErrorMessage[] = "The Session has already ended.";
 
 // Reads out the stream's read buffer until failure, and ends the call. Returns
@@ -254,6 +268,61 @@ ActionDescriptor& ActionDescriptor::WithReaction(
   return *this;
 }
 
+struct FillSlotData {
+  intrinsic_proto::icon::ActionInstance& action_instance_proto;
+  void operator()(const SlotPartMap& slot_part_map) {
+    *action_instance_proto.mutable_slot_part_map() = ToProto(slot_part_map);
+  }
+  void operator()(const std::string& part_name) {
+    action_instance_proto.set_part_name(part_name);
+  }
+};
+
+// static
+absl::StatusOr<ActionGraphTemplate> ActionGraphTemplate::Create(
+    absl::Span<const ActionDescriptor> action_descriptors) {
+  if (action_descriptors.empty()) {
+    return absl::InvalidArgumentError("Action graph template has no actions.");
+  }
+  ActionGraphTemplate graph;
+  graph.action_descriptors_ = std::vector<ActionDescriptor>(
+      action_descriptors.begin(), action_descriptors.end());
+  for (const ActionDescriptor& action_descriptor : action_descriptors) {
+    const int index = graph.request_.action_instances_size();
+    if (!graph.action_indices_.insert({action_descriptor.action_id_, index})
+             .second) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Action ", action_descriptor.action_id_.value(),
+                       " appears more than once in the template."));
+    }
+    intrinsic_proto::icon::ActionInstance* action_instance =
+        graph.request_.add_action_instances();
+    action_instance->set_action_type_name(action_descriptor.action_type_name_);
+    action_instance->set_action_instance_id(
+        action_descriptor.action_id_.value());
+    std::visit(FillSlotData{*action_instance}, action_descriptor.slot_data_);
+    if (action_descriptor.fixed_params_.has_value()) {
+      *action_instance->mutable_fixed_parameters() =
+          action_descriptor.fixed_params_.value();
+    }
+    for (const ReactionDescriptor& reaction_descriptor :
+         action_descriptor.reaction_descriptors_) {
+      graph.reaction_descriptors_.push_back(reaction_descriptor);
+      // The reaction id is set once the template is added.
+      *graph.request_.add_reactions() = ReactionDescriptor::ToProto(
+          reaction_descriptor, ReactionId(0), action_descriptor.action_id_);
+    }
+  }
+  return graph;
+}
+
+ActionTemplateParams& ActionTemplateParams::WithFixedParams(
+    ActionInstanceId action_id,
+    const ::google::protobuf::Message& fixed_params) {
+  fixed_params_[action_id].PackFrom(fixed_params);
+  return *this;
+}
+
 Action::Action(ActionInstanceId id) : id_(id) {}
 
 absl::StatusOr<std::unique_ptr<Session>> Session::Start(
@@ -264,7 +333,21 @@ absl::StatusOr<std::unique_ptr<Session>> Session::Start(
   return StartImpl(
       context, icon_channel,
       intrinsic_proto::icon::IconApi::NewStub(icon_channel->GetChannel()),
-      parts, icon_channel->GetClientContextFactory(), deadline);
+      parts, icon_channel->GetClientContextFactory(), deadline,
+      /*reaction_watcher=*/nullptr);
+}
+
+absl::StatusOr<std::unique_ptr<Session>> Session::Start(
+    std::shared_ptr<ChannelInterface> icon_channel,
+    std::shared_ptr<ReactionWatcher> reaction_watcher,
+    absl::Span<const std::string> parts,
+    const intrinsic_proto::data_logger::Context& context,
+    std::optional<absl::Time> deadline) {
+  return StartImpl(
+      context, icon_channel,
+      intrinsic_proto::icon::IconApi::NewStub(icon_channel->GetChannel()),
+      parts, icon_channel->GetClientContextFactory(), deadline,
+      std::move(reaction_watcher));
 }
 
 absl::StatusOr<std::unique_ptr<Session>> Session::Start(
@@ -274,7 +357,8 @@ absl::StatusOr<std::unique_ptr<Session>> Session::Start(
     const intrinsic_proto::data_logger::Context& context,
     std::optional<absl::Time> deadline) {
   return StartImpl(context, nullptr, std::move(stub), parts,
-                   client_context_factory, deadline);
+                   client_context_factory, deadline,
+                   /*reaction_watcher=*/nullptr);
 }
 
 absl::StatusOr<std::unique_ptr<Session>> Session::StartImpl(
@@ -283,7 +367,10 @@ absl::StatusOr<std::unique_ptr<Session>> Session::StartImpl(
     std::unique_ptr<intrinsic_proto::icon::IconApi::StubInterface> stub,
     absl::Span<const std::string> parts,
     const ClientContextFactory& client_context_factory,
-    std::optional<absl::Time> deadline) {
+    std::optional<absl::Time> deadline,
+    std::shared_ptr<ReactionWatcher> reaction_watcher) {
+  ScopedAllocationTag allocation_tag(kSessionAllocationTag);
+  ScopedClientTrace trace(ClientTracePoint::kSessionStart);
   std::unique_ptr<grpc::ClientContext> start_session_context =
       client_context_factory();
   std::unique_ptr<grpc::ClientReaderWriterInterface<
@@ -300,6 +387,18 @@ absl::StatusOr<std::unique_ptr<Session>> Session::StartImpl(
   // i.e. when the watcher loop is run.
   std::unique_ptr<grpc::ClientContext> watcher_context =
       client_context_factory();
+  if (reaction_watcher != nullptr) {
+    INTR_ASSIGN_OR_RETURN(
+        std::unique_ptr<ReactionWatcher::Stream> shared_watcher_stream,
+        reaction_watcher->Watch(stub.get(), std::move(watcher_context),
+                                session_id));
+    LOG(INFO) << "Session started with context: " << context;
+    return absl::WrapUnique(new Session(
+        std::move(icon_channel), std::move(start_session_context),
+        std::move(action_stream), /*watcher_context=*/nullptr,
+        /*watcher_stream=*/nullptr, std::move(shared_watcher_stream),
+        std::move(stub), session_id, context, client_context_factory));
+  }
   intrinsic_proto::icon::WatchReactionsRequest watch_reactions_request;
   watch_reactions_request.set_session_id(session_id.value());
   std::unique_ptr<grpc::ClientReaderInterface<
@@ -323,8 +422,9 @@ absl::StatusOr<std::unique_ptr<Session>> Session::StartImpl(
   return absl::WrapUnique(
       new Session(std::move(icon_channel), std::move(start_session_context),
                   std::move(action_stream), std::move(watcher_context),
-                  std::move(watcher_stream), std::move(stub), session_id,
-                  context, client_context_factory));
+                  std::move(watcher_stream), /*shared_watcher_stream=*/nullptr,
+                  std::move(stub), session_id, context,
+                  client_context_factory));
 }
 
 Session::~Session() {
@@ -345,20 +445,48 @@ absl::StatusOr<Action> Session::AddAction(
   return actions[0];
 }
 
-struct FillSlotData {
-  intrinsic_proto::icon::ActionInstance& action_instance_proto;
-  void operator()(const SlotPartMap& slot_part_map) {
-    *action_instance_proto.mutable_slot_part_map() = ToProto(slot_part_map);
-  }
-  void operator()(const std::string& part_name) {
-    action_instance_proto.set_part_name(part_name);
-  }
-};
-
 absl::StatusOr<std::vector<Action>> Session::AddActions(
     absl::Span<const ActionDescriptor> action_descriptors) {
+  return AddActionsAsync(action_descriptors).Get();
+}
+
+SessionFuture<std::vector<Action>> Session::AddActionsAsync(
+    absl::Span<const ActionDescriptor> action_descriptors) {
+  return AddActionsImpl(action_descriptors,
+                        /*start_actions_request=*/std::nullopt);
+}
+
+absl::StatusOr<std::vector<Action>> Session::AddActionsAndStart(
+    absl::Span<const ActionDescriptor> action_descriptors,
+    absl::Span<const ActionInstanceId> start_action_ids,
+    bool stop_active_actions) {
+  return AddActionsAndStartAsync(action_descriptors, start_action_ids,
+                                 stop_active_actions)
+      .Get();
+}
+
+SessionFuture<std::vector<Action>> Session::AddActionsAndStartAsync(
+    absl::Span<const ActionDescriptor> action_descriptors,
+    absl::Span<const ActionInstanceId> start_action_ids,
+    bool stop_active_actions) {
+  intrinsic_proto::icon::OpenSessionRequest::StartActionsRequestData
+      start_actions_request;
+  start_actions_request.set_stop_active_actions(stop_active_actions);
+  for (ActionInstanceId action_id : start_action_ids) {
+    start_actions_request.add_action_instance_ids(action_id.value());
+  }
+  return AddActionsImpl(action_descriptors, start_actions_request);
+}
+
+SessionFuture<std::vector<Action>> Session::AddActionsImpl(
+    absl::Span<const ActionDescriptor> action_descriptors,
+    std::optional<
+        intrinsic_proto::icon::OpenSessionRequest::StartActionsRequestData>
+        start_actions_request) {
+  ScopedAllocationTag allocation_tag(kSessionAllocationTag);
   if (session_ended_) {
-    return absl::FailedPreconditionError(kAlreadyEndedErrorMessage);
+    return SessionFuture<std::vector<Action>>(
+        absl::FailedPreconditionError(kAlreadyEndedErrorMessage));
   }
   // First, check the union of all new reaction handles with the existing
   // handles for uniqueness.
@@ -367,7 +495,11 @@ absl::StatusOr<std::vector<Action>> Session::AddActions(
     absl::c_copy(action_descriptor.reaction_descriptors_,
                  std::back_inserter(new_reaction_descriptors));
   }
-  INTR_RETURN_IF_ERROR(CheckReactionHandlesUnique(new_reaction_descriptors));
+  if (absl::Status status =
+          CheckReactionHandlesUnique(new_reaction_descriptors);
+      !status.ok()) {
+    return SessionFuture<std::vector<Action>>(status);
+  }
 
   absl::flat_hash_map<ReactionId, ReactionDescriptor>
       reaction_descriptors_by_id;
@@ -400,14 +532,88 @@ absl::StatusOr<std::vector<Action>> Session::AddActions(
                                       action_descriptor.action_id_);
     }
   }
-  INTR_ASSIGN_OR_RETURN(intrinsic_proto::icon::OpenSessionResponse response,
-                        GetResponseOrEnd(request));
-  INTR_RETURN_IF_ERROR(EndAndLogOnAbort(response.status()));
+  if (start_actions_request.has_value()) {
+    *request.mutable_start_actions_request() = *start_actions_request;
+  }
+
+  return SendAddActionsRequest(request, std::move(reaction_descriptors_by_id),
+                               MakeActionVector(action_descriptors));
+}
 
-  // Save any callbacks and ReactionHandles for the successfully added
-  // reactions.
+SessionFuture<std::vector<Action>> Session::SendAddActionsRequest(
+    const intrinsic_proto::icon::OpenSessionRequest& request,
+    absl::flat_hash_map<ReactionId, ReactionDescriptor>
+        reaction_descriptors_by_id,
+    std::vector<Action> actions) {
+  // Save any callbacks and ReactionHandles right away, so that requests sent
+  // before this one is answered see the handles as taken. They are erased
+  // again if the server does not add the reactions.
   SaveReactionData(reaction_descriptors_by_id);
-  return MakeActionVector(action_descriptors);
+  SessionFuture<std::vector<Action>> future(this,
+                                            next_request_sequence_number_);
+  WriteRequest(
+      request,
+      [this, result = future.result_,
+       reaction_descriptors_by_id = std::move(reaction_descriptors_by_id),
+       actions = std::move(actions)](
+          absl::StatusOr<intrinsic_proto::icon::OpenSessionResponse>
+              response) mutable {
+        if (absl::Status status = ResponseStatus(response); !status.ok()) {
+          EraseReactionData(reaction_descriptors_by_id);
+          *result = std::move(status);
+          return;
+        }
+        *result = std::move(actions);
+      });
+  return future;
+}
+
+absl::StatusOr<std::vector<Action>> Session::AddActionsFromTemplate(
+    const ActionGraphTemplate& graph, const ActionTemplateParams& params) {
+  return AddActionsFromTemplateAsync(graph, params).Get();
+}
+
+SessionFuture<std::vector<Action>> Session::AddActionsFromTemplateAsync(
+    const ActionGraphTemplate& graph, const ActionTemplateParams& params) {
+  if (session_ended_) {
+    return SessionFuture<std::vector<Action>>(
+        absl::FailedPreconditionError(kAlreadyEndedErrorMessage));
+  }
+  if (absl::Status status =
+          CheckReactionHandlesUnique(graph.reaction_descriptors_);
+      !status.ok()) {
+    return SessionFuture<std::vector<Action>>(status);
+  }
+
+  intrinsic_proto::icon::OpenSessionRequest request;
+  intrinsic_proto::icon::ActionsAndReactions* actions_and_reactions =
+      request.mutable_add_actions_and_reactions();
+  *actions_and_reactions = graph.request_;
+  for (const auto& [action_id, fixed_params] : params.fixed_params_) {
+    auto it = graph.action_indices_.find(action_id);
+    if (it == graph.action_indices_.end()) {
+      return SessionFuture<std::vector<Action>>(
+          absl::InvalidArgumentError(absl::StrCat(
+              "Action ", action_id.value(), " is not part of the template.")));
+    }
+    *actions_and_reactions->mutable_action_instances(it->second)
+         ->mutable_fixed_parameters() = fixed_params;
+  }
+
+  absl::flat_hash_map<ReactionId, ReactionDescriptor>
+      reaction_descriptors_by_id;
+  for (int i = 0; i < actions_and_reactions->reactions_size(); ++i) {
+    ReactionId reaction_id = reaction_id_sequence_.GetNext();
+    CHECK(reaction_descriptors_by_id
+              .insert({reaction_id, graph.reaction_descriptors_[i]})
+              .second)
+        << "SequenceNumber generated duplicate ReactionId: "
+        << reaction_id.value();
+    actions_and_reactions->mutable_reactions(i)->set_reaction_instance_id(
+        reaction_id.value());
+  }
+  return SendAddActionsRequest(request, std::move(reaction_descriptors_by_id),
+                               MakeActionVector(graph.action_descriptors_));
 }
 
 absl::Status Session::AddFreestandingReaction(
@@ -417,10 +623,19 @@ absl::Status Session::AddFreestandingReaction(
 
 absl::Status Session::AddFreestandingReactions(
     absl::Span<const ReactionDescriptor> reaction_descriptors) {
+  return AddFreestandingReactionsAsync(reaction_descriptors).Get();
+}
+
+SessionFuture<> Session::AddFreestandingReactionsAsync(
+    absl::Span<const ReactionDescriptor> reaction_descriptors) {
   if (session_ended_) {
-    return absl::FailedPreconditionError(kAlreadyEndedErrorMessage);
+    return SessionFuture<>(
+        absl::FailedPreconditionError(kAlreadyEndedErrorMessage));
+  }
+  if (absl::Status status = CheckReactionHandlesUnique(reaction_descriptors);
+      !status.ok()) {
+    return SessionFuture<>(status);
   }
-  INTR_RETURN_IF_ERROR(CheckReactionHandlesUnique(reaction_descriptors));
 
   absl::flat_hash_map<ReactionId, ReactionDescriptor>
       reaction_descriptors_by_id;
@@ -435,15 +650,23 @@ absl::Status Session::AddFreestandingReactions(
         ReactionDescriptor::ToProto(reaction_descriptor, reaction_id,
                                     std::nullopt);
   }
-  INTR_ASSIGN_OR_RETURN(
-      const intrinsic_proto::icon::OpenSessionResponse response,
-      GetResponseOrEnd(request));
-  INTR_RETURN_IF_ERROR(EndAndLogOnAbort(response.status()));
 
-  // Save any callbacks and ReactionHandles for the successfully added
-  // reactions.
+  // Save any callbacks and ReactionHandles right away, see AddActionsImpl().
   SaveReactionData(reaction_descriptors_by_id);
-  return absl::OkStatus();
+  SessionFuture<> future(this, next_request_sequence_number_);
+  WriteRequest(
+      request,
+      [this, result = future.result_,
+       reaction_descriptors_by_id = std::move(reaction_descriptors_by_id)](
+          absl::StatusOr<intrinsic_proto::icon::OpenSessionResponse>
+              response) mutable {
+        absl::Status status = ResponseStatus(response);
+        if (!status.ok()) {
+          EraseReactionData(reaction_descriptors_by_id);
+        }
+        *result = std::move(status);
+      });
+  return future;
 }
 
 absl::Status Session::RemoveAction(ActionInstanceId action_id) {
@@ -452,8 +675,14 @@ absl::Status Session::RemoveAction(ActionInstanceId action_id) {
 
 absl::Status Session::RemoveActions(
     const std::vector<ActionInstanceId>& action_ids) {
+  return RemoveActionsAsync(action_ids).Get();
+}
+
+SessionFuture<> Session::RemoveActionsAsync(
+    const std::vector<ActionInstanceId>& action_ids) {
   if (session_ended_) {
-    return absl::FailedPreconditionError(kAlreadyEndedErrorMessage);
+    return SessionFuture<>(
+        absl::FailedPreconditionError(kAlreadyEndedErrorMessage));
   }
 
   intrinsic_proto::icon::OpenSessionRequest request;
@@ -461,11 +690,7 @@ absl::Status Session::RemoveActions(
     request.mutable_remove_action_and_reaction_ids()->add_action_instance_ids(
         action_id.value());
   }
-
-  INTR_ASSIGN_OR_RETURN(intrinsic_proto::icon::OpenSessionResponse response,
-                        GetResponseOrEnd(request));
-
-  return EndAndLogOnAbort(response.status());
+  return SendRequest(request);
 }
 
 absl::Status Session::ClearAllActionsAndReactions() {
@@ -475,10 +700,13 @@ absl::Status Session::ClearAllActionsAndReactions() {
 
   intrinsic_proto::icon::OpenSessionRequest request;
   request.mutable_clear_all_actions_reactions();
-  INTR_ASSIGN_OR_RETURN(intrinsic_proto::icon::OpenSessionResponse response,
-                        GetResponseOrEnd(request));
-
-  return EndAndLogOnAbort(response.status());
+  INTR_RETURN_IF_ERROR(SendRequest(request).Get());
+  // The server has dropped all reactions, so forget their handles and
+  // callbacks. This lets ReactionHandles be reused afterwards.
+  reaction_handle_to_id_and_loc_.clear();
+  absl::MutexLock lock(&reaction_callbacks_mutex_);
+  reaction_callbacks_.clear();
+  return absl::OkStatus();
 }
 
 absl::Status Session::StartAction(const Action& action,
@@ -488,8 +716,14 @@ absl::Status Session::StartAction(const Action& action,
 
 absl::Status Session::StartActions(absl::Span<const Action> actions,
                                    bool stop_active_actions) {
+  return StartActionsAsync(actions, stop_active_actions).Get();
+}
+
+SessionFuture<> Session::StartActionsAsync(absl::Span<const Action> actions,
+                                           bool stop_active_actions) {
   if (session_ended_) {
-    return absl::FailedPreconditionError(kAlreadyEndedErrorMessage);
+    return SessionFuture<>(
+        absl::FailedPreconditionError(kAlreadyEndedErrorMessage));
   }
   intrinsic_proto::icon::OpenSessionRequest::StartActionsRequestData
       start_actions_request;
@@ -499,9 +733,8 @@ absl::Status Session::StartActions(absl::Span<const Action> actions,
   }
   intrinsic_proto::icon::OpenSessionRequest request;
   *request.mutable_start_actions_request() = start_actions_request;
-  INTR_ASSIGN_OR_RETURN(intrinsic_proto::icon::OpenSessionResponse response,
-                        GetResponseOrEnd(request));
-  return EndAndLogOnAbort(response.status());
+  icon::TraceInstant("icon_client", "StartActions");
+  return SendRequest(request);
 }
 
 absl::Status Session::StopAllActions() {
@@ -511,8 +744,7 @@ absl::Status Session::StopAllActions() {
 absl::Status Session::RunWatcherLoop(absl::Time deadline) {
   quit_watcher_loop_ = false;
   while (true) {
-    absl::StatusOr<std::optional<intrinsic_proto::icon::WatchReactionsResponse>>
-        response;
+    absl::StatusOr<std::optional<ReceivedReaction>> response;
     ReadResult result =
         reactions_queue_.Reader().ReadWithTimeout(response, deadline);
     if (result == ReadResult::kDeadlineExceeded) {
@@ -567,6 +799,19 @@ void Session::QuitWatcherLoop() {
   }
 }
 
+absl::Status Session::DispatchReactionsOn(ReactionExecutor executor) {
+  if (session_ended_) {
+    return absl::FailedPreconditionError(kAlreadyEndedErrorMessage);
+  }
+  if (dispatch_on_executor_.load(std::memory_order_relaxed)) {
+    return absl::FailedPreconditionError(
+        "Reactions are already dispatched on an executor.");
+  }
+  reaction_executor_ = std::move(executor);
+  dispatch_on_executor_.store(true, std::memory_order_release);
+  return absl::OkStatus();
+}
+
 absl::StatusOr<::intrinsic_proto::icon::StreamingOutput>
 Session::GetLatestOutput(ActionInstanceId id, absl::Time deadline) {
   std::unique_ptr<grpc::ClientContext> context = client_context_factory_();
@@ -580,27 +825,68 @@ Session::GetLatestOutput(ActionInstanceId id, absl::Time deadline) {
   return response.output();
 }
 
+absl::StatusOr<std::unique_ptr<OutputSubscription>> Session::SubscribeOutputs(
+    absl::Span<const ActionInstanceId> action_ids, absl::Duration period) {
+  if (session_ended_) {
+    return absl::FailedPreconditionError(kAlreadyEndedErrorMessage);
+  }
+  return OutputSubscription::Create(
+      stub_.get(), client_context_factory_, session_id_, action_ids, period,
+      [this](ActionInstanceId id, absl::Time deadline) {
+        return GetLatestOutput(id, deadline);
+      });
+}
+
 absl::StatusOr<::intrinsic_proto::icon::JointTrajectoryPVA>
 Session::GetPlannedTrajectory(ActionInstanceId id) {
+  std::unique_ptr<PlannedTrajectoryReader> reader = ReadPlannedTrajectory(id);
+  ::intrinsic_proto::icon::JointTrajectoryPVA planned_trajectory;
+  ::intrinsic_proto::icon::JointTrajectoryPVA segment;
+  bool has_segments = false;
+  while (true) {
+    INTR_ASSIGN_OR_RETURN(bool has_segment, reader->Next(&segment));
+    if (!has_segment) break;
+    has_segments = true;
+    INTR_RETURN_IF_ERROR(
+        AppendTrajectoryProto(std::move(segment), &planned_trajectory));
+  }
+  if (!has_segments) {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "Planned trajectory of action ", id.value(), " is empty."));
+  }
+  return planned_trajectory;
+}
+
+absl::StatusOr<JointTrajectory> Session::GetPlannedJointTrajectory(
+    ActionInstanceId id) {
+  std::unique_ptr<PlannedTrajectoryReader> reader = ReadPlannedTrajectory(id);
+  JointTrajectory planned_trajectory;
+  ::intrinsic_proto::icon::JointTrajectoryPVA segment;
+  bool has_segments = false;
+  while (true) {
+    INTR_ASSIGN_OR_RETURN(bool has_segment, reader->Next(&segment));
+    if (!has_segment) break;
+    has_segments = true;
+    INTR_RETURN_IF_ERROR(planned_trajectory.Append(segment));
+  }
+  if (!has_segments) {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "Planned trajectory of action ", id.value(), " is empty."));
+  }
+  return planned_trajectory;
+}
+
+std::unique_ptr<PlannedTrajectoryReader> Session::ReadPlannedTrajectory(
+    ActionInstanceId id) {
   std::unique_ptr<grpc::ClientContext> context = client_context_factory_();
   ::intrinsic_proto::icon::GetPlannedTrajectoryRequest request;
   request.set_session_id(session_id_.value());
   request.set_action_id(id.value());
-
   std::unique_ptr<::grpc::ClientReaderInterface<
       ::intrinsic_proto::icon::GetPlannedTrajectoryResponse>>
       stream = stub_->GetPlannedTrajectory(context.get(), request);
-
-  ::intrinsic_proto::icon::GetPlannedTrajectoryResponse response;
-  std::vector<::intrinsic_proto::icon::JointTrajectoryPVA>
-      planned_trajectory_segments;
-  while (stream->Read(&response)) {
-    planned_trajectory_segments.push_back(
-        response.planned_trajectory_segment());
-  }
-  INTR_RETURN_IF_ERROR(ToAbslStatus(stream->Finish()));
-
-  return ConcatenateTrajectoryProtos(planned_trajectory_segments);
+  return std::make_unique<PlannedTrajectoryReader>(std::move(context),
+                                                   std::move(stream));
 }
 
 absl::Status Session::RunWatcherLoopUntilReaction(
@@ -612,18 +898,28 @@ absl::Status Session::RunWatcherLoopUntilReaction(
                      reaction_handle.value(), ")"));
   }
   const ReactionId reaction_id = maybe_id->second.first;
-  auto [it, inserted] = reaction_callback_map_.insert(
-      {reaction_id, [this, reaction_id] {
-         reaction_callback_map_.erase(reaction_id);
-         this->QuitWatcherLoop();
-       }});
-  if (!inserted) {
-    std::function<void()> previous_callback = it->second;
-    it->second = [this, previous_callback, reaction_id] {
-      previous_callback();
-      reaction_callback_map_.insert_or_assign(reaction_id, previous_callback);
-      this->QuitWatcherLoop();
-    };
+  {
+    absl::MutexLock lock(&reaction_callbacks_mutex_);
+    std::function<void()>& callback = ReactionCallbackEntry(reaction_id);
+    if (!callback) {
+      callback = [this, reaction_id] {
+        {
+          absl::MutexLock lock(&reaction_callbacks_mutex_);
+          ReactionCallbackEntry(reaction_id) = nullptr;
+        }
+        this->QuitWatcherLoop();
+      };
+    } else {
+      std::function<void()> previous_callback = callback;
+      callback = [this, previous_callback, reaction_id] {
+        previous_callback();
+        {
+          absl::MutexLock lock(&reaction_callbacks_mutex_);
+          ReactionCallbackEntry(reaction_id) = previous_callback;
+        }
+        this->QuitWatcherLoop();
+      };
+    }
   }
   return RunWatcherLoop(deadline);
 }
@@ -635,6 +931,12 @@ absl::Status Session::End() {
   session_ended_ = true;
   QuitWatcherLoop();  // stop triggering client callbacks.
 
+  // Resolve the futures of requests that are still in flight before closing
+  // the call, so that their responses are not mistaken for unexpected ones.
+  if (!pending_responses_.empty()) {
+    ReadResponsesUntil(pending_responses_.back().sequence_number);
+  }
+
   // Close the action session call
   action_stream_->WritesDone();
   // The server ends all watcher streams when the action session ends, so we
@@ -645,7 +947,11 @@ absl::Status Session::End() {
   // Ensure that we've stopped reading reactions from the `watcher_stream_`
   // before finishing the watch reactions call to avoid calling
   // watcher_stream_.Read() concurrently from multiple threads.
-  watcher_read_thread_.Join();
+  if (shared_watcher_stream_ != nullptr) {
+    shared_watcher_stream_->WaitUntilFinished();
+  } else {
+    watcher_read_thread_.Join();
+  }
   CleanUpWatcherCall();
   return session_call_status;
 }
@@ -661,6 +967,7 @@ Session::Session(
     std::unique_ptr<grpc::ClientReaderInterface<
         intrinsic_proto::icon::WatchReactionsResponse>>
         watcher_stream,
+    std::unique_ptr<ReactionWatcher::Stream> shared_watcher_stream,
     std::unique_ptr<intrinsic_proto::icon::IconApi::StubInterface> stub,
     SessionId session_id, const intrinsic_proto::data_logger::Context& context,
     ClientContextFactory client_context_factory)
@@ -670,10 +977,23 @@ Session::Session(
       action_stream_(std::move(action_stream)),
       watcher_context_(std::move(watcher_context)),
       watcher_stream_(std::move(watcher_stream)),
-      watcher_read_thread_(&Session::WatchReactionsThreadBody, this),
+      shared_watcher_stream_(std::move(shared_watcher_stream)),
       stub_(std::move(stub)),
       session_id_(session_id),
-      client_context_factory_(client_context_factory) {}
+      client_context_factory_(client_context_factory) {
+  // Start reading reactions only once all members are initialized.
+  if (shared_watcher_stream_ != nullptr) {
+    shared_watcher_stream_->Attach(
+        [this](intrinsic_proto::icon::WatchReactionsResponse& response) {
+          HandleReactionResponse(response);
+        },
+        [this](const ::grpc::Status& grpc_status) {
+          HandleWatcherCallEnd(grpc_status);
+        });
+  } else {
+    watcher_read_thread_ = Thread(&Session::WatchReactionsThreadBody, this);
+  }
+}
 
 absl::Status Session::CheckReactionHandlesUnique(
     absl::Span<const ReactionDescriptor> reaction_descriptors) const {
@@ -718,58 +1038,170 @@ void Session::SaveReactionData(
              "happen.";
     }
     if (reaction_descriptor.on_condition_) {
-      // If we fail to insert the callback, there's a serious bug in
+      absl::MutexLock lock(&reaction_callbacks_mutex_);
+      std::function<void()>& callback = ReactionCallbackEntry(reaction_id);
+      // If the entry is taken already, there's a serious bug in
       // SequenceNumber.
-      CHECK(
-          reaction_callback_map_
-              .insert({reaction_id, reaction_descriptor.on_condition_.value()})
-              .second)
-          << "Trying to insert duplicate Reaction callback in "
-             "SaveReactionData. The server should guarantee this does not "
-             "happen.";
+      CHECK(!callback) << "Trying to insert duplicate Reaction callback in "
+                          "SaveReactionData. The server should guarantee this "
+                          "does not happen.";
+      callback = reaction_descriptor.on_condition_.value();
     }
   }
 }
 
-absl::StatusOr<intrinsic_proto::icon::OpenSessionResponse>
-Session::GetResponseOrEnd(
+void Session::EraseReactionData(
+    const absl::flat_hash_map<ReactionId, ReactionDescriptor>&
+        reaction_descriptors_by_id) {
+  for (const auto& [reaction_id, reaction_descriptor] :
+       reaction_descriptors_by_id) {
+    if (reaction_descriptor.reaction_handle_) {
+      reaction_handle_to_id_and_loc_.erase(
+          reaction_descriptor.reaction_handle_->first);
+    }
+    if (reaction_descriptor.on_condition_) {
+      absl::MutexLock lock(&reaction_callbacks_mutex_);
+      ReactionCallbackEntry(reaction_id) = nullptr;
+    }
+  }
+}
+
+SessionFuture<> Session::SendRequest(
     const intrinsic_proto::icon::OpenSessionRequest& request) {
-  absl::StatusOr<intrinsic_proto::icon::OpenSessionResponse>
-      status_or_response =
-          WriteMessageAndReadResponse(request, action_stream_.get());
-  if (!status_or_response.ok()) {
-    LOG(ERROR) << "Call died while completing message exchange: "
-               << status_or_response.status();
-    absl::Status session_status = End();
-    LOG(ERROR) << "Ended session with status: " << session_status;
-    return absl::AbortedError(
+  SessionFuture<> future(this, next_request_sequence_number_);
+  WriteRequest(request,
+               [this, result = future.result_](
+                   absl::StatusOr<intrinsic_proto::icon::OpenSessionResponse>
+                       response) { *result = ResponseStatus(response); });
+  return future;
+}
+
+uint64_t Session::WriteRequest(
+    const intrinsic_proto::icon::OpenSessionRequest& request,
+    ResponseHandler on_response) {
+  ScopedAllocationTag allocation_tag(kSessionAllocationTag);
+  const uint64_t sequence_number = next_request_sequence_number_++;
+  pending_responses_.push_back(PendingResponse{
+      .sequence_number = sequence_number,
+      .on_response = std::move(on_response),
+      .send_time =
+          ClientTracingEnabled() ? absl::Now() : absl::InfinitePast()});
+  if (!action_stream_->Write(request)) {
+    // The call is dead. Reading fails as well, which resolves this and all
+    // earlier requests and ends the session.
+    ReadResponsesUntil(sequence_number);
+  }
+  return sequence_number;
+}
+
+void Session::ReadResponsesUntil(uint64_t sequence_number) {
+  ScopedAllocationTag allocation_tag(kSessionAllocationTag);
+  while (!pending_responses_.empty() &&
+         pending_responses_.front().sequence_number <= sequence_number) {
+    // Remove the handler before calling it: it may end the session, which
+    // reads the remaining responses.
+    PendingResponse pending = std::move(pending_responses_.front());
+    pending_responses_.pop_front();
+    intrinsic_proto::icon::OpenSessionResponse response;
+    bool read_ok;
+    {
+      ScopedClientTrace trace(ClientTracePoint::kSessionResponseWait);
+      read_ok = action_stream_->Read(&response);
+    }
+    if (read_ok) {
+      if (pending.send_time != absl::InfinitePast()) {
+        RecordClientLatency(ClientTracePoint::kSessionRoundTrip,
+                            absl::Now() - pending.send_time);
+      }
+      std::move(pending.on_response)(std::move(response));
+      continue;
+    }
+
+    LOG(ERROR) << "Call died while completing message exchange.";
+    const absl::Status aborted = absl::AbortedError(
         "The session ended while performing a remote operation.");
+    std::move(pending.on_response)(aborted);
+    while (!pending_responses_.empty()) {
+      std::move(pending_responses_.front().on_response)(aborted);
+      pending_responses_.pop_front();
+    }
+    if (!session_ended_) {
+      absl::Status session_status = End();
+      LOG(ERROR) << "Ended session with status: " << session_status;
+    }
+    return;
   }
+}
 
-  return *status_or_response;
+absl::Status Session::ResponseStatus(
+    const absl::StatusOr<intrinsic_proto::icon::OpenSessionResponse>&
+        response) {
+  if (!response.ok()) {
+    return response.status();
+  }
+  return EndAndLogOnAbort(response->status());
 }
 
-void Session::TriggerReactionCallbacks(
-    const intrinsic_proto::icon::WatchReactionsResponse& reaction) {
-  if (!reaction.has_reaction_event()) {
+void Session::TriggerReactionCallbacks(const ReceivedReaction& reaction) {
+  if (!reaction.response.has_reaction_event()) {
     return;
   }
 
-  ReactionId reaction_id(reaction.reaction_event().reaction_id());
-  auto reaction_callback = reaction_callback_map_.find(reaction_id);
-  if (reaction_callback == reaction_callback_map_.end()) {
+  // Runs a copy, so that the callback may replace its own entry.
+  std::function<void()> reaction_callback = GetReactionCallback(
+      ReactionId(reaction.response.reaction_event().reaction_id()));
+  if (!reaction_callback) {
     return;
   }
-  reaction_callback->second();
+  RecordClientLatency(ClientTracePoint::kReactionQueueDelay,
+                      absl::Now() - reaction.receive_time);
+  ScopedClientTrace trace(ClientTracePoint::kReactionCallback);
+  reaction_callback();
+}
+
+void Session::DispatchReactionCallbacks(const ReceivedReaction& reaction) {
+  if (!reaction.response.has_reaction_event()) {
+    return;
+  }
+  INTRINSIC_TRACE_SCOPE("icon_client", "ReactionCallback");
+
+  std::function<void()> reaction_callback = GetReactionCallback(
+      ReactionId(reaction.response.reaction_event().reaction_id()));
+  if (!reaction_callback) {
+    return;
+  }
+  reaction_executor_([reaction_callback = std::move(reaction_callback),
+                      receive_time = reaction.receive_time]() mutable {
+    RecordClientLatency(ClientTracePoint::kReactionQueueDelay,
+                        absl::Now() - receive_time);
+    ScopedClientTrace trace(ClientTracePoint::kReactionCallback);
+    reaction_callback();
+  });
+}
+
+std::function<void()> Session::GetReactionCallback(ReactionId reaction_id) {
+  absl::ReaderMutexLock lock(&reaction_callbacks_mutex_);
+  if (reaction_id.value() < 0 ||
+      reaction_id.value() >= static_cast<int64_t>(reaction_callbacks_.size())) {
+    return nullptr;
+  }
+  return reaction_callbacks_[reaction_id.value()];
+}
+
+std::function<void()>& Session::ReactionCallbackEntry(ReactionId reaction_id) {
+  const size_t index = static_cast<size_t>(reaction_id.value());
+  if (index >= reaction_callbacks_.size()) {
+    reaction_callbacks_.resize(index + 1);
+  }
+  return reaction_callbacks_[index];
 }
 
 void Session::CleanUpWatcherCall() {
-  absl::StatusOr<std::optional<intrinsic_proto::icon::WatchReactionsResponse>>
-      response = std::nullopt;
+  absl::StatusOr<std::optional<ReceivedReaction>> response = std::nullopt;
   while (reactions_queue_.Reader().Read(response) == ReadResult::kConsumed) {
     if (response.ok() && response->has_value()) {
       DLOG(INFO) << "Had reaction event in queue after quitting watcher loop: "
-                 << response->value();
+                 << response->value().response;
     }
   }
   LOG(INFO) << "Ended watcher call";
@@ -789,21 +1221,41 @@ absl::Status Session::EndAndLogOnAbort(const ::google::rpc::Status& status) {
 }
 
 void Session::WatchReactionsThreadBody() {
-  intrinsic_proto::icon::WatchReactionsResponse watcher_reactions_response;
+  icon::TraceInitForThisThread("icon_reactions");
+  ScopedAllocationTag allocation_tag(kSessionAllocationTag);
+  intrinsic_proto::icon::WatchReactionsResponse response;
   // Read will return false when the call ends. The call normally ends when the
   // session is over. If the call ends earlier, it's due to a connection failure
   // or a bug on the server.
-  while (watcher_stream_->Read(&watcher_reactions_response)) {
-    // Block until the response can be written to the queue.
-    absl::MutexLock l(&reactions_queue_writer_mutex_);
-    while (!reactions_queue_.Writer().Write(watcher_reactions_response)) {
-    }
+  while (watcher_stream_->Read(&response)) {
+    HandleReactionResponse(response);
+  }
+  HandleWatcherCallEnd(watcher_stream_->Finish());
+}
+
+void Session::HandleReactionResponse(
+    intrinsic_proto::icon::WatchReactionsResponse& response) {
+  ReceivedReaction received = {.response = std::move(response),
+                               .receive_time = absl::Now()};
+  icon::TraceInstant("icon_client", "ReactionReceived");
+  if (dispatch_on_executor_.load(std::memory_order_acquire)) {
+    DispatchReactionCallbacks(received);
+    return;
+  }
+  // Block until the reaction can be moved into the queue. Emplace() only calls
+  // the lambda once there is space, so `received` is moved once.
+  absl::MutexLock l(&reactions_queue_writer_mutex_);
+  while (!reactions_queue_.Writer().Emplace(
+      [&received](auto* item) { *item = std::move(received); })) {
   }
-  grpc::Status grpc_status = watcher_stream_->Finish();
+}
+
+void Session::HandleWatcherCallEnd(const ::grpc::Status& grpc_status) {
   absl::MutexLock l(&reactions_queue_writer_mutex_);
   if (!grpc_status.ok()) {
     absl::Status error = ToAbslStatus(grpc_status);  // Only allowed for errors.
-    while (!reactions_queue_.Writer().Write(error)) {
+    while (!reactions_queue_.Writer().Emplace(
+        [&error](auto* item) { *item = std::move(error); })) {
     }
   }
   reactions_queue_.Writer().Close();
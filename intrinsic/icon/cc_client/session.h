@@ -5,14 +5,18 @@
 
 #include <atomic>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
@@ -25,10 +29,14 @@
 #include "google/rpc/status.pb.h"
 #include "grpcpp/support/sync_stream.h"
 #include "intrinsic/icon/cc_client/condition.h"
+#include "intrinsic/icon/cc_client/output_subscription.h"
+#include "intrinsic/icon/cc_client/planned_trajectory_reader.h"
+#include "intrinsic/icon/cc_client/reaction_watcher.h"
 #include "intrinsic/icon/cc_client/stream.h"
 #include "intrinsic/icon/common/id_types.h"
 #include "intrinsic/icon/common/slot_part_map.h"
 #include "intrinsic/icon/proto/joint_space.pb.h"
+#include "intrinsic/icon/proto/joint_trajectory.h"
 #include "intrinsic/icon/proto/service.grpc.pb.h"
 #include "intrinsic/icon/proto/service.pb.h"
 #include "intrinsic/icon/proto/streaming_output.pb.h"
@@ -178,6 +186,7 @@ class ActionDescriptor {
   ActionInstanceId Id() const { return action_id_; }
 
  private:
+  friend class ActionGraphTemplate;
   friend class Session;
 
   const std::string action_type_name_;
@@ -188,6 +197,68 @@ class ActionDescriptor {
   std::vector<ReactionDescriptor> reaction_descriptors_;
 };
 
+// A set of Actions and their Reactions that is added to Sessions over and
+// over, with only the fixed parameters of the Actions changing, e.g. once per
+// cycle of a pick loop with new target poses.
+//
+// Create() converts the descriptors to their request once. Adding the template
+// with Session::AddActionsFromTemplate() then only copies that request, fills
+// in fresh reaction ids and the fixed parameters in ActionTemplateParams, and
+// keeps the conditions from being converted again every cycle.
+//
+// Example:
+//
+// INTR_ASSIGN_OR_RETURN(
+//     ActionGraphTemplate pick,
+//     ActionGraphTemplate::Create({approach_descriptor, grasp_descriptor}));
+// for (const Pose& target : targets) {
+//   INTR_RETURN_IF_ERROR(session->ClearAllActionsAndReactions());
+//   INTR_RETURN_IF_ERROR(
+//       session
+//           ->AddActionsFromTemplate(
+//               pick, ActionTemplateParams().WithFixedParams(
+//                         kApproachId, MakeApproachParams(target)))
+//           .status());
+//   ...
+// }
+class ActionGraphTemplate {
+ public:
+  // Returns InvalidArgumentError if `action_descriptors` is empty or contains
+  // an action id more than once.
+  static absl::StatusOr<ActionGraphTemplate> Create(
+      absl::Span<const ActionDescriptor> action_descriptors);
+
+ private:
+  friend class Session;
+
+  ActionGraphTemplate() = default;
+
+  std::vector<ActionDescriptor> action_descriptors_;
+  // The reactions of all actions, in the order of `request_.reactions()`.
+  std::vector<ReactionDescriptor> reaction_descriptors_;
+  // Reaction ids are set when adding the template.
+  intrinsic_proto::icon::ActionsAndReactions request_;
+  // Index of each action in `request_.action_instances()`.
+  absl::flat_hash_map<ActionInstanceId, int> action_indices_;
+};
+
+// Fixed parameters for adding an ActionGraphTemplate. Actions that have none
+// here keep the fixed parameters of their ActionDescriptor.
+class ActionTemplateParams {
+ public:
+  // Sets the fixed parameters of the action with `action_id`, replacing
+  // previous calls for the same action. No references to `fixed_params` are
+  // retained beyond this call.
+  ActionTemplateParams& WithFixedParams(
+      ActionInstanceId action_id,
+      const ::google::protobuf::Message& fixed_params);
+
+ private:
+  friend class Session;
+
+  absl::flat_hash_map<ActionInstanceId, google::protobuf::Any> fixed_params_;
+};
+
 // Provides a handle to the user for an already-created action.
 class Action {
  public:
@@ -202,6 +273,65 @@ class Action {
   ActionInstanceId id_;
 };
 
+class Session;
+
+// The result of a Session request that has been sent to the server, but whose
+// response may not have been read yet. Returned by the `...Async()` methods of
+// Session.
+//
+// The server answers the requests of a session in the order in which they were
+// sent. Get() therefore reads and resolves the responses of all requests sent
+// before this one first, and SessionFutures can be resolved in any order.
+//
+// Like Session itself, a SessionFuture is not thread-safe. It must not outlive
+// its Session. Ending the Session resolves all outstanding SessionFutures.
+template <typename T = void>
+class SessionFuture {
+ public:
+  // absl::Status for requests without a result value, absl::StatusOr<T>
+  // otherwise.
+  using ResultType = std::conditional_t<std::is_void_v<T>, absl::Status,
+                                        absl::StatusOr<T>>;
+
+  SessionFuture(SessionFuture&&) = default;
+  SessionFuture& operator=(SessionFuture&&) = default;
+  SessionFuture(const SessionFuture&) = delete;
+  SessionFuture& operator=(const SessionFuture&) = delete;
+
+  // Blocks until the response to the request has been read, and returns the
+  // result. Returns the same errors as the corresponding blocking Session
+  // method. May be called repeatedly.
+  ResultType Get();
+
+  // Returns true if Get() does not block.
+  bool IsReady() const { return result_->has_value(); }
+
+ private:
+  friend class Session;
+
+  // Creates a future that is resolved once the response to the request with
+  // `sequence_number` has been read.
+  SessionFuture(Session* session, uint64_t sequence_number)
+      : session_(session),
+        sequence_number_(sequence_number),
+        result_(std::make_shared<std::optional<ResultType>>()) {}
+  // Creates a future that is already resolved with `result`, e.g. because the
+  // request could not be sent.
+  explicit SessionFuture(ResultType result)
+      : result_(std::make_shared<std::optional<ResultType>>(
+            std::move(result))) {}
+
+  Session* session_ = nullptr;
+  uint64_t sequence_number_ = 0;
+  // Shared with the response handler in the Session.
+  std::shared_ptr<std::optional<ResultType>> result_;
+};
+
+// Runs a reaction callback, e.g. by scheduling it on a thread pool, or by
+// running it inline. See Session::DispatchReactionsOn().
+using ReactionExecutor =
+    absl::AnyInvocable<void(absl::AnyInvocable<void() &&>)>;
+
 // A `Session` scopes control of a set of parts to a single session. The
 // `Session` provides the ability to manipulate those parts by adding actions
 // and/or reactions.
@@ -225,6 +355,16 @@ class Session {
       const intrinsic_proto::data_logger::Context& context = {},
       std::optional<absl::Time> deadline = std::nullopt);
 
+  // Same as above, but reads the reaction events of the session on the shared
+  // thread of `reaction_watcher`, instead of a thread of its own. See
+  // ReactionWatcher, and Client::StartSession().
+  static absl::StatusOr<std::unique_ptr<Session>> Start(
+      std::shared_ptr<ChannelInterface> icon_channel,
+      std::shared_ptr<ReactionWatcher> reaction_watcher,
+      absl::Span<const std::string> parts,
+      const intrinsic_proto::data_logger::Context& context = {},
+      std::optional<absl::Time> deadline = std::nullopt);
+
   // Creates a Session for the `parts` and starts it.
   //
   // The resulting session uses default-constructed ::grpc::ClientContext
@@ -264,6 +404,54 @@ class Session {
   absl::StatusOr<std::vector<Action>> AddActions(
       absl::Span<const ActionDescriptor> action_descriptors);
 
+  // Same as AddActions(), but does not wait for the server to respond. The
+  // returned future holds the result.
+  //
+  // The `...Async()` methods let a caller send several requests back to back
+  // and pay for a single round trip, e.g. when rebuilding the action graph
+  // between two parts:
+  //
+  //   SessionFuture<> removed = session->RemoveActionsAsync(old_ids);
+  //   SessionFuture<std::vector<Action>> added =
+  //       session->AddActionsAsync(descriptors);
+  //   INTR_RETURN_IF_ERROR(removed.Get());
+  //   INTR_ASSIGN_OR_RETURN(std::vector<Action> actions, added.Get());
+  //
+  // ICON handles each request on its own, so a later request is sent and
+  // processed even if an earlier one fails.
+  SessionFuture<std::vector<Action>> AddActionsAsync(
+      absl::Span<const ActionDescriptor> action_descriptors);
+
+  // Adds the actions described by `action_descriptors` and starts the actions
+  // with `start_action_ids` in a single request, see AddActions() and
+  // StartActions(). `start_action_ids` may refer to both the new actions and
+  // actions that were added before. Returns an error if either adding or
+  // starting fails.
+  absl::StatusOr<std::vector<Action>> AddActionsAndStart(
+      absl::Span<const ActionDescriptor> action_descriptors,
+      absl::Span<const ActionInstanceId> start_action_ids,
+      bool stop_active_actions = true);
+
+  // Same as AddActionsAndStart(), but does not wait for the server to respond.
+  SessionFuture<std::vector<Action>> AddActionsAndStartAsync(
+      absl::Span<const ActionDescriptor> action_descriptors,
+      absl::Span<const ActionInstanceId> start_action_ids,
+      bool stop_active_actions = true);
+
+  // Adds the actions and reactions of `graph`, with the fixed parameters in
+  // `params`. Returns the same errors as AddActions(), and
+  // InvalidArgumentError if `params` refers to an action that is not in
+  // `graph`.
+  absl::StatusOr<std::vector<Action>> AddActionsFromTemplate(
+      const ActionGraphTemplate& graph,
+      const ActionTemplateParams& params = {});
+
+  // Same as AddActionsFromTemplate(), but does not wait for the server to
+  // respond. See AddActionsAsync().
+  SessionFuture<std::vector<Action>> AddActionsFromTemplateAsync(
+      const ActionGraphTemplate& graph,
+      const ActionTemplateParams& params = {});
+
   // Adds the reaction described by `reaction_descriptor` to the session as
   // a free-standing reaction. This reaction is not attached to a specific
   // action but is active as long as the session is active.
@@ -276,6 +464,11 @@ class Session {
   absl::Status AddFreestandingReactions(
       absl::Span<const ReactionDescriptor> reaction_descriptors);
 
+  // Same as AddFreestandingReactions(), but does not wait for the server to
+  // respond. See AddActionsAsync().
+  SessionFuture<> AddFreestandingReactionsAsync(
+      absl::Span<const ReactionDescriptor> reaction_descriptors);
+
   // Removes the action identified by the `action_id`, as well as any Reactions
   // that originate from or switch to that Action.
   //
@@ -298,11 +491,17 @@ class Session {
   // with a previously used ID.
   absl::Status RemoveActions(const std::vector<ActionInstanceId>& action_ids);
 
+  // Same as RemoveActions(), but does not wait for the server to respond. See
+  // AddActionsAsync().
+  SessionFuture<> RemoveActionsAsync(
+      const std::vector<ActionInstanceId>& action_ids);
+
   // Removes all Actions and Reactions from the Session. ICON will fall back to
   // the default Action(s), which normally stops the robot.
   //
   // N.B. This essentially invalidates all Action and ReactionHandle objects
-  // obtained from this Session.
+  // obtained from this Session. Their ReactionHandles may be used again for new
+  // reactions afterwards.
   absl::Status ClearAllActionsAndReactions();
 
   // Starts the given actions on the server.
@@ -324,6 +523,11 @@ class Session {
   // Other errors may be returned due to the `actions` specified.
   absl::Status StartActions(absl::Span<const Action> actions,
                             bool stop_active_actions = true);
+
+  // Same as StartActions(), but does not wait for the server to respond. See
+  // AddActionsAsync().
+  SessionFuture<> StartActionsAsync(absl::Span<const Action> actions,
+                                    bool stop_active_actions = true);
   ABSL_DEPRECATED("use StartActions() instead")
   absl::Status StartAction(const Action& action,
                            bool stop_active_actions = true);
@@ -357,6 +561,27 @@ class Session {
   // This method is thread-safe.
   void QuitWatcherLoop();
 
+  // Hands the callbacks of reactions to `executor` as soon as their events are
+  // received, instead of queueing the events for RunWatcherLoop(). This saves
+  // the hop through the event queue and the wake-up of the thread that runs
+  // the watcher loop.
+  //
+  // `executor` is called on the thread that reads the reaction events of this
+  // Session, see ReactionWatcher, and must not block. It is not called anymore once End() returns, but closures that it
+  // has already been handed may still run, so they must finish before the
+  // Session is destroyed. Callbacks may run concurrently with calls on the
+  // Session from other threads, and with each other if `executor` runs them in
+  // parallel.
+  //
+  // RunWatcherLoop() still returns when QuitWatcherLoop() is called or the
+  // session ends, and RunWatcherLoopUntilReaction() when the reaction fires.
+  // Reaction events that were queued before this call are only processed by
+  // RunWatcherLoop().
+  //
+  // Returns FailedPreconditionError if the session ended, or if reactions are
+  // already dispatched on an executor.
+  absl::Status DispatchReactionsOn(ReactionExecutor executor);
+
   // Creates a StreamWriter for the given `input_name` of the given action.
   //
   // Returns an aborted error if the session ended. Other errors may be returned
@@ -369,14 +594,56 @@ class Session {
         channel_ ? channel_->GetClientContextFactory() : nullptr);
   }
 
+  // Creates a BufferedStreamWriter for the given `input_name` of the given
+  // action. Unlike StreamWriter(), its Write() does not wait for the server,
+  // see BufferedStreamWriterInterface.
+  //
+  // Returns an aborted error if the session ended, and an invalid argument
+  // error if `options` are out of range. Other errors may be returned due to
+  // mismatched types, an input already in use, etc.
+  template <typename T>
+  absl::StatusOr<std::unique_ptr<BufferedStreamWriterInterface<T>>>
+  BufferedStreamWriter(const Action& action, absl::string_view input_name,
+                       const BufferedStreamWriterOptions& options = {}) {
+    return intrinsic::icon::internal::BufferedStreamWriter<T>::Open(
+        session_id_, action.id(), input_name, stub_.get(), options,
+        channel_ ? channel_->GetClientContextFactory() : nullptr);
+  }
+
   // Returns the latest output of the Action with `id`. Blocks until `deadline`
   // if that Action is active, but has not published an output value yet.
   absl::StatusOr<::intrinsic_proto::icon::StreamingOutput> GetLatestOutput(
       ActionInstanceId id, absl::Time deadline);
 
+  // Keeps the latest outputs of the Actions with `action_ids` up to date in
+  // the background, streaming the new ones every `period`, so that they can be
+  // read without blocking. See OutputSubscription. The subscription must not
+  // outlive this Session.
+  //
+  // Returns FailedPreconditionError if the session ended, and
+  // InvalidArgumentError if `action_ids` is empty or contains duplicates, or
+  // if `period` is not positive.
+  absl::StatusOr<std::unique_ptr<OutputSubscription>> SubscribeOutputs(
+      absl::Span<const ActionInstanceId> action_ids, absl::Duration period);
+
+  // Returns the complete planned trajectory of the Action with `id`.
+  //
+  // The trajectory is assembled in place from the segments the server sends.
+  // For long trajectories, prefer ReadPlannedTrajectory().
   absl::StatusOr<::intrinsic_proto::icon::JointTrajectoryPVA>
   GetPlannedTrajectory(ActionInstanceId id);
 
+  // Same as GetPlannedTrajectory(), but assembles the segments into a columnar
+  // JointTrajectory, which takes a fraction of the memory of the proto.
+  absl::StatusOr<JointTrajectory> GetPlannedJointTrajectory(
+      ActionInstanceId id);
+
+  // Starts reading the planned trajectory of the Action with `id` segment by
+  // segment. See PlannedTrajectoryReader. The reader must not outlive this
+  // Session.
+  std::unique_ptr<PlannedTrajectoryReader> ReadPlannedTrajectory(
+      ActionInstanceId id);
+
   // Ends the session and returns the session end status. Returns a precondition
   // failed status if the session has already ended.
   absl::Status End();
@@ -391,7 +658,8 @@ class Session {
       std::unique_ptr<intrinsic_proto::icon::IconApi::StubInterface> stub,
       absl::Span<const std::string> parts,
       const ClientContextFactory& client_context_factory,
-      std::optional<absl::Time> deadline);
+      std::optional<absl::Time> deadline,
+      std::shared_ptr<ReactionWatcher> reaction_watcher);
 
   Session(std::shared_ptr<ChannelInterface> icon_channel,
           std::unique_ptr<grpc::ClientContext> action_context,
@@ -403,6 +671,7 @@ class Session {
           std::unique_ptr<::grpc::ClientReaderInterface<
               intrinsic_proto::icon::WatchReactionsResponse>>
               watcher_stream,
+          std::unique_ptr<ReactionWatcher::Stream> shared_watcher_stream,
           std::unique_ptr<intrinsic_proto::icon::IconApi::StubInterface> stub,
           SessionId session_id,
           const intrinsic_proto::data_logger::Context& context,
@@ -419,18 +688,89 @@ class Session {
       absl::Span<const ReactionDescriptor> reaction_descriptors) const;
 
   // Saves any callbacks and ReactionHandles contained in
-  // `reaction_descriptors_by_id` to `reaction_callback_map_` and
+  // `reaction_descriptors_by_id` to `reaction_callbacks_` and
   // `reaction_handle_to_id_and_loc_`.
   void SaveReactionData(
       const absl::flat_hash_map<ReactionId, ReactionDescriptor>&
           reaction_descriptors_by_id);
 
-  absl::StatusOr<intrinsic_proto::icon::OpenSessionResponse> GetResponseOrEnd(
+  template <typename T>
+  friend class SessionFuture;
+
+  // Handles the response to a request, or the AbortedError that the session
+  // ended before the response was read.
+  using ResponseHandler = absl::AnyInvocable<void(
+      absl::StatusOr<intrinsic_proto::icon::OpenSessionResponse>) &&>;
+
+  // Builds the request, shared by AddActionsAsync() and
+  // AddActionsAndStartAsync().
+  SessionFuture<std::vector<Action>> AddActionsImpl(
+      absl::Span<const ActionDescriptor> action_descriptors,
+      std::optional<intrinsic_proto::icon::OpenSessionRequest::
+                        StartActionsRequestData>
+          start_actions_request);
+
+  // Sends `request`, which adds the actions of `actions` and the reactions of
+  // `reaction_descriptors_by_id`, and returns a future that is resolved with
+  // `actions` once the server added them. Shared by AddActionsImpl() and
+  // AddActionsFromTemplateAsync().
+  SessionFuture<std::vector<Action>> SendAddActionsRequest(
+      const intrinsic_proto::icon::OpenSessionRequest& request,
+      absl::flat_hash_map<ReactionId, ReactionDescriptor>
+          reaction_descriptors_by_id,
+      std::vector<Action> actions);
+
+  // Sends `request` and returns a future that is resolved with the status of
+  // the response. Ends the session if the server returns an aborted error.
+  SessionFuture<> SendRequest(
       const intrinsic_proto::icon::OpenSessionRequest& request);
 
+  // Writes `request` to `action_stream_` and returns its sequence number.
+  // `on_response` is called once the response has been read by
+  // ReadResponsesUntil(). If the call died, this ends the session.
+  uint64_t WriteRequest(
+      const intrinsic_proto::icon::OpenSessionRequest& request,
+      ResponseHandler on_response);
+
+  // Reads the responses to all requests up to and including the one with
+  // `sequence_number`, in order, and passes them to their handlers. If the
+  // call died, passes an AbortedError to the remaining handlers and ends the
+  // session.
+  void ReadResponsesUntil(uint64_t sequence_number);
+
+  // Returns the status of a response passed to a ResponseHandler, see
+  // EndAndLogOnAbort().
+  absl::Status ResponseStatus(
+      const absl::StatusOr<intrinsic_proto::icon::OpenSessionResponse>&
+          response);
+
+  // Undoes SaveReactionData() for reactions that the server did not add.
+  void EraseReactionData(
+      const absl::flat_hash_map<ReactionId, ReactionDescriptor>&
+          reaction_descriptors_by_id);
+
+  // A reaction event, and when it was received.
+  struct ReceivedReaction {
+    intrinsic_proto::icon::WatchReactionsResponse response;
+    absl::Time receive_time;
+  };
+
   // Triggers the reaction callbacks for the given `reaction`.
-  void TriggerReactionCallbacks(
-      const intrinsic_proto::icon::WatchReactionsResponse& reaction);
+  void TriggerReactionCallbacks(const ReceivedReaction& reaction);
+
+  // Hands the reaction callbacks for the given `reaction` to
+  // `reaction_executor_`.
+  void DispatchReactionCallbacks(const ReceivedReaction& reaction);
+
+  // Returns a copy of the callback registered to `reaction_id`, or an empty
+  // function if there is none.
+  std::function<void()> GetReactionCallback(ReactionId reaction_id)
+      ABSL_LOCKS_EXCLUDED(reaction_callbacks_mutex_);
+
+  // Returns the entry of `reaction_callbacks_` for `reaction_id`, growing it as
+  // needed.
+  std::function<void()>& ReactionCallbackEntry(ReactionId reaction_id)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(reaction_callbacks_mutex_);
 
   // Reads out the reaction watcher buffer and finishes the call. Logs any
   // additional reactions received, and any call errors.
@@ -444,10 +784,20 @@ class Session {
   // Session remains active.
   absl::Status EndAndLogOnAbort(const ::google::rpc::Status& status);
 
-  // Reads from watcher stream, and queues new reactions into the
-  // `reactions_queue_`.
+  // Reads from watcher stream, and passes new reactions to
+  // HandleReactionResponse().
   void WatchReactionsThreadBody();
 
+  // Queues the reaction event `response` into the `reactions_queue_`, or
+  // dispatches its callback on `reaction_executor_`. Called on the thread that
+  // reads the watcher stream. May move from `response`.
+  void HandleReactionResponse(
+      intrinsic_proto::icon::WatchReactionsResponse& response);
+
+  // Queues the error of the watcher call, if any, and closes the
+  // `reactions_queue_`.
+  void HandleWatcherCallEnd(const ::grpc::Status& grpc_status);
+
   // Hold onto the channel, if any, so that callers do not need to worry about
   // its lifetime. May be nullptr depending on the version of Start used to
   // construct this session.
@@ -463,6 +813,17 @@ class Session {
       intrinsic_proto::icon::OpenSessionResponse>>
       action_stream_;
 
+  // Handlers for the requests that were sent on `action_stream_` but whose
+  // responses have not been read yet, in the order of the requests.
+  struct PendingResponse {
+    uint64_t sequence_number;
+    ResponseHandler on_response;
+    // InfinitePast() if client tracing was disabled.
+    absl::Time send_time;
+  };
+  std::deque<PendingResponse> pending_responses_;
+  uint64_t next_request_sequence_number_ = 0;
+
   std::unique_ptr<grpc::ClientContext> watcher_context_;
 
   // Only call watcher_stream_::Read() on `watcher_read_thread_` until
@@ -471,21 +832,37 @@ class Session {
       intrinsic_proto::icon::WatchReactionsResponse>>
       watcher_stream_;
 
-  // A map of callbacks registered to reactions, keyed by the reaction id.
-  absl::flat_hash_map<ReactionId, std::function<void()>> reaction_callback_map_;
-
-  // Reaction events are written to the `reactions_queue_` from the
-  // `watcher_read_thread_`, and read during `RunWatcherLoop()` on the calling
-  // thread. Passing a nullopt quits the watcher loop.
+  // Used instead of `watcher_stream_` and `watcher_read_thread_` if the session
+  // was started with a ReactionWatcher. Then, reaction events are handled on
+  // the thread of the ReactionWatcher.
+  std::unique_ptr<ReactionWatcher::Stream> shared_watcher_stream_;
+
+  // Callbacks registered to reactions, indexed by the value of the reaction
+  // id. `reaction_id_sequence_` hands out dense ids, so this needs no hash
+  // lookup per reaction event. Empty functions stand for reactions without
+  // callback. Callbacks are dispatched from the watcher thread after
+  // DispatchReactionsOn(), hence the mutex.
+  absl::Mutex reaction_callbacks_mutex_;
+  std::vector<std::function<void()>> reaction_callbacks_
+      ABSL_GUARDED_BY(reaction_callbacks_mutex_);
+
+  // Set once by DispatchReactionsOn(), before `dispatch_on_executor_`. Only
+  // called on the watcher thread afterwards.
+  ReactionExecutor reaction_executor_;
+  std::atomic<bool> dispatch_on_executor_ = false;
+
+  // Reaction events are written to the `reactions_queue_` from the watcher
+  // thread, and read during `RunWatcherLoop()` on the calling thread. Passing a
+  // nullopt quits the watcher loop.
   absl::Mutex reactions_queue_writer_mutex_;  // we write from two threads
-  RealtimeWriteQueue<absl::StatusOr<
-      std::optional<intrinsic_proto::icon::WatchReactionsResponse>>>
+  RealtimeWriteQueue<absl::StatusOr<std::optional<ReceivedReaction>>>
       reactions_queue_;
   std::atomic<bool> quit_watcher_loop_ = false;
 
   // Used to read reaction events in the background. `watcher_stream_::Read()`
   // calls should only be made on this thread. It is ok for other
-  // watcher_stream_ methods to be invoked on another thread.
+  // watcher_stream_ methods to be invoked on another thread. Not started if
+  // `shared_watcher_stream_` is used.
   Thread watcher_read_thread_;
 
   std::unique_ptr<intrinsic_proto::icon::IconApi::StubInterface> stub_;
@@ -504,6 +881,14 @@ class Session {
   ClientContextFactory client_context_factory_;
 };
 
+template <typename T>
+typename SessionFuture<T>::ResultType SessionFuture<T>::Get() {
+  if (!result_->has_value()) {
+    session_->ReadResponsesUntil(sequence_number_);
+  }
+  return **result_;
+}
+
 }  // namespace icon
 }  // namespace intrinsic
 
@@ -0,0 +1,154 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/cc_client/session_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "intrinsic/icon/cc_client/session.h"
+#include "intrinsic/logging/proto/context.pb.h"
+#include "intrinsic/util/grpc/channel_interface.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic {
+namespace icon {
+
+SessionLease::SessionLease(SessionPool* pool, std::vector<std::string> parts,
+                           std::unique_ptr<Session> session)
+    : pool_(pool), parts_(std::move(parts)), session_(std::move(session)) {}
+
+SessionLease& SessionLease::operator=(SessionLease&& other) {
+  if (this != &other) {
+    Release();
+    pool_ = other.pool_;
+    parts_ = std::move(other.parts_);
+    session_ = std::move(other.session_);
+  }
+  return *this;
+}
+
+SessionLease::~SessionLease() { Release(); }
+
+void SessionLease::Discard() { session_.reset(); }
+
+void SessionLease::Release() {
+  if (session_ == nullptr) {
+    return;
+  }
+  pool_->Return(std::move(parts_), std::move(session_));
+}
+
+SessionPool::SessionPool(std::shared_ptr<ChannelInterface> icon_channel,
+                         const intrinsic_proto::data_logger::Context& context,
+                         size_t max_idle_sessions_per_parts)
+    : SessionPool(
+          [icon_channel = std::move(icon_channel),
+           context](absl::Span<const std::string> parts) {
+            return Session::Start(icon_channel, parts, context);
+          },
+          max_idle_sessions_per_parts) {}
+
+SessionPool::SessionPool(SessionFactory session_factory,
+                         size_t max_idle_sessions_per_parts)
+    : session_factory_(std::move(session_factory)),
+      max_idle_sessions_per_parts_(max_idle_sessions_per_parts) {}
+
+SessionPool::~SessionPool() { Clear(); }
+
+absl::StatusOr<SessionLease> SessionPool::Lease(
+    absl::Span<const std::string> parts) {
+  std::vector<std::string> sorted_parts = SortedParts(parts);
+  std::unique_ptr<Session> session = PopIdle(sorted_parts);
+  if (session == nullptr) {
+    INTR_ASSIGN_OR_RETURN(session, session_factory_(sorted_parts));
+  }
+  return SessionLease(this, std::move(sorted_parts), std::move(session));
+}
+
+absl::Status SessionPool::Prewarm(absl::Span<const std::string> parts) {
+  std::vector<std::string> sorted_parts = SortedParts(parts);
+  {
+    absl::MutexLock lock(&mutex_);
+    if (auto it = idle_sessions_.find(sorted_parts);
+        it != idle_sessions_.end() && !it->second.empty()) {
+      return absl::OkStatus();
+    }
+  }
+  INTR_ASSIGN_OR_RETURN(std::unique_ptr<Session> session,
+                        session_factory_(sorted_parts));
+  Return(std::move(sorted_parts), std::move(session));
+  return absl::OkStatus();
+}
+
+void SessionPool::Clear() {
+  absl::flat_hash_map<std::vector<std::string>,
+                      std::vector<std::unique_ptr<Session>>>
+      idle_sessions;
+  {
+    absl::MutexLock lock(&mutex_);
+    idle_sessions.swap(idle_sessions_);
+  }
+  // Destroying the Sessions ends them, outside of the lock.
+}
+
+size_t SessionPool::NumIdle() const {
+  absl::MutexLock lock(&mutex_);
+  size_t num_idle = 0;
+  for (const auto& [parts, sessions] : idle_sessions_) {
+    num_idle += sessions.size();
+  }
+  return num_idle;
+}
+
+// static
+std::vector<std::string> SessionPool::SortedParts(
+    absl::Span<const std::string> parts) {
+  std::vector<std::string> sorted_parts(parts.begin(), parts.end());
+  std::sort(sorted_parts.begin(), sorted_parts.end());
+  return sorted_parts;
+}
+
+std::unique_ptr<Session> SessionPool::PopIdle(
+    const std::vector<std::string>& parts) {
+  absl::MutexLock lock(&mutex_);
+  auto it = idle_sessions_.find(parts);
+  if (it == idle_sessions_.end() || it->second.empty()) {
+    return nullptr;
+  }
+  std::unique_ptr<Session> session = std::move(it->second.back());
+  it->second.pop_back();
+  return session;
+}
+
+void SessionPool::Return(std::vector<std::string> parts,
+                         std::unique_ptr<Session> session) {
+  // Ended Sessions fail this, too.
+  if (absl::Status status = session->ClearAllActionsAndReactions();
+      !status.ok()) {
+    LOG(WARNING) << "Dropping Session " << session->Id().value()
+                 << " from the pool, failed to reset it: " << status;
+    return;
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    std::vector<std::unique_ptr<Session>>& sessions = idle_sessions_[parts];
+    if (sessions.size() < max_idle_sessions_per_parts_) {
+      sessions.push_back(std::move(session));
+      return;
+    }
+  }
+  // The pool is full, so `session` ends here, outside of the lock.
+}
+
+}  // namespace icon
+}  // namespace intrinsic
@@ -0,0 +1,146 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_CC_CLIENT_SESSION_POOL_H_
+#define INTRINSIC_ICON_CC_CLIENT_SESSION_POOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "intrinsic/icon/cc_client/session.h"
+#include "intrinsic/logging/proto/context.pb.h"
+#include "intrinsic/util/grpc/channel_interface.h"
+
+namespace intrinsic {
+namespace icon {
+
+class SessionPool;
+
+// A Session leased from a SessionPool. Returns the Session to the pool when
+// destroyed.
+//
+// Like Session, a SessionLease is not thread-safe. It is movable, and must not
+// outlive its pool.
+class SessionLease {
+ public:
+  SessionLease(SessionLease&& other) = default;
+  SessionLease& operator=(SessionLease&& other);
+  ~SessionLease();
+
+  Session& operator*() const { return *session_; }
+  Session* operator->() const { return session_.get(); }
+  Session* get() const { return session_.get(); }
+
+  // Ends the Session instead of returning it to the pool, e.g. because it is
+  // in an unknown state.
+  void Discard();
+
+ private:
+  friend class SessionPool;
+
+  SessionLease(SessionPool* pool, std::vector<std::string> parts,
+               std::unique_ptr<Session> session);
+
+  // Returns the Session to the pool, if any.
+  void Release();
+
+  SessionPool* pool_;
+  // Sorted.
+  std::vector<std::string> parts_;
+  std::unique_ptr<Session> session_;
+};
+
+// Keeps started Sessions around, so that a warm Session for a set of parts can
+// be leased and returned, instead of starting one from scratch for every skill
+// execution. This saves the setup latency of the Session's gRPC streams.
+//
+// When a lease ends, the Session is reset with ClearAllActionsAndReactions()
+// and kept for the next Lease() of the same parts, up to
+// `max_idle_sessions_per_parts`. Sessions that have ended or fail to reset are
+// dropped. Other state, such as that set by Session::DispatchReactionsOn(),
+// carries over to the next lease.
+//
+// N.B. An idle Session keeps holding its parts, so other clients cannot start
+// a Session for them. Call Clear() to release them.
+//
+// This class is thread-safe.
+//
+// Example:
+//
+// SessionPool pool(icon_channel);
+// for (const Skill& skill : skills) {
+//   INTR_ASSIGN_OR_RETURN(SessionLease session, pool.Lease({"robot_arm"}));
+//   INTR_RETURN_IF_ERROR(skill.Execute(*session));
+// }
+class SessionPool {
+ public:
+  // Starts a Session for the given parts.
+  using SessionFactory = absl::AnyInvocable<absl::StatusOr<
+      std::unique_ptr<Session>>(absl::Span<const std::string> parts)>;
+
+  // Starts Sessions on `icon_channel`, tagging part status with `context`.
+  explicit SessionPool(
+      std::shared_ptr<ChannelInterface> icon_channel,
+      const intrinsic_proto::data_logger::Context& context = {},
+      size_t max_idle_sessions_per_parts = 1);
+
+  // Starts Sessions with `session_factory`.
+  explicit SessionPool(SessionFactory session_factory,
+                       size_t max_idle_sessions_per_parts = 1);
+
+  // Ends all idle Sessions. All leases must have ended.
+  ~SessionPool();
+
+  SessionPool(const SessionPool&) = delete;
+  SessionPool& operator=(const SessionPool&) = delete;
+
+  // Leases an idle Session for exactly the `parts` (in any order), or starts
+  // a new one if there is none. Propagates errors of starting the Session.
+  absl::StatusOr<SessionLease> Lease(absl::Span<const std::string> parts);
+
+  // Starts a Session for `parts` and puts it into the pool, unless an idle
+  // Session for `parts` exists already.
+  absl::Status Prewarm(absl::Span<const std::string> parts);
+
+  // Ends all idle Sessions.
+  void Clear();
+
+  // Returns the number of idle Sessions for all parts.
+  size_t NumIdle() const;
+
+ private:
+  friend class SessionLease;
+
+  static std::vector<std::string> SortedParts(
+      absl::Span<const std::string> parts);
+
+  // Pops an idle Session for `parts`, or returns nullptr.
+  std::unique_ptr<Session> PopIdle(const std::vector<std::string>& parts)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Resets `session` and keeps it for later leases, or ends it.
+  void Return(std::vector<std::string> parts,
+              std::unique_ptr<Session> session) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  SessionFactory session_factory_;
+  const size_t max_idle_sessions_per_parts_;
+
+  mutable absl::Mutex mutex_;
+  // Keyed by sorted part names.
+  absl::flat_hash_map<std::vector<std::string>,
+                      std::vector<std::unique_ptr<Session>>>
+      idle_sessions_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace icon
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_ICON_CC_CLIENT_SESSION_POOL_H_
@@ -5,9 +5,14 @@
 #include <cstddef>
 #include <string>
 
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "intrinsic/icon/common/state_variable_path_constants.h"
 #include "intrinsic/icon/common/state_variable_path_util.h"
+#include "intrinsic/icon/utils/fixed_str_cat.h"
+#include "intrinsic/util/status/status_macros.h"
 
 namespace intrinsic::icon {
 
@@ -21,6 +26,32 @@ std::string BuildIndexedArmPath(absl::string_view part_name,
        {.name = kArmTypeNodeName},
        {.name = std::string(field_type_name), .index = index}});
 }
+
+absl::Status ValidateNodeName(absl::string_view name) {
+  if (name.empty()) {
+    return absl::InvalidArgumentError("State variable path node is empty.");
+  }
+  if (name.size() > kMaxNodeNameLength) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("State variable path node '", name, "' is longer than ",
+                     kMaxNodeNameLength, " characters."));
+  }
+  if (name.find(kStateVariablePathSeparator) != absl::string_view::npos) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("State variable path node '", name, "' contains '",
+                     kStateVariablePathSeparator, "'."));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ValidateTail(const StateVariablePathTail& tail,
+                          StateVariablePathTail::Kind expected_kind) {
+  if (tail.kind() != expected_kind) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Wrong arguments for state variable path tail '", tail.view(), "'."));
+  }
+  return absl::OkStatus();
+}
 }  // namespace
 
 std::string ArmSensedPositionStateVariablePath(absl::string_view part_name,
@@ -149,4 +180,35 @@ std::string SafetyEnableButtonStatusStateVariablePath() {
       {{.name = kSafetyTypeNodeName}, {.name = kEnableButtonStatusNodeName}});
 }
 
+absl::StatusOr<FixedStateVariablePath> BuildFixedStateVariablePath(
+    absl::string_view part_name, const StateVariablePathTail& tail) {
+  INTR_RETURN_IF_ERROR(
+      ValidateTail(tail, StateVariablePathTail::Kind::kComplete));
+  INTR_RETURN_IF_ERROR(ValidateNodeName(part_name));
+  return FixedStrCat<kMaxFixedStateVariablePathLength>(
+      kStateVariablePathPrefix, part_name, tail.view());
+}
+
+absl::StatusOr<FixedStateVariablePath> BuildFixedStateVariablePath(
+    absl::string_view part_name, const StateVariablePathTail& tail,
+    size_t index) {
+  INTR_RETURN_IF_ERROR(
+      ValidateTail(tail, StateVariablePathTail::Kind::kIndexed));
+  INTR_RETURN_IF_ERROR(ValidateNodeName(part_name));
+  return FixedStrCat<kMaxFixedStateVariablePathLength>(
+      kStateVariablePathPrefix, part_name, tail.view(), "[", index, "]");
+}
+
+absl::StatusOr<FixedStateVariablePath> BuildFixedStateVariablePath(
+    absl::string_view part_name, const StateVariablePathTail& tail,
+    absl::string_view node_name, size_t index) {
+  INTR_RETURN_IF_ERROR(
+      ValidateTail(tail, StateVariablePathTail::Kind::kNamedIndexed));
+  INTR_RETURN_IF_ERROR(ValidateNodeName(part_name));
+  INTR_RETURN_IF_ERROR(ValidateNodeName(node_name));
+  return FixedStrCat<kMaxFixedStateVariablePathLength>(
+      kStateVariablePathPrefix, part_name, tail.view(),
+      kStateVariablePathSeparator, node_name, "[", index, "]");
+}
+
 }  // namespace intrinsic::icon
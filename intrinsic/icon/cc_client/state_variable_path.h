@@ -5,9 +5,15 @@
 #ifndef INTRINSIC_ICON_CC_CLIENT_STATE_VARIABLE_PATH_H_
 #define INTRINSIC_ICON_CC_CLIENT_STATE_VARIABLE_PATH_H_
 
+#include <cstddef>
+#include <initializer_list>
+#include <optional>
 #include <string>
 
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "intrinsic/icon/common/state_variable_path_constants.h"
+#include "intrinsic/icon/utils/fixed_string.h"
 
 namespace intrinsic::icon {
 
@@ -186,6 +192,193 @@ std::string RangefinderDistanceStateVariablePath(absl::string_view part_name);
 // Returns a generated state variable path string.
 std::string SafetyEnableButtonStatusStateVariablePath();
 
+// Non-allocating path builders.
+//
+// The functions above allocate several strings for every path. When building
+// many reactions, e.g. in a loop, prefer the builders below: The part of a
+// path that follows the part name (its "tail") is assembled at compile time,
+// and the complete path is built into a FixedStateVariablePath on the stack.
+//
+// Example:
+//
+// INTR_ASSIGN_OR_RETURN(
+//     FixedStateVariablePath path,
+//     BuildFixedStateVariablePath(
+//         "arm", kArmBaseTwistTipSensedPathTail<TwistDimension::Z>));
+// Condition condition = IsGreaterThan(path, 0.1);
+
+// The part of a state variable path that follows the part name, e.g.
+// ".ArmPart.sensed_position". Only create instances as constexpr, so that
+// exceeding kMaxStateVariablePathTailLength fails to compile.
+class StateVariablePathTail {
+ public:
+  enum class Kind {
+    // The tail ends the path.
+    kComplete,
+    // The tail ends in an array node and needs an index.
+    kIndexed,
+    // The tail is followed by a named array node, e.g. the signal block of an
+    // ADIO part, and needs a node name and an index.
+    kNamedIndexed,
+  };
+
+  static constexpr size_t kMaxStateVariablePathTailLength = 64;
+
+  // Joins `nodes` with kStateVariablePathSeparator and appends `index` to the
+  // last node, if set.
+  constexpr StateVariablePathTail(Kind kind,
+                                  std::initializer_list<absl::string_view> nodes,
+                                  std::optional<size_t> index = std::nullopt)
+      : kind_(kind) {
+    for (absl::string_view node : nodes) {
+      Append(kStateVariablePathSeparator);
+      Append(node);
+    }
+    if (index.has_value()) {
+      Append("[");
+      AppendIndex(*index);
+      Append("]");
+    }
+  }
+
+  constexpr Kind kind() const { return kind_; }
+  constexpr absl::string_view view() const { return {data_, size_}; }
+
+ private:
+  constexpr void Append(absl::string_view s) {
+    for (char c : s) {
+      // Out of bounds in a constant expression, i.e. a compile error, if the
+      // tail is too long.
+      data_[size_++] = c;
+    }
+  }
+
+  constexpr void AppendIndex(size_t index) {
+    char digits[20] = {};
+    size_t num_digits = 0;
+    do {
+      digits[num_digits++] = static_cast<char>('0' + index % 10);
+      index /= 10;
+    } while (index > 0);
+    while (num_digits > 0) {
+      data_[size_++] = digits[--num_digits];
+    }
+  }
+
+  Kind kind_;
+  char data_[kMaxStateVariablePathTailLength] = {};
+  size_t size_ = 0;
+};
+
+// Long enough for any path with valid node names, i.e. names of at most
+// kMaxNodeNameLength characters.
+inline constexpr size_t kMaxFixedStateVariablePathLength =
+    1 + kMaxNodeNameLength +
+    StateVariablePathTail::kMaxStateVariablePathTailLength + 1 +
+    kMaxNodeNameLength + 22;
+
+using FixedStateVariablePath = FixedString<kMaxFixedStateVariablePathLength>;
+
+// Tails of the arm paths, see ArmSensed*StateVariablePath(). Need a joint
+// index.
+inline constexpr StateVariablePathTail kArmSensedPositionPathTail(
+    StateVariablePathTail::Kind::kIndexed,
+    {kArmTypeNodeName, kSensedPositionNodeName});
+inline constexpr StateVariablePathTail kArmSensedVelocityPathTail(
+    StateVariablePathTail::Kind::kIndexed,
+    {kArmTypeNodeName, kSensedVelocityNodeName});
+inline constexpr StateVariablePathTail kArmSensedAccelerationPathTail(
+    StateVariablePathTail::Kind::kIndexed,
+    {kArmTypeNodeName, kSensedAccelerationNodeName});
+inline constexpr StateVariablePathTail kArmSensedTorquePathTail(
+    StateVariablePathTail::Kind::kIndexed,
+    {kArmTypeNodeName, kSensedTorqueNodeName});
+
+// See ArmBaseTwistTipSensedStateVariablePath().
+template <TwistDimension kTwistDimension>
+inline constexpr StateVariablePathTail kArmBaseTwistTipSensedPathTail(
+    StateVariablePathTail::Kind::kComplete,
+    {kArmTypeNodeName, kBaseTwistTipSensedNodeNodeName},
+    static_cast<size_t>(kTwistDimension));
+
+// See ArmBaseLinearVelocityTipSensedStateVariablePath().
+inline constexpr StateVariablePathTail kArmBaseLinearVelocityTipSensedPathTail(
+    StateVariablePathTail::Kind::kComplete,
+    {kArmTypeNodeName, kBaseLinearVelocityTipSensedNodeName});
+
+// See ArmBaseAngularVelocityTipSensedStateVariablePath().
+inline constexpr StateVariablePathTail kArmBaseAngularVelocityTipSensedPathTail(
+    StateVariablePathTail::Kind::kComplete,
+    {kArmTypeNodeName, kBaseAngularVelocityTipSensedNodeName});
+
+// See ArmCurrentControlModeStateVariablePath().
+inline constexpr StateVariablePathTail kArmCurrentControlModePathTail(
+    StateVariablePathTail::Kind::kComplete,
+    {kArmTypeNodeName, kCurrentControlModeNodeName});
+
+// See FTWrenchAtTipStateVariablePath().
+template <WrenchDimension kWrenchDimension>
+inline constexpr StateVariablePathTail kFTWrenchAtTipPathTail(
+    StateVariablePathTail::Kind::kComplete,
+    {kFTTypeNodeName, kWrenchAtTipNodeName},
+    static_cast<size_t>(kWrenchDimension));
+
+// See FTForceMagnitudeAtTipStateVariablePath().
+inline constexpr StateVariablePathTail kFTForceMagnitudeAtTipPathTail(
+    StateVariablePathTail::Kind::kComplete,
+    {kFTTypeNodeName, kForceMagnitudeAtTipNodeName});
+
+// See FTTorqueMagnitudeAtTipStateVariablePath().
+inline constexpr StateVariablePathTail kFTTorqueMagnitudeAtTipPathTail(
+    StateVariablePathTail::Kind::kComplete,
+    {kFTTypeNodeName, kTorqueMagnitudeAtTipNodeName});
+
+// See GripperSensedStateStateVariablePath().
+inline constexpr StateVariablePathTail kGripperSensedStatePathTail(
+    StateVariablePathTail::Kind::kComplete,
+    {kGripperTypeNodeName, kGripperSensedStateNodeName});
+
+// See GripperOpeningWidthStateVariablePath().
+inline constexpr StateVariablePathTail kGripperOpeningWidthPathTail(
+    StateVariablePathTail::Kind::kComplete,
+    {kGripperTypeNodeName, kGripperOpeningWidthNodeName});
+
+// Tails of the ADIO paths, see ADIO*StateVariablePath(). Need a block name and
+// a signal index.
+inline constexpr StateVariablePathTail kADIODigitalInputPathTail(
+    StateVariablePathTail::Kind::kNamedIndexed,
+    {kADIOTypeNodeName, kDigitalInputNodeName});
+inline constexpr StateVariablePathTail kADIODigitalOutputPathTail(
+    StateVariablePathTail::Kind::kNamedIndexed,
+    {kADIOTypeNodeName, kDigitalOutputNodeName});
+inline constexpr StateVariablePathTail kADIOAnalogInputPathTail(
+    StateVariablePathTail::Kind::kNamedIndexed,
+    {kADIOTypeNodeName, kAnalogInputNodeName});
+
+// See RangefinderDistanceStateVariablePath().
+inline constexpr StateVariablePathTail kRangefinderDistancePathTail(
+    StateVariablePathTail::Kind::kComplete,
+    {kRangefinderNodeName, kRangefinderDistanceNodeName});
+
+// Builds the state variable path of `tail` for the part `part_name` without
+// allocating.
+//
+// Returns InvalidArgumentError if `tail` needs an index, or if `part_name` is
+// empty, longer than kMaxNodeNameLength or contains a separator.
+absl::StatusOr<FixedStateVariablePath> BuildFixedStateVariablePath(
+    absl::string_view part_name, const StateVariablePathTail& tail);
+
+// As above, for tails of Kind::kIndexed.
+absl::StatusOr<FixedStateVariablePath> BuildFixedStateVariablePath(
+    absl::string_view part_name, const StateVariablePathTail& tail,
+    size_t index);
+
+// As above, for tails of Kind::kNamedIndexed. `node_name` is validated like
+// `part_name`.
+absl::StatusOr<FixedStateVariablePath> BuildFixedStateVariablePath(
+    absl::string_view part_name, const StateVariablePathTail& tail,
+    absl::string_view node_name, size_t index);
+
 }  // namespace intrinsic::icon
 
 #endif  // INTRINSIC_ICON_CC_CLIENT_STATE_VARIABLE_PATH_H_
@@ -0,0 +1,65 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/cc_client/state_variable_snapshot.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "intrinsic/icon/proto/service.pb.h"
+
+namespace intrinsic::icon {
+
+// static
+absl::StatusOr<StateVariableIndex> StateVariableIndex::FromProto(
+    std::vector<std::string> paths,
+    const ::intrinsic_proto::icon::CompileStateVariablesResponse& response) {
+  if (response.types_size() != static_cast<int>(paths.size())) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected ", paths.size(), " state variable types, got ",
+                     response.types_size()));
+  }
+  std::vector<Type> types;
+  types.reserve(response.types_size());
+  for (int type : response.types()) {
+    types.push_back(static_cast<Type>(type));
+  }
+  return StateVariableIndex(response.index_handle(), std::move(paths),
+                            std::move(types));
+}
+
+StateVariableIndex::StateVariableIndex(int64_t handle,
+                                       std::vector<std::string> paths,
+                                       std::vector<Type> types)
+    : handle_(handle), paths_(std::move(paths)), types_(std::move(types)) {}
+
+absl::StatusOr<size_t> StateVariableIndex::Find(absl::string_view path) const {
+  for (size_t i = 0; i < paths_.size(); ++i) {
+    if (paths_[i] == path) {
+      return i;
+    }
+  }
+  return absl::NotFoundError(
+      absl::StrCat("State variable index does not contain \"", path, "\""));
+}
+
+absl::Status FromProto(
+    const ::intrinsic_proto::icon::ReadStateVariablesResponse& response,
+    const StateVariableIndex& index, StateVariableSnapshot& snapshot) {
+  if (response.values_size() != static_cast<int>(index.size())) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected ", index.size(), " state variable values, got ",
+                     response.values_size()));
+  }
+  snapshot.timestamp_ns = response.timestamp_ns();
+  snapshot.values.assign(response.values().begin(), response.values().end());
+  return absl::OkStatus();
+}
+
+}  // namespace intrinsic::icon
@@ -0,0 +1,83 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_CC_CLIENT_STATE_VARIABLE_SNAPSHOT_H_
+#define INTRINSIC_ICON_CC_CLIENT_STATE_VARIABLE_SNAPSHOT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "intrinsic/icon/proto/service.pb.h"
+#include "intrinsic/icon/proto/types.pb.h"
+
+namespace intrinsic::icon {
+
+// A list of state variable paths that the server has compiled for reading,
+// see Client::CompileStateVariables(). The values of all paths are then read
+// with a single request that only carries the handle of the index, and
+// returned as one packed array in the order of the paths.
+//
+// The index is valid until the server restarts.
+class StateVariableIndex {
+ public:
+  using Type =
+      ::intrinsic_proto::icon::ActionSignature::StateVariableInfo::Type;
+
+  // Returns the index that the server compiled from `paths`.
+  //
+  // Returns InvalidArgumentError if `response` does not have a type for each
+  // path.
+  static absl::StatusOr<StateVariableIndex> FromProto(
+      std::vector<std::string> paths,
+      const ::intrinsic_proto::icon::CompileStateVariablesResponse& response);
+
+  // Identifies the index in requests.
+  int64_t handle() const { return handle_; }
+
+  size_t size() const { return paths_.size(); }
+
+  absl::Span<const std::string> paths() const { return paths_; }
+
+  // The value type of the path at `position`.
+  Type type(size_t position) const { return types_[position]; }
+
+  // Returns the position of `path` among the paths of the index.
+  //
+  // Returns NotFoundError if the index does not contain `path`.
+  absl::StatusOr<size_t> Find(absl::string_view path) const;
+
+ private:
+  StateVariableIndex(int64_t handle, std::vector<std::string> paths,
+                     std::vector<Type> types);
+
+  int64_t handle_;
+  std::vector<std::string> paths_;
+  std::vector<Type> types_;
+};
+
+// The values of the paths of a StateVariableIndex, all sampled in the same
+// control cycle.
+struct StateVariableSnapshot {
+  // Control timestamp, in nanoseconds since the server started.
+  int64_t timestamp_ns = 0;
+  // In the order of StateVariableIndex::paths(). Integer and boolean values
+  // are converted to double, see StateVariableIndex::type().
+  std::vector<double> values;
+};
+
+// Fills `snapshot` from `response`, reusing the storage of its values.
+//
+// Returns InvalidArgumentError if `response` does not have exactly
+// `index.size()` values.
+absl::Status FromProto(
+    const ::intrinsic_proto::icon::ReadStateVariablesResponse& response,
+    const StateVariableIndex& index, StateVariableSnapshot& snapshot);
+
+}  // namespace intrinsic::icon
+
+#endif  // INTRINSIC_ICON_CC_CLIENT_STATE_VARIABLE_SNAPSHOT_H_
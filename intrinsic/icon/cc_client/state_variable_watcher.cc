@@ -0,0 +1,119 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/cc_client/state_variable_watcher.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/support/sync_stream.h"
+#include "intrinsic/icon/cc_client/state_variable_snapshot.h"
+#include "intrinsic/icon/proto/service.grpc.pb.h"
+#include "intrinsic/icon/proto/service.pb.h"
+#include "intrinsic/util/grpc/channel_interface.h"
+#include "intrinsic/util/grpc/stream_watcher.h"
+#include "intrinsic/util/proto_time.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic::icon {
+
+// static
+absl::StatusOr<std::unique_ptr<StateVariableWatcher>>
+StateVariableWatcher::Create(
+    intrinsic_proto::icon::IconApi::StubInterface* stub,
+    ClientContextFactory client_context_factory, StateVariableIndex index,
+    absl::Duration period, Callback callback) {
+  if (period <= absl::ZeroDuration()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Period must be positive, got ", absl::FormatDuration(period)));
+  }
+  // Private constructor, so no make_unique.
+  return absl::WrapUnique(new StateVariableWatcher(
+      stub, std::move(client_context_factory), std::move(index), period,
+      std::move(callback)));
+}
+
+StateVariableWatcher::StateVariableWatcher(
+    intrinsic_proto::icon::IconApi::StubInterface* stub,
+    ClientContextFactory client_context_factory, StateVariableIndex index,
+    absl::Duration period, Callback callback)
+    : stub_(stub),
+      index_(std::move(index)),
+      period_(period),
+      callback_(std::move(callback)),
+      // Size the values of all buffers up front, so that filling them does not
+      // allocate.
+      buffer_(StateVariableSnapshot{
+          .values = std::vector<double>(index_.size())}) {
+  // Start watching only once all members are initialized.
+  watcher_ = std::make_unique<StreamWatcher>(
+      [this](::grpc::ClientContext* context) { return Stream(context); },
+      StreamWatcher::Options{
+          .name = "state variables",
+          .client_context_factory = std::move(client_context_factory),
+          .retry_delay = std::max(period, kMinStreamRetryDelay),
+          // The server does not know the index anymore, e.g. because it
+          // restarted, or rejects the period.
+          .is_permanent =
+              [](const absl::Status& status) {
+                return absl::IsNotFound(status) ||
+                       absl::IsInvalidArgument(status);
+              },
+      });
+}
+
+bool StateVariableWatcher::GetNewSnapshot(
+    const StateVariableSnapshot** snapshot) {
+  StateVariableSnapshot* latest = nullptr;
+  if (!buffer_.TryGetNewActiveBuffer(&latest, &generation_)) {
+    return false;
+  }
+  latest_ = latest;
+  *snapshot = latest;
+  return true;
+}
+
+absl::StatusOr<StateVariableSnapshot>
+StateVariableWatcher::GetLatestSnapshot() {
+  const StateVariableSnapshot* snapshot = nullptr;
+  GetNewSnapshot(&snapshot);
+  if (latest_ == nullptr) {
+    return absl::UnavailableError("No state variable snapshot received yet");
+  }
+  return *latest_;
+}
+
+absl::Status StateVariableWatcher::Stream(::grpc::ClientContext* context) {
+  intrinsic_proto::icon::WatchStateVariablesRequest request;
+  request.set_index_handle(index_.handle());
+  INTR_RETURN_IF_ERROR(ToProto(period_, request.mutable_period()));
+  std::unique_ptr<::grpc::ClientReaderInterface<
+      intrinsic_proto::icon::ReadStateVariablesResponse>>
+      stream = stub_->WatchStateVariables(context, request);
+  return ReadStream(
+      *stream,
+      [this](
+          const intrinsic_proto::icon::ReadStateVariablesResponse& response) {
+        StateVariableSnapshot* snapshot = buffer_.GetFreeBuffer();
+        if (absl::Status status = FromProto(response, index_, *snapshot);
+            !status.ok()) {
+          LOG(WARNING) << "Ignoring invalid state variable snapshot: "
+                       << status;
+          return;
+        }
+        buffer_.CommitFreeBuffer();
+        if (callback_ != nullptr) {
+          callback_(*snapshot);
+        }
+      });
+}
+
+}  // namespace intrinsic::icon
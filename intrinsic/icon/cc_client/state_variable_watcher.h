@@ -0,0 +1,96 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_CC_CLIENT_STATE_VARIABLE_WATCHER_H_
+#define INTRINSIC_ICON_CC_CLIENT_STATE_VARIABLE_WATCHER_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "grpcpp/client_context.h"
+#include "intrinsic/icon/cc_client/state_variable_snapshot.h"
+#include "intrinsic/icon/proto/service.grpc.pb.h"
+#include "intrinsic/icon/utils/async_buffer.h"
+#include "intrinsic/util/grpc/channel_interface.h"
+#include "intrinsic/util/grpc/stream_watcher.h"
+
+namespace intrinsic::icon {
+
+// Samples the values of a StateVariableIndex at a fixed period in the
+// background.
+//
+// A single thread reads the WatchStateVariables stream of the server and
+// publishes each snapshot into a triple buffer, and calls the optional
+// callback. The buffers keep the storage of their values, so sampling does not
+// allocate once they are warm. Reading the latest snapshot is lock-free and
+// does not make a request, which makes it cheap to sample dozens of signals in
+// a monitoring loop.
+//
+// If the stream breaks, the watcher reopens it after `period`, but at most
+// once per second. It stops if the server does not know the index, e.g.
+// because it restarted, or does not implement the stream; see status().
+//
+// Obtain a StateVariableWatcher from Client::WatchStateVariables(). It must
+// not outlive its Client.
+//
+// Only a single thread may read snapshots. Destroying the watcher cancels the
+// stream and waits for an outstanding callback to finish.
+class StateVariableWatcher {
+ public:
+  // Called on the thread of the watcher with each new snapshot. Must not block
+  // for long, since that delays the next one.
+  using Callback = absl::AnyInvocable<void(const StateVariableSnapshot&)>;
+
+  // Starts watching the values of `index` through `stub`, with ClientContexts
+  // from `client_context_factory`. `callback` may be null.
+  //
+  // Returns InvalidArgumentError if `period` is not positive.
+  static absl::StatusOr<std::unique_ptr<StateVariableWatcher>> Create(
+      intrinsic_proto::icon::IconApi::StubInterface* stub,
+      ClientContextFactory client_context_factory, StateVariableIndex index,
+      absl::Duration period, Callback callback);
+
+  StateVariableWatcher(const StateVariableWatcher&) = delete;
+  StateVariableWatcher& operator=(const StateVariableWatcher&) = delete;
+
+  const StateVariableIndex& index() const { return index_; }
+
+  // Sets `*snapshot` to the latest snapshot and returns true if it has changed
+  // since the last call. Otherwise, returns false and leaves `*snapshot`
+  // unchanged; the snapshot returned by the previous call stays valid until
+  // the next call.
+  bool GetNewSnapshot(const StateVariableSnapshot** snapshot);
+
+  // Returns the latest snapshot, or UnavailableError if none was received yet.
+  absl::StatusOr<StateVariableSnapshot> GetLatestSnapshot();
+
+  // Returns the error that stopped the watcher, or OkStatus while it runs.
+  absl::Status status() const { return watcher_->status(); }
+
+ private:
+  StateVariableWatcher(intrinsic_proto::icon::IconApi::StubInterface* stub,
+                       ClientContextFactory client_context_factory,
+                       StateVariableIndex index, absl::Duration period,
+                       Callback callback);
+
+  // Reads the stream until it ends, and returns its final status.
+  absl::Status Stream(::grpc::ClientContext* context);
+
+  intrinsic_proto::icon::IconApi::StubInterface* const stub_;
+  const StateVariableIndex index_;
+  const absl::Duration period_;
+  Callback callback_;
+  AsyncBuffer<StateVariableSnapshot> buffer_;
+  // Only accessed by the reader.
+  uint64_t generation_ = 0;
+  const StateVariableSnapshot* latest_ = nullptr;
+  // Last, so that it stops before the members it uses are destroyed.
+  std::unique_ptr<StreamWatcher> watcher_;
+};
+
+}  // namespace intrinsic::icon
+
+#endif  // INTRINSIC_ICON_CC_CLIENT_STATE_VARIABLE_WATCHER_H_
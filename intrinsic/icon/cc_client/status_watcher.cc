@@ -0,0 +1,241 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/cc_client/status_watcher.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/field_mask.pb.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/util/field_mask_util.h"
+#include "google/protobuf/util/message_differencer.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/support/sync_stream.h"
+#include "intrinsic/icon/proto/part_status.pb.h"
+#include "intrinsic/icon/proto/service.grpc.pb.h"
+#include "intrinsic/icon/proto/service.pb.h"
+#include "intrinsic/util/grpc/channel_interface.h"
+#include "intrinsic/util/grpc/stream_watcher.h"
+#include "intrinsic/util/proto_time.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic::icon {
+namespace {
+
+using ::google::protobuf::FieldMask;
+using ::google::protobuf::util::FieldMaskUtil;
+using ::google::protobuf::util::MessageDifferencer;
+using ::intrinsic_proto::icon::IconApi;
+using ::intrinsic_proto::icon::PartStatus;
+
+// Collects the paths of all differences, as far as a FieldMask can express
+// them, i.e. up to the first repeated field.
+class PathCollector : public MessageDifferencer::Reporter {
+ public:
+  const std::vector<std::string>& paths() const { return paths_; }
+
+  void ReportAdded(
+      const google::protobuf::Message& message1,
+      const google::protobuf::Message& message2,
+      const std::vector<MessageDifferencer::SpecificField>& field_path)
+      override {
+    Add(field_path);
+  }
+  void ReportDeleted(
+      const google::protobuf::Message& message1,
+      const google::protobuf::Message& message2,
+      const std::vector<MessageDifferencer::SpecificField>& field_path)
+      override {
+    Add(field_path);
+  }
+  void ReportModified(
+      const google::protobuf::Message& message1,
+      const google::protobuf::Message& message2,
+      const std::vector<MessageDifferencer::SpecificField>& field_path)
+      override {
+    Add(field_path);
+  }
+
+ private:
+  void Add(const std::vector<MessageDifferencer::SpecificField>& field_path) {
+    std::vector<absl::string_view> names;
+    for (const MessageDifferencer::SpecificField& specific_field : field_path) {
+      if (specific_field.field == nullptr) {
+        break;
+      }
+      names.push_back(specific_field.field->name());
+      if (specific_field.field->is_repeated()) {
+        break;
+      }
+    }
+    paths_.push_back(absl::StrJoin(names, "."));
+  }
+
+  std::vector<std::string> paths_;
+};
+
+// Returns true if one of `path` and `other` is a prefix path of the other.
+bool PathsOverlap(absl::string_view path, absl::string_view other) {
+  if (path.size() > other.size()) {
+    std::swap(path, other);
+  }
+  return absl::StartsWith(other, path) &&
+         (other.size() == path.size() || other[path.size()] == '.');
+}
+
+// Returns all fields of PartStatus, except `timestamp_ns`.
+FieldMask AllFields() {
+  FieldMask fields;
+  const google::protobuf::Descriptor* descriptor = PartStatus::descriptor();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    if (descriptor->field(i)->number() != PartStatus::kTimestampNsFieldNumber) {
+      fields.add_paths(descriptor->field(i)->name());
+    }
+  }
+  return fields;
+}
+
+}  // namespace
+
+// static
+absl::StatusOr<std::unique_ptr<StatusWatcher>> StatusWatcher::Create(
+    IconApi::StubInterface* stub, ClientContextFactory client_context_factory,
+    absl::Span<const std::string> part_names, const FieldMask& fields,
+    absl::Duration period, FetchFn fetch, UpdateCallback callback) {
+  if (!FieldMaskUtil::IsValidFieldMask<PartStatus>(fields)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid field mask for PartStatus: ",
+                     FieldMaskUtil::ToString(fields)));
+  }
+  if (period <= absl::ZeroDuration()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Period must be positive, got ", absl::FormatDuration(period)));
+  }
+  // Private constructor, so no make_unique.
+  return absl::WrapUnique(new StatusWatcher(
+      stub, std::move(client_context_factory), part_names,
+      fields.paths().empty() ? AllFields() : fields, period, std::move(fetch),
+      std::move(callback)));
+}
+
+StatusWatcher::StatusWatcher(IconApi::StubInterface* stub,
+                             ClientContextFactory client_context_factory,
+                             absl::Span<const std::string> part_names,
+                             FieldMask fields, absl::Duration period,
+                             FetchFn fetch, UpdateCallback callback)
+    : stub_(stub),
+      part_names_(part_names.begin(), part_names.end()),
+      fields_(std::move(fields)),
+      period_(period),
+      fetch_(std::move(fetch)),
+      callback_(std::move(callback)) {
+  // Start watching only once all members are initialized.
+  watcher_ = std::make_unique<StreamWatcher>(
+      [this](::grpc::ClientContext* context) { return Stream(context); },
+      StreamWatcher::Options{
+          .name = "part status",
+          .client_context_factory = std::move(client_context_factory),
+          .retry_delay = std::max(period, kMinStreamRetryDelay),
+          .poll =
+              [this](absl::Time) {
+                Poll();
+                return absl::OkStatus();
+              },
+          .poll_period = period,
+          // The server rejects the field mask or the period.
+          .is_permanent =
+              [](const absl::Status& status) {
+                return absl::IsInvalidArgument(status);
+              },
+      });
+}
+
+absl::Status StatusWatcher::Stream(::grpc::ClientContext* context) {
+  intrinsic_proto::icon::WatchStatusRequest request;
+  request.mutable_part_names()->Add(part_names_.begin(), part_names_.end());
+  *request.mutable_fields() = fields_;
+  INTR_RETURN_IF_ERROR(ToProto(period_, request.mutable_period()));
+  std::unique_ptr<::grpc::ClientReaderInterface<
+      intrinsic_proto::icon::WatchStatusResponse>>
+      stream = stub_->WatchStatus(context, request);
+  return ReadStream(
+      *stream,
+      [this](intrinsic_proto::icon::WatchStatusResponse& response) {
+        for (auto& change : *response.mutable_changes()) {
+          PartStatusUpdate update{
+              .part_name = std::move(*change.mutable_part_name()),
+              .changed_fields = std::move(*change.mutable_changed_fields()),
+              .status = std::move(*change.mutable_status())};
+          callback_(update);
+        }
+      });
+}
+
+void StatusWatcher::Poll() {
+  absl::StatusOr<::intrinsic_proto::icon::GetStatusResponse> response =
+      fetch_();
+  if (!response.ok()) {
+    LOG_EVERY_N_SEC(WARNING, 10)
+        << "Failed to fetch status: " << response.status();
+  } else if (part_names_.empty()) {
+    for (const auto& [part_name, status] : response->part_status()) {
+      Update(part_name, status);
+    }
+  } else {
+    for (const std::string& part_name : part_names_) {
+      if (auto it = response->part_status().find(part_name);
+          it != response->part_status().end()) {
+        Update(part_name, it->second);
+      }
+    }
+  }
+}
+
+void StatusWatcher::Update(const std::string& part_name,
+                           const PartStatus& status) {
+  PartStatus trimmed = status;
+  FieldMaskUtil::TrimMessage(fields_, &trimmed);
+  PartStatusUpdate update{.part_name = part_name};
+  auto [it, inserted] = last_status_.try_emplace(part_name);
+  if (inserted) {
+    update.changed_fields = fields_;
+  } else {
+    PathCollector collector;
+    MessageDifferencer differencer;
+    differencer.IgnoreField(
+        PartStatus::descriptor()->FindFieldByNumber(
+            PartStatus::kTimestampNsFieldNumber));
+    differencer.ReportDifferencesTo(&collector);
+    if (differencer.Compare(it->second, trimmed)) {
+      return;
+    }
+    for (const std::string& path : fields_.paths()) {
+      if (std::any_of(collector.paths().begin(), collector.paths().end(),
+                      [&path](absl::string_view changed) {
+                        return PathsOverlap(path, changed);
+                      })) {
+        update.changed_fields.add_paths(path);
+      }
+    }
+  }
+  update.status = trimmed;
+  FieldMaskUtil::TrimMessage(update.changed_fields, &update.status);
+  update.status.set_timestamp_ns(status.timestamp_ns());
+  it->second = std::move(trimmed);
+  callback_(update);
+}
+
+}  // namespace intrinsic::icon
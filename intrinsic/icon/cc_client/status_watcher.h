@@ -0,0 +1,115 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_CC_CLIENT_STATUS_WATCHER_H_
+#define INTRINSIC_ICON_CC_CLIENT_STATUS_WATCHER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "google/protobuf/field_mask.pb.h"
+#include "grpcpp/client_context.h"
+#include "intrinsic/icon/proto/part_status.pb.h"
+#include "intrinsic/icon/proto/service.grpc.pb.h"
+#include "intrinsic/icon/proto/service.pb.h"
+#include "intrinsic/util/grpc/channel_interface.h"
+#include "intrinsic/util/grpc/stream_watcher.h"
+
+namespace intrinsic::icon {
+
+// A change of the status of a single Part.
+struct PartStatusUpdate {
+  std::string part_name;
+  // The watched fields of `status` that changed since the last update. The
+  // first update of a Part contains all watched fields.
+  google::protobuf::FieldMask changed_fields;
+  // Only `timestamp_ns` and the fields in `changed_fields` are set.
+  ::intrinsic_proto::icon::PartStatus status;
+};
+
+// Watches the status of a set of Parts in the background, and reports only
+// the fields that changed.
+//
+// A single thread reads the WatchStatus stream of the server, which compares
+// the status once per `period` and sends only the changes, and calls the
+// callback once per Part whose watched fields changed. `timestamp_ns` changes
+// with every status, so it does not count as a change. If the stream breaks,
+// the watcher reopens it, and the first update of each Part contains all
+// watched fields again. Servers that do not implement the stream are polled
+// with GetStatus() once per `period` instead, and the watcher compares the
+// status itself.
+//
+// Obtain a StatusWatcher from Client::WatchStatus(). It must not outlive its
+// Client. Destroying the watcher cancels the stream and waits for an
+// outstanding callback to finish.
+class StatusWatcher {
+ public:
+  // Fetches the status of all parts from a server without WatchStatus.
+  using FetchFn = absl::AnyInvocable<
+      absl::StatusOr<::intrinsic_proto::icon::GetStatusResponse>()>;
+  // Called on the thread of the watcher. Must not block for long, since that
+  // delays the next update.
+  using UpdateCallback = absl::AnyInvocable<void(const PartStatusUpdate&)>;
+
+  // Starts watching the status through `stub`, with ClientContexts from
+  // `client_context_factory`, and calls `callback` with the changes of the
+  // Parts `part_names`, or of all Parts if `part_names` is empty. Only the
+  // fields in `fields` are watched, or all fields if `fields` is empty.
+  // `fetch` is only used if the server does not implement WatchStatus; failed
+  // fetches are skipped.
+  //
+  // Returns InvalidArgumentError if `fields` is not a valid field mask for
+  // PartStatus, or if `period` is not positive.
+  static absl::StatusOr<std::unique_ptr<StatusWatcher>> Create(
+      ::intrinsic_proto::icon::IconApi::StubInterface* stub,
+      ClientContextFactory client_context_factory,
+      absl::Span<const std::string> part_names,
+      const google::protobuf::FieldMask& fields, absl::Duration period,
+      FetchFn fetch, UpdateCallback callback);
+
+  StatusWatcher(const StatusWatcher&) = delete;
+  StatusWatcher& operator=(const StatusWatcher&) = delete;
+
+  // Returns the error that stopped the watcher, e.g. because the server
+  // rejected the request, or OkStatus while it runs.
+  absl::Status status() const { return watcher_->status(); }
+
+ private:
+  StatusWatcher(::intrinsic_proto::icon::IconApi::StubInterface* stub,
+                ClientContextFactory client_context_factory,
+                absl::Span<const std::string> part_names,
+                google::protobuf::FieldMask fields, absl::Duration period,
+                FetchFn fetch, UpdateCallback callback);
+
+  // Reads the stream until it ends, and returns its final status.
+  absl::Status Stream(::grpc::ClientContext* context);
+  // Fetches the status once, and reports the changes since the last fetch.
+  void Poll();
+  // Reports the changes of the Part `part_name` to `status`.
+  void Update(const std::string& part_name,
+              const ::intrinsic_proto::icon::PartStatus& status);
+
+  ::intrinsic_proto::icon::IconApi::StubInterface* const stub_;
+  const std::vector<std::string> part_names_;
+  // Never empty, see Create().
+  const google::protobuf::FieldMask fields_;
+  const absl::Duration period_;
+  FetchFn fetch_;
+  UpdateCallback callback_;
+  // Only accessed by the thread of `watcher_` while polling. Trimmed to
+  // `fields_`.
+  absl::flat_hash_map<std::string, ::intrinsic_proto::icon::PartStatus>
+      last_status_;
+  // Last, so that it stops before the members it uses are destroyed.
+  std::unique_ptr<StreamWatcher> watcher_;
+};
+
+}  // namespace intrinsic::icon
+
+#endif  // INTRINSIC_ICON_CC_CLIENT_STATUS_WATCHER_H_
@@ -2,21 +2,56 @@
 
 #include "intrinsic/icon/cc_client/stream.h"
 
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <utility>
 
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "google/protobuf/any.pb.h"
+#include "google/protobuf/message.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/support/config.h"
 #include "grpcpp/support/sync_stream.h"
+#include "intrinsic/icon/cc_client/client_tracing.h"
 #include "intrinsic/icon/common/id_types.h"
+#include "intrinsic/icon/proto/service.grpc.pb.h"
 #include "intrinsic/icon/proto/service.pb.h"
+#include "intrinsic/util/grpc/channel_interface.h"
 #include "intrinsic/util/status/status_conversion_grpc.h"
 #include "intrinsic/util/status/status_conversion_rpc.h"
 #include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
 
 namespace intrinsic::icon::internal {
 
+// static
+absl::StatusOr<std::unique_ptr<GenericStreamWriter>> GenericStreamWriter::Open(
+    SessionId session_id, ActionInstanceId action_instance_id,
+    absl::string_view input_name,
+    intrinsic_proto::icon::IconApi::StubInterface* stub,
+    const ClientContextFactory& client_context_factory) {
+  std::unique_ptr<::grpc::ClientContext> context;
+  if (client_context_factory) {
+    context = client_context_factory();
+  } else {
+    context = std::make_unique<::grpc::ClientContext>();
+  }
+  auto grpc_stream = stub->OpenWriteStream(context.get());
+  auto stream_writer = std::make_unique<GenericStreamWriter>(
+      std::move(context), std::move(grpc_stream));
+  INTR_RETURN_IF_ERROR(stream_writer->OpenStreamWriter(
+      session_id, action_instance_id, input_name));
+  return stream_writer;
+}
+
 GenericStreamWriter::~GenericStreamWriter() {
   if (absl::Status status = FinishIfNeeded(); !status.ok()) {
     LOG(ERROR) << "Stream closing with status: " << status;
@@ -61,6 +96,7 @@ absl::Status GenericStreamWriter::OpenStreamWriter(
 
 absl::Status GenericStreamWriter::WriteToStream(
     const google::protobuf::Message& value) {
+  ScopedClientTrace trace(ClientTracePoint::kStreamWrite);
   intrinsic_proto::icon::OpenWriteStreamRequest req;
   req.mutable_write_value()->mutable_value()->PackFrom(value);
 
@@ -100,4 +136,180 @@ absl::Status GenericStreamWriter::FinishIfNeeded() {
   return *finish_status_;
 }
 
+GenericBufferedStreamWriter::GenericBufferedStreamWriter(
+    std::unique_ptr<GenericStreamWriter> stream_writer,
+    absl::string_view type_name, const BufferedStreamWriterOptions& options)
+    : options_(options),
+      // Same prefix as google::protobuf::Any::PackFrom().
+      type_url_(absl::StrCat("type.googleapis.com/", type_name)),
+      stream_writer_(std::move(stream_writer)),
+      send_thread_(&GenericBufferedStreamWriter::SendLoop, this),
+      receive_thread_(&GenericBufferedStreamWriter::ReceiveLoop, this) {}
+
+GenericBufferedStreamWriter::~GenericBufferedStreamWriter() {
+  {
+    // Let the send thread drain the queue first.
+    absl::MutexLock lock(&mutex_);
+    mutex_.Await(absl::Condition(
+        this, &GenericBufferedStreamWriter::QueueEmptyOrFailed));
+    stop_ = true;
+  }
+  send_thread_.Join();
+  // The server ends the call once it has acknowledged all values, which lets
+  // the receive thread return.
+  stream_writer_->grpc_stream_->WritesDone();
+  receive_thread_.Join();
+  stream_writer_->finish_status_ =
+      ToAbslStatus(stream_writer_->grpc_stream_->Finish());
+  if (!stream_writer_->finish_status_->ok()) {
+    LOG(ERROR) << "Stream closing with status: "
+               << *stream_writer_->finish_status_;
+  }
+}
+
+// static
+absl::Status GenericBufferedStreamWriter::ValidateOptions(
+    const BufferedStreamWriterOptions& options) {
+  if (options.max_in_flight < 1) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "max_in_flight must be at least 1, got ", options.max_in_flight));
+  }
+  if (options.queue_capacity < 1) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "queue_capacity must be at least 1, got ", options.queue_capacity));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status GenericBufferedStreamWriter::Write(
+    const google::protobuf::Message& value) {
+  absl::MutexLock lock(&mutex_);
+  if (!stream_status_.ok()) {
+    return stream_status_;
+  }
+  std::string serialized_value;
+  if (!spare_strings_.empty()) {
+    serialized_value = std::move(spare_strings_.back());
+    spare_strings_.pop_back();
+  }
+  if (!value.SerializeToString(&serialized_value)) {
+    return absl::InvalidArgumentError("Failed to serialize value.");
+  }
+  if (queue_.size() >= static_cast<size_t>(options_.queue_capacity)) {
+    spare_strings_.push_back(std::move(queue_.front().serialized_value));
+    queue_.pop_front();
+    ++stats_.num_dropped;
+  }
+  queue_.push_back({.serialized_value = std::move(serialized_value),
+                    .queued_at = absl::Now()});
+  return absl::OkStatus();
+}
+
+absl::Status GenericBufferedStreamWriter::Flush(absl::Time deadline) {
+  absl::MutexLock lock(&mutex_);
+  const bool flushed = mutex_.AwaitWithDeadline(
+      absl::Condition(this, &GenericBufferedStreamWriter::FlushedOrFailed),
+      deadline);
+  if (!stream_status_.ok()) {
+    return stream_status_;
+  }
+  if (!flushed) {
+    return absl::DeadlineExceededError(
+        "Timed out waiting for the server to acknowledge all values.");
+  }
+  return absl::OkStatus();
+}
+
+BufferedStreamWriterStats GenericBufferedStreamWriter::GetStats() const {
+  absl::MutexLock lock(&mutex_);
+  return stats_;
+}
+
+bool GenericBufferedStreamWriter::CanSendOrStop() const {
+  return stop_ || !stream_status_.ok() ||
+         (!queue_.empty() && num_in_flight_ < options_.max_in_flight);
+}
+
+bool GenericBufferedStreamWriter::QueueEmptyOrFailed() const {
+  return queue_.empty() || !stream_status_.ok();
+}
+
+bool GenericBufferedStreamWriter::FlushedOrFailed() const {
+  return (queue_.empty() && num_in_flight_ == 0) || !stream_status_.ok();
+}
+
+void GenericBufferedStreamWriter::Fail(absl::Status status) {
+  if (stream_status_.ok()) {
+    stream_status_ = std::move(status);
+  }
+}
+
+void GenericBufferedStreamWriter::SendLoop() {
+  // Reused for all writes, so that sending does not allocate once the strings
+  // of the queue have grown to the size of a serialized value.
+  intrinsic_proto::icon::OpenWriteStreamRequest request;
+  google::protobuf::Any* any = request.mutable_write_value()->mutable_value();
+  any->set_type_url(type_url_);
+  while (true) {
+    QueuedValue queued;
+    ::grpc::WriteOptions write_options;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(
+          absl::Condition(this, &GenericBufferedStreamWriter::CanSendOrStop));
+      if (stop_ || !stream_status_.ok()) {
+        return;
+      }
+      queued = std::move(queue_.front());
+      queue_.pop_front();
+      ++num_in_flight_;
+      if (absl::Now() - queued.queued_at > options_.late_threshold) {
+        ++stats_.num_late;
+      }
+      // Let gRPC coalesce this write with the next one if that can be sent
+      // right away. Otherwise the write must go out immediately, since the
+      // next one waits for an acknowledgement.
+      if (!queue_.empty() && num_in_flight_ < options_.max_in_flight) {
+        write_options.set_buffer_hint();
+      }
+    }
+    any->mutable_value()->swap(queued.serialized_value);
+    const bool written =
+        stream_writer_->grpc_stream_->Write(request, write_options);
+
+    absl::MutexLock lock(&mutex_);
+    spare_strings_.push_back(std::move(queued.serialized_value));
+    if (!written) {
+      Fail(absl::AbortedError("Failed to write to stream."));
+      return;
+    }
+  }
+}
+
+void GenericBufferedStreamWriter::ReceiveLoop() {
+  intrinsic_proto::icon::OpenWriteStreamResponse response;
+  while (stream_writer_->grpc_stream_->Read(&response)) {
+    absl::MutexLock lock(&mutex_);
+    if (num_in_flight_ > 0) {
+      --num_in_flight_;
+    }
+    if (!response.has_write_value_response()) {
+      Fail(absl::InternalError(
+          "Stream write response is missing `write_value_response` field "
+          "after writing a value."));
+      continue;
+    }
+    absl::Status status =
+        intrinsic::MakeStatusFromRpcStatus(response.write_value_response());
+    if (status.ok()) {
+      ++stats_.num_accepted;
+    } else {
+      ++stats_.num_rejected;
+      stats_.last_rejection = std::move(status);
+    }
+  }
+  absl::MutexLock lock(&mutex_);
+  Fail(absl::AbortedError("The stream was closed."));
+}
+
 }  // namespace intrinsic::icon::internal
@@ -3,14 +3,22 @@
 #ifndef INTRINSIC_ICON_CC_CLIENT_STREAM_H_
 #define INTRINSIC_ICON_CC_CLIENT_STREAM_H_
 
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <optional>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "google/protobuf/message.h"
 #include "grpcpp/client_context.h"
 #include "grpcpp/support/sync_stream.h"
 #include "intrinsic/icon/common/id_types.h"
@@ -18,6 +26,7 @@
 #include "intrinsic/icon/proto/service.pb.h"
 #include "intrinsic/util/grpc/channel_interface.h"
 #include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
 
 namespace intrinsic::icon {
 
@@ -34,10 +43,71 @@ class StreamWriterInterface {
   virtual absl::Status Write(const T& value) = 0;
 };
 
+// Configures a BufferedStreamWriter.
+struct BufferedStreamWriterOptions {
+  // Maximum number of values that have been sent, but not acknowledged by the
+  // server yet. Must be at least 1.
+  int max_in_flight = 4;
+  // Maximum number of values that wait to be sent. If the queue is full, the
+  // oldest waiting value is dropped in favor of the new one. Must be at least
+  // 1.
+  int queue_capacity = 2;
+  // Values that wait longer than this to be sent are counted as late.
+  absl::Duration late_threshold = absl::Milliseconds(1);
+};
+
+// Counters of a BufferedStreamWriter.
+struct BufferedStreamWriterStats {
+  // Values that the server has accepted.
+  int64_t num_accepted = 0;
+  // Values that the server has rejected.
+  int64_t num_rejected = 0;
+  // Values that were dropped from the queue before they could be sent.
+  int64_t num_dropped = 0;
+  // Values that waited longer than `late_threshold` to be sent.
+  int64_t num_late = 0;
+  // The status of the last rejected value, if any.
+  absl::Status last_rejection;
+};
+
+// A StreamWriter that does not wait for the server. Write() only queues the
+// value, while background threads send queued values and collect the
+// acknowledgements of the server, with up to `max_in_flight` values sent
+// ahead. This takes the round trip to the server out of the writing thread,
+// which makes it suitable for streaming setpoints at high rates.
+//
+// Values queued back-to-back are coalesced into fewer network writes. If the
+// server falls behind, older setpoints are dropped in favor of newer ones.
+// Since the server's response is not known when Write() returns, rejected
+// values are only counted; see GetStats().
+//
+// Write() and Flush() may be called from different threads.
+template <class T>
+class BufferedStreamWriterInterface : public StreamWriterInterface<T> {
+ public:
+  // Queues `value` to be written to the Action input stream, without waiting
+  // for the server. Returns AbortedError if the stream has failed.
+  absl::Status Write(const T& value) override = 0;
+
+  // Blocks until all queued values have been acknowledged by the server, or
+  // `deadline` passes (DeadlineExceededError). Returns AbortedError if the
+  // stream has failed.
+  virtual absl::Status Flush(absl::Time deadline) = 0;
+
+  virtual BufferedStreamWriterStats GetStats() const = 0;
+};
+
 namespace internal {
 
 class GenericStreamWriter {
  public:
+  // Opens a write stream to `input_name` of the given action.
+  static absl::StatusOr<std::unique_ptr<GenericStreamWriter>> Open(
+      SessionId session_id, ActionInstanceId action_instance_id,
+      absl::string_view input_name,
+      intrinsic_proto::icon::IconApi::StubInterface* stub,
+      const ClientContextFactory& client_context_factory);
+
   GenericStreamWriter(std::unique_ptr<::grpc::ClientContext> channel_context,
                       std::unique_ptr<::grpc::ClientReaderWriterInterface<
                           intrinsic_proto::icon::OpenWriteStreamRequest,
@@ -56,6 +126,8 @@ class GenericStreamWriter {
   absl::Status FinishIfNeeded();
 
  private:
+  friend class GenericBufferedStreamWriter;
+
   std::unique_ptr<::grpc::ClientContext> channel_context_;
   std::unique_ptr<::grpc::ClientReaderWriterInterface<
       intrinsic_proto::icon::OpenWriteStreamRequest,
@@ -76,21 +148,12 @@ class StreamWriter : public StreamWriterInterface<T> {
       absl::string_view input_name,
       intrinsic_proto::icon::IconApi::StubInterface* stub,
       const ClientContextFactory& client_context_factory = nullptr) {
-    std::unique_ptr<::grpc::ClientContext> context;
-    if (client_context_factory) {
-      context = client_context_factory();
-    } else {
-      context = std::make_unique<::grpc::ClientContext>();
-    }
-    auto grpc_stream = stub->OpenWriteStream(context.get());
-    auto generic_stream_writer = std::make_unique<GenericStreamWriter>(
-        std::move(context), std::move(grpc_stream));
-    auto stream_writer =
-        std::make_unique<::intrinsic::icon::internal::StreamWriter<T>>(
-            std::move(generic_stream_writer));
-    INTR_RETURN_IF_ERROR(stream_writer->stream_writer_->OpenStreamWriter(
-        session_id, action_instance_id, input_name));
-    return stream_writer;
+    INTR_ASSIGN_OR_RETURN(
+        std::unique_ptr<GenericStreamWriter> generic_stream_writer,
+        GenericStreamWriter::Open(session_id, action_instance_id, input_name,
+                                  stub, client_context_factory));
+    return std::make_unique<::intrinsic::icon::internal::StreamWriter<T>>(
+        std::move(generic_stream_writer));
   }
 
   absl::Status Write(const T& value) override {
@@ -101,6 +164,103 @@ class StreamWriter : public StreamWriterInterface<T> {
   std::unique_ptr<GenericStreamWriter> stream_writer_;
 };
 
+// Sends serialized values of a fixed message type on a GenericStreamWriter
+// from background threads. See BufferedStreamWriterInterface.
+class GenericBufferedStreamWriter {
+ public:
+  // `type_name` is the full name of the message type of all written values.
+  GenericBufferedStreamWriter(
+      std::unique_ptr<GenericStreamWriter> stream_writer,
+      absl::string_view type_name, const BufferedStreamWriterOptions& options);
+  // Sends the values that are still queued and waits for their
+  // acknowledgements.
+  ~GenericBufferedStreamWriter();
+
+  GenericBufferedStreamWriter(const GenericBufferedStreamWriter&) = delete;
+  GenericBufferedStreamWriter& operator=(const GenericBufferedStreamWriter&) =
+      delete;
+
+  // Returns InvalidArgumentError if `options` are out of range.
+  static absl::Status ValidateOptions(
+      const BufferedStreamWriterOptions& options);
+
+  absl::Status Write(const google::protobuf::Message& value)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  absl::Status Flush(absl::Time deadline) ABSL_LOCKS_EXCLUDED(mutex_);
+  BufferedStreamWriterStats GetStats() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct QueuedValue {
+    std::string serialized_value;
+    absl::Time queued_at;
+  };
+
+  bool CanSendOrStop() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  bool QueueEmptyOrFailed() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  bool FlushedOrFailed() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Records that the stream has failed, unless it failed before.
+  void Fail(absl::Status status) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  void SendLoop();
+  void ReceiveLoop();
+
+  const BufferedStreamWriterOptions options_;
+  const std::string type_url_;
+  std::unique_ptr<GenericStreamWriter> stream_writer_;
+
+  mutable absl::Mutex mutex_;
+  std::deque<QueuedValue> queue_ ABSL_GUARDED_BY(mutex_);
+  // Strings of values that have been sent, kept to reuse their capacity.
+  std::vector<std::string> spare_strings_ ABSL_GUARDED_BY(mutex_);
+  int num_in_flight_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool stop_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::Status stream_status_ ABSL_GUARDED_BY(mutex_);
+  BufferedStreamWriterStats stats_ ABSL_GUARDED_BY(mutex_);
+
+  Thread send_thread_;
+  Thread receive_thread_;
+};
+
+template <class T>
+class BufferedStreamWriter : public BufferedStreamWriterInterface<T> {
+ public:
+  explicit BufferedStreamWriter(
+      std::unique_ptr<GenericStreamWriter> stream_writer,
+      const BufferedStreamWriterOptions& options)
+      : stream_writer_(std::move(stream_writer), T::descriptor()->full_name(),
+                       options) {}
+
+  static absl::StatusOr<std::unique_ptr<BufferedStreamWriter<T>>> Open(
+      SessionId session_id, ActionInstanceId action_instance_id,
+      absl::string_view input_name,
+      intrinsic_proto::icon::IconApi::StubInterface* stub,
+      const BufferedStreamWriterOptions& options,
+      const ClientContextFactory& client_context_factory = nullptr) {
+    INTR_RETURN_IF_ERROR(GenericBufferedStreamWriter::ValidateOptions(options));
+    INTR_ASSIGN_OR_RETURN(
+        std::unique_ptr<GenericStreamWriter> generic_stream_writer,
+        GenericStreamWriter::Open(session_id, action_instance_id, input_name,
+                                  stub, client_context_factory));
+    return std::make_unique<BufferedStreamWriter<T>>(
+        std::move(generic_stream_writer), options);
+  }
+
+  absl::Status Write(const T& value) override {
+    return stream_writer_.Write(value);
+  }
+
+  absl::Status Flush(absl::Time deadline) override {
+    return stream_writer_.Flush(deadline);
+  }
+
+  BufferedStreamWriterStats GetStats() const override {
+    return stream_writer_.GetStats();
+  }
+
+ private:
+  GenericBufferedStreamWriter stream_writer_;
+};
+
 }  // namespace internal
 }  // namespace intrinsic::icon
 
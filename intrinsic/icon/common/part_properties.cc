@@ -2,11 +2,16 @@
 
 #include "intrinsic/icon/common/part_properties.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <tuple>
 #include <variant>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "intrinsic/icon/proto/service.pb.h"
 
 namespace intrinsic::icon {
@@ -69,4 +74,94 @@ absl::Status AssignPropertyValue::operator()(bool src, double& dst) {
       "Cannot assign boolean value to double property '", property_name, "'"));
 }
 
+PartPropertyMap DiffPartProperties(const PartPropertiesByPart& before,
+                                   const PartPropertiesByPart& after) {
+  PartPropertyMap diff;
+  for (const auto& [part_name, properties] : after) {
+    auto before_part = before.find(part_name);
+    for (const auto& [property_name, value] : properties) {
+      if (before_part != before.end()) {
+        auto before_value = before_part->second.find(property_name);
+        if (before_value != before_part->second.end() &&
+            before_value->second == value) {
+          continue;
+        }
+      }
+      diff.properties[part_name][property_name] = value;
+    }
+  }
+  return diff;
+}
+
+PartPropertyTable::PartPropertyTable(const PartPropertiesByPart& properties) {
+  for (const auto& [part_name, part_properties] : properties) {
+    for (const auto& [property_name, value] : part_properties) {
+      entries_.push_back({.part_name = part_name,
+                          .property_name = property_name,
+                          .value = value});
+    }
+  }
+  std::sort(entries_.begin(), entries_.end(),
+            [](const Entry& a, const Entry& b) {
+              return std::tie(a.part_name, a.property_name) <
+                     std::tie(b.part_name, b.property_name);
+            });
+}
+
+std::optional<PartPropertyId> PartPropertyTable::FindId(
+    absl::string_view part_name, absl::string_view property_name) const {
+  auto it = std::lower_bound(
+      entries_.begin(), entries_.end(), part_name,
+      [property_name](const Entry& entry, absl::string_view part_name) {
+        const int part_compare =
+            absl::string_view(entry.part_name).compare(part_name);
+        return part_compare < 0 ||
+               (part_compare == 0 && entry.property_name < property_name);
+      });
+  if (it == entries_.end() || it->part_name != part_name ||
+      it->property_name != property_name) {
+    return std::nullopt;
+  }
+  return PartPropertyId(static_cast<size_t>(it - entries_.begin()));
+}
+
+absl::Status PartPropertyTable::Set(PartPropertyId id,
+                                    const PartPropertyValue& value) {
+  if (id.value() >= entries_.size()) {
+    return absl::OutOfRangeError(absl::StrCat("Part property id ", id.value(),
+                                              " is out of range [0, ",
+                                              entries_.size(), ")"));
+  }
+  Entry& entry = entries_[id.value()];
+  return std::visit(
+      AssignPropertyValue{.property_name = absl::StrCat(
+                              entry.part_name, ".", entry.property_name)},
+      value, entry.value);
+}
+
+absl::Status PartPropertyTable::Update(const PartPropertiesByPart& properties) {
+  for (const auto& [part_name, part_properties] : properties) {
+    for (const auto& [property_name, value] : part_properties) {
+      std::optional<PartPropertyId> id = FindId(part_name, property_name);
+      if (!id.has_value()) {
+        return absl::NotFoundError(absl::StrCat("Part '", part_name,
+                                                "' has no property '",
+                                                property_name, "'"));
+      }
+      if (absl::Status status = Set(*id, value); !status.ok()) {
+        return status;
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+PartPropertyMap PartPropertyTable::ToPartPropertyMap() const {
+  PartPropertyMap map;
+  for (const Entry& entry : entries_) {
+    map.properties[entry.part_name][entry.property_name] = entry.value;
+  }
+  return map;
+}
+
 }  // namespace intrinsic::icon
@@ -4,12 +4,15 @@
 #define INTRINSIC_ICON_COMMON_PART_PROPERTIES_H_
 
 #include <cstddef>
+#include <optional>
 #include <string>
 #include <variant>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "intrinsic/icon/proto/service.pb.h"
 #include "intrinsic/third_party/intops/strong_int.h"
@@ -26,18 +29,84 @@ DEFINE_STRONG_INT_TYPE(PartPropertyId, size_t);
 // after that point it should never change types!
 using PartPropertyValue = std::variant<bool, double>;
 
+// Part properties, keyed by part name and then by property name.
+using PartPropertiesByPart =
+    absl::flat_hash_map<std::string,
+                        absl::flat_hash_map<std::string, PartPropertyValue>>;
+
 struct TimestampedPartProperties {
   absl::Duration timestamp_control;
   absl::Time timestamp_wall;
-  absl::flat_hash_map<std::string,
-                      absl::flat_hash_map<std::string, PartPropertyValue>>
-      properties;
+  PartPropertiesByPart properties;
 };
 
 struct PartPropertyMap {
-  absl::flat_hash_map<std::string,
-                      absl::flat_hash_map<std::string, PartPropertyValue>>
-      properties;
+  PartPropertiesByPart properties;
+};
+
+// Returns the properties of `after` that `before` lacks or that have a
+// different value there, e.g., to only send the properties that changed with
+// Client::SetPartProperties().
+PartPropertyMap DiffPartProperties(const PartPropertiesByPart& before,
+                                   const PartPropertiesByPart& after);
+
+// The values of a fixed set of part properties, in a vector sorted by part and
+// property name and indexed by PartPropertyId.
+//
+// Looking up a property by name is a binary search that hashes nothing. Code
+// that reads the same properties repeatedly, e.g., every cycle, should resolve
+// their ids once with FindId() and then read value(id), which is a plain
+// vector access. Update() refreshes the values in place, e.g., from the result
+// of Client::GetPartProperties(), without reallocating.
+class PartPropertyTable {
+ public:
+  PartPropertyTable() = default;
+
+  // Creates a table with the properties and values of `properties`.
+  explicit PartPropertyTable(const PartPropertiesByPart& properties);
+
+  // Returns the id of the property `property_name` of part `part_name`, or
+  // nullopt if the table does not have it.
+  std::optional<PartPropertyId> FindId(absl::string_view part_name,
+                                       absl::string_view property_name) const;
+
+  // `id` must be in [0, size()).
+  const PartPropertyValue& value(PartPropertyId id) const {
+    return entries_[id.value()].value;
+  }
+  const std::string& part_name(PartPropertyId id) const {
+    return entries_[id.value()].part_name;
+  }
+  const std::string& property_name(PartPropertyId id) const {
+    return entries_[id.value()].property_name;
+  }
+
+  size_t size() const { return entries_.size(); }
+
+  // Sets the value of property `id` without changing its type.
+  //
+  // Returns OutOfRangeError if `id` is not in [0, size()), and
+  // InvalidArgumentError if `value` holds a different type than the property.
+  absl::Status Set(PartPropertyId id, const PartPropertyValue& value);
+
+  // Sets the values of all of `properties`, which may be a subset of the
+  // table.
+  //
+  // Returns NotFoundError if the table lacks one of `properties`, and
+  // InvalidArgumentError if one of them holds a different type than in the
+  // table. Values before the failing property may have been updated then.
+  absl::Status Update(const PartPropertiesByPart& properties);
+
+  PartPropertyMap ToPartPropertyMap() const;
+
+ private:
+  struct Entry {
+    std::string part_name;
+    std::string property_name;
+    PartPropertyValue value;
+  };
+
+  std::vector<Entry> entries_;
 };
 
 ::intrinsic_proto::icon::PartPropertyValue ToProto(
@@ -2,9 +2,12 @@
 
 #include "intrinsic/icon/common/slot_part_map.h"
 
+#include <algorithm>
+#include <optional>
 #include <string>
 #include <utility>
 
+#include "absl/strings/string_view.h"
 #include "intrinsic/icon/proto/types.pb.h"
 
 namespace intrinsic::icon {
@@ -28,4 +31,37 @@ intrinsic_proto::icon::SlotPartMap ToProto(const SlotPartMap& part_map) {
   return proto;
 }
 
+FlatSlotPartMap::FlatSlotPartMap(const SlotPartMap& map)
+    : entries_(map.begin(), map.end()) {}
+
+FlatSlotPartMap::FlatSlotPartMap(
+    const intrinsic_proto::icon::SlotPartMap& proto)
+    : entries_(proto.slot_name_to_part_name().begin(),
+               proto.slot_name_to_part_name().end()) {
+  // Proto maps are unordered.
+  std::sort(entries_.begin(), entries_.end());
+}
+
+std::optional<SlotIndex> FlatSlotPartMap::FindSlot(
+    absl::string_view slot_name) const {
+  auto it = std::lower_bound(
+      entries_.begin(), entries_.end(), slot_name,
+      [](const std::pair<std::string, std::string>& entry,
+         absl::string_view name) { return entry.first < name; });
+  if (it == entries_.end() || it->first != slot_name) {
+    return std::nullopt;
+  }
+  return SlotIndex(static_cast<int32_t>(it - entries_.begin()));
+}
+
+const std::string* FlatSlotPartMap::FindPart(
+    absl::string_view slot_name) const {
+  std::optional<SlotIndex> index = FindSlot(slot_name);
+  return index.has_value() ? &part_name(*index) : nullptr;
+}
+
+SlotPartMap FlatSlotPartMap::ToSlotPartMap() const {
+  return SlotPartMap(entries_.begin(), entries_.end());
+}
+
 }  // namespace intrinsic::icon
@@ -3,11 +3,17 @@
 #ifndef INTRINSIC_ICON_COMMON_SLOT_PART_MAP_H_
 #define INTRINSIC_ICON_COMMON_SLOT_PART_MAP_H_
 
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/container/btree_map.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "intrinsic/icon/proto/types.pb.h"
+#include "intrinsic/third_party/intops/strong_int.h"
 
 namespace intrinsic::icon {
 
@@ -21,6 +27,51 @@ SlotPartMap SlotPartMapFromProto(
     const intrinsic_proto::icon::SlotPartMap& proto);
 intrinsic_proto::icon::SlotPartMap ToProto(const SlotPartMap& part_map);
 
+// Index of a slot in a FlatSlotPartMap.
+DEFINE_STRONG_INT_TYPE(SlotIndex, int32_t);
+
+// An immutable SlotPartMap in a vector sorted by slot name. Actions have a
+// handful of slots, so a binary search over contiguous entries is cheaper than
+// hashing the name or walking a btree. Code that looks up the same slot
+// repeatedly can resolve it once with FindSlot() and then use its SlotIndex,
+// which involves no string comparisons at all.
+class FlatSlotPartMap {
+ public:
+  FlatSlotPartMap() = default;
+  explicit FlatSlotPartMap(const SlotPartMap& map);
+  explicit FlatSlotPartMap(const intrinsic_proto::icon::SlotPartMap& proto);
+
+  // Returns the index of `slot_name`, or nullopt if there is no such slot.
+  std::optional<SlotIndex> FindSlot(absl::string_view slot_name) const;
+
+  // Returns the part of `slot_name`, or nullptr if there is no such slot.
+  const std::string* FindPart(absl::string_view slot_name) const;
+
+  // `index` must be in [0, size()).
+  const std::string& slot_name(SlotIndex index) const {
+    return entries_[index.value()].first;
+  }
+  const std::string& part_name(SlotIndex index) const {
+    return entries_[index.value()].second;
+  }
+
+  int size() const { return static_cast<int>(entries_.size()); }
+  bool empty() const { return entries_.empty(); }
+
+  SlotPartMap ToSlotPartMap() const;
+
+  bool operator==(const FlatSlotPartMap& other) const {
+    return entries_ == other.entries_;
+  }
+  bool operator!=(const FlatSlotPartMap& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  // Sorted by slot name, which is unique.
+  std::vector<std::pair<std::string, std::string>> entries_;
+};
+
 }  // namespace intrinsic::icon
 
 #endif  // INTRINSIC_ICON_COMMON_SLOT_PART_MAP_H_
@@ -2,9 +2,49 @@
 
 #include "intrinsic/icon/control/logging_mode.h"
 
+#include <cstdint>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "intrinsic/icon/proto/logging_mode.pb.h"
+#include "intrinsic/util/proto_time.h"
+#include "intrinsic/util/status/status_macros.h"
 
 namespace intrinsic::icon {
+namespace {
+
+// The proto uses 0 for "unset", which logs every cycle like 1.
+int DecimationFromProto(uint32_t decimation) {
+  return decimation == 0 ? 1 : static_cast<int>(decimation);
+}
+
+absl::Status ValidateDecimation(absl::string_view part_name,
+                                absl::string_view signal, int decimation) {
+  if (decimation < 1) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Decimation of ", signal, " of part '", part_name,
+        "' must be positive, got ", decimation));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ValidateDuration(absl::string_view part_name,
+                              absl::string_view name,
+                              absl::Duration duration) {
+  if (duration < absl::ZeroDuration()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The ", name, " duration of part '", part_name,
+                     "' must not be negative, got ",
+                     absl::FormatDuration(duration)));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
 
 LoggingMode FromProto(const intrinsic_proto::icon::LoggingMode& proto) {
   switch (proto) {
@@ -27,4 +67,62 @@ intrinsic_proto::icon::LoggingMode ToProto(LoggingMode logging_mode) {
   }
 }
 
+LoggingPolicy FromProto(const intrinsic_proto::icon::LoggingPolicy& proto) {
+  LoggingPolicy policy;
+  for (const auto& [part_name, part_proto] : proto.part_policies()) {
+    PartLoggingPolicy& part_policy = policy.part_policies[part_name];
+    part_policy.decimation = DecimationFromProto(part_proto.decimation());
+    for (const auto& [signal, decimation] : part_proto.signal_decimation()) {
+      part_policy.signal_decimation[signal] = DecimationFromProto(decimation);
+    }
+    if (part_proto.has_triggered_logging()) {
+      const intrinsic_proto::icon::TriggeredLogging& triggered =
+          part_proto.triggered_logging();
+      part_policy.triggered_logging = TriggeredLogging{
+          .pre_trigger = intrinsic::FromProto(triggered.pre_trigger_duration()),
+          .post_trigger =
+              intrinsic::FromProto(triggered.post_trigger_duration()),
+          .on_fault = triggered.on_fault(),
+          .on_reaction = triggered.on_reaction(),
+      };
+    }
+  }
+  return policy;
+}
+
+absl::StatusOr<intrinsic_proto::icon::LoggingPolicy> ToProto(
+    const LoggingPolicy& policy) {
+  intrinsic_proto::icon::LoggingPolicy proto;
+  for (const auto& [part_name, part_policy] : policy.part_policies) {
+    intrinsic_proto::icon::PartLoggingPolicy& part_proto =
+        (*proto.mutable_part_policies())[part_name];
+    INTR_RETURN_IF_ERROR(
+        ValidateDecimation(part_name, "all signals", part_policy.decimation));
+    part_proto.set_decimation(part_policy.decimation);
+    for (const auto& [signal, decimation] : part_policy.signal_decimation) {
+      INTR_RETURN_IF_ERROR(ValidateDecimation(
+          part_name, absl::StrCat("signal '", signal, "'"), decimation));
+      (*part_proto.mutable_signal_decimation())[signal] = decimation;
+    }
+    if (part_policy.triggered_logging.has_value()) {
+      const TriggeredLogging& triggered = *part_policy.triggered_logging;
+      INTR_RETURN_IF_ERROR(
+          ValidateDuration(part_name, "pre-trigger", triggered.pre_trigger));
+      INTR_RETURN_IF_ERROR(
+          ValidateDuration(part_name, "post-trigger", triggered.post_trigger));
+      intrinsic_proto::icon::TriggeredLogging* triggered_proto =
+          part_proto.mutable_triggered_logging();
+      INTR_RETURN_IF_ERROR(intrinsic::ToProto(
+          triggered.pre_trigger,
+          triggered_proto->mutable_pre_trigger_duration()));
+      INTR_RETURN_IF_ERROR(intrinsic::ToProto(
+          triggered.post_trigger,
+          triggered_proto->mutable_post_trigger_duration()));
+      triggered_proto->set_on_fault(triggered.on_fault);
+      triggered_proto->set_on_reaction(triggered.on_reaction);
+    }
+  }
+  return proto;
+}
+
 }  // namespace intrinsic::icon
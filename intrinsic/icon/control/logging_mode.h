@@ -3,6 +3,12 @@
 #ifndef INTRINSIC_ICON_CONTROL_LOGGING_MODE_H_
 #define INTRINSIC_ICON_CONTROL_LOGGING_MODE_H_
 
+#include <optional>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
 #include "intrinsic/icon/proto/logging_mode.pb.h"
 
 namespace intrinsic::icon {
@@ -18,6 +24,45 @@ LoggingMode FromProto(const intrinsic_proto::icon::LoggingMode& proto);
 
 intrinsic_proto::icon::LoggingMode ToProto(LoggingMode mode);
 
+// Keeps the recent logs of a part in memory, and only persists them around
+// incidents.
+struct TriggeredLogging {
+  // How much of the logs before a trigger to persist, i.e. the length of the
+  // in-memory ring buffer.
+  absl::Duration pre_trigger = absl::ZeroDuration();
+  // How long to keep persisting logs after a trigger.
+  absl::Duration post_trigger = absl::ZeroDuration();
+  // Triggers when the part or the server faults.
+  bool on_fault = true;
+  // Triggers when a reaction of an action on the part fires.
+  bool on_reaction = false;
+};
+
+// How ICON logs the status of a single part.
+struct PartLoggingPolicy {
+  // Logs every `decimation`-th cycle, 1 logs every cycle.
+  int decimation = 1;
+  // Overrides `decimation` for single signals, keyed by the name of a field of
+  // intrinsic_proto::icon::PartStatus, e.g. "joint_states".
+  absl::flat_hash_map<std::string, int> signal_decimation;
+  // If set, logs are only persisted around triggers.
+  std::optional<TriggeredLogging> triggered_logging;
+};
+
+// Per-part refinement of the LoggingMode.
+struct LoggingPolicy {
+  // Keyed by part name. Parts without a policy are logged according to the
+  // LoggingMode.
+  absl::flat_hash_map<std::string, PartLoggingPolicy> part_policies;
+};
+
+LoggingPolicy FromProto(const intrinsic_proto::icon::LoggingPolicy& proto);
+
+// Returns InvalidArgumentError if a decimation is not positive or a duration
+// is negative.
+absl::StatusOr<intrinsic_proto::icon::LoggingPolicy> ToProto(
+    const LoggingPolicy& policy);
+
 }  // namespace intrinsic::icon
 
 #endif  // INTRINSIC_ICON_CONTROL_LOGGING_MODE_H_
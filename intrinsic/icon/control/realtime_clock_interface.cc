@@ -2,6 +2,13 @@
 
 #include "intrinsic/icon/control/realtime_clock_interface.h"
 
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/utils/clock.h"
+#include "intrinsic/icon/utils/duration.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/icon/utils/realtime_status_macro.h"
+
 namespace intrinsic::icon {
 
 RealtimeStatus RealtimeClockInterface::TickBlockingWithTimeout(
@@ -9,4 +16,15 @@ RealtimeStatus RealtimeClockInterface::TickBlockingWithTimeout(
   return TickBlockingWithDeadline(current_timestamp, absl::Now() + timeout);
 }
 
+RealtimeStatus RealtimeClockInterface::TickBatchBlockingWithDeadline(
+    intrinsic::Time first_timestamp, intrinsic::Duration period,
+    int num_ticks, absl::Time deadline) {
+  intrinsic::Time timestamp = first_timestamp;
+  for (int i = 0; i < num_ticks; ++i) {
+    INTRINSIC_RT_RETURN_IF_ERROR(TickBlockingWithDeadline(timestamp, deadline));
+    timestamp += period;
+  }
+  return OkStatus();
+}
+
 }  // namespace intrinsic::icon
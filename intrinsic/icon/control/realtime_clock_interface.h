@@ -5,6 +5,7 @@
 
 #include "absl/time/time.h"
 #include "intrinsic/icon/utils/clock.h"
+#include "intrinsic/icon/utils/duration.h"
 #include "intrinsic/icon/utils/realtime_status.h"
 
 namespace intrinsic::icon {
@@ -37,6 +38,18 @@ class RealtimeClockInterface {
   RealtimeStatus TickBlockingWithTimeout(intrinsic::Time current_timestamp,
                                          absl::Duration timeout);
 
+  // Steps ICON's real time update loop `num_ticks` times, with the timestamps
+  // `first_timestamp`, `first_timestamp + period`, ..., blocking the current
+  // thread until all ticks have finished or the deadline has expired. Stops at
+  // the first tick that fails and returns its error.
+  //
+  // The default implementation calls TickBlockingWithDeadline() once per tick.
+  // Implementations that hand every tick over to the control layer, e.g.
+  // through a Lockstep, can override this to run all ticks in one handoff.
+  virtual RealtimeStatus TickBatchBlockingWithDeadline(
+      intrinsic::Time first_timestamp, intrinsic::Duration period,
+      int num_ticks, absl::Time deadline);
+
   // Resets the clock in order to recover after a failure during
   // `TickBlockingWithTimeout`. Leaves the clock in a state, ready to start
   // `TickBlockingWithTimeout`.
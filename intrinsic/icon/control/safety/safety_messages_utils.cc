@@ -111,4 +111,27 @@ RequestedBehavior ExtractRequestedBehavior(
   return RequestedBehavior::UNKNOWN;
 }
 
+SafetyStatusMessageBuilder::SafetyStatusMessageBuilder() {
+  // Every field has to be present in the buffer to be mutable in place.
+  builder_.ForceDefaults(true);
+  builder_.Finish(CreateSafetyStatusMessage(builder_));
+  message_ = GetMutableSafetyStatusMessage(builder_.GetBufferPointer());
+}
+
+void SafetyStatusMessageBuilder::Set(ModeOfSafeOperation mode_of_safe_operation,
+                                     ButtonStatus estop_button_status,
+                                     ButtonStatus enable_button_status,
+                                     RequestedBehavior requested_behavior) {
+  SetSafetyStatusMessage(mode_of_safe_operation, estop_button_status,
+                         enable_button_status, requested_behavior, *message_);
+}
+
+void SafetyStatusMessageBuilder::SetFromSafetyInputs(
+    const std::bitset<8>& safety_inputs) {
+  Set(ExtractModeOfSafeOperation(safety_inputs),
+      ExtractEStopButtonStatus(safety_inputs),
+      ExtractEnableButtonStatus(safety_inputs),
+      ExtractRequestedBehavior(safety_inputs));
+}
+
 }  // namespace intrinsic::safety::messages
@@ -9,7 +9,10 @@
 #include <type_traits>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "flatbuffers/flatbuffers.h"
 #include "intrinsic/icon/control/safety/safety_messages_generated.h"
+#include "intrinsic/icon/testing/realtime_annotations.h"
 
 namespace intrinsic::safety::messages {
 
@@ -55,6 +58,44 @@ ButtonStatus ExtractEnableButtonStatus(const std::bitset<8>& safety_inputs);
 // safety::messages::SafetyStatusBit.
 RequestedBehavior ExtractRequestedBehavior(const std::bitset<8>& safety_inputs);
 
+// Holds a SafetyStatusMessage in a buffer that is allocated once, on
+// construction, and updated in place afterwards. Unlike
+// BuildSafetyStatusMessage(), publishing the safety status every cycle does
+// not allocate.
+class SafetyStatusMessageBuilder {
+ public:
+  // Not real-time safe. Allocates the buffer and builds a message with all
+  // fields UNKNOWN.
+  SafetyStatusMessageBuilder();
+
+  SafetyStatusMessageBuilder(const SafetyStatusMessageBuilder&) = delete;
+  SafetyStatusMessageBuilder& operator=(const SafetyStatusMessageBuilder&) =
+      delete;
+
+  // Real-time safe. Sets all fields of the message.
+  void Set(ModeOfSafeOperation mode_of_safe_operation,
+           ButtonStatus estop_button_status, ButtonStatus enable_button_status,
+           RequestedBehavior requested_behavior) INTRINSIC_CHECK_REALTIME_SAFE;
+
+  // Real-time safe. Sets all fields of the message from `safety_inputs`, which
+  // are expected to follow the order as in safety::messages::SafetyStatusBit.
+  void SetFromSafetyInputs(const std::bitset<8>& safety_inputs)
+      INTRINSIC_CHECK_REALTIME_SAFE;
+
+  const SafetyStatusMessage& message() const { return *message_; }
+
+  // Returns the serialized message. The span stays valid for the lifetime of
+  // the builder and reflects later calls to Set().
+  absl::Span<const uint8_t> buffer() const {
+    return absl::MakeConstSpan(builder_.GetBufferPointer(), builder_.GetSize());
+  }
+
+ private:
+  flatbuffers::FlatBufferBuilder builder_;
+  // Points into `builder_`.
+  SafetyStatusMessage* message_;
+};
+
 }  // namespace intrinsic::safety::messages
 
 #endif  // INTRINSIC_ICON_CONTROL_SAFETY_SAFETY_MESSAGES_UTILS_H_
@@ -0,0 +1,75 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/control/simulation_clock_driver.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/control/realtime_clock_interface.h"
+#include "intrinsic/icon/utils/clock.h"
+#include "intrinsic/icon/utils/duration.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/icon/utils/realtime_status_macro.h"
+
+namespace intrinsic::icon {
+
+SimulationClockDriver::SimulationClockDriver(RealtimeClockInterface& clock,
+                                             intrinsic::Time start_time,
+                                             const Options& options)
+    : clock_(clock),
+      options_(options),
+      next_tick_time_(start_time),
+      pace_start_wall_time_(absl::Now()),
+      pace_start_tick_time_(start_time) {}
+
+RealtimeStatus SimulationClockDriver::Advance(int64_t num_ticks) {
+  if (options_.period <= intrinsic::ZeroDuration()) {
+    return InvalidArgumentError("The period must be positive.");
+  }
+  if (options_.ticks_per_handshake < 1) {
+    return InvalidArgumentError("ticks_per_handshake must be at least 1.");
+  }
+  while (num_ticks > 0) {
+    const int batch_size = static_cast<int>(
+        std::min<int64_t>(num_ticks, options_.ticks_per_handshake));
+    Pace();
+    INTRINSIC_RT_RETURN_IF_ERROR(clock_.TickBatchBlockingWithDeadline(
+        next_tick_time_, options_.period, batch_size,
+        absl::Now() + options_.batch_timeout));
+    next_tick_time_ += batch_size * options_.period;
+    num_ticks_ += batch_size;
+    num_ticks -= batch_size;
+  }
+  return OkStatus();
+}
+
+RealtimeStatus SimulationClockDriver::AdvanceBy(intrinsic::Duration duration) {
+  if (options_.period <= intrinsic::ZeroDuration()) {
+    return InvalidArgumentError("The period must be positive.");
+  }
+  // Rounds up to whole periods.
+  return Advance((duration + options_.period - intrinsic::Duration(1)) /
+                 options_.period);
+}
+
+RealtimeStatus SimulationClockDriver::Reset(absl::Duration timeout) {
+  INTRINSIC_RT_RETURN_IF_ERROR(clock_.Reset(timeout));
+  pace_start_wall_time_ = absl::Now();
+  pace_start_tick_time_ = next_tick_time_;
+  return OkStatus();
+}
+
+void SimulationClockDriver::Pace() const {
+  if (options_.realtime_factor <= 0) {
+    return;
+  }
+  const double simulated_seconds =
+      intrinsic::ToDoubleSeconds(next_tick_time_ - pace_start_tick_time_);
+  absl::SleepFor(pace_start_wall_time_ +
+                 absl::Seconds(simulated_seconds / options_.realtime_factor) -
+                 absl::Now());
+}
+
+}  // namespace intrinsic::icon
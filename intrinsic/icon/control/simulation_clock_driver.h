@@ -0,0 +1,87 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_CONTROL_SIMULATION_CLOCK_DRIVER_H_
+#define INTRINSIC_ICON_CONTROL_SIMULATION_CLOCK_DRIVER_H_
+
+#include <cstdint>
+
+#include "absl/time/time.h"
+#include "intrinsic/icon/control/realtime_clock_interface.h"
+#include "intrinsic/icon/utils/clock.h"
+#include "intrinsic/icon/utils/duration.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+
+namespace intrinsic::icon {
+
+// Drives simulated time through a RealtimeClockInterface, advancing it by
+// `ticks_per_handshake` control cycles per call to
+// RealtimeClockInterface::TickBatchBlockingWithDeadline().
+//
+// Simulated time is either paced to a multiple of wall time, or advanced as
+// fast as the control layer runs, e.g. to validate long cycles offline:
+//
+//   SimulationClockDriver driver(clock, /*start_time=*/Clock::Now(),
+//                                {.period = std::chrono::milliseconds(1),
+//                                 .ticks_per_handshake = 100,
+//                                 .realtime_factor = 0});
+//   INTRINSIC_RT_RETURN_IF_ERROR(driver.AdvanceBy(std::chrono::hours(1)));
+//
+// Not thread-safe.
+class SimulationClockDriver {
+ public:
+  struct Options {
+    // Simulated time between two ticks.
+    intrinsic::Duration period = std::chrono::milliseconds(1);
+    // Number of ticks per handshake with the control layer. Larger batches
+    // save handoffs, but the driver can only pace and stop between batches.
+    int ticks_per_handshake = 1;
+    // Simulated seconds per wall second. Zero or less advances simulated time
+    // as fast as possible.
+    double realtime_factor = 1.0;
+    // Wall time a batch may take before it fails with DeadlineExceeded.
+    absl::Duration batch_timeout = absl::Seconds(1);
+  };
+
+  // `clock` must outlive the driver. The first tick has the timestamp
+  // `start_time`.
+  SimulationClockDriver(RealtimeClockInterface& clock,
+                        intrinsic::Time start_time, const Options& options);
+
+  // Advances simulated time by `num_ticks` periods, in batches of up to
+  // `ticks_per_handshake` ticks.
+  //
+  // Returns the error of the first batch that fails. Batches before it count
+  // as done, the failed one does not: after Reset(), the next call starts
+  // again at the first tick of that batch.
+  RealtimeStatus Advance(int64_t num_ticks);
+
+  // Advances simulated time by at least `duration`, i.e. by as many whole
+  // periods as needed. See Advance().
+  RealtimeStatus AdvanceBy(intrinsic::Duration duration);
+
+  // Resets the clock after a failure, see RealtimeClockInterface::Reset().
+  // Keeps the simulated time, and restarts pacing from now.
+  RealtimeStatus Reset(absl::Duration timeout);
+
+  // Timestamp of the next tick.
+  intrinsic::Time next_tick_time() const { return next_tick_time_; }
+  // Number of ticks done so far.
+  int64_t num_ticks() const { return num_ticks_; }
+
+ private:
+  // Sleeps until wall time has caught up with the simulated time of the next
+  // tick, scaled by the realtime factor.
+  void Pace() const;
+
+  RealtimeClockInterface& clock_;
+  const Options options_;
+  intrinsic::Time next_tick_time_;
+  int64_t num_ticks_ = 0;
+  // Wall and simulated time at which pacing started.
+  absl::Time pace_start_wall_time_;
+  intrinsic::Time pace_start_tick_time_;
+};
+
+}  // namespace intrinsic::icon
+
+#endif  // INTRINSIC_ICON_CONTROL_SIMULATION_CLOCK_DRIVER_H_
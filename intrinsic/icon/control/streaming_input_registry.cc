@@ -0,0 +1,100 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/control/streaming_input_registry.h"
+
+#include <any>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/any.pb.h"
+#include "google/protobuf/message.h"
+#include "intrinsic/util/proto/type_url.h"
+
+namespace intrinsic::icon {
+
+absl::StatusOr<StreamingInputTypeId> StreamingInputRegistry::Register(
+    const google::protobuf::Message& prototype, Parser parser) {
+  const std::string& type_name = prototype.GetDescriptor()->full_name();
+  const StreamingInputTypeId id(static_cast<int32_t>(entries_.size()));
+  if (!ids_.try_emplace(type_name, id).second) {
+    return absl::AlreadyExistsError(absl::StrCat(
+        "Streaming input type '", type_name, "' has a parser already"));
+  }
+  std::unique_ptr<google::protobuf::Message> copy(prototype.New());
+  copy->CopyFrom(prototype);
+  entries_.push_back(
+      {.prototype = std::move(copy), .parser = std::move(parser)});
+  return id;
+}
+
+absl::StatusOr<StreamingInputTypeId> StreamingInputRegistry::Resolve(
+    absl::string_view type_url) const {
+  auto it = ids_.find(StripTypeUrlPrefix(type_url));
+  if (it == ids_.end()) {
+    return absl::NotFoundError(absl::StrCat(
+        "No parser for streaming input type '", type_url, "'"));
+  }
+  return it->second;
+}
+
+absl::string_view StreamingInputRegistry::TypeName(
+    StreamingInputTypeId id) const {
+  const Entry* entry = FindEntry(id);
+  return entry == nullptr ? absl::string_view()
+                          : entry->prototype->GetDescriptor()->full_name();
+}
+
+absl::StatusOr<std::any> StreamingInputRegistry::Parse(
+    StreamingInputTypeId id, const google::protobuf::Any& input) const {
+  const Entry* entry = FindEntry(id);
+  if (entry == nullptr) {
+    return absl::NotFoundError(
+        absl::StrCat("Unknown streaming input type id ", id.value()));
+  }
+  std::unique_ptr<google::protobuf::Message> message(entry->prototype->New());
+  if (!input.UnpackTo(message.get())) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Streaming input of type '", input.type_url(),
+                     "' is not a ", message->GetDescriptor()->full_name()));
+  }
+  return entry->parser(*message);
+}
+
+absl::StatusOr<StreamingInputReader> StreamingInputRegistry::CreateReader(
+    StreamingInputTypeId id) const {
+  const Entry* entry = FindEntry(id);
+  if (entry == nullptr) {
+    return absl::NotFoundError(
+        absl::StrCat("Unknown streaming input type id ", id.value()));
+  }
+  return StreamingInputReader(
+      *this, id,
+      std::unique_ptr<google::protobuf::Message>(entry->prototype->New()));
+}
+
+const StreamingInputRegistry::Entry* StreamingInputRegistry::FindEntry(
+    StreamingInputTypeId id) const {
+  if (id.value() < 0 || id.value() >= size()) {
+    return nullptr;
+  }
+  return &entries_[id.value()];
+}
+
+absl::StatusOr<std::any> StreamingInputReader::Parse(
+    const google::protobuf::Any& input) {
+  // ParseFromString() clears the message first, which keeps the memory of its
+  // repeated and string fields for the next message.
+  if (!message_->ParseFromString(input.value())) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Cannot parse streaming input of type '", input.type_url(), "' as ",
+        message_->GetDescriptor()->full_name()));
+  }
+  return registry_->entries_[type_id_.value()].parser(*message_);
+}
+
+}  // namespace intrinsic::icon
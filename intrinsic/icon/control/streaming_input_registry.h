@@ -0,0 +1,154 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_CONTROL_STREAMING_INPUT_REGISTRY_H_
+#define INTRINSIC_ICON_CONTROL_STREAMING_INPUT_REGISTRY_H_
+
+#include <any>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/any.pb.h"
+#include "google/protobuf/message.h"
+#include "intrinsic/third_party/intops/strong_int.h"
+
+namespace intrinsic::icon {
+
+// Dense index of a message type in a StreamingInputRegistry.
+DEFINE_STRONG_INT_TYPE(StreamingInputTypeId, int32_t);
+
+class StreamingInputReader;
+
+// Parsers of streaming inputs, indexed by message type.
+//
+// A GenericStreamingInputParser matches the type URL of every message it
+// parses and unpacks it into a new message. A stream only ever carries one
+// type, though, so this registry resolves the type URL once, when the stream
+// is opened, and hands out a StreamingInputReader that parses every message of
+// the stream into the same message instance:
+//
+//   StreamingInputRegistry registry;
+//   INTR_RETURN_IF_ERROR(registry.Register<MyInputProto>(
+//       [](const MyInputProto& input) -> absl::StatusOr<std::any> {
+//         return MyRealtimeInput(input);
+//       }).status());
+//   ...
+//   // When the stream is opened.
+//   INTR_ASSIGN_OR_RETURN(StreamingInputTypeId id,
+//                         registry.Resolve(stream_type_url));
+//   INTR_ASSIGN_OR_RETURN(StreamingInputReader reader,
+//                         registry.CreateReader(id));
+//   // For every write.
+//   INTR_ASSIGN_OR_RETURN(std::any value, reader.Parse(any));
+//
+// Registering is not thread safe. Once all parsers are registered, the
+// registry can be used from any thread.
+class StreamingInputRegistry {
+ public:
+  using Parser = std::function<absl::StatusOr<std::any>(
+      const google::protobuf::Message& input)>;
+
+  // Registers `parser` for messages of the type of `prototype`, which is
+  // copied.
+  //
+  // Returns AlreadyExistsError if the type has a parser already.
+  absl::StatusOr<StreamingInputTypeId> Register(
+      const google::protobuf::Message& prototype, Parser parser);
+
+  // Same as above, for a parser of a concrete message type.
+  template <typename ProtoT>
+  absl::StatusOr<StreamingInputTypeId> Register(
+      std::function<absl::StatusOr<std::any>(const ProtoT& input)> parser) {
+    return Register(ProtoT::default_instance(),
+                    [parser = std::move(parser)](
+                        const google::protobuf::Message& input) {
+                      return parser(static_cast<const ProtoT&>(input));
+                    });
+  }
+
+  // Returns the id of the type with `type_url`, which may or may not have the
+  // type.googleapis.com/ prefix.
+  //
+  // Returns NotFoundError if the type has no parser.
+  absl::StatusOr<StreamingInputTypeId> Resolve(
+      absl::string_view type_url) const;
+
+  // Returns the full name of the message type with `id`, or an empty string
+  // if `id` is unknown.
+  absl::string_view TypeName(StreamingInputTypeId id) const;
+
+  // Returns the number of registered types. Ids are 0 to size() - 1.
+  int size() const { return static_cast<int>(entries_.size()); }
+
+  // Parses `input` with the parser of type `id`. Unlike
+  // StreamingInputReader::Parse(), this allocates a message for every call
+  // and checks the type URL of `input`, but is thread safe.
+  //
+  // Returns NotFoundError if `id` is unknown, InvalidArgumentError if `input`
+  // is not of type `id`, and the error of the parser otherwise.
+  absl::StatusOr<std::any> Parse(StreamingInputTypeId id,
+                                 const google::protobuf::Any& input) const;
+
+  // Creates a reader for a stream of messages of type `id`. The registry must
+  // outlive the reader.
+  //
+  // Returns NotFoundError if `id` is unknown.
+  absl::StatusOr<StreamingInputReader> CreateReader(
+      StreamingInputTypeId id) const;
+
+ private:
+  friend class StreamingInputReader;
+
+  struct Entry {
+    std::unique_ptr<google::protobuf::Message> prototype;
+    Parser parser;
+  };
+
+  const Entry* FindEntry(StreamingInputTypeId id) const;
+
+  // Indexed by StreamingInputTypeId.
+  std::vector<Entry> entries_;
+  // Keyed by full message name, without the type URL prefix.
+  absl::flat_hash_map<std::string, StreamingInputTypeId> ids_;
+};
+
+// Parses the messages of one stream, whose type was resolved when the stream
+// was opened. Every message is parsed into the same message instance, so
+// parsing allocates only when a message is larger than all before it. Not
+// thread safe; use one reader per stream.
+class StreamingInputReader {
+ public:
+  StreamingInputTypeId type_id() const { return type_id_; }
+
+  // Parses `input` and converts it with the parser of the stream's type. Does
+  // not match the type URL of `input` against the type of the stream; use
+  // StreamingInputRegistry::Resolve() on it if the stream may change types.
+  //
+  // Returns InvalidArgumentError if `input` cannot be parsed as the type of
+  // the stream, and the error of the parser otherwise.
+  absl::StatusOr<std::any> Parse(const google::protobuf::Any& input);
+
+ private:
+  friend class StreamingInputRegistry;
+
+  StreamingInputReader(const StreamingInputRegistry& registry,
+                       StreamingInputTypeId type_id,
+                       std::unique_ptr<google::protobuf::Message> message)
+      : registry_(&registry),
+        type_id_(type_id),
+        message_(std::move(message)) {}
+
+  const StreamingInputRegistry* registry_;
+  StreamingInputTypeId type_id_;
+  std::unique_ptr<google::protobuf::Message> message_;
+};
+
+}  // namespace intrinsic::icon
+
+#endif  // INTRINSIC_ICON_CONTROL_STREAMING_INPUT_REGISTRY_H_
@@ -23,6 +23,12 @@ DEFINE_STRONG_INT_TYPE(StreamingInputId, int64_t);
 // converters. Users do not interact with these definitions directly, but rather
 // use wrappers that automatically convert from concrete proto message types to
 // google::protobuf::Any and from realtime types to absl::any (and vice versa).
+// StreamingInputRegistry in streaming_input_registry.h resolves the type of a
+// stream once instead of matching type URLs for every message.
+//
+// To exchange commands and states with other processes in real time, without
+// parsing protos, see the FlatBuffer mirrors in
+// intrinsic/icon/flatbuffers/control_types.h.
 using GenericStreamingInputParser = std::function<absl::StatusOr<std::any>(
     const google::protobuf::Any &streaming_input)>;
 using GenericStreamingOutputConverter =
@@ -2,11 +2,18 @@
 
 #include "intrinsic/icon/equipment/channel_factory.h"
 
+#include <cstddef>
 #include <memory>
 #include <utility>
 
+#include "absl/container/node_hash_map.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "grpcpp/channel.h"
 #include "intrinsic/util/grpc/channel.h"
 #include "intrinsic/util/grpc/channel_interface.h"
 #include "intrinsic/util/grpc/connection_params.h"
@@ -26,5 +33,84 @@ DefaultChannelFactory::MakeChannel(const ConnectionParams& params,
   return Channel::Make(params, timeout);
 }
 
+namespace {
+
+// Returns whether `channel` can still be used. Asks an idle channel to
+// reconnect in the background.
+bool IsUsable(const ChannelInterface& channel) {
+  std::shared_ptr<grpc::Channel> grpc_channel = channel.GetChannel();
+  if (grpc_channel == nullptr) {
+    return false;
+  }
+  const grpc_connectivity_state state =
+      grpc_channel->GetState(/*try_to_connect=*/true);
+  return state != GRPC_CHANNEL_TRANSIENT_FAILURE &&
+         state != GRPC_CHANNEL_SHUTDOWN;
+}
+
+}  // namespace
+
+CachingChannelFactory::CachingChannelFactory(
+    std::unique_ptr<ChannelFactory> factory)
+    : factory_(std::move(factory)) {}
+
+const CachingChannelFactory& CachingChannelFactory::Global() {
+  static const auto* factory = new CachingChannelFactory();
+  return *factory;
+}
+
+absl::StatusOr<std::shared_ptr<ChannelInterface>>
+CachingChannelFactory::MakeChannel(const ConnectionParams& params,
+                                   absl::Duration timeout) const {
+  const absl::Time deadline = absl::Now() + timeout;
+  mutex_.Lock();
+  Entry& entry = entries_[params];
+  if (!mutex_.AwaitWithDeadline(
+          absl::Condition(
+              +[](Entry* entry) { return !entry->connecting; }, &entry),
+          deadline)) {
+    mutex_.Unlock();
+    return absl::DeadlineExceededError(
+        absl::StrCat("Timed out waiting for a connection to ", params.address,
+                     " by another caller."));
+  }
+  if (entry.channel != nullptr && IsUsable(*entry.channel)) {
+    std::shared_ptr<ChannelInterface> channel = entry.channel;
+    mutex_.Unlock();
+    return channel;
+  }
+  entry.connecting = true;
+  mutex_.Unlock();
+
+  absl::StatusOr<std::shared_ptr<ChannelInterface>> channel =
+      factory_->MakeChannel(params, deadline - absl::Now());
+
+  absl::MutexLock lock(&mutex_);
+  entry.connecting = false;
+  if (channel.ok()) {
+    entry.channel = *channel;
+  }
+  return channel;
+}
+
+void CachingChannelFactory::Clear() {
+  absl::MutexLock lock(&mutex_);
+  // Keeps entries that are connecting, which their callers still reference.
+  absl::erase_if(entries_, [](const auto& entry) {
+    return !entry.second.connecting;
+  });
+}
+
+size_t CachingChannelFactory::size() const {
+  absl::MutexLock lock(&mutex_);
+  size_t size = 0;
+  for (const auto& [params, entry] : entries_) {
+    if (entry.channel != nullptr) {
+      ++size;
+    }
+  }
+  return size;
+}
+
 }  // namespace icon
 }  // namespace intrinsic
@@ -3,9 +3,13 @@
 #ifndef INTRINSIC_ICON_EQUIPMENT_CHANNEL_FACTORY_H_
 #define INTRINSIC_ICON_EQUIPMENT_CHANNEL_FACTORY_H_
 
+#include <cstddef>
 #include <memory>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "intrinsic/util/grpc/channel_interface.h"
 #include "intrinsic/util/grpc/connection_params.h"
@@ -44,6 +48,55 @@ class DefaultChannelFactory : public ChannelFactory {
       const ConnectionParams& params, absl::Duration timeout) const override;
 };
 
+// CachingChannelFactory shares one channel per ConnectionParams among all of
+// its callers, e.g., the equipment handles of all skill executions, instead of
+// connecting and health checking a new channel every time.
+//
+// A cached channel is handed out as long as it is not failed or shut down.
+// Handing it out asks an idle channel to reconnect, which gRPC does in the
+// background, so that the channel is usually connected again when it is used.
+// A failed channel is replaced by a new one on the next call. Concurrent calls
+// for the same parameters wait for a single connection attempt.
+//
+// Thread safe.
+class CachingChannelFactory : public ChannelFactory {
+ public:
+  // Caches the channels created by `factory`.
+  explicit CachingChannelFactory(
+      std::unique_ptr<ChannelFactory> factory =
+          std::make_unique<DefaultChannelFactory>());
+
+  // Returns a process-wide instance that caches channels created by a
+  // DefaultChannelFactory.
+  static const CachingChannelFactory& Global();
+
+  using ChannelFactory::MakeChannel;
+
+  // Returns the cached channel for `params`, or creates one, waiting up to
+  // `timeout` for it to connect.
+  absl::StatusOr<std::shared_ptr<ChannelInterface>> MakeChannel(
+      const ConnectionParams& params, absl::Duration timeout) const override;
+
+  // Drops all cached channels. Channels handed out stay valid.
+  void Clear();
+
+  // Returns the number of cached channels.
+  size_t size() const;
+
+ private:
+  struct Entry {
+    std::shared_ptr<ChannelInterface> channel;
+    // Whether a call is creating a channel for the entry.
+    bool connecting = false;
+  };
+
+  const std::unique_ptr<ChannelFactory> factory_;
+  mutable absl::Mutex mutex_;
+  // Node-based, since entries are referenced while the mutex is released.
+  mutable absl::node_hash_map<ConnectionParams, Entry> entries_
+      ABSL_GUARDED_BY(mutex_);
+};
+
 }  // namespace icon
 }  // namespace intrinsic
 
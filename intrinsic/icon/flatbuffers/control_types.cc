@@ -0,0 +1,221 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+
+#include "intrinsic/icon/flatbuffers/control_types.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "flatbuffers/detached_buffer.h"
+#include "flatbuffers/flatbuffer_builder.h"
+#include "flatbuffers/vector.h"
+#include "intrinsic/eigenmath/types.h"
+#include "intrinsic/icon/control/joint_position_command.h"
+#include "intrinsic/icon/control/realtime_signal_types.h"
+#include "intrinsic/icon/flatbuffers/control_types_generated.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/icon/utils/realtime_status_macro.h"
+#include "intrinsic/icon/utils/realtime_status_or.h"
+#include "intrinsic/kinematics/types/dynamic_limits_check_mode.h"
+#include "intrinsic/kinematics/types/joint_state.h"
+
+namespace intrinsic_fbs {
+
+namespace {
+
+using ::intrinsic::eigenmath::VectorNd;
+using ::intrinsic::icon::InvalidArgumentError;
+using ::intrinsic::icon::RealtimeStatus;
+
+constexpr size_t kMaxVectorSize = VectorNd::MaxSizeAtCompileTime;
+
+// Returns the size of `values`, which is 0 if the vector is absent.
+size_t SizeOf(const flatbuffers::Vector<double>* values) {
+  return values == nullptr ? 0 : values->size();
+}
+
+// Returns InvalidArgumentError unless the buffer vector `output` exists and has
+// `size` values.
+RealtimeStatus CheckOutputSize(const flatbuffers::Vector<double>* output,
+                               size_t size, const char* name) {
+  if (output == nullptr) {
+    return InvalidArgumentError(RealtimeStatus::StrCat(
+        "Buffer has no ", name, "; use a buffer from Create*Buffer()"));
+  }
+  if (output->size() != size) {
+    return InvalidArgumentError(RealtimeStatus::StrCat(
+        "Buffer has ", output->size(), " ", name, " values, but got ", size));
+  }
+  return intrinsic::icon::OkStatus();
+}
+
+void CopyToVector(const VectorNd& values, flatbuffers::Vector<double>& output) {
+  std::copy(values.data(), values.data() + values.size(), output.data());
+}
+
+// Copies `values` into a VectorNd. An absent vector is empty.
+intrinsic::icon::RealtimeStatusOr<VectorNd> FromVector(
+    const flatbuffers::Vector<double>* values, const char* name) {
+  if (SizeOf(values) > kMaxVectorSize) {
+    return InvalidArgumentError(RealtimeStatus::StrCat(
+        name, " has ", values->size(), " values, but at most ", kMaxVectorSize,
+        " are supported"));
+  }
+  if (values == nullptr) {
+    return VectorNd(0);
+  }
+  return VectorNd(AsEigen(*values));
+}
+
+}  // namespace
+
+ConstVectorMap AsEigen(const flatbuffers::Vector<double>& values) {
+  return ConstVectorMap(values.data(), values.size());
+}
+
+DynamicLimitsCheckMode ToFbs(intrinsic::DynamicLimitsCheckMode mode) {
+  switch (mode) {
+    case intrinsic::DynamicLimitsCheckMode::kCheckJointAcceleration:
+      return DynamicLimitsCheckMode::CHECK_JOINT_ACCELERATION;
+    case intrinsic::DynamicLimitsCheckMode::kCheckNone:
+      return DynamicLimitsCheckMode::CHECK_NONE;
+  }
+  return DynamicLimitsCheckMode::CHECK_JOINT_ACCELERATION;
+}
+
+intrinsic::DynamicLimitsCheckMode FromFbs(DynamicLimitsCheckMode mode) {
+  switch (mode) {
+    case DynamicLimitsCheckMode::CHECK_JOINT_ACCELERATION:
+      return intrinsic::DynamicLimitsCheckMode::kCheckJointAcceleration;
+    case DynamicLimitsCheckMode::CHECK_NONE:
+      return intrinsic::DynamicLimitsCheckMode::kCheckNone;
+  }
+  // Like FromProto() for an unspecified mode.
+  return intrinsic::DynamicLimitsCheckMode::kCheckJointAcceleration;
+}
+
+SignalValue ToFbs(const intrinsic::icon::SignalValue& value) {
+  return SignalValue(value.current_value, value.previous_value);
+}
+
+intrinsic::icon::SignalValue FromFbs(const SignalValue& value) {
+  return {.current_value = value.current_value(),
+          .previous_value = value.previous_value()};
+}
+
+flatbuffers::DetachedBuffer CreateJointPositionCommandBuffer(
+    size_t num_joints) {
+  std::vector<double> zeros(num_joints, 0);
+  flatbuffers::FlatBufferBuilder builder;
+  // Writes the flags and the mode even if they have their default values, so
+  // that they can be mutated in place.
+  builder.ForceDefaults(true);
+  builder.Finish(CreateJointPositionCommandDirect(
+      builder, &zeros, &zeros, &zeros, /*has_velocity_feedforward=*/false,
+      /*has_acceleration_feedforward=*/false,
+      ToFbs(intrinsic::icon::JointPositionCommand::
+                DefaultDynamicLimitsCheckMode())));
+  return builder.Release();
+}
+
+RealtimeStatus CopyToJointPositionCommand(
+    const intrinsic::icon::JointPositionCommand& command,
+    JointPositionCommand& fbs_command) {
+  const size_t size = command.Size();
+  INTRINSIC_RT_RETURN_IF_ERROR(
+      CheckOutputSize(fbs_command.position(), size, "position"));
+  INTRINSIC_RT_RETURN_IF_ERROR(CheckOutputSize(
+      fbs_command.velocity_feedforward(), size, "velocity feedforward"));
+  INTRINSIC_RT_RETURN_IF_ERROR(
+      CheckOutputSize(fbs_command.acceleration_feedforward(), size,
+                      "acceleration feedforward"));
+  if (!fbs_command.mutate_has_velocity_feedforward(
+          command.velocity_feedforward().has_value()) ||
+      !fbs_command.mutate_has_acceleration_feedforward(
+          command.acceleration_feedforward().has_value()) ||
+      !fbs_command.mutate_joint_dynamic_limits_check_mode(
+          ToFbs(command.joint_dynamic_limits_check_mode()))) {
+    return InvalidArgumentError(
+        "Buffer lacks scalar fields; use CreateJointPositionCommandBuffer()");
+  }
+  CopyToVector(command.position(), *fbs_command.mutable_position());
+  if (command.velocity_feedforward().has_value()) {
+    CopyToVector(*command.velocity_feedforward(),
+                 *fbs_command.mutable_velocity_feedforward());
+  }
+  if (command.acceleration_feedforward().has_value()) {
+    CopyToVector(*command.acceleration_feedforward(),
+                 *fbs_command.mutable_acceleration_feedforward());
+  }
+  return intrinsic::icon::OkStatus();
+}
+
+intrinsic::icon::RealtimeStatusOr<intrinsic::icon::JointPositionCommand>
+FromFbs(const JointPositionCommand& command) {
+  INTRINSIC_RT_ASSIGN_OR_RETURN(VectorNd position,
+                                FromVector(command.position(), "Position"));
+  std::optional<VectorNd> velocity_feedforward;
+  if (command.has_velocity_feedforward()) {
+    INTRINSIC_RT_ASSIGN_OR_RETURN(
+        velocity_feedforward,
+        FromVector(command.velocity_feedforward(), "Velocity feedforward"));
+  }
+  std::optional<VectorNd> acceleration_feedforward;
+  if (command.has_acceleration_feedforward()) {
+    INTRINSIC_RT_ASSIGN_OR_RETURN(
+        acceleration_feedforward,
+        FromVector(command.acceleration_feedforward(),
+                   "Acceleration feedforward"));
+  }
+  return intrinsic::icon::JointPositionCommand::Create(
+      position, velocity_feedforward, acceleration_feedforward,
+      FromFbs(command.joint_dynamic_limits_check_mode()));
+}
+
+flatbuffers::DetachedBuffer CreateJointStateBuffer(size_t num_joints) {
+  std::vector<double> zeros(num_joints, 0);
+  flatbuffers::FlatBufferBuilder builder;
+  builder.Finish(CreateJointStateDirect(builder, &zeros, &zeros, &zeros));
+  return builder.Release();
+}
+
+RealtimeStatus CopyToJointState(const intrinsic::JointStatePVA& state,
+                                JointState& fbs_state) {
+  if (!state.IsSizeConsistent()) {
+    return InvalidArgumentError("Joint state is not size consistent");
+  }
+  const size_t size = state.size();
+  INTRINSIC_RT_RETURN_IF_ERROR(
+      CheckOutputSize(fbs_state.position(), size, "position"));
+  INTRINSIC_RT_RETURN_IF_ERROR(
+      CheckOutputSize(fbs_state.velocity(), size, "velocity"));
+  INTRINSIC_RT_RETURN_IF_ERROR(
+      CheckOutputSize(fbs_state.acceleration(), size, "acceleration"));
+  CopyToVector(state.position, *fbs_state.mutable_position());
+  CopyToVector(state.velocity, *fbs_state.mutable_velocity());
+  CopyToVector(state.acceleration, *fbs_state.mutable_acceleration());
+  return intrinsic::icon::OkStatus();
+}
+
+intrinsic::icon::RealtimeStatusOr<intrinsic::JointStatePVA> FromFbs(
+    const JointState& state) {
+  const size_t size = SizeOf(state.position());
+  if (SizeOf(state.velocity()) != size ||
+      SizeOf(state.acceleration()) != size) {
+    return InvalidArgumentError(RealtimeStatus::StrCat(
+        "Joint state has ", size, " positions, ", SizeOf(state.velocity()),
+        " velocities and ", SizeOf(state.acceleration()), " accelerations"));
+  }
+  intrinsic::JointStatePVA result;
+  INTRINSIC_RT_ASSIGN_OR_RETURN(result.position,
+                                FromVector(state.position(), "Position"));
+  INTRINSIC_RT_ASSIGN_OR_RETURN(result.velocity,
+                                FromVector(state.velocity(), "Velocity"));
+  INTRINSIC_RT_ASSIGN_OR_RETURN(
+      result.acceleration, FromVector(state.acceleration(), "Acceleration"));
+  return result;
+}
+
+}  // namespace intrinsic_fbs
@@ -0,0 +1,78 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+
+#ifndef INTRINSIC_ICON_FLATBUFFERS_CONTROL_TYPES_H_
+#define INTRINSIC_ICON_FLATBUFFERS_CONTROL_TYPES_H_
+
+#include <cstddef>
+
+#include "Eigen/Core"
+#include "flatbuffers/detached_buffer.h"
+#include "flatbuffers/vector.h"
+#include "intrinsic/eigenmath/types.h"
+#include "intrinsic/icon/control/joint_position_command.h"
+#include "intrinsic/icon/control/realtime_signal_types.h"
+#include "intrinsic/icon/flatbuffers/control_types_generated.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/icon/utils/realtime_status_or.h"
+#include "intrinsic/kinematics/types/dynamic_limits_check_mode.h"
+#include "intrinsic/kinematics/types/joint_state.h"
+
+// FlatBuffer mirrors of the types that real-time code exchanges with other
+// processes, e.g., through shared memory. Unlike the streaming I/O protos,
+// reading them involves no parsing, and updating a preallocated buffer does
+// not allocate.
+//
+// The Create*Buffer() functions allocate and are not real-time safe. All other
+// functions are real-time safe.
+
+namespace intrinsic_fbs {
+
+// Views a vector of a buffer as an Eigen vector, without copying. The buffer
+// must outlive the view.
+using ConstVectorMap = Eigen::Map<const intrinsic::eigenmath::VectorXd>;
+ConstVectorMap AsEigen(const flatbuffers::Vector<double>& values);
+
+DynamicLimitsCheckMode ToFbs(intrinsic::DynamicLimitsCheckMode mode);
+intrinsic::DynamicLimitsCheckMode FromFbs(DynamicLimitsCheckMode mode);
+
+SignalValue ToFbs(const intrinsic::icon::SignalValue& value);
+intrinsic::icon::SignalValue FromFbs(const SignalValue& value);
+
+// Creates a buffer that holds a JointPositionCommand for `num_joints` joints,
+// with zero positions and no feedforward.
+flatbuffers::DetachedBuffer CreateJointPositionCommandBuffer(size_t num_joints);
+
+// Copies `command` into a JointPositionCommand from
+// CreateJointPositionCommandBuffer().
+//
+// Returns InvalidArgumentError if `command` has a different number of joints;
+// `fbs_command` is unchanged then.
+intrinsic::icon::RealtimeStatus CopyToJointPositionCommand(
+    const intrinsic::icon::JointPositionCommand& command,
+    JointPositionCommand& fbs_command);
+
+// Returns InvalidArgumentError if the vectors of `command` have different
+// sizes, or more values than an eigenmath::VectorNd holds.
+intrinsic::icon::RealtimeStatusOr<intrinsic::icon::JointPositionCommand>
+FromFbs(const JointPositionCommand& command);
+
+// Creates a buffer that holds a JointState for `num_joints` joints, with all
+// values zero.
+flatbuffers::DetachedBuffer CreateJointStateBuffer(size_t num_joints);
+
+// Copies `state` into a JointState from CreateJointStateBuffer().
+//
+// Returns InvalidArgumentError if `state` is not size consistent or has a
+// different number of joints; `fbs_state` is unchanged then.
+intrinsic::icon::RealtimeStatus CopyToJointState(
+    const intrinsic::JointStatePVA& state, JointState& fbs_state);
+
+// Returns InvalidArgumentError if the vectors of `state` have different sizes,
+// or more values than an eigenmath::VectorNd holds.
+intrinsic::icon::RealtimeStatusOr<intrinsic::JointStatePVA> FromFbs(
+    const JointState& state);
+
+}  // namespace intrinsic_fbs
+
+#endif  // INTRINSIC_ICON_FLATBUFFERS_CONTROL_TYPES_H_
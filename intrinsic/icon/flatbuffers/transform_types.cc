@@ -12,6 +12,7 @@
 #include "flatbuffers/flatbuffer_builder.h"
 #include "intrinsic/eigenmath/types.h"
 #include "intrinsic/icon/flatbuffers/transform_types_generated.h"
+#include "intrinsic/math/pose3.h"
 
 namespace intrinsic_fbs {
 
@@ -53,4 +54,31 @@ flatbuffers::DetachedBuffer CreateWrenchBuffer() {
   return builder.Release();
 }
 
+PointF ToFbs(const intrinsic::eigenmath::Vector3f& point) {
+  return PointF(point.x(), point.y(), point.z());
+}
+
+RotationF ToFbs(const intrinsic::eigenmath::Quaternionf& rotation) {
+  return RotationF(rotation.x(), rotation.y(), rotation.z(), rotation.w());
+}
+
+TransformF ToFbs(const intrinsic::Pose3f& transform) {
+  return TransformF(ToFbs(transform.translation()),
+                    ToFbs(transform.quaternion()));
+}
+
+intrinsic::eigenmath::Vector3f FromFbs(const PointF& point) {
+  return {point.x(), point.y(), point.z()};
+}
+
+intrinsic::eigenmath::Quaternionf FromFbs(const RotationF& rotation) {
+  // Eigen's Quaternion ctor takes parameters in the order {w, x, y, z}.
+  return {rotation.qw(), rotation.qx(), rotation.qy(), rotation.qz()};
+}
+
+intrinsic::Pose3f FromFbs(const TransformF& transform) {
+  return intrinsic::Pose3f(FromFbs(transform.rotation()),
+                           FromFbs(transform.position()));
+}
+
 }  // namespace intrinsic_fbs
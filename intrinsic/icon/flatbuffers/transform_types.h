@@ -8,8 +8,13 @@
 #include <vector>
 
 #include "Eigen/Dense"
+#include "absl/types/span.h"
+#include "flatbuffers/base.h"
 #include "flatbuffers/detached_buffer.h"
+#include "flatbuffers/vector.h"
+#include "intrinsic/eigenmath/types.h"
 #include "intrinsic/icon/flatbuffers/transform_types_generated.h"
+#include "intrinsic/math/pose3.h"
 
 namespace intrinsic_fbs {
 
@@ -34,6 +39,164 @@ VectorNd* CopyToVectorNdBuffer(const std::vector<double>& data, void* buffer,
 // intrinsic_fbs::Wrench.
 flatbuffers::DetachedBuffer CreateWrenchBuffer();
 
+// Converts between the single precision structs and their Eigen types.
+PointF ToFbs(const intrinsic::eigenmath::Vector3f& point);
+RotationF ToFbs(const intrinsic::eigenmath::Quaternionf& rotation);
+TransformF ToFbs(const intrinsic::Pose3f& transform);
+intrinsic::eigenmath::Vector3f FromFbs(const PointF& point);
+// Does not normalize the quaternion.
+intrinsic::eigenmath::Quaternionf FromFbs(const RotationF& rotation);
+// Normalizes the rotation of the transform.
+intrinsic::Pose3f FromFbs(const TransformF& transform);
+
+// Views of the double precision structs as Eigen types, without copying, so
+// that real-time code reads and writes them in place, e.g., in shared memory.
+// The structs are plain doubles in the order of the Eigen coefficients, and
+// FlatBuffers stores them in the byte order of the (little-endian) host. The
+// struct must outlive the view.
+static_assert(FLATBUFFERS_LITTLEENDIAN,
+              "Views of FlatBuffer structs require a little-endian host");
+static_assert(sizeof(Point) == 3 * sizeof(double));
+static_assert(sizeof(Rotation) == 4 * sizeof(double));
+static_assert(sizeof(Twist) == 6 * sizeof(double));
+static_assert(sizeof(Acceleration) == 6 * sizeof(double));
+static_assert(sizeof(Jerk) == 6 * sizeof(double));
+static_assert(sizeof(Wrench) == 6 * sizeof(double));
+static_assert(sizeof(Transform) == sizeof(Point) + sizeof(Rotation));
+
+using Vector3dMap = Eigen::Map<intrinsic::eigenmath::Vector3d>;
+using ConstVector3dMap = Eigen::Map<const intrinsic::eigenmath::Vector3d>;
+// Eigen maps quaternions only through its default-aligned type; the map
+// itself does not require alignment.
+using QuaterniondMap = Eigen::Map<Eigen::Quaterniond>;
+using ConstQuaterniondMap = Eigen::Map<const Eigen::Quaterniond>;
+using Vector6dMap = Eigen::Map<intrinsic::eigenmath::Vector6d>;
+using ConstVector6dMap = Eigen::Map<const intrinsic::eigenmath::Vector6d>;
+
+inline ConstVector3dMap ViewAsVector3d(const Point& point) {
+  return ConstVector3dMap(reinterpret_cast<const double*>(&point));
+}
+inline Vector3dMap ViewAsVector3d(Point& point) {
+  return Vector3dMap(reinterpret_cast<double*>(&point));
+}
+
+// Does not normalize the quaternion.
+inline ConstQuaterniondMap ViewAsQuaterniond(const Rotation& rotation) {
+  return ConstQuaterniondMap(reinterpret_cast<const double*>(&rotation));
+}
+inline QuaterniondMap ViewAsQuaterniond(Rotation& rotation) {
+  return QuaterniondMap(reinterpret_cast<double*>(&rotation));
+}
+
+inline ConstVector6dMap ViewAsVector6d(const Twist& twist) {
+  return ConstVector6dMap(reinterpret_cast<const double*>(&twist));
+}
+inline Vector6dMap ViewAsVector6d(Twist& twist) {
+  return Vector6dMap(reinterpret_cast<double*>(&twist));
+}
+inline ConstVector6dMap ViewAsVector6d(const Acceleration& acceleration) {
+  return ConstVector6dMap(reinterpret_cast<const double*>(&acceleration));
+}
+inline Vector6dMap ViewAsVector6d(Acceleration& acceleration) {
+  return Vector6dMap(reinterpret_cast<double*>(&acceleration));
+}
+inline ConstVector6dMap ViewAsVector6d(const Jerk& jerk) {
+  return ConstVector6dMap(reinterpret_cast<const double*>(&jerk));
+}
+inline Vector6dMap ViewAsVector6d(Jerk& jerk) {
+  return Vector6dMap(reinterpret_cast<double*>(&jerk));
+}
+inline ConstVector6dMap ViewAsVector6d(const Wrench& wrench) {
+  return ConstVector6dMap(reinterpret_cast<const double*>(&wrench));
+}
+inline Vector6dMap ViewAsVector6d(Wrench& wrench) {
+  return Vector6dMap(reinterpret_cast<double*>(&wrench));
+}
+
+// A Transform viewed with the accessors of a Pose3d. A Pose3d itself cannot
+// view the struct, since it keeps its rotation first.
+class ConstPose3dView {
+ public:
+  explicit ConstPose3dView(const Transform& transform)
+      : transform_(&transform) {}
+
+  ConstVector3dMap translation() const {
+    return ViewAsVector3d(transform_->position());
+  }
+  // Does not normalize the quaternion.
+  ConstQuaterniondMap quaternion() const {
+    return ViewAsQuaterniond(transform_->rotation());
+  }
+
+  // Copies the transform and normalizes its rotation.
+  intrinsic::Pose3d ToPose3d() const {
+    return intrinsic::Pose3d(intrinsic::eigenmath::Quaterniond(quaternion()),
+                             intrinsic::eigenmath::Vector3d(translation()));
+  }
+
+ private:
+  const Transform* transform_;
+};
+
+inline ConstPose3dView ViewAsPose3d(const Transform& transform) {
+  return ConstPose3dView(transform);
+}
+
+// Returns the structs of a FlatBuffer vector of structs, e.g., the
+// [Point] field of a table, as a span. FlatBuffers stores them contiguously.
+template <typename T>
+absl::Span<const T> AsSpan(const flatbuffers::Vector<const T*>& structs) {
+  return absl::MakeConstSpan(reinterpret_cast<const T*>(structs.Data()),
+                             structs.size());
+}
+
+// Views of spans of structs as matrices with one column per struct. The
+// columns of rotations are the coefficients x, y, z, w.
+using ConstMatrix3XdMap = Eigen::Map<const Eigen::Matrix3Xd>;
+using ConstMatrix4XdMap = Eigen::Map<const Eigen::Matrix4Xd>;
+using ConstMatrix6XdMap = Eigen::Map<const intrinsic::eigenmath::Matrix6Xd>;
+
+inline ConstMatrix3XdMap ViewAsMatrix3Xd(absl::Span<const Point> points) {
+  return ConstMatrix3XdMap(reinterpret_cast<const double*>(points.data()), 3,
+                           points.size());
+}
+inline ConstMatrix4XdMap ViewAsMatrix4Xd(absl::Span<const Rotation> rotations) {
+  return ConstMatrix4XdMap(reinterpret_cast<const double*>(rotations.data()),
+                           4, rotations.size());
+}
+inline ConstMatrix6XdMap ViewAsMatrix6Xd(absl::Span<const Twist> twists) {
+  return ConstMatrix6XdMap(reinterpret_cast<const double*>(twists.data()), 6,
+                           twists.size());
+}
+inline ConstMatrix6XdMap ViewAsMatrix6Xd(absl::Span<const Wrench> wrenches) {
+  return ConstMatrix6XdMap(reinterpret_cast<const double*>(wrenches.data()), 6,
+                           wrenches.size());
+}
+
+// The translations and rotations of a span of transforms, as matrices with one
+// column per transform.
+inline constexpr int kTransformStride = sizeof(Transform) / sizeof(double);
+using ConstTransformTranslationsMap =
+    Eigen::Map<const Eigen::Matrix3Xd, Eigen::Unaligned,
+               Eigen::OuterStride<kTransformStride>>;
+using ConstTransformRotationsMap =
+    Eigen::Map<const Eigen::Matrix4Xd, Eigen::Unaligned,
+               Eigen::OuterStride<kTransformStride>>;
+
+inline ConstTransformTranslationsMap ViewTranslations(
+    absl::Span<const Transform> transforms) {
+  return ConstTransformTranslationsMap(
+      reinterpret_cast<const double*>(transforms.data()), 3,
+      transforms.size());
+}
+inline ConstTransformRotationsMap ViewRotations(
+    absl::Span<const Transform> transforms) {
+  return ConstTransformRotationsMap(
+      reinterpret_cast<const double*>(transforms.data()) +
+          sizeof(Point) / sizeof(double),
+      4, transforms.size());
+}
+
 }  // namespace intrinsic_fbs
 
 #endif  // INTRINSIC_ICON_FLATBUFFERS_TRANSFORM_TYPES_H_
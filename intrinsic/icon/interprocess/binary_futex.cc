@@ -3,26 +3,49 @@
 #include "intrinsic/icon/interprocess/binary_futex.h"
 
 #include <linux/futex.h>
-#include <sys/syscall.h>
 
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
 
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
-#include "intrinsic/icon/testing/realtime_annotations.h"
+#include "intrinsic/icon/interprocess/internal/futex.h"
 #include "intrinsic/icon/utils/realtime_status.h"
 
 namespace intrinsic::icon {
 namespace {
 
-inline int64_t futex(std::atomic<uint32_t> &uaddr, int futex_op, uint32_t val,
-                     const struct timespec *timeout = nullptr,
-                     uint32_t *uaddr2 = nullptr,
-                     uint32_t val3 = 0) INTRINSIC_SUPPRESS_REALTIME_CHECK {
-  // For the static analysis, we allow futex operations even though they can
-  // be blocking, because the blocking behavior is usually intended.
-  return syscall(SYS_futex, &uaddr, futex_op, val, timeout, uaddr2,
-                 FUTEX_BITSET_MATCH_ANY);
+// Number of polls between two reads of the clock while spinning.
+constexpr int kPollsPerClockRead = 16;
+
+// Tells the CPU that the calling thread busy-waits, which saves power and
+// frees resources for a sibling hyperthread.
+inline void SpinPause() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Polls `val` until it is one or `spin_end` has passed. Returns true if it
+// acquired the futex by setting `val` from one to zero.
+bool SpinUntil(std::atomic<uint32_t> &val, absl::Time spin_end) {
+  do {
+    for (int i = 0; i < kPollsPerClockRead; ++i) {
+      // Only attempt the compare-exchange, which takes the cache line
+      // exclusively, once the value has changed.
+      if (val.load(std::memory_order_relaxed) == 1) {
+        uint32_t one = 1;
+        if (val.compare_exchange_strong(one, 0)) {
+          return true;
+        }
+      }
+      SpinPause();
+    }
+  } while (absl::Now() < spin_end);
+  return false;
 }
 
 RealtimeStatus Wait(std::atomic<uint32_t> &val, const timespec *ts) {
@@ -35,7 +58,8 @@ RealtimeStatus Wait(std::atomic<uint32_t> &val, const timespec *ts) {
     }
 
     // The value is not yet what we expect, let's wait for it.
-    auto ret = futex(val, FUTEX_WAIT_BITSET | FUTEX_CLOCK_REALTIME, 0, ts);
+    auto ret =
+        internal::Futex(val, FUTEX_WAIT_BITSET | FUTEX_CLOCK_REALTIME, 0, ts);
     if (ret == -1 && errno == ETIMEDOUT) {
       return DeadlineExceededError(RealtimeStatus::StrCat(
           "Timeout after ",
@@ -55,11 +79,16 @@ RealtimeStatus Wait(std::atomic<uint32_t> &val, const timespec *ts) {
 
 }  // namespace
 
-BinaryFutex::BinaryFutex(bool posted) : val_(posted == true ? 1 : 0) {}
-BinaryFutex::BinaryFutex(BinaryFutex &&other) : val_(other.val_.load()) {}
+BinaryFutex::BinaryFutex(bool posted, absl::Duration spin_duration)
+    : val_(posted == true ? 1 : 0) {
+  SetSpinDuration(spin_duration);
+}
+BinaryFutex::BinaryFutex(BinaryFutex &&other)
+    : val_(other.val_.load()), spin_ns_(other.spin_ns_) {}
 BinaryFutex &BinaryFutex::operator=(BinaryFutex &&other) {
   if (this != &other) {
     val_.store(other.val_.load());
+    spin_ns_ = other.spin_ns_;
   }
   return *this;
 }
@@ -68,7 +97,7 @@ RealtimeStatus BinaryFutex::Post() {
   uint32_t zero = 0;
   if (val_.compare_exchange_strong(zero, 1)) {
     // One indicating that we wake up at most 1 other client.
-    if (futex(val_, FUTEX_WAKE, 1) == -1) {
+    if (internal::Futex(val_, FUTEX_WAKE, 1) == -1) {
       return InternalError(strerror(errno));
     }
   }
@@ -79,6 +108,13 @@ RealtimeStatus BinaryFutex::WaitUntil(absl::Time deadline) const {
   if (deadline < absl::Now()) {
     return DeadlineExceededError("Specified deadline is in the past");
   }
+  if (spin_ns_ > 0) {
+    const absl::Time spin_end =
+        std::min(absl::Now() + absl::Nanoseconds(spin_ns_), deadline);
+    if (SpinUntil(val_, spin_end)) {
+      return OkStatus();
+    }
+  }
   if (deadline == absl::InfiniteFuture()) {
     return Wait(val_, nullptr);
   }
@@ -92,4 +128,8 @@ RealtimeStatus BinaryFutex::WaitFor(absl::Duration timeout) const {
 
 uint32_t BinaryFutex::Value() const { return val_; }
 
+void BinaryFutex::SetSpinDuration(absl::Duration spin_duration) {
+  spin_ns_ = std::max<int64_t>(absl::ToInt64Nanoseconds(spin_duration), 0);
+}
+
 }  // namespace intrinsic::icon
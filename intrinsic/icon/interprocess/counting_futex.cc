@@ -0,0 +1,101 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/interprocess/counting_futex.h"
+
+#include <linux/futex.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/interprocess/internal/futex.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/icon/utils/realtime_status_or.h"
+
+namespace intrinsic::icon {
+
+CountingFutex::CountingFutex(uint32_t initial_count) : count_(initial_count) {}
+
+RealtimeStatus CountingFutex::Post(uint32_t count) {
+  if (count == 0) {
+    return OkStatus();
+  }
+  uint32_t current = count_.load();
+  do {
+    if (current > std::numeric_limits<uint32_t>::max() - count) {
+      return ResourceExhaustedError(RealtimeStatus::StrCat(
+          "Posting ", count, " would overflow the count of ", current));
+    }
+  } while (!count_.compare_exchange_weak(current, current + count));
+
+  // Waiters register before they re-check the count, so a waiter that is not
+  // counted here sees the new count and does not go to sleep.
+  if (num_waiters_.load() > 0) {
+    const int num_to_wake =
+        static_cast<int>(std::min<uint32_t>(count, INT_MAX));
+    if (internal::Futex(count_, FUTEX_WAKE, num_to_wake) == -1) {
+      return InternalError(strerror(errno));
+    }
+  }
+  return OkStatus();
+}
+
+RealtimeStatus CountingFutex::WaitUntil(absl::Time deadline) {
+  return TakeUntil(/*max_count=*/1, deadline).status();
+}
+
+RealtimeStatus CountingFutex::WaitFor(absl::Duration timeout) {
+  return WaitUntil(absl::Now() + timeout);
+}
+
+RealtimeStatusOr<uint32_t> CountingFutex::TakeUntil(uint32_t max_count,
+                                                    absl::Time deadline) {
+  if (max_count == 0) {
+    return InvalidArgumentError("max_count must be positive");
+  }
+  while (true) {
+    if (const uint32_t taken = TryTake(max_count); taken > 0) {
+      return taken;
+    }
+    num_waiters_.fetch_add(1);
+    // Sleeps only if the count is still zero.
+    const RealtimeStatus status =
+        internal::FutexWaitUntil(count_, /*expected=*/0, deadline);
+    num_waiters_.fetch_sub(1);
+    if (!status.ok()) {
+      // A post may have raced with the timeout.
+      if (const uint32_t taken = TryTake(max_count); taken > 0) {
+        return taken;
+      }
+      return status;
+    }
+  }
+}
+
+RealtimeStatusOr<uint32_t> CountingFutex::TakeFor(uint32_t max_count,
+                                                  absl::Duration timeout) {
+  return TakeUntil(max_count, absl::Now() + timeout);
+}
+
+bool CountingFutex::TryWait() { return TryTake(/*max_count=*/1) > 0; }
+
+uint32_t CountingFutex::Value() const { return count_; }
+
+uint32_t CountingFutex::TryTake(uint32_t max_count) {
+  uint32_t current = count_.load();
+  while (current > 0) {
+    const uint32_t taken = std::min(current, max_count);
+    if (count_.compare_exchange_weak(current, current - taken)) {
+      return taken;
+    }
+  }
+  return 0;
+}
+
+}  // namespace intrinsic::icon
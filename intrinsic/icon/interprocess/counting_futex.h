@@ -0,0 +1,100 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_INTERPROCESS_COUNTING_FUTEX_H_
+#define INTRINSIC_ICON_INTERPROCESS_COUNTING_FUTEX_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "absl/time/time.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/icon/utils/realtime_status_or.h"
+
+namespace intrinsic::icon {
+
+// A CountingFutex is a counting semaphore on top of a futex. Like BinaryFutex
+// it can be shared through multiple processes via shared memory, but posts
+// accumulate instead of saturating at one.
+//
+// This suits producer/consumer rings: the producer posts once per batch with
+// the number of elements it inserted, and the consumer takes everything that
+// is available with a single wake-up.
+//
+// ```
+//  // Producer
+//  for (int i = 0; i < n; ++i) ring.Insert(items[i]);
+//  INTR_RETURN_IF_ERROR(f_items.Post(n));
+//
+//  // Consumer
+//  INTR_ASSIGN_OR_RETURN(uint32_t available,
+//                        f_items.TakeFor(ring.capacity(), absl::Seconds(1)));
+//  for (uint32_t i = 0; i < available; ++i) Process(ring.Pop());
+// ```
+//
+// A post of `n` wakes up to `n` waiters. Waiting and posting never make a
+// syscall when it is not needed, i.e. when the count is positive or nobody is
+// waiting.
+class CountingFutex {
+ public:
+  explicit CountingFutex(uint32_t initial_count = 0);
+  CountingFutex(const CountingFutex &other) = delete;
+  CountingFutex &operator=(const CountingFutex &other) = delete;
+
+  // Increases the count by `count` and wakes up to `count` waiters.
+  // Returns a resource exhausted error without changing the count if it would
+  // overflow, and an internal error if the waiters could not be woken.
+  // Real-time safe.
+  // Thread-safe.
+  RealtimeStatus Post(uint32_t count = 1);
+
+  // Waits until the count is positive or the deadline exceeds, then decreases
+  // it by one and returns ok.
+  // Returns a deadline exceeded error on timeout, and an internal error if the
+  // futex could not be accessed.
+  // Real-time safe when `deadline` is close enough.
+  // Thread-safe.
+  RealtimeStatus WaitUntil(absl::Time deadline);
+
+  // Same as WaitUntil(), with a timeout relative to now.
+  RealtimeStatus WaitFor(absl::Duration timeout);
+
+  // Waits until the count is positive or the deadline exceeds, then decreases
+  // it by up to `max_count` at once and returns by how much.
+  // Returns an invalid argument error if `max_count` is zero, otherwise the
+  // same errors as WaitUntil().
+  // Real-time safe when `deadline` is close enough.
+  // Thread-safe.
+  RealtimeStatusOr<uint32_t> TakeUntil(uint32_t max_count, absl::Time deadline);
+
+  // Same as TakeUntil(), with a timeout relative to now.
+  RealtimeStatusOr<uint32_t> TakeFor(uint32_t max_count,
+                                     absl::Duration timeout);
+
+  // Decreases the count by one and returns true if it is positive. Returns
+  // false otherwise.
+  // Real-time safe.
+  // Thread-safe.
+  bool TryWait();
+
+  // Returns the current count. The returned value might be outdated by the
+  // time the caller uses the value.
+  // Real-time safe.
+  uint32_t Value() const;
+
+ private:
+  // Decreases the count by up to `max_count` if it is positive. Returns by how
+  // much.
+  uint32_t TryTake(uint32_t max_count);
+
+  static_assert(
+      std::atomic<uint32_t>::is_always_lock_free,
+      "Atomic operations need to be lock free for multi-process communication");
+  std::atomic<uint32_t> count_;
+  // The number of threads that are about to sleep or sleep on `count_`. Lets
+  // Post() skip the wake-up syscall when nobody waits.
+  std::atomic<uint32_t> num_waiters_ = {0};
+};
+
+}  // namespace intrinsic::icon
+
+#endif  // INTRINSIC_ICON_INTERPROCESS_COUNTING_FUTEX_H_
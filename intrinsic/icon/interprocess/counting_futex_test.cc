@@ -0,0 +1,79 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/interprocess/counting_futex.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::icon {
+namespace {
+
+TEST(CountingFutexTest, PostsAccumulate) {
+  CountingFutex futex;
+  EXPECT_FALSE(futex.TryWait());
+  ASSERT_TRUE(futex.Post().ok());
+  ASSERT_TRUE(futex.Post(/*count=*/2).ok());
+  EXPECT_EQ(futex.Value(), 3);
+
+  EXPECT_TRUE(futex.TryWait());
+  EXPECT_TRUE(futex.WaitFor(absl::Seconds(1)).ok());
+  EXPECT_TRUE(futex.WaitFor(absl::Seconds(1)).ok());
+  EXPECT_EQ(futex.WaitFor(absl::Milliseconds(1)).code(),
+            absl::StatusCode::kDeadlineExceeded);
+}
+
+TEST(CountingFutexTest, TakeReturnsBatch) {
+  CountingFutex futex(/*initial_count=*/5);
+  auto taken = futex.TakeFor(/*max_count=*/3, absl::Seconds(1));
+  ASSERT_TRUE(taken.ok());
+  EXPECT_EQ(taken.value(), 3);
+  taken = futex.TakeFor(/*max_count=*/3, absl::Seconds(1));
+  ASSERT_TRUE(taken.ok());
+  EXPECT_EQ(taken.value(), 2);
+  EXPECT_EQ(futex.TakeFor(/*max_count=*/3, absl::Milliseconds(1))
+                .status()
+                .code(),
+            absl::StatusCode::kDeadlineExceeded);
+  EXPECT_EQ(futex.TakeFor(/*max_count=*/0, absl::Seconds(1)).status().code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(CountingFutexTest, PostFailsOnOverflow) {
+  CountingFutex futex(std::numeric_limits<uint32_t>::max());
+  EXPECT_EQ(futex.Post().code(), absl::StatusCode::kResourceExhausted);
+  EXPECT_EQ(futex.Value(), std::numeric_limits<uint32_t>::max());
+}
+
+TEST(CountingFutexTest, OnePostWakesSeveralWaiters) {
+  constexpr int kNumWaiters = 4;
+  constexpr int kNumRounds = 100;
+  CountingFutex futex;
+  std::vector<Thread> waiters;
+  for (int i = 0; i < kNumWaiters; ++i) {
+    waiters.emplace_back([&futex]() {
+      for (int round = 0; round < kNumRounds; ++round) {
+        ASSERT_TRUE(futex.WaitFor(absl::Seconds(10)).ok());
+      }
+    });
+  }
+  for (int round = 0; round < kNumRounds; ++round) {
+    ASSERT_TRUE(futex.Post(kNumWaiters).ok());
+  }
+  for (Thread& waiter : waiters) {
+    waiter.Join();
+  }
+  EXPECT_EQ(futex.Value(), 0);
+}
+
+}  // namespace
+}  // namespace intrinsic::icon
@@ -0,0 +1,91 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/interprocess/futex_event_group.h"
+
+#include <linux/futex.h>
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/interprocess/internal/futex.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/icon/utils/realtime_status_or.h"
+
+namespace intrinsic::icon {
+
+FutexEventGroup::FutexEventGroup(uint32_t initial_flags)
+    : flags_(initial_flags) {}
+
+RealtimeStatus FutexEventGroup::Set(uint32_t flags) {
+  const uint32_t newly_set = flags & ~flags_.fetch_or(flags);
+  // Waiters for flags that were set before have not gone to sleep, or have
+  // been woken up already.
+  if (newly_set != 0 && internal::Futex(flags_, FUTEX_WAKE_BITSET, INT_MAX,
+                                        /*timeout=*/nullptr,
+                                        /*val3=*/newly_set) == -1) {
+    return InternalError(strerror(errno));
+  }
+  return OkStatus();
+}
+
+uint32_t FutexEventGroup::Clear(uint32_t flags) {
+  return flags_.fetch_and(~flags);
+}
+
+RealtimeStatusOr<uint32_t> FutexEventGroup::WaitUntil(
+    uint32_t mask, absl::Time deadline) const {
+  return Wait(mask, deadline, /*consume=*/false);
+}
+
+RealtimeStatusOr<uint32_t> FutexEventGroup::WaitFor(
+    uint32_t mask, absl::Duration timeout) const {
+  return WaitUntil(mask, absl::Now() + timeout);
+}
+
+RealtimeStatusOr<uint32_t> FutexEventGroup::ConsumeUntil(uint32_t mask,
+                                                         absl::Time deadline) {
+  return Wait(mask, deadline, /*consume=*/true);
+}
+
+RealtimeStatusOr<uint32_t> FutexEventGroup::ConsumeFor(
+    uint32_t mask, absl::Duration timeout) {
+  return ConsumeUntil(mask, absl::Now() + timeout);
+}
+
+uint32_t FutexEventGroup::Value() const { return flags_; }
+
+RealtimeStatusOr<uint32_t> FutexEventGroup::Wait(uint32_t mask,
+                                                 absl::Time deadline,
+                                                 bool consume) const {
+  if (mask == 0) {
+    return InvalidArgumentError("mask must not be zero");
+  }
+  uint32_t current = flags_.load();
+  while (true) {
+    if ((current & mask) != 0) {
+      if (!consume) {
+        return current & mask;
+      }
+      if (flags_.compare_exchange_weak(current, current & ~mask)) {
+        return current & mask;
+      }
+      // `current` was updated, check it again.
+      continue;
+    }
+    // Sleeps only if no flag changed since `current` was loaded, and is only
+    // woken up by Set() calls for flags in `mask`.
+    const RealtimeStatus status =
+        internal::FutexWaitUntil(flags_, current, deadline, mask);
+    current = flags_.load();
+    if (!status.ok() && (current & mask) == 0) {
+      return status;
+    }
+  }
+}
+
+}  // namespace intrinsic::icon
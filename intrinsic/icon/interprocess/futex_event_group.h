@@ -0,0 +1,99 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_INTERPROCESS_FUTEX_EVENT_GROUP_H_
+#define INTRINSIC_ICON_INTERPROCESS_FUTEX_EVENT_GROUP_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "absl/time/time.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/icon/utils/realtime_status_or.h"
+
+namespace intrinsic::icon {
+
+// A FutexEventGroup holds 32 event flags in a single futex, which can be
+// shared through multiple processes via shared memory.
+//
+// Any number of threads can wait for any subset of the flags. Setting flags
+// wakes all waiters that wait for one of the newly set flags, and only those,
+// since waiters sleep with their mask in FUTEX_WAIT_BITSET. This lets one
+// producer signal e.g. "new data" and "shutdown" to several consumers through
+// one futex.
+//
+// ```
+//  constexpr uint32_t kDataReady = 1 << 0;
+//  constexpr uint32_t kShutdown = 1 << 1;
+//
+//  // Consumer
+//  INTR_ASSIGN_OR_RETURN(uint32_t flags,
+//                        events.WaitFor(kDataReady | kShutdown, timeout));
+//  if (flags & kShutdown) return;
+//
+//  // Producer
+//  INTR_RETURN_IF_ERROR(events.Set(kDataReady));
+// ```
+//
+// Flags stay set until they are cleared with Clear() or ConsumeUntil().
+class FutexEventGroup {
+ public:
+  explicit FutexEventGroup(uint32_t initial_flags = 0);
+  FutexEventGroup(const FutexEventGroup &other) = delete;
+  FutexEventGroup &operator=(const FutexEventGroup &other) = delete;
+
+  // Sets `flags` and wakes all waiters that wait for one of them, if any of
+  // them was not set before.
+  // Returns an internal error if the waiters could not be woken.
+  // Real-time safe.
+  // Thread-safe.
+  RealtimeStatus Set(uint32_t flags);
+
+  // Clears `flags` and returns all flags as they were before.
+  // Real-time safe.
+  // Thread-safe.
+  uint32_t Clear(uint32_t flags);
+
+  // Waits until at least one of the flags in `mask` is set or the deadline
+  // exceeds, and returns the flags of `mask` that are set. Does not clear the
+  // flags.
+  // Returns an invalid argument error if `mask` is zero, a deadline exceeded
+  // error on timeout, and an internal error if the futex could not be
+  // accessed.
+  // Real-time safe when `deadline` is close enough.
+  // Thread-safe.
+  RealtimeStatusOr<uint32_t> WaitUntil(uint32_t mask,
+                                       absl::Time deadline) const;
+
+  // Same as WaitUntil(), with a timeout relative to now.
+  RealtimeStatusOr<uint32_t> WaitFor(uint32_t mask,
+                                     absl::Duration timeout) const;
+
+  // Same as WaitUntil(), but atomically clears the returned flags. Each time a
+  // flag is set, only one consumer receives it.
+  RealtimeStatusOr<uint32_t> ConsumeUntil(uint32_t mask, absl::Time deadline);
+
+  // Same as ConsumeUntil(), with a timeout relative to now.
+  RealtimeStatusOr<uint32_t> ConsumeFor(uint32_t mask, absl::Duration timeout);
+
+  // Returns all flags. The returned value might be outdated by the time the
+  // caller uses the value.
+  // Real-time safe.
+  uint32_t Value() const;
+
+ private:
+  // Waits until one of the flags in `mask` is set. With `consume`, clears and
+  // returns them atomically.
+  RealtimeStatusOr<uint32_t> Wait(uint32_t mask, absl::Time deadline,
+                                  bool consume) const;
+
+  // As for BinaryFutex, the atomic value is mutable to give waiting read-only
+  // semantics.
+  static_assert(
+      std::atomic<uint32_t>::is_always_lock_free,
+      "Atomic operations need to be lock free for multi-process communication");
+  mutable std::atomic<uint32_t> flags_;
+};
+
+}  // namespace intrinsic::icon
+
+#endif  // INTRINSIC_ICON_INTERPROCESS_FUTEX_EVENT_GROUP_H_
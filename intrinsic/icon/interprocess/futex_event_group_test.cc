@@ -0,0 +1,79 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/interprocess/futex_event_group.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::icon {
+namespace {
+
+constexpr uint32_t kFlagA = 1 << 0;
+constexpr uint32_t kFlagB = 1 << 1;
+
+TEST(FutexEventGroupTest, WaitReturnsSetFlagsOfMask) {
+  FutexEventGroup events;
+  ASSERT_TRUE(events.Set(kFlagA).ok());
+
+  auto flags = events.WaitFor(kFlagA | kFlagB, absl::Seconds(1));
+  ASSERT_TRUE(flags.ok());
+  EXPECT_EQ(flags.value(), kFlagA);
+  // Waiting does not clear the flags.
+  EXPECT_EQ(events.Value(), kFlagA);
+  EXPECT_EQ(events.WaitFor(kFlagB, absl::Milliseconds(1)).status().code(),
+            absl::StatusCode::kDeadlineExceeded);
+  EXPECT_EQ(events.WaitFor(0, absl::Seconds(1)).status().code(),
+            absl::StatusCode::kInvalidArgument);
+
+  EXPECT_EQ(events.Clear(kFlagA), kFlagA);
+  EXPECT_EQ(events.Value(), 0);
+}
+
+TEST(FutexEventGroupTest, ConsumeClearsReturnedFlags) {
+  FutexEventGroup events(/*initial_flags=*/kFlagA | kFlagB);
+  auto flags = events.ConsumeFor(kFlagA, absl::Seconds(1));
+  ASSERT_TRUE(flags.ok());
+  EXPECT_EQ(flags.value(), kFlagA);
+  EXPECT_EQ(events.Value(), kFlagB);
+  EXPECT_EQ(events.ConsumeFor(kFlagA, absl::Milliseconds(1)).status().code(),
+            absl::StatusCode::kDeadlineExceeded);
+}
+
+TEST(FutexEventGroupTest, SetWakesAllWaitersOfFlag) {
+  constexpr int kNumWaiters = 3;
+  FutexEventGroup events;
+  std::atomic<int> num_woken = 0;
+  std::vector<Thread> waiters;
+  for (int i = 0; i < kNumWaiters; ++i) {
+    waiters.emplace_back([&]() {
+      auto flags = events.WaitFor(kFlagA, absl::Seconds(10));
+      ASSERT_TRUE(flags.ok());
+      EXPECT_EQ(flags.value(), kFlagA);
+      ++num_woken;
+    });
+  }
+  // Flags outside of the mask of the waiters do not wake them.
+  ASSERT_TRUE(events.Set(kFlagB).ok());
+  absl::SleepFor(absl::Milliseconds(10));
+  EXPECT_EQ(num_woken, 0);
+
+  ASSERT_TRUE(events.Set(kFlagA).ok());
+  for (Thread& waiter : waiters) {
+    waiter.Join();
+  }
+  EXPECT_EQ(num_woken, kNumWaiters);
+}
+
+}  // namespace
+}  // namespace intrinsic::icon
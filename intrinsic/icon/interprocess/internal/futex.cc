@@ -0,0 +1,58 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/interprocess/internal/futex.h"
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/testing/realtime_annotations.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+
+namespace intrinsic::icon::internal {
+
+int64_t Futex(std::atomic<uint32_t>& uaddr, int futex_op, uint32_t val,
+              const struct timespec* timeout,
+              uint32_t val3) INTRINSIC_SUPPRESS_REALTIME_CHECK {
+  // For the static analysis, we allow futex operations even though they can
+  // be blocking, because the blocking behavior is usually intended.
+  return syscall(SYS_futex, &uaddr, futex_op, val, timeout,
+                 /*uaddr2=*/nullptr, val3);
+}
+
+RealtimeStatus FutexWaitUntil(std::atomic<uint32_t>& uaddr, uint32_t expected,
+                              absl::Time deadline, uint32_t mask) {
+  int64_t ret;
+  if (deadline == absl::InfiniteFuture()) {
+    ret = Futex(uaddr, FUTEX_WAIT_BITSET, expected, nullptr, mask);
+  } else {
+    if (deadline <= absl::Now()) {
+      return DeadlineExceededError("Deadline exceeded while waiting on futex");
+    }
+    const struct timespec ts = absl::ToTimespec(deadline);
+    ret = Futex(uaddr, FUTEX_WAIT_BITSET | FUTEX_CLOCK_REALTIME, expected, &ts,
+                mask);
+  }
+  if (ret != -1) return OkStatus();
+  switch (errno) {
+    case ETIMEDOUT:
+      return DeadlineExceededError("Deadline exceeded while waiting on futex");
+    // The value changed before we went to sleep, or a signal woke us up. We've
+    // encountered various SIGPROF when running on forge and decided to ignore
+    // these.
+    case EAGAIN:
+    case EINTR:
+      return OkStatus();
+    default:
+      return InternalError(strerror(errno));
+  }
+}
+
+}  // namespace intrinsic::icon::internal
@@ -0,0 +1,38 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_INTERPROCESS_INTERNAL_FUTEX_H_
+#define INTRINSIC_ICON_INTERPROCESS_INTERNAL_FUTEX_H_
+
+#include <linux/futex.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "absl/time/time.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+
+namespace intrinsic::icon::internal {
+
+// Calls futex(2) on `uaddr`. Returns the result of the syscall and leaves the
+// error in errno. The futex is not process private, so it can be shared
+// through shared memory.
+int64_t Futex(std::atomic<uint32_t>& uaddr, int futex_op, uint32_t val,
+              const struct timespec* timeout = nullptr,
+              uint32_t val3 = FUTEX_BITSET_MATCH_ANY);
+
+// Sleeps while `uaddr` holds `expected`, until a FUTEX_WAKE or a
+// FUTEX_WAKE_BITSET whose mask intersects `mask` wakes it, or `deadline`
+// passes.
+//
+// Returns OkStatus() if the caller should re-check its condition, i.e. after a
+// wake-up, a spurious wake-up, a signal, or if `uaddr` did not hold `expected`
+// anymore. Returns DeadlineExceededError once `deadline` has passed, and
+// InternalError if the futex could not be accessed.
+// Real-time safe when `deadline` is close enough.
+RealtimeStatus FutexWaitUntil(std::atomic<uint32_t>& uaddr, uint32_t expected,
+                              absl::Time deadline,
+                              uint32_t mask = FUTEX_BITSET_MATCH_ANY);
+
+}  // namespace intrinsic::icon::internal
+
+#endif  // INTRINSIC_ICON_INTERPROCESS_INTERNAL_FUTEX_H_
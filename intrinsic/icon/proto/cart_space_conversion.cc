@@ -2,13 +2,17 @@
 
 #include "intrinsic/icon/proto/cart_space_conversion.h"
 
+#include <cstddef>
 #include <cstdlib>
 #include <string>
+#include <vector>
 
 #include "Eigen/Geometry"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "google/protobuf/repeated_ptr_field.h"
 #include "intrinsic/eigenmath/types.h"
 #include "intrinsic/icon/proto/cart_space.pb.h"
 #include "intrinsic/icon/proto/eigen_conversion.h"
@@ -20,29 +24,96 @@
 namespace intrinsic::icon {
 
 namespace {
+template <typename ProtoT, typename CartVectorT>
+void CartVectorToProto(const CartVectorT& obj, ProtoT* out) {
+  out->set_x(obj.x());
+  out->set_y(obj.y());
+  out->set_z(obj.z());
+  out->set_rx(obj.RX());
+  out->set_ry(obj.RY());
+  out->set_rz(obj.RZ());
+}
+
 template <typename ProtoT, typename CartVectorT>
 ProtoT CartVectorToProto(const CartVectorT& obj) {
   ProtoT out;
-  out.set_x(obj.x());
-  out.set_y(obj.y());
-  out.set_z(obj.z());
-  out.set_rx(obj.RX());
-  out.set_ry(obj.RY());
-  out.set_rz(obj.RZ());
+  CartVectorToProto(obj, &out);
   return out;
 }
 
+template <typename ProtoT, typename CartVectorT>
+void CartVectorFromProto(const ProtoT& proto, CartVectorT* out) {
+  out->x() = proto.x();
+  out->y() = proto.y();
+  out->z() = proto.z();
+  out->RX() = proto.rx();
+  out->RY() = proto.ry();
+  out->RZ() = proto.rz();
+}
+
 template <typename ProtoT, typename CartVectorT>
 CartVectorT CartVectorFromProto(const ProtoT& proto) {
   CartVectorT out;
-  out.x() = proto.x();
-  out.y() = proto.y();
-  out.z() = proto.z();
-  out.RX() = proto.rx();
-  out.RY() = proto.ry();
-  out.RZ() = proto.rz();
+  CartVectorFromProto(proto, &out);
   return out;
 }
+
+absl::Status CheckBatchSize(int num_protos, size_t num_values) {
+  if (static_cast<size_t>(num_protos) != num_values) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Cannot convert ", num_protos, " protos into ",
+                     num_values, " values"));
+  }
+  return absl::OkStatus();
+}
+
+template <typename ProtoT, typename CartVectorT>
+void CartVectorsToProto(absl::Span<const CartVectorT> values,
+                        google::protobuf::RepeatedPtrField<ProtoT>* protos) {
+  // Clear() keeps the elements allocated, and Add() reuses them.
+  protos->Clear();
+  protos->Reserve(static_cast<int>(values.size()));
+  for (const CartVectorT& value : values) {
+    CartVectorToProto(value, protos->Add());
+  }
+}
+
+template <typename ProtoT, typename CartVectorT>
+absl::Status CartVectorsFromProto(
+    const google::protobuf::RepeatedPtrField<ProtoT>& protos,
+    absl::Span<CartVectorT> values) {
+  INTR_RETURN_IF_ERROR(CheckBatchSize(protos.size(), values.size()));
+  for (size_t i = 0; i < values.size(); ++i) {
+    CartVectorFromProto(protos[i], &values[i]);
+  }
+  return absl::OkStatus();
+}
+
+bool IsNormalized(const eigenmath::Quaterniond& quat) {
+  return std::abs(quat.squaredNorm() - 1.0f) <
+         Eigen::NumTraits<double>::dummy_precision();
+}
+
+eigenmath::Quaterniond QuaternionFromProto(
+    const intrinsic_proto::icon::Transform& proto) {
+  return eigenmath::Quaterniond{proto.rot().qw(), proto.rot().qx(),
+                                proto.rot().qy(), proto.rot().qz()};
+}
+
+absl::Status NotNormalizedError(const intrinsic_proto::icon::Transform& proto) {
+  return absl::InvalidArgumentError(
+      absl::StrCat("Cannot deserialize control::Transform: quaternion is not "
+                   "normalized; proto=",
+                   proto));
+}
+
+// Converts `proto`, whose quaternion is known to be normalized.
+Pose3d PoseFromValidProto(const intrinsic_proto::icon::Transform& proto) {
+  return Pose3d(
+      QuaternionFromProto(proto),
+      eigenmath::Vector3d{proto.pos().x(), proto.pos().y(), proto.pos().z()},
+      eigenmath::kDoNotNormalize);
+}
 }  // namespace
 
 intrinsic_proto::icon::Twist ToProto(const Twist& twist) {
@@ -53,6 +124,14 @@ Twist FromProto(const intrinsic_proto::icon::Twist& proto) {
   return CartVectorFromProto<intrinsic_proto::icon::Twist, Twist>(proto);
 }
 
+void ToProto(const Twist& twist, intrinsic_proto::icon::Twist* proto) {
+  CartVectorToProto(twist, proto);
+}
+
+void FromProto(const intrinsic_proto::icon::Twist& proto, Twist* twist) {
+  CartVectorFromProto(proto, twist);
+}
+
 intrinsic_proto::icon::Acceleration ToProto(const Acceleration& acc) {
   return CartVectorToProto<intrinsic_proto::icon::Acceleration, Acceleration>(
       acc);
@@ -63,6 +142,16 @@ Acceleration FromProto(const intrinsic_proto::icon::Acceleration& proto) {
       proto);
 }
 
+void ToProto(const Acceleration& acc,
+             intrinsic_proto::icon::Acceleration* proto) {
+  CartVectorToProto(acc, proto);
+}
+
+void FromProto(const intrinsic_proto::icon::Acceleration& proto,
+               Acceleration* acc) {
+  CartVectorFromProto(proto, acc);
+}
+
 intrinsic_proto::icon::Wrench ToProto(const Wrench& wrench) {
   return CartVectorToProto<intrinsic_proto::icon::Wrench, Wrench>(wrench);
 }
@@ -71,57 +160,71 @@ Wrench FromProto(const intrinsic_proto::icon::Wrench& proto) {
   return CartVectorFromProto<intrinsic_proto::icon::Wrench, Wrench>(proto);
 }
 
+void ToProto(const Wrench& wrench, intrinsic_proto::icon::Wrench* proto) {
+  CartVectorToProto(wrench, proto);
+}
+
+void FromProto(const intrinsic_proto::icon::Wrench& proto, Wrench* wrench) {
+  CartVectorFromProto(proto, wrench);
+}
+
 intrinsic_proto::icon::CartesianLimits ToProto(const CartesianLimits& limits) {
   intrinsic_proto::icon::CartesianLimits out;
+  ToProto(limits, &out);
+  return out;
+}
+
+void ToProto(const CartesianLimits& limits,
+             intrinsic_proto::icon::CartesianLimits* proto) {
   Vector3dToRepeatedDouble(limits.min_translational_position,
-                           out.mutable_min_translational_position());
+                           proto->mutable_min_translational_position());
   Vector3dToRepeatedDouble(limits.max_translational_position,
-                           out.mutable_max_translational_position());
+                           proto->mutable_max_translational_position());
   Vector3dToRepeatedDouble(limits.min_translational_velocity,
-                           out.mutable_min_translational_velocity());
+                           proto->mutable_min_translational_velocity());
   Vector3dToRepeatedDouble(limits.max_translational_velocity,
-                           out.mutable_max_translational_velocity());
+                           proto->mutable_max_translational_velocity());
   Vector3dToRepeatedDouble(limits.min_translational_acceleration,
-                           out.mutable_min_translational_acceleration());
+                           proto->mutable_min_translational_acceleration());
   Vector3dToRepeatedDouble(limits.max_translational_acceleration,
-                           out.mutable_max_translational_acceleration());
+                           proto->mutable_max_translational_acceleration());
   Vector3dToRepeatedDouble(limits.min_translational_jerk,
-                           out.mutable_min_translational_jerk());
+                           proto->mutable_min_translational_jerk());
   Vector3dToRepeatedDouble(limits.max_translational_jerk,
-                           out.mutable_max_translational_jerk());
-  out.set_max_rotational_velocity(limits.max_rotational_velocity);
-  out.set_max_rotational_acceleration(limits.max_rotational_acceleration);
-  out.set_max_rotational_jerk(limits.max_rotational_jerk);
-  return out;
+                           proto->mutable_max_translational_jerk());
+  proto->set_max_rotational_velocity(limits.max_rotational_velocity);
+  proto->set_max_rotational_acceleration(limits.max_rotational_acceleration);
+  proto->set_max_rotational_jerk(limits.max_rotational_jerk);
 }
 
 absl::StatusOr<CartesianLimits> FromProto(
     const intrinsic_proto::icon::CartesianLimits& proto) {
   CartesianLimits out;
-  INTR_ASSIGN_OR_RETURN(
-      out.min_translational_position,
-      RepeatedDoubleToVector3d(proto.min_translational_position()));
-  INTR_ASSIGN_OR_RETURN(
-      out.max_translational_position,
-      RepeatedDoubleToVector3d(proto.max_translational_position()));
-  INTR_ASSIGN_OR_RETURN(
-      out.min_translational_velocity,
-      RepeatedDoubleToVector3d(proto.min_translational_velocity()));
-  INTR_ASSIGN_OR_RETURN(
-      out.max_translational_velocity,
-      RepeatedDoubleToVector3d(proto.max_translational_velocity()));
-  INTR_ASSIGN_OR_RETURN(
-      out.min_translational_acceleration,
-      RepeatedDoubleToVector3d(proto.min_translational_acceleration()));
-  INTR_ASSIGN_OR_RETURN(
-      out.max_translational_acceleration,
-      RepeatedDoubleToVector3d(proto.max_translational_acceleration()));
-  INTR_ASSIGN_OR_RETURN(
-      out.min_translational_jerk,
-      RepeatedDoubleToVector3d(proto.min_translational_jerk()));
-  INTR_ASSIGN_OR_RETURN(
-      out.max_translational_jerk,
-      RepeatedDoubleToVector3d(proto.max_translational_jerk()));
+  INTR_RETURN_IF_ERROR(FromProto(proto, &out));
+  return out;
+}
+
+absl::Status FromProto(const intrinsic_proto::icon::CartesianLimits& proto,
+                       CartesianLimits* limits) {
+  CartesianLimits& out = *limits;
+  INTR_RETURN_IF_ERROR(RepeatedDoubleToVector3d(
+      proto.min_translational_position(), &out.min_translational_position));
+  INTR_RETURN_IF_ERROR(RepeatedDoubleToVector3d(
+      proto.max_translational_position(), &out.max_translational_position));
+  INTR_RETURN_IF_ERROR(RepeatedDoubleToVector3d(
+      proto.min_translational_velocity(), &out.min_translational_velocity));
+  INTR_RETURN_IF_ERROR(RepeatedDoubleToVector3d(
+      proto.max_translational_velocity(), &out.max_translational_velocity));
+  INTR_RETURN_IF_ERROR(
+      RepeatedDoubleToVector3d(proto.min_translational_acceleration(),
+                               &out.min_translational_acceleration));
+  INTR_RETURN_IF_ERROR(
+      RepeatedDoubleToVector3d(proto.max_translational_acceleration(),
+                               &out.max_translational_acceleration));
+  INTR_RETURN_IF_ERROR(RepeatedDoubleToVector3d(
+      proto.min_translational_jerk(), &out.min_translational_jerk));
+  INTR_RETURN_IF_ERROR(RepeatedDoubleToVector3d(
+      proto.max_translational_jerk(), &out.max_translational_jerk));
   out.max_rotational_velocity = proto.max_rotational_velocity();
   out.max_rotational_acceleration = proto.max_rotational_acceleration();
   out.max_rotational_jerk = proto.max_rotational_jerk();
@@ -129,42 +232,115 @@ absl::StatusOr<CartesianLimits> FromProto(
     return absl::InvalidArgumentError(
         absl::StrCat("Cartesian limits are invalid: ", proto));
   }
-  return out;
+  return absl::OkStatus();
 }
 
 intrinsic_proto::icon::Transform ToProto(const Pose3d& pose) {
   intrinsic_proto::icon::Transform out;
-  intrinsic_proto::icon::Point pos;
+  ToProto(pose, &out);
+  return out;
+}
+
+void ToProto(const Pose3d& pose, intrinsic_proto::icon::Transform* proto) {
+  intrinsic_proto::icon::Point& pos = *proto->mutable_pos();
   pos.set_x(pose.translation().x());
   pos.set_y(pose.translation().y());
   pos.set_z(pose.translation().z());
 
-  intrinsic_proto::icon::Rotation rot;
+  intrinsic_proto::icon::Rotation& rot = *proto->mutable_rot();
   rot.set_qx(pose.quaternion().x());
   rot.set_qy(pose.quaternion().y());
   rot.set_qz(pose.quaternion().z());
   rot.set_qw(pose.quaternion().w());
-
-  *out.mutable_pos() = pos;
-  *out.mutable_rot() = rot;
-  return out;
 }
 
 absl::StatusOr<Pose3d> FromProto(
     const intrinsic_proto::icon::Transform& proto) {
-  eigenmath::Quaterniond quat{proto.rot().qw(), proto.rot().qx(),
-                              proto.rot().qy(), proto.rot().qz()};
-  if (std::abs(quat.squaredNorm() - 1.0f) >=
-      Eigen::NumTraits<double>::dummy_precision()) {
-    return absl::InvalidArgumentError(
-        absl::StrCat("Cannot deserialize control::Transform: quaternion is not "
-                     "normalized; proto=",
-                     proto));
+  Pose3d pose;
+  INTR_RETURN_IF_ERROR(FromProto(proto, &pose));
+  return pose;
+}
+
+absl::Status FromProto(const intrinsic_proto::icon::Transform& proto,
+                       Pose3d* pose) {
+  if (!IsNormalized(QuaternionFromProto(proto))) {
+    return NotNormalizedError(proto);
   }
-  return Pose3d(
-      quat,
-      eigenmath::Vector3d{proto.pos().x(), proto.pos().y(), proto.pos().z()},
-      eigenmath::kDoNotNormalize);
+  *pose = PoseFromValidProto(proto);
+  return absl::OkStatus();
+}
+
+void ToProto(
+    absl::Span<const Twist> twists,
+    google::protobuf::RepeatedPtrField<intrinsic_proto::icon::Twist>* protos) {
+  CartVectorsToProto(twists, protos);
+}
+
+absl::Status FromProto(
+    const google::protobuf::RepeatedPtrField<intrinsic_proto::icon::Twist>&
+        protos,
+    absl::Span<Twist> twists) {
+  return CartVectorsFromProto(protos, twists);
+}
+
+void ToProto(absl::Span<const Acceleration> accs,
+             google::protobuf::RepeatedPtrField<
+                 intrinsic_proto::icon::Acceleration>* protos) {
+  CartVectorsToProto(accs, protos);
+}
+
+absl::Status FromProto(
+    const google::protobuf::RepeatedPtrField<
+        intrinsic_proto::icon::Acceleration>& protos,
+    absl::Span<Acceleration> accs) {
+  return CartVectorsFromProto(protos, accs);
+}
+
+void ToProto(
+    absl::Span<const Wrench> wrenches,
+    google::protobuf::RepeatedPtrField<intrinsic_proto::icon::Wrench>* protos) {
+  CartVectorsToProto(wrenches, protos);
+}
+
+absl::Status FromProto(
+    const google::protobuf::RepeatedPtrField<intrinsic_proto::icon::Wrench>&
+        protos,
+    absl::Span<Wrench> wrenches) {
+  return CartVectorsFromProto(protos, wrenches);
+}
+
+void ToProto(absl::Span<const Pose3d> poses,
+             google::protobuf::RepeatedPtrField<
+                 intrinsic_proto::icon::Transform>* protos) {
+  protos->Clear();
+  protos->Reserve(static_cast<int>(poses.size()));
+  for (const Pose3d& pose : poses) {
+    ToProto(pose, protos->Add());
+  }
+}
+
+absl::Status FromProto(
+    const google::protobuf::RepeatedPtrField<intrinsic_proto::icon::Transform>&
+        protos,
+    absl::Span<Pose3d> poses) {
+  INTR_RETURN_IF_ERROR(CheckBatchSize(protos.size(), poses.size()));
+  for (const intrinsic_proto::icon::Transform& proto : protos) {
+    if (!IsNormalized(QuaternionFromProto(proto))) {
+      return NotNormalizedError(proto);
+    }
+  }
+  for (size_t i = 0; i < poses.size(); ++i) {
+    poses[i] = PoseFromValidProto(protos[i]);
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::vector<Pose3d>> FromProto(
+    const google::protobuf::RepeatedPtrField<intrinsic_proto::icon::Transform>&
+        protos) {
+  std::vector<Pose3d> poses(protos.size());
+  INTR_RETURN_IF_ERROR(FromProto(protos, absl::MakeSpan(poses)));
+  return poses;
 }
 
 }  // namespace intrinsic::icon
@@ -3,8 +3,12 @@
 #ifndef INTRINSIC_ICON_PROTO_CART_SPACE_CONVERSION_H_
 #define INTRINSIC_ICON_PROTO_CART_SPACE_CONVERSION_H_
 
+#include <vector>
+
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "google/protobuf/repeated_ptr_field.h"
 #include "intrinsic/icon/proto/cart_space.pb.h"
 #include "intrinsic/kinematics/types/cartesian_limits.h"
 #include "intrinsic/math/pose3.h"
@@ -12,26 +16,39 @@
 
 namespace intrinsic::icon {
 
+// The overloads below that take a pointer to their output write into it instead
+// of returning a new object, and reuse its storage. See eigen_conversion.h.
+
 // Converts a Twist to a proto::Twist proto.
 intrinsic_proto::icon::Twist ToProto(const Twist& twist);
+void ToProto(const Twist& twist, intrinsic_proto::icon::Twist* proto);
 
 // Converts a proto::Twist proto to a Twist.
 Twist FromProto(const intrinsic_proto::icon::Twist& proto);
+void FromProto(const intrinsic_proto::icon::Twist& proto, Twist* twist);
 
 // Converts an Acceleration to a proto::Acceleration proto.
 intrinsic_proto::icon::Acceleration ToProto(const Acceleration& acc);
+void ToProto(const Acceleration& acc,
+             intrinsic_proto::icon::Acceleration* proto);
 
 // Converts a proto::Acceleration proto to an Acceleration.
 Acceleration FromProto(const intrinsic_proto::icon::Acceleration& proto);
+void FromProto(const intrinsic_proto::icon::Acceleration& proto,
+               Acceleration* acc);
 
 // Converts a Wrench to a proto::Wrench proto.
 intrinsic_proto::icon::Wrench ToProto(const Wrench& wrench);
+void ToProto(const Wrench& wrench, intrinsic_proto::icon::Wrench* proto);
 
 // Converts a proto::Wrench proto to a Wrench.
 Wrench FromProto(const intrinsic_proto::icon::Wrench& proto);
+void FromProto(const intrinsic_proto::icon::Wrench& proto, Wrench* wrench);
 
 // Converts CartesianLimits to a proto::CartesianLimits proto.
 intrinsic_proto::icon::CartesianLimits ToProto(const CartesianLimits& limits);
+void ToProto(const CartesianLimits& limits,
+             intrinsic_proto::icon::CartesianLimits* proto);
 
 // Converts a proto::CartesianLimits proto to a CartesianLimits.
 //
@@ -39,16 +56,67 @@ intrinsic_proto::icon::CartesianLimits ToProto(const CartesianLimits& limits);
 // is returned.
 absl::StatusOr<CartesianLimits> FromProto(
     const intrinsic_proto::icon::CartesianLimits& proto);
+// On error, `limits` may be partially updated.
+absl::Status FromProto(const intrinsic_proto::icon::CartesianLimits& proto,
+                       CartesianLimits* limits);
 
 // Converts a Pose3d to a proto::Transform proto.
 //
 // `pose` is converted as-is. If it has a non-normalized quaternion, then the
 // conversion will still succeed, but `FromProto(ToProto(pose)` will fail.
 intrinsic_proto::icon::Transform ToProto(const Pose3d& pose);
+void ToProto(const Pose3d& pose, intrinsic_proto::icon::Transform* proto);
 
 // Converts a proto::Transform proto to a Pose3d. Returns
 // InvalidArgumentError if `rot` is not normalized.
 absl::StatusOr<Pose3d> FromProto(const intrinsic_proto::icon::Transform& proto);
+absl::Status FromProto(const intrinsic_proto::icon::Transform& proto,
+                       Pose3d* pose);
+
+// Batch conversions, e.g., for the waypoints of a Cartesian path.
+//
+// ToProto() replaces the contents of `protos` and reuses its allocated
+// elements, so that converting into the same repeated field again, e.g., for
+// every chunk of a streamed trajectory, does not allocate. FromProto() writes
+// into `values`, which must have the same size as `protos`, and returns
+// InvalidArgumentError otherwise.
+void ToProto(
+    absl::Span<const Twist> twists,
+    google::protobuf::RepeatedPtrField<intrinsic_proto::icon::Twist>* protos);
+absl::Status FromProto(
+    const google::protobuf::RepeatedPtrField<intrinsic_proto::icon::Twist>&
+        protos,
+    absl::Span<Twist> twists);
+
+void ToProto(absl::Span<const Acceleration> accs,
+             google::protobuf::RepeatedPtrField<
+                 intrinsic_proto::icon::Acceleration>* protos);
+absl::Status FromProto(
+    const google::protobuf::RepeatedPtrField<
+        intrinsic_proto::icon::Acceleration>& protos,
+    absl::Span<Acceleration> accs);
+
+void ToProto(
+    absl::Span<const Wrench> wrenches,
+    google::protobuf::RepeatedPtrField<intrinsic_proto::icon::Wrench>* protos);
+absl::Status FromProto(
+    const google::protobuf::RepeatedPtrField<intrinsic_proto::icon::Wrench>&
+        protos,
+    absl::Span<Wrench> wrenches);
+
+void ToProto(absl::Span<const Pose3d> poses,
+             google::protobuf::RepeatedPtrField<
+                 intrinsic_proto::icon::Transform>* protos);
+
+// Checks all quaternions before writing any pose, so that `poses` is left
+// unchanged if one of them is not normalized.
+absl::Status FromProto(
+    const google::protobuf::RepeatedPtrField<intrinsic_proto::icon::Transform>&
+        protos,
+    absl::Span<Pose3d> poses);
+absl::StatusOr<std::vector<Pose3d>> FromProto(
+    const google::protobuf::RepeatedPtrField<intrinsic_proto::icon::Transform>&
+        protos);
 
 }  // namespace intrinsic::icon
 
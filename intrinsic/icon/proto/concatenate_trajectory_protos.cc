@@ -3,10 +3,15 @@
 #include "intrinsic/icon/proto/concatenate_trajectory_protos.h"
 
 #include <algorithm>
+#include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "google/protobuf/duration.pb.h"
+#include "intrinsic/icon/proto/joint_space.pb.h"
+#include "intrinsic/util/status/status_macros.h"
 
 namespace intrinsic {
 
@@ -80,4 +85,55 @@ ConcatenateTrajectoryProtos(
   return trajectory;
 }
 
+absl::StatusOr<intrinsic_proto::icon::JointTrajectoryPVA>
+ConcatenateTrajectoryProtos(
+    std::vector<intrinsic_proto::icon::JointTrajectoryPVA>&&
+        trajectory_segments) {
+  if (trajectory_segments.empty())
+    return absl::FailedPreconditionError(
+        "Vector of trajectory protos is empty.");
+
+  intrinsic_proto::icon::JointTrajectoryPVA trajectory =
+      std::move(trajectory_segments[0]);
+  for (int subel = 1; subel < trajectory_segments.size(); subel++) {
+    INTR_RETURN_IF_ERROR(
+        AppendTrajectoryProto(std::move(trajectory_segments[subel]),
+                              &trajectory));
+  }
+  return trajectory;
+}
+
+absl::Status AppendTrajectoryProto(
+    intrinsic_proto::icon::JointTrajectoryPVA&& segment,
+    intrinsic_proto::icon::JointTrajectoryPVA* trajectory) {
+  if (trajectory->time_since_start_size() == 0 &&
+      trajectory->state_size() == 0) {
+    *trajectory = std::move(segment);
+    return absl::OkStatus();
+  }
+  if (segment.joint_dynamic_limits_check_mode() !=
+      trajectory->joint_dynamic_limits_check_mode()) {
+    return absl::InvalidArgumentError(
+        "All trajectory segments should have the same "
+        "dynamic_limits_check_mode.");
+  }
+  if (segment.interpolation_type() != trajectory->interpolation_type()) {
+    return absl::InvalidArgumentError(
+        "All trajectory segments should have the same "
+        "interpolation_type.");
+  }
+  trajectory->mutable_time_since_start()->Reserve(
+      trajectory->time_since_start_size() + segment.time_since_start_size());
+  for (google::protobuf::Duration& time_since_start :
+       *segment.mutable_time_since_start()) {
+    *trajectory->add_time_since_start() = std::move(time_since_start);
+  }
+  trajectory->mutable_state()->Reserve(trajectory->state_size() +
+                                       segment.state_size());
+  for (intrinsic_proto::icon::JointStatePVA& state : *segment.mutable_state()) {
+    *trajectory->add_state() = std::move(state);
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace intrinsic
@@ -5,6 +5,7 @@
 
 #include <vector>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "intrinsic/icon/proto/joint_space.pb.h"
 
@@ -14,6 +15,10 @@ namespace intrinsic {
 // `max_subtrajectory_length`. Time stamps remain untouched in the different
 // trajectory segments. Returns kFailedPrecondition in case of invalid
 // `max_subtrajectory_length` or in case of an empty `proto`.
+//
+// This copies every state. To stream a long trajectory in chunks, prefer
+// SplitTrajectoryView() in trajectory_view.h, which serializes only the chunk
+// that is being sent.
 absl::StatusOr<std::vector<intrinsic_proto::icon::JointTrajectoryPVA>>
 SplitTrajectoryProto(const intrinsic_proto::icon::JointTrajectoryPVA& proto,
                      int max_subtrajectory_length);
@@ -23,11 +28,33 @@ SplitTrajectoryProto(const intrinsic_proto::icon::JointTrajectoryPVA& proto,
 // `trajectory_segments` are monotonically increasing, and that the first time
 // stamp of a segment is greater than the last time stamp of the preceding
 // segment. Returns kFailedPrecondition if `trajectories` is empty.
+//
+// JointTrajectory::Append() in joint_trajectory.h joins segments into
+// contiguous arrays instead, without a message per state.
 absl::StatusOr<intrinsic_proto::icon::JointTrajectoryPVA>
 ConcatenateTrajectoryProtos(
     const std::vector<intrinsic_proto::icon::JointTrajectoryPVA>&
         trajectory_segments);
 
+// As above, but moves the states and time stamps out of `trajectory_segments`
+// instead of copying them.
+absl::StatusOr<intrinsic_proto::icon::JointTrajectoryPVA>
+ConcatenateTrajectoryProtos(
+    std::vector<intrinsic_proto::icon::JointTrajectoryPVA>&&
+        trajectory_segments);
+
+// Appends `segment` to `trajectory` in place, moving its states and time
+// stamps. If `trajectory` is empty, it takes over `segment` as is. This allows
+// joining segments as they arrive, without keeping them around. Makes the same
+// assumptions about time stamps as ConcatenateTrajectoryProtos().
+//
+// Returns kInvalidArgument if `trajectory` is not empty and `segment` has a
+// different dynamic limits check mode or interpolation type; `trajectory` is
+// unchanged then.
+absl::Status AppendTrajectoryProto(
+    intrinsic_proto::icon::JointTrajectoryPVA&& segment,
+    intrinsic_proto::icon::JointTrajectoryPVA* trajectory);
+
 }  // namespace intrinsic
 
 #endif  // INTRINSIC_ICON_PROTO_CONCATENATE_TRAJECTORY_PROTOS_H_
@@ -11,15 +11,21 @@
 #include "intrinsic/icon/proto/cart_space.pb.h"
 #include "intrinsic/icon/proto/joint_space.pb.h"
 #include "intrinsic/icon/proto/matrix.pb.h"
+#include "intrinsic/util/status/status_macros.h"
 
 namespace intrinsic::icon {
 
 intrinsic_proto::icon::JointVec ToJointVecProto(const eigenmath::VectorNd& v) {
   intrinsic_proto::icon::JointVec proto;
-  details::ToRepeatedDouble(v, proto.mutable_joints());
+  ToJointVecProto(v, &proto);
   return proto;
 }
 
+void ToJointVecProto(const eigenmath::VectorNd& v,
+                     intrinsic_proto::icon::JointVec* proto) {
+  details::ToRepeatedDouble(v, proto->mutable_joints());
+}
+
 intrinsic_proto::icon::JointStatePV ToJointStatePVProtoWithZeroVel(
     const eigenmath::VectorNd& v) {
   intrinsic_proto::icon::JointStatePV proto;
@@ -35,20 +41,36 @@ absl::StatusOr<eigenmath::VectorNd> FromProto(
   return RepeatedDoubleToVectorNd(proto.joints());
 }
 
+absl::Status FromProto(const intrinsic_proto::icon::JointVec& proto,
+                       eigenmath::VectorNd* v) {
+  return RepeatedDoubleToVectorNd(proto.joints(), v);
+}
+
 intrinsic_proto::icon::Matrix6d ToProto(const eigenmath::Matrix6d& matrix) {
   intrinsic_proto::icon::Matrix6d proto;
-  proto.mutable_data()->Resize(36, 0);
+  ToProto(matrix, &proto);
+  return proto;
+}
+
+void ToProto(const eigenmath::Matrix6d& matrix,
+             intrinsic_proto::icon::Matrix6d* proto) {
+  proto->mutable_data()->Resize(36, 0);
   for (int i = 0; i < 6; ++i) {
     for (int j = 0; j < 6; ++j) {
-      proto.set_data((i * 6) + j, matrix(i, j));
+      proto->set_data((i * 6) + j, matrix(i, j));
     }
   }
-  return proto;
 }
 
 absl::StatusOr<eigenmath::Matrix6d> FromProto(
     const intrinsic_proto::icon::Matrix6d& proto) {
   eigenmath::Matrix6d out;
+  INTR_RETURN_IF_ERROR(FromProto(proto, &out));
+  return out;
+}
+
+absl::Status FromProto(const intrinsic_proto::icon::Matrix6d& proto,
+                       eigenmath::Matrix6d* matrix) {
   if (proto.data_size() != 36) {
     return absl::InvalidArgumentError(absl::StrCat(
         "Cannot read Matrix6d from proto: expected data size of 36, got ",
@@ -56,32 +78,42 @@ absl::StatusOr<eigenmath::Matrix6d> FromProto(
   }
   for (int i = 0; i < 6; ++i) {
     for (int j = 0; j < 6; ++j) {
-      out(i, j) = proto.data((i * 6) + j);
+      (*matrix)(i, j) = proto.data((i * 6) + j);
     }
   }
-  return out;
+  return absl::OkStatus();
 }
 
 intrinsic_proto::icon::CartVec6 ToProto(const eigenmath::Vector6d& vector) {
   intrinsic_proto::icon::CartVec6 proto;
-  proto.set_x(vector(0));
-  proto.set_y(vector(1));
-  proto.set_z(vector(2));
-  proto.set_rx(vector(3));
-  proto.set_ry(vector(4));
-  proto.set_rz(vector(5));
+  ToProto(vector, &proto);
   return proto;
 }
 
+void ToProto(const eigenmath::Vector6d& vector,
+             intrinsic_proto::icon::CartVec6* proto) {
+  proto->set_x(vector(0));
+  proto->set_y(vector(1));
+  proto->set_z(vector(2));
+  proto->set_rx(vector(3));
+  proto->set_ry(vector(4));
+  proto->set_rz(vector(5));
+}
+
 eigenmath::Vector6d FromProto(const intrinsic_proto::icon::CartVec6& proto) {
   eigenmath::Vector6d vector;
-  vector(0) = proto.x();
-  vector(1) = proto.y();
-  vector(2) = proto.z();
-  vector(3) = proto.rx();
-  vector(4) = proto.ry();
-  vector(5) = proto.rz();
+  FromProto(proto, &vector);
   return vector;
 }
 
+void FromProto(const intrinsic_proto::icon::CartVec6& proto,
+               eigenmath::Vector6d* vector) {
+  (*vector)(0) = proto.x();
+  (*vector)(1) = proto.y();
+  (*vector)(2) = proto.z();
+  (*vector)(3) = proto.rx();
+  (*vector)(4) = proto.ry();
+  (*vector)(5) = proto.rz();
+}
+
 }  // namespace intrinsic::icon
@@ -3,6 +3,7 @@
 #ifndef INTRINSIC_ICON_PROTO_EIGEN_CONVERSION_H_
 #define INTRINSIC_ICON_PROTO_EIGEN_CONVERSION_H_
 
+#include <algorithm>
 #include <cstddef>
 #include <string>
 
@@ -10,6 +11,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/types/span.h"
 #include "google/protobuf/repeated_field.h"
 #include "intrinsic/eigenmath/types.h"
 #include "intrinsic/icon/proto/cart_space.pb.h"
@@ -18,8 +20,15 @@
 
 namespace intrinsic::icon {
 
+// The conversions below that take a pointer to their output reuse its storage
+// instead of returning a new object. They do not allocate once the output has
+// reached its size, so that they can convert, e.g., streamed setpoints and
+// status messages every cycle.
+
 // Converts a VectorNd to a JointVec proto.
 intrinsic_proto::icon::JointVec ToJointVecProto(const eigenmath::VectorNd& v);
+void ToJointVecProto(const eigenmath::VectorNd& v,
+                     intrinsic_proto::icon::JointVec* proto);
 
 // Converts a VectorNd to a JointStatePV proto with zero velocities.
 intrinsic_proto::icon::JointStatePV ToJointStatePVProtoWithZeroVel(
@@ -29,15 +38,17 @@ intrinsic_proto::icon::JointStatePV ToJointStatePVProtoWithZeroVel(
 // Returns kInvalidArgument if size does not fit into VectorNd.
 absl::StatusOr<eigenmath::VectorNd> FromProto(
     const intrinsic_proto::icon::JointVec& proto);
+absl::Status FromProto(const intrinsic_proto::icon::JointVec& proto,
+                       eigenmath::VectorNd* v);
 
 namespace details {
 template <typename T>
 void ToRepeatedDouble(const T& values,
                       google::protobuf::RepeatedField<double>* output) {
-  output->Clear();
-  output->Reserve(static_cast<size_t>(values.size()));
+  // Resize() keeps the capacity of `output`.
+  output->Resize(static_cast<int>(values.size()), 0.0);
   for (size_t i = 0; i < static_cast<size_t>(values.size()); ++i) {
-    output->Add(values[i]);
+    output->Set(static_cast<int>(i), values[i]);
   }
 }
 
@@ -53,6 +64,29 @@ T FromRepeatedDouble(const google::protobuf::RepeatedField<double>& values) {
 
 }  // namespace details
 
+// Copies `values` to a proto repeated field double.
+inline void SpanToRepeatedDouble(
+    absl::Span<const double> values,
+    google::protobuf::RepeatedField<double>* output) {
+  output->Resize(static_cast<int>(values.size()), 0.0);
+  std::copy(values.begin(), values.end(), output->mutable_data());
+}
+
+// Copies a proto repeated field double to `output`.
+//
+// Returns InvalidArgumentError if the sizes differ.
+inline absl::Status RepeatedDoubleToSpan(
+    const google::protobuf::RepeatedField<double>& values,
+    absl::Span<double> output) {
+  if (static_cast<size_t>(values.size()) != output.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Cannot copy ", values.size(),
+                     " repeated doubles to a span of size ", output.size()));
+  }
+  std::copy(values.begin(), values.end(), output.begin());
+  return absl::OkStatus();
+}
+
 // Converts a VectorXd to a proto repeated field double.
 inline void VectorXdToRepeatedDouble(
     const eigenmath::VectorXd& values,
@@ -73,6 +107,14 @@ inline eigenmath::VectorXd RepeatedDoubleToVectorXd(
   return details::FromRepeatedDouble<eigenmath::VectorXd>(values);
 }
 
+// Same as above into `output`, which is only reallocated if its size changes.
+inline void RepeatedDoubleToVectorXd(
+    const google::protobuf::RepeatedField<double>& values,
+    eigenmath::VectorXd* output) {
+  output->resize(values.size());
+  std::copy(values.begin(), values.end(), output->data());
+}
+
 // Converts a proto double repeated field to a VectorNd.
 inline absl::StatusOr<eigenmath::VectorNd> RepeatedDoubleToVectorNd(
     const google::protobuf::RepeatedField<double>& values) {
@@ -84,6 +126,20 @@ inline absl::StatusOr<eigenmath::VectorNd> RepeatedDoubleToVectorNd(
   return details::FromRepeatedDouble<eigenmath::VectorNd>(values);
 }
 
+// Same as above into `output`. Leaves `output` unchanged on error.
+inline absl::Status RepeatedDoubleToVectorNd(
+    const google::protobuf::RepeatedField<double>& values,
+    eigenmath::VectorNd* output) {
+  if (values.size() > eigenmath::MAX_EIGEN_VECTOR_SIZE) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Size of values ", values.size(), " is too large, must be less than ",
+        eigenmath::MAX_EIGEN_VECTOR_SIZE, " to convert to VectorNd"));
+  }
+  output->resize(values.size());
+  std::copy(values.begin(), values.end(), output->data());
+  return absl::OkStatus();
+}
+
 // Converts a Vector3d to a proto repeated field of doubles (with 3 elements).
 inline void Vector3dToRepeatedDouble(
     const eigenmath::Vector3d& values,
@@ -106,20 +162,42 @@ inline absl::StatusOr<eigenmath::Vector3d> RepeatedDoubleToVector3d(
   return details::FromRepeatedDouble<eigenmath::Vector3d>(values);
 }
 
+// Same as above into `output`. Leaves `output` unchanged on error.
+inline absl::Status RepeatedDoubleToVector3d(
+    const google::protobuf::RepeatedField<double>& values,
+    eigenmath::Vector3d* output) {
+  if (values.size() != 3) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Cannot convert repeated double field to Vector3d; expected size 3, "
+        "but size is ",
+        values.size(), "; values=[", absl::StrJoin(values, ", "), "]"));
+  }
+  *output = eigenmath::Vector3d(values[0], values[1], values[2]);
+  return absl::OkStatus();
+}
+
 // Converts a 6x6 matrix to a proto.
 intrinsic_proto::icon::Matrix6d ToProto(const eigenmath::Matrix6d& matrix);
+void ToProto(const eigenmath::Matrix6d& matrix,
+             intrinsic_proto::icon::Matrix6d* proto);
 
 // Converts a 6x6 matrix proto to an eigenmath::Matrix6d.
 //
 // Returns InvalidArgumentError if the `data` field does not have 36 elements.
 absl::StatusOr<eigenmath::Matrix6d> FromProto(
     const intrinsic_proto::icon::Matrix6d& proto);
+absl::Status FromProto(const intrinsic_proto::icon::Matrix6d& proto,
+                       eigenmath::Matrix6d* matrix);
 
 // Converts an eigenmath::Vector6d to a CartVec6 proto.
 intrinsic_proto::icon::CartVec6 ToProto(const eigenmath::Vector6d& vector);
+void ToProto(const eigenmath::Vector6d& vector,
+             intrinsic_proto::icon::CartVec6* proto);
 
 // Converts a CartVec6 proto to an eigenmath::Vector6d.
 eigenmath::Vector6d FromProto(const intrinsic_proto::icon::CartVec6& proto);
+void FromProto(const intrinsic_proto::icon::CartVec6& proto,
+               eigenmath::Vector6d* vector);
 
 }  // namespace intrinsic::icon
 
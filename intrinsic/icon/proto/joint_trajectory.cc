@@ -0,0 +1,498 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/proto/joint_trajectory.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "google/protobuf/duration.pb.h"
+#include "google/protobuf/repeated_field.h"
+#include "intrinsic/icon/proto/eigen_conversion.h"
+#include "intrinsic/icon/proto/joint_space.pb.h"
+#include "intrinsic/kinematics/types/dynamic_limits_check_mode.pb.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic {
+
+namespace {
+
+constexpr int64_t kNanosPerSecond = 1'000'000'000;
+// The largest number of seconds of a time stamp that fits into int64
+// nanoseconds together with its nanos.
+constexpr int64_t kMaxSeconds =
+    std::numeric_limits<int64_t>::max() / kNanosPerSecond - 1;
+
+// Header of the format written by ToBytes(). It is followed by int64 time
+// stamps in nanoseconds and column-major double matrices for position and,
+// if flagged, velocity and acceleration.
+struct BytesHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+  int64_t num_joints;
+  int64_t num_states;
+  int32_t joint_dynamic_limits_check_mode;
+  int32_t interpolation_type;
+};
+static_assert(sizeof(BytesHeader) % sizeof(double) == 0);
+
+constexpr char kMagic[8] = {'I', 'N', 'T', 'R', 'J', 'T', 'R', 'J'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kHasVelocity = 1 << 0;
+constexpr uint32_t kHasAcceleration = 1 << 1;
+
+// Byte offsets of the arrays of a trajectory in the format written by
+// ToBytes(). Offsets of missing quantities are 0.
+struct BytesLayout {
+  BytesHeader header;
+  size_t position_offset;
+  size_t velocity_offset;
+  size_t acceleration_offset;
+};
+
+absl::StatusOr<BytesLayout> ParseBytesLayout(absl::string_view bytes) {
+  BytesLayout layout;
+  if (bytes.size() < sizeof(BytesHeader)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Joint trajectory bytes have ", bytes.size(),
+                     " bytes, which is less than the header"));
+  }
+  std::memcpy(&layout.header, bytes.data(), sizeof(BytesHeader));
+  const BytesHeader& header = layout.header;
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    return absl::InvalidArgumentError(
+        "Bytes are not a joint trajectory written by JointTrajectory");
+  }
+  if (header.version != kVersion) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Unsupported joint trajectory version ", header.version,
+        ", expected ", kVersion, " (bytes with a different byte order?)"));
+  }
+  if (header.num_joints < 0 ||
+      header.num_joints > std::numeric_limits<int>::max() ||
+      header.num_states < 0 ||
+      header.num_states > std::numeric_limits<int>::max() ||
+      (header.num_states > 0 && header.num_joints == 0)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Invalid joint trajectory of ", header.num_states, " states with ",
+        header.num_joints, " joints"));
+  }
+  if ((header.flags & ~(kHasVelocity | kHasAcceleration)) != 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unsupported joint trajectory flags ", header.flags));
+  }
+  // Checks with divisions that the arrays fit into `bytes` before computing
+  // their sizes, which a corrupt header could otherwise make overflow.
+  const size_t num_joints = static_cast<size_t>(header.num_joints);
+  const size_t num_states = static_cast<size_t>(header.num_states);
+  const size_t num_matrices = 1 + ((header.flags & kHasVelocity) ? 1 : 0) +
+                              ((header.flags & kHasAcceleration) ? 1 : 0);
+  const size_t payload_size = bytes.size() - sizeof(BytesHeader);
+  if (num_states > payload_size / sizeof(int64_t) ||
+      (num_states > 0 &&
+       num_joints > (payload_size - num_states * sizeof(int64_t)) /
+                        (num_matrices * sizeof(double)) / num_states)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Joint trajectory bytes have ", bytes.size(),
+        " bytes, which is less than the header describes for ",
+        header.num_states, " states with ", header.num_joints, " joints"));
+  }
+  const size_t matrix_size = num_joints * num_states * sizeof(double);
+  size_t offset = sizeof(BytesHeader) + num_states * sizeof(int64_t);
+  layout.position_offset = offset;
+  offset += matrix_size;
+  layout.velocity_offset = 0;
+  if (header.flags & kHasVelocity) {
+    layout.velocity_offset = offset;
+    offset += matrix_size;
+  }
+  layout.acceleration_offset = 0;
+  if (header.flags & kHasAcceleration) {
+    layout.acceleration_offset = offset;
+    offset += matrix_size;
+  }
+  if (offset != bytes.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Joint trajectory bytes have ", bytes.size(),
+                     " bytes, but the header describes ", offset));
+  }
+  return layout;
+}
+
+// Appends the values of `field` of all states to `output`, which must have
+// room for them. Returns the number of values per state, or -1 if the states
+// have none.
+template <typename Field>
+absl::StatusOr<int> AppendStateValues(
+    const google::protobuf::RepeatedPtrField<
+        intrinsic_proto::icon::JointStatePVA>& states,
+    absl::string_view name, Field field, std::vector<double>& output) {
+  if (states.empty() || field(states[0]).empty()) {
+    for (int i = 0; i < states.size(); ++i) {
+      if (!field(states[i]).empty()) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("State ", i, " has ", name,
+                         " values, but the first state has none"));
+      }
+    }
+    return -1;
+  }
+  const int num_values = field(states[0]).size();
+  output.reserve(output.size() + static_cast<size_t>(num_values) *
+                                     static_cast<size_t>(states.size()));
+  for (int i = 0; i < states.size(); ++i) {
+    const google::protobuf::RepeatedField<double>& values = field(states[i]);
+    if (values.size() != num_values) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("State ", i, " has ", values.size(), " ", name,
+                       " values, but the first state has ", num_values));
+    }
+    output.insert(output.end(), values.begin(), values.end());
+  }
+  return num_values;
+}
+
+// Copies column `column` of `matrix` to `output`, or clears `output` if
+// `matrix` is empty.
+void ColumnToRepeatedDouble(const JointTrajectory::ConstMatrixMap& matrix,
+                            int column,
+                            google::protobuf::RepeatedField<double>* output) {
+  if (matrix.size() == 0) {
+    output->Clear();
+    return;
+  }
+  icon::SpanToRepeatedDouble(
+      absl::MakeConstSpan(matrix.col(column).data(), matrix.rows()), output);
+}
+
+// Resizes `field` to `size` elements, keeping existing elements for reuse.
+template <typename T>
+void ResizeRepeatedPtrField(int size,
+                            google::protobuf::RepeatedPtrField<T>* field) {
+  if (field->size() > size) {
+    field->DeleteSubrange(size, field->size() - size);
+  }
+  field->Reserve(size);
+  while (field->size() < size) {
+    field->Add();
+  }
+}
+
+}  // namespace
+
+absl::StatusOr<JointTrajectory> JointTrajectory::FromProto(
+    const intrinsic_proto::icon::JointTrajectoryPVA& proto) {
+  if (proto.state_size() != proto.time_since_start_size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Trajectory has ", proto.state_size(), " states, but ",
+                     proto.time_since_start_size(), " time stamps"));
+  }
+  using State = intrinsic_proto::icon::JointStatePVA;
+  JointTrajectory trajectory;
+  trajectory.joint_dynamic_limits_check_mode_ =
+      proto.joint_dynamic_limits_check_mode();
+  trajectory.interpolation_type_ = proto.interpolation_type();
+  if (proto.state().empty()) {
+    return trajectory;
+  }
+  INTR_ASSIGN_OR_RETURN(
+      trajectory.num_joints_,
+      AppendStateValues(
+          proto.state(), "position",
+          [](const State& state) -> const auto& { return state.position(); },
+          trajectory.position_));
+  if (trajectory.num_joints_ < 0) {
+    return absl::InvalidArgumentError("Trajectory states have no positions");
+  }
+  INTR_ASSIGN_OR_RETURN(
+      const int num_velocities,
+      AppendStateValues(
+          proto.state(), "velocity",
+          [](const State& state) -> const auto& { return state.velocity(); },
+          trajectory.velocity_));
+  INTR_ASSIGN_OR_RETURN(
+      const int num_accelerations,
+      AppendStateValues(proto.state(), "acceleration",
+                        [](const State& state) -> const auto& {
+                          return state.acceleration();
+                        },
+                        trajectory.acceleration_));
+  for (const int num_values : {num_velocities, num_accelerations}) {
+    if (num_values >= 0 && num_values != trajectory.num_joints_) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Trajectory states have ", trajectory.num_joints_,
+          " positions, but ", num_values, " velocities or accelerations"));
+    }
+  }
+  trajectory.has_velocity_ = num_velocities >= 0;
+  trajectory.has_acceleration_ = num_accelerations >= 0;
+
+  trajectory.time_since_start_nanos_.reserve(proto.time_since_start_size());
+  for (const google::protobuf::Duration& time_since_start :
+       proto.time_since_start()) {
+    if (std::abs(time_since_start.seconds()) > kMaxSeconds) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Time stamp of ", time_since_start.seconds(),
+                       " seconds does not fit into int64 nanoseconds"));
+    }
+    trajectory.time_since_start_nanos_.push_back(
+        time_since_start.seconds() * kNanosPerSecond +
+        time_since_start.nanos());
+  }
+  return trajectory;
+}
+
+absl::StatusOr<JointTrajectory> JointTrajectory::FromColumns(
+    int num_joints, std::vector<int64_t> time_since_start_nanos,
+    std::vector<double> position, std::vector<double> velocity,
+    std::vector<double> acceleration,
+    intrinsic_proto::DynamicLimitsCheckMode joint_dynamic_limits_check_mode,
+    intrinsic_proto::icon::JointTrajectoryInterpolationType
+        interpolation_type) {
+  if (num_joints <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Trajectory must have at least one joint, got ",
+                     num_joints));
+  }
+  const size_t num_values =
+      static_cast<size_t>(num_joints) * time_since_start_nanos.size();
+  if (position.size() != num_values ||
+      (!velocity.empty() && velocity.size() != num_values) ||
+      (!acceleration.empty() && acceleration.size() != num_values)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Trajectory of ", time_since_start_nanos.size(), " states with ",
+        num_joints, " joints needs ", num_values,
+        " values per quantity, got ", position.size(), " positions, ",
+        velocity.size(), " velocities and ", acceleration.size(),
+        " accelerations"));
+  }
+  JointTrajectory trajectory;
+  trajectory.num_joints_ = num_joints;
+  trajectory.has_velocity_ = !velocity.empty();
+  trajectory.has_acceleration_ = !acceleration.empty();
+  trajectory.time_since_start_nanos_ = std::move(time_since_start_nanos);
+  trajectory.position_ = std::move(position);
+  trajectory.velocity_ = std::move(velocity);
+  trajectory.acceleration_ = std::move(acceleration);
+  trajectory.joint_dynamic_limits_check_mode_ =
+      joint_dynamic_limits_check_mode;
+  trajectory.interpolation_type_ = interpolation_type;
+  return trajectory;
+}
+
+absl::StatusOr<JointTrajectory> JointTrajectory::FromBytes(
+    absl::string_view bytes) {
+  INTR_ASSIGN_OR_RETURN(const BytesLayout layout, ParseBytesLayout(bytes));
+  const size_t num_states = layout.header.num_states;
+  const size_t num_values = layout.header.num_joints * num_states;
+  auto copy_values = [&](size_t offset, std::vector<double>& output) {
+    output.resize(num_values);
+    std::memcpy(output.data(), bytes.data() + offset,
+                num_values * sizeof(double));
+  };
+  JointTrajectory trajectory;
+  trajectory.num_joints_ = static_cast<int>(layout.header.num_joints);
+  trajectory.time_since_start_nanos_.resize(num_states);
+  std::memcpy(trajectory.time_since_start_nanos_.data(),
+              bytes.data() + sizeof(BytesHeader),
+              num_states * sizeof(int64_t));
+  copy_values(layout.position_offset, trajectory.position_);
+  trajectory.has_velocity_ = layout.velocity_offset != 0;
+  if (trajectory.has_velocity_) {
+    copy_values(layout.velocity_offset, trajectory.velocity_);
+  }
+  trajectory.has_acceleration_ = layout.acceleration_offset != 0;
+  if (trajectory.has_acceleration_) {
+    copy_values(layout.acceleration_offset, trajectory.acceleration_);
+  }
+  trajectory.joint_dynamic_limits_check_mode_ =
+      static_cast<intrinsic_proto::DynamicLimitsCheckMode>(
+          layout.header.joint_dynamic_limits_check_mode);
+  trajectory.interpolation_type_ =
+      static_cast<intrinsic_proto::icon::JointTrajectoryInterpolationType>(
+          layout.header.interpolation_type);
+  return trajectory;
+}
+
+intrinsic_proto::icon::JointTrajectoryPVA JointTrajectory::ToProto() const {
+  intrinsic_proto::icon::JointTrajectoryPVA proto;
+  ToProto(0, size(), &proto);
+  return proto;
+}
+
+void JointTrajectory::ToProto(
+    int begin, int end,
+    intrinsic_proto::icon::JointTrajectoryPVA* proto) const {
+  CHECK(0 <= begin && begin <= end && end <= size())
+      << "Invalid range [" << begin << ", " << end
+      << ") for a trajectory of size " << size();
+  const int num_states = end - begin;
+  ResizeRepeatedPtrField(num_states, proto->mutable_state());
+  ResizeRepeatedPtrField(num_states, proto->mutable_time_since_start());
+  for (int i = 0; i < num_states; ++i) {
+    const int index = begin + i;
+    intrinsic_proto::icon::JointStatePVA& state = *proto->mutable_state(i);
+    ColumnToRepeatedDouble(position(), index, state.mutable_position());
+    ColumnToRepeatedDouble(velocity(), index, state.mutable_velocity());
+    ColumnToRepeatedDouble(acceleration(), index,
+                           state.mutable_acceleration());
+    // Integer division truncates, so seconds and nanos have the same sign
+    // like google.protobuf.Duration requires.
+    google::protobuf::Duration& time_since_start =
+        *proto->mutable_time_since_start(i);
+    time_since_start.set_seconds(time_since_start_nanos_[index] /
+                                 kNanosPerSecond);
+    time_since_start.set_nanos(
+        static_cast<int32_t>(time_since_start_nanos_[index] % kNanosPerSecond));
+  }
+  proto->set_joint_dynamic_limits_check_mode(joint_dynamic_limits_check_mode_);
+  proto->set_interpolation_type(interpolation_type_);
+}
+
+std::string JointTrajectory::ToBytes() const {
+  BytesHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.flags = (has_velocity_ ? kHasVelocity : 0) |
+                 (has_acceleration_ ? kHasAcceleration : 0);
+  header.num_joints = num_joints_;
+  header.num_states = size();
+  header.joint_dynamic_limits_check_mode = joint_dynamic_limits_check_mode_;
+  header.interpolation_type = interpolation_type_;
+
+  std::string bytes;
+  bytes.reserve(sizeof(BytesHeader) +
+                time_since_start_nanos_.size() * sizeof(int64_t) +
+                (position_.size() + velocity_.size() + acceleration_.size()) *
+                    sizeof(double));
+  bytes.append(reinterpret_cast<const char*>(&header), sizeof(BytesHeader));
+  bytes.append(reinterpret_cast<const char*>(time_since_start_nanos_.data()),
+               time_since_start_nanos_.size() * sizeof(int64_t));
+  for (const std::vector<double>* values :
+       {&position_, &velocity_, &acceleration_}) {
+    bytes.append(reinterpret_cast<const char*>(values->data()),
+                 values->size() * sizeof(double));
+  }
+  return bytes;
+}
+
+absl::Status JointTrajectory::Append(
+    const intrinsic_proto::icon::JointTrajectoryPVA& segment) {
+  INTR_ASSIGN_OR_RETURN(const JointTrajectory converted, FromProto(segment));
+  return Append(converted);
+}
+
+absl::Status JointTrajectory::Append(const JointTrajectory& segment) {
+  if (empty()) {
+    *this = segment;
+    return absl::OkStatus();
+  }
+  if (segment.joint_dynamic_limits_check_mode_ !=
+      joint_dynamic_limits_check_mode_) {
+    return absl::InvalidArgumentError(
+        "All trajectory segments should have the same "
+        "dynamic_limits_check_mode.");
+  }
+  if (segment.interpolation_type_ != interpolation_type_) {
+    return absl::InvalidArgumentError(
+        "All trajectory segments should have the same "
+        "interpolation_type.");
+  }
+  if (segment.empty()) {
+    return absl::OkStatus();
+  }
+  if (segment.num_joints_ != num_joints_ ||
+      segment.has_velocity_ != has_velocity_ ||
+      segment.has_acceleration_ != has_acceleration_) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Cannot append a segment with ", segment.num_joints_,
+        " joints to a trajectory with ", num_joints_,
+        " joints, or with different quantities"));
+  }
+  time_since_start_nanos_.insert(time_since_start_nanos_.end(),
+                                 segment.time_since_start_nanos_.begin(),
+                                 segment.time_since_start_nanos_.end());
+  position_.insert(position_.end(), segment.position_.begin(),
+                   segment.position_.end());
+  velocity_.insert(velocity_.end(), segment.velocity_.begin(),
+                   segment.velocity_.end());
+  acceleration_.insert(acceleration_.end(), segment.acceleration_.begin(),
+                       segment.acceleration_.end());
+  return absl::OkStatus();
+}
+
+void JointTrajectory::Reserve(int num_states) {
+  time_since_start_nanos_.reserve(num_states);
+  const size_t num_values = static_cast<size_t>(num_joints_) * num_states;
+  position_.reserve(num_values);
+  if (has_velocity_) {
+    velocity_.reserve(num_values);
+  }
+  if (has_acceleration_) {
+    acceleration_.reserve(num_values);
+  }
+}
+
+absl::StatusOr<MappedJointTrajectory> MappedJointTrajectory::Create(
+    absl::string_view bytes) {
+  if (reinterpret_cast<uintptr_t>(bytes.data()) % alignof(double) != 0) {
+    return absl::InvalidArgumentError(
+        "Joint trajectory bytes must be 8-byte aligned to be mapped");
+  }
+  INTR_ASSIGN_OR_RETURN(const BytesLayout layout, ParseBytesLayout(bytes));
+  auto values_at = [&](size_t offset) -> const double* {
+    return offset == 0
+               ? nullptr
+               : reinterpret_cast<const double*>(bytes.data() + offset);
+  };
+  MappedJointTrajectory trajectory;
+  trajectory.num_joints_ = static_cast<int>(layout.header.num_joints);
+  trajectory.size_ = static_cast<int>(layout.header.num_states);
+  trajectory.time_since_start_nanos_ =
+      reinterpret_cast<const int64_t*>(bytes.data() + sizeof(BytesHeader));
+  trajectory.position_ = values_at(layout.position_offset);
+  trajectory.velocity_ = values_at(layout.velocity_offset);
+  trajectory.acceleration_ = values_at(layout.acceleration_offset);
+  trajectory.joint_dynamic_limits_check_mode_ =
+      static_cast<intrinsic_proto::DynamicLimitsCheckMode>(
+          layout.header.joint_dynamic_limits_check_mode);
+  trajectory.interpolation_type_ =
+      static_cast<intrinsic_proto::icon::JointTrajectoryInterpolationType>(
+          layout.header.interpolation_type);
+  return trajectory;
+}
+
+JointTrajectory MappedJointTrajectory::ToJointTrajectory() const {
+  const size_t num_values = static_cast<size_t>(num_joints_) * size_;
+  JointTrajectory trajectory;
+  trajectory.num_joints_ = num_joints_;
+  trajectory.has_velocity_ = has_velocity();
+  trajectory.has_acceleration_ = has_acceleration();
+  trajectory.time_since_start_nanos_.assign(time_since_start_nanos_,
+                                            time_since_start_nanos_ + size_);
+  trajectory.position_.assign(position_, position_ + num_values);
+  if (has_velocity()) {
+    trajectory.velocity_.assign(velocity_, velocity_ + num_values);
+  }
+  if (has_acceleration()) {
+    trajectory.acceleration_.assign(acceleration_,
+                                    acceleration_ + num_values);
+  }
+  trajectory.joint_dynamic_limits_check_mode_ =
+      joint_dynamic_limits_check_mode_;
+  trajectory.interpolation_type_ = interpolation_type_;
+  return trajectory;
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,224 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_PROTO_JOINT_TRAJECTORY_H_
+#define INTRINSIC_ICON_PROTO_JOINT_TRAJECTORY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Eigen/Core"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "intrinsic/eigenmath/types.h"
+#include "intrinsic/icon/proto/joint_space.pb.h"
+#include "intrinsic/kinematics/types/dynamic_limits_check_mode.pb.h"
+
+namespace intrinsic {
+
+class MappedJointTrajectory;
+
+// A joint trajectory in columnar form: contiguous arrays of time stamps,
+// positions, velocities and accelerations, instead of a message per state like
+// JointTrajectoryPVA. Resampling, limit checks and concatenation run over
+// contiguous memory, and the trajectory takes a fraction of the memory of the
+// proto.
+//
+// Quantities are accessed as matrices with one row per joint and one column
+// per state. Every state has a position. Velocities and accelerations are
+// optional, like in the proto; their matrices are empty if the trajectory does
+// not have them.
+//
+// Convert planning results with FromProto(), e.g.,
+// MotionPlannerClient::PlanTrajectoryResult::trajectory, join segments with
+// Append(), see Session::GetPlannedJointTrajectory(), and stream chunks with
+// TrajectoryView. ToBytes() writes a binary format that MappedJointTrajectory
+// reads in place, e.g., from a memory mapped file.
+class JointTrajectory {
+ public:
+  using ConstMatrixMap = Eigen::Map<const eigenmath::MatrixXd>;
+
+  // An empty trajectory. Its number of joints and the quantities it has are
+  // set by the first Append().
+  JointTrajectory() = default;
+
+  // Copies the states and time stamps of `proto`.
+  //
+  // Returns InvalidArgumentError if the numbers of states and time stamps
+  // differ, if a time stamp does not fit into int64 nanoseconds, or if the
+  // states do not all have positions and the same other quantities, with one
+  // value per joint.
+  static absl::StatusOr<JointTrajectory> FromProto(
+      const intrinsic_proto::icon::JointTrajectoryPVA& proto);
+
+  // Takes over column-major arrays with `num_joints` rows and one column per
+  // time stamp. `velocity` and `acceleration` may be empty if the trajectory
+  // does not have them.
+  //
+  // Returns InvalidArgumentError if `num_joints` is not positive or if the
+  // sizes of the arrays do not match.
+  static absl::StatusOr<JointTrajectory> FromColumns(
+      int num_joints, std::vector<int64_t> time_since_start_nanos,
+      std::vector<double> position, std::vector<double> velocity,
+      std::vector<double> acceleration,
+      intrinsic_proto::DynamicLimitsCheckMode joint_dynamic_limits_check_mode,
+      intrinsic_proto::icon::JointTrajectoryInterpolationType
+          interpolation_type);
+
+  // Reads a trajectory that was written by ToBytes(). `bytes` need not be
+  // aligned.
+  //
+  // Returns InvalidArgumentError if `bytes` is not a valid trajectory.
+  static absl::StatusOr<JointTrajectory> FromBytes(absl::string_view bytes);
+
+  intrinsic_proto::icon::JointTrajectoryPVA ToProto() const;
+
+  // Writes the states [begin, end) and their time stamps into `proto`,
+  // reusing its storage. Time stamps are copied as they are, not shifted to
+  // start at zero, like in SplitTrajectoryProto(). See TrajectoryView for
+  // ranges of states. CHECK-fails unless 0 <= begin <= end <= size().
+  void ToProto(int begin, int end,
+               intrinsic_proto::icon::JointTrajectoryPVA* proto) const;
+
+  // Writes the trajectory in a binary format that is read back by FromBytes()
+  // and MappedJointTrajectory. It is a fixed size header followed by the time
+  // stamps and the matrices, all 8-byte aligned and in native byte order.
+  // Offsets are 64 bits, so unlike a FlatBuffer, which is limited to 2GiB,
+  // it holds logs of any length.
+  std::string ToBytes() const;
+
+  // Appends the states of `segment`. If this trajectory is empty, it takes
+  // over the number of joints, quantities, dynamic limits check mode and
+  // interpolation type of `segment`. Makes the same assumptions about time
+  // stamps as ConcatenateTrajectoryProtos(). Storage grows geometrically, so
+  // appending many segments takes time linear in the total size.
+  //
+  // Returns InvalidArgumentError if `segment` is not a valid trajectory, or if
+  // it differs from this trajectory in any of the properties above; this
+  // trajectory is unchanged then.
+  absl::Status Append(const intrinsic_proto::icon::JointTrajectoryPVA& segment);
+  absl::Status Append(const JointTrajectory& segment);
+
+  // Reserves storage for `num_states` states in total. Only reserves storage
+  // for time stamps before the number of joints is known.
+  void Reserve(int num_states);
+
+  // Returns the number of states.
+  int size() const { return static_cast<int>(time_since_start_nanos_.size()); }
+  bool empty() const { return time_since_start_nanos_.empty(); }
+  int num_joints() const { return num_joints_; }
+  bool has_velocity() const { return has_velocity_; }
+  bool has_acceleration() const { return has_acceleration_; }
+
+  absl::Span<const int64_t> time_since_start_nanos() const {
+    return time_since_start_nanos_;
+  }
+  absl::Duration time_since_start(int index) const {
+    return absl::Nanoseconds(time_since_start_nanos_[index]);
+  }
+
+  ConstMatrixMap position() const { return ToMatrix(position_); }
+  ConstMatrixMap velocity() const { return ToMatrix(velocity_); }
+  ConstMatrixMap acceleration() const { return ToMatrix(acceleration_); }
+
+  intrinsic_proto::DynamicLimitsCheckMode joint_dynamic_limits_check_mode()
+      const {
+    return joint_dynamic_limits_check_mode_;
+  }
+  intrinsic_proto::icon::JointTrajectoryInterpolationType interpolation_type()
+      const {
+    return interpolation_type_;
+  }
+
+ private:
+  friend class MappedJointTrajectory;
+
+  ConstMatrixMap ToMatrix(const std::vector<double>& values) const {
+    return ConstMatrixMap(values.data(), values.empty() ? 0 : num_joints_,
+                          values.empty() ? 0 : size());
+  }
+
+  int num_joints_ = 0;
+  bool has_velocity_ = false;
+  bool has_acceleration_ = false;
+  std::vector<int64_t> time_since_start_nanos_;
+  // Column-major, one column per state.
+  std::vector<double> position_;
+  std::vector<double> velocity_;
+  std::vector<double> acceleration_;
+  intrinsic_proto::DynamicLimitsCheckMode joint_dynamic_limits_check_mode_ =
+      intrinsic_proto::DynamicLimitsCheckMode{};
+  intrinsic_proto::icon::JointTrajectoryInterpolationType interpolation_type_ =
+      intrinsic_proto::icon::INTERPOLATION_TYPE_UNSPECIFIED;
+};
+
+// A trajectory in the format written by JointTrajectory::ToBytes(), read in
+// place without copying. The bytes must outlive this object.
+class MappedJointTrajectory {
+ public:
+  // Returns InvalidArgumentError if `bytes` is not a valid trajectory or not
+  // 8-byte aligned. Memory mapped files are page aligned.
+  static absl::StatusOr<MappedJointTrajectory> Create(absl::string_view bytes);
+
+  int size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  int num_joints() const { return num_joints_; }
+  bool has_velocity() const { return velocity_ != nullptr; }
+  bool has_acceleration() const { return acceleration_ != nullptr; }
+
+  absl::Span<const int64_t> time_since_start_nanos() const {
+    return absl::MakeConstSpan(time_since_start_nanos_, size_);
+  }
+  absl::Duration time_since_start(int index) const {
+    return absl::Nanoseconds(time_since_start_nanos_[index]);
+  }
+
+  JointTrajectory::ConstMatrixMap position() const {
+    return ToMatrix(position_);
+  }
+  JointTrajectory::ConstMatrixMap velocity() const {
+    return ToMatrix(velocity_);
+  }
+  JointTrajectory::ConstMatrixMap acceleration() const {
+    return ToMatrix(acceleration_);
+  }
+
+  intrinsic_proto::DynamicLimitsCheckMode joint_dynamic_limits_check_mode()
+      const {
+    return joint_dynamic_limits_check_mode_;
+  }
+  intrinsic_proto::icon::JointTrajectoryInterpolationType interpolation_type()
+      const {
+    return interpolation_type_;
+  }
+
+  // Copies the trajectory.
+  JointTrajectory ToJointTrajectory() const;
+
+ private:
+  MappedJointTrajectory() = default;
+
+  JointTrajectory::ConstMatrixMap ToMatrix(const double* values) const {
+    return JointTrajectory::ConstMatrixMap(
+        values, values == nullptr ? 0 : num_joints_,
+        values == nullptr ? 0 : size_);
+  }
+
+  int num_joints_ = 0;
+  int size_ = 0;
+  const int64_t* time_since_start_nanos_ = nullptr;
+  const double* position_ = nullptr;
+  const double* velocity_ = nullptr;
+  const double* acceleration_ = nullptr;
+  intrinsic_proto::DynamicLimitsCheckMode joint_dynamic_limits_check_mode_ =
+      intrinsic_proto::DynamicLimitsCheckMode{};
+  intrinsic_proto::icon::JointTrajectoryInterpolationType interpolation_type_ =
+      intrinsic_proto::icon::INTERPOLATION_TYPE_UNSPECIFIED;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_ICON_PROTO_JOINT_TRAJECTORY_H_
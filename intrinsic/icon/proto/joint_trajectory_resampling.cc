@@ -0,0 +1,275 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/proto/joint_trajectory_resampling.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "Eigen/Core"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "intrinsic/eigenmath/types.h"
+#include "intrinsic/icon/proto/joint_trajectory.h"
+#include "intrinsic/util/thread/thread_pool.h"
+
+namespace intrinsic {
+
+namespace {
+
+using Interpolation = ResampleOptions::Interpolation;
+using MatrixMap = Eigen::Map<eigenmath::MatrixXd>;
+
+constexpr double kSecondsPerNano = 1e-9;
+
+// Weights of p0, h * v0, h^2 * a0, h^2 * a1, h * v1 and p1 of a Hermite spline
+// segment of duration h, at normalized time u in [0, 1].
+using Weights = std::array<double, 6>;
+
+// The weights of the position and its first two derivatives with respect to
+// u.
+struct HermiteWeights {
+  Weights position;
+  Weights velocity;
+  Weights acceleration;
+};
+
+HermiteWeights ComputeWeights(Interpolation interpolation, double u) {
+  const double u2 = u * u;
+  const double u3 = u2 * u;
+  if (interpolation == Interpolation::kCubic) {
+    return {
+        .position = {2 * u3 - 3 * u2 + 1, u3 - 2 * u2 + u, 0, 0, u3 - u2,
+                     -2 * u3 + 3 * u2},
+        .velocity = {6 * u2 - 6 * u, 3 * u2 - 4 * u + 1, 0, 0, 3 * u2 - 2 * u,
+                     -6 * u2 + 6 * u},
+        .acceleration = {12 * u - 6, 6 * u - 4, 0, 0, 6 * u - 2, -12 * u + 6},
+    };
+  }
+  const double u4 = u3 * u;
+  const double u5 = u4 * u;
+  return {
+      .position = {1 - 10 * u3 + 15 * u4 - 6 * u5,
+                   u - 6 * u3 + 8 * u4 - 3 * u5,
+                   0.5 * u2 - 1.5 * u3 + 1.5 * u4 - 0.5 * u5,
+                   0.5 * u3 - u4 + 0.5 * u5, -4 * u3 + 7 * u4 - 3 * u5,
+                   10 * u3 - 15 * u4 + 6 * u5},
+      .velocity = {-30 * u2 + 60 * u3 - 30 * u4,
+                   1 - 18 * u2 + 32 * u3 - 15 * u4,
+                   u - 4.5 * u2 + 6 * u3 - 2.5 * u4,
+                   1.5 * u2 - 4 * u3 + 2.5 * u4, -12 * u2 + 28 * u3 - 15 * u4,
+                   30 * u2 - 60 * u3 + 30 * u4},
+      .acceleration = {-60 * u + 180 * u2 - 120 * u3,
+                       -36 * u + 96 * u2 - 60 * u3,
+                       1 - 9 * u + 18 * u2 - 10 * u3, 3 * u - 12 * u2 + 10 * u3,
+                       -24 * u + 84 * u2 - 60 * u3,
+                       60 * u - 180 * u2 + 120 * u3},
+  };
+}
+
+// Everything the jobs share. The jobs write disjoint columns of the outputs.
+struct ResampleContext {
+  Interpolation interpolation;
+  double time_scale;
+  int64_t start_nanos;
+  int64_t period_nanos;
+  // Scaled duration of the trajectory, i.e., the time stamp of the last state
+  // of the result relative to `start_nanos`.
+  int64_t duration_nanos;
+  // Time stamps of the input in seconds relative to `start_nanos`.
+  std::vector<double> knots;
+  JointTrajectory::ConstMatrixMap position;
+  JointTrajectory::ConstMatrixMap velocity;
+  JointTrajectory::ConstMatrixMap acceleration;
+  // Outputs with `size` states.
+  int size;
+  int64_t* time_since_start_nanos_out;
+  double* position_out;
+  double* velocity_out;
+  double* acceleration_out;
+};
+
+// Computes the states [begin, end) of the result.
+void ResampleRange(const ResampleContext& context, int begin, int end) {
+  const int last_segment = static_cast<int>(context.knots.size()) - 2;
+  const double end_time = context.knots.back();
+  const double s = context.time_scale;
+  const int num_joints = static_cast<int>(context.position.rows());
+  MatrixMap position_out(context.position_out, num_joints, context.size);
+  MatrixMap velocity_out(context.velocity_out, num_joints, context.size);
+  MatrixMap acceleration_out(context.acceleration_out, num_joints,
+                             context.size);
+  int segment = -1;
+  for (int k = begin; k < end; ++k) {
+    const int64_t nanos =
+        std::min(k * context.period_nanos, context.duration_nanos);
+    context.time_since_start_nanos_out[k] = context.start_nanos + nanos;
+    const double time = std::min(nanos * kSecondsPerNano * s, end_time);
+    if (segment < 0) {
+      // Only the first state of a job searches; the others move forward.
+      segment = static_cast<int>(std::upper_bound(context.knots.begin(),
+                                                  context.knots.end(), time) -
+                                 context.knots.begin()) -
+                1;
+      segment = std::clamp(segment, 0, last_segment);
+    }
+    while (segment < last_segment && context.knots[segment + 1] <= time) {
+      ++segment;
+    }
+    const double h = context.knots[segment + 1] - context.knots[segment];
+    const HermiteWeights w =
+        ComputeWeights(context.interpolation,
+                       (time - context.knots[segment]) / h);
+
+    // Weights with respect to the time of the result.
+    const double dt = s / h;
+    const double dt2 = dt * dt;
+    const int i = segment;
+    auto combine = [&](const Weights& weights, double factor, auto out) {
+      out.noalias() = (factor * weights[0]) * context.position.col(i) +
+                      (factor * weights[5]) * context.position.col(i + 1) +
+                      (factor * h * weights[1]) * context.velocity.col(i) +
+                      (factor * h * weights[4]) * context.velocity.col(i + 1);
+      if (context.interpolation == Interpolation::kQuintic) {
+        const double h2 = factor * h * h;
+        out.noalias() += (h2 * weights[2]) * context.acceleration.col(i) +
+                         (h2 * weights[3]) * context.acceleration.col(i + 1);
+      }
+    };
+    combine(w.position, 1.0, position_out.col(k));
+    combine(w.velocity, dt, velocity_out.col(k));
+    combine(w.acceleration, dt2, acceleration_out.col(k));
+  }
+}
+
+}  // namespace
+
+absl::StatusOr<JointTrajectory> ResampleJointTrajectory(
+    const JointTrajectory& trajectory, const ResampleOptions& options) {
+  const int64_t period_nanos = absl::ToInt64Nanoseconds(options.period);
+  if (period_nanos <= 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Resampling period must be positive, got ",
+        absl::FormatDuration(options.period)));
+  }
+  if (!(options.time_scale > 0.0 && std::isfinite(options.time_scale))) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Time scale must be positive and finite, got ", options.time_scale));
+  }
+  if (options.states_per_job <= 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "States per job must be positive, got ", options.states_per_job));
+  }
+  if (trajectory.empty()) {
+    return absl::InvalidArgumentError("Cannot resample an empty trajectory");
+  }
+  if (!trajectory.has_velocity()) {
+    return absl::InvalidArgumentError(
+        "Resampling needs the velocities of the trajectory");
+  }
+  if (options.interpolation == Interpolation::kQuintic &&
+      !trajectory.has_acceleration()) {
+    return absl::InvalidArgumentError(
+        "Quintic resampling needs the accelerations of the trajectory");
+  }
+
+  absl::Span<const int64_t> times = trajectory.time_since_start_nanos();
+  const int64_t start_nanos = times.front();
+  std::vector<double> knots(times.size());
+  for (int i = 0; i < trajectory.size(); ++i) {
+    if (i > 0 && times[i] <= times[i - 1]) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Time stamps must be strictly increasing, but state ", i, " is at ",
+          absl::FormatDuration(trajectory.time_since_start(i)), " after ",
+          absl::FormatDuration(trajectory.time_since_start(i - 1))));
+    }
+    knots[i] = (times[i] - start_nanos) * kSecondsPerNano;
+  }
+
+  const int num_joints = trajectory.num_joints();
+  const double scaled_duration_nanos =
+      std::round(static_cast<double>(times.back() - start_nanos) /
+                 options.time_scale);
+  const double num_periods = std::floor(scaled_duration_nanos / period_nanos);
+  // One state per period and the end, unless it is on a period already.
+  const double num_states = num_periods + 1 +
+                            (num_periods * period_nanos < scaled_duration_nanos
+                                 ? 1
+                                 : 0);
+  if (num_states * num_joints > std::numeric_limits<int>::max()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Resampling at ", absl::FormatDuration(options.period),
+                     " would result in ", num_states, " states"));
+  }
+  const int size = static_cast<int>(num_states);
+
+  std::vector<int64_t> time_since_start_nanos(size);
+  const size_t num_values = static_cast<size_t>(num_joints) * size;
+  std::vector<double> position(num_values);
+  std::vector<double> velocity(num_values);
+  std::vector<double> acceleration(num_values);
+  if (trajectory.size() == 1) {
+    // Nothing to interpolate.
+    time_since_start_nanos[0] = start_nanos;
+    MatrixMap(velocity.data(), num_joints, 1) =
+        options.time_scale * trajectory.velocity();
+    MatrixMap(position.data(), num_joints, 1) = trajectory.position();
+    if (trajectory.has_acceleration()) {
+      MatrixMap(acceleration.data(), num_joints, 1) =
+          options.time_scale * options.time_scale * trajectory.acceleration();
+    }
+  } else {
+    const ResampleContext context = {
+        .interpolation = options.interpolation,
+        .time_scale = options.time_scale,
+        .start_nanos = start_nanos,
+        .period_nanos = period_nanos,
+        .duration_nanos = static_cast<int64_t>(scaled_duration_nanos),
+        .knots = std::move(knots),
+        .position = trajectory.position(),
+        .velocity = trajectory.velocity(),
+        .acceleration = trajectory.acceleration(),
+        .size = size,
+        .time_since_start_nanos_out = time_since_start_nanos.data(),
+        .position_out = position.data(),
+        .velocity_out = velocity.data(),
+        .acceleration_out = acceleration.data(),
+    };
+    const int num_jobs =
+        options.thread_pool == nullptr
+            ? 1
+            : (size + options.states_per_job - 1) / options.states_per_job;
+    absl::BlockingCounter pending(num_jobs - 1);
+    for (int job = 0; job + 1 < num_jobs; ++job) {
+      const int begin = job * options.states_per_job;
+      const int end = begin + options.states_per_job;
+      auto run = [&context, &pending, begin, end] {
+        ResampleRange(context, begin, end);
+        pending.DecrementCount();
+      };
+      if (!options.thread_pool->TrySubmit(run)) {
+        run();
+      }
+    }
+    // The calling thread computes the last job while the pool runs the
+    // others.
+    ResampleRange(context, (num_jobs - 1) * options.states_per_job, size);
+    pending.Wait();
+  }
+
+  return JointTrajectory::FromColumns(
+      num_joints, std::move(time_since_start_nanos), std::move(position),
+      std::move(velocity), std::move(acceleration),
+      trajectory.joint_dynamic_limits_check_mode(),
+      trajectory.interpolation_type());
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,60 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_PROTO_JOINT_TRAJECTORY_RESAMPLING_H_
+#define INTRINSIC_ICON_PROTO_JOINT_TRAJECTORY_RESAMPLING_H_
+
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/proto/joint_trajectory.h"
+#include "intrinsic/util/thread/thread_pool.h"
+
+namespace intrinsic {
+
+struct ResampleOptions {
+  enum class Interpolation {
+    // Cubic Hermite splines through the positions and velocities of the
+    // states. Accelerations of the result are piecewise linear.
+    kCubic,
+    // Quintic Hermite splines through the positions, velocities and
+    // accelerations of the states.
+    kQuintic,
+  };
+
+  static ResampleOptions Defaults() { return ResampleOptions(); }
+
+  // Time between two states of the result, usually the control period.
+  absl::Duration period = absl::Milliseconds(1);
+  Interpolation interpolation = Interpolation::kCubic;
+  // Speed override. The result moves along the same path `time_scale` times
+  // as fast, i.e., its duration is divided by `time_scale`, velocities are
+  // multiplied by `time_scale` and accelerations by its square.
+  double time_scale = 1.0;
+  // If set, the result is computed in jobs of `states_per_job` states on this
+  // pool. Jobs that do not fit into the pool run on the calling thread.
+  ThreadPool* thread_pool = nullptr;
+  int states_per_job = 4096;
+};
+
+// Resamples `trajectory` at a fixed period, e.g., to stream planner output to
+// ICON with a StreamWriter or to a trajectory tracking action.
+//
+// The result starts at the first time stamp of `trajectory` and has a state
+// every `options.period` until the (scaled) end of `trajectory`. Its last
+// state is the end of `trajectory`, which is closer than `options.period` to
+// the state before unless the duration is a multiple of the period. The
+// result has positions, velocities and accelerations, and keeps the dynamic
+// limits check mode and interpolation type of `trajectory`.
+//
+// Every state is computed for all joints at once from the two states of
+// `trajectory` around it.
+//
+// Returns InvalidArgumentError if `trajectory` is empty, does not have the
+// quantities `options.interpolation` needs, or its time stamps are not
+// strictly increasing, or if the options are invalid.
+absl::StatusOr<JointTrajectory> ResampleJointTrajectory(
+    const JointTrajectory& trajectory,
+    const ResampleOptions& options = ResampleOptions::Defaults());
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_ICON_PROTO_JOINT_TRAJECTORY_RESAMPLING_H_
@@ -0,0 +1,324 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/proto/joint_trajectory.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/proto/joint_space.pb.h"
+#include "intrinsic/icon/proto/trajectory_view.h"
+#include "intrinsic/kinematics/types/dynamic_limits_check_mode.pb.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic {
+namespace {
+
+using ::intrinsic::testing::EqualsProto;
+using ::intrinsic::testing::StatusIs;
+using ::testing::ElementsAre;
+
+// Byte offsets and size of the header written by ToBytes().
+constexpr size_t kHeaderSize = 40;
+constexpr size_t kFlagsOffset = 12;
+constexpr size_t kNumJointsOffset = 16;
+constexpr size_t kNumStatesOffset = 24;
+
+// Returns a trajectory of `num_states` states of two joints, with velocities
+// and accelerations, that starts at -1.5s to cover negative time stamps.
+intrinsic_proto::icon::JointTrajectoryPVA MakeProto(int num_states) {
+  intrinsic_proto::icon::JointTrajectoryPVA proto;
+  for (int i = 0; i < num_states; ++i) {
+    intrinsic_proto::icon::JointStatePVA* state = proto.add_state();
+    state->add_position(i);
+    state->add_position(-i);
+    state->add_velocity(0.5 * i);
+    state->add_velocity(-0.5 * i);
+    state->add_acceleration(0.25 * i);
+    state->add_acceleration(-0.25 * i);
+    const int64_t nanos = -1'500'000'000 + int64_t{i} * 700'000'000;
+    proto.add_time_since_start()->set_seconds(nanos / 1'000'000'000);
+    proto.mutable_time_since_start(i)->set_nanos(nanos % 1'000'000'000);
+  }
+  proto.set_joint_dynamic_limits_check_mode(
+      intrinsic_proto::DYNAMIC_LIMITS_CHECK_MODE_CHECK_NONE);
+  proto.set_interpolation_type(
+      intrinsic_proto::icon::INTERPOLATION_TYPE_CUBIC_POLYNOMIAL);
+  return proto;
+}
+
+// Copies `bytes` into 8-byte aligned storage.
+std::vector<int64_t> Aligned(absl::string_view bytes) {
+  std::vector<int64_t> storage((bytes.size() + 7) / 8);
+  std::memcpy(storage.data(), bytes.data(), bytes.size());
+  return storage;
+}
+
+template <typename T>
+void Overwrite(size_t offset, T value, std::string& bytes) {
+  std::memcpy(bytes.data() + offset, &value, sizeof(value));
+}
+
+TEST(JointTrajectoryTest, ProtoRoundTrip) {
+  const intrinsic_proto::icon::JointTrajectoryPVA proto = MakeProto(5);
+  ASSERT_OK_AND_ASSIGN(const JointTrajectory trajectory,
+                       JointTrajectory::FromProto(proto));
+  EXPECT_EQ(trajectory.size(), 5);
+  EXPECT_EQ(trajectory.num_joints(), 2);
+  EXPECT_TRUE(trajectory.has_velocity());
+  EXPECT_TRUE(trajectory.has_acceleration());
+  EXPECT_EQ(trajectory.position()(1, 3), -3);
+  EXPECT_EQ(trajectory.time_since_start(0), absl::Milliseconds(-1500));
+  EXPECT_THAT(trajectory.ToProto(), EqualsProto(proto));
+}
+
+TEST(JointTrajectoryTest, ProtoRoundTripWithoutVelocityOrAcceleration) {
+  intrinsic_proto::icon::JointTrajectoryPVA proto = MakeProto(3);
+  for (intrinsic_proto::icon::JointStatePVA& state : *proto.mutable_state()) {
+    state.clear_velocity();
+    state.clear_acceleration();
+  }
+  ASSERT_OK_AND_ASSIGN(const JointTrajectory trajectory,
+                       JointTrajectory::FromProto(proto));
+  EXPECT_FALSE(trajectory.has_velocity());
+  EXPECT_EQ(trajectory.velocity().size(), 0);
+  EXPECT_THAT(trajectory.ToProto(), EqualsProto(proto));
+}
+
+TEST(JointTrajectoryTest, FromProtoRejectsInconsistentStates) {
+  intrinsic_proto::icon::JointTrajectoryPVA missing_time = MakeProto(3);
+  missing_time.mutable_time_since_start()->RemoveLast();
+  EXPECT_THAT(JointTrajectory::FromProto(missing_time),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  intrinsic_proto::icon::JointTrajectoryPVA extra_joint = MakeProto(3);
+  extra_joint.mutable_state(2)->add_position(0);
+  EXPECT_THAT(JointTrajectory::FromProto(extra_joint),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  intrinsic_proto::icon::JointTrajectoryPVA missing_velocity = MakeProto(3);
+  missing_velocity.mutable_state(1)->clear_velocity();
+  EXPECT_THAT(JointTrajectory::FromProto(missing_velocity),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(JointTrajectoryTest, ToProtoRangeWritesTimeStampsAndReusesProto) {
+  const intrinsic_proto::icon::JointTrajectoryPVA proto = MakeProto(6);
+  ASSERT_OK_AND_ASSIGN(const JointTrajectory trajectory,
+                       JointTrajectory::FromProto(proto));
+  intrinsic_proto::icon::JointTrajectoryPVA chunk = MakeProto(4);
+  trajectory.ToProto(2, 5, &chunk);
+  ASSERT_EQ(chunk.state_size(), 3);
+  ASSERT_EQ(chunk.time_since_start_size(), 3);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_THAT(chunk.state(i), EqualsProto(proto.state(2 + i)));
+    EXPECT_THAT(chunk.time_since_start(i),
+                EqualsProto(proto.time_since_start(2 + i)));
+  }
+}
+
+TEST(JointTrajectoryTest, BytesRoundTrip) {
+  ASSERT_OK_AND_ASSIGN(const JointTrajectory trajectory,
+                       JointTrajectory::FromProto(MakeProto(7)));
+  const std::string bytes = trajectory.ToBytes();
+  ASSERT_OK_AND_ASSIGN(const JointTrajectory copy,
+                       JointTrajectory::FromBytes(bytes));
+  EXPECT_THAT(copy.ToProto(), EqualsProto(trajectory.ToProto()));
+}
+
+TEST(JointTrajectoryTest, FromBytesAcceptsUnalignedBytes) {
+  ASSERT_OK_AND_ASSIGN(const JointTrajectory trajectory,
+                       JointTrajectory::FromProto(MakeProto(3)));
+  const std::string bytes = absl::StrCat("x", trajectory.ToBytes());
+  ASSERT_OK_AND_ASSIGN(
+      const JointTrajectory copy,
+      JointTrajectory::FromBytes(absl::string_view(bytes).substr(1)));
+  EXPECT_THAT(copy.ToProto(), EqualsProto(trajectory.ToProto()));
+}
+
+TEST(JointTrajectoryTest, EmptyTrajectoryBytesRoundTrip) {
+  const JointTrajectory trajectory;
+  ASSERT_OK_AND_ASSIGN(const JointTrajectory copy,
+                       JointTrajectory::FromBytes(trajectory.ToBytes()));
+  EXPECT_TRUE(copy.empty());
+}
+
+TEST(MappedJointTrajectoryTest, ReadsBytesInPlace) {
+  ASSERT_OK_AND_ASSIGN(const JointTrajectory trajectory,
+                       JointTrajectory::FromProto(MakeProto(4)));
+  const std::string bytes = trajectory.ToBytes();
+  const std::vector<int64_t> storage = Aligned(bytes);
+  const absl::string_view aligned(reinterpret_cast<const char*>(storage.data()),
+                                  bytes.size());
+  ASSERT_OK_AND_ASSIGN(const MappedJointTrajectory mapped,
+                       MappedJointTrajectory::Create(aligned));
+  EXPECT_EQ(mapped.size(), 4);
+  EXPECT_EQ(mapped.num_joints(), 2);
+  EXPECT_EQ(mapped.position(), trajectory.position());
+  EXPECT_EQ(mapped.velocity(), trajectory.velocity());
+  EXPECT_EQ(mapped.acceleration(), trajectory.acceleration());
+  EXPECT_EQ(mapped.time_since_start_nanos(),
+            trajectory.time_since_start_nanos());
+  EXPECT_EQ(mapped.position().data(),
+            reinterpret_cast<const double*>(aligned.data() + kHeaderSize +
+                                            4 * sizeof(int64_t)));
+  EXPECT_EQ(mapped.interpolation_type(),
+            intrinsic_proto::icon::INTERPOLATION_TYPE_CUBIC_POLYNOMIAL);
+  EXPECT_THAT(mapped.ToJointTrajectory().ToProto(),
+              EqualsProto(trajectory.ToProto()));
+}
+
+TEST(MappedJointTrajectoryTest, RejectsUnalignedBytes) {
+  ASSERT_OK_AND_ASSIGN(const JointTrajectory trajectory,
+                       JointTrajectory::FromProto(MakeProto(2)));
+  const std::string bytes = trajectory.ToBytes();
+  const std::vector<int64_t> storage = Aligned(absl::StrCat("x", bytes));
+  EXPECT_THAT(MappedJointTrajectory::Create(absl::string_view(
+                  reinterpret_cast<const char*>(storage.data()) + 1,
+                  bytes.size())),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(JointTrajectoryTest, FromBytesRejectsTruncatedAndTrailingBytes) {
+  ASSERT_OK_AND_ASSIGN(const JointTrajectory trajectory,
+                       JointTrajectory::FromProto(MakeProto(3)));
+  const std::string bytes = trajectory.ToBytes();
+  for (size_t size = 0; size < bytes.size(); ++size) {
+    EXPECT_THAT(
+        JointTrajectory::FromBytes(absl::string_view(bytes).substr(0, size)),
+        StatusIs(absl::StatusCode::kInvalidArgument))
+        << size;
+  }
+  EXPECT_THAT(JointTrajectory::FromBytes(absl::StrCat(bytes, "12345678")),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(JointTrajectoryTest, FromBytesRejectsCorruptHeaders) {
+  ASSERT_OK_AND_ASSIGN(const JointTrajectory trajectory,
+                       JointTrajectory::FromProto(MakeProto(3)));
+  const std::string bytes = trajectory.ToBytes();
+  struct Corruption {
+    size_t offset;
+    int64_t value;
+  };
+  for (const Corruption& corruption : std::vector<Corruption>{
+           {kNumStatesOffset, 4},
+           {kNumStatesOffset, -1},
+           {kNumStatesOffset, std::numeric_limits<int>::max()},
+           {kNumStatesOffset, std::numeric_limits<int64_t>::max()},
+           {kNumJointsOffset, 3},
+           {kNumJointsOffset, 0},
+           {kNumJointsOffset, -2},
+           // The product of joints and states overflows 64 bits, which must
+           // not wrap around to a size that matches.
+           {kNumJointsOffset, std::numeric_limits<int>::max()},
+       }) {
+    std::string corrupt = bytes;
+    Overwrite(corruption.offset, corruption.value, corrupt);
+    EXPECT_THAT(JointTrajectory::FromBytes(corrupt),
+                StatusIs(absl::StatusCode::kInvalidArgument))
+        << corruption.offset << ": " << corruption.value;
+  }
+  // Both counts at their maximum with all quantities multiply to more than
+  // 2^64 bytes.
+  std::string huge = bytes;
+  Overwrite<int64_t>(kNumJointsOffset, std::numeric_limits<int>::max(), huge);
+  Overwrite<int64_t>(kNumStatesOffset, std::numeric_limits<int>::max(), huge);
+  EXPECT_THAT(JointTrajectory::FromBytes(huge),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  std::string unknown_flag = bytes;
+  Overwrite<uint32_t>(kFlagsOffset, 1 << 7, unknown_flag);
+  EXPECT_THAT(JointTrajectory::FromBytes(unknown_flag),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  std::string wrong_magic = bytes;
+  wrong_magic[0] = 'X';
+  EXPECT_THAT(JointTrajectory::FromBytes(wrong_magic),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(JointTrajectoryTest, FromBytesRejectsSizesThatWrapAround) {
+  // 1263665316 * (1 + 1824726040) = 2^61 + 4, so without overflow checks the
+  // arrays of these counts seem to take 8 * (2^61 + 4) = 32 (mod 2^64) bytes
+  // and fit exactly into 32 bytes after the header.
+  std::string bytes = JointTrajectory().ToBytes();
+  bytes.resize(kHeaderSize + 32);
+  Overwrite<uint32_t>(kFlagsOffset, 0, bytes);
+  Overwrite<int64_t>(kNumJointsOffset, 1824726040, bytes);
+  Overwrite<int64_t>(kNumStatesOffset, 1263665316, bytes);
+  EXPECT_THAT(JointTrajectory::FromBytes(bytes),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  const std::vector<int64_t> storage = Aligned(bytes);
+  EXPECT_THAT(MappedJointTrajectory::Create(absl::string_view(
+                  reinterpret_cast<const char*>(storage.data()),
+                  bytes.size())),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(JointTrajectoryTest, AppendJoinsSegments) {
+  const intrinsic_proto::icon::JointTrajectoryPVA proto = MakeProto(6);
+  intrinsic_proto::icon::JointTrajectoryPVA first = proto;
+  intrinsic_proto::icon::JointTrajectoryPVA second = proto;
+  first.mutable_state()->DeleteSubrange(4, 2);
+  first.mutable_time_since_start()->DeleteSubrange(4, 2);
+  second.mutable_state()->DeleteSubrange(0, 4);
+  second.mutable_time_since_start()->DeleteSubrange(0, 4);
+
+  JointTrajectory trajectory;
+  ASSERT_OK(trajectory.Append(first));
+  ASSERT_OK(trajectory.Append(second));
+  EXPECT_THAT(trajectory.ToProto(), EqualsProto(proto));
+}
+
+TEST(JointTrajectoryTest, AppendRejectsMismatchedSegments) {
+  ASSERT_OK_AND_ASSIGN(JointTrajectory trajectory,
+                       JointTrajectory::FromProto(MakeProto(2)));
+  const intrinsic_proto::icon::JointTrajectoryPVA before =
+      trajectory.ToProto();
+
+  intrinsic_proto::icon::JointTrajectoryPVA other_interpolation = MakeProto(2);
+  other_interpolation.set_interpolation_type(
+      intrinsic_proto::icon::INTERPOLATION_TYPE_UNSPECIFIED);
+  EXPECT_THAT(trajectory.Append(other_interpolation),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  intrinsic_proto::icon::JointTrajectoryPVA other_joints = MakeProto(2);
+  for (intrinsic_proto::icon::JointStatePVA& state :
+       *other_joints.mutable_state()) {
+    state.add_position(0);
+    state.add_velocity(0);
+    state.add_acceleration(0);
+  }
+  EXPECT_THAT(trajectory.Append(other_joints),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(trajectory.ToProto(), EqualsProto(before));
+}
+
+TEST(TrajectoryViewTest, SplitsAndConcatenatesWithoutCopies) {
+  const intrinsic_proto::icon::JointTrajectoryPVA proto = MakeProto(5);
+  ASSERT_OK_AND_ASSIGN(const TrajectoryBuffer buffer,
+                       TrajectoryBuffer::FromProto(proto));
+  ASSERT_OK_AND_ASSIGN(const std::vector<TrajectoryView> chunks,
+                       SplitTrajectoryView(TrajectoryView(buffer), 2));
+  ASSERT_EQ(chunks.size(), 3);
+  EXPECT_EQ(&chunks[2].buffer(), &buffer);
+  EXPECT_THAT(chunks[2].ToProto().time_since_start(),
+              ElementsAre(EqualsProto(proto.time_since_start(4))));
+  ASSERT_OK_AND_ASSIGN(const TrajectoryView whole,
+                       ConcatenateTrajectoryViews(chunks));
+  EXPECT_EQ(whole.size(), 5);
+  EXPECT_THAT(whole.ToProto(), EqualsProto(proto));
+}
+
+}  // namespace
+}  // namespace intrinsic
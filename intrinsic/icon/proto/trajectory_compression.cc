@@ -0,0 +1,389 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/proto/trajectory_compression.h"
+
+#include <zlib.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include "absl/base/casts.h"
+#include "absl/numeric/int128.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/duration.pb.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/repeated_field.h"
+#include "google/protobuf/wire_format_lite.h"
+#include "intrinsic/icon/proto/joint_space.pb.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic {
+
+namespace {
+
+using ::google::protobuf::RepeatedField;
+using ::google::protobuf::internal::WireFormatLite;
+using ::google::protobuf::io::CodedInputStream;
+using ::google::protobuf::io::CodedOutputStream;
+using ::intrinsic_proto::icon::CompressedJointTrajectoryPVA;
+using ::intrinsic_proto::icon::JointStatePVA;
+using ::intrinsic_proto::icon::JointTrajectoryPVA;
+
+constexpr int kMaxVarintBytes = 10;
+constexpr int64_t kNanosPerSecond = 1'000'000'000;
+// Time stamps beyond this many seconds do not fit into int64 nanoseconds.
+constexpr int64_t kMaxSeconds =
+    std::numeric_limits<int64_t>::max() / kNanosPerSecond - 1;
+// Quantized values are at most this large, so that multiplying them back by
+// the tolerance is exact up to rounding.
+constexpr double kMaxQuantized = static_cast<double>(int64_t{1} << 50);
+
+// The position, velocity or acceleration of a state.
+using ChannelFn = const RepeatedField<double>& (JointStatePVA::*)() const;
+using MutableChannelFn = RepeatedField<double>* (JointStatePVA::*)();
+
+struct ChannelField {
+  const char* name;
+  ChannelFn get;
+  MutableChannelFn mutable_get;
+  double TrajectoryCompressionOptions::*tolerance;
+  CompressedJointTrajectoryPVA::Channel* (
+      CompressedJointTrajectoryPVA::*mutable_channel)();
+  bool (CompressedJointTrajectoryPVA::*has_channel)() const;
+  const CompressedJointTrajectoryPVA::Channel& (
+      CompressedJointTrajectoryPVA::*channel)() const;
+};
+
+constexpr ChannelField kChannels[] = {
+    {"position", &JointStatePVA::position, &JointStatePVA::mutable_position,
+     &TrajectoryCompressionOptions::position_tolerance,
+     &CompressedJointTrajectoryPVA::mutable_position,
+     &CompressedJointTrajectoryPVA::has_position,
+     &CompressedJointTrajectoryPVA::position},
+    {"velocity", &JointStatePVA::velocity, &JointStatePVA::mutable_velocity,
+     &TrajectoryCompressionOptions::velocity_tolerance,
+     &CompressedJointTrajectoryPVA::mutable_velocity,
+     &CompressedJointTrajectoryPVA::has_velocity,
+     &CompressedJointTrajectoryPVA::velocity},
+    {"acceleration", &JointStatePVA::acceleration,
+     &JointStatePVA::mutable_acceleration,
+     &TrajectoryCompressionOptions::acceleration_tolerance,
+     &CompressedJointTrajectoryPVA::mutable_acceleration,
+     &CompressedJointTrajectoryPVA::has_acceleration,
+     &CompressedJointTrajectoryPVA::acceleration},
+};
+
+// Writes a time series as the zigzag varints of its delta of deltas. Values
+// are 64-bit patterns and wrap around on overflow, which the decoder undoes.
+class SeriesEncoder {
+ public:
+  explicit SeriesEncoder(std::string* out) : out_(out) {}
+
+  void Add(uint64_t value) {
+    const uint64_t delta = value - previous_;
+    uint8_t bytes[kMaxVarintBytes];
+    const uint8_t* end = CodedOutputStream::WriteVarint64ToArray(
+        WireFormatLite::ZigZagEncode64(
+            absl::bit_cast<int64_t>(delta - previous_delta_)),
+        bytes);
+    out_->append(reinterpret_cast<const char*>(bytes), end - bytes);
+    previous_delta_ = first_ ? 0 : delta;
+    previous_ = value;
+    first_ = false;
+  }
+
+ private:
+  std::string* out_;
+  bool first_ = true;
+  uint64_t previous_ = 0;
+  uint64_t previous_delta_ = 0;
+};
+
+// Reads a time series written by SeriesEncoder.
+class SeriesDecoder {
+ public:
+  explicit SeriesDecoder(CodedInputStream* input) : input_(input) {}
+
+  absl::StatusOr<uint64_t> Next() {
+    uint64_t zigzag;
+    if (!input_->ReadVarint64(&zigzag)) {
+      return absl::InvalidArgumentError(
+          "Compressed trajectory data is truncated");
+    }
+    const uint64_t delta =
+        absl::bit_cast<uint64_t>(WireFormatLite::ZigZagDecode64(zigzag)) +
+        previous_delta_;
+    previous_ += delta;
+    previous_delta_ = first_ ? 0 : delta;
+    first_ = false;
+    return previous_;
+  }
+
+ private:
+  CodedInputStream* input_;
+  bool first_ = true;
+  uint64_t previous_ = 0;
+  uint64_t previous_delta_ = 0;
+};
+
+absl::StatusOr<int64_t> ToNanos(const google::protobuf::Duration& duration) {
+  if (std::abs(duration.seconds()) > kMaxSeconds ||
+      std::abs(duration.nanos()) >= kNanosPerSecond) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Time stamp out of range: ", duration.seconds(), "s ",
+                     duration.nanos(), "ns"));
+  }
+  return duration.seconds() * kNanosPerSecond + duration.nanos();
+}
+
+absl::Status CheckTolerance(const char* name, double tolerance) {
+  if (!std::isfinite(tolerance) || tolerance < 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        name, " tolerance must be finite and non-negative, got ", tolerance));
+  }
+  return absl::OkStatus();
+}
+
+// Returns the pattern that `value` is stored as with `tolerance`.
+absl::StatusOr<uint64_t> Quantize(double value, double tolerance) {
+  if (tolerance == 0) {
+    return absl::bit_cast<uint64_t>(value);
+  }
+  const double quantized = std::round(value / tolerance);
+  if (!(std::abs(quantized) <= kMaxQuantized)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Cannot quantize ", value, " with tolerance ", tolerance));
+  }
+  return absl::bit_cast<uint64_t>(static_cast<int64_t>(quantized));
+}
+
+double Dequantize(uint64_t pattern, double tolerance) {
+  if (tolerance == 0) {
+    return absl::bit_cast<double>(pattern);
+  }
+  return static_cast<double>(absl::bit_cast<int64_t>(pattern)) * tolerance;
+}
+
+// Checks that all states have `num_values` values in `channel`.
+absl::Status CheckChannelSizes(const JointTrajectoryPVA& trajectory,
+                               const ChannelField& channel, int num_values) {
+  for (int i = 0; i < trajectory.state_size(); ++i) {
+    if (const int size = (trajectory.state(i).*channel.get)().size();
+        size != num_values) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "State ", i, " has ", size, " ", channel.name, " values, expected ",
+          num_values));
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<CompressedJointTrajectoryPVA> CompressTrajectoryProto(
+    const JointTrajectoryPVA& trajectory,
+    const TrajectoryCompressionOptions& options) {
+  for (const ChannelField& channel : kChannels) {
+    INTR_RETURN_IF_ERROR(
+        CheckTolerance(channel.name, options.*channel.tolerance));
+  }
+  if (options.compression != CompressedJointTrajectoryPVA::COMPRESSION_NONE &&
+      options.compression != CompressedJointTrajectoryPVA::COMPRESSION_ZLIB) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unsupported compression ", options.compression));
+  }
+  const int num_states = trajectory.state_size();
+  const int num_joints =
+      num_states == 0 ? 0 : trajectory.state(0).position_size();
+  if (num_states > 0 && num_joints == 0) {
+    return absl::InvalidArgumentError("The states have no positions");
+  }
+
+  CompressedJointTrajectoryPVA compressed;
+  compressed.set_num_states(num_states);
+  compressed.set_num_time_stamps(trajectory.time_since_start_size());
+  compressed.set_num_joints(num_joints);
+  compressed.set_joint_dynamic_limits_check_mode(
+      trajectory.joint_dynamic_limits_check_mode());
+  compressed.set_interpolation_type(trajectory.interpolation_type());
+
+  std::string data;
+  SeriesEncoder time_encoder(&data);
+  for (const google::protobuf::Duration& time : trajectory.time_since_start()) {
+    INTR_ASSIGN_OR_RETURN(const int64_t nanos, ToNanos(time));
+    time_encoder.Add(absl::bit_cast<uint64_t>(nanos));
+  }
+
+  for (const ChannelField& channel : kChannels) {
+    // Velocities and accelerations are optional, but must be present in all
+    // states or none.
+    const int num_values =
+        num_states == 0 ? 0 : (trajectory.state(0).*channel.get)().size();
+    if (num_values != 0 && num_values != num_joints) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("State 0 has ", num_values, " ", channel.name,
+                       " values, expected ", num_joints));
+    }
+    INTR_RETURN_IF_ERROR(CheckChannelSizes(trajectory, channel, num_values));
+    if (num_values == 0) continue;
+    const double tolerance = options.*channel.tolerance;
+    (compressed.*channel.mutable_channel)()->set_tolerance(tolerance);
+    // Series by joint, so that each one is a smooth series over time.
+    for (int joint = 0; joint < num_joints; ++joint) {
+      SeriesEncoder encoder(&data);
+      for (const JointStatePVA& state : trajectory.state()) {
+        INTR_ASSIGN_OR_RETURN(const uint64_t pattern,
+                              Quantize((state.*channel.get)()[joint],
+                                       tolerance));
+        encoder.Add(pattern);
+      }
+    }
+  }
+
+  if (data.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Encoded trajectory exceeds 2GiB (", data.size(),
+        " bytes), split it with SplitTrajectoryProto() first"));
+  }
+  compressed.set_uncompressed_size(data.size());
+  if (options.compression == CompressedJointTrajectoryPVA::COMPRESSION_ZLIB &&
+      !data.empty()) {
+    std::string deflated(compressBound(data.size()), '\0');
+    uLongf deflated_size = deflated.size();
+    if (int ret = compress2(reinterpret_cast<Bytef*>(deflated.data()),
+                            &deflated_size,
+                            reinterpret_cast<const Bytef*>(data.data()),
+                            data.size(), Z_DEFAULT_COMPRESSION);
+        ret != Z_OK) {
+      return absl::InternalError(
+          absl::StrCat("Failed to compress trajectory, zlib error ", ret));
+    }
+    if (deflated_size < data.size()) {
+      deflated.resize(deflated_size);
+      compressed.set_compression(
+          CompressedJointTrajectoryPVA::COMPRESSION_ZLIB);
+      compressed.set_data(std::move(deflated));
+      return compressed;
+    }
+  }
+  compressed.set_data(std::move(data));
+  return compressed;
+}
+
+absl::StatusOr<JointTrajectoryPVA> DecompressTrajectoryProto(
+    const CompressedJointTrajectoryPVA& compressed) {
+  const uint64_t num_states = compressed.num_states();
+  const uint64_t num_joints = compressed.num_joints();
+  uint64_t num_series = 0;
+  for (const ChannelField& channel : kChannels) {
+    if ((compressed.*channel.has_channel)()) {
+      INTR_RETURN_IF_ERROR(CheckTolerance(
+          channel.name, (compressed.*channel.channel)().tolerance()));
+      num_series += num_joints;
+    }
+  }
+  if (num_states > 0 && (!compressed.has_position() || num_joints == 0)) {
+    return absl::InvalidArgumentError(
+        "Compressed trajectory has states without positions");
+  }
+  // Every value takes one to kMaxVarintBytes bytes. Checking the size of the
+  // data against that keeps a malformed message from making this allocate
+  // more than its data describes.
+  const absl::uint128 num_values =
+      absl::uint128(num_series) * num_states + compressed.num_time_stamps();
+  if (num_values > std::numeric_limits<int>::max()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Compressed trajectory has too many values: ", num_states,
+        " states of ", num_joints, " joints"));
+  }
+  if (compressed.uncompressed_size() < num_values ||
+      compressed.uncompressed_size() > num_values * kMaxVarintBytes ||
+      compressed.uncompressed_size() >
+          static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Uncompressed size ", compressed.uncompressed_size(),
+        " does not match ", absl::Uint128Low64(num_values), " values"));
+  }
+
+  std::string inflated;
+  absl::string_view data = compressed.data();
+  switch (compressed.compression()) {
+    case CompressedJointTrajectoryPVA::COMPRESSION_NONE:
+      break;
+    case CompressedJointTrajectoryPVA::COMPRESSION_ZLIB: {
+      inflated.resize(compressed.uncompressed_size());
+      uLongf inflated_size = inflated.size();
+      if (int ret = uncompress(reinterpret_cast<Bytef*>(inflated.data()),
+                               &inflated_size,
+                               reinterpret_cast<const Bytef*>(data.data()),
+                               data.size());
+          ret != Z_OK) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Failed to decompress trajectory, zlib error ", ret));
+      }
+      inflated.resize(inflated_size);
+      data = inflated;
+      break;
+    }
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unsupported compression ", compressed.compression()));
+  }
+  if (data.size() != compressed.uncompressed_size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected ", compressed.uncompressed_size(),
+                     " bytes of trajectory data, got ", data.size()));
+  }
+
+  JointTrajectoryPVA trajectory;
+  trajectory.set_joint_dynamic_limits_check_mode(
+      compressed.joint_dynamic_limits_check_mode());
+  trajectory.set_interpolation_type(compressed.interpolation_type());
+
+  CodedInputStream input(reinterpret_cast<const uint8_t*>(data.data()),
+                         static_cast<int>(data.size()));
+  SeriesDecoder time_decoder(&input);
+  trajectory.mutable_time_since_start()->Reserve(
+      compressed.num_time_stamps());
+  for (uint32_t i = 0; i < compressed.num_time_stamps(); ++i) {
+    INTR_ASSIGN_OR_RETURN(const uint64_t pattern, time_decoder.Next());
+    const int64_t nanos = absl::bit_cast<int64_t>(pattern);
+    google::protobuf::Duration* time = trajectory.add_time_since_start();
+    time->set_seconds(nanos / kNanosPerSecond);
+    time->set_nanos(static_cast<int32_t>(nanos % kNanosPerSecond));
+  }
+
+  trajectory.mutable_state()->Reserve(num_states);
+  for (uint64_t i = 0; i < num_states; ++i) {
+    trajectory.add_state();
+  }
+  for (const ChannelField& channel : kChannels) {
+    if (!(compressed.*channel.has_channel)()) continue;
+    const double tolerance = (compressed.*channel.channel)().tolerance();
+    for (JointStatePVA& state : *trajectory.mutable_state()) {
+      (state.*channel.mutable_get)()->Resize(num_joints, 0.0);
+    }
+    for (uint64_t joint = 0; joint < num_joints; ++joint) {
+      SeriesDecoder decoder(&input);
+      for (JointStatePVA& state : *trajectory.mutable_state()) {
+        INTR_ASSIGN_OR_RETURN(const uint64_t pattern, decoder.Next());
+        (state.*channel.mutable_get)()->Set(joint,
+                                           Dequantize(pattern, tolerance));
+      }
+    }
+  }
+  if (input.CurrentPosition() != static_cast<int>(data.size())) {
+    return absl::InvalidArgumentError(
+        "Compressed trajectory data has trailing bytes");
+  }
+  return trajectory;
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,60 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_PROTO_TRAJECTORY_COMPRESSION_H_
+#define INTRINSIC_ICON_PROTO_TRAJECTORY_COMPRESSION_H_
+
+#include "absl/status/statusor.h"
+#include "intrinsic/icon/proto/joint_space.pb.h"
+
+namespace intrinsic {
+
+// How CompressTrajectoryProto() encodes a trajectory.
+struct TrajectoryCompressionOptions {
+  // Maximum absolute error of each decoded position, velocity and
+  // acceleration, or 0 to store them exactly. A tolerance well below the
+  // resolution of the joint encoders loses no information in practice and
+  // shrinks smooth trajectories far more than exact storage.
+  double position_tolerance = 0;
+  double velocity_tolerance = 0;
+  double acceleration_tolerance = 0;
+  // Compression of the encoded values.
+  intrinsic_proto::icon::CompressedJointTrajectoryPVA::Compression compression =
+      intrinsic_proto::icon::CompressedJointTrajectoryPVA::COMPRESSION_ZLIB;
+};
+
+// Encodes `trajectory` compactly for logging and storage, e.g., of the joint
+// states of a long shift collected into a JointTrajectoryPVA.
+//
+// Time stamps are stored exactly as nanoseconds. Each position, velocity and
+// acceleration of a joint is rounded to a multiple of its tolerance, so it is
+// off by at most half the tolerance, or taken as the bits of the double if
+// the tolerance is 0, which keeps it exact. Each of these time series is
+// stored as its delta of deltas, which is close to zero for a smooth or
+// regularly sampled series, as zigzag varints, one series after the other.
+// The result is then compressed with `options.compression`, unless that does
+// not make it smaller.
+//
+// Returns kInvalidArgument if
+// * a tolerance is negative or not finite,
+// * the states have no positions, do not all have the same number of joints,
+//   or some have velocities or accelerations and others do not,
+// * a value with a nonzero tolerance is not finite or too large to round to
+//   a multiple of it,
+// * a time stamp does not fit into 64 bits of nanoseconds, or
+// * the encoded trajectory exceeds 2GiB.
+absl::StatusOr<intrinsic_proto::icon::CompressedJointTrajectoryPVA>
+CompressTrajectoryProto(
+    const intrinsic_proto::icon::JointTrajectoryPVA& trajectory,
+    const TrajectoryCompressionOptions& options = {});
+
+// Decodes a trajectory encoded with CompressTrajectoryProto(). Values are
+// within the tolerances of `compressed` of the original values.
+//
+// Returns kInvalidArgument if `compressed` is malformed.
+absl::StatusOr<intrinsic_proto::icon::JointTrajectoryPVA>
+DecompressTrajectoryProto(
+    const intrinsic_proto::icon::CompressedJointTrajectoryPVA& compressed);
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_ICON_PROTO_TRAJECTORY_COMPRESSION_H_
@@ -0,0 +1,94 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/proto/trajectory_view.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "intrinsic/icon/proto/joint_space.pb.h"
+#include "intrinsic/icon/proto/joint_trajectory.h"
+
+namespace intrinsic {
+
+TrajectoryView::TrajectoryView(const JointTrajectory& trajectory)
+    : TrajectoryView(trajectory, 0, trajectory.size()) {}
+
+TrajectoryView::TrajectoryView(const JointTrajectory& trajectory, int begin,
+                               int end)
+    : trajectory_(&trajectory), begin_(begin), end_(end) {
+  CHECK(0 <= begin && begin <= end && end <= trajectory.size())
+      << "Invalid range [" << begin << ", " << end
+      << ") for a trajectory of size " << trajectory.size();
+}
+
+TrajectoryView TrajectoryView::Subview(int begin, int end) const {
+  CHECK(0 <= begin && begin <= end && end <= size())
+      << "Invalid range [" << begin << ", " << end
+      << ") for a view of size " << size();
+  return TrajectoryView(*trajectory_, begin_ + begin, begin_ + end);
+}
+
+intrinsic_proto::icon::JointTrajectoryPVA TrajectoryView::ToProto() const {
+  intrinsic_proto::icon::JointTrajectoryPVA proto;
+  ToProto(&proto);
+  return proto;
+}
+
+void TrajectoryView::ToProto(
+    intrinsic_proto::icon::JointTrajectoryPVA* proto) const {
+  trajectory_->ToProto(begin_, end_, proto);
+}
+
+absl::StatusOr<std::vector<TrajectoryView>> SplitTrajectoryView(
+    TrajectoryView trajectory, int max_subtrajectory_length) {
+  if (trajectory.empty()) {
+    return absl::FailedPreconditionError(
+        "Empty trajectory view cannot be split up");
+  }
+  if (max_subtrajectory_length < 1) {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "max_subtrajectory_length must be greater than 0, but got ",
+        max_subtrajectory_length));
+  }
+  std::vector<TrajectoryView> split_trajectories;
+  split_trajectories.reserve(
+      (trajectory.size() + max_subtrajectory_length - 1) /
+      max_subtrajectory_length);
+  for (int begin = 0; begin < trajectory.size();
+       begin += max_subtrajectory_length) {
+    split_trajectories.push_back(trajectory.Subview(
+        begin, std::min(trajectory.size(), begin + max_subtrajectory_length)));
+  }
+  return split_trajectories;
+}
+
+absl::StatusOr<TrajectoryView> ConcatenateTrajectoryViews(
+    absl::Span<const TrajectoryView> trajectory_segments) {
+  if (trajectory_segments.empty()) {
+    return absl::FailedPreconditionError("Span of trajectory views is empty.");
+  }
+  const TrajectoryView& first = trajectory_segments.front();
+  for (int i = 1; i < trajectory_segments.size(); ++i) {
+    const TrajectoryView& segment = trajectory_segments[i];
+    if (&segment.trajectory() != &first.trajectory()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Trajectory view ", i, " refers to a different trajectory than the "
+          "first one; use JointTrajectory::Append() instead."));
+    }
+    if (segment.begin() != trajectory_segments[i - 1].end()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Trajectory view ", i, " starts at state ", segment.begin(),
+          ", but the previous view ends at state ",
+          trajectory_segments[i - 1].end()));
+    }
+  }
+  return TrajectoryView(first.trajectory(), first.begin(),
+                        trajectory_segments.back().end());
+}
+
+}  // namespace intrinsic
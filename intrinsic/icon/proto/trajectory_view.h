@@ -0,0 +1,83 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_PROTO_TRAJECTORY_VIEW_H_
+#define INTRINSIC_ICON_PROTO_TRAJECTORY_VIEW_H_
+
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "intrinsic/icon/proto/joint_space.pb.h"
+#include "intrinsic/icon/proto/joint_trajectory.h"
+
+namespace intrinsic {
+
+// TrajectoryBuffer was merged into JointTrajectory, which holds the same
+// columnar states. Prefer JointTrajectory in new code, and TrajectoryView(
+// trajectory) over TrajectoryBuffer::View().
+using TrajectoryBuffer = JointTrajectory;
+
+// A range of consecutive states [begin, end) of a JointTrajectory. Cheap to
+// copy; does not own the states. The trajectory must outlive the view.
+//
+// Long trajectories are streamed to ICON by splitting a view of a
+// JointTrajectory with SplitTrajectoryView(), and converting each view to a
+// proto only when it is sent. Unlike SplitTrajectoryProto(), this never holds
+// more than one copy of the trajectory plus the chunk in flight.
+class TrajectoryView {
+ public:
+  // A view of all states of `trajectory`.
+  explicit TrajectoryView(const JointTrajectory& trajectory);
+
+  // CHECK-fails unless 0 <= begin <= end <= trajectory.size().
+  TrajectoryView(const JointTrajectory& trajectory, int begin, int end);
+
+  const JointTrajectory& trajectory() const { return *trajectory_; }
+  // Same as trajectory(), for code written against TrajectoryBuffer.
+  const TrajectoryBuffer& buffer() const { return *trajectory_; }
+  int begin() const { return begin_; }
+  int end() const { return end_; }
+  int size() const { return end_ - begin_; }
+  bool empty() const { return begin_ == end_; }
+
+  // Returns the view of the states [begin, end) of this view, with indices
+  // relative to this view. CHECK-fails unless 0 <= begin <= end <= size().
+  TrajectoryView Subview(int begin, int end) const;
+
+  // Serializes the states of this view and their time stamps. Time stamps are
+  // copied as they are, not shifted to start at zero, like in
+  // SplitTrajectoryProto().
+  intrinsic_proto::icon::JointTrajectoryPVA ToProto() const;
+
+  // Same as above into `proto`, reusing its storage. Converting each chunk
+  // into the same proto does not allocate once it has reached the chunk size.
+  void ToProto(intrinsic_proto::icon::JointTrajectoryPVA* proto) const;
+
+ private:
+  const JointTrajectory* trajectory_;
+  int begin_;
+  int end_;
+};
+
+// Same as SplitTrajectoryProto(), but splits `trajectory` into views of at most
+// `max_subtrajectory_length` states without copying any of them.
+//
+// Returns kFailedPrecondition in case of invalid `max_subtrajectory_length` or
+// in case of an empty `trajectory`.
+absl::StatusOr<std::vector<TrajectoryView>> SplitTrajectoryView(
+    TrajectoryView trajectory, int max_subtrajectory_length);
+
+// Same as ConcatenateTrajectoryProtos(), for views. Returns a single view of
+// all states of `trajectory_segments` without copying any of them, which
+// requires the segments to be consecutive ranges of the same trajectory, e.g.,
+// the result of SplitTrajectoryView().
+//
+// Returns kFailedPrecondition if `trajectory_segments` is empty, and
+// kInvalidArgument if the segments are not consecutive ranges of the same
+// trajectory. Use JointTrajectory::Append() to join other trajectories.
+absl::StatusOr<TrajectoryView> ConcatenateTrajectoryViews(
+    absl::Span<const TrajectoryView> trajectory_segments);
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_ICON_PROTO_TRAJECTORY_VIEW_H_
@@ -0,0 +1,172 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/release/file_helpers.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/message_lite.h"
+
+namespace intrinsic {
+
+namespace {
+
+// Closes a file descriptor when going out of scope.
+class FileCloser {
+ public:
+  explicit FileCloser(int fd) : fd_(fd) {}
+  ~FileCloser() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  FileCloser(const FileCloser&) = delete;
+  FileCloser& operator=(const FileCloser&) = delete;
+
+  // Closes the file descriptor now and returns the result of close().
+  int Close() {
+    const int result = close(fd_);
+    fd_ = -1;
+    return result;
+  }
+
+ private:
+  int fd_;
+};
+
+// Creates a temporary file next to `filename`, stores its path in
+// `temp_path` and returns its file descriptor, or -1 with errno set. Unlike
+// mkstemp(), which always uses mode 0600, this leaves the mode to the umask.
+int CreateTempFile(absl::string_view filename, std::string& temp_path) {
+  static std::atomic<uint64_t> next_id = 0;
+  while (true) {
+    temp_path =
+        absl::StrCat(filename, ".tmp.", getpid(), ".", next_id.fetch_add(1));
+    const int fd = open(temp_path.c_str(),
+                        O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+    // A previous process with the same pid may have left the file behind.
+    if (fd >= 0 || errno != EEXIST) {
+      return fd;
+    }
+  }
+}
+
+absl::Status ParseError(absl::string_view filename) {
+  return absl::InvalidArgumentError(
+      absl::StrCat("Unable to parse file '", filename, "'."));
+}
+
+}  // namespace
+
+absl::Status ReadBinaryProto(absl::string_view filename,
+                             google::protobuf::MessageLite& proto) {
+  const std::string path(filename);
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unable to open file '", filename,
+                     "'. Error: ", std::strerror(errno), "."));
+  }
+  FileCloser closer(fd);
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unable to stat file '", filename,
+                     "'. Error: ", std::strerror(errno), "."));
+  }
+  const size_t size = file_stat.st_size;
+  if (!S_ISREG(file_stat.st_mode) || size == 0) {
+    // Empty and special files cannot be mapped.
+    google::protobuf::io::FileInputStream input(fd);
+    if (!proto.ParsePartialFromZeroCopyStream(&input)) {
+      return ParseError(filename);
+    }
+    return absl::OkStatus();
+  }
+
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unable to map file '", filename,
+                     "'. Error: ", std::strerror(errno), "."));
+  }
+  // The file is read front to back once.
+  (void)madvise(data, size, MADV_SEQUENTIAL);
+  bool parsed = false;
+  {
+    google::protobuf::io::ArrayInputStream input(data, size);
+    google::protobuf::io::CodedInputStream coded_input(&input);
+    coded_input.SetTotalBytesLimit(std::numeric_limits<int>::max());
+    parsed = proto.ParsePartialFromCodedStream(&coded_input) &&
+             coded_input.ConsumedEntireMessage();
+  }
+  munmap(data, size);
+  if (!parsed) {
+    return ParseError(filename);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status WriteBinaryProto(absl::string_view filename,
+                              const google::protobuf::MessageLite& proto) {
+  std::string temp_path;
+  const int fd = CreateTempFile(filename, temp_path);
+  if (fd < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unable to open file '", filename,
+                     "'. Error: ", std::strerror(errno), "."));
+  }
+  FileCloser closer(fd);
+
+  bool written = false;
+  {
+    google::protobuf::io::FileOutputStream output(fd);
+    {
+      google::protobuf::io::CodedOutputStream coded_output(&output);
+      coded_output.SetSerializationDeterministic(true);
+      written = proto.SerializePartialToCodedStream(&coded_output) &&
+                !coded_output.HadError();
+    }
+    written = output.Flush() && written;
+  }
+  // Keeps the mode of a file that is replaced.
+  struct stat existing;
+  const bool replaces_file =
+      stat(std::string(filename).c_str(), &existing) == 0;
+  if (!written ||
+      (replaces_file && fchmod(fd, existing.st_mode & 07777) != 0) ||
+      fsync(fd) != 0 || closer.Close() != 0) {
+    const int error = errno;
+    unlink(temp_path.c_str());
+    return absl::InternalError(
+        absl::StrCat("Unable to write file '", filename,
+                     "'. Error: ", std::strerror(error), "."));
+  }
+  if (rename(temp_path.c_str(), std::string(filename).c_str()) != 0) {
+    const int error = errno;
+    unlink(temp_path.c_str());
+    return absl::InternalError(
+        absl::StrCat("Unable to rename '", temp_path, "' to '", filename,
+                     "'. Error: ", std::strerror(error), "."));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace intrinsic
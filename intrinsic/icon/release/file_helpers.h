@@ -3,61 +3,64 @@
 #ifndef INTRINSIC_ICON_RELEASE_FILE_HELPERS_H_
 #define INTRINSIC_ICON_RELEASE_FILE_HELPERS_H_
 
-#include <cerrno>
-#include <cstring>
-#include <fstream>
-#include <ios>
-#include <sstream>
 #include <string>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
-#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
-#include "google/protobuf/io/coded_stream.h"
-#include "google/protobuf/io/zero_copy_stream_impl.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/message_lite.h"
 
 namespace intrinsic {
 
+// Parses the binary proto in the file `filename` into `proto`. The file is
+// memory-mapped and parsed in place, without copying it into a buffer first.
+//
+// Returns InvalidArgumentError if the file cannot be opened or parsed.
+absl::Status ReadBinaryProto(absl::string_view filename,
+                             google::protobuf::MessageLite& proto);
+
+// Serializes `proto` deterministically into the file `filename`. The proto is
+// written to a temporary file in the same directory, which is then renamed to
+// `filename`, so that readers see either the previous or the complete new
+// file, even if the writer crashes. A replaced file keeps its mode, and a new
+// file gets mode 0666 minus the umask.
+//
+// Returns InvalidArgumentError if the temporary file cannot be created, and
+// InternalError if it cannot be written or renamed.
+absl::Status WriteBinaryProto(absl::string_view filename,
+                              const google::protobuf::MessageLite& proto);
+
 // T should be a proto.
 template <typename T>
 absl::StatusOr<T> GetBinaryProto(absl::string_view filename) {
-  std::ifstream ifs(std::string(filename),
-                    std::ios_base::in | std::ios_base::binary);
-  if (!ifs.is_open()) {
-    return absl::InvalidArgumentError(
-        absl::StrCat("Unable to open file '", filename,
-                     "'. Error: ", std::strerror(errno), "."));
-  }
-  std::stringstream ss;
-  ss << ifs.rdbuf();
-
   T proto;
-  bool result = proto.ParsePartialFromString(ss.str());
-  if (!result) {
-    return absl::InvalidArgumentError(
-        absl::StrCat("Unable to parse file '", filename, "'."));
+  absl::Status status = ReadBinaryProto(filename, proto);
+  if (!status.ok()) {
+    return status;
   }
-
   return proto;
 }
 
+// Same as above, but allocates the proto on `arena`, which owns it, e.g., to
+// load a large proto with many submessages faster.
+//
 // T should be a proto.
 template <typename T>
-absl::Status SetBinaryProto(absl::string_view filename, const T& my_proto) {
-  std::ofstream ofs(std::string(filename),
-                    std::ios_base::out | std::ios_base::binary);
-  if (!ofs.is_open()) {
-    return absl::InvalidArgumentError(
-        absl::StrCat("Unable to open file '", filename, "'."));
+absl::StatusOr<T*> GetBinaryProto(absl::string_view filename,
+                                  google::protobuf::Arena* arena) {
+  T* proto = google::protobuf::Arena::Create<T>(arena);
+  absl::Status status = ReadBinaryProto(filename, *proto);
+  if (!status.ok()) {
+    return status;
   }
+  return proto;
+}
 
-  google::protobuf::io::OstreamOutputStream output_stream(&ofs);
-  google::protobuf::io::CodedOutputStream coded_stream(&output_stream);
-  coded_stream.SetSerializationDeterministic(true);
-  my_proto.SerializePartialToCodedStream(&coded_stream);
-
-  return absl::OkStatus();
+// T should be a proto.
+template <typename T>
+absl::Status SetBinaryProto(absl::string_view filename, const T& my_proto) {
+  return WriteBinaryProto(filename, my_proto);
 }
 
 }  // namespace intrinsic
@@ -0,0 +1,81 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/release/file_helpers.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "google/protobuf/wrappers.pb.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic {
+namespace {
+
+using ::intrinsic::testing::StatusIs;
+
+class FileHelpersTest : public ::testing::Test {
+ protected:
+  FileHelpersTest()
+      : path_(absl::StrCat(::testing::TempDir(), "/",
+                           ::testing::UnitTest::GetInstance()
+                               ->current_test_info()
+                               ->name(),
+                           ".binpb")) {}
+
+  void TearDown() override { unlink(path_.c_str()); }
+
+  mode_t ModeOf(const std::string& path) {
+    struct stat st;
+    EXPECT_EQ(stat(path.c_str(), &st), 0);
+    return st.st_mode & 07777;
+  }
+
+  const std::string path_;
+};
+
+TEST_F(FileHelpersTest, WritesAndReadsProto) {
+  google::protobuf::StringValue written;
+  written.set_value("hello");
+  ASSERT_OK(SetBinaryProto(path_, written));
+  ASSERT_OK_AND_ASSIGN(google::protobuf::StringValue read,
+                       GetBinaryProto<google::protobuf::StringValue>(path_));
+  EXPECT_EQ(read.value(), "hello");
+
+  // Replaces the file.
+  written.set_value("world");
+  ASSERT_OK(SetBinaryProto(path_, written));
+  ASSERT_OK_AND_ASSIGN(read,
+                       GetBinaryProto<google::protobuf::StringValue>(path_));
+  EXPECT_EQ(read.value(), "world");
+}
+
+TEST_F(FileHelpersTest, NewFileUsesUmask) {
+  const mode_t old_umask = umask(027);
+  const absl::Status status =
+      SetBinaryProto(path_, google::protobuf::StringValue());
+  umask(old_umask);
+  ASSERT_OK(status);
+  EXPECT_EQ(ModeOf(path_), 0640);
+}
+
+TEST_F(FileHelpersTest, ReplacedFileKeepsMode) {
+  ASSERT_OK(SetBinaryProto(path_, google::protobuf::StringValue()));
+  ASSERT_EQ(chmod(path_.c_str(), 0600), 0);
+  ASSERT_OK(SetBinaryProto(path_, google::protobuf::StringValue()));
+  EXPECT_EQ(ModeOf(path_), 0600);
+}
+
+TEST_F(FileHelpersTest, ReadFailsForMissingFile) {
+  google::protobuf::StringValue proto;
+  EXPECT_THAT(ReadBinaryProto(path_, proto),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace intrinsic
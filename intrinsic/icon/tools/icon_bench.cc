@@ -0,0 +1,313 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+// The `icon_bench` tool measures the latency and throughput of the ICON API.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/actions/cartesian_jogging_info.h"
+#include "intrinsic/icon/cc_client/client.h"
+#include "intrinsic/icon/cc_client/condition.h"
+#include "intrinsic/icon/cc_client/robot_config.h"
+#include "intrinsic/icon/cc_client/session.h"
+#include "intrinsic/icon/common/builtins.h"
+#include "intrinsic/icon/common/id_types.h"
+#include "intrinsic/icon/proto/generic_part_config.pb.h"
+#include "intrinsic/icon/release/portable/init_xfa.h"
+#include "intrinsic/util/grpc/channel.h"
+#include "intrinsic/util/grpc/connection_params.h"
+#include "intrinsic/util/status/status_macros.h"
+
+ABSL_FLAG(std::string, server, "xfa.lan:17080", "Address of the ICON Server");
+
+ABSL_FLAG(
+    std::string, instance, "",
+    "Optional name of the ICON instance. Use this to select a specific ICON "
+    "instance if multiple ones are running behind an ingress server.");
+
+ABSL_FLAG(std::string, part, "arm", "Part to run the benchmarks on");
+
+ABSL_FLAG(int, iterations, 100,
+          "Number of samples of each request/response benchmark");
+
+ABSL_FLAG(absl::Duration, stream_duration, absl::Seconds(5),
+          "How long to write to the stream; if 0: skips the stream benchmark");
+
+ABSL_FLAG(double, stream_rate, 100, "Stream writes per second");
+
+const char* UsageString() {
+  return R"(
+Usage: icon_bench [--server=<addr>] [--instance=<name>] [--part=<part>] [--iterations=<n>] [--stream_duration=<duration>] [--stream_rate=<hz>]
+
+Measures the latency of ICON API calls against a running server or simulator
+and prints percentiles for:
+
+  session_start           Session::Start()
+  add_actions             Session::AddActions() of one action
+  start_actions           Session::StartActions() of one action
+  start_to_callback       From StartActions() until RunWatcherLoop() runs the
+                          callback of a reaction that fires in the first cycle
+  get_latest_output       Session::GetLatestOutput() of an active action
+  stream_write            StreamWriter::Write()
+  stream_write_interval   Time between two consecutive stream writes
+
+The part does not move: the benchmarks use the stop action and Cartesian
+jogging with a zero twist. Still, only run this on a robot that is allowed to
+be controlled.
+
+Example:
+
+  icon_bench --part=arm --iterations=1000
+)";
+}
+
+namespace {
+
+using intrinsic::icon::Action;
+using intrinsic::icon::ActionDescriptor;
+using intrinsic::icon::ActionInstanceId;
+using intrinsic::icon::CartesianJoggingInfo;
+using intrinsic::icon::Channel;
+using intrinsic::icon::Client;
+using intrinsic::icon::ReactionDescriptor;
+using intrinsic::icon::Session;
+
+// Collects the samples of one benchmark and prints their percentiles.
+class Samples {
+ public:
+  explicit Samples(absl::string_view name) : name_(name) {}
+
+  void Record(absl::Duration sample) { samples_.push_back(sample); }
+
+  void Print() {
+    if (samples_.empty()) {
+      std::cout << absl::StrFormat("%-22s no samples\n", name_);
+      return;
+    }
+    std::sort(samples_.begin(), samples_.end());
+    absl::Duration sum = absl::ZeroDuration();
+    for (absl::Duration sample : samples_) {
+      sum += sample;
+    }
+    std::cout << absl::StrFormat(
+        "%-22s n=%-6d mean=%-10s p50=%-10s p90=%-10s p99=%-10s max=%s\n",
+        name_, samples_.size(),
+        Format(sum / static_cast<int64_t>(samples_.size())),
+        Format(Percentile(0.5)), Format(Percentile(0.9)),
+        Format(Percentile(0.99)), Format(samples_.back()));
+  }
+
+ private:
+  // Nearest-rank percentile, `samples_` must be sorted.
+  absl::Duration Percentile(double p) const {
+    size_t rank = static_cast<size_t>(p * samples_.size() + 0.5);
+    rank = std::clamp<size_t>(rank, 1, samples_.size());
+    return samples_[rank - 1];
+  }
+
+  static std::string Format(absl::Duration duration) {
+    return absl::StrFormat("%.3fms", absl::ToDoubleMilliseconds(duration));
+  }
+
+  std::string name_;
+  std::vector<absl::Duration> samples_;
+};
+
+absl::Status BenchmarkSessionStart(std::shared_ptr<Channel> icon_channel,
+                                   absl::string_view part, int iterations) {
+  Samples session_start("session_start");
+  for (int i = 0; i < iterations; ++i) {
+    const absl::Time start = absl::Now();
+    INTR_ASSIGN_OR_RETURN(std::unique_ptr<Session> session,
+                          Session::Start(icon_channel, {std::string(part)}));
+    session_start.Record(absl::Now() - start);
+  }
+  session_start.Print();
+  return absl::OkStatus();
+}
+
+absl::Status BenchmarkActions(Session& session, absl::string_view part,
+                              int iterations) {
+  Samples add_actions("add_actions");
+  Samples start_actions("start_actions");
+  Samples start_to_callback("start_to_callback");
+  Samples get_latest_output("get_latest_output");
+  absl::Status get_latest_output_status;
+  for (int i = 0; i < iterations; ++i) {
+    absl::Time started;
+    bool fired = false;
+    ActionDescriptor stop =
+        ActionDescriptor(intrinsic::icon::kStopAction, ActionInstanceId(i),
+                         part)
+            .WithReaction(
+                ReactionDescriptor(intrinsic::icon::IsGreaterThanOrEqual(
+                                       intrinsic::icon::kActionElapsedTime,
+                                       0.0))
+                    .FireOnce()
+                    .WithWatcherOnCondition([&]() {
+                      start_to_callback.Record(absl::Now() - started);
+                      fired = true;
+                      session.QuitWatcherLoop();
+                    }));
+
+    absl::Time start = absl::Now();
+    INTR_ASSIGN_OR_RETURN(std::vector<Action> actions,
+                          session.AddActions({stop}));
+    add_actions.Record(absl::Now() - start);
+
+    started = absl::Now();
+    INTR_RETURN_IF_ERROR(session.StartActions(actions));
+    start_actions.Record(absl::Now() - started);
+    if (absl::Status status =
+            session.RunWatcherLoop(absl::Now() + absl::Seconds(5));
+        !status.ok() && !absl::IsDeadlineExceeded(status)) {
+      return status;
+    }
+    if (!fired) {
+      return absl::DeadlineExceededError(
+          "The reaction of the stop action did not fire within 5s");
+    }
+
+    start = absl::Now();
+    absl::Status status =
+        session
+            .GetLatestOutput(actions.front().id(),
+                             absl::Now() + absl::Seconds(1))
+            .status();
+    if (status.ok()) {
+      get_latest_output.Record(absl::Now() - start);
+    } else {
+      get_latest_output_status = status;
+    }
+
+    INTR_RETURN_IF_ERROR(session.StopAllActions());
+    INTR_RETURN_IF_ERROR(session.ClearAllActionsAndReactions());
+  }
+  add_actions.Print();
+  start_actions.Print();
+  start_to_callback.Print();
+  get_latest_output.Print();
+  if (!get_latest_output_status.ok()) {
+    // Not every server publishes an output for the stop action.
+    std::cout << "  get_latest_output failed: " << get_latest_output_status
+              << "\n";
+  }
+  return absl::OkStatus();
+}
+
+// `jogging_id` must not be used by any other action of `session`.
+absl::Status BenchmarkStream(Client& client, Session& session,
+                             absl::string_view part,
+                             ActionInstanceId jogging_id,
+                             absl::Duration duration, double rate) {
+  INTR_ASSIGN_OR_RETURN(intrinsic::icon::RobotConfig robot_config,
+                        client.GetConfig());
+  INTR_ASSIGN_OR_RETURN(
+      intrinsic_proto::icon::GenericPartConfig generic_part_config,
+      robot_config.GetGenericPartConfig(part));
+  if (!generic_part_config.cartesian_limits_config()
+           .has_default_cartesian_limits()) {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "Part '", part,
+        "' has no Cartesian limits, which the stream benchmark needs for "
+        "Cartesian jogging. Use --stream_duration=0 to skip it."));
+  }
+  CartesianJoggingInfo::FixedParams fixed_params;
+  *fixed_params.mutable_cartesian_limits() =
+      generic_part_config.cartesian_limits_config().default_cartesian_limits();
+
+  INTR_ASSIGN_OR_RETURN(
+      std::vector<Action> actions,
+      session.AddActions(
+          {ActionDescriptor(CartesianJoggingInfo::kActionTypeName, jogging_id,
+                            part)
+               .WithFixedParams(fixed_params)}));
+  INTR_ASSIGN_OR_RETURN(
+      auto writer,
+      session.StreamWriter<CartesianJoggingInfo::StreamingParams>(
+          actions.front(), CartesianJoggingInfo::kStreamingInputName));
+  INTR_RETURN_IF_ERROR(session.StartActions(actions));
+
+  // A zero twist, so the part holds its position.
+  const CartesianJoggingInfo::StreamingParams zero_twist;
+  Samples stream_write("stream_write");
+  Samples stream_write_interval("stream_write_interval");
+  const absl::Duration period = absl::Seconds(1 / rate);
+  const absl::Time begin = absl::Now();
+  absl::Time next = begin;
+  absl::Time previous = absl::InfinitePast();
+  int64_t writes = 0;
+  while (next < begin + duration) {
+    absl::SleepFor(next - absl::Now());
+    const absl::Time start = absl::Now();
+    INTR_RETURN_IF_ERROR(writer->Write(zero_twist));
+    stream_write.Record(absl::Now() - start);
+    if (previous != absl::InfinitePast()) {
+      stream_write_interval.Record(start - previous);
+    }
+    previous = start;
+    ++writes;
+    next += period;
+  }
+  const absl::Duration elapsed = absl::Now() - begin;
+  INTR_RETURN_IF_ERROR(session.StopAllActions());
+
+  stream_write.Print();
+  stream_write_interval.Print();
+  std::cout << absl::StrFormat(
+      "  %d writes in %s: %.1f writes/s, target %.1f writes/s\n", writes,
+      absl::FormatDuration(elapsed), writes / absl::ToDoubleSeconds(elapsed),
+      rate);
+  return absl::OkStatus();
+}
+
+absl::Status Run(const intrinsic::ConnectionParams& connection_params,
+                 absl::string_view part, int iterations,
+                 absl::Duration stream_duration, double stream_rate) {
+  if (iterations <= 0) {
+    return absl::InvalidArgumentError("--iterations must be positive");
+  }
+  if (stream_rate <= 0) {
+    return absl::InvalidArgumentError("--stream_rate must be positive");
+  }
+  INTR_ASSIGN_OR_RETURN(auto icon_channel, Channel::Make(connection_params));
+  Client client(icon_channel);
+
+  INTR_RETURN_IF_ERROR(BenchmarkSessionStart(icon_channel, part, iterations));
+
+  INTR_ASSIGN_OR_RETURN(std::unique_ptr<Session> session,
+                        Session::Start(icon_channel, {std::string(part)}));
+  INTR_RETURN_IF_ERROR(BenchmarkActions(*session, part, iterations));
+  if (stream_duration > absl::ZeroDuration()) {
+    // BenchmarkActions() used the IDs below `iterations`.
+    INTR_RETURN_IF_ERROR(BenchmarkStream(client, *session, part,
+                                         ActionInstanceId(iterations),
+                                         stream_duration, stream_rate));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  InitXfa(UsageString(), argc, argv);
+  QCHECK_OK(Run(intrinsic::ConnectionParams::ResourceInstance(
+                    absl::GetFlag(FLAGS_instance), absl::GetFlag(FLAGS_server)),
+                absl::GetFlag(FLAGS_part), absl::GetFlag(FLAGS_iterations),
+                absl::GetFlag(FLAGS_stream_duration),
+                absl::GetFlag(FLAGS_stream_rate)));
+  return 0;
+}
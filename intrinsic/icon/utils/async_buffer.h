@@ -3,7 +3,9 @@
 #ifndef INTRINSIC_ICON_UTILS_ASYNC_BUFFER_H_
 #define INTRINSIC_ICON_UTILS_ASYNC_BUFFER_H_
 
+#include <array>
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
@@ -44,6 +46,22 @@ namespace intrinsic {
 // with the mailbox buffer, and returns the new active buffer if the mailbox is
 // full.  In either case, the mailbox is considered to be empty after a call to
 // GetActiveBuffer.
+//
+// Every commit also increments a generation counter, which is stored in the
+// same atomic word as the state. A consumer that only wants to act on new data
+// can keep the generation of the last buffer it processed and call
+// TryGetNewActiveBuffer(), which returns false without modifying the buffer if
+// nothing was committed since:
+// \code
+// uint64_t generation = 0;
+// Buffer* active;
+// if (async.TryGetNewActiveBuffer(&active, &generation)) {
+//   Process(*active);
+// }
+// \endcode
+//
+// See MultiReaderAsyncBuffer for a variant with several consumers, and
+// HistoryBuffer (history_buffer.h) to read any of the last few states.
 template <typename T>
 class AsyncBuffer {
  public:
@@ -62,6 +80,17 @@ class AsyncBuffer {
   // of this call.
   bool GetActiveBuffer(T** buffer);
 
+  // Like GetActiveBuffer(), but only if a buffer with a generation newer than
+  // `*generation` has been committed. In that case, sets `*buffer` to it,
+  // `*generation` to its generation and returns true. Otherwise, returns false
+  // and leaves `*buffer` and `*generation` unchanged; the buffer returned by
+  // the previous call stays valid.
+  //
+  // Generations start at 1 for the first commit, so passing 0 returns any
+  // committed buffer. Checking for new data does not write to the shared state
+  // unless there is new data.
+  bool TryGetNewActiveBuffer(T** buffer, uint64_t* generation);
+
   // Commits the free buffer by swapping it with the mailbox buffer.
   //
   // Each call to this function must be preceded by a call to GetFreeBuffer()
@@ -74,7 +103,9 @@ class AsyncBuffer {
   T* GetFreeBuffer();
 
  private:
-  std::atomic<uint8_t> raw_state_ = 0;
+  // The generation of the latest commit in the upper bits, and the index into
+  // kStateLookupTable in the lowest byte.
+  std::atomic<uint64_t> raw_state_ = 0;
   bool free_buffer_checked_out_ = false;
   // Buffers: active, mailbox, free.
   std::unique_ptr<T> buffers_[3];
@@ -182,47 +213,269 @@ constexpr State kStateLookupTable[] = {
     {.active_buf = 2, .free_buf = 1, .get_active = 1, .commit_free = 11},
     {.active_buf = 2, .free_buf = 0, .get_active = 3, .commit_free = 10}};
 
+// The state word of AsyncBuffer packs the index of the state above and the
+// generation of the latest commit.
+constexpr int kGenerationShift = 8;
+constexpr uint64_t kStateMask = (uint64_t{1} << kGenerationShift) - 1;
+
+constexpr uint8_t StateIndex(uint64_t raw_state) {
+  return raw_state & kStateMask;
+}
+constexpr uint64_t Generation(uint64_t raw_state) {
+  return raw_state >> kGenerationShift;
+}
+constexpr uint64_t RawState(uint64_t generation, uint8_t state_index) {
+  return (generation << kGenerationShift) | state_index;
+}
+
 }  // namespace async_buffer_internal
 
 template <typename T>
 inline T* AsyncBuffer<T>::GetFreeBuffer() {
   using async_buffer_internal::kStateLookupTable;
+  using async_buffer_internal::StateIndex;
   free_buffer_checked_out_ = true;
-  return buffers_[kStateLookupTable[raw_state_.load()].free_buf].get();
+  return buffers_[kStateLookupTable[StateIndex(raw_state_.load())].free_buf]
+      .get();
 }
 
 template <typename T>
 inline bool AsyncBuffer<T>::GetActiveBuffer(T** buffer) {
+  using async_buffer_internal::Generation;
   using async_buffer_internal::kStateLookupTable;
+  using async_buffer_internal::RawState;
+  using async_buffer_internal::StateIndex;
 
-  uint8_t cur_state = raw_state_.load();
-  uint8_t next_state = 0;
+  uint64_t cur_state = raw_state_.load();
+  uint64_t next_state = 0;
   do {
-    next_state = kStateLookupTable[cur_state].get_active;
+    next_state = RawState(Generation(cur_state),
+                          kStateLookupTable[StateIndex(cur_state)].get_active);
   } while (!raw_state_.compare_exchange_strong(cur_state, next_state));
 
-  *buffer = buffers_[kStateLookupTable[next_state].active_buf].get();
+  *buffer =
+      buffers_[kStateLookupTable[StateIndex(next_state)].active_buf].get();
   return next_state != cur_state;
 }
 
+template <typename T>
+inline bool AsyncBuffer<T>::TryGetNewActiveBuffer(T** buffer,
+                                                  uint64_t* generation) {
+  using async_buffer_internal::Generation;
+  using async_buffer_internal::kStateLookupTable;
+  using async_buffer_internal::RawState;
+  using async_buffer_internal::StateIndex;
+
+  uint64_t cur_state = raw_state_.load();
+  uint64_t next_state = 0;
+  do {
+    if (Generation(cur_state) <= *generation) return false;
+    next_state = RawState(Generation(cur_state),
+                          kStateLookupTable[StateIndex(cur_state)].get_active);
+  } while (!raw_state_.compare_exchange_strong(cur_state, next_state));
+
+  *buffer =
+      buffers_[kStateLookupTable[StateIndex(next_state)].active_buf].get();
+  *generation = Generation(next_state);
+  return true;
+}
+
 template <typename T>
 inline bool AsyncBuffer<T>::CommitFreeBuffer() {
+  using async_buffer_internal::Generation;
   using async_buffer_internal::kStateLookupTable;
+  using async_buffer_internal::RawState;
+  using async_buffer_internal::StateIndex;
 
   if (!free_buffer_checked_out_) {
     return false;
   }
 
-  uint8_t cur_state = raw_state_.load();
-  uint8_t next_state = 0;
+  uint64_t cur_state = raw_state_.load();
+  uint64_t next_state = 0;
   do {
-    next_state = kStateLookupTable[cur_state].commit_free;
+    next_state = RawState(Generation(cur_state) + 1,
+                          kStateLookupTable[StateIndex(cur_state)].commit_free);
   } while (!raw_state_.compare_exchange_strong(cur_state, next_state));
 
   free_buffer_checked_out_ = false;
   return true;
 }
 
+// A real time safe producer/consumer buffer container for a single producer
+// and up to `kNumReaders` consumers.
+//
+// Like AsyncBuffer, the producer fills a free buffer and commits it, and each
+// consumer gets the latest committed buffer, which is not modified until that
+// consumer asks for a buffer again. Consumers never wait for each other or for
+// the producer, so several non-realtime consumers can share one realtime
+// producer.
+//
+// Consumers are identified by an index in [0, kNumReaders). Each index must be
+// used by at most one thread at a time.
+//
+// Every consumer holds on to one buffer, one buffer holds the latest commit
+// and the producer needs a further one to fill, so this uses kNumReaders + 2
+// buffers. A consumer announces the buffer it reads in a per-consumer slot and
+// the producer only fills buffers that are neither announced nor the latest.
+//
+// Producer, realtime safe:
+// \code
+// Buffer* free_buff = async.GetFreeBuffer();
+// free_buff->update();
+// async.CommitFreeBuffer();
+// \endcode
+//
+// Consumer `reader`, lock free:
+// \code
+// uint64_t generation = 0;
+// Buffer* active;
+// if (async.TryGetNewActiveBuffer(reader, &active, &generation)) {
+//   Process(*active);
+// }
+// \endcode
+template <typename T, size_t kNumReaders>
+class MultiReaderAsyncBuffer {
+ public:
+  static_assert(kNumReaders > 0, "MultiReaderAsyncBuffer needs a reader");
+  static constexpr size_t kNumBuffers = kNumReaders + 2;
+  static_assert(kNumBuffers <= async_buffer_internal::kStateMask,
+                "Too many readers");
+
+  // Creates a MultiReaderAsyncBuffer with internally allocated storage.
+  template <typename... InitArgs>
+  explicit MultiReaderAsyncBuffer(const InitArgs&... args);
+
+  // Returns the latest committed buffer to consumer `reader`, or a default
+  // buffer if nothing was committed yet. This buffer is guaranteed not to be
+  // modified until the next call to GetActiveBuffer() or
+  // TryGetNewActiveBuffer() by the same consumer. Returns the generation of the
+  // buffer, which is 0 for the default buffer.
+  uint64_t GetActiveBuffer(size_t reader, T** buffer);
+
+  // Like GetActiveBuffer(), but only if a buffer with a generation newer than
+  // `*generation` has been committed. In that case, sets `*buffer` to it,
+  // `*generation` to its generation and returns true. Otherwise, returns false
+  // and leaves `*buffer` and `*generation` unchanged; the buffer returned by
+  // the previous call stays valid.
+  bool TryGetNewActiveBuffer(size_t reader, T** buffer, uint64_t* generation);
+
+  // Makes the latest committed buffer available to all consumers.
+  //
+  // Each call to this function must be preceded by a call to GetFreeBuffer()
+  // or else it has no effect. Returns true if this call was preceded by a call
+  // to GetFreeBuffer(), false otherwise.
+  bool CommitFreeBuffer();
+
+  // Returns a free buffer to the producer. This buffer can be modified until
+  // the producer calls CommitFreeBuffer(). Repeated calls before a commit
+  // return the same buffer.
+  T* GetFreeBuffer();
+
+ private:
+  // Value of a slot in `reading_` while the consumer holds no buffer.
+  static constexpr uint8_t kNoBuffer = kNumBuffers;
+
+  // Announces the latest buffer in the slot of `reader` and returns the state
+  // word it belongs to.
+  uint64_t AcquireLatest(size_t reader);
+
+  // The generation of the latest commit in the upper bits, and the index of
+  // the buffer holding it in the lowest byte.
+  std::atomic<uint64_t> latest_ = 0;
+  // The buffer each consumer reads, or kNoBuffer.
+  std::array<std::atomic<uint8_t>, kNumReaders> reading_;
+  // Only accessed by the producer.
+  uint8_t free_buffer_ = kNoBuffer;
+  std::array<std::unique_ptr<T>, kNumBuffers> buffers_;
+};
+
+template <typename T, size_t kNumReaders>
+template <typename... InitArgs>
+inline MultiReaderAsyncBuffer<T, kNumReaders>::MultiReaderAsyncBuffer(
+    const InitArgs&... args) {
+  for (std::unique_ptr<T>& buf : buffers_) {
+    buf = std::make_unique<T>(args...);
+  }
+  for (std::atomic<uint8_t>& reading : reading_) {
+    reading.store(kNoBuffer, std::memory_order_relaxed);
+  }
+}
+
+template <typename T, size_t kNumReaders>
+inline uint64_t MultiReaderAsyncBuffer<T, kNumReaders>::AcquireLatest(
+    size_t reader) {
+  using async_buffer_internal::StateIndex;
+
+  uint64_t latest = latest_.load();
+  while (true) {
+    reading_[reader].store(StateIndex(latest));
+    // The producer may have picked the buffer to fill before it saw the
+    // announcement. It only does so after committing a newer buffer, so the
+    // announcement holds if the latest buffer did not change in the meantime.
+    // Sequentially consistent ordering makes sure the producer either sees
+    // the announcement or the consumer sees the newer commit.
+    const uint64_t check = latest_.load();
+    if (check == latest) return latest;
+    latest = check;
+  }
+}
+
+template <typename T, size_t kNumReaders>
+inline uint64_t MultiReaderAsyncBuffer<T, kNumReaders>::GetActiveBuffer(
+    size_t reader, T** buffer) {
+  using async_buffer_internal::Generation;
+  using async_buffer_internal::StateIndex;
+
+  const uint64_t latest = AcquireLatest(reader);
+  *buffer = buffers_[StateIndex(latest)].get();
+  return Generation(latest);
+}
+
+template <typename T, size_t kNumReaders>
+inline bool MultiReaderAsyncBuffer<T, kNumReaders>::TryGetNewActiveBuffer(
+    size_t reader, T** buffer, uint64_t* generation) {
+  using async_buffer_internal::Generation;
+
+  if (Generation(latest_.load()) <= *generation) return false;
+  *generation = GetActiveBuffer(reader, buffer);
+  return true;
+}
+
+template <typename T, size_t kNumReaders>
+inline T* MultiReaderAsyncBuffer<T, kNumReaders>::GetFreeBuffer() {
+  using async_buffer_internal::StateIndex;
+
+  if (free_buffer_ == kNoBuffer) {
+    // Only the producer modifies `latest_`, so it cannot change concurrently.
+    std::array<bool, kNumBuffers> in_use = {};
+    in_use[StateIndex(latest_.load(std::memory_order_relaxed))] = true;
+    for (const std::atomic<uint8_t>& reading : reading_) {
+      const uint8_t index = reading.load();
+      if (index != kNoBuffer) in_use[index] = true;
+    }
+    // At most kNumReaders + 1 of the kNumReaders + 2 buffers are in use.
+    free_buffer_ = 0;
+    while (in_use[free_buffer_]) ++free_buffer_;
+  }
+  return buffers_[free_buffer_].get();
+}
+
+template <typename T, size_t kNumReaders>
+inline bool MultiReaderAsyncBuffer<T, kNumReaders>::CommitFreeBuffer() {
+  using async_buffer_internal::Generation;
+  using async_buffer_internal::RawState;
+
+  if (free_buffer_ == kNoBuffer) {
+    return false;
+  }
+  const uint64_t generation =
+      Generation(latest_.load(std::memory_order_relaxed)) + 1;
+  latest_.store(RawState(generation, free_buffer_));
+  free_buffer_ = kNoBuffer;
+  return true;
+}
+
 }  // namespace intrinsic
 
 #endif  // INTRINSIC_ICON_UTILS_ASYNC_BUFFER_H_
@@ -4,11 +4,14 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <cstdint>
 #include <random>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "intrinsic/icon/release/source_location.h"
+#include "intrinsic/util/thread/thread.h"
 
 namespace intrinsic::icon {
 namespace {
@@ -206,5 +209,98 @@ TEST_F(AsyncBufferTest, ReturnValueSemantics) {
   ASSERT_NE(other_buffer, nullptr);
 }
 
+TEST_F(AsyncBufferTest, TryGetNewActiveBufferReportsGenerations) {
+  AsyncBuffer<Buffer> async;
+  Buffer* active = nullptr;
+  uint64_t generation = 0;
+
+  // Nothing was committed yet.
+  EXPECT_FALSE(async.TryGetNewActiveBuffer(&active, &generation));
+  EXPECT_EQ(active, nullptr);
+  EXPECT_EQ(generation, 0);
+
+  async.GetFreeBuffer()->Fill(1);
+  ASSERT_TRUE(async.CommitFreeBuffer());
+  ASSERT_TRUE(async.TryGetNewActiveBuffer(&active, &generation));
+  EXPECT_EQ(generation, 1);
+  active->Check(1);
+
+  // No new commit, so the previous buffer stays active.
+  Buffer* unchanged = active;
+  EXPECT_FALSE(async.TryGetNewActiveBuffer(&active, &generation));
+  EXPECT_EQ(active, unchanged);
+  EXPECT_EQ(generation, 1);
+
+  // Only the latest of several commits is returned.
+  for (uint32_t i = 2; i <= 4; ++i) {
+    async.GetFreeBuffer()->Fill(i);
+    ASSERT_TRUE(async.CommitFreeBuffer());
+  }
+  ASSERT_TRUE(async.TryGetNewActiveBuffer(&active, &generation));
+  EXPECT_EQ(generation, 4);
+  active->Check(4);
+}
+
+TEST_F(AsyncBufferTest, MultiReaderReadersSeeLatestCommit) {
+  MultiReaderAsyncBuffer<Buffer, 2> async;
+  Buffer* reader0 = nullptr;
+  Buffer* reader1 = nullptr;
+  uint64_t generation0 = 0;
+  uint64_t generation1 = 0;
+
+  EXPECT_EQ(async.GetActiveBuffer(0, &reader0), 0);
+  reader0->Check(0);
+
+  async.GetFreeBuffer()->Fill(1);
+  ASSERT_TRUE(async.CommitFreeBuffer());
+  ASSERT_TRUE(async.TryGetNewActiveBuffer(0, &reader0, &generation0));
+  EXPECT_EQ(generation0, 1);
+
+  // Reader 0 keeps generation 1 while the producer moves on.
+  for (uint32_t i = 2; i <= 5; ++i) {
+    async.GetFreeBuffer()->Fill(i);
+    ASSERT_TRUE(async.CommitFreeBuffer());
+    reader0->Check(1);
+  }
+  ASSERT_TRUE(async.TryGetNewActiveBuffer(1, &reader1, &generation1));
+  EXPECT_EQ(generation1, 5);
+  reader1->Check(5);
+  EXPECT_FALSE(async.TryGetNewActiveBuffer(1, &reader1, &generation1));
+  reader0->Check(1);
+
+  ASSERT_TRUE(async.TryGetNewActiveBuffer(0, &reader0, &generation0));
+  EXPECT_EQ(generation0, 5);
+  EXPECT_FALSE(async.CommitFreeBuffer());
+}
+
+TEST_F(AsyncBufferTest, MultiReaderConcurrentReadersSeeConsistentBuffers) {
+  constexpr int kNumReaders = 3;
+  constexpr uint32_t kNumCommits = 2000;
+  MultiReaderAsyncBuffer<Buffer, kNumReaders> async;
+  std::atomic<bool> done = false;
+
+  std::vector<Thread> readers;
+  for (int r = 0; r < kNumReaders; ++r) {
+    readers.emplace_back([r, &async, &done]() {
+      uint64_t generation = 0;
+      Buffer* active = nullptr;
+      while (!done) {
+        const uint64_t previous = generation;
+        if (async.TryGetNewActiveBuffer(r, &active, &generation)) {
+          ASSERT_GT(generation, previous);
+          // The producer fills generation g with sequence number g.
+          active->Check(generation);
+        }
+      }
+    });
+  }
+  for (uint32_t i = 1; i <= kNumCommits; ++i) {
+    async.GetFreeBuffer()->Fill(i);
+    ASSERT_TRUE(async.CommitFreeBuffer());
+  }
+  done = true;
+  for (Thread& reader : readers) reader.Join();
+}
+
 }  // namespace
 }  // namespace intrinsic::icon
@@ -3,11 +3,22 @@
 #ifndef INTRINSIC_ICON_UTILS_ASYNC_REQUEST_H_
 #define INTRINSIC_ICON_UTILS_ASYNC_REQUEST_H_
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <utility>
+#include <vector>
 
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "intrinsic/icon/interprocess/binary_futex.h"
 #include "intrinsic/icon/testing/realtime_annotations.h"
 #include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/icon/utils/realtime_status_macro.h"
 #include "intrinsic/platform/common/buffers/rt_promise.h"
 
 namespace intrinsic::icon {
@@ -36,6 +47,14 @@ namespace intrinsic::icon {
 // });
 // INTR_RETURN_IF_ERROR(bool job_result, rt_job_result.Get());
 // rt_thread.Join();
+//
+// To issue many requests without allocating a future for each, take the
+// promise from a PromisePool (see rt_promise_pool.h) instead:
+//
+// PromisePool<bool> pool(/*capacity=*/64);
+// ASSIGN_OR_RETURN(PooledFuture<bool> rt_job_result, pool.Acquire());
+// ASSIGN_OR_RETURN(auto promise, rt_job_result.GetPromise());
+// AsyncRequest<int, bool> request(request_value, std::move(promise));
 template <typename RequestDataType, typename ResponseDataType>
 class AsyncRequest {
  public:
@@ -110,6 +129,230 @@ class AsyncRequest {
   std::optional<RealtimePromise<ResponseDataType>> promise_;
 };
 
+template <typename RequestDataType, typename ResponseDataType>
+class AsyncBatchRequest;
+
+// The responses to an AsyncBatchRequest, owned by the non-rt side that issued
+// it. The rt side fills in all responses and then notifies the completion
+// once, instead of setting one promise per request.
+//
+// The completion must outlive its request. The destructor blocks until the
+// request has been finished or destroyed, so it must not run on an rt thread.
+template <typename ResponseDataType>
+class BatchCompletion {
+ public:
+  BatchCompletion() = default;
+  BatchCompletion(const BatchCompletion&) = delete;
+  BatchCompletion& operator=(const BatchCompletion&) = delete;
+
+  INTRINSIC_NON_REALTIME_ONLY ~BatchCompletion() {
+    if (state_.load(std::memory_order_relaxed) != State::kUnused &&
+        !released_seen_) {
+      // The request must not access this object anymore once it posted.
+      while (!released_.WaitFor(absl::InfiniteDuration()).ok()) {
+      }
+    }
+  }
+
+  // Waits until `deadline` for the request to be finished, and returns the
+  // responses in the order of the requests. Returns ...
+  //   * `DeadlineExceededError` if the request is not finished by `deadline`,
+  //   * `CancelledError` if the completion was cancelled, or the request was
+  //     destroyed without being finished,
+  //   * `FailedPreconditionError` if no request was made for the completion.
+  // Not thread-safe.
+  INTRINSIC_NON_REALTIME_ONLY absl::StatusOr<absl::Span<const ResponseDataType>>
+  WaitUntil(absl::Time deadline) {
+    if (state_.load(std::memory_order_relaxed) == State::kUnused) {
+      return absl::FailedPreconditionError(
+          "No request was made for the completion.");
+    }
+    if (!released_seen_) {
+      INTRINSIC_RT_RETURN_IF_ERROR(released_.WaitUntil(deadline));
+      released_seen_ = true;
+    }
+    if (state_.load(std::memory_order_acquire) != State::kFinished ||
+        IsCancelled()) {
+      return absl::CancelledError("The batch request was cancelled.");
+    }
+    return responses();
+  }
+
+  INTRINSIC_NON_REALTIME_ONLY absl::StatusOr<absl::Span<const ResponseDataType>>
+  WaitFor(absl::Duration timeout) {
+    return WaitUntil(absl::Now() + timeout);
+  }
+
+  // Returns true once the request has been finished, after which
+  // `responses()` may be read. Does not block, for consumers that poll, e.g.
+  // once per cycle on an rt thread.
+  bool Poll() const INTRINSIC_CHECK_REALTIME_SAFE {
+    return state_.load(std::memory_order_acquire) == State::kFinished;
+  }
+
+  // Returns the responses. Must only be called after `Poll()` returned true
+  // or `WaitUntil()` succeeded.
+  absl::Span<const ResponseDataType> responses() const
+      INTRINSIC_CHECK_REALTIME_SAFE {
+    return responses_;
+  }
+
+  // Asks the rt side to skip the remaining requests, see
+  // AsyncBatchRequest::IsCancelled(). The request still has to be finished
+  // or destroyed before the completion can be destroyed.
+  void Cancel() INTRINSIC_CHECK_REALTIME_SAFE {
+    cancelled_.store(true, std::memory_order_relaxed);
+  }
+
+  bool IsCancelled() const INTRINSIC_CHECK_REALTIME_SAFE {
+    return cancelled_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  template <typename, typename>
+  friend class AsyncBatchRequest;
+
+  enum class State : uint8_t { kUnused, kPending, kFinished, kDropped };
+
+  // Called by the request when it is finished or destroyed. The completion
+  // must not be accessed afterwards.
+  icon::RealtimeStatus Release(State state) INTRINSIC_CHECK_REALTIME_SAFE {
+    state_.store(state, std::memory_order_release);
+    return released_.Post();
+  }
+
+  std::vector<ResponseDataType> responses_;
+  std::atomic<State> state_ = State::kUnused;
+  std::atomic<bool> cancelled_ = false;
+  // Posted once by the request when it is finished or destroyed.
+  icon::BinaryFutex released_;
+  // Whether `released_` has been consumed by WaitUntil().
+  bool released_seen_ = false;
+};
+
+// A batch of requests that the rt side answers with one notification. Use
+// this instead of an AsyncRequest per request when issuing many requests at
+// once, e.g. to configure a hardware module at startup, to save a futex round
+// trip per request.
+//
+// Example:
+//
+// BatchCompletion<bool> completion;
+// INTR_ASSIGN_OR_RETURN(auto request,
+//                       (AsyncBatchRequest<Config, bool>::Create(
+//                           std::move(configs), completion)));
+// // Hand `request` over to the rt thread, which does
+// for (size_t i = 0; i < request.size(); ++i) {
+//   (void)request.SetResponse(i, Apply(request.GetRequest(i)));
+// }
+// (void)request.Finish();
+// // Then, on the non-rt side,
+// INTR_ASSIGN_OR_RETURN(absl::Span<const bool> applied,
+//                       completion.WaitFor(absl::Seconds(1)));
+template <typename RequestDataType, typename ResponseDataType>
+class AsyncBatchRequest {
+ public:
+  AsyncBatchRequest() = default;
+  AsyncBatchRequest(const AsyncBatchRequest&) = delete;
+  AsyncBatchRequest& operator=(const AsyncBatchRequest&) = delete;
+  AsyncBatchRequest(AsyncBatchRequest&& other)
+      : requests_(std::move(other.requests_)),
+        completion_(std::exchange(other.completion_, nullptr)) {}
+  AsyncBatchRequest& operator=(AsyncBatchRequest&& other) {
+    if (this != &other) {
+      Drop();
+      requests_ = std::move(other.requests_);
+      completion_ = std::exchange(other.completion_, nullptr);
+    }
+    return *this;
+  }
+  // Use this constructor when no reply is needed.
+  explicit AsyncBatchRequest(std::vector<RequestDataType> requests)
+      : requests_(std::move(requests)) {}
+
+  // Creates a request whose responses are reported through `completion`,
+  // which must outlive the request. Allocates the responses, so that the rt
+  // side does not have to.
+  //
+  // Returns `AlreadyExistsError` if a request was made for `completion`
+  // before.
+  INTRINSIC_NON_REALTIME_ONLY static absl::StatusOr<AsyncBatchRequest> Create(
+      std::vector<RequestDataType> requests,
+      BatchCompletion<ResponseDataType>& completion) {
+    using State = typename BatchCompletion<ResponseDataType>::State;
+    if (completion.state_.load(std::memory_order_relaxed) != State::kUnused) {
+      return absl::AlreadyExistsError(
+          "A request was already made for the completion.");
+    }
+    completion.responses_.resize(requests.size());
+    completion.state_.store(State::kPending, std::memory_order_relaxed);
+    AsyncBatchRequest request(std::move(requests));
+    request.completion_ = &completion;
+    return request;
+  }
+
+  // Reports the request as dropped to the completion, unless it was
+  // finished.
+  ~AsyncBatchRequest() { Drop(); }
+
+  size_t size() const INTRINSIC_CHECK_REALTIME_SAFE { return requests_.size(); }
+
+  const RequestDataType& GetRequest(size_t index) const
+      INTRINSIC_CHECK_REALTIME_SAFE {
+    return requests_[index];
+  }
+  absl::Span<const RequestDataType> GetRequests() const
+      INTRINSIC_CHECK_REALTIME_SAFE {
+    return requests_;
+  }
+
+  // Returns true if the completion has been cancelled up until now.
+  bool IsCancelled() const INTRINSIC_CHECK_REALTIME_SAFE {
+    return completion_ != nullptr && completion_->IsCancelled();
+  }
+
+  // Sets the response to the request at `index`. The non-rt side only sees it
+  // after `Finish()`. Returns an error if `index` is out of range, and OK if
+  // constructed without completion.
+  icon::RealtimeStatus SetResponse(size_t index, ResponseDataType response)
+      INTRINSIC_CHECK_REALTIME_SAFE {
+    if (completion_ == nullptr) {
+      return icon::OkStatus();
+    }
+    if (index >= completion_->responses_.size()) {
+      return icon::OutOfRangeError(icon::RealtimeStatus::StrCat(
+          "Response index ", index, " is out of range for a batch of ",
+          completion_->responses_.size(), " requests."));
+    }
+    completion_->responses_[index] = std::move(response);
+    return icon::OkStatus();
+  }
+
+  // Makes all responses available to the completion and notifies it. The
+  // request must not be used afterwards. Returns OK if constructed without
+  // completion.
+  icon::RealtimeStatus Finish() INTRINSIC_CHECK_REALTIME_SAFE {
+    if (completion_ == nullptr) {
+      return icon::OkStatus();
+    }
+    return std::exchange(completion_, nullptr)
+        ->Release(BatchCompletion<ResponseDataType>::State::kFinished);
+  }
+
+ private:
+  void Drop() {
+    if (completion_ != nullptr) {
+      (void)std::exchange(completion_, nullptr)
+          ->Release(BatchCompletion<ResponseDataType>::State::kDropped);
+    }
+  }
+
+  std::vector<RequestDataType> requests_;
+  // The completion, or nullptr if no reply is needed or the request has been
+  // finished.
+  BatchCompletion<ResponseDataType>* completion_ = nullptr;
+};
+
 }  // namespace intrinsic::icon
 
 #endif  // INTRINSIC_ICON_UTILS_ASYNC_REQUEST_H_
@@ -0,0 +1,89 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/async_request.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::icon {
+namespace {
+
+using ::intrinsic::testing::IsOk;
+using ::intrinsic::testing::StatusIs;
+using ::testing::ElementsAre;
+
+TEST(AsyncBatchRequestTest, CompletesAllResponsesAtOnce) {
+  BatchCompletion<int> completion;
+  absl::StatusOr<AsyncBatchRequest<int, int>> request =
+      AsyncBatchRequest<int, int>::Create({1, 2, 3}, completion);
+  ASSERT_THAT(request.status(), IsOk());
+
+  Thread rt_thread([request = *std::move(request)]() mutable {
+    for (size_t i = 0; i < request.size(); ++i) {
+      ASSERT_THAT(request.SetResponse(i, 10 * request.GetRequest(i)), IsOk());
+    }
+    ASSERT_THAT(request.Finish(), IsOk());
+  });
+  absl::StatusOr<absl::Span<const int>> responses =
+      completion.WaitFor(absl::Seconds(10));
+  ASSERT_THAT(responses.status(), IsOk());
+  EXPECT_THAT(*responses, ElementsAre(10, 20, 30));
+  EXPECT_TRUE(completion.Poll());
+  rt_thread.Join();
+}
+
+TEST(AsyncBatchRequestTest, PollsForCompletion) {
+  BatchCompletion<int> completion;
+  absl::StatusOr<AsyncBatchRequest<int, int>> request =
+      AsyncBatchRequest<int, int>::Create({1}, completion);
+  ASSERT_THAT(request.status(), IsOk());
+  EXPECT_FALSE(completion.Poll());
+  ASSERT_THAT(request->SetResponse(0, 5), IsOk());
+  EXPECT_FALSE(completion.Poll());
+  EXPECT_THAT(request->SetResponse(1, 5),
+              StatusIs(absl::StatusCode::kOutOfRange));
+  ASSERT_THAT(request->Finish(), IsOk());
+  EXPECT_TRUE(completion.Poll());
+  EXPECT_THAT(completion.responses(), ElementsAre(5));
+}
+
+TEST(AsyncBatchRequestTest, DroppedRequestCancelsCompletion) {
+  BatchCompletion<int> completion;
+  {
+    absl::StatusOr<AsyncBatchRequest<int, int>> request =
+        AsyncBatchRequest<int, int>::Create({1, 2}, completion);
+    ASSERT_THAT(request.status(), IsOk());
+    EXPECT_THAT((AsyncBatchRequest<int, int>::Create({3}, completion)).status(),
+                StatusIs(absl::StatusCode::kAlreadyExists));
+  }
+  EXPECT_THAT(completion.WaitFor(absl::Seconds(10)).status(),
+              StatusIs(absl::StatusCode::kCancelled));
+  EXPECT_FALSE(completion.Poll());
+}
+
+TEST(AsyncBatchRequestTest, TimesOutWithoutFinish) {
+  BatchCompletion<int> completion;
+  absl::StatusOr<AsyncBatchRequest<int, int>> request =
+      AsyncBatchRequest<int, int>::Create({1}, completion);
+  ASSERT_THAT(request.status(), IsOk());
+  EXPECT_THAT(completion.WaitFor(absl::Milliseconds(10)).status(),
+              StatusIs(absl::StatusCode::kDeadlineExceeded));
+  completion.Cancel();
+  EXPECT_TRUE(request->IsCancelled());
+  ASSERT_THAT(request->Finish(), IsOk());
+  EXPECT_THAT(completion.WaitFor(absl::Seconds(10)).status(),
+              StatusIs(absl::StatusCode::kCancelled));
+}
+
+}  // namespace
+}  // namespace intrinsic::icon
@@ -0,0 +1,129 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/compact_realtime_status.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "absl/base/attributes.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "intrinsic/icon/utils/realtime_guard.h"
+
+namespace intrinsic {
+namespace icon {
+namespace {
+
+// Sequence numbers must fit into the bits above the code and ring of
+// CompactRealtimeStatus.
+constexpr uint64_t kSequenceMask = (uint64_t{1} << 48) - 1;
+
+struct MessageSlot {
+  // Sequence number of the message in `data`, or 0 while it is written.
+  std::atomic<uint64_t> sequence = 0;
+  size_t size = 0;
+  char data[CompactRealtimeStatus::kMaxMessageLength];
+};
+
+struct MessageRing {
+  std::atomic<bool> in_use = false;
+  // Only accessed by the thread that uses the ring. Starts at 1, since 0
+  // marks a slot that is being written.
+  uint64_t next_sequence = 1;
+  MessageSlot slots[CompactRealtimeStatus::kNumMessageSlots];
+};
+
+// Zero-initialized, so the pages of rings are only touched once used.
+ABSL_CONST_INIT MessageRing s_rings[CompactRealtimeStatus::kMaxThreads];
+
+// Index of the ring of this thread into `s_rings`, or -1.
+thread_local int s_ring_index = -1;
+
+// Returns the ring of this thread, claiming one if needed, or -1 if all rings
+// are in use.
+int ThisThreadsRing() {
+  if (s_ring_index >= 0) {
+    return s_ring_index;
+  }
+  for (size_t i = 0; i < CompactRealtimeStatus::kMaxThreads; ++i) {
+    if (!s_rings[i].in_use.load(std::memory_order_relaxed) &&
+        !s_rings[i].in_use.exchange(true, std::memory_order_acquire)) {
+      s_ring_index = i;
+      return s_ring_index;
+    }
+  }
+  return -1;
+}
+
+// Releases the ring of this thread when the thread exits.
+struct RingReleaser {
+  ~RingReleaser() {
+    if (s_ring_index >= 0) {
+      s_rings[s_ring_index].in_use.store(false, std::memory_order_release);
+      s_ring_index = -1;
+    }
+  }
+};
+
+}  // namespace
+
+CompactRealtimeStatus::CompactRealtimeStatus(absl::StatusCode code,
+                                             absl::string_view message) {
+  if (code == absl::StatusCode::kOk) {
+    return;
+  }
+  rep_ = static_cast<uint64_t>(code) & kCodeMask;
+  const int ring_index = message.empty() ? -1 : ThisThreadsRing();
+  if (ring_index < 0) {
+    rep_ |= kNoRing << kRingShift;
+    return;
+  }
+  MessageRing& ring = s_rings[ring_index];
+  uint64_t sequence = ring.next_sequence;
+  ring.next_sequence = std::max<uint64_t>((sequence + 1) & kSequenceMask, 1);
+
+  MessageSlot& slot = ring.slots[sequence % kNumMessageSlots];
+  slot.sequence.store(0, std::memory_order_relaxed);
+  slot.size = std::min(message.size(), kMaxMessageLength);
+  std::memcpy(slot.data, message.data(), slot.size);
+  slot.sequence.store(sequence, std::memory_order_release);
+
+  rep_ |= (static_cast<uint64_t>(ring_index) << kRingShift) |
+          (sequence << kSequenceShift);
+}
+
+CompactRealtimeStatus::operator absl::Status() const {
+  INTRINSIC_ASSERT_NON_REALTIME();
+  return {code(), message()};
+}
+
+absl::string_view CompactRealtimeStatus::message() const {
+  if (ok()) {
+    return {};
+  }
+  const uint64_t ring_index = (rep_ >> kRingShift) & kRingMask;
+  if (ring_index == kNoRing) {
+    return {};
+  }
+  const uint64_t sequence = rep_ >> kSequenceShift;
+  const MessageSlot& slot =
+      s_rings[ring_index].slots[sequence % kNumMessageSlots];
+  if (slot.sequence.load(std::memory_order_acquire) != sequence) {
+    return kMessageUnavailable;
+  }
+  return absl::string_view(slot.data, slot.size);
+}
+
+void InitCompactRealtimeStatusForThisThread() {
+  INTRINSIC_ASSERT_NON_REALTIME();
+  // Registers the destructor for this thread.
+  thread_local RingReleaser releaser;
+  (void)releaser;
+  (void)ThisThreadsRing();
+}
+
+}  // namespace icon
+}  // namespace intrinsic
@@ -0,0 +1,144 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_UTILS_COMPACT_REALTIME_STATUS_H_
+#define INTRINSIC_ICON_UTILS_COMPACT_REALTIME_STATUS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "absl/base/attributes.h"
+#include "absl/base/optimization.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "intrinsic/icon/testing/realtime_annotations.h"
+#include "intrinsic/icon/utils/realtime_guard.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+
+namespace intrinsic {
+namespace icon {
+
+// A real-time safe status that is a single machine word.
+//
+// Unlike RealtimeStatus, which embeds its message, a CompactRealtimeStatus
+// stores only the error code and a reference to a message slot. The slots are
+// preallocated in a ring per thread, so creating an error is real-time safe,
+// and an OK status is just a zero word that is cheap to return and copy.
+// Messages can be up to kMaxMessageLength long.
+//
+// N.B. Each thread has kNumMessageSlots slots, which are reused in turn. The
+// message of an error is available until that many newer errors with message
+// were created on the same thread. Afterwards, message() returns
+// kMessageUnavailable. Convert to RealtimeStatus or absl::Status to keep the
+// message for longer, or to pass the status to another thread.
+//
+// Any thread can create errors with messages; a thread claims a ring of slots
+// on its first error. Call InitCompactRealtimeStatusForThisThread() in threads
+// that end before the process, so that their ring is released when they
+// exit. Otherwise, or if all kMaxThreads rings are in use, errors keep their
+// code, but lose their message.
+class ABSL_MUST_USE_RESULT CompactRealtimeStatus final {
+ public:
+  static constexpr size_t kMaxMessageLength = 500;
+  static constexpr size_t kNumMessageSlots = 16;
+  static constexpr size_t kMaxThreads = 64;
+  // Returned by message() once the slot of the message has been reused.
+  static constexpr absl::string_view kMessageUnavailable =
+      "<message no longer available>";
+
+  // Creates an OK status.
+  constexpr CompactRealtimeStatus() = default;
+  // Creates a status with `code` and `message`. If `code` is kOk, `message`
+  // is ignored. Truncates messages longer than kMaxMessageLength.
+  CompactRealtimeStatus(absl::StatusCode code,
+                        absl::string_view message) INTRINSIC_CHECK_REALTIME_SAFE;
+  // Copies the code and message of `status`.
+  CompactRealtimeStatus(  // NOLINT: implicit conversion ok
+      const RealtimeStatus& status) INTRINSIC_CHECK_REALTIME_SAFE
+      : CompactRealtimeStatus(status.code(), status.message()) {}
+
+  // Truncates the message to RealtimeStatus::kMaxMessageLength.
+  operator RealtimeStatus() const  // NOLINT: implicit conversion ok
+      INTRINSIC_CHECK_REALTIME_SAFE {
+    return RealtimeStatus(code(), message());
+  }
+  operator absl::Status() const;  // NOLINT: implicit conversion ok
+
+  ABSL_MUST_USE_RESULT bool ok() const INTRINSIC_CHECK_REALTIME_SAFE {
+    return rep_ == 0;
+  }
+  absl::StatusCode code() const INTRINSIC_CHECK_REALTIME_SAFE {
+    return static_cast<absl::StatusCode>(rep_ & kCodeMask);
+  }
+
+  // Returns the error message, which is empty for OK statuses, and
+  // kMessageUnavailable if its slot has been reused. The result is valid
+  // until then.
+  absl::string_view message() const INTRINSIC_CHECK_REALTIME_SAFE;
+
+  friend bool operator==(const CompactRealtimeStatus& lhs,
+                         const CompactRealtimeStatus& rhs) {
+    return lhs.rep_ == rhs.rep_ ||
+           (lhs.code() == rhs.code() && lhs.message() == rhs.message());
+  }
+  friend bool operator!=(const CompactRealtimeStatus& lhs,
+                         const CompactRealtimeStatus& rhs) {
+    return !(lhs == rhs);
+  }
+
+ private:
+  // Layout of `rep_`: The lowest byte is the code. For errors, the second
+  // byte is the thread's ring (or kNoRing) and the remaining bits are the
+  // sequence number of the message in the ring.
+  static constexpr uint64_t kCodeMask = 0xff;
+  static constexpr int kRingShift = 8;
+  static constexpr uint64_t kRingMask = 0xff;
+  static constexpr int kSequenceShift = 16;
+  static constexpr uint64_t kNoRing = kRingMask;
+
+  uint64_t rep_ = 0;
+};
+
+static_assert(sizeof(CompactRealtimeStatus) == sizeof(uint64_t));
+
+// Not real-time safe.
+// Claims a ring of message slots for this thread, and releases it when the
+// thread exits. Calling it again in the same thread has no effect.
+void InitCompactRealtimeStatusForThisThread();
+
+// Logging operator exposed for CHECK_* functions. These should only be called
+// in non realtime contexts.
+inline std::ostream& operator<<(std::ostream& os,
+                                const CompactRealtimeStatus& status) {
+  INTRINSIC_ASSERT_NON_REALTIME();
+  if (status.ok() || status.message().empty()) {
+    return os << RealtimeStatusCodeToCharArray(status.code());
+  }
+  return os << RealtimeStatusCodeToCharArray(status.code()) << ": "
+            << status.message();
+}
+
+}  // namespace icon
+}  // namespace intrinsic
+
+// Evaluates an expression that produces a CompactRealtimeStatus, and returns
+// it from the current function if it is not OK. Unlike
+// INTRINSIC_RT_RETURN_IF_ERROR, the OK path only tests a single word.
+//
+// Example:
+//    CompactRealtimeStatus Bar();
+//
+//    CompactRealtimeStatus Foo() {
+//      INTRINSIC_RT_RETURN_IF_COMPACT_ERROR(Bar());
+//      return CompactRealtimeStatus();
+//    }
+#define INTRINSIC_RT_RETURN_IF_COMPACT_ERROR(expr)                      \
+  do {                                                                  \
+    if (const ::intrinsic::icon::CompactRealtimeStatus compact_status = \
+            (expr);                                                     \
+        ABSL_PREDICT_FALSE(!compact_status.ok())) {                     \
+      return compact_status;                                            \
+    }                                                                   \
+  } while (0)
+
+#endif  // INTRINSIC_ICON_UTILS_COMPACT_REALTIME_STATUS_H_
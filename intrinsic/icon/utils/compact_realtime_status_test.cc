@@ -0,0 +1,102 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/compact_realtime_status.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::icon {
+namespace {
+
+using ::testing::IsEmpty;
+
+TEST(CompactRealtimeStatusTest, DefaultIsOk) {
+  CompactRealtimeStatus status;
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ(status.code(), absl::StatusCode::kOk);
+  EXPECT_THAT(status.message(), IsEmpty());
+  EXPECT_EQ(status, CompactRealtimeStatus(absl::StatusCode::kOk, "ignored"));
+}
+
+TEST(CompactRealtimeStatusTest, KeepsCodeAndMessage) {
+  CompactRealtimeStatus status(absl::StatusCode::kAborted, "aborted");
+  EXPECT_FALSE(status.ok());
+  EXPECT_EQ(status.code(), absl::StatusCode::kAborted);
+  EXPECT_EQ(status.message(), "aborted");
+  EXPECT_EQ(status, CompactRealtimeStatus(absl::StatusCode::kAborted,
+                                          "aborted"));
+  EXPECT_NE(status, CompactRealtimeStatus(absl::StatusCode::kAborted,
+                                          "other"));
+  EXPECT_THAT(CompactRealtimeStatus(absl::StatusCode::kInternal, "").message(),
+              IsEmpty());
+}
+
+TEST(CompactRealtimeStatusTest, KeepsMessagesLongerThanRealtimeStatus) {
+  std::string message(CompactRealtimeStatus::kMaxMessageLength + 10, 'x');
+  CompactRealtimeStatus status(absl::StatusCode::kInternal, message);
+  EXPECT_EQ(status.message(),
+            message.substr(0, CompactRealtimeStatus::kMaxMessageLength));
+
+  RealtimeStatus realtime_status = status;
+  EXPECT_EQ(realtime_status.code(), absl::StatusCode::kInternal);
+  EXPECT_EQ(realtime_status.message(),
+            message.substr(0, RealtimeStatus::kMaxMessageLength));
+}
+
+TEST(CompactRealtimeStatusTest, ConvertsFromRealtimeStatus) {
+  CompactRealtimeStatus status = NotFoundError("not found");
+  EXPECT_EQ(status.code(), absl::StatusCode::kNotFound);
+  EXPECT_EQ(status.message(), "not found");
+  EXPECT_EQ(absl::Status(status), absl::NotFoundError("not found"));
+  EXPECT_TRUE(CompactRealtimeStatus(OkStatus()).ok());
+}
+
+TEST(CompactRealtimeStatusTest, ReusesMessageSlots) {
+  CompactRealtimeStatus status(absl::StatusCode::kInternal, "first");
+  for (size_t i = 0; i < CompactRealtimeStatus::kNumMessageSlots - 1; ++i) {
+    CompactRealtimeStatus newer(absl::StatusCode::kInternal,
+                                absl::StrCat("newer ", i));
+    EXPECT_EQ(newer.message(), absl::StrCat("newer ", i));
+  }
+  EXPECT_EQ(status.message(), "first");
+  CompactRealtimeStatus newest(absl::StatusCode::kInternal, "newest");
+  EXPECT_EQ(status.message(), CompactRealtimeStatus::kMessageUnavailable);
+  // The code is still known.
+  EXPECT_EQ(status.code(), absl::StatusCode::kInternal);
+}
+
+CompactRealtimeStatus ReturnIfError(CompactRealtimeStatus status) {
+  INTRINSIC_RT_RETURN_IF_COMPACT_ERROR(status);
+  return CompactRealtimeStatus(absl::StatusCode::kUnknown, "not returned");
+}
+
+TEST(CompactRealtimeStatusTest, ReturnIfCompactError) {
+  EXPECT_EQ(ReturnIfError(CompactRealtimeStatus()).code(),
+            absl::StatusCode::kUnknown);
+  EXPECT_EQ(
+      ReturnIfError(CompactRealtimeStatus(absl::StatusCode::kAborted, "a"))
+          .message(),
+      "a");
+}
+
+TEST(CompactRealtimeStatusTest, ReleasesRingsOfEndedThreads) {
+  for (size_t i = 0; i < 2 * CompactRealtimeStatus::kMaxThreads; ++i) {
+    Thread thread([]() {
+      InitCompactRealtimeStatusForThisThread();
+      CompactRealtimeStatus status(absl::StatusCode::kInternal, "in thread");
+      EXPECT_EQ(status.message(), "in thread");
+    });
+    thread.Join();
+  }
+}
+
+}  // namespace
+}  // namespace intrinsic::icon
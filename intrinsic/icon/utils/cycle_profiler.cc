@@ -0,0 +1,199 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/cycle_profiler.h"
+
+#include <time.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "intrinsic/icon/utils/current_cycle.h"
+
+namespace intrinsic::icon {
+
+// static
+int64_t CycleProfiler::MonotonicNowNs() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return int64_t{now.tv_sec} * 1'000'000'000 + now.tv_nsec;
+}
+
+// static
+absl::StatusOr<std::unique_ptr<CycleProfiler>> CycleProfiler::Create(
+    absl::Span<const absl::string_view> phase_names,
+    absl::Duration cycle_period, int publish_interval, NowFn now) {
+  if (phase_names.empty() || phase_names.size() > CycleProfile::kMaxPhases) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected 1 to ", CycleProfile::kMaxPhases,
+                     " phases, got ", phase_names.size()));
+  }
+  if (cycle_period <= absl::ZeroDuration()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Cycle period must be positive, got ",
+                     absl::FormatDuration(cycle_period)));
+  }
+  if (publish_interval <= 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Publish interval must be positive, got ", publish_interval));
+  }
+  // Private constructor, so no make_unique.
+  return absl::WrapUnique(
+      new CycleProfiler(phase_names, absl::ToInt64Nanoseconds(cycle_period),
+                        publish_interval, now));
+}
+
+CycleProfiler::CycleProfiler(absl::Span<const absl::string_view> phase_names,
+                             int64_t cycle_period_ns, int publish_interval,
+                             NowFn now)
+    : phase_names_(phase_names.begin(), phase_names.end()),
+      cycle_period_ns_(cycle_period_ns),
+      publish_interval_(publish_interval),
+      now_(now) {
+  // The histograms cover two cycle periods.
+  profile_.bucket_width_ns = std::max<int64_t>(
+      2 * cycle_period_ns_ / CycleProfile::kNumHistogramBuckets, 1);
+}
+
+size_t CycleProfiler::Bucket(int64_t duration_ns) const {
+  return std::min<size_t>(duration_ns / profile_.bucket_width_ns,
+                          CycleProfile::kNumHistogramBuckets - 1);
+}
+
+void CycleProfiler::StartCycle() {
+  const int64_t now = now_();
+  current_ = CycleRecord{.cycle = Cycle::GetCurrentCycle()};
+  if (previous_start_ns_ >= 0) {
+    current_.period_ns = now - previous_start_ns_;
+  }
+  previous_start_ns_ = now;
+  cycle_start_ns_ = now;
+  phase_start_ns_ = now;
+  in_cycle_ = true;
+}
+
+void CycleProfiler::EndPhase(size_t phase) {
+  if (!in_cycle_ || phase >= phase_names_.size()) {
+    return;
+  }
+  const int64_t now = now_();
+  current_.phase_duration_ns[phase] += now - phase_start_ns_;
+  phase_start_ns_ = now;
+}
+
+void CycleProfiler::EndCycle() {
+  if (!in_cycle_) {
+    return;
+  }
+  in_cycle_ = false;
+  current_.duration_ns = now_() - cycle_start_ns_;
+
+  ++profile_.num_cycles;
+  if (current_.duration_ns > cycle_period_ns_) {
+    ++profile_.num_overruns;
+  }
+  ++profile_.duration_histogram[Bucket(current_.duration_ns)];
+  if (current_.period_ns > 0) {
+    ++profile_.jitter_histogram[Bucket(
+        std::abs(current_.period_ns - cycle_period_ns_))];
+  }
+  for (size_t i = 0; i < phase_names_.size(); ++i) {
+    CycleProfile::PhaseStats& phase = profile_.phases[i];
+    phase.total_duration_ns += current_.phase_duration_ns[i];
+    phase.max_duration_ns =
+        std::max(phase.max_duration_ns, current_.phase_duration_ns[i]);
+  }
+
+  // Keeps `worst_cycles` sorted, longest first. The entries past num_cycles
+  // have a duration of 0, so they are replaced first.
+  auto& worst = profile_.worst_cycles;
+  if (current_.duration_ns > worst.back().duration_ns ||
+      profile_.num_cycles <= worst.size()) {
+    size_t i = std::min<size_t>(profile_.num_cycles, worst.size()) - 1;
+    for (; i > 0 && worst[i - 1].duration_ns < current_.duration_ns; --i) {
+      worst[i] = worst[i - 1];
+    }
+    worst[i] = current_;
+  }
+
+  if (++cycles_since_publish_ >= publish_interval_) {
+    cycles_since_publish_ = 0;
+    *published_.GetFreeBuffer() = profile_;
+    published_.CommitFreeBuffer();
+  }
+}
+
+std::optional<CycleProfile> CycleProfiler::GetNewProfile() {
+  CycleProfile* profile = nullptr;
+  if (!published_.TryGetNewActiveBuffer(&profile, &read_generation_)) {
+    return std::nullopt;
+  }
+  return *profile;
+}
+
+std::string CycleProfiler::FormatProfile(const CycleProfile& profile) const {
+  std::string out = absl::StrCat(
+      profile.num_cycles, " cycles, ", profile.num_overruns,
+      " overruns of ", absl::FormatDuration(absl::Nanoseconds(cycle_period_ns_)),
+      "\n");
+  if (profile.num_cycles == 0) {
+    return out;
+  }
+  for (size_t i = 0; i < phase_names_.size(); ++i) {
+    const CycleProfile::PhaseStats& phase = profile.phases[i];
+    absl::StrAppend(
+        &out, "  phase ", phase_names_[i], ": mean ",
+        absl::FormatDuration(absl::Nanoseconds(phase.total_duration_ns) /
+                             profile.num_cycles),
+        ", max ",
+        absl::FormatDuration(absl::Nanoseconds(phase.max_duration_ns)), "\n");
+  }
+  const auto append_histogram =
+      [&](absl::string_view name,
+          const std::array<uint64_t, CycleProfile::kNumHistogramBuckets>&
+              histogram) {
+        absl::StrAppend(&out, "  ", name, " histogram (bucket width ",
+                        absl::FormatDuration(
+                            absl::Nanoseconds(profile.bucket_width_ns)),
+                        "):");
+        for (size_t i = 0; i < histogram.size(); ++i) {
+          if (histogram[i] != 0) {
+            absl::StrAppend(&out, " [", i, "]=", histogram[i]);
+          }
+        }
+        absl::StrAppend(&out, "\n");
+      };
+  append_histogram("duration", profile.duration_histogram);
+  append_histogram("jitter", profile.jitter_histogram);
+  const size_t num_worst =
+      std::min<size_t>(profile.num_cycles, profile.worst_cycles.size());
+  for (size_t i = 0; i < num_worst; ++i) {
+    const CycleRecord& record = profile.worst_cycles[i];
+    absl::StrAppend(
+        &out, "  worst #", i + 1, ": cycle ", record.cycle, " took ",
+        absl::FormatDuration(absl::Nanoseconds(record.duration_ns)),
+        " (period ", absl::FormatDuration(absl::Nanoseconds(record.period_ns)),
+        "):");
+    for (size_t phase = 0; phase < phase_names_.size(); ++phase) {
+      absl::StrAppend(&out, " ", phase_names_[phase], "=",
+                      absl::FormatDuration(absl::Nanoseconds(
+                          record.phase_duration_ns[phase])));
+    }
+    absl::StrAppend(&out, "\n");
+  }
+  return out;
+}
+
+}  // namespace intrinsic::icon
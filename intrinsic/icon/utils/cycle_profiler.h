@@ -0,0 +1,173 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_UTILS_CYCLE_PROFILER_H_
+#define INTRINSIC_ICON_UTILS_CYCLE_PROFILER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "intrinsic/icon/testing/realtime_annotations.h"
+#include "intrinsic/icon/utils/async_buffer.h"
+
+namespace intrinsic::icon {
+
+// Timing of a single cycle.
+struct CycleRecord {
+  static constexpr size_t kMaxPhases = 16;
+
+  // Cycle::GetCurrentCycle() when the cycle started.
+  uint64_t cycle = 0;
+  // Time from the start of the previous cycle to the start of this one, or 0
+  // for the first cycle.
+  int64_t period_ns = 0;
+  // Time from the start to the end of the cycle.
+  int64_t duration_ns = 0;
+  // Time spent in each phase, indexed like the phase names of the profiler.
+  std::array<int64_t, kMaxPhases> phase_duration_ns = {};
+};
+
+// Statistics of all cycles since a CycleProfiler was created.
+struct CycleProfile {
+  static constexpr size_t kMaxPhases = CycleRecord::kMaxPhases;
+  static constexpr size_t kNumHistogramBuckets = 32;
+  static constexpr size_t kNumWorstCycles = 8;
+
+  struct PhaseStats {
+    int64_t total_duration_ns = 0;
+    int64_t max_duration_ns = 0;
+  };
+
+  uint64_t num_cycles = 0;
+  // Number of cycles that took longer than the cycle period.
+  uint64_t num_overruns = 0;
+  // Bucket `i` counts the cycles with a duration in
+  // [i * bucket_width_ns, (i + 1) * bucket_width_ns). The last bucket also
+  // counts all longer cycles.
+  int64_t bucket_width_ns = 0;
+  std::array<uint64_t, kNumHistogramBuckets> duration_histogram = {};
+  // Like `duration_histogram`, but for the deviation of the start-to-start
+  // period from the cycle period, in either direction.
+  std::array<uint64_t, kNumHistogramBuckets> jitter_histogram = {};
+  std::array<PhaseStats, kMaxPhases> phases = {};
+  // The longest cycles, longest first. Only the first
+  // min(num_cycles, kNumWorstCycles) entries are valid.
+  std::array<CycleRecord, kNumWorstCycles> worst_cycles = {};
+};
+
+// Records the timing of the cycles of a real-time loop, split into
+// user-defined phases, and makes the statistics available to a non-real-time
+// thread.
+//
+// The real-time thread calls StartCycle() at the beginning of each cycle,
+// EndPhase() at the end of each phase and EndCycle() at the end of the cycle:
+//
+//   INTR_ASSIGN_OR_RETURN(std::unique_ptr<CycleProfiler> profiler,
+//                         CycleProfiler::Create({"read", "compute", "write"},
+//                                               absl::Milliseconds(1)));
+//   ...
+//   // In the real-time loop:
+//   profiler->StartCycle();
+//   ReadSensors();
+//   profiler->EndPhase(0);
+//   Compute();
+//   profiler->EndPhase(1);
+//   WriteCommands();
+//   profiler->EndPhase(2);
+//   profiler->EndCycle();
+//
+// On another thread, GetNewProfile() returns the latest published statistics,
+// which FormatProfile() turns into a human readable string. The statistics
+// include histograms of the cycle duration and jitter, and the phase
+// breakdown of the kNumWorstCycles longest cycles, so that overruns can be
+// diagnosed without rebuilding with instrumentation.
+//
+// A CycleProfiler is meant for a single real-time thread and a single reader
+// thread. Recording is lock-free and does not allocate. To limit the copying
+// in the real-time thread, the statistics are only published every
+// `publish_interval` cycles.
+class CycleProfiler {
+ public:
+  // Returns the current time in nanoseconds. Must be real-time safe.
+  using NowFn = int64_t (*)();
+
+  // Returns CLOCK_MONOTONIC in nanoseconds. Unlike Clock::Now(), this is
+  // wall time also in simulation, which is what profiling needs.
+  static int64_t MonotonicNowNs() INTRINSIC_CHECK_REALTIME_SAFE;
+
+  // Creates a profiler for cycles with the phases `phase_names` and the
+  // nominal period `cycle_period`. Cycles longer than `cycle_period` count as
+  // overruns. The histograms cover durations of up to twice `cycle_period`.
+  //
+  // Returns InvalidArgumentError if there are no or more than
+  // CycleProfile::kMaxPhases phases, or if `cycle_period` or
+  // `publish_interval` is not positive.
+  static absl::StatusOr<std::unique_ptr<CycleProfiler>> Create(
+      absl::Span<const absl::string_view> phase_names,
+      absl::Duration cycle_period, int publish_interval = 1,
+      NowFn now = &MonotonicNowNs);
+
+  CycleProfiler(const CycleProfiler&) = delete;
+  CycleProfiler& operator=(const CycleProfiler&) = delete;
+
+  // Real-time safe. Starts a cycle, and its first phase. Discards a cycle that
+  // was started, but not ended.
+  void StartCycle() INTRINSIC_CHECK_REALTIME_SAFE;
+  // Real-time safe. Ends the phase `phase`, and starts the next one. Ending the
+  // same phase several times in a cycle adds up its durations. Has no effect
+  // outside of a cycle or if `phase` is out of range.
+  void EndPhase(size_t phase) INTRINSIC_CHECK_REALTIME_SAFE;
+  // Real-time safe. Ends the cycle, updates the statistics and publishes them
+  // if `publish_interval` cycles passed since the last publication. Has no
+  // effect outside of a cycle.
+  void EndCycle() INTRINSIC_CHECK_REALTIME_SAFE;
+
+  // Not real-time safe. Returns the statistics if they were published since
+  // the last call, otherwise std::nullopt. Must only be called from one thread
+  // at a time.
+  std::optional<CycleProfile> GetNewProfile() INTRINSIC_NON_REALTIME_ONLY;
+
+  // Not real-time safe. Returns a multi-line summary of `profile`.
+  std::string FormatProfile(const CycleProfile& profile) const
+      INTRINSIC_NON_REALTIME_ONLY;
+
+  absl::Span<const std::string> phase_names() const { return phase_names_; }
+
+ private:
+  CycleProfiler(absl::Span<const absl::string_view> phase_names,
+                int64_t cycle_period_ns, int publish_interval, NowFn now);
+
+  // Returns the histogram bucket of `duration_ns`.
+  size_t Bucket(int64_t duration_ns) const;
+
+  const std::vector<std::string> phase_names_;
+  const int64_t cycle_period_ns_;
+  const int publish_interval_;
+  const NowFn now_;
+
+  // Only accessed by the real-time thread.
+  CycleProfile profile_;
+  CycleRecord current_;
+  bool in_cycle_ = false;
+  int64_t cycle_start_ns_ = 0;
+  int64_t phase_start_ns_ = 0;
+  // Start of the previous cycle, or -1.
+  int64_t previous_start_ns_ = -1;
+  int cycles_since_publish_ = 0;
+
+  AsyncBuffer<CycleProfile> published_;
+  // Only accessed by the reader thread.
+  uint64_t read_generation_ = 0;
+};
+
+}  // namespace intrinsic::icon
+
+#endif  // INTRINSIC_ICON_UTILS_CYCLE_PROFILER_H_
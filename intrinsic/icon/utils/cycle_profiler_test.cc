@@ -0,0 +1,139 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/cycle_profiler.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/utils/current_cycle.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::icon {
+namespace {
+
+using ::intrinsic::testing::StatusIs;
+using ::testing::AllOf;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+int64_t fake_now_ns = 0;
+int64_t FakeNow() { return fake_now_ns; }
+
+// Runs a cycle that starts at `start_ns` and spends `read_ns` and `write_ns`
+// in its two phases.
+void RunCycle(CycleProfiler& profiler, int64_t start_ns, int64_t read_ns,
+              int64_t write_ns) {
+  Cycle::IncrementCurrentCycle();
+  fake_now_ns = start_ns;
+  profiler.StartCycle();
+  fake_now_ns += read_ns;
+  profiler.EndPhase(0);
+  fake_now_ns += write_ns;
+  profiler.EndPhase(1);
+  profiler.EndCycle();
+}
+
+TEST(CycleProfilerTest, RejectsInvalidArguments) {
+  EXPECT_THAT(CycleProfiler::Create({}, absl::Milliseconds(1)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(CycleProfiler::Create({"a"}, absl::ZeroDuration()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(CycleProfiler::Create({"a"}, absl::Milliseconds(1),
+                                    /*publish_interval=*/0),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(CycleProfilerTest, RecordsPhasesHistogramsAndOverruns) {
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CycleProfiler> profiler,
+      CycleProfiler::Create({"read", "write"}, absl::Microseconds(1000),
+                            /*publish_interval=*/1, &FakeNow));
+  EXPECT_FALSE(profiler->GetNewProfile().has_value());
+
+  RunCycle(*profiler, 0, 100, 200);
+  RunCycle(*profiler, 1000'000, 300, 400);
+  // Starts late and overruns.
+  RunCycle(*profiler, 2500'000, 1000'000, 500);
+
+  std::optional<CycleProfile> profile = profiler->GetNewProfile();
+  ASSERT_TRUE(profile.has_value());
+  EXPECT_FALSE(profiler->GetNewProfile().has_value());
+  EXPECT_EQ(profile->num_cycles, 3);
+  EXPECT_EQ(profile->num_overruns, 1);
+  EXPECT_EQ(profile->bucket_width_ns, 62'500);
+  EXPECT_EQ(profile->duration_histogram[0], 2);
+  EXPECT_EQ(profile->duration_histogram[16], 1);
+  // The second cycle started on time, the third 500us late.
+  EXPECT_EQ(profile->jitter_histogram[0], 1);
+  EXPECT_EQ(profile->jitter_histogram[8], 1);
+  EXPECT_EQ(profile->phases[0].max_duration_ns, 1000'000);
+  EXPECT_EQ(profile->phases[1].total_duration_ns, 1100);
+
+  EXPECT_EQ(profile->worst_cycles[0].duration_ns, 1000'500);
+  EXPECT_EQ(profile->worst_cycles[0].period_ns, 1500'000);
+  EXPECT_EQ(profile->worst_cycles[0].cycle, Cycle::GetCurrentCycle());
+  EXPECT_EQ(profile->worst_cycles[0].phase_duration_ns[0], 1000'000);
+  EXPECT_EQ(profile->worst_cycles[1].duration_ns, 700);
+  EXPECT_EQ(profile->worst_cycles[2].duration_ns, 300);
+  EXPECT_EQ(profile->worst_cycles[2].period_ns, 0);
+
+  EXPECT_THAT(profiler->FormatProfile(*profile),
+              AllOf(HasSubstr("3 cycles, 1 overruns"),
+                    HasSubstr("phase read: mean"),
+                    HasSubstr("worst #1: cycle")));
+}
+
+TEST(CycleProfilerTest, KeepsWorstCyclesAndPublishesPeriodically) {
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CycleProfiler> profiler,
+      CycleProfiler::Create({"read", "write"}, absl::Microseconds(1000),
+                            /*publish_interval=*/10, &FakeNow));
+  for (int i = 0; i < 9; ++i) {
+    RunCycle(*profiler, i * 1000'000, i, 0);
+  }
+  EXPECT_FALSE(profiler->GetNewProfile().has_value());
+  for (int i = 9; i < 20; ++i) {
+    RunCycle(*profiler, i * 1000'000, (i * 7) % 20, 0);
+  }
+  std::optional<CycleProfile> profile = profiler->GetNewProfile();
+  ASSERT_TRUE(profile.has_value());
+  EXPECT_EQ(profile->num_cycles, 20);
+  std::vector<int64_t> worst;
+  for (const CycleRecord& record : profile->worst_cycles) {
+    worst.push_back(record.duration_ns);
+  }
+  EXPECT_THAT(worst, ElementsAre(19, 18, 17, 13, 12, 11, 10, 8));
+  EXPECT_FALSE(profiler->GetNewProfile().has_value());
+}
+
+TEST(CycleProfilerTest, IgnoresCallsOutsideOfCycles) {
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CycleProfiler> profiler,
+      CycleProfiler::Create({"only"}, absl::Microseconds(1000),
+                            /*publish_interval=*/1, &FakeNow));
+  profiler->EndPhase(0);
+  profiler->EndCycle();
+  EXPECT_FALSE(profiler->GetNewProfile().has_value());
+
+  fake_now_ns = 0;
+  profiler->StartCycle();
+  fake_now_ns = 10;
+  profiler->EndPhase(0);
+  profiler->EndPhase(1);
+  profiler->EndCycle();
+  std::optional<CycleProfile> profile = profiler->GetNewProfile();
+  ASSERT_TRUE(profile.has_value());
+  EXPECT_EQ(profile->num_cycles, 1);
+  EXPECT_EQ(profile->phases[0].total_duration_ns, 10);
+  EXPECT_EQ(profile->phases[1].total_duration_ns, 0);
+}
+
+}  // namespace
+}  // namespace intrinsic::icon
@@ -3,10 +3,10 @@
 #ifndef INTRINSIC_ICON_UTILS_FIXED_STR_CAT_H_
 #define INTRINSIC_ICON_UTILS_FIXED_STR_CAT_H_
 
-#include <algorithm>
+#include <charconv>
 #include <cstddef>
-#include <cstring>
 #include <initializer_list>
+#include <type_traits>
 
 #include "absl/base/attributes.h"
 #include "absl/strings/str_cat.h"
@@ -15,46 +15,42 @@
 
 namespace intrinsic::icon {
 
+// Formats a double as the shortest string that parses back to exactly the
+// same value, e.g., for logging values that six significant digits (the format
+// of doubles in FixedStrCat()) do not tell apart. Does not allocate, so it is
+// real-time safe:
+//
+//   FixedStrCat<64>("position=", RoundTripDouble(position));
+class RoundTripDouble {
+ public:
+  explicit RoundTripDouble(double value) {
+    // std::to_chars finds the shortest representation without allocating or
+    // depending on the locale.
+    size_ = std::to_chars(buffer_, buffer_ + sizeof(buffer_), value).ptr -
+            buffer_;
+  }
+
+  absl::string_view Piece() const { return absl::string_view(buffer_, size_); }
+
+ private:
+  // The longest shortest representation is 24 characters, e.g.,
+  // "-2.2250738585072014e-308".
+  char buffer_[32];
+  size_t size_;
+};
+
 namespace internal {
 
-// NB: This differs slightly from the absl implementation by checking against
-// MaxSize before resizing, and not attempting to copy past the end. To port to
-// absl's exact algorithm we'd need to either implement a real-time safe
-// allocator, possibly TLSF for more flexible real-time safe strings, or assert
-// when MaxSize is exceeded. For now, we implement it this way for consistency
-// with FixedString's constructor.
-template <size_t MaxSize>
-FixedString<MaxSize> CatPieces(
-    std::initializer_list<absl::string_view> pieces) {
-  FixedString<MaxSize> result;
-  size_t total_size = 0;
-  for (const absl::string_view& piece : pieces) {
-    total_size += piece.size();
-  }
-  if (total_size == 0) {
-    return result;
-  }
-  result.resize(std::min(MaxSize, total_size));
-
-  char* const begin = &result[0];
-  char* out = begin;
-  for (const absl::string_view& piece : pieces) {
-    const size_t current_size = out - begin;
-    int num_chars_to_copy = piece.size();
-    if (num_chars_to_copy + current_size > MaxSize) {
-      num_chars_to_copy = MaxSize - current_size;
-      if (num_chars_to_copy <= 0) {
-        return result;
-      }
-    }
-
-    if (num_chars_to_copy != 0) {
-      memcpy(out, piece.data(), num_chars_to_copy);
-      out += num_chars_to_copy;
-    }
-  }
-  return result;
-}
+// Numbers are formatted directly into the FixedString, see
+// FixedString::append_number(), instead of into an absl::AlphaNum first. Like
+// absl::AlphaNum, this rejects char.
+template <typename T>
+constexpr bool kIsNumber = std::is_arithmetic_v<T> &&
+                           !std::is_same_v<T, char> &&
+                           !std::is_same_v<T, wchar_t> &&
+                           !std::is_same_v<T, char8_t> &&
+                           !std::is_same_v<T, char16_t> &&
+                           !std::is_same_v<T, char32_t>;
 
 inline absl::string_view ToStringView(
     const absl::AlphaNum& a ABSL_ATTRIBUTE_LIFETIME_BOUND) {
@@ -67,14 +63,48 @@ inline absl::string_view ToStringView(
   return a;
 }
 
+inline absl::string_view ToStringView(
+    const RoundTripDouble& a ABSL_ATTRIBUTE_LIFETIME_BOUND) {
+  return a.Piece();
+}
+
+template <size_t MaxSize, typename T>
+void AppendArg(FixedString<MaxSize>& dest, const T& arg) {
+  if constexpr (kIsNumber<T>) {
+    dest.append_number(arg);
+  } else {
+    // The temporary that the piece may point into, e.g., an AlphaNum, lives
+    // until the piece is appended.
+    dest.append(ToStringView(arg));
+  }
+}
+
 }  // namespace internal
 
+// Appends pieces to `dest` in place. Like FixedStrCat(), drops what exceeds
+// MaxSize. Building a string piece by piece with FixedStrAppend() takes time
+// linear in its size, while repeating `str = FixedStrCat<N>(str, ...)` copies
+// `str` every time.
+template <size_t MaxSize, typename... AV>
+void FixedStrAppend(FixedString<MaxSize>* dest, const AV&... args) {
+  if constexpr ((!internal::kIsNumber<AV> && ...)) {
+    // A single call, so that the total size is bounded once, and the
+    // temporaries the pieces point into live until all pieces are appended.
+    dest->append(std::initializer_list<absl::string_view>{
+        internal::ToStringView(args)...});
+  } else {
+    (internal::AppendArg(*dest, args), ...);
+  }
+}
+
 // Concatenates pieces to create a new string. If the combined size of the
 // pieces exceeds MaxSize, then excess pieces are dropped from the resulting
 // string.
 template <size_t MaxSize, typename... AV>
 ABSL_MUST_USE_RESULT FixedString<MaxSize> FixedStrCat(const AV&... args) {
-  return internal::CatPieces<MaxSize>({internal::ToStringView(args)...});
+  FixedString<MaxSize> result;
+  FixedStrAppend(&result, args...);
+  return result;
 }
 
 }  // namespace intrinsic::icon
@@ -0,0 +1,93 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/fixed_str_cat.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "intrinsic/icon/utils/fixed_string.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::icon {
+namespace {
+
+using ::testing::IsEmpty;
+
+TEST(FixedStrCatTest, ConcatenatesPieces) {
+  EXPECT_EQ(absl::string_view(FixedStrCat<32>("a", "bc", "", "def")),
+            "abcdef");
+  EXPECT_EQ(absl::string_view(FixedStrCat<32>(FixedString<4>("fix"), "ed")),
+            "fixed");
+}
+
+TEST(FixedStrCatTest, TruncatesAtMaxSize) {
+  EXPECT_EQ(absl::string_view(FixedStrCat<5>("abc", "def", "ghi")), "abcde");
+  EXPECT_EQ(absl::string_view(FixedStrCat<5>("abc", 123456)), "abc12");
+  EXPECT_EQ(absl::string_view(FixedStrCat<3>(1.5, "x")), "1.5");
+}
+
+TEST(FixedStrCatTest, FormatsNumbersLikeStrCat) {
+  for (const int64_t value :
+       {int64_t{0}, int64_t{-1}, int64_t{42}, int64_t{-987654321},
+        std::numeric_limits<int64_t>::min(),
+        std::numeric_limits<int64_t>::max()}) {
+    EXPECT_EQ(absl::string_view(FixedStrCat<32>(value)), absl::StrCat(value));
+  }
+  EXPECT_EQ(absl::string_view(FixedStrCat<32>(
+                std::numeric_limits<uint64_t>::max())),
+            absl::StrCat(std::numeric_limits<uint64_t>::max()));
+  for (const double value :
+       {0.0, -0.0, 1.0, -2.5, 0.1, 1.0 / 3.0, 123456.0, 1234567.0, 1e-5,
+        1.5e-300, -1.79769e+308, std::numeric_limits<double>::infinity(),
+        -std::numeric_limits<double>::infinity()}) {
+    EXPECT_EQ(absl::string_view(FixedStrCat<32>(value)), absl::StrCat(value))
+        << value;
+  }
+  EXPECT_EQ(absl::string_view(FixedStrCat<32>(0.25f)), absl::StrCat(0.25f));
+  EXPECT_EQ(absl::string_view(FixedStrCat<32>(true, false)), "10");
+}
+
+TEST(FixedStrCatTest, AppendsInPlace) {
+  FixedString<16> str("n=");
+  FixedStrAppend(&str, 12, ", x=", 0.5);
+  EXPECT_EQ(absl::string_view(str), "n=12, x=0.5");
+  FixedStrAppend(&str, "-overflowing");
+  EXPECT_EQ(absl::string_view(str), "n=12, x=0.5-over");
+  FixedStrAppend(&str, 1);
+  EXPECT_EQ(absl::string_view(str), "n=12, x=0.5-over");
+}
+
+TEST(FixedStringTest, ComparesContents) {
+  EXPECT_EQ(FixedString<8>("abc"), FixedString<8>("abc"));
+  EXPECT_NE(FixedString<8>("abc"), FixedString<8>("abd"));
+  EXPECT_NE(FixedString<8>("abc"), FixedString<8>("ab"));
+  FixedString<8> str("abc");
+  str.clear();
+  EXPECT_THAT(absl::string_view(str), IsEmpty());
+  EXPECT_EQ(str, FixedString<8>());
+}
+
+TEST(FixedStringTest, HashesLikeStringView) {
+  EXPECT_EQ(absl::Hash<FixedString<8>>()(FixedString<8>("key")),
+            absl::Hash<absl::string_view>()("key"));
+
+  absl::flat_hash_map<FixedString<8>, int, FixedStringHash, FixedStringEq>
+      map;
+  map[FixedString<8>("one")] = 1;
+  map[FixedString<8>("two")] = 2;
+  auto it = map.find(absl::string_view("two"));
+  ASSERT_NE(it, map.end());
+  EXPECT_EQ(it->second, 2);
+  EXPECT_EQ(map.find(absl::string_view("three")), map.end());
+}
+
+}  // namespace
+}  // namespace intrinsic::icon
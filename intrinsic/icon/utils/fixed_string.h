@@ -5,10 +5,16 @@
 
 #include <algorithm>
 #include <array>
+#include <charconv>
 #include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <system_error>
+#include <type_traits>
 #include <utility>
 
 #include "absl/base/macros.h"
+#include "absl/hash/hash.h"
 #include "absl/strings/string_view.h"
 
 namespace intrinsic::icon {
@@ -49,17 +55,57 @@ class FixedString {
   // implicit conversion to absl::string_view.
   FixedString(  // NOLINT(google-explicit-constructor)
       const absl::string_view s) {
-    size_ = std::min(MaxSize, s.size());
-    std::copy(s.begin(), s.begin() + size_, data_.begin());
+    append(s);
   }
 
   // Truncates. No operation if full (`size() == MaxSize`).
   void append(const absl::string_view s) {
-    std::size_t new_size = std::min(MaxSize, size_ + s.size());
-    // Allowed because new_size >= size_.
-    std::size_t chars_to_write = new_size - size_;
-    std::copy(s.begin(), s.begin() + chars_to_write, data_.begin() + size_);
-    size_ = new_size;
+    const std::size_t count = std::min(s.size(), MaxSize - size_);
+    if (count > 0) {
+      std::memcpy(data_.data() + size_, s.data(), count);
+    }
+    size_ += count;
+  }
+
+  // Appends all `pieces`, truncating like append(). Bounds the total size
+  // once, so that each piece is a single copy.
+  void append(std::initializer_list<absl::string_view> pieces) {
+    std::size_t total_size = 0;
+    for (const absl::string_view piece : pieces) {
+      total_size += piece.size();
+    }
+    std::size_t remaining = std::min(total_size, MaxSize - size_);
+    char* out = data_.data() + size_;
+    size_ += remaining;
+    for (const absl::string_view piece : pieces) {
+      if (remaining == 0) {
+        break;
+      }
+      const std::size_t count = std::min(piece.size(), remaining);
+      std::memcpy(out, piece.data(), count);
+      out += count;
+      remaining -= count;
+    }
+  }
+
+  // Appends `value` in decimal, or, if it is floating point, with six
+  // significant digits like "%g". Formats directly into the unused capacity,
+  // and truncates like append().
+  template <typename Number>
+    requires(std::is_arithmetic_v<Number> && !std::is_same_v<Number, char>)
+  void append_number(Number value) {
+    char* const begin = data_.data() + size_;
+    const std::to_chars_result result =
+        ToChars(begin, data_.data() + MaxSize, value);
+    if (result.ec == std::errc()) {
+      size_ += result.ptr - begin;
+      return;
+    }
+    // Does not fit, so format aside and append what fits.
+    char buffer[kMaxNumberLength];
+    const std::to_chars_result full_result =
+        ToChars(buffer, buffer + kMaxNumberLength, value);
+    append(absl::string_view(buffer, full_result.ptr - buffer));
   }
 
   void resize(size_t count) {
@@ -71,29 +117,34 @@ class FixedString {
     size_ = count;
   }
 
+  void clear() { size_ = 0; }
+
   size_t size() const { return size_; }
   bool empty() const { return size_ == 0; }
   static constexpr size_t max_size() { return MaxSize; }
 
+  // Not null-terminated.
+  const char* data() const { return data_.data(); }
+
   char& operator[](size_t idx) {
     ABSL_HARDENING_ASSERT(idx < size());
     return data_[idx];
   }
 
   friend bool operator==(const FixedString& lhs, const FixedString& rhs) {
-    return std::equal(lhs.data_.begin(), lhs.data_.begin() + lhs.size_,
-                      rhs.data_.begin(), rhs.data_.begin() + rhs.size_) &&
-           lhs.size_ == rhs.size_;
+    return lhs.size_ == rhs.size_ &&
+           std::memcmp(lhs.data_.data(), rhs.data_.data(), lhs.size_) == 0;
   }
 
   friend bool operator!=(const FixedString& lhs, const FixedString& rhs) {
     return !(lhs == rhs);
   }
 
+  // Hashes like absl::string_view, so that hash tables keyed by FixedString
+  // can look up absl::string_view keys, see FixedStringHash.
   template <typename H>
   friend H AbslHashValue(H h, const FixedString& c) {
-    return H::combine(
-        H::combine_contiguous(std::move(h), c.data_.data(), c.size_), c.size_);
+    return H::combine(std::move(h), absl::string_view(c));
   }
 
   operator absl::string_view() const {  // NOLINT(google-explicit-constructor)
@@ -101,10 +152,48 @@ class FixedString {
   }
 
  private:
+  // Fits any integer, and any floating point number with six significant
+  // digits, e.g., "-1.79769e+308".
+  static constexpr size_t kMaxNumberLength = 32;
+
+  template <typename Number>
+  static std::to_chars_result ToChars(char* first, char* last, Number value) {
+    if constexpr (std::is_floating_point_v<Number>) {
+      return std::to_chars(first, last, value, std::chars_format::general,
+                           /*precision=*/6);
+    } else if constexpr (std::is_same_v<Number, bool>) {
+      return std::to_chars(first, last, static_cast<int>(value));
+    } else {
+      return std::to_chars(first, last, value);
+    }
+  }
+
   std::array<char, MaxSize> data_;
   std::size_t size_ = 0;
 };
 
+// Hash and equality for hash tables keyed by FixedString of any size, which
+// also look up absl::string_view keys without converting them, e.g.:
+//
+//   absl::flat_hash_map<FixedString<32>, int, FixedStringHash, FixedStringEq>
+//       map;
+//   auto it = map.find(absl::string_view("name"));
+struct FixedStringHash {
+  using is_transparent = void;
+
+  size_t operator()(absl::string_view s) const {
+    return absl::Hash<absl::string_view>()(s);
+  }
+};
+
+struct FixedStringEq {
+  using is_transparent = void;
+
+  bool operator()(absl::string_view lhs, absl::string_view rhs) const {
+    return lhs == rhs;
+  }
+};
+
 // Explicit function to convert a single character into a FixedString.
 inline FixedString<1> SingleCharacterString(char ch) {
   FixedString<1> str;
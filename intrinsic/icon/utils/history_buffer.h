@@ -0,0 +1,151 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_UTILS_HISTORY_BUFFER_H_
+#define INTRINSIC_ICON_UTILS_HISTORY_BUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace intrinsic {
+
+// A real time safe ring of the last `kDepth` states committed by a single
+// producer, which any number of consumers can read without blocking it.
+//
+// Companion to AsyncBuffer, which only hands out the latest state: consumers
+// that need the last few control cycles, e.g. to interpolate between two
+// states, can read any of them by generation instead of copying every cycle.
+//
+// Each slot is guarded by a sequence counter (a seqlock): the producer marks a
+// slot as being written, copies the state into it and then publishes its
+// generation. A consumer copies the slot out and keeps the copy only if the
+// slot held the requested generation before and after copying. Reads
+// therefore never block the producer, but fail if the producer overwrites the
+// slot in the meantime, i.e. if the state is about to drop out of the ring.
+//
+// The states are stored as relaxed atomic words, so T must be trivially
+// copyable.
+//
+// Producer, realtime safe:
+// \code
+// history.Commit(state);
+// \endcode
+//
+// Consumer, lock free:
+// \code
+// State latest, previous;
+// const uint64_t generation = history.latest_generation();
+// if (history.Read(generation, &latest) &&
+//     history.Read(generation - 1, &previous)) {
+//   Interpolate(previous, latest);
+// }
+// \endcode
+template <typename T, size_t kDepth>
+class HistoryBuffer {
+ public:
+  static_assert(std::is_trivially_copyable_v<T>,
+                "HistoryBuffer copies states word by word");
+  static_assert(kDepth > 0, "HistoryBuffer needs a slot");
+
+  HistoryBuffer() : slots_(std::make_unique<Slot[]>(kDepth)) {}
+
+  HistoryBuffer(const HistoryBuffer&) = delete;
+  HistoryBuffer& operator=(const HistoryBuffer&) = delete;
+
+  // Copies `value` into the ring as the next generation, replacing the oldest
+  // state once the ring is full. Must only be called by the producer.
+  void Commit(const T& value);
+
+  // Returns the generation of the latest commit. Generations start at 1 for
+  // the first commit, so 0 means nothing was committed yet.
+  uint64_t latest_generation() const {
+    return latest_generation_.load(std::memory_order_acquire);
+  }
+
+  // Copies the state of `generation` into `*value` and returns true. Returns
+  // false and leaves `*value` unspecified if that generation was not
+  // committed yet, has dropped out of the ring, or was overwritten while being
+  // copied.
+  bool Read(uint64_t generation, T* value) const;
+
+  // Copies the state committed `age` commits before the latest one (0 for
+  // the latest) into `*value` and returns its generation, or returns 0 if
+  // there is no such state in the ring. See Read().
+  uint64_t ReadRecent(size_t age, T* value) const;
+
+ private:
+  static constexpr size_t kNumWords =
+      (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  struct Slot {
+    // Twice the generation of the state in `words` once it is complete, odd
+    // while the producer writes to it.
+    std::atomic<uint64_t> sequence = 0;
+    std::atomic<uint64_t> words[kNumWords] = {};
+  };
+
+  Slot& SlotFor(uint64_t generation) const {
+    return slots_[generation % kDepth];
+  }
+
+  std::atomic<uint64_t> latest_generation_ = 0;
+  const std::unique_ptr<Slot[]> slots_;
+};
+
+template <typename T, size_t kDepth>
+void HistoryBuffer<T, kDepth>::Commit(const T& value) {
+  const uint64_t generation =
+      latest_generation_.load(std::memory_order_relaxed) + 1;
+  Slot& slot = SlotFor(generation);
+  uint64_t words[kNumWords] = {};
+  std::memcpy(words, &value, sizeof(T));
+
+  slot.sequence.store(2 * generation - 1, std::memory_order_relaxed);
+  // Orders the odd sequence before the words, so that a consumer that sees
+  // any new word also sees the slot as being written.
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t i = 0; i < kNumWords; ++i) {
+    slot.words[i].store(words[i], std::memory_order_relaxed);
+  }
+  slot.sequence.store(2 * generation, std::memory_order_release);
+  latest_generation_.store(generation, std::memory_order_release);
+}
+
+template <typename T, size_t kDepth>
+bool HistoryBuffer<T, kDepth>::Read(uint64_t generation, T* value) const {
+  if (generation == 0 || generation > latest_generation()) {
+    return false;
+  }
+  const Slot& slot = SlotFor(generation);
+  if (slot.sequence.load(std::memory_order_acquire) != 2 * generation) {
+    return false;
+  }
+  uint64_t words[kNumWords];
+  for (size_t i = 0; i < kNumWords; ++i) {
+    words[i] = slot.words[i].load(std::memory_order_relaxed);
+  }
+  // Orders the words before the second check of the sequence.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (slot.sequence.load(std::memory_order_relaxed) != 2 * generation) {
+    return false;
+  }
+  std::memcpy(value, words, sizeof(T));
+  return true;
+}
+
+template <typename T, size_t kDepth>
+uint64_t HistoryBuffer<T, kDepth>::ReadRecent(size_t age, T* value) const {
+  const uint64_t latest = latest_generation();
+  if (age >= kDepth || age >= latest) {
+    return 0;
+  }
+  const uint64_t generation = latest - age;
+  return Read(generation, value) ? generation : 0;
+}
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_ICON_UTILS_HISTORY_BUFFER_H_
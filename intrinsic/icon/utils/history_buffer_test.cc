@@ -0,0 +1,101 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/history_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+namespace {
+
+struct State {
+  uint64_t generation = 0;
+  double position = 0;
+  // Makes the size not a multiple of the word size.
+  uint8_t flag = 0;
+};
+
+State MakeState(uint64_t generation) {
+  return State{.generation = generation,
+               .position = 0.5 * generation,
+               .flag = static_cast<uint8_t>(generation)};
+}
+
+TEST(HistoryBufferTest, ReadsLastStates) {
+  HistoryBuffer<State, 3> history;
+  State state;
+  EXPECT_EQ(history.latest_generation(), 0);
+  EXPECT_FALSE(history.Read(0, &state));
+  EXPECT_EQ(history.ReadRecent(0, &state), 0);
+
+  for (uint64_t generation = 1; generation <= 5; ++generation) {
+    history.Commit(MakeState(generation));
+  }
+  EXPECT_EQ(history.latest_generation(), 5);
+  for (uint64_t generation = 3; generation <= 5; ++generation) {
+    ASSERT_TRUE(history.Read(generation, &state));
+    EXPECT_EQ(state.generation, generation);
+    EXPECT_EQ(state.position, 0.5 * generation);
+    EXPECT_EQ(state.flag, generation);
+  }
+  // Dropped out of the ring, or not committed yet.
+  EXPECT_FALSE(history.Read(2, &state));
+  EXPECT_FALSE(history.Read(6, &state));
+
+  EXPECT_EQ(history.ReadRecent(0, &state), 5);
+  EXPECT_EQ(state.generation, 5);
+  EXPECT_EQ(history.ReadRecent(2, &state), 3);
+  EXPECT_EQ(state.generation, 3);
+  EXPECT_EQ(history.ReadRecent(3, &state), 0);
+}
+
+TEST(HistoryBufferTest, ConcurrentReadsAreConsistent) {
+  constexpr uint64_t kNumCommits = 200000;
+  HistoryBuffer<State, 4> history;
+  std::atomic<bool> done = false;
+  std::atomic<int> num_ready_readers = 0;
+  std::atomic<uint64_t> num_reads = 0;
+
+  auto read = [&]() {
+    State state;
+    ++num_ready_readers;
+    while (!done) {
+      const uint64_t generation = history.latest_generation();
+      for (uint64_t age = 0; age < 4 && age < generation; ++age) {
+        if (history.Read(generation - age, &state)) {
+          // A torn read would mix fields of different generations.
+          ASSERT_EQ(state.generation, generation - age);
+          ASSERT_EQ(state.position, 0.5 * state.generation);
+          ASSERT_EQ(state.flag, static_cast<uint8_t>(state.generation));
+          ++num_reads;
+        }
+      }
+    }
+  };
+  Thread reader1(read);
+  Thread reader2(read);
+  while (num_ready_readers < 2) {
+    std::this_thread::yield();
+  }
+  // Keeps committing until a read succeeded, since the readers may not be
+  // scheduled while this thread commits, e.g. on a single CPU.
+  for (uint64_t generation = 1; generation <= kNumCommits || num_reads == 0;
+       ++generation) {
+    history.Commit(MakeState(generation));
+    if (generation >= kNumCommits) {
+      std::this_thread::yield();
+    }
+  }
+  done = true;
+  reader1.Join();
+  reader2.Join();
+  EXPECT_GT(num_reads, 0);
+}
+
+}  // namespace
+}  // namespace intrinsic
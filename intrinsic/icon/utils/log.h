@@ -27,6 +27,9 @@
 //   // Logs at most once every 2 seconds.
 //   INTRINSIC_RT_LOG_THROTTLED(WARNING) << "limit exceeded";
 //
+//   // Logs a burst of messages, then at most once per second.
+//   INTRINSIC_RT_LOG_RATE_LIMITED(ERROR) << "fault: " << fault_code;
+//
 // FATAL LOGGING
 // -------------
 // None of these macros is fatal.  For a non-recoverable error use
@@ -40,6 +43,29 @@
 // It also prints a count how many messages were ignored.
 // This logging function is useful to avoid log spam for
 // high-frequency calls (for example, every millisecond).
+//
+// INTRINSIC_RT_LOG_RATE_LIMITED logs a burst of up to 10 messages per call
+// site, and one message per second after that. On the next logged message, it
+// reports how many calls were suppressed.
+//
+// Both macros also share a global budget of log messages, so that a storm of
+// faults at many call sites cannot flood the log either, and logging takes
+// bounded time per cycle. Calls beyond the budget are suppressed and reported
+// like repetitions.
+//
+// DEFERRED LOGGING
+// ----------------
+// INTRINSIC_RT_LOG_DEFERRED takes a format string literal with one "{}" per
+// argument, and only copies the raw bytes of the arguments (bool, integers,
+// floating-point numbers and strings):
+//
+//   INTRINSIC_RT_LOG_DEFERRED(INFO, "joint {} at position {}", i, position[i]);
+//
+// The arguments are converted to text later, in the non-real-time thread of
+// the RealtimeLogSink, so this is cheaper than INTRINSIC_RT_LOG in a control
+// cycle. It supports at most LogSinkInterface::kLogRecordMaxArgs arguments
+// with a total of LogSinkInterface::kLogRecordArgsMaxSize bytes; strings are
+// truncated and excess arguments dropped.
 
 namespace intrinsic {
 
@@ -71,6 +97,18 @@ void RtLogInitForThisThread();
           INTRINSIC_LOC)
 // NOLINTEND(readability/braces)
 
+// NOLINTBEGIN(readability/braces)
+#define INTRINSIC_RT_LOG_RATE_LIMITED(SEVERITY)                                \
+  if (static ::intrinsic::icon::internal::LogRateLimiter rate_limiter; true) \
+    if (auto result = rate_limiter.Tick(                                      \
+            ::intrinsic::icon::GlobalLogContext::GetTime);                    \
+        result.has_value())                                                   \
+  ::intrinsic::icon::internal::LogClient() +=                                 \
+      ::intrinsic::icon::internal::LogEntryBuilder::Create(                   \
+          ::intrinsic::icon::LogPriority::SEVERITY, result.value(),           \
+          INTRINSIC_LOC)
+// NOLINTEND(readability/braces)
+
 // Logs the message the first N times this macro instance is called.
 // NOLINTBEGIN(readability/braces)
 #define INTRINSIC_RT_LOG_FIRST_N(SEVERITY, N)                         \
@@ -83,6 +121,12 @@ void RtLogInitForThisThread();
 // Logs the first time it is called.
 #define INTRINSIC_RT_LOG_FIRST(SEVERITY) INTRINSIC_RT_LOG_FIRST_N(SEVERITY, 1)
 
+// Logs `FORMAT` with the arguments, deferring their formatting to the sink.
+#define INTRINSIC_RT_LOG_DEFERRED(SEVERITY, FORMAT, ...)                \
+  ::intrinsic::icon::internal::LogDeferred(                             \
+      ::intrinsic::icon::LogPriority::SEVERITY, INTRINSIC_LOC, FORMAT, \
+      ##__VA_ARGS__)
+
 // Documentation for developers of logging:
 // Filtering is implemented similar to absl/log/internal/conditions.h
 // Also, the if clause will error if prefixes (like intrinsic::) are used,
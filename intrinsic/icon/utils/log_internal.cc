@@ -18,6 +18,7 @@
 #include <optional>
 #include <utility>
 
+#include "absl/base/attributes.h"
 #include "absl/log/log.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
@@ -32,6 +33,8 @@ struct LoggerThreadInfo {
   std::unique_ptr<LogSinkInterface> logger;
   // Existing log entry in call stack to detect recursive logging.
   LogSinkInterface::LogEntry* log_entry = nullptr;
+  // Existing log record in call stack to detect recursive logging.
+  const LogSinkInterface::LogRecord* log_record = nullptr;
 };
 
 }  // namespace internal
@@ -117,8 +120,11 @@ std::optional<LogThrottler::Result> LogThrottler::Tick(
   result.period_nanoseconds = result.robot_timestamp_ns - first_log_time;
   result.num_calls_merged = num_calls_merged;
   int64_t delta = result.robot_timestamp_ns - last_log_time;
-  if (num_calls_merged >= kMaxDeduplicationCount ||
-      delta >= kSpamPeriodNanoseconds) {
+  // Without global budget, keeps merging calls. They are reported once the
+  // budget has been refilled.
+  if ((num_calls_merged >= kMaxDeduplicationCount ||
+       delta >= kSpamPeriodNanoseconds) &&
+      GlobalLogBudget().TryTake(result.robot_timestamp_ns)) {
     // Log and reset.
     last_log_time = result.robot_timestamp_ns;
     num_calls_merged = 0;
@@ -127,6 +133,56 @@ std::optional<LogThrottler::Result> LogThrottler::Tick(
   return {};
 }
 
+bool LogTokenBucket::TryTake(int64_t now_ns) {
+  int64_t full_time_ns = full_time_ns_.load(std::memory_order_relaxed);
+  for (int attempt = 0; attempt < kMaxAttempts; ++attempt) {
+    int64_t start_ns = std::max(full_time_ns, now_ns);
+    // A full time beyond the capacity means that the clock changed, e.g. by
+    // GlobalLogContext::SetTimeFunction().
+    if (start_ns > now_ns + burst_tolerance_ns_ + refill_period_ns_) {
+      start_ns = now_ns;
+    }
+    if (start_ns - now_ns > burst_tolerance_ns_) {
+      return false;
+    }
+    if (full_time_ns_.compare_exchange_weak(full_time_ns,
+                                            start_ns + refill_period_ns_,
+                                            std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Allows sustained 100 messages per second, after a burst of 200.
+static constexpr int64_t kGlobalLogBudgetRefillPeriodNanoseconds = 1.0e7;
+static constexpr int32_t kGlobalLogBudgetCapacity = 200;
+
+ABSL_CONST_INIT static LogTokenBucket s_global_log_budget(
+    kGlobalLogBudgetRefillPeriodNanoseconds, kGlobalLogBudgetCapacity);
+
+LogTokenBucket& GlobalLogBudget() { return s_global_log_budget; }
+
+std::optional<LogThrottler::Result> LogRateLimiter::Tick(
+    LogThrottler::GetTimeFunction get_time_function) {
+  LogThrottler::Result result;
+  get_time_function(&result.robot_timestamp_ns, &result.wall_timestamp_ns);
+  if (!bucket_.TryTake(result.robot_timestamp_ns) ||
+      !GlobalLogBudget().TryTake(result.robot_timestamp_ns)) {
+    if (num_calls_suppressed_.fetch_add(1) == 0) {
+      first_suppressed_time_ = result.robot_timestamp_ns;
+    }
+    return std::nullopt;
+  }
+  int32_t num_calls_suppressed = num_calls_suppressed_.exchange(0);
+  result.num_calls_merged = num_calls_suppressed + 1;
+  if (num_calls_suppressed > 0) {
+    result.period_nanoseconds =
+        result.robot_timestamp_ns - first_suppressed_time_;
+  }
+  return result;
+}
+
 void LogClient::operator+=(LogEntryBuilder& builder) const {
   int save_errno = errno;
   if (builder.throttler_result().num_calls_merged > 1) {
@@ -152,7 +208,7 @@ void LogClient::operator+=(LogEntryBuilder& builder) const {
 
   // Fail on recursive log calls.
   internal::LoggerThreadInfo& info = GetThreadInfo();
-  if (info.log_entry != nullptr) {
+  if (info.log_entry != nullptr || info.log_record != nullptr) {
     [&]() INTRINSIC_SUPPRESS_REALTIME_CHECK {
       LOG(FATAL) << "Recursive INTRINSIC_RT_LOG log call at " << entry.filename
                  << " line " << entry.line;
@@ -165,5 +221,22 @@ void LogClient::operator+=(LogEntryBuilder& builder) const {
   errno = save_errno;
 }
 
+void SubmitLogRecord(const LogSinkInterface::LogRecord& record) {
+  int save_errno = errno;
+  // Fail on recursive log calls.
+  internal::LoggerThreadInfo& info = GetThreadInfo();
+  if (info.log_entry != nullptr || info.log_record != nullptr) {
+    [&]() INTRINSIC_SUPPRESS_REALTIME_CHECK {
+      LOG(FATAL) << "Recursive INTRINSIC_RT_LOG log call at "
+                 << record.filename << " line " << record.line;
+    }();
+  }
+  info.log_record = &record;
+  GlobalLogContext::GetThreadLocalLogSinkOrFallback().LogDeferred(record);
+  info.log_record = nullptr;
+
+  errno = save_errno;
+}
+
 }  // namespace internal
 }  // namespace intrinsic::icon
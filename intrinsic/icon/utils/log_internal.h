@@ -6,10 +6,14 @@
 #include <errno.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <optional>
+#include <type_traits>
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -65,6 +69,67 @@ struct LogThrottler {
   std::atomic<int64_t> last_log_time = 0;
 };
 
+// A lock-free token bucket, implemented by the generic cell rate algorithm:
+// Instead of a token count, it stores the time at which the bucket would be
+// full again.
+// Thread-safe and real-time safe. Can be constant-initialized, so that it
+// lives in static storage without any initialization at runtime.
+class LogTokenBucket {
+ public:
+  // Refills one token every `refill_period_ns`, and holds at most `capacity`
+  // tokens.
+  constexpr LogTokenBucket(int64_t refill_period_ns, int32_t capacity)
+      : refill_period_ns_(refill_period_ns),
+        burst_tolerance_ns_(refill_period_ns * (capacity - 1)) {}
+
+  LogTokenBucket(const LogTokenBucket&) = delete;
+  LogTokenBucket& operator=(const LogTokenBucket&) = delete;
+
+  // Takes a token at `now_ns`. Returns false if the bucket is empty. Gives up
+  // after a few attempts if other threads take tokens concurrently, so that
+  // it returns in bounded time.
+  bool TryTake(int64_t now_ns);
+
+ private:
+  static constexpr int kMaxAttempts = 4;
+
+  const int64_t refill_period_ns_;
+  const int64_t burst_tolerance_ns_;
+  // The time at which the bucket is full again.
+  std::atomic<int64_t> full_time_ns_ = 0;
+};
+
+// The budget for all throttled and rate-limited log calls of the process, so
+// that many call sites together cannot flood the log sinks either. Takes
+// effect only after the per-call-site limits.
+LogTokenBucket& GlobalLogBudget();
+
+// Limits a INTRINSIC_RT_LOG_RATE_LIMITED call site to a burst of
+// `kCallSiteCapacity` messages, refilled by one message per
+// `kCallSiteRefillPeriodNanoseconds`, and by the GlobalLogBudget().
+// Thread-safe.
+class LogRateLimiter {
+ public:
+  static constexpr int64_t kCallSiteRefillPeriodNanoseconds = 1.0e9;
+  static constexpr int32_t kCallSiteCapacity = 10;
+
+  constexpr LogRateLimiter()
+      : bucket_(kCallSiteRefillPeriodNanoseconds, kCallSiteCapacity) {}
+
+  // Counts a call and decides if it should log. The result reports the calls
+  // that were suppressed since the last logged one.
+  // Returns nullopt if the call should be suppressed.
+  std::optional<LogThrottler::Result> Tick(
+      LogThrottler::GetTimeFunction get_time_function = LogGetTime);
+
+ private:
+  LogTokenBucket bucket_;
+  // Number of calls that were suppressed since the last logged one.
+  std::atomic<int32_t> num_calls_suppressed_ = 0;
+  // Time of the oldest suppressed call.
+  std::atomic<int64_t> first_suppressed_time_ = 0;
+};
+
 }  // namespace internal
 
 // Holds global and thread-local logger and configuration.
@@ -176,6 +241,86 @@ class LogClient {
   void operator+=(LogEntryBuilder& builder) const;
 };
 
+// Appends `size` raw bytes of an argument of `type` to `record`. Drops the
+// argument if `record` is full, like FixedStrCat drops excess pieces.
+inline void AppendLogRecordArg(LogSinkInterface::LogRecord& record,
+                               LogSinkInterface::LogArgType type,
+                               const void* data, size_t size) {
+  if (record.num_args >= LogSinkInterface::kLogRecordMaxArgs ||
+      record.args_size + size > LogSinkInterface::kLogRecordArgsMaxSize) {
+    return;
+  }
+  std::memcpy(record.args + record.args_size, data, size);
+  record.args_size += size;
+  record.arg_types[record.num_args++] = type;
+}
+
+// Appends a string argument to `record`, truncating it to the remaining
+// space.
+inline void AppendLogRecordArg(LogSinkInterface::LogRecord& record,
+                               absl::string_view value) {
+  size_t remaining =
+      LogSinkInterface::kLogRecordArgsMaxSize - record.args_size;
+  if (record.num_args >= LogSinkInterface::kLogRecordMaxArgs ||
+      remaining < sizeof(uint16_t)) {
+    return;
+  }
+  uint16_t size = std::min(value.size(), remaining - sizeof(uint16_t));
+  std::memcpy(record.args + record.args_size, &size, sizeof(size));
+  std::memcpy(record.args + record.args_size + sizeof(size), value.data(),
+              size);
+  record.args_size += sizeof(size) + size;
+  record.arg_types[record.num_args++] = LogSinkInterface::LogArgType::kString;
+}
+
+// Appends the raw bytes of `value` to `record`. Supports bool, integer,
+// floating-point and string-like types (anything convertible to
+// absl::string_view, including FixedString).
+template <typename T>
+void AppendLogRecordArg(LogSinkInterface::LogRecord& record, const T& value) {
+  if constexpr (std::is_same_v<T, bool>) {
+    AppendLogRecordArg(record, LogSinkInterface::LogArgType::kBool, &value,
+                       sizeof(value));
+  } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    int64_t raw = value;
+    AppendLogRecordArg(record, LogSinkInterface::LogArgType::kInt64, &raw,
+                       sizeof(raw));
+  } else if constexpr (std::is_integral_v<T>) {
+    uint64_t raw = value;
+    AppendLogRecordArg(record, LogSinkInterface::LogArgType::kUint64, &raw,
+                       sizeof(raw));
+  } else if constexpr (std::is_floating_point_v<T>) {
+    double raw = value;
+    AppendLogRecordArg(record, LogSinkInterface::LogArgType::kDouble, &raw,
+                       sizeof(raw));
+  } else {
+    AppendLogRecordArg(record, absl::string_view(value));
+  }
+}
+
+// Passes `record` to the thread-local LogSink.
+void SubmitLogRecord(const LogSinkInterface::LogRecord& record);
+
+// Captures the arguments of INTRINSIC_RT_LOG_DEFERRED without converting them
+// to text. `format` must be a string literal, since only its address is
+// stored.
+template <size_t N, typename... Args>
+void LogDeferred(LogPriority priority,
+                 intrinsic::SourceLocation source_location,
+                 const char (&format)[N], const Args&... args) {
+  static_assert(sizeof...(Args) <= LogSinkInterface::kLogRecordMaxArgs,
+                "Too many arguments for INTRINSIC_RT_LOG_DEFERRED");
+  LogSinkInterface::LogRecord record;
+  record.priority = priority;
+  GlobalLogContext::GetTime(&record.robot_timestamp_ns,
+                            &record.wall_timestamp_ns);
+  record.filename = source_location.file_name();
+  record.line = source_location.line();
+  record.format = format;
+  (AppendLogRecordArg(record, args), ...);
+  SubmitLogRecord(record);
+}
+
 }  // namespace internal
 }  // namespace intrinsic::icon
 
@@ -2,13 +2,19 @@
 
 #include "intrinsic/icon/utils/log_sink.h"
 
+#include <ctype.h>
+
 #include <algorithm>
 #include <cinttypes>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <string>
 
 #include "absl/log/check.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 
 namespace intrinsic::icon {
@@ -59,6 +65,87 @@ int LogEntryFormatToBuffer(char* buffer, int buffer_size,
   return std::min(num_chars, buffer_size - 1);
 }
 
+void LogSinkInterface::LogDeferred(const LogRecord& record) {
+  LogEntry entry;
+  LogRecordToEntry(record, &entry);
+  Log(entry);
+}
+
+void LogRecordToEntry(const LogSinkInterface::LogRecord& record,
+                      LogSinkInterface::LogEntry* entry) {
+  entry->priority = record.priority;
+  entry->robot_timestamp_ns = record.robot_timestamp_ns;
+  entry->wall_timestamp_ns = record.wall_timestamp_ns;
+  entry->filename = record.filename;
+  entry->line = record.line;
+
+  size_t msglen = 0;
+  auto append = [entry, &msglen](absl::string_view piece) {
+    size_t size =
+        std::min(piece.size(), LogSinkInterface::kLogMessageMaxSize - msglen);
+    std::memcpy(entry->msg + msglen, piece.data(), size);
+    msglen += size;
+  };
+
+  const char* arg = record.args;
+  int arg_index = 0;
+  absl::string_view format = record.format;
+  while (!format.empty()) {
+    size_t placeholder = format.find("{}");
+    append(format.substr(0, placeholder));
+    if (placeholder == absl::string_view::npos) {
+      break;
+    }
+    format.remove_prefix(placeholder + 2);
+    if (arg_index >= record.num_args) {
+      append("{}");
+      continue;
+    }
+    switch (record.arg_types[arg_index++]) {
+      case LogSinkInterface::LogArgType::kBool:
+        append(*arg != 0 ? "true" : "false");
+        arg += 1;
+        break;
+      case LogSinkInterface::LogArgType::kInt64: {
+        int64_t value;
+        std::memcpy(&value, arg, sizeof(value));
+        append(absl::AlphaNum(value).Piece());
+        arg += sizeof(value);
+        break;
+      }
+      case LogSinkInterface::LogArgType::kUint64: {
+        uint64_t value;
+        std::memcpy(&value, arg, sizeof(value));
+        append(absl::AlphaNum(value).Piece());
+        arg += sizeof(value);
+        break;
+      }
+      case LogSinkInterface::LogArgType::kDouble: {
+        double value;
+        std::memcpy(&value, arg, sizeof(value));
+        append(absl::AlphaNum(value).Piece());
+        arg += sizeof(value);
+        break;
+      }
+      case LogSinkInterface::LogArgType::kString: {
+        uint16_t size;
+        std::memcpy(&size, arg, sizeof(size));
+        arg += sizeof(size);
+        append(absl::string_view(arg, size));
+        arg += size;
+        break;
+      }
+    }
+  }
+
+  // Strip trailing newlines and spaces, like INTRINSIC_RT_LOG.
+  while (msglen > 0 && isspace(entry->msg[msglen - 1])) {
+    --msglen;
+  }
+  entry->msg[msglen] = 0;
+  entry->msglen = msglen;
+}
+
 void StderrLogSink::Log(const LogEntry& entry) {
   char buffer[kLogMessageMaxSize] = {0};
   LogEntryFormatToBuffer(buffer, sizeof(buffer), entry);
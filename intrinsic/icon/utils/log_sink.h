@@ -38,6 +38,42 @@ class LogSinkInterface {
     char msg[kLogMessageMaxSize + 1];
   };
 
+  // Maximum number of arguments of a LogRecord.
+  static constexpr size_t kLogRecordMaxArgs = 16;
+  // Bytes available for the raw arguments of a LogRecord.
+  static constexpr size_t kLogRecordArgsMaxSize = 512;
+
+  enum class LogArgType : uint8_t { kBool, kInt64, kUint64, kDouble, kString };
+
+  // A log message whose arguments have not been formatted yet, see
+  // INTRINSIC_RT_LOG_DEFERRED.
+  //
+  // A LogRecord is much smaller than a LogEntry and is filled without any
+  // string conversion, so it is cheap to write on a real-time thread.
+  struct LogRecord {
+    LogPriority priority = LogPriority::INFO;
+    // Nanoseconds since epoch from a monotonic system-wide clock.
+    int64_t robot_timestamp_ns = 0;
+    // Nanoseconds since epoch from a system-wide real-time clock.
+    int64_t wall_timestamp_ns = 0;
+    // File name where the log was written.
+    // Must be a string that never changes.
+    const char* filename = "";
+    // Line number where the log was written.
+    int32_t line = 0;
+    // Format of the message, with one "{}" per argument. Identifies the
+    // message, so it must be a string that never changes.
+    const char* format = "";
+    // Number of arguments in `args`.
+    uint8_t num_args = 0;
+    // Bytes in `args`.
+    uint16_t args_size = 0;
+    LogArgType arg_types[kLogRecordMaxArgs];
+    // Raw arguments. Numbers are stored as int64_t, uint64_t or double and
+    // strings as an uint16_t size followed by their characters.
+    char args[kLogRecordArgsMaxSize];
+  };
+
   virtual ~LogSinkInterface() = default;
 
   // Writes incoming log entries.
@@ -47,6 +83,13 @@ class LogSinkInterface {
   // It is forbidden to call INTRINSIC_RT_LOG inside this function or call Log
   // recursively.
   virtual void Log(const LogEntry& entry) = 0;
+
+  // Writes incoming log records.
+  // The default implementation formats the record with LogRecordToEntry and
+  // calls Log(). Real-time safe implementations may instead format the record
+  // in a lower-priority thread.
+  // The same restrictions as for Log() apply.
+  virtual void LogDeferred(const LogRecord& record);
 };
 
 // Returns the string name for priority.
@@ -63,6 +106,14 @@ int LogEntryFormatToBuffer(char* buffer, int buffer_size,
                            const LogSinkInterface::LogEntry& entry,
                            absl::TimeZone timezone = absl::UTCTimeZone());
 
+// Formats a log `record` into `entry`, replacing each "{}" in the format with
+// the next argument. Placeholders without argument are kept as is, arguments
+// without placeholder are dropped. Truncates the message if it exceeds
+// LogSinkInterface::kLogMessageMaxSize.
+// Does not allocate.
+void LogRecordToEntry(const LogSinkInterface::LogRecord& record,
+                      LogSinkInterface::LogEntry* entry);
+
 // A default logger class that writes the log to standard error.
 class StderrLogSink : public LogSinkInterface {
  public:
@@ -5,6 +5,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -179,5 +180,103 @@ TEST(IconUtilsLogTest, LogFirstNDoesNotAllocate) {
   }
 }
 
+int64_t s_fake_time_ns = 0;
+
+void GetFakeTime(int64_t* robot_timestamp_ns, int64_t* wall_timestamp_ns) {
+  *robot_timestamp_ns = s_fake_time_ns;
+  *wall_timestamp_ns = s_fake_time_ns;
+}
+
+TEST(IconUtilsLogTest, RateLimits) {
+  auto unique_logger = std::make_unique<FakeLogger>();
+  auto* logger = unique_logger.get();
+  GlobalLogContext::SetThreadLocalLogSink(std::move(unique_logger));
+  // Later than the real clock of the global budget.
+  s_fake_time_ns = int64_t{1} << 60;
+  GlobalLogContext::SetTimeFunction(GetFakeTime);
+  auto log = [](int i) { INTRINSIC_RT_LOG_RATE_LIMITED(ERROR) << "i:" << i; };
+  for (int i = 0; i < 20; ++i) {
+    log(i);
+  }
+  s_fake_time_ns += internal::LogRateLimiter::kCallSiteRefillPeriodNanoseconds;
+  log(20);
+  GlobalLogContext::SetTimeFunction(nullptr);
+  ASSERT_EQ(logger->messages_.size(), 11);
+  EXPECT_THAT(logger->messages_[9], StrEq("i:9"));
+  EXPECT_THAT(logger->messages_[10],
+              StrEq("i:20 (repeated 11 times in 1s)"));
+}
+
+TEST(IconUtilsLogTest, TokenBucketRefills) {
+  internal::LogTokenBucket bucket(/*refill_period_ns=*/100, /*capacity=*/3);
+  EXPECT_TRUE(bucket.TryTake(1000));
+  EXPECT_TRUE(bucket.TryTake(1000));
+  EXPECT_TRUE(bucket.TryTake(1000));
+  EXPECT_FALSE(bucket.TryTake(1000));
+  EXPECT_FALSE(bucket.TryTake(1099));
+  EXPECT_TRUE(bucket.TryTake(1100));
+  EXPECT_FALSE(bucket.TryTake(1100));
+  // Refills completely, but not beyond the capacity.
+  EXPECT_TRUE(bucket.TryTake(2000));
+  EXPECT_TRUE(bucket.TryTake(2000));
+  EXPECT_TRUE(bucket.TryTake(2000));
+  EXPECT_FALSE(bucket.TryTake(2000));
+  // Recovers from a clock that jumps back.
+  EXPECT_TRUE(bucket.TryTake(0));
+}
+
+TEST(IconUtilsLogTest, LogsDeferred) {
+  auto unique_logger = std::make_unique<FakeLogger>();
+  auto* logger = unique_logger.get();
+  GlobalLogContext::SetThreadLocalLogSink(std::move(unique_logger));
+  std::string s = "text";
+  INTRINSIC_RT_LOG_DEFERRED(ERROR, "dof:{} d:{} u:{} b:{} s:{}", 3, 0.5,
+                            uint8_t{7}, true, s);
+  auto location = INTRINSIC_LOC;
+  std::string expected_line_number = absl::StrCat(":", location.line() - 2);
+  EXPECT_THAT(logger->messages_,
+              ElementsAre(StrEq("dof:3 d:0.5 u:7 b:true s:text")));
+  EXPECT_THAT(logger->text_,
+              ElementsAre(AllOf(StartsWith("E"), HasSubstr("log_test.cc"),
+                                HasSubstr("dof:3 d:0.5 u:7 b:true s:text"))));
+}
+
+TEST(IconUtilsLogTest, LogsDeferredWithMismatchedArguments) {
+  auto unique_logger = std::make_unique<FakeLogger>();
+  auto* logger = unique_logger.get();
+  GlobalLogContext::SetThreadLocalLogSink(std::move(unique_logger));
+  INTRINSIC_RT_LOG_DEFERRED(INFO, "no arguments  ");
+  INTRINSIC_RT_LOG_DEFERRED(INFO, "missing {} and {}", 1);
+  INTRINSIC_RT_LOG_DEFERRED(INFO, "excess {}", 1, 2);
+  EXPECT_THAT(logger->messages_,
+              ElementsAre(StrEq("no arguments"), StrEq("missing 1 and {}"),
+                          StrEq("excess 1")));
+}
+
+TEST(IconUtilsLogTest, LogDeferredTruncatesStrings) {
+  auto unique_logger = std::make_unique<FakeLogger>();
+  auto* logger = unique_logger.get();
+  GlobalLogContext::SetThreadLocalLogSink(std::move(unique_logger));
+  std::string long_string(2 * LogSinkInterface::kLogRecordArgsMaxSize, 'x');
+  INTRINSIC_RT_LOG_DEFERRED(INFO, "{}{}", long_string, 1);
+  // The string is cut to the argument bytes, without its size, and the
+  // integer does not fit anymore.
+  std::string expected(
+      LogSinkInterface::kLogRecordArgsMaxSize - sizeof(uint16_t), 'x');
+  EXPECT_THAT(logger->messages_, ElementsAre(absl::StrCat(expected, "{}")));
+}
+
+TEST(IconUtilsLogTest, LogDeferredDoesNotAllocate) {
+  GlobalLogContext::SetThreadLocalLogSink(nullptr);
+  RtLogInitForThisThread();
+  double d = 0.5;
+  std::string s = "text";
+  INTRINSIC_RT_LOG_DEFERRED(INFO, "dof:{} d:{}", 3, d);
+  INTRINSIC_RT_LOG_DEFERRED(ERROR, "error: {}", s);
+  for (int i = 0; i < 2000; ++i) {
+    INTRINSIC_RT_LOG_DEFERRED(WARNING, "often logged i:{}", i);
+  }
+}
+
 }  // namespace
 }  // namespace intrinsic::icon
@@ -4,8 +4,15 @@
 
 #include <dlfcn.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
 
+#include "absl/base/attributes.h"
 #include "absl/debugging/stacktrace.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
@@ -26,6 +33,78 @@ struct ThreadLocalInfo {
 
 thread_local ThreadLocalInfo s_current_thread;
 
+constexpr size_t kMaxViolationFrames = 16;
+constexpr size_t kMaxViolationThreadNameLength = 32;
+
+// An entry of the violation samples table. Claimed by setting `signature`
+// and readable once `ready` is set.
+struct ViolationSlot {
+  std::atomic<uint64_t> signature = 0;
+  std::atomic<bool> ready = false;
+  std::atomic<int64_t> count = 0;
+  const char* file_name = nullptr;
+  int line = 0;
+  int num_frames = 0;
+  void* frames[kMaxViolationFrames];
+  size_t thread_name_length = 0;
+  char thread_name[kMaxViolationThreadNameLength];
+};
+
+ABSL_CONST_INIT ViolationSlot
+    s_violation_samples[RealTimeGuard::kMaxViolationSamples];
+ABSL_CONST_INIT std::atomic<int64_t> s_num_dropped_violation_samples = 0;
+
+uint64_t MixSignature(uint64_t signature, uint64_t value) {
+  return signature ^
+         (value + 0x9e3779b97f4a7c15 + (signature << 6) + (signature >> 2));
+}
+
+// Counts a violation at `loc` in the table of violation samples. This is
+// real-time safe, since it neither allocates nor locks.
+ABSL_ATTRIBUTE_NOINLINE void RecordViolationSample(
+    const intrinsic::SourceLocation& loc) {
+  void* frames[kMaxViolationFrames];
+  // Skips this function and TriggerRealtimeCheck().
+  const int num_frames =
+      absl::GetStackTrace(frames, kMaxViolationFrames, /*skip_count=*/2);
+  uint64_t signature =
+      MixSignature(reinterpret_cast<uintptr_t>(loc.file_name()), loc.line());
+  for (int i = 0; i < num_frames; ++i) {
+    signature = MixSignature(signature, reinterpret_cast<uintptr_t>(frames[i]));
+  }
+  // 0 marks free slots.
+  signature = std::max<uint64_t>(signature, 1);
+
+  for (size_t probe = 0; probe < RealTimeGuard::kMaxViolationSamples;
+       ++probe) {
+    ViolationSlot& slot =
+        s_violation_samples[(signature + probe) %
+                            RealTimeGuard::kMaxViolationSamples];
+    uint64_t slot_signature = slot.signature.load(std::memory_order_acquire);
+    if (slot_signature == 0 &&
+        slot.signature.compare_exchange_strong(slot_signature, signature,
+                                               std::memory_order_acq_rel)) {
+      slot.file_name = loc.file_name();
+      slot.line = loc.line();
+      slot.num_frames = num_frames;
+      std::memcpy(slot.frames, frames, num_frames * sizeof(void*));
+      slot.thread_name_length = std::min(s_current_thread.thread_name.size(),
+                                         kMaxViolationThreadNameLength);
+      std::memcpy(slot.thread_name, s_current_thread.thread_name.data(),
+                  slot.thread_name_length);
+      slot.ready.store(true, std::memory_order_release);
+      slot.count.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    // On a failed exchange, `slot_signature` is the one of the winner.
+    if (slot_signature == signature) {
+      slot.count.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+  s_num_dropped_violation_samples.fetch_add(1, std::memory_order_relaxed);
+}
+
 }  // namespace
 
 // Trigger a warning about an unsafe function called from real-time.
@@ -54,6 +133,10 @@ void TriggerRealtimeCheck(const intrinsic::SourceLocation& loc) {
       RealTimeGuard::LogErrorBacktrace();
       break;
     }
+    case RealTimeGuard::SAMPLE: {
+      RecordViolationSample(loc);
+      break;
+    }
     case RealTimeGuard::IGNORE: {
       break;
     }
@@ -108,6 +191,61 @@ void RealTimeGuard::LogErrorBacktrace() {
   }
 }
 
+std::vector<RealtimeViolationSample> RealTimeGuard::GetViolationSamples() {
+  INTRINSIC_ASSERT_NON_REALTIME();
+  std::vector<RealtimeViolationSample> samples;
+  for (const ViolationSlot& slot : s_violation_samples) {
+    if (!slot.ready.load(std::memory_order_acquire)) {
+      continue;
+    }
+    samples.push_back({
+        .file_name = slot.file_name,
+        .line = slot.line,
+        .thread_name = std::string(slot.thread_name, slot.thread_name_length),
+        .count = slot.count.load(std::memory_order_relaxed),
+        .frames = std::vector<void*>(slot.frames,
+                                     slot.frames + slot.num_frames),
+    });
+  }
+  return samples;
+}
+
+int64_t RealTimeGuard::NumDroppedViolationSamples() {
+  INTRINSIC_ASSERT_NON_REALTIME();
+  return s_num_dropped_violation_samples.load(std::memory_order_relaxed);
+}
+
+std::string RealTimeGuard::FormatViolationSamples() {
+  INTRINSIC_ASSERT_NON_REALTIME();
+  std::vector<RealtimeViolationSample> samples = GetViolationSamples();
+  std::sort(samples.begin(), samples.end(),
+            [](const RealtimeViolationSample& lhs,
+               const RealtimeViolationSample& rhs) {
+              return lhs.count > rhs.count;
+            });
+  std::string out;
+  for (const RealtimeViolationSample& sample : samples) {
+    absl::StrAppend(&out, sample.count, " violations at ", sample.file_name,
+                    ":", sample.line, " in thread '", sample.thread_name,
+                    "':\n");
+    for (size_t index = 0; index < sample.frames.size(); ++index) {
+      Dl_info info;
+      const char* name = "no symbol";
+      if (dladdr(sample.frames[index], &info) != 0 &&
+          info.dli_sname != nullptr) {
+        name = info.dli_sname;
+      }
+      absl::StrAppend(&out, "  #", absl::Dec(index, absl::kZeroPad2), ": '",
+                      name, "' (0x", absl::Hex(sample.frames[index]), ")\n");
+    }
+  }
+  if (const int64_t dropped = NumDroppedViolationSamples(); dropped > 0) {
+    absl::StrAppend(&out, dropped,
+                    " violations were not recorded, since the table is full\n");
+  }
+  return out;
+}
+
 void RealTimeGuard::SetCurrentThreadName(absl::string_view thread_name) {
   s_current_thread.thread_name = thread_name;
 }
@@ -3,11 +3,30 @@
 #ifndef INTRINSIC_ICON_UTILS_REALTIME_GUARD_H_
 #define INTRINSIC_ICON_UTILS_REALTIME_GUARD_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include "absl/strings/string_view.h"
 #include "intrinsic/icon/release/source_location.h"
 
 namespace intrinsic::icon {
 
+// A deduplicated real-time violation recorded by RealTimeGuard::SAMPLE.
+struct RealtimeViolationSample {
+  // Location of the INTRINSIC_ASSERT_NON_REALTIME() that was triggered.
+  const char* file_name = "";
+  int line = 0;
+  // Name of the thread of the first violation with this signature, see
+  // RealTimeGuard::SetCurrentThreadName().
+  std::string thread_name;
+  // Number of violations with this signature.
+  int64_t count = 0;
+  // Return addresses of the stack of the first violation, innermost first.
+  std::vector<void*> frames;
+};
+
 // RealTimeGuard is a debugging tool to mark a section of code as real-time
 // (RT). Real-time unsafe code can then assert that it is not called from a
 // section that is real-time guarded. For example:
@@ -39,8 +58,15 @@ class RealTimeGuard {
   enum Reaction {
     IGNORE = 0,  // Do nothing, silently proceed
     LOGE = 1,    // Log the function call as an error and proceed
-    PANIC = 2    // CHECK-fail and terminate the process immediately
+    PANIC = 2,   // CHECK-fail and terminate the process immediately
+    // Count the function call in the table of violation samples and proceed,
+    // see GetViolationSamples().
+    SAMPLE = 3
   };
+
+  // Number of distinct violations that SAMPLE keeps. Further distinct
+  // violations are only counted in NumDroppedViolationSamples().
+  static constexpr size_t kMaxViolationSamples = 64;
   /**
    * Enters the realtime section.
    *
@@ -75,6 +101,26 @@ class RealTimeGuard {
   // This function does not allocate and is real-time compatible.
   static void LogErrorBacktrace();
 
+  // Not real-time safe. Returns the violations recorded by the SAMPLE reaction
+  // of all threads since the process started, deduplicated by location and
+  // stack. Violations that are recorded concurrently may be missing.
+  //
+  // Unlike logging each violation, SAMPLE is cheap enough to run in
+  // production: It unwinds the stack, but writes only to a fixed, lock-free
+  // table. Dump the table on demand, e.g. with FormatViolationSamples(), to
+  // find allocations and system calls that happen on real-time threads under
+  // real load.
+  static std::vector<RealtimeViolationSample> GetViolationSamples();
+
+  // Not real-time safe. Returns the number of violations that SAMPLE did not
+  // record, because kMaxViolationSamples distinct violations were recorded
+  // already.
+  static int64_t NumDroppedViolationSamples();
+
+  // Not real-time safe. Returns a human readable, symbolized dump of
+  // GetViolationSamples(), ordered by count.
+  static std::string FormatViolationSamples();
+
   // Optional, only results in `thread_name` being shown in warnings and errors.
   // `thread_name` must outlive `RealTimeGuard`.
   static void SetCurrentThreadName(absl::string_view thread_name);
@@ -5,6 +5,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -12,6 +13,7 @@
 
 #include "absl/log/log.h"
 #include "absl/types/span.h"
+#include "intrinsic/icon/release/source_location.h"
 #include "intrinsic/icon/utils/log.h"
 #include "intrinsic/icon/utils/log_sink.h"
 #include "intrinsic/util/testing/gtest_wrapper.h"
@@ -23,6 +25,8 @@ using ::testing::Contains;
 using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 using ::testing::IsEmpty;
+using ::testing::Not;
+using ::testing::SizeIs;
 
 TEST(RealTimeGuardTest, DeathTest) {
   EXPECT_NO_THROW(INTRINSIC_ASSERT_NON_REALTIME());
@@ -97,5 +101,47 @@ TEST(RealTimeGuardTest, BacktraceContainsFunctionNames) {
                           "Backtrace:"));
 }
 
+int ViolateOnce() {
+  INTRINSIC_ASSERT_NON_REALTIME(INTRINSIC_LOC);
+  return __LINE__ - 1;
+}
+
+int ViolateAgain() {
+  INTRINSIC_ASSERT_NON_REALTIME(INTRINSIC_LOC);
+  return __LINE__ - 1;
+}
+
+TEST(RealTimeGuardTest, SampleCountsDeduplicatedViolations) {
+  int once_line = 0;
+  int again_line = 0;
+  {
+    RealTimeGuard guard(RealTimeGuard::Reaction::SAMPLE);
+    for (int i = 0; i < 3; ++i) {
+      once_line = ViolateOnce();
+    }
+    again_line = ViolateAgain();
+  }
+  // Outside of the guard, nothing is recorded.
+  ViolateOnce();
+
+  std::vector<RealtimeViolationSample> samples =
+      RealTimeGuard::GetViolationSamples();
+  ASSERT_THAT(samples, SizeIs(2));
+  std::sort(samples.begin(), samples.end(),
+            [](const RealtimeViolationSample& lhs,
+               const RealtimeViolationSample& rhs) {
+              return lhs.count > rhs.count;
+            });
+  EXPECT_EQ(samples[0].count, 3);
+  EXPECT_EQ(samples[0].line, once_line);
+  EXPECT_THAT(samples[0].file_name, HasSubstr("realtime_guard_test.cc"));
+  EXPECT_THAT(samples[0].frames, Not(IsEmpty()));
+  EXPECT_EQ(samples[1].count, 1);
+  EXPECT_EQ(samples[1].line, again_line);
+  EXPECT_EQ(RealTimeGuard::NumDroppedViolationSamples(), 0);
+  EXPECT_THAT(RealTimeGuard::FormatViolationSamples(),
+              HasSubstr("3 violations at "));
+}
+
 }  // namespace
 }  // namespace intrinsic::icon
@@ -8,27 +8,55 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
-#include <iostream>
-#include <memory>
-#include <ostream>
 #include <thread>  // NOLINT(build/c++11)
-#include <utility>
+#include <variant>
+#include <vector>
 
-#include "absl/base/thread_annotations.h"
-#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/log.h"
-#include "absl/synchronization/mutex.h"
 #include "absl/synchronization/notification.h"
 #include "absl/time/time.h"
-#include "intrinsic/icon/interprocess/binary_futex.h"
 #include "intrinsic/icon/utils/log_sink.h"
 #include "intrinsic/icon/utils/realtime_guard.h"
 #include "intrinsic/platform/common/buffers/realtime_write_queue.h"
+#include "intrinsic/platform/common/buffers/realtime_write_queue_set.h"
 
 namespace intrinsic::icon {
+namespace internal {
+
+// The queue of one RealtimeLogSink. Shared between the sink's thread and the
+// GlobalLogSink thread.
+struct RealtimeLogQueue {
+  RealtimeWriteQueue<QueuedLog> queue{/*capacity=*/1000};
+  // Messages that did not fit into `queue`. Only incremented by the sink.
+  std::atomic<uint64_t> num_dropped = 0;
+  // Set before the sink closes `queue` to remove it.
+  std::atomic<bool> removing = false;
+  // Notified by the GlobalLogSink thread once `queue` has been flushed and the
+  // thread no longer accesses this object.
+  absl::Notification removed;
+
+  // The following fields are only accessed by the GlobalLogSink thread, or
+  // before the queue has been handed over to it.
+
+  // Next queue in the list of queues that wait to be added.
+  RealtimeLogQueue* next_added = nullptr;
+  // Value of `num_dropped` that has been reported already.
+  uint64_t num_dropped_reported = 0;
+};
+
+}  // namespace internal
 
+// Prints the messages of all RealtimeLogSinks from a single non-RT thread.
+//
+// The sinks never lock: Adding a queue pushes it onto a lock-free list, and
+// removing it closes it. Only the reader thread changes the set of queues it
+// reads, so the mutex of `queue_set_` is never contended. The thread blocks in
+// an epoll wait on the event fds of all queues, and drains every ready queue
+// in one batch.
 class GlobalLogSink {
  public:
   GlobalLogSink()
@@ -51,81 +79,120 @@ class GlobalLogSink {
   }
   ~GlobalLogSink() {
     stop_reader_thread_ = true;
-    (void)notify_reader_.Post();
+    queue_set_.Wake();
     if (reader_thread_.joinable()) reader_thread_.join();
   }
 
-  RealtimeWriteQueue<LogSinkInterface::LogEntry>::RtWriter* CreateWriter() {
-    absl::MutexLock lock(&mutex_);
-    auto queue =
-        std::make_unique<RealtimeWriteQueue<LogSinkInterface::LogEntry>>(
-            /*capacity=*/1000);
-    auto* writer = &queue->Writer();
-    queues_[writer] = std::move(queue);
-    return writer;
+  // Returns a new queue, which the reader thread starts reading soon.
+  internal::RealtimeLogQueue* AddQueue() {
+    auto* queue = new internal::RealtimeLogQueue;
+    queue->next_added = added_queues_.load(std::memory_order_relaxed);
+    while (!added_queues_.compare_exchange_weak(queue->next_added, queue,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+    }
+    queue_set_.Wake();
+    return queue;
   }
 
-  void RemoveWriter(
-      RealtimeWriteQueue<LogSinkInterface::LogEntry>::RtWriter* writer) {
-    absl::MutexLock lock(&mutex_);
-    FlushAndRemoveWriter(writer);
+  // Closes `queue` and blocks until the reader thread has flushed it. Must be
+  // called by the thread that writes to `queue`.
+  void RemoveQueue(internal::RealtimeLogQueue* queue) {
+    queue->removing.store(true, std::memory_order_release);
+    queue->queue.Writer().Close();
+    // The queue may not have been added to `queue_set_` yet.
+    queue_set_.Wake();
+    queue->removed.WaitForNotification();
+    delete queue;
   }
 
   void Run() {
-    while (true) {
-      (void)notify_reader_.WaitFor(absl::InfiniteDuration());
-      if (stop_reader_thread_) break;
-      absl::MutexLock lock(&mutex_);
-      for (auto& [_, queue] : queues_) {
-        if (queue->Reader().Empty()) continue;
-        LogSinkInterface::LogEntry entry;
-        // Do not wait.
-        auto result =
-            queue->Reader().ReadWithTimeout(entry, absl::InfinitePast());
-        if (result != ReadResult::kConsumed) continue;
-        char buffer[LogSinkInterface::kLogMessageMaxSize];
-        LogEntryFormatToBuffer(buffer, sizeof(buffer), entry);
-        fprintf(stderr, "%s", buffer);
-        fflush(stderr);
-        if (!queue->Reader().Empty()) (void)notify_reader_.Post();
+    while (!stop_reader_thread_) {
+      // Blocks until any writer has written or closed its queue, or until
+      // AddQueue(), RemoveQueue() or the destructor wake the thread.
+      (void)queue_set_.Read(
+          [](RealtimeWriteQueue<internal::QueuedLog>&,
+             internal::QueuedLog& log) { PrintLog(log); });
+      TakeAddedQueues();
+      for (auto it = queues_.begin(); it != queues_.end();) {
+        internal::RealtimeLogQueue* queue = *it;
+        ReportDropped(*queue);
+        if (queue->removing.load(std::memory_order_acquire)) {
+          FlushAndRemove(queue);
+          it = queues_.erase(it);
+        } else {
+          ++it;
+        }
       }
     }
-    absl::MutexLock lock(&mutex_);
-    while (!queues_.empty()) {
-      FlushAndRemoveWriter(queues_.begin()->first);
+    TakeAddedQueues();
+    for (internal::RealtimeLogQueue* queue : queues_) {
+      FlushAndRemove(queue);
     }
+    queues_.clear();
   }
 
-  // RT safe.
-  void Notify() { (void)notify_reader_.Post(); }
-
  private:
-  void FlushAndRemoveWriter(
-      RealtimeWriteQueue<LogSinkInterface::LogEntry>::RtWriter* writer)
-      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
-    writer->Close();
-    auto& queue = queues_.find(writer)->second;
-    while (!queue->Reader().Empty()) {
+  // Starts reading the queues that were added since the last call.
+  void TakeAddedQueues() {
+    internal::RealtimeLogQueue* queue =
+        added_queues_.exchange(nullptr, std::memory_order_acquire);
+    for (; queue != nullptr; queue = queue->next_added) {
+      queue_set_.Add(&queue->queue);
+      queues_.push_back(queue);
+    }
+  }
+
+  // Prints the remaining messages of `queue` and hands it back to
+  // RemoveQueue(). `queue` must not be accessed afterwards.
+  void FlushAndRemove(internal::RealtimeLogQueue* queue) {
+    // After this, the reader thread no longer reads from the queue.
+    queue_set_.Remove(&queue->queue);
+    internal::QueuedLog log;
+    while (queue->queue.Reader().ReadWithTimeout(log, absl::InfinitePast()) ==
+           ReadResult::kConsumed) {
+      PrintLog(log);
+    }
+    ReportDropped(*queue);
+    queue->removed.Notify();
+  }
+
+  static void ReportDropped(internal::RealtimeLogQueue& queue) {
+    uint64_t num_dropped = queue.num_dropped.load(std::memory_order_relaxed);
+    if (num_dropped == queue.num_dropped_reported) {
+      return;
+    }
+    LOG(WARNING) << "Dropped " << num_dropped - queue.num_dropped_reported
+                 << " messages of a RealtimeLogSink, because its queue was "
+                    "full.";
+    queue.num_dropped_reported = num_dropped;
+  }
+
+  static void PrintLog(const internal::QueuedLog& log) {
+    if (const auto* record = std::get_if<LogSinkInterface::LogRecord>(&log)) {
       LogSinkInterface::LogEntry entry;
-      auto result =
-          queue->Reader().ReadWithTimeout(entry, absl::InfinitePast());
-      if (result != ReadResult::kConsumed) break;
-      char buffer[LogSinkInterface::kLogMessageMaxSize];
-      LogEntryFormatToBuffer(buffer, sizeof(buffer), entry);
-      fprintf(stderr, "%s", buffer);
-      fflush(stderr);
+      LogRecordToEntry(*record, &entry);
+      PrintEntry(entry);
+    } else {
+      PrintEntry(std::get<LogSinkInterface::LogEntry>(log));
     }
-    queues_.erase(writer);
   }
 
-  absl::Mutex mutex_;
-  absl::flat_hash_map<
-      RealtimeWriteQueue<LogSinkInterface::LogEntry>::RtWriter*,
-      std::unique_ptr<RealtimeWriteQueue<LogSinkInterface::LogEntry>>>
-      queues_ ABSL_GUARDED_BY(mutex_);
+  static void PrintEntry(const LogSinkInterface::LogEntry& entry) {
+    char buffer[LogSinkInterface::kLogMessageMaxSize];
+    LogEntryFormatToBuffer(buffer, sizeof(buffer), entry);
+    fprintf(stderr, "%s", buffer);
+    fflush(stderr);
+  }
+
+  // Lock-free list of queues that wait to be added, linked by `next_added`.
+  std::atomic<internal::RealtimeLogQueue*> added_queues_ = nullptr;
+  // Only accessed by the reader thread.
+  std::vector<internal::RealtimeLogQueue*> queues_;
   absl::Notification reader_thread_started_;
   std::atomic<bool> stop_reader_thread_ = false;
-  BinaryFutex notify_reader_;
+  // Wakes the reader thread whenever any of the queues is written to.
+  RealtimeWriteQueueSet<internal::QueuedLog> queue_set_;
   // We cannot use intrinsic::Thread here to avoid cyclic dependency.
   std::thread reader_thread_;
 };
@@ -138,18 +205,37 @@ GlobalLogSink& GetGlobalLogSink() {
 
 RealtimeLogSink::RealtimeLogSink() {
   INTRINSIC_ASSERT_NON_REALTIME();
-  writer_ = GetGlobalLogSink().CreateWriter();
+  queue_ = GetGlobalLogSink().AddQueue();
 }
 
 RealtimeLogSink::~RealtimeLogSink() {
   INTRINSIC_ASSERT_NON_REALTIME();
-  GetGlobalLogSink().RemoveWriter(writer_);
+  GetGlobalLogSink().RemoveQueue(queue_);
 }
 
 void RealtimeLogSink::Log(const LogEntry& entry) {
-  if (!writer_->Closed()) {
-    (void)writer_->Write(entry);
-    GetGlobalLogSink().Notify();
+  // Copies the entry straight into the queue, without a temporary QueuedLog.
+  Write([&entry](internal::QueuedLog* log) { *log = entry; });
+}
+
+void RealtimeLogSink::LogDeferred(const LogRecord& record) {
+  Write([&record](internal::QueuedLog* log) { *log = record; });
+}
+
+uint64_t RealtimeLogSink::NumDropped() const {
+  return queue_->num_dropped.load(std::memory_order_relaxed);
+}
+
+void RealtimeLogSink::Write(
+    absl::FunctionRef<void(internal::QueuedLog*)> fill) {
+  RealtimeWriteQueue<internal::QueuedLog>::RtWriter& writer =
+      queue_->queue.Writer();
+  if (writer.Closed()) {
+    return;
+  }
+  // Writing signals the reader thread.
+  if (!writer.Emplace(fill)) {
+    queue_->num_dropped.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
@@ -4,11 +4,23 @@
 #define INTRINSIC_ICON_UTILS_REALTIME_LOG_SINK_H_
 
 #include <cstddef>
+#include <cstdint>
+#include <variant>
 
+#include "absl/functional/function_ref.h"
 #include "intrinsic/icon/utils/log_sink.h"
-#include "intrinsic/platform/common/buffers/realtime_write_queue.h"
 
 namespace intrinsic::icon {
+namespace internal {
+
+// A log message as queued for the GlobalLogSink thread. Log records are
+// formatted only by that thread.
+using QueuedLog =
+    std::variant<LogSinkInterface::LogEntry, LogSinkInterface::LogRecord>;
+
+struct RealtimeLogQueue;
+
+}  // namespace internal
 
 // A real-time safe log sink that writes to std::cerr.
 // When there are multiple threads, each should create a thread-local object.
@@ -30,8 +42,23 @@ class RealtimeLogSink : public LogSinkInterface {
   // If the buffer is full, messages may be dropped.
   void Log(const LogEntry& entry) override;
 
+  // RT safe.
+  // Like Log(), but only copies the raw record. The global non-RT thread
+  // formats it.
+  void LogDeferred(const LogRecord& record) override;
+
+  // RT safe.
+  // Returns the number of messages that were dropped because the buffer was
+  // full. The global non-RT thread also logs a warning for dropped messages.
+  uint64_t NumDropped() const;
+
  private:
-  RealtimeWriteQueue<LogEntry>::RtWriter* writer_;
+  // Sets the next free element of the queue in place with `fill`, or counts
+  // the message as dropped if the queue is full.
+  void Write(absl::FunctionRef<void(internal::QueuedLog*)> fill);
+
+  // Shared with the global non-RT thread. Deleted by the destructor.
+  internal::RealtimeLogQueue* queue_;
 };
 
 }  // namespace intrinsic::icon
@@ -0,0 +1,60 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/realtime_log_sink.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "intrinsic/icon/utils/log_sink.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::icon {
+namespace {
+
+LogSinkInterface::LogEntry MakeEntry(const char* message) {
+  LogSinkInterface::LogEntry entry;
+  entry.filename = __FILE__;
+  entry.line = __LINE__;
+  entry.msglen = snprintf(entry.msg, sizeof(entry.msg), "%s", message);
+  return entry;
+}
+
+TEST(RealtimeLogSinkTest, ManySinksOnManyThreads) {
+  std::vector<Thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([]() {
+      for (int j = 0; j < 10; ++j) {
+        auto sink = std::make_unique<RealtimeLogSink>();
+        for (int k = 0; k < 10; ++k) {
+          sink->Log(MakeEntry("entry"));
+        }
+        EXPECT_EQ(sink->NumDropped(), 0);
+        // Blocks until the entries have been written.
+        sink.reset();
+      }
+    });
+  }
+  for (Thread& thread : threads) {
+    thread.Join();
+  }
+}
+
+TEST(RealtimeLogSinkTest, CountsDroppedMessages) {
+  RealtimeLogSink sink;
+  // Blocks the reader thread in its first fprintf, so that the queue fills
+  // up.
+  flockfile(stderr);
+  for (int i = 0; i < 2000; ++i) {
+    sink.Log(MakeEntry("entry"));
+  }
+  funlockfile(stderr);
+  EXPECT_GT(sink.NumDropped(), 0);
+}
+
+}  // namespace
+}  // namespace intrinsic::icon
@@ -0,0 +1,412 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+// Latency and throughput of the real-time primitives.
+//
+// Besides the mean time per iteration, the benchmarks time single operations
+// and report their mean, 99.9th percentile and maximum as the counters
+// `mean_ns`, `p99.9_ns` and `max_ns`, since the tail is what counts on RT
+// cores. Single operations are timed with std::chrono::steady_clock, which
+// adds the cost of reading the clock (typically 20-30ns) to each of them.
+//
+// Cross-core benchmarks pin their threads to CPUs 0 and 1, busy-wait or block
+// as the primitive does, and are skipped on machines with a single CPU.
+//
+// The logging benchmarks write to stderr, so redirect it.
+//
+// Run with:
+//   bazel run -c opt //intrinsic/icon/utils:realtime_primitives_benchmark \
+//     2>/dev/null
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <cstdint>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "benchmark/benchmark.h"
+#include "intrinsic/icon/interprocess/binary_futex.h"
+#include "intrinsic/icon/utils/async_buffer.h"
+#include "intrinsic/icon/utils/compact_realtime_status.h"
+#include "intrinsic/icon/utils/fixed_str_cat.h"
+#include "intrinsic/icon/utils/fixed_string.h"
+#include "intrinsic/icon/utils/log.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/icon/utils/realtime_status_macro.h"
+#include "intrinsic/platform/common/buffers/realtime_write_queue.h"
+#include "intrinsic/platform/common/buffers/rt_promise.h"
+#include "intrinsic/platform/common/buffers/rt_queue.h"
+#include "intrinsic/util/thread/lockstep.h"
+
+namespace intrinsic::icon {
+namespace {
+
+// Operations per iteration of the cross-core benchmarks.
+constexpr int64_t kOperationsPerIteration = 1 << 14;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Records the latencies of single operations and reports their distribution
+// as counters. Keeps the first kMaxSamples samples, so that recording never
+// allocates.
+class LatencyRecorder {
+ public:
+  static constexpr size_t kMaxSamples = 1 << 20;
+
+  LatencyRecorder() { samples_.reserve(kMaxSamples); }
+
+  void Record(int64_t latency_ns) {
+    if (samples_.size() < kMaxSamples) {
+      samples_.push_back(latency_ns);
+    }
+  }
+
+  void Report(benchmark::State& state) {
+    if (samples_.empty()) return;
+    std::sort(samples_.begin(), samples_.end());
+    double sum = 0;
+    for (int64_t sample : samples_) sum += sample;
+    state.counters["mean_ns"] = sum / samples_.size();
+    state.counters["p99.9_ns"] = samples_[samples_.size() * 999 / 1000];
+    state.counters["max_ns"] = samples_.back();
+  }
+
+ private:
+  std::vector<int64_t> samples_;
+};
+
+// Returns false and skips the benchmark if the machine has a single CPU.
+bool HasTwoCpus(benchmark::State& state) {
+  if (std::thread::hardware_concurrency() >= 2) return true;
+  state.SkipWithError("Needs at least two CPUs");
+  return false;
+}
+
+// Pins the calling thread to `cpu`.
+void PinToCpu(int cpu) {
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+  (void)pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+}
+
+// Time from committing a timestamp on CPU 0 until the reader on CPU 1 gets it.
+void BM_AsyncBufferCommitToGet(benchmark::State& state) {
+  if (!HasTwoCpus(state)) return;
+  AsyncBuffer<int64_t> buffer;
+  LatencyRecorder latencies;
+  PinToCpu(0);
+  for (auto _ : state) {
+    std::atomic<bool> done = false;
+    std::thread reader([&]() {
+      PinToCpu(1);
+      uint64_t generation = 0;
+      int64_t* active = nullptr;
+      while (!done.load(std::memory_order_relaxed)) {
+        if (buffer.TryGetNewActiveBuffer(&active, &generation)) {
+          latencies.Record(NowNs() - *active);
+        }
+      }
+    });
+    for (int64_t i = 0; i < kOperationsPerIteration; ++i) {
+      *buffer.GetFreeBuffer() = NowNs();
+      buffer.CommitFreeBuffer();
+    }
+    done = true;
+    reader.join();
+  }
+  state.SetItemsProcessed(state.iterations() * kOperationsPerIteration);
+  latencies.Report(state);
+}
+BENCHMARK(BM_AsyncBufferCommitToGet)->UseRealTime();
+
+// Time from inserting a timestamp on CPU 0 until the reader on CPU 1 pops it.
+// Argument: queue capacity.
+void BM_RealtimeQueueLatency(benchmark::State& state) {
+  if (!HasTwoCpus(state)) return;
+  RealtimeQueue<int64_t> queue(state.range(0));
+  LatencyRecorder latencies;
+  PinToCpu(0);
+  for (auto _ : state) {
+    std::thread reader([&]() {
+      PinToCpu(1);
+      RealtimeQueue<int64_t>::Reader& r = *queue.reader();
+      for (int64_t received = 0; received < kOperationsPerIteration;) {
+        if (const int64_t* value = r.Front(); value != nullptr) {
+          latencies.Record(NowNs() - *value);
+          r.DropFront();
+          ++received;
+        }
+      }
+    });
+    RealtimeQueue<int64_t>::Writer& w = *queue.writer();
+    for (int64_t sent = 0; sent < kOperationsPerIteration;) {
+      if (int64_t* slot = w.PrepareInsert(); slot != nullptr) {
+        *slot = NowNs();
+        w.FinishInsert();
+        ++sent;
+      }
+    }
+    reader.join();
+  }
+  state.SetItemsProcessed(state.iterations() * kOperationsPerIteration);
+  latencies.Report(state);
+}
+BENCHMARK(BM_RealtimeQueueLatency)
+    ->ArgName("capacity")
+    ->Arg(64)
+    ->Arg(1024)
+    ->UseRealTime();
+
+// Throughput of a writer on CPU 0 and a blocking reader on CPU 1. The latency
+// counters are those of RtWriter::Write(), which signals an event fd.
+// Argument: queue capacity.
+void BM_RealtimeWriteQueueThroughput(benchmark::State& state) {
+  if (!HasTwoCpus(state)) return;
+  LatencyRecorder latencies;
+  PinToCpu(0);
+  for (auto _ : state) {
+    RealtimeWriteQueue<int64_t> queue(state.range(0));
+    std::thread reader([&queue]() {
+      PinToCpu(1);
+      int64_t item = 0;
+      int64_t sum = 0;
+      while (queue.Reader().Read(item) == ReadResult::kConsumed) {
+        sum += item;
+      }
+      benchmark::DoNotOptimize(sum);
+    });
+    for (int64_t sent = 0; sent < kOperationsPerIteration;) {
+      const int64_t start = NowNs();
+      if (queue.Writer().Write(sent)) {
+        latencies.Record(NowNs() - start);
+        ++sent;
+      }
+    }
+    queue.Writer().Close();
+    reader.join();
+  }
+  state.SetItemsProcessed(state.iterations() * kOperationsPerIteration);
+  latencies.Report(state);
+}
+BENCHMARK(BM_RealtimeWriteQueueThroughput)
+    ->ArgName("capacity")
+    ->Arg(64)
+    ->Arg(1024)
+    ->UseRealTime();
+
+// Time from asking a thread on CPU 1 to set a promise until the future on
+// CPU 0 returns the value.
+void BM_PromiseRoundTrip(benchmark::State& state) {
+  if (!HasTwoCpus(state)) return;
+  BinaryFutex request;
+  RealtimePromise<int64_t> promise;
+  std::atomic<bool> stop = false;
+  PinToCpu(0);
+  std::thread responder([&]() {
+    PinToCpu(1);
+    while (!stop) {
+      if (!request.WaitFor(absl::Milliseconds(100)).ok()) continue;
+      // Destroys the promise when done, which the future waits for.
+      RealtimePromise<int64_t> local_promise = std::move(promise);
+      (void)local_promise.SetValue(NowNs());
+    }
+  });
+  LatencyRecorder latencies;
+  for (auto _ : state) {
+    NonRealtimeFuture<int64_t> future;
+    promise = *future.GetPromise();
+    const int64_t start = NowNs();
+    (void)request.Post();
+    absl::StatusOr<int64_t> value = future.Get();
+    latencies.Record(NowNs() - start);
+    benchmark::DoNotOptimize(value);
+  }
+  stop = true;
+  responder.join();
+  latencies.Report(state);
+}
+BENCHMARK(BM_PromiseRoundTrip)->UseRealTime();
+
+// Time from posting a futex on CPU 0 until the waiter on CPU 1 wakes up, with
+// both sides spinning for up to `spin_us` before they block.
+void BM_BinaryFutexWakeUp(benchmark::State& state) {
+  if (!HasTwoCpus(state)) return;
+  const absl::Duration spin = absl::Microseconds(state.range(0));
+  BinaryFutex ping(/*posted=*/false, spin);
+  BinaryFutex pong(/*posted=*/false, spin);
+  std::atomic<int64_t> post_time_ns = 0;
+  std::atomic<bool> stop = false;
+  // Only written by the waiter.
+  LatencyRecorder latencies;
+  PinToCpu(0);
+  std::thread waiter([&]() {
+    PinToCpu(1);
+    while (!stop) {
+      if (!ping.WaitFor(absl::Milliseconds(100)).ok()) continue;
+      latencies.Record(NowNs() - post_time_ns);
+      (void)pong.Post();
+    }
+  });
+  for (auto _ : state) {
+    post_time_ns = NowNs();
+    (void)ping.Post();
+    while (!pong.WaitFor(absl::Seconds(1)).ok()) {
+    }
+  }
+  stop = true;
+  waiter.join();
+  latencies.Report(state);
+}
+BENCHMARK(BM_BinaryFutexWakeUp)
+    ->ArgName("spin_us")
+    ->Arg(0)
+    ->Arg(20)
+    ->UseRealTime();
+
+// Time of one round of a Lockstep, with operation A on CPU 0 and operation B
+// on CPU 1, i.e. of two handoffs between the cores. Both sides spin for up to
+// `spin_us` before they block.
+void BM_LockstepRound(benchmark::State& state) {
+  if (!HasTwoCpus(state)) return;
+  Lockstep lockstep(absl::Microseconds(state.range(0)));
+  PinToCpu(0);
+  std::thread b_thread([&lockstep]() {
+    PinToCpu(1);
+    while (lockstep.StartOperationBWithDeadline(absl::InfiniteFuture()).ok()) {
+      (void)lockstep.EndOperationB();
+    }
+  });
+  LatencyRecorder latencies;
+  for (auto _ : state) {
+    const int64_t start = NowNs();
+    (void)lockstep.StartOperationAWithDeadline(absl::InfiniteFuture());
+    latencies.Record(NowNs() - start);
+    (void)lockstep.EndOperationA();
+  }
+  lockstep.Cancel();
+  b_thread.join();
+  latencies.Report(state);
+}
+BENCHMARK(BM_LockstepRound)
+    ->ArgName("spin_us")
+    ->Arg(0)
+    ->Arg(20)
+    ->UseRealTime();
+
+void BM_FixedStrCat(benchmark::State& state) {
+  LatencyRecorder latencies;
+  int64_t i = 0;
+  for (auto _ : state) {
+    const int64_t start = NowNs();
+    FixedString<RealtimeStatus::kMaxMessageLength> message =
+        FixedStrCat<RealtimeStatus::kMaxMessageLength>(
+            "joint ", i++, " exceeded its limit of ", 1.5, " rad");
+    latencies.Record(NowNs() - start);
+    benchmark::DoNotOptimize(message);
+  }
+  latencies.Report(state);
+}
+BENCHMARK(BM_FixedStrCat);
+
+ABSL_ATTRIBUTE_NOINLINE RealtimeStatus Fail(bool fail) {
+  if (fail) return InternalError("failed");
+  return OkStatus();
+}
+
+ABSL_ATTRIBUTE_NOINLINE RealtimeStatus Propagate(int depth, bool fail) {
+  if (depth == 0) return Fail(fail);
+  INTRINSIC_RT_RETURN_IF_ERROR(Propagate(depth - 1, fail));
+  return OkStatus();
+}
+
+ABSL_ATTRIBUTE_NOINLINE CompactRealtimeStatus FailCompact(bool fail) {
+  if (fail) return CompactRealtimeStatus(absl::StatusCode::kInternal, "failed");
+  return CompactRealtimeStatus();
+}
+
+ABSL_ATTRIBUTE_NOINLINE CompactRealtimeStatus PropagateCompact(int depth,
+                                                               bool fail) {
+  if (depth == 0) return FailCompact(fail);
+  INTRINSIC_RT_RETURN_IF_COMPACT_ERROR(PropagateCompact(depth - 1, fail));
+  return CompactRealtimeStatus();
+}
+
+// Returns a status through 8 levels of INTRINSIC_RT_RETURN_IF_ERROR.
+// Argument: 1 to return an error, 0 for OK.
+void BM_RealtimeStatusPropagation(benchmark::State& state) {
+  const bool fail = state.range(0) != 0;
+  LatencyRecorder latencies;
+  for (auto _ : state) {
+    const int64_t start = NowNs();
+    RealtimeStatus status = Propagate(/*depth=*/8, fail);
+    latencies.Record(NowNs() - start);
+    benchmark::DoNotOptimize(status);
+  }
+  latencies.Report(state);
+}
+BENCHMARK(BM_RealtimeStatusPropagation)->ArgName("error")->Arg(0)->Arg(1);
+
+// Like BM_RealtimeStatusPropagation, for CompactRealtimeStatus.
+void BM_CompactRealtimeStatusPropagation(benchmark::State& state) {
+  const bool fail = state.range(0) != 0;
+  LatencyRecorder latencies;
+  for (auto _ : state) {
+    const int64_t start = NowNs();
+    CompactRealtimeStatus status = PropagateCompact(/*depth=*/8, fail);
+    latencies.Record(NowNs() - start);
+    benchmark::DoNotOptimize(status);
+  }
+  latencies.Report(state);
+}
+BENCHMARK(BM_CompactRealtimeStatusPropagation)
+    ->ArgName("error")
+    ->Arg(0)
+    ->Arg(1);
+
+// Cost of INTRINSIC_RT_LOG on the calling thread, with the RealtimeLogSink.
+// Messages beyond the capacity of the sink's queue are dropped.
+void BM_RtLog(benchmark::State& state) {
+  RtLogInitForThisThread();
+  LatencyRecorder latencies;
+  int64_t i = 0;
+  for (auto _ : state) {
+    const int64_t start = NowNs();
+    INTRINSIC_RT_LOG(INFO) << "joint " << i++ << " exceeded its limit of "
+                           << 1.5 << " rad";
+    latencies.Record(NowNs() - start);
+  }
+  latencies.Report(state);
+}
+BENCHMARK(BM_RtLog);
+
+// Like BM_RtLog, for INTRINSIC_RT_LOG_DEFERRED.
+void BM_RtLogDeferred(benchmark::State& state) {
+  RtLogInitForThisThread();
+  LatencyRecorder latencies;
+  int64_t i = 0;
+  for (auto _ : state) {
+    const int64_t start = NowNs();
+    INTRINSIC_RT_LOG_DEFERRED(INFO, "joint {} exceeded its limit of {} rad",
+                              i++, 1.5);
+    latencies.Record(NowNs() - start);
+  }
+  latencies.Report(state);
+}
+BENCHMARK(BM_RtLogDeferred);
+
+}  // namespace
+}  // namespace intrinsic::icon
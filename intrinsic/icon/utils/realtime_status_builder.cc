@@ -0,0 +1,52 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/realtime_status_builder.h"
+
+#include <cstddef>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "intrinsic/icon/utils/fixed_string.h"
+#include "intrinsic/icon/utils/realtime_guard.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+
+namespace intrinsic::icon {
+
+namespace realtime_status_builder_internal {
+
+absl::string_view BaseName(absl::string_view path) {
+  const size_t slash = path.rfind('/');
+  return slash == absl::string_view::npos ? path : path.substr(slash + 1);
+}
+
+}  // namespace realtime_status_builder_internal
+
+RealtimeStatusBuilder::operator RealtimeStatus() const {
+  if (status_.ok()) {
+    return status_;
+  }
+  FixedString<RealtimeStatus::kMaxMessageLength> message;
+  ForEachMessagePiece(
+      [&message](absl::string_view piece) { message.append(piece); });
+  return RealtimeStatus(status_.code(), message);
+}
+
+RealtimeStatusBuilder::operator absl::Status() const {
+  INTRINSIC_ASSERT_NON_REALTIME();
+  if (status_.ok()) {
+    return absl::OkStatus();
+  }
+  size_t size = 0;
+  ForEachMessagePiece(
+      [&size](absl::string_view piece) { size += piece.size(); });
+  std::string message;
+  message.reserve(size);
+  ForEachMessagePiece(
+      [&message](absl::string_view piece) {
+        message.append(piece.data(), piece.size());
+      });
+  return absl::Status(status_.code(), message);
+}
+
+}  // namespace intrinsic::icon
@@ -0,0 +1,217 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_UTILS_REALTIME_STATUS_BUILDER_H_
+#define INTRINSIC_ICON_UTILS_REALTIME_STATUS_BUILDER_H_
+
+#include <cstdint>
+#include <utility>
+
+#include "absl/base/attributes.h"
+#include "absl/base/optimization.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "intrinsic/icon/release/source_location.h"
+#include "intrinsic/icon/testing/realtime_annotations.h"
+#include "intrinsic/icon/utils/fixed_str_cat.h"
+#include "intrinsic/icon/utils/fixed_string.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic::icon {
+
+// Real-time safe counterpart of intrinsic::StatusBuilder for RealtimeStatus.
+// Adds context to an error with `<<`, optionally annotated with the source
+// location of the builder, without using the heap:
+//
+//   RealtimeStatus MoveJoint(int joint) {
+//     INTRINSIC_RT_RETURN_IF_ERROR_BUILDER(CheckLimits(joint))
+//         .AnnotateSourceLocation()
+//         << "while moving joint " << joint;
+//     ...
+//   }
+//
+// `<<` accepts everything that FixedStrCat() does. The additional message
+// holds up to RealtimeStatus::kMaxMessageLength characters; like
+// FixedStrCat(), the builder drops what does not fit.
+//
+// Converting to RealtimeStatus truncates the joined message to
+// RealtimeStatus::kMaxMessageLength. Converting to absl::Status at the
+// real-time boundary keeps the full original and additional messages, and
+// allocates once for the joined message.
+class ABSL_MUST_USE_RESULT RealtimeStatusBuilder {
+ public:
+  // Creates a builder based on `original_status`. Pass INTRINSIC_LOC as
+  // `location`.
+  RealtimeStatusBuilder(const RealtimeStatus& original_status,
+                        SourceLocation location) INTRINSIC_CHECK_REALTIME_SAFE
+      : status_(original_status),
+        loc_(location) {}
+  // Creates a builder for an error with `code` and no message yet. Pass
+  // INTRINSIC_LOC as `location`.
+  RealtimeStatusBuilder(absl::StatusCode code,
+                        SourceLocation location) INTRINSIC_CHECK_REALTIME_SAFE
+      : status_(code, ""),
+        loc_(location) {}
+
+  // Joins the additional message in front of the original message, without a
+  // separator.
+  RealtimeStatusBuilder& SetPrepend() & INTRINSIC_CHECK_REALTIME_SAFE {
+    join_style_ = JoinStyle::kPrepend;
+    return *this;
+  }
+  RealtimeStatusBuilder&& SetPrepend() && INTRINSIC_CHECK_REALTIME_SAFE {
+    return std::move(SetPrepend());
+  }
+
+  // Joins the additional message after the original message, without a
+  // separator.
+  RealtimeStatusBuilder& SetAppend() & INTRINSIC_CHECK_REALTIME_SAFE {
+    join_style_ = JoinStyle::kAppend;
+    return *this;
+  }
+  RealtimeStatusBuilder&& SetAppend() && INTRINSIC_CHECK_REALTIME_SAFE {
+    return std::move(SetAppend());
+  }
+
+  // Starts the message of the result with the base name of the file and the
+  // line of the builder, e.g. "arm_part.cc:42: ".
+  RealtimeStatusBuilder& AnnotateSourceLocation() &
+      INTRINSIC_CHECK_REALTIME_SAFE {
+    annotate_source_location_ = true;
+    return *this;
+  }
+  RealtimeStatusBuilder&& AnnotateSourceLocation() &&
+      INTRINSIC_CHECK_REALTIME_SAFE {
+    return std::move(AnnotateSourceLocation());
+  }
+
+  // Sets the code of the result.
+  RealtimeStatusBuilder& SetCode(absl::StatusCode code) &
+      INTRINSIC_CHECK_REALTIME_SAFE {
+    status_ = RealtimeStatus(code, status_.message());
+    return *this;
+  }
+  RealtimeStatusBuilder&& SetCode(absl::StatusCode code) &&
+      INTRINSIC_CHECK_REALTIME_SAFE {
+    return std::move(SetCode(code));
+  }
+
+  // Appends to the additional message. By default, it is joined to the
+  // original message with a "; " separator. No operation if the builder is
+  // OK.
+  template <typename T>
+  RealtimeStatusBuilder& operator<<(const T& value) &
+      INTRINSIC_CHECK_REALTIME_SAFE {
+    if (!status_.ok()) {
+      FixedStrAppend(&message_, value);
+    }
+    return *this;
+  }
+  template <typename T>
+  RealtimeStatusBuilder&& operator<<(const T& value) &&
+      INTRINSIC_CHECK_REALTIME_SAFE {
+    return std::move(*this << value);
+  }
+
+  // Returns true if the result will be OK.
+  bool ok() const INTRINSIC_CHECK_REALTIME_SAFE { return status_.ok(); }
+
+  // Returns the code of the result.
+  absl::StatusCode code() const INTRINSIC_CHECK_REALTIME_SAFE {
+    return status_.code();
+  }
+
+  // Returns the location that was passed to the constructor.
+  SourceLocation source_location() const INTRINSIC_CHECK_REALTIME_SAFE {
+    return loc_;
+  }
+
+  // Returns the result, with the joined message truncated to
+  // RealtimeStatus::kMaxMessageLength.
+  operator RealtimeStatus() const  // NOLINT: Builder converts implicitly.
+      INTRINSIC_CHECK_REALTIME_SAFE;
+
+  // Returns the result with the full joined message. Not real-time safe.
+  operator absl::Status() const;  // NOLINT: Builder converts implicitly.
+
+ private:
+  enum class JoinStyle : uint8_t {
+    kAnnotate,
+    kAppend,
+    kPrepend,
+  };
+
+  // Calls `append` with the pieces of the joined message, in order.
+  template <typename AppendFn>
+  void ForEachMessagePiece(AppendFn append) const;
+
+  RealtimeStatus status_;
+  SourceLocation loc_;
+  JoinStyle join_style_ = JoinStyle::kAnnotate;
+  bool annotate_source_location_ = false;
+  FixedString<RealtimeStatus::kMaxMessageLength> message_;
+};
+
+// Like INTRINSIC_RT_RETURN_IF_ERROR(), but returns through a
+// RealtimeStatusBuilder, so that the error can be extended with `<<` and the
+// builder options:
+//
+//   INTRINSIC_RT_RETURN_IF_ERROR_BUILDER(Bar(n)) << "for n=" << n;
+//
+// The enclosing function must return RealtimeStatus or absl::Status.
+#define INTRINSIC_RT_RETURN_IF_ERROR_BUILDER(expr)                        \
+  INTR_STATUS_MACROS_IMPL_ELSE_BLOCKER_                                   \
+  if (::intrinsic::icon::RealtimeStatusBuilder                            \
+          intrinsic_rt_status_builder((expr), INTRINSIC_LOC);             \
+      ABSL_PREDICT_TRUE(intrinsic_rt_status_builder.ok())) {              \
+  } else /* NOLINT */                                                     \
+    return intrinsic_rt_status_builder
+
+// Implementation details follow; clients should ignore.
+
+namespace realtime_status_builder_internal {
+
+// Returns the part of `path` after the last '/'.
+absl::string_view BaseName(absl::string_view path)
+    INTRINSIC_CHECK_REALTIME_SAFE;
+
+}  // namespace realtime_status_builder_internal
+
+template <typename AppendFn>
+void RealtimeStatusBuilder::ForEachMessagePiece(AppendFn append) const {
+  if (annotate_source_location_ && loc_.file_name() != nullptr) {
+    const absl::AlphaNum line(loc_.line());
+    append(realtime_status_builder_internal::BaseName(loc_.file_name()));
+    append(":");
+    append(line.Piece());
+    append(": ");
+  }
+  const absl::string_view original = status_.message();
+  const absl::string_view extra = message_;
+  if (extra.empty()) {
+    append(original);
+    return;
+  }
+  switch (join_style_) {
+    case JoinStyle::kAnnotate:
+      append(original);
+      if (!original.empty()) {
+        append("; ");
+      }
+      append(extra);
+      break;
+    case JoinStyle::kAppend:
+      append(original);
+      append(extra);
+      break;
+    case JoinStyle::kPrepend:
+      append(extra);
+      append(original);
+      break;
+  }
+}
+
+}  // namespace intrinsic::icon
+
+#endif  // INTRINSIC_ICON_UTILS_REALTIME_STATUS_BUILDER_H_
@@ -0,0 +1,90 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/realtime_status_builder.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "intrinsic/icon/release/source_location.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::icon {
+namespace {
+
+using ::testing::EndsWith;
+using ::testing::StartsWith;
+
+RealtimeStatus Propagate(const RealtimeStatus& status, int value) {
+  INTRINSIC_RT_RETURN_IF_ERROR_BUILDER(status) << "value " << value;
+  return OkStatus();
+}
+
+TEST(RealtimeStatusBuilderTest, OkStaysOk) {
+  EXPECT_TRUE(Propagate(OkStatus(), 1).ok());
+  RealtimeStatusBuilder builder(OkStatus(), INTRINSIC_LOC);
+  builder << "ignored";
+  EXPECT_EQ(static_cast<RealtimeStatus>(builder), OkStatus());
+  EXPECT_TRUE(static_cast<absl::Status>(builder).ok());
+}
+
+TEST(RealtimeStatusBuilderTest, AnnotatesByDefault) {
+  EXPECT_EQ(Propagate(InternalError("failed"), 7),
+            InternalError("failed; value 7"));
+  EXPECT_EQ(Propagate(InternalError(""), 7), InternalError("value 7"));
+  EXPECT_EQ(static_cast<RealtimeStatus>(
+                RealtimeStatusBuilder(InternalError("failed"), INTRINSIC_LOC)),
+            InternalError("failed"));
+}
+
+TEST(RealtimeStatusBuilderTest, AppendsAndPrepends) {
+  EXPECT_EQ(static_cast<RealtimeStatus>(
+                RealtimeStatusBuilder(AbortedError("a"), INTRINSIC_LOC)
+                    .SetAppend()
+                << "b"),
+            AbortedError("ab"));
+  EXPECT_EQ(static_cast<RealtimeStatus>(
+                RealtimeStatusBuilder(AbortedError("a"), INTRINSIC_LOC)
+                    .SetPrepend()
+                << "b"),
+            AbortedError("ba"));
+}
+
+TEST(RealtimeStatusBuilderTest, SetsCode) {
+  EXPECT_EQ(static_cast<RealtimeStatus>(
+                RealtimeStatusBuilder(AbortedError("a"), INTRINSIC_LOC)
+                    .SetCode(absl::StatusCode::kUnavailable)),
+            UnavailableError("a"));
+  EXPECT_EQ(static_cast<RealtimeStatus>(
+                RealtimeStatusBuilder(absl::StatusCode::kNotFound,
+                                      INTRINSIC_LOC)
+                << "joint " << 3),
+            NotFoundError("joint 3"));
+}
+
+TEST(RealtimeStatusBuilderTest, AnnotatesSourceLocation) {
+  const RealtimeStatus status =
+      RealtimeStatusBuilder(InternalError("failed"), INTRINSIC_LOC)
+          .AnnotateSourceLocation();
+  EXPECT_THAT(std::string(status.message()),
+              StartsWith("realtime_status_builder_test.cc:"));
+  EXPECT_THAT(std::string(status.message()), EndsWith(": failed"));
+}
+
+TEST(RealtimeStatusBuilderTest, AbslStatusKeepsFullMessage) {
+  const std::string original(RealtimeStatus::kMaxMessageLength, 'a');
+  const std::string extra(RealtimeStatus::kMaxMessageLength, 'b');
+  RealtimeStatusBuilder builder(InternalError(original), INTRINSIC_LOC);
+  builder << extra;
+
+  const absl::Status status = builder;
+  EXPECT_EQ(status, absl::InternalError(original + "; " + extra));
+  const RealtimeStatus realtime_status = builder;
+  EXPECT_EQ(realtime_status.message(), original);
+}
+
+}  // namespace
+}  // namespace intrinsic::icon
@@ -3,6 +3,7 @@
 #ifndef INTRINSIC_ICON_UTILS_REALTIME_STATUS_OR_H_
 #define INTRINSIC_ICON_UTILS_REALTIME_STATUS_OR_H_
 
+#include <memory>
 #include <type_traits>
 #include <utility>
 
@@ -14,6 +15,14 @@
 
 namespace intrinsic::icon {
 
+namespace realtime_status_or_internal {
+
+// Returned by RealtimeStatusOr::status() while it holds a value, which shares
+// its storage with the error.
+inline const RealtimeStatus kOkStatus;
+
+}  // namespace realtime_status_or_internal
+
 // A variant of absl::StatusOr for realtime contexts.
 //
 // It contains either a usable object of type 'T' or an error of type
@@ -21,10 +30,17 @@ namespace intrinsic::icon {
 // 'T' is realtime-safe, this class is also, because RealtimeStatus does not
 // allocate on the heap.
 //
+// The object and the error share their storage, since there is only an error
+// message if there is no object. So a RealtimeStatusOr is only as large as the
+// larger of the two, and returning a large 'T', such as JointLimits, does not
+// copy an unused message buffer along with it. Construct large objects in
+// place with std::in_place or emplace() to avoid copying them at all.
+//
 // Compared to absl::StatusOr, this here has fewer features.
 // Among other things, it does not warn about undesirable corner cases like
-// constructing with kOk, or ambiguous construction with "{}".
-// Also, type 'T' must be default-constructible.
+// constructing with kOk, or ambiguous construction with "{}". Constructing
+// with kOk default-constructs the object, if 'T' is default-constructible, and
+// results in an internal error otherwise.
 template <typename T>
 class RealtimeStatusOr {
  public:
@@ -44,12 +60,21 @@ class RealtimeStatusOr {
   //      return std::move(bar);
   //    }
   //
-  // std::conditional templating uses the copy constructor T if the type is
-  // trivially copyable, otherwise it uses T&&.
+  // std::conditional templating takes a const reference to T if the type is
+  // trivially copyable, so that it is copied once, and T&& otherwise.
   template <bool IsCopyable = std::is_trivially_copy_constructible<T>::value>
   RealtimeStatusOr(  // NOLINT(google-explicit-constructor)
-      typename std::conditional<IsCopyable, T, T&&>::type data)
-      : status_(OkStatus()), data_(std::move(data)) {}
+      typename std::conditional<IsCopyable, const T&, T&&>::type data)
+      : has_value_(true), data_(std::move(data)) {}
+
+  // Constructs the usable object in place from `args`.
+  // Example:
+  //   RealtimeStatusOr<JointLimits> GetLimits() {
+  //     return RealtimeStatusOr<JointLimits>(std::in_place, ...);
+  //   }
+  template <typename... Args>
+  explicit RealtimeStatusOr(std::in_place_t, Args&&... args)
+      : has_value_(true), data_(std::forward<Args>(args)...) {}
 
   // Allows returning errors.
   // Example:
@@ -58,29 +83,80 @@ class RealtimeStatusOr {
   //   }
   RealtimeStatusOr(  // NOLINT(google-explicit-constructor)
       RealtimeStatus&& status)
-      : status_(status) {}
+      : RealtimeStatusOr(static_cast<const RealtimeStatus&>(status)) {}
 
   // Allows forwarding errors from a different RealtimeStatusOr type, for
   // instance in nested functions.
   RealtimeStatusOr(  // NOLINT(google-explicit-constructor)
-      const RealtimeStatus& status)
-      : status_(status) {}
+      const RealtimeStatus& status);
 
   // Allowed so users can create containers.
-  RealtimeStatusOr() : status_(absl::StatusCode::kUnknown, "") {}
+  RealtimeStatusOr()
+      : has_value_(false), status_(absl::StatusCode::kUnknown, "") {}
 
-  // Copy, move and assignment are allowed.
-  RealtimeStatusOr(const RealtimeStatusOr&) = default;
-  RealtimeStatusOr& operator=(const RealtimeStatusOr&) = default;
-  RealtimeStatusOr(RealtimeStatusOr&&) noexcept = default;
-  RealtimeStatusOr& operator=(RealtimeStatusOr&&) noexcept = default;
+  // Copy, move and assignment are allowed, if 'T' allows them.
+  RealtimeStatusOr(const RealtimeStatusOr& other)
+    requires std::is_copy_constructible_v<T>
+      : has_value_(false) {
+    ConstructFrom(other);
+  }
+  RealtimeStatusOr& operator=(const RealtimeStatusOr& other)
+    requires std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T>
+  {
+    if (this == &other) {
+      return *this;
+    }
+    if (has_value_ && other.has_value_) {
+      data_ = other.data_;
+    } else {
+      Destroy();
+      ConstructFrom(other);
+    }
+    return *this;
+  }
+  RealtimeStatusOr(RealtimeStatusOr&& other) noexcept(
+      std::is_nothrow_move_constructible_v<T>)
+    requires std::is_move_constructible_v<T>
+      : has_value_(false) {
+    ConstructFrom(std::move(other));
+  }
+  RealtimeStatusOr& operator=(RealtimeStatusOr&& other) noexcept(
+      std::is_nothrow_move_constructible_v<T> &&
+      std::is_nothrow_move_assignable_v<T>)
+    requires std::is_move_constructible_v<T> && std::is_move_assignable_v<T>
+  {
+    if (this == &other) {
+      return *this;
+    }
+    if (has_value_ && other.has_value_) {
+      data_ = std::move(other.data_);
+    } else {
+      Destroy();
+      ConstructFrom(std::move(other));
+    }
+    return *this;
+  }
+
+  ~RealtimeStatusOr() { Destroy(); }
+
+  // Replaces the usable object or error with an object constructed in place
+  // from `args`, and returns it.
+  template <typename... Args>
+  T& emplace(Args&&... args) {
+    Destroy();
+    std::construct_at(&data_, std::forward<Args>(args)...);
+    has_value_ = true;
+    return data_;
+  }
 
   // Returns true if the status is ok.
-  bool ok() const { return status_.ok(); }
+  bool ok() const { return has_value_; }
 
   // Returns the status. If a usable object is present, the status code is
   // "kOk".
-  const RealtimeStatus& status() const { return status_; }
+  const RealtimeStatus& status() const {
+    return has_value_ ? realtime_status_or_internal::kOkStatus : status_;
+  }
 
   // Get the usable object.
   // Only allowed if 'ok() == true', otherwise fails a runtime assert.
@@ -123,11 +199,65 @@ class RealtimeStatusOr {
   const T&& operator*() const&&;
   T&& operator*() &&;
 
+  // Returns a pointer to the current value.
+  //
+  // REQUIRES: `this->ok() == true`, otherwise the behavior is undefined.
+  const T* operator->() const;
+  T* operator->();
+
  private:
-  RealtimeStatus status_;
-  T data_;
+  static_assert(std::is_trivially_destructible_v<RealtimeStatus>,
+                "The error is not destroyed when the object replaces it");
+
+  // Constructs the usable object or error of `other`, which is a
+  // RealtimeStatusOr, in the empty storage.
+  template <typename Other>
+  void ConstructFrom(Other&& other) {
+    if (other.has_value_) {
+      std::construct_at(&data_, std::forward<Other>(other).data_);
+      has_value_ = true;
+    } else {
+      std::construct_at(&status_, other.status_);
+      has_value_ = false;
+    }
+  }
+
+  // Destroys the usable object, if any, leaving the storage empty.
+  void Destroy() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      if (has_value_) {
+        std::destroy_at(&data_);
+      }
+    }
+    has_value_ = false;
+  }
+
+  bool has_value_;
+  // Only `data_` is alive if `has_value_`, and only `status_` otherwise, with
+  // the exception of Destroy() and ConstructFrom(), which leave neither alive.
+  union {
+    RealtimeStatus status_;
+    T data_;
+  };
 };
 
+template <typename T>
+RealtimeStatusOr<T>::RealtimeStatusOr(const RealtimeStatus& status)
+    : has_value_(false) {
+  if (!status.ok()) {
+    std::construct_at(&status_, status);
+    return;
+  }
+  if constexpr (std::is_default_constructible_v<T>) {
+    std::construct_at(&data_);
+    has_value_ = true;
+  } else {
+    std::construct_at(&status_, absl::StatusCode::kInternal,
+                      "RealtimeStatusOr constructed with an ok status but "
+                      "without a value");
+  }
+}
+
 template <typename T>
 const T& RealtimeStatusOr<T>::value() const& INTRINSIC_SUPPRESS_REALTIME_CHECK {
   CHECK(ok()) << "RealtimeStatusOr::value() only allowed if ok() aka usable "
@@ -221,6 +351,22 @@ T&& RealtimeStatusOr<T>::operator*() && {
   return std::move(this->data_);
 }
 
+template <typename T>
+const T* RealtimeStatusOr<T>::operator->() const {
+  CHECK(ok())
+      << "RealtimeStatusOr::operator->() only allowed if ok() aka usable "
+         "value has been set";
+  return &this->data_;
+}
+
+template <typename T>
+T* RealtimeStatusOr<T>::operator->() {
+  CHECK(ok())
+      << "RealtimeStatusOr::operator->() only allowed if ok() aka usable "
+         "value has been set";
+  return &this->data_;
+}
+
 }  // namespace intrinsic::icon
 
 #endif  // INTRINSIC_ICON_UTILS_REALTIME_STATUS_OR_H_
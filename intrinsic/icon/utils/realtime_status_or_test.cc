@@ -0,0 +1,146 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/realtime_status_or.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::icon {
+namespace {
+
+using ::testing::IsEmpty;
+using ::testing::Pointee;
+
+using LargeValue = std::array<double, 64>;
+
+// Counts the copies and moves of a value.
+struct Counted {
+  Counted() = default;
+  explicit Counted(int value) : value(value) {}
+  Counted(const Counted& other) : value(other.value) { ++copies; }
+  Counted& operator=(const Counted& other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+  Counted(Counted&& other) noexcept : value(other.value) { ++moves; }
+  Counted& operator=(Counted&& other) noexcept {
+    value = other.value;
+    ++moves;
+    return *this;
+  }
+
+  static inline int copies = 0;
+  static inline int moves = 0;
+  int value = 0;
+};
+
+// Not default-constructible.
+struct NoDefault {
+  explicit NoDefault(int value) : value(value) {}
+  int value;
+};
+
+TEST(RealtimeStatusOrTest, ValueAndErrorShareStorage) {
+  EXPECT_LT(sizeof(RealtimeStatusOr<LargeValue>),
+            sizeof(LargeValue) + sizeof(RealtimeStatus));
+  EXPECT_LE(sizeof(RealtimeStatusOr<int>),
+            sizeof(RealtimeStatus) + alignof(RealtimeStatus));
+}
+
+TEST(RealtimeStatusOrTest, HoldsValue) {
+  RealtimeStatusOr<int> status_or = 4;
+  ASSERT_TRUE(status_or.ok());
+  EXPECT_TRUE(status_or.status().ok());
+  EXPECT_THAT(status_or.status().message(), IsEmpty());
+  EXPECT_EQ(*status_or, 4);
+  EXPECT_EQ(status_or.value(), 4);
+}
+
+TEST(RealtimeStatusOrTest, HoldsError) {
+  RealtimeStatusOr<LargeValue> status_or = InternalError("broken");
+  EXPECT_FALSE(status_or.ok());
+  EXPECT_EQ(status_or.status().code(), absl::StatusCode::kInternal);
+  EXPECT_EQ(status_or.status().message(), "broken");
+}
+
+TEST(RealtimeStatusOrTest, DefaultIsUnknownError) {
+  RealtimeStatusOr<NoDefault> status_or;
+  EXPECT_FALSE(status_or.ok());
+  EXPECT_EQ(status_or.status().code(), absl::StatusCode::kUnknown);
+}
+
+TEST(RealtimeStatusOrTest, OkStatusDefaultConstructsValue) {
+  RealtimeStatusOr<int> status_or = OkStatus();
+  ASSERT_TRUE(status_or.ok());
+  EXPECT_EQ(*status_or, 0);
+
+  RealtimeStatusOr<NoDefault> no_default = OkStatus();
+  EXPECT_EQ(no_default.status().code(), absl::StatusCode::kInternal);
+}
+
+TEST(RealtimeStatusOrTest, ConstructsInPlace) {
+  Counted::copies = 0;
+  Counted::moves = 0;
+  RealtimeStatusOr<Counted> status_or(std::in_place, 7);
+  ASSERT_TRUE(status_or.ok());
+  EXPECT_EQ(status_or->value, 7);
+  EXPECT_EQ(Counted::copies, 0);
+  EXPECT_EQ(Counted::moves, 0);
+}
+
+TEST(RealtimeStatusOrTest, EmplaceReplacesError) {
+  RealtimeStatusOr<NoDefault> status_or = AbortedError("aborted");
+  NoDefault& value = status_or.emplace(3);
+  ASSERT_TRUE(status_or.ok());
+  EXPECT_EQ(value.value, 3);
+  EXPECT_EQ(status_or->value, 3);
+}
+
+TEST(RealtimeStatusOrTest, MovesValue) {
+  Counted::copies = 0;
+  Counted::moves = 0;
+  RealtimeStatusOr<Counted> status_or = Counted(5);
+  RealtimeStatusOr<Counted> moved = std::move(status_or);
+  ASSERT_TRUE(moved.ok());
+  EXPECT_EQ(moved->value, 5);
+  EXPECT_EQ(Counted::copies, 0);
+  EXPECT_EQ(Counted::moves, 2);
+}
+
+TEST(RealtimeStatusOrTest, AssignsBetweenValueAndError) {
+  RealtimeStatusOr<std::unique_ptr<int>> status_or =
+      std::make_unique<int>(1);
+  status_or = NotFoundError("gone");
+  EXPECT_EQ(status_or.status().code(), absl::StatusCode::kNotFound);
+  status_or = RealtimeStatusOr<std::unique_ptr<int>>(std::make_unique<int>(2));
+  ASSERT_TRUE(status_or.ok());
+  EXPECT_THAT(*status_or, Pointee(2));
+
+  RealtimeStatusOr<Counted> copy_source = Counted(9);
+  RealtimeStatusOr<Counted> copy = UnknownError("");
+  copy = copy_source;
+  ASSERT_TRUE(copy.ok());
+  EXPECT_EQ(copy->value, 9);
+  EXPECT_EQ(copy_source->value, 9);
+}
+
+TEST(RealtimeStatusOrTest, CopyabilityFollowsValue) {
+  static_assert(std::is_copy_constructible_v<RealtimeStatusOr<int>>);
+  static_assert(
+      !std::is_copy_constructible_v<RealtimeStatusOr<std::unique_ptr<int>>>);
+  static_assert(std::is_nothrow_move_constructible_v<
+                RealtimeStatusOr<std::unique_ptr<int>>>);
+}
+
+}  // namespace
+}  // namespace intrinsic::icon
@@ -0,0 +1,239 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/trace_event.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "intrinsic/icon/utils/clock.h"
+#include "intrinsic/icon/utils/current_cycle.h"
+#include "intrinsic/platform/common/buffers/rt_queue.h"
+
+namespace intrinsic::icon {
+namespace {
+
+// The trace buffer of one thread. The thread writes, the collector reads.
+struct ThreadTraceBuffer {
+  ThreadTraceBuffer(absl::string_view thread_name, int thread_id,
+                    size_t capacity)
+      : queue(capacity), thread_name(thread_name), thread_id(thread_id) {}
+
+  RealtimeQueue<TraceEvent> queue;
+  const std::string thread_name;
+  const int thread_id;
+  std::atomic<uint64_t> num_dropped = 0;
+  // Set when the thread exits. The collector releases the buffer once it has
+  // drained it.
+  std::atomic<bool> exited = false;
+};
+
+struct Registry {
+  absl::Mutex mutex;
+  int next_thread_id ABSL_GUARDED_BY(mutex) = 1;
+  std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers
+      ABSL_GUARDED_BY(mutex);
+};
+
+Registry& GetRegistry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+// Keeps the buffer of a thread alive while the thread runs, and marks it as
+// exited when the thread ends.
+class ThreadTraceHandle {
+ public:
+  ~ThreadTraceHandle();
+
+  std::shared_ptr<ThreadTraceBuffer> buffer_;
+};
+
+std::atomic<bool> tracing_enabled = false;
+thread_local ThreadTraceHandle thread_handle;
+// Raw copy of `thread_handle.buffer_`. Unlike `thread_handle`, it has no
+// destructor, so accessing it on the RT path needs no initialization guard.
+thread_local ThreadTraceBuffer* thread_buffer = nullptr;
+
+ThreadTraceHandle::~ThreadTraceHandle() {
+  thread_buffer = nullptr;
+  if (buffer_ != nullptr) {
+    buffer_->exited.store(true, std::memory_order_release);
+  }
+}
+
+void Record(const char* category, const char* name, TracePhase phase) {
+  if (!tracing_enabled.load(std::memory_order_relaxed)) {
+    return;
+  }
+  ThreadTraceBuffer* buffer = thread_buffer;
+  if (buffer == nullptr) {
+    return;
+  }
+  const TraceEvent event = {.category = category,
+                            .name = name,
+                            .time_ns = Clock::now_ns(),
+                            .cycle = Cycle::GetCurrentCycle(),
+                            .phase = phase};
+  if (!buffer->queue.writer()->Insert(event)) {
+    buffer->num_dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void AppendJsonString(absl::string_view value, std::string* out) {
+  out->push_back('"');
+  for (const char c : value) {
+    switch (c) {
+      case '"':
+        out->append("\\\"");
+        break;
+      case '\\':
+        out->append("\\\\");
+        break;
+      case '\n':
+        out->append("\\n");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          absl::StrAppendFormat(out, "\\u%04x", c);
+        } else {
+          out->push_back(c);
+        }
+    }
+  }
+  out->push_back('"');
+}
+
+}  // namespace
+
+void SetTracingEnabled(bool enabled) {
+  tracing_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsTracingEnabled() {
+  return tracing_enabled.load(std::memory_order_relaxed);
+}
+
+void TraceInitForThisThread(absl::string_view thread_name, size_t capacity) {
+  if (thread_buffer != nullptr) {
+    return;
+  }
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  thread_handle.buffer_ = std::make_shared<ThreadTraceBuffer>(
+      thread_name, registry.next_thread_id++, capacity);
+  thread_buffer = thread_handle.buffer_.get();
+  registry.buffers.push_back(thread_handle.buffer_);
+}
+
+void TraceBegin(const char* category, const char* name) {
+  Record(category, name, TracePhase::kBegin);
+}
+
+void TraceEnd(const char* category, const char* name) {
+  Record(category, name, TracePhase::kEnd);
+}
+
+void TraceInstant(const char* category, const char* name) {
+  Record(category, name, TracePhase::kInstant);
+}
+
+void TraceCollector::Drain() {
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  std::vector<std::shared_ptr<ThreadTraceBuffer>> running;
+  running.reserve(registry.buffers.size());
+  for (std::shared_ptr<ThreadTraceBuffer>& buffer : registry.buffers) {
+    // Checked before draining, so that the last events of an exiting thread
+    // are not lost.
+    const bool exited = buffer->exited.load(std::memory_order_acquire);
+    while (std::optional<TraceEvent> event = buffer->queue.reader()->Pop()) {
+      events_.push_back({.thread_id = buffer->thread_id, .event = *event});
+    }
+    num_dropped_ += buffer->num_dropped.exchange(0, std::memory_order_relaxed);
+    bool known = false;
+    for (const auto& [thread_id, name] : thread_names_) {
+      known = known || thread_id == buffer->thread_id;
+    }
+    if (!known) {
+      thread_names_.emplace_back(buffer->thread_id, buffer->thread_name);
+    }
+    if (!exited) {
+      running.push_back(std::move(buffer));
+    }
+  }
+  registry.buffers = std::move(running);
+}
+
+std::string TraceCollector::ToChromeTraceJson() {
+  Drain();
+  const int pid = getpid();
+  std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  auto separate = [&]() {
+    if (!first) json.push_back(',');
+    first = false;
+  };
+  for (const auto& [thread_id, name] : thread_names_) {
+    separate();
+    absl::StrAppend(&json, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":",
+                    pid, ",\"tid\":", thread_id, ",\"args\":{\"name\":");
+    AppendJsonString(name, &json);
+    json.append("}}");
+  }
+  for (const ThreadEvent& thread_event : events_) {
+    const TraceEvent& event = thread_event.event;
+    separate();
+    absl::StrAppend(&json, "{\"ph\":\"",
+                    std::string(1, static_cast<char>(event.phase)),
+                    "\",\"cat\":");
+    AppendJsonString(event.category, &json);
+    json.append(",\"name\":");
+    AppendJsonString(event.name, &json);
+    // Chrome trace timestamps are in microseconds.
+    absl::StrAppendFormat(&json, ",\"ts\":%.3f", event.time_ns / 1000.0);
+    absl::StrAppend(&json, ",\"pid\":", pid, ",\"tid\":",
+                    thread_event.thread_id);
+    if (event.phase == TracePhase::kInstant) {
+      // Thread scoped, i.e. drawn on the track of its thread.
+      json.append(",\"s\":\"t\"");
+    }
+    absl::StrAppend(&json, ",\"args\":{\"cycle\":", event.cycle, "}}");
+  }
+  json.append("]}\n");
+  return json;
+}
+
+absl::Status TraceCollector::WriteChromeTrace(absl::string_view filename) {
+  const std::string json = ToChromeTraceJson();
+  const std::string path(filename);
+  std::FILE* file = std::fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    return absl::InternalError(
+        absl::StrCat("Failed to open ", path, ": ", std::strerror(errno)));
+  }
+  const bool written = std::fwrite(json.data(), 1, json.size(), file) ==
+                       json.size();
+  if (std::fclose(file) != 0 || !written) {
+    return absl::InternalError(absl::StrCat("Failed to write ", path));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace intrinsic::icon
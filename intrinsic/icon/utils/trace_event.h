@@ -0,0 +1,146 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_UTILS_TRACE_EVENT_H_
+#define INTRINSIC_ICON_UTILS_TRACE_EVENT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace intrinsic::icon {
+
+// Lightweight, real-time safe tracing of begin, end and instant events.
+//
+// Each thread records into its own ring buffer, which a non-RT
+// TraceCollector drains and writes out in the Chrome trace event format. The
+// files open in https://ui.perfetto.dev and chrome://tracing, so that a
+// single trace shows e.g. a skill, the ICON actions it starts and the
+// reactions it waits for on one timeline.
+//
+// Events are stamped with Clock::Now() and Cycle::GetCurrentCycle(). Tracing
+// is off by default and then costs a single relaxed load per event.
+//
+// Usage:
+// \code
+// void Loop() {
+//   INTRINSIC_TRACE_SCOPE("control", "ApplyCommand");
+//   ...
+//   if (triggered) TraceInstant("control", "ReactionTriggered");
+// }
+// \endcode
+//
+// `category` and `name` must be string literals, or otherwise outlive the
+// collector: events only store the pointers.
+
+enum class TracePhase : char {
+  kBegin = 'B',
+  kEnd = 'E',
+  kInstant = 'i',
+};
+
+struct TraceEvent {
+  const char* category = "";
+  const char* name = "";
+  // Clock::Now() in nanoseconds.
+  int64_t time_ns = 0;
+  // Cycle::GetCurrentCycle().
+  uint64_t cycle = 0;
+  TracePhase phase = TracePhase::kInstant;
+};
+
+// Thread-safe. Turns recording on or off for all threads.
+void SetTracingEnabled(bool enabled);
+// RT safe.
+bool IsTracingEnabled();
+
+// Not RT safe.
+// Allocates the trace buffer of the calling thread, which holds up to
+// `capacity` events between two drains, and names the thread `thread_name`
+// in traces. intrinsic::Thread calls this for all its threads. Events of
+// threads without a buffer are dropped.
+// Calling this again on the same thread keeps the existing buffer.
+void TraceInitForThisThread(absl::string_view thread_name,
+                            size_t capacity = 1024);
+
+// RT safe.
+// Record an event on the calling thread. If the buffer of the thread is full,
+// the event is dropped and counted, see TraceCollector::num_dropped().
+void TraceBegin(const char* category, const char* name);
+void TraceEnd(const char* category, const char* name);
+void TraceInstant(const char* category, const char* name);
+
+// RT safe.
+// Records a begin event on construction and the matching end event on
+// destruction.
+class ScopedTraceEvent {
+ public:
+  ScopedTraceEvent(const char* category, const char* name)
+      : category_(category), name_(name) {
+    TraceBegin(category_, name_);
+  }
+  ~ScopedTraceEvent() { TraceEnd(category_, name_); }
+
+  ScopedTraceEvent(const ScopedTraceEvent&) = delete;
+  ScopedTraceEvent& operator=(const ScopedTraceEvent&) = delete;
+
+ private:
+  const char* category_;
+  const char* name_;
+};
+
+// Not RT safe.
+// Collects the events of all threads and writes them out. Use a single
+// collector per process; concurrent drains are serialized.
+class TraceCollector {
+ public:
+  // An event with the thread it was recorded on.
+  struct ThreadEvent {
+    // Unique per thread, in the order in which threads initialized tracing.
+    int thread_id;
+    TraceEvent event;
+  };
+
+  // Moves the events that all threads recorded since the last drain into
+  // this collector. Call this regularly, the per-thread buffers are bounded.
+  // Also releases the buffers of threads that have exited.
+  void Drain();
+
+  // Drains and returns the collected events in the Chrome trace event JSON
+  // format, including the thread names.
+  std::string ToChromeTraceJson();
+
+  // Drains and writes the collected events to `filename`, see
+  // ToChromeTraceJson().
+  absl::Status WriteChromeTrace(absl::string_view filename);
+
+  // Drops the collected events.
+  void Clear() { events_.clear(); }
+
+  const std::vector<ThreadEvent>& events() const { return events_; }
+
+  // Number of events that were dropped because a per-thread buffer was full.
+  uint64_t num_dropped() const { return num_dropped_; }
+
+ private:
+  std::vector<ThreadEvent> events_;
+  // Names of all threads seen by Drain(), by thread id.
+  std::vector<std::pair<int, std::string>> thread_names_;
+  uint64_t num_dropped_ = 0;
+};
+
+}  // namespace intrinsic::icon
+
+#define INTRINSIC_TRACE_CONCAT_INNER(a, b) a##b
+#define INTRINSIC_TRACE_CONCAT(a, b) INTRINSIC_TRACE_CONCAT_INNER(a, b)
+
+// Traces the rest of the enclosing scope. RT safe.
+#define INTRINSIC_TRACE_SCOPE(category, name)                     \
+  ::intrinsic::icon::ScopedTraceEvent INTRINSIC_TRACE_CONCAT(     \
+      intrinsic_trace_scope_, __LINE__)(category, name)
+
+#endif  // INTRINSIC_ICON_UTILS_TRACE_EVENT_H_
@@ -0,0 +1,84 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/trace_event.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "intrinsic/icon/utils/current_cycle.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::icon {
+namespace {
+
+using ::testing::HasSubstr;
+
+// Tracing state is global, so each test starts from a drained collector.
+class TraceEventTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    TraceInitForThisThread("test_main", /*capacity=*/8);
+    collector_.Drain();
+    collector_.Clear();
+    SetTracingEnabled(true);
+  }
+  void TearDown() override { SetTracingEnabled(false); }
+
+  TraceCollector collector_;
+};
+
+TEST_F(TraceEventTest, RecordsScopesAndInstants) {
+  Cycle::SetCurrentCycle(42);
+  {
+    INTRINSIC_TRACE_SCOPE("test", "Scope");
+    TraceInstant("test", "Instant");
+  }
+  collector_.Drain();
+  const std::vector<TraceCollector::ThreadEvent>& events = collector_.events();
+  ASSERT_EQ(events.size(), 3);
+  EXPECT_EQ(events[0].event.phase, TracePhase::kBegin);
+  EXPECT_EQ(events[1].event.phase, TracePhase::kInstant);
+  EXPECT_EQ(events[2].event.phase, TracePhase::kEnd);
+  EXPECT_STREQ(events[1].event.name, "Instant");
+  EXPECT_EQ(events[1].event.cycle, 42);
+  EXPECT_LE(events[0].event.time_ns, events[2].event.time_ns);
+}
+
+TEST_F(TraceEventTest, DisabledTracingRecordsNothing) {
+  SetTracingEnabled(false);
+  TraceInstant("test", "Instant");
+  collector_.Drain();
+  EXPECT_TRUE(collector_.events().empty());
+}
+
+TEST_F(TraceEventTest, CountsDroppedEvents) {
+  for (int i = 0; i < 10; ++i) {
+    TraceInstant("test", "Instant");
+  }
+  collector_.Drain();
+  EXPECT_EQ(collector_.events().size(), 8);
+  EXPECT_EQ(collector_.num_dropped(), 2);
+}
+
+TEST_F(TraceEventTest, WritesChromeTraceOfAllThreads) {
+  Thread thread([]() {
+    TraceInitForThisThread("worker");
+    TraceInstant("test", "FromWorker");
+  });
+  thread.Join();
+  TraceInstant("test", "FromMain");
+
+  const std::string json = collector_.ToChromeTraceJson();
+  EXPECT_THAT(json, HasSubstr("\"traceEvents\":["));
+  EXPECT_THAT(json, HasSubstr("\"args\":{\"name\":\"worker\"}"));
+  EXPECT_THAT(json, HasSubstr("\"args\":{\"name\":\"test_main\"}"));
+  EXPECT_THAT(json, HasSubstr("\"name\":\"FromWorker\""));
+  EXPECT_THAT(json, HasSubstr("\"name\":\"FromMain\""));
+  EXPECT_EQ(collector_.events().size(), 2);
+}
+
+}  // namespace
+}  // namespace intrinsic::icon
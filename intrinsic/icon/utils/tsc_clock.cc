@@ -0,0 +1,200 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/tsc_clock.h"
+
+#include <time.h>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "absl/base/attributes.h"
+#include "absl/base/const_init.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/utils/clock.h"
+#include "intrinsic/icon/utils/duration.h"
+#include "intrinsic/icon/utils/log_internal.h"
+
+namespace intrinsic {
+namespace {
+
+// The rate is a fixed point number with kRateShift fractional bits.
+constexpr int kRateShift = 32;
+constexpr absl::Duration kCalibrationDuration = absl::Milliseconds(10);
+// Number of attempts to read the TSC and CLOCK_MONOTONIC close together.
+constexpr int kNumSampleAttempts = 16;
+
+int64_t MonotonicNowNs() {
+  timespec ts;
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ToInt64Nanoseconds(DurationFromTimespec(ts));
+}
+
+#if defined(__x86_64__)
+uint64_t ReadTsc() { return __rdtsc(); }
+
+bool HasInvariantTsc() {
+  unsigned int eax, ebx, ecx, edx;
+  if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 ||
+      eax < 0x80000007) {
+    return false;
+  }
+  if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0) {
+    return false;
+  }
+  return (edx & (1u << 8)) != 0;
+}
+#else
+uint64_t ReadTsc() { return 0; }
+
+bool HasInvariantTsc() { return false; }
+#endif
+
+// A TSC value and the CLOCK_MONOTONIC time at which it was read.
+struct Sample {
+  uint64_t tsc = 0;
+  int64_t ns = 0;
+};
+
+// Reads the TSC and CLOCK_MONOTONIC, and keeps the pair of reads that was
+// least disturbed, e.g. by interrupts.
+Sample TakeSample() {
+  Sample best;
+  uint64_t best_width = std::numeric_limits<uint64_t>::max();
+  for (int i = 0; i < kNumSampleAttempts; ++i) {
+    const uint64_t before = ReadTsc();
+    const int64_t ns = MonotonicNowNs();
+    const uint64_t after = ReadTsc();
+    if (after - before < best_width) {
+      best_width = after - before;
+      best = {.tsc = before + (after - before) / 2, .ns = ns};
+    }
+  }
+  return best;
+}
+
+// Parameters to convert the TSC to nanoseconds:
+// ns = ns_base + ((tsc - tsc_base) * rate) >> kRateShift.
+struct Conversion {
+  std::atomic<uint64_t> tsc_base = 0;
+  std::atomic<int64_t> ns_base = 0;
+  std::atomic<uint64_t> rate = 0;
+};
+
+// The readers use conversions[generation odd ? 1 : 0]. The writer only
+// writes the other conversion and then increments `generation`, so readers
+// only retry if an update completed while they were reading, but never wait
+// for a writer. Generation 0 means that the TSC is not calibrated.
+ABSL_CONST_INIT std::atomic<uint64_t> s_generation = 0;
+ABSL_CONST_INIT Conversion s_conversions[2];
+
+ABSL_CONST_INIT absl::Mutex s_calibration_mutex(absl::kConstInit);
+// The first sample of the calibration, used to measure the rate over a
+// growing interval.
+ABSL_CONST_INIT Sample s_first_sample ABSL_GUARDED_BY(s_calibration_mutex);
+
+int64_t Convert(uint64_t tsc, uint64_t tsc_base, int64_t ns_base,
+                uint64_t rate) {
+  // The TSC may be slightly behind `tsc_base` on other cores.
+  const __int128 ticks = static_cast<int64_t>(tsc - tsc_base);
+  return ns_base + static_cast<int64_t>((ticks * rate) >> kRateShift);
+}
+
+// Returns the rate in nanoseconds per tick between `from` and `to`.
+uint64_t Rate(const Sample& from, const Sample& to) {
+  const unsigned __int128 ns = static_cast<uint64_t>(to.ns - from.ns);
+  return static_cast<uint64_t>((ns << kRateShift) / (to.tsc - from.tsc));
+}
+
+void Publish(uint64_t tsc_base, int64_t ns_base, uint64_t rate)
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(s_calibration_mutex) {
+  const uint64_t generation = s_generation.load(std::memory_order_relaxed);
+  Conversion& next = s_conversions[(generation + 1) % 2];
+  next.tsc_base.store(tsc_base, std::memory_order_relaxed);
+  next.ns_base.store(ns_base, std::memory_order_relaxed);
+  next.rate.store(rate, std::memory_order_relaxed);
+  s_generation.store(generation + 1, std::memory_order_release);
+}
+
+void TscLogGetTime(int64_t* robot_timestamp_ns, int64_t* wall_timestamp_ns) {
+  *robot_timestamp_ns = TscClock::NowNs();
+  timespec ts_wall;
+  clock_gettime(CLOCK_REALTIME, &ts_wall);
+  *wall_timestamp_ns =
+      ts_wall.tv_nsec + static_cast<uint64_t>(ts_wall.tv_sec) * NSECS_PER_SEC;
+}
+
+}  // namespace
+
+bool TscClock::Calibrate() {
+  if (!HasInvariantTsc()) {
+    return false;
+  }
+  absl::MutexLock lock(&s_calibration_mutex);
+  const Sample first = TakeSample();
+  absl::SleepFor(kCalibrationDuration);
+  const Sample last = TakeSample();
+  if (last.tsc <= first.tsc || last.ns <= first.ns) {
+    return false;
+  }
+  s_first_sample = first;
+  Publish(first.tsc, first.ns, Rate(first, last));
+  return true;
+}
+
+void TscClock::Recalibrate() {
+  absl::MutexLock lock(&s_calibration_mutex);
+  if (!UsesTsc()) {
+    return;
+  }
+  const Sample now = TakeSample();
+  if (now.tsc <= s_first_sample.tsc || now.ns <= s_first_sample.ns) {
+    return;
+  }
+  // Jumps forward to CLOCK_MONOTONIC if the TSC is behind, but never back.
+  Publish(now.tsc, std::max(now.ns, NowNs()), Rate(s_first_sample, now));
+}
+
+bool TscClock::UsesTsc() {
+  return s_generation.load(std::memory_order_relaxed) != 0;
+}
+
+int64_t TscClock::NowNs() {
+  while (true) {
+    const uint64_t generation = s_generation.load(std::memory_order_acquire);
+    if (generation == 0) [[unlikely]] {
+      return MonotonicNowNs();
+    }
+    const Conversion& conversion = s_conversions[generation % 2];
+    const uint64_t tsc_base =
+        conversion.tsc_base.load(std::memory_order_relaxed);
+    const int64_t ns_base = conversion.ns_base.load(std::memory_order_relaxed);
+    const uint64_t rate = conversion.rate.load(std::memory_order_relaxed);
+    const uint64_t tsc = ReadTsc();
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s_generation.load(std::memory_order_relaxed) == generation)
+        [[likely]] {
+      return Convert(tsc, tsc_base, ns_base, rate);
+    }
+  }
+}
+
+bool UseTscClock() {
+  if (!TscClock::Calibrate()) {
+    return false;
+  }
+  Clock::setClockImpl(std::make_shared<TscClockDriver>());
+  icon::GlobalLogContext::SetTimeFunction(&TscLogGetTime);
+  return true;
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,81 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_ICON_UTILS_TSC_CLOCK_H_
+#define INTRINSIC_ICON_UTILS_TSC_CLOCK_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "intrinsic/icon/testing/realtime_annotations.h"
+#include "intrinsic/icon/utils/clock.h"
+
+namespace intrinsic {
+
+// A fast monotonic clock based on the time stamp counter (TSC) of the CPU.
+//
+// TscClock::NowNs() has the same epoch as CLOCK_MONOTONIC, but converts the
+// TSC with a calibrated rate instead of calling clock_gettime(). The read path
+// is a handful of loads and a multiplication, without locks, virtual dispatch
+// or reference counting, so that real-time code can take several timestamps
+// per cycle.
+//
+// The TSC is only used on x86-64 CPUs with an invariant TSC, and only after
+// Calibrate() was called. Otherwise, NowNs() falls back to
+// clock_gettime(CLOCK_MONOTONIC).
+//
+// The TSC and CLOCK_MONOTONIC drift apart slowly, e.g. due to NTP adjustments
+// of the latter. Call Recalibrate() periodically from a non-real-time thread
+// to keep them in sync.
+//
+// N.B. TscClock always measures wall time. Unlike Clock::Now(), it does not
+// follow the simulated time of a simulation.
+class TscClock {
+ public:
+  TscClock() = delete;
+
+  // Not real-time safe. Measures the rate of the TSC against CLOCK_MONOTONIC,
+  // which takes about 10ms. Returns false if the TSC is not usable, in which
+  // case NowNs() keeps using clock_gettime(). Calling Calibrate() again starts
+  // a new calibration.
+  static bool Calibrate() INTRINSIC_NON_REALTIME_ONLY;
+
+  // Not real-time safe. Updates the rate and offset of the TSC against
+  // CLOCK_MONOTONIC. The rate is measured over the whole time since
+  // Calibrate(), so it gets more precise with every call. Has no effect if the
+  // TSC is not calibrated.
+  //
+  // The time returned by NowNs() never goes backwards, but may jump forward by
+  // the drift since the last call.
+  static void Recalibrate() INTRINSIC_NON_REALTIME_ONLY;
+
+  // Returns whether NowNs() uses the TSC.
+  static bool UsesTsc() INTRINSIC_CHECK_REALTIME_SAFE;
+
+  // Thread safe. Returns the current time in nanoseconds, in the epoch of
+  // CLOCK_MONOTONIC.
+  static int64_t NowNs() INTRINSIC_CHECK_REALTIME_SAFE;
+
+  // Thread safe. Returns the current time.
+  static Time Now() INTRINSIC_CHECK_REALTIME_SAFE {
+    return timeFromNSec(NowNs());
+  }
+};
+
+// A Clock::IClockDriver that returns TscClock::Now().
+class TscClockDriver final : public Clock::IClockDriver {
+ public:
+  TscClockDriver() = default;
+
+  // Implement Clock::IClockDriver.
+  Clock::time_point now() const override { return TscClock::Now(); }
+};
+
+// Not real-time safe. Calibrates TscClock and, if the TSC is usable, makes it
+// the time source of Clock and of the timestamps of the real-time log. Like
+// Clock::setClockImpl(), this should be called once when the process is
+// initialized, and not in simulation. Returns TscClock::UsesTsc().
+bool UseTscClock() INTRINSIC_NON_REALTIME_ONLY;
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_ICON_UTILS_TSC_CLOCK_H_
@@ -0,0 +1,76 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/icon/utils/tsc_clock.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <time.h>
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/utils/clock.h"
+#include "intrinsic/icon/utils/duration.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic {
+namespace {
+
+int64_t MonotonicNowNs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ToInt64Nanoseconds(DurationFromTimespec(ts));
+}
+
+// Expects TscClock::NowNs() to be within `tolerance_ns` of CLOCK_MONOTONIC.
+void ExpectCloseToMonotonic(int64_t tolerance_ns) {
+  const int64_t before = MonotonicNowNs();
+  const int64_t now = TscClock::NowNs();
+  const int64_t after = MonotonicNowNs();
+  EXPECT_GE(now, before - tolerance_ns);
+  EXPECT_LE(now, after + tolerance_ns);
+}
+
+TEST(TscClockTest, FollowsMonotonicClock) {
+  // Before calibration, this is CLOCK_MONOTONIC.
+  ExpectCloseToMonotonic(0);
+  if (!TscClock::Calibrate()) {
+    GTEST_SKIP() << "No invariant TSC";
+  }
+  EXPECT_TRUE(TscClock::UsesTsc());
+  ExpectCloseToMonotonic(absl::ToInt64Nanoseconds(absl::Microseconds(100)));
+  absl::SleepFor(absl::Milliseconds(50));
+  ExpectCloseToMonotonic(absl::ToInt64Nanoseconds(absl::Microseconds(100)));
+  TscClock::Recalibrate();
+  ExpectCloseToMonotonic(absl::ToInt64Nanoseconds(absl::Microseconds(100)));
+}
+
+TEST(TscClockTest, IsMonotonic) {
+  TscClock::Calibrate();
+  int64_t previous = TscClock::NowNs();
+  for (int i = 0; i < 100000; ++i) {
+    if (i % 10000 == 0) {
+      TscClock::Recalibrate();
+    }
+    const int64_t now = TscClock::NowNs();
+    ASSERT_GE(now, previous);
+    previous = now;
+  }
+}
+
+TEST(TscClockTest, DriverServesClock) {
+  if (!UseTscClock()) {
+    GTEST_SKIP() << "No invariant TSC";
+  }
+  const int64_t before = TscClock::NowNs();
+  const int64_t now = Clock::now_ns();
+  EXPECT_GE(now, before);
+  EXPECT_LE(now, TscClock::NowNs());
+  Clock::setClockImpl(nullptr);
+}
+
+}  // namespace
+}  // namespace intrinsic
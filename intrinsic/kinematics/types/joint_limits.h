@@ -4,7 +4,9 @@
 #define INTRINSIC_KINEMATICS_TYPES_JOINT_LIMITS_H_
 
 #include <cstddef>
+#include <limits>
 
+#include "Eigen/Core"
 #include "absl/status/statusor.h"
 #include "intrinsic/eigenmath/types.h"
 #include "intrinsic/icon/utils/realtime_status.h"
@@ -51,6 +53,81 @@ struct JointLimits {
   eigenmath::VectorNd max_torque;
 };
 
+// Same as JointLimits for exactly DOF joints, e.g., JointLimitsN<7>. The size
+// is known at compile time, so that per-cycle limit checks unroll and need no
+// size checks. Convert from JointLimits once, outside of the real-time loop.
+template <int DOF>
+struct JointLimitsN {
+  static_assert(DOF > 0 && DOF <= JointLimits::kMaxSize,
+                "DOF must be in [1, JointLimits::kMaxSize]");
+
+  using Vector = eigenmath::Vectord<DOF, Eigen::DontAlign>;
+
+  // Makes JointLimitsN with each limit range set to (-infinity, infinity).
+  static JointLimitsN Unlimited() {
+    JointLimitsN limits;
+    limits.SetUnlimited();
+    return limits;
+  }
+
+  // Converts `limits`, which must have exactly DOF joints.
+  static icon::RealtimeStatusOr<JointLimitsN> FromJointLimits(
+      const JointLimits& limits) {
+    if (!limits.IsSizeConsistent() || limits.size() != DOF) {
+      return icon::InvalidArgumentError(icon::RealtimeStatus::StrCat(
+          "Expected joint limits of size ", DOF, ", but size=", limits.size()));
+    }
+    JointLimitsN limits_n;
+    limits_n.min_position = limits.min_position;
+    limits_n.max_position = limits.max_position;
+    limits_n.max_velocity = limits.max_velocity;
+    limits_n.max_acceleration = limits.max_acceleration;
+    limits_n.max_jerk = limits.max_jerk;
+    limits_n.max_torque = limits.max_torque;
+    return limits_n;
+  }
+
+  // Returns the number of joints.
+  static constexpr eigenmath::VectorXd::Index size() { return DOF; }
+
+  // Sets each limit range to (-infinity, infinity).
+  void SetUnlimited() {
+    min_position.setConstant(-std::numeric_limits<double>::infinity());
+    max_position.setConstant(std::numeric_limits<double>::infinity());
+    max_velocity.setConstant(std::numeric_limits<double>::infinity());
+    max_acceleration.setConstant(std::numeric_limits<double>::infinity());
+    max_jerk.setConstant(std::numeric_limits<double>::infinity());
+    max_torque.setConstant(std::numeric_limits<double>::infinity());
+  }
+
+  // Same as JointLimits::IsValid().
+  bool IsValid() const {
+    return (max_position - min_position).minCoeff() >= 0 &&
+           (max_velocity.array() >= 0).all() &&
+           (max_acceleration.array() >= 0).all() &&
+           (max_jerk.array() >= 0).all() && (max_torque.array() >= 0).all();
+  }
+
+  JointLimits ToJointLimits() const {
+    JointLimits limits;
+    limits.min_position = min_position;
+    limits.max_position = max_position;
+    limits.max_velocity = max_velocity;
+    limits.max_acceleration = max_acceleration;
+    limits.max_jerk = max_jerk;
+    limits.max_torque = max_torque;
+    return limits;
+  }
+
+  // Limit vectors. Zero until set.
+  Vector min_position = Vector::Zero();
+  Vector max_position = Vector::Zero();
+  Vector max_velocity = Vector::Zero();
+  Vector max_acceleration = Vector::Zero();
+  Vector max_jerk = Vector::Zero();
+  Vector max_torque = Vector::Zero();
+};
+
 intrinsic_proto::JointLimits ToProto(const JointLimits& limits);
 
 absl::StatusOr<JointLimits> FromProto(
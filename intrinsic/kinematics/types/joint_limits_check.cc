@@ -0,0 +1,234 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/kinematics/types/joint_limits_check.h"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Eigen/Core"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/substitute.h"
+#include "google/protobuf/repeated_field.h"
+#include "intrinsic/eigenmath/types.h"
+#include "intrinsic/icon/proto/joint_space.pb.h"
+#include "intrinsic/kinematics/types/dynamic_limits_check_mode.h"
+#include "intrinsic/kinematics/types/joint_limits_xd.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic {
+
+namespace {
+
+using Index = eigenmath::MatrixXd::Index;
+
+// The number of samples checked at a time. Large enough for the array
+// expressions to amortize their setup, small enough to stop soon after all
+// joints have a violation.
+constexpr Index kBlockSize = 1024;
+
+// The samples of one quantity and the range they must stay in.
+struct Check {
+  JointLimitViolation::Type type;
+  const eigenmath::MatrixXd* samples;
+  eigenmath::VectorXd lower;
+  eigenmath::VectorXd upper;
+};
+
+absl::string_view TypeName(JointLimitViolation::Type type) {
+  switch (type) {
+    case JointLimitViolation::Type::kPosition:
+      return "position";
+    case JointLimitViolation::Type::kVelocity:
+      return "velocity";
+    case JointLimitViolation::Type::kAcceleration:
+      return "acceleration";
+    case JointLimitViolation::Type::kJerk:
+      return "jerk";
+  }
+  return "unknown";
+}
+
+// Adds a check of `samples` to `checks` unless `samples` is empty. Updates
+// `num_samples`, which is negative until the first non-empty matrix.
+absl::Status AddCheck(JointLimitViolation::Type type,
+                      const eigenmath::MatrixXd& samples,
+                      const eigenmath::VectorXd& lower,
+                      const eigenmath::VectorXd& upper, Index& num_samples,
+                      std::vector<Check>& checks) {
+  if (samples.size() == 0) {
+    return absl::OkStatus();
+  }
+  if (samples.rows() != lower.size()) {
+    return absl::InvalidArgumentError(
+        absl::Substitute("The $0 samples have $1 rows, expected one per joint "
+                         "of the limits ($2)",
+                         TypeName(type), samples.rows(), lower.size()));
+  }
+  if (num_samples >= 0 && samples.cols() != num_samples) {
+    return absl::InvalidArgumentError(absl::Substitute(
+        "The $0 samples have $1 columns, expected $2 like the others",
+        TypeName(type), samples.cols(), num_samples));
+  }
+  num_samples = samples.cols();
+  checks.push_back(
+      {.type = type, .samples = &samples, .lower = lower, .upper = upper});
+  return absl::OkStatus();
+}
+
+// Returns the values of `field` of all states as a matrix with one column per
+// state, or an empty matrix if the states have no values.
+template <typename Field>
+absl::StatusOr<eigenmath::MatrixXd> ToSampleMatrix(
+    const google::protobuf::RepeatedPtrField<
+        intrinsic_proto::icon::JointStatePVA>& states,
+    absl::string_view name, Field field) {
+  if (states.empty() || field(states[0]).empty()) {
+    return eigenmath::MatrixXd();
+  }
+  const int num_joints = field(states[0]).size();
+  eigenmath::MatrixXd samples(num_joints, states.size());
+  for (int i = 0; i < states.size(); ++i) {
+    const google::protobuf::RepeatedField<double>& values = field(states[i]);
+    if (values.size() != num_joints) {
+      return absl::InvalidArgumentError(absl::Substitute(
+          "State $0 has $1 $2 values, expected $3 like the first state", i,
+          values.size(), name, num_joints));
+    }
+    std::copy(values.begin(), values.end(), samples.col(i).data());
+  }
+  return samples;
+}
+
+}  // namespace
+
+absl::StatusOr<std::vector<JointLimitViolation>> CheckJointLimits(
+    const JointLimitsXd& limits, const eigenmath::MatrixXd& position,
+    const eigenmath::MatrixXd& velocity,
+    const eigenmath::MatrixXd& acceleration, const eigenmath::MatrixXd& jerk,
+    DynamicLimitsCheckMode check_mode) {
+  if (!limits.IsSizeConsistent()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Joint limits are not size consistent: ",
+                     ToString(limits)));
+  }
+
+  // Ordered by increasing order, so that the lowest order wins ties.
+  std::vector<Check> checks;
+  Index num_samples = -1;
+  INTR_RETURN_IF_ERROR(AddCheck(JointLimitViolation::Type::kPosition, position,
+                                limits.min_position, limits.max_position,
+                                num_samples, checks));
+  INTR_RETURN_IF_ERROR(AddCheck(JointLimitViolation::Type::kVelocity, velocity,
+                                -limits.max_velocity, limits.max_velocity,
+                                num_samples, checks));
+  if (check_mode == DynamicLimitsCheckMode::kCheckJointAcceleration) {
+    INTR_RETURN_IF_ERROR(AddCheck(
+        JointLimitViolation::Type::kAcceleration, acceleration,
+        -limits.max_acceleration, limits.max_acceleration, num_samples,
+        checks));
+    INTR_RETURN_IF_ERROR(AddCheck(JointLimitViolation::Type::kJerk, jerk,
+                                  -limits.max_jerk, limits.max_jerk,
+                                  num_samples, checks));
+  }
+
+  const Index num_joints = limits.size();
+  std::vector<std::optional<JointLimitViolation>> first(num_joints);
+  Index num_violating = 0;
+  Eigen::Array<bool, Eigen::Dynamic, Eigen::Dynamic> outside(num_joints,
+                                                             kBlockSize);
+  for (Index begin = 0; begin < num_samples && num_violating < num_joints;
+       begin += kBlockSize) {
+    const Index n = std::min(kBlockSize, num_samples - begin);
+    for (const Check& check : checks) {
+      const auto block = check.samples->middleCols(begin, n).array();
+      // NaN compares false, so it is outside of any range.
+      outside.leftCols(n) =
+          !((block >= check.lower.array().replicate(1, n)) &&
+            (block <= check.upper.array().replicate(1, n)));
+      // Only the rows of joints that are outside of their range are searched
+      // for the first violating sample.
+      const Eigen::Array<bool, Eigen::Dynamic, 1> any =
+          outside.leftCols(n).rowwise().any();
+      for (Index joint = 0; joint < num_joints; ++joint) {
+        if (!any[joint]) {
+          continue;
+        }
+        Index column = 0;
+        while (!outside(joint, column)) {
+          ++column;
+        }
+        const Index sample = begin + column;
+        if (first[joint].has_value() && first[joint]->sample <= sample) {
+          continue;
+        }
+        const double value = (*check.samples)(joint, sample);
+        first[joint] = JointLimitViolation{
+            .joint = joint,
+            .sample = sample,
+            .type = check.type,
+            .value = value,
+            .limit = check.type == JointLimitViolation::Type::kPosition &&
+                             value < check.lower[joint]
+                         ? check.lower[joint]
+                         : check.upper[joint],
+        };
+      }
+    }
+    num_violating = std::count_if(
+        first.begin(), first.end(),
+        [](const std::optional<JointLimitViolation>& violation) {
+          return violation.has_value();
+        });
+  }
+
+  std::vector<JointLimitViolation> violations;
+  for (const std::optional<JointLimitViolation>& violation : first) {
+    if (violation.has_value()) {
+      violations.push_back(*violation);
+    }
+  }
+  return violations;
+}
+
+absl::StatusOr<std::vector<JointLimitViolation>> CheckJointLimits(
+    const JointLimitsXd& limits,
+    const intrinsic_proto::icon::JointTrajectoryPVA& trajectory) {
+  INTR_ASSIGN_OR_RETURN(
+      const DynamicLimitsCheckMode check_mode,
+      FromProto(trajectory.joint_dynamic_limits_check_mode()));
+  using State = intrinsic_proto::icon::JointStatePVA;
+  INTR_ASSIGN_OR_RETURN(
+      const eigenmath::MatrixXd position,
+      ToSampleMatrix(trajectory.state(), "position",
+                     [](const State& state) -> const auto& {
+                       return state.position();
+                     }));
+  INTR_ASSIGN_OR_RETURN(
+      const eigenmath::MatrixXd velocity,
+      ToSampleMatrix(trajectory.state(), "velocity",
+                     [](const State& state) -> const auto& {
+                       return state.velocity();
+                     }));
+  INTR_ASSIGN_OR_RETURN(
+      const eigenmath::MatrixXd acceleration,
+      ToSampleMatrix(trajectory.state(), "acceleration",
+                     [](const State& state) -> const auto& {
+                       return state.acceleration();
+                     }));
+  return CheckJointLimits(limits, position, velocity, acceleration,
+                          eigenmath::MatrixXd(), check_mode);
+}
+
+std::string ToString(const JointLimitViolation& violation) {
+  return absl::Substitute(
+      "Joint $0 exceeds its $1 limit $2 at sample $3 with $4", violation.joint,
+      TypeName(violation.type), violation.limit, violation.sample,
+      violation.value);
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,65 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_KINEMATICS_TYPES_JOINT_LIMITS_CHECK_H_
+#define INTRINSIC_KINEMATICS_TYPES_JOINT_LIMITS_CHECK_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "intrinsic/eigenmath/types.h"
+#include "intrinsic/icon/proto/joint_space.pb.h"
+#include "intrinsic/kinematics/types/dynamic_limits_check_mode.h"
+#include "intrinsic/kinematics/types/joint_limits_xd.h"
+
+namespace intrinsic {
+
+// The first sample of a trajectory at which a joint exceeds one of its limits.
+struct JointLimitViolation {
+  enum class Type { kPosition, kVelocity, kAcceleration, kJerk };
+
+  eigenmath::MatrixXd::Index joint;
+  eigenmath::MatrixXd::Index sample;
+  Type type;
+  // The value of the joint at `sample`, and the limit it exceeds. For
+  // velocity, acceleration and jerk, the limit is the maximum magnitude.
+  double value;
+  double limit;
+};
+
+// Checks the samples of a trajectory against `limits`, and returns the first
+// violation of each joint that exceeds a limit, ordered by joint. Returns an
+// empty vector if the trajectory is within the limits.
+//
+// Each matrix has one row per joint and one column per sample. Matrices that
+// are empty are not checked, e.g., if a trajectory has no jerk. Acceleration
+// and jerk are only checked with kCheckJointAcceleration. If a joint exceeds
+// several limits at the same sample, the violation of the lowest order is
+// reported.
+//
+// Samples are checked in blocks across all joints with Eigen array
+// expressions, and checking stops once every joint has a violation.
+//
+// Returns InvalidArgumentError if `limits` are not size consistent, or if a
+// non-empty matrix does not have one row per joint or has a different number
+// of samples than the others.
+absl::StatusOr<std::vector<JointLimitViolation>> CheckJointLimits(
+    const JointLimitsXd& limits, const eigenmath::MatrixXd& position,
+    const eigenmath::MatrixXd& velocity,
+    const eigenmath::MatrixXd& acceleration, const eigenmath::MatrixXd& jerk,
+    DynamicLimitsCheckMode check_mode);
+
+// Same as above, for the positions, velocities and accelerations of
+// `trajectory`, with its joint_dynamic_limits_check_mode.
+//
+// Returns InvalidArgumentError if the states of `trajectory` do not all have
+// the same number of joints.
+absl::StatusOr<std::vector<JointLimitViolation>> CheckJointLimits(
+    const JointLimitsXd& limits,
+    const intrinsic_proto::icon::JointTrajectoryPVA& trajectory);
+
+std::string ToString(const JointLimitViolation& violation);
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_KINEMATICS_TYPES_JOINT_LIMITS_CHECK_H_
@@ -25,6 +25,17 @@ using JointStateVAJ = StateRnVAJ;
 template <int N = eigenmath::MAX_EIGEN_VECTOR_SIZE>
 using JointStatePVAWithMaxSize = StateRnPVAWithMaxSize<N>;
 
+template <int N>
+using JointStatePWithFixedSize = StateRnPWithFixedSize<N>;
+template <int N>
+using JointStatePVWithFixedSize = StateRnPVWithFixedSize<N>;
+template <int N>
+using JointStatePVAWithFixedSize = StateRnPVAWithFixedSize<N>;
+template <int N>
+using JointStatePVAJWithFixedSize = StateRnPVAJWithFixedSize<N>;
+template <int N>
+using JointStatePVATWithFixedSize = StateRnPVATWithFixedSize<N>;
+
 }  // namespace intrinsic
 
 #endif  // INTRINSIC_KINEMATICS_TYPES_JOINT_STATE_H_
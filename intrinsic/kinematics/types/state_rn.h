@@ -14,14 +14,16 @@ namespace intrinsic {
 namespace state_rn_details {
 
 // Helper macro for accessing a named data member from `data()` call
-#define CREATE_STATE_RN_BASE(CLASS_NAME, TYPE, VAR_NAME) \
-  template <int N = eigenmath::MAX_EIGEN_VECTOR_SIZE>    \
-  struct CLASS_NAME {                                    \
-    TYPE<N> VAR_NAME;                                    \
-                                                         \
-   protected:                                            \
-    TYPE<N>& value() { return VAR_NAME; }                \
-    const TYPE<N>& value() const { return VAR_NAME; }    \
+#define CREATE_STATE_RN_BASE(CLASS_NAME, TYPE, VAR_NAME)                \
+  template <int N = eigenmath::MAX_EIGEN_VECTOR_SIZE>                   \
+  struct CLASS_NAME {                                                   \
+    TYPE<N> VAR_NAME;                                                   \
+                                                                        \
+   protected:                                                           \
+    static constexpr bool kIsFixedSize =                                \
+        TYPE<N>::RowsAtCompileTime != Eigen::Dynamic;                   \
+    TYPE<N>& value() { return VAR_NAME; }                               \
+    const TYPE<N>& value() const { return VAR_NAME; }                   \
   }
 
 // use trivial derived types here so we can use the class type to set to
@@ -35,6 +37,10 @@ struct MaxVectorNd : public eigenmath::VectorNdWithMaxSize<N> {
   using eigenmath::VectorNdWithMaxSize<N>::VectorNdWithMaxSize;
 };
 
+// Eigen vector of doubles with exactly N elements.
+template <int N>
+using VectorNdWithFixedSize = eigenmath::Vectord<N, Eigen::DontAlign>;
+
 CREATE_STATE_RN_BASE(StateRnBaseP, eigenmath::VectorNdWithMaxSize, position);
 CREATE_STATE_RN_BASE(StateRnBaseV, eigenmath::VectorNdWithMaxSize, velocity);
 CREATE_STATE_RN_BASE(StateRnBaseA, eigenmath::VectorNdWithMaxSize,
@@ -42,39 +48,140 @@ CREATE_STATE_RN_BASE(StateRnBaseA, eigenmath::VectorNdWithMaxSize,
 CREATE_STATE_RN_BASE(StateRnBaseJ, eigenmath::VectorNdWithMaxSize, jerk);
 CREATE_STATE_RN_BASE(StateRnBaseT, eigenmath::VectorNdWithMaxSize, torque);
 
+CREATE_STATE_RN_BASE(StateRnFixedBaseP, VectorNdWithFixedSize, position);
+CREATE_STATE_RN_BASE(StateRnFixedBaseV, VectorNdWithFixedSize, velocity);
+CREATE_STATE_RN_BASE(StateRnFixedBaseA, VectorNdWithFixedSize, acceleration);
+CREATE_STATE_RN_BASE(StateRnFixedBaseJ, VectorNdWithFixedSize, jerk);
+CREATE_STATE_RN_BASE(StateRnFixedBaseT, VectorNdWithFixedSize, torque);
+
 #undef CREATE_STATE_RN_BASE
 
 }  // namespace state_rn_details
 
+// A state with up to N elements per vector, or exactly N elements if the
+// bases have a fixed size (see StateRnPVAWithFixedSize). With a fixed size,
+// size() is a compile time constant and there are no dynamic size checks.
 template <int N, typename... Bases>
 struct StateRn : AggregateType<Bases...> {
   using AggregateType<Bases...>::AggregateType;
 
+  static constexpr bool kIsFixedSize = (Bases::kIsFixedSize && ...);
+  static_assert(kIsFixedSize || !(Bases::kIsFixedSize || ...),
+                "Cannot mix bases with fixed and dynamic size");
+
   static StateRn Zero(Eigen::Index size) {
     StateRn state;
     CHECK_OK(state.SetSize(size));
     return state;
   }
 
+  // Returns a state of size N with all values set to zero. Only for states
+  // with a fixed size.
+  static StateRn Zero() {
+    static_assert(kIsFixedSize, "Zero() requires a size, use Zero(size)");
+    StateRn state;
+    (state.Bases::value().setZero(), ...);
+    return state;
+  }
+
   Eigen::Index size() const {
-    using B = std::tuple_element_t<0, std::tuple<Bases...>>;
-    return B::value().rows();
+    if constexpr (kIsFixedSize) {
+      return N;
+    } else {
+      using B = std::tuple_element_t<0, std::tuple<Bases...>>;
+      return B::value().rows();
+    }
   }
 
   bool IsSizeConsistent() const {
-    const Eigen::Index size = this->size();
-    return ((Bases::value().rows() == size) && ...);
+    if constexpr (kIsFixedSize) {
+      return true;
+    } else {
+      const Eigen::Index size = this->size();
+      return ((Bases::value().rows() == size) && ...);
+    }
   }
 
   icon::RealtimeStatus SetSize(Eigen::Index size) {
-    if (size > N) {
-      return icon::InvalidArgumentError(icon::RealtimeStatus::StrCat(
-          "MAX_EIGEN_VECTOR_SIZE set to ", N, ", but dof= ", size));
+    if constexpr (kIsFixedSize) {
+      if (size != N) {
+        return icon::InvalidArgumentError(icon::RealtimeStatus::StrCat(
+            "Size fixed to ", N, ", but dof= ", size));
+      }
+    } else {
+      if (size > N) {
+        return icon::InvalidArgumentError(icon::RealtimeStatus::StrCat(
+            "MAX_EIGEN_VECTOR_SIZE set to ", N, ", but dof= ", size));
+      }
+      (Bases::value().resize(size), ...);
     }
-    (Bases::value().resize(size), ...);
     (Bases::value().setConstant(0.), ...);
     return icon::OkStatus();
   }
+
+  // Fused element-wise operations over all bases. For states with a fixed
+  // size, they run as a single Eigen expression over the values of all bases
+  // together, which vectorizes without a remainder per base. All states must
+  // have the same size. Real-time safe.
+
+  // Sets this state to `this + alpha * x`.
+  void Axpy(double alpha, const StateRn& x) {
+    if constexpr (kIsFixedSize) {
+      Flat() += alpha * x.Flat();
+    } else {
+      ((Bases::value() += alpha * x.Bases::value()), ...);
+    }
+  }
+
+  // Clamps every value of this state to the corresponding values of `lower`
+  // and `upper`.
+  void Clamp(const StateRn& lower, const StateRn& upper) {
+    if constexpr (kIsFixedSize) {
+      Flat() = Flat().cwiseMax(lower.Flat()).cwiseMin(upper.Flat());
+    } else {
+      ((Bases::value() = Bases::value()
+                             .cwiseMax(lower.Bases::value())
+                             .cwiseMin(upper.Bases::value())),
+       ...);
+    }
+  }
+
+  // Returns `from + t * (to - from)`, i.e., `from` for t = 0 and `to` for
+  // t = 1.
+  static StateRn Interpolate(const StateRn& from, const StateRn& to,
+                             double t) {
+    StateRn result;
+    if constexpr (kIsFixedSize) {
+      result.Flat() = from.Flat() + t * (to.Flat() - from.Flat());
+    } else {
+      ((result.Bases::value() =
+            from.Bases::value() +
+            t * (to.Bases::value() - from.Bases::value())),
+       ...);
+    }
+    return result;
+  }
+
+ private:
+  // The values of all bases of a fixed size state as one vector. The bases
+  // consist of nothing but their values, so the state is an array of doubles.
+  // The order of the bases in it is up to the compiler, which is fine for
+  // element-wise operations between states of the same type.
+  using FlatVector =
+      eigenmath::Vectord<N * sizeof...(Bases), Eigen::DontAlign>;
+
+  Eigen::Map<FlatVector> Flat() {
+    static_assert(kIsFixedSize);
+    static_assert(sizeof(StateRn) == sizeof(FlatVector),
+                  "The bases of a fixed size state must have no padding");
+    return Eigen::Map<FlatVector>(reinterpret_cast<double*>(this));
+  }
+  Eigen::Map<const FlatVector> Flat() const {
+    static_assert(kIsFixedSize);
+    static_assert(sizeof(StateRn) == sizeof(FlatVector),
+                  "The bases of a fixed size state must have no padding");
+    return Eigen::Map<const FlatVector>(reinterpret_cast<const double*>(this));
+  }
 };
 
 using StateRnP =
@@ -102,6 +209,33 @@ using StateRnPVAWithMaxSize = StateRn<N, state_rn_details::StateRnBaseP<N>,
 // default version using MAX_EIGEN_MATRIX_SIZE
 using StateRnPVA = StateRnPVAWithMaxSize<eigenmath::MAX_EIGEN_VECTOR_SIZE>;
 
+// Joint states with exactly N joints, e.g., for the real-time paths of 6- and
+// 7-DOF robots.
+template <int N>
+using StateRnPWithFixedSize =
+    StateRn<N, state_rn_details::StateRnFixedBaseP<N>>;
+template <int N>
+using StateRnPVWithFixedSize =
+    StateRn<N, state_rn_details::StateRnFixedBaseP<N>,
+            state_rn_details::StateRnFixedBaseV<N>>;
+template <int N>
+using StateRnPVAWithFixedSize =
+    StateRn<N, state_rn_details::StateRnFixedBaseP<N>,
+            state_rn_details::StateRnFixedBaseV<N>,
+            state_rn_details::StateRnFixedBaseA<N>>;
+template <int N>
+using StateRnPVAJWithFixedSize =
+    StateRn<N, state_rn_details::StateRnFixedBaseP<N>,
+            state_rn_details::StateRnFixedBaseV<N>,
+            state_rn_details::StateRnFixedBaseA<N>,
+            state_rn_details::StateRnFixedBaseJ<N>>;
+template <int N>
+using StateRnPVATWithFixedSize =
+    StateRn<N, state_rn_details::StateRnFixedBaseP<N>,
+            state_rn_details::StateRnFixedBaseV<N>,
+            state_rn_details::StateRnFixedBaseA<N>,
+            state_rn_details::StateRnFixedBaseT<N>>;
+
 using StateRnPVT =
     StateRn<eigenmath::MAX_EIGEN_VECTOR_SIZE, state_rn_details::StateRnBaseP<>,
             state_rn_details::StateRnBaseV<>, state_rn_details::StateRnBaseT<>>;
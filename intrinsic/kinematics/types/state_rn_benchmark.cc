@@ -0,0 +1,100 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+// Compares the fused element-wise operations of StateRn to running the same
+// operation one base at a time, for a 7-DOF joint state.
+//
+// Run with:
+//   bazel run -c opt //intrinsic/kinematics/types:state_rn_benchmark
+
+#include "benchmark/benchmark.h"
+#include "intrinsic/eigenmath/types.h"
+#include "intrinsic/kinematics/types/state_rn.h"
+
+namespace intrinsic {
+namespace {
+
+constexpr int kDof = 7;
+
+template <typename State>
+State MakeState(double offset) {
+  State state = State::Zero(kDof);
+  for (int i = 0; i < kDof; ++i) {
+    state.position[i] = offset + i;
+    state.velocity[i] = offset - i;
+    state.acceleration[i] = offset * i;
+  }
+  return state;
+}
+
+template <typename State>
+void BM_AxpyPerBase(benchmark::State& state) {
+  State y = MakeState<State>(1.0);
+  const State x = MakeState<State>(2.0);
+  for (auto s : state) {
+    y.position += 1e-3 * x.position;
+    y.velocity += 1e-3 * x.velocity;
+    y.acceleration += 1e-3 * x.acceleration;
+    benchmark::DoNotOptimize(y);
+  }
+}
+BENCHMARK(BM_AxpyPerBase<StateRnPVAWithFixedSize<kDof>>);
+BENCHMARK(BM_AxpyPerBase<StateRnPVA>);
+
+template <typename State>
+void BM_Axpy(benchmark::State& state) {
+  State y = MakeState<State>(1.0);
+  const State x = MakeState<State>(2.0);
+  for (auto s : state) {
+    y.Axpy(1e-3, x);
+    benchmark::DoNotOptimize(y);
+  }
+}
+BENCHMARK(BM_Axpy<StateRnPVAWithFixedSize<kDof>>);
+BENCHMARK(BM_Axpy<StateRnPVA>);
+
+template <typename State>
+void BM_ClampPerBase(benchmark::State& state) {
+  State value = MakeState<State>(1.0);
+  const State lower = MakeState<State>(-2.0);
+  const State upper = MakeState<State>(2.0);
+  for (auto s : state) {
+    value.position =
+        value.position.cwiseMax(lower.position).cwiseMin(upper.position);
+    value.velocity =
+        value.velocity.cwiseMax(lower.velocity).cwiseMin(upper.velocity);
+    value.acceleration = value.acceleration.cwiseMax(lower.acceleration)
+                             .cwiseMin(upper.acceleration);
+    benchmark::DoNotOptimize(value);
+  }
+}
+BENCHMARK(BM_ClampPerBase<StateRnPVAWithFixedSize<kDof>>);
+
+template <typename State>
+void BM_Clamp(benchmark::State& state) {
+  State value = MakeState<State>(1.0);
+  const State lower = MakeState<State>(-2.0);
+  const State upper = MakeState<State>(2.0);
+  for (auto s : state) {
+    value.Clamp(lower, upper);
+    benchmark::DoNotOptimize(value);
+  }
+}
+BENCHMARK(BM_Clamp<StateRnPVAWithFixedSize<kDof>>);
+BENCHMARK(BM_Clamp<StateRnPVA>);
+
+template <typename State>
+void BM_Interpolate(benchmark::State& state) {
+  const State from = MakeState<State>(1.0);
+  const State to = MakeState<State>(2.0);
+  double t = 0.5;
+  for (auto s : state) {
+    benchmark::DoNotOptimize(t);
+    State result = State::Interpolate(from, to, t);
+    benchmark::DoNotOptimize(result);
+  }
+}
+BENCHMARK(BM_Interpolate<StateRnPVAWithFixedSize<kDof>>);
+BENCHMARK(BM_Interpolate<StateRnPVA>);
+
+}  // namespace
+}  // namespace intrinsic
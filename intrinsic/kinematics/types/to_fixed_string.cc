@@ -15,6 +15,7 @@
 
 namespace intrinsic {
 
+using icon::FixedStrAppend;
 using icon::FixedStrCat;
 using icon::FixedString;
 
@@ -27,9 +28,10 @@ FixedString<kVectorNdStrSize> ToFixedString(const eigenmath::VectorNd& vec) {
     return {""};
   }
 
+  // Appends in place, instead of copying `str` for every value.
   FixedString<kVectorNdStrSize> str = FixedStrCat<kVectorNdStrSize>(vec[0]);
   for (size_t i = 1; i < vec.size(); ++i) {
-    str = FixedStrCat<kVectorNdStrSize>(str, ",", vec[i]);
+    FixedStrAppend(&str, ",", vec[i]);
   }
   return str;
 }
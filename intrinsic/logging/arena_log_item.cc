@@ -0,0 +1,29 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/logging/arena_log_item.h"
+
+#include <cstddef>
+#include <memory>
+
+#include "google/protobuf/arena.h"
+#include "intrinsic/logging/proto/logger_service.pb.h"
+
+namespace intrinsic {
+
+namespace {
+
+::google::protobuf::ArenaOptions MakeArenaOptions(size_t initial_block_bytes) {
+  ::google::protobuf::ArenaOptions options;
+  options.start_block_size = initial_block_bytes;
+  return options;
+}
+
+}  // namespace
+
+ArenaLogItem::ArenaLogItem(size_t initial_block_bytes)
+    : arena_(std::make_unique<::google::protobuf::Arena>(
+          MakeArenaOptions(initial_block_bytes))),
+      request_(::google::protobuf::Arena::Create<
+               ::intrinsic_proto::data_logger::LogRequest>(arena_.get())) {}
+
+}  // namespace intrinsic
@@ -0,0 +1,67 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_LOGGING_ARENA_LOG_ITEM_H_
+#define INTRINSIC_LOGGING_ARENA_LOG_ITEM_H_
+
+#include <cstddef>
+#include <memory>
+
+#include "google/protobuf/arena.h"
+#include "intrinsic/logging/proto/log_item.pb.h"
+#include "intrinsic/logging/proto/logger_service.pb.h"
+
+namespace intrinsic {
+
+// A LogItem that lives on an arena, inside the LogRequest that sends it.
+//
+// Building a LogItem on the heap allocates each nested message, string and
+// repeated field separately, and logging it moves it into a LogRequest. An
+// ArenaLogItem allocates them from a few arena blocks instead, and is sent
+// without any copy or move. All of it is freed at once when the item is
+// logged, or destroyed.
+//
+// Example:
+//
+//   ArenaLogItem log_item;
+//   LogItem& item = log_item.item();
+//   item.mutable_metadata()->set_event_source("my_skill.debug");
+//   *item.mutable_context() = logging_context.data_logger_context;
+//   ...
+//   data_logger::LogAsync(std::move(log_item));
+//
+// Move-only. Messages of the item must not be released to, or swapped with,
+// messages that are not on the same arena.
+class ArenaLogItem {
+ public:
+  using LogItem = ::intrinsic_proto::data_logger::LogItem;
+
+  // Size of the first arena block, which should fit a typical item, so that
+  // building it allocates once.
+  static constexpr size_t kDefaultInitialBlockBytes = 4096;
+
+  explicit ArenaLogItem(size_t initial_block_bytes = kDefaultInitialBlockBytes);
+
+  ArenaLogItem(ArenaLogItem&&) = default;
+  ArenaLogItem& operator=(ArenaLogItem&&) = default;
+
+  LogItem& item() { return *request_->mutable_item(); }
+  const LogItem& item() const { return request_->item(); }
+
+  // The arena of the item, e.g., to create messages to add to it.
+  ::google::protobuf::Arena& arena() { return *arena_; }
+
+  // The request that sends the item.
+  const ::intrinsic_proto::data_logger::LogRequest& request() const {
+    return *request_;
+  }
+
+ private:
+  // On the heap, so that moving the item does not move the arena.
+  std::unique_ptr<::google::protobuf::Arena> arena_;
+  // Owned by `arena_`.
+  ::intrinsic_proto::data_logger::LogRequest* request_;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_LOGGING_ARENA_LOG_ITEM_H_
@@ -0,0 +1,176 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/logging/buffered_structured_logger.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/logging/structured_logging_client.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+
+// static
+absl::StatusOr<std::unique_ptr<BufferedStructuredLogger>>
+BufferedStructuredLogger::Create(StructuredLoggingClient client,
+                                 const Options& options) {
+  if (options.max_batch_items == 0 || options.max_batch_bytes == 0 ||
+      options.max_buffered_items == 0) {
+    return absl::InvalidArgumentError(
+        "Batch and buffer size limits must be positive");
+  }
+  if (options.max_batch_delay <= absl::ZeroDuration()) {
+    return absl::InvalidArgumentError("Maximum batch delay must be positive");
+  }
+  auto logger = absl::WrapUnique(
+      new BufferedStructuredLogger(std::move(client), options));
+  INTR_RETURN_IF_ERROR(logger->sender_.Start(
+      Thread::Options().SetName("log_batcher"),
+      &BufferedStructuredLogger::RunSender, logger.get()));
+  return logger;
+}
+
+BufferedStructuredLogger::BufferedStructuredLogger(
+    StructuredLoggingClient client, const Options& options)
+    : client_(std::move(client)), options_(options) {}
+
+BufferedStructuredLogger::~BufferedStructuredLogger() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stop_ = true;
+  }
+  if (sender_.Joinable()) {
+    sender_.Join();
+  }
+}
+
+bool BufferedStructuredLogger::Log(LogItem&& item) {
+  const size_t bytes = item.ByteSizeLong();
+  absl::MutexLock lock(&mutex_);
+  if (buffer_.size() >= options_.max_buffered_items &&
+      options_.max_block_duration > absl::ZeroDuration()) {
+    auto has_space = [this]() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+      return stop_ || buffer_.size() < options_.max_buffered_items;
+    };
+    mutex_.AwaitWithTimeout(absl::Condition(&has_space),
+                            options_.max_block_duration);
+  }
+  if (stop_ || buffer_.size() >= options_.max_buffered_items) {
+    ++stats_.num_dropped;
+    LOG_EVERY_N_SEC(WARNING, 10)
+        << "Structured logging buffer is full, dropped "
+        << stats_.num_dropped << " items so far";
+    return false;
+  }
+  buffer_.push_back(
+      {.item = std::move(item), .bytes = bytes, .enqueue_time = absl::Now()});
+  buffered_bytes_ += bytes;
+  ++num_enqueued_;
+  return true;
+}
+
+bool BufferedStructuredLogger::Log(const LogItem& item) {
+  LogItem log_item = item;
+  return Log(std::move(log_item));
+}
+
+absl::Status BufferedStructuredLogger::Flush(absl::Time deadline) {
+  absl::MutexLock lock(&mutex_);
+  const uint64_t target = num_enqueued_;
+  flush_target_ = std::max(flush_target_, target);
+  auto sent = [this, target]() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+    return num_sent_ >= target;
+  };
+  if (!mutex_.AwaitWithDeadline(absl::Condition(&sent), deadline)) {
+    return absl::DeadlineExceededError(
+        absl::StrCat("Timed out flushing structured logs, ",
+                     target - num_sent_, " items are not sent yet"));
+  }
+  return absl::OkStatus();
+}
+
+BufferedStructuredLogger::Stats BufferedStructuredLogger::GetStats() const {
+  absl::MutexLock lock(&mutex_);
+  Stats stats = stats_;
+  stats.num_buffered = buffer_.size();
+  return stats;
+}
+
+bool BufferedStructuredLogger::BatchReady() const {
+  return stop_ || flush_target_ > num_taken_ ||
+         buffer_.size() >= options_.max_batch_items ||
+         buffered_bytes_ >= options_.max_batch_bytes;
+}
+
+void BufferedStructuredLogger::RunSender() {
+  while (true) {
+    std::vector<LogItem> batch;
+    {
+      absl::MutexLock lock(&mutex_);
+      const absl::Condition batch_ready(this,
+                                        &BufferedStructuredLogger::BatchReady);
+      // Waits for a full batch, or for the oldest item to age.
+      while (!BatchReady()) {
+        if (buffer_.empty()) {
+          auto has_work = [this]() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+            return BatchReady() || !buffer_.empty();
+          };
+          mutex_.Await(absl::Condition(&has_work));
+          continue;
+        }
+        const absl::Time send_time =
+            buffer_.front().enqueue_time + options_.max_batch_delay;
+        if (absl::Now() >= send_time ||
+            !mutex_.AwaitWithDeadline(batch_ready, send_time)) {
+          break;
+        }
+      }
+      if (buffer_.empty()) {
+        if (stop_) {
+          return;
+        }
+        continue;
+      }
+      size_t batch_bytes = 0;
+      while (!buffer_.empty() && batch.size() < options_.max_batch_items &&
+             (batch.empty() ||
+              batch_bytes + buffer_.front().bytes <=
+                  options_.max_batch_bytes)) {
+        Entry& entry = buffer_.front();
+        batch_bytes += entry.bytes;
+        batch.push_back(std::move(entry.item));
+        buffer_.pop_front();
+      }
+      buffered_bytes_ -= batch_bytes;
+      num_taken_ += batch.size();
+    }
+
+    const size_t batch_size = batch.size();
+    const absl::Status status = client_.LogBatch(std::move(batch));
+    if (!status.ok()) {
+      LOG_EVERY_N_SEC(WARNING, 10) << "Failed to send a batch of " << batch_size
+                                   << " structured log items: " << status;
+    }
+
+    absl::MutexLock lock(&mutex_);
+    ++stats_.num_batches;
+    (status.ok() ? stats_.num_logged : stats_.num_failed) += batch_size;
+    num_sent_ += batch_size;
+  }
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,147 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_LOGGING_BUFFERED_STRUCTURED_LOGGER_H_
+#define INTRINSIC_LOGGING_BUFFERED_STRUCTURED_LOGGER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "intrinsic/logging/proto/log_item.pb.h"
+#include "intrinsic/logging/structured_logging_client.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+
+// Buffers log items on the client and sends them to the structured logging
+// service in batches, with a single LogBatch RPC per batch.
+//
+// StructuredLoggingClient::LogAsync() issues one RPC per item, which does not
+// scale to thousands of items per second. Instead, Log() only appends the
+// item to a bounded buffer. A sender thread sends a batch once it has
+// Options::max_batch_items items or Options::max_batch_bytes bytes, or once
+// its oldest item waited for Options::max_batch_delay.
+//
+// Only one batch is in flight at a time. If the service falls behind, the
+// buffer fills up, and Log() waits for up to Options::max_block_duration for
+// space before it drops the item. Dropped items, and items of batches that
+// failed to send, are counted in Stats:
+//
+//   INTR_ASSIGN_OR_RETURN(StructuredLoggingClient client,
+//                         StructuredLoggingClient::Create(address, deadline));
+//   INTR_ASSIGN_OR_RETURN(
+//       std::unique_ptr<BufferedStructuredLogger> logger,
+//       BufferedStructuredLogger::Create(std::move(client), {}));
+//   logger->Log(std::move(item));
+//
+// Flush() fits ShutdownCoordinator::DrainFn, so that buffered items are sent
+// on shutdown:
+//
+//   coordinator.Register("structured_logs", ShutdownCoordinator::kFlushLogs,
+//                        absl::Seconds(1), [&logger](absl::Time deadline) {
+//                          return logger->Flush(deadline);
+//                        });
+//
+// Thread safe.
+class BufferedStructuredLogger {
+ public:
+  using LogItem = StructuredLoggingClient::LogItem;
+
+  struct Options {
+    // A batch is sent once it has this many items, ...
+    size_t max_batch_items = 256;
+    // ... or this many bytes, ...
+    size_t max_batch_bytes = size_t{4} << 20;
+    // ... or once its oldest item waited this long.
+    absl::Duration max_batch_delay = absl::Milliseconds(100);
+    // Maximum number of items that wait to be sent.
+    size_t max_buffered_items = 16384;
+    // How long Log() waits for space in a full buffer before it drops the
+    // item. Zero drops right away, so that Log() never blocks.
+    absl::Duration max_block_duration = absl::ZeroDuration();
+  };
+
+  struct Stats {
+    // Items that were sent successfully.
+    uint64_t num_logged = 0;
+    // Items that were dropped because the buffer was full.
+    uint64_t num_dropped = 0;
+    // Items of batches that failed to send.
+    uint64_t num_failed = 0;
+    // Batches sent, successfully or not.
+    uint64_t num_batches = 0;
+    // Items that wait to be sent.
+    size_t num_buffered = 0;
+  };
+
+  // Starts the sender thread.
+  //
+  // Returns InvalidArgumentError if a size limit is zero or
+  // `max_batch_delay` is not positive.
+  static absl::StatusOr<std::unique_ptr<BufferedStructuredLogger>> Create(
+      StructuredLoggingClient client, const Options& options);
+
+  // Sends all buffered items, then stops the sender thread.
+  ~BufferedStructuredLogger();
+
+  BufferedStructuredLogger(const BufferedStructuredLogger&) = delete;
+  BufferedStructuredLogger& operator=(const BufferedStructuredLogger&) =
+      delete;
+
+  // Appends `item` to the buffer. Returns false, and drops the item, if the
+  // buffer stays full for Options::max_block_duration.
+  bool Log(LogItem&& item);
+  // Like above, but copies `item`.
+  bool Log(const LogItem& item);
+
+  // Sends the items buffered before the call right away, without waiting for
+  // a full batch, and waits until they are sent.
+  //
+  // Returns DeadlineExceededError if they are not sent by `deadline`.
+  absl::Status Flush(absl::Time deadline);
+
+  Stats GetStats() const;
+
+ private:
+  struct Entry {
+    LogItem item;
+    size_t bytes;
+    absl::Time enqueue_time;
+  };
+
+  BufferedStructuredLogger(StructuredLoggingClient client,
+                           const Options& options);
+
+  // Returns whether the sender thread should send a batch without waiting for
+  // the oldest item to age.
+  bool BatchReady() const ABSL_SHARED_LOCKS_REQUIRED(mutex_);
+  void RunSender();
+
+  const StructuredLoggingClient client_;
+  const Options options_;
+
+  mutable absl::Mutex mutex_;
+  std::deque<Entry> buffer_ ABSL_GUARDED_BY(mutex_);
+  size_t buffered_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Number of items ever appended to, and taken from, the buffer.
+  uint64_t num_enqueued_ ABSL_GUARDED_BY(mutex_) = 0;
+  uint64_t num_taken_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Number of items that were sent, successfully or not.
+  uint64_t num_sent_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Sends right away until `num_taken_` reaches this.
+  uint64_t flush_target_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool stop_ ABSL_GUARDED_BY(mutex_) = false;
+  Stats stats_ ABSL_GUARDED_BY(mutex_);
+
+  Thread sender_;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_LOGGING_BUFFERED_STRUCTURED_LOGGER_H_
@@ -6,22 +6,29 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/random/random.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "grpcpp/channel.h"
+#include "intrinsic/logging/arena_log_item.h"
+#include "intrinsic/logging/log_sampler.h"
+#include "intrinsic/logging/log_spool.h"
 #include "intrinsic/logging/proto/log_item.pb.h"
 #include "intrinsic/logging/proto/logger_service.pb.h"
 #include "intrinsic/logging/structured_logging_client.h"
 #include "intrinsic/util/grpc/grpc.h"
 #include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
 
 namespace intrinsic::data_logger {
 namespace {
@@ -29,6 +36,8 @@ namespace {
 constexpr std::string_view kLoggerNotInitialized =
     "Attempting to log before logger initialized.";
 
+using ::intrinsic_proto::data_logger::LogItem;
+
 class LoggingData {
  public:
   static LoggingData& Instance() {
@@ -55,44 +64,227 @@ class LoggingData {
     return logging_client_->Log(std::move(item));
   }
 
-  void LogAsync(const intrinsic_proto::data_logger::LogItem& item) {
+  void LogAsync(const LogItem& item) {
     if (!logging_client_.has_value()) {
       LOG_FIRST_N(WARNING, 1) << kLoggerNotInitialized << " Doing nothing.";
       return;
     }
+    const absl::Time now = absl::Now();
+    LogReleased(now);
+    if (!sampler_.Admit(item, now)) {
+      return;
+    }
+    if (spool_ != nullptr) {
+      Spool(item).IgnoreError();
+      return;
+    }
     return logging_client_->LogAsync(item);
   }
 
-  void LogAsync(const intrinsic_proto::data_logger::LogItem& item,
+  void LogAsync(const LogItem& item,
                 std::function<void(absl::Status)> callback) {
     if (!logging_client_.has_value()) {
       LOG_FIRST_N(WARNING, 1) << kLoggerNotInitialized << " Doing nothing.";
       return;
     }
+    const absl::Time now = absl::Now();
+    LogReleased(now);
+    if (!sampler_.Admit(item, now)) {
+      callback(absl::OkStatus());
+      return;
+    }
+    if (spool_ != nullptr) {
+      callback(Spool(item));
+      return;
+    }
     return logging_client_->LogAsync(item, std::move(callback));
   }
 
-  void LogAsync(intrinsic_proto::data_logger::LogItem&& item) {
+  void LogAsync(LogItem&& item) {
+    if (!logging_client_.has_value()) {
+      LOG_FIRST_N(WARNING, 1) << kLoggerNotInitialized << " Doing nothing.";
+      return;
+    }
+    const absl::Time now = absl::Now();
+    LogReleased(now);
+    if (!sampler_.Admit(std::move(item), now)) {
+      return;
+    }
+    if (spool_ != nullptr) {
+      Spool(item).IgnoreError();
+      return;
+    }
+    return logging_client_->LogAsync(std::move(item));
+  }
+
+  void LogAsync(LogItem&& item, std::function<void(absl::Status)> callback) {
+    if (!logging_client_.has_value()) {
+      LOG_FIRST_N(WARNING, 1) << kLoggerNotInitialized << " Doing nothing.";
+      return;
+    }
+    const absl::Time now = absl::Now();
+    LogReleased(now);
+    if (!sampler_.Admit(std::move(item), now)) {
+      callback(absl::OkStatus());
+      return;
+    }
+    if (spool_ != nullptr) {
+      callback(Spool(item));
+      return;
+    }
+    return logging_client_->LogAsync(std::move(item), std::move(callback));
+  }
+
+  void LogAsync(ArenaLogItem&& item) {
     if (!logging_client_.has_value()) {
       LOG_FIRST_N(WARNING, 1) << kLoggerNotInitialized << " Doing nothing.";
       return;
     }
+    const absl::Time now = absl::Now();
+    LogReleased(now);
+    if (!sampler_.Admit(item.item(), now)) {
+      return;
+    }
+    if (spool_ != nullptr) {
+      Spool(item.item()).IgnoreError();
+      return;
+    }
     return logging_client_->LogAsync(std::move(item));
   }
 
-  void LogAsync(intrinsic_proto::data_logger::LogItem&& item,
+  void LogAsync(ArenaLogItem&& item,
                 std::function<void(absl::Status)> callback) {
     if (!logging_client_.has_value()) {
       LOG_FIRST_N(WARNING, 1) << kLoggerNotInitialized << " Doing nothing.";
       return;
     }
+    const absl::Time now = absl::Now();
+    LogReleased(now);
+    if (!sampler_.Admit(item.item(), now)) {
+      callback(absl::OkStatus());
+      return;
+    }
+    if (spool_ != nullptr) {
+      callback(Spool(item.item()));
+      return;
+    }
     return logging_client_->LogAsync(std::move(item), std::move(callback));
   }
 
+  absl::Status SetSamplingPolicy(absl::string_view event_source,
+                                 const SamplingPolicy& policy) {
+    return sampler_.SetPolicy(event_source, policy);
+  }
+
+  SamplingStats GetSamplingStats(absl::string_view event_source) const {
+    return sampler_.GetStats(event_source);
+  }
+
+  absl::Status EnableSpool(const LocalSpoolOptions& options) {
+    if (!logging_client_.has_value()) {
+      return absl::FailedPreconditionError(kLoggerNotInitialized);
+    }
+    if (spool_ != nullptr) {
+      return absl::FailedPreconditionError(
+          "The local spool is enabled already");
+    }
+    if (options.max_batch_items == 0 || options.max_batch_bytes == 0) {
+      return absl::InvalidArgumentError("Batch size limits must be positive");
+    }
+    INTR_ASSIGN_OR_RETURN(std::unique_ptr<LogSpool> spool,
+                          LogSpool::Open(options.spool));
+    spool_options_ = options;
+    spool_ = std::move(spool);
+    // Replays for the lifetime of the process, which the singleton lives for.
+    if (absl::Status status = replayer_.Start(
+            Thread::Options().SetName("log_spool"), &LoggingData::Replay, this);
+        !status.ok()) {
+      spool_.reset();
+      return status;
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status FlushSpool(absl::Time deadline) {
+    if (spool_ == nullptr) {
+      return absl::OkStatus();
+    }
+    if (!spool_->WaitUntilEmpty(deadline)) {
+      return absl::DeadlineExceededError(
+          absl::StrCat("Timed out flushing the local log spool, ",
+                       spool_->pending_bytes(), " bytes are not logged yet"));
+    }
+    return absl::OkStatus();
+  }
+
  private:
   LoggingData() = default;
 
+  // Logs the items that reservoir sampling released by `now`, if any.
+  void LogReleased(absl::Time now) {
+    if (!sampler_.HasReleased(now)) {
+      return;
+    }
+    std::vector<LogItem> items;
+    sampler_.TakeReleased(now, items);
+    for (LogItem& item : items) {
+      if (spool_ != nullptr) {
+        Spool(item).IgnoreError();
+      } else {
+        logging_client_->LogAsync(std::move(item));
+      }
+    }
+  }
+
+  absl::Status Spool(const LogItem& item) {
+    std::string record;
+    if (!item.SerializeToString(&record)) {
+      return absl::InternalError("Failed to serialize log item");
+    }
+    absl::Status status = spool_->Append(record);
+    if (!status.ok()) {
+      LOG_EVERY_N_SEC(WARNING, 10) << "Dropped a log item: " << status;
+    }
+    return status;
+  }
+
+  void Replay() {
+    while (true) {
+      if (!spool_->WaitForRecords(absl::InfiniteDuration())) {
+        continue;
+      }
+      LogSpool::Batch batch = spool_->Read(spool_options_.max_batch_items,
+                                           spool_options_.max_batch_bytes);
+      std::vector<LogItem> items;
+      items.reserve(batch.records.size());
+      for (const std::string& record : batch.records) {
+        if (!items.emplace_back().ParseFromString(record)) {
+          LOG(WARNING) << "Dropped a corrupted log item from the local spool";
+          items.pop_back();
+        }
+      }
+      const absl::Status status =
+          items.empty() ? absl::OkStatus()
+                        : logging_client_->LogBatch(std::move(items));
+      if (!status.ok()) {
+        LOG_EVERY_N_SEC(WARNING, 10)
+            << "Failed to replay spooled log items, keeping "
+            << spool_->pending_bytes() << " bytes spooled: " << status;
+        absl::SleepFor(spool_options_.retry_interval);
+        continue;
+      }
+      if (const absl::Status commit_status = spool_->Commit(batch);
+          !commit_status.ok()) {
+        LOG(ERROR) << "Failed to commit spooled log items: " << commit_status;
+      }
+    }
+  }
+
   std::optional<StructuredLoggingClient> logging_client_;
+  LogSampler sampler_;
+  LocalSpoolOptions spool_options_;
+  std::unique_ptr<LogSpool> spool_;
+  Thread replayer_;
 };
 
 }  // namespace
@@ -117,6 +309,32 @@ void LogAsync(intrinsic_proto::data_logger::LogItem&& item,
   LoggingData::Instance().LogAsync(std::move(item), std::move(callback));
 }
 
+void LogAsync(ArenaLogItem&& item) {
+  LoggingData::Instance().LogAsync(std::move(item));
+}
+
+void LogAsync(ArenaLogItem&& item,
+              std::function<void(absl::Status)> callback) {
+  LoggingData::Instance().LogAsync(std::move(item), std::move(callback));
+}
+
+absl::Status SetSamplingPolicy(absl::string_view event_source,
+                               const SamplingPolicy& policy) {
+  return LoggingData::Instance().SetSamplingPolicy(event_source, policy);
+}
+
+SamplingStats GetSamplingStats(absl::string_view event_source) {
+  return LoggingData::Instance().GetSamplingStats(event_source);
+}
+
+absl::Status EnableLocalSpool(const LocalSpoolOptions& options) {
+  return LoggingData::Instance().EnableSpool(options);
+}
+
+absl::Status FlushLocalSpool(absl::Time deadline) {
+  return LoggingData::Instance().FlushSpool(deadline);
+}
+
 absl::Status LogAndAwaitResponse(
     const intrinsic_proto::data_logger::LogItem& item) {
   return LoggingData::Instance().Log(item);
@@ -3,6 +3,7 @@
 #ifndef INTRINSIC_LOGGING_DATA_LOGGER_CLIENT_H_
 #define INTRINSIC_LOGGING_DATA_LOGGER_CLIENT_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -10,6 +11,9 @@
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
+#include "intrinsic/logging/arena_log_item.h"
+#include "intrinsic/logging/log_sampler.h"
+#include "intrinsic/logging/log_spool.h"
 #include "intrinsic/logging/proto/log_item.pb.h"
 #include "intrinsic/logging/proto/logger_service.grpc.pb.h"
 #include "intrinsic/util/grpc/grpc.h"
@@ -28,6 +32,48 @@ absl::Status StartUpIntrinsicLoggerViaStub(
     std::unique_ptr<intrinsic_proto::data_logger::DataLogger::StubInterface>
         stub);
 
+struct LocalSpoolOptions {
+  LogSpool::Options spool;
+  // Maximum number of items, and of bytes, replayed with one LogBatch RPC.
+  size_t max_batch_items = 256;
+  size_t max_batch_bytes = size_t{4} << 20;
+  // How long to wait before retrying a batch the DataLogger failed to log.
+  absl::Duration retry_interval = absl::Seconds(1);
+};
+
+// Routes LogAsync() through a local spool, so that logging never waits for
+// the network and items are kept while the DataLogger is slow or down. Items
+// are appended to memory-mapped segment files in `options.spool.directory`,
+// and a background thread replays them to the DataLogger in batches, retrying
+// until it is reachable again. Items left from a previous run are replayed
+// as well. Call once during program startup, after the logger is started.
+//
+// LogAsync() callbacks get the status of appending to the spool, e.g.,
+// ResourceExhaustedError once the spool is full. Items of a batch that failed
+// part way may be logged twice. LogAndAwaitResponse() bypasses the spool.
+absl::Status EnableLocalSpool(const LocalSpoolOptions& options);
+
+// Waits until all spooled items are logged. Fits ShutdownCoordinator::DrainFn.
+//
+// Returns DeadlineExceededError if they are not logged by `deadline`.
+absl::Status FlushLocalSpool(absl::Time deadline);
+
+// Sets the policy that decides which items of `event_source` LogAsync() logs,
+// e.g., to rate limit or decimate a high-rate source. The policy applies
+// before an item is serialized, so dropping an item costs little. Items that
+// reservoir sampling picks are logged once their window closes. Replaces the
+// previous policy of `event_source`. LogAndAwaitResponse() is not sampled.
+//
+// LogAsync() callbacks of dropped and held items are called with OkStatus.
+//
+// Returns InvalidArgumentError if `policy` is invalid.
+absl::Status SetSamplingPolicy(absl::string_view event_source,
+                               const SamplingPolicy& policy);
+
+// Returns how many items of `event_source` the sampling policy has seen, and
+// dropped.
+SamplingStats GetSamplingStats(absl::string_view event_source);
+
 // Generates a random integer with sufficient entropy to be considered globally
 // unique.
 uint64_t GenerateUid();
@@ -40,6 +86,11 @@ void LogAsync(intrinsic_proto::data_logger::LogItem&& item);
 void LogAsync(intrinsic_proto::data_logger::LogItem&& item,
               std::function<void(absl::Status)> callback);
 
+// Asynchronously logs a message built on an arena, see ArenaLogItem. The
+// arena is freed once the item is sent, or spooled.
+void LogAsync(ArenaLogItem&& item);
+void LogAsync(ArenaLogItem&& item, std::function<void(absl::Status)> callback);
+
 // Sends a request to log `item` to the logging service, waits for a response
 // and returns the Status. Use this instead of the async call when:
 //   1) You don't mind blocking for a few ms.
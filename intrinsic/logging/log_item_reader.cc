@@ -0,0 +1,163 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/logging/log_item_reader.h"
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "intrinsic/logging/structured_logging_client.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+
+// Fetches the pages of one part of the time range on its own thread.
+struct LogItemReader::Shard {
+  const StructuredLoggingClient* client;
+  std::string event_source;
+  int page_size;
+  absl::Time start_time;
+  absl::Time end_time;
+  size_t max_pages;
+
+  absl::Mutex mutex;
+  std::deque<std::vector<LogItem>> pages ABSL_GUARDED_BY(mutex);
+  // Set once the last page is fetched, or fetching failed.
+  bool done ABSL_GUARDED_BY(mutex) = false;
+  absl::Status status ABSL_GUARDED_BY(mutex);
+  bool cancelled ABSL_GUARDED_BY(mutex) = false;
+
+  Thread fetcher;
+
+  void Fetch() {
+    std::string page_token;
+    while (true) {
+      {
+        absl::MutexLock lock(&mutex);
+        auto has_space = [this]() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+          return cancelled || pages.size() < max_pages;
+        };
+        mutex.Await(absl::Condition(&has_space));
+        if (cancelled) {
+          return;
+        }
+      }
+      absl::StatusOr<StructuredLoggingClient::GetResult> result =
+          client->GetLogItems(event_source, page_size, page_token, start_time,
+                              end_time);
+      absl::MutexLock lock(&mutex);
+      if (!result.ok()) {
+        status = result.status();
+        done = true;
+        return;
+      }
+      const bool last_page =
+          result->next_page_token.empty() || result->log_items.empty();
+      if (!result->log_items.empty()) {
+        pages.push_back(std::move(result->log_items));
+      }
+      if (last_page) {
+        done = true;
+        return;
+      }
+      page_token = std::move(result->next_page_token);
+    }
+  }
+};
+
+LogItemReader::LogItemReader() = default;
+
+// static
+absl::StatusOr<std::unique_ptr<LogItemReader>> LogItemReader::Create(
+    const StructuredLoggingClient& client, absl::string_view event_source,
+    const Options& options) {
+  if (options.page_size <= 0 || options.prefetch_pages <= 0 ||
+      options.num_shards <= 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Page size, prefetch pages and number of shards must be positive, got ",
+        options.page_size, ", ", options.prefetch_pages, " and ",
+        options.num_shards));
+  }
+  if (options.start_time > options.end_time) {
+    return absl::InvalidArgumentError("Start time is after end time");
+  }
+  if (options.num_shards > 1 &&
+      (options.start_time == absl::InfinitePast() ||
+       options.end_time == absl::InfiniteFuture())) {
+    return absl::InvalidArgumentError(
+        "An infinite time range cannot be sharded");
+  }
+
+  auto reader = absl::WrapUnique(new LogItemReader());
+  const absl::Duration shard_duration =
+      (options.end_time - options.start_time) / options.num_shards;
+  for (int i = 0; i < options.num_shards; ++i) {
+    auto shard = std::make_unique<Shard>();
+    shard->client = &client;
+    shard->event_source = std::string(event_source);
+    shard->page_size = options.page_size;
+    shard->start_time = options.start_time + i * shard_duration;
+    // Both ends are inclusive, so shards end right before the next one starts.
+    shard->end_time = i + 1 == options.num_shards
+                          ? options.end_time
+                          : shard->start_time + shard_duration -
+                                absl::Nanoseconds(1);
+    shard->max_pages = options.prefetch_pages;
+    INTR_RETURN_IF_ERROR(shard->fetcher.Start(
+        Thread::Options().SetName(absl::StrCat("log_reader_", i)),
+        &Shard::Fetch, shard.get()));
+    reader->shards_.push_back(std::move(shard));
+  }
+  return reader;
+}
+
+LogItemReader::~LogItemReader() {
+  for (std::unique_ptr<Shard>& shard : shards_) {
+    absl::MutexLock lock(&shard->mutex);
+    shard->cancelled = true;
+  }
+  for (std::unique_ptr<Shard>& shard : shards_) {
+    if (shard->fetcher.Joinable()) {
+      shard->fetcher.Join();
+    }
+  }
+}
+
+absl::StatusOr<std::optional<LogItemReader::LogItem>> LogItemReader::Next() {
+  while (page_index_ >= page_.size()) {
+    if (current_shard_ >= shards_.size()) {
+      return std::nullopt;
+    }
+    Shard& shard = *shards_[current_shard_];
+    absl::MutexLock lock(&shard.mutex);
+    auto has_page = [&shard]() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+      return shard.done || !shard.pages.empty();
+    };
+    shard.mutex.Await(absl::Condition(&has_page));
+    if (!shard.pages.empty()) {
+      page_ = std::move(shard.pages.front());
+      shard.pages.pop_front();
+      page_index_ = 0;
+    } else if (!shard.status.ok()) {
+      return shard.status;
+    } else {
+      ++current_shard_;
+    }
+  }
+  return std::move(page_[page_index_++]);
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,95 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_LOGGING_LOG_ITEM_READER_H_
+#define INTRINSIC_LOGGING_LOG_ITEM_READER_H_
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/logging/proto/log_item.pb.h"
+#include "intrinsic/logging/structured_logging_client.h"
+
+namespace intrinsic {
+
+// Reads all log items of an event source in a time range, page by page,
+// without the caller looping over page tokens:
+//
+//   INTR_ASSIGN_OR_RETURN(
+//       std::unique_ptr<LogItemReader> reader,
+//       LogItemReader::Create(client, "robot_state",
+//                             {.start_time = start, .end_time = end,
+//                              .num_shards = 8}));
+//   while (true) {
+//     INTR_ASSIGN_OR_RETURN(std::optional<LogItem> item, reader->Next());
+//     if (!item.has_value()) break;
+//     ...
+//   }
+//
+// Background threads fetch the next pages while the caller processes the
+// current one. At most Options::prefetch_pages pages per shard wait to be
+// read, so memory stays bounded however long the time range is.
+//
+// For large exports, the time range can be split into Options::num_shards
+// shards that are fetched in parallel. Items are still returned in order,
+// since the shards are read one after the other.
+//
+// Not thread safe. The client must outlive the reader.
+class LogItemReader {
+ public:
+  using LogItem = StructuredLoggingClient::LogItem;
+
+  struct Options {
+    // Maximum number of items per GetLogItems RPC.
+    int page_size = 1000;
+    absl::Time start_time = absl::UniversalEpoch();
+    absl::Time end_time = absl::Now();
+    // Number of parts of [start_time, end_time] that are fetched in parallel.
+    // Must be 1 if either time is infinite.
+    int num_shards = 1;
+    // Maximum number of fetched pages per shard that wait to be read.
+    int prefetch_pages = 2;
+  };
+
+  // Starts fetching the first pages.
+  //
+  // Returns InvalidArgumentError if the options are invalid.
+  static absl::StatusOr<std::unique_ptr<LogItemReader>> Create(
+      const StructuredLoggingClient& client, absl::string_view event_source,
+      const Options& options);
+
+  // Stops fetching.
+  ~LogItemReader();
+
+  LogItemReader(const LogItemReader&) = delete;
+  LogItemReader& operator=(const LogItemReader&) = delete;
+
+  // Returns the next item, or std::nullopt after the last one. Blocks until
+  // the page of the item is fetched.
+  //
+  // Returns the error of GetLogItems if a page cannot be fetched. The reader
+  // must not be used afterwards.
+  absl::StatusOr<std::optional<LogItem>> Next();
+
+ private:
+  struct Shard;
+
+  LogItemReader();
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  // Index of the shard that is read.
+  size_t current_shard_ = 0;
+  // The page that is read, and the index of its next item.
+  std::vector<LogItem> page_;
+  size_t page_index_ = 0;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_LOGGING_LOG_ITEM_READER_H_
@@ -0,0 +1,232 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/logging/log_sampler.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/random/random.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "intrinsic/logging/proto/log_item.pb.h"
+
+namespace intrinsic {
+
+absl::Status LogSampler::SetPolicy(absl::string_view event_source,
+                                   const SamplingPolicy& policy) {
+  if (policy.keep_every_nth < 1) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "keep_every_nth must be at least 1, got ", policy.keep_every_nth));
+  }
+  if (policy.max_items_per_second < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("max_items_per_second must not be negative, got ",
+                     policy.max_items_per_second));
+  }
+  if (policy.max_burst < 1) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "max_burst must be at least 1, got ", policy.max_burst));
+  }
+  if (policy.reservoir_size < 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "reservoir_size must not be negative, got ", policy.reservoir_size));
+  }
+  if (policy.reservoir_size > 0 &&
+      policy.reservoir_window <= absl::ZeroDuration()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("reservoir_window must be positive, got ",
+                     absl::FormatDuration(policy.reservoir_window)));
+  }
+
+  absl::MutexLock lock(&mutex_);
+  std::unique_ptr<Source>& source = sources_[event_source];
+  if (source != nullptr) {
+    Release(*source);
+  }
+  source = std::make_unique<Source>();
+  source->policy = policy;
+  source->tokens = static_cast<double>(policy.max_burst);
+  source->reservoir.reserve(policy.reservoir_size);
+  has_policies_.store(true, std::memory_order_release);
+  UpdateNextRelease();
+  return absl::OkStatus();
+}
+
+bool LogSampler::Admit(const LogItem& item, absl::Time now) {
+  if (!has_policies_.load(std::memory_order_acquire)) {
+    return true;
+  }
+  absl::MutexLock lock(&mutex_);
+  auto it = sources_.find(item.metadata().event_source());
+  if (it == sources_.end()) {
+    return true;
+  }
+  LogItem* reservoir_slot = nullptr;
+  if (Sample(*it->second, item, now, &reservoir_slot)) {
+    return true;
+  }
+  if (reservoir_slot != nullptr) {
+    *reservoir_slot = item;
+  }
+  return false;
+}
+
+bool LogSampler::Admit(LogItem&& item, absl::Time now) {
+  if (!has_policies_.load(std::memory_order_acquire)) {
+    return true;
+  }
+  absl::MutexLock lock(&mutex_);
+  auto it = sources_.find(item.metadata().event_source());
+  if (it == sources_.end()) {
+    return true;
+  }
+  LogItem* reservoir_slot = nullptr;
+  if (Sample(*it->second, item, now, &reservoir_slot)) {
+    return true;
+  }
+  if (reservoir_slot != nullptr) {
+    *reservoir_slot = std::move(item);
+  }
+  return false;
+}
+
+bool LogSampler::HasReleased(absl::Time now) const {
+  return absl::ToUnixNanos(now) >=
+         next_release_ns_.load(std::memory_order_relaxed);
+}
+
+void LogSampler::TakeReleased(absl::Time now, std::vector<LogItem>& items) {
+  absl::MutexLock lock(&mutex_);
+  for (auto& [event_source, source] : sources_) {
+    if (!source->reservoir.empty()) {
+      CloseWindow(*source, now);
+    }
+  }
+  items.insert(items.end(), std::make_move_iterator(released_.begin()),
+               std::make_move_iterator(released_.end()));
+  released_.clear();
+  UpdateNextRelease();
+}
+
+SamplingStats LogSampler::GetStats(absl::string_view event_source) const {
+  absl::MutexLock lock(&mutex_);
+  auto it = sources_.find(event_source);
+  if (it == sources_.end()) {
+    return SamplingStats();
+  }
+  return it->second->stats;
+}
+
+bool LogSampler::Sample(Source& source, const LogItem& item, absl::Time now,
+                        LogItem** reservoir_slot) {
+  const SamplingPolicy& policy = source.policy;
+  SamplingStats& stats = source.stats;
+  ++stats.offered;
+
+  if (policy.max_item_bytes > 0) {
+    // Computing the size is much cheaper than serializing the item.
+    const size_t bytes = item.ByteSizeLong();
+    if (bytes > policy.max_item_bytes) {
+      ++stats.dropped_oversize;
+      stats.dropped_oversize_bytes += static_cast<int64_t>(bytes);
+      return false;
+    }
+  }
+
+  if (policy.keep_every_nth > 1 &&
+      source.decimation_count++ % policy.keep_every_nth != 0) {
+    ++stats.sampled_out;
+    return false;
+  }
+
+  if (policy.max_items_per_second > 0) {
+    const double elapsed_s =
+        std::max(0.0, absl::ToDoubleSeconds(now - source.last_refill));
+    source.tokens =
+        std::min(static_cast<double>(policy.max_burst),
+                 source.tokens + elapsed_s * policy.max_items_per_second);
+    source.last_refill = now;
+    if (source.tokens < 1) {
+      ++stats.sampled_out;
+      return false;
+    }
+    source.tokens -= 1;
+  }
+
+  if (policy.reservoir_size > 0) {
+    CloseWindow(source, now);
+    if (source.window_count == 0) {
+      // The window just started, so the sampler holds items until its end.
+      next_release_ns_.store(
+          std::min(next_release_ns_.load(std::memory_order_relaxed),
+                   absl::ToUnixNanos(source.window_end)),
+          std::memory_order_relaxed);
+    }
+    ++source.window_count;
+    if (source.reservoir.size() < static_cast<size_t>(policy.reservoir_size)) {
+      *reservoir_slot = &source.reservoir.emplace_back();
+      ++stats.held;
+      return false;
+    }
+    // Replaces a random held item, so that each item of the window is held
+    // with the same probability.
+    const int64_t slot =
+        absl::Uniform<int64_t>(bit_gen_, 0, source.window_count);
+    if (slot < policy.reservoir_size) {
+      *reservoir_slot = &source.reservoir[slot];
+    }
+    ++stats.sampled_out;
+    return false;
+  }
+
+  ++stats.logged;
+  return true;
+}
+
+void LogSampler::CloseWindow(Source& source, absl::Time now) {
+  if (now < source.window_end) {
+    return;
+  }
+  Release(source);
+  source.window_count = 0;
+  source.window_end = now + source.policy.reservoir_window;
+}
+
+void LogSampler::Release(Source& source) {
+  if (source.reservoir.empty()) {
+    return;
+  }
+  const auto released = static_cast<int64_t>(source.reservoir.size());
+  source.stats.held -= released;
+  source.stats.logged += released;
+  released_.insert(released_.end(),
+                   std::make_move_iterator(source.reservoir.begin()),
+                   std::make_move_iterator(source.reservoir.end()));
+  source.reservoir.clear();
+  next_release_ns_.store(INT64_MIN, std::memory_order_relaxed);
+}
+
+void LogSampler::UpdateNextRelease() {
+  int64_t next_release_ns = INT64_MAX;
+  if (!released_.empty()) {
+    next_release_ns = INT64_MIN;
+  } else {
+    for (const auto& [event_source, source] : sources_) {
+      if (!source->reservoir.empty()) {
+        next_release_ns = std::min(next_release_ns,
+                                   absl::ToUnixNanos(source->window_end));
+      }
+    }
+  }
+  next_release_ns_.store(next_release_ns, std::memory_order_relaxed);
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,153 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_LOGGING_LOG_SAMPLER_H_
+#define INTRINSIC_LOGGING_LOG_SAMPLER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/random/random.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "intrinsic/logging/proto/log_item.pb.h"
+
+namespace intrinsic {
+
+// Decides which log items of an event source are logged. The stages apply in
+// the order of the fields, and each one only sees the items that the previous
+// ones kept. The default policy keeps every item.
+struct SamplingPolicy {
+  // Drops items whose serialized size is larger than this. Zero disables the
+  // cap.
+  size_t max_item_bytes = 0;
+  // Keeps only every Nth item.
+  int64_t keep_every_nth = 1;
+  // Keeps at most this many items per second on average, in bursts of up to
+  // `max_burst` items. Zero disables the limit.
+  double max_items_per_second = 0;
+  int64_t max_burst = 1;
+  // Keeps a uniformly random sample of up to `reservoir_size` items out of
+  // each `reservoir_window`, which are logged once the window closes. Zero
+  // disables reservoir sampling.
+  int64_t reservoir_size = 0;
+  absl::Duration reservoir_window = absl::Seconds(1);
+};
+
+// How many items of an event source the sampler has seen, and what it did
+// with them.
+struct SamplingStats {
+  int64_t offered = 0;
+  int64_t logged = 0;
+  // Dropped because they exceeded SamplingPolicy::max_item_bytes, and their
+  // total serialized size.
+  int64_t dropped_oversize = 0;
+  int64_t dropped_oversize_bytes = 0;
+  // Dropped by decimation, the rate limit, or reservoir sampling.
+  int64_t sampled_out = 0;
+  // Picked by reservoir sampling, but not logged yet.
+  int64_t held = 0;
+};
+
+// Applies a SamplingPolicy to the log items of each event source, before
+// they are serialized, so that dropped items cost as little as possible.
+// Event sources without a policy are not sampled, and as long as no policy is
+// set at all, Admit() does not lock.
+//
+// Items that reservoir sampling picks are kept by the sampler until their
+// window closes, and then handed out by TakeReleased(). Windows only close
+// when items are offered or TakeReleased() is called, so the last window is
+// held until the next call.
+//
+// Thread safe.
+class LogSampler {
+ public:
+  using LogItem = ::intrinsic_proto::data_logger::LogItem;
+
+  LogSampler() = default;
+
+  LogSampler(const LogSampler&) = delete;
+  LogSampler& operator=(const LogSampler&) = delete;
+
+  // Sets the policy of `event_source`, which resets its sampling state and
+  // releases the items it holds.
+  //
+  // Returns InvalidArgumentError if `policy` is invalid.
+  absl::Status SetPolicy(absl::string_view event_source,
+                         const SamplingPolicy& policy)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns whether `item` should be logged now. Returns false for items that
+  // are dropped, and for items that reservoir sampling picked, which are
+  // copied, or moved, into the sampler. `item` is only moved from if false
+  // is returned.
+  bool Admit(const LogItem& item, absl::Time now) ABSL_LOCKS_EXCLUDED(mutex_);
+  bool Admit(LogItem&& item, absl::Time now) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns whether TakeReleased() would return any item at `now`. Does not
+  // lock.
+  bool HasReleased(absl::Time now) const;
+
+  // Closes the reservoir windows that ended by `now`, and appends the items
+  // picked in them, and in reservoirs reset by SetPolicy(), to `items`.
+  void TakeReleased(absl::Time now, std::vector<LogItem>& items)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the statistics of `event_source`, which are all zero if it has no
+  // policy.
+  SamplingStats GetStats(absl::string_view event_source) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Source {
+    SamplingPolicy policy;
+    SamplingStats stats;
+    // Items seen by the decimation stage.
+    int64_t decimation_count = 0;
+    // Token bucket of the rate limit.
+    double tokens = 0;
+    absl::Time last_refill = absl::InfinitePast();
+    // Items seen by the reservoir stage in the current window, and the ones
+    // picked so far.
+    int64_t window_count = 0;
+    absl::Time window_end = absl::InfinitePast();
+    std::vector<LogItem> reservoir;
+  };
+
+  // Returns whether `item` should be logged now. Sets `reservoir_slot` to the
+  // slot of the reservoir that `item` replaces, if reservoir sampling picked
+  // it.
+  bool Sample(Source& source, const LogItem& item, absl::Time now,
+              LogItem** reservoir_slot) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Moves the reservoir of `source` to `released_` if its window ended by
+  // `now`, and starts the next window.
+  void CloseWindow(Source& source, absl::Time now)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Moves the reservoir of `source` to `released_`.
+  void Release(Source& source) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Updates `next_release_ns_` after a reservoir window changed.
+  void UpdateNextRelease() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Whether any policy is set, so that Admit() skips the lock otherwise.
+  std::atomic<bool> has_policies_ = false;
+  // When TakeReleased() returns items next, in nanoseconds since the Unix
+  // epoch, so that HasReleased() does not lock.
+  std::atomic<int64_t> next_release_ns_ = INT64_MAX;
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::unique_ptr<Source>> sources_
+      ABSL_GUARDED_BY(mutex_);
+  std::vector<LogItem> released_ ABSL_GUARDED_BY(mutex_);
+  absl::BitGen bit_gen_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_LOGGING_LOG_SAMPLER_H_
@@ -0,0 +1,351 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/logging/log_spool.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic {
+
+namespace {
+
+constexpr uint64_t kMagic = 0x314c4f4f50534c49;  // "ILSPOOL1"
+constexpr absl::string_view kSegmentPrefix = "segment-";
+constexpr absl::string_view kSegmentSuffix = ".spool";
+
+// Header at the beginning of each segment. Records start at kHeaderSize.
+struct SegmentHeader {
+  uint64_t magic;
+  // Offset of the first uncommitted record.
+  uint64_t read_offset;
+};
+constexpr size_t kHeaderSize = 64;
+static_assert(sizeof(SegmentHeader) <= kHeaderSize);
+
+// Each record starts with its length plus one, so that zero marks the end.
+constexpr size_t kFrameSize = sizeof(uint32_t);
+
+// Size of a record including its frame, padded to keep frames aligned.
+constexpr size_t FramedSize(size_t length) {
+  return (kFrameSize + length + kFrameSize - 1) / kFrameSize * kFrameSize;
+}
+
+absl::Status ErrnoToStatus(absl::string_view what, absl::string_view path) {
+  return absl::InternalError(
+      absl::StrCat(what, " ", path, " failed: ", std::strerror(errno)));
+}
+
+}  // namespace
+
+struct LogSpool::Segment {
+  uint64_t id;
+  std::string path;
+  char* data;
+  size_t size;
+  // Offset past the last record.
+  size_t write_offset;
+
+  ~Segment() { munmap(data, size); }
+
+  SegmentHeader& header() { return *reinterpret_cast<SegmentHeader*>(data); }
+  size_t pending_bytes() { return write_offset - header().read_offset; }
+  bool Fits(size_t length) const {
+    return write_offset + FramedSize(length) <= size;
+  }
+};
+
+LogSpool::LogSpool(const Options& options) : options_(options) {}
+
+LogSpool::~LogSpool() = default;
+
+// static
+absl::StatusOr<std::unique_ptr<LogSpool>> LogSpool::Open(
+    const Options& options) {
+  if (options.directory.empty()) {
+    return absl::InvalidArgumentError("The spool directory must be set");
+  }
+  if (options.segment_bytes <= kHeaderSize + kFrameSize ||
+      options.segment_bytes > std::numeric_limits<uint32_t>::max() ||
+      options.max_total_bytes < options.segment_bytes) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Invalid spool sizes, segment: ", options.segment_bytes,
+        " bytes, total: ", options.max_total_bytes, " bytes"));
+  }
+  if (mkdir(options.directory.c_str(), 0755) != 0 && errno != EEXIST) {
+    return ErrnoToStatus("Creating spool directory", options.directory);
+  }
+
+  DIR* dir = opendir(options.directory.c_str());
+  if (dir == nullptr) {
+    return ErrnoToStatus("Opening spool directory", options.directory);
+  }
+  std::vector<uint64_t> ids;
+  while (const dirent* entry = readdir(dir)) {
+    absl::string_view name(entry->d_name);
+    uint64_t id;
+    if (absl::ConsumePrefix(&name, kSegmentPrefix) &&
+        absl::ConsumeSuffix(&name, kSegmentSuffix) &&
+        absl::SimpleAtoi(name, &id)) {
+      ids.push_back(id);
+    }
+  }
+  closedir(dir);
+  std::sort(ids.begin(), ids.end());
+
+  auto spool = absl::WrapUnique(new LogSpool(options));
+  absl::MutexLock lock(&spool->mutex_);
+  for (uint64_t id : ids) {
+    INTR_ASSIGN_OR_RETURN(std::unique_ptr<Segment> segment,
+                          spool->OpenSegment(id));
+    spool->next_segment_id_ = id + 1;
+    if (segment->pending_bytes() == 0) {
+      // Either never written to, or delivered before the last run ended.
+      if (unlink(segment->path.c_str()) != 0) {
+        return ErrnoToStatus("Deleting spool segment", segment->path);
+      }
+      continue;
+    }
+    spool->pending_bytes_ += segment->pending_bytes();
+    spool->total_bytes_ += segment->size;
+    spool->segments_.push_back(std::move(segment));
+  }
+  if (spool->pending_bytes_ > 0) {
+    LOG(INFO) << "Found " << spool->pending_bytes_
+              << " bytes of spooled log items in " << options.directory;
+  }
+  return spool;
+}
+
+std::string LogSpool::SegmentPath(uint64_t id) const {
+  return absl::StrFormat("%s/%s%020d%s", options_.directory, kSegmentPrefix,
+                         id, kSegmentSuffix);
+}
+
+absl::StatusOr<std::unique_ptr<LogSpool::Segment>> LogSpool::CreateSegment(
+    uint64_t id) const {
+  const std::string path = SegmentPath(id);
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) {
+    return ErrnoToStatus("Creating spool segment", path);
+  }
+  if (ftruncate(fd, options_.segment_bytes) != 0) {
+    const absl::Status status = ErrnoToStatus("Resizing spool segment", path);
+    close(fd);
+    unlink(path.c_str());
+    return status;
+  }
+  void* data = mmap(nullptr, options_.segment_bytes, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    const absl::Status status = ErrnoToStatus("Mapping spool segment", path);
+    unlink(path.c_str());
+    return status;
+  }
+  auto segment = absl::WrapUnique(new Segment{.id = id,
+                                              .path = path,
+                                              .data = static_cast<char*>(data),
+                                              .size = options_.segment_bytes,
+                                              .write_offset = kHeaderSize});
+  segment->header().read_offset = kHeaderSize;
+  segment->header().magic = kMagic;
+  return segment;
+}
+
+absl::StatusOr<std::unique_ptr<LogSpool::Segment>> LogSpool::OpenSegment(
+    uint64_t id) const {
+  const std::string path = SegmentPath(id);
+  const int fd = open(path.c_str(), O_RDWR);
+  if (fd < 0) {
+    return ErrnoToStatus("Opening spool segment", path);
+  }
+  struct stat stat_buffer;
+  if (fstat(fd, &stat_buffer) != 0) {
+    const absl::Status status = ErrnoToStatus("Reading spool segment", path);
+    close(fd);
+    return status;
+  }
+  const size_t size = stat_buffer.st_size;
+  if (size <= kHeaderSize || size > std::numeric_limits<uint32_t>::max()) {
+    close(fd);
+    return absl::DataLossError(
+        absl::StrCat("Spool segment ", path, " has invalid size ", size));
+  }
+  void* data =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return ErrnoToStatus("Mapping spool segment", path);
+  }
+  auto segment = absl::WrapUnique(new Segment{.id = id,
+                                              .path = path,
+                                              .data = static_cast<char*>(data),
+                                              .size = size,
+                                              .write_offset = kHeaderSize});
+  if (segment->header().magic != kMagic) {
+    return absl::DataLossError(
+        absl::StrCat("Spool segment ", path, " has an invalid header"));
+  }
+  // Finds the end of the last complete record.
+  while (segment->write_offset + kFrameSize <= size) {
+    uint32_t frame;
+    std::memcpy(&frame, segment->data + segment->write_offset, kFrameSize);
+    if (frame == 0 || !segment->Fits(frame - 1)) {
+      break;
+    }
+    segment->write_offset += FramedSize(frame - 1);
+  }
+  uint64_t& read_offset = segment->header().read_offset;
+  if (read_offset < kHeaderSize || read_offset > segment->write_offset) {
+    LOG(WARNING) << "Spool segment " << path
+                 << " has an invalid read offset, replaying it from the start";
+    read_offset = kHeaderSize;
+  }
+  return segment;
+}
+
+absl::Status LogSpool::Append(absl::string_view record) {
+  if (FramedSize(record.size()) > options_.segment_bytes - kHeaderSize) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Record of ", record.size(),
+                     " bytes does not fit into a spool segment of ",
+                     options_.segment_bytes, " bytes"));
+  }
+  absl::MutexLock lock(&mutex_);
+  if (segments_.empty() || !segments_.back()->Fits(record.size())) {
+    if (!segments_.empty() && segments_.back()->pending_bytes() == 0) {
+      // The last segment is full and delivered.
+      INTR_RETURN_IF_ERROR(DeleteOldestSegment());
+    }
+    if (total_bytes_ + options_.segment_bytes > options_.max_total_bytes) {
+      ++num_rejected_;
+      return absl::ResourceExhaustedError(absl::StrCat(
+          "Log spool in ", options_.directory, " is full with ",
+          pending_bytes_, " bytes"));
+    }
+    INTR_ASSIGN_OR_RETURN(std::unique_ptr<Segment> segment,
+                          CreateSegment(next_segment_id_));
+    ++next_segment_id_;
+    total_bytes_ += segment->size;
+    segments_.push_back(std::move(segment));
+  }
+
+  Segment& segment = *segments_.back();
+  char* frame = segment.data + segment.write_offset;
+  std::memcpy(frame + kFrameSize, record.data(), record.size());
+  // Written last, so that the record is complete once the frame is set.
+  const uint32_t length = record.size() + 1;
+  std::memcpy(frame, &length, kFrameSize);
+  segment.write_offset += FramedSize(record.size());
+  pending_bytes_ += FramedSize(record.size());
+  return absl::OkStatus();
+}
+
+LogSpool::Batch LogSpool::Read(size_t max_records, size_t max_bytes) {
+  Batch batch;
+  absl::MutexLock lock(&mutex_);
+  if (segments_.empty()) {
+    return batch;
+  }
+  Segment& segment = *segments_.front();
+  size_t offset = segment.header().read_offset;
+  size_t bytes = 0;
+  while (offset < segment.write_offset && batch.records.size() < max_records) {
+    uint32_t frame;
+    std::memcpy(&frame, segment.data + offset, kFrameSize);
+    const size_t length = frame - 1;
+    if (!batch.records.empty() && bytes + length > max_bytes) {
+      break;
+    }
+    batch.records.emplace_back(segment.data + offset + kFrameSize, length);
+    bytes += length;
+    offset += FramedSize(length);
+  }
+  batch.segment_id = segment.id;
+  batch.end_offset = offset;
+  return batch;
+}
+
+absl::Status LogSpool::Commit(const Batch& batch) {
+  if (batch.records.empty()) {
+    return absl::OkStatus();
+  }
+  absl::MutexLock lock(&mutex_);
+  if (segments_.empty() || segments_.front()->id != batch.segment_id) {
+    return absl::FailedPreconditionError(
+        "The batch is not the last one read from the spool");
+  }
+  Segment& segment = *segments_.front();
+  pending_bytes_ -= batch.end_offset - segment.header().read_offset;
+  segment.header().read_offset = batch.end_offset;
+  if (segment.pending_bytes() == 0 && segments_.size() > 1) {
+    INTR_RETURN_IF_ERROR(DeleteOldestSegment());
+  }
+  return absl::OkStatus();
+}
+
+absl::Status LogSpool::DeleteOldestSegment() {
+  std::unique_ptr<Segment> segment = std::move(segments_.front());
+  segments_.pop_front();
+  total_bytes_ -= segment->size;
+  if (unlink(segment->path.c_str()) != 0) {
+    return ErrnoToStatus("Deleting spool segment", segment->path);
+  }
+  return absl::OkStatus();
+}
+
+bool LogSpool::WaitForRecords(absl::Duration timeout) {
+  absl::MutexLock lock(&mutex_);
+  auto has_records = [this]() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+    return pending_bytes_ > 0;
+  };
+  return mutex_.AwaitWithTimeout(absl::Condition(&has_records), timeout);
+}
+
+bool LogSpool::WaitUntilEmpty(absl::Time deadline) {
+  absl::MutexLock lock(&mutex_);
+  auto empty = [this]() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+    return pending_bytes_ == 0;
+  };
+  return mutex_.AwaitWithDeadline(absl::Condition(&empty), deadline);
+}
+
+size_t LogSpool::pending_bytes() const {
+  absl::MutexLock lock(&mutex_);
+  return pending_bytes_;
+}
+
+uint64_t LogSpool::num_rejected() const {
+  absl::MutexLock lock(&mutex_);
+  return num_rejected_;
+}
+
+}  // namespace intrinsic
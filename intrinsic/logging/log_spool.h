@@ -0,0 +1,130 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_LOGGING_LOG_SPOOL_H_
+#define INTRINSIC_LOGGING_LOG_SPOOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace intrinsic {
+
+// A persistent FIFO of serialized log items in memory-mapped, append-only
+// segment files, so that items survive while the DataLogger is unreachable,
+// and across restarts.
+//
+// Appending copies the record into the mapped segment and never touches the
+// network. A single reader reads the oldest records with Read(), and removes
+// them with Commit() once they are delivered. Fully committed segments are
+// deleted.
+//
+// Each segment starts with a header that holds the offset of its first
+// uncommitted record, followed by records of a 32-bit length and the payload.
+// The length is written last, so that a partially written record is ignored
+// when the spool is reopened.
+//
+// Thread safe, but there must only be one reader.
+class LogSpool {
+ public:
+  struct Options {
+    // Directory of the segment files. Created if it does not exist. Must not
+    // be shared with another spool.
+    std::string directory;
+    // Size of each segment file. Bounds the size of a record.
+    size_t segment_bytes = size_t{8} << 20;
+    // Maximum size of all segment files. Append() rejects records beyond.
+    size_t max_total_bytes = size_t{256} << 20;
+  };
+
+  // Records read by Read(), and where they end.
+  struct Batch {
+    std::vector<std::string> records;
+
+   private:
+    friend class LogSpool;
+    uint64_t segment_id = 0;
+    size_t end_offset = 0;
+  };
+
+  // Opens the spool in Options::directory, including the records that are
+  // left from a previous run.
+  //
+  // Returns InvalidArgumentError if the options are invalid, and
+  // InternalError if the directory or a segment cannot be created or mapped.
+  static absl::StatusOr<std::unique_ptr<LogSpool>> Open(const Options& options);
+
+  // Unmaps the segments, which keeps their records on disk.
+  ~LogSpool();
+
+  LogSpool(const LogSpool&) = delete;
+  LogSpool& operator=(const LogSpool&) = delete;
+
+  // Appends `record`.
+  //
+  // Returns InvalidArgumentError if `record` does not fit into a segment,
+  // ResourceExhaustedError if the spool is full, and InternalError if a new
+  // segment cannot be created.
+  absl::Status Append(absl::string_view record);
+
+  // Returns up to `max_records` of the oldest uncommitted records, and at
+  // least one if there is any, with up to `max_bytes` in total. Only reads
+  // records of one segment at a time. Reading again without Commit() returns
+  // the same records.
+  Batch Read(size_t max_records, size_t max_bytes);
+
+  // Removes the records of `batch`, which must be the last batch read.
+  //
+  // Returns InternalError if a segment cannot be deleted.
+  absl::Status Commit(const Batch& batch);
+
+  // Waits for up to `timeout` until there are uncommitted records. Returns
+  // whether there are.
+  bool WaitForRecords(absl::Duration timeout);
+
+  // Waits until all records are committed. Returns false if they are not by
+  // `deadline`.
+  bool WaitUntilEmpty(absl::Time deadline);
+
+  // Number of bytes of uncommitted records, including their framing.
+  size_t pending_bytes() const;
+  // Number of records Append() rejected because the spool was full.
+  uint64_t num_rejected() const;
+
+ private:
+  struct Segment;
+
+  explicit LogSpool(const Options& options);
+
+  // Creates and maps a new, empty segment.
+  absl::StatusOr<std::unique_ptr<Segment>> CreateSegment(uint64_t id) const;
+  // Maps an existing segment and finds its end.
+  absl::StatusOr<std::unique_ptr<Segment>> OpenSegment(uint64_t id) const;
+  std::string SegmentPath(uint64_t id) const;
+  // Unmaps and deletes the oldest segment.
+  absl::Status DeleteOldestSegment() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const Options options_;
+
+  mutable absl::Mutex mutex_;
+  // Oldest first. The last one is appended to.
+  std::deque<std::unique_ptr<Segment>> segments_ ABSL_GUARDED_BY(mutex_);
+  uint64_t next_segment_id_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Sizes of all segments, and of their uncommitted records.
+  size_t total_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  size_t pending_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  uint64_t num_rejected_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_LOGGING_LOG_SPOOL_H_
@@ -0,0 +1,157 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/logging/log_sync_operation.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "grpcpp/support/status.h"
+#include "intrinsic/logging/proto/logger_service.grpc.pb.h"
+#include "intrinsic/logging/proto/logger_service.pb.h"
+#include "intrinsic/util/status/status_conversion_grpc.h"
+
+namespace intrinsic {
+
+// static
+absl::StatusOr<std::shared_ptr<LogSyncOperation>> LogSyncOperation::Start(
+    LoggerStub* stub,
+    std::vector<std::vector<std::string>> prioritized_event_sources,
+    Callbacks callbacks) {
+  std::vector<std::vector<std::string>> groups;
+  for (std::vector<std::string>& group : prioritized_event_sources) {
+    if (!group.empty()) {
+      groups.push_back(std::move(group));
+    }
+  }
+  if (groups.empty()) {
+    return absl::InvalidArgumentError("No event sources to sync");
+  }
+  // Private constructor, so no make_shared.
+  std::shared_ptr<LogSyncOperation> operation(
+      new LogSyncOperation(stub, std::move(groups), std::move(callbacks)));
+  operation->StartNextGroup();
+  return operation;
+}
+
+LogSyncOperation::LogSyncOperation(
+    LoggerStub* stub, std::vector<std::vector<std::string>> groups,
+    Callbacks callbacks)
+    : stub_(stub),
+      groups_(std::move(groups)),
+      callbacks_(std::move(callbacks)) {
+  progress_.total_groups = groups_.size();
+}
+
+LogSyncProgress LogSyncOperation::progress() const {
+  absl::MutexLock lock(&mutex_);
+  return progress_;
+}
+
+bool LogSyncOperation::done() const {
+  absl::MutexLock lock(&mutex_);
+  return done_;
+}
+
+void LogSyncOperation::Cancel() {
+  absl::MutexLock lock(&mutex_);
+  if (done_) {
+    return;
+  }
+  cancelled_ = true;
+  // Also cancels a call that is about to start.
+  if (!calls_.empty()) {
+    calls_.back()->context.TryCancel();
+  }
+}
+
+absl::Status LogSyncOperation::Wait(absl::Time deadline) const {
+  absl::MutexLock lock(&mutex_);
+  if (!mutex_.AwaitWithDeadline(absl::Condition(&done_), deadline)) {
+    return absl::DeadlineExceededError(
+        "Timed out waiting for logs to be synced");
+  }
+  return status_;
+}
+
+void LogSyncOperation::StartNextGroup() {
+  Call* call = nullptr;
+  LogSyncProgress progress;
+  absl::Status status;
+  {
+    absl::MutexLock lock(&mutex_);
+    const size_t next_group = progress_.finished_groups;
+    if (!cancelled_ && next_group < groups_.size()) {
+      const std::vector<std::string>& group = groups_[next_group];
+      call = calls_.emplace_back(std::make_unique<Call>()).get();
+      call->request.mutable_event_sources()->Add(group.begin(), group.end());
+      call->request.set_sync_all(false);
+    } else {
+      if (cancelled_) {
+        for (size_t i = next_group; i < groups_.size(); ++i) {
+          progress_.failed_event_sources.insert(
+              progress_.failed_event_sources.end(), groups_[i].begin(),
+              groups_[i].end());
+        }
+        if (status_.ok()) {
+          status_ = absl::CancelledError("Log sync cancelled");
+        }
+      }
+      done_ = true;
+      progress = progress_;
+      status = status_;
+    }
+  }
+  if (call == nullptr) {
+    if (callbacks_.on_done != nullptr) {
+      callbacks_.on_done(status, progress);
+    }
+    return;
+  }
+  stub_->async()->SyncAndRotateLogs(
+      &call->context, &call->request, &call->response,
+      [self = shared_from_this(), call](::grpc::Status grpc_status) {
+        self->OnGroupDone(call, grpc_status);
+      });
+}
+
+void LogSyncOperation::OnGroupDone(Call* call,
+                                   const ::grpc::Status& grpc_status) {
+  absl::Status status = ToAbslStatus(grpc_status);
+  LogSyncProgress progress;
+  {
+    absl::MutexLock lock(&mutex_);
+    ++progress_.finished_groups;
+    if (status.ok()) {
+      progress_.synced_event_sources.insert(
+          progress_.synced_event_sources.end(),
+          call->response.event_sources().begin(),
+          call->response.event_sources().end());
+      progress_.throttled_event_sources.insert(
+          progress_.throttled_event_sources.end(),
+          call->response.throttled_event_sources().begin(),
+          call->response.throttled_event_sources().end());
+    } else {
+      progress_.failed_event_sources.insert(
+          progress_.failed_event_sources.end(),
+          call->request.event_sources().begin(),
+          call->request.event_sources().end());
+      if (status_.ok()) {
+        status_ = std::move(status);
+      }
+    }
+    progress = progress_;
+  }
+  if (callbacks_.on_progress != nullptr) {
+    callbacks_.on_progress(progress);
+  }
+  StartNextGroup();
+}
+
+}  // namespace intrinsic
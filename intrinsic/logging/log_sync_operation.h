@@ -0,0 +1,126 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_LOGGING_LOG_SYNC_OPERATION_H_
+#define INTRINSIC_LOGGING_LOG_SYNC_OPERATION_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "grpcpp/client_context.h"
+#include "intrinsic/logging/proto/logger_service.grpc.pb.h"
+#include "intrinsic/logging/proto/logger_service.pb.h"
+
+namespace intrinsic {
+
+// What a LogSyncOperation has synced so far.
+struct LogSyncProgress {
+  // Number of priority groups, and how many of them have finished.
+  size_t total_groups = 0;
+  size_t finished_groups = 0;
+  // Event sources that the DataLogger synced and rotated.
+  std::vector<std::string> synced_event_sources;
+  // Event sources that the DataLogger did not sync due to throttling.
+  std::vector<std::string> throttled_event_sources;
+  // Event sources whose SyncAndRotateLogs RPC failed, or that were not synced
+  // because the operation was cancelled.
+  std::vector<std::string> failed_event_sources;
+};
+
+// A SyncAndRotateLogs of several groups of event sources that runs in the
+// background, see StructuredLoggingClient::SyncAndRotateLogsAsync().
+//
+// The groups are synced one after the other, in order, with one RPC each, so
+// that the sources that matter most are uploaded first, and an end-of-job hook
+// can start the sync early and tear down while it runs. A group whose RPC
+// fails does not stop the following groups.
+//
+// This class is thread-safe. Dropping the last reference does not cancel the
+// operation, which keeps itself alive until it is done. The stub must outlive
+// the operation; call Cancel() and Wait() before destroying it early.
+class LogSyncOperation
+    : public std::enable_shared_from_this<LogSyncOperation> {
+ public:
+  using LoggerStub = ::intrinsic_proto::data_logger::DataLogger::StubInterface;
+
+  struct Callbacks {
+    // Called after each group finished, with the progress so far.
+    std::function<void(const LogSyncProgress&)> on_progress;
+    // Called once, when all groups finished or the operation was cancelled,
+    // with the status that Wait() returns.
+    std::function<void(const absl::Status&, const LogSyncProgress&)> on_done;
+  };
+
+  // Starts syncing `prioritized_event_sources` through `stub`, highest
+  // priority first. Empty groups are skipped. Callbacks run on a gRPC thread
+  // and must not block.
+  //
+  // Returns InvalidArgumentError if there is no event source to sync.
+  static absl::StatusOr<std::shared_ptr<LogSyncOperation>> Start(
+      LoggerStub* stub,
+      std::vector<std::vector<std::string>> prioritized_event_sources,
+      Callbacks callbacks);
+
+  LogSyncOperation(const LogSyncOperation&) = delete;
+  LogSyncOperation& operator=(const LogSyncOperation&) = delete;
+
+  // Returns the progress so far.
+  LogSyncProgress progress() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns whether the operation is done.
+  bool done() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Cancels the RPC in flight and skips the groups that have not started.
+  // Does nothing if the operation is done.
+  void Cancel() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Waits until the operation is done.
+  //
+  // Returns the first error of a group, CancelledError if the operation was
+  // cancelled, and DeadlineExceededError if it is not done by `deadline`, in
+  // which case it keeps running.
+  absl::Status Wait(absl::Time deadline = absl::InfiniteFuture()) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  // The state of the RPC of one group, which must outlive its callback.
+  struct Call {
+    ::grpc::ClientContext context;
+    ::intrinsic_proto::data_logger::SyncRequest request;
+    ::intrinsic_proto::data_logger::SyncResponse response;
+  };
+
+  LogSyncOperation(LoggerStub* stub,
+                   std::vector<std::vector<std::string>> groups,
+                   Callbacks callbacks);
+
+  // Starts the RPC of the next group, or finishes the operation if there is
+  // none left.
+  void StartNextGroup() ABSL_LOCKS_EXCLUDED(mutex_);
+  void OnGroupDone(Call* call, const ::grpc::Status& grpc_status)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  LoggerStub* const stub_;
+  const std::vector<std::vector<std::string>> groups_;
+  const Callbacks callbacks_;
+
+  mutable absl::Mutex mutex_;
+  LogSyncProgress progress_ ABSL_GUARDED_BY(mutex_);
+  // All calls so far. Kept until the operation is destroyed, since a call must
+  // not be destroyed from its own callback.
+  std::vector<std::unique_ptr<Call>> calls_ ABSL_GUARDED_BY(mutex_);
+  bool cancelled_ ABSL_GUARDED_BY(mutex_) = false;
+  bool done_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::Status status_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_LOGGING_LOG_SYNC_OPERATION_H_
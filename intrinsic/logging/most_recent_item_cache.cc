@@ -0,0 +1,128 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/logging/most_recent_item_cache.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/support/sync_stream.h"
+#include "intrinsic/logging/proto/logger_service.pb.h"
+#include "intrinsic/util/grpc/stream_watcher.h"
+
+namespace intrinsic {
+
+// static
+absl::StatusOr<std::unique_ptr<MostRecentItemCache>>
+MostRecentItemCache::Create(LoggerStub* stub,
+                            std::vector<std::string> event_sources,
+                            absl::Duration retry_period,
+                            ItemCallback callback) {
+  if (event_sources.empty()) {
+    return absl::InvalidArgumentError("No event sources to watch");
+  }
+  if (retry_period <= absl::ZeroDuration()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Retry period must be positive, got ",
+                     absl::FormatDuration(retry_period)));
+  }
+  // Private constructor, so no make_unique.
+  return absl::WrapUnique(
+      new MostRecentItemCache(stub, std::move(event_sources), retry_period,
+                              std::move(callback)));
+}
+
+MostRecentItemCache::MostRecentItemCache(LoggerStub* stub,
+                                         std::vector<std::string> event_sources,
+                                         absl::Duration retry_period,
+                                         ItemCallback callback)
+    : stub_(stub),
+      event_sources_(std::move(event_sources)),
+      callback_(std::move(callback)) {
+  for (const std::string& event_source : event_sources_) {
+    items_.try_emplace(event_source, nullptr);
+  }
+  // Start watching only once all members are initialized.
+  watcher_ = std::make_unique<StreamWatcher>(
+      [this](::grpc::ClientContext* context) { return Stream(context); },
+      StreamWatcher::Options{
+          .name = "most recent items",
+          .retry_delay = retry_period,
+          .poll = [this](absl::Time deadline) { return Poll(deadline); },
+          .poll_period = retry_period,
+      });
+}
+
+absl::StatusOr<std::shared_ptr<const MostRecentItemCache::LogItem>>
+MostRecentItemCache::GetMostRecentItem(absl::string_view event_source) const {
+  absl::MutexLock lock(&items_mutex_);
+  auto it = items_.find(event_source);
+  if (it == items_.end()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Event source '", event_source, "' is not watched"));
+  }
+  if (it->second == nullptr) {
+    return absl::NotFoundError(absl::StrCat(
+        "No item of event source '", event_source, "' received yet"));
+  }
+  return it->second;
+}
+
+absl::Status MostRecentItemCache::Stream(::grpc::ClientContext* context) {
+  intrinsic_proto::data_logger::WatchMostRecentItemsRequest request;
+  request.mutable_event_sources()->Add(event_sources_.begin(),
+                                       event_sources_.end());
+  std::unique_ptr<::grpc::ClientReaderInterface<
+      intrinsic_proto::data_logger::WatchMostRecentItemsResponse>>
+      stream = stub_->WatchMostRecentItems(context, request);
+  return ReadStream(
+      *stream,
+      [this](intrinsic_proto::data_logger::WatchMostRecentItemsResponse&
+                 response) { Update(std::move(*response.mutable_item())); });
+}
+
+absl::Status MostRecentItemCache::Poll(absl::Time deadline) {
+  for (const std::string& event_source : event_sources_) {
+    ::grpc::ClientContext context;
+    context.set_deadline(absl::ToChronoTime(deadline));
+    intrinsic_proto::data_logger::GetMostRecentItemRequest request;
+    request.set_event_source(event_source);
+    intrinsic_proto::data_logger::GetMostRecentItemResponse response;
+    if (stub_->GetMostRecentItem(&context, request, &response).ok()) {
+      Update(std::move(*response.mutable_item()));
+    }
+  }
+  return absl::OkStatus();
+}
+
+void MostRecentItemCache::Update(LogItem item) {
+  std::shared_ptr<const LogItem> shared;
+  {
+    absl::MutexLock lock(&items_mutex_);
+    auto it = items_.find(item.metadata().event_source());
+    if (it == items_.end()) {
+      return;
+    }
+    // Polling returns the same item until a new one is logged.
+    if (it->second != nullptr &&
+        it->second->metadata().uid() == item.metadata().uid()) {
+      return;
+    }
+    shared = std::make_shared<const LogItem>(std::move(item));
+    it->second = shared;
+  }
+  if (callback_ != nullptr) {
+    callback_(*shared);
+  }
+}
+
+}  // namespace intrinsic
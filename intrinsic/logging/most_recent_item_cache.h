@@ -0,0 +1,94 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_LOGGING_MOST_RECENT_ITEM_CACHE_H_
+#define INTRINSIC_LOGGING_MOST_RECENT_ITEM_CACHE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "grpcpp/client_context.h"
+#include "intrinsic/logging/proto/log_item.pb.h"
+#include "intrinsic/logging/proto/logger_service.grpc.pb.h"
+#include "intrinsic/util/grpc/stream_watcher.h"
+
+namespace intrinsic {
+
+// Keeps the most recent LogItem of a set of event sources up to date in the
+// background, so that reading it is a local lookup instead of a
+// GetMostRecentItem RPC per read.
+//
+// A single thread reads the WatchMostRecentItems stream of the DataLogger,
+// which pushes each new item of the watched event sources as soon as it is
+// logged, and calls the optional callback. If the stream breaks, the cache
+// reopens it after `retry_period`. DataLoggers that do not implement the
+// stream are polled with GetMostRecentItem every `retry_period` instead.
+//
+// Obtain a MostRecentItemCache from
+// StructuredLoggingClient::WatchMostRecentItems(). It must not outlive its
+// client.
+//
+// This class is thread-safe. Destroying the cache cancels the stream and waits
+// for an outstanding callback to finish.
+class MostRecentItemCache {
+ public:
+  using LogItem = ::intrinsic_proto::data_logger::LogItem;
+  using LoggerStub = ::intrinsic_proto::data_logger::DataLogger::StubInterface;
+  // Called on the thread of the cache with each new item. Must not block for
+  // long, since that delays the next update.
+  using ItemCallback = absl::AnyInvocable<void(const LogItem&)>;
+
+  // Starts watching `event_sources` through `stub`. `callback` may be null.
+  //
+  // Returns InvalidArgumentError if `event_sources` is empty, or if
+  // `retry_period` is not positive.
+  static absl::StatusOr<std::unique_ptr<MostRecentItemCache>> Create(
+      LoggerStub* stub, std::vector<std::string> event_sources,
+      absl::Duration retry_period, ItemCallback callback);
+
+  MostRecentItemCache(const MostRecentItemCache&) = delete;
+  MostRecentItemCache& operator=(const MostRecentItemCache&) = delete;
+
+  // Returns the most recent item of `event_source`. The item is shared with
+  // the cache and is not copied.
+  //
+  // Returns InvalidArgumentError if the cache does not watch `event_source`,
+  // and NotFoundError if no item of it has been received yet.
+  absl::StatusOr<std::shared_ptr<const LogItem>> GetMostRecentItem(
+      absl::string_view event_source) const ABSL_LOCKS_EXCLUDED(items_mutex_);
+
+ private:
+  MostRecentItemCache(LoggerStub* stub, std::vector<std::string> event_sources,
+                      absl::Duration retry_period, ItemCallback callback);
+
+  // Reads the stream until it ends, and returns its final status.
+  absl::Status Stream(::grpc::ClientContext* context);
+  // Polls the most recent item of each event source once.
+  absl::Status Poll(absl::Time deadline);
+  // Stores `item` if it differs from the cached one of its event source.
+  void Update(LogItem item) ABSL_LOCKS_EXCLUDED(items_mutex_);
+
+  LoggerStub* const stub_;
+  const std::vector<std::string> event_sources_;
+  ItemCallback callback_;
+
+  mutable absl::Mutex items_mutex_;
+  // Keyed by event source. Contains an entry for each watched event source,
+  // which is null until its first item is received.
+  absl::flat_hash_map<std::string, std::shared_ptr<const LogItem>> items_
+      ABSL_GUARDED_BY(items_mutex_);
+  // Last, so that it stops before the members it uses are destroyed.
+  std::unique_ptr<StreamWatcher> watcher_;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_LOGGING_MOST_RECENT_ITEM_CACHE_H_
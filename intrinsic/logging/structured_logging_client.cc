@@ -11,6 +11,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/attributes.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -19,8 +20,12 @@
 #include "grpcpp/channel.h"
 #include "grpcpp/client_context.h"
 #include "grpcpp/support/status.h"
+#include "intrinsic/logging/arena_log_item.h"
+#include "intrinsic/logging/log_sync_operation.h"
+#include "intrinsic/logging/most_recent_item_cache.h"
 #include "intrinsic/logging/proto/logger_service.grpc.pb.h"
 #include "intrinsic/logging/proto/logger_service.pb.h"
+#include "intrinsic/util/allocation_tracking.h"
 #include "intrinsic/util/grpc/grpc.h"
 #include "intrinsic/util/proto_time.h"
 #include "intrinsic/util/status/status_conversion_grpc.h"
@@ -30,6 +35,78 @@ namespace intrinsic {
 
 using intrinsic_proto::data_logger::LogOptions;
 
+namespace {
+
+using LoggerStub = StructuredLoggingClient::LoggerStub;
+
+ABSL_CONST_INIT LazyAllocationTag kLoggingAllocationTag("structured_logging");
+
+// A LogRequest that borrows the item of the caller instead of copying it, for
+// large items such as images or point clouds. Must not outlive the item.
+class BorrowedLogRequest {
+ public:
+  explicit BorrowedLogRequest(const StructuredLoggingClient::LogItem& item) {
+    // The request is only serialized, so the item is never modified.
+    request_.unsafe_arena_set_allocated_item(
+        const_cast<StructuredLoggingClient::LogItem*>(&item));
+  }
+
+  ~BorrowedLogRequest() { (void)request_.unsafe_arena_release_item(); }
+
+  BorrowedLogRequest(const BorrowedLogRequest&) = delete;
+  BorrowedLogRequest& operator=(const BorrowedLogRequest&) = delete;
+
+  const intrinsic_proto::data_logger::LogRequest& request() const {
+    return request_;
+  }
+
+ private:
+  intrinsic_proto::data_logger::LogRequest request_;
+};
+
+absl::Status SendLog(LoggerStub& stub,
+                     const intrinsic_proto::data_logger::LogRequest& request) {
+  grpc::ClientContext context;
+  google::protobuf::Empty response;
+  return ToAbslStatus(stub.Log(&context, request, &response));
+}
+
+// Starts an asynchronous Log RPC. The request is serialized before this
+// returns, so it only needs to outlive the call.
+void SendLogAsync(LoggerStub& stub,
+                  const intrinsic_proto::data_logger::LogRequest& request,
+                  std::function<void(absl::Status)> callback) {
+  struct LogArgs {
+    // Both, the context as well as the response need to persist until the
+    // callback function is invoked regardless of whether the response is used
+    // in the callback or not.
+    grpc::ClientContext context;
+    google::protobuf::Empty response;
+    std::function<void(absl::Status)> callback;
+  };
+
+  // We need a shared_ptr here because the lambda below must remain copyable and
+  // this is not the case if we used a unique_ptr.
+  auto args = std::make_shared<LogArgs>();
+  args->callback = std::move(callback);
+  stub.async()->Log(
+      &args->context, &request, &args->response,
+      [args](grpc::Status s) { args->callback(ToAbslStatus(s)); });
+}
+
+// Returns the default callback of LogAsync().
+std::function<void(absl::Status)> WarnOnFailure(
+    const StructuredLoggingClient::LogItem& item) {
+  return [event_source = item.metadata().event_source()](absl::Status s) {
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to log item for event source '" << event_source
+                   << "' in async call.";
+    }
+  };
+}
+
+}  // namespace
+
 struct StructuredLoggingClient::StructuredLoggingClientImpl {
   explicit StructuredLoggingClientImpl(
       const std::shared_ptr<grpc::Channel>& channel)
@@ -76,61 +153,86 @@ StructuredLoggingClient::~StructuredLoggingClient() = default;
 
 // Dispatches one log item to the data logger.
 absl::Status StructuredLoggingClient::Log(LogItem&& item) const {
-  grpc::ClientContext context;
+  ScopedAllocationTag allocation_tag(kLoggingAllocationTag);
   intrinsic_proto::data_logger::LogRequest request;
   *request.mutable_item() = std::move(item);
-  google::protobuf::Empty response;
-  return ToAbslStatus(impl_->stub->Log(&context, request, &response));
+  return SendLog(*impl_->stub, request);
 }
 
 absl::Status StructuredLoggingClient::Log(const LogItem& item) const {
-  LogItem log_item = item;
-  return Log(std::move(log_item));
+  ScopedAllocationTag allocation_tag(kLoggingAllocationTag);
+  BorrowedLogRequest request(item);
+  return SendLog(*impl_->stub, request.request());
 }
 
 void StructuredLoggingClient::LogAsync(LogItem&& item) const {
-  std::string event_source = item.metadata().event_source();
-  return LogAsync(std::move(item),
-                  [event_source = std::move(event_source)](absl::Status s) {
-                    if (!s.ok()) {
-                      LOG(WARNING) << "Failed to log item for event source '"
-                                   << event_source << "' in async call.";
-                    }
-                  });
+  std::function<void(absl::Status)> callback = WarnOnFailure(item);
+  return LogAsync(std::move(item), std::move(callback));
 }
 
 void StructuredLoggingClient::LogAsync(
     LogItem&& item, std::function<void(absl::Status)> callback) const {
-  struct LogArgs {
-    // Both, the context as well as the response need to persist until the
-    // callback function is invoked regardless of whether the response is used
-    // in the callback or not.
-    grpc::ClientContext context;
-    google::protobuf::Empty response;
-    std::function<void(absl::Status)> callback;
-  };
-
+  ScopedAllocationTag allocation_tag(kLoggingAllocationTag);
   intrinsic_proto::data_logger::LogRequest request;
   *request.mutable_item() = std::move(item);
-
-  // We need a shared_ptr here because the lambda below must remain copyable and
-  // this is not the case if we used a unique_ptr.
-  auto args = std::make_shared<LogArgs>();
-  args->callback = std::move(callback);
-  impl_->stub->async()->Log(
-      &args->context, &request, &args->response,
-      [args](grpc::Status s) { args->callback(ToAbslStatus(s)); });
+  SendLogAsync(*impl_->stub, request, std::move(callback));
 }
 
 void StructuredLoggingClient::LogAsync(const LogItem& item) const {
-  LogItem log_item = item;
-  return LogAsync(std::move(log_item));
+  return LogAsync(item, WarnOnFailure(item));
 }
 
 void StructuredLoggingClient::LogAsync(
     const LogItem& item, std::function<void(absl::Status)> callback) const {
-  LogItem log_item = item;
-  return LogAsync(std::move(log_item), std::move(callback));
+  ScopedAllocationTag allocation_tag(kLoggingAllocationTag);
+  BorrowedLogRequest request(item);
+  SendLogAsync(*impl_->stub, request.request(), std::move(callback));
+}
+
+void StructuredLoggingClient::LogAsync(ArenaLogItem&& item) const {
+  std::function<void(absl::Status)> callback = WarnOnFailure(item.item());
+  return LogAsync(std::move(item), std::move(callback));
+}
+
+void StructuredLoggingClient::LogAsync(
+    ArenaLogItem&& item, std::function<void(absl::Status)> callback) const {
+  ScopedAllocationTag allocation_tag(kLoggingAllocationTag);
+  // The callback owns the arena, which is freed together with the callback.
+  auto owned_item = std::make_shared<ArenaLogItem>(std::move(item));
+  const intrinsic_proto::data_logger::LogRequest& request =
+      owned_item->request();
+  SendLogAsync(*impl_->stub, request,
+               [owned_item = std::move(owned_item),
+                callback = std::move(callback)](absl::Status status) {
+                 callback(std::move(status));
+               });
+}
+
+absl::Status StructuredLoggingClient::LogBatch(
+    std::vector<LogItem>&& items) const {
+  if (items.empty()) {
+    return absl::OkStatus();
+  }
+  ScopedAllocationTag allocation_tag(kLoggingAllocationTag);
+  intrinsic_proto::data_logger::LogBatchRequest request;
+  request.mutable_items()->Reserve(items.size());
+  for (LogItem& item : items) {
+    *request.add_items() = std::move(item);
+  }
+  {
+    grpc::ClientContext context;
+    google::protobuf::Empty response;
+    absl::Status status =
+        ToAbslStatus(impl_->stub->LogBatch(&context, request, &response));
+    if (!absl::IsUnimplemented(status)) {
+      return status;
+    }
+  }
+  // Older services only implement Log.
+  for (LogItem& item : *request.mutable_items()) {
+    INTR_RETURN_IF_ERROR(Log(std::move(item)));
+  }
+  return absl::OkStatus();
 }
 
 // Returns a list of `event_source` that can be requested using GetLogItems.
@@ -201,6 +303,15 @@ StructuredLoggingClient::GetMostRecentItem(
   return std::move(response.item());
 }
 
+absl::StatusOr<std::unique_ptr<MostRecentItemCache>>
+StructuredLoggingClient::WatchMostRecentItems(
+    std::vector<std::string> event_sources, absl::Duration retry_period,
+    MostRecentItemCache::ItemCallback callback) const {
+  return MostRecentItemCache::Create(impl_->stub.get(),
+                                     std::move(event_sources), retry_period,
+                                     std::move(callback));
+}
+
 // Flushes all remaining LogItems
 absl::StatusOr<std::vector<std::string>>
 StructuredLoggingClient::SyncAndRotateLogs(
@@ -233,6 +344,15 @@ StructuredLoggingClient::SyncAndRotateLogs() const {
   return synced_event_sources;
 }
 
+absl::StatusOr<std::shared_ptr<LogSyncOperation>>
+StructuredLoggingClient::SyncAndRotateLogsAsync(
+    std::vector<std::vector<std::string>> prioritized_event_sources,
+    LogSyncOperation::Callbacks callbacks) const {
+  return LogSyncOperation::Start(impl_->stub.get(),
+                                 std::move(prioritized_event_sources),
+                                 std::move(callbacks));
+}
+
 absl::Status StructuredLoggingClient::SetLogOptions(
     const std::map<std::string, intrinsic_proto::data_logger::LogOptions>&
         options) const {
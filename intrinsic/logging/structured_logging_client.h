@@ -16,6 +16,9 @@
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "grpcpp/channel.h"
+#include "intrinsic/logging/arena_log_item.h"
+#include "intrinsic/logging/log_sync_operation.h"
+#include "intrinsic/logging/most_recent_item_cache.h"
 #include "intrinsic/logging/proto/log_item.pb.h"
 #include "intrinsic/logging/proto/logger_service.grpc.pb.h"
 
@@ -62,7 +65,7 @@ class StructuredLoggingClient {
   // Logs an r-value item.
   absl::Status Log(LogItem&& item) const;
 
-  // Logs an item. The item will be internally copied to the logging request.
+  // Logs an item. The logging request borrows the item instead of copying it.
   absl::Status Log(const LogItem& item) const;
 
   // Performs asynchronous logging of an r-value item. A default callback is
@@ -74,17 +77,33 @@ class StructuredLoggingClient {
   void LogAsync(LogItem&& item,
                 std::function<void(absl::Status)> callback) const;
 
-  // Performs asynchronous logging of an item. The item will be internally
-  // copied to the logging request. A default callback is
+  // Performs asynchronous logging of an item. The item is serialized before
+  // the call returns, without being copied first. A default callback is
   // installed, which prints a warning message in case of a logging failure.
   void LogAsync(const LogItem& item) const;
 
   // Performs asynchronous logging of an item and calls the user specified
-  // callback when done. The item will be internally copied to the logging
-  // request.
+  // callback when done. The item is serialized before the call returns,
+  // without being copied first.
   void LogAsync(const LogItem& item,
                 std::function<void(absl::Status)> callback) const;
 
+  // Performs asynchronous logging of an item built on an arena, which is sent
+  // without being copied or moved. The arena is freed after the callback ran.
+  // A default callback is installed, which prints a warning message in case
+  // of a logging failure.
+  void LogAsync(ArenaLogItem&& item) const;
+
+  // Performs asynchronous logging of an item built on an arena and calls the
+  // user specified callback when done. The arena is freed after the callback
+  // ran.
+  void LogAsync(ArenaLogItem&& item,
+                std::function<void(absl::Status)> callback) const;
+
+  // Logs `items` with a single LogBatch RPC. Falls back to one Log RPC per
+  // item if the service does not implement LogBatch.
+  absl::Status LogBatch(std::vector<LogItem>&& items) const;
+
   // Returns a list of `event_source` that can be requested using list requests.
   absl::StatusOr<std::vector<std::string>> ListLogSources() const;
 
@@ -120,6 +139,18 @@ class StructuredLoggingClient {
   absl::StatusOr<LogItem> GetMostRecentItem(
       absl::string_view event_source) const;
 
+  // Starts watching the most recent LogItems of `event_sources`, so that
+  // MostRecentItemCache::GetMostRecentItem() is a local read instead of an RPC
+  // per call. `callback`, if set, is called with each new item as it arrives.
+  // The DataLogger pushes new items as they are logged; if it does not support
+  // that, the cache polls it every `retry_period` instead.
+  //
+  // The returned cache must not outlive this client.
+  absl::StatusOr<std::unique_ptr<MostRecentItemCache>> WatchMostRecentItems(
+      std::vector<std::string> event_sources,
+      absl::Duration retry_period = absl::Seconds(1),
+      MostRecentItemCache::ItemCallback callback = nullptr) const;
+
   // Writes all log files of the specified 'event_sources' to GCS.
   // Might be throttled per-event-source if called too frequently.
   //
@@ -136,6 +167,18 @@ class StructuredLoggingClient {
   absl::StatusOr<std::vector<std::string>> ABSL_MUST_USE_RESULT
   SyncAndRotateLogs() const;
 
+  // Starts writing the log files of `prioritized_event_sources` to GCS in the
+  // background, one group after the other, and returns a handle to follow the
+  // progress of, wait for, or cancel the sync. Does not block, so that an
+  // end-of-job hook can overlap the upload with its teardown.
+  //
+  // The client must outlive the returned operation.
+  //
+  // Returns InvalidArgumentError if there is no event source to sync.
+  absl::StatusOr<std::shared_ptr<LogSyncOperation>> SyncAndRotateLogsAsync(
+      std::vector<std::vector<std::string>> prioritized_event_sources,
+      LogSyncOperation::Callbacks callbacks = {}) const;
+
   // Set the logging configuration for an event_source
   absl::Status SetLogOptions(
       const std::map<std::string, intrinsic_proto::data_logger::LogOptions>&
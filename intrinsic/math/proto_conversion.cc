@@ -4,8 +4,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <limits>
 
+#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
@@ -55,6 +57,13 @@ namespace intrinsic_proto {
 
 absl::StatusOr<intrinsic::eigenmath::MatrixXd> FromProto(
     const Matrixd& proto_matrix) {
+  intrinsic::eigenmath::MatrixXd eigen_matrix;
+  INTR_RETURN_IF_ERROR(FromProto(proto_matrix, &eigen_matrix));
+  return eigen_matrix;
+}
+
+absl::Status FromProto(const Matrixd& proto_matrix,
+                       intrinsic::eigenmath::MatrixXd* eigen_matrix) {
   if (proto_matrix.rows() > intrinsic_proto::kMaxMatrixProtoDimension ||
       proto_matrix.rows() < 1) {
     return absl::InvalidArgumentError(absl::Substitute(
@@ -71,16 +80,16 @@ absl::StatusOr<intrinsic::eigenmath::MatrixXd> FromProto(
         proto_matrix.cols(), intrinsic_proto::kMaxMatrixProtoDimension));
   }
 
-  intrinsic::eigenmath::MatrixXd eigen_matrix(proto_matrix.rows(),
-                                              proto_matrix.cols());
-  if (proto_matrix.values().size() != eigen_matrix.size()) {
+  const int64_t size = int64_t{proto_matrix.rows()} * proto_matrix.cols();
+  if (proto_matrix.values().size() != size) {
     return absl::InvalidArgumentError(
         absl::Substitute("The number of elements in the matrix doesn't match "
                          "the size (cols x rows) definition: $0 vs $1",
-                         proto_matrix.values().size(), eigen_matrix.size()));
+                         proto_matrix.values().size(), size));
   }
-  absl::c_copy(proto_matrix.values(), eigen_matrix.reshaped().begin());
-  return eigen_matrix;
+  eigen_matrix->resize(proto_matrix.rows(), proto_matrix.cols());
+  absl::c_copy(proto_matrix.values(), eigen_matrix->reshaped().begin());
+  return absl::OkStatus();
 }
 
 }  // namespace intrinsic_proto
@@ -96,7 +105,22 @@ intrinsic::eigenmath::Quaterniond FromProto(const Quaternion& quaternion) {
   return {quaternion.w(), quaternion.x(), quaternion.y(), quaternion.z()};
 }
 
+void FromProto(const Point& point, intrinsic::eigenmath::Vector3d* out) {
+  *out = FromProto(point);
+}
+
+void FromProto(const Quaternion& quaternion,
+               intrinsic::eigenmath::Quaterniond* out) {
+  *out = FromProto(quaternion);
+}
+
 absl::StatusOr<intrinsic::Pose> FromProto(const Pose& pose) {
+  intrinsic::Pose out;
+  INTR_RETURN_IF_ERROR(FromProto(pose, &out));
+  return out;
+}
+
+absl::Status FromProto(const Pose& pose, intrinsic::Pose* out) {
   intrinsic::eigenmath::Quaterniond quaternion = FromProto(pose.orientation());
   // We need to perform a soft-check in here, since otherwise, we might raise an
   // error status due to numeric errors introduced by the squared norm
@@ -114,8 +138,9 @@ absl::StatusOr<intrinsic::Pose> FromProto(const Pose& pose) {
         std::sqrt(squared_norm), normalized_quat.x(), normalized_quat.y(),
         normalized_quat.z(), normalized_quat.w()));
   }
-  return intrinsic::Pose(quaternion, FromProto(pose.position()),
+  *out = intrinsic::Pose(quaternion, FromProto(pose.position()),
                          intrinsic::eigenmath::kDoNotNormalize);
+  return absl::OkStatus();
 }
 
 absl::StatusOr<intrinsic::Pose> FromProtoNormalized(const Pose& pose) {
@@ -148,38 +173,80 @@ absl::StatusOr<intrinsic::Pose> FromProtoNormalized(const Pose& pose) {
                          intrinsic::eigenmath::kDoNotNormalize);
 }
 
+intrinsic::eigenmath::Vector3f FromProtoToVector3f(const Point& point) {
+  return FromProto(point).cast<float>();
+}
+
+intrinsic::eigenmath::Quaternionf FromProtoToQuaternionf(
+    const Quaternion& quaternion) {
+  return FromProto(quaternion).cast<float>();
+}
+
+absl::StatusOr<intrinsic::Pose3f> FromProtoToPose3f(const Pose& pose) {
+  INTR_ASSIGN_OR_RETURN(const intrinsic::Pose pose_d, FromProto(pose));
+  return intrinsic::Pose3f(pose_d.cast<float>());
+}
+
 }  // namespace intrinsic_proto
 
 namespace intrinsic {
 
 intrinsic_proto::Pose ToProto(const Pose& pose) {
   intrinsic_proto::Pose proto_pose;
-  *proto_pose.mutable_position() = ToProto(pose.translation());
-  *proto_pose.mutable_orientation() = ToProto(pose.quaternion());
+  ToProto(pose, &proto_pose);
   return proto_pose;
 }
 
 intrinsic_proto::Point ToProto(const eigenmath::Vector3d& point) {
   intrinsic_proto::Point proto_point;
-  proto_point.set_x(point.x());
-  proto_point.set_y(point.y());
-  proto_point.set_z(point.z());
+  ToProto(point, &proto_point);
   return proto_point;
 }
 
 intrinsic_proto::Quaternion ToProto(const eigenmath::Quaterniond& quaternion) {
   intrinsic_proto::Quaternion proto_quaternion;
-  proto_quaternion.set_x(quaternion.x());
-  proto_quaternion.set_y(quaternion.y());
-  proto_quaternion.set_z(quaternion.z());
-  proto_quaternion.set_w(quaternion.w());
+  ToProto(quaternion, &proto_quaternion);
   return proto_quaternion;
 }
 
+void ToProto(const Pose& pose, intrinsic_proto::Pose* proto) {
+  ToProto(pose.translation(), proto->mutable_position());
+  ToProto(pose.quaternion(), proto->mutable_orientation());
+}
+
+void ToProto(const eigenmath::Vector3d& point, intrinsic_proto::Point* proto) {
+  proto->set_x(point.x());
+  proto->set_y(point.y());
+  proto->set_z(point.z());
+}
+
+void ToProto(const eigenmath::Quaterniond& quaternion,
+             intrinsic_proto::Quaternion* proto) {
+  proto->set_x(quaternion.x());
+  proto->set_y(quaternion.y());
+  proto->set_z(quaternion.z());
+  proto->set_w(quaternion.w());
+}
+
+intrinsic_proto::Pose ToProto(const Pose3f& pose) {
+  intrinsic_proto::Pose proto_pose;
+  *proto_pose.mutable_position() = ToProto(pose.translation());
+  *proto_pose.mutable_orientation() = ToProto(pose.quaternion());
+  return proto_pose;
+}
+
+intrinsic_proto::Point ToProto(const eigenmath::Vector3f& point) {
+  return ToProto(eigenmath::Vector3d(point.cast<double>()));
+}
+
+intrinsic_proto::Quaternion ToProto(const eigenmath::Quaternionf& quaternion) {
+  return ToProto(eigenmath::Quaterniond(quaternion.cast<double>()));
+}
+
 namespace {
 template <typename MatrixType>
-absl::StatusOr<intrinsic_proto::Matrixd> ToProtoImpl(
-    const MatrixType& eigen_matrix) {
+absl::Status ToProtoImpl(const MatrixType& eigen_matrix,
+                         intrinsic_proto::Matrixd* proto_matrix) {
   if (eigen_matrix.rows() < 1 ||
       eigen_matrix.rows() > intrinsic_proto::kMaxMatrixProtoDimension) {
     return absl::InvalidArgumentError(absl::Substitute(
@@ -197,16 +264,24 @@ absl::StatusOr<intrinsic_proto::Matrixd> ToProtoImpl(
   }
 
   const auto reshaped_matrix = eigen_matrix.reshaped();  // NOLINT
-  intrinsic_proto::Matrixd proto_matrix;
-  proto_matrix.set_rows(eigen_matrix.rows());
-  proto_matrix.set_cols(eigen_matrix.cols());
-  proto_matrix.mutable_values()->Add(reshaped_matrix.begin(),
-                                     reshaped_matrix.end());
-  return proto_matrix;
+  proto_matrix->set_rows(eigen_matrix.rows());
+  proto_matrix->set_cols(eigen_matrix.cols());
+  // Clear() keeps the capacity of the values.
+  proto_matrix->mutable_values()->Clear();
+  proto_matrix->mutable_values()->Add(reshaped_matrix.begin(),
+                                      reshaped_matrix.end());
+  return absl::OkStatus();
 }
 }  // namespace
 
 intrinsic_proto::Matrixd ToProto(const eigenmath::Matrix3d& matrix) {
-  return ToProtoImpl(matrix).value();
+  intrinsic_proto::Matrixd proto;
+  ToProto(matrix, &proto);
+  return proto;
+}
+
+void ToProto(const eigenmath::Matrix3d& matrix,
+             intrinsic_proto::Matrixd* proto) {
+  CHECK_OK(ToProtoImpl(matrix, proto));
 }
 }  // namespace intrinsic
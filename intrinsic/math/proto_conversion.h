@@ -3,6 +3,7 @@
 #ifndef INTRINSIC_MATH_PROTO_CONVERSION_H_
 #define INTRINSIC_MATH_PROTO_CONVERSION_H_
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "intrinsic/eigenmath/types.h"
 #include "intrinsic/math/pose3.h"
@@ -19,6 +20,10 @@ namespace intrinsic_proto {
 constexpr int kMaxMatrixProtoDimension = 2048;
 absl::StatusOr<intrinsic::eigenmath::MatrixXd> FromProto(
     const Matrixd& proto_matrix);
+// Same as above into `eigen_matrix`, which is only reallocated if its size
+// changes.
+absl::Status FromProto(const Matrixd& proto_matrix,
+                       intrinsic::eigenmath::MatrixXd* eigen_matrix);
 
 }  // namespace intrinsic_proto
 
@@ -35,6 +40,19 @@ absl::StatusOr<intrinsic::Pose> FromProto(const Pose& pose);
 // as normalized as expected in `FromProto`, then no normalization is performed.
 absl::StatusOr<intrinsic::Pose> FromProtoNormalized(const Pose& pose);
 
+// Same as the conversions above, into an existing object.
+void FromProto(const Point& point, intrinsic::eigenmath::Vector3d* out);
+void FromProto(const Quaternion& quaternion,
+               intrinsic::eigenmath::Quaterniond* out);
+absl::Status FromProto(const Pose& pose, intrinsic::Pose* out);
+
+// Single precision variants of the conversions above. The pose is checked in
+// double precision like in FromProto(const Pose&), then rounded.
+intrinsic::eigenmath::Vector3f FromProtoToVector3f(const Point& point);
+intrinsic::eigenmath::Quaternionf FromProtoToQuaternionf(
+    const Quaternion& quaternion);
+absl::StatusOr<intrinsic::Pose3f> FromProtoToPose3f(const Pose& pose);
+
 }  // namespace intrinsic_proto
 
 // To enable unqualified calls to ToProto() throughout our code base, we declare
@@ -45,7 +63,20 @@ intrinsic_proto::Pose ToProto(const Pose& pose);
 intrinsic_proto::Point ToProto(const eigenmath::Vector3d& point);
 intrinsic_proto::Quaternion ToProto(const eigenmath::Quaterniond& quaternion);
 
+// Same as the conversions above, into an existing proto. This reuses the
+// storage of `proto`, e.g., of the sub-messages of a Pose.
+void ToProto(const Pose& pose, intrinsic_proto::Pose* proto);
+void ToProto(const eigenmath::Vector3d& point, intrinsic_proto::Point* proto);
+void ToProto(const eigenmath::Quaterniond& quaternion,
+             intrinsic_proto::Quaternion* proto);
+
+intrinsic_proto::Pose ToProto(const Pose3f& pose);
+intrinsic_proto::Point ToProto(const eigenmath::Vector3f& point);
+intrinsic_proto::Quaternion ToProto(const eigenmath::Quaternionf& quaternion);
+
 intrinsic_proto::Matrixd ToProto(const eigenmath::Matrix3d& matrix);
+void ToProto(const eigenmath::Matrix3d& matrix,
+             intrinsic_proto::Matrixd* proto);
 }  // namespace intrinsic
 
 #endif  // INTRINSIC_MATH_PROTO_CONVERSION_H_
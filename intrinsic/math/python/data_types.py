@@ -7,6 +7,7 @@ from typing import Any, Optional, Sequence
 from intrinsic.icon.proto import cart_space_pb2
 from intrinsic.math.python import math_types
 from intrinsic.math.python import pose3
+from intrinsic.math.python import pose3_batch
 from intrinsic.math.python import quaternion
 from intrinsic.math.python import rotation3
 from intrinsic.math.python import vector_util
@@ -15,6 +16,8 @@ import numpy as np
 VECTOR_TYPE = math_types.VectorType
 Rotation3 = rotation3.Rotation3
 Pose3 = pose3.Pose3
+Pose3Batch = pose3_batch.Pose3Batch
+Rotation3Batch = pose3_batch.Rotation3Batch
 Quaternion = quaternion.Quaternion
 
 
@@ -0,0 +1,433 @@
+# Copyright 2023 Intrinsic Innovation LLC
+
+"""Batches of rotations and poses backed by numpy arrays (python3).
+
+Rotation3Batch and Pose3Batch hold many rotations or poses in a single array
+and apply the operations of Rotation3 and Pose3 to all of them at once, which
+is much faster than a list of Rotation3 or Pose3 objects for thousands of
+elements.
+
+A Pose3Batch is an (N, 7) float64 array of vec7 rows [tx, ty, tz, qx, qy, qz,
+qw], see Pose3.vec7, and a Rotation3Batch is an (N, 4) array of quaternions
+[qx, qy, qz, qw]. The arrays are exposed as views, so a C-contiguous batch is
+passed to numpy code or to C++ (see pose3_batch_py.cc) without copying.
+
+Binary operations broadcast a batch of one element against a batch of N:
+
+  world_poses_objects = world_pose_camera * camera_poses_objects
+"""
+
+from typing import Iterable, List, Optional, Union
+
+from intrinsic.math.python import pose3
+from intrinsic.math.python import quaternion as quaternion_class
+from intrinsic.math.python import rotation3
+import numpy as np
+
+# ----------------------------------------------------------------------------
+# Error messages for exceptions.
+XYZW_SHAPE_MESSAGE = 'Rotation3Batch expects an array of shape (N, 4)'
+VEC7_SHAPE_MESSAGE = 'Pose3Batch expects an array of shape (N, 7)'
+BROADCAST_MESSAGE = 'Batches of different sizes cannot be combined'
+
+
+def _as_rows(
+    values: Union[np.ndarray, Iterable[float]], width: int, message: str
+) -> np.ndarray:
+  """Returns `values` as a float64 (N, width) array, copying only if needed."""
+  array = np.asarray(values, dtype=np.float64)
+  if array.ndim == 1 and array.shape[0] == width:
+    array = array.reshape(1, width)
+  if array.ndim != 2 or array.shape[1] != width:
+    raise ValueError('%s, got %s.' % (message, array.shape))
+  return array
+
+
+def _check_broadcast(size_a: int, size_b: int) -> None:
+  if size_a != size_b and size_a != 1 and size_b != 1:
+    raise ValueError('%s: %d and %d.' % (BROADCAST_MESSAGE, size_a, size_b))
+
+
+def _quaternion_multiply(a: np.ndarray, b: np.ndarray) -> np.ndarray:
+  """Returns the Hamilton products of the xyzw rows of `a` and `b`."""
+  a_vec, a_w = a[:, :3], a[:, 3:]
+  b_vec, b_w = b[:, :3], b[:, 3:]
+  product = np.empty(np.broadcast_shapes(a.shape, b.shape))
+  product[:, :3] = a_w * b_vec + b_w * a_vec + np.cross(a_vec, b_vec)
+  product[:, 3] = (a_w * b_w)[:, 0] - np.sum(a_vec * b_vec, axis=1)
+  return product
+
+
+def _rotate(xyzw: np.ndarray, points: np.ndarray) -> np.ndarray:
+  """Rotates the rows of `points` by the (normalized) xyzw rows."""
+  unit = xyzw / np.linalg.norm(xyzw, axis=1, keepdims=True)
+  vec, w = unit[:, :3], unit[:, 3:]
+  # p' = p + w * t + v x t, with t = 2 * (v x p).
+  t = 2.0 * np.cross(vec, points)
+  return points + w * t + np.cross(vec, t)
+
+
+def _matrices_from_quaternions(xyzw: np.ndarray) -> np.ndarray:
+  """Returns the (N, 3, 3) rotation matrices of the (normalized) xyzw rows."""
+  unit = xyzw / np.linalg.norm(xyzw, axis=1, keepdims=True)
+  x, y, z, w = unit[:, 0], unit[:, 1], unit[:, 2], unit[:, 3]
+  matrices = np.empty((xyzw.shape[0], 3, 3))
+  matrices[:, 0, 0] = 1.0 - 2.0 * (y * y + z * z)
+  matrices[:, 0, 1] = 2.0 * (x * y - z * w)
+  matrices[:, 0, 2] = 2.0 * (x * z + y * w)
+  matrices[:, 1, 0] = 2.0 * (x * y + z * w)
+  matrices[:, 1, 1] = 1.0 - 2.0 * (x * x + z * z)
+  matrices[:, 1, 2] = 2.0 * (y * z - x * w)
+  matrices[:, 2, 0] = 2.0 * (x * z - y * w)
+  matrices[:, 2, 1] = 2.0 * (y * z + x * w)
+  matrices[:, 2, 2] = 1.0 - 2.0 * (x * x + y * y)
+  return matrices
+
+
+def _quaternions_from_matrices(matrices: np.ndarray) -> np.ndarray:
+  """Returns the unit xyzw quaternions of (N, 3, 3) rotation matrices.
+
+  Uses the largest of the trace and the diagonal elements for each matrix,
+  which keeps the square root away from zero.
+
+  Args:
+    matrices: Rotation matrices of shape (N, 3, 3).
+
+  Returns:
+    Quaternions of shape (N, 4).
+  """
+  m = matrices
+  trace = m[:, 0, 0] + m[:, 1, 1] + m[:, 2, 2]
+  case = np.argmax(
+      np.stack([trace, m[:, 0, 0], m[:, 1, 1], m[:, 2, 2]], axis=1), axis=1
+  )
+  xyzw = np.empty((m.shape[0], 4))
+
+  i = case == 0
+  s = 2.0 * np.sqrt(1.0 + trace[i])
+  xyzw[i, 0] = (m[i, 2, 1] - m[i, 1, 2]) / s
+  xyzw[i, 1] = (m[i, 0, 2] - m[i, 2, 0]) / s
+  xyzw[i, 2] = (m[i, 1, 0] - m[i, 0, 1]) / s
+  xyzw[i, 3] = 0.25 * s
+
+  i = case == 1
+  s = 2.0 * np.sqrt(1.0 + m[i, 0, 0] - m[i, 1, 1] - m[i, 2, 2])
+  xyzw[i, 0] = 0.25 * s
+  xyzw[i, 1] = (m[i, 0, 1] + m[i, 1, 0]) / s
+  xyzw[i, 2] = (m[i, 0, 2] + m[i, 2, 0]) / s
+  xyzw[i, 3] = (m[i, 2, 1] - m[i, 1, 2]) / s
+
+  i = case == 2
+  s = 2.0 * np.sqrt(1.0 + m[i, 1, 1] - m[i, 0, 0] - m[i, 2, 2])
+  xyzw[i, 0] = (m[i, 0, 1] + m[i, 1, 0]) / s
+  xyzw[i, 1] = 0.25 * s
+  xyzw[i, 2] = (m[i, 1, 2] + m[i, 2, 1]) / s
+  xyzw[i, 3] = (m[i, 0, 2] - m[i, 2, 0]) / s
+
+  i = case == 3
+  s = 2.0 * np.sqrt(1.0 + m[i, 2, 2] - m[i, 0, 0] - m[i, 1, 1])
+  xyzw[i, 0] = (m[i, 0, 2] + m[i, 2, 0]) / s
+  xyzw[i, 1] = (m[i, 1, 2] + m[i, 2, 1]) / s
+  xyzw[i, 2] = 0.25 * s
+  xyzw[i, 3] = (m[i, 1, 0] - m[i, 0, 1]) / s
+
+  return xyzw / np.linalg.norm(xyzw, axis=1, keepdims=True)
+
+
+class Rotation3Batch(object):
+  """A batch of rotations, as an (N, 4) array of xyzw quaternions.
+
+  Like Rotation3, the quaternions are expected to be normalized unless the
+  batch is constructed with normalize=True.
+
+  Properties:
+    xyzw: The quaternions, as an (N, 4) array that shares memory with the
+      batch.
+
+  Factory functions:
+    identity
+    from_rotations
+    from_matrices
+  """
+
+  def __init__(self, xyzw: np.ndarray, normalize: bool = False):
+    """Constructs a batch from quaternions.
+
+    Does not copy `xyzw` if it is already a float64 array of shape (N, 4).
+
+    Args:
+      xyzw: Quaternions of shape (N, 4), or a single quaternion of shape (4,).
+      normalize: Indicates whether to normalize the quaternions.
+
+    Raises:
+      ValueError: If `xyzw` has the wrong shape or contains a zero quaternion.
+    """
+    xyzw = _as_rows(xyzw, 4, XYZW_SHAPE_MESSAGE)
+    norms = np.linalg.norm(xyzw, axis=1, keepdims=True)
+    if np.any(norms == 0.0):
+      raise ValueError('Rotation3Batch: quaternions must be non-zero.')
+    if normalize:
+      xyzw = xyzw / norms
+    self._xyzw = xyzw
+
+  @property
+  def xyzw(self) -> np.ndarray:
+    """Returns the (N, 4) array of quaternions, without copying."""
+    return self._xyzw
+
+  def __len__(self) -> int:
+    return self._xyzw.shape[0]
+
+  def __getitem__(
+      self, index: Union[int, slice, np.ndarray]
+  ) -> Union[rotation3.Rotation3, 'Rotation3Batch']:
+    """Returns a single Rotation3 for an integer, else a sub-batch."""
+    if isinstance(index, (int, np.integer)):
+      return rotation3.Rotation3(
+          quaternion_class.Quaternion(xyzw=self._xyzw[index].copy())
+      )
+    return Rotation3Batch(self._xyzw[index])
+
+  def to_rotations(self) -> List[rotation3.Rotation3]:
+    """Returns the rotations as a list of Rotation3 objects."""
+    return [self[i] for i in range(len(self))]
+
+  def inverse(self) -> 'Rotation3Batch':
+    """Returns the inverse rotations."""
+    inverse = self._xyzw * np.array([-1.0, -1.0, -1.0, 1.0])
+    norms_squared = np.sum(self._xyzw * self._xyzw, axis=1, keepdims=True)
+    return Rotation3Batch(inverse / norms_squared)
+
+  def multiply(self, other: 'Rotation3Batch') -> 'Rotation3Batch':
+    """Returns the compositions self[i] * other[i], broadcasting size 1."""
+    _check_broadcast(len(self), len(other))
+    return Rotation3Batch(_quaternion_multiply(self._xyzw, other.xyzw))
+
+  def rotate_points(self, points: np.ndarray) -> np.ndarray:
+    """Rotates an (N, 3) array of points, broadcasting size 1."""
+    points = _as_rows(points, 3, 'Points must have shape (N, 3)')
+    _check_broadcast(len(self), points.shape[0])
+    return _rotate(self._xyzw, points)
+
+  def matrix3x3(self) -> np.ndarray:
+    """Returns the rotations as an (N, 3, 3) array of matrices."""
+    return _matrices_from_quaternions(self._xyzw)
+
+  def __mul__(self, other: 'Rotation3Batch') -> 'Rotation3Batch':
+    return self.multiply(other)
+
+  @classmethod
+  def identity(cls, size: int) -> 'Rotation3Batch':
+    """Returns a batch of `size` identity rotations."""
+    xyzw = np.zeros((size, 4))
+    xyzw[:, 3] = 1.0
+    return cls(xyzw)
+
+  @classmethod
+  def from_rotations(
+      cls, rotations: Iterable[rotation3.Rotation3]
+  ) -> 'Rotation3Batch':
+    """Constructs a batch from Rotation3 objects."""
+    return cls(
+        np.array(
+            [rotation.quaternion.xyzw for rotation in rotations],
+            dtype=np.float64,
+        ).reshape(-1, 4)
+    )
+
+  @classmethod
+  def from_matrices(cls, matrices: np.ndarray) -> 'Rotation3Batch':
+    """Constructs a batch from an (N, 3, 3) array of rotation matrices."""
+    matrices = np.asarray(matrices, dtype=np.float64)
+    if matrices.ndim != 3 or matrices.shape[1:] != (3, 3):
+      raise ValueError(
+          'Rotation matrices must have shape (N, 3, 3), got %s.'
+          % (matrices.shape,)
+      )
+    return cls(_quaternions_from_matrices(matrices))
+
+
+class Pose3Batch(object):
+  """A batch of poses, as an (N, 7) array of vec7 rows.
+
+  Each row is [tx, ty, tz, qx, qy, qz, qw], see Pose3.vec7.
+
+  Properties:
+    vec7: The poses, as an (N, 7) array that shares memory with the batch.
+    translations: The (N, 3) translations, a view of vec7.
+    rotations: The rotations, as a Rotation3Batch that views vec7.
+
+  Factory functions:
+    identity
+    from_poses
+    from_matrices
+    from_translations_and_rotations
+  """
+
+  def __init__(self, vec7: np.ndarray, normalize: bool = False):
+    """Constructs a batch from vec7 rows.
+
+    Does not copy `vec7` if it is already a float64 array of shape (N, 7) and
+    `normalize` is False.
+
+    Args:
+      vec7: Poses of shape (N, 7), or a single pose of shape (7,).
+      normalize: Indicates whether to normalize the quaternions.
+
+    Raises:
+      ValueError: If `vec7` has the wrong shape or contains a zero quaternion.
+    """
+    vec7 = _as_rows(vec7, 7, VEC7_SHAPE_MESSAGE)
+    if normalize:
+      vec7 = vec7.copy()
+      vec7[:, 3:] = Rotation3Batch(vec7[:, 3:], normalize=True).xyzw
+    else:
+      # Checks the quaternions.
+      Rotation3Batch(vec7[:, 3:])
+    self._vec7 = vec7
+
+  @property
+  def vec7(self) -> np.ndarray:
+    """Returns the (N, 7) array of poses, without copying."""
+    return self._vec7
+
+  @property
+  def translations(self) -> np.ndarray:
+    """Returns the (N, 3) translations, as a view of vec7."""
+    return self._vec7[:, :3]
+
+  @property
+  def rotations(self) -> Rotation3Batch:
+    """Returns the rotations, as a view of vec7."""
+    return Rotation3Batch(self._vec7[:, 3:])
+
+  def __len__(self) -> int:
+    return self._vec7.shape[0]
+
+  def __getitem__(
+      self, index: Union[int, slice, np.ndarray]
+  ) -> Union[pose3.Pose3, 'Pose3Batch']:
+    """Returns a single Pose3 for an integer, else a sub-batch."""
+    if isinstance(index, (int, np.integer)):
+      return pose3.Pose3.from_vec7(self._vec7[index])
+    return Pose3Batch(self._vec7[index])
+
+  def to_poses(self) -> List[pose3.Pose3]:
+    """Returns the poses as a list of Pose3 objects."""
+    return [self[i] for i in range(len(self))]
+
+  def inverse(self) -> 'Pose3Batch':
+    """Returns the inverse poses."""
+    inverse_rotations = self.rotations.inverse()
+    return Pose3Batch.from_translations_and_rotations(
+        -inverse_rotations.rotate_points(self.translations), inverse_rotations
+    )
+
+  def multiply(self, other: 'Pose3Batch') -> 'Pose3Batch':
+    """Returns the compositions self[i] * other[i], broadcasting size 1."""
+    _check_broadcast(len(self), len(other))
+    rotations = self.rotations
+    return Pose3Batch.from_translations_and_rotations(
+        self.translations + rotations.rotate_points(other.translations),
+        rotations.multiply(other.rotations),
+    )
+
+  def transform_points(self, points: np.ndarray) -> np.ndarray:
+    """Transforms an (N, 3) array of points, broadcasting size 1."""
+    return self.rotations.rotate_points(points) + self.translations
+
+  def matrix4x4(self) -> np.ndarray:
+    """Returns the poses as an (N, 4, 4) array of homogeneous transforms."""
+    matrices = np.zeros((len(self), 4, 4))
+    matrices[:, :3, :3] = self.rotations.matrix3x3()
+    matrices[:, :3, 3] = self.translations
+    matrices[:, 3, 3] = 1.0
+    return matrices
+
+  def almost_equal(
+      self, other: 'Pose3Batch', rtol: float = 1e-5, atol: float = 1e-8
+  ) -> np.ndarray:
+    """Returns, per pose, whether the poses are almost equal.
+
+    Quaternions q and -q represent the same rotation and are treated as equal.
+
+    Args:
+      other: Poses to compare to, broadcasting size 1.
+      rtol: Relative tolerance.
+      atol: Absolute tolerance.
+
+    Returns:
+      A boolean array of shape (N,).
+    """
+    _check_broadcast(len(self), len(other))
+    translations_close = np.all(
+        np.isclose(self.translations, other.translations, rtol, atol), axis=1
+    )
+    a = self.rotations.xyzw
+    b = other.rotations.xyzw
+    a = a / np.linalg.norm(a, axis=1, keepdims=True)
+    b = b / np.linalg.norm(b, axis=1, keepdims=True)
+    rotations_close = np.all(np.isclose(a, b, rtol, atol), axis=1) | np.all(
+        np.isclose(a, -b, rtol, atol), axis=1
+    )
+    return translations_close & rotations_close
+
+  def __mul__(self, other: 'Pose3Batch') -> 'Pose3Batch':
+    return self.multiply(other)
+
+  @classmethod
+  def identity(cls, size: int) -> 'Pose3Batch':
+    """Returns a batch of `size` identity poses."""
+    vec7 = np.zeros((size, 7))
+    vec7[:, 6] = 1.0
+    return cls(vec7)
+
+  @classmethod
+  def from_poses(cls, poses: Iterable[pose3.Pose3]) -> 'Pose3Batch':
+    """Constructs a batch from Pose3 objects."""
+    return cls(
+        np.array([pose.vec7 for pose in poses], dtype=np.float64).reshape(
+            -1, 7
+        )
+    )
+
+  @classmethod
+  def from_translations_and_rotations(
+      cls,
+      translations: np.ndarray,
+      rotations: Optional[Rotation3Batch] = None,
+  ) -> 'Pose3Batch':
+    """Constructs a batch from (N, 3) translations and N rotations.
+
+    Args:
+      translations: Translations of shape (N, 3). A single translation is
+        broadcast to the size of `rotations`.
+      rotations: Rotations, identity if not given. A single rotation is
+        broadcast to the size of `translations`.
+
+    Returns:
+      The poses.
+    """
+    translations = _as_rows(
+        translations, 3, 'Translations must have shape (N, 3)'
+    )
+    if rotations is None:
+      rotations = Rotation3Batch.identity(1)
+    _check_broadcast(translations.shape[0], len(rotations))
+    vec7 = np.empty((max(translations.shape[0], len(rotations)), 7))
+    vec7[:, :3] = translations
+    vec7[:, 3:] = rotations.xyzw
+    return cls(vec7)
+
+  @classmethod
+  def from_matrices(cls, matrices: np.ndarray) -> 'Pose3Batch':
+    """Constructs a batch from an (N, 4, 4) array of homogeneous transforms."""
+    matrices = np.asarray(matrices, dtype=np.float64)
+    if matrices.ndim != 3 or matrices.shape[1:] != (4, 4):
+      raise ValueError(
+          'Homogeneous transforms must have shape (N, 4, 4), got %s.'
+          % (matrices.shape,)
+      )
+    return cls.from_translations_and_rotations(
+        matrices[:, :3, 3], Rotation3Batch.from_matrices(matrices[:, :3, :3])
+    )
@@ -0,0 +1,138 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+// Operations on Pose3Batch arrays in C++ (see pose3_batch.py).
+//
+// The operations read the rows of the given C-contiguous (N, 7) float64
+// arrays in place with Eigen::Map and write their results into arrays
+// allocated by numpy, so no intermediate copy of a batch is made. Note that
+// intrinsic::Pose3d pads its translation, so a vec7 row cannot be cast to a
+// Pose3d directly.
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <cstddef>
+
+#include "absl/strings/str_cat.h"
+#include "intrinsic/eigenmath/types.h"
+#include "intrinsic/math/pose3.h"
+
+namespace intrinsic {
+namespace {
+
+namespace py = pybind11;
+
+using DoubleArray =
+    py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+constexpr py::ssize_t kPoseWidth = 7;
+constexpr py::ssize_t kPointWidth = 3;
+
+// Returns the number of rows of `array`, which must have shape (N, width).
+py::ssize_t NumRows(const DoubleArray& array, py::ssize_t width,
+                    const char* name) {
+  if (array.ndim() != 2 || array.shape(1) != width) {
+    throw py::value_error(absl::StrCat(name, " must have shape (N, ", width,
+                                       "), got ", array.ndim(), " dims"));
+  }
+  return array.shape(0);
+}
+
+// Returns the size of the result of broadcasting rows of sizes `a` and `b`.
+py::ssize_t BroadcastRows(py::ssize_t a, py::ssize_t b) {
+  if (a != b && a != 1 && b != 1) {
+    throw py::value_error(absl::StrCat(
+        "Batches of different sizes cannot be combined: ", a, " and ", b));
+  }
+  return a == 1 ? b : a;
+}
+
+// Returns the pose of the vec7 row at `row`.
+Pose3d PoseAt(const double* row) {
+  return Pose3d(
+      eigenmath::Quaterniond(Eigen::Map<const Eigen::Quaterniond>(row + 3)),
+      eigenmath::Vector3d(Eigen::Map<const eigenmath::Vector3d>(row)));
+}
+
+// Writes `pose` to the vec7 row at `row`.
+void SetPoseAt(const Pose3d& pose, double* row) {
+  Eigen::Map<eigenmath::Vector3d> translation(row);
+  Eigen::Map<Eigen::Quaterniond> quaternion(row + 3);
+  translation = pose.translation();
+  quaternion = pose.quaternion();
+}
+
+// Returns a_poses_b * b_poses_c, broadcasting a single pose on either side.
+DoubleArray Multiply(const DoubleArray& a_poses_b,
+                     const DoubleArray& b_poses_c) {
+  const py::ssize_t size =
+      BroadcastRows(NumRows(a_poses_b, kPoseWidth, "a_poses_b"),
+                    NumRows(b_poses_c, kPoseWidth, "b_poses_c"));
+  DoubleArray result({size, kPoseWidth});
+  const double* lhs = a_poses_b.data();
+  const double* rhs = b_poses_c.data();
+  double* out = result.mutable_data();
+  const py::ssize_t lhs_step = a_poses_b.shape(0) == 1 ? 0 : kPoseWidth;
+  const py::ssize_t rhs_step = b_poses_c.shape(0) == 1 ? 0 : kPoseWidth;
+  {
+    py::gil_scoped_release release;
+    for (py::ssize_t i = 0; i < size; ++i) {
+      SetPoseAt(PoseAt(lhs + i * lhs_step) * PoseAt(rhs + i * rhs_step),
+                out + i * kPoseWidth);
+    }
+  }
+  return result;
+}
+
+// Returns the inverse of each pose.
+DoubleArray Inverse(const DoubleArray& a_poses_b) {
+  const py::ssize_t size = NumRows(a_poses_b, kPoseWidth, "a_poses_b");
+  DoubleArray result({size, kPoseWidth});
+  const double* in = a_poses_b.data();
+  double* out = result.mutable_data();
+  {
+    py::gil_scoped_release release;
+    for (py::ssize_t i = 0; i < size; ++i) {
+      SetPoseAt(PoseAt(in + i * kPoseWidth).inverse(), out + i * kPoseWidth);
+    }
+  }
+  return result;
+}
+
+// Returns a_poses_b * b_points, broadcasting a single pose or point.
+DoubleArray TransformPoints(const DoubleArray& a_poses_b,
+                            const DoubleArray& b_points) {
+  const py::ssize_t size =
+      BroadcastRows(NumRows(a_poses_b, kPoseWidth, "a_poses_b"),
+                    NumRows(b_points, kPointWidth, "b_points"));
+  DoubleArray result({size, kPointWidth});
+  const double* poses = a_poses_b.data();
+  const double* points = b_points.data();
+  double* out = result.mutable_data();
+  const py::ssize_t pose_step = a_poses_b.shape(0) == 1 ? 0 : kPoseWidth;
+  const py::ssize_t point_step = b_points.shape(0) == 1 ? 0 : kPointWidth;
+  {
+    py::gil_scoped_release release;
+    for (py::ssize_t i = 0; i < size; ++i) {
+      Eigen::Map<const eigenmath::Vector3d> point(points + i * point_step);
+      Eigen::Map<eigenmath::Vector3d> transformed(out + i * kPointWidth);
+      transformed = PoseAt(poses + i * pose_step) * point;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+PYBIND11_MODULE(pose3_batch_py, m) {
+  m.doc() = "Operations on (N, 7) arrays of vec7 poses in C++.";
+  m.def("multiply", &Multiply, py::arg("a_poses_b"), py::arg("b_poses_c"),
+        "Returns the products of two (N, 7) pose arrays.");
+  m.def("inverse", &Inverse, py::arg("a_poses_b"),
+        "Returns the inverses of an (N, 7) pose array.");
+  m.def("transform_points", &TransformPoints, py::arg("a_poses_b"),
+        py::arg("b_points"),
+        "Returns the (N, 3) points transformed by an (N, 7) pose array.");
+}
+
+}  // namespace intrinsic
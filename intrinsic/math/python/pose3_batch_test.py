@@ -0,0 +1,141 @@
+# Copyright 2023 Intrinsic Innovation LLC
+
+"""Tests for intrinsic.math.python.pose3_batch."""
+
+from absl.testing import absltest
+from intrinsic.math.python import math_test
+from intrinsic.math.python import pose3
+from intrinsic.math.python import pose3_batch
+import numpy as np
+
+_TEST_POSES = [pose for _, pose in math_test.make_named_poses()]
+_TEST_ROTATIONS = [rotation for _, rotation in math_test.make_named_rotations()]
+_TEST_POINTS = np.array(
+    [vector for _, vector in math_test.make_named_vectors()]
+)
+
+
+class Rotation3BatchTest(math_test.TestCase):
+
+  def test_from_rotations_and_getitem(self):
+    batch = pose3_batch.Rotation3Batch.from_rotations(_TEST_ROTATIONS)
+    self.assertLen(batch, len(_TEST_ROTATIONS))
+    for i, rotation in enumerate(_TEST_ROTATIONS):
+      self.assert_rotation_close(batch[i], rotation)
+    self.assertLen(batch[1:3], 2)
+
+  def test_inverse_and_multiply(self):
+    batch = pose3_batch.Rotation3Batch.from_rotations(_TEST_ROTATIONS)
+    inverse = batch.inverse()
+    products = batch * batch[::-1]
+    for i, rotation in enumerate(_TEST_ROTATIONS):
+      self.assert_rotation_close(inverse[i], rotation.inverse())
+      self.assert_rotation_close(
+          products[i], rotation * _TEST_ROTATIONS[-1 - i]
+      )
+
+  def test_rotate_points(self):
+    batch = pose3_batch.Rotation3Batch.from_rotations(_TEST_ROTATIONS)
+    for point in _TEST_POINTS:
+      rotated = batch.rotate_points(point)
+      for i, rotation in enumerate(_TEST_ROTATIONS):
+        self.assert_all_close(rotated[i], rotation.rotate_point(point))
+
+  def test_matrices_round_trip(self):
+    batch = pose3_batch.Rotation3Batch.from_rotations(_TEST_ROTATIONS)
+    matrices = batch.matrix3x3()
+    for i, rotation in enumerate(_TEST_ROTATIONS):
+      self.assert_all_close(matrices[i], rotation.matrix3x3())
+    round_trip = pose3_batch.Rotation3Batch.from_matrices(matrices)
+    for i, rotation in enumerate(_TEST_ROTATIONS):
+      self.assert_rotation_close(round_trip[i], rotation)
+
+  def test_invalid_shape(self):
+    with self.assertRaises(ValueError):
+      pose3_batch.Rotation3Batch(np.zeros((2, 3)))
+    identity = pose3_batch.Rotation3Batch.identity
+    with self.assertRaises(ValueError):
+      identity(2).multiply(identity(3))
+
+
+class Pose3BatchTest(math_test.TestCase):
+
+  def test_from_poses_and_getitem(self):
+    batch = pose3_batch.Pose3Batch.from_poses(_TEST_POSES)
+    self.assertLen(batch, len(_TEST_POSES))
+    self.assertEqual(batch.vec7.shape, (len(_TEST_POSES), 7))
+    for i, pose in enumerate(_TEST_POSES):
+      self.assert_pose_close(batch[i], pose)
+      self.assert_all_equal(batch.vec7[i], pose.vec7)
+
+  def test_views_share_memory(self):
+    vec7 = pose3_batch.Pose3Batch.identity(3).vec7.copy()
+    batch = pose3_batch.Pose3Batch(vec7)
+    self.assertTrue(np.shares_memory(batch.vec7, vec7))
+    self.assertTrue(np.shares_memory(batch.translations, vec7))
+    self.assertTrue(np.shares_memory(batch.rotations.xyzw, vec7))
+
+  def test_inverse(self):
+    batch = pose3_batch.Pose3Batch.from_poses(_TEST_POSES)
+    inverse = batch.inverse()
+    for i, pose in enumerate(_TEST_POSES):
+      self.assert_pose_close(inverse[i], pose.inverse())
+    identity = pose3_batch.Pose3Batch.identity(1)
+    self.assertTrue(np.all((batch * inverse).almost_equal(identity)))
+
+  def test_multiply(self):
+    batch = pose3_batch.Pose3Batch.from_poses(_TEST_POSES)
+    products = batch * batch[::-1]
+    for i, pose in enumerate(_TEST_POSES):
+      self.assert_pose_close(products[i], pose * _TEST_POSES[-1 - i])
+
+  def test_multiply_broadcasts(self):
+    batch = pose3_batch.Pose3Batch.from_poses(_TEST_POSES)
+    first = _TEST_POSES[0]
+    left = pose3_batch.Pose3Batch.from_poses([first]) * batch
+    right = batch * pose3_batch.Pose3Batch.from_poses([first])
+    for i, pose in enumerate(_TEST_POSES):
+      self.assert_pose_close(left[i], first * pose)
+      self.assert_pose_close(right[i], pose * first)
+
+  def test_transform_points(self):
+    batch = pose3_batch.Pose3Batch.from_poses(_TEST_POSES)
+    for point in _TEST_POINTS:
+      transformed = batch.transform_points(point)
+      for i, pose in enumerate(_TEST_POSES):
+        self.assert_all_close(transformed[i], pose.transform_point(point))
+
+  def test_matrices_round_trip(self):
+    batch = pose3_batch.Pose3Batch.from_poses(_TEST_POSES)
+    matrices = batch.matrix4x4()
+    for i, pose in enumerate(_TEST_POSES):
+      self.assert_all_close(matrices[i], pose.matrix4x4())
+    round_trip = pose3_batch.Pose3Batch.from_matrices(matrices)
+    self.assertTrue(np.all(round_trip.almost_equal(batch)))
+
+  def test_almost_equal_treats_negated_quaternions_as_equal(self):
+    vec7 = pose3_batch.Pose3Batch.from_poses(_TEST_POSES).vec7
+    negated = vec7.copy()
+    negated[:, 3:] *= -1.0
+    moved = vec7.copy()
+    moved[:, 0] += 1.0
+    batch = pose3_batch.Pose3Batch(vec7)
+    self.assertTrue(np.all(batch.almost_equal(pose3_batch.Pose3Batch(negated))))
+    self.assertFalse(np.any(batch.almost_equal(pose3_batch.Pose3Batch(moved))))
+
+  def test_from_translations_and_rotations(self):
+    rotation = _TEST_ROTATIONS[1]
+    batch = pose3_batch.Pose3Batch.from_translations_and_rotations(
+        _TEST_POINTS,
+        pose3_batch.Rotation3Batch.from_rotations([rotation]),
+    )
+    for i, point in enumerate(_TEST_POINTS):
+      self.assert_pose_close(batch[i], pose3.Pose3(rotation, point))
+
+  def test_invalid_shape(self):
+    with self.assertRaises(ValueError):
+      pose3_batch.Pose3Batch(np.zeros((2, 6)))
+
+
+if __name__ == '__main__':
+  absltest.main()
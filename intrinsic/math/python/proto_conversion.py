@@ -3,6 +3,7 @@
 """Converters from intrinsic math protos to commonly used in-memory representations."""
 
 import sys
+from typing import Iterable, MutableSequence, Optional
 
 from intrinsic.icon.proto import cart_space_pb2
 from intrinsic.math.proto import array_pb2
@@ -12,6 +13,8 @@ from intrinsic.math.proto import pose_pb2
 from intrinsic.math.proto import quaternion_pb2
 from intrinsic.math.proto import vector3_pb2
 from intrinsic.math.python import data_types
+from intrinsic.math.python import math_types
+from intrinsic.math.python import pose3_batch
 import numpy as np
 
 
@@ -188,6 +191,94 @@ def pose_to_proto(pose: data_types.Pose3) -> pose_pb2.Pose:
   return msg
 
 
+def pose_batch_from_protos(
+    pose_protos: Iterable[pose_pb2.Pose],
+) -> pose3_batch.Pose3Batch:
+  """Converts pose protos, e.g., a repeated field, to a Pose3Batch.
+
+  Reads all fields into one flat list, which numpy converts in a single call,
+  instead of creating a Pose3 per proto.
+
+  Args:
+    pose_protos: The poses as protos.
+
+  Returns:
+    The poses as Pose3Batch.
+
+  Raises:
+    ValueError: If a quaternion is not normalized.
+  """
+  values = []
+  for pose_proto in pose_protos:
+    position = pose_proto.position
+    orientation = pose_proto.orientation
+    values.extend((
+        position.x,
+        position.y,
+        position.z,
+        orientation.x,
+        orientation.y,
+        orientation.z,
+        orientation.w,
+    ))
+  vec7 = np.array(values, dtype=np.float64).reshape(-1, 7)
+  # Like pose_from_proto(), expect normalized quaternions.
+  norms = np.linalg.norm(vec7[:, 3:], axis=1)
+  not_normalized = np.flatnonzero(
+      np.abs(1.0 - norms) > math_types.DEFAULT_RTOL_VALUE_FOR_NP_IS_CLOSE
+  )
+  if not_normalized.size:
+    raise ValueError(
+        f'Quaternion of pose {not_normalized[0]} is not normalized:'
+        f' {vec7[not_normalized[0], 3:]}.'
+    )
+  return pose3_batch.Pose3Batch(vec7)
+
+
+def pose_batch_to_protos(
+    batch: pose3_batch.Pose3Batch,
+    pose_protos: Optional[MutableSequence[pose_pb2.Pose]] = None,
+) -> MutableSequence[pose_pb2.Pose]:
+  """Converts a Pose3Batch to pose protos.
+
+  Converts the array to Python floats in a single call, and sets the fields
+  directly. Like pose_to_proto(), normalizes quaternions that are not already
+  normalized.
+
+  Args:
+    batch: The poses.
+    pose_protos: A repeated Pose field to append the poses to. If not given,
+      the poses are returned as a list.
+
+  Returns:
+    `pose_protos` if given, else a list of the poses as protos.
+  """
+  vec7 = batch.vec7
+  norms = np.linalg.norm(vec7[:, 3:], axis=1)
+  not_normalized = (
+      np.abs(1.0 - norms) > math_types.DEFAULT_RTOL_VALUE_FOR_NP_IS_CLOSE
+  )
+  if np.any(not_normalized):
+    vec7 = vec7.copy()
+    vec7[not_normalized, 3:] /= norms[not_normalized, np.newaxis]
+  if pose_protos is None:
+    pose_protos = [pose_pb2.Pose() for _ in range(len(batch))]
+    targets = pose_protos
+  else:
+    targets = [pose_protos.add() for _ in range(len(batch))]
+  for pose_proto, (tx, ty, tz, qx, qy, qz, qw) in zip(targets, vec7.tolist()):
+    position = pose_proto.position
+    position.x = tx
+    position.y = ty
+    position.z = tz
+    orientation = pose_proto.orientation
+    orientation.x = qx
+    orientation.y = qy
+    orientation.z = qz
+    orientation.w = qw
+  return pose_protos
+
+
 def wrench_from_proto(wrench: cart_space_pb2.Wrench) -> data_types.Wrench:
   return data_types.Wrench(
       [wrench.x, wrench.y, wrench.z], [wrench.rx, wrench.ry, wrench.rz]
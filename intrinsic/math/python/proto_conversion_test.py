@@ -214,6 +214,77 @@ class ProtoConversionTest(parameterized.TestCase):
     # We expect bit-wise equality
     self.assertEqual(result_proto, pose_proto)
 
+  def test_pose_batch_from_protos(self):
+    poses = [
+        data_types.Pose3(
+            translation=np.random.randn(3),
+            rotation=data_types.Rotation3.random(),
+        )
+        for _ in range(5)
+    ]
+    pose_protos = [proto_conversion.pose_to_proto(pose) for pose in poses]
+    batch = proto_conversion.pose_batch_from_protos(pose_protos)
+    self.assertLen(batch, len(poses))
+    for i, pose_proto in enumerate(pose_protos):
+      self.assertEqual(batch[i], proto_conversion.pose_from_proto(pose_proto))
+
+  def test_pose_batch_from_protos_empty(self):
+    batch = proto_conversion.pose_batch_from_protos([])
+    self.assertEqual(batch.vec7.shape, (0, 7))
+
+  def test_pose_batch_from_protos_fails_for_non_unit_quaternions(self):
+    pose_protos = [
+        pose_pb2.Pose(orientation=quaternion_pb2.Quaternion(w=1.0)),
+        pose_pb2.Pose(
+            orientation=quaternion_pb2.Quaternion(x=0.4, y=0.5, z=0.6, w=0.7)
+        ),
+    ]
+    with self.assertRaises(ValueError):
+      proto_conversion.pose_batch_from_protos(pose_protos)
+
+  def test_pose_batch_to_protos(self):
+    vec7 = np.array([
+        [1.0, 2.0, 3.0, 0.5, -0.5, 0.5, -0.5],
+        [4.0, 5.0, 6.0, 0.0, 0.0, 0.0, 1.1],
+    ])
+    pose_protos = proto_conversion.pose_batch_to_protos(
+        data_types.Pose3Batch(vec7)
+    )
+    self.assertEqual(
+        pose_protos,
+        [
+            pose_pb2.Pose(
+                position=point_pb2.Point(x=1, y=2, z=3),
+                orientation=quaternion_pb2.Quaternion(
+                    x=0.5, y=-0.5, z=0.5, w=-0.5
+                ),
+            ),
+            pose_pb2.Pose(
+                position=point_pb2.Point(x=4, y=5, z=6),
+                orientation=quaternion_pb2.Quaternion(x=0, y=0, z=0, w=1),
+            ),
+        ],
+    )
+    # The batch itself is not normalized in place.
+    self.assertEqual(vec7[1, 6], 1.1)
+
+  def test_pose_batch_roundtrip(self):
+    pose_protos = [
+        pose_pb2.Pose(
+            position=point_pb2.Point(
+                x=-1.32635246, y=-0.20890486, z=-0.16996824
+            ),
+            orientation=quaternion_pb2.Quaternion(
+                x=-0.53663178, y=-0.49717722, z=0.24928427, w=-0.6345853
+            ),
+        )
+    ] * 3
+    result_protos = proto_conversion.pose_batch_to_protos(
+        proto_conversion.pose_batch_from_protos(pose_protos)
+    )
+    # We expect bit-wise equality
+    self.assertEqual(result_protos, pose_protos)
+
   def test_wrench_from_proto(self):
     wrench_proto = cart_space_pb2.Wrench(x=1, y=2, z=3, rx=4, ry=5, rz=6)
 
@@ -2,9 +2,61 @@
 
 #include "intrinsic/math/transform_utils.h"
 
+#include <algorithm>
+#include <cstddef>
+
+#include "Eigen/Core"
+#include "absl/log/check.h"
+#include "absl/types/span.h"
+#include "intrinsic/eigenmath/types.h"
 #include "intrinsic/math/pose3.h"
+#include "intrinsic/math/twist.h"
 
 namespace intrinsic {
+namespace {
+
+// The number of points transformed at a time. Blocks are small enough for
+// their intermediate results to stay on the stack and in cache.
+constexpr Eigen::Index kBlockSize = 256;
+
+// Points are densely packed, so that a span of them can be mapped to a 3xN
+// matrix.
+static_assert(sizeof(eigenmath::Vector3d) == 3 * sizeof(double));
+
+// Same for twists and wrenches and 6xN matrices.
+static_assert(sizeof(Twist) == 6 * sizeof(double));
+static_assert(sizeof(Wrench) == 6 * sizeof(double));
+
+// Returns the skew-symmetric matrix [v]x, for which [v]x * u = v.cross(u).
+eigenmath::Matrix3d CrossProductMatrix(const eigenmath::Vector3d& v) {
+  eigenmath::Matrix3d m;
+  m << 0, -v.z(), v.y(),  //
+      v.z(), 0, -v.x(),   //
+      -v.y(), v.x(), 0;
+  return m;
+}
+
+// Sets out[i] = matrix * in[i] for 6-vectors, a block of vectors at a time.
+template <typename VectorT>
+void TransformMany(const eigenmath::Matrix6d& matrix,
+                   absl::Span<const VectorT> in, absl::Span<VectorT> out) {
+  CHECK_EQ(in.size(), out.size());
+  const Eigen::Index size = static_cast<Eigen::Index>(in.size());
+  Eigen::Matrix<double, 6, Eigen::Dynamic, Eigen::ColMajor, 6, kBlockSize>
+      transformed;
+  for (Eigen::Index begin = 0; begin < size; begin += kBlockSize) {
+    const Eigen::Index n = std::min(kBlockSize, size - begin);
+    Eigen::Map<const Eigen::Matrix<double, 6, Eigen::Dynamic>> b(
+        in[begin].data(), 6, n);
+    Eigen::Map<Eigen::Matrix<double, 6, Eigen::Dynamic>> a(out[begin].data(),
+                                                           6, n);
+    // Transform into a separate block first, since a and b may be the same.
+    transformed.noalias() = matrix * b;
+    a = transformed;
+  }
+}
+
+}  // namespace
 
 Wrench TransformWrench(const Pose3d& a_T_b, const Wrench& b_W) {
   Wrench a_W;
@@ -14,4 +66,100 @@ Wrench TransformWrench(const Pose3d& a_T_b, const Wrench& b_W) {
   return Wrench(a_W);
 }
 
+PoseAdjoint::PoseAdjoint(const Pose3d& a_T_b) {
+  const eigenmath::Matrix3d a_R_b = a_T_b.rotationMatrix();
+  const eigenmath::Matrix3d t_cross_R =
+      CrossProductMatrix(a_T_b.translation()) * a_R_b;
+  twist_matrix_.topLeftCorner<3, 3>() = a_R_b;
+  twist_matrix_.topRightCorner<3, 3>() = t_cross_R;
+  twist_matrix_.bottomLeftCorner<3, 3>().setZero();
+  twist_matrix_.bottomRightCorner<3, 3>() = a_R_b;
+  wrench_matrix_.topLeftCorner<3, 3>() = a_R_b;
+  wrench_matrix_.topRightCorner<3, 3>().setZero();
+  wrench_matrix_.bottomLeftCorner<3, 3>() = t_cross_R;
+  wrench_matrix_.bottomRightCorner<3, 3>() = a_R_b;
+}
+
+Twist PoseAdjoint::TransformTwist(const Twist& b_V) const {
+  return Twist(twist_matrix_ * b_V);
+}
+
+Wrench PoseAdjoint::TransformWrench(const Wrench& b_W) const {
+  return Wrench(wrench_matrix_ * b_W);
+}
+
+void PoseAdjoint::TransformTwists(absl::Span<const Twist> b_V,
+                                  absl::Span<Twist> a_V) const {
+  TransformMany(twist_matrix_, b_V, a_V);
+}
+
+void PoseAdjoint::TransformWrenches(absl::Span<const Wrench> b_W,
+                                    absl::Span<Wrench> a_W) const {
+  TransformMany(wrench_matrix_, b_W, a_W);
+}
+
+void TransformPoints(const Pose3d& a_T_b,
+                     absl::Span<const eigenmath::Vector3d> b_points,
+                     absl::Span<eigenmath::Vector3d> a_points) {
+  CHECK_EQ(b_points.size(), a_points.size());
+  const eigenmath::Matrix3d a_R_b = a_T_b.rotationMatrix();
+  const eigenmath::Vector3d& a_t_b = a_T_b.translation();
+  const Eigen::Index size = static_cast<Eigen::Index>(b_points.size());
+  Eigen::Matrix<double, 3, Eigen::Dynamic, Eigen::ColMajor, 3, kBlockSize>
+      rotated;
+  for (Eigen::Index begin = 0; begin < size; begin += kBlockSize) {
+    const Eigen::Index n = std::min(kBlockSize, size - begin);
+    Eigen::Map<const Eigen::Matrix3Xd> b(b_points[begin].data(), 3, n);
+    Eigen::Map<Eigen::Matrix3Xd> a(a_points[begin].data(), 3, n);
+    // Rotate into a separate block first, since a and b may be the same.
+    rotated.noalias() = a_R_b * b;
+    a = rotated.colwise() + a_t_b;
+  }
+}
+
+void TransformPoints(const Pose3d& a_T_b, absl::Span<double> x,
+                     absl::Span<double> y, absl::Span<double> z) {
+  CHECK_EQ(x.size(), y.size());
+  CHECK_EQ(x.size(), z.size());
+  const eigenmath::Matrix3d a_R_b = a_T_b.rotationMatrix();
+  const eigenmath::Vector3d& a_t_b = a_T_b.translation();
+  const Eigen::Index size = static_cast<Eigen::Index>(x.size());
+  using Block = Eigen::Array<double, Eigen::Dynamic, 1, Eigen::ColMajor,
+                             kBlockSize, 1>;
+  for (Eigen::Index begin = 0; begin < size; begin += kBlockSize) {
+    const Eigen::Index n = std::min(kBlockSize, size - begin);
+    Eigen::Map<Eigen::ArrayXd> a_x(x.data() + begin, n);
+    Eigen::Map<Eigen::ArrayXd> a_y(y.data() + begin, n);
+    Eigen::Map<Eigen::ArrayXd> a_z(z.data() + begin, n);
+    const Block b_x = a_x;
+    const Block b_y = a_y;
+    const Block b_z = a_z;
+    a_x = a_R_b(0, 0) * b_x + a_R_b(0, 1) * b_y + a_R_b(0, 2) * b_z + a_t_b.x();
+    a_y = a_R_b(1, 0) * b_x + a_R_b(1, 1) * b_y + a_R_b(1, 2) * b_z + a_t_b.y();
+    a_z = a_R_b(2, 0) * b_x + a_R_b(2, 1) * b_y + a_R_b(2, 2) * b_z + a_t_b.z();
+  }
+}
+
+void ComposeMany(absl::Span<const Pose3d> a_T_b, absl::Span<const Pose3d> b_T_c,
+                 absl::Span<Pose3d> a_T_c) {
+  CHECK_EQ(a_T_b.size(), b_T_c.size());
+  CHECK_EQ(a_T_b.size(), a_T_c.size());
+  for (size_t i = 0; i < a_T_b.size(); ++i) {
+    a_T_c[i] = a_T_b[i] * b_T_c[i];
+  }
+}
+
+void ComposeMany(const Pose3d& a_T_b, absl::Span<const Pose3d> b_T_c,
+                 absl::Span<Pose3d> a_T_c) {
+  CHECK_EQ(b_T_c.size(), a_T_c.size());
+  // The translations only need the rotation of a_T_b, which is cheaper to
+  // apply as a matrix than as a quaternion.
+  const eigenmath::Matrix3d a_R_b = a_T_b.rotationMatrix();
+  for (size_t i = 0; i < b_T_c.size(); ++i) {
+    const eigenmath::Vector3d a_t_c =
+        a_T_b.translation() + a_R_b * b_T_c[i].translation();
+    a_T_c[i] = Pose3d(a_T_b.so3() * b_T_c[i].so3(), a_t_c);
+  }
+}
+
 }  // namespace intrinsic
@@ -3,6 +3,8 @@
 #ifndef INTRINSIC_MATH_TRANSFORM_UTILS_H_
 #define INTRINSIC_MATH_TRANSFORM_UTILS_H_
 
+#include "absl/types/span.h"
+#include "intrinsic/eigenmath/types.h"
 #include "intrinsic/math/pose3.h"
 #include "intrinsic/math/twist.h"
 
@@ -20,6 +22,112 @@ namespace intrinsic {
  */
 Wrench TransformWrench(const Pose3d& a_T_b, const Wrench& b_W);
 
+/**
+ * The adjoint of a pose a_T_b, for transforming many twists and wrenches from
+ * frame B to frame A. The 6x6 matrices that do so are computed once, when the
+ * PoseAdjoint is created, so that each transformation is a single
+ * matrix-vector product. Use it wherever several twists or wrenches are
+ * transformed with the same pose, e.g., in every control cycle.
+ *
+ * Twists are (vx,vy,vz,wx,wy,wz) and wrenches are (fx,fy,fz,tx,ty,tz), both
+ * at the origin of their frame and expressed in its coordinates.
+ *
+ * All functions are real-time safe.
+ */
+class PoseAdjoint {
+ public:
+  /**
+   * @param a_T_b the position and orientation of B relative to A
+   */
+  explicit PoseAdjoint(const Pose3d& a_T_b);
+
+  /**
+   * The matrix that maps a twist in B to the same twist in A, i.e.
+   * [R, [t]x R; 0, R].
+   */
+  const eigenmath::Matrix6d& twist_matrix() const { return twist_matrix_; }
+
+  /**
+   * The matrix that maps a wrench in B to the same wrench in A, i.e.
+   * [R, 0; [t]x R, R]. Same as TransformWrench(a_T_b, b_W).
+   */
+  const eigenmath::Matrix6d& wrench_matrix() const { return wrench_matrix_; }
+
+  Twist TransformTwist(const Twist& b_V) const;
+  Wrench TransformWrench(const Wrench& b_W) const;
+
+  /**
+   * Transforms many twists from frame B to frame A.
+   *
+   * @param b_V   twists expressed in B coordinates.
+   * @param a_V   receives the same twists expressed in A coordinates. Must
+   *              have the same size as b_V, and may be the same span.
+   */
+  void TransformTwists(absl::Span<const Twist> b_V,
+                       absl::Span<Twist> a_V) const;
+
+  /**
+   * Transforms many wrenches from frame B to frame A.
+   *
+   * @param b_W   wrenches expressed in B coordinates.
+   * @param a_W   receives the same wrenches expressed in A coordinates. Must
+   *              have the same size as b_W, and may be the same span.
+   */
+  void TransformWrenches(absl::Span<const Wrench> b_W,
+                         absl::Span<Wrench> a_W) const;
+
+ private:
+  eigenmath::Matrix6d twist_matrix_;
+  eigenmath::Matrix6d wrench_matrix_;
+};
+
+/**
+ * Transforms many points from frame B to frame A, i.e. a_points[i] = a_T_b *
+ * b_points[i]. The rotation is converted to a matrix once and applied to
+ * blocks of points at a time, which is much faster than transforming the
+ * points one by one.
+ *
+ * @param a_T_b    the position and orientation of B relative to A
+ * @param b_points points expressed in B coordinates.
+ * @param a_points receives the same points expressed in A coordinates. Must
+ *                 have the same size as b_points, and may be the same span.
+ */
+void TransformPoints(const Pose3d& a_T_b,
+                     absl::Span<const eigenmath::Vector3d> b_points,
+                     absl::Span<eigenmath::Vector3d> a_points);
+
+/**
+ * Same as above, for points stored as separate arrays of coordinates, which
+ * are transformed in place from frame B to frame A.
+ *
+ * @param a_T_b the position and orientation of B relative to A
+ * @param x, y, z coordinates of the points, all of the same size.
+ */
+void TransformPoints(const Pose3d& a_T_b, absl::Span<double> x,
+                     absl::Span<double> y, absl::Span<double> z);
+
+/**
+ * Composes poses pairwise, i.e. a_T_c[i] = a_T_b[i] * b_T_c[i].
+ *
+ * @param a_T_b, b_T_c poses of the same size.
+ * @param a_T_c receives the composed poses. Must have the same size as the
+ *              inputs, and may be the same span as either of them.
+ */
+void ComposeMany(absl::Span<const Pose3d> a_T_b, absl::Span<const Pose3d> b_T_c,
+                 absl::Span<Pose3d> a_T_c);
+
+/**
+ * Composes a single pose with many poses, i.e. a_T_c[i] = a_T_b * b_T_c[i],
+ * e.g. to express many frames of B in the frame A.
+ *
+ * @param a_T_b the position and orientation of B relative to A
+ * @param b_T_c poses expressed in B coordinates.
+ * @param a_T_c receives the composed poses. Must have the same size as b_T_c,
+ *              and may be the same span.
+ */
+void ComposeMany(const Pose3d& a_T_b, absl::Span<const Pose3d> b_T_c,
+                 absl::Span<Pose3d> a_T_c);
+
 }  // namespace intrinsic
 
 #endif  // INTRINSIC_MATH_TRANSFORM_UTILS_H_
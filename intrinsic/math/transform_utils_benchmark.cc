@@ -0,0 +1,102 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+// Compares transforming twists and wrenches one at a time with a pose to
+// transforming them with a PoseAdjoint.
+//
+// Run with:
+//   bazel run -c opt //intrinsic/math:transform_utils_benchmark
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "intrinsic/eigenmath/types.h"
+#include "intrinsic/math/pose3.h"
+#include "intrinsic/math/transform_utils.h"
+#include "intrinsic/math/twist.h"
+
+namespace intrinsic {
+namespace {
+
+Pose3d RandomPose(std::mt19937& rng) {
+  std::normal_distribution<double> normal;
+  return Pose3d(eigenmath::Quaterniond(normal(rng), normal(rng), normal(rng),
+                                       normal(rng))
+                    .normalized(),
+                eigenmath::Vector3d(normal(rng), normal(rng), normal(rng)));
+}
+
+template <typename VectorT>
+std::vector<VectorT> RandomVectors(std::mt19937& rng, size_t size) {
+  std::normal_distribution<double> normal;
+  std::vector<VectorT> vectors;
+  for (size_t i = 0; i < size; ++i) {
+    vectors.emplace_back(normal(rng), normal(rng), normal(rng), normal(rng),
+                         normal(rng), normal(rng));
+  }
+  return vectors;
+}
+
+void BM_TransformWrench(benchmark::State& state) {
+  std::mt19937 rng(1);
+  const Pose3d a_T_b = RandomPose(rng);
+  const std::vector<Wrench> b_W = RandomVectors<Wrench>(rng, state.range(0));
+  std::vector<Wrench> a_W(b_W.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < b_W.size(); ++i) {
+      a_W[i] = TransformWrench(a_T_b, b_W[i]);
+    }
+    benchmark::DoNotOptimize(a_W.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformWrench)->Arg(1)->Arg(8)->Arg(64)->Arg(1024);
+
+void BM_PoseAdjointTransformWrench(benchmark::State& state) {
+  std::mt19937 rng(1);
+  const Pose3d a_T_b = RandomPose(rng);
+  const std::vector<Wrench> b_W = RandomVectors<Wrench>(rng, state.range(0));
+  std::vector<Wrench> a_W(b_W.size());
+  for (auto _ : state) {
+    // Includes computing the adjoint, as if the pose changed every cycle.
+    const PoseAdjoint a_Ad_b(a_T_b);
+    for (size_t i = 0; i < b_W.size(); ++i) {
+      a_W[i] = a_Ad_b.TransformWrench(b_W[i]);
+    }
+    benchmark::DoNotOptimize(a_W.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PoseAdjointTransformWrench)->Arg(1)->Arg(8)->Arg(64)->Arg(1024);
+
+void BM_PoseAdjointTransformWrenches(benchmark::State& state) {
+  std::mt19937 rng(1);
+  const Pose3d a_T_b = RandomPose(rng);
+  const std::vector<Wrench> b_W = RandomVectors<Wrench>(rng, state.range(0));
+  std::vector<Wrench> a_W(b_W.size());
+  for (auto _ : state) {
+    const PoseAdjoint a_Ad_b(a_T_b);
+    a_Ad_b.TransformWrenches(b_W, absl::MakeSpan(a_W));
+    benchmark::DoNotOptimize(a_W.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PoseAdjointTransformWrenches)->Arg(1)->Arg(8)->Arg(64)->Arg(1024);
+
+void BM_PoseAdjointTransformTwists(benchmark::State& state) {
+  std::mt19937 rng(1);
+  const PoseAdjoint a_Ad_b(RandomPose(rng));
+  const std::vector<Twist> b_V = RandomVectors<Twist>(rng, state.range(0));
+  std::vector<Twist> a_V(b_V.size());
+  for (auto _ : state) {
+    a_Ad_b.TransformTwists(b_V, absl::MakeSpan(a_V));
+    benchmark::DoNotOptimize(a_V.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PoseAdjointTransformTwists)->Arg(1)->Arg(8)->Arg(64)->Arg(1024);
+
+}  // namespace
+}  // namespace intrinsic
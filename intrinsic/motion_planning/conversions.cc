@@ -4,6 +4,7 @@
 
 #include <vector>
 
+#include "absl/types/span.h"
 #include "intrinsic/util/eigen.h"
 
 namespace intrinsic {
@@ -20,7 +21,7 @@ std::vector<eigenmath::VectorXd> ToVectorXds(
 }
 
 void ToJointVecs(
-    const std::vector<eigenmath::VectorXd>& path,
+    absl::Span<const eigenmath::VectorXd> path,
     google::protobuf::RepeatedPtrField<intrinsic_proto::icon::JointVec>*
         vectors) {
   vectors->Clear();
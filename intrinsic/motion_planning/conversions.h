@@ -5,6 +5,7 @@
 
 #include <vector>
 
+#include "absl/types/span.h"
 #include "google/protobuf/repeated_field.h"
 #include "intrinsic/eigenmath/types.h"
 #include "intrinsic/icon/proto/joint_space.pb.h"
@@ -16,7 +17,7 @@ std::vector<eigenmath::VectorXd> ToVectorXds(
         vectors);
 // Clears any data currently in vectors.
 void ToJointVecs(
-    const std::vector<eigenmath::VectorXd>& path,
+    absl::Span<const eigenmath::VectorXd> path,
     google::protobuf::RepeatedPtrField<intrinsic_proto::icon::JointVec>*
         vectors);
 
@@ -2,16 +2,32 @@
 
 #include "intrinsic/motion_planning/motion_planner_client.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
 #include <memory>
 #include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "google/protobuf/duration.pb.h"
 #include "google/protobuf/empty.pb.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "grpcpp/client_context.h"
 #include "intrinsic/eigenmath/types.h"
 #include "intrinsic/icon/proto/joint_space.pb.h"
@@ -23,6 +39,9 @@
 #include "intrinsic/motion_planning/proto/motion_planner_service.pb.h"
 #include "intrinsic/motion_planning/proto/motion_target.pb.h"
 #include "intrinsic/util/eigen.h"
+#include "intrinsic/util/grpc/channel.h"
+#include "intrinsic/util/grpc/connection_params.h"
+#include "intrinsic/util/proto_time.h"
 #include "intrinsic/util/status/status_conversion_grpc.h"
 #include "intrinsic/util/status/status_macros.h"
 #include "intrinsic/world/objects/kinematic_object.h"
@@ -30,6 +49,276 @@
 namespace intrinsic {
 namespace motion_planning {
 
+namespace {
+
+// Full names of the methods that use a CallPolicy.
+constexpr char kPlanTrajectoryMethod[] =
+    "/intrinsic_proto.motion_planning.MotionPlannerService/PlanTrajectory";
+constexpr char kComputeIkMethod[] =
+    "/intrinsic_proto.motion_planning.MotionPlannerService/ComputeIk";
+constexpr char kComputeFkMethod[] =
+    "/intrinsic_proto.motion_planning.MotionPlannerService/ComputeFk";
+constexpr char kCheckCollisionsMethod[] =
+    "/intrinsic_proto.motion_planning.MotionPlannerService/CheckCollisions";
+
+intrinsic_proto::motion_planning::IkRequest MakeIkRequest(
+    const world::KinematicObject& robot,
+    const intrinsic_proto::world::geometric_constraints::GeometricConstraint&
+        geometric_target,
+    const MotionPlannerClient::IkOptions& options,
+    const std::string& world_id) {
+  intrinsic_proto::motion_planning::IkRequest request;
+  request.set_world_id(world_id);
+  request.mutable_robot_reference()->mutable_object_id()->set_id(
+      robot.Id().value());
+
+  *request.mutable_target() = geometric_target;
+
+  if (options.starting_joints.size() > 0) {
+    VectorXdToRepeatedDouble(
+        options.starting_joints,
+        request.mutable_starting_joints()->mutable_joints());
+  }
+
+  if (options.max_num_solutions.has_value()) {
+    request.set_max_num_solutions(*options.max_num_solutions);
+  }
+
+  if (options.collision_settings.has_value()) {
+    *request.mutable_collision_settings() = *options.collision_settings;
+  }
+
+  request.set_ensure_same_branch(options.ensure_same_branch);
+
+  request.set_prefer_same_branch(options.prefer_same_branch);
+  return request;
+}
+
+intrinsic_proto::motion_planning::FkRequest MakeFkRequest(
+    const world::KinematicObject& robot,
+    const eigenmath::VectorXd& joint_values,
+    const intrinsic_proto::world::TransformNodeReference& reference,
+    const intrinsic_proto::world::TransformNodeReference& target,
+    const std::string& world_id) {
+  intrinsic_proto::motion_planning::FkRequest request;
+  request.set_world_id(world_id);
+  request.mutable_robot_reference()->mutable_object_id()->set_id(
+      robot.Id().value());
+  VectorXdToRepeatedDouble(joint_values,
+                           request.mutable_joints()->mutable_joints());
+
+  *request.mutable_reference() = reference;
+  *request.mutable_target() = target;
+  return request;
+}
+
+MotionPlannerClient::PlanTrajectoryResult ToPlanTrajectoryResult(
+    const intrinsic_proto::motion_planning::TrajectoryPlanningResponse&
+        response) {
+  MotionPlannerClient::PlanTrajectoryResult result;
+  result.trajectory = response.discretized();
+  result.swept_volume.insert(result.swept_volume.begin(),
+                             response.swept_volume().begin(),
+                             response.swept_volume().end());
+  result.lock_motion_id = response.has_lock_motion_id()
+                              ? std::optional(response.lock_motion_id())
+                              : std::nullopt;
+
+  return result;
+}
+
+// Returns the cache key of a planning problem for the given world version.
+// The caller id and the logging context do not change the trajectory, so they
+// are not part of the key.
+std::string PlanCacheKey(
+    absl::string_view world_version,
+    intrinsic_proto::motion_planning::MotionPlanningRequest request) {
+  request.clear_caller_id();
+  request.clear_context();
+  std::string serialized;
+  {
+    google::protobuf::io::StringOutputStream stream(&serialized);
+    google::protobuf::io::CodedOutputStream coded_stream(&stream);
+    // Maps are serialized in a stable order, so equal requests have equal
+    // keys.
+    coded_stream.SetSerializationDeterministic(true);
+    request.SerializeToCodedStream(&coded_stream);
+  }
+  return absl::StrCat("plan:", world_version.size(), ":", world_version,
+                      serialized);
+}
+
+// Returns the cache key of the locked motion with the given id.
+std::string LockedMotionCacheKey(absl::string_view motion_id) {
+  return absl::StrCat("locked:", motion_id);
+}
+
+// Returns the time from the start to the end of the given trajectory.
+absl::Duration TrajectoryDuration(
+    const intrinsic_proto::icon::JointTrajectoryPVA& trajectory) {
+  if (trajectory.time_since_start().empty()) {
+    return absl::ZeroDuration();
+  }
+  return FromProto(*trajectory.time_since_start().rbegin());
+}
+
+absl::Status ValidateBatchOptions(
+    const MotionPlannerClient::BatchOptions& batch_options) {
+  if (batch_options.max_concurrent_requests <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("max_concurrent_requests must be positive, got ",
+                     batch_options.max_concurrent_requests));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ValidateChunkedCheckCollisionsOptions(
+    const MotionPlannerClient::ChunkedCheckCollisionsOptions& chunk_options) {
+  if (chunk_options.chunk_size < 2) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "chunk_size must be at least 2, got ", chunk_options.chunk_size));
+  }
+  if (chunk_options.max_concurrent_requests <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("max_concurrent_requests must be positive, got ",
+                     chunk_options.max_concurrent_requests));
+  }
+  return absl::OkStatus();
+}
+
+intrinsic_proto::motion_planning::CheckCollisionsRequest
+MakeCheckCollisionsRequest(
+    const world::KinematicObject& robot,
+    absl::Span<const eigenmath::VectorXd> waypoints,
+    const MotionPlannerClient::CheckCollisionsOptions& options,
+    const std::string& world_id) {
+  intrinsic_proto::motion_planning::CheckCollisionsRequest request;
+  request.set_world_id(world_id);
+  request.mutable_robot_reference()->mutable_object_id()->set_id(
+      robot.Id().value());
+  ToJointVecs(waypoints, request.mutable_waypoint());
+
+  if (options.collision_settings.has_value()) {
+    *request.mutable_collision_settings() = *options.collision_settings;
+  }
+  return request;
+}
+
+// Starts a call for each of `requests` with `start_call`, which must invoke its
+// last argument once the call has finished, keeping at most
+// `max_concurrent_calls` calls in flight. Passes the status and response of
+// each call to `on_done` as soon as the call has finished; calls of `on_done`
+// do not overlap. Returns once all calls have finished.
+template <typename Response, typename Request, typename StartCall,
+          typename OnDone>
+void CallConcurrently(absl::Span<const Request> requests,
+                      int max_concurrent_calls, StartCall start_call,
+                      OnDone on_done) {
+  std::vector<grpc::ClientContext> contexts(requests.size());
+  std::vector<Response> responses(requests.size());
+  absl::Mutex mutex;
+  int in_flight = 0;
+  const auto has_capacity = [&in_flight, max_concurrent_calls]() {
+    return in_flight < max_concurrent_calls;
+  };
+  absl::BlockingCounter pending(static_cast<int>(requests.size()));
+  for (size_t i = 0; i < requests.size(); ++i) {
+    {
+      absl::MutexLock lock(&mutex);
+      mutex.Await(absl::Condition(&has_capacity));
+      ++in_flight;
+    }
+    start_call(&contexts[i], &requests[i], &responses[i],
+               [&mutex, &in_flight, &pending, &responses, &on_done,
+                i](grpc::Status status) {
+                 {
+                   absl::MutexLock lock(&mutex);
+                   on_done(i, ToAbslStatus(status), std::move(responses[i]));
+                   --in_flight;
+                 }
+                 pending.DecrementCount();
+               });
+  }
+  pending.Wait();
+}
+
+}  // namespace
+
+// Planned trajectories, of which the least recently used are dropped first.
+class MotionPlannerClient::PlanCache {
+ public:
+  explicit PlanCache(PlanCacheOptions options) : options_(std::move(options)) {}
+
+  const PlanCacheOptions& options() const { return options_; }
+
+  // Returns the trajectory cached under `key`, if any, and marks it as
+  // recently used.
+  std::optional<PlanTrajectoryResult> Find(const std::string& key)
+      ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return std::nullopt;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->result;
+  }
+
+  // Caches `result` under `key`, dropping the least recently used trajectories
+  // as needed. Results larger than the whole cache are not cached.
+  void Insert(const std::string& key, const PlanTrajectoryResult& result)
+      ABSL_LOCKS_EXCLUDED(mutex_) {
+    size_t bytes = key.size() + result.trajectory.ByteSizeLong();
+    for (const intrinsic_proto::geometry::TransformedGeometryStorageRefs&
+             shape : result.swept_volume) {
+      bytes += shape.ByteSizeLong();
+    }
+    if (options_.max_entries == 0 || bytes > options_.max_bytes) {
+      return;
+    }
+    absl::MutexLock lock(&mutex_);
+    if (auto it = index_.find(key); it != index_.end()) {
+      Erase(it->second);
+    }
+    while (!entries_.empty() && (entries_.size() >= options_.max_entries ||
+                                 bytes_ + bytes > options_.max_bytes)) {
+      Erase(std::prev(entries_.end()));
+    }
+    entries_.push_front({.key = key, .result = result, .bytes = bytes});
+    index_[key] = entries_.begin();
+    bytes_ += bytes;
+  }
+
+  void Clear() ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    index_.clear();
+    entries_.clear();
+    bytes_ = 0;
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    PlanTrajectoryResult result;
+    size_t bytes;
+  };
+
+  void Erase(std::list<Entry>::iterator it)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    bytes_ -= it->bytes;
+    index_.erase(it->key);
+    entries_.erase(it);
+  }
+
+  const PlanCacheOptions options_;
+  absl::Mutex mutex_;
+  // Most recently used first.
+  std::list<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, std::list<Entry>::iterator> index_
+      ABSL_GUARDED_BY(mutex_);
+  size_t bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
 const MotionPlannerClient::MotionPlanningOptions&
 MotionPlannerClient::MotionPlanningOptions::Defaults() {
   static const auto* defaults = new MotionPlannerClient::MotionPlanningOptions({
@@ -41,6 +330,26 @@ MotionPlannerClient::MotionPlanningOptions::Defaults() {
   return *defaults;
 }
 
+const MotionPlannerClient::BatchOptions&
+MotionPlannerClient::BatchOptions::Defaults() {
+  static const auto* defaults = new MotionPlannerClient::BatchOptions({
+      .max_concurrent_requests = 16,
+  });
+
+  return *defaults;
+}
+
+const MotionPlannerClient::ChunkedCheckCollisionsOptions&
+MotionPlannerClient::ChunkedCheckCollisionsOptions::Defaults() {
+  static const auto* defaults =
+      new MotionPlannerClient::ChunkedCheckCollisionsOptions({
+          .chunk_size = 1000,
+          .max_concurrent_requests = 4,
+      });
+
+  return *defaults;
+}
+
 MotionPlannerClient::MotionPlannerClient(
     absl::string_view world_id,
     std::shared_ptr<
@@ -49,14 +358,24 @@ MotionPlannerClient::MotionPlannerClient(
     : world_id_(world_id),
       motion_planner_service_(std::move(motion_planner_service)) {}
 
-absl::StatusOr<MotionPlannerClient::PlanTrajectoryResult>
-MotionPlannerClient::PlanTrajectory(
+MotionPlannerClient::MotionPlannerClient(
+    absl::string_view world_id,
+    std::shared_ptr<
+        intrinsic_proto::motion_planning::MotionPlannerService::StubInterface>
+        motion_planner_service,
+    PlanCacheOptions plan_cache_options)
+    : world_id_(world_id),
+      motion_planner_service_(std::move(motion_planner_service)),
+      plan_cache_(std::make_shared<PlanCache>(std::move(plan_cache_options))) {}
+
+intrinsic_proto::motion_planning::MotionPlanningRequest
+MotionPlannerClient::MakeMotionPlanningRequest(
     const intrinsic_proto::motion_planning::RobotSpecification&
         robot_specification,
     const intrinsic_proto::motion_planning::MotionSpecification&
         motion_specification,
     const MotionPlanningOptions& options, const std::string& caller_id,
-    const intrinsic_proto::data_logger::Context& context) {
+    const intrinsic_proto::data_logger::Context& context) const {
   intrinsic_proto::motion_planning::MotionPlanningRequest request;
   *request.mutable_robot_specification() = robot_specification;
   *request.mutable_motion_specification() = motion_specification;
@@ -74,24 +393,220 @@ MotionPlannerClient::PlanTrajectory(
   }
   request.set_caller_id(caller_id);
   *request.mutable_context() = context;
+  return request;
+}
 
-  intrinsic_proto::motion_planning::TrajectoryPlanningResponse response;
-  grpc::ClientContext ctx;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(
-      motion_planner_service_->PlanTrajectory(&ctx, request, &response)));
-
-  MotionPlannerClient::PlanTrajectoryResult result;
-  result.trajectory = response.discretized();
-  result.swept_volume.insert(result.swept_volume.begin(),
-                             response.swept_volume().begin(),
-                             response.swept_volume().end());
-  result.lock_motion_id = response.has_lock_motion_id()
-                              ? std::optional(response.lock_motion_id())
-                              : std::nullopt;
+absl::StatusOr<MotionPlannerClient::PlanTrajectoryResult>
+MotionPlannerClient::PlanTrajectory(
+    const intrinsic_proto::motion_planning::RobotSpecification&
+        robot_specification,
+    const intrinsic_proto::motion_planning::MotionSpecification&
+        motion_specification,
+    const MotionPlanningOptions& options, const std::string& caller_id,
+    const intrinsic_proto::data_logger::Context& context) {
+  intrinsic_proto::motion_planning::MotionPlanningRequest request =
+      MakeMotionPlanningRequest(robot_specification, motion_specification,
+                                options, caller_id, context);
+
+  // Key under which the trajectory is cached, or empty if it is not cached.
+  std::string cache_key;
+  if (plan_cache_ != nullptr) {
+    const intrinsic_proto::motion_planning::LockMotionConfiguration*
+        lock_motion_configuration =
+            options.lock_motion_configuration.has_value()
+                ? &*options.lock_motion_configuration
+                : nullptr;
+    if (lock_motion_configuration != nullptr &&
+        lock_motion_configuration->has_load_motion_command()) {
+      cache_key = LockedMotionCacheKey(
+          lock_motion_configuration->load_motion_command().motion_id());
+    } else if (lock_motion_configuration == nullptr &&
+               plan_cache_->options().world_version != nullptr) {
+      INTR_ASSIGN_OR_RETURN(const std::string world_version,
+                            plan_cache_->options().world_version());
+      cache_key = PlanCacheKey(world_version, request);
+    }
+    if (!cache_key.empty()) {
+      if (std::optional<PlanTrajectoryResult> result =
+              plan_cache_->Find(cache_key);
+          result.has_value()) {
+        return *std::move(result);
+      }
+    }
+  }
 
+  INTR_ASSIGN_OR_RETURN(
+      const intrinsic_proto::motion_planning::TrajectoryPlanningResponse
+          response,
+      CallWithPolicy<
+          intrinsic_proto::motion_planning::TrajectoryPlanningResponse>(
+          call_policies_.For(kPlanTrajectoryMethod),
+          [&](grpc::ClientContext* ctx,
+              intrinsic_proto::motion_planning::TrajectoryPlanningResponse*
+                  response) {
+            return motion_planner_service_->PlanTrajectory(ctx, request,
+                                                           response);
+          }));
+
+  PlanTrajectoryResult result = ToPlanTrajectoryResult(response);
+  if (plan_cache_ != nullptr) {
+    if (!cache_key.empty()) {
+      plan_cache_->Insert(cache_key, result);
+    } else if (result.lock_motion_id.has_value()) {
+      // Loading the motion later returns it without the id, like the service.
+      PlanTrajectoryResult locked_motion = result;
+      locked_motion.lock_motion_id.reset();
+      plan_cache_->Insert(LockedMotionCacheKey(*result.lock_motion_id),
+                          locked_motion);
+    }
+  }
   return result;
 }
 
+MotionPlannerClient::PlanTrajectoryHandle::PlanTrajectoryHandle(
+    std::function<void(bool ok)> on_done)
+    : on_done_(std::move(on_done)) {}
+
+MotionPlannerClient::PlanTrajectoryHandle::~PlanTrajectoryHandle() {
+  if (!done_.HasBeenNotified()) {
+    context_.TryCancel();
+    done_.WaitForNotification();
+  }
+}
+
+bool MotionPlannerClient::PlanTrajectoryHandle::IsDone() const {
+  return done_.HasBeenNotified();
+}
+
+bool MotionPlannerClient::PlanTrajectoryHandle::WaitWithTimeout(
+    absl::Duration timeout) const {
+  return done_.WaitForNotificationWithTimeout(timeout);
+}
+
+absl::StatusOr<MotionPlannerClient::PlanTrajectoryResult>
+MotionPlannerClient::PlanTrajectoryHandle::Wait() const {
+  done_.WaitForNotification();
+  INTR_RETURN_IF_ERROR(ToAbslStatus(status_));
+  return ToPlanTrajectoryResult(response_);
+}
+
+void MotionPlannerClient::PlanTrajectoryHandle::Cancel() {
+  context_.TryCancel();
+}
+
+void MotionPlannerClient::PlanTrajectoryHandle::Finish(grpc::Status status) {
+  status_ = std::move(status);
+  if (on_done_ != nullptr) {
+    on_done_(status_.ok());
+  }
+  done_.Notify();
+}
+
+std::unique_ptr<MotionPlannerClient::PlanTrajectoryHandle>
+MotionPlannerClient::StartPlanTrajectory(
+    intrinsic_proto::motion_planning::MotionPlanningRequest request,
+    std::function<void(bool ok)> on_done) {
+  // Private constructor, so no make_unique.
+  auto handle =
+      absl::WrapUnique(new PlanTrajectoryHandle(std::move(on_done)));
+  handle->request_ = std::move(request);
+  PlanTrajectoryHandle* h = handle.get();
+  // Stubs without an asynchronous interface, such as mocks, are called
+  // synchronously.
+  if (auto* async = motion_planner_service_->async(); async != nullptr) {
+    async->PlanTrajectory(&h->context_, &h->request_, &h->response_,
+                          [h](grpc::Status status) {
+                            h->Finish(std::move(status));
+                          });
+  } else {
+    h->Finish(motion_planner_service_->PlanTrajectory(
+        &h->context_, h->request_, &h->response_));
+  }
+  return handle;
+}
+
+std::unique_ptr<MotionPlannerClient::PlanTrajectoryHandle>
+MotionPlannerClient::PlanTrajectoryAsync(
+    const intrinsic_proto::motion_planning::RobotSpecification&
+        robot_specification,
+    const intrinsic_proto::motion_planning::MotionSpecification&
+        motion_specification,
+    const MotionPlanningOptions& options, const std::string& caller_id,
+    const intrinsic_proto::data_logger::Context& context) {
+  return StartPlanTrajectory(
+      MakeMotionPlanningRequest(robot_specification, motion_specification,
+                                options, caller_id, context));
+}
+
+absl::StatusOr<MotionPlannerClient::PlanCandidatesResult>
+MotionPlannerClient::PlanCandidates(
+    const intrinsic_proto::motion_planning::RobotSpecification&
+        robot_specification,
+    absl::Span<const intrinsic_proto::motion_planning::MotionSpecification>
+        motion_specifications,
+    CandidateSelection selection, const MotionPlanningOptions& options,
+    const std::string& caller_id,
+    const intrinsic_proto::data_logger::Context& context) {
+  if (motion_specifications.empty()) {
+    return absl::InvalidArgumentError("No motion specifications given");
+  }
+  absl::Mutex mutex;
+  size_t num_done = 0;
+  std::optional<size_t> first_success;
+  // Declared after the state above, so that the handles wait for their calls
+  // to finish before the state is destroyed.
+  std::vector<std::unique_ptr<PlanTrajectoryHandle>> handles;
+  handles.reserve(motion_specifications.size());
+  for (size_t i = 0; i < motion_specifications.size(); ++i) {
+    handles.push_back(StartPlanTrajectory(
+        MakeMotionPlanningRequest(robot_specification,
+                                  motion_specifications[i], options, caller_id,
+                                  context),
+        [&mutex, &num_done, &first_success, i](bool ok) {
+          absl::MutexLock lock(&mutex);
+          ++num_done;
+          if (ok && !first_success.has_value()) {
+            first_success = i;
+          }
+        }));
+  }
+  const auto finished = [&]() {
+    return num_done == handles.size() ||
+           (selection == CandidateSelection::kFirstSuccess &&
+            first_success.has_value());
+  };
+  std::optional<size_t> selected;
+  {
+    absl::MutexLock lock(&mutex);
+    mutex.Await(absl::Condition(&finished));
+    selected = first_success;
+  }
+
+  if (selection == CandidateSelection::kShortestDuration) {
+    std::optional<absl::Duration> shortest;
+    for (size_t i = 0; i < handles.size(); ++i) {
+      absl::StatusOr<PlanTrajectoryResult> result = handles[i]->Wait();
+      if (!result.ok()) continue;
+      const absl::Duration duration = TrajectoryDuration(result->trajectory);
+      if (!shortest.has_value() || duration < *shortest) {
+        shortest = duration;
+        selected = i;
+      }
+    }
+  }
+  if (!selected.has_value()) {
+    return handles.front()->Wait().status();
+  }
+  for (size_t i = 0; i < handles.size(); ++i) {
+    if (i != *selected) {
+      handles[i]->Cancel();
+    }
+  }
+  INTR_ASSIGN_OR_RETURN(PlanTrajectoryResult result,
+                        handles[*selected]->Wait());
+  return PlanCandidatesResult{.index = *selected, .result = std::move(result)};
+}
+
 absl::StatusOr<std::vector<eigenmath::VectorXd>> MotionPlannerClient::ComputeIk(
     const world::KinematicObject& robot,
     const intrinsic_proto::motion_planning::CartesianMotionTarget&
@@ -117,37 +632,77 @@ absl::StatusOr<std::vector<eigenmath::VectorXd>> MotionPlannerClient::ComputeIk(
     const intrinsic_proto::world::geometric_constraints::GeometricConstraint&
         geometric_target,
     const IkOptions& options) {
-  intrinsic_proto::motion_planning::IkRequest request;
-  request.set_world_id(world_id_);
-  request.mutable_robot_reference()->mutable_object_id()->set_id(
-      robot.Id().value());
-
-  *request.mutable_target() = geometric_target;
+  intrinsic_proto::motion_planning::IkRequest request =
+      MakeIkRequest(robot, geometric_target, options, world_id_);
+
+  INTR_ASSIGN_OR_RETURN(
+      const intrinsic_proto::motion_planning::IkResponse response,
+      CallWithPolicy<intrinsic_proto::motion_planning::IkResponse>(
+          call_policies_.For(kComputeIkMethod),
+          [&](grpc::ClientContext* ctx,
+              intrinsic_proto::motion_planning::IkResponse* response) {
+            return motion_planner_service_->ComputeIk(ctx, request, response);
+          }));
 
-  if (options.starting_joints.size() > 0) {
-    VectorXdToRepeatedDouble(
-        options.starting_joints,
-        request.mutable_starting_joints()->mutable_joints());
-  }
+  return ToVectorXds(response.solutions());
+}
 
-  if (options.max_num_solutions.has_value()) {
-    request.set_max_num_solutions(*options.max_num_solutions);
-  }
+absl::StatusOr<std::vector<absl::StatusOr<std::vector<eigenmath::VectorXd>>>>
+MotionPlannerClient::ComputeIkBatch(
+    const world::KinematicObject& robot,
+    absl::Span<const intrinsic_proto::world::geometric_constraints::
+                   GeometricConstraint>
+        geometric_targets,
+    const IkOptions& options, const BatchOptions& batch_options) {
+  std::vector<absl::StatusOr<std::vector<eigenmath::VectorXd>>> results(
+      geometric_targets.size());
+  INTR_RETURN_IF_ERROR(ComputeIkBatch(
+      robot, geometric_targets, options, batch_options,
+      [&results](size_t index,
+                 absl::StatusOr<std::vector<eigenmath::VectorXd>> result) {
+        results[index] = std::move(result);
+      }));
+  return results;
+}
 
-  if (options.collision_settings.has_value()) {
-    *request.mutable_collision_settings() = *options.collision_settings;
+absl::Status MotionPlannerClient::ComputeIkBatch(
+    const world::KinematicObject& robot,
+    absl::Span<const intrinsic_proto::world::geometric_constraints::
+                   GeometricConstraint>
+        geometric_targets,
+    const IkOptions& options, const BatchOptions& batch_options,
+    BatchResultCallback<std::vector<eigenmath::VectorXd>> on_result) {
+  INTR_RETURN_IF_ERROR(ValidateBatchOptions(batch_options));
+  std::vector<intrinsic_proto::motion_planning::IkRequest> requests;
+  requests.reserve(geometric_targets.size());
+  for (const intrinsic_proto::world::geometric_constraints::GeometricConstraint&
+           geometric_target : geometric_targets) {
+    requests.push_back(
+        MakeIkRequest(robot, geometric_target, options, world_id_));
   }
-
-  request.set_ensure_same_branch(options.ensure_same_branch);
-
-  request.set_prefer_same_branch(options.prefer_same_branch);
-
-  intrinsic_proto::motion_planning::IkResponse response;
-  grpc::ClientContext ctx;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(
-      motion_planner_service_->ComputeIk(&ctx, request, &response)));
-
-  return ToVectorXds(response.solutions());
+  CallConcurrently<intrinsic_proto::motion_planning::IkResponse>(
+      absl::MakeConstSpan(requests), batch_options.max_concurrent_requests,
+      [this](grpc::ClientContext* ctx,
+             const intrinsic_proto::motion_planning::IkRequest* request,
+             intrinsic_proto::motion_planning::IkResponse* response,
+             std::function<void(grpc::Status)> on_done) {
+        // Stubs without an asynchronous interface, such as mocks, are called
+        // one after the other.
+        if (auto* async = motion_planner_service_->async(); async != nullptr) {
+          async->ComputeIk(ctx, request, response, std::move(on_done));
+        } else {
+          on_done(motion_planner_service_->ComputeIk(ctx, *request, response));
+        }
+      },
+      [&on_result](size_t index, absl::Status status,
+                   intrinsic_proto::motion_planning::IkResponse response) {
+        if (!status.ok()) {
+          on_result(index, std::move(status));
+          return;
+        }
+        on_result(index, ToVectorXds(response.solutions()));
+      });
+  return absl::OkStatus();
 }
 
 namespace {
@@ -158,23 +713,19 @@ absl::StatusOr<Pose3d> ComputeFkInternal(
     const eigenmath::VectorXd& joint_values,
     const intrinsic_proto::world::TransformNodeReference& reference,
     const intrinsic_proto::world::TransformNodeReference& target,
-    const std::string& world_id,
+    const std::string& world_id, const CallPolicy& policy,
     intrinsic_proto::motion_planning::MotionPlannerService::StubInterface&
         motion_planner_service) {
-  intrinsic_proto::motion_planning::FkRequest request;
-  request.set_world_id(world_id);
-  request.mutable_robot_reference()->mutable_object_id()->set_id(
-      robot.Id().value());
-  VectorXdToRepeatedDouble(joint_values,
-                           request.mutable_joints()->mutable_joints());
+  intrinsic_proto::motion_planning::FkRequest request =
+      MakeFkRequest(robot, joint_values, reference, target, world_id);
 
-  *request.mutable_reference() = reference;
-  *request.mutable_target() = target;
-
-  intrinsic_proto::motion_planning::FkResponse response;
-  grpc::ClientContext ctx;
-  INTR_RETURN_IF_ERROR(
-      ToAbslStatus(motion_planner_service.ComputeFk(&ctx, request, &response)));
+  INTR_ASSIGN_OR_RETURN(
+      const intrinsic_proto::motion_planning::FkResponse response,
+      CallWithPolicy<intrinsic_proto::motion_planning::FkResponse>(
+          policy, [&](grpc::ClientContext* ctx,
+                      intrinsic_proto::motion_planning::FkResponse* response) {
+            return motion_planner_service.ComputeFk(ctx, request, response);
+          }));
 
   return FromProto(response.reference_t_target());
 }
@@ -191,7 +742,8 @@ absl::StatusOr<Pose3d> MotionPlannerClient::ComputeFk(
   intrinsic_proto::world::TransformNodeReference target_proto;
   *target_proto.mutable_by_name() = target;
   return ComputeFkInternal(robot, joint_values, reference_proto, target_proto,
-                           world_id_, *motion_planner_service_);
+                           world_id_, call_policies_.For(kComputeFkMethod),
+                           *motion_planner_service_);
 }
 
 absl::StatusOr<Pose3d> MotionPlannerClient::ComputeFk(
@@ -203,7 +755,64 @@ absl::StatusOr<Pose3d> MotionPlannerClient::ComputeFk(
   intrinsic_proto::world::TransformNodeReference target_proto;
   target_proto.set_id(target.Id().value());
   return ComputeFkInternal(robot, joint_values, reference_proto, target_proto,
-                           world_id_, *motion_planner_service_);
+                           world_id_, call_policies_.For(kComputeFkMethod),
+                           *motion_planner_service_);
+}
+
+absl::StatusOr<std::vector<absl::StatusOr<Pose3d>>>
+MotionPlannerClient::ComputeFkBatch(
+    const world::KinematicObject& robot,
+    absl::Span<const eigenmath::VectorXd> joint_values,
+    const world::TransformNode& reference, const world::TransformNode& target,
+    const BatchOptions& batch_options) {
+  std::vector<absl::StatusOr<Pose3d>> results(joint_values.size());
+  INTR_RETURN_IF_ERROR(ComputeFkBatch(
+      robot, joint_values, reference, target, batch_options,
+      [&results](size_t index, absl::StatusOr<Pose3d> result) {
+        results[index] = std::move(result);
+      }));
+  return results;
+}
+
+absl::Status MotionPlannerClient::ComputeFkBatch(
+    const world::KinematicObject& robot,
+    absl::Span<const eigenmath::VectorXd> joint_values,
+    const world::TransformNode& reference, const world::TransformNode& target,
+    const BatchOptions& batch_options, BatchResultCallback<Pose3d> on_result) {
+  INTR_RETURN_IF_ERROR(ValidateBatchOptions(batch_options));
+  intrinsic_proto::world::TransformNodeReference reference_proto;
+  reference_proto.set_id(reference.Id().value());
+  intrinsic_proto::world::TransformNodeReference target_proto;
+  target_proto.set_id(target.Id().value());
+  std::vector<intrinsic_proto::motion_planning::FkRequest> requests;
+  requests.reserve(joint_values.size());
+  for (const eigenmath::VectorXd& joints : joint_values) {
+    requests.push_back(MakeFkRequest(robot, joints, reference_proto,
+                                     target_proto, world_id_));
+  }
+  CallConcurrently<intrinsic_proto::motion_planning::FkResponse>(
+      absl::MakeConstSpan(requests), batch_options.max_concurrent_requests,
+      [this](grpc::ClientContext* ctx,
+             const intrinsic_proto::motion_planning::FkRequest* request,
+             intrinsic_proto::motion_planning::FkResponse* response,
+             std::function<void(grpc::Status)> on_done) {
+        // Stubs without an asynchronous interface, such as mocks, are called
+        // one after the other.
+        if (auto* async = motion_planner_service_->async(); async != nullptr) {
+          async->ComputeFk(ctx, request, response, std::move(on_done));
+        } else {
+          on_done(motion_planner_service_->ComputeFk(ctx, *request, response));
+        }
+      },
+      [&on_result](size_t index, absl::Status status,
+                   intrinsic_proto::motion_planning::FkResponse response) {
+        if (!status.ok()) {
+          on_result(index, std::move(status));
+          return;
+        }
+        on_result(index, FromProto(response.reference_t_target()));
+      });
+  return absl::OkStatus();
 }
 
 absl::StatusOr<intrinsic_proto::motion_planning::CheckCollisionsResponse>
@@ -211,24 +820,139 @@ MotionPlannerClient::CheckCollisions(
     const world::KinematicObject& robot,
     const std::vector<eigenmath::VectorXd>& waypoints,
     const CheckCollisionsOptions& options) {
-  intrinsic_proto::motion_planning::CheckCollisionsRequest request;
-  request.set_world_id(world_id_);
-  request.mutable_robot_reference()->mutable_object_id()->set_id(
-      robot.Id().value());
-  ToJointVecs(waypoints, request.mutable_waypoint());
+  const intrinsic_proto::motion_planning::CheckCollisionsRequest request =
+      MakeCheckCollisionsRequest(robot, waypoints, options, world_id_);
+
+  using Response = intrinsic_proto::motion_planning::CheckCollisionsResponse;
+  return CallWithPolicy<Response>(
+      call_policies_.For(kCheckCollisionsMethod),
+      [&](grpc::ClientContext* ctx, Response* response) {
+        return motion_planner_service_->CheckCollisions(ctx, request, response);
+      });
+}
 
-  if (options.collision_settings.has_value()) {
-    *request.mutable_collision_settings() = *options.collision_settings;
+absl::StatusOr<std::optional<MotionPlannerClient::CheckCollisionsChunkResult>>
+MotionPlannerClient::CheckCollisionsChunked(
+    const world::KinematicObject& robot,
+    absl::Span<const eigenmath::VectorXd> waypoints,
+    const CheckCollisionsOptions& options,
+    const ChunkedCheckCollisionsOptions& chunk_options) {
+  return CheckCollisionsChunked(robot, waypoints, options, chunk_options,
+                                [](const CheckCollisionsChunkResult&) {});
+}
+
+absl::StatusOr<std::optional<MotionPlannerClient::CheckCollisionsChunkResult>>
+MotionPlannerClient::CheckCollisionsChunked(
+    const world::KinematicObject& robot,
+    absl::Span<const eigenmath::VectorXd> waypoints,
+    const CheckCollisionsOptions& options,
+    const ChunkedCheckCollisionsOptions& chunk_options,
+    CheckCollisionsChunkCallback on_chunk) {
+  INTR_RETURN_IF_ERROR(ValidateChunkedCheckCollisionsOptions(chunk_options));
+
+  // Chunk i starts at waypoint i * stride, where the previous chunk ends.
+  const size_t stride = chunk_options.chunk_size - 1;
+  const size_t num_chunks =
+      waypoints.size() <= 1 ? 1 : (waypoints.size() - 2) / stride + 1;
+
+  struct Chunk {
+    size_t begin;
+    size_t end;
+    grpc::ClientContext context;
+    intrinsic_proto::motion_planning::CheckCollisionsRequest request;
+    intrinsic_proto::motion_planning::CheckCollisionsResponse response;
+    // Set once the call has finished.
+    std::optional<absl::Status> status;
+  };
+  // Shared with the calls, so that the mutex outlives the last callback.
+  struct State {
+    absl::Mutex mutex;
+    int in_flight ABSL_GUARDED_BY(mutex) = 0;
+    // Chunks that were started but not reported yet, in path order. Only
+    // accessed by the calling thread.
+    std::deque<std::unique_ptr<Chunk>> chunks;
+  };
+  auto state = std::make_shared<State>();
+
+  // Only the requests of chunks in flight are kept in memory.
+  const auto start_chunk = [&](size_t index) {
+    auto chunk = std::make_unique<Chunk>();
+    chunk->begin = index * stride;
+    chunk->end =
+        std::min(chunk->begin + chunk_options.chunk_size, waypoints.size());
+    chunk->request = MakeCheckCollisionsRequest(
+        robot, waypoints.subspan(chunk->begin, chunk->end - chunk->begin),
+        options, world_id_);
+    Chunk* call = chunk.get();
+    state->chunks.push_back(std::move(chunk));
+    {
+      absl::MutexLock lock(&state->mutex);
+      ++state->in_flight;
+    }
+    std::function<void(grpc::Status)> on_done = [state,
+                                                 call](grpc::Status status) {
+      absl::MutexLock lock(&state->mutex);
+      call->status = ToAbslStatus(status);
+      --state->in_flight;
+    };
+    // Stubs without an asynchronous interface, such as mocks, are called one
+    // after the other.
+    if (auto* async = motion_planner_service_->async(); async != nullptr) {
+      async->CheckCollisions(&call->context, &call->request, &call->response,
+                             std::move(on_done));
+    } else {
+      on_done(motion_planner_service_->CheckCollisions(
+          &call->context, call->request, &call->response));
+    }
+  };
+
+  absl::Status status;
+  std::optional<CheckCollisionsChunkResult> collision;
+  size_t next_start = 0;
+  for (size_t next_report = 0; next_report < num_chunks; ++next_report) {
+    while (next_start < num_chunks &&
+           next_start - next_report <
+               static_cast<size_t>(chunk_options.max_concurrent_requests)) {
+      start_chunk(next_start++);
+    }
+    Chunk& chunk = *state->chunks.front();
+    {
+      absl::MutexLock lock(&state->mutex);
+      state->mutex.Await(absl::Condition(
+          +[](Chunk* chunk) { return chunk->status.has_value(); }, &chunk));
+    }
+    if (!chunk.status->ok()) {
+      status = *chunk.status;
+      break;
+    }
+    CheckCollisionsChunkResult result = {.begin = chunk.begin,
+                                         .end = chunk.end,
+                                         .response = std::move(chunk.response)};
+    state->chunks.pop_front();
+    on_chunk(result);
+    if (result.response.has_collision()) {
+      collision = std::move(result);
+      break;
+    }
   }
 
-  intrinsic_proto::motion_planning::CheckCollisionsResponse response;
-  grpc::ClientContext ctx;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(
-      motion_planner_service_->CheckCollisions(&ctx, request, &response)));
-  return response;
+  // Stop checking the chunks beyond the first collision or error.
+  for (const std::unique_ptr<Chunk>& chunk : state->chunks) {
+    chunk->context.TryCancel();
+  }
+  {
+    absl::MutexLock lock(&state->mutex);
+    state->mutex.Await(absl::Condition(
+        +[](int* in_flight) { return *in_flight == 0; }, &state->in_flight));
+  }
+  INTR_RETURN_IF_ERROR(status);
+  return collision;
 }
 
 absl::StatusOr<google::protobuf::Empty> MotionPlannerClient::ClearCache() {
+  if (plan_cache_ != nullptr) {
+    plan_cache_->Clear();
+  }
   google::protobuf::Empty response;
   grpc::ClientContext ctx;
   INTR_RETURN_IF_ERROR(ToAbslStatus(motion_planner_service_->ClearCache(
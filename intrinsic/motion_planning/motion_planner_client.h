@@ -3,14 +3,24 @@
 #ifndef INTRINSIC_MOTION_PLANNING_MOTION_PLANNER_CLIENT_H_
 #define INTRINSIC_MOTION_PLANNING_MOTION_PLANNER_CLIENT_H_
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "google/protobuf/empty.pb.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/support/status.h"
 #include "intrinsic/eigenmath/types.h"
 #include "intrinsic/geometry/service/transformed_geometry_storage_refs.pb.h"
 #include "intrinsic/logging/proto/context.pb.h"
@@ -20,6 +30,7 @@
 #include "intrinsic/motion_planning/proto/motion_planner_service.pb.h"
 #include "intrinsic/motion_planning/proto/motion_specification.pb.h"
 #include "intrinsic/motion_planning/proto/motion_target.pb.h"
+#include "intrinsic/util/grpc/connection_params.h"
 #include "intrinsic/world/objects/kinematic_object.h"
 #include "intrinsic/world/objects/transform_node.h"
 #include "intrinsic/world/proto/collision_settings.pb.h"
@@ -39,12 +50,60 @@ class MotionPlannerClient {
           intrinsic_proto::motion_planning::MotionPlannerService::StubInterface>
           motion_planner_service);
 
+  // Options for the cache of planned trajectories. See the constructor below.
+  struct PlanCacheOptions {
+    // Returns a string that changes whenever the world is updated, e.g.,
+    // ObjectWorldClient::GetWorldVersion(). Trajectories are only reused for
+    // the world version they were planned for. If not set, only locked
+    // motions are cached.
+    std::function<absl::StatusOr<std::string>()> world_version;
+
+    // The maximum number of cached trajectories.
+    size_t max_entries = 128;
+
+    // The maximum total size of the cached trajectories in bytes, as
+    // serialized protos.
+    size_t max_bytes = size_t{64} << 20;
+  };
+
+  // Creates a client for the world with the given id, which caches the
+  // trajectories it plans in memory.
+  //
+  // PlanTrajectory() returns a cached trajectory without a request if the same
+  // problem was planned for the same world version before. The caller id and
+  // logging context are not part of the problem. Motions that were locked with
+  // a SaveMotionCommand or loaded with a LoadMotionCommand are cached by their
+  // id, so loading them again does not make a request either. The least
+  // recently used trajectories are dropped when the cache is full, and
+  // ClearCache() drops all of them. PlanTrajectoryAsync() and PlanCandidates()
+  // always make requests.
+  MotionPlannerClient(
+      absl::string_view world_id,
+      std::shared_ptr<
+          intrinsic_proto::motion_planning::MotionPlannerService::StubInterface>
+          motion_planner_service,
+      PlanCacheOptions plan_cache_options);
+
+  // Sets the deadlines, retries and hedging of the calls of PlanTrajectory(),
+  // ComputeIk(), ComputeFk() and CheckCollisions(), e.g., from
+  // Channel::GetCallPolicies(). Not thread-safe, so call it before using the
+  // client. By default, calls have no deadline and are not retried.
+  //
+  // Policies are looked up by the full method name, e.g.,
+  // "/intrinsic_proto.motion_planning.MotionPlannerService/ComputeIk". Only
+  // retry or hedge PlanTrajectory() if no motions are saved with it.
+  void SetCallPolicies(CallPolicies call_policies) {
+    call_policies_ = std::move(call_policies);
+  }
+
   // Options for motion planning.
   struct MotionPlanningOptions {
     // Timeout for path planning algorithms.
     double path_planning_time_out = 30;
 
     // Optionally generate and return the swept volume for the computed path.
+    // The result only holds references to its shapes; use SweptVolume to fetch
+    // their geometry when it is needed.
     bool compute_swept_volume = false;
 
     // Optional configuration for saving or loading a motion.
@@ -57,7 +116,8 @@ class MotionPlannerClient {
 
   // Wrapped result from calling PlanTrajectory. Contains both the trajectory
   // and an optional set of shapes that correspond to the swept volume of the
-  // trajectory.
+  // trajectory. JointTrajectory::FromProto() converts the trajectory to a
+  // columnar form for resampling and limit checks.
   struct PlanTrajectoryResult {
     intrinsic_proto::icon::JointTrajectoryPVA trajectory;
     std::vector<intrinsic_proto::geometry::TransformedGeometryStorageRefs>
@@ -81,6 +141,98 @@ class MotionPlannerClient {
       const intrinsic_proto::data_logger::Context& context =
           intrinsic_proto::data_logger::Context());
 
+  // A PlanTrajectory() call in progress. See PlanTrajectoryAsync().
+  //
+  // Destroying the handle cancels the call if it has not finished yet, and
+  // waits for it to finish.
+  class PlanTrajectoryHandle {
+   public:
+    ~PlanTrajectoryHandle();
+
+    PlanTrajectoryHandle(const PlanTrajectoryHandle&) = delete;
+    PlanTrajectoryHandle& operator=(const PlanTrajectoryHandle&) = delete;
+
+    // Returns true if the call has finished, i.e., Wait() does not block.
+    bool IsDone() const;
+
+    // Waits until the call has finished or `timeout` has passed. Returns true
+    // if the call has finished.
+    bool WaitWithTimeout(absl::Duration timeout) const;
+
+    // Waits until the call has finished and returns its result. Returns
+    // CancelledError if the call was cancelled before the trajectory was
+    // planned. Can be called more than once.
+    absl::StatusOr<PlanTrajectoryResult> Wait() const;
+
+    // Asks the service to stop planning, without waiting for the call to
+    // finish. Has no effect if the call has finished already.
+    void Cancel();
+
+   private:
+    friend class MotionPlannerClient;
+
+    // Private constructor, so only MotionPlannerClient creates handles.
+    explicit PlanTrajectoryHandle(std::function<void(bool ok)> on_done);
+
+    // Records the status of the finished call and wakes up waiters.
+    void Finish(grpc::Status status);
+
+    grpc::ClientContext context_;
+    intrinsic_proto::motion_planning::MotionPlanningRequest request_;
+    intrinsic_proto::motion_planning::TrajectoryPlanningResponse response_;
+    grpc::Status status_;
+    // Called before `done_` is notified. Used by PlanCandidates().
+    std::function<void(bool ok)> on_done_;
+    absl::Notification done_;
+  };
+
+  // Starts planning a trajectory like PlanTrajectory(), and returns without
+  // waiting for the result. This allows planning the next motion while the
+  // robot executes the current one.
+  std::unique_ptr<PlanTrajectoryHandle> PlanTrajectoryAsync(
+      const intrinsic_proto::motion_planning::RobotSpecification&
+          robot_specification,
+      const intrinsic_proto::motion_planning::MotionSpecification&
+          motion_specification,
+      const MotionPlanningOptions& options = MotionPlanningOptions::Defaults(),
+      const std::string& caller_id = "Anonymous",
+      const intrinsic_proto::data_logger::Context& context =
+          intrinsic_proto::data_logger::Context());
+
+  // How PlanCandidates() picks one of several planned trajectories.
+  enum class CandidateSelection {
+    // The first candidate that was planned successfully. Planning of the other
+    // candidates is cancelled.
+    kFirstSuccess,
+    // The successfully planned candidate with the shortest trajectory. Waits
+    // for all candidates.
+    kShortestDuration,
+  };
+
+  // Result of PlanCandidates().
+  struct PlanCandidatesResult {
+    // Index of the selected candidate in the motion specifications.
+    size_t index;
+    PlanTrajectoryResult result;
+  };
+
+  // Plans a trajectory for each of `motion_specifications`, e.g., for
+  // alternative goals, concurrently and returns the trajectory picked by
+  // `selection`.
+  //
+  // Returns InvalidArgumentError if `motion_specifications` is empty, and the
+  // error of the first candidate if no candidate could be planned.
+  absl::StatusOr<PlanCandidatesResult> PlanCandidates(
+      const intrinsic_proto::motion_planning::RobotSpecification&
+          robot_specification,
+      absl::Span<const intrinsic_proto::motion_planning::MotionSpecification>
+          motion_specifications,
+      CandidateSelection selection = CandidateSelection::kFirstSuccess,
+      const MotionPlanningOptions& options = MotionPlanningOptions::Defaults(),
+      const std::string& caller_id = "Anonymous",
+      const intrinsic_proto::data_logger::Context& context =
+          intrinsic_proto::data_logger::Context());
+
   // Options for ik.
   struct IkOptions {
     // The starting joint configuration to use. If empty (=default), the current
@@ -126,6 +278,49 @@ class MotionPlannerClient {
       const IkOptions& options = {.ensure_same_branch = false,
                                   .prefer_same_branch = false});
 
+  // Options for the batched IK and FK calls.
+  struct BatchOptions {
+    // The maximum number of requests in flight at the same time. Must be
+    // positive. A batch takes about as long as one call per
+    // `max_concurrent_requests` entries.
+    int max_concurrent_requests = 16;
+
+    // Returns the default set of options to use with batched requests.
+    static const BatchOptions& Defaults();
+  };
+
+  // Receives the result for the entry with the given index of a batch.
+  template <typename T>
+  using BatchResultCallback =
+      absl::FunctionRef<void(size_t index, absl::StatusOr<T> result)>;
+
+  // Computes inverse kinematics for each of the given targets with the same
+  // options. The requests are sent concurrently. Returns the solutions, or the
+  // error, for each target in the order of `geometric_targets`.
+  //
+  // Returns InvalidArgumentError if `batch_options` are invalid.
+  absl::StatusOr<std::vector<absl::StatusOr<std::vector<eigenmath::VectorXd>>>>
+  ComputeIkBatch(
+      const world::KinematicObject& robot,
+      absl::Span<const intrinsic_proto::world::geometric_constraints::
+                     GeometricConstraint>
+          geometric_targets,
+      const IkOptions& options = {.ensure_same_branch = false,
+                                  .prefer_same_branch = false},
+      const BatchOptions& batch_options = BatchOptions::Defaults());
+
+  // Same as above, but passes the result for each target to `on_result` as
+  // soon as it arrives, so that results can be processed while the rest of
+  // the batch is computed. Calls of `on_result` do not overlap, but may happen
+  // on other threads. Returns once all results were passed.
+  absl::Status ComputeIkBatch(
+      const world::KinematicObject& robot,
+      absl::Span<const intrinsic_proto::world::geometric_constraints::
+                     GeometricConstraint>
+          geometric_targets,
+      const IkOptions& options, const BatchOptions& batch_options,
+      BatchResultCallback<std::vector<eigenmath::VectorXd>> on_result);
+
   // Computes forward kinematics.
   //
   // The returned transform is reference_t_target, i.e. the frame of "target" in
@@ -148,6 +343,26 @@ class MotionPlannerClient {
                                    const eigenmath::VectorXd& joint_values,
                                    const world::TransformNode& reference,
                                    const world::TransformNode& target);
+
+  // Computes forward kinematics for each of the given joint configurations.
+  // The requests are sent concurrently. Returns reference_t_target, or the
+  // error, for each configuration in the order of `joint_values`.
+  //
+  // Returns InvalidArgumentError if `batch_options` are invalid.
+  absl::StatusOr<std::vector<absl::StatusOr<Pose3d>>> ComputeFkBatch(
+      const world::KinematicObject& robot,
+      absl::Span<const eigenmath::VectorXd> joint_values,
+      const world::TransformNode& reference, const world::TransformNode& target,
+      const BatchOptions& batch_options = BatchOptions::Defaults());
+
+  // Same as above, but passes the result for each configuration to
+  // `on_result` as soon as it arrives. See ComputeIkBatch().
+  absl::Status ComputeFkBatch(
+      const world::KinematicObject& robot,
+      absl::Span<const eigenmath::VectorXd> joint_values,
+      const world::TransformNode& reference, const world::TransformNode& target,
+      const BatchOptions& batch_options, BatchResultCallback<Pose3d> on_result);
+
   // Options for check collisions.
   struct CheckCollisionsOptions {
     // Optional collision settings.
@@ -160,14 +375,85 @@ class MotionPlannerClient {
                   const std::vector<eigenmath::VectorXd>& waypoints,
                   const CheckCollisionsOptions& options = {});
 
-  // Clear the PlanTrajectory caches.
+  // Options for checking a path in chunks.
+  struct ChunkedCheckCollisionsOptions {
+    // The number of waypoints per request. Consecutive chunks share their
+    // boundary waypoint, so that every segment of the path is checked. Must be
+    // at least 2.
+    size_t chunk_size = 1000;
+
+    // The maximum number of chunks checked at the same time. Must be positive.
+    // Chunks beyond the first collision may be checked needlessly.
+    int max_concurrent_requests = 4;
+
+    // Returns the default set of options to use with chunked checks.
+    static const ChunkedCheckCollisionsOptions& Defaults();
+  };
+
+  // The result of checking one chunk of a path.
+  struct CheckCollisionsChunkResult {
+    // The waypoints [begin, end) of the path that were checked.
+    size_t begin;
+    size_t end;
+    intrinsic_proto::motion_planning::CheckCollisionsResponse response;
+  };
+
+  // Receives the result of each chunk of a path, in path order.
+  using CheckCollisionsChunkCallback =
+      absl::FunctionRef<void(const CheckCollisionsChunkResult& chunk)>;
+
+  // Checks collisions for a given path in chunks of
+  // `chunk_options.chunk_size` waypoints, which keeps the requests small for
+  // long, dense paths. Stops at the first chunk in collision and returns it,
+  // or returns nullopt if the whole path is collision free.
+  //
+  // Returns InvalidArgumentError if `chunk_options` are invalid, and the
+  // error of the first chunk that failed.
+  absl::StatusOr<std::optional<CheckCollisionsChunkResult>>
+  CheckCollisionsChunked(const world::KinematicObject& robot,
+                         absl::Span<const eigenmath::VectorXd> waypoints,
+                         const CheckCollisionsOptions& options = {},
+                         const ChunkedCheckCollisionsOptions& chunk_options =
+                             ChunkedCheckCollisionsOptions::Defaults());
+
+  // Same as above, but also passes the result of every checked chunk to
+  // `on_chunk` as soon as it is known, in path order and on the calling
+  // thread, up to and including the first chunk in collision.
+  absl::StatusOr<std::optional<CheckCollisionsChunkResult>>
+  CheckCollisionsChunked(const world::KinematicObject& robot,
+                         absl::Span<const eigenmath::VectorXd> waypoints,
+                         const CheckCollisionsOptions& options,
+                         const ChunkedCheckCollisionsOptions& chunk_options,
+                         CheckCollisionsChunkCallback on_chunk);
+
+  // Clear the PlanTrajectory caches, both in the service and in this client.
   absl::StatusOr<google::protobuf::Empty> ClearCache();
 
  private:
+  class PlanCache;
+
+  intrinsic_proto::motion_planning::MotionPlanningRequest
+  MakeMotionPlanningRequest(
+      const intrinsic_proto::motion_planning::RobotSpecification&
+          robot_specification,
+      const intrinsic_proto::motion_planning::MotionSpecification&
+          motion_specification,
+      const MotionPlanningOptions& options, const std::string& caller_id,
+      const intrinsic_proto::data_logger::Context& context) const;
+
+  // Starts the given PlanTrajectory() call. `on_done` is called with whether
+  // the call succeeded once it has finished, possibly on another thread.
+  std::unique_ptr<PlanTrajectoryHandle> StartPlanTrajectory(
+      intrinsic_proto::motion_planning::MotionPlanningRequest request,
+      std::function<void(bool ok)> on_done = nullptr);
+
   std::string world_id_;
   std::shared_ptr<
       intrinsic_proto::motion_planning::MotionPlannerService::StubInterface>
       motion_planner_service_;
+  // Null if the client does not cache trajectories.
+  std::shared_ptr<PlanCache> plan_cache_;
+  CallPolicies call_policies_;
 };
 
 }  // namespace motion_planning
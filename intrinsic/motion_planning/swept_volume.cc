@@ -0,0 +1,99 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/motion_planning/swept_volume.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "grpcpp/client_context.h"
+#include "intrinsic/geometry/service/geometry_service.grpc.pb.h"
+#include "intrinsic/geometry/service/geometry_service.pb.h"
+#include "intrinsic/geometry/service/geometry_service_types.pb.h"
+#include "intrinsic/geometry/service/transformed_geometry_storage_refs.pb.h"
+#include "intrinsic/util/status/status_conversion_grpc.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic {
+namespace motion_planning {
+
+SweptVolume::SweptVolume(
+    std::vector<intrinsic_proto::geometry::TransformedGeometryStorageRefs>
+        shapes,
+    std::shared_ptr<intrinsic_proto::geometry::GeometryService::StubInterface>
+        geometry_service)
+    : shapes_(std::move(shapes)),
+      geometry_service_(std::move(geometry_service)) {}
+
+absl::StatusOr<
+    std::shared_ptr<const intrinsic_proto::geometry::GeometryWithMetadata>>
+SweptVolume::GetGeometry(size_t index) const {
+  if (index >= shapes_.size()) {
+    return absl::OutOfRangeError(absl::StrCat(
+        "No shape ", index, " in a swept volume of ", shapes_.size()));
+  }
+  const intrinsic_proto::geometry::GeometryStorageRefs& refs =
+      shapes_[index].geometry_storage_refs();
+  std::string key = refs.SerializeAsString();
+  {
+    absl::MutexLock lock(&mutex_);
+    if (auto it = geometries_.find(key); it != geometries_.end()) {
+      return it->second;
+    }
+  }
+
+  // Fetch without holding the lock, so that other shapes can be fetched at the
+  // same time. Concurrent calls for the same shape may fetch it twice.
+  intrinsic_proto::geometry::GetGeometryRequest request;
+  *request.mutable_geometry_storage_refs() = refs;
+  auto geometry =
+      std::make_shared<intrinsic_proto::geometry::GeometryWithMetadata>();
+  grpc::ClientContext ctx;
+  INTR_RETURN_IF_ERROR(ToAbslStatus(
+      geometry_service_->GetGeometry(&ctx, request, geometry.get())));
+
+  absl::MutexLock lock(&mutex_);
+  return geometries_.try_emplace(std::move(key), std::move(geometry))
+      .first->second;
+}
+
+absl::StatusOr<
+    std::shared_ptr<const intrinsic_proto::geometry::RenderableWithMetadata>>
+SweptVolume::GetRenderable(size_t index, uint32_t lod_level) const {
+  if (index >= shapes_.size()) {
+    return absl::OutOfRangeError(absl::StrCat(
+        "No shape ", index, " in a swept volume of ", shapes_.size()));
+  }
+  const intrinsic_proto::geometry::GeometryStorageRefs& refs =
+      shapes_[index].geometry_storage_refs();
+  std::pair<std::string, uint32_t> key(refs.SerializeAsString(), lod_level);
+  {
+    absl::MutexLock lock(&mutex_);
+    if (auto it = renderables_.find(key); it != renderables_.end()) {
+      return it->second;
+    }
+  }
+
+  intrinsic_proto::geometry::GetRenderableRequest request;
+  *request.mutable_geometry_storage_refs() = refs;
+  request.set_lod_level(lod_level);
+  auto renderable =
+      std::make_shared<intrinsic_proto::geometry::RenderableWithMetadata>();
+  grpc::ClientContext ctx;
+  INTR_RETURN_IF_ERROR(ToAbslStatus(
+      geometry_service_->GetRenderable(&ctx, request, renderable.get())));
+
+  absl::MutexLock lock(&mutex_);
+  return renderables_.try_emplace(std::move(key), std::move(renderable))
+      .first->second;
+}
+
+}  // namespace motion_planning
+}  // namespace intrinsic
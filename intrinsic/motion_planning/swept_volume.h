@@ -0,0 +1,102 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_MOTION_PLANNING_SWEPT_VOLUME_H_
+#define INTRINSIC_MOTION_PLANNING_SWEPT_VOLUME_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "intrinsic/geometry/service/geometry_service.grpc.pb.h"
+#include "intrinsic/geometry/service/geometry_service_types.pb.h"
+#include "intrinsic/geometry/service/transformed_geometry_storage_refs.pb.h"
+
+namespace intrinsic {
+namespace motion_planning {
+
+// The swept volume of a planned trajectory, see
+// MotionPlannerClient::PlanTrajectoryResult::swept_volume.
+//
+// The planning response only holds references to the shapes of the volume,
+// which stay small. Their geometry is fetched from the geometry service on
+// first use and kept for later calls; shapes that reference the same stored
+// geometry are fetched only once. For previews, GetRenderable() fetches a
+// simplified mesh of a shape instead of the exact geometry.
+//
+// Thread safe.
+class SweptVolume {
+ public:
+  SweptVolume(
+      std::vector<intrinsic_proto::geometry::TransformedGeometryStorageRefs>
+          shapes,
+      std::shared_ptr<
+          intrinsic_proto::geometry::GeometryService::StubInterface>
+          geometry_service);
+
+  SweptVolume(const SweptVolume&) = delete;
+  SweptVolume& operator=(const SweptVolume&) = delete;
+
+  // Returns the number of shapes of the volume.
+  size_t size() const { return shapes_.size(); }
+
+  // Returns true if the volume has no shapes, e.g., because it was not
+  // requested.
+  bool empty() const { return shapes_.empty(); }
+
+  // Returns the references to the shapes of the volume, each with its pose in
+  // the frame of the world.
+  const std::vector<intrinsic_proto::geometry::TransformedGeometryStorageRefs>&
+  shapes() const {
+    return shapes_;
+  }
+
+  // Returns the exact geometry of the shape with the given index.
+  //
+  // Returns OutOfRangeError if there is no such shape, and the error of the
+  // geometry service if fetching fails. Failures are not cached.
+  absl::StatusOr<
+      std::shared_ptr<const intrinsic_proto::geometry::GeometryWithMetadata>>
+  GetGeometry(size_t index) const ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the renderable mesh of the shape with the given index at the given
+  // level of detail. 0 is the original quality, and higher levels are
+  // increasingly decimated, which keeps previews of large volumes small.
+  //
+  // Returns OutOfRangeError if there is no such shape, and the error of the
+  // geometry service if fetching fails. Failures are not cached.
+  absl::StatusOr<
+      std::shared_ptr<const intrinsic_proto::geometry::RenderableWithMetadata>>
+  GetRenderable(size_t index, uint32_t lod_level) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  std::vector<intrinsic_proto::geometry::TransformedGeometryStorageRefs>
+      shapes_;
+  std::shared_ptr<intrinsic_proto::geometry::GeometryService::StubInterface>
+      geometry_service_;
+
+  mutable absl::Mutex mutex_;
+  // Fetched geometry by the serialized storage references of the shape.
+  mutable absl::flat_hash_map<
+      std::string,
+      std::shared_ptr<const intrinsic_proto::geometry::GeometryWithMetadata>>
+      geometries_ ABSL_GUARDED_BY(mutex_);
+  // Fetched renderables by the serialized storage references of the shape and
+  // the level of detail.
+  mutable absl::flat_hash_map<
+      std::pair<std::string, uint32_t>,
+      std::shared_ptr<const intrinsic_proto::geometry::RenderableWithMetadata>>
+      renderables_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace motion_planning
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_MOTION_PLANNING_SWEPT_VOLUME_H_
@@ -41,6 +41,10 @@ class EventFd {
   // When this pollfd signals, the user should call testAndClear().
   void SetupPoll(struct pollfd& poll_fd) const;
 
+  // Returns the file descriptor, e.g. to register it with epoll(7). -1 before
+  // Init().
+  int fd() const { return fd_; }
+
  private:
   int fd_ = -1;
 };
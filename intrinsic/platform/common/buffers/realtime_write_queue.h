@@ -8,8 +8,11 @@
 #include <cstdint>
 #include <cstring>
 #include <optional>
+#include <type_traits>
+#include <utility>
 
 #include "absl/base/attributes.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/time/time.h"
@@ -19,6 +22,9 @@
 
 namespace intrinsic {
 
+template <typename T>
+class RealtimeWriteQueueSet;
+
 // Possible results of a read.
 enum class ReadResult {
   // An item was consumed.
@@ -50,6 +56,8 @@ enum class ReadResult {
 // });
 // reader.Join();
 // writer.Join();
+//
+// To serve many queues from a single reader thread, see RealtimeWriteQueueSet.
 template <typename T>
 class RealtimeWriteQueue {
  public:
@@ -93,6 +101,25 @@ class RealtimeWriteQueue {
     // Returns true if the write succeeded. A write can fail if the queue is
     // full. It is invalid to call Write() after calling Close().
     ABSL_MUST_USE_RESULT bool Write(const T& item);
+    // Same as above, but moves `item` into the queue.
+    ABSL_MUST_USE_RESULT bool Write(T&& item);
+
+    // Passes the next free element to `fill`, which should set it in place,
+    // and makes it available to the reader. Returns false without calling
+    // `fill` if the queue is full. Realtime safe if `fill` is. It is invalid
+    // to call Emplace() after calling Close().
+    ABSL_MUST_USE_RESULT bool Emplace(absl::FunctionRef<void(T*)> fill);
+
+    // Assigns T(args...) to the next free element, without constructing a
+    // temporary at the call site just to copy it in. Returns false if the
+    // queue is full.
+    template <typename... Args,
+              typename = std::enable_if_t<std::is_constructible_v<T, Args...>>>
+    ABSL_MUST_USE_RESULT bool Emplace(Args&&... args) {
+      return Emplace([&args...](T* element) {
+        *element = T(std::forward<Args>(args)...);
+      });
+    }
 
     // Marks the queue as 'closed', further attempts to Write() to the queue
     // are invalid.
@@ -122,6 +149,8 @@ class RealtimeWriteQueue {
   RtWriter& Writer() { return writer_; }
 
  private:
+  friend RealtimeWriteQueueSet<T>;
+
   void InitEventFds();
 
   internal::RtQueueBuffer<T> buffer_;
@@ -201,12 +230,23 @@ void RealtimeWriteQueue<T>::NonRtReader::PollEvents(absl::Time deadline) {
 
 template <typename T>
 bool RealtimeWriteQueue<T>::RtWriter::Write(const T& item) {
+  return Emplace([&item](T* element) { *element = item; });
+}
+
+template <typename T>
+bool RealtimeWriteQueue<T>::RtWriter::Write(T&& item) {
+  return Emplace([&item](T* element) { *element = std::move(item); });
+}
+
+template <typename T>
+bool RealtimeWriteQueue<T>::RtWriter::Emplace(
+    absl::FunctionRef<void(T*)> fill) {
   CHECK(!closed_) << "Invalid to Write() after Close()ing the queue";
   T* element = buffer_.PrepareInsert();
   if (element == nullptr) {
     return false;
   }
-  *element = item;
+  fill(element);
   buffer_.FinishInsert();
   count_event_fd_.Signal();
   return true;
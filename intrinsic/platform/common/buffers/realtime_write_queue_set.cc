@@ -0,0 +1,81 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/common/buffers/realtime_write_queue_set.h"
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "absl/log/check.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "intrinsic/platform/common/buffers/internal/event_fd.h"
+
+namespace intrinsic::internal {
+
+namespace {
+
+// Returns the timeout for epoll_wait(2) in milliseconds, rounded up so that
+// the wait does not return before `deadline`.
+int EpollTimeoutMs(absl::Time deadline) {
+  if (deadline == absl::InfiniteFuture()) return -1;
+  const absl::Duration remaining =
+      std::max(deadline - absl::Now(), absl::ZeroDuration());
+  return static_cast<int>(std::min<int64_t>(
+      absl::ToInt64Milliseconds(absl::Ceil(remaining, absl::Milliseconds(1))),
+      INT_MAX));
+}
+
+}  // namespace
+
+EventFdEpoll::EventFdEpoll() : epoll_fd_(epoll_create1(EPOLL_CLOEXEC)) {
+  // NB: This can only fail due to limits on file descriptors or insufficient
+  // memory, which are unrecoverable for the process.
+  CHECK(epoll_fd_ >= 0) << "epoll_create1() failed with error: "
+                        << std::strerror(errno);
+}
+
+EventFdEpoll::~EventFdEpoll() { close(epoll_fd_); }
+
+void EventFdEpoll::Add(const EventFd& event_fd, uint64_t id) {
+  struct epoll_event event = {.events = EPOLLIN, .data = {.u64 = id}};
+  const int result =
+      epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, event_fd.fd(), &event);
+  CHECK(result == 0) << "epoll_ctl(EPOLL_CTL_ADD) failed with error: "
+                     << std::strerror(errno);
+}
+
+void EventFdEpoll::Remove(const EventFd& event_fd) {
+  const int result =
+      epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, event_fd.fd(), nullptr);
+  CHECK(result == 0) << "epoll_ctl(EPOLL_CTL_DEL) failed with error: "
+                     << std::strerror(errno);
+}
+
+size_t EventFdEpoll::Wait(absl::Time deadline, absl::Span<uint64_t> ids) {
+  constexpr size_t kMaxEvents = 64;
+  std::array<struct epoll_event, kMaxEvents> events;
+  const int max_events =
+      static_cast<int>(std::min(ids.size(), events.size()));
+  const int num_events = epoll_wait(epoll_fd_, events.data(), max_events,
+                                    EpollTimeoutMs(deadline));
+  // If the wait was interrupted by a signal, simply report no events and
+  // carry on.
+  if (num_events == -1 && errno == EINTR) return 0;
+  CHECK(num_events != -1) << "epoll_wait() failed with error: "
+                          << std::strerror(errno);
+  for (int i = 0; i < num_events; ++i) {
+    ids[i] = events[i].data.u64;
+  }
+  return num_events;
+}
+
+}  // namespace intrinsic::internal
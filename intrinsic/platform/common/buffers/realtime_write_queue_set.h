@@ -0,0 +1,209 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_COMMON_BUFFERS_REALTIME_WRITE_QUEUE_SET_H_
+#define INTRINSIC_PLATFORM_COMMON_BUFFERS_REALTIME_WRITE_QUEUE_SET_H_
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/log/check.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "intrinsic/platform/common/buffers/internal/event_fd.h"
+#include "intrinsic/platform/common/buffers/realtime_write_queue.h"
+
+namespace intrinsic {
+
+namespace internal {
+
+// Thin wrapper around an epoll(7) instance that reports which registered ids
+// are ready. Level-triggered, so an id is reported again until its event fds
+// have been read.
+class EventFdEpoll {
+ public:
+  EventFdEpoll();
+  ~EventFdEpoll();
+
+  EventFdEpoll(const EventFdEpoll&) = delete;
+  EventFdEpoll& operator=(const EventFdEpoll&) = delete;
+
+  // Reports `id` whenever `event_fd` is readable.
+  void Add(const EventFd& event_fd, uint64_t id);
+  void Remove(const EventFd& event_fd);
+
+  // Blocks until at least one registered event fd is readable or `deadline`
+  // passes, and writes the ids of up to `ids.size()` readable event fds to
+  // `ids`. Returns the number of ids written, which is zero on timeout or if
+  // the wait was interrupted by a signal.
+  size_t Wait(absl::Time deadline, absl::Span<uint64_t> ids);
+
+ private:
+  int epoll_fd_ = -1;
+};
+
+}  // namespace internal
+
+// Lets a single non-realtime reader block on any number of RealtimeWriteQueue
+// instances at once.
+//
+// The set waits on the event fds of all queues with one epoll(7) call and then
+// drains the queues that are ready, so a single consumer thread can serve many
+// realtime producers without spinning or polling each queue in turn. Producers
+// keep using RealtimeWriteQueue::Writer() unchanged.
+//
+// The set does not own the queues. A queue must be removed before it is
+// destroyed, and must not be read through its own Reader() while it is part
+// of a set.
+//
+// Add(), Remove() and Wake() are thread-safe and may be called while another
+// thread blocks in ReadWithTimeout(). At most one thread may call
+// ReadWithTimeout() at a time.
+//
+// Example usage:
+//
+// RealtimeWriteQueueSet<int> queues;
+// queues.Add(&queue_a);
+// queues.Add(&queue_b);
+// while (!stop) {
+//   queues.ReadWithTimeout(
+//       [](RealtimeWriteQueue<int>& queue, int& item) { Print(item); },
+//       absl::InfiniteFuture());
+// }
+template <typename T>
+class RealtimeWriteQueueSet {
+ public:
+  // Receives the items read by ReadWithTimeout() together with the queue they
+  // were read from.
+  using ConsumeFn = absl::FunctionRef<void(RealtimeWriteQueue<T>& queue,
+                                           T& item)>;
+
+  RealtimeWriteQueueSet();
+
+  // Adds `queue` to the set. Not realtime safe. `queue` must not be part of
+  // the set already.
+  void Add(RealtimeWriteQueue<T>* queue);
+
+  // Removes `queue` from the set. Not realtime safe. Waits until a concurrent
+  // ReadWithTimeout() has finished passing items to its consume function.
+  // Afterwards, reads of `queue` never reach a ReadWithTimeout() callback and
+  // remaining items can be read through `queue->Reader()`. No-op if `queue`
+  // is not part of the set.
+  void Remove(RealtimeWriteQueue<T>* queue);
+
+  // Blocks until at least one queue has items or was closed, Wake() is
+  // called, or `deadline` passes. Then reads all available items of every
+  // ready queue and passes each to `consume`. Returns the number of items
+  // consumed, which is zero on timeout or wake-up.
+  //
+  // `consume` runs while the set is locked and must not call Add() or
+  // Remove().
+  size_t ReadWithTimeout(ConsumeFn consume, absl::Time deadline);
+
+  size_t Read(ConsumeFn consume) {
+    return ReadWithTimeout(consume, absl::InfiniteFuture());
+  }
+
+  // Makes a concurrent or the next call to ReadWithTimeout() return, even if
+  // no queue is ready. Realtime safe.
+  void Wake() { wake_event_fd_.Signal(); }
+
+ private:
+  // Maximum number of ready event fds handled per wait. Further ready queues
+  // are reported by the next wait.
+  static constexpr size_t kMaxEventsPerWait = 64;
+  // The id reported for `wake_event_fd_`. Queues get ids starting at 1.
+  static constexpr uint64_t kWakeId = 0;
+
+  // Reads all available items of `queue`.
+  static size_t Drain(RealtimeWriteQueue<T>& queue, ConsumeFn consume);
+
+  internal::EventFdEpoll epoll_;
+  internal::EventFd wake_event_fd_;
+
+  absl::Mutex mutex_;
+  // Queues are identified by a never reused id, so that events which were
+  // reported for a queue just before it was removed are ignored.
+  uint64_t next_id_ ABSL_GUARDED_BY(mutex_) = kWakeId + 1;
+  absl::flat_hash_map<uint64_t, RealtimeWriteQueue<T>*> queues_by_id_
+      ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<RealtimeWriteQueue<T>*, uint64_t> ids_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+template <typename T>
+RealtimeWriteQueueSet<T>::RealtimeWriteQueueSet() {
+  const bool wake_inited = wake_event_fd_.Init();
+  CHECK(wake_inited) << "Failed to init wake_event_fd_ with error: "
+                     << std::strerror(errno);
+  epoll_.Add(wake_event_fd_, kWakeId);
+}
+
+template <typename T>
+void RealtimeWriteQueueSet<T>::Add(RealtimeWriteQueue<T>* queue) {
+  absl::MutexLock lock(&mutex_);
+  const uint64_t id = next_id_++;
+  const bool inserted = ids_.emplace(queue, id).second;
+  CHECK(inserted) << "Queue was added twice";
+  queues_by_id_[id] = queue;
+  epoll_.Add(queue->count_event_fd_, id);
+  epoll_.Add(queue->closed_event_fd_, id);
+}
+
+template <typename T>
+void RealtimeWriteQueueSet<T>::Remove(RealtimeWriteQueue<T>* queue) {
+  absl::MutexLock lock(&mutex_);
+  auto it = ids_.find(queue);
+  if (it == ids_.end()) return;
+  epoll_.Remove(queue->count_event_fd_);
+  epoll_.Remove(queue->closed_event_fd_);
+  queues_by_id_.erase(it->second);
+  ids_.erase(it);
+}
+
+template <typename T>
+size_t RealtimeWriteQueueSet<T>::ReadWithTimeout(ConsumeFn consume,
+                                                 absl::Time deadline) {
+  std::array<uint64_t, kMaxEventsPerWait> ready_ids;
+  const size_t num_ready = epoll_.Wait(deadline, absl::MakeSpan(ready_ids));
+
+  size_t consumed = 0;
+  absl::MutexLock lock(&mutex_);
+  for (size_t i = 0; i < num_ready; ++i) {
+    if (ready_ids[i] == kWakeId) {
+      (void)wake_event_fd_.Read();
+      continue;
+    }
+    auto it = queues_by_id_.find(ready_ids[i]);
+    // The queue was removed after the wait returned.
+    if (it == queues_by_id_.end()) continue;
+    consumed += Drain(*it->second, consume);
+  }
+  return consumed;
+}
+
+template <typename T>
+size_t RealtimeWriteQueueSet<T>::Drain(RealtimeWriteQueue<T>& queue,
+                                       ConsumeFn consume) {
+  // Always read until the reader reports something other than kConsumed, even
+  // if the buffer looks empty: that read clears the event fds of the queue,
+  // which would otherwise keep the level-triggered epoll ready.
+  size_t consumed = 0;
+  T item;
+  while (queue.Reader().ReadWithTimeout(item, absl::InfinitePast()) ==
+         ReadResult::kConsumed) {
+    consume(queue, item);
+    ++consumed;
+  }
+  return consumed;
+}
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_PLATFORM_COMMON_BUFFERS_REALTIME_WRITE_QUEUE_SET_H_
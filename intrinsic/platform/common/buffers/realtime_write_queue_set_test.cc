@@ -0,0 +1,125 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/common/buffers/realtime_write_queue_set.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/platform/common/buffers/realtime_write_queue.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(RealtimeWriteQueueSetTest, ReadsFromAllReadyQueues) {
+  RealtimeWriteQueue<int> queue_a;
+  RealtimeWriteQueue<int> queue_b;
+  RealtimeWriteQueue<int> queue_idle;
+  RealtimeWriteQueueSet<int> queues;
+  queues.Add(&queue_a);
+  queues.Add(&queue_b);
+  queues.Add(&queue_idle);
+
+  ASSERT_TRUE(queue_a.Writer().Write(1));
+  ASSERT_TRUE(queue_a.Writer().Write(2));
+  ASSERT_TRUE(queue_b.Writer().Write(10));
+
+  std::vector<int> from_a;
+  std::vector<int> from_b;
+  EXPECT_EQ(queues.Read([&](RealtimeWriteQueue<int>& queue, int& item) {
+    EXPECT_NE(&queue, &queue_idle);
+    (&queue == &queue_a ? from_a : from_b).push_back(item);
+  }),
+            3);
+  EXPECT_THAT(from_a, ElementsAre(1, 2));
+  EXPECT_THAT(from_b, ElementsAre(10));
+
+  // Everything was drained, so the next read times out.
+  EXPECT_EQ(queues.ReadWithTimeout([](RealtimeWriteQueue<int>&, int&) {},
+                                   absl::Now() + absl::Milliseconds(10)),
+            0);
+}
+
+TEST(RealtimeWriteQueueSetTest, WakeReturnsWithoutItems) {
+  RealtimeWriteQueue<int> queue;
+  RealtimeWriteQueueSet<int> queues;
+  queues.Add(&queue);
+
+  Thread waker([&queues]() {
+    absl::SleepFor(absl::Milliseconds(10));
+    queues.Wake();
+  });
+  EXPECT_EQ(queues.Read([](RealtimeWriteQueue<int>&, int&) {}), 0);
+  waker.Join();
+}
+
+TEST(RealtimeWriteQueueSetTest, RemovedQueueIsNotRead) {
+  RealtimeWriteQueue<int> queue_a;
+  RealtimeWriteQueue<int> queue_b;
+  RealtimeWriteQueueSet<int> queues;
+  queues.Add(&queue_a);
+  queues.Add(&queue_b);
+  queues.Remove(&queue_b);
+
+  ASSERT_TRUE(queue_a.Writer().Write(1));
+  ASSERT_TRUE(queue_b.Writer().Write(2));
+  std::vector<int> items;
+  EXPECT_EQ(queues.Read([&](RealtimeWriteQueue<int>&, int& item) {
+    items.push_back(item);
+  }),
+            1);
+  EXPECT_THAT(items, ElementsAre(1));
+
+  // The item is still in the removed queue.
+  int item = 0;
+  EXPECT_EQ(queue_b.Reader().Read(item), ReadResult::kConsumed);
+  EXPECT_EQ(item, 2);
+}
+
+TEST(RealtimeWriteQueueSetTest, ServesManyWritersFromOneReader) {
+  constexpr int kNumWriters = 4;
+  constexpr int kItemsPerWriter = 50;
+  std::vector<std::unique_ptr<RealtimeWriteQueue<int>>> queue_storage;
+  RealtimeWriteQueueSet<int> queues;
+  for (int i = 0; i < kNumWriters; ++i) {
+    queue_storage.push_back(std::make_unique<RealtimeWriteQueue<int>>(
+        /*capacity=*/kItemsPerWriter));
+    queues.Add(queue_storage.back().get());
+  }
+
+  std::vector<Thread> writers;
+  for (int w = 0; w < kNumWriters; ++w) {
+    writers.emplace_back([w, &queue = *queue_storage[w]]() {
+      for (int i = 0; i < kItemsPerWriter; ++i) {
+        ASSERT_TRUE(queue.Writer().Write(w * kItemsPerWriter + i));
+      }
+      queue.Writer().Close();
+    });
+  }
+
+  std::vector<int> last_item(kNumWriters, -1);
+  int total = 0;
+  while (total < kNumWriters * kItemsPerWriter) {
+    total += queues.Read([&](RealtimeWriteQueue<int>&, int& item) {
+      const int writer = item / kItemsPerWriter;
+      // Items of each writer arrive in order.
+      EXPECT_GT(item, last_item[writer]);
+      last_item[writer] = item;
+    });
+  }
+  for (Thread& writer : writers) writer.Join();
+  EXPECT_EQ(queues.ReadWithTimeout([](RealtimeWriteQueue<int>&, int&) {},
+                                   absl::Now() + absl::Milliseconds(10)),
+            0);
+}
+
+}  // namespace
+}  // namespace intrinsic
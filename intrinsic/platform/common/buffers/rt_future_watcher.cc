@@ -0,0 +1,65 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/common/buffers/rt_future_watcher.h"
+
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/log/log.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+
+FutureWatcher::FutureWatcher()
+    : FutureWatcher([](absl::AnyInvocable<void() &&> continuation) {
+        std::move(continuation)();
+      }) {}
+
+FutureWatcher::FutureWatcher(FutureExecutor executor)
+    : executor_(std::move(executor)), thread_([this]() { Run(); }) {}
+
+FutureWatcher::~FutureWatcher() {
+  stop_ = true;
+  (void)wake_.Post();
+  thread_.Join();
+}
+
+void FutureWatcher::Add(Watch watch) {
+  {
+    absl::MutexLock lock(&mutex_);
+    watches_.push_back(std::move(watch));
+  }
+  // The future may have become ready before it was added.
+  (void)wake_.Post();
+}
+
+void FutureWatcher::Run() {
+  std::vector<Watch> done;
+  while (true) {
+    if (auto status = wake_.WaitFor(absl::InfiniteDuration()); !status.ok()) {
+      LOG(ERROR) << "FutureWatcher failed to wait: " << status.message();
+    }
+    if (stop_) break;
+    {
+      absl::MutexLock lock(&mutex_);
+      for (size_t i = 0; i < watches_.size();) {
+        if (watches_[i].is_done()) {
+          done.push_back(std::move(watches_[i]));
+          watches_[i] = std::move(watches_.back());
+          watches_.pop_back();
+        } else {
+          ++i;
+        }
+      }
+    }
+    for (Watch& watch : done) {
+      executor_(std::move(watch.continuation));
+    }
+    done.clear();
+  }
+}
+
+}  // namespace intrinsic
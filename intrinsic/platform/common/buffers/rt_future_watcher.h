@@ -0,0 +1,215 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_FUTURE_WATCHER_H_
+#define INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_FUTURE_WATCHER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "intrinsic/icon/interprocess/binary_futex.h"
+#include "intrinsic/platform/common/buffers/rt_promise.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+
+// Runs a closure, e.g. by scheduling it on a thread pool. Must be thread-safe
+// if it is shared between watchers.
+using FutureExecutor = absl::AnyInvocable<void(absl::AnyInvocable<void() &&>)>;
+
+// Runs continuations of NonRealtimeFutures without blocking a thread per
+// future.
+//
+// A FutureWatcher owns a single thread that sleeps on one BinaryFutex. The
+// promises of watched futures post that futex when they set a value, are
+// cancelled or are destroyed, and the thread then hands the continuations of
+// all futures that are done to the executor.
+//
+// Example, fanning out requests to several modules and joining the results:
+//
+// FutureWatcher watcher;
+// NonRealtimeFuture<bool> module_a;
+// NonRealtimeFuture<bool> module_b;
+// ... hand module_a.GetPromise() and module_b.GetPromise() to realtime
+//     threads ...
+// NonRealtimeFuture<bool>* futures[] = {&module_a, &module_b};
+// RETURN_IF_ERROR(WhenAll<bool>(
+//     watcher, futures,
+//     [](std::vector<absl::StatusOr<bool>> results) { ... }));
+//
+// A watched future delivers its result to its continuation; Get*() must not be
+// called on it. The future must stay alive until its continuation has run,
+// and the watcher must outlive the promises of all futures it watched.
+// Continuations of futures that are not done when the watcher is destroyed
+// are never run.
+class FutureWatcher {
+ public:
+  // Runs continuations on the thread of the watcher. They must not block.
+  FutureWatcher();
+  // Hands continuations to `executor`.
+  explicit FutureWatcher(FutureExecutor executor);
+  ~FutureWatcher();
+
+  FutureWatcher(const FutureWatcher&) = delete;
+  FutureWatcher& operator=(const FutureWatcher&) = delete;
+
+  // Calls `callback` with the result of `future` once the promise has set a
+  // value, either side cancelled, or the promise was destroyed without a value
+  // (CancelledError). Not realtime safe.
+  //
+  // Returns FailedPreconditionError if `future` is already watched, or if its
+  // promise has already been destroyed.
+  template <typename T>
+  absl::Status Then(NonRealtimeFuture<T>& future,
+                    absl::AnyInvocable<void(absl::StatusOr<T>) &&> callback);
+
+ private:
+  struct Watch {
+    // Returns true once the continuation can run without blocking.
+    absl::AnyInvocable<bool()> is_done;
+    absl::AnyInvocable<void() &&> continuation;
+  };
+
+  // Returns the result of a future that is done.
+  template <typename T>
+  static absl::StatusOr<T> GetResult(NonRealtimeFuture<T>& future);
+  template <typename T>
+  static bool IsDone(const NonRealtimeFuture<T>& future);
+
+  void Add(Watch watch);
+  void Run();
+
+  FutureExecutor executor_;
+  // Posted by the promises of all watched futures.
+  icon::BinaryFutex wake_;
+  std::atomic<bool> stop_ = false;
+  absl::Mutex mutex_;
+  std::vector<Watch> watches_ ABSL_GUARDED_BY(mutex_);
+  Thread thread_;
+};
+
+// Calls `callback` with the results of all `futures`, in the same order, once
+// all of them are done. See FutureWatcher::Then().
+template <typename T>
+absl::Status WhenAll(
+    FutureWatcher& watcher, absl::Span<NonRealtimeFuture<T>* const> futures,
+    absl::AnyInvocable<void(std::vector<absl::StatusOr<T>>) &&> callback);
+
+// Calls `callback` with the index and result of the first of `futures` that is
+// done. The results of the other futures are dropped; they must nevertheless
+// stay alive until they are done. See FutureWatcher::Then().
+template <typename T>
+absl::Status WhenAny(
+    FutureWatcher& watcher, absl::Span<NonRealtimeFuture<T>* const> futures,
+    absl::AnyInvocable<void(size_t index, absl::StatusOr<T>) &&> callback);
+
+template <typename T>
+bool FutureWatcher::IsDone(const NonRealtimeFuture<T>& future) {
+  return future.is_ready_.Value() != 0 ||
+         future.is_cancelled_.load(std::memory_order_relaxed) ||
+         future.events_.PromiseDestroyed();
+}
+
+template <typename T>
+absl::StatusOr<T> FutureWatcher::GetResult(NonRealtimeFuture<T>& future) {
+  // The promise posts `is_ready_` before it is destroyed if it set a value.
+  if (future.is_ready_.Value() != 0 ||
+      future.is_cancelled_.load(std::memory_order_relaxed)) {
+    return future.Get();
+  }
+  return absl::CancelledError("Promise was destroyed without a value.");
+}
+
+template <typename T>
+absl::Status FutureWatcher::Then(
+    NonRealtimeFuture<T>& future,
+    absl::AnyInvocable<void(absl::StatusOr<T>) &&> callback) {
+  if (!future.events_.SetWatcher(&wake_)) {
+    return absl::FailedPreconditionError(
+        "Future is already watched or its promise has been destroyed.");
+  }
+  Add({.is_done = [&future]() { return IsDone(future); },
+       .continuation = [&future, callback = std::move(callback)]() mutable {
+         std::move(callback)(GetResult(future));
+       }});
+  return absl::OkStatus();
+}
+
+template <typename T>
+absl::Status WhenAll(
+    FutureWatcher& watcher, absl::Span<NonRealtimeFuture<T>* const> futures,
+    absl::AnyInvocable<void(std::vector<absl::StatusOr<T>>) &&> callback) {
+  struct State {
+    absl::Mutex mutex;
+    std::vector<std::optional<absl::StatusOr<T>>> results
+        ABSL_GUARDED_BY(mutex);
+    size_t remaining ABSL_GUARDED_BY(mutex);
+    absl::AnyInvocable<void(std::vector<absl::StatusOr<T>>) &&> callback;
+  };
+  auto state = std::make_shared<State>();
+  {
+    absl::MutexLock lock(&state->mutex);
+    state->results.resize(futures.size());
+    state->remaining = futures.size();
+  }
+  state->callback = std::move(callback);
+  if (futures.empty()) {
+    std::move(state->callback)({});
+    return absl::OkStatus();
+  }
+  for (size_t i = 0; i < futures.size(); ++i) {
+    absl::Status status = watcher.Then<T>(
+        *futures[i], [state, i](absl::StatusOr<T> result) {
+          std::vector<absl::StatusOr<T>> results;
+          {
+            absl::MutexLock lock(&state->mutex);
+            state->results[i] = std::move(result);
+            if (--state->remaining > 0) return;
+            results.reserve(state->results.size());
+            for (std::optional<absl::StatusOr<T>>& r : state->results) {
+              results.push_back(*std::move(r));
+            }
+          }
+          std::move(state->callback)(std::move(results));
+        });
+    // Futures that were added before still report to `state`, which then
+    // never completes.
+    if (!status.ok()) return status;
+  }
+  return absl::OkStatus();
+}
+
+template <typename T>
+absl::Status WhenAny(
+    FutureWatcher& watcher, absl::Span<NonRealtimeFuture<T>* const> futures,
+    absl::AnyInvocable<void(size_t index, absl::StatusOr<T>) &&> callback) {
+  struct State {
+    std::atomic<bool> done = false;
+    absl::AnyInvocable<void(size_t, absl::StatusOr<T>) &&> callback;
+  };
+  auto state = std::make_shared<State>();
+  state->callback = std::move(callback);
+  for (size_t i = 0; i < futures.size(); ++i) {
+    absl::Status status = watcher.Then<T>(
+        *futures[i], [state, i](absl::StatusOr<T> result) {
+          if (state->done.exchange(true)) return;
+          std::move(state->callback)(i, std::move(result));
+        });
+    if (!status.ok()) return status;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_FUTURE_WATCHER_H_
@@ -0,0 +1,153 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/common/buffers/rt_future_watcher.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "intrinsic/platform/common/buffers/rt_promise.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+namespace {
+
+using ::intrinsic::testing::IsOkAndHolds;
+using ::intrinsic::testing::StatusIs;
+
+TEST(FutureWatcherTest, ThenRunsWhenPromiseSetsValue) {
+  FutureWatcher watcher;
+  NonRealtimeFuture<int> future;
+  ASSERT_OK_AND_ASSIGN(RealtimePromise<int> promise, future.GetPromise());
+
+  absl::Notification done;
+  std::optional<absl::StatusOr<int>> result;
+  ASSERT_OK(watcher.Then<int>(future, [&](absl::StatusOr<int> r) {
+    result = std::move(r);
+    done.Notify();
+  }));
+  EXPECT_FALSE(done.HasBeenNotified());
+
+  Thread rt_thread([promise = std::move(promise)]() mutable {
+    ASSERT_OK(promise.SetValue(7));
+  });
+  done.WaitForNotification();
+  EXPECT_THAT(*result, IsOkAndHolds(7));
+  rt_thread.Join();
+}
+
+TEST(FutureWatcherTest, ThenRunsWhenValueWasSetBeforeWatching) {
+  FutureWatcher watcher;
+  NonRealtimeFuture<int> future;
+  ASSERT_OK_AND_ASSIGN(RealtimePromise<int> promise, future.GetPromise());
+  ASSERT_OK(promise.SetValue(3));
+
+  absl::Notification done;
+  ASSERT_OK(watcher.Then<int>(future, [&](absl::StatusOr<int> r) {
+    EXPECT_THAT(r, IsOkAndHolds(3));
+    done.Notify();
+  }));
+  done.WaitForNotification();
+}
+
+TEST(FutureWatcherTest, ThenReportsPromiseDestroyedWithoutValue) {
+  FutureWatcher watcher;
+  NonRealtimeFuture<int> future;
+  std::optional<RealtimePromise<int>> promise;
+  ASSERT_OK_AND_ASSIGN(promise, future.GetPromise());
+
+  absl::Notification done;
+  ASSERT_OK(watcher.Then<int>(future, [&](absl::StatusOr<int> r) {
+    EXPECT_THAT(r, StatusIs(absl::StatusCode::kCancelled));
+    done.Notify();
+  }));
+  promise.reset();
+  done.WaitForNotification();
+
+  // A future can only be watched once.
+  EXPECT_THAT(watcher.Then<int>(future, [](absl::StatusOr<int>) {}),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST(FutureWatcherTest, WhenAllJoinsResultsInOrder) {
+  FutureWatcher watcher;
+  constexpr int kNumFutures = 4;
+  NonRealtimeFuture<int> futures[kNumFutures];
+  std::vector<RealtimePromise<int>> promises;
+  for (NonRealtimeFuture<int>& future : futures) {
+    ASSERT_OK_AND_ASSIGN(RealtimePromise<int> promise, future.GetPromise());
+    promises.push_back(std::move(promise));
+  }
+  NonRealtimeFuture<int>* future_ptrs[kNumFutures];
+  for (int i = 0; i < kNumFutures; ++i) future_ptrs[i] = &futures[i];
+
+  absl::Notification done;
+  std::vector<absl::StatusOr<int>> results;
+  ASSERT_OK(WhenAll<int>(watcher, future_ptrs,
+                         [&](std::vector<absl::StatusOr<int>> r) {
+                           results = std::move(r);
+                           done.Notify();
+                         }));
+
+  // Complete the futures in reverse order from one thread.
+  Thread rt_thread([&promises]() {
+    for (int i = kNumFutures - 1; i >= 0; --i) {
+      if (i == 1) {
+        ASSERT_OK(promises[i].Cancel());
+      } else {
+        ASSERT_OK(promises[i].SetValue(i * 10));
+      }
+    }
+  });
+  done.WaitForNotification();
+  rt_thread.Join();
+  ASSERT_EQ(results.size(), kNumFutures);
+  EXPECT_THAT(results[0], IsOkAndHolds(0));
+  EXPECT_THAT(results[1], StatusIs(absl::StatusCode::kCancelled));
+  EXPECT_THAT(results[2], IsOkAndHolds(20));
+  EXPECT_THAT(results[3], IsOkAndHolds(30));
+}
+
+TEST(FutureWatcherTest, WhenAnyReportsFirstResultOnExecutor) {
+  absl::BlockingCounter executed(2);
+  FutureWatcher watcher([&](absl::AnyInvocable<void() &&> continuation) {
+    std::move(continuation)();
+    executed.DecrementCount();
+  });
+  NonRealtimeFuture<int> first;
+  NonRealtimeFuture<int> second;
+  ASSERT_OK_AND_ASSIGN(RealtimePromise<int> first_promise, first.GetPromise());
+  ASSERT_OK_AND_ASSIGN(RealtimePromise<int> second_promise,
+                       second.GetPromise());
+  NonRealtimeFuture<int>* future_ptrs[] = {&first, &second};
+
+  absl::Notification done;
+  std::optional<size_t> winner;
+  ASSERT_OK(WhenAny<int>(watcher, future_ptrs,
+                         [&](size_t index, absl::StatusOr<int> result) {
+                           winner = index;
+                           EXPECT_THAT(result, IsOkAndHolds(2));
+                           done.Notify();
+                         }));
+  ASSERT_OK(second_promise.SetValue(2));
+  done.WaitForNotification();
+  EXPECT_EQ(winner, 1);
+
+  // The other future still has to complete before it may be destroyed.
+  ASSERT_OK(first_promise.SetValue(1));
+  executed.Wait();
+}
+
+}  // namespace
+}  // namespace intrinsic
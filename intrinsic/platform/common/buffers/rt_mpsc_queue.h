@@ -0,0 +1,256 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_MPSC_QUEUE_H_
+#define INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_MPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "absl/base/attributes.h"
+#include "absl/base/optimization.h"
+#include "absl/functional/function_ref.h"
+#include "absl/log/check.h"
+#include "intrinsic/icon/utils/realtime_guard.h"
+
+namespace intrinsic {
+
+// Implementation of a Realtime-safe queue for multiple producers.
+//
+// This is a first-in-first-out (FIFO) lock-free queue with a fixed size that's
+// thread safe for any number of concurrent producers and a single consumer.
+// Unlike RealtimeQueueMultiWriter, which serializes producers with a mutex,
+// inserting never blocks, so several realtime threads can feed one consumer.
+//
+// Every slot carries a sequence number that tells producers and the consumer
+// whose turn it is to access the slot. A producer claims a slot with a single
+// compare-and-swap on the insert position and then publishes it by advancing
+// the sequence number of the slot; the consumer never writes to state shared
+// with producers other than the sequence number of the slot it releases.
+//
+// Like RealtimeQueue, this queue recycles its elements without any automatic
+// reset or clearing.
+//
+// Basic Usage:
+//
+// RealtimeMpscQueue<int> queue(/*capacity=*/64);
+//
+// // From any number of threads. Returns false if the queue was full.
+// bool success = queue.Insert(5);
+//
+// // From one thread only.
+// std::optional<int> value = queue.Pop();
+//
+// Realtime safe usage for non-trivial element types:
+//
+// bool success = queue.Emplace([&](MyProtoType* item) { item->set_...; });
+//
+// const MyProtoType* item = queue.Front();
+// if (item) {  // nullptr if queue is empty.
+//   DoSomething(*item);
+//   queue.DropFront();  // or queue.KeepFront() to leave item in queue.
+// }
+//
+// Elements are delivered in the order in which producers claimed their slots.
+// If a producer is preempted between claiming and publishing its slot, the
+// consumer sees the queue as empty until that producer publishes, even if later
+// slots have already been published.
+template <typename T>
+class RealtimeMpscQueue {
+ public:
+  static constexpr size_t kDefaultBufferCapacity = 100;
+  using value_type = T;
+
+  // Not copyable or moveable.
+  RealtimeMpscQueue(const RealtimeMpscQueue&) = delete;
+  RealtimeMpscQueue(RealtimeMpscQueue&&) = delete;
+
+  explicit RealtimeMpscQueue(size_t capacity = kDefaultBufferCapacity);
+
+  // Producer side. Thread-safe.
+
+  // Claims the next free element, passes it to `fill` and makes it available
+  // to the consumer. Returns false without calling `fill` if the queue is
+  // full. Realtime safe if `fill` is.
+  ABSL_MUST_USE_RESULT bool Emplace(absl::FunctionRef<void(T*)> fill);
+
+  // Assigns T(args...) to the next free element and returns true, or returns
+  // false if the queue is full. Not realtime safe if constructing or moving T
+  // allocates.
+  template <typename... Args,
+            typename = std::enable_if_t<std::is_constructible_v<T, Args...>>>
+  ABSL_MUST_USE_RESULT bool Emplace(Args&&... args) {
+    return Emplace(
+        [&args...](T* value) { *value = T(std::forward<Args>(args)...); });
+  }
+
+  // Copies or moves `item` into the queue and returns true if there is space,
+  // or false if the queue was full. Not realtime safe if copying or moving T
+  // allocates; use Emplace() instead.
+  ABSL_MUST_USE_RESULT bool Insert(const T& item);
+  ABSL_MUST_USE_RESULT bool Insert(T&& item);
+
+  // Consumer side. Thread-compatible, i.e., at most one thread may use these
+  // at a time.
+
+  // Gets a pointer to the front element, or nullptr if the queue is empty. If
+  // not empty, KeepFront or DropFront must be called before another call to
+  // Front is allowed.
+  ABSL_MUST_USE_RESULT T* Front();
+  // Keeps the front element.
+  void KeepFront();
+  // Removes the front element and hands its slot back to the producers.
+  void DropFront();
+  // Removes and returns a copy of the first element, or nullopt if empty. Due
+  // to the copy, this is not realtime safe for non-trivially-copyable objects;
+  // use Front/DropFront for realtime safety with non-trivial types.
+  ABSL_MUST_USE_RESULT std::optional<T> Pop();
+
+  // Returns true if no published element is waiting for the consumer.
+  // Thread-safe.
+  bool Empty() const;
+
+  // Returns the capacity of the queue.
+  size_t Capacity() const { return capacity_; }
+
+ private:
+  struct Slot {
+    // Equal to the insert position that may claim the slot next while the
+    // slot is free, and to that insert position plus one once the element is
+    // published.
+    std::atomic<uint64_t> sequence;
+    T value;
+  };
+
+  // Returns the claimed slot, or nullptr if the queue is full.
+  Slot* Claim();
+  // Makes the element of a slot returned by Claim() available to the
+  // consumer.
+  static void Publish(Slot& slot) {
+    slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_release);
+  }
+
+  const size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+
+  // The positions are on separate cache lines, so that producers and the
+  // consumer do not contend on them.
+  ABSL_CACHELINE_ALIGNED std::atomic<uint64_t> insert_position_ = 0;
+  ABSL_CACHELINE_ALIGNED std::atomic<uint64_t> front_position_ = 0;
+  bool front_accessed_ = false;
+};
+
+template <typename T>
+RealtimeMpscQueue<T>::RealtimeMpscQueue(size_t capacity)
+    : capacity_(capacity), slots_(std::make_unique<Slot[]>(capacity)) {
+  CHECK_GT(capacity_, 0) << "RealtimeMpscQueue needs a positive capacity.";
+  for (size_t i = 0; i < capacity_; ++i) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+template <typename T>
+typename RealtimeMpscQueue<T>::Slot* RealtimeMpscQueue<T>::Claim() {
+  uint64_t position = insert_position_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot& slot = slots_[position % capacity_];
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    const int64_t lag =
+        static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+    if (lag == 0) {
+      // The slot is free for this position. On failure, `position` is updated
+      // to the position claimed by another producer.
+      if (insert_position_.compare_exchange_weak(position, position + 1,
+                                                 std::memory_order_relaxed)) {
+        return &slot;
+      }
+    } else if (lag < 0) {
+      // The consumer has not released the slot from the previous round yet.
+      return nullptr;
+    } else {
+      // Another producer claimed this position in the meantime.
+      position = insert_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <typename T>
+bool RealtimeMpscQueue<T>::Emplace(absl::FunctionRef<void(T*)> fill) {
+  Slot* slot = Claim();
+  if (slot == nullptr) return false;
+  fill(&slot->value);
+  Publish(*slot);
+  return true;
+}
+
+template <typename T>
+bool RealtimeMpscQueue<T>::Insert(const T& item) {
+  if (!std::is_trivially_copyable<T>::value) {
+    INTRINSIC_ASSERT_NON_REALTIME();
+  }
+  return Emplace([&item](T* value) { *value = item; });
+}
+
+template <typename T>
+bool RealtimeMpscQueue<T>::Insert(T&& item) {
+  return Emplace([&item](T* value) { *value = std::move(item); });
+}
+
+template <typename T>
+T* RealtimeMpscQueue<T>::Front() {
+  CHECK(!front_accessed_)
+      << "KeepFront or DropFront must be called before another "
+         "call to Front is allowed.";
+  const uint64_t position = front_position_.load(std::memory_order_relaxed);
+  Slot& slot = slots_[position % capacity_];
+  if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+    return nullptr;
+  }
+  front_accessed_ = true;
+  return &slot.value;
+}
+
+template <typename T>
+void RealtimeMpscQueue<T>::KeepFront() {
+  CHECK(front_accessed_) << "Front must be called before KeepFront.";
+  front_accessed_ = false;
+}
+
+template <typename T>
+void RealtimeMpscQueue<T>::DropFront() {
+  CHECK(front_accessed_) << "Front must be called before DropFront.";
+  front_accessed_ = false;
+  const uint64_t position = front_position_.load(std::memory_order_relaxed);
+  // Frees the slot for the insert position of the next round.
+  slots_[position % capacity_].sequence.store(position + capacity_,
+                                              std::memory_order_release);
+  front_position_.store(position + 1, std::memory_order_relaxed);
+}
+
+template <typename T>
+std::optional<T> RealtimeMpscQueue<T>::Pop() {
+  if (!std::is_trivially_copyable<T>::value) {
+    INTRINSIC_ASSERT_NON_REALTIME();
+  }
+  const T* front_ptr = Front();
+  if (front_ptr == nullptr) return std::nullopt;
+  T front = *front_ptr;
+  DropFront();
+  return front;
+}
+
+template <typename T>
+bool RealtimeMpscQueue<T>::Empty() const {
+  const uint64_t position = front_position_.load(std::memory_order_relaxed);
+  return slots_[position % capacity_].sequence.load(
+             std::memory_order_acquire) != position + 1;
+}
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_MPSC_QUEUE_H_
@@ -0,0 +1,108 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/common/buffers/rt_mpsc_queue.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+namespace {
+
+using ::testing::Optional;
+
+TEST(RealtimeMpscQueueTest, InsertAndPopInOrder) {
+  RealtimeMpscQueue<int> queue(/*capacity=*/3);
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_EQ(queue.Pop(), std::nullopt);
+
+  EXPECT_TRUE(queue.Insert(1));
+  EXPECT_TRUE(queue.Insert(2));
+  EXPECT_FALSE(queue.Empty());
+  EXPECT_THAT(queue.Pop(), Optional(1));
+  EXPECT_THAT(queue.Pop(), Optional(2));
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(RealtimeMpscQueueTest, ReportsFullQueueAndWrapsAround) {
+  RealtimeMpscQueue<int> queue(/*capacity=*/2);
+  for (int round = 0; round < 5; ++round) {
+    EXPECT_TRUE(queue.Insert(2 * round));
+    EXPECT_TRUE(queue.Insert(2 * round + 1));
+    EXPECT_FALSE(queue.Insert(-1));
+    EXPECT_THAT(queue.Pop(), Optional(2 * round));
+    EXPECT_THAT(queue.Pop(), Optional(2 * round + 1));
+  }
+}
+
+TEST(RealtimeMpscQueueTest, EmplaceAndKeepFront) {
+  RealtimeMpscQueue<std::vector<int>> queue(/*capacity=*/2);
+  ASSERT_TRUE(queue.Emplace([](std::vector<int>* v) { v->assign({1, 2}); }));
+
+  std::vector<int>* front = queue.Front();
+  ASSERT_NE(front, nullptr);
+  EXPECT_EQ(front->size(), 2);
+  queue.KeepFront();
+
+  front = queue.Front();
+  ASSERT_NE(front, nullptr);
+  EXPECT_EQ(front->size(), 2);
+  queue.DropFront();
+  EXPECT_EQ(queue.Front(), nullptr);
+}
+
+TEST(RealtimeMpscQueueTest, ConcurrentInsert) {
+  constexpr int kNumWriters = 4;
+  constexpr int kIterationsPerWriter = 10000;
+  // Smaller than the number of elements, so that writers run into a full
+  // queue while the reader is draining it.
+  RealtimeMpscQueue<std::unique_ptr<int>> queue(/*capacity=*/64);
+
+  std::vector<Thread> writers;
+  for (int w = 0; w < kNumWriters; ++w) {
+    writers.emplace_back([&queue, w]() {
+      for (int i = 0; i < kIterationsPerWriter; ++i) {
+        auto value = std::make_unique<int>(w * kIterationsPerWriter + i);
+        // Insert() only moves from `value` on success.
+        while (!queue.Insert(std::move(value))) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  // Values of every writer arrive in the order in which it inserted them.
+  std::vector<int> next_expected(kNumWriters);
+  for (int w = 0; w < kNumWriters; ++w) {
+    next_expected[w] = w * kIterationsPerWriter;
+  }
+  size_t receive_count = 0;
+  while (receive_count < kNumWriters * kIterationsPerWriter) {
+    std::unique_ptr<int>* front = queue.Front();
+    if (front == nullptr) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_NE(*front, nullptr);
+    const int writer = **front / kIterationsPerWriter;
+    ASSERT_GE(writer, 0);
+    ASSERT_LT(writer, kNumWriters);
+    EXPECT_EQ(**front, next_expected[writer]);
+    ++next_expected[writer];
+    queue.DropFront();
+    ++receive_count;
+  }
+  for (Thread& writer : writers) writer.Join();
+  EXPECT_TRUE(queue.Empty());
+}
+
+}  // namespace
+}  // namespace intrinsic
@@ -4,6 +4,7 @@
 #define INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_PROMISE_H_
 
 #include <atomic>
+#include <cstdint>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/log/log.h"
@@ -47,10 +48,64 @@ namespace intrinsic {
 // * The promise can only be moved, but not copied.
 // * The future must always outlive any promise that may still be used,
 //   even in cases when `Future::Get*` may have received a timeout.
+// * To issue many requests without allocating a future for each, see
+//   PromisePool in rt_promise_pool.h.
 
-// Forward declaration.
+// Forward declarations.
 template <typename T>
 class NonRealtimeFuture;
+template <typename T>
+class PooledFuture;
+class FutureWatcher;
+
+namespace internal {
+
+// Lets a FutureWatcher learn that a future may have become ready without a
+// thread blocking on the future. The promise posts the futex of the watcher
+// after it set a value or was cancelled, and when it is destroyed.
+class FutureEvents {
+ public:
+  // Makes the promise post `watcher`. Returns false if a watcher was set
+  // before, or if the promise is being or has been destroyed, in which case
+  // it will not post.
+  bool SetWatcher(icon::BinaryFutex* watcher) {
+    uintptr_t expected = kNoWatcher;
+    return state_.compare_exchange_strong(
+        expected, reinterpret_cast<uintptr_t>(watcher));
+  }
+
+  // Returns true if the promise is being or has been destroyed.
+  bool PromiseDestroyed() const {
+    return state_.load() == kPromiseDestroyed;
+  }
+
+  // Called by the promise after it set a value or was cancelled. Realtime
+  // safe.
+  void Notify() const {
+    const uintptr_t state = state_.load();
+    if (state != kNoWatcher && state != kPromiseDestroyed) {
+      (void)reinterpret_cast<icon::BinaryFutex*>(state)->Post();
+    }
+  }
+
+  // Called by the promise before it signals its destruction to the future,
+  // after which it must not access the future anymore. Returns the watcher to
+  // post after that signal, or nullptr. Realtime safe.
+  icon::BinaryFutex* MarkPromiseDestroyed() {
+    const uintptr_t state = state_.exchange(kPromiseDestroyed);
+    if (state == kNoWatcher || state == kPromiseDestroyed) return nullptr;
+    return reinterpret_cast<icon::BinaryFutex*>(state);
+  }
+
+ private:
+  static constexpr uintptr_t kNoWatcher = 0;
+  static constexpr uintptr_t kPromiseDestroyed = 1;
+
+  // kNoWatcher, kPromiseDestroyed or the address of the watcher's futex.
+  std::atomic<uintptr_t> state_ = kNoWatcher;
+};
+
+}  // namespace internal
 
 // The real-time capable promise.
 // Can only be moved or (move-)assigned.
@@ -68,7 +123,8 @@ class RealtimePromise {
         is_ready_(promise.is_ready_),
         is_cancel_acknowledged_(promise.is_cancel_acknowledged_),
         is_destroyed_(promise.is_destroyed_),
-        is_cancelled_(promise.is_cancelled_) {
+        is_cancelled_(promise.is_cancelled_),
+        events_(promise.events_) {
     // We need to set is_ready_ to a nullptr on a moved from object to ensure
     // that the destructor is still fully functional on moved from objects.
     promise.is_ready_ = nullptr;
@@ -79,6 +135,7 @@ class RealtimePromise {
     is_cancel_acknowledged_ = promise.is_cancel_acknowledged_;
     is_destroyed_ = promise.is_destroyed_;
     is_cancelled_ = promise.is_cancelled_;
+    events_ = promise.events_;
 
     // We need to set is_ready_ to a nullptr on a moved from object to ensure
     // that the destructor is still fully functional on moved from objects.
@@ -98,6 +155,10 @@ class RealtimePromise {
       INTRINSIC_RT_LOG(ERROR) << "Failed to signal cancel acknowledgement: "
                               << post_error.message();
     }
+    // The watcher of the future, if any, lives independently of the future,
+    // so it can still be posted after the future is gone.
+    icon::BinaryFutex* watcher =
+        events_ == nullptr ? nullptr : events_->MarkPromiseDestroyed();
     // Signal the destruction of the promise to the future.
     post_error = is_destroyed_->Post();
     if (!post_error.ok()) {
@@ -107,6 +168,7 @@ class RealtimePromise {
     // The call to is_destroyed_->Post(); must be the last call to any member
     // pointer since the future might be waiting to destruct the pointers'
     // memory!
+    if (watcher != nullptr) (void)watcher->Post();
   }
 
   // Sets the value of the promise, which will make the future become ready.
@@ -149,7 +211,9 @@ class RealtimePromise {
     // Preemptively confirm the cancellation so the future won't have to wait
     // on the promise when it's destructed.
     INTRINSIC_RT_RETURN_IF_ERROR(is_cancel_acknowledged_->Post());
-    return is_ready_->Post();
+    INTRINSIC_RT_RETURN_IF_ERROR(is_ready_->Post());
+    if (events_ != nullptr) events_->Notify();
+    return icon::OkStatus();
   }
 
   // Cancels the promise and informs the corresponding future.
@@ -163,7 +227,9 @@ class RealtimePromise {
     INTRINSIC_RT_RETURN_IF_ERROR(
         is_ready_->Post());  // So that the future, which waits for a value,
                              // returns early.
-    return is_cancel_acknowledged_->Post();
+    INTRINSIC_RT_RETURN_IF_ERROR(is_cancel_acknowledged_->Post());
+    if (events_ != nullptr) events_->Notify();
+    return icon::OkStatus();
   }
 
   // Returns true if the promise or the corresponding future have been
@@ -178,6 +244,7 @@ class RealtimePromise {
 
  private:
   friend class NonRealtimeFuture<T>;
+  friend class PooledFuture<T>;
 
   // Constructor.
   // Does not take ownership of any pointers, thus all pointers must outlive the
@@ -186,12 +253,14 @@ class RealtimePromise {
                   icon::BinaryFutex* is_ready,
                   icon::BinaryFutex* is_cancel_acknowledged,
                   icon::BinaryFutex* is_destroyed,
-                  std::atomic_bool* is_cancelled)
+                  std::atomic_bool* is_cancelled,
+                  internal::FutureEvents* events = nullptr)
       : buffer_(buffer),
         is_ready_(is_ready),
         is_cancel_acknowledged_(is_cancel_acknowledged),
         is_destroyed_(is_destroyed),
-        is_cancelled_(is_cancelled) {}
+        is_cancelled_(is_cancelled),
+        events_(events) {}
 
   // The buffer used for passing the value from the promise to the future.
   internal::RtQueueBuffer<T>* buffer_ = nullptr;
@@ -204,6 +273,9 @@ class RealtimePromise {
   icon::BinaryFutex* is_destroyed_ = nullptr;
   // Whether the future/promise has been cancelled.
   std::atomic_bool* is_cancelled_ = nullptr;
+  // Notifies a FutureWatcher of the future, or nullptr if watching is not
+  // supported.
+  internal::FutureEvents* events_ = nullptr;
 };
 
 // The non-real time capable future.
@@ -338,6 +410,8 @@ class NonRealtimeFuture {
   }
 
  private:
+  friend class FutureWatcher;
+
   // Non thread-safe implementation for cancelling the future.
   // Called in cases where the `synchronization_mutex_` is already held.
   INTRINSIC_NON_REALTIME_ONLY absl::Status UnprotectedCancel()
@@ -345,6 +419,7 @@ class NonRealtimeFuture {
     bool was_cancelled =
         is_cancelled_.exchange(true, std::memory_order_relaxed);
     if (!was_cancelled) {
+      events_.Notify();
       INTRINSIC_RT_RETURN_IF_ERROR(
           is_cancel_acknowledged_.WaitFor(cancellation_confirm_timeout_));
     }
@@ -361,7 +436,10 @@ class NonRealtimeFuture {
   // Used by future to wait for the promise to be destroyed.
   icon::BinaryFutex is_destroyed_;
   // Whether the future/promise has been cancelled.
-  std::atomic_bool is_cancelled_;
+  std::atomic_bool is_cancelled_ = false;
+  // Notifies a FutureWatcher, see FutureWatcher::Then(). Must be declared
+  // before `promise_`, which uses it on destruction.
+  internal::FutureEvents events_;
   // Whether the value has been retrieved from the future.
   bool is_value_retrieved_ = false;
   // The promise has this much time to confirm the future's cancellation.
@@ -371,7 +449,8 @@ class NonRealtimeFuture {
       RealtimePromise<T>(/*buffer=*/&buffer_, /*is_ready=*/&is_ready_,
                          /*is_cancel_acknowledged=*/&is_cancel_acknowledged_,
                          /*is_destroyed=*/&is_destroyed_,
-                         /*is_cancelled=*/&is_cancelled_);
+                         /*is_cancelled=*/&is_cancelled_,
+                         /*events=*/&events_);
   // Indicates whether the promise has been retrieved through `GetPromise`.
   bool promise_was_moved_ = false;
   // Mutex to ensure reentrancy and thread-safety.
@@ -0,0 +1,343 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_PROMISE_POOL_H_
+#define INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_PROMISE_POOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/interprocess/binary_futex.h"
+#include "intrinsic/icon/testing/realtime_annotations.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/icon/utils/realtime_status_macro.h"
+#include "intrinsic/platform/common/buffers/rt_promise.h"
+#include "intrinsic/platform/common/buffers/rt_queue_buffer.h"
+
+namespace intrinsic {
+
+template <typename T>
+class PromisePool;
+
+// A future whose state lives in a PromisePool. Same semantics as
+// NonRealtimeFuture, but movable and non-blocking on destruction.
+template <typename T>
+class PooledFuture {
+ public:
+  // Creates an invalid future. All calls except the destructor fail.
+  PooledFuture() = default;
+  PooledFuture(const PooledFuture&) = delete;
+  PooledFuture& operator=(const PooledFuture&) = delete;
+  PooledFuture(PooledFuture&& other)
+      : pool_(std::exchange(other.pool_, nullptr)),
+        index_(other.index_),
+        generation_(other.generation_) {}
+  PooledFuture& operator=(PooledFuture&& other) {
+    if (this != &other) {
+      Release();
+      pool_ = std::exchange(other.pool_, nullptr);
+      index_ = other.index_;
+      generation_ = other.generation_;
+    }
+    return *this;
+  }
+  // Returns the slot to the pool. Cancels the promise if it may still be used.
+  ~PooledFuture() { Release(); }
+
+  // Returns a promise that may then be moved around for the value to be set.
+  // Must only be called once or will return an `AlreadyExistsError`.
+  INTRINSIC_NON_REALTIME_ONLY absl::StatusOr<RealtimePromise<T>> GetPromise();
+
+  // Waits until `deadline` for the promise to set a value. Returns the same
+  // errors as NonRealtimeFuture::GetWithDeadline(), and a
+  // `FailedPreconditionError` if this future is invalid.
+  INTRINSIC_NON_REALTIME_ONLY absl::StatusOr<T> GetWithDeadline(
+      absl::Time deadline);
+  INTRINSIC_NON_REALTIME_ONLY absl::StatusOr<T> GetWithTimeout(
+      absl::Duration timeout) {
+    return GetWithDeadline(absl::Now() + timeout);
+  }
+  INTRINSIC_NON_REALTIME_ONLY absl::StatusOr<T> Get() {
+    return GetWithDeadline(absl::InfiniteFuture());
+  }
+
+  // Returns true if the value is available and a call to `Get*` would return
+  // immediately.
+  bool IsReady() const;
+
+  // Cancels the future and waits for the promise to confirm, see
+  // NonRealtimeFuture::Cancel().
+  INTRINSIC_NON_REALTIME_ONLY absl::Status Cancel();
+
+  // Returns false for default-constructed and moved-from futures.
+  bool valid() const { return pool_ != nullptr; }
+
+ private:
+  friend class PromisePool<T>;
+  using Slot = typename PromisePool<T>::Slot;
+
+  PooledFuture(PromisePool<T>* pool, uint32_t index, uint64_t generation)
+      : pool_(pool), index_(index), generation_(generation) {}
+
+  // Returns the slot of this future, or an error if the future is invalid or
+  // the slot has been recycled.
+  absl::StatusOr<Slot*> GetSlot() const;
+  void Release();
+
+  PromisePool<T>* pool_ = nullptr;
+  uint32_t index_ = 0;
+  uint64_t generation_ = 0;
+};
+
+// A preallocated pool of future/promise pairs.
+//
+// NonRealtimeFuture allocates its value buffer and owns its futexes, so every
+// request that uses one pays for a heap allocation, and its destructor blocks
+// until the promise is gone. A PromisePool allocates the state of `capacity`
+// pairs once and recycles it: Acquire() hands out a PooledFuture, whose
+// GetPromise() returns a regular RealtimePromise, so code that takes a
+// RealtimePromise (e.g. icon::AsyncRequest) works unchanged.
+//
+// A slot is recycled once both its future and its promise have been destroyed,
+// in any order. Destroying a PooledFuture never blocks; if its promise is still
+// alive, the future is cancelled and the slot is reclaimed by a later
+// Acquire(). Every recycling increments the generation of the slot, and a
+// PooledFuture checks that generation on every call, so a stale handle fails
+// instead of touching a recycled slot.
+//
+// Example:
+//
+// PromisePool<bool> pool(/*capacity=*/64);
+// ASSIGN_OR_RETURN(PooledFuture<bool> future, pool.Acquire());
+// ASSIGN_OR_RETURN(RealtimePromise<bool> promise, future.GetPromise());
+// AsyncRequest<int, bool> request(request_value, std::move(promise));
+// ... hand `request` to the realtime thread ...
+// ASSIGN_OR_RETURN(bool result, future.Get());
+//
+// The pool must outlive all of its futures and promises. Acquire() is
+// thread-safe. Each PooledFuture is thread-compatible.
+template <typename T>
+class PromisePool {
+ public:
+  // Allocates the state of `capacity` future/promise pairs. A promise has
+  // `cancellation_confirm_timeout` to confirm a PooledFuture::Cancel().
+  explicit PromisePool(
+      size_t capacity,
+      absl::Duration cancellation_confirm_timeout = absl::Seconds(1));
+
+  PromisePool(const PromisePool&) = delete;
+  PromisePool& operator=(const PromisePool&) = delete;
+
+  // Returns a future backed by a free slot. Does not allocate. Returns a
+  // `ResourceExhaustedError` if all slots are in use.
+  INTRINSIC_NON_REALTIME_ONLY absl::StatusOr<PooledFuture<T>> Acquire();
+
+  // Returns the number of slots that are not used by any future or promise.
+  size_t NumFree();
+
+  size_t Capacity() const { return capacity_; }
+
+ private:
+  friend class PooledFuture<T>;
+
+  // The state of one future/promise pair, matching the members of
+  // NonRealtimeFuture.
+  struct Slot {
+    internal::RtQueueBuffer<T> buffer{/*capacity=*/1};
+    icon::BinaryFutex is_ready;
+    icon::BinaryFutex is_cancel_acknowledged;
+    icon::BinaryFutex is_destroyed;
+    std::atomic_bool is_cancelled = false;
+    bool is_value_retrieved = false;
+    bool promise_was_moved = false;
+    std::atomic<uint64_t> generation = 0;
+  };
+
+  // Called when the future of slot `index` is destroyed.
+  void Release(uint32_t index);
+  // Moves the slots whose promises have been destroyed since their futures
+  // were released to the free list.
+  void ReclaimPendingLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Resets slot `index`, invalidates all handles to it and frees it.
+  void RecycleLocked(uint32_t index) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const size_t capacity_;
+  const absl::Duration cancellation_confirm_timeout_;
+  std::unique_ptr<Slot[]> slots_;
+
+  absl::Mutex mutex_;
+  // Both lists have `capacity_` reserved, so they never allocate.
+  std::vector<uint32_t> free_ ABSL_GUARDED_BY(mutex_);
+  // Slots whose future was released while their promise was still alive.
+  std::vector<uint32_t> pending_ ABSL_GUARDED_BY(mutex_);
+};
+
+template <typename T>
+PromisePool<T>::PromisePool(size_t capacity,
+                            absl::Duration cancellation_confirm_timeout)
+    : capacity_(capacity),
+      cancellation_confirm_timeout_(cancellation_confirm_timeout),
+      slots_(std::make_unique<Slot[]>(capacity)) {
+  CHECK_GT(capacity_, 0) << "PromisePool needs a positive capacity.";
+  absl::MutexLock lock(&mutex_);
+  free_.reserve(capacity_);
+  pending_.reserve(capacity_);
+  // Hand out low indices first.
+  for (size_t i = capacity_; i > 0; --i) {
+    free_.push_back(i - 1);
+  }
+}
+
+template <typename T>
+absl::StatusOr<PooledFuture<T>> PromisePool<T>::Acquire() {
+  absl::MutexLock lock(&mutex_);
+  if (free_.empty()) ReclaimPendingLocked();
+  if (free_.empty()) {
+    return absl::ResourceExhaustedError(
+        "All futures of the PromisePool are in use.");
+  }
+  const uint32_t index = free_.back();
+  free_.pop_back();
+  return PooledFuture<T>(
+      this, index, slots_[index].generation.load(std::memory_order_relaxed));
+}
+
+template <typename T>
+size_t PromisePool<T>::NumFree() {
+  absl::MutexLock lock(&mutex_);
+  ReclaimPendingLocked();
+  return free_.size();
+}
+
+template <typename T>
+void PromisePool<T>::Release(uint32_t index) {
+  Slot& slot = slots_[index];
+  absl::MutexLock lock(&mutex_);
+  if (slot.promise_was_moved && !slot.is_destroyed.Value()) {
+    // Makes the promise fail instead of setting a value nobody reads.
+    slot.is_cancelled.store(true, std::memory_order_relaxed);
+    pending_.push_back(index);
+    return;
+  }
+  RecycleLocked(index);
+}
+
+template <typename T>
+void PromisePool<T>::ReclaimPendingLocked() {
+  for (size_t i = 0; i < pending_.size();) {
+    if (slots_[pending_[i]].is_destroyed.Value()) {
+      RecycleLocked(pending_[i]);
+      pending_[i] = pending_.back();
+      pending_.pop_back();
+    } else {
+      ++i;
+    }
+  }
+}
+
+template <typename T>
+void PromisePool<T>::RecycleLocked(uint32_t index) {
+  Slot& slot = slots_[index];
+  if (slot.buffer.Front() != nullptr) slot.buffer.DropFront();
+  slot.is_ready = icon::BinaryFutex();
+  slot.is_cancel_acknowledged = icon::BinaryFutex();
+  slot.is_destroyed = icon::BinaryFutex();
+  slot.is_cancelled.store(false, std::memory_order_relaxed);
+  slot.is_value_retrieved = false;
+  slot.promise_was_moved = false;
+  slot.generation.fetch_add(1, std::memory_order_relaxed);
+  free_.push_back(index);
+}
+
+template <typename T>
+absl::StatusOr<typename PooledFuture<T>::Slot*> PooledFuture<T>::GetSlot()
+    const {
+  if (pool_ == nullptr) {
+    return absl::FailedPreconditionError("Invalid PooledFuture.");
+  }
+  Slot* slot = &pool_->slots_[index_];
+  if (slot->generation.load(std::memory_order_relaxed) != generation_) {
+    return absl::FailedPreconditionError(
+        "PooledFuture refers to a recycled slot.");
+  }
+  return slot;
+}
+
+template <typename T>
+void PooledFuture<T>::Release() {
+  if (pool_ == nullptr) return;
+  std::exchange(pool_, nullptr)->Release(index_);
+}
+
+template <typename T>
+absl::StatusOr<RealtimePromise<T>> PooledFuture<T>::GetPromise() {
+  absl::StatusOr<Slot*> slot = GetSlot();
+  if (!slot.ok()) return slot.status();
+  if ((*slot)->promise_was_moved) {
+    return absl::AlreadyExistsError(
+        "GetPromise must only be called once on a future.");
+  }
+  (*slot)->promise_was_moved = true;
+  return RealtimePromise<T>(
+      /*buffer=*/&(*slot)->buffer, /*is_ready=*/&(*slot)->is_ready,
+      /*is_cancel_acknowledged=*/&(*slot)->is_cancel_acknowledged,
+      /*is_destroyed=*/&(*slot)->is_destroyed,
+      /*is_cancelled=*/&(*slot)->is_cancelled);
+}
+
+template <typename T>
+absl::StatusOr<T> PooledFuture<T>::GetWithDeadline(absl::Time deadline) {
+  absl::StatusOr<Slot*> slot = GetSlot();
+  if (!slot.ok()) return slot.status();
+  Slot& s = **slot;
+  if (s.is_value_retrieved) {
+    return absl::ResourceExhaustedError("Value has already been retrieved.");
+  }
+  if (s.is_cancelled.load(std::memory_order_relaxed)) {
+    return absl::CancelledError("Future or promise have been cancelled.");
+  }
+  INTRINSIC_RT_RETURN_IF_ERROR(s.is_ready.WaitUntil(deadline));
+  // Cancel() might have been called in the meantime, so we need to check
+  // again.
+  if (s.is_cancelled.load(std::memory_order_relaxed)) {
+    return absl::CancelledError("Future or promise have been cancelled.");
+  }
+  s.is_value_retrieved = true;
+  T* value = s.buffer.Front();
+  T result = *value;
+  s.buffer.DropFront();
+  return result;
+}
+
+template <typename T>
+bool PooledFuture<T>::IsReady() const {
+  absl::StatusOr<Slot*> slot = GetSlot();
+  return slot.ok() && !(*slot)->buffer.Empty();
+}
+
+template <typename T>
+absl::Status PooledFuture<T>::Cancel() {
+  absl::StatusOr<Slot*> slot = GetSlot();
+  if (!slot.ok()) return slot.status();
+  const bool was_cancelled =
+      (*slot)->is_cancelled.exchange(true, std::memory_order_relaxed);
+  if (!was_cancelled) {
+    INTRINSIC_RT_RETURN_IF_ERROR((*slot)->is_cancel_acknowledged.WaitFor(
+        pool_->cancellation_confirm_timeout_));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_PROMISE_POOL_H_
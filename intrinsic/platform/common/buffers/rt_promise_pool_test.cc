@@ -0,0 +1,95 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/common/buffers/rt_promise_pool.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "intrinsic/platform/common/buffers/rt_promise.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+namespace {
+
+using ::intrinsic::testing::IsOkAndHolds;
+using ::intrinsic::testing::StatusIs;
+using ::testing::Eq;
+
+TEST(PromisePoolTest, PassesValueFromPromiseToFuture) {
+  PromisePool<int> pool(/*capacity=*/2);
+  ASSERT_OK_AND_ASSIGN(PooledFuture<int> future, pool.Acquire());
+  ASSERT_OK_AND_ASSIGN(RealtimePromise<int> promise, future.GetPromise());
+
+  Thread rt_thread([promise = std::move(promise)]() mutable {
+    ASSERT_OK(promise.SetValue(42));
+  });
+  EXPECT_THAT(future.Get(), IsOkAndHolds(Eq(42)));
+  EXPECT_THAT(future.Get(), StatusIs(absl::StatusCode::kResourceExhausted));
+  EXPECT_THAT(future.GetPromise(), StatusIs(absl::StatusCode::kAlreadyExists));
+  rt_thread.Join();
+}
+
+TEST(PromisePoolTest, RecyclesSlotsOnceFutureAndPromiseAreDestroyed) {
+  PromisePool<int> pool(/*capacity=*/1);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK_AND_ASSIGN(PooledFuture<int> future, pool.Acquire());
+    EXPECT_EQ(pool.NumFree(), 0);
+    EXPECT_THAT(pool.Acquire(), StatusIs(absl::StatusCode::kResourceExhausted));
+    ASSERT_OK_AND_ASSIGN(RealtimePromise<int> promise, future.GetPromise());
+    ASSERT_OK(promise.SetValue(i));
+    EXPECT_THAT(future.Get(), IsOkAndHolds(Eq(i)));
+  }
+  EXPECT_EQ(pool.NumFree(), 1);
+}
+
+TEST(PromisePoolTest, ReleasingFutureFirstCancelsPromiseWithoutBlocking) {
+  PromisePool<int> pool(/*capacity=*/1);
+  std::optional<RealtimePromise<int>> promise;
+  {
+    ASSERT_OK_AND_ASSIGN(PooledFuture<int> future, pool.Acquire());
+    ASSERT_OK_AND_ASSIGN(promise, future.GetPromise());
+  }
+  // The promise still refers to the slot, so it is not free yet.
+  EXPECT_EQ(pool.NumFree(), 0);
+  EXPECT_THAT(promise->SetValue(1), StatusIs(absl::StatusCode::kCancelled));
+
+  promise.reset();
+  EXPECT_EQ(pool.NumFree(), 1);
+  ASSERT_OK_AND_ASSIGN(PooledFuture<int> future, pool.Acquire());
+  EXPECT_FALSE(future.IsReady());
+  ASSERT_OK_AND_ASSIGN(RealtimePromise<int> new_promise, future.GetPromise());
+  ASSERT_OK(new_promise.SetValue(2));
+  EXPECT_THAT(future.Get(), IsOkAndHolds(Eq(2)));
+}
+
+TEST(PromisePoolTest, CancelReachesPromise) {
+  PromisePool<int> pool(/*capacity=*/1, absl::Milliseconds(100));
+  ASSERT_OK_AND_ASSIGN(PooledFuture<int> future, pool.Acquire());
+  ASSERT_OK_AND_ASSIGN(RealtimePromise<int> promise, future.GetPromise());
+
+  ASSERT_OK(promise.Cancel());
+  ASSERT_OK(future.Cancel());
+  EXPECT_THAT(future.Get(), StatusIs(absl::StatusCode::kCancelled));
+  EXPECT_THAT(promise.IsCancelled(), IsOkAndHolds(true));
+}
+
+TEST(PromisePoolTest, MovedFromFutureIsInvalid) {
+  PromisePool<int> pool(/*capacity=*/1);
+  ASSERT_OK_AND_ASSIGN(PooledFuture<int> future, pool.Acquire());
+  PooledFuture<int> moved = std::move(future);
+
+  EXPECT_FALSE(future.valid());  // NOLINT(bugprone-use-after-move)
+  EXPECT_THAT(future.GetPromise(),  // NOLINT(bugprone-use-after-move)
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  EXPECT_TRUE(moved.valid());
+  EXPECT_OK(moved.GetPromise());
+}
+
+}  // namespace
+}  // namespace intrinsic
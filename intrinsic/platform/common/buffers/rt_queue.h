@@ -7,8 +7,11 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <type_traits>
+#include <utility>
 
 #include "absl/base/attributes.h"
+#include "absl/functional/function_ref.h"
 #include "absl/memory/memory.h"
 #include "absl/types/optional.h"
 #include "intrinsic/icon/utils/realtime_guard.h"
@@ -71,6 +74,20 @@ class RealtimeQueueBase {
 //   reader->DropFront();  // or reader->KeepFront() to leave item in queue.
 // }
 //
+// Batched usage, which synchronizes with the other side once per batch
+// instead of once per element:
+//
+// internal::RtQueueSpans<int> items = writer->PrepareInsertN(16);
+// for (size_t i = 0; i < items.size(); ++i) items[i] = ...;
+// writer->FinishInsertN(items.size());  // nothing to finish if empty.
+//
+// internal::RtQueueSpans<int> items = reader->FrontN(16);
+// if (!items.empty()) {
+//   for (int item : items.first) DoSomething(item);
+//   for (int item : items.second) DoSomething(item);
+//   reader->DropFrontN(items.size());
+// }
+//
 // If PrepareInsert returns a non-null value, it must be followed by a call to
 // FinishInsert before it can be called again. Likewise, if Front returns a
 // non-null value, it must be followed by a call to DropFront or KeepFront
@@ -109,6 +126,14 @@ class RealtimeQueue : public RealtimeQueueBase {
     void KeepFront() { buffer_.KeepFront(); }
     // Removes the front element; no-op if the queue is empty.
     void DropFront() { buffer_.DropFront(); }
+    // Gets up to `max_count` elements from the front, as up to two contiguous
+    // spans, or an empty range if empty. If not empty, KeepFront or DropFrontN
+    // must be called before another call to Front or FrontN is allowed.
+    ABSL_MUST_USE_RESULT internal::RtQueueSpans<T> FrontN(size_t max_count) {
+      return buffer_.FrontN(max_count);
+    }
+    // Removes the first `count` elements returned by FrontN at once.
+    void DropFrontN(size_t count) { buffer_.DropFrontN(count); }
     // Removes and returns a copy of the first element, or nullopt if empty.
     // Due to the copy, this is not realtime safe for non-trivially-copyable
     // objects; use Front/DropFront for realtime safety with non-trivial types.
@@ -145,11 +170,45 @@ class RealtimeQueue : public RealtimeQueueBase {
     // Make the element referenced by the return value of PrepareInsert
     // available to the reader.
     void FinishInsert() { buffer_.FinishInsert(); }
+    // Gets up to `max_count` free elements, as up to two contiguous spans, or
+    // an empty range if the queue is full. The elements should be set and then
+    // FinishInsertN must be called. The reset function, if any, is applied to
+    // every returned element.
+    ABSL_MUST_USE_RESULT internal::RtQueueSpans<T> PrepareInsertN(
+        size_t max_count) {
+      internal::RtQueueSpans<T> elements = buffer_.PrepareInsertN(max_count);
+      if (reset_function_) {
+        for (T& element : elements.first) reset_function_(&element);
+        for (T& element : elements.second) reset_function_(&element);
+      }
+      return elements;
+    }
+    // Makes the first `count` elements returned by PrepareInsertN available to
+    // the reader at once.
+    void FinishInsertN(size_t count) { buffer_.FinishInsertN(count); }
     // Copy item into the queue and return true if there is space, or false if
     // it was not copied because the queue was full. Due to the copy, this is
     // not realtime safe for non-trivially-copyable objects; use
     // PrepareInsert/FinishInsert for realtime safety with non-trivial types.
     ABSL_MUST_USE_RESULT bool Insert(const T& item);
+    // Same as above, but moves `item` into the recycled element. Not realtime
+    // safe if moving T allocates.
+    ABSL_MUST_USE_RESULT bool Insert(T&& item);
+    // Passes the next available element to `fill`, which should set it in
+    // place, and makes it available to the reader. Returns false without
+    // calling `fill` if the queue is full. Realtime safe if `fill` is.
+    ABSL_MUST_USE_RESULT bool Emplace(absl::FunctionRef<void(T*)> fill);
+    // Assigns T(args...) to the next available element and returns true, or
+    // returns false if the queue is full. Avoids constructing a temporary at
+    // the call site just to copy it in; not realtime safe if constructing or
+    // moving T allocates.
+    template <typename... Args,
+              typename = std::enable_if_t<std::is_constructible_v<T, Args...>>>
+    ABSL_MUST_USE_RESULT bool Emplace(Args&&... args) {
+      return Emplace([&args...](T* element) {
+        *element = T(std::forward<Args>(args)...);
+      });
+    }
     // Sets a function which is called by PrepareInsert to reset the recycled
     // element before it's inserted.
     void SetElementResetFunction(std::function<void(T*)> reset_function) {
@@ -243,6 +302,22 @@ bool RealtimeQueue<T>::Writer::Insert(const T& item) {
   }
 }
 
+template <typename T>
+bool RealtimeQueue<T>::Writer::Insert(T&& item) {
+  return Emplace([&item](T* element) { *element = std::move(item); });
+}
+
+template <typename T>
+bool RealtimeQueue<T>::Writer::Emplace(absl::FunctionRef<void(T*)> fill) {
+  T* element = PrepareInsert();
+  if (element == nullptr) {
+    return false;
+  }
+  fill(element);
+  FinishInsert();
+  return true;
+}
+
 }  // namespace intrinsic
 
 #endif  // INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_QUEUE_H_
@@ -0,0 +1,128 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+// Cross-core throughput of RealtimeQueue.
+//
+// A writer thread and a reader thread, pinned to different CPUs, move a fixed
+// number of elements through a queue. The throughput is dominated by how often
+// the two cores have to exchange the cache lines that hold the state of the
+// queue. To compare two versions of RtQueueBuffer, run the benchmark on both
+// versions on the same machine.
+//
+// Both threads busy-wait, so the benchmarks are skipped on machines with a
+// single CPU.
+//
+// Run with:
+//   bazel run -c opt //intrinsic/platform/common/buffers:rt_queue_benchmark
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "benchmark/benchmark.h"
+#include "intrinsic/platform/common/buffers/rt_queue.h"
+
+namespace intrinsic {
+namespace {
+
+constexpr int64_t kElementsPerIteration = 1 << 20;
+
+// Returns false and skips the benchmark if the machine has a single CPU.
+bool HasTwoCpus(benchmark::State& state) {
+  if (std::thread::hardware_concurrency() >= 2) return true;
+  state.SkipWithError("Needs at least two CPUs");
+  return false;
+}
+
+// Pins the calling thread to `cpu`.
+void PinToCpu(int cpu) {
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+  (void)pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+}
+
+// Moves kElementsPerIteration elements from a writer on CPU 0 to a reader on
+// CPU 1 per iteration, one element at a time. Argument: queue capacity.
+void BM_CrossCoreSingle(benchmark::State& state) {
+  if (!HasTwoCpus(state)) return;
+  RealtimeQueue<int64_t> queue(state.range(0));
+  PinToCpu(0);
+  for (auto _ : state) {
+    std::thread reader([&queue]() {
+      PinToCpu(1);
+      RealtimeQueue<int64_t>::Reader& r = *queue.reader();
+      int64_t sum = 0;
+      for (int64_t received = 0; received < kElementsPerIteration;) {
+        if (const int64_t* value = r.Front(); value != nullptr) {
+          sum += *value;
+          r.DropFront();
+          ++received;
+        }
+      }
+      benchmark::DoNotOptimize(sum);
+    });
+    RealtimeQueue<int64_t>::Writer& w = *queue.writer();
+    for (int64_t sent = 0; sent < kElementsPerIteration;) {
+      if (int64_t* slot = w.PrepareInsert(); slot != nullptr) {
+        *slot = sent;
+        w.FinishInsert();
+        ++sent;
+      }
+    }
+    reader.join();
+  }
+  state.SetItemsProcessed(state.iterations() * kElementsPerIteration);
+}
+BENCHMARK(BM_CrossCoreSingle)
+    ->ArgName("capacity")
+    ->Arg(64)
+    ->Arg(1024)
+    ->UseRealTime();
+
+// Like BM_CrossCoreSingle, but with batches of up to 64 elements on both
+// sides. Argument: queue capacity.
+void BM_CrossCoreBatched(benchmark::State& state) {
+  constexpr size_t kBatchSize = 64;
+  if (!HasTwoCpus(state)) return;
+  RealtimeQueue<int64_t> queue(state.range(0));
+  PinToCpu(0);
+  for (auto _ : state) {
+    std::thread reader([&queue]() {
+      PinToCpu(1);
+      RealtimeQueue<int64_t>::Reader& r = *queue.reader();
+      int64_t sum = 0;
+      for (int64_t received = 0; received < kElementsPerIteration;) {
+        internal::RtQueueSpans<int64_t> values = r.FrontN(kBatchSize);
+        if (values.empty()) continue;
+        for (int64_t value : values.first) sum += value;
+        for (int64_t value : values.second) sum += value;
+        r.DropFrontN(values.size());
+        received += values.size();
+      }
+      benchmark::DoNotOptimize(sum);
+    });
+    RealtimeQueue<int64_t>::Writer& w = *queue.writer();
+    for (int64_t sent = 0; sent < kElementsPerIteration;) {
+      internal::RtQueueSpans<int64_t> slots = w.PrepareInsertN(
+          std::min<int64_t>(kBatchSize, kElementsPerIteration - sent));
+      if (slots.empty()) continue;
+      for (size_t i = 0; i < slots.size(); ++i) slots[i] = sent + i;
+      w.FinishInsertN(slots.size());
+      sent += slots.size();
+    }
+    reader.join();
+  }
+  state.SetItemsProcessed(state.iterations() * kElementsPerIteration);
+}
+BENCHMARK(BM_CrossCoreBatched)
+    ->ArgName("capacity")
+    ->Arg(64)
+    ->Arg(1024)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace intrinsic
@@ -3,22 +3,45 @@
 #ifndef INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_QUEUE_BUFFER_H_
 #define INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_QUEUE_BUFFER_H_
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <memory>
 
 #include "absl/base/attributes.h"
+#include "absl/base/optimization.h"
 #include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/memory/memory.h"
 #include "absl/types/optional.h"
+#include "absl/types/span.h"
 
 // IWYU pragma: no_forward_declare absl::FunctionRef
 
 namespace intrinsic {
 namespace internal {
 
+// A contiguous range of elements of a ring buffer, split into two spans if it
+// wraps around the end of the buffer. `second` is empty unless `first` ends at
+// the end of the buffer.
+template <typename T>
+struct RtQueueSpans {
+  absl::Span<T> first;
+  absl::Span<T> second;
+
+  size_t size() const { return first.size() + second.size(); }
+  bool empty() const { return size() == 0; }
+  // Returns the element at `index`, counting from the start of `first`.
+  T& operator[](size_t index) const {
+    return index < first.size() ? first[index] : second[index - first.size()];
+  }
+};
+
 // A buffer for performing spsc-queue style automatic operations.
+//
+// The state of the writer and the reader is kept on separate cache lines, so
+// that a writer and a reader on different cores do not invalidate each other's
+// cache lines on every operation.
 template <typename T>
 class RtQueueBuffer {
  public:
@@ -37,6 +60,16 @@ class RtQueueBuffer {
   // Keeps the front element.
   void KeepFront();
 
+  // Gets up to `max_count` elements from the front, or an empty range if the
+  // buffer is empty. After a non-empty result, DropFrontN() or KeepFront()
+  // must be called prior to subsequent calls to Front() or FrontN().
+  ABSL_MUST_USE_RESULT RtQueueSpans<T> FrontN(size_t max_count);
+
+  // Removes the first `count` elements of the range returned by FrontN(), with
+  // a single atomic operation. `count` must not exceed the size of that range;
+  // the remaining elements are kept.
+  void DropFrontN(size_t count);
+
   // Gets a pointer to the next available element, or nullptr if the queue is
   // full. The element should be set and then FinishInsert must be called.
   ABSL_MUST_USE_RESULT T* PrepareInsert();
@@ -45,12 +78,26 @@ class RtQueueBuffer {
   // available to the reader.
   void FinishInsert();
 
+  // Gets up to `max_count` free elements, or an empty range if the buffer is
+  // full. After a non-empty result, the elements should be set and then
+  // FinishInsertN must be called.
+  ABSL_MUST_USE_RESULT RtQueueSpans<T> PrepareInsertN(size_t max_count);
+
+  // Makes the first `count` elements of the range returned by PrepareInsertN()
+  // available to the reader, with a single atomic operation. `count` must not
+  // exceed the size of that range; the remaining elements are not inserted.
+  void FinishInsertN(size_t count);
+
   // Returns true when the buffer is empty. Thread-safe.
-  bool Empty() const { return size_.load(std::memory_order_acquire) == 0; }
+  bool Empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
 
   // Returns true when the buffer is full. Thread-safe.
   bool Full() const {
-    return size_.load(std::memory_order_acquire) == capacity_;
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    return head_.load(std::memory_order_acquire) - tail == capacity_;
   }
 
   // Returns the capacity of the buffer.
@@ -59,22 +106,44 @@ class RtQueueBuffer {
   void InitElements(absl::FunctionRef<void(T*)> init_function);
 
  private:
-  // Increases the number of messages stored in the buffer by 1.
-  void IncreaseSize() { size_.fetch_add(1, std::memory_order_seq_cst); }
+  // Returns the range of `count` elements starting at position `start`.
+  RtQueueSpans<T> MakeSpans(size_t start, size_t count) const;
 
-  // Decreases the number of messages stored in the buffer by 1.
-  void DecreaseSize() { size_.fetch_sub(1, std::memory_order_seq_cst); }
+  // Returns the number of elements the writer may insert, reloading the
+  // position of the reader only if fewer than `wanted` are known to be free.
+  size_t FreeForWriter(size_t wanted);
 
-  bool insert_in_progress_ = false;
-  size_t head_ = 0;
-
-  bool front_accessed_ = false;
-  size_t tail_ = 0;
+  // Returns the number of elements the reader may read, reloading the
+  // position of the writer only if fewer than `wanted` are known to be
+  // available.
+  size_t AvailableForReader(size_t wanted);
 
+  // Read-only after construction.
+  const size_t capacity_;  // the length of the buffer
   // Memory used as a ring buffer.
-  std::atomic_size_t size_ = 0;  // number of messages stored in the buffer
-  const size_t capacity_;        // the length of the buffer
   std::unique_ptr<T[]> buffer_;
+
+  // The positions of the writer and the reader only ever increase; the index
+  // of a position in `buffer_` is the position modulo the capacity. Each side
+  // owns one cache line with its position, which the other side only reads,
+  // and its last observed value of the other side's position. A side reloads
+  // the position of the other side only when its cached copy says the buffer
+  // is full (writer) or empty (reader), so in steady state neither side pulls
+  // the other's cache line for every element.
+
+  // Owned by the writer.
+  ABSL_CACHELINE_ALIGNED std::atomic<size_t> head_ = 0;
+  size_t cached_tail_ = 0;
+  bool insert_in_progress_ = false;
+  // Number of elements handed out by the pending PrepareInsert(N) call.
+  size_t insert_count_ = 0;
+
+  // Owned by the reader.
+  ABSL_CACHELINE_ALIGNED std::atomic<size_t> tail_ = 0;
+  size_t cached_head_ = 0;
+  bool front_accessed_ = false;
+  // Number of elements handed out by the pending Front(N) call.
+  size_t front_count_ = 0;
 };
 
 // Implementation of RealtimeQueue functions.
@@ -96,17 +165,68 @@ void RtQueueBuffer<T>::InitElements(absl::FunctionRef<void(T*)> init_function) {
   }
 }
 
+template <typename T>
+RtQueueSpans<T> RtQueueBuffer<T>::MakeSpans(size_t start, size_t count) const {
+  const size_t index = start % Capacity();
+  const size_t first_count = std::min(count, Capacity() - index);
+  return {
+      .first = absl::Span<T>(&buffer_[index], first_count),
+      .second = absl::Span<T>(buffer_.get(), count - first_count),
+  };
+}
+
+template <typename T>
+size_t RtQueueBuffer<T>::FreeForWriter(size_t wanted) {
+  const size_t head = head_.load(std::memory_order_relaxed);
+  size_t free = capacity_ - (head - cached_tail_);
+  if (free < wanted) {
+    // Synchronizes with the release in DropFront(N), so that the reader is done
+    // with the elements before they are handed out again.
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    free = capacity_ - (head - cached_tail_);
+  }
+  return free;
+}
+
+template <typename T>
+size_t RtQueueBuffer<T>::AvailableForReader(size_t wanted) {
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  size_t available = cached_head_ - tail;
+  if (available < wanted) {
+    // Synchronizes with the release in FinishInsert(N), so that the elements
+    // are fully written.
+    cached_head_ = head_.load(std::memory_order_acquire);
+    available = cached_head_ - tail;
+  }
+  return available;
+}
+
 // Implementation of RealtimeQueue::Reader functions.
 template <typename T>
 T* RtQueueBuffer<T>::Front() {
   CHECK(!front_accessed_)
       << "KeepFront or DropFront must be called before another "
          "call to Front is allowed.";
-  if (Empty()) {
+  if (AvailableForReader(1) == 0) {
     return nullptr;
   }
   front_accessed_ = true;
-  return &buffer_[tail_];
+  front_count_ = 1;
+  return &buffer_[tail_.load(std::memory_order_relaxed) % Capacity()];
+}
+
+template <typename T>
+RtQueueSpans<T> RtQueueBuffer<T>::FrontN(size_t max_count) {
+  CHECK(!front_accessed_)
+      << "KeepFront or DropFrontN must be called before another "
+         "call to FrontN is allowed.";
+  const size_t count = std::min(max_count, AvailableForReader(max_count));
+  if (count == 0) {
+    return {};
+  }
+  front_accessed_ = true;
+  front_count_ = count;
+  return MakeSpans(tail_.load(std::memory_order_relaxed), count);
 }
 
 template <typename T>
@@ -119,8 +239,19 @@ template <typename T>
 void RtQueueBuffer<T>::DropFront() {
   CHECK(front_accessed_) << "Front must be called before DropFront.";
   front_accessed_ = false;
-  DecreaseSize();
-  tail_ = (tail_ + 1) % Capacity();
+  tail_.store(tail_.load(std::memory_order_relaxed) + 1,
+              std::memory_order_release);
+}
+
+template <typename T>
+void RtQueueBuffer<T>::DropFrontN(size_t count) {
+  CHECK(front_accessed_) << "FrontN must be called before DropFrontN.";
+  CHECK_LE(count, front_count_)
+      << "DropFrontN cannot drop more elements than FrontN returned.";
+  front_accessed_ = false;
+  if (count == 0) return;
+  tail_.store(tail_.load(std::memory_order_relaxed) + count,
+              std::memory_order_release);
 }
 
 template <typename T>
@@ -128,11 +259,26 @@ T* RtQueueBuffer<T>::PrepareInsert() {
   CHECK(!insert_in_progress_)
       << "FinishInsert must be called before another call to "
          "PrepareInsert is allowed.";
-  if (Full()) {
+  if (FreeForWriter(1) == 0) {
     return nullptr;
   }
   insert_in_progress_ = true;
-  return &buffer_[head_];
+  insert_count_ = 1;
+  return &buffer_[head_.load(std::memory_order_relaxed) % Capacity()];
+}
+
+template <typename T>
+RtQueueSpans<T> RtQueueBuffer<T>::PrepareInsertN(size_t max_count) {
+  CHECK(!insert_in_progress_)
+      << "FinishInsertN must be called before another call to "
+         "PrepareInsertN is allowed.";
+  const size_t count = std::min(max_count, FreeForWriter(max_count));
+  if (count == 0) {
+    return {};
+  }
+  insert_in_progress_ = true;
+  insert_count_ = count;
+  return MakeSpans(head_.load(std::memory_order_relaxed), count);
 }
 
 template <typename T>
@@ -140,8 +286,21 @@ void RtQueueBuffer<T>::FinishInsert() {
   CHECK(insert_in_progress_)
       << "PrepareInsert must be called before FinishInsert.";
   insert_in_progress_ = false;
-  head_ = (head_ + 1) % Capacity();
-  IncreaseSize();
+  head_.store(head_.load(std::memory_order_relaxed) + 1,
+              std::memory_order_release);
+}
+
+template <typename T>
+void RtQueueBuffer<T>::FinishInsertN(size_t count) {
+  CHECK(insert_in_progress_)
+      << "PrepareInsertN must be called before FinishInsertN.";
+  CHECK_LE(count, insert_count_)
+      << "FinishInsertN cannot insert more elements than PrepareInsertN "
+         "returned.";
+  insert_in_progress_ = false;
+  if (count == 0) return;
+  head_.store(head_.load(std::memory_order_relaxed) + count,
+              std::memory_order_release);
 }
 
 }  // namespace internal
@@ -0,0 +1,160 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/common/buffers/rt_queue_buffer.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::internal {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsNull;
+using ::testing::NotNull;
+
+std::vector<int> ToVector(const RtQueueSpans<int>& spans) {
+  std::vector<int> values(spans.first.begin(), spans.first.end());
+  values.insert(values.end(), spans.second.begin(), spans.second.end());
+  return values;
+}
+
+void Insert(RtQueueBuffer<int>& buffer, int value) {
+  int* slot = buffer.PrepareInsert();
+  ASSERT_THAT(slot, NotNull());
+  *slot = value;
+  buffer.FinishInsert();
+}
+
+TEST(RtQueueBufferTest, PositionsWrapAroundManyTimes) {
+  // Not a power of two, so that the indices do not line up with the bits of
+  // the positions.
+  constexpr size_t kCapacity = 5;
+  RtQueueBuffer<int> buffer(kCapacity);
+  int next_insert = 0;
+  int next_read = 0;
+  // Batches of varying sizes, which end at every index of the buffer.
+  for (int round = 0; round < 1000; ++round) {
+    const size_t batch_size = 1 + round % kCapacity;
+    RtQueueSpans<int> free = buffer.PrepareInsertN(batch_size);
+    ASSERT_EQ(free.size(), batch_size);
+    EXPECT_EQ(free.first.size() + free.second.size(), batch_size);
+    for (size_t i = 0; i < free.size(); ++i) free[i] = next_insert++;
+    buffer.FinishInsertN(batch_size);
+
+    RtQueueSpans<int> items = buffer.FrontN(kCapacity);
+    ASSERT_EQ(items.size(), batch_size);
+    for (size_t i = 0; i < items.size(); ++i) {
+      EXPECT_EQ(items[i], next_read + static_cast<int>(i));
+    }
+    next_read += static_cast<int>(items.size());
+    buffer.DropFrontN(items.size());
+    EXPECT_TRUE(buffer.Empty());
+  }
+}
+
+TEST(RtQueueBufferTest, WriterReloadsStaleReaderPosition) {
+  RtQueueBuffer<int> buffer(/*capacity=*/4);
+  for (int i = 0; i < 3; ++i) Insert(buffer, i);
+  // The writer last saw the reader at position 0, so it knows of one free
+  // element only.
+  RtQueueSpans<int> items = buffer.FrontN(3);
+  ASSERT_EQ(items.size(), 3);
+  buffer.DropFrontN(3);
+
+  // Asks for more than the cached position allows, which must reload it.
+  RtQueueSpans<int> free = buffer.PrepareInsertN(4);
+  ASSERT_EQ(free.size(), 4);
+  EXPECT_EQ(free.first.size(), 1);
+  EXPECT_EQ(free.second.size(), 3);
+  for (size_t i = 0; i < free.size(); ++i) free[i] = 10 + static_cast<int>(i);
+  buffer.FinishInsertN(4);
+  EXPECT_TRUE(buffer.Full());
+  EXPECT_THAT(buffer.PrepareInsert(), IsNull());
+
+  EXPECT_THAT(ToVector(buffer.FrontN(4)), ElementsAre(10, 11, 12, 13));
+}
+
+TEST(RtQueueBufferTest, WriterReloadsStaleReaderPositionWhenFull) {
+  RtQueueBuffer<int> buffer(/*capacity=*/2);
+  Insert(buffer, 1);
+  Insert(buffer, 2);
+  EXPECT_THAT(buffer.PrepareInsert(), IsNull());
+
+  int* front = buffer.Front();
+  ASSERT_THAT(front, NotNull());
+  EXPECT_EQ(*front, 1);
+  buffer.DropFront();
+
+  Insert(buffer, 3);
+  EXPECT_THAT(ToVector(buffer.FrontN(2)), ElementsAre(2, 3));
+}
+
+TEST(RtQueueBufferTest, ReaderReloadsStaleWriterPosition) {
+  RtQueueBuffer<int> buffer(/*capacity=*/4);
+  Insert(buffer, 1);
+  // The reader caches the writer position after the first element.
+  RtQueueSpans<int> items = buffer.FrontN(4);
+  ASSERT_EQ(items.size(), 1);
+  buffer.KeepFront();
+
+  Insert(buffer, 2);
+  Insert(buffer, 3);
+  // The cached position knows of one element, but all three are returned.
+  EXPECT_THAT(ToVector(buffer.FrontN(4)), ElementsAre(1, 2, 3));
+  buffer.DropFrontN(3);
+
+  // Empty according to the cache, until the writer inserts again.
+  EXPECT_THAT(buffer.Front(), IsNull());
+  Insert(buffer, 4);
+  int* front = buffer.Front();
+  ASSERT_THAT(front, NotNull());
+  EXPECT_EQ(*front, 4);
+}
+
+TEST(RtQueueBufferTest, TransfersAllElementsBetweenThreads) {
+  constexpr int kNumElements = 200000;
+  constexpr size_t kCapacity = 7;
+  RtQueueBuffer<int> buffer(kCapacity);
+  std::vector<int> received;
+  received.reserve(kNumElements);
+
+  Thread reader([&buffer, &received]() {
+    for (size_t round = 0; received.size() < kNumElements; ++round) {
+      RtQueueSpans<int> items = buffer.FrontN(1 + round % kCapacity);
+      if (items.empty()) {
+        std::this_thread::yield();
+        continue;
+      }
+      for (size_t i = 0; i < items.size(); ++i) received.push_back(items[i]);
+      buffer.DropFrontN(items.size());
+    }
+  });
+  int next = 0;
+  for (size_t round = 0; next < kNumElements; ++round) {
+    const size_t wanted = std::min<size_t>(1 + round % 3, kNumElements - next);
+    RtQueueSpans<int> free = buffer.PrepareInsertN(wanted);
+    if (free.empty()) {
+      std::this_thread::yield();
+      continue;
+    }
+    for (size_t i = 0; i < free.size(); ++i) free[i] = next++;
+    buffer.FinishInsertN(free.size());
+  }
+  reader.Join();
+
+  ASSERT_EQ(received.size(), kNumElements);
+  for (int i = 0; i < kNumElements; ++i) {
+    ASSERT_EQ(received[i], i);
+  }
+}
+
+}  // namespace
+}  // namespace intrinsic::internal
@@ -3,7 +3,11 @@
 #ifndef INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_QUEUE_MULTI_WRITER_H_
 #define INTRINSIC_PLATFORM_COMMON_BUFFERS_RT_QUEUE_MULTI_WRITER_H_
 
+#include <type_traits>
+#include <utility>
+
 #include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
 #include "intrinsic/icon/utils/realtime_guard.h"
@@ -15,6 +19,9 @@ namespace intrinsic {
 // multiple concurrent writers. In doing this, we drop the realtime safety of
 // the write operation. Any readers of the RealtimeQueue are of course still
 // realtime safe.
+//
+// See RealtimeMpscQueue (rt_mpsc_queue.h) for a queue whose writers are
+// realtime safe.
 template <class T>
 class RealtimeQueueMultiWriter {
  public:
@@ -32,19 +39,35 @@ class RealtimeQueueMultiWriter {
   // Not realtime safe, but thread safe.
   // Returns ResourceExhausted if the underlying RealtimeQueue is full.
   absl::Status Insert(T&& value) ABSL_LOCKS_EXCLUDED(mutex_) {
+    return Emplace([&value](T* item) { *item = std::move(value); });
+  }
+
+  // Passes the next free element of the underlying RealtimeQueue to `fill`,
+  // which should set it in place.
+  // Not realtime safe, but thread safe.
+  // Returns ResourceExhausted without calling `fill` if the underlying
+  // RealtimeQueue is full.
+  absl::Status Emplace(absl::FunctionRef<void(T*)> fill)
+      ABSL_LOCKS_EXCLUDED(mutex_) {
     INTRINSIC_ASSERT_NON_REALTIME();
     absl::MutexLock l(&mutex_);
-    // RealtimeQueue::Writer::Insert() makes a copy, negating any performance
-    // benefits we get from accepting rvalues.
-    T* queue_item = writer_.PrepareInsert();
-    if (queue_item == nullptr) {
+    if (!writer_.Emplace(fill)) {
       return absl::ResourceExhaustedError("RealtimeQueue capacity exhausted");
     }
-    *queue_item = std::move(value);
-    writer_.FinishInsert();
     return absl::OkStatus();
   }
 
+  // Assigns T(args...) to the next free element of the underlying
+  // RealtimeQueue.
+  // Not realtime safe, but thread safe.
+  // Returns ResourceExhausted if the underlying RealtimeQueue is full.
+  template <typename... Args,
+            typename = std::enable_if_t<std::is_constructible_v<T, Args...>>>
+  absl::Status Emplace(Args&&... args) ABSL_LOCKS_EXCLUDED(mutex_) {
+    return Emplace(
+        [&args...](T* item) { *item = T(std::forward<Args>(args)...); });
+  }
+
  private:
   absl::Mutex mutex_;
   typename RealtimeQueue<T>::Writer& writer_ ABSL_GUARDED_BY(mutex_);
@@ -0,0 +1,110 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/common/buffers/rt_queue.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Optional;
+
+std::vector<int> ToVector(const internal::RtQueueSpans<int>& spans) {
+  std::vector<int> values(spans.first.begin(), spans.first.end());
+  values.insert(values.end(), spans.second.begin(), spans.second.end());
+  return values;
+}
+
+TEST(RealtimeQueueTest, BatchedInsertAndRead) {
+  RealtimeQueue<int> queue(/*capacity=*/4);
+  internal::RtQueueSpans<int> free = queue.writer()->PrepareInsertN(3);
+  ASSERT_EQ(free.size(), 3);
+  EXPECT_THAT(free.second, IsEmpty());
+  for (size_t i = 0; i < free.size(); ++i) free[i] = static_cast<int>(i);
+  queue.writer()->FinishInsertN(3);
+
+  internal::RtQueueSpans<int> items = queue.reader()->FrontN(10);
+  EXPECT_THAT(ToVector(items), ElementsAre(0, 1, 2));
+  queue.reader()->DropFrontN(2);
+  EXPECT_THAT(queue.reader()->Pop(), Optional(2));
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(RealtimeQueueTest, BatchesWrapAround) {
+  RealtimeQueue<int> queue(/*capacity=*/4);
+  // Move the head and tail to the last slot.
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(queue.writer()->Insert(i));
+    ASSERT_THAT(queue.reader()->Pop(), Optional(i));
+  }
+
+  internal::RtQueueSpans<int> free = queue.writer()->PrepareInsertN(4);
+  ASSERT_EQ(free.size(), 4);
+  EXPECT_EQ(free.first.size(), 1);
+  EXPECT_EQ(free.second.size(), 3);
+  for (size_t i = 0; i < free.size(); ++i) free[i] = 10 + static_cast<int>(i);
+  queue.writer()->FinishInsertN(4);
+  EXPECT_TRUE(queue.Full());
+  EXPECT_TRUE(queue.writer()->PrepareInsertN(1).empty());
+
+  internal::RtQueueSpans<int> items = queue.reader()->FrontN(4);
+  EXPECT_EQ(items.first.size(), 1);
+  EXPECT_THAT(ToVector(items), ElementsAre(10, 11, 12, 13));
+  queue.reader()->DropFrontN(4);
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_TRUE(queue.reader()->FrontN(1).empty());
+}
+
+TEST(RealtimeQueueTest, PartialBatchesKeepRemainingElements) {
+  RealtimeQueue<int> queue(/*capacity=*/4);
+  internal::RtQueueSpans<int> free = queue.writer()->PrepareInsertN(4);
+  ASSERT_EQ(free.size(), 4);
+  free[0] = 1;
+  free[1] = 2;
+  // Only the elements that were set are inserted.
+  queue.writer()->FinishInsertN(2);
+
+  internal::RtQueueSpans<int> items = queue.reader()->FrontN(4);
+  EXPECT_THAT(ToVector(items), ElementsAre(1, 2));
+  queue.reader()->KeepFront();
+  EXPECT_THAT(ToVector(queue.reader()->FrontN(4)), ElementsAre(1, 2));
+  queue.reader()->DropFrontN(0);
+  EXPECT_THAT(queue.reader()->Pop(), Optional(1));
+}
+
+TEST(RealtimeQueueTest, PrepareInsertNAppliesResetFunction) {
+  RealtimeQueue<int> queue(/*capacity=*/2);
+  queue.writer()->SetElementResetFunction([](int* v) { *v = -1; });
+  internal::RtQueueSpans<int> free = queue.writer()->PrepareInsertN(2);
+  EXPECT_THAT(ToVector(free), ElementsAre(-1, -1));
+  queue.writer()->FinishInsertN(2);
+}
+
+TEST(RealtimeQueueTest, EmplaceAndMoveInsert) {
+  RealtimeQueue<std::string> queue(/*capacity=*/3);
+  std::string moved(100, 'a');
+  ASSERT_TRUE(queue.writer()->Insert(std::move(moved)));
+  ASSERT_TRUE(queue.writer()->Emplace(size_t{3}, 'b'));
+  ASSERT_TRUE(queue.writer()->Emplace([](std::string* item) {
+    item->assign("built in place");
+  }));
+  // `fill` is not called when the queue is full.
+  EXPECT_FALSE(queue.writer()->Emplace([](std::string*) { FAIL(); }));
+
+  EXPECT_THAT(queue.reader()->Pop(), Optional(std::string(100, 'a')));
+  EXPECT_THAT(queue.reader()->Pop(), Optional(std::string("bbb")));
+  EXPECT_THAT(queue.reader()->Pop(), Optional(std::string("built in place")));
+}
+
+}  // namespace
+}  // namespace intrinsic
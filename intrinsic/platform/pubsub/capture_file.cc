@@ -0,0 +1,389 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/capture_file.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic {
+
+namespace {
+
+constexpr uint64_t kMagic = 0x3150414350534249;  // "IBSPCAP1"
+constexpr absl::string_view kSegmentPrefix = "segment-";
+constexpr absl::string_view kSegmentSuffix = ".icap";
+// Number of digits of the segment id in the file name.
+constexpr size_t kSegmentIdDigits = 20;
+
+// Header at the beginning of each segment. Records start at kHeaderSize.
+struct SegmentHeader {
+  uint64_t magic;
+  uint64_t id;
+};
+constexpr size_t kHeaderSize = 64;
+static_assert(sizeof(SegmentHeader) <= kHeaderSize);
+
+// Header of each record, which is followed by the topic and the packet.
+struct RecordHeader {
+  // Size of the topic plus one, so that zero marks the end. Written last.
+  uint32_t topic_size_plus_one;
+  uint32_t packet_size;
+  int64_t publish_time_ns;
+  int64_t receive_time_ns;
+};
+constexpr size_t kAlignment = alignof(RecordHeader);
+
+// Size of a record including its header, padded to keep headers aligned.
+constexpr size_t RecordSize(size_t topic_size, size_t packet_size) {
+  return (sizeof(RecordHeader) + topic_size + packet_size + kAlignment - 1) /
+         kAlignment * kAlignment;
+}
+
+absl::Status ErrnoToStatus(absl::string_view what, absl::string_view path) {
+  return absl::InternalError(
+      absl::StrCat(what, " ", path, " failed: ", std::strerror(errno)));
+}
+
+// Returns the ids of the segments in `directory`, sorted.
+absl::StatusOr<std::vector<uint64_t>> ListSegments(
+    absl::string_view directory) {
+  const std::string path(directory);
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) {
+    if (errno == ENOENT) {
+      return absl::NotFoundError(
+          absl::StrCat("Capture directory ", directory, " does not exist"));
+    }
+    return ErrnoToStatus("Opening capture directory", directory);
+  }
+  std::vector<uint64_t> ids;
+  while (const dirent* entry = readdir(dir)) {
+    absl::string_view name(entry->d_name);
+    uint64_t id;
+    if (absl::ConsumePrefix(&name, kSegmentPrefix) &&
+        absl::ConsumeSuffix(&name, kSegmentSuffix) &&
+        absl::SimpleAtoi(name, &id)) {
+      ids.push_back(id);
+    }
+  }
+  closedir(dir);
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+// Replaces the id in `path`, which ends with a segment file name, without
+// allocating.
+void SetSegmentId(uint64_t id, std::string& path) {
+  char* digits = path.data() + path.size() - kSegmentSuffix.size();
+  for (size_t i = 0; i < kSegmentIdDigits; ++i) {
+    *--digits = '0' + id % 10;
+    id /= 10;
+  }
+}
+
+// Returned by CaptureWriter::Append() without allocating.
+const absl::Status& ClosedError() {
+  static const auto* const status =
+      new absl::Status(absl::FailedPreconditionError("The capture is closed"));
+  return *status;
+}
+
+const absl::Status& FullError() {
+  static const auto* const status =
+      new absl::Status(absl::ResourceExhaustedError("The capture is full"));
+  return *status;
+}
+
+}  // namespace
+
+CaptureWriter::CaptureWriter(const Options& options) : options_(options) {}
+
+CaptureWriter::~CaptureWriter() {
+  if (absl::Status status = Close(); !status.ok()) {
+    LOG(ERROR) << "Closing capture in " << options_.directory
+               << " failed: " << status;
+  }
+}
+
+// static
+absl::StatusOr<std::unique_ptr<CaptureWriter>> CaptureWriter::Create(
+    const Options& options) {
+  if (options.directory.empty()) {
+    return absl::InvalidArgumentError("The capture directory must be set");
+  }
+  if (options.segment_bytes <= kHeaderSize + sizeof(RecordHeader) ||
+      options.segment_bytes > std::numeric_limits<uint32_t>::max()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Invalid capture segment size of ", options.segment_bytes, " bytes"));
+  }
+  if (mkdir(options.directory.c_str(), 0755) != 0 && errno != EEXIST) {
+    return ErrnoToStatus("Creating capture directory", options.directory);
+  }
+  INTR_ASSIGN_OR_RETURN(std::vector<uint64_t> ids,
+                        ListSegments(options.directory));
+  if (!ids.empty()) {
+    return absl::AlreadyExistsError(absl::StrCat(
+        "Capture directory ", options.directory, " contains a capture"));
+  }
+
+  auto writer = absl::WrapUnique(new CaptureWriter(options));
+  absl::MutexLock lock(&writer->mutex_);
+  writer->segment_path_ =
+      absl::StrFormat("%s/%s%0*d%s", options.directory, kSegmentPrefix,
+                      kSegmentIdDigits, 0, kSegmentSuffix);
+  INTR_RETURN_IF_ERROR(writer->CreateSegment());
+  return writer;
+}
+
+absl::Status CaptureWriter::CreateSegment() {
+  SetSegmentId(segment_id_, segment_path_);
+  const int fd = open(segment_path_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) {
+    return ErrnoToStatus("Creating capture segment", segment_path_);
+  }
+  if (ftruncate(fd, options_.segment_bytes) != 0) {
+    const absl::Status status =
+        ErrnoToStatus("Resizing capture segment", segment_path_);
+    close(fd);
+    unlink(segment_path_.c_str());
+    return status;
+  }
+  void* data = mmap(nullptr, options_.segment_bytes, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    const absl::Status status =
+        ErrnoToStatus("Mapping capture segment", segment_path_);
+    close(fd);
+    unlink(segment_path_.c_str());
+    return status;
+  }
+  fd_ = fd;
+  data_ = static_cast<char*>(data);
+  write_offset_ = kHeaderSize;
+  const SegmentHeader header = {.magic = kMagic, .id = segment_id_};
+  std::memcpy(data_, &header, sizeof(header));
+  return absl::OkStatus();
+}
+
+absl::Status CaptureWriter::FinishSegment() {
+  munmap(data_, options_.segment_bytes);
+  data_ = nullptr;
+  absl::Status status;
+  if (ftruncate(fd_, write_offset_) != 0) {
+    status = ErrnoToStatus("Truncating capture segment", segment_path_);
+  }
+  close(fd_);
+  fd_ = -1;
+  return status;
+}
+
+absl::Status CaptureWriter::Append(absl::string_view topic,
+                                   absl::string_view packet,
+                                   absl::Time publish_time,
+                                   absl::Time receive_time) {
+  const size_t size = RecordSize(topic.size(), packet.size());
+  if (size > options_.segment_bytes - kHeaderSize) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Record of ", size,
+                     " bytes does not fit into a capture segment of ",
+                     options_.segment_bytes, " bytes"));
+  }
+  absl::MutexLock lock(&mutex_);
+  if (data_ == nullptr) {
+    return ClosedError();
+  }
+  if (size > options_.max_total_bytes - total_bytes_) {
+    return FullError();
+  }
+  if (write_offset_ + size > options_.segment_bytes) {
+    absl::Status status = FinishSegment();
+    ++segment_id_;
+    if (status.ok()) status = CreateSegment();
+    INTR_RETURN_IF_ERROR(status);
+  }
+
+  char* record = data_ + write_offset_;
+  const RecordHeader header = {
+      .topic_size_plus_one = static_cast<uint32_t>(topic.size() + 1),
+      .packet_size = static_cast<uint32_t>(packet.size()),
+      .publish_time_ns = absl::ToUnixNanos(publish_time),
+      .receive_time_ns = absl::ToUnixNanos(receive_time)};
+  char* payload = record + sizeof(RecordHeader);
+  std::memcpy(payload, topic.data(), topic.size());
+  std::memcpy(payload + topic.size(), packet.data(), packet.size());
+  std::memcpy(record + sizeof(uint32_t),
+              reinterpret_cast<const char*>(&header) + sizeof(uint32_t),
+              sizeof(RecordHeader) - sizeof(uint32_t));
+  // Written last, so that the record is complete once the topic size is set.
+  std::memcpy(record, &header.topic_size_plus_one, sizeof(uint32_t));
+  write_offset_ += size;
+  total_bytes_ += size;
+  ++num_records_;
+  return absl::OkStatus();
+}
+
+absl::Status CaptureWriter::Close() {
+  absl::MutexLock lock(&mutex_);
+  if (data_ == nullptr) {
+    return absl::OkStatus();
+  }
+  return FinishSegment();
+}
+
+uint64_t CaptureWriter::num_records() const {
+  absl::MutexLock lock(&mutex_);
+  return num_records_;
+}
+
+size_t CaptureWriter::total_bytes() const {
+  absl::MutexLock lock(&mutex_);
+  return total_bytes_;
+}
+
+// static
+absl::StatusOr<std::unique_ptr<CaptureReader>> CaptureReader::Open(
+    absl::string_view directory) {
+  INTR_ASSIGN_OR_RETURN(std::vector<uint64_t> ids, ListSegments(directory));
+  if (ids.empty()) {
+    return absl::NotFoundError(
+        absl::StrCat("Capture directory ", directory, " contains no capture"));
+  }
+
+  auto reader = absl::WrapUnique(new CaptureReader());
+  for (uint64_t id : ids) {
+    const std::string path =
+        absl::StrFormat("%s/%s%0*d%s", directory, kSegmentPrefix,
+                        kSegmentIdDigits, id, kSegmentSuffix);
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return ErrnoToStatus("Opening capture segment", path);
+    }
+    struct stat stat_buffer;
+    if (fstat(fd, &stat_buffer) != 0) {
+      const absl::Status status =
+          ErrnoToStatus("Reading capture segment", path);
+      close(fd);
+      return status;
+    }
+    const size_t size = stat_buffer.st_size;
+    if (size < kHeaderSize) {
+      close(fd);
+      return absl::DataLossError(
+          absl::StrCat("Capture segment ", path, " has invalid size ", size));
+    }
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+      return ErrnoToStatus("Mapping capture segment", path);
+    }
+    const char* segment = static_cast<const char*>(data);
+    reader->segments_.push_back({.data = segment, .size = size});
+
+    SegmentHeader segment_header;
+    std::memcpy(&segment_header, segment, sizeof(segment_header));
+    if (segment_header.magic != kMagic) {
+      return absl::DataLossError(
+          absl::StrCat("Capture segment ", path, " has an invalid header"));
+    }
+    size_t offset = kHeaderSize;
+    while (offset + sizeof(RecordHeader) <= size) {
+      RecordHeader header;
+      std::memcpy(&header, segment + offset, sizeof(header));
+      if (header.topic_size_plus_one == 0) {
+        // The end of a segment that was not finished.
+        break;
+      }
+      const size_t topic_size = header.topic_size_plus_one - 1;
+      const size_t record_size = RecordSize(topic_size, header.packet_size);
+      if (offset + record_size > size) {
+        return absl::DataLossError(absl::StrCat(
+            "Capture segment ", path, " has a truncated record at offset ",
+            offset));
+      }
+      const char* payload = segment + offset + sizeof(RecordHeader);
+      reader->records_.push_back(
+          {.topic = absl::string_view(payload, topic_size),
+           .packet = absl::string_view(payload + topic_size,
+                                       header.packet_size),
+           .publish_time = absl::FromUnixNanos(header.publish_time_ns),
+           .receive_time = absl::FromUnixNanos(header.receive_time_ns)});
+      offset += record_size;
+    }
+  }
+
+  for (size_t i = 0; i < reader->records_.size(); ++i) {
+    reader->index_[reader->records_[i].topic].push_back(i);
+  }
+  for (auto& [topic, indices] : reader->index_) {
+    std::stable_sort(indices.begin(), indices.end(),
+                     [&records = reader->records_](size_t a, size_t b) {
+                       return records[a].publish_time <
+                              records[b].publish_time;
+                     });
+  }
+  return reader;
+}
+
+CaptureReader::~CaptureReader() {
+  for (const Segment& segment : segments_) {
+    munmap(const_cast<char*>(segment.data), segment.size);
+  }
+}
+
+std::vector<absl::string_view> CaptureReader::Topics() const {
+  std::vector<absl::string_view> topics;
+  topics.reserve(index_.size());
+  for (const auto& [topic, indices] : index_) {
+    topics.push_back(topic);
+  }
+  std::sort(topics.begin(), topics.end());
+  return topics;
+}
+
+std::vector<CaptureRecord> CaptureReader::Find(absl::string_view topic,
+                                               absl::Time start,
+                                               absl::Time end) const {
+  std::vector<CaptureRecord> found;
+  auto it = index_.find(topic);
+  if (it == index_.end()) {
+    return found;
+  }
+  const std::vector<size_t>& indices = it->second;
+  auto first = std::lower_bound(
+      indices.begin(), indices.end(), start, [this](size_t i, absl::Time t) {
+        return records_[i].publish_time < t;
+      });
+  for (; first != indices.end() && records_[*first].publish_time < end;
+       ++first) {
+    found.push_back(records_[*first]);
+  }
+  return found;
+}
+
+}  // namespace intrinsic
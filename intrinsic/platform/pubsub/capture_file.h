@@ -0,0 +1,161 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_CAPTURE_FILE_H_
+#define INTRINSIC_PLATFORM_PUBSUB_CAPTURE_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+
+namespace intrinsic {
+
+// A capture of PubSub traffic in memory-mapped, append-only segment files in
+// one directory, written by CaptureWriter and read by CaptureReader.
+//
+// Each segment starts with a header, followed by records of a header with the
+// sizes and times of the record, the topic and the serialized PubSubPacket.
+// The first field of the record header is written last, so that a partially
+// written record is ignored when the capture is read after a crash. Complete
+// segments are truncated to their records.
+
+// A record of a capture. The views point into the mapped segments of the
+// CaptureReader.
+struct CaptureRecord {
+  absl::string_view topic;
+  absl::string_view packet;
+  absl::Time publish_time;
+  absl::Time receive_time;
+};
+
+// Appends records to a new capture.
+//
+// Append() copies the record into the mapped segment under a lock and does
+// not allocate, not even when it starts a new segment, so that recording does
+// not disturb the processes under observation.
+//
+// Thread safe.
+class CaptureWriter {
+ public:
+  struct Options {
+    // Directory of the segment files. Created if it does not exist. Must not
+    // contain a capture yet.
+    std::string directory;
+    // Size of each segment file. Bounds the size of a record.
+    size_t segment_bytes = size_t{64} << 20;
+    // Maximum size of all records. Append() rejects records beyond.
+    size_t max_total_bytes = std::numeric_limits<size_t>::max();
+  };
+
+  // Creates a capture in Options::directory.
+  //
+  // Returns InvalidArgumentError if the options are invalid,
+  // AlreadyExistsError if the directory contains a capture, and InternalError
+  // if the directory or the first segment cannot be created.
+  static absl::StatusOr<std::unique_ptr<CaptureWriter>> Create(
+      const Options& options);
+
+  // Calls Close().
+  ~CaptureWriter();
+
+  CaptureWriter(const CaptureWriter&) = delete;
+  CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+  // Appends a record.
+  //
+  // Returns InvalidArgumentError if the record does not fit into a segment,
+  // ResourceExhaustedError if the capture is full, FailedPreconditionError if
+  // the writer is closed, and InternalError if a new segment cannot be
+  // created.
+  absl::Status Append(absl::string_view topic, absl::string_view packet,
+                      absl::Time publish_time, absl::Time receive_time);
+
+  // Truncates and unmaps the last segment. Later calls to Append() fail.
+  absl::Status Close();
+
+  // Number of records appended.
+  uint64_t num_records() const;
+  // Number of bytes of all records, including their headers.
+  size_t total_bytes() const;
+
+ private:
+  explicit CaptureWriter(const Options& options);
+
+  // Creates and maps the segment `segment_id_`, whose path is
+  // `segment_path_`.
+  absl::Status CreateSegment() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Truncates the current segment to its records and unmaps it.
+  absl::Status FinishSegment() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const Options options_;
+
+  mutable absl::Mutex mutex_;
+  // Path of the current segment, which is updated in place.
+  std::string segment_path_ ABSL_GUARDED_BY(mutex_);
+  uint64_t segment_id_ ABSL_GUARDED_BY(mutex_) = 0;
+  int fd_ ABSL_GUARDED_BY(mutex_) = -1;
+  char* data_ ABSL_GUARDED_BY(mutex_) = nullptr;
+  // Offset past the last record of the current segment.
+  size_t write_offset_ ABSL_GUARDED_BY(mutex_) = 0;
+  uint64_t num_records_ ABSL_GUARDED_BY(mutex_) = 0;
+  size_t total_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+// Reads a capture written by CaptureWriter, which may still be written to.
+// Records appended after Open() are not read.
+//
+// Maps all segments and indexes the records by topic and publish time.
+class CaptureReader {
+ public:
+  // Opens the capture in `directory`.
+  //
+  // Returns NotFoundError if the directory contains no capture, DataLossError
+  // if a segment is corrupt, and InternalError if a segment cannot be mapped.
+  static absl::StatusOr<std::unique_ptr<CaptureReader>> Open(
+      absl::string_view directory);
+
+  ~CaptureReader();
+
+  CaptureReader(const CaptureReader&) = delete;
+  CaptureReader& operator=(const CaptureReader&) = delete;
+
+  // All records, in the order in which they were appended.
+  absl::Span<const CaptureRecord> records() const { return records_; }
+
+  // The topics of all records, sorted.
+  std::vector<absl::string_view> Topics() const;
+
+  // Returns the records of `topic` published in [`start`, `end`), sorted by
+  // publish time.
+  std::vector<CaptureRecord> Find(
+      absl::string_view topic, absl::Time start = absl::InfinitePast(),
+      absl::Time end = absl::InfiniteFuture()) const;
+
+ private:
+  struct Segment {
+    const char* data;
+    size_t size;
+  };
+
+  CaptureReader() = default;
+
+  std::vector<Segment> segments_;
+  std::vector<CaptureRecord> records_;
+  // Indices into `records_` by topic, sorted by publish time.
+  absl::flat_hash_map<absl::string_view, std::vector<size_t>> index_;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_CAPTURE_FILE_H_
@@ -0,0 +1,176 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/capture_file.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic {
+namespace {
+
+using ::intrinsic::testing::IsOk;
+using ::intrinsic::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::Field;
+using ::testing::IsEmpty;
+
+MATCHER_P2(IsRecord, topic, packet, "") {
+  return arg.topic == topic && arg.packet == packet;
+}
+
+class CaptureFileTest : public ::testing::Test {
+ protected:
+  CaptureFileTest()
+      : directory_(absl::StrCat(::testing::TempDir(), "/",
+                                ::testing::UnitTest::GetInstance()
+                                    ->current_test_info()
+                                    ->name())) {}
+
+  CaptureWriter::Options WriterOptions() const {
+    return {.directory = directory_};
+  }
+
+  const std::string directory_;
+};
+
+TEST_F(CaptureFileTest, ReadsRecordsInOrder) {
+  const absl::Time t0 = absl::FromUnixSeconds(1000);
+  {
+    absl::StatusOr<std::unique_ptr<CaptureWriter>> writer =
+        CaptureWriter::Create(WriterOptions());
+    ASSERT_THAT(writer.status(), IsOk());
+    ASSERT_THAT((*writer)->Append("a", "packet1", t0, t0), IsOk());
+    ASSERT_THAT((*writer)->Append("b", "packet2", t0, t0 + absl::Seconds(1)),
+                IsOk());
+    ASSERT_THAT((*writer)->Append("a", "", t0, t0 + absl::Seconds(2)),
+                IsOk());
+    EXPECT_EQ((*writer)->num_records(), 3);
+  }
+
+  absl::StatusOr<std::unique_ptr<CaptureReader>> reader =
+      CaptureReader::Open(directory_);
+  ASSERT_THAT(reader.status(), IsOk());
+  EXPECT_THAT((*reader)->records(),
+              ElementsAre(IsRecord("a", "packet1"), IsRecord("b", "packet2"),
+                          IsRecord("a", "")));
+  EXPECT_EQ((*reader)->records()[1].publish_time, t0);
+  EXPECT_EQ((*reader)->records()[1].receive_time, t0 + absl::Seconds(1));
+  EXPECT_THAT((*reader)->Topics(), ElementsAre("a", "b"));
+}
+
+TEST_F(CaptureFileTest, FindsRecordsByTopicAndPublishTime) {
+  const absl::Time t0 = absl::FromUnixSeconds(1000);
+  {
+    absl::StatusOr<std::unique_ptr<CaptureWriter>> writer =
+        CaptureWriter::Create(WriterOptions());
+    ASSERT_THAT(writer.status(), IsOk());
+    // Received out of publish order.
+    for (int i : {3, 1, 2, 0}) {
+      ASSERT_THAT((*writer)->Append("a", absl::StrCat(i),
+                                    t0 + absl::Seconds(i), absl::Now()),
+                  IsOk());
+      ASSERT_THAT((*writer)->Append("b", "other", t0 + absl::Seconds(i),
+                                    absl::Now()),
+                  IsOk());
+    }
+  }
+
+  absl::StatusOr<std::unique_ptr<CaptureReader>> reader =
+      CaptureReader::Open(directory_);
+  ASSERT_THAT(reader.status(), IsOk());
+  EXPECT_THAT((*reader)->Find("a"),
+              ElementsAre(Field(&CaptureRecord::packet, "0"),
+                          Field(&CaptureRecord::packet, "1"),
+                          Field(&CaptureRecord::packet, "2"),
+                          Field(&CaptureRecord::packet, "3")));
+  EXPECT_THAT(
+      (*reader)->Find("a", t0 + absl::Seconds(1), t0 + absl::Seconds(3)),
+      ElementsAre(Field(&CaptureRecord::packet, "1"),
+                  Field(&CaptureRecord::packet, "2")));
+  EXPECT_THAT((*reader)->Find("c"), IsEmpty());
+}
+
+TEST_F(CaptureFileTest, SpansSegments) {
+  CaptureWriter::Options options = WriterOptions();
+  options.segment_bytes = 256;
+  const std::string packet(100, 'x');
+  {
+    absl::StatusOr<std::unique_ptr<CaptureWriter>> writer =
+        CaptureWriter::Create(options);
+    ASSERT_THAT(writer.status(), IsOk());
+    for (int i = 0; i < 10; ++i) {
+      ASSERT_THAT((*writer)->Append("topic", packet, absl::Now(), absl::Now()),
+                  IsOk());
+    }
+  }
+
+  absl::StatusOr<std::unique_ptr<CaptureReader>> reader =
+      CaptureReader::Open(directory_);
+  ASSERT_THAT(reader.status(), IsOk());
+  ASSERT_EQ((*reader)->records().size(), 10);
+  for (const CaptureRecord& record : (*reader)->records()) {
+    EXPECT_EQ(record.packet, packet);
+  }
+}
+
+TEST_F(CaptureFileTest, ReadsCaptureThatIsStillWritten) {
+  absl::StatusOr<std::unique_ptr<CaptureWriter>> writer =
+      CaptureWriter::Create(WriterOptions());
+  ASSERT_THAT(writer.status(), IsOk());
+  ASSERT_THAT((*writer)->Append("a", "packet", absl::Now(), absl::Now()),
+              IsOk());
+
+  absl::StatusOr<std::unique_ptr<CaptureReader>> reader =
+      CaptureReader::Open(directory_);
+  ASSERT_THAT(reader.status(), IsOk());
+  EXPECT_THAT((*reader)->records(), ElementsAre(IsRecord("a", "packet")));
+}
+
+TEST_F(CaptureFileTest, RejectsRecordsBeyondLimits) {
+  CaptureWriter::Options options = WriterOptions();
+  options.segment_bytes = 256;
+  options.max_total_bytes = 256;
+  absl::StatusOr<std::unique_ptr<CaptureWriter>> writer =
+      CaptureWriter::Create(options);
+  ASSERT_THAT(writer.status(), IsOk());
+
+  EXPECT_THAT((*writer)->Append("a", std::string(256, 'x'), absl::Now(),
+                                absl::Now()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  ASSERT_THAT((*writer)->Append("a", std::string(150, 'x'), absl::Now(),
+                                absl::Now()),
+              IsOk());
+  EXPECT_THAT((*writer)->Append("a", std::string(150, 'x'), absl::Now(),
+                                absl::Now()),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+
+  ASSERT_THAT((*writer)->Close(), IsOk());
+  EXPECT_THAT((*writer)->Append("a", "", absl::Now(), absl::Now()),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST_F(CaptureFileTest, RefusesExistingCapture) {
+  ASSERT_THAT(CaptureWriter::Create(WriterOptions()).status(), IsOk());
+  EXPECT_THAT(CaptureWriter::Create(WriterOptions()).status(),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+}
+
+TEST_F(CaptureFileTest, OpenFailsWithoutCapture) {
+  EXPECT_THAT(CaptureReader::Open(directory_).status(),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+}  // namespace
+}  // namespace intrinsic
@@ -0,0 +1,73 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/keyexpr_topic_cache.h"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "intrinsic/platform/pubsub/zenoh_util/zenoh_handle.h"
+
+namespace intrinsic::internal {
+
+namespace {
+
+constexpr absl::string_view kIntrospectionTopicPrefix = "in/_introspection/";
+
+}  // namespace
+
+KeyexprTopicCache::KeyexprTopicCache(absl::string_view subscription_keyexpr)
+    : subscription_keyexpr_(subscription_keyexpr),
+      subscription_topic_(MakeTopic(subscription_keyexpr)) {}
+
+std::optional<ReceivedTopic> KeyexprTopicCache::MakeTopic(
+    absl::string_view keyexpr) {
+  absl::StatusOr<std::string> name = ZenohHandle::remove_topic_prefix(keyexpr);
+  if (!name.ok()) return std::nullopt;
+  return ReceivedTopic{
+      .name = *std::move(name),
+      .is_introspection = absl::StartsWith(keyexpr, kIntrospectionTopicPrefix),
+  };
+}
+
+const ReceivedTopic* KeyexprTopicCache::Resolve(absl::string_view keyexpr,
+                                                ReceivedTopic* uncached) {
+  if (keyexpr == subscription_keyexpr_) {
+    return subscription_topic_.has_value() ? &*subscription_topic_ : nullptr;
+  }
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    if (auto it = topics_.find(keyexpr); it != topics_.end()) {
+      return it->second.get();
+    }
+  }
+  std::optional<ReceivedTopic> topic = MakeTopic(keyexpr);
+  if (!topic.has_value()) return nullptr;
+
+  absl::MutexLock lock(&mutex_);
+  if (auto it = topics_.find(keyexpr); it != topics_.end()) {
+    // Another thread resolved the same key expression in the meantime.
+    return it->second.get();
+  }
+  if (topics_.size() >= kMaxCachedTopics) {
+    *uncached = *std::move(topic);
+    return uncached;
+  }
+  auto [it, inserted] = topics_.try_emplace(
+      std::string(keyexpr),
+      std::make_unique<const ReceivedTopic>(*std::move(topic)));
+  return it->second.get();
+}
+
+size_t KeyexprTopicCache::size() const {
+  absl::ReaderMutexLock lock(&mutex_);
+  return topics_.size();
+}
+
+}  // namespace intrinsic::internal
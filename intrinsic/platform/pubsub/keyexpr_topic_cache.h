@@ -0,0 +1,77 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_KEYEXPR_TOPIC_CACHE_H_
+#define INTRINSIC_PLATFORM_PUBSUB_KEYEXPR_TOPIC_CACHE_H_
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace intrinsic::internal {
+
+// The topic of a key expression on which a subscription received a packet.
+struct ReceivedTopic {
+  // The topic name without the middleware prefix, as passed to expanded
+  // subscription callbacks.
+  std::string name;
+  // Whether the topic carries introspection data, which subscriptions ignore.
+  bool is_introspection = false;
+};
+
+// Resolves the key expressions on which a subscription receives packets into
+// topics, so that the prefix handling is done once per key expression instead
+// of once per packet.
+//
+// For a subscription without wildcards, all packets arrive on the key
+// expression of the subscription itself, which is resolved on construction
+// and returned without locking. Other key expressions (i.e., those matched by
+// a wildcard subscription) are resolved on first use and cached, so that
+// resolving them costs one hash lookup, independently of how many topics the
+// subscription matches.
+//
+// This class is thread-safe.
+class KeyexprTopicCache {
+ public:
+  // Bounds the memory used by a wildcard subscription matching many key
+  // expressions. Further key expressions are resolved on every packet.
+  static constexpr size_t kMaxCachedTopics = 4096;
+
+  // `subscription_keyexpr` is the (prefixed) key expression of the
+  // subscription.
+  explicit KeyexprTopicCache(absl::string_view subscription_keyexpr);
+
+  KeyexprTopicCache(const KeyexprTopicCache&) = delete;
+  KeyexprTopicCache& operator=(const KeyexprTopicCache&) = delete;
+
+  // Returns the topic of the (prefixed) key expression `keyexpr`, or nullptr
+  // if it is not a valid topic key expression. The returned topic remains
+  // valid for the lifetime of the cache, unless the cache is full, in which
+  // case the topic is written to and returned as `*uncached`.
+  const ReceivedTopic* Resolve(absl::string_view keyexpr,
+                               ReceivedTopic* uncached);
+
+  // Returns the number of cached key expressions of wildcard matches.
+  size_t size() const;
+
+ private:
+  static std::optional<ReceivedTopic> MakeTopic(absl::string_view keyexpr);
+
+  const std::string subscription_keyexpr_;
+  const std::optional<ReceivedTopic> subscription_topic_;
+
+  mutable absl::Mutex mutex_;
+  // The topics are heap allocated so that pointers to them remain valid when
+  // the map is rehashed.
+  absl::flat_hash_map<std::string, std::unique_ptr<const ReceivedTopic>>
+      topics_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace intrinsic::internal
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_KEYEXPR_TOPIC_CACHE_H_
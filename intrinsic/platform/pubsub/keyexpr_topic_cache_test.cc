@@ -0,0 +1,81 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/keyexpr_topic_cache.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::internal {
+namespace {
+
+using ::testing::Field;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::Pointee;
+
+TEST(KeyexprTopicCacheTest, ResolvesSubscriptionKeyexprWithoutCaching) {
+  KeyexprTopicCache cache("in/robot/status");
+  ReceivedTopic uncached;
+
+  const ReceivedTopic* topic = cache.Resolve("in/robot/status", &uncached);
+
+  EXPECT_THAT(topic, Pointee(Field(&ReceivedTopic::name, "/robot/status")));
+  EXPECT_FALSE(topic->is_introspection);
+  EXPECT_EQ(cache.Resolve("in/robot/status", &uncached), topic);
+  EXPECT_EQ(cache.size(), 0);
+}
+
+TEST(KeyexprTopicCacheTest, CachesWildcardMatches) {
+  KeyexprTopicCache cache("in/**");
+  ReceivedTopic uncached;
+
+  const ReceivedTopic* first = cache.Resolve("in/a/b", &uncached);
+  const ReceivedTopic* second = cache.Resolve("in/c", &uncached);
+
+  EXPECT_THAT(first, Pointee(Field(&ReceivedTopic::name, "/a/b")));
+  EXPECT_THAT(second, Pointee(Field(&ReceivedTopic::name, "/c")));
+  EXPECT_EQ(cache.Resolve("in/a/b", &uncached), first);
+  EXPECT_NE(first, &uncached);
+  EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(KeyexprTopicCacheTest, DetectsIntrospectionTopics) {
+  KeyexprTopicCache cache("in/**");
+  ReceivedTopic uncached;
+
+  const ReceivedTopic* topic =
+      cache.Resolve("in/_introspection/stats", &uncached);
+
+  ASSERT_THAT(topic, NotNull());
+  EXPECT_TRUE(topic->is_introspection);
+}
+
+TEST(KeyexprTopicCacheTest, RejectsInvalidKeyexpr) {
+  KeyexprTopicCache cache("in/**");
+  ReceivedTopic uncached;
+
+  EXPECT_THAT(cache.Resolve("in", &uncached), IsNull());
+}
+
+TEST(KeyexprTopicCacheTest, StopsCachingWhenFull) {
+  KeyexprTopicCache cache("in/**");
+  ReceivedTopic uncached;
+  for (size_t i = 0; i < KeyexprTopicCache::kMaxCachedTopics; ++i) {
+    ASSERT_THAT(cache.Resolve(absl::StrCat("in/topic", i), &uncached),
+                NotNull());
+  }
+
+  const ReceivedTopic* topic = cache.Resolve("in/one/more", &uncached);
+
+  EXPECT_EQ(topic, &uncached);
+  EXPECT_EQ(uncached.name, "/one/more");
+  EXPECT_EQ(cache.size(), KeyexprTopicCache::kMaxCachedTopics);
+}
+
+}  // namespace
+}  // namespace intrinsic::internal
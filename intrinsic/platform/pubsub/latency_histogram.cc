@@ -0,0 +1,89 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/latency_histogram.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/numeric/bits.h"
+#include "absl/time/time.h"
+
+namespace intrinsic::internal {
+
+size_t LatencyHistogram::BucketIndex(uint64_t nanos) {
+  if (nanos < kSubBucketCount) return nanos;
+  const int shift = absl::bit_width(nanos) - 1 - kSubBucketBits;
+  if (shift > kMaxValueBits - 1 - kSubBucketBits) return kNumBuckets - 1;
+  const uint64_t sub_bucket = (nanos >> shift) - kSubBucketCount;
+  return (shift + 1) * kSubBucketCount + sub_bucket;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t index) {
+  if (index < kSubBucketCount) return index;
+  const int shift = static_cast<int>(index / kSubBucketCount) - 1;
+  const uint64_t sub_bucket = index % kSubBucketCount;
+  return ((kSubBucketCount + sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(absl::Duration latency) {
+  const int64_t signed_nanos = absl::ToInt64Nanoseconds(latency);
+  const uint64_t nanos =
+      signed_nanos > 0 ? static_cast<uint64_t>(signed_nanos) : 0;
+  buckets_[BucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_nanos_.fetch_add(nanos, std::memory_order_relaxed);
+  uint64_t max = max_nanos_.load(std::memory_order_relaxed);
+  while (nanos > max && !max_nanos_.compare_exchange_weak(
+                            max, nanos, std::memory_order_relaxed)) {
+  }
+}
+
+LatencySummary LatencyHistogram::Summarize() const {
+  std::array<uint64_t, kNumBuckets> buckets;
+  uint64_t count = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    count += buckets[i];
+  }
+  LatencySummary summary;
+  if (count == 0) return summary;
+
+  const uint64_t max_nanos = max_nanos_.load(std::memory_order_relaxed);
+  auto percentile = [&](double p) {
+    // The rank of the percentile, starting at 1.
+    const uint64_t rank =
+        std::max<uint64_t>(static_cast<uint64_t>(p * count + 0.5), 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      seen += buckets[i];
+      if (seen >= rank) {
+        return absl::Nanoseconds(std::min(BucketUpperBound(i), max_nanos));
+      }
+    }
+    return absl::Nanoseconds(max_nanos);
+  };
+  summary.count = count;
+  const uint64_t total = std::max<uint64_t>(
+      count_.load(std::memory_order_relaxed), 1);
+  summary.mean =
+      absl::Nanoseconds(sum_nanos_.load(std::memory_order_relaxed) / total);
+  summary.p50 = percentile(0.5);
+  summary.p90 = percentile(0.9);
+  summary.p99 = percentile(0.99);
+  summary.max = absl::Nanoseconds(max_nanos);
+  return summary;
+}
+
+void LatencyHistogram::Reset() {
+  for (std::atomic<uint64_t>& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_nanos_.store(0, std::memory_order_relaxed);
+  max_nanos_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace intrinsic::internal
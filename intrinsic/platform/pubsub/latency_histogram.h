@@ -0,0 +1,74 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_LATENCY_HISTOGRAM_H_
+#define INTRINSIC_PLATFORM_PUBSUB_LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/time/time.h"
+
+namespace intrinsic {
+
+// Summary of the latencies recorded by a histogram. Percentiles are accurate
+// to within 1/16 (about 6%) of their value.
+struct LatencySummary {
+  uint64_t count = 0;
+  absl::Duration mean = absl::ZeroDuration();
+  absl::Duration p50 = absl::ZeroDuration();
+  absl::Duration p90 = absl::ZeroDuration();
+  absl::Duration p99 = absl::ZeroDuration();
+  absl::Duration max = absl::ZeroDuration();
+};
+
+namespace internal {
+
+// A histogram of latencies with logarithmic buckets, in the style of an HDR
+// histogram: every power of two between 16 ns and about 4.9 hours is split
+// into 16 linear sub-buckets, so that the relative error of a recorded value
+// is bounded independently of its magnitude.
+//
+// Record() only performs relaxed atomic increments, so it never blocks and
+// does not allocate. It may be called concurrently with itself and with
+// Summarize(), which then reflects a consistent state for every single bucket
+// but not necessarily across buckets.
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr uint64_t kSubBucketCount = uint64_t{1} << kSubBucketBits;
+  // Latencies of at least 2^44 ns are recorded in the last bucket.
+  static constexpr int kMaxValueBits = 44;
+  static constexpr size_t kNumBuckets =
+      (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+
+  LatencyHistogram() = default;
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  // Records a single latency. Negative latencies, e.g., due to clock offsets
+  // between hosts, are recorded as zero.
+  void Record(absl::Duration latency);
+
+  LatencySummary Summarize() const;
+
+  // Not atomic with respect to concurrent calls of Record().
+  void Reset();
+
+  // Exposed for testing.
+  static size_t BucketIndex(uint64_t nanos);
+  // The largest value that is recorded in the bucket with the given index.
+  static uint64_t BucketUpperBound(size_t index);
+
+ private:
+  std::array<std::atomic<uint64_t>, kNumBuckets> buckets_ = {};
+  std::atomic<uint64_t> count_ = 0;
+  std::atomic<uint64_t> sum_nanos_ = 0;
+  std::atomic<uint64_t> max_nanos_ = 0;
+};
+
+}  // namespace internal
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_LATENCY_HISTOGRAM_H_
@@ -0,0 +1,90 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/latency_histogram.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/time/time.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::internal {
+namespace {
+
+TEST(LatencyHistogramTest, BucketsCoverAllValues) {
+  EXPECT_EQ(LatencyHistogram::BucketIndex(0), 0);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(15), 15);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(16), 16);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(uint64_t{1} << 63),
+            LatencyHistogram::kNumBuckets - 1);
+
+  // Every value is in a bucket whose upper bound is at least the value and at
+  // most 1/16 larger.
+  for (uint64_t value : {uint64_t{1}, uint64_t{17}, uint64_t{1000},
+                         uint64_t{123456789}, (uint64_t{1} << 44) - 1}) {
+    const size_t index = LatencyHistogram::BucketIndex(value);
+    const uint64_t upper_bound = LatencyHistogram::BucketUpperBound(index);
+    EXPECT_GE(upper_bound, value);
+    EXPECT_LE(upper_bound - value, value / 16) << value;
+    if (index > 0) {
+      EXPECT_LT(LatencyHistogram::BucketUpperBound(index - 1), value);
+    }
+  }
+}
+
+TEST(LatencyHistogramTest, SummarizesRecordedLatencies) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Summarize().count, 0);
+
+  for (int i = 1; i <= 100; ++i) {
+    histogram.Record(absl::Microseconds(i));
+  }
+  const LatencySummary summary = histogram.Summarize();
+  EXPECT_EQ(summary.count, 100);
+  EXPECT_EQ(summary.mean, absl::Nanoseconds(50500));
+  EXPECT_EQ(summary.max, absl::Microseconds(100));
+  EXPECT_GE(summary.p50, absl::Microseconds(50));
+  EXPECT_LE(summary.p50, absl::Microseconds(50) * 17 / 16);
+  EXPECT_GE(summary.p90, absl::Microseconds(90));
+  EXPECT_LE(summary.p90, absl::Microseconds(90) * 17 / 16);
+  EXPECT_GE(summary.p99, absl::Microseconds(99));
+  EXPECT_LE(summary.p99, summary.max);
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.Summarize().count, 0);
+}
+
+TEST(LatencyHistogramTest, ClampsNegativeLatencies) {
+  LatencyHistogram histogram;
+  histogram.Record(absl::Milliseconds(-5));
+  const LatencySummary summary = histogram.Summarize();
+  EXPECT_EQ(summary.count, 1);
+  EXPECT_EQ(summary.max, absl::ZeroDuration());
+}
+
+TEST(LatencyHistogramTest, RecordsConcurrently) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumRecords = 10000;
+  LatencyHistogram histogram;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&histogram, t]() {
+      for (int i = 0; i < kNumRecords; ++i) {
+        histogram.Record(absl::Nanoseconds(t * kNumRecords + i));
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+
+  const LatencySummary summary = histogram.Summarize();
+  EXPECT_EQ(summary.count, kNumThreads * kNumRecords);
+  EXPECT_EQ(summary.max, absl::Nanoseconds(kNumThreads * kNumRecords - 1));
+}
+
+}  // namespace
+}  // namespace intrinsic::internal
@@ -0,0 +1,119 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/message_batcher.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "google/protobuf/message.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::internal {
+
+absl::StatusOr<std::unique_ptr<MessageBatcher>> MessageBatcher::Create(
+    const google::protobuf::Message& exemplar, const Options& options,
+    BatchCallback callback) {
+  if (options.max_batch_size == 0) {
+    return absl::InvalidArgumentError("max_batch_size must be at least 1");
+  }
+  if (options.max_latency <= absl::ZeroDuration()) {
+    return absl::InvalidArgumentError("max_latency must be positive");
+  }
+  auto batcher = absl::WrapUnique(
+      new MessageBatcher(exemplar, options, std::move(callback)));
+  INTR_RETURN_IF_ERROR(batcher->thread_.Start(
+      Thread::Options().SetName("pubsub_batch"),
+      [batcher = batcher.get()]() { batcher->Run(); }));
+  return batcher;
+}
+
+MessageBatcher::MessageBatcher(const google::protobuf::Message& exemplar,
+                               const Options& options, BatchCallback callback)
+    : exemplar_(exemplar.New()),
+      options_(options),
+      callback_(std::move(callback)),
+      pending_(options.max_batch_size),
+      delivering_(options.max_batch_size) {}
+
+MessageBatcher::~MessageBatcher() { Stop(); }
+
+void MessageBatcher::Add(const google::protobuf::Message& message) {
+  absl::MutexLock lock(&mutex_);
+  if (stop_) {
+    return;
+  }
+  if (num_pending_ == pending_.size()) {
+    ++num_dropped_;
+    return;
+  }
+  std::unique_ptr<google::protobuf::Message>& slot = pending_[num_pending_];
+  if (slot == nullptr) {
+    slot.reset(exemplar_->New());
+  }
+  slot->CopyFrom(message);
+  if (num_pending_ == 0) {
+    first_pending_time_ = absl::Now();
+  }
+  ++num_pending_;
+}
+
+void MessageBatcher::Stop() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stop_ = true;
+  }
+  if (thread_.Joinable()) {
+    thread_.Join();
+  }
+}
+
+uint64_t MessageBatcher::num_delivered() const {
+  absl::MutexLock lock(&mutex_);
+  return num_delivered_;
+}
+
+uint64_t MessageBatcher::num_dropped() const {
+  absl::MutexLock lock(&mutex_);
+  return num_dropped_;
+}
+
+void MessageBatcher::Run() {
+  while (true) {
+    size_t batch_size;
+    {
+      absl::MutexLock lock(&mutex_);
+      auto has_pending = [this]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+        return stop_ || num_pending_ > 0;
+      };
+      mutex_.Await(absl::Condition(&has_pending));
+      auto is_full = [this]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+        return stop_ || num_pending_ == pending_.size();
+      };
+      mutex_.AwaitWithDeadline(absl::Condition(&is_full),
+                               first_pending_time_ + options_.max_latency);
+      if (stop_) {
+        return;
+      }
+      batch_size = num_pending_;
+      num_pending_ = 0;
+      pending_.swap(delivering_);
+    }
+
+    callback_(absl::MakeConstSpan(delivering_.data(), batch_size));
+
+    absl::MutexLock lock(&mutex_);
+    num_delivered_ += batch_size;
+  }
+}
+
+}  // namespace intrinsic::internal
@@ -0,0 +1,106 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_MESSAGE_BATCHER_H_
+#define INTRINSIC_PLATFORM_PUBSUB_MESSAGE_BATCHER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "google/protobuf/message.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::internal {
+
+// Accumulates received messages and hands them to a callback in batches.
+//
+// Useful for callbacks with a high fixed cost per invocation, such as Python
+// callbacks, which have to acquire the GIL. A batch is delivered by a thread
+// owned by the batcher once it holds `max_batch_size` messages, or once its
+// oldest message waited for `max_latency`, whichever comes first.
+//
+// Messages are copied into messages of the exemplar's type, which are reused
+// for later batches, so Add() does not allocate once the messages are large
+// enough. At most one batch is pending while the callback runs; messages that
+// arrive while the pending batch is full are dropped.
+//
+// Add() is thread-safe. The callback is only ever invoked from the delivery
+// thread, i.e., one batch at a time.
+class MessageBatcher {
+ public:
+  // Receives a non-empty batch, oldest message first. The messages are only
+  // valid for the duration of the callback.
+  using BatchCallback = std::function<void(
+      absl::Span<const std::unique_ptr<google::protobuf::Message>> batch)>;
+
+  struct Options {
+    // Must be at least 1.
+    size_t max_batch_size = 64;
+    // Must be positive.
+    absl::Duration max_latency = absl::Milliseconds(10);
+  };
+
+  static absl::StatusOr<std::unique_ptr<MessageBatcher>> Create(
+      const google::protobuf::Message& exemplar, const Options& options,
+      BatchCallback callback);
+
+  ~MessageBatcher();
+
+  MessageBatcher(const MessageBatcher&) = delete;
+  MessageBatcher& operator=(const MessageBatcher&) = delete;
+
+  // Copies `message` into the pending batch. `message` must have the type of
+  // the exemplar.
+  void Add(const google::protobuf::Message& message);
+
+  // Stops and joins the delivery thread. Messages that were not delivered yet
+  // are discarded, as are messages that are added afterwards. Must not be
+  // called from the callback.
+  void Stop();
+
+  // Number of messages that were passed to the callback.
+  uint64_t num_delivered() const;
+
+  // Number of messages that were dropped because the callback did not keep up.
+  uint64_t num_dropped() const;
+
+ private:
+  MessageBatcher(const google::protobuf::Message& exemplar,
+                 const Options& options, BatchCallback callback);
+
+  void Run();
+
+  const std::unique_ptr<google::protobuf::Message> exemplar_;
+  const Options options_;
+  const BatchCallback callback_;
+
+  mutable absl::Mutex mutex_;
+  bool stop_ ABSL_GUARDED_BY(mutex_) = false;
+  // Holds `max_batch_size` slots, of which the first `num_pending_` hold
+  // messages. Slots are allocated on first use.
+  std::vector<std::unique_ptr<google::protobuf::Message>> pending_
+      ABSL_GUARDED_BY(mutex_);
+  size_t num_pending_ ABSL_GUARDED_BY(mutex_) = 0;
+  // When the first message of the pending batch was added.
+  absl::Time first_pending_time_ ABSL_GUARDED_BY(mutex_);
+  uint64_t num_delivered_ ABSL_GUARDED_BY(mutex_) = 0;
+  uint64_t num_dropped_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  // The batch that is being delivered. Swapped with `pending_`, so that its
+  // messages are reused for the next batch. Only accessed by the delivery
+  // thread.
+  std::vector<std::unique_ptr<google::protobuf::Message>> delivering_;
+
+  Thread thread_;
+};
+
+}  // namespace intrinsic::internal
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_MESSAGE_BATCHER_H_
@@ -0,0 +1,173 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/message_batcher.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "google/protobuf/message.h"
+#include "intrinsic/platform/common/proto/test.pb.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::internal {
+namespace {
+
+using ::intrinsic::proto::TestMessageString;
+using ::intrinsic::testing::IsOk;
+using ::intrinsic::testing::StatusIs;
+using ::testing::ElementsAre;
+
+constexpr absl::Duration kTimeout = absl::Seconds(10);
+
+TestMessageString Message(const std::string& data) {
+  TestMessageString message;
+  message.set_data(data);
+  return message;
+}
+
+// Records the data of every delivered batch. Optionally blocks the first
+// delivery until Unblock() is called, so that tests can fill up the batcher
+// deterministically.
+class Recorder {
+ public:
+  explicit Recorder(bool block_first_batch = false) {
+    if (!block_first_batch) unblocked_.Notify();
+  }
+
+  MessageBatcher::BatchCallback callback() {
+    return [this](
+               absl::Span<const std::unique_ptr<google::protobuf::Message>>
+                   batch) {
+      if (!started_.HasBeenNotified()) started_.Notify();
+      unblocked_.WaitForNotification();
+      std::vector<std::string> data;
+      for (const auto& message : batch) {
+        data.push_back(static_cast<const TestMessageString&>(*message).data());
+      }
+      absl::MutexLock lock(&mutex_);
+      batches_.push_back(std::move(data));
+    };
+  }
+
+  void WaitUntilBlocked() {
+    ASSERT_TRUE(started_.WaitForNotificationWithTimeout(kTimeout));
+  }
+
+  void Unblock() { unblocked_.Notify(); }
+
+  std::vector<std::vector<std::string>> WaitForBatches(size_t n) {
+    absl::MutexLock lock(&mutex_);
+    auto has_enough = [this, n]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+      return batches_.size() >= n;
+    };
+    mutex_.AwaitWithTimeout(absl::Condition(&has_enough), kTimeout);
+    return batches_;
+  }
+
+ private:
+  absl::Notification started_;
+  absl::Notification unblocked_;
+  absl::Mutex mutex_;
+  std::vector<std::vector<std::string>> batches_ ABSL_GUARDED_BY(mutex_);
+};
+
+TEST(MessageBatcherTest, RejectsInvalidOptions) {
+  EXPECT_THAT(MessageBatcher::Create(TestMessageString(),
+                                     {.max_batch_size = 0}, [](auto) {}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(MessageBatcher::Create(TestMessageString(),
+                                     {.max_latency = absl::ZeroDuration()},
+                                     [](auto) {}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(MessageBatcherTest, DeliversFullBatch) {
+  Recorder recorder;
+  absl::StatusOr<std::unique_ptr<MessageBatcher>> batcher =
+      MessageBatcher::Create(
+          TestMessageString(),
+          {.max_batch_size = 3, .max_latency = absl::Hours(1)},
+          recorder.callback());
+  ASSERT_THAT(batcher.status(), IsOk());
+
+  (*batcher)->Add(Message("a"));
+  (*batcher)->Add(Message("b"));
+  (*batcher)->Add(Message("c"));
+
+  EXPECT_THAT(recorder.WaitForBatches(1),
+              ElementsAre(ElementsAre("a", "b", "c")));
+}
+
+TEST(MessageBatcherTest, DeliversPartialBatchAfterMaxLatency) {
+  Recorder recorder;
+  absl::StatusOr<std::unique_ptr<MessageBatcher>> batcher =
+      MessageBatcher::Create(
+          TestMessageString(),
+          {.max_batch_size = 100, .max_latency = absl::Milliseconds(10)},
+          recorder.callback());
+  ASSERT_THAT(batcher.status(), IsOk());
+
+  const absl::Time start = absl::Now();
+  (*batcher)->Add(Message("a"));
+  (*batcher)->Add(Message("b"));
+
+  EXPECT_THAT(recorder.WaitForBatches(1), ElementsAre(ElementsAre("a", "b")));
+  EXPECT_LT(absl::Now() - start, kTimeout);
+}
+
+TEST(MessageBatcherTest, DropsMessagesWhilePendingBatchIsFull) {
+  Recorder recorder(/*block_first_batch=*/true);
+  absl::StatusOr<std::unique_ptr<MessageBatcher>> batcher =
+      MessageBatcher::Create(
+          TestMessageString(),
+          {.max_batch_size = 2, .max_latency = absl::Hours(1)},
+          recorder.callback());
+  ASSERT_THAT(batcher.status(), IsOk());
+
+  (*batcher)->Add(Message("a"));
+  (*batcher)->Add(Message("b"));
+  recorder.WaitUntilBlocked();
+  (*batcher)->Add(Message("c"));
+  (*batcher)->Add(Message("d"));
+  (*batcher)->Add(Message("e"));
+  recorder.Unblock();
+
+  EXPECT_THAT(recorder.WaitForBatches(2),
+              ElementsAre(ElementsAre("a", "b"), ElementsAre("c", "d")));
+  (*batcher)->Stop();
+  EXPECT_EQ((*batcher)->num_delivered(), 4);
+  EXPECT_EQ((*batcher)->num_dropped(), 1);
+}
+
+TEST(MessageBatcherTest, DiscardsPendingMessagesOnStop) {
+  Recorder recorder;
+  absl::StatusOr<std::unique_ptr<MessageBatcher>> batcher =
+      MessageBatcher::Create(
+          TestMessageString(),
+          {.max_batch_size = 100, .max_latency = absl::Hours(1)},
+          recorder.callback());
+  ASSERT_THAT(batcher.status(), IsOk());
+
+  (*batcher)->Add(Message("a"));
+  (*batcher)->Stop();
+  (*batcher)->Add(Message("b"));
+
+  EXPECT_EQ((*batcher)->num_delivered(), 0);
+  EXPECT_EQ((*batcher)->num_dropped(), 0);
+}
+
+}  // namespace
+}  // namespace intrinsic::internal
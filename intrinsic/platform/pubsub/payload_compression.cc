@@ -0,0 +1,234 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/payload_compression.h"
+
+#include <zlib.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "intrinsic/platform/pubsub/adapters/pubsub.pb.h"
+#include "intrinsic/platform/pubsub/pubsub_packet_view.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic::internal {
+
+namespace {
+
+using ::google::protobuf::io::CodedOutputStream;
+using ::intrinsic_proto::pubsub::PubSubPacket;
+
+constexpr uint32_t kWireTypeVarint = 0;
+constexpr uint32_t kWireTypeLengthDelimited = 2;
+
+constexpr uint32_t MakeTag(uint32_t field_number, uint32_t wire_type) {
+  return (field_number << 3) | wire_type;
+}
+
+// Field tags of intrinsic_proto::pubsub::PubSubPacket.
+constexpr uint32_t kPacketPayloadTag = MakeTag(1, kWireTypeLengthDelimited);
+constexpr uint32_t kPacketPublishTimeTag = MakeTag(2, kWireTypeLengthDelimited);
+constexpr uint32_t kPacketTraceIdTag = MakeTag(4, kWireTypeVarint);
+constexpr uint32_t kPacketSpanIdTag = MakeTag(5, kWireTypeVarint);
+constexpr uint32_t kPacketPayloadCompressionTag = MakeTag(6, kWireTypeVarint);
+constexpr uint32_t kPacketUncompressedPayloadSizeTag =
+    MakeTag(7, kWireTypeVarint);
+// Field tags of google::protobuf::Any.
+constexpr uint32_t kAnyTypeUrlTag = MakeTag(1, kWireTypeLengthDelimited);
+constexpr uint32_t kAnyValueTag = MakeTag(2, kWireTypeLengthDelimited);
+// Field tags of google::protobuf::Timestamp.
+constexpr uint32_t kTimestampSecondsTag = MakeTag(1, kWireTypeVarint);
+constexpr uint32_t kTimestampNanosTag = MakeTag(2, kWireTypeVarint);
+
+size_t LengthDelimitedSize(uint32_t tag, size_t payload_size) {
+  return CodedOutputStream::VarintSize32(tag) +
+         CodedOutputStream::VarintSize64(payload_size) + payload_size;
+}
+
+// Size of a varint field, or 0 if `value` is 0 and thus not serialized.
+size_t VarintFieldSize(uint32_t tag, uint64_t value) {
+  if (value == 0) return 0;
+  return CodedOutputStream::VarintSize32(tag) +
+         CodedOutputStream::VarintSize64(value);
+}
+
+uint8_t* WriteLengthDelimitedHeader(uint32_t tag, size_t payload_size,
+                                    uint8_t* target) {
+  target = CodedOutputStream::WriteVarint32ToArray(tag, target);
+  return CodedOutputStream::WriteVarint64ToArray(payload_size, target);
+}
+
+uint8_t* WriteVarintField(uint32_t tag, uint64_t value, uint8_t* target) {
+  if (value == 0) return target;
+  target = CodedOutputStream::WriteVarint32ToArray(tag, target);
+  return CodedOutputStream::WriteVarint64ToArray(value, target);
+}
+
+// Writes the payload value to `target`, which has room for exactly the size of
+// the value.
+using WriteValueFn = absl::FunctionRef<absl::Status(char* target)>;
+
+// Writes a packet with the envelope of `packet`, the given compression fields
+// and a payload value of `value_size` bytes to `buffer`.
+absl::StatusOr<absl::string_view> WritePacket(
+    const PubSubPacketView& packet,
+    PubSubPacket::PayloadCompression compression,
+    uint64_t uncompressed_payload_size, size_t value_size,
+    WriteValueFn write_value, std::string* buffer) {
+  const absl::string_view type_url = packet.payload_type_url();
+  const int64_t seconds = packet.publish_time_seconds();
+  const int32_t nanos = packet.publish_time_nanos();
+
+  size_t any_size = LengthDelimitedSize(kAnyTypeUrlTag, type_url.size());
+  if (value_size != 0) {
+    any_size += LengthDelimitedSize(kAnyValueTag, value_size);
+  }
+  size_t timestamp_size = VarintFieldSize(kTimestampSecondsTag, seconds);
+  if (nanos != 0) {
+    timestamp_size += CodedOutputStream::VarintSize32(kTimestampNanosTag) +
+                      CodedOutputStream::VarintSize32SignExtended(nanos);
+  }
+  const size_t packet_size =
+      LengthDelimitedSize(kPacketPayloadTag, any_size) +
+      LengthDelimitedSize(kPacketPublishTimeTag, timestamp_size) +
+      VarintFieldSize(kPacketTraceIdTag, packet.trace_id()) +
+      VarintFieldSize(kPacketSpanIdTag, packet.span_id()) +
+      VarintFieldSize(kPacketPayloadCompressionTag, compression) +
+      VarintFieldSize(kPacketUncompressedPayloadSizeTag,
+                      uncompressed_payload_size);
+  if (packet_size > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Serialized PubSubPacket exceeds 2GiB (", packet_size, " bytes)"));
+  }
+
+  buffer->resize(packet_size);
+  uint8_t* target = reinterpret_cast<uint8_t*>(buffer->data());
+
+  // PubSubPacket.payload (google.protobuf.Any)
+  target = WriteLengthDelimitedHeader(kPacketPayloadTag, any_size, target);
+  target = WriteLengthDelimitedHeader(kAnyTypeUrlTag, type_url.size(), target);
+  target = CodedOutputStream::WriteRawToArray(type_url.data(), type_url.size(),
+                                              target);
+  if (value_size != 0) {
+    target = WriteLengthDelimitedHeader(kAnyValueTag, value_size, target);
+    INTR_RETURN_IF_ERROR(write_value(reinterpret_cast<char*>(target)));
+    target += value_size;
+  }
+
+  // PubSubPacket.publish_time (google.protobuf.Timestamp)
+  target =
+      WriteLengthDelimitedHeader(kPacketPublishTimeTag, timestamp_size, target);
+  target = WriteVarintField(kTimestampSecondsTag, seconds, target);
+  if (nanos != 0) {
+    target =
+        CodedOutputStream::WriteVarint32ToArray(kTimestampNanosTag, target);
+    target =
+        CodedOutputStream::WriteVarint32SignExtendedToArray(nanos, target);
+  }
+
+  target = WriteVarintField(kPacketTraceIdTag, packet.trace_id(), target);
+  target = WriteVarintField(kPacketSpanIdTag, packet.span_id(), target);
+  target = WriteVarintField(kPacketPayloadCompressionTag, compression, target);
+  WriteVarintField(kPacketUncompressedPayloadSizeTag,
+                   uncompressed_payload_size, target);
+  return absl::string_view(*buffer);
+}
+
+}  // namespace
+
+absl::StatusOr<absl::string_view> CompressPubSubPacket(
+    absl::string_view packet, const PayloadCompressionOptions& options,
+    std::string* buffer) {
+  if (options.compression == PubSubPacket::PAYLOAD_COMPRESSION_NONE) {
+    return packet;
+  }
+  if (options.compression != PubSubPacket::PAYLOAD_COMPRESSION_ZLIB) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Unsupported payload compression ", options.compression));
+  }
+  INTR_ASSIGN_OR_RETURN(const PubSubPacketView view,
+                        PubSubPacketView::Parse(packet));
+  const absl::string_view value = view.payload_value();
+  if (view.payload_compression() != PubSubPacket::PAYLOAD_COMPRESSION_NONE ||
+      value.empty() || value.size() < options.threshold) {
+    return packet;
+  }
+
+  // The size of the compressed payload precedes it in the envelope, so the
+  // payload is compressed into a scratch buffer first. Only the size of the
+  // scratch buffer is ever changed, so it keeps its capacity.
+  thread_local std::string compressed;
+  uLongf compressed_size = compressBound(value.size());
+  if (compressed.size() < compressed_size) {
+    compressed.resize(compressed_size);
+  }
+  if (int ret = compress2(reinterpret_cast<Bytef*>(compressed.data()),
+                          &compressed_size,
+                          reinterpret_cast<const Bytef*>(value.data()),
+                          value.size(), Z_BEST_SPEED);
+      ret != Z_OK) {
+    return absl::InternalError(
+        absl::StrCat("Failed to compress payload, zlib error ", ret));
+  }
+  if (compressed_size >= value.size()) {
+    // Incompressible, e.g., an encoded image.
+    return packet;
+  }
+
+  buffer->clear();
+  return WritePacket(
+      view, PubSubPacket::PAYLOAD_COMPRESSION_ZLIB, value.size(),
+      compressed_size,
+      [&](char* target) {
+        std::memcpy(target, compressed.data(), compressed_size);
+        return absl::OkStatus();
+      },
+      buffer);
+}
+
+absl::StatusOr<absl::string_view> DecompressPubSubPacket(
+    absl::string_view packet, std::string* buffer) {
+  absl::StatusOr<PubSubPacketView> view = PubSubPacketView::Parse(packet);
+  if (!view.ok() ||
+      view->payload_compression() == PubSubPacket::PAYLOAD_COMPRESSION_NONE) {
+    return packet;
+  }
+  if (view->payload_compression() != PubSubPacket::PAYLOAD_COMPRESSION_ZLIB) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Unsupported payload compression ", view->payload_compression()));
+  }
+  const uint64_t uncompressed_size = view->uncompressed_payload_size();
+  if (uncompressed_size >
+      static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Uncompressed payload exceeds 2GiB (", uncompressed_size, " bytes)"));
+  }
+
+  const absl::string_view value = view->payload_value();
+  buffer->clear();
+  return WritePacket(
+      *view, PubSubPacket::PAYLOAD_COMPRESSION_NONE,
+      /*uncompressed_payload_size=*/0, uncompressed_size,
+      [&](char* target) {
+        uLongf size = uncompressed_size;
+        if (uncompress(reinterpret_cast<Bytef*>(target), &size,
+                       reinterpret_cast<const Bytef*>(value.data()),
+                       value.size()) != Z_OK ||
+            size != uncompressed_size) {
+          return absl::InvalidArgumentError("Corrupt compressed payload");
+        }
+        return absl::OkStatus();
+      },
+      buffer);
+}
+
+}  // namespace intrinsic::internal
@@ -0,0 +1,51 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_PAYLOAD_COMPRESSION_H_
+#define INTRINSIC_PLATFORM_PUBSUB_PAYLOAD_COMPRESSION_H_
+
+#include <cstddef>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "intrinsic/platform/pubsub/adapters/pubsub.pb.h"
+
+namespace intrinsic::internal {
+
+// How a publisher compresses the payloads of its packets.
+struct PayloadCompressionOptions {
+  intrinsic_proto::pubsub::PubSubPacket::PayloadCompression compression =
+      intrinsic_proto::pubsub::PubSubPacket::PAYLOAD_COMPRESSION_NONE;
+  // Payloads smaller than this many bytes are not compressed.
+  size_t threshold = 0;
+};
+
+// Returns the packet to send instead of the serialized PubSubPacket `packet`.
+// That is a packet with the payload compressed according to `options`, written
+// to `buffer`, or `packet` itself if compression is disabled, the payload is
+// smaller than the threshold or already compressed, or compression does not
+// make it smaller.
+//
+// `buffer` is cleared first. Compression uses a scratch buffer that is reused
+// on this thread, so if `buffer` is reused across calls, this does not
+// allocate once the buffers are large enough for the largest packet.
+//
+// Returns an error if `packet` is not a valid serialized PubSubPacket.
+absl::StatusOr<absl::string_view> CompressPubSubPacket(
+    absl::string_view packet, const PayloadCompressionOptions& options,
+    std::string* buffer);
+
+// Returns the serialized PubSubPacket `packet` with its payload decompressed.
+// That is a packet written to `buffer`, or `packet` itself if its payload is
+// not compressed or the envelope is malformed, so that the caller reports it
+// like any other malformed packet.
+//
+// `buffer` is cleared first and the payload is decompressed directly into it.
+//
+// Returns an error if the payload cannot be decompressed.
+absl::StatusOr<absl::string_view> DecompressPubSubPacket(
+    absl::string_view packet, std::string* buffer);
+
+}  // namespace intrinsic::internal
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_PAYLOAD_COMPRESSION_H_
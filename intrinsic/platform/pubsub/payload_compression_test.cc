@@ -0,0 +1,113 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/payload_compression.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/wrappers.pb.h"
+#include "intrinsic/platform/pubsub/adapters/pubsub.pb.h"
+#include "intrinsic/platform/pubsub/pubsub_packet_view.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::internal {
+namespace {
+
+using ::intrinsic::testing::IsOk;
+using ::intrinsic::testing::StatusIs;
+using ::intrinsic_proto::pubsub::PubSubPacket;
+
+constexpr PayloadCompressionOptions kZlib = {
+    .compression = PubSubPacket::PAYLOAD_COMPRESSION_ZLIB,
+    .threshold = 1024,
+};
+
+std::string MakePacket(absl::string_view payload) {
+  google::protobuf::StringValue message;
+  message.set_value(std::string(payload));
+  PubSubPacket packet;
+  packet.mutable_payload()->PackFrom(message);
+  packet.mutable_publish_time()->set_seconds(1700000000);
+  packet.mutable_publish_time()->set_nanos(5);
+  packet.set_trace_id(77);
+  packet.set_span_id(88);
+  return packet.SerializeAsString();
+}
+
+TEST(PayloadCompressionTest, RoundTripPreservesPacket) {
+  const std::string packet = MakePacket(std::string(64 << 10, 'a'));
+
+  std::string compressed_buffer;
+  absl::StatusOr<absl::string_view> compressed =
+      CompressPubSubPacket(packet, kZlib, &compressed_buffer);
+  ASSERT_THAT(compressed.status(), IsOk());
+  EXPECT_LT(compressed->size(), packet.size() / 10);
+
+  absl::StatusOr<PubSubPacketView> view = PubSubPacketView::Parse(*compressed);
+  ASSERT_THAT(view.status(), IsOk());
+  EXPECT_EQ(view->payload_compression(),
+            PubSubPacket::PAYLOAD_COMPRESSION_ZLIB);
+  EXPECT_TRUE(view->PayloadIs("google.protobuf.StringValue"));
+  EXPECT_EQ(view->publish_time_seconds(), 1700000000);
+  EXPECT_EQ(view->trace_id(), 77);
+
+  std::string decompressed_buffer;
+  absl::StatusOr<absl::string_view> decompressed =
+      DecompressPubSubPacket(*compressed, &decompressed_buffer);
+  ASSERT_THAT(decompressed.status(), IsOk());
+  EXPECT_EQ(*decompressed, packet);
+}
+
+TEST(PayloadCompressionTest, KeepsSmallPayloads) {
+  const std::string packet = MakePacket(std::string(100, 'a'));
+  std::string buffer;
+  absl::StatusOr<absl::string_view> compressed =
+      CompressPubSubPacket(packet, kZlib, &buffer);
+  ASSERT_THAT(compressed.status(), IsOk());
+  EXPECT_EQ(compressed->data(), packet.data());
+}
+
+TEST(PayloadCompressionTest, KeepsIncompressiblePayloads) {
+  std::string payload;
+  uint32_t state = 1;
+  for (int i = 0; i < 4096; ++i) {
+    state = state * 1664525 + 1013904223;
+    payload.push_back(static_cast<char>(state >> 24));
+  }
+  const std::string packet = MakePacket(payload);
+  std::string buffer;
+  absl::StatusOr<absl::string_view> compressed =
+      CompressPubSubPacket(packet, kZlib, &buffer);
+  ASSERT_THAT(compressed.status(), IsOk());
+  EXPECT_EQ(compressed->data(), packet.data());
+}
+
+TEST(PayloadCompressionTest, PassesUncompressedPacketsThrough) {
+  const std::string packet = MakePacket("hello");
+  std::string buffer;
+  absl::StatusOr<absl::string_view> decompressed =
+      DecompressPubSubPacket(packet, &buffer);
+  ASSERT_THAT(decompressed.status(), IsOk());
+  EXPECT_EQ(decompressed->data(), packet.data());
+}
+
+TEST(PayloadCompressionTest, RejectsCorruptPayload) {
+  PubSubPacket packet;
+  packet.mutable_payload()->set_type_url(
+      "type.googleapis.com/google.protobuf.StringValue");
+  packet.mutable_payload()->set_value("not a zlib stream");
+  packet.set_payload_compression(PubSubPacket::PAYLOAD_COMPRESSION_ZLIB);
+  packet.set_uncompressed_payload_size(100);
+  std::string buffer;
+  EXPECT_THAT(
+      DecompressPubSubPacket(packet.SerializeAsString(), &buffer).status(),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace intrinsic::internal
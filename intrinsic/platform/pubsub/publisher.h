@@ -3,16 +3,35 @@
 #ifndef INTRINSIC_PLATFORM_PUBSUB_PUBLISHER_H_
 #define INTRINSIC_PLATFORM_PUBSUB_PUBLISHER_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "google/protobuf/message.h"
 
 namespace intrinsic {
 
 struct PublisherData;
 
+// Counters of the messages of a publisher that were published with
+// Publisher::PublishAsync().
+struct AsyncPublishStats {
+  // Messages that were accepted for sending.
+  uint64_t enqueued = 0;
+  // Messages that were replaced by a newer message before they were sent
+  // (AsyncPublishingCoalesced only).
+  uint64_t coalesced = 0;
+  // Messages that were rejected because the queue was full.
+  uint64_t dropped = 0;
+  // Messages that the middleware failed to send.
+  uint64_t failed = 0;
+};
+
 class Publisher {
  public:
   Publisher(absl::string_view topic_name,
@@ -32,9 +51,54 @@ class Publisher {
     return Publish(message, absl::Now());
   }
 
+  // Publishes a finished FlatBuffer whose root table has the fully qualified
+  // name `root_type` (e.g., "intrinsic_fbs.Point"). The bytes of `flatbuffer`
+  // are copied into the packet as is, without an intermediate protobuf
+  // message, and subscribers created with PubSub::CreateFlatbufferSubscription()
+  // access them in place. For a flatbuffers::FlatBufferBuilder `builder`, pass
+  // `{builder.GetBufferPointer(), builder.GetSize()}`.
+  absl::Status PublishFlatbuffer(absl::string_view root_type,
+                                 absl::Span<const uint8_t> flatbuffer,
+                                 absl::Time event_time) const;
+
+  absl::Status PublishFlatbuffer(absl::string_view root_type,
+                                 absl::Span<const uint8_t> flatbuffer) const {
+    return PublishFlatbuffer(root_type, flatbuffer, absl::Now());
+  }
+
+  // Publishes `packet`, a serialized PubSubPacket such as one received with
+  // PubSub::CreateSerializedPacketSubscription(), as is. The packet keeps its
+  // original publish time. Returns an InvalidArgument error if `packet` is not
+  // a valid PubSubPacket.
+  absl::Status PublishSerializedPacket(absl::string_view packet) const;
+
+  // Encodes `message` on the calling thread and hands it to the I/O thread of
+  // the PubSub instance for sending, without blocking on the middleware. The
+  // publisher must have been created with TopicConfig::async_publishing
+  // enabled; returns a FailedPrecondition error otherwise.
+  //
+  // Does not allocate once the queue of the publisher has grown to the size of
+  // the largest message and never waits for a lock. Returns a
+  // ResourceExhausted error if the message was dropped because the queue was
+  // full or another thread was publishing on the same topic at the same time.
+  // Errors of the middleware are not returned but counted, see
+  // GetAsyncPublishStats().
+  absl::Status PublishAsync(const google::protobuf::Message& message,
+                            absl::Time event_time) const;
+
+  absl::Status PublishAsync(const google::protobuf::Message& message) const {
+    return PublishAsync(message, absl::Now());
+  }
+
+  // Returns the counters of PublishAsync(). All counters are zero if
+  // asynchronous publishing is not enabled.
+  AsyncPublishStats GetAsyncPublishStats() const;
+
   absl::string_view TopicName() const { return topic_name_; }
 
  private:
+  friend class PublisherGroup;
+
   std::string topic_name_ = {};
   std::unique_ptr<PublisherData> publisher_data_ = {};
 };
@@ -0,0 +1,78 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_PUBLISHER_GROUP_H_
+#define INTRINSIC_PLATFORM_PUBSUB_PUBLISHER_GROUP_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "google/protobuf/message.h"
+#include "intrinsic/platform/pubsub/publisher.h"
+
+namespace intrinsic {
+
+// A fixed set of publishers whose messages are published together, e.g., a
+// set of status topics that is published on every control cycle.
+//
+// Compared to calling Publisher::Publish() for each topic, a PublisherGroup
+// takes a single publish timestamp for all messages and encodes all packets
+// into one contiguous buffer that is reused between calls.
+//
+// Create a PublisherGroup with PubSub::CreatePublisherGroup():
+//
+//   INTR_ASSIGN_OR_RETURN(
+//       PublisherGroup group,
+//       pubsub.CreatePublisherGroup({"/status/a", "/status/b"}, TopicConfig()));
+//   StatusA a;
+//   StatusB b;
+//   INTR_RETURN_IF_ERROR(group.Publish({&a, &b}));
+//
+// This class is not thread-safe.
+class PublisherGroup {
+ public:
+  explicit PublisherGroup(std::vector<Publisher> publishers);
+
+  PublisherGroup(const PublisherGroup&) = delete;
+  PublisherGroup& operator=(const PublisherGroup&) = delete;
+  PublisherGroup(PublisherGroup&&) = default;
+  PublisherGroup& operator=(PublisherGroup&&) = default;
+
+  // Publishes `messages[i]` on the i-th publisher of the group. `messages` must
+  // have exactly one entry per publisher. Entries may be nullptr, in which case
+  // nothing is published on the respective topic.
+  //
+  // All messages are stamped with the same publish time. Publishing continues
+  // for the remaining topics if publishing on one topic fails, in which case
+  // an error is returned after all messages have been handed to the
+  // middleware.
+  absl::Status Publish(
+      absl::Span<const google::protobuf::Message* const> messages,
+      absl::Time event_time);
+
+  absl::Status Publish(
+      absl::Span<const google::protobuf::Message* const> messages) {
+    return Publish(messages, absl::Now());
+  }
+
+  size_t size() const { return publishers_.size(); }
+
+  const Publisher& publisher(size_t index) const { return publishers_[index]; }
+
+ private:
+  std::vector<Publisher> publishers_;
+  // Buffers reused between calls to Publish(), so that publishing a batch does
+  // not allocate once they have grown to the size of the largest batch.
+  std::string buffer_;
+  std::string compressed_buffer_;
+  std::vector<size_t> packet_ends_;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_PUBLISHER_GROUP_H_
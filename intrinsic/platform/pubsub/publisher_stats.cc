@@ -2,30 +2,65 @@
 
 #include "intrinsic/platform/pubsub/publisher_stats.h"
 
-#include <limits>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 
 namespace intrinsic::internal {
 
-int PublisherStats::GetCount(absl::string_view topic) {
-  absl::MutexLock lock(&mu_);
-  return counts_[topic];
+absl::Time TopicPublishCounters::last_publish_time() const {
+  const int64_t ns = last_publish_time_ns_.load(std::memory_order_relaxed);
+  if (ns == kNeverPublished) return absl::InfinitePast();
+  return absl::FromUnixNanos(ns);
 }
 
-void PublisherStats::Increment(absl::string_view topic) {
+void TopicPublishCounters::Reset() {
+  messages_.store(0, std::memory_order_relaxed);
+  bytes_.store(0, std::memory_order_relaxed);
+  last_publish_time_ns_.store(kNeverPublished, std::memory_order_relaxed);
+}
+
+TopicPublishCounters* PublisherStats::GetOrRegister(absl::string_view topic) {
   absl::MutexLock lock(&mu_);
-  if (counts_[topic] == std::numeric_limits<int64_t>::max()) {
-    counts_[topic] = 0;
+  std::unique_ptr<TopicPublishCounters>& counters = counters_[topic];
+  if (counters == nullptr) {
+    counters = std::make_unique<TopicPublishCounters>();
   }
-  counts_[topic]++;
+  return counters.get();
+}
+
+const TopicPublishCounters* PublisherStats::Find(absl::string_view topic) {
+  absl::MutexLock lock(&mu_);
+  auto it = counters_.find(topic);
+  return it == counters_.end() ? nullptr : it->second.get();
+}
+
+int PublisherStats::GetCount(absl::string_view topic) {
+  const TopicPublishCounters* counters = Find(topic);
+  return counters == nullptr ? 0 : counters->messages();
+}
+
+int64_t PublisherStats::GetByteCount(absl::string_view topic) {
+  const TopicPublishCounters* counters = Find(topic);
+  return counters == nullptr ? 0 : counters->bytes();
+}
+
+absl::Time PublisherStats::GetLastPublishTime(absl::string_view topic) {
+  const TopicPublishCounters* counters = Find(topic);
+  return counters == nullptr ? absl::InfinitePast()
+                             : counters->last_publish_time();
 }
 
 void PublisherStats::Reset() {
   absl::MutexLock lock(&mu_);
-  counts_.clear();
+  for (auto& [topic, counters] : counters_) {
+    counters->Reset();
+  }
 }
 
 void ResetMessagesPublished() { return PublisherStats::Singleton().Reset(); }
@@ -34,4 +69,12 @@ int MessagesPublished(absl::string_view topic) {
   return PublisherStats::Singleton().GetCount(topic);
 }
 
+int64_t BytesPublished(absl::string_view topic) {
+  return PublisherStats::Singleton().GetByteCount(topic);
+}
+
+absl::Time LastPublishTime(absl::string_view topic) {
+  return PublisherStats::Singleton().GetLastPublishTime(topic);
+}
+
 }  // namespace intrinsic::internal
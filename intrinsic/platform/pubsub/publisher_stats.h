@@ -3,21 +3,74 @@
 #ifndef INTRINSIC_PLATFORM_PUBSUB_PUBLISHER_STATS_H_
 #define INTRINSIC_PLATFORM_PUBSUB_PUBLISHER_STATS_H_
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <string>
 
+#include "absl/base/optimization.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 
 namespace intrinsic::internal {
 
+// Publishing statistics of a single topic.
+//
+// Publishers update the counters with relaxed atomic operations, so recording
+// a publish neither takes a lock nor looks up the topic. The counters are
+// aligned to a cache line so that publishers of different topics do not
+// contend on the same cache line.
+class ABSL_CACHELINE_ALIGNED TopicPublishCounters {
+ public:
+  // Records a single published message of the given serialized size.
+  void RecordPublish(size_t bytes, absl::Time publish_time) {
+    messages_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    last_publish_time_ns_.store(absl::ToUnixNanos(publish_time),
+                                std::memory_order_relaxed);
+  }
+
+  int64_t messages() const { return messages_.load(std::memory_order_relaxed); }
+
+  int64_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+  // Returns absl::InfinitePast() if no message has been published.
+  absl::Time last_publish_time() const;
+
+  void Reset();
+
+ private:
+  static constexpr int64_t kNeverPublished =
+      std::numeric_limits<int64_t>::min();
+
+  std::atomic<int64_t> messages_ = 0;
+  std::atomic<int64_t> bytes_ = 0;
+  std::atomic<int64_t> last_publish_time_ns_ = kNeverPublished;
+};
+
 class PublisherStats {
  public:
+  // Returns the counters for the given topic, creating them if necessary. The
+  // returned pointer remains valid for the lifetime of the process. This is
+  // meant to be called once when creating a publisher, which then records
+  // every publish on the returned counters.
+  TopicPublishCounters* GetOrRegister(absl::string_view topic);
+
   int GetCount(absl::string_view topic);
 
-  void Increment(absl::string_view topic);
+  int64_t GetByteCount(absl::string_view topic);
+
+  // Returns absl::InfinitePast() if no message has been published on the
+  // topic.
+  absl::Time GetLastPublishTime(absl::string_view topic);
 
+  // Resets all counters to 0. Counters returned by GetOrRegister() remain
+  // valid.
   void Reset();
 
   static PublisherStats& Singleton() {
@@ -26,12 +79,22 @@ class PublisherStats {
   }
 
  private:
+  // Returns nullptr if the topic has not been registered.
+  const TopicPublishCounters* Find(absl::string_view topic);
+
   absl::Mutex mu_;
-  absl::flat_hash_map<std::string, int64_t> counts_ ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::string, std::unique_ptr<TopicPublishCounters>>
+      counters_ ABSL_GUARDED_BY(mu_);
 };
 
 // How many pubsub messages have been sent by this process for a given topic.
 int MessagesPublished(absl::string_view topic);
+// How many bytes of serialized pubsub packets have been sent by this process
+// for a given topic.
+int64_t BytesPublished(absl::string_view topic);
+// When the last pubsub message was sent by this process for a given topic, or
+// absl::InfinitePast() if none was sent.
+absl::Time LastPublishTime(absl::string_view topic);
 // Reset the MessagePublished counters to 0.
 void ResetMessagesPublished();
 
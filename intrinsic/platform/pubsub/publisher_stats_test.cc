@@ -0,0 +1,50 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/publisher_stats.h"
+
+#include <gtest/gtest.h>
+
+#include "absl/time/time.h"
+
+namespace intrinsic::internal {
+namespace {
+
+TEST(PublisherStatsTest, RecordsOnRegisteredCounters) {
+  PublisherStats stats;
+  TopicPublishCounters* counters = stats.GetOrRegister("/topic");
+  EXPECT_EQ(stats.GetOrRegister("/topic"), counters);
+  EXPECT_EQ(stats.GetCount("/topic"), 0);
+  EXPECT_EQ(stats.GetLastPublishTime("/topic"), absl::InfinitePast());
+
+  const absl::Time t0 = absl::FromUnixSeconds(1700000000);
+  counters->RecordPublish(/*bytes=*/10, t0);
+  counters->RecordPublish(/*bytes=*/32, t0 + absl::Milliseconds(1));
+
+  EXPECT_EQ(stats.GetCount("/topic"), 2);
+  EXPECT_EQ(stats.GetByteCount("/topic"), 42);
+  EXPECT_EQ(stats.GetLastPublishTime("/topic"), t0 + absl::Milliseconds(1));
+}
+
+TEST(PublisherStatsTest, UnknownTopicHasNoStats) {
+  PublisherStats stats;
+  EXPECT_EQ(stats.GetCount("/unknown"), 0);
+  EXPECT_EQ(stats.GetByteCount("/unknown"), 0);
+  EXPECT_EQ(stats.GetLastPublishTime("/unknown"), absl::InfinitePast());
+}
+
+TEST(PublisherStatsTest, ResetKeepsCountersValid) {
+  PublisherStats stats;
+  TopicPublishCounters* counters = stats.GetOrRegister("/topic");
+  counters->RecordPublish(/*bytes=*/10, absl::FromUnixSeconds(1));
+  stats.Reset();
+  EXPECT_EQ(stats.GetCount("/topic"), 0);
+  EXPECT_EQ(stats.GetByteCount("/topic"), 0);
+  EXPECT_EQ(stats.GetLastPublishTime("/topic"), absl::InfinitePast());
+
+  counters->RecordPublish(/*bytes=*/5, absl::FromUnixSeconds(2));
+  EXPECT_EQ(stats.GetCount("/topic"), 1);
+  EXPECT_EQ(stats.GetByteCount("/topic"), 5);
+}
+
+}  // namespace
+}  // namespace intrinsic::internal
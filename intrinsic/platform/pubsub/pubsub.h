@@ -3,20 +3,36 @@
 #ifndef INTRINSIC_PLATFORM_PUBSUB_PUBSUB_H_
 #define INTRINSIC_PLATFORM_PUBSUB_PUBSUB_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <memory>
+#include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "absl/functional/function_ref.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "flatbuffers/flatbuffers.h"
 #include "google/protobuf/any.pb.h"
 #include "google/protobuf/message.h"
 #include "intrinsic/platform/pubsub/adapters/pubsub.pb.h"
 #include "intrinsic/platform/pubsub/publisher.h"
+#include "intrinsic/platform/pubsub/publisher_group.h"
+#include "intrinsic/platform/pubsub/pubsub_packet_view.h"
+#include "intrinsic/platform/pubsub/queryable.h"
+#include "intrinsic/platform/pubsub/reusable_message_pool.h"
 #include "intrinsic/platform/pubsub/subscription.h"
+#include "intrinsic/platform/pubsub/zenoh_util/zenoh_config.h"
+#include "intrinsic/util/thread/thread.h"
 
 // The PubSub class implements an interface to a publisher-subscriber
 // system, a one-to-many communication bus that allows sending protocol buffers
@@ -56,6 +72,24 @@
 // Note: Be careful to not destroy the PubSub instance after creating a
 // Subscription.
 //
+// Answering requests on a key, e.g., for small and frequent requests within a
+// cell that do not warrant a gRPC service:
+//
+//   INTR_ASSIGN_OR_RETURN(
+//       Queryable queryable,
+//       pubsub.CreateQueryable<PoseRequest, Pose>(
+//           "/calibration/latest_pose",
+//           [](const PoseRequest& request, Pose& pose) -> absl::Status {
+//             // Here we fill in the response.
+//             return absl::OkStatus();
+//           }));
+//
+// Sending a request to it:
+//
+//   Pose pose;
+//   INTR_RETURN_IF_ERROR(
+//       pubsub.QueryOne("/calibration/latest_pose", PoseRequest(), pose));
+//
 namespace intrinsic {
 
 struct TopicConfig {
@@ -65,6 +99,115 @@ struct TopicConfig {
   };
 
   TopicQoS topic_qos = HighReliability;
+
+  enum TopicTransport {
+    // Packets are sent through the middleware.
+    Network = 0,
+    // Packets are written to a shared memory segment on the local host and
+    // only a small descriptor of each packet is sent through the middleware.
+    // This avoids sending large payloads, such as images or point clouds,
+    // through the network stack. Publishers and subscribers of the topic must
+    // run on the same host and all of them must use this transport.
+    // Subscribers still receive packets that are sent through the network,
+    // e.g., if a packet is larger than `shared_memory_slot_size`.
+    SameHostSharedMemory = 1,
+  };
+
+  TopicTransport transport = Network;
+
+  // Layout of the shared memory segment of a SameHostSharedMemory topic. All
+  // publishers of the topic must use the same values. A subscriber loses
+  // packets if it falls behind by more than `shared_memory_num_slots`
+  // packets.
+  size_t shared_memory_num_slots = 16;
+  size_t shared_memory_slot_size = 1 << 20;
+
+  // How received messages are handed to the callback of a subscription.
+  enum DeliveryMode {
+    // The callback runs on the thread of the middleware that received the
+    // message. A slow callback delays the delivery of all messages of the
+    // session.
+    Inline = 0,
+    // The callback runs on a thread owned by the subscription, and only the
+    // newest message of every topic is kept until the callback is ready for
+    // it. Older messages are dropped. Recommended for Sensor topics.
+    LatestValue = 1,
+    // The callback runs on a thread owned by the subscription, which receives
+    // messages through a queue of `delivery_queue_capacity` messages. Messages
+    // that arrive while the queue is full are dropped.
+    BoundedQueue = 2,
+  };
+
+  // Only applies to subscriptions. See Subscription::NumDroppedMessages().
+  DeliveryMode delivery = Inline;
+
+  // Capacity of the queue of a subscription with BoundedQueue delivery.
+  size_t delivery_queue_capacity = 64;
+
+  // Options of the thread that runs the callback of a subscription with
+  // LatestValue or BoundedQueue delivery, e.g., a real-time priority and
+  // dedicated CPUs for a critical sensor topic, so that its callback wakes up
+  // with a consistent latency regardless of bulk traffic on other topics. Reuse
+  // one TopicConfig for all topics of a class of traffic. Must be left at the
+  // default for Inline delivery, whose callbacks run on the threads of the
+  // middleware.
+  Thread::Options delivery_thread_options;
+
+  // Whether a subscription records the latencies of the packets it receives,
+  // see Subscription::GetLatencyStats() and
+  // PubSub::PublishLatencyIntrospection(). Costs a clock read and a parse of
+  // the packet envelope per packet. Only applies to subscriptions.
+  bool record_latency = false;
+
+  // Decides from the envelope of a received packet whether a subscription
+  // handles it, e.g., so that a recorder skips the payload types or publish
+  // times it does not record. Packets for which it returns false are dropped
+  // before they are queued for delivery, decompressed or parsed. Packets whose
+  // envelope is malformed are passed on, so that the subscription reports them
+  // as usual.
+  //
+  // Runs on the thread of the middleware for every received packet, so it must
+  // be cheap and thread-safe. Only applies to subscriptions.
+  std::function<bool(absl::string_view topic,
+                     const internal::PubSubPacketView& packet)>
+      packet_filter;
+
+  // Whether a publisher supports Publisher::PublishAsync().
+  enum AsyncPublishing {
+    AsyncPublishingDisabled = 0,
+    // Messages are sent in the order in which they were published, through a
+    // queue of `async_publish_queue_capacity` messages.
+    AsyncPublishingQueued = 1,
+    // Only the newest message that was not sent yet is kept; older messages
+    // are replaced by newer ones.
+    AsyncPublishingCoalesced = 2,
+  };
+
+  // Only applies to publishers.
+  AsyncPublishing async_publishing = AsyncPublishingDisabled;
+
+  // Capacity of the queue of a publisher with AsyncPublishingQueued.
+  size_t async_publish_queue_capacity = 64;
+
+  // How a publisher compresses the payloads of its packets, e.g., for images,
+  // depth maps or debug data that are consumed on other hosts. Subscriptions
+  // decompress packets before passing them to their callbacks, so they need no
+  // config, but all subscribers of the topic must support compression.
+  enum PayloadCompression {
+    NoCompression = 0,
+    // zlib at its fastest level.
+    ZlibCompression = 1,
+  };
+
+  // Only applies to publishers, and not to packets that are sent through
+  // shared memory.
+  PayloadCompression compression = NoCompression;
+
+  // Payloads smaller than this many bytes are sent uncompressed, since
+  // compressing them would cost more time than it saves on the network.
+  // Payloads that do not get smaller, e.g., encoded images, are also sent
+  // uncompressed.
+  size_t compression_threshold = 4096;
 };
 
 // The following two callbacks are defined to be used asynchronously when a
@@ -86,6 +229,29 @@ using SubscriptionOkExpandedCallback =
 using SubscriptionErrorCallback =
     std::function<void(absl::string_view packet, absl::Status error)>;
 
+// Callback of a queryable. Fills in `response`, which is empty, for `request`,
+// or returns an error, which is sent to the querier instead. The messages are
+// taken from pools owned by the queryable and are only valid for the duration
+// of the callback.
+template <typename RequestT, typename ResponseT>
+using QueryableCallback =
+    std::function<absl::Status(const RequestT& request, ResponseT& response)>;
+
+struct QueryOptions {
+  // How long to wait for replies.
+  absl::Duration timeout = absl::Seconds(1);
+
+  // The query completes as soon as this many replies arrived. If 0, the query
+  // collects all replies that arrive within `timeout`, so it always takes
+  // `timeout`.
+  size_t max_replies = 1;
+};
+
+// Topic on which PubSub::PublishAllocationIntrospection() publishes the
+// allocation counters of the process, without the topic prefix.
+inline constexpr absl::string_view kAllocationIntrospectionTopic =
+    "_introspection/allocations";
+
 struct PubSubData;
 
 // This class is thread-safe.
@@ -94,6 +260,10 @@ class PubSub {
   PubSub();
   explicit PubSub(absl::string_view participant_name);
   explicit PubSub(absl::string_view participant_name, absl::string_view config);
+  // Creates a session whose transport is tuned with `profile`. Apart from the
+  // tuning, the session uses the settings of ZenohConfigBuilder(). Use the
+  // constructor above with ZenohConfigBuilder::Build() for custom settings.
+  PubSub(absl::string_view participant_name, ZenohTuning::Profile profile);
 
   PubSub(const PubSub&) = delete;
   PubSub& operator=(const PubSub&) = delete;
@@ -104,6 +274,13 @@ class PubSub {
   absl::StatusOr<Publisher> CreatePublisher(absl::string_view topic,
                                             const TopicConfig& config) const;
 
+  // Creates a group of publishers, one for each of the given topics, whose
+  // messages are published together with PublisherGroup::Publish(). All
+  // publishers use the same config. See publisher_group.h.
+  absl::StatusOr<PublisherGroup> CreatePublisherGroup(
+      absl::Span<const absl::string_view> topics,
+      const TopicConfig& config) const;
+
   // Creates a subscription which invokes the specified callback when a package
   // is received on the topic. This function can only be invoked for proto
   // messages but not for google::protobuf::Message itself.
@@ -141,9 +318,15 @@ class PubSub {
   // Creates a subscription using an exemplar, i.e. a sample proto message.
   //
   // This function requires an exemplar (a sample message) to be passed in
-  // which can hold the payload of a PubSubPacket. The exemplar is used during
-  // each callback to create a new proto message, to extract the payload from
-  // the PubSubPacket and it is then passed to the actual callback function.
+  // which can hold the payload of a PubSubPacket. The exemplar is used to
+  // create the messages into which the payloads of received PubSubPackets are
+  // parsed before they are passed to the actual callback function.
+  //
+  // The payload is parsed directly from the received buffer, without first
+  // parsing the PubSubPacket and its google::protobuf::Any. The messages passed
+  // to `msg_callback` are taken from a pool that is owned by the subscription
+  // and reused across callbacks, so the message is only valid for the duration
+  // of the callback.
   template <typename T>
   absl::StatusOr<Subscription> CreateSubscription(
       absl::string_view topic, const TopicConfig& config, const T& exemplar,
@@ -153,28 +336,104 @@ class PubSub {
                   "Protocol buffers are the only supported serialization "
                   "format for PubSub.");
 
-    // This payload is shared between callbacks and may be read from multiple
-    // threads. We need a shared_ptr here because a std::function must be
-    // copyable.
-    std::shared_ptr<T> shared_payload(exemplar.New());
+    // The pool is shared between callbacks which may run in multiple threads.
+    // We need a shared_ptr here because a std::function must be copyable.
+    auto payload_pool =
+        std::make_shared<internal::ReusableMessagePool<T>>(exemplar);
 
     // The message callback is never copied. It is merely moved to this helper
     // lambda which is itself moved to the subscription class.
-    auto package_to_payload =
+    auto packet_to_payload =
         [callback = std::move(msg_callback),
          error_callback = std::move(error_callback),
-         shared_payload = std::move(shared_payload)](
-            const intrinsic_proto::pubsub::PubSubPacket& packet) {
-          // Create a local copy of the shared payload which we can safely
-          // modify in different threads.
-          std::unique_ptr<T> payload(shared_payload->New());
-          if (!packet.payload().UnpackTo(payload.get())) {
-            HandleError(error_callback, packet, *payload);
+         payload_pool = std::move(payload_pool)](absl::string_view packet) {
+          absl::StatusOr<internal::PubSubPacketView> view =
+              internal::PubSubPacketView::Parse(packet);
+          if (!view.ok()) {
+            LOG_EVERY_N(ERROR, 1) << "Deserializing message failed: "
+                                  << view.status();
+            return;
+          }
+          typename internal::ReusableMessagePool<T>::Lease payload =
+              payload_pool->Acquire();
+          const absl::string_view value = view->payload_value();
+          if (!view->PayloadIs(payload->GetDescriptor()->full_name()) ||
+              !payload->ParseFromArray(value.data(),
+                                       static_cast<int>(value.size()))) {
+            HandleError(error_callback, *view, *payload);
             return;
           }
           callback(*payload);
         };
-    return CreateSubscription(topic, config, std::move(package_to_payload));
+    return CreateSerializedPacketSubscription(topic, config,
+                                              std::move(packet_to_payload));
+  }
+
+  // Creates a subscription for FlatBuffers with the root table T, as published
+  // with Publisher::PublishFlatbuffer(). `root_type` is the fully qualified
+  // name of T in the schema (e.g., "intrinsic_fbs.Point") and must match the
+  // name used by the publisher.
+  //
+  // Received buffers are verified and passed to `msg_callback` in place, i.e.,
+  // without being deserialized or copied, unless the buffer is not suitably
+  // aligned in the received packet. The table is only valid for the duration
+  // of the callback. Packets with other payloads or buffers that fail
+  // verification are reported to `error_callback`.
+  template <typename T>
+  absl::StatusOr<Subscription> CreateFlatbufferSubscription(
+      absl::string_view topic, const TopicConfig& config,
+      absl::string_view root_type, SubscriptionOkCallback<T> msg_callback,
+      SubscriptionErrorCallback error_callback = {}) const {
+    static_assert(std::is_base_of_v<flatbuffers::Table, T>,
+                  "T must be a FlatBuffers table.");
+    auto packet_to_table = [callback = std::move(msg_callback),
+                            error_callback = std::move(error_callback),
+                            root_type = std::string(root_type)](
+                               absl::string_view packet) {
+      absl::StatusOr<internal::PubSubPacketView> view =
+          internal::PubSubPacketView::Parse(packet);
+      if (!view.ok()) {
+        LOG_EVERY_N(ERROR, 1) << "Deserializing message failed: "
+                              << view.status();
+        return;
+      }
+      if (!view->PayloadIsFlatbuffer(root_type)) {
+        HandleError(error_callback, *view,
+                    absl::StrCat("Expected FlatBuffer of type ", root_type,
+                                 " but got ", view->payload_type_url()));
+        return;
+      }
+      const absl::string_view value = view->payload_value();
+      const uint8_t* data = reinterpret_cast<const uint8_t*>(value.data());
+      // The buffer was aligned by the FlatBufferBuilder, but is at an
+      // arbitrary offset in the packet. Misaligned buffers are copied into a
+      // buffer that is reused on this thread, unless a callback of this
+      // subscription further up the stack is still using it.
+      thread_local std::vector<uint64_t> thread_buffer;
+      thread_local bool thread_buffer_in_use = false;
+      std::vector<uint64_t> nested_buffer;
+      bool owns_thread_buffer = false;
+      if (reinterpret_cast<uintptr_t>(data) % alignof(uint64_t) != 0) {
+        owns_thread_buffer = !thread_buffer_in_use;
+        std::vector<uint64_t>& aligned =
+            owns_thread_buffer ? thread_buffer : nested_buffer;
+        aligned.resize((value.size() + sizeof(uint64_t) - 1) /
+                       sizeof(uint64_t));
+        std::memcpy(aligned.data(), value.data(), value.size());
+        data = reinterpret_cast<const uint8_t*>(aligned.data());
+      }
+      flatbuffers::Verifier verifier(data, value.size());
+      if (!verifier.VerifyBuffer<T>(nullptr)) {
+        HandleError(error_callback, *view,
+                    absl::StrCat("Invalid FlatBuffer of type ", root_type));
+        return;
+      }
+      thread_buffer_in_use = thread_buffer_in_use || owns_thread_buffer;
+      callback(*flatbuffers::GetRoot<T>(data));
+      if (owns_thread_buffer) thread_buffer_in_use = false;
+    };
+    return CreateSerializedPacketSubscription(topic, config,
+                                              std::move(packet_to_table));
   }
 
   // Creates a subscription for a raw PubSubPacket. This kind of subscription is
@@ -190,6 +449,132 @@ class PubSub {
       SubscriptionOkExpandedCallback<intrinsic_proto::pubsub::PubSubPacket>
           msg_callback) const;
 
+  // Callback for a serialized PubSubPacket. The packet is only valid for the
+  // duration of the callback.
+  using SerializedPacketCallback =
+      std::function<void(absl::string_view packet)>;
+
+  // Creates a subscription which passes the received packets to `msg_callback`
+  // without deserializing them. Unlike the raw PubSubPacket overloads of
+  // CreateSubscription(), this does not allocate per packet, which makes it
+  // suitable for forwarding and recording traffic. Use
+  // internal::PubSubPacketView to access the fields of a packet in place.
+  absl::StatusOr<Subscription> CreateSerializedPacketSubscription(
+      absl::string_view topic, const TopicConfig& config,
+      SerializedPacketCallback msg_callback) const;
+
+  // Creates a queryable which answers the queries on `key` with `callback`.
+  // Like topics, keys are prefixed for the middleware, so queryables share the
+  // namespaces of topics, including the one of introspection topics.
+  //
+  // Requests are parsed directly from the received buffer into messages that
+  // are reused across callbacks, and replies are serialized into a buffer that
+  // is reused on the calling thread, so answering a query does not allocate
+  // once the pools and buffers have grown to their working size.
+  //
+  // Callbacks run on the threads of the middleware and may run concurrently.
+  // Note: Be careful to not destroy the PubSub instance after creating a
+  // Queryable.
+  template <typename RequestT, typename ResponseT>
+  absl::StatusOr<Queryable> CreateQueryable(
+      absl::string_view key,
+      QueryableCallback<RequestT, ResponseT> callback) const {
+    static_assert(std::is_base_of_v<google::protobuf::Message, RequestT> &&
+                      std::is_base_of_v<google::protobuf::Message, ResponseT>,
+                  "Protocol buffers are the only supported serialization "
+                  "format for PubSub.");
+    auto request_pool =
+        std::make_shared<internal::ReusableMessagePool<RequestT>>(
+            RequestT::default_instance());
+    auto response_pool =
+        std::make_shared<internal::ReusableMessagePool<ResponseT>>(
+            ResponseT::default_instance());
+    auto handler =
+        [callback = std::move(callback), request_pool = std::move(request_pool),
+         response_pool = std::move(response_pool)](
+            absl::string_view request_packet,
+            absl::FunctionRef<absl::Status(
+                const google::protobuf::Message& response)>
+                reply) -> absl::Status {
+      absl::StatusOr<internal::PubSubPacketView> view =
+          internal::PubSubPacketView::Parse(request_packet);
+      if (!view.ok()) {
+        return view.status();
+      }
+      typename internal::ReusableMessagePool<RequestT>::Lease request =
+          request_pool->Acquire();
+      if (absl::Status status = ParsePayload(*view, *request); !status.ok()) {
+        return status;
+      }
+      typename internal::ReusableMessagePool<ResponseT>::Lease response =
+          response_pool->Acquire();
+      if (absl::Status status = callback(*request, *response); !status.ok()) {
+        return status;
+      }
+      return reply(*response);
+    };
+    return CreateSerializedQueryable(key, std::move(handler));
+  }
+
+  // Sends `request` to the queryables on `key`, which may contain wildcards,
+  // and returns the replies that arrived before `options.timeout`, in the
+  // order in which they arrived.
+  //
+  // Returns DeadlineExceededError if no reply arrived, and the first error
+  // otherwise if no reply was successful, e.g., if the queryables returned
+  // errors or replied with another message type.
+  template <typename ResponseT>
+  absl::StatusOr<std::vector<ResponseT>> Query(
+      absl::string_view key, const google::protobuf::Message& request,
+      const QueryOptions& options = {}) const {
+    static_assert(std::is_base_of_v<google::protobuf::Message, ResponseT>,
+                  "Protocol buffers are the only supported serialization "
+                  "format for PubSub.");
+    std::vector<ResponseT> responses;
+    absl::Status first_error;
+    absl::Status status = QuerySerialized(
+        key, request, options,
+        [&](const absl::StatusOr<internal::PubSubPacketView>& reply) {
+          absl::Status reply_status = reply.status();
+          if (reply_status.ok()) {
+            reply_status = ParsePayload(*reply, responses.emplace_back());
+            if (!reply_status.ok()) responses.pop_back();
+          }
+          if (first_error.ok()) first_error = reply_status;
+        });
+    if (!status.ok()) {
+      return status;
+    }
+    if (responses.empty()) {
+      return first_error;
+    }
+    return responses;
+  }
+
+  // Sends `request` to the queryables on `key` and parses the first reply
+  // into `response`, which may be reused across queries to avoid allocating.
+  //
+  // Returns DeadlineExceededError if no reply arrived within `timeout`, and
+  // the error of the reply if it is not a message of the type of `response`.
+  absl::Status QueryOne(absl::string_view key,
+                        const google::protobuf::Message& request,
+                        google::protobuf::Message& response,
+                        absl::Duration timeout = absl::Seconds(1)) const;
+
+  // Publishes the latencies of all subscriptions of this process that were
+  // created with TopicConfig::record_latency as JSON on the introspection
+  // topic "_introspection/pubsub_latency". Meant to be called periodically,
+  // e.g., once per second, by a process that wants its latencies to be
+  // collected together with the other introspection data.
+  absl::Status PublishLatencyIntrospection() const;
+
+  // Publishes the allocation counters of this process per AllocationTag as
+  // JSON on the introspection topic kAllocationIntrospectionTopic, see
+  // AllocationStatsToJson(). The counters are only non-zero in binaries that
+  // link //intrinsic/util:allocation_tracking_hooks. Meant to be called
+  // periodically, like PublishLatencyIntrospection().
+  absl::Status PublishAllocationIntrospection() const;
+
   // Test if a key expression is "canonical", meaning that it has a valid
   // combination of wildcards, no illegal characters, no trailing slash, etc.
   bool KeyexprIsCanon(absl::string_view keyexpr) const;
@@ -207,6 +592,42 @@ class PubSub {
                                        absl::string_view right) const;
 
  private:
+  // Handles a query with the serialized request packet. Calls `reply` with the
+  // response, or returns an error, which is sent to the querier instead.
+  using SerializedQueryHandler = std::function<absl::Status(
+      absl::string_view request_packet,
+      absl::FunctionRef<absl::Status(const google::protobuf::Message& response)>
+          reply)>;
+
+  absl::StatusOr<Queryable> CreateSerializedQueryable(
+      absl::string_view key, SerializedQueryHandler handler) const;
+
+  // Sends `request` and calls `on_reply` for every reply until `options` say
+  // that the query is complete. An error sent by a queryable, or a reply that
+  // is not a valid packet, is passed to `on_reply` as an error.
+  //
+  // Returns DeadlineExceededError if no reply arrived.
+  absl::Status QuerySerialized(
+      absl::string_view key, const google::protobuf::Message& request,
+      const QueryOptions& options,
+      absl::FunctionRef<
+          void(const absl::StatusOr<internal::PubSubPacketView>& reply)>
+          on_reply) const;
+
+  // Parses the payload of `packet` into `message`. Returns an error if the
+  // payload is not a valid message of the type of `message`.
+  static absl::Status ParsePayload(const internal::PubSubPacketView& packet,
+                                   google::protobuf::Message& message) {
+    const absl::string_view value = packet.payload_value();
+    if (!packet.PayloadIs(message.GetDescriptor()->full_name()) ||
+        !message.ParseFromArray(value.data(), static_cast<int>(value.size()))) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Expected payload of type ", message.GetTypeName(),
+                       " but got ", packet.payload_type_url()));
+    }
+    return absl::OkStatus();
+  }
+
   static void HandleError(const SubscriptionErrorCallback& error_callback,
                           const intrinsic_proto::pubsub::PubSubPacket& packet,
                           const google::protobuf::Message& payload) {
@@ -223,6 +644,32 @@ class PubSub {
                        " but got ", packet.payload().type_url())));
   }
 
+  // Error handling is not on the fast path, so we parse the full packet here to
+  // report it in the same format as for other subscriptions.
+  static void HandleError(const SubscriptionErrorCallback& error_callback,
+                          const internal::PubSubPacketView& packet_view,
+                          const google::protobuf::Message& payload) {
+    intrinsic_proto::pubsub::PubSubPacket packet;
+    const absl::string_view serialized = packet_view.packet();
+    packet.ParseFromArray(serialized.data(),
+                          static_cast<int>(serialized.size()));
+    HandleError(error_callback, packet, payload);
+  }
+
+  static void HandleError(const SubscriptionErrorCallback& error_callback,
+                          const internal::PubSubPacketView& packet_view,
+                          absl::string_view message) {
+    intrinsic_proto::pubsub::PubSubPacket packet;
+    const absl::string_view serialized = packet_view.packet();
+    packet.ParseFromArray(serialized.data(),
+                          static_cast<int>(serialized.size()));
+    if (error_callback == nullptr) {
+      LOG(ERROR) << message;
+      return;
+    }
+    error_callback(packet.DebugString(), absl::InvalidArgumentError(message));
+  }
+
   // We use a shared_ptr here because it allows us to auto generate the
   // destructor even when PubSubData is an incomplete type.
   std::shared_ptr<PubSubData> data_;
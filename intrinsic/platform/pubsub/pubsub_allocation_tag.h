@@ -0,0 +1,16 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_PUBSUB_ALLOCATION_TAG_H_
+#define INTRINSIC_PLATFORM_PUBSUB_PUBSUB_ALLOCATION_TAG_H_
+
+#include "absl/base/attributes.h"
+#include "intrinsic/util/allocation_tracking.h"
+
+namespace intrinsic::internal {
+
+// The tag of the allocations of publishers and subscriptions.
+ABSL_CONST_INIT inline LazyAllocationTag kPubSubAllocationTag("pubsub");
+
+}  // namespace intrinsic::internal
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_PUBSUB_ALLOCATION_TAG_H_
@@ -0,0 +1,292 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+// Benchmarks for the PubSub library.
+//
+// Measures the cost of encoding packets, the publish throughput and the
+// end-to-end latency from Publish() until all subscribers of a topic received
+// the message, for payloads from 64 B to 8 MiB, both QoS settings, several
+// subscribers and all subscription callback types. Publisher and subscribers
+// run in the same process.
+//
+// Besides time, every benchmark reports the number of heap allocations per
+// message (in all threads of the process, i.e., including the middleware) as
+// `allocs_per_msg`, counted by //intrinsic/util:allocation_tracking_hooks. Latency benchmarks additionally report percentiles as
+// `p50_us`, `p90_us`, `p99_us` and `max_us`.
+//
+// Run with:
+//   bazel run -c opt //intrinsic/platform/pubsub:pubsub_benchmark
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "benchmark/benchmark.h"
+#include "google/protobuf/timestamp.pb.h"
+#include "intrinsic/platform/common/proto/test.pb.h"
+#include "intrinsic/platform/pubsub/adapters/pubsub.pb.h"
+#include "intrinsic/platform/pubsub/publisher.h"
+#include "intrinsic/platform/pubsub/pubsub.h"
+#include "intrinsic/platform/pubsub/pubsub_packet_encoder.h"
+#include "intrinsic/platform/pubsub/subscription.h"
+#include "intrinsic/util/allocation_tracking.h"
+
+namespace intrinsic {
+namespace {
+
+using ::intrinsic::proto::PingPongMessage;
+
+constexpr int64_t kMinPayloadSize = 64;
+constexpr int64_t kMaxPayloadSize = 8 << 20;
+// Upper bound for the time a message may take to reach all subscribers before
+// a latency benchmark is aborted, e.g., because a Sensor QoS message was lost.
+constexpr absl::Duration kReceiveTimeout = absl::Seconds(5);
+constexpr absl::string_view kAllocationTagName = "pubsub_benchmark";
+
+enum class SubscriptionType {
+  kTyped = 0,
+  kPubSubPacket = 1,
+  kExpandedPubSubPacket = 2,
+};
+
+// Shared by all benchmarks, since the middleware supports only one session
+// per process.
+PubSub& GetPubSub() {
+  static PubSub* pubsub = new PubSub();
+  return *pubsub;
+}
+
+// Returns a topic that is not used by any other benchmark run.
+std::string UniqueTopic() {
+  static std::atomic<int> next_topic = 0;
+  return absl::StrCat("/benchmark/pubsub/", next_topic.fetch_add(1));
+}
+
+TopicConfig MakeConfig(int64_t qos) {
+  TopicConfig config;
+  config.topic_qos = static_cast<TopicConfig::TopicQoS>(qos);
+  return config;
+}
+
+PingPongMessage MakeMessage(int64_t payload_size) {
+  PingPongMessage message;
+  message.set_payload(std::string(payload_size, 'x'));
+  return message;
+}
+
+// Returns the number of heap allocations of the process so far.
+int64_t GetAllocationCount() {
+  // Attributes the allocations of reading the counters to a tag of their own,
+  // which is left out, so that they do not count towards the benchmark.
+  static const AllocationTag tag = AllocationTag::Get(kAllocationTagName);
+  ScopedAllocationTag scoped_tag(tag);
+  int64_t count = 0;
+  for (const AllocationStats& stats : GetAllocationStats()) {
+    if (stats.tag != kAllocationTagName) {
+      count += stats.allocations;
+    }
+  }
+  return count;
+}
+
+void SetAllocationsPerMessage(benchmark::State& state,
+                              int64_t allocations_before) {
+  state.counters["allocs_per_msg"] = benchmark::Counter(
+      static_cast<double>(GetAllocationCount() - allocations_before),
+      benchmark::Counter::kAvgIterations);
+}
+
+// Counts messages received by all subscribers of a topic.
+class ReceiveCounter {
+ public:
+  void Increment() {
+    absl::MutexLock lock(&mutex_);
+    ++count_;
+    last_receive_time_ = absl::Now();
+  }
+
+  // Waits until `count` messages were received in total and returns the time
+  // at which the last one was received.
+  absl::StatusOr<absl::Time> WaitFor(int64_t count) {
+    absl::MutexLock lock(&mutex_);
+    auto received = [this, count]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+      return count_ >= count;
+    };
+    if (!mutex_.AwaitWithTimeout(absl::Condition(&received),
+                                 kReceiveTimeout)) {
+      return absl::DeadlineExceededError(
+          absl::StrCat("Received ", count_, " of ", count, " messages"));
+    }
+    return last_receive_time_;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  int64_t count_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::Time last_receive_time_ ABSL_GUARDED_BY(mutex_);
+};
+
+absl::StatusOr<Subscription> Subscribe(SubscriptionType type,
+                                       absl::string_view topic,
+                                       const TopicConfig& config,
+                                       ReceiveCounter& counter) {
+  switch (type) {
+    case SubscriptionType::kTyped:
+      return GetPubSub().CreateSubscription<PingPongMessage>(
+          topic, config,
+          [&counter](const PingPongMessage&) { counter.Increment(); });
+    case SubscriptionType::kPubSubPacket:
+      return GetPubSub().CreateSubscription(
+          topic, config,
+          SubscriptionOkCallback<intrinsic_proto::pubsub::PubSubPacket>(
+              [&counter](const intrinsic_proto::pubsub::PubSubPacket&) {
+                counter.Increment();
+              }));
+    case SubscriptionType::kExpandedPubSubPacket:
+      return GetPubSub().CreateSubscription(
+          topic, config,
+          SubscriptionOkExpandedCallback<intrinsic_proto::pubsub::PubSubPacket>(
+              [&counter](absl::string_view,
+                         const intrinsic_proto::pubsub::PubSubPacket&) {
+                counter.Increment();
+              }));
+  }
+  return absl::InvalidArgumentError("Unknown subscription type");
+}
+
+// Encoding a PubSubPacket, without the middleware.
+void BM_EncodePacket(benchmark::State& state) {
+  const PingPongMessage message = MakeMessage(state.range(0));
+  google::protobuf::Timestamp publish_time;
+  publish_time.set_seconds(1);
+  std::string buffer;
+
+  const int64_t allocations_before = GetAllocationCount();
+  for (auto _ : state) {
+    buffer.clear();
+    CHECK_OK(internal::AppendPubSubPacket(message, publish_time, &buffer)
+                 .status());
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  SetAllocationsPerMessage(state, allocations_before);
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EncodePacket)
+    ->RangeMultiplier(8)
+    ->Range(kMinPayloadSize, kMaxPayloadSize);
+
+// Back-to-back publishing. Arguments: payload size, QoS, number of typed
+// subscribers. Subscribers are not waited for, so this measures the load
+// that publishing puts on the calling thread.
+void BM_PublishThroughput(benchmark::State& state) {
+  const std::string topic = UniqueTopic();
+  const TopicConfig config = MakeConfig(state.range(1));
+  const PingPongMessage message = MakeMessage(state.range(0));
+  absl::StatusOr<Publisher> publisher =
+      GetPubSub().CreatePublisher(topic, config);
+  CHECK_OK(publisher.status());
+  ReceiveCounter counter;
+  std::vector<Subscription> subscriptions;
+  for (int64_t i = 0; i < state.range(2); ++i) {
+    absl::StatusOr<Subscription> subscription =
+        Subscribe(SubscriptionType::kTyped, topic, config, counter);
+    CHECK_OK(subscription.status());
+    subscriptions.push_back(*std::move(subscription));
+  }
+
+  const int64_t allocations_before = GetAllocationCount();
+  for (auto _ : state) {
+    if (absl::Status status = publisher->Publish(message); !status.ok()) {
+      state.SkipWithError(status.ToString().c_str());
+      break;
+    }
+  }
+  SetAllocationsPerMessage(state, allocations_before);
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PublishThroughput)
+    ->ArgNames({"bytes", "qos", "subscribers"})
+    ->ArgsProduct({benchmark::CreateRange(kMinPayloadSize, kMaxPayloadSize,
+                                          /*multi=*/8),
+                   {TopicConfig::Sensor, TopicConfig::HighReliability},
+                   {0, 1, 4}});
+
+// Time from Publish() until all subscribers received the message. Arguments:
+// payload size, QoS, number of subscribers, SubscriptionType.
+void BM_EndToEndLatency(benchmark::State& state) {
+  const std::string topic = UniqueTopic();
+  const TopicConfig config = MakeConfig(state.range(1));
+  const int64_t num_subscribers = state.range(2);
+  const auto type = static_cast<SubscriptionType>(state.range(3));
+  PingPongMessage message = MakeMessage(state.range(0));
+  absl::StatusOr<Publisher> publisher =
+      GetPubSub().CreatePublisher(topic, config);
+  CHECK_OK(publisher.status());
+  ReceiveCounter counter;
+  std::vector<Subscription> subscriptions;
+  for (int64_t i = 0; i < num_subscribers; ++i) {
+    absl::StatusOr<Subscription> subscription =
+        Subscribe(type, topic, config, counter);
+    CHECK_OK(subscription.status());
+    subscriptions.push_back(*std::move(subscription));
+  }
+
+  // Reserved up front, so that the timed loop does not allocate for it.
+  std::vector<double> latencies_us;
+  latencies_us.reserve(state.max_iterations);
+  int64_t expected = 0;
+  const int64_t allocations_before = GetAllocationCount();
+  for (auto _ : state) {
+    message.set_iteration_id(expected);
+    expected += num_subscribers;
+    const absl::Time start = absl::Now();
+    if (absl::Status status = publisher->Publish(message); !status.ok()) {
+      state.SkipWithError(status.ToString().c_str());
+      break;
+    }
+    absl::StatusOr<absl::Time> received = counter.WaitFor(expected);
+    if (!received.ok()) {
+      state.SkipWithError(received.status().ToString().c_str());
+      break;
+    }
+    latencies_us.push_back(absl::ToDoubleMicroseconds(*received - start));
+  }
+  SetAllocationsPerMessage(state, allocations_before);
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+
+  if (latencies_us.empty()) return;
+  std::sort(latencies_us.begin(), latencies_us.end());
+  auto percentile = [&latencies_us](double p) {
+    return latencies_us[static_cast<size_t>(p * (latencies_us.size() - 1))];
+  };
+  state.counters["p50_us"] = percentile(0.5);
+  state.counters["p90_us"] = percentile(0.9);
+  state.counters["p99_us"] = percentile(0.99);
+  state.counters["max_us"] = latencies_us.back();
+}
+BENCHMARK(BM_EndToEndLatency)
+    ->ArgNames({"bytes", "qos", "subscribers", "type"})
+    ->ArgsProduct(
+        {benchmark::CreateRange(kMinPayloadSize, kMaxPayloadSize, /*multi=*/8),
+         {TopicConfig::Sensor, TopicConfig::HighReliability},
+         {1, 4},
+         {static_cast<int64_t>(SubscriptionType::kTyped),
+          static_cast<int64_t>(SubscriptionType::kPubSubPacket),
+          static_cast<int64_t>(SubscriptionType::kExpandedPubSubPacket)}})
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace intrinsic
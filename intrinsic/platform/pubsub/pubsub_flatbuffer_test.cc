@@ -0,0 +1,127 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "flatbuffers/flatbuffers.h"
+#include "intrinsic/icon/flatbuffers/transform_types_generated.h"
+#include "intrinsic/platform/pubsub/publisher.h"
+#include "intrinsic/platform/pubsub/pubsub.h"
+#include "intrinsic/platform/pubsub/subscription.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic {
+namespace {
+
+using ::intrinsic::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+constexpr absl::Duration kTimeout = absl::Seconds(10);
+constexpr absl::string_view kRootType = "intrinsic_fbs.VectorNd";
+
+// Shared by all tests, since the middleware supports only one session per
+// process.
+PubSub& GetPubSub() {
+  static PubSub* pubsub = new PubSub();
+  return *pubsub;
+}
+
+// Returns a topic that is not used by any other test.
+std::string UniqueTopic() {
+  static std::atomic<int> next_topic = 0;
+  return absl::StrCat("/test/pubsub_flatbuffer/", next_topic.fetch_add(1));
+}
+
+flatbuffers::DetachedBuffer MakeVectorNd(const std::vector<double>& data) {
+  flatbuffers::FlatBufferBuilder builder;
+  builder.Finish(intrinsic_fbs::CreateVectorNdDirect(builder, &data));
+  return builder.Release();
+}
+
+// Publishes `flatbuffer` until `received` is notified, since a subscription
+// may miss messages published before the middleware matched it with the
+// publisher.
+void PublishUntilNotified(const Publisher& publisher,
+                          absl::string_view root_type,
+                          const flatbuffers::DetachedBuffer& flatbuffer,
+                          absl::Notification& received) {
+  const absl::Time deadline = absl::Now() + kTimeout;
+  while (absl::Now() < deadline) {
+    ASSERT_OK(publisher.PublishFlatbuffer(
+        root_type,
+        absl::Span<const uint8_t>(flatbuffer.data(), flatbuffer.size())));
+    if (received.WaitForNotificationWithTimeout(absl::Milliseconds(10))) {
+      return;
+    }
+  }
+  FAIL() << "Nothing received within " << kTimeout;
+}
+
+TEST(PubSubFlatbufferTest, ReceivesPublishedFlatbuffer) {
+  const std::string topic = UniqueTopic();
+  absl::Mutex mutex;
+  std::vector<double> received_data;
+  absl::Notification received;
+  ASSERT_OK_AND_ASSIGN(
+      Subscription subscription,
+      GetPubSub().CreateFlatbufferSubscription<intrinsic_fbs::VectorNd>(
+          topic, TopicConfig(), kRootType,
+          [&](const intrinsic_fbs::VectorNd& vector) {
+            absl::MutexLock lock(&mutex);
+            if (received.HasBeenNotified()) return;
+            received_data.assign(vector.data()->begin(), vector.data()->end());
+            received.Notify();
+          }));
+  ASSERT_OK_AND_ASSIGN(Publisher publisher,
+                       GetPubSub().CreatePublisher(topic, TopicConfig()));
+
+  PublishUntilNotified(publisher, kRootType, MakeVectorNd({1.5, -2.0, 3.25}),
+                       received);
+  absl::MutexLock lock(&mutex);
+  EXPECT_THAT(received_data, ElementsAre(1.5, -2.0, 3.25));
+}
+
+TEST(PubSubFlatbufferTest, ReportsOtherRootType) {
+  const std::string topic = UniqueTopic();
+  std::atomic<int> num_tables = 0;
+  absl::Mutex mutex;
+  absl::Status error;
+  absl::Notification received;
+  ASSERT_OK_AND_ASSIGN(
+      Subscription subscription,
+      GetPubSub().CreateFlatbufferSubscription<intrinsic_fbs::VectorNd>(
+          topic, TopicConfig(), kRootType,
+          [&num_tables](const intrinsic_fbs::VectorNd&) { ++num_tables; },
+          [&](absl::string_view, absl::Status status) {
+            absl::MutexLock lock(&mutex);
+            if (received.HasBeenNotified()) return;
+            error = status;
+            received.Notify();
+          }));
+  ASSERT_OK_AND_ASSIGN(Publisher publisher,
+                       GetPubSub().CreatePublisher(topic, TopicConfig()));
+
+  PublishUntilNotified(publisher, "intrinsic_fbs.OtherTable",
+                       MakeVectorNd({1.0}), received);
+  EXPECT_EQ(num_tables, 0);
+  absl::MutexLock lock(&mutex);
+  EXPECT_THAT(error, StatusIs(absl::StatusCode::kInvalidArgument,
+                              HasSubstr(std::string(kRootType))));
+}
+
+}  // namespace
+}  // namespace intrinsic
@@ -0,0 +1,185 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/pubsub_packet_encoder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/timestamp.pb.h"
+
+namespace intrinsic::internal {
+
+namespace {
+
+using ::google::protobuf::io::CodedOutputStream;
+
+// Same prefix as used by google::protobuf::Any::PackFrom().
+constexpr absl::string_view kTypeUrlPrefix = "type.googleapis.com/";
+
+constexpr uint32_t kWireTypeVarint = 0;
+constexpr uint32_t kWireTypeLengthDelimited = 2;
+
+constexpr uint32_t MakeTag(uint32_t field_number, uint32_t wire_type) {
+  return (field_number << 3) | wire_type;
+}
+
+// Field tags of intrinsic_proto::pubsub::PubSubPacket.
+constexpr uint32_t kPacketPayloadTag = MakeTag(1, kWireTypeLengthDelimited);
+constexpr uint32_t kPacketPublishTimeTag = MakeTag(2, kWireTypeLengthDelimited);
+// Field tags of google::protobuf::Any.
+constexpr uint32_t kAnyTypeUrlTag = MakeTag(1, kWireTypeLengthDelimited);
+constexpr uint32_t kAnyValueTag = MakeTag(2, kWireTypeLengthDelimited);
+// Field tags of google::protobuf::Timestamp.
+constexpr uint32_t kTimestampSecondsTag = MakeTag(1, kWireTypeVarint);
+constexpr uint32_t kTimestampNanosTag = MakeTag(2, kWireTypeVarint);
+
+// Size of a length-delimited field with the given tag and payload size.
+size_t LengthDelimitedSize(uint32_t tag, size_t payload_size) {
+  return CodedOutputStream::VarintSize32(tag) +
+         CodedOutputStream::VarintSize64(payload_size) + payload_size;
+}
+
+uint8_t* WriteLengthDelimitedHeader(uint32_t tag, size_t payload_size,
+                                    uint8_t* target) {
+  target = CodedOutputStream::WriteVarint32ToArray(tag, target);
+  return CodedOutputStream::WriteVarint64ToArray(payload_size, target);
+}
+
+uint8_t* WriteRaw(absl::string_view data, uint8_t* target) {
+  return CodedOutputStream::WriteRawToArray(data.data(), data.size(), target);
+}
+
+// Writes the payload value of `value_size` bytes to `target` and returns the
+// position after it.
+using WriteValueFn = absl::FunctionRef<uint8_t*(uint8_t* target)>;
+
+absl::StatusOr<size_t> EncodePacket(
+    absl::string_view type_url_prefix, absl::string_view type_name,
+    size_t value_size, WriteValueFn write_value,
+    const google::protobuf::Timestamp& publish_time,
+    absl::FunctionRef<char*(size_t size)> allocate) {
+  const size_t type_url_size = type_url_prefix.size() + type_name.size();
+
+  // Proto3 semantics: fields with default values are not serialized. This
+  // matches the output of PubSubPacket::SerializeAsString().
+  const int64_t seconds = publish_time.seconds();
+  const int32_t nanos = publish_time.nanos();
+  size_t timestamp_size = 0;
+  if (seconds != 0) {
+    timestamp_size += CodedOutputStream::VarintSize32(kTimestampSecondsTag) +
+                      CodedOutputStream::VarintSize64(seconds);
+  }
+  if (nanos != 0) {
+    timestamp_size += CodedOutputStream::VarintSize32(kTimestampNanosTag) +
+                      CodedOutputStream::VarintSize32SignExtended(nanos);
+  }
+
+  size_t any_size = LengthDelimitedSize(kAnyTypeUrlTag, type_url_size);
+  if (value_size != 0) {
+    any_size += LengthDelimitedSize(kAnyValueTag, value_size);
+  }
+  const size_t packet_size =
+      LengthDelimitedSize(kPacketPayloadTag, any_size) +
+      LengthDelimitedSize(kPacketPublishTimeTag, timestamp_size);
+  if (packet_size > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Serialized PubSubPacket for message of type ", type_name,
+                     " exceeds 2GiB (", packet_size, " bytes)"));
+  }
+
+  char* packet = allocate(packet_size);
+  if (packet == nullptr) {
+    return absl::ResourceExhaustedError(absl::StrCat(
+        "No space for PubSubPacket of ", packet_size, " bytes"));
+  }
+  uint8_t* target = reinterpret_cast<uint8_t*>(packet);
+
+  // PubSubPacket.payload (google.protobuf.Any)
+  target = WriteLengthDelimitedHeader(kPacketPayloadTag, any_size, target);
+  target = WriteLengthDelimitedHeader(kAnyTypeUrlTag, type_url_size, target);
+  target = WriteRaw(type_url_prefix, target);
+  target = WriteRaw(type_name, target);
+  if (value_size != 0) {
+    target = WriteLengthDelimitedHeader(kAnyValueTag, value_size, target);
+    target = write_value(target);
+  }
+
+  // PubSubPacket.publish_time (google.protobuf.Timestamp)
+  target =
+      WriteLengthDelimitedHeader(kPacketPublishTimeTag, timestamp_size, target);
+  if (seconds != 0) {
+    target = CodedOutputStream::WriteVarint32ToArray(kTimestampSecondsTag,
+                                                     target);
+    target = CodedOutputStream::WriteVarint64ToArray(seconds, target);
+  }
+  if (nanos != 0) {
+    target =
+        CodedOutputStream::WriteVarint32ToArray(kTimestampNanosTag, target);
+    target =
+        CodedOutputStream::WriteVarint32SignExtendedToArray(nanos, target);
+  }
+
+  return packet_size;
+}
+
+// Allocates at the end of `buffer`.
+char* AppendTo(std::string* buffer, size_t size) {
+  const size_t offset = buffer->size();
+  buffer->resize(offset + size);
+  return buffer->data() + offset;
+}
+
+}  // namespace
+
+absl::StatusOr<size_t> AppendPubSubPacket(
+    const google::protobuf::Message& message,
+    const google::protobuf::Timestamp& publish_time, std::string* buffer) {
+  return EncodePubSubPacket(message, publish_time, [buffer](size_t size) {
+    return AppendTo(buffer, size);
+  });
+}
+
+absl::StatusOr<size_t> EncodePubSubPacket(
+    const google::protobuf::Message& message,
+    const google::protobuf::Timestamp& publish_time,
+    absl::FunctionRef<char*(size_t size)> allocate) {
+  // Caches the sizes of all submessages so that the serialization below does
+  // not need to walk the message tree again.
+  const size_t value_size = message.ByteSizeLong();
+  return EncodePacket(
+      kTypeUrlPrefix, message.GetDescriptor()->full_name(), value_size,
+      [&message](uint8_t* target) {
+        return message.SerializeWithCachedSizesToArray(target);
+      },
+      publish_time, allocate);
+}
+
+absl::StatusOr<size_t> AppendFlatbufferPubSubPacket(
+    absl::string_view root_type, absl::string_view flatbuffer,
+    const google::protobuf::Timestamp& publish_time, std::string* buffer) {
+  return EncodeFlatbufferPubSubPacket(
+      root_type, flatbuffer, publish_time,
+      [buffer](size_t size) { return AppendTo(buffer, size); });
+}
+
+absl::StatusOr<size_t> EncodeFlatbufferPubSubPacket(
+    absl::string_view root_type, absl::string_view flatbuffer,
+    const google::protobuf::Timestamp& publish_time,
+    absl::FunctionRef<char*(size_t size)> allocate) {
+  return EncodePacket(
+      kFlatbufferTypeUrlPrefix, root_type, flatbuffer.size(),
+      [flatbuffer](uint8_t* target) { return WriteRaw(flatbuffer, target); },
+      publish_time, allocate);
+}
+
+}  // namespace intrinsic::internal
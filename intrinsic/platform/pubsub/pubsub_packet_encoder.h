@@ -0,0 +1,66 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_PUBSUB_PACKET_ENCODER_H_
+#define INTRINSIC_PLATFORM_PUBSUB_PUBSUB_PACKET_ENCODER_H_
+
+#include <cstddef>
+#include <string>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/timestamp.pb.h"
+
+namespace intrinsic::internal {
+
+// Type URL prefix of the `payload` Any of PubSubPackets that carry a
+// FlatBuffer. The prefix is followed by the fully qualified name of the root
+// table of the FlatBuffer (e.g., "type.intrinsic.ai/flatbuffers/foo.Bar") and
+// the `value` of the Any holds the finished FlatBuffer as is.
+inline constexpr absl::string_view kFlatbufferTypeUrlPrefix =
+    "type.intrinsic.ai/flatbuffers/";
+
+// Appends the wire encoding of an intrinsic_proto::pubsub::PubSubPacket to
+// `buffer`. The packet holds `message` packed into its `payload` Any and
+// `publish_time` as its publish time.
+//
+// The result is byte-identical to filling a PubSubPacket with
+// `payload().PackFrom(message)` and calling SerializeAsString() on it, but
+// `message` is serialized only once, directly into `buffer`, and no temporary
+// messages or strings are created. If `buffer` is reused across calls (e.g.
+// cleared, but not shrunk), this does not allocate once its capacity is large
+// enough for the largest packet.
+//
+// Returns the number of bytes appended to `buffer`, or an error if the packet
+// would exceed the maximum size of a serialized protobuf message.
+absl::StatusOr<size_t> AppendPubSubPacket(
+    const google::protobuf::Message& message,
+    const google::protobuf::Timestamp& publish_time, std::string* buffer);
+
+// Like AppendPubSubPacket(), but writes the packet to memory provided by
+// `allocate`. `allocate` is called exactly once with the size of the packet
+// and must return a pointer to at least that many writable bytes, or nullptr
+// to abort encoding, in which case a ResourceExhausted error is returned.
+absl::StatusOr<size_t> EncodePubSubPacket(
+    const google::protobuf::Message& message,
+    const google::protobuf::Timestamp& publish_time,
+    absl::FunctionRef<char*(size_t size)> allocate);
+
+// Like AppendPubSubPacket(), but the packet carries the finished FlatBuffer
+// `flatbuffer` with the root table `root_type` (a fully qualified FlatBuffers
+// type name, e.g., "intrinsic_fbs.Point"). See kFlatbufferTypeUrlPrefix.
+absl::StatusOr<size_t> AppendFlatbufferPubSubPacket(
+    absl::string_view root_type, absl::string_view flatbuffer,
+    const google::protobuf::Timestamp& publish_time, std::string* buffer);
+
+// Like EncodePubSubPacket(), but for a FlatBuffer payload. See
+// AppendFlatbufferPubSubPacket().
+absl::StatusOr<size_t> EncodeFlatbufferPubSubPacket(
+    absl::string_view root_type, absl::string_view flatbuffer,
+    const google::protobuf::Timestamp& publish_time,
+    absl::FunctionRef<char*(size_t size)> allocate);
+
+}  // namespace intrinsic::internal
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_PUBSUB_PACKET_ENCODER_H_
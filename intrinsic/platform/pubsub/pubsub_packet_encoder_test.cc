@@ -0,0 +1,127 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/pubsub_packet_encoder.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "google/protobuf/duration.pb.h"
+#include "google/protobuf/empty.pb.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/timestamp.pb.h"
+#include "intrinsic/platform/pubsub/adapters/pubsub.pb.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::internal {
+namespace {
+
+using ::intrinsic::testing::IsOk;
+using ::intrinsic::testing::IsOkAndHolds;
+
+google::protobuf::Timestamp MakeTimestamp(int64_t seconds, int32_t nanos) {
+  google::protobuf::Timestamp timestamp;
+  timestamp.set_seconds(seconds);
+  timestamp.set_nanos(nanos);
+  return timestamp;
+}
+
+std::string SerializeWithPackFrom(
+    const google::protobuf::Message& message,
+    const google::protobuf::Timestamp& publish_time) {
+  intrinsic_proto::pubsub::PubSubPacket packet;
+  packet.mutable_payload()->PackFrom(message);
+  *packet.mutable_publish_time() = publish_time;
+  return packet.SerializeAsString();
+}
+
+TEST(PubSubPacketEncoderTest, MatchesPackFromSerialization) {
+  google::protobuf::Duration message;
+  message.set_seconds(1234);
+  message.set_nanos(-5);
+
+  for (const auto& publish_time :
+       {MakeTimestamp(0, 0), MakeTimestamp(1700000000, 0),
+        MakeTimestamp(0, 999999999), MakeTimestamp(-62135596800, 1),
+        MakeTimestamp(1700000000, 123456789)}) {
+    const std::string expected = SerializeWithPackFrom(message, publish_time);
+    std::string buffer;
+    EXPECT_THAT(AppendPubSubPacket(message, publish_time, &buffer),
+                IsOkAndHolds(expected.size()));
+    EXPECT_EQ(buffer, expected);
+  }
+}
+
+TEST(PubSubPacketEncoderTest, EncodesEmptyPayload) {
+  const google::protobuf::Empty message;
+  const google::protobuf::Timestamp publish_time = MakeTimestamp(42, 7);
+
+  const std::string expected = SerializeWithPackFrom(message, publish_time);
+  std::string buffer;
+  ASSERT_THAT(AppendPubSubPacket(message, publish_time, &buffer),
+              IsOkAndHolds(expected.size()));
+  EXPECT_EQ(buffer, expected);
+
+  intrinsic_proto::pubsub::PubSubPacket packet;
+  ASSERT_TRUE(packet.ParseFromString(buffer));
+  EXPECT_TRUE(packet.payload().Is<google::protobuf::Empty>());
+  EXPECT_EQ(packet.publish_time().seconds(), 42);
+  EXPECT_EQ(packet.publish_time().nanos(), 7);
+}
+
+TEST(PubSubPacketEncoderTest, AppendsToExistingBuffer) {
+  google::protobuf::Duration first;
+  first.set_seconds(1);
+  google::protobuf::Duration second;
+  second.set_nanos(2);
+  const google::protobuf::Timestamp publish_time = MakeTimestamp(10, 20);
+
+  std::string buffer = "prefix";
+  ASSERT_THAT(AppendPubSubPacket(first, publish_time, &buffer),
+              IsOkAndHolds(SerializeWithPackFrom(first, publish_time).size()));
+  ASSERT_THAT(AppendPubSubPacket(second, publish_time, &buffer),
+              IsOkAndHolds(SerializeWithPackFrom(second, publish_time).size()));
+  EXPECT_EQ(buffer, "prefix" + SerializeWithPackFrom(first, publish_time) +
+                        SerializeWithPackFrom(second, publish_time));
+}
+
+TEST(PubSubPacketEncoderTest, RoundTripsPayload) {
+  google::protobuf::Timestamp message = MakeTimestamp(99, 100);
+  std::string buffer;
+  ASSERT_THAT(AppendPubSubPacket(message, MakeTimestamp(1, 2), &buffer),
+              IsOk());
+
+  intrinsic_proto::pubsub::PubSubPacket packet;
+  ASSERT_TRUE(packet.ParseFromString(buffer));
+  google::protobuf::Timestamp unpacked;
+  ASSERT_TRUE(packet.payload().UnpackTo(&unpacked));
+  EXPECT_EQ(unpacked.seconds(), 99);
+  EXPECT_EQ(unpacked.nanos(), 100);
+}
+
+TEST(PubSubPacketEncoderTest, EncodesFlatbufferPayload) {
+  const std::string flatbuffer("\x08\x00\x00\x00\x00\x00\x04\x00", 8);
+  const google::protobuf::Timestamp publish_time = MakeTimestamp(3, 4);
+
+  std::string buffer;
+  absl::StatusOr<size_t> size = AppendFlatbufferPubSubPacket(
+      "intrinsic_fbs.Point", flatbuffer, publish_time, &buffer);
+  ASSERT_THAT(size, IsOkAndHolds(buffer.size()));
+
+  intrinsic_proto::pubsub::PubSubPacket packet;
+  ASSERT_TRUE(packet.ParseFromString(buffer));
+  EXPECT_EQ(packet.payload().type_url(),
+            "type.intrinsic.ai/flatbuffers/intrinsic_fbs.Point");
+  EXPECT_EQ(packet.payload().value(), flatbuffer);
+  EXPECT_EQ(packet.publish_time().seconds(), 3);
+  EXPECT_EQ(packet.publish_time().nanos(), 4);
+
+  // Re-serializing the parsed packet yields the same bytes.
+  EXPECT_EQ(packet.SerializeAsString(), buffer);
+}
+
+}  // namespace
+}  // namespace intrinsic::internal
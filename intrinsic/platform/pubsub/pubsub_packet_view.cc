@@ -0,0 +1,210 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/pubsub_packet_view.h"
+
+#include <cstdint>
+#include <limits>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "intrinsic/platform/pubsub/pubsub_packet_encoder.h"
+
+namespace intrinsic::internal {
+
+namespace {
+
+using ::google::protobuf::io::CodedInputStream;
+
+constexpr uint32_t kWireTypeVarint = 0;
+constexpr uint32_t kWireTypeFixed64 = 1;
+constexpr uint32_t kWireTypeLengthDelimited = 2;
+constexpr uint32_t kWireTypeFixed32 = 5;
+
+// Field numbers of intrinsic_proto::pubsub::PubSubPacket.
+constexpr uint32_t kPacketPayloadField = 1;
+constexpr uint32_t kPacketPublishTimeField = 2;
+constexpr uint32_t kPacketTraceIdField = 4;
+constexpr uint32_t kPacketSpanIdField = 5;
+constexpr uint32_t kPacketPayloadCompressionField = 6;
+constexpr uint32_t kPacketUncompressedPayloadSizeField = 7;
+// Field numbers of google::protobuf::Any.
+constexpr uint32_t kAnyTypeUrlField = 1;
+constexpr uint32_t kAnyValueField = 2;
+// Field numbers of google::protobuf::Timestamp.
+constexpr uint32_t kTimestampSecondsField = 1;
+constexpr uint32_t kTimestampNanosField = 2;
+
+absl::Status ParseError() {
+  return absl::InvalidArgumentError("Malformed PubSubPacket");
+}
+
+// A minimal reader for the subset of the protobuf wire format used by the
+// packet envelope. Length-delimited fields are returned as views into the
+// input buffer.
+class WireReader {
+ public:
+  explicit WireReader(absl::string_view data)
+      : data_(data),
+        input_(reinterpret_cast<const uint8_t*>(data.data()),
+               static_cast<int>(data.size())) {}
+
+  bool AtEnd() const {
+    return input_.CurrentPosition() == static_cast<int>(data_.size());
+  }
+
+  // Reads the next tag. Returns 0 on error.
+  uint32_t ReadTag() { return input_.ReadTag(); }
+
+  bool ReadVarint64(uint64_t* value) { return input_.ReadVarint64(value); }
+
+  bool ReadLengthDelimited(absl::string_view* value) {
+    uint32_t length;
+    if (!input_.ReadVarint32(&length)) return false;
+    const int position = input_.CurrentPosition();
+    if (!input_.Skip(static_cast<int>(length))) return false;
+    *value = data_.substr(position, length);
+    return true;
+  }
+
+  // Skips a field of the given wire type. Groups are not supported.
+  bool SkipField(uint32_t wire_type) {
+    switch (wire_type) {
+      case kWireTypeVarint: {
+        uint64_t unused;
+        return input_.ReadVarint64(&unused);
+      }
+      case kWireTypeFixed64: {
+        uint64_t unused;
+        return input_.ReadLittleEndian64(&unused);
+      }
+      case kWireTypeLengthDelimited: {
+        absl::string_view unused;
+        return ReadLengthDelimited(&unused);
+      }
+      case kWireTypeFixed32: {
+        uint32_t unused;
+        return input_.ReadLittleEndian32(&unused);
+      }
+      default:
+        return false;
+    }
+  }
+
+ private:
+  absl::string_view data_;
+  CodedInputStream input_;
+};
+
+absl::Status ParseAny(absl::string_view data, absl::string_view* type_url,
+                      absl::string_view* value) {
+  WireReader reader(data);
+  while (!reader.AtEnd()) {
+    const uint32_t tag = reader.ReadTag();
+    if (tag == 0) return ParseError();
+    const uint32_t field = tag >> 3;
+    const uint32_t wire_type = tag & 0x7;
+    bool ok;
+    if (field == kAnyTypeUrlField && wire_type == kWireTypeLengthDelimited) {
+      ok = reader.ReadLengthDelimited(type_url);
+    } else if (field == kAnyValueField &&
+               wire_type == kWireTypeLengthDelimited) {
+      ok = reader.ReadLengthDelimited(value);
+    } else {
+      ok = reader.SkipField(wire_type);
+    }
+    if (!ok) return ParseError();
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ParseTimestamp(absl::string_view data, int64_t* seconds,
+                            int32_t* nanos) {
+  WireReader reader(data);
+  while (!reader.AtEnd()) {
+    const uint32_t tag = reader.ReadTag();
+    if (tag == 0) return ParseError();
+    const uint32_t field = tag >> 3;
+    const uint32_t wire_type = tag & 0x7;
+    bool ok;
+    uint64_t value;
+    if (field == kTimestampSecondsField && wire_type == kWireTypeVarint) {
+      ok = reader.ReadVarint64(&value);
+      *seconds = static_cast<int64_t>(value);
+    } else if (field == kTimestampNanosField && wire_type == kWireTypeVarint) {
+      ok = reader.ReadVarint64(&value);
+      *nanos = static_cast<int32_t>(value);
+    } else {
+      ok = reader.SkipField(wire_type);
+    }
+    if (!ok) return ParseError();
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<PubSubPacketView> PubSubPacketView::Parse(
+    absl::string_view packet) {
+  if (packet.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    return ParseError();
+  }
+  PubSubPacketView view;
+  view.packet_ = packet;
+  WireReader reader(packet);
+  while (!reader.AtEnd()) {
+    const uint32_t tag = reader.ReadTag();
+    if (tag == 0) return ParseError();
+    const uint32_t field = tag >> 3;
+    const uint32_t wire_type = tag & 0x7;
+    absl::string_view submessage;
+    bool ok;
+    if (field == kPacketPayloadField && wire_type == kWireTypeLengthDelimited) {
+      ok = reader.ReadLengthDelimited(&submessage) &&
+           ParseAny(submessage, &view.payload_type_url_, &view.payload_value_)
+               .ok();
+    } else if (field == kPacketPublishTimeField &&
+               wire_type == kWireTypeLengthDelimited) {
+      ok = reader.ReadLengthDelimited(&submessage) &&
+           ParseTimestamp(submessage, &view.publish_time_seconds_,
+                          &view.publish_time_nanos_)
+               .ok();
+    } else if (field == kPacketTraceIdField && wire_type == kWireTypeVarint) {
+      ok = reader.ReadVarint64(&view.trace_id_);
+    } else if (field == kPacketSpanIdField && wire_type == kWireTypeVarint) {
+      ok = reader.ReadVarint64(&view.span_id_);
+    } else if (field == kPacketPayloadCompressionField &&
+               wire_type == kWireTypeVarint) {
+      uint64_t value;
+      ok = reader.ReadVarint64(&value);
+      view.payload_compression_ = static_cast<int>(value);
+    } else if (field == kPacketUncompressedPayloadSizeField &&
+               wire_type == kWireTypeVarint) {
+      ok = reader.ReadVarint64(&view.uncompressed_payload_size_);
+    } else {
+      ok = reader.SkipField(wire_type);
+    }
+    if (!ok) return ParseError();
+  }
+  return view;
+}
+
+bool PubSubPacketView::PayloadIs(absl::string_view full_name) const {
+  // Same check as google::protobuf::Any::Is(): the type URL must end in
+  // "/<full_name>".
+  return payload_type_url_.size() > full_name.size() &&
+         absl::EndsWith(payload_type_url_, full_name) &&
+         payload_type_url_[payload_type_url_.size() - full_name.size() - 1] ==
+             '/';
+}
+
+bool PubSubPacketView::PayloadIsFlatbuffer(absl::string_view root_type) const {
+  return payload_type_url_.size() ==
+             kFlatbufferTypeUrlPrefix.size() + root_type.size() &&
+         absl::StartsWith(payload_type_url_, kFlatbufferTypeUrlPrefix) &&
+         absl::EndsWith(payload_type_url_, root_type);
+}
+
+}  // namespace intrinsic::internal
@@ -0,0 +1,85 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_PUBSUB_PACKET_VIEW_H_
+#define INTRINSIC_PLATFORM_PUBSUB_PUBSUB_PACKET_VIEW_H_
+
+#include <cstdint>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+
+namespace intrinsic::internal {
+
+// A read-only view of a serialized intrinsic_proto::pubsub::PubSubPacket.
+//
+// Parsing a view only decodes the packet envelope. The type URL and the
+// serialized payload message are exposed as string_views into the original
+// buffer, so that the payload can be parsed directly into its target message
+// without first being copied into a google::protobuf::Any.
+//
+// The view does not own any data and must not outlive the buffer it was parsed
+// from.
+class PubSubPacketView {
+ public:
+  // Parses the envelope of the serialized PubSubPacket in `packet`. Returns an
+  // error if `packet` is not a valid serialized PubSubPacket.
+  static absl::StatusOr<PubSubPacketView> Parse(absl::string_view packet);
+
+  // The serialized packet this view was parsed from.
+  absl::string_view packet() const { return packet_; }
+
+  // The type URL of the payload, i.e., `payload.type_url`.
+  absl::string_view payload_type_url() const { return payload_type_url_; }
+
+  // The serialized payload message, i.e., `payload.value`.
+  absl::string_view payload_value() const { return payload_value_; }
+
+  // Returns true if the payload is a message of the given fully qualified type
+  // name. Follows the same rules as google::protobuf::Any::Is().
+  bool PayloadIs(absl::string_view full_name) const;
+
+  // Returns true if the payload is a FlatBuffer with the given fully qualified
+  // root table name, i.e., if the packet was encoded with
+  // AppendFlatbufferPubSubPacket(). In that case, payload_value() is the
+  // FlatBuffer.
+  bool PayloadIsFlatbuffer(absl::string_view root_type) const;
+
+  // The fields of `publish_time`.
+  int64_t publish_time_seconds() const { return publish_time_seconds_; }
+  int32_t publish_time_nanos() const { return publish_time_nanos_; }
+
+  // The publish time, or absl::UnixEpoch() if the packet has none.
+  absl::Time publish_time() const {
+    return absl::FromUnixSeconds(publish_time_seconds_) +
+           absl::Nanoseconds(publish_time_nanos_);
+  }
+
+  uint64_t trace_id() const { return trace_id_; }
+  uint64_t span_id() const { return span_id_; }
+
+  // The value of `payload_compression`, see
+  // intrinsic_proto::pubsub::PubSubPacket::PayloadCompression. If it is not 0,
+  // payload_value() is compressed.
+  int payload_compression() const { return payload_compression_; }
+  uint64_t uncompressed_payload_size() const {
+    return uncompressed_payload_size_;
+  }
+
+ private:
+  PubSubPacketView() = default;
+
+  absl::string_view packet_;
+  absl::string_view payload_type_url_;
+  absl::string_view payload_value_;
+  int64_t publish_time_seconds_ = 0;
+  int32_t publish_time_nanos_ = 0;
+  uint64_t trace_id_ = 0;
+  uint64_t span_id_ = 0;
+  int payload_compression_ = 0;
+  uint64_t uncompressed_payload_size_ = 0;
+};
+
+}  // namespace intrinsic::internal
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_PUBSUB_PACKET_VIEW_H_
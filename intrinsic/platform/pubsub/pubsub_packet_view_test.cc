@@ -0,0 +1,126 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/pubsub_packet_view.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "absl/time/time.h"
+#include "google/protobuf/duration.pb.h"
+#include "google/protobuf/timestamp.pb.h"
+#include "intrinsic/platform/pubsub/adapters/pubsub.pb.h"
+#include "intrinsic/platform/pubsub/pubsub_packet_encoder.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::internal {
+namespace {
+
+using ::intrinsic::testing::IsOk;
+
+TEST(PubSubPacketViewTest, ExposesEnvelopeAndPayload) {
+  google::protobuf::Duration message;
+  message.set_seconds(12);
+  message.set_nanos(34);
+
+  intrinsic_proto::pubsub::PubSubPacket packet;
+  packet.mutable_payload()->PackFrom(message);
+  packet.mutable_publish_time()->set_seconds(1700000000);
+  packet.mutable_publish_time()->set_nanos(5);
+  packet.set_trace_id(77);
+  packet.set_span_id(88);
+  const std::string serialized = packet.SerializeAsString();
+
+  absl::StatusOr<PubSubPacketView> view = PubSubPacketView::Parse(serialized);
+  ASSERT_THAT(view.status(), IsOk());
+  EXPECT_EQ(view->packet(), serialized);
+  EXPECT_EQ(view->payload_type_url(), packet.payload().type_url());
+  EXPECT_EQ(view->payload_value(), packet.payload().value());
+  EXPECT_TRUE(view->PayloadIs("google.protobuf.Duration"));
+  EXPECT_FALSE(view->PayloadIs("protobuf.Duration"));
+  EXPECT_FALSE(view->PayloadIs("google.protobuf.Timestamp"));
+  EXPECT_EQ(view->publish_time_seconds(), 1700000000);
+  EXPECT_EQ(view->publish_time_nanos(), 5);
+  EXPECT_EQ(view->publish_time(),
+            absl::FromUnixSeconds(1700000000) + absl::Nanoseconds(5));
+  EXPECT_EQ(view->trace_id(), 77);
+  EXPECT_EQ(view->span_id(), 88);
+
+  google::protobuf::Duration parsed;
+  ASSERT_TRUE(parsed.ParseFromArray(view->payload_value().data(),
+                                    view->payload_value().size()));
+  EXPECT_EQ(parsed.seconds(), 12);
+  EXPECT_EQ(parsed.nanos(), 34);
+}
+
+TEST(PubSubPacketViewTest, ParsesEncoderOutput) {
+  google::protobuf::Duration message;
+  message.set_seconds(-3);
+  google::protobuf::Timestamp publish_time;
+  publish_time.set_seconds(-62135596800);
+  publish_time.set_nanos(999999999);
+
+  std::string buffer;
+  ASSERT_THAT(AppendPubSubPacket(message, publish_time, &buffer).status(),
+              IsOk());
+  absl::StatusOr<PubSubPacketView> view = PubSubPacketView::Parse(buffer);
+  ASSERT_THAT(view.status(), IsOk());
+  EXPECT_TRUE(view->PayloadIs("google.protobuf.Duration"));
+  EXPECT_EQ(view->payload_value(), message.SerializeAsString());
+  EXPECT_EQ(view->publish_time_seconds(), -62135596800);
+  EXPECT_EQ(view->publish_time_nanos(), 999999999);
+}
+
+TEST(PubSubPacketViewTest, DetectsFlatbufferPayload) {
+  const std::string flatbuffer("\x0c\x00\x00\x00fbs-data", 12);
+  std::string buffer;
+  ASSERT_THAT(AppendFlatbufferPubSubPacket("intrinsic_fbs.Point", flatbuffer,
+                                           google::protobuf::Timestamp(),
+                                           &buffer)
+                  .status(),
+              IsOk());
+  absl::StatusOr<PubSubPacketView> view = PubSubPacketView::Parse(buffer);
+  ASSERT_THAT(view.status(), IsOk());
+  EXPECT_TRUE(view->PayloadIsFlatbuffer("intrinsic_fbs.Point"));
+  EXPECT_FALSE(view->PayloadIsFlatbuffer("fbs.Point"));
+  EXPECT_FALSE(view->PayloadIsFlatbuffer("intrinsic_fbs.Point2"));
+  EXPECT_EQ(view->payload_value(), flatbuffer);
+
+  google::protobuf::Duration message;
+  buffer.clear();
+  ASSERT_THAT(AppendPubSubPacket(message, google::protobuf::Timestamp(),
+                                 &buffer)
+                  .status(),
+              IsOk());
+  view = PubSubPacketView::Parse(buffer);
+  ASSERT_THAT(view.status(), IsOk());
+  EXPECT_FALSE(view->PayloadIsFlatbuffer("google.protobuf.Duration"));
+}
+
+TEST(PubSubPacketViewTest, ParsesEmptyPacket) {
+  absl::StatusOr<PubSubPacketView> view = PubSubPacketView::Parse("");
+  ASSERT_THAT(view.status(), IsOk());
+  EXPECT_TRUE(view->payload_type_url().empty());
+  EXPECT_TRUE(view->payload_value().empty());
+  EXPECT_FALSE(view->PayloadIs("google.protobuf.Duration"));
+  EXPECT_EQ(view->publish_time(), absl::UnixEpoch());
+}
+
+TEST(PubSubPacketViewTest, RejectsMalformedPacket) {
+  google::protobuf::Duration message;
+  message.set_seconds(12);
+  intrinsic_proto::pubsub::PubSubPacket packet;
+  packet.mutable_payload()->PackFrom(message);
+  const std::string serialized = packet.SerializeAsString();
+
+  // Truncating the packet cuts off the length-delimited payload.
+  EXPECT_FALSE(
+      PubSubPacketView::Parse(
+          absl::string_view(serialized).substr(0, serialized.size() - 1))
+          .ok());
+  EXPECT_FALSE(PubSubPacketView::Parse("\xff\xff\xff").ok());
+}
+
+}  // namespace
+}  // namespace intrinsic::internal
@@ -0,0 +1,116 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/pubsub_recorder.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "intrinsic/platform/pubsub/capture_file.h"
+#include "intrinsic/platform/pubsub/publisher.h"
+#include "intrinsic/platform/pubsub/pubsub.h"
+#include "intrinsic/platform/pubsub/pubsub_packet_view.h"
+#include "intrinsic/platform/pubsub/subscription.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic {
+
+// static
+absl::StatusOr<std::unique_ptr<PubSubRecorder>> PubSubRecorder::Create(
+    const PubSub& pubsub, absl::Span<const std::string> topics,
+    CaptureWriter* writer, const TopicConfig& config) {
+  if (writer == nullptr) {
+    return absl::InvalidArgumentError("The capture writer must not be null");
+  }
+  auto recorder = absl::WrapUnique(new PubSubRecorder(writer));
+  for (const std::string& topic : topics) {
+    INTR_ASSIGN_OR_RETURN(
+        Subscription subscription,
+        pubsub.CreateSerializedPacketSubscription(
+            topic, config,
+            [recorder = recorder.get(), topic](absl::string_view packet) {
+              recorder->Record(topic, packet);
+            }));
+    recorder->subscriptions_.push_back(std::move(subscription));
+  }
+  return recorder;
+}
+
+void PubSubRecorder::Stop() {
+  for (Subscription& subscription : subscriptions_) {
+    subscription.Unsubscribe();
+  }
+}
+
+void PubSubRecorder::Record(absl::string_view topic,
+                            absl::string_view packet) {
+  const absl::Time receive_time = absl::Now();
+  absl::StatusOr<internal::PubSubPacketView> view =
+      internal::PubSubPacketView::Parse(packet);
+  if (!view.ok()) {
+    ++num_dropped_;
+    return;
+  }
+  const absl::Time publish_time =
+      absl::FromUnixSeconds(view->publish_time_seconds()) +
+      absl::Nanoseconds(view->publish_time_nanos());
+  if (!writer_->Append(topic, packet, publish_time, receive_time).ok()) {
+    ++num_dropped_;
+    return;
+  }
+  ++num_recorded_;
+}
+
+absl::Status PubSubPlayer::Play(const CaptureReader& capture,
+                                const Options& options) {
+  if (options.rate < 0) {
+    return absl::InvalidArgumentError("The rate must not be negative");
+  }
+  stop_.store(false);
+  num_published_.store(0);
+  absl::Span<const CaptureRecord> records = capture.records();
+  if (records.empty()) {
+    return absl::OkStatus();
+  }
+
+  // Publishers are created on first use, so that their creation does not
+  // delay the start of the replay for topics that appear late.
+  absl::flat_hash_map<absl::string_view, Publisher> publishers;
+  const absl::Time start = absl::Now();
+  const absl::Time first_receive_time = records.front().receive_time;
+  for (const CaptureRecord& record : records) {
+    if (stop_.load()) {
+      return absl::CancelledError("Replay stopped");
+    }
+    auto it = publishers.find(record.topic);
+    if (it == publishers.end()) {
+      INTR_ASSIGN_OR_RETURN(Publisher publisher,
+                            pubsub_.CreatePublisher(record.topic,
+                                                    options.config));
+      it = publishers.emplace(record.topic, std::move(publisher)).first;
+    }
+    if (options.rate > 0) {
+      const absl::Time due =
+          start + (record.receive_time - first_receive_time) / options.rate;
+      if (absl::Now() < due - options.spin_threshold) {
+        absl::SleepFor(due - options.spin_threshold - absl::Now());
+      }
+      while (absl::Now() < due) {
+      }
+    }
+    INTR_RETURN_IF_ERROR(it->second.PublishSerializedPacket(record.packet));
+    ++num_published_;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,115 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_PUBSUB_RECORDER_H_
+#define INTRINSIC_PLATFORM_PUBSUB_PUBSUB_RECORDER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "intrinsic/platform/pubsub/capture_file.h"
+#include "intrinsic/platform/pubsub/pubsub.h"
+#include "intrinsic/platform/pubsub/subscription.h"
+
+namespace intrinsic {
+
+// Records the traffic on a set of topics into a capture.
+//
+// Packets are appended to the capture as received, without deserializing
+// them, and without allocating, so that recording keeps up with high rates.
+// Packets that cannot be appended, e.g., because the capture is full, are
+// dropped and counted.
+//
+// Example:
+//
+//   INTR_ASSIGN_OR_RETURN(
+//       std::unique_ptr<CaptureWriter> writer,
+//       CaptureWriter::Create({.directory = "/tmp/capture"}));
+//   INTR_ASSIGN_OR_RETURN(
+//       std::unique_ptr<PubSubRecorder> recorder,
+//       PubSubRecorder::Create(pubsub, {"robot/state", "camera/image"},
+//                              writer.get()));
+class PubSubRecorder {
+ public:
+  // Starts recording `topics` into `writer`, which must outlive the recorder.
+  static absl::StatusOr<std::unique_ptr<PubSubRecorder>> Create(
+      const PubSub& pubsub, absl::Span<const std::string> topics,
+      CaptureWriter* writer, const TopicConfig& config = TopicConfig());
+
+  PubSubRecorder(const PubSubRecorder&) = delete;
+  PubSubRecorder& operator=(const PubSubRecorder&) = delete;
+
+  // Stops recording. Does not close the writer.
+  void Stop();
+
+  // Number of packets recorded.
+  uint64_t num_recorded() const { return num_recorded_.load(); }
+  // Number of packets that were received but could not be recorded.
+  uint64_t num_dropped() const { return num_dropped_.load(); }
+
+ private:
+  explicit PubSubRecorder(CaptureWriter* writer) : writer_(writer) {}
+
+  void Record(absl::string_view topic, absl::string_view packet);
+
+  CaptureWriter* const writer_;
+  std::atomic<uint64_t> num_recorded_ = 0;
+  std::atomic<uint64_t> num_dropped_ = 0;
+  // Last, so that the subscriptions are destroyed first.
+  std::vector<Subscription> subscriptions_;
+};
+
+// Republishes the records of a capture with their original timing.
+class PubSubPlayer {
+ public:
+  struct Options {
+    // Speed of the replay relative to the recording. Zero replays as fast as
+    // possible.
+    double rate = 1.0;
+    // The player sleeps until this long before a record is due and then spins,
+    // since sleeping alone overshoots by up to a scheduler time slice.
+    absl::Duration spin_threshold = absl::Microseconds(200);
+    // Config of the publishers.
+    TopicConfig config;
+  };
+
+  explicit PubSubPlayer(const PubSub& pubsub) : pubsub_(pubsub) {}
+
+  PubSubPlayer(const PubSubPlayer&) = delete;
+  PubSubPlayer& operator=(const PubSubPlayer&) = delete;
+
+  // Republishes all records of `capture` in the order in which they were
+  // recorded, spaced like their receive times divided by Options::rate. Every
+  // packet keeps its original publish time. Blocks until all records are
+  // published or Stop() is called.
+  //
+  // Returns InvalidArgumentError if the options are invalid, CancelledError if
+  // stopped, and the first error of creating a publisher or publishing.
+  absl::Status Play(const CaptureReader& capture, const Options& options);
+
+  absl::Status Play(const CaptureReader& capture) {
+    return Play(capture, Options());
+  }
+
+  // Makes a running Play() return. Thread safe.
+  void Stop() { stop_.store(true); }
+
+  // Number of records published by the last call to Play().
+  uint64_t num_published() const { return num_published_.load(); }
+
+ private:
+  const PubSub& pubsub_;
+  std::atomic<bool> stop_ = false;
+  std::atomic<uint64_t> num_published_ = 0;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_PUBSUB_RECORDER_H_
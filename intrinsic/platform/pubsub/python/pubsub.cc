@@ -7,6 +7,8 @@
 #include <pybind11/pytypes.h>
 #include <pybind11/stl.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string_view>
@@ -16,9 +18,14 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "google/protobuf/message.h"
+#include "intrinsic/platform/pubsub/message_batcher.h"
 #include "intrinsic/platform/pubsub/publisher.h"
 #include "intrinsic/platform/pubsub/subscription.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "pybind11_abseil/absl_casters.h"
 #include "pybind11_abseil/no_throw_status.h"
 #include "pybind11_abseil/status_casters.h"
 #include "pybind11_protobuf/native_proto_caster.h"
@@ -97,6 +104,91 @@ struct PySubscriptionDeleter {
   }
 };
 
+// A subscription whose messages are handed to Python in batches, so that the
+// GIL is acquired once per batch rather than once per message.
+class BatchedSubscription {
+ public:
+  BatchedSubscription(std::unique_ptr<internal::MessageBatcher> batcher,
+                      Subscription subscription)
+      : batcher_(std::move(batcher)), subscription_(std::move(subscription)) {}
+
+  absl::string_view TopicName() const { return subscription_.TopicName(); }
+
+  // Messages dropped by the subscription or because the batch callback did not
+  // keep up.
+  uint64_t NumDroppedMessages() const {
+    return subscription_.NumDroppedMessages() + batcher_->num_dropped();
+  }
+
+  // Stops all callbacks. Must be called with the GIL released, since the
+  // delivery thread may be waiting for it.
+  void Stop() {
+    subscription_.Unsubscribe();
+    batcher_->Stop();
+  }
+
+ private:
+  std::unique_ptr<internal::MessageBatcher> batcher_;
+  Subscription subscription_;
+};
+
+absl::StatusOr<BatchedSubscription> CreateBatchedSubscription(
+    PubSub* self, absl::string_view topic, const TopicConfig& config,
+    const google::protobuf::Message& exemplar, pybind11::object batch_callback,
+    size_t max_batch_size, absl::Duration max_latency,
+    pybind11::object err_callback) {
+  INTR_ASSIGN_OR_RETURN(
+      std::unique_ptr<internal::MessageBatcher> batcher,
+      internal::MessageBatcher::Create(
+          exemplar,
+          {.max_batch_size = max_batch_size, .max_latency = max_latency},
+          [py_batch_cb = std::move(batch_callback)](
+              absl::Span<const std::unique_ptr<google::protobuf::Message>>
+                  batch) {
+            pybind11::gil_scoped_acquire gil;
+            pybind11::list messages(batch.size());
+            for (size_t i = 0; i < batch.size(); ++i) {
+              // This will create a copy in the py proto caster
+              messages[i] = pybind11::cast(*batch[i]);
+            }
+            py_batch_cb(messages);
+          }));
+
+  SubscriptionErrorCallback error_callback = {};
+  if (err_callback && !err_callback.is_none()) {
+    error_callback = [py_err_cb = std::move(err_callback)](
+                         absl::string_view packet, absl::Status error) {
+      pybind11::gil_scoped_acquire gil;
+      py_err_cb(packet, pybind11::google::DoNotThrowStatus(error));
+    };
+  }
+
+  // Copying a message into the batch does not need the GIL.
+  SubscriptionOkCallback<google::protobuf::Message> message_callback =
+      [batcher = batcher.get()](const google::protobuf::Message& msg) {
+        batcher->Add(msg);
+      };
+  INTR_ASSIGN_OR_RETURN(
+      Subscription subscription,
+      self->CreateSubscription(topic, config, exemplar,
+                               std::move(message_callback),
+                               std::move(error_callback)));
+  return BatchedSubscription(std::move(batcher), std::move(subscription));
+}
+
+struct PyBatchedSubscriptionDeleter {
+  void operator()(BatchedSubscription* s) {
+    // See PySubscriptionDeleter. In addition, the delivery thread of the
+    // batcher may be waiting for the GIL, so it must be joined with the GIL
+    // released as well.
+    {
+      pybind11::gil_scoped_release release_gil;
+      s->Stop();
+    }
+    delete s;
+  }
+};
+
 }  // namespace
 
 PYBIND11_MODULE(pubsub, m) {
@@ -128,6 +220,14 @@ PYBIND11_MODULE(pubsub, m) {
            pybind11::arg("error_callback") = nullptr)
       .def("CreateSubscription", &CreateSubscription, pybind11::arg("topic"),
            pybind11::arg("exemplar"), pybind11::arg("msg_callback") = nullptr,
+           pybind11::arg("error_callback") = nullptr)
+      // Calls `batch_callback` with a list of up to `max_batch_size` messages,
+      // at the latest `max_latency` after the oldest message was received.
+      .def("CreateBatchedSubscription", &CreateBatchedSubscription,
+           pybind11::arg("topic"), pybind11::arg("config"),
+           pybind11::arg("exemplar"), pybind11::arg("batch_callback"),
+           pybind11::arg("max_batch_size") = 64,
+           pybind11::arg("max_latency") = absl::Milliseconds(10),
            pybind11::arg("error_callback") = nullptr);
 
   pybind11::class_<Publisher>(m, "Publisher")
@@ -145,6 +245,13 @@ PYBIND11_MODULE(pubsub, m) {
                    std::unique_ptr<Subscription, PySubscriptionDeleter>>(
       m, "Subscription")
       .def("TopicName", &Subscription::TopicName);
+
+  pybind11::class_<BatchedSubscription,
+                   std::unique_ptr<BatchedSubscription,
+                                   PyBatchedSubscriptionDeleter>>(
+      m, "BatchedSubscription")
+      .def("TopicName", &BatchedSubscription::TopicName)
+      .def("NumDroppedMessages", &BatchedSubscription::NumDroppedMessages);
 }
 
 }  // namespace pubsub
@@ -2,6 +2,7 @@
 
 """Tests for intrinsic.platform.pubsub.python.pubsub."""
 
+import datetime
 import threading
 
 from absl.testing import absltest
@@ -139,6 +140,36 @@ class PubsubTest(parameterized.TestCase):
     with condition:
       condition.wait_for(lambda: call_type != CallbackType.NONE, 1)
 
+  def test_batched_subscription(self):
+    config = pubsub.TopicConfig()
+    publisher = self.pubsub.CreatePublisher('batched_news', config)
+
+    condition = threading.Condition()
+    received = []
+
+    def batch_callback(messages):
+      with condition:
+        received.extend(messages)
+        condition.notify()
+
+    subscription = self.pubsub.CreateBatchedSubscription(  # pylint:disable=unused-variable
+        'batched_news',
+        config,
+        test_pb2.TestMessageString(),
+        batch_callback,
+        max_batch_size=2,
+        max_latency=datetime.timedelta(milliseconds=10),
+    )
+    values = [test_pb2.TestMessageString(data=str(i)) for i in range(3)]
+    for value in values:
+      publisher.Publish(value)
+
+    with condition:
+      condition.wait_for(lambda: len(received) >= len(values), 1)
+    self.assertLen(received, len(values))
+    for message, value in zip(received, values):
+      compare.assertProto2Equal(self, message, value)
+
 
 if __name__ == '__main__':
   absltest.main()
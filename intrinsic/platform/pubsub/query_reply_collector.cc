@@ -0,0 +1,83 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/query_reply_collector.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/base/const_init.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace intrinsic::internal {
+namespace {
+
+// Guards the registry. Held while a reply is handled, so that a collector
+// cannot be destroyed while it handles a reply.
+ABSL_CONST_INIT absl::Mutex registry_mutex(absl::kConstInit);
+
+uint64_t next_id ABSL_GUARDED_BY(registry_mutex) = 1;
+
+absl::flat_hash_map<uint64_t, QueryReplyCollector*>& Registry()
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(registry_mutex) {
+  static auto* registry =
+      new absl::flat_hash_map<uint64_t, QueryReplyCollector*>;
+  return *registry;
+}
+
+uint64_t Register(QueryReplyCollector* collector) {
+  absl::MutexLock lock(&registry_mutex);
+  const uint64_t id = next_id++;
+  Registry().emplace(id, collector);
+  return id;
+}
+
+}  // namespace
+
+QueryReplyCollector::QueryReplyCollector(size_t max_replies,
+                                         ReplyHandler on_reply)
+    : id_(Register(this)), max_replies_(max_replies), on_reply_(on_reply) {}
+
+QueryReplyCollector::~QueryReplyCollector() {
+  absl::MutexLock lock(&registry_mutex);
+  Registry().erase(id_);
+}
+
+void* QueryReplyCollector::context() const {
+  return reinterpret_cast<void*>(static_cast<uintptr_t>(id_));
+}
+
+void QueryReplyCollector::OnReply(const char* keyexpr, const void* bytes,
+                                  size_t bytes_len, void* context) {
+  const uint64_t id = reinterpret_cast<uintptr_t>(context);
+  absl::MutexLock lock(&registry_mutex);
+  auto it = Registry().find(id);
+  if (it == Registry().end()) {
+    return;
+  }
+  it->second->HandleReply(
+      absl::string_view(static_cast<const char*>(bytes), bytes_len));
+}
+
+size_t QueryReplyCollector::WaitUntil(absl::Time deadline) {
+  absl::MutexLock lock(&mutex_);
+  auto done = [this]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+    return max_replies_ != 0 && num_replies_ >= max_replies_;
+  };
+  mutex_.AwaitWithDeadline(absl::Condition(&done), deadline);
+  return num_replies_;
+}
+
+void QueryReplyCollector::HandleReply(absl::string_view packet) {
+  absl::MutexLock lock(&mutex_);
+  if (max_replies_ != 0 && num_replies_ >= max_replies_) {
+    return;
+  }
+  on_reply_(packet);
+  ++num_replies_;
+}
+
+}  // namespace intrinsic::internal
@@ -0,0 +1,64 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_QUERY_REPLY_COLLECTOR_H_
+#define INTRINSIC_PLATFORM_PUBSUB_QUERY_REPLY_COLLECTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace intrinsic::internal {
+
+// Collects the replies to one query that is sent through the middleware.
+//
+// The middleware calls OnReply() for every reply, possibly after the querying
+// thread stopped waiting for replies. The collector therefore does not hand
+// itself to the middleware, but an id under which it is registered while it
+// exists. Replies for unknown ids, i.e., replies that arrive after the
+// collector was destroyed, are dropped.
+//
+// This class is thread-safe.
+class QueryReplyCollector {
+ public:
+  // Called with every reply packet, under a lock, until the collector is
+  // destroyed. The packet is only valid for the duration of the call.
+  using ReplyHandler = absl::FunctionRef<void(absl::string_view packet)>;
+
+  // Collects at most `max_replies` replies, or all replies if `max_replies`
+  // is 0. `on_reply` must outlive the collector.
+  QueryReplyCollector(size_t max_replies, ReplyHandler on_reply);
+  ~QueryReplyCollector();
+
+  QueryReplyCollector(const QueryReplyCollector&) = delete;
+  QueryReplyCollector& operator=(const QueryReplyCollector&) = delete;
+
+  // The user context to pass to the middleware together with OnReply().
+  void* context() const;
+
+  // Matches imw_query_callback_fn.
+  static void OnReply(const char* keyexpr, const void* bytes, size_t bytes_len,
+                      void* context);
+
+  // Waits until `max_replies` replies arrived or until `deadline`. Returns the
+  // number of replies passed to the handler.
+  size_t WaitUntil(absl::Time deadline);
+
+ private:
+  void HandleReply(absl::string_view packet);
+
+  const uint64_t id_;
+  const size_t max_replies_;
+  const ReplyHandler on_reply_;
+
+  absl::Mutex mutex_;
+  size_t num_replies_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace intrinsic::internal
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_QUERY_REPLY_COLLECTOR_H_
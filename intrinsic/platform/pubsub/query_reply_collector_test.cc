@@ -0,0 +1,110 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/query_reply_collector.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::internal {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+constexpr absl::Duration kTimeout = absl::Seconds(10);
+
+void Reply(void* context, absl::string_view packet) {
+  QueryReplyCollector::OnReply("key", packet.data(), packet.size(), context);
+}
+
+TEST(QueryReplyCollectorTest, ReturnsOnceMaxRepliesArrived) {
+  std::vector<std::string> replies;
+  QueryReplyCollector collector(
+      2, [&](absl::string_view packet) { replies.emplace_back(packet); });
+
+  std::thread replier([context = collector.context()]() {
+    Reply(context, "a");
+    Reply(context, "b");
+  });
+  const absl::Time start = absl::Now();
+  EXPECT_EQ(collector.WaitUntil(absl::Now() + kTimeout), 2);
+  EXPECT_LT(absl::Now() - start, kTimeout);
+  replier.join();
+
+  EXPECT_THAT(replies, ElementsAre("a", "b"));
+}
+
+TEST(QueryReplyCollectorTest, DropsRepliesBeyondMaxReplies) {
+  std::vector<std::string> replies;
+  QueryReplyCollector collector(
+      1, [&](absl::string_view packet) { replies.emplace_back(packet); });
+
+  Reply(collector.context(), "a");
+  Reply(collector.context(), "b");
+
+  EXPECT_EQ(collector.WaitUntil(absl::Now()), 1);
+  EXPECT_THAT(replies, ElementsAre("a"));
+}
+
+TEST(QueryReplyCollectorTest, CollectsAllRepliesUntilDeadline) {
+  std::vector<std::string> replies;
+  QueryReplyCollector collector(
+      0, [&](absl::string_view packet) { replies.emplace_back(packet); });
+
+  Reply(collector.context(), "a");
+  Reply(collector.context(), "b");
+  Reply(collector.context(), "c");
+
+  EXPECT_EQ(collector.WaitUntil(absl::Now() + absl::Milliseconds(10)), 3);
+  EXPECT_THAT(replies, ElementsAre("a", "b", "c"));
+}
+
+TEST(QueryReplyCollectorTest, ReturnsZeroAtDeadlineWithoutReplies) {
+  QueryReplyCollector collector(1, [](absl::string_view packet) {});
+
+  EXPECT_EQ(collector.WaitUntil(absl::Now() + absl::Milliseconds(10)), 0);
+}
+
+TEST(QueryReplyCollectorTest, DropsRepliesAfterDestruction) {
+  std::vector<std::string> replies;
+  void* context;
+  {
+    QueryReplyCollector collector(
+        1, [&](absl::string_view packet) { replies.emplace_back(packet); });
+    context = collector.context();
+  }
+
+  Reply(context, "late");
+
+  EXPECT_THAT(replies, IsEmpty());
+}
+
+TEST(QueryReplyCollectorTest, KeepsRepliesOfConcurrentQueriesApart) {
+  std::vector<std::string> first_replies;
+  std::vector<std::string> second_replies;
+  QueryReplyCollector first(1, [&](absl::string_view packet) {
+    first_replies.emplace_back(packet);
+  });
+  QueryReplyCollector second(1, [&](absl::string_view packet) {
+    second_replies.emplace_back(packet);
+  });
+
+  Reply(second.context(), "2");
+  Reply(first.context(), "1");
+
+  EXPECT_NE(first.context(), second.context());
+  EXPECT_THAT(first_replies, ElementsAre("1"));
+  EXPECT_THAT(second_replies, ElementsAre("2"));
+}
+
+}  // namespace
+}  // namespace intrinsic::internal
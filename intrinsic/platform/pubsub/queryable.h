@@ -0,0 +1,41 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_QUERYABLE_H_
+#define INTRINSIC_PLATFORM_PUBSUB_QUERYABLE_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+namespace intrinsic {
+
+struct QueryableData;
+
+// Answers the queries on a key, see PubSub::CreateQueryable(). Stops answering
+// when destroyed.
+class Queryable {
+ public:
+  Queryable();
+  Queryable(absl::string_view key, std::unique_ptr<QueryableData> data);
+
+  ~Queryable();
+
+  Queryable(const Queryable&) = delete;
+  Queryable& operator=(const Queryable&) = delete;
+  Queryable(Queryable&&);
+  Queryable& operator=(Queryable&&);
+
+  absl::string_view Key() const { return key_; }
+
+  // Stops answering queries.
+  void Close();
+
+ private:
+  std::string key_;
+  std::unique_ptr<QueryableData> data_;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_QUERYABLE_H_
@@ -0,0 +1,85 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_REUSABLE_MESSAGE_POOL_H_
+#define INTRINSIC_PLATFORM_PUBSUB_REUSABLE_MESSAGE_POOL_H_
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "google/protobuf/message.h"
+
+namespace intrinsic::internal {
+
+// A pool of protobuf messages of the same type which are reused for parsing
+// incoming packets.
+//
+// Subscription callbacks may run concurrently on several zenoh threads, so a
+// subscription cannot use a single message for all callbacks. Instead, every
+// callback leases a message from the pool and returns it when done. The pool
+// grows to the maximum number of concurrently running callbacks and does not
+// allocate after that. Returned messages are cleared, which keeps the memory
+// of their repeated and string fields for the next parse.
+//
+// This class is thread-safe.
+template <typename T>
+class ReusableMessagePool {
+ public:
+  // Exclusive access to a message of the pool. Returns the message to the pool
+  // on destruction.
+  class Lease {
+   public:
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    ~Lease() { pool_.Release(std::move(message_)); }
+
+    T& operator*() const { return *message_; }
+    T* operator->() const { return message_.get(); }
+
+   private:
+    friend class ReusableMessagePool;
+    Lease(ReusableMessagePool& pool, std::unique_ptr<T> message)
+        : pool_(pool), message_(std::move(message)) {}
+
+    ReusableMessagePool& pool_;
+    std::unique_ptr<T> message_;
+  };
+
+  // Messages of the pool are created with `exemplar.New()`, so `exemplar` may
+  // also be a dynamic message.
+  explicit ReusableMessagePool(const T& exemplar)
+      : exemplar_(exemplar.New()) {}
+
+  ReusableMessagePool(const ReusableMessagePool&) = delete;
+  ReusableMessagePool& operator=(const ReusableMessagePool&) = delete;
+
+  // Returns an empty message. The lease must not outlive the pool.
+  Lease Acquire() {
+    {
+      absl::MutexLock lock(&mu_);
+      if (!free_.empty()) {
+        std::unique_ptr<T> message = std::move(free_.back());
+        free_.pop_back();
+        return Lease(*this, std::move(message));
+      }
+    }
+    return Lease(*this, std::unique_ptr<T>(exemplar_->New()));
+  }
+
+ private:
+  void Release(std::unique_ptr<T> message) {
+    message->Clear();
+    absl::MutexLock lock(&mu_);
+    free_.push_back(std::move(message));
+  }
+
+  const std::unique_ptr<T> exemplar_;
+  absl::Mutex mu_;
+  std::vector<std::unique_ptr<T>> free_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace intrinsic::internal
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_REUSABLE_MESSAGE_POOL_H_
@@ -0,0 +1,47 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_SCOPED_THREAD_BUFFER_H_
+#define INTRINSIC_PLATFORM_PUBSUB_SCOPED_THREAD_BUFFER_H_
+
+#include <string>
+
+namespace intrinsic::internal {
+
+// Provides an empty buffer for encoding or decoding a packet. The buffer is
+// reused by all ScopedThreadBuffers with the same `Tag` on this thread, so
+// that encoding does not allocate once the buffer has grown to the size of the
+// largest packet. The middleware may deliver a packet to local subscribers on
+// the publishing thread, so a subscription callback that publishes again gets
+// a separate buffer.
+template <typename Tag>
+class ScopedThreadBuffer {
+ public:
+  ScopedThreadBuffer() : owns_thread_buffer_(!thread_buffer_in_use_) {
+    if (owns_thread_buffer_) {
+      thread_buffer_in_use_ = true;
+      thread_buffer_.clear();
+    }
+  }
+
+  ~ScopedThreadBuffer() {
+    if (owns_thread_buffer_) thread_buffer_in_use_ = false;
+  }
+
+  ScopedThreadBuffer(const ScopedThreadBuffer&) = delete;
+  ScopedThreadBuffer& operator=(const ScopedThreadBuffer&) = delete;
+
+  std::string* get() {
+    return owns_thread_buffer_ ? &thread_buffer_ : &nested_buffer_;
+  }
+
+ private:
+  static thread_local inline std::string thread_buffer_;
+  static thread_local inline bool thread_buffer_in_use_ = false;
+
+  const bool owns_thread_buffer_;
+  std::string nested_buffer_;
+};
+
+}  // namespace intrinsic::internal
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_SCOPED_THREAD_BUFFER_H_
@@ -0,0 +1,346 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/shared_memory_ring.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/base/optimization.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/random/random.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace intrinsic::internal {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x52534d49;  // "IMSR"
+constexpr uint32_t kVersion = 1;
+
+// Serialized descriptors start with 0xff. A serialized PubSubPacket starts with
+// the tag of one of its fields, which are all below 16 and therefore encoded
+// as a single byte below 0x80.
+constexpr char kDescriptorPrefix[8] = {'\xff', 'S', 'H', 'M', 0, 0, 0, 1};
+
+// How long Create() and Open() wait for a concurrently created segment to be
+// initialized.
+constexpr absl::Duration kInitializationTimeout = absl::Milliseconds(100);
+
+constexpr size_t RoundUpToCacheLine(size_t size) {
+  return (size + ABSL_CACHELINE_SIZE - 1) / ABSL_CACHELINE_SIZE *
+         ABSL_CACHELINE_SIZE;
+}
+
+absl::Status ErrnoToStatus(absl::string_view what, absl::string_view name) {
+  const int error = errno;
+  const std::string message =
+      absl::StrCat(what, " of shared memory segment ", name,
+                   " failed: ", std::strerror(error));
+  if (error == ENOENT) return absl::NotFoundError(message);
+  return absl::InternalError(message);
+}
+
+}  // namespace
+
+// Header at the beginning of the segment. Followed by `num_slots` slots, each
+// consisting of a SlotHeader and `slot_size` bytes of data.
+struct SharedMemoryRing::Header {
+  // Written last (with release semantics) when the segment is initialized.
+  std::atomic<uint32_t> magic;
+  uint32_t version;
+  uint64_t num_slots;
+  uint64_t slot_size;
+  uint64_t ring_id;
+  // The sequence number of the next packet.
+  alignas(ABSL_CACHELINE_SIZE) std::atomic<uint64_t> next_sequence;
+};
+
+struct alignas(ABSL_CACHELINE_SIZE) SharedMemoryRing::SlotHeader {
+  // Sequence lock of the slot. 0 if the slot is empty, 2 * sequence + 1 while
+  // the packet with the given sequence number is written and 2 * sequence + 2
+  // once it is committed.
+  std::atomic<uint64_t> state;
+  std::atomic<uint64_t> size;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+                  std::atomic<uint64_t>::is_always_lock_free,
+              "Atomic operations need to be lock free for multi-process "
+              "communication");
+
+size_t SharedMemoryRing::SlotStride(size_t slot_size) {
+  return sizeof(SlotHeader) + RoundUpToCacheLine(slot_size);
+}
+
+std::string SharedMemoryRing::SegmentName(absl::string_view prefixed_topic) {
+  return absl::StrCat("/intrinsic_pubsub.",
+                      absl::StrReplaceAll(prefixed_topic, {{"/", "."}}));
+}
+
+SharedMemoryRing::SharedMemoryRing(int fd, void* base, size_t mapped_size,
+                                   std::string owned_name)
+    : fd_(fd),
+      base_(base),
+      mapped_size_(mapped_size),
+      owned_name_(std::move(owned_name)) {}
+
+SharedMemoryRing::~SharedMemoryRing() {
+  munmap(base_, mapped_size_);
+  close(fd_);
+  if (!owned_name_.empty()) shm_unlink(owned_name_.c_str());
+}
+
+absl::StatusOr<std::unique_ptr<SharedMemoryRing>> SharedMemoryRing::Create(
+    absl::string_view segment_name, size_t num_slots, size_t slot_size) {
+  if (num_slots == 0 || slot_size == 0) {
+    return absl::InvalidArgumentError(
+        "Shared memory rings need at least one slot of non-zero size");
+  }
+  const std::string name(segment_name);
+  // Packets may hold private data, so other users must not map the segment.
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0 && errno == EEXIST) {
+    absl::StatusOr<std::unique_ptr<SharedMemoryRing>> ring = Open(name);
+    if (!ring.ok()) return ring.status();
+    if ((*ring)->num_slots() != num_slots ||
+        (*ring)->slot_size() != slot_size) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          "Shared memory segment ", name, " exists with ",
+          (*ring)->num_slots(), " slots of ", (*ring)->slot_size(),
+          " bytes, but ", num_slots, " slots of ", slot_size,
+          " bytes were requested"));
+    }
+    return ring;
+  }
+  if (fd < 0) return ErrnoToStatus("Creation", name);
+
+  const size_t mapped_size =
+      RoundUpToCacheLine(sizeof(Header)) + num_slots * SlotStride(slot_size);
+  if (ftruncate(fd, static_cast<off_t>(mapped_size)) != 0) {
+    absl::Status status = ErrnoToStatus("Resizing", name);
+    close(fd);
+    shm_unlink(name.c_str());
+    return status;
+  }
+  void* base =
+      mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    absl::Status status = ErrnoToStatus("Mapping", name);
+    close(fd);
+    shm_unlink(name.c_str());
+    return status;
+  }
+
+  // ftruncate() zero-fills the segment, so all slots start out empty.
+  auto* header = new (base) Header();
+  header->version = kVersion;
+  header->num_slots = num_slots;
+  header->slot_size = slot_size;
+  header->ring_id = absl::Uniform<uint64_t>(absl::BitGen());
+  header->next_sequence.store(0, std::memory_order_relaxed);
+  header->magic.store(kMagic, std::memory_order_release);
+  return absl::WrapUnique(new SharedMemoryRing(fd, base, mapped_size, name));
+}
+
+absl::StatusOr<std::unique_ptr<SharedMemoryRing>> SharedMemoryRing::Open(
+    absl::string_view segment_name) {
+  const std::string name(segment_name);
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) return ErrnoToStatus("Opening", name);
+
+  // The segment might have been created, but not yet resized and initialized
+  // by another process.
+  const absl::Time deadline = absl::Now() + kInitializationTimeout;
+  struct stat stat_buffer;
+  while (true) {
+    if (fstat(fd, &stat_buffer) != 0) {
+      absl::Status status = ErrnoToStatus("Inspection", name);
+      close(fd);
+      return status;
+    }
+    if (static_cast<size_t>(stat_buffer.st_size) >= sizeof(Header)) break;
+    if (absl::Now() > deadline) {
+      close(fd);
+      return absl::UnavailableError(
+          absl::StrCat("Shared memory segment ", name, " is not initialized"));
+    }
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+
+  const size_t mapped_size = static_cast<size_t>(stat_buffer.st_size);
+  void* base =
+      mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    absl::Status status = ErrnoToStatus("Mapping", name);
+    close(fd);
+    return status;
+  }
+  auto ring = absl::WrapUnique(
+      new SharedMemoryRing(fd, base, mapped_size, /*owned_name=*/""));
+
+  const auto* header = static_cast<const Header*>(base);
+  while (header->magic.load(std::memory_order_acquire) != kMagic) {
+    if (absl::Now() > deadline) {
+      return absl::UnavailableError(
+          absl::StrCat("Shared memory segment ", name, " is not initialized"));
+    }
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  if (header->version != kVersion ||
+      mapped_size < RoundUpToCacheLine(sizeof(Header)) +
+                        header->num_slots * SlotStride(header->slot_size)) {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "Shared memory segment ", name, " has an incompatible layout"));
+  }
+  return ring;
+}
+
+void SharedMemoryRing::EncodeDescriptor(const Descriptor& descriptor,
+                                        char* out) {
+  // Descriptors never leave the host, so the fields are stored in native byte
+  // order.
+  std::memcpy(out, kDescriptorPrefix, sizeof(kDescriptorPrefix));
+  std::memcpy(out + 8, &descriptor.ring_id, sizeof(descriptor.ring_id));
+  std::memcpy(out + 16, &descriptor.sequence, sizeof(descriptor.sequence));
+}
+
+std::optional<SharedMemoryRing::Descriptor> SharedMemoryRing::DecodeDescriptor(
+    absl::string_view data) {
+  if (data.size() != kDescriptorSize ||
+      !absl::StartsWith(data, absl::string_view(kDescriptorPrefix,
+                                                sizeof(kDescriptorPrefix)))) {
+    return std::nullopt;
+  }
+  Descriptor descriptor;
+  std::memcpy(&descriptor.ring_id, data.data() + 8, sizeof(descriptor.ring_id));
+  std::memcpy(&descriptor.sequence, data.data() + 16,
+              sizeof(descriptor.sequence));
+  return descriptor;
+}
+
+uint64_t SharedMemoryRing::ring_id() const {
+  return static_cast<const Header*>(base_)->ring_id;
+}
+
+size_t SharedMemoryRing::num_slots() const {
+  return static_cast<const Header*>(base_)->num_slots;
+}
+
+size_t SharedMemoryRing::slot_size() const {
+  return static_cast<const Header*>(base_)->slot_size;
+}
+
+SharedMemoryRing::SlotHeader& SharedMemoryRing::Slot(uint64_t sequence) const {
+  const auto* header = static_cast<const Header*>(base_);
+  char* slots =
+      static_cast<char*>(base_) + RoundUpToCacheLine(sizeof(Header));
+  return *reinterpret_cast<SlotHeader*>(
+      slots + (sequence % header->num_slots) * SlotStride(header->slot_size));
+}
+
+absl::StatusOr<SharedMemoryRing::Reservation> SharedMemoryRing::Reserve() {
+  auto* header = static_cast<Header*>(base_);
+  const uint64_t sequence =
+      header->next_sequence.fetch_add(1, std::memory_order_relaxed);
+  SlotHeader& slot = Slot(sequence);
+  uint64_t state = slot.state.load(std::memory_order_relaxed);
+  // An odd state means that another publisher is still writing to the slot.
+  if (state % 2 == 1 ||
+      !slot.state.compare_exchange_strong(state, 2 * sequence + 1,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed)) {
+    return absl::ResourceExhaustedError(
+        "Shared memory slot is still being written");
+  }
+  // Make sure that readers observe the busy state before any of the writes to
+  // the slot data.
+  std::atomic_thread_fence(std::memory_order_release);
+  return Reservation{.sequence = sequence,
+                     .data = reinterpret_cast<char*>(&slot + 1)};
+}
+
+SharedMemoryRing::Descriptor SharedMemoryRing::Commit(
+    const Reservation& reservation, size_t size) {
+  SlotHeader& slot = Slot(reservation.sequence);
+  slot.size.store(size, std::memory_order_relaxed);
+  slot.state.store(2 * reservation.sequence + 2, std::memory_order_release);
+  return Descriptor{.ring_id = ring_id(), .sequence = reservation.sequence};
+}
+
+void SharedMemoryRing::Abort(const Reservation& reservation) {
+  // The data of the previous packet in this slot might have been partially
+  // overwritten, so the slot is marked as empty.
+  Slot(reservation.sequence).state.store(0, std::memory_order_release);
+}
+
+bool SharedMemoryRing::Read(uint64_t sequence, std::string* out) const {
+  const SlotHeader& slot = Slot(sequence);
+  const uint64_t committed = 2 * sequence + 2;
+  if (slot.state.load(std::memory_order_acquire) != committed) return false;
+  const size_t size = slot.size.load(std::memory_order_relaxed);
+  if (size > slot_size()) return false;
+  out->assign(reinterpret_cast<const char*>(&slot + 1), size);
+  // Make sure that the copy above happens before checking that the slot was
+  // not overwritten in the meantime.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.state.load(std::memory_order_relaxed) == committed;
+}
+
+bool SharedMemoryReader::Resolve(absl::string_view* blob,
+                                 std::string* buffer) {
+  std::optional<SharedMemoryRing::Descriptor> descriptor =
+      SharedMemoryRing::DecodeDescriptor(*blob);
+  if (!descriptor.has_value()) return true;
+
+  absl::MutexLock lock(&mu_);
+  // (Re-)open the segment when receiving the first descriptor and whenever the
+  // segment was recreated by a publisher.
+  if (ring_ == nullptr || ring_->ring_id() != descriptor->ring_id) {
+    absl::StatusOr<std::unique_ptr<SharedMemoryRing>> ring =
+        SharedMemoryRing::Open(segment_name_);
+    if (!ring.ok()) {
+      LOG_EVERY_N_SEC(ERROR, 10)
+          << "Cannot read packet from shared memory: " << ring.status();
+      return false;
+    }
+    ring_ = *std::move(ring);
+    if (ring_->ring_id() != descriptor->ring_id) {
+      LOG_EVERY_N_SEC(ERROR, 10)
+          << "Shared memory segment " << segment_name_
+          << " does not match the received descriptor";
+      return false;
+    }
+  }
+  if (!ring_->Read(descriptor->sequence, buffer)) {
+    LOG_EVERY_N_SEC(WARNING, 10)
+        << "Dropped packet " << descriptor->sequence << " from shared memory "
+        << "segment " << segment_name_ << " since it was overwritten";
+    return false;
+  }
+  *blob = *buffer;
+  return true;
+}
+
+}  // namespace intrinsic::internal
@@ -0,0 +1,150 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_SHARED_MEMORY_RING_H_
+#define INTRINSIC_PLATFORM_PUBSUB_SHARED_MEMORY_RING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace intrinsic::internal {
+
+// A ring of sequence-numbered slots in a named POSIX shared memory segment,
+// used to exchange PubSub packets between processes on the same host.
+//
+// A publisher writes a packet into the next slot of the ring and then sends a
+// small fixed-size descriptor, which identifies the ring and the sequence
+// number of the slot, through the middleware. Subscribers resolve the
+// descriptor by copying the packet out of shared memory. Large payloads
+// therefore never pass through the network stack.
+//
+// Every slot is protected by a sequence lock: a writer claims a slot by
+// atomically marking it as busy, and readers detect when the slot was
+// overwritten by a newer packet while they were reading it. A ring can be
+// shared by several publishers of the same topic. Readers that fall behind by
+// more than the number of slots lose the overwritten packets.
+//
+// Writing and reading are lock-free and do not allocate, except for
+// `Read()` growing its output buffer.
+class SharedMemoryRing {
+ public:
+  // Size of a serialized descriptor.
+  static constexpr size_t kDescriptorSize = 24;
+
+  // Identifies a packet in a ring.
+  struct Descriptor {
+    uint64_t ring_id;
+    uint64_t sequence;
+  };
+
+  // A slot that was claimed for writing with Reserve().
+  struct Reservation {
+    uint64_t sequence;
+    char* data;
+  };
+
+  // Returns the name of the shared memory segment used for the topic with the
+  // given (prefixed) name.
+  static std::string SegmentName(absl::string_view prefixed_topic);
+
+  // Creates the segment with the given name, or opens it if it already exists
+  // with the same layout. Returns a FailedPrecondition error if the segment
+  // exists with a different layout. A created segment is only accessible to
+  // processes of the same user, and the ring that created it owns it.
+  static absl::StatusOr<std::unique_ptr<SharedMemoryRing>> Create(
+      absl::string_view segment_name, size_t num_slots, size_t slot_size);
+
+  // Opens an existing segment. Returns a NotFound error if no segment with the
+  // given name exists.
+  static absl::StatusOr<std::unique_ptr<SharedMemoryRing>> Open(
+      absl::string_view segment_name);
+
+  // Serializes `descriptor` into `out`, which must have room for
+  // kDescriptorSize bytes.
+  static void EncodeDescriptor(const Descriptor& descriptor, char* out);
+
+  // Returns the descriptor serialized in `data`, or std::nullopt if `data`
+  // does not hold a serialized descriptor. Serialized descriptors can never be
+  // mistaken for a serialized PubSubPacket.
+  static std::optional<Descriptor> DecodeDescriptor(absl::string_view data);
+
+  SharedMemoryRing(const SharedMemoryRing&) = delete;
+  SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+  // Unmaps the segment. If this ring owns the segment, also removes its name,
+  // so that it is freed once all other processes unmapped it. Rings that
+  // have it mapped keep working, but it can no longer be opened.
+  ~SharedMemoryRing();
+
+  // A random id that changes whenever the segment is recreated.
+  uint64_t ring_id() const;
+  size_t num_slots() const;
+  // Maximum size of a packet.
+  size_t slot_size() const;
+
+  // Claims the next slot of the ring for writing. Returns a ResourceExhausted
+  // error if the slot is still being written by another publisher. The
+  // reservation must be finished with either Commit() or Abort().
+  absl::StatusOr<Reservation> Reserve();
+
+  // Publishes the first `size` bytes of the reserved slot and returns the
+  // descriptor of the packet.
+  Descriptor Commit(const Reservation& reservation, size_t size);
+
+  // Releases a reserved slot without publishing it.
+  void Abort(const Reservation& reservation);
+
+  // Copies the packet with the given sequence number into `out`. Returns
+  // false if the slot no longer (or not yet) holds that packet.
+  bool Read(uint64_t sequence, std::string* out) const;
+
+ private:
+  struct Header;
+  struct SlotHeader;
+
+  // `owned_name` is the name of the segment if this ring created it, and
+  // empty otherwise.
+  SharedMemoryRing(int fd, void* base, size_t mapped_size,
+                   std::string owned_name);
+
+  // Distance between two consecutive slots in the segment.
+  static size_t SlotStride(size_t slot_size);
+
+  SlotHeader& Slot(uint64_t sequence) const;
+
+  int fd_;
+  void* base_;
+  size_t mapped_size_;
+  std::string owned_name_;
+};
+
+// Resolves descriptors received on a shared memory topic into packets.
+//
+// This class is thread-safe.
+class SharedMemoryReader {
+ public:
+  explicit SharedMemoryReader(std::string segment_name)
+      : segment_name_(std::move(segment_name)) {}
+
+  // If `*blob` is a descriptor, copies the packet it refers to into `buffer`
+  // and points `*blob` to it. Returns false if the packet could not be read,
+  // e.g., because it was already overwritten. Returns true and leaves `*blob`
+  // unchanged if it is not a descriptor.
+  bool Resolve(absl::string_view* blob, std::string* buffer);
+
+ private:
+  const std::string segment_name_;
+  absl::Mutex mu_;
+  std::unique_ptr<SharedMemoryRing> ring_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace intrinsic::internal
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_SHARED_MEMORY_RING_H_
@@ -0,0 +1,212 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/shared_memory_ring.h"
+
+#include <gmock/gmock.h>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::internal {
+namespace {
+
+using ::intrinsic::testing::IsOk;
+using ::intrinsic::testing::StatusIs;
+
+class SharedMemoryRingTest : public ::testing::Test {
+ protected:
+  SharedMemoryRingTest()
+      : segment_name_(SharedMemoryRing::SegmentName(absl::StrCat(
+            "in/test/", ::testing::UnitTest::GetInstance()
+                             ->current_test_info()
+                             ->name()))) {
+    shm_unlink(segment_name_.c_str());
+  }
+  ~SharedMemoryRingTest() override { shm_unlink(segment_name_.c_str()); }
+
+  void Write(SharedMemoryRing& ring, absl::string_view data,
+             SharedMemoryRing::Descriptor* descriptor) {
+    absl::StatusOr<SharedMemoryRing::Reservation> reservation = ring.Reserve();
+    ASSERT_THAT(reservation.status(), IsOk());
+    std::memcpy(reservation->data, data.data(), data.size());
+    *descriptor = ring.Commit(*reservation, data.size());
+  }
+
+  const std::string segment_name_;
+};
+
+TEST_F(SharedMemoryRingTest, SegmentNameHasNoInnerSlashes) {
+  EXPECT_EQ(SharedMemoryRing::SegmentName("in/a/b"), "/intrinsic_pubsub.in.a.b");
+}
+
+TEST_F(SharedMemoryRingTest, ReadsCommittedPackets) {
+  absl::StatusOr<std::unique_ptr<SharedMemoryRing>> writer =
+      SharedMemoryRing::Create(segment_name_, /*num_slots=*/4,
+                               /*slot_size=*/64);
+  ASSERT_THAT(writer.status(), IsOk());
+  absl::StatusOr<std::unique_ptr<SharedMemoryRing>> reader =
+      SharedMemoryRing::Open(segment_name_);
+  ASSERT_THAT(reader.status(), IsOk());
+  EXPECT_EQ((*reader)->ring_id(), (*writer)->ring_id());
+  EXPECT_EQ((*reader)->num_slots(), 4);
+  EXPECT_EQ((*reader)->slot_size(), 64);
+
+  SharedMemoryRing::Descriptor first;
+  SharedMemoryRing::Descriptor second;
+  Write(**writer, "hello", &first);
+  Write(**writer, "world", &second);
+  EXPECT_EQ(first.ring_id, (*writer)->ring_id());
+  EXPECT_EQ(second.sequence, first.sequence + 1);
+
+  std::string out;
+  ASSERT_TRUE((*reader)->Read(first.sequence, &out));
+  EXPECT_EQ(out, "hello");
+  ASSERT_TRUE((*reader)->Read(second.sequence, &out));
+  EXPECT_EQ(out, "world");
+  // Not yet written.
+  EXPECT_FALSE((*reader)->Read(second.sequence + 1, &out));
+}
+
+TEST_F(SharedMemoryRingTest, OverwrittenPacketsCannotBeRead) {
+  absl::StatusOr<std::unique_ptr<SharedMemoryRing>> ring =
+      SharedMemoryRing::Create(segment_name_, /*num_slots=*/2,
+                               /*slot_size=*/16);
+  ASSERT_THAT(ring.status(), IsOk());
+  SharedMemoryRing::Descriptor descriptors[3];
+  for (int i = 0; i < 3; ++i) {
+    Write(**ring, absl::StrCat("packet ", i), &descriptors[i]);
+  }
+  std::string out;
+  EXPECT_FALSE((*ring)->Read(descriptors[0].sequence, &out));
+  ASSERT_TRUE((*ring)->Read(descriptors[2].sequence, &out));
+  EXPECT_EQ(out, "packet 2");
+}
+
+TEST_F(SharedMemoryRingTest, BusySlotCannotBeReserved) {
+  absl::StatusOr<std::unique_ptr<SharedMemoryRing>> ring =
+      SharedMemoryRing::Create(segment_name_, /*num_slots=*/1,
+                               /*slot_size=*/16);
+  ASSERT_THAT(ring.status(), IsOk());
+  absl::StatusOr<SharedMemoryRing::Reservation> first = (*ring)->Reserve();
+  ASSERT_THAT(first.status(), IsOk());
+  EXPECT_THAT((*ring)->Reserve().status(),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+  (*ring)->Abort(*first);
+  EXPECT_THAT((*ring)->Reserve().status(), IsOk());
+}
+
+TEST_F(SharedMemoryRingTest, CreateReusesCompatibleSegment) {
+  absl::StatusOr<std::unique_ptr<SharedMemoryRing>> first =
+      SharedMemoryRing::Create(segment_name_, /*num_slots=*/2,
+                               /*slot_size=*/16);
+  ASSERT_THAT(first.status(), IsOk());
+  absl::StatusOr<std::unique_ptr<SharedMemoryRing>> second =
+      SharedMemoryRing::Create(segment_name_, /*num_slots=*/2,
+                               /*slot_size=*/16);
+  ASSERT_THAT(second.status(), IsOk());
+  EXPECT_EQ((*first)->ring_id(), (*second)->ring_id());
+
+  EXPECT_THAT(SharedMemoryRing::Create(segment_name_, /*num_slots=*/4,
+                                       /*slot_size=*/16)
+                  .status(),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST_F(SharedMemoryRingTest, CreatedSegmentIsPrivateToUser) {
+  absl::StatusOr<std::unique_ptr<SharedMemoryRing>> ring =
+      SharedMemoryRing::Create(segment_name_, /*num_slots=*/2,
+                               /*slot_size=*/16);
+  ASSERT_THAT(ring.status(), IsOk());
+  const int fd = shm_open(segment_name_.c_str(), O_RDONLY, 0);
+  ASSERT_GE(fd, 0);
+  struct stat stat_buffer;
+  ASSERT_EQ(fstat(fd, &stat_buffer), 0);
+  close(fd);
+  EXPECT_EQ(stat_buffer.st_mode & 0777, 0600);
+}
+
+TEST_F(SharedMemoryRingTest, OwnerRemovesSegment) {
+  absl::StatusOr<std::unique_ptr<SharedMemoryRing>> owner =
+      SharedMemoryRing::Create(segment_name_, /*num_slots=*/2,
+                               /*slot_size=*/16);
+  ASSERT_THAT(owner.status(), IsOk());
+  absl::StatusOr<std::unique_ptr<SharedMemoryRing>> reused =
+      SharedMemoryRing::Create(segment_name_, /*num_slots=*/2,
+                               /*slot_size=*/16);
+  ASSERT_THAT(reused.status(), IsOk());
+  absl::StatusOr<std::unique_ptr<SharedMemoryRing>> reader =
+      SharedMemoryRing::Open(segment_name_);
+  ASSERT_THAT(reader.status(), IsOk());
+
+  // Rings that only opened the segment leave it in place.
+  reused->reset();
+  reader->reset();
+  EXPECT_THAT(SharedMemoryRing::Open(segment_name_).status(), IsOk());
+
+  reader = SharedMemoryRing::Open(segment_name_);
+  ASSERT_THAT(reader.status(), IsOk());
+  owner->reset();
+  EXPECT_THAT(SharedMemoryRing::Open(segment_name_).status(),
+              StatusIs(absl::StatusCode::kNotFound));
+  // The mapping of the reader stays valid.
+  EXPECT_EQ((*reader)->num_slots(), 2);
+}
+
+TEST_F(SharedMemoryRingTest, OpenFailsForMissingSegment) {
+  EXPECT_THAT(SharedMemoryRing::Open(segment_name_).status(),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST_F(SharedMemoryRingTest, DescriptorRoundTrip) {
+  char serialized[SharedMemoryRing::kDescriptorSize];
+  SharedMemoryRing::EncodeDescriptor({.ring_id = 123, .sequence = 456},
+                                     serialized);
+  std::optional<SharedMemoryRing::Descriptor> descriptor =
+      SharedMemoryRing::DecodeDescriptor(
+          absl::string_view(serialized, sizeof(serialized)));
+  ASSERT_TRUE(descriptor.has_value());
+  EXPECT_EQ(descriptor->ring_id, 123);
+  EXPECT_EQ(descriptor->sequence, 456);
+
+  EXPECT_FALSE(SharedMemoryRing::DecodeDescriptor("").has_value());
+  EXPECT_FALSE(
+      SharedMemoryRing::DecodeDescriptor(std::string(24, '\x0a')).has_value());
+}
+
+TEST_F(SharedMemoryRingTest, ReaderResolvesDescriptors) {
+  absl::StatusOr<std::unique_ptr<SharedMemoryRing>> ring =
+      SharedMemoryRing::Create(segment_name_, /*num_slots=*/2,
+                               /*slot_size=*/16);
+  ASSERT_THAT(ring.status(), IsOk());
+  SharedMemoryRing::Descriptor descriptor;
+  Write(**ring, "packet", &descriptor);
+  char serialized[SharedMemoryRing::kDescriptorSize];
+  SharedMemoryRing::EncodeDescriptor(descriptor, serialized);
+
+  SharedMemoryReader reader(segment_name_);
+  std::string buffer;
+  absl::string_view blob(serialized, sizeof(serialized));
+  ASSERT_TRUE(reader.Resolve(&blob, &buffer));
+  EXPECT_EQ(blob, "packet");
+
+  // Inline packets are passed through.
+  blob = "inline";
+  ASSERT_TRUE(reader.Resolve(&blob, &buffer));
+  EXPECT_EQ(blob, "inline");
+}
+
+}  // namespace
+}  // namespace intrinsic::internal
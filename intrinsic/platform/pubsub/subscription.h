@@ -3,15 +3,30 @@
 #ifndef INTRINSIC_PLATFORM_PUBSUB_SUBSCRIPTION_H_
 #define INTRINSIC_PLATFORM_PUBSUB_SUBSCRIPTION_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
 #include "absl/strings/string_view.h"
+#include "intrinsic/platform/pubsub/latency_histogram.h"
 
 namespace intrinsic {
 
 struct SubscriptionData;
 
+// Latencies of the messages received by a subscription. See
+// TopicConfig::record_latency.
+struct SubscriptionLatencyStats {
+  // From Publisher::Publish() until the middleware handed the message to the
+  // subscription. Only meaningful if the clocks of the publishing and the
+  // subscribing host are synchronized.
+  LatencySummary publish_to_receive;
+  // From the middleware handing the message to the subscription until the
+  // callback returned, including the time spent waiting for the dispatch
+  // thread with TopicConfig::LatestValue or TopicConfig::BoundedQueue delivery.
+  LatencySummary receive_to_callback_complete;
+};
+
 class Subscription {
  public:
   Subscription();
@@ -27,6 +42,15 @@ class Subscription {
 
   absl::string_view TopicName() const { return topic_name_; }
 
+  // Returns the number of received messages that were dropped because the
+  // callback did not keep up. Always zero for subscriptions with
+  // TopicConfig::Inline delivery.
+  uint64_t NumDroppedMessages() const;
+
+  // Returns the latencies of the messages received so far. All counts are
+  // zero unless the subscription was created with TopicConfig::record_latency.
+  SubscriptionLatencyStats GetLatencyStats() const;
+
   // To handle complex cases, such as when unsubscribing from a Python topic,
   // the shutdown sequence may need to be done in delicate ordering to avoid the
   // potential for deadlock. The Python GIL needs to be acquired when the
@@ -34,6 +58,9 @@ class Subscription {
   // Zenoh subscription is destroyed, due to internal mutex contention in the
   // callback thread pool.  Exposing the Unsubscribe() function allows a pybind
   // holder type to do this in the correct order.
+  //
+  // For subscriptions with a dispatch thread, this waits for a running
+  // callback to return. Afterwards, the callback is not invoked anymore.
   void Unsubscribe();
 
  private:
@@ -0,0 +1,167 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/subscription_dispatcher.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::internal {
+
+namespace {
+
+// Upper bound for how long the dispatch thread sleeps without checking whether
+// it was stopped.
+constexpr absl::Duration kWakeupInterval = absl::Milliseconds(100);
+
+}  // namespace
+
+absl::Status SubscriptionDispatcher::Start(const Thread::Options& options) {
+  Thread::Options named_options = options;
+  if (!options.GetName().has_value()) {
+    named_options.SetName("pubsub_dispatch");
+  }
+  return thread_.Start(named_options, [this]() { Run(); });
+}
+
+void SubscriptionDispatcher::Stop() {
+  stop_.store(true, std::memory_order_release);
+  Notify();
+  if (thread_.Joinable()) {
+    thread_.Join();
+  }
+}
+
+void SubscriptionDispatcher::WaitForNotification() const {
+  // A timeout is not an error here, it only bounds the time until stop_ is
+  // checked again.
+  (void)wakeup_.WaitFor(kWakeupInterval);
+}
+
+absl::StatusOr<std::unique_ptr<LatestValueDispatcher>>
+LatestValueDispatcher::Create(Callback callback,
+                              const Thread::Options& thread_options) {
+  auto dispatcher = absl::WrapUnique(new LatestValueDispatcher(
+      std::move(callback)));
+  INTR_RETURN_IF_ERROR(dispatcher->Start(thread_options));
+  return dispatcher;
+}
+
+LatestValueDispatcher::~LatestValueDispatcher() { Stop(); }
+
+void LatestValueDispatcher::Offer(absl::string_view keyexpr,
+                                  absl::string_view packet,
+                                  absl::Time receive_time) {
+  bool replaced = false;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = slots_.find(keyexpr);
+    if (it == slots_.end()) {
+      it = slots_.try_emplace(std::string(keyexpr)).first;
+    }
+    Slot& slot = it->second;
+    slot.packet.assign(packet.data(), packet.size());
+    slot.receive_time = receive_time;
+    replaced = slot.pending;
+    if (!slot.pending) {
+      slot.pending = true;
+      ready_.push_back(&*it);
+    }
+  }
+  if (replaced) {
+    RecordDrop();
+  } else {
+    Notify();
+  }
+}
+
+void LatestValueDispatcher::Run() {
+  std::string keyexpr;
+  std::string packet;
+  absl::Time receive_time;
+  while (!stopped()) {
+    bool has_packet = false;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (!ready_.empty()) {
+        auto* entry = ready_.front();
+        ready_.pop_front();
+        keyexpr.assign(entry->first);
+        // Swapping hands the slot the buffer of the previous packet, so that
+        // neither side needs to allocate for packets of similar size.
+        packet.swap(entry->second.packet);
+        receive_time = entry->second.receive_time;
+        entry->second.pending = false;
+        has_packet = true;
+      }
+    }
+    if (has_packet) {
+      Deliver(keyexpr, packet, receive_time);
+    } else {
+      WaitForNotification();
+    }
+  }
+}
+
+absl::StatusOr<std::unique_ptr<BoundedQueueDispatcher>>
+BoundedQueueDispatcher::Create(size_t capacity, Callback callback,
+                               const Thread::Options& thread_options) {
+  if (capacity == 0) {
+    return absl::InvalidArgumentError(
+        "The capacity of a subscription queue must be positive");
+  }
+  auto dispatcher = absl::WrapUnique(
+      new BoundedQueueDispatcher(capacity, std::move(callback)));
+  INTR_RETURN_IF_ERROR(dispatcher->Start(thread_options));
+  return dispatcher;
+}
+
+BoundedQueueDispatcher::BoundedQueueDispatcher(size_t capacity,
+                                               Callback callback)
+    : SubscriptionDispatcher(std::move(callback)), queue_(capacity) {}
+
+BoundedQueueDispatcher::~BoundedQueueDispatcher() { Stop(); }
+
+void BoundedQueueDispatcher::Offer(absl::string_view keyexpr,
+                                   absl::string_view packet,
+                                   absl::Time receive_time) {
+  {
+    absl::MutexLock lock(&writer_mutex_);
+    Entry* entry = queue_.writer()->PrepareInsert();
+    if (entry == nullptr) {
+      RecordDrop();
+      return;
+    }
+    entry->keyexpr.assign(keyexpr.data(), keyexpr.size());
+    entry->packet.assign(packet.data(), packet.size());
+    entry->receive_time = receive_time;
+    queue_.writer()->FinishInsert();
+  }
+  Notify();
+}
+
+void BoundedQueueDispatcher::Run() {
+  RealtimeQueue<Entry>::Reader* reader = queue_.reader();
+  while (!stopped()) {
+    // The entry stays in the queue while the callback runs, so its buffers are
+    // not copied.
+    if (const Entry* entry = reader->Front(); entry != nullptr) {
+      Deliver(entry->keyexpr, entry->packet, entry->receive_time);
+      reader->DropFront();
+    } else {
+      WaitForNotification();
+    }
+  }
+}
+
+}  // namespace intrinsic::internal
@@ -0,0 +1,184 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_SUBSCRIPTION_DISPATCHER_H_
+#define INTRINSIC_PLATFORM_PUBSUB_SUBSCRIPTION_DISPATCHER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/node_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/interprocess/binary_futex.h"
+#include "intrinsic/platform/common/buffers/rt_queue.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::internal {
+
+// Decouples the callback of a subscription from the thread of the middleware
+// that receives the packets.
+//
+// Received packets are copied into the dispatcher with Offer() and handed to
+// the callback by a thread that is owned by the dispatcher. A slow callback
+// therefore never blocks the middleware. Instead, packets are dropped if the
+// callback cannot keep up; see the subclasses for which packets are dropped.
+//
+// Offer() is thread-safe. The callback is only ever invoked from the dispatch
+// thread, i.e., one packet at a time. The dispatch thread is started with the
+// Thread::Options passed to Create(), so that latency-sensitive subscriptions
+// can run their callbacks with a real-time priority or on dedicated CPUs. It is
+// named "pubsub_dispatch" unless the options set a name.
+class SubscriptionDispatcher {
+ public:
+  // Receives the key expression on which a packet was received, the packet
+  // and the time at which it was passed to Offer(). The key expression and the
+  // packet are only valid for the duration of the callback.
+  using Callback =
+      std::function<void(absl::string_view keyexpr, absl::string_view packet,
+                         absl::Time receive_time)>;
+
+  SubscriptionDispatcher(const SubscriptionDispatcher&) = delete;
+  SubscriptionDispatcher& operator=(const SubscriptionDispatcher&) = delete;
+  virtual ~SubscriptionDispatcher() = default;
+
+  // Copies the packet for delivery on the dispatch thread. `receive_time` is
+  // passed on to the callback as is.
+  virtual void Offer(absl::string_view keyexpr, absl::string_view packet,
+                     absl::Time receive_time) = 0;
+
+  // Number of packets that were passed to the callback.
+  uint64_t num_delivered() const {
+    return num_delivered_.load(std::memory_order_relaxed);
+  }
+
+  // Number of packets that were dropped because the callback did not keep up.
+  uint64_t num_dropped() const {
+    return num_dropped_.load(std::memory_order_relaxed);
+  }
+
+ protected:
+  explicit SubscriptionDispatcher(Callback callback)
+      : callback_(std::move(callback)) {}
+
+  // Starts the dispatch thread with `options`, which runs Run() until Stop()
+  // is called.
+  absl::Status Start(const Thread::Options& options);
+
+  // Stops and joins the dispatch thread. Packets that were not delivered yet
+  // are discarded. Must be called by the destructor of subclasses, before their
+  // members are destroyed.
+  void Stop();
+
+  bool stopped() const { return stop_.load(std::memory_order_acquire); }
+
+  // Wakes up the dispatch thread.
+  void Notify() { (void)wakeup_.Post(); }
+
+  // Blocks the dispatch thread until Notify() is called, or a short timeout
+  // expires.
+  void WaitForNotification() const;
+
+  void Deliver(absl::string_view keyexpr, absl::string_view packet,
+               absl::Time receive_time) {
+    callback_(keyexpr, packet, receive_time);
+    num_delivered_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void RecordDrop() { num_dropped_.fetch_add(1, std::memory_order_relaxed); }
+
+  // Delivers packets until stopped() returns true.
+  virtual void Run() = 0;
+
+ private:
+  const Callback callback_;
+  icon::BinaryFutex wakeup_;
+  std::atomic<bool> stop_ = false;
+  std::atomic<uint64_t> num_delivered_ = 0;
+  std::atomic<uint64_t> num_dropped_ = 0;
+  Thread thread_;
+};
+
+// Delivers only the newest packet of every key expression. A packet that
+// arrives before the previous packet on the same key expression was delivered
+// replaces it, and the replaced packet counts as dropped.
+//
+// This suits topics whose subscribers only care about the current state, such
+// as sensor streams.
+class LatestValueDispatcher : public SubscriptionDispatcher {
+ public:
+  static absl::StatusOr<std::unique_ptr<LatestValueDispatcher>> Create(
+      Callback callback,
+      const Thread::Options& thread_options = Thread::Options());
+
+  ~LatestValueDispatcher() override;
+
+  void Offer(absl::string_view keyexpr, absl::string_view packet,
+             absl::Time receive_time) override;
+
+ private:
+  struct Slot {
+    std::string packet;
+    absl::Time receive_time;
+    bool pending = false;
+  };
+
+  using SubscriptionDispatcher::SubscriptionDispatcher;
+
+  void Run() override;
+
+  absl::Mutex mutex_;
+  // Node-based so that `ready_` can point into it. Slots are never erased, so
+  // after the first packet on a key expression, Offer() does not allocate
+  // unless the packet grows.
+  absl::node_hash_map<std::string, Slot> slots_ ABSL_GUARDED_BY(mutex_);
+  // Slots with a pending packet, in the order in which they became pending.
+  std::deque<absl::node_hash_map<std::string, Slot>::value_type*> ready_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+// Delivers all packets in the order in which they were received, through a
+// queue with a fixed capacity. Packets that arrive while the queue is full are
+// dropped.
+class BoundedQueueDispatcher : public SubscriptionDispatcher {
+ public:
+  static absl::StatusOr<std::unique_ptr<BoundedQueueDispatcher>> Create(
+      size_t capacity, Callback callback,
+      const Thread::Options& thread_options = Thread::Options());
+
+  ~BoundedQueueDispatcher() override;
+
+  void Offer(absl::string_view keyexpr, absl::string_view packet,
+             absl::Time receive_time) override;
+
+ private:
+  struct Entry {
+    std::string keyexpr;
+    std::string packet;
+    absl::Time receive_time;
+  };
+
+  BoundedQueueDispatcher(size_t capacity, Callback callback);
+
+  void Run() override;
+
+  // Entries are recycled by the queue, so their strings keep their capacity
+  // and Offer() stops allocating once they are large enough.
+  RealtimeQueue<Entry> queue_;
+  // The queue supports a single writer only, but the middleware may call
+  // Offer() from several threads.
+  absl::Mutex writer_mutex_;
+};
+
+}  // namespace intrinsic::internal
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_SUBSCRIPTION_DISPATCHER_H_
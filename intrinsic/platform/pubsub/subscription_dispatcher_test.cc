@@ -0,0 +1,165 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/subscription_dispatcher.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <pthread.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::internal {
+namespace {
+
+using ::intrinsic::testing::IsOk;
+using ::intrinsic::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+constexpr absl::Duration kTimeout = absl::Seconds(10);
+
+absl::Time ReceiveTime(int seconds) { return absl::FromUnixSeconds(seconds); }
+
+// Records delivered packets. The first delivery blocks until Unblock() is
+// called, so that tests can fill up the dispatcher deterministically.
+class Recorder {
+ public:
+  SubscriptionDispatcher::Callback callback() {
+    return [this](absl::string_view keyexpr, absl::string_view packet,
+                  absl::Time receive_time) {
+      // Only the dispatch thread invokes the callback.
+      if (!started_.HasBeenNotified()) started_.Notify();
+      unblocked_.WaitForNotification();
+      absl::MutexLock lock(&mutex_);
+      received_.emplace_back(keyexpr, packet);
+      receive_times_.push_back(receive_time);
+    };
+  }
+
+  void WaitUntilBlocked() {
+    ASSERT_TRUE(started_.WaitForNotificationWithTimeout(kTimeout));
+  }
+
+  void Unblock() { unblocked_.Notify(); }
+
+  std::vector<std::pair<std::string, std::string>> WaitForPackets(size_t n) {
+    absl::MutexLock lock(&mutex_);
+    auto has_enough = [this, n]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+      return received_.size() >= n;
+    };
+    mutex_.AwaitWithTimeout(absl::Condition(&has_enough), kTimeout);
+    return received_;
+  }
+
+  std::vector<absl::Time> receive_times() {
+    absl::MutexLock lock(&mutex_);
+    return receive_times_;
+  }
+
+ private:
+  absl::Notification started_;
+  absl::Notification unblocked_;
+  absl::Mutex mutex_;
+  std::vector<std::pair<std::string, std::string>> received_
+      ABSL_GUARDED_BY(mutex_);
+  std::vector<absl::Time> receive_times_ ABSL_GUARDED_BY(mutex_);
+};
+
+TEST(LatestValueDispatcherTest, DeliversNewestPacketPerKey) {
+  Recorder recorder;
+  absl::StatusOr<std::unique_ptr<LatestValueDispatcher>> dispatcher =
+      LatestValueDispatcher::Create(recorder.callback());
+  ASSERT_THAT(dispatcher.status(), IsOk());
+
+  (*dispatcher)->Offer("in/a", "a0", ReceiveTime(1));
+  recorder.WaitUntilBlocked();
+  (*dispatcher)->Offer("in/a", "a1", ReceiveTime(2));
+  (*dispatcher)->Offer("in/b", "b0", ReceiveTime(3));
+  (*dispatcher)->Offer("in/a", "a2", ReceiveTime(4));
+  recorder.Unblock();
+
+  EXPECT_THAT(recorder.WaitForPackets(3),
+              ElementsAre(Pair("in/a", "a0"), Pair("in/a", "a2"),
+                          Pair("in/b", "b0")));
+  EXPECT_THAT(recorder.receive_times(),
+              ElementsAre(ReceiveTime(1), ReceiveTime(4), ReceiveTime(3)));
+  EXPECT_EQ((*dispatcher)->num_dropped(), 1);
+}
+
+TEST(BoundedQueueDispatcherTest, DeliversInOrderAndDropsWhenFull) {
+  Recorder recorder;
+  absl::StatusOr<std::unique_ptr<BoundedQueueDispatcher>> dispatcher =
+      BoundedQueueDispatcher::Create(/*capacity=*/2, recorder.callback());
+  ASSERT_THAT(dispatcher.status(), IsOk());
+
+  (*dispatcher)->Offer("in/a", "0", ReceiveTime(5));
+  recorder.WaitUntilBlocked();
+  // The packet being delivered still occupies its slot.
+  (*dispatcher)->Offer("in/a", "1", ReceiveTime(6));
+  (*dispatcher)->Offer("in/a", "2", ReceiveTime(7));
+  EXPECT_EQ((*dispatcher)->num_dropped(), 1);
+  recorder.Unblock();
+
+  EXPECT_THAT(recorder.WaitForPackets(2),
+              ElementsAre(Pair("in/a", "0"), Pair("in/a", "1")));
+  EXPECT_THAT(recorder.receive_times(),
+              ElementsAre(ReceiveTime(5), ReceiveTime(6)));
+}
+
+TEST(BoundedQueueDispatcherTest, RejectsZeroCapacity) {
+  EXPECT_THAT(
+      BoundedQueueDispatcher::Create(
+          0, [](absl::string_view, absl::string_view, absl::Time) {})
+          .status(),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(LatestValueDispatcherTest, DestructionStopsDispatchThread) {
+  int num_delivered = 0;
+  {
+    absl::StatusOr<std::unique_ptr<LatestValueDispatcher>> dispatcher =
+        LatestValueDispatcher::Create(
+            [&num_delivered](absl::string_view, absl::string_view,
+                             absl::Time) {
+              ++num_delivered;
+            });
+    ASSERT_THAT(dispatcher.status(), IsOk());
+  }
+  EXPECT_EQ(num_delivered, 0);
+}
+
+TEST(BoundedQueueDispatcherTest, StartsDispatchThreadWithOptions) {
+  absl::Notification delivered;
+  std::string thread_name;
+  absl::StatusOr<std::unique_ptr<BoundedQueueDispatcher>> dispatcher =
+      BoundedQueueDispatcher::Create(
+          /*capacity=*/1,
+          [&](absl::string_view, absl::string_view, absl::Time) {
+            char name[Thread::GetMaxNameLength()] = {};
+            pthread_getname_np(pthread_self(), name, sizeof(name));
+            thread_name = name;
+            delivered.Notify();
+          },
+          Thread::Options().SetName("sensor_dispatch"));
+  ASSERT_THAT(dispatcher.status(), IsOk());
+
+  (*dispatcher)->Offer("in/a", "0", ReceiveTime(1));
+  ASSERT_TRUE(delivered.WaitForNotificationWithTimeout(kTimeout));
+  EXPECT_EQ(thread_name, "sensor_dispatch");
+}
+
+}  // namespace
+}  // namespace intrinsic::internal
@@ -0,0 +1,72 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/subscription_latency.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "intrinsic/platform/pubsub/latency_histogram.h"
+
+namespace intrinsic::internal {
+
+namespace {
+
+void AppendSummaryJson(const LatencySummary& summary, std::string* json) {
+  absl::StrAppendFormat(
+      json,
+      R"({"count": %d, "mean_us": %g, "p50_us": %g, "p90_us": %g, )"
+      R"("p99_us": %g, "max_us": %g})",
+      summary.count, absl::ToDoubleMicroseconds(summary.mean),
+      absl::ToDoubleMicroseconds(summary.p50),
+      absl::ToDoubleMicroseconds(summary.p90),
+      absl::ToDoubleMicroseconds(summary.p99),
+      absl::ToDoubleMicroseconds(summary.max));
+}
+
+}  // namespace
+
+void SubscriptionLatencyRegistry::Register(
+    absl::string_view topic, std::weak_ptr<const SubscriptionLatency> latency) {
+  absl::MutexLock lock(&mu_);
+  PruneLocked();
+  entries_.emplace_back(std::string(topic), std::move(latency));
+}
+
+std::string SubscriptionLatencyRegistry::ToJson() {
+  absl::MutexLock lock(&mu_);
+  PruneLocked();
+  std::string json = R"({"subscriptions": [)";
+  bool first = true;
+  for (const auto& [topic, weak_latency] : entries_) {
+    std::shared_ptr<const SubscriptionLatency> latency = weak_latency.lock();
+    if (latency == nullptr) continue;
+    // Topic names are valid key expressions, which contain neither quotes nor
+    // backslashes, so they need no escaping.
+    absl::StrAppend(&json, first ? "" : ", ", R"({"topic": ")", topic,
+                    R"(", "publish_to_receive": )");
+    AppendSummaryJson(latency->publish_to_receive.Summarize(), &json);
+    absl::StrAppend(&json, R"(, "receive_to_callback_complete": )");
+    AppendSummaryJson(latency->receive_to_callback_complete.Summarize(), &json);
+    json.append("}");
+    first = false;
+  }
+  json.append("]}");
+  return json;
+}
+
+void SubscriptionLatencyRegistry::PruneLocked() {
+  entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                [](const auto& entry) {
+                                  return entry.second.expired();
+                                }),
+                 entries_.end());
+}
+
+}  // namespace intrinsic::internal
@@ -0,0 +1,73 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_SUBSCRIPTION_LATENCY_H_
+#define INTRINSIC_PLATFORM_PUBSUB_SUBSCRIPTION_LATENCY_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "intrinsic/platform/pubsub/latency_histogram.h"
+
+namespace intrinsic::internal {
+
+// Topic on which PubSub::PublishLatencyIntrospection() publishes the
+// latencies of all subscriptions of the process, without the topic prefix.
+inline constexpr absl::string_view kLatencyIntrospectionTopic =
+    "_introspection/pubsub_latency";
+
+// Latencies of the packets received by a subscription with
+// TopicConfig::record_latency.
+struct SubscriptionLatency {
+  // From the publish time stamped into the packet by the publisher until the
+  // middleware handed the packet to the subscription. Includes the clock offset
+  // between the hosts of publisher and subscriber.
+  LatencyHistogram publish_to_receive;
+  // From the middleware handing the packet to the subscription until the
+  // callback of the subscription returned. Includes the time the packet waited
+  // for a dispatch thread.
+  LatencyHistogram receive_to_callback_complete;
+};
+
+// The latencies of all subscriptions of the process that record them.
+//
+// This class is thread-safe.
+class SubscriptionLatencyRegistry {
+ public:
+  // Adds the latencies of a subscription to `topic`. The registry does not
+  // keep `latency` alive; it is dropped once the subscription is destroyed.
+  void Register(absl::string_view topic,
+                std::weak_ptr<const SubscriptionLatency> latency);
+
+  // Returns the latencies of all live subscriptions as a JSON object of the
+  // form
+  //
+  //   {"subscriptions": [{"topic": "/a",
+  //                       "publish_to_receive": {"count": 3, "mean_us": 1.5,
+  //                                              "p50_us": 1, "p90_us": 2,
+  //                                              "p99_us": 2, "max_us": 2},
+  //                       "receive_to_callback_complete": {...}}, ...]}
+  std::string ToJson();
+
+  static SubscriptionLatencyRegistry& Singleton() {
+    static SubscriptionLatencyRegistry* registry =
+        new SubscriptionLatencyRegistry;
+    return *registry;
+  }
+
+ private:
+  // Removes the entries of destroyed subscriptions.
+  void PruneLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  absl::Mutex mu_;
+  std::vector<std::pair<std::string, std::weak_ptr<const SubscriptionLatency>>>
+      entries_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace intrinsic::internal
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_SUBSCRIPTION_LATENCY_H_
@@ -0,0 +1,41 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/subscription_latency.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "absl/time/time.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::internal {
+namespace {
+
+TEST(SubscriptionLatencyRegistryTest, ReportsLiveSubscriptionsAsJson) {
+  SubscriptionLatencyRegistry registry;
+  EXPECT_EQ(registry.ToJson(), R"({"subscriptions": []})");
+
+  auto latency = std::make_shared<SubscriptionLatency>();
+  latency->publish_to_receive.Record(absl::Microseconds(2));
+  latency->receive_to_callback_complete.Record(absl::Microseconds(1));
+  registry.Register("/a", latency);
+  {
+    auto destroyed = std::make_shared<SubscriptionLatency>();
+    registry.Register("/b", destroyed);
+  }
+
+  EXPECT_EQ(registry.ToJson(),
+            R"({"subscriptions": [{"topic": "/a", "publish_to_receive": )"
+            R"({"count": 1, "mean_us": 2, "p50_us": 2, "p90_us": 2, )"
+            R"("p99_us": 2, "max_us": 2}, "receive_to_callback_complete": )"
+            R"({"count": 1, "mean_us": 1, "p50_us": 1, "p90_us": 1, )"
+            R"("p99_us": 1, "max_us": 1}}]})");
+
+  latency.reset();
+  EXPECT_EQ(registry.ToJson(), R"({"subscriptions": []})");
+}
+
+}  // namespace
+}  // namespace intrinsic::internal
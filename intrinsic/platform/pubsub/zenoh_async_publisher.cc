@@ -0,0 +1,219 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/zenoh_async_publisher.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/timestamp.pb.h"
+#include "intrinsic/platform/pubsub/payload_compression.h"
+#include "intrinsic/platform/pubsub/pubsub_packet_encoder.h"
+#include "intrinsic/platform/pubsub/shared_memory_ring.h"
+#include "intrinsic/platform/pubsub/zenoh_publisher_data.h"
+#include "intrinsic/platform/pubsub/zenoh_util/zenoh_handle.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic::internal {
+
+namespace {
+
+// Upper bound for how long the I/O thread sleeps without checking whether it
+// was stopped.
+constexpr absl::Duration kWakeupInterval = absl::Milliseconds(100);
+
+absl::Status QueueFullError() {
+  return absl::ResourceExhaustedError(
+      "Asynchronous publish queue is full, message dropped");
+}
+
+// Copies `packet` into the shared memory ring of the publisher and publishes
+// its descriptor. Returns false if the packet does not fit into the ring.
+bool SendViaSharedMemory(const PublisherData& publisher_data,
+                         absl::string_view packet, imw_ret_t* ret) {
+  SharedMemoryRing& ring = *publisher_data.shared_memory_ring;
+  if (packet.size() > ring.slot_size()) return false;
+  absl::StatusOr<SharedMemoryRing::Reservation> reservation = ring.Reserve();
+  if (!reservation.ok()) return false;
+  std::memcpy(reservation->data, packet.data(), packet.size());
+  char descriptor[SharedMemoryRing::kDescriptorSize];
+  SharedMemoryRing::EncodeDescriptor(
+      ring.Commit(*reservation, packet.size()), descriptor);
+  *ret = Zenoh().imw_publish(publisher_data.prefixed_name.c_str(), descriptor,
+                             sizeof(descriptor));
+  return true;
+}
+
+}  // namespace
+
+AsyncPublishQueue::AsyncPublishQueue(const PublisherData* publisher_data,
+                                     size_t capacity, bool coalesce)
+    : publisher_data_(publisher_data),
+      coalesce_(coalesce),
+      // The queue is unused in coalescing mode.
+      queue_(coalesce ? 1 : std::max<size_t>(capacity, 1)) {}
+
+absl::Status AsyncPublishQueue::Push(
+    const google::protobuf::Message& message, absl::Time publish_time,
+    const google::protobuf::Timestamp& publish_time_proto) {
+  absl::Status status =
+      coalesce_ ? PushCoalesced(message, publish_time, publish_time_proto)
+                : PushQueued(message, publish_time, publish_time_proto);
+  if (status.ok()) {
+    num_enqueued_.fetch_add(1, std::memory_order_relaxed);
+  } else if (absl::IsResourceExhausted(status)) {
+    num_dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return status;
+}
+
+absl::Status AsyncPublishQueue::PushQueued(
+    const google::protobuf::Message& message, absl::Time publish_time,
+    const google::protobuf::Timestamp& publish_time_proto) {
+  // Another thread publishing asynchronously on the same topic at the same
+  // time is treated like a full queue, so that Push() never blocks.
+  if (!writer_mutex_.TryLock()) return QueueFullError();
+  Packet* packet = queue_.writer()->PrepareInsert();
+  if (packet == nullptr) {
+    writer_mutex_.Unlock();
+    return QueueFullError();
+  }
+  packet->data.clear();
+  absl::Status status =
+      AppendPubSubPacket(message, publish_time_proto, &packet->data).status();
+  if (!status.ok()) {
+    // A prepared slot must be inserted. Empty packets are skipped by Drain().
+    packet->data.clear();
+  }
+  packet->publish_time = publish_time;
+  queue_.writer()->FinishInsert();
+  writer_mutex_.Unlock();
+  return status;
+}
+
+absl::Status AsyncPublishQueue::PushCoalesced(
+    const google::protobuf::Message& message, absl::Time publish_time,
+    const google::protobuf::Timestamp& publish_time_proto) {
+  // The I/O thread only holds the lock to swap out the pending packet.
+  if (!latest_mutex_.TryLock()) return QueueFullError();
+  latest_.data.clear();
+  absl::Status status =
+      AppendPubSubPacket(message, publish_time_proto, &latest_.data).status();
+  if (status.ok()) {
+    if (latest_pending_) {
+      num_coalesced_.fetch_add(1, std::memory_order_relaxed);
+    }
+    latest_.publish_time = publish_time;
+    latest_pending_ = true;
+  } else {
+    // The previous packet was overwritten.
+    latest_pending_ = false;
+  }
+  latest_mutex_.Unlock();
+  return status;
+}
+
+void AsyncPublishQueue::Drain() {
+  if (coalesce_) {
+    {
+      absl::MutexLock lock(&latest_mutex_);
+      if (!latest_pending_) return;
+      // Swapping keeps the capacity of both buffers, so that neither side
+      // needs to allocate for packets of similar size.
+      std::swap(latest_, sending_);
+      latest_pending_ = false;
+    }
+    Send(sending_);
+    return;
+  }
+  RealtimeQueue<Packet>::Reader* reader = queue_.reader();
+  while (const Packet* packet = reader->Front()) {
+    if (!packet->data.empty()) Send(*packet);
+    reader->DropFront();
+  }
+}
+
+void AsyncPublishQueue::Send(const Packet& packet) {
+  imw_ret_t ret = IMW_OK;
+  absl::string_view sent = packet.data;
+  if (publisher_data_->shared_memory_ring == nullptr ||
+      !SendViaSharedMemory(*publisher_data_, packet.data, &ret)) {
+    // Compresses here rather than in Push(), so that the publishing thread
+    // does not pay for it.
+    absl::StatusOr<absl::string_view> compressed =
+        CompressPubSubPacket(packet.data, publisher_data_->compression,
+                             &compressed_);
+    if (compressed.ok()) {
+      sent = *compressed;
+    } else {
+      LOG_EVERY_N(ERROR, 100) << "Sending packet on "
+                              << publisher_data_->prefixed_name
+                              << " uncompressed: " << compressed.status();
+    }
+    ret = Zenoh().imw_publish(publisher_data_->prefixed_name.c_str(),
+                              sent.data(), sent.size());
+  }
+  publisher_data_->stats->RecordPublish(sent.size(), packet.publish_time);
+  if (ret != IMW_OK) {
+    num_failed_.fetch_add(1, std::memory_order_relaxed);
+    LOG_EVERY_N(ERROR, 100) << "Error publishing message asynchronously on "
+                            << publisher_data_->prefixed_name;
+  }
+}
+
+AsyncPublishThread::~AsyncPublishThread() { Stop(); }
+
+absl::Status AsyncPublishThread::Register(
+    std::shared_ptr<AsyncPublishQueue> queue) {
+  absl::MutexLock lock(&mutex_);
+  if (!started_ && !stop_.load(std::memory_order_acquire)) {
+    INTR_RETURN_IF_ERROR(thread_.Start(
+        Thread::Options().SetName("pubsub_async_io"), [this]() { Run(); }));
+    started_ = true;
+  }
+  queues_.push_back(std::move(queue));
+  return absl::OkStatus();
+}
+
+void AsyncPublishThread::Unregister(const AsyncPublishQueue* queue) {
+  absl::MutexLock lock(&mutex_);
+  queues_.erase(std::remove_if(queues_.begin(), queues_.end(),
+                               [queue](const auto& registered) {
+                                 return registered.get() == queue;
+                               }),
+                queues_.end());
+}
+
+void AsyncPublishThread::Stop() {
+  stop_.store(true, std::memory_order_release);
+  Notify();
+  if (thread_.Joinable()) {
+    thread_.Join();
+  }
+}
+
+void AsyncPublishThread::Run() {
+  bool stopping = false;
+  while (!stopping) {
+    (void)wakeup_.WaitFor(kWakeupInterval);
+    // Drain once more after being stopped, so that packets published before
+    // Stop() are not lost.
+    stopping = stop_.load(std::memory_order_acquire);
+    absl::MutexLock lock(&mutex_);
+    for (const std::shared_ptr<AsyncPublishQueue>& queue : queues_) {
+      queue->Drain();
+    }
+  }
+}
+
+}  // namespace intrinsic::internal
@@ -0,0 +1,158 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_ZENOH_ASYNC_PUBLISHER_H_
+#define INTRINSIC_PLATFORM_PUBSUB_ZENOH_ASYNC_PUBLISHER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/timestamp.pb.h"
+#include "intrinsic/icon/interprocess/binary_futex.h"
+#include "intrinsic/platform/common/buffers/rt_queue.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+
+struct PublisherData;
+
+namespace internal {
+
+// Packets that were published with Publisher::PublishAsync() and not yet sent
+// by the AsyncPublishThread.
+//
+// The caller of Push() encodes the packet directly into a preallocated slot,
+// so pushing does not allocate once the slots have grown to the size of the
+// largest packet, and it never blocks: if the slot cannot be claimed
+// immediately, the packet is dropped.
+//
+// In coalescing mode, there is a single slot and a new packet replaces a
+// packet that was not sent yet.
+//
+// This class is thread-safe.
+class AsyncPublishQueue {
+ public:
+  // `publisher_data` must outlive the queue.
+  AsyncPublishQueue(const PublisherData* publisher_data, size_t capacity,
+                    bool coalesce);
+
+  AsyncPublishQueue(const AsyncPublishQueue&) = delete;
+  AsyncPublishQueue& operator=(const AsyncPublishQueue&) = delete;
+
+  // Encodes `message` for sending. Returns a ResourceExhausted error if the
+  // packet was dropped because the queue is full or is being written
+  // concurrently by another thread.
+  absl::Status Push(const google::protobuf::Message& message,
+                    absl::Time publish_time,
+                    const google::protobuf::Timestamp& publish_time_proto);
+
+  // Sends all packets that were pushed so far. Only called by the
+  // AsyncPublishThread.
+  void Drain();
+
+  // Number of packets that were accepted by Push().
+  uint64_t num_enqueued() const {
+    return num_enqueued_.load(std::memory_order_relaxed);
+  }
+  // Number of packets that were replaced by a newer packet in coalescing mode.
+  uint64_t num_coalesced() const {
+    return num_coalesced_.load(std::memory_order_relaxed);
+  }
+  // Number of packets that were rejected by Push().
+  uint64_t num_dropped() const {
+    return num_dropped_.load(std::memory_order_relaxed);
+  }
+  // Number of packets that the middleware failed to send.
+  uint64_t num_failed() const {
+    return num_failed_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Packet {
+    std::string data;
+    absl::Time publish_time;
+  };
+
+  absl::Status PushQueued(const google::protobuf::Message& message,
+                          absl::Time publish_time,
+                          const google::protobuf::Timestamp& publish_time_proto);
+  absl::Status PushCoalesced(
+      const google::protobuf::Message& message, absl::Time publish_time,
+      const google::protobuf::Timestamp& publish_time_proto);
+  void Send(const Packet& packet);
+
+  const PublisherData* const publisher_data_;
+  const bool coalesce_;
+
+  // Queued mode. The queue supports a single writer only, so writers must hold
+  // `writer_mutex_`.
+  RealtimeQueue<Packet> queue_;
+  absl::Mutex writer_mutex_;
+
+  // Coalescing mode.
+  absl::Mutex latest_mutex_;
+  Packet latest_ ABSL_GUARDED_BY(latest_mutex_);
+  bool latest_pending_ ABSL_GUARDED_BY(latest_mutex_) = false;
+  // Only used by Drain().
+  Packet sending_;
+  std::string compressed_;
+
+  std::atomic<uint64_t> num_enqueued_ = 0;
+  std::atomic<uint64_t> num_coalesced_ = 0;
+  std::atomic<uint64_t> num_dropped_ = 0;
+  std::atomic<uint64_t> num_failed_ = 0;
+};
+
+// The I/O thread of a PubSub instance that sends the packets of all
+// AsyncPublishQueues. The thread is started when the first queue is
+// registered.
+//
+// This class is thread-safe.
+class AsyncPublishThread {
+ public:
+  AsyncPublishThread() = default;
+  AsyncPublishThread(const AsyncPublishThread&) = delete;
+  AsyncPublishThread& operator=(const AsyncPublishThread&) = delete;
+  ~AsyncPublishThread();
+
+  // Starts draining `queue`.
+  absl::Status Register(std::shared_ptr<AsyncPublishQueue> queue);
+
+  // Stops draining `queue`. When this returns, the thread does not access
+  // `queue` anymore.
+  void Unregister(const AsyncPublishQueue* queue);
+
+  // Wakes up the thread to drain the queues. Does not block.
+  void Notify() { (void)wakeup_.Post(); }
+
+  // Sends the remaining packets and stops the thread. Queues that are
+  // registered afterwards are not drained.
+  void Stop();
+
+ private:
+  void Run();
+
+  icon::BinaryFutex wakeup_;
+  std::atomic<bool> stop_ = false;
+
+  // Held while the queues are drained, so that Unregister() can wait for the
+  // thread to finish using a queue.
+  absl::Mutex mutex_;
+  std::vector<std::shared_ptr<AsyncPublishQueue>> queues_
+      ABSL_GUARDED_BY(mutex_);
+  bool started_ ABSL_GUARDED_BY(mutex_) = false;
+  Thread thread_;
+};
+
+}  // namespace internal
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_ZENOH_ASYNC_PUBLISHER_H_
@@ -0,0 +1,68 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/zenoh_async_publisher.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "google/protobuf/timestamp.pb.h"
+#include "google/protobuf/wrappers.pb.h"
+#include "intrinsic/platform/pubsub/zenoh_publisher_data.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::internal {
+namespace {
+
+using ::intrinsic::testing::IsOk;
+using ::intrinsic::testing::StatusIs;
+
+// These tests only cover the caller side of the queue; sending requires a
+// middleware session.
+class AsyncPublishQueueTest : public ::testing::Test {
+ protected:
+  absl::Status Push(AsyncPublishQueue& queue) {
+    google::protobuf::Int32Value message;
+    message.set_value(42);
+    return queue.Push(message, absl::Now(), google::protobuf::Timestamp());
+  }
+
+  PublisherData publisher_data_;
+};
+
+TEST_F(AsyncPublishQueueTest, DropsWhenQueueIsFull) {
+  AsyncPublishQueue queue(&publisher_data_, /*capacity=*/2,
+                          /*coalesce=*/false);
+
+  EXPECT_THAT(Push(queue), IsOk());
+  EXPECT_THAT(Push(queue), IsOk());
+  EXPECT_THAT(Push(queue), StatusIs(absl::StatusCode::kResourceExhausted));
+
+  EXPECT_EQ(queue.num_enqueued(), 2);
+  EXPECT_EQ(queue.num_dropped(), 1);
+  EXPECT_EQ(queue.num_coalesced(), 0);
+}
+
+TEST_F(AsyncPublishQueueTest, CoalescesPendingPackets) {
+  AsyncPublishQueue queue(&publisher_data_, /*capacity=*/2,
+                          /*coalesce=*/true);
+
+  EXPECT_THAT(Push(queue), IsOk());
+  EXPECT_THAT(Push(queue), IsOk());
+  EXPECT_THAT(Push(queue), IsOk());
+
+  EXPECT_EQ(queue.num_enqueued(), 3);
+  EXPECT_EQ(queue.num_coalesced(), 2);
+  EXPECT_EQ(queue.num_dropped(), 0);
+}
+
+TEST(AsyncPublishThreadTest, StopsWithoutQueues) {
+  AsyncPublishThread thread;
+  thread.Notify();
+  thread.Stop();
+}
+
+}  // namespace
+}  // namespace intrinsic::internal
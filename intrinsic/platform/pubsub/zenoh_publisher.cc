@@ -1,31 +1,143 @@
 // Copyright 2023 Intrinsic Innovation LLC
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
 
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
-#include "google/protobuf/any.pb.h"
+#include "absl/types/span.h"
 #include "google/protobuf/message.h"
-#include "intrinsic/platform/pubsub/adapters/pubsub.pb.h"
+#include "google/protobuf/timestamp.pb.h"
+#include "intrinsic/icon/utils/trace_event.h"
+#include "intrinsic/platform/pubsub/payload_compression.h"
 #include "intrinsic/platform/pubsub/publisher.h"
 #include "intrinsic/platform/pubsub/publisher_stats.h"
+#include "intrinsic/platform/pubsub/pubsub_allocation_tag.h"
+#include "intrinsic/platform/pubsub/pubsub_packet_encoder.h"
+#include "intrinsic/platform/pubsub/pubsub_packet_view.h"
+#include "intrinsic/platform/pubsub/scoped_thread_buffer.h"
+#include "intrinsic/platform/pubsub/shared_memory_ring.h"
+#include "intrinsic/platform/pubsub/zenoh_async_publisher.h"
 #include "intrinsic/platform/pubsub/zenoh_publisher_data.h"
 #include "intrinsic/platform/pubsub/zenoh_util/zenoh_handle.h"
+#include "intrinsic/util/allocation_tracking.h"
 #include "intrinsic/util/proto_time.h"
 #include "intrinsic/util/status/status_macros.h"
 #include "opencensus/stats/stats.h"
 
 namespace intrinsic {
 
+namespace {
+
+// Buffers for encoding packets and for compressing them, which are reused by
+// all publishers on this thread.
+struct PacketTag {};
+struct CompressedPacketTag {};
+using ScopedPacketBuffer = internal::ScopedThreadBuffer<PacketTag>;
+using ScopedCompressedPacketBuffer =
+    internal::ScopedThreadBuffer<CompressedPacketTag>;
+
+// Encodes a packet into the memory returned by `allocate`, see
+// internal::EncodePubSubPacket().
+using PacketEncoder = absl::FunctionRef<absl::StatusOr<size_t>(
+    absl::FunctionRef<char*(size_t size)> allocate)>;
+
+// Encodes the packet directly into the next slot of the shared memory ring of
+// the publisher and publishes the descriptor of the slot. Returns false if the
+// packet could not be written to shared memory and needs to be sent inline
+// instead.
+absl::StatusOr<bool> PublishToSharedMemory(const PublisherData& publisher_data,
+                                           PacketEncoder encode,
+                                           absl::Time publish_time) {
+  internal::SharedMemoryRing& ring = *publisher_data.shared_memory_ring;
+  absl::StatusOr<internal::SharedMemoryRing::Reservation> reservation =
+      ring.Reserve();
+  if (!reservation.ok()) return false;
+  absl::StatusOr<size_t> packet_size = encode([&](size_t size) -> char* {
+    return size <= ring.slot_size() ? reservation->data : nullptr;
+  });
+  if (!packet_size.ok()) {
+    ring.Abort(*reservation);
+    if (absl::IsResourceExhausted(packet_size.status())) return false;
+    return packet_size.status();
+  }
+
+  char descriptor[internal::SharedMemoryRing::kDescriptorSize];
+  internal::SharedMemoryRing::EncodeDescriptor(
+      ring.Commit(*reservation, *packet_size), descriptor);
+  imw_ret_t ret = Zenoh().imw_publish(publisher_data.prefixed_name.c_str(),
+                                      descriptor, sizeof(descriptor));
+
+  publisher_data.stats->RecordPublish(*packet_size, publish_time);
+
+  if (ret != IMW_OK) {
+    return absl::InternalError("Error publishing message");
+  }
+  return true;
+}
+
+// Publishes the packet produced by `encode`, via shared memory if the
+// publisher has a shared memory ring and the packet fits into it.
+absl::Status PublishPacket(const PublisherData& publisher_data,
+                           PacketEncoder encode, absl::Time publish_time) {
+  INTRINSIC_TRACE_SCOPE("pubsub", "Publish");
+  ScopedAllocationTag allocation_tag(internal::kPubSubAllocationTag);
+  if (publisher_data.shared_memory_ring != nullptr) {
+    absl::StatusOr<bool> published =
+        PublishToSharedMemory(publisher_data, encode, publish_time);
+    if (!published.ok() || *published) return published.status();
+    // The packet does not fit into shared memory. Fall through to sending it
+    // inline.
+  }
+
+  ScopedPacketBuffer buffer;
+  INTR_ASSIGN_OR_RETURN(size_t packet_size, encode([&buffer](size_t size) {
+                          buffer.get()->resize(size);
+                          return buffer.get()->data();
+                        }));
+  ScopedCompressedPacketBuffer compressed_buffer;
+  INTR_ASSIGN_OR_RETURN(
+      absl::string_view packet,
+      internal::CompressPubSubPacket(
+          absl::string_view(buffer.get()->data(), packet_size),
+          publisher_data.compression, compressed_buffer.get()));
+
+  imw_ret_t ret = Zenoh().imw_publish(publisher_data.prefixed_name.c_str(),
+                                      packet.data(), packet.size());
+
+  publisher_data.stats->RecordPublish(packet.size(), publish_time);
+
+  if (ret != IMW_OK) {
+    return absl::InternalError("Error publishing message");
+  }
+  return absl::OkStatus();
+}
+
+// Stops asynchronous publishing and destroys the middleware publisher.
+void DestroyPublisher(PublisherData& publisher_data) {
+  if (publisher_data.async_queue != nullptr) {
+    publisher_data.async_thread->Unregister(publisher_data.async_queue.get());
+  }
+  if (!publisher_data.prefixed_name.empty()) {
+    Zenoh().imw_destroy_publisher(publisher_data.prefixed_name.c_str());
+  }
+}
+
+}  // namespace
+
 Publisher::Publisher(Publisher&&) = default;
 
 Publisher& Publisher::operator=(Publisher&& other) {
-  if (publisher_data_ && !publisher_data_->prefixed_name.empty()) {
-    Zenoh().imw_destroy_publisher(publisher_data_->prefixed_name.c_str());
+  if (publisher_data_) {
+    DestroyPublisher(*publisher_data_);
   }
   topic_name_ = std::move(other.topic_name_);
   publisher_data_ = std::move(other.publisher_data_);
@@ -37,32 +149,100 @@ Publisher::Publisher(absl::string_view topic_name,
     : topic_name_(topic_name), publisher_data_(std::move(publisher_data)) {}
 
 Publisher::~Publisher() {
-  if (publisher_data_ && !publisher_data_->prefixed_name.empty()) {
-    Zenoh().imw_destroy_publisher(publisher_data_->prefixed_name.c_str());
+  if (publisher_data_) {
+    DestroyPublisher(*publisher_data_);
   }
 }
 
 absl::Status Publisher::Publish(const google::protobuf::Message& message,
                                 absl::Time event_time) const {
-  intrinsic_proto::pubsub::PubSubPacket wrapper;
-  wrapper.mutable_payload()->PackFrom(message);
   // When the pubsub message was sent out.
   absl::Time publish_time = absl::Now();
-  INTR_ASSIGN_OR_RETURN(*wrapper.mutable_publish_time(), ToProto(publish_time));
+  google::protobuf::Timestamp publish_time_proto;
+  ToProtoUnchecked(publish_time, &publish_time_proto);
   if (event_time > publish_time) {
     return absl::InvalidArgumentError("event_time should not be in the future");
   }
 
-  imw_ret_t ret = Zenoh().imw_publish(publisher_data_->prefixed_name.c_str(),
-                                      wrapper.SerializeAsString().c_str(),
-                                      wrapper.ByteSizeLong());
+  return PublishPacket(
+      *publisher_data_,
+      [&](absl::FunctionRef<char*(size_t size)> allocate) {
+        return internal::EncodePubSubPacket(message, publish_time_proto,
+                                            allocate);
+      },
+      publish_time);
+}
 
-  intrinsic::internal::PublisherStats::Singleton().Increment(topic_name_);
+absl::Status Publisher::PublishFlatbuffer(absl::string_view root_type,
+                                          absl::Span<const uint8_t> flatbuffer,
+                                          absl::Time event_time) const {
+  absl::Time publish_time = absl::Now();
+  google::protobuf::Timestamp publish_time_proto;
+  ToProtoUnchecked(publish_time, &publish_time_proto);
+  if (event_time > publish_time) {
+    return absl::InvalidArgumentError("event_time should not be in the future");
+  }
+  if (root_type.empty()) {
+    return absl::InvalidArgumentError("root_type must not be empty");
+  }
 
-  if (ret != IMW_OK) {
-    return absl::InternalError("Error publishing message");
+  const absl::string_view bytes(reinterpret_cast<const char*>(flatbuffer.data()),
+                                flatbuffer.size());
+  return PublishPacket(
+      *publisher_data_,
+      [&](absl::FunctionRef<char*(size_t size)> allocate) {
+        return internal::EncodeFlatbufferPubSubPacket(
+            root_type, bytes, publish_time_proto, allocate);
+      },
+      publish_time);
+}
+
+absl::Status Publisher::PublishSerializedPacket(
+    absl::string_view packet) const {
+  INTR_RETURN_IF_ERROR(internal::PubSubPacketView::Parse(packet).status());
+  return PublishPacket(
+      *publisher_data_,
+      [&](absl::FunctionRef<char*(size_t size)> allocate)
+          -> absl::StatusOr<size_t> {
+        char* data = allocate(packet.size());
+        if (data == nullptr) {
+          return absl::ResourceExhaustedError("No space for the packet");
+        }
+        std::memcpy(data, packet.data(), packet.size());
+        return packet.size();
+      },
+      absl::Now());
+}
+
+absl::Status Publisher::PublishAsync(const google::protobuf::Message& message,
+                                     absl::Time event_time) const {
+  if (publisher_data_->async_queue == nullptr) {
+    return absl::FailedPreconditionError(
+        "Asynchronous publishing is not enabled for this publisher");
   }
+  absl::Time publish_time = absl::Now();
+  google::protobuf::Timestamp publish_time_proto;
+  ToProtoUnchecked(publish_time, &publish_time_proto);
+  if (event_time > publish_time) {
+    return absl::InvalidArgumentError("event_time should not be in the future");
+  }
+  INTR_RETURN_IF_ERROR(publisher_data_->async_queue->Push(
+      message, publish_time, publish_time_proto));
+  publisher_data_->async_thread->Notify();
   return absl::OkStatus();
 }
 
+AsyncPublishStats Publisher::GetAsyncPublishStats() const {
+  if (publisher_data_ == nullptr || publisher_data_->async_queue == nullptr) {
+    return {};
+  }
+  const internal::AsyncPublishQueue& queue = *publisher_data_->async_queue;
+  return {
+      .enqueued = queue.num_enqueued(),
+      .coalesced = queue.num_coalesced(),
+      .dropped = queue.num_dropped(),
+      .failed = queue.num_failed(),
+  };
+}
+
 }  // namespace intrinsic
@@ -3,12 +3,33 @@
 #ifndef INTRINSIC_PLATFORM_PUBSUB_ZENOH_PUBLISHER_DATA_H_
 #define INTRINSIC_PLATFORM_PUBSUB_ZENOH_PUBLISHER_DATA_H_
 
+#include <memory>
 #include <string>
 
+#include "intrinsic/platform/pubsub/payload_compression.h"
+#include "intrinsic/platform/pubsub/publisher_stats.h"
+#include "intrinsic/platform/pubsub/shared_memory_ring.h"
+
 namespace intrinsic {
 
+namespace internal {
+class AsyncPublishQueue;
+class AsyncPublishThread;
+}  // namespace internal
+
 struct PublisherData {
   std::string prefixed_name;
+  // Statistics of the topic, owned by internal::PublisherStats::Singleton().
+  internal::TopicPublishCounters* stats = nullptr;
+  // Set for topics with the SameHostSharedMemory transport.
+  std::unique_ptr<internal::SharedMemoryRing> shared_memory_ring;
+  // Applies to packets that are sent through the middleware.
+  internal::PayloadCompressionOptions compression;
+  // Set for topics that enable Publisher::PublishAsync(). The queue is
+  // registered with the I/O thread of the PubSub instance for the lifetime of
+  // the publisher.
+  std::shared_ptr<internal::AsyncPublishQueue> async_queue;
+  std::shared_ptr<internal::AsyncPublishThread> async_thread;
 };
 
 }  // namespace intrinsic
@@ -0,0 +1,100 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/timestamp.pb.h"
+#include "intrinsic/platform/pubsub/payload_compression.h"
+#include "intrinsic/platform/pubsub/publisher.h"
+#include "intrinsic/platform/pubsub/publisher_group.h"
+#include "intrinsic/platform/pubsub/pubsub_packet_encoder.h"
+#include "intrinsic/platform/pubsub/zenoh_publisher_data.h"
+#include "intrinsic/platform/pubsub/zenoh_util/zenoh_handle.h"
+#include "intrinsic/util/proto_time.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic {
+
+PublisherGroup::PublisherGroup(std::vector<Publisher> publishers)
+    : publishers_(std::move(publishers)) {
+  packet_ends_.reserve(publishers_.size());
+}
+
+absl::Status PublisherGroup::Publish(
+    absl::Span<const google::protobuf::Message* const> messages,
+    absl::Time event_time) {
+  if (messages.size() != publishers_.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected ", publishers_.size(), " messages but got ",
+                     messages.size()));
+  }
+  // When the pubsub messages were sent out.
+  absl::Time publish_time = absl::Now();
+  google::protobuf::Timestamp publish_time_proto;
+  ToProtoUnchecked(publish_time, &publish_time_proto);
+  if (event_time > publish_time) {
+    return absl::InvalidArgumentError("event_time should not be in the future");
+  }
+
+  // Encode all packets first so that the middleware calls below are not
+  // interleaved with serialization.
+  buffer_.clear();
+  packet_ends_.clear();
+  for (size_t i = 0; i < messages.size(); ++i) {
+    if (messages[i] != nullptr) {
+      const size_t packet_begin = buffer_.size();
+      INTR_ASSIGN_OR_RETURN(size_t packet_size,
+                            internal::AppendPubSubPacket(
+                                *messages[i], publish_time_proto, &buffer_));
+      INTR_ASSIGN_OR_RETURN(
+          absl::string_view packet,
+          internal::CompressPubSubPacket(
+              absl::string_view(buffer_).substr(packet_begin, packet_size),
+              publishers_[i].publisher_data_->compression,
+              &compressed_buffer_));
+      if (packet.data() != buffer_.data() + packet_begin) {
+        buffer_.resize(packet_begin);
+        buffer_.append(packet.data(), packet.size());
+      }
+    }
+    packet_ends_.push_back(buffer_.size());
+  }
+
+  size_t packet_begin = 0;
+  int num_published = 0;
+  int num_failed = 0;
+  for (size_t i = 0; i < publishers_.size(); ++i) {
+    const size_t packet_end = packet_ends_[i];
+    if (packet_end == packet_begin) continue;  // No message for this topic.
+    const Publisher& publisher = publishers_[i];
+    imw_ret_t ret =
+        Zenoh().imw_publish(publisher.publisher_data_->prefixed_name.c_str(),
+                            buffer_.data() + packet_begin,
+                            packet_end - packet_begin);
+    publisher.publisher_data_->stats->RecordPublish(packet_end - packet_begin,
+                                                    publish_time);
+    packet_begin = packet_end;
+    ++num_published;
+    if (ret != IMW_OK) {
+      ++num_failed;
+    }
+  }
+
+  if (num_failed > 0) {
+    return absl::InternalError(
+        absl::StrCat("Error publishing ", num_failed, " of ",
+                     num_published, " messages"));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace intrinsic
@@ -1,34 +1,283 @@
 // Copyright 2023 Intrinsic Innovation LLC
 
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/algorithm/container.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
-#include "absl/strings/match.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/timestamp.pb.h"
+#include "google/rpc/status.pb.h"
 #include "intrinsic/platform/pubsub/adapters/pubsub.pb.h"
+#include "intrinsic/platform/pubsub/keyexpr_topic_cache.h"
+#include "intrinsic/platform/pubsub/payload_compression.h"
 #include "intrinsic/platform/pubsub/publisher.h"
+#include "intrinsic/platform/pubsub/publisher_group.h"
+#include "intrinsic/platform/pubsub/publisher_stats.h"
 #include "intrinsic/platform/pubsub/pubsub.h"
+#include "intrinsic/platform/pubsub/pubsub_allocation_tag.h"
+#include "intrinsic/platform/pubsub/pubsub_packet_encoder.h"
+#include "intrinsic/platform/pubsub/pubsub_packet_view.h"
+#include "intrinsic/platform/pubsub/query_reply_collector.h"
+#include "intrinsic/platform/pubsub/queryable.h"
+#include "intrinsic/platform/pubsub/scoped_thread_buffer.h"
+#include "intrinsic/platform/pubsub/shared_memory_ring.h"
 #include "intrinsic/platform/pubsub/subscription.h"
+#include "intrinsic/platform/pubsub/subscription_dispatcher.h"
+#include "intrinsic/platform/pubsub/subscription_latency.h"
+#include "intrinsic/platform/pubsub/zenoh_async_publisher.h"
 #include "intrinsic/platform/pubsub/zenoh_publisher_data.h"
 #include "intrinsic/platform/pubsub/zenoh_pubsub_data.h"
+#include "intrinsic/platform/pubsub/zenoh_queryable_data.h"
 #include "intrinsic/platform/pubsub/zenoh_subscription_data.h"
 #include "intrinsic/platform/pubsub/zenoh_util/zenoh_config.h"
 #include "intrinsic/platform/pubsub/zenoh_util/zenoh_handle.h"
+#include "intrinsic/platform/pubsub/zenoh_util/zenoh_session.h"
+#include "intrinsic/util/allocation_tracking.h"
+#include "intrinsic/util/proto_time.h"
+#include "intrinsic/util/status/status_conversion_rpc.h"
 #include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
 
 namespace intrinsic {
 
-constexpr char kIntrospectionTopicPrefix[] = "in/_introspection/";
-
 std::string PubSubQoSToZenohQos(const TopicConfig::TopicQoS &qos) {
   return qos == TopicConfig::TopicQoS::Sensor ? "Sensor" : "HighReliability";
 }
 
+// Returns the reader for packet descriptors received on a topic with the
+// SameHostSharedMemory transport, or nullptr for other transports.
+std::shared_ptr<internal::SharedMemoryReader> MakeSharedMemoryReader(
+    absl::string_view prefixed_name, const TopicConfig &config) {
+  if (config.transport != TopicConfig::SameHostSharedMemory) return nullptr;
+  return std::make_shared<internal::SharedMemoryReader>(
+      internal::SharedMemoryRing::SegmentName(prefixed_name));
+}
+
+// Returns the received packet, reading it from shared memory if `blob` is the
+// descriptor of a packet in shared memory. Returns false if the packet could
+// not be read.
+bool ResolvePacket(internal::SharedMemoryReader *shared_memory_reader,
+                   const void *blob, size_t blob_len,
+                   absl::string_view *packet) {
+  *packet = absl::string_view(static_cast<const char *>(blob), blob_len);
+  if (shared_memory_reader == nullptr) return true;
+  // Only used until the packet is parsed, which happens before any user
+  // callback runs.
+  thread_local std::string shared_memory_buffer;
+  return shared_memory_reader->Resolve(packet, &shared_memory_buffer);
+}
+
+// Receives a packet on the topic `topic_name`, which is the key expression of
+// the packet without the topic prefix. Packets in shared memory have already
+// been resolved.
+using PacketHandler =
+    std::function<void(absl::string_view topic_name, absl::string_view packet)>;
+
+// Returns the dispatcher for the delivery mode of `config`, or nullptr if
+// packets are handled directly on the thread of the middleware.
+absl::StatusOr<std::unique_ptr<internal::SubscriptionDispatcher>>
+MakeSubscriptionDispatcher(const TopicConfig &config,
+                           internal::SubscriptionDispatcher::Callback handler) {
+  switch (config.delivery) {
+    case TopicConfig::Inline:
+      if (config.delivery_thread_options != Thread::Options()) {
+        return absl::InvalidArgumentError(
+            "Delivery thread options require LatestValue or BoundedQueue "
+            "delivery");
+      }
+      return nullptr;
+    case TopicConfig::LatestValue:
+      return internal::LatestValueDispatcher::Create(
+          std::move(handler), config.delivery_thread_options);
+    case TopicConfig::BoundedQueue:
+      return internal::BoundedQueueDispatcher::Create(
+          config.delivery_queue_capacity, std::move(handler),
+          config.delivery_thread_options);
+  }
+  return absl::InvalidArgumentError(
+      absl::StrFormat("Unknown delivery mode %d", config.delivery));
+}
+
+// Records the time from the publish time stamped into `packet` until
+// `receive_time`. Packets without a publish time are ignored.
+void RecordPublishToReceive(const internal::PubSubPacketView &packet,
+                            absl::Time receive_time,
+                            internal::SubscriptionLatency &latency) {
+  if (packet.publish_time() == absl::UnixEpoch()) {
+    return;
+  }
+  latency.publish_to_receive.Record(receive_time - packet.publish_time());
+}
+
+// Buffer for decompressing received packets, which is reused by all
+// subscriptions on this thread.
+struct DecompressedPacketTag {};
+using ScopedDecompressedPacketBuffer =
+    internal::ScopedThreadBuffer<DecompressedPacketTag>;
+
+// Subscribes to the topic and passes every received packet to `handler`,
+// either directly or through a dispatcher, depending on `config.delivery`.
+absl::StatusOr<Subscription> SubscribeToPackets(absl::string_view topic_name,
+                                                const TopicConfig &config,
+                                                PacketHandler handler) {
+  auto prefixed_name = ZenohHandle::add_topic_prefix(topic_name);
+  if (!prefixed_name.ok()) {
+    return prefixed_name.status();
+  }
+
+  auto subscription_data = std::make_unique<SubscriptionData>();
+  subscription_data->prefixed_name = *prefixed_name;
+  if (config.record_latency) {
+    subscription_data->latency =
+        std::make_shared<internal::SubscriptionLatency>();
+    internal::SubscriptionLatencyRegistry::Singleton().Register(
+        topic_name, subscription_data->latency);
+  }
+  internal::SubscriptionDispatcher::Callback deliver =
+      [handler = std::move(handler), latency = subscription_data->latency](
+          absl::string_view topic_name, absl::string_view packet,
+          absl::Time receive_time) {
+        ScopedAllocationTag allocation_tag(internal::kPubSubAllocationTag);
+        // Decompresses here rather than on the thread of the middleware, so
+        // that packets which a dispatcher drops are never decompressed.
+        ScopedDecompressedPacketBuffer buffer;
+        absl::StatusOr<absl::string_view> decompressed =
+            internal::DecompressPubSubPacket(packet, buffer.get());
+        if (!decompressed.ok()) {
+          LOG_EVERY_N(ERROR, 1) << "Decompressing packet on " << topic_name
+                                << " failed: " << decompressed.status();
+          return;
+        }
+        handler(topic_name, *decompressed);
+        if (latency != nullptr) {
+          latency->receive_to_callback_complete.Record(absl::Now() -
+                                                       receive_time);
+        }
+      };
+  INTR_ASSIGN_OR_RETURN(subscription_data->dispatcher,
+                        MakeSubscriptionDispatcher(config, deliver));
+  auto callback = std::make_unique<imw_callback_functor_t>(
+      [deliver = std::move(deliver), latency = subscription_data->latency,
+       packet_filter = config.packet_filter,
+       dispatcher = subscription_data->dispatcher.get(),
+       shared_memory_reader = MakeSharedMemoryReader(*prefixed_name, config),
+       topics = std::make_shared<internal::KeyexprTopicCache>(*prefixed_name)](
+          const char *keyexpr, const void *blob, const size_t blob_len) {
+        ScopedAllocationTag allocation_tag(internal::kPubSubAllocationTag);
+        const absl::Time receive_time =
+            latency != nullptr ? absl::Now() : absl::InfinitePast();
+        internal::ReceivedTopic uncached_topic;
+        const internal::ReceivedTopic *topic =
+            topics->Resolve(keyexpr, &uncached_topic);
+        if (topic == nullptr) {
+          LOG_EVERY_N(ERROR, 1) << "Received packet on invalid key expression "
+                                << keyexpr;
+          return;
+        }
+        // Don't attempt to deserialize the introspection data
+        // since it's JSON and doesn't need to be logged anyway;
+        // it will be parsed and captured by Prometheus separately
+        if (topic->is_introspection) return;
+
+        absl::string_view packet;
+        if (!ResolvePacket(shared_memory_reader.get(), blob, blob_len,
+                           &packet)) {
+          return;
+        }
+        // Only the envelope is parsed here; the payload is parsed, if at all,
+        // once the packet is delivered.
+        if (packet_filter != nullptr || latency != nullptr) {
+          absl::StatusOr<internal::PubSubPacketView> view =
+              internal::PubSubPacketView::Parse(packet);
+          if (view.ok()) {
+            if (packet_filter != nullptr &&
+                !packet_filter(topic->name, *view)) {
+              return;
+            }
+            if (latency != nullptr) {
+              RecordPublishToReceive(*view, receive_time, *latency);
+            }
+          }
+        }
+        if (dispatcher != nullptr) {
+          dispatcher->Offer(topic->name, packet, receive_time);
+        } else {
+          deliver(topic->name, packet, receive_time);
+        }
+      });
+  subscription_data->callback_functor = std::move(callback);
+
+  imw_ret_t ret = Zenoh().imw_create_subscription(
+      prefixed_name->c_str(), zenoh_static_callback,
+      intrinsic::PubSubQoSToZenohQos(config.topic_qos).c_str(),
+      subscription_data->callback_functor.get());
+  if (ret != IMW_OK) {
+    return absl::InternalError("Error creating a subscription");
+  }
+  return Subscription(topic_name, std::move(subscription_data));
+}
+
+// Encodes `message` into a PubSubPacket in `buffer`, which is cleared first.
+absl::Status EncodePacket(const google::protobuf::Message &message,
+                          std::string &buffer) {
+  google::protobuf::Timestamp now;
+  ToProtoUnchecked(absl::Now(), &now);
+  buffer.clear();
+  return internal::AppendPubSubPacket(message, now, &buffer).status();
+}
+
+// Sends `response` as the reply to the query with `query_context`. The packet
+// is encoded into a buffer that is reused on this thread.
+absl::Status ReplyToQuery(const std::string &prefixed_name,
+                          const void *query_context,
+                          const google::protobuf::Message &response) {
+  thread_local std::string reply_buffer;
+  INTR_RETURN_IF_ERROR(EncodePacket(response, reply_buffer));
+  if (Zenoh().imw_queryable_reply(query_context, prefixed_name.c_str(),
+                                  reply_buffer.data(),
+                                  reply_buffer.size()) != IMW_OK) {
+    return absl::InternalError(
+        absl::StrCat("Error replying to a query on ", prefixed_name));
+  }
+  return absl::OkStatus();
+}
+
+// Returns the view of the reply `packet`, or the error that the queryable
+// sent instead of a response.
+absl::StatusOr<internal::PubSubPacketView> DecodeReply(
+    absl::string_view packet) {
+  INTR_ASSIGN_OR_RETURN(internal::PubSubPacketView view,
+                        internal::PubSubPacketView::Parse(packet));
+  if (!view.PayloadIs(google::rpc::Status::descriptor()->full_name())) {
+    return view;
+  }
+  google::rpc::Status status;
+  const absl::string_view value = view.payload_value();
+  if (!status.ParseFromArray(value.data(), static_cast<int>(value.size()))) {
+    return absl::InvalidArgumentError("Invalid error reply to a query");
+  }
+  if (status.code() == 0) {
+    // A queryable that responds with a google.rpc.Status message.
+    return view;
+  }
+  return ToAbslStatus(status);
+}
+
 std::unique_ptr<PubSubData> MakePubSubData(
     absl::string_view config_param = absl::string_view()) {
   auto data = std::make_unique<PubSubData>();
@@ -39,15 +288,24 @@ std::unique_ptr<PubSubData> MakePubSubData(
       LOG(FATAL) << "Could not get PubSub peer config";
     }
   }
-  imw_ret_t ret = Zenoh().imw_init(config.c_str());
-  if (ret != IMW_OK) {
-    LOG(FATAL) << "Error creating a zenoh session with config " << config;
+  if (absl::Status status = internal::ZenohSession::Get().Acquire(config);
+      !status.ok()) {
+    LOG(FATAL) << status;
   }
-  LOG(INFO) << "Created a zenoh session with libimw_zenoh version: "
+  LOG(INFO) << "Using a zenoh session with libimw_zenoh version: "
             << Zenoh().imw_version();
   return data;
 }
 
+std::string MakeConfig(ZenohTuning::Profile profile) {
+  absl::StatusOr<std::string> config =
+      ZenohConfigBuilder().SetProfile(profile).Build();
+  if (!config.ok()) {
+    LOG(FATAL) << "Invalid PubSub config: " << config.status();
+  }
+  return *std::move(config);
+}
+
 PubSub::PubSub() : data_(MakePubSubData()) {}
 
 PubSub::PubSub(absl::string_view participant_name) : data_(MakePubSubData()) {}
@@ -55,7 +313,25 @@ PubSub::PubSub(absl::string_view participant_name) : data_(MakePubSubData()) {}
 PubSub::PubSub(absl::string_view participant_name, absl::string_view config)
     : data_(MakePubSubData(config)) {}
 
-PubSub::~PubSub() { Zenoh().imw_fini(); }
+PubSub::PubSub(absl::string_view participant_name,
+               ZenohTuning::Profile profile)
+    : data_(MakePubSubData(MakeConfig(profile))) {}
+
+PubSub::~PubSub() {
+  // Moved-from instances do not use the session.
+  if (data_ == nullptr) {
+    return;
+  }
+  // Sends the pending asynchronous messages while the session is still open.
+  data_->async_publish_thread->Stop();
+  {
+    absl::MutexLock lock(&data_->mutex);
+    for (const std::string &topic : data_->introspection_topics) {
+      Zenoh().imw_destroy_publisher(topic.c_str());
+    }
+  }
+  internal::ZenohSession::Get().Release();
+}
 
 absl::StatusOr<Publisher> PubSub::CreatePublisher(
     absl::string_view topic_name, const TopicConfig &config) const {
@@ -73,91 +349,228 @@ absl::StatusOr<Publisher> PubSub::CreatePublisher(
   }
   auto publisher_data = std::make_unique<PublisherData>();
   publisher_data->prefixed_name = *prefixed_name;
+  if (config.transport == TopicConfig::SameHostSharedMemory) {
+    absl::StatusOr<std::unique_ptr<internal::SharedMemoryRing>> ring =
+        internal::SharedMemoryRing::Create(
+            internal::SharedMemoryRing::SegmentName(*prefixed_name),
+            config.shared_memory_num_slots, config.shared_memory_slot_size);
+    if (!ring.ok()) {
+      Zenoh().imw_destroy_publisher(prefixed_name->c_str());
+      return ring.status();
+    }
+    publisher_data->shared_memory_ring = *std::move(ring);
+  }
+  switch (config.compression) {
+    case TopicConfig::NoCompression:
+      break;
+    case TopicConfig::ZlibCompression:
+      publisher_data->compression = {
+          .compression =
+              intrinsic_proto::pubsub::PubSubPacket::PAYLOAD_COMPRESSION_ZLIB,
+          .threshold = config.compression_threshold,
+      };
+      break;
+    default:
+      Zenoh().imw_destroy_publisher(prefixed_name->c_str());
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Unknown payload compression %d", config.compression));
+  }
+  publisher_data->stats =
+      internal::PublisherStats::Singleton().GetOrRegister(topic_name);
+  if (config.async_publishing != TopicConfig::AsyncPublishingDisabled) {
+    auto queue = std::make_shared<internal::AsyncPublishQueue>(
+        publisher_data.get(), config.async_publish_queue_capacity,
+        /*coalesce=*/config.async_publishing ==
+            TopicConfig::AsyncPublishingCoalesced);
+    if (absl::Status status = data_->async_publish_thread->Register(queue);
+        !status.ok()) {
+      Zenoh().imw_destroy_publisher(prefixed_name->c_str());
+      return status;
+    }
+    publisher_data->async_queue = std::move(queue);
+    publisher_data->async_thread = data_->async_publish_thread;
+  }
   return Publisher(topic_name, std::move(publisher_data));
 }
 
+absl::StatusOr<PublisherGroup> PubSub::CreatePublisherGroup(
+    absl::Span<const absl::string_view> topics,
+    const TopicConfig &config) const {
+  std::vector<Publisher> publishers;
+  publishers.reserve(topics.size());
+  for (absl::string_view topic : topics) {
+    INTR_ASSIGN_OR_RETURN(Publisher publisher, CreatePublisher(topic, config));
+    publishers.push_back(std::move(publisher));
+  }
+  return PublisherGroup(std::move(publishers));
+}
+
 absl::StatusOr<Subscription> PubSub::CreateSubscription(
     absl::string_view topic_name, const TopicConfig &config,
     SubscriptionOkCallback<intrinsic_proto::pubsub::PubSubPacket> msg_callback)
     const {
-  auto prefixed_name = ZenohHandle::add_topic_prefix(topic_name);
-  if (!prefixed_name.ok()) {
-    return prefixed_name.status();
-  }
-
-  auto subscription_data = std::make_unique<SubscriptionData>();
-  subscription_data->prefixed_name = *prefixed_name;
-  auto callback = std::make_unique<imw_callback_functor_t>(
-      [msg_callback](const char *keyexpr, const void *blob,
-                     const size_t blob_len) {
-        // Don't attempt to deserialize the introspection data
-        // since it's JSON and doesn't need to be logged anyway;
-        // it will be parsed and captured by Prometheus separately
-        if (absl::StartsWith(keyexpr, kIntrospectionTopicPrefix)) return;
-
+  return SubscribeToPackets(
+      topic_name, config,
+      [msg_callback = std::move(msg_callback)](absl::string_view topic_name,
+                                               absl::string_view packet) {
         intrinsic_proto::pubsub::PubSubPacket msg;
-        bool success = msg.ParseFromArray(blob, blob_len);
+        bool success = msg.ParseFromArray(packet.data(), packet.size());
         if (!success) {
           LOG_EVERY_N(ERROR, 1)
               << absl::StrFormat("Deserializing message failed. Topic: ")
-              << keyexpr;
+              << topic_name;
           return;
         }
         msg_callback(msg);
       });
-  subscription_data->callback_functor = std::move(callback);
-
-  imw_ret_t ret = Zenoh().imw_create_subscription(
-      prefixed_name->c_str(), zenoh_static_callback,
-      intrinsic::PubSubQoSToZenohQos(config.topic_qos).c_str(),
-      subscription_data->callback_functor.get());
-  if (ret != IMW_OK) {
-    return absl::InternalError("Error creating a subscription");
-  }
-  return Subscription(topic_name, std::move(subscription_data));
 }
 absl::StatusOr<Subscription> PubSub::CreateSubscription(
     absl::string_view topic_name, const TopicConfig &config,
     SubscriptionOkExpandedCallback<intrinsic_proto::pubsub::PubSubPacket>
         msg_callback) const {
-  auto prefixed_name = ZenohHandle::add_topic_prefix(topic_name);
-  if (!prefixed_name.ok()) {
-    return prefixed_name.status();
-  }
-
-  auto subscription_data = std::make_unique<SubscriptionData>();
-  subscription_data->prefixed_name = *prefixed_name;
-  auto callback = std::make_unique<imw_callback_functor_t>(
-      [msg_callback](const char *keyexpr, const void *blob,
-                     const size_t blob_len) {
-        absl::string_view topic_str(keyexpr);
-        if (absl::StartsWith(topic_str, kIntrospectionTopicPrefix)) return;
-
+  return SubscribeToPackets(
+      topic_name, config,
+      [msg_callback = std::move(msg_callback)](absl::string_view topic_name,
+                                               absl::string_view packet) {
         intrinsic_proto::pubsub::PubSubPacket msg;
-        bool success = msg.ParseFromArray(blob, blob_len);
+        bool success = msg.ParseFromArray(packet.data(), packet.size());
         if (!success) {
           LOG_EVERY_N(ERROR, 1)
               << absl::StrFormat("Deserializing message failed. Topic: ")
-              << keyexpr;
+              << topic_name;
           return;
         }
-        auto topic_name = ZenohHandle::remove_topic_prefix(keyexpr);
-        if (!topic_name.ok()) {
-          LOG_EVERY_N(ERROR, 1) << "Topic name error: " << topic_name.status();
-          return;
+        msg_callback(topic_name, msg);
+      });
+}
+
+absl::StatusOr<Subscription> PubSub::CreateSerializedPacketSubscription(
+    absl::string_view topic_name, const TopicConfig &config,
+    SerializedPacketCallback msg_callback) const {
+  return SubscribeToPackets(
+      topic_name, config,
+      [msg_callback = std::move(msg_callback)](
+          absl::string_view topic_name, absl::string_view packet) {
+        msg_callback(packet);
+      });
+}
+
+absl::StatusOr<Queryable> PubSub::CreateSerializedQueryable(
+    absl::string_view key, SerializedQueryHandler handler) const {
+  INTR_ASSIGN_OR_RETURN(std::string prefixed_name,
+                        ZenohHandle::add_topic_prefix(key));
+  auto queryable_data = std::make_unique<QueryableData>();
+  queryable_data->prefixed_name = prefixed_name;
+  queryable_data->callback_functor = std::make_unique<imw_queryable_functor_t>(
+      [handler = std::move(handler), prefixed_name](
+          const char *keyexpr, const void *query_bytes,
+          const size_t query_bytes_len, const void *query_context) {
+        const absl::string_view request(static_cast<const char *>(query_bytes),
+                                        query_bytes_len);
+        absl::Status status = handler(
+            request, [&](const google::protobuf::Message &response) {
+              return ReplyToQuery(prefixed_name, query_context, response);
+            });
+        if (!status.ok()) {
+          status = ReplyToQuery(prefixed_name, query_context,
+                                ToGoogleRpcStatus(status));
+        }
+        if (!status.ok()) {
+          LOG_EVERY_N(ERROR, 1) << "Query on " << keyexpr
+                                << " failed: " << status;
         }
-        msg_callback(*topic_name, msg);
       });
-  subscription_data->callback_functor = std::move(callback);
+  imw_ret_t ret = Zenoh().imw_create_queryable(
+      queryable_data->prefixed_name.c_str(), zenoh_queryable_static_callback,
+      queryable_data->callback_functor.get());
+  if (ret != IMW_OK) {
+    return absl::InternalError(
+        absl::StrCat("Error creating a queryable on ", key));
+  }
+  return Queryable(key, std::move(queryable_data));
+}
 
-  imw_ret_t ret = Zenoh().imw_create_subscription(
-      prefixed_name->c_str(), zenoh_static_callback,
-      intrinsic::PubSubQoSToZenohQos(config.topic_qos).c_str(),
-      subscription_data->callback_functor.get());
+absl::Status PubSub::QuerySerialized(
+    absl::string_view key, const google::protobuf::Message &request,
+    const QueryOptions &options,
+    absl::FunctionRef<
+        void(const absl::StatusOr<internal::PubSubPacketView> &reply)>
+        on_reply) const {
+  INTR_ASSIGN_OR_RETURN(const std::string prefixed_name,
+                        ZenohHandle::add_topic_prefix(key));
+  thread_local std::string request_buffer;
+  INTR_RETURN_IF_ERROR(EncodePacket(request, request_buffer));
+  const absl::Time deadline = absl::Now() + options.timeout;
+  // Replies that arrive after the collector is destroyed are dropped.
+  internal::QueryReplyCollector collector(
+      options.max_replies,
+      [&](absl::string_view packet) { on_reply(DecodeReply(packet)); });
+  imw_ret_t ret = Zenoh().imw_query(
+      prefixed_name.c_str(), internal::QueryReplyCollector::OnReply,
+      request_buffer.data(), request_buffer.size(), collector.context());
   if (ret != IMW_OK) {
-    return absl::InternalError("Error creating a subscription");
+    return absl::InternalError(absl::StrCat("Error sending a query on ", key));
   }
-  return Subscription(topic_name, std::move(subscription_data));
+  if (collector.WaitUntil(deadline) == 0) {
+    return absl::DeadlineExceededError(
+        absl::StrCat("No reply to the query on ", key, " within ",
+                     absl::FormatDuration(options.timeout)));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status PubSub::QueryOne(absl::string_view key,
+                              const google::protobuf::Message &request,
+                              google::protobuf::Message &response,
+                              absl::Duration timeout) const {
+  absl::Status status;
+  INTR_RETURN_IF_ERROR(QuerySerialized(
+      key, request, {.timeout = timeout, .max_replies = 1},
+      [&](const absl::StatusOr<internal::PubSubPacketView> &reply) {
+        status = reply.ok() ? ParsePayload(*reply, response) : reply.status();
+      }));
+  return status;
+}
+
+namespace {
+
+// Publishes `json` on the introspection `topic`, creating the middleware
+// publisher on first use.
+absl::Status PublishIntrospection(PubSubData &data, absl::string_view topic,
+                                  absl::string_view json) {
+  INTR_ASSIGN_OR_RETURN(const std::string prefixed_name,
+                        ZenohHandle::add_topic_prefix(topic));
+  {
+    absl::MutexLock lock(&data.mutex);
+    if (!absl::c_linear_search(data.introspection_topics, prefixed_name)) {
+      imw_ret_t ret = Zenoh().imw_create_publisher(
+          prefixed_name.c_str(),
+          PubSubQoSToZenohQos(TopicConfig::Sensor).c_str());
+      if (ret == IMW_ERROR) {
+        return absl::InternalError(
+            absl::StrCat("Error creating the publisher for ", topic));
+      }
+      data.introspection_topics.push_back(prefixed_name);
+    }
+  }
+  if (Zenoh().imw_publish(prefixed_name.c_str(), json.data(), json.size()) !=
+      IMW_OK) {
+    return absl::InternalError(absl::StrCat("Error publishing on ", topic));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status PubSub::PublishLatencyIntrospection() const {
+  return PublishIntrospection(
+      *data_, internal::kLatencyIntrospectionTopic,
+      internal::SubscriptionLatencyRegistry::Singleton().ToJson());
+}
+
+absl::Status PubSub::PublishAllocationIntrospection() const {
+  return PublishIntrospection(*data_, kAllocationIntrospectionTopic,
+                              AllocationStatsToJson());
 }
 
 bool PubSub::KeyexprIsCanon(absl::string_view keyexpr) const {
@@ -3,9 +3,28 @@
 #ifndef INTRINSIC_PLATFORM_PUBSUB_ZENOH_PUBSUB_DATA_H_
 #define INTRINSIC_PLATFORM_PUBSUB_ZENOH_PUBSUB_DATA_H_
 
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "intrinsic/platform/pubsub/zenoh_async_publisher.h"
+
 namespace intrinsic {
 
-struct PubSubData {};
+struct PubSubData {
+  // Sends the messages of Publisher::PublishAsync() for all publishers of the
+  // PubSub instance. Shared with the publishers, which may outlive the
+  // instance.
+  std::shared_ptr<internal::AsyncPublishThread> async_publish_thread =
+      std::make_shared<internal::AsyncPublishThread>();
+
+  absl::Mutex mutex;
+  // Prefixed topics of the middleware publishers created for
+  // PublishLatencyIntrospection() and PublishAllocationIntrospection().
+  std::vector<std::string> introspection_topics ABSL_GUARDED_BY(mutex);
+};
 
 }  // namespace intrinsic
 
@@ -0,0 +1,40 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "intrinsic/platform/pubsub/queryable.h"
+#include "intrinsic/platform/pubsub/zenoh_queryable_data.h"
+#include "intrinsic/platform/pubsub/zenoh_util/zenoh_handle.h"
+
+namespace intrinsic {
+
+Queryable::Queryable() = default;
+
+Queryable::Queryable(absl::string_view key,
+                     std::unique_ptr<QueryableData> data)
+    : key_(key), data_(std::move(data)) {}
+
+Queryable::Queryable(Queryable &&) = default;
+
+Queryable &Queryable::operator=(Queryable &&other) {
+  Close();
+  key_ = std::move(other.key_);
+  data_ = std::move(other.data_);
+  return *this;
+}
+
+Queryable::~Queryable() { Close(); }
+
+void Queryable::Close() {
+  if (!key_.empty()) {
+    Zenoh().imw_destroy_queryable(data_->prefixed_name.c_str(),
+                                  zenoh_queryable_static_callback,
+                                  data_->callback_functor.get());
+    key_.clear();
+  }
+}
+
+}  // namespace intrinsic
@@ -1,5 +1,6 @@
 // Copyright 2023 Intrinsic Innovation LLC
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -25,6 +26,7 @@ Subscription &Subscription::operator=(Subscription &&other) {
     Zenoh().imw_destroy_subscription(
         subscription_data_->prefixed_name.c_str(), zenoh_static_callback,
         subscription_data_->callback_functor.get());
+    subscription_data_->dispatcher.reset();
   }
   topic_name_ = std::move(other.topic_name_);
   subscription_data_ = std::move(other.subscription_data_);
@@ -38,8 +40,31 @@ void Subscription::Unsubscribe() {
     Zenoh().imw_destroy_subscription(
         subscription_data_->prefixed_name.c_str(), zenoh_static_callback,
         subscription_data_->callback_functor.get());
+    subscription_data_->dispatcher.reset();
     topic_name_.clear();
   }
 }
 
+uint64_t Subscription::NumDroppedMessages() const {
+  if (subscription_data_ == nullptr ||
+      subscription_data_->dispatcher == nullptr) {
+    return 0;
+  }
+  return subscription_data_->dispatcher->num_dropped();
+}
+
+SubscriptionLatencyStats Subscription::GetLatencyStats() const {
+  if (subscription_data_ == nullptr ||
+      subscription_data_->latency == nullptr) {
+    return {};
+  }
+  return {
+      .publish_to_receive =
+          subscription_data_->latency->publish_to_receive.Summarize(),
+      .receive_to_callback_complete =
+          subscription_data_->latency->receive_to_callback_complete
+              .Summarize(),
+  };
+}
+
 }  // namespace intrinsic
@@ -6,6 +6,8 @@
 #include <memory>
 #include <string>
 
+#include "intrinsic/platform/pubsub/subscription_dispatcher.h"
+#include "intrinsic/platform/pubsub/subscription_latency.h"
 #include "intrinsic/platform/pubsub/zenoh_util/zenoh_handle.h"
 
 namespace intrinsic {
@@ -13,6 +15,13 @@ namespace intrinsic {
 struct SubscriptionData {
   std::unique_ptr<imw_callback_functor_t> callback_functor;
   std::string prefixed_name;
+  // Runs the callback if the subscription does not use inline delivery. The
+  // callback functor refers to it, so it must be reset only after the
+  // middleware subscription was destroyed.
+  std::unique_ptr<internal::SubscriptionDispatcher> dispatcher;
+  // Only set if the subscription records latencies. Shared with the callback
+  // functor and the dispatcher.
+  std::shared_ptr<internal::SubscriptionLatency> latency;
 };
 
 }  // namespace intrinsic
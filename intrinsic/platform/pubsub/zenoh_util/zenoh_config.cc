@@ -1,8 +1,315 @@
 // Copyright 2023 Intrinsic Innovation LLC
 
+#include "intrinsic/platform/pubsub/zenoh_util/zenoh_config.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <ios>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/flags/flag.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "intrinsic/platform/pubsub/zenoh_util/zenoh_helpers.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "tools/cpp/runfiles/runfiles.h"
 
 ABSL_FLAG(std::string, zenoh_router, "",
           "Override the default Zenoh connection to PROTOCOL/HOSTNAME:PORT");
+
+namespace intrinsic {
+
+namespace {
+
+// Must match peer_config.json.
+constexpr absl::string_view kDefaultRouterEndpoint =
+    "tcp/zenoh-router.app-intrinsic-base:7447";
+constexpr absl::string_view kDefaultListenIp = "0.0.0.0";
+
+// Limits enforced by the middleware.
+constexpr size_t kMaxBatchSize = 65535;
+constexpr size_t kMaxQueueSize = 16;
+
+// Queue sizes of the priorities that do not carry published messages. These
+// are the defaults of the middleware, which are written out because the queue
+// sizes can only be set all together.
+constexpr absl::string_view kControlQueueSizes =
+    R"("control": 1, "real_time": 1, "interactive_high": 1, )"
+    R"("interactive_low": 1, "background": 4)";
+
+std::string JsonString(absl::string_view value) {
+  return absl::StrCat("\"", value, "\"");
+}
+
+std::string JsonBool(bool value) { return value ? "true" : "false"; }
+
+std::string JsonMember(absl::string_view key, absl::string_view value) {
+  return absl::StrCat(JsonString(key), ": ", value);
+}
+
+std::string JsonObject(const std::vector<std::string>& members) {
+  return absl::StrCat("{", absl::StrJoin(members, ", "), "}");
+}
+
+std::string JsonStringArray(const std::vector<std::string>& values) {
+  return absl::StrCat(
+      "[",
+      absl::StrJoin(values, ", ",
+                    [](std::string* out, const std::string& value) {
+                      absl::StrAppend(out, JsonString(value));
+                    }),
+      "]");
+}
+
+absl::Status ValidateEndpoints(absl::string_view name,
+                               const std::vector<std::string>& endpoints) {
+  for (const std::string& endpoint : endpoints) {
+    if (endpoint.find('/') == std::string::npos ||
+        endpoint.find_first_of("\"\\") != std::string::npos) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Invalid ", name, " endpoint \"", endpoint,
+          "\", expected PROTOCOL/ADDRESS"));
+    }
+  }
+  return absl::OkStatus();
+}
+
+std::string OptionalToString(const std::optional<size_t>& value) {
+  return value.has_value() ? absl::StrCat(*value) : "default";
+}
+
+std::string OptionalToString(const std::optional<bool>& value) {
+  return value.has_value() ? JsonBool(*value) : "default";
+}
+
+// Returns the "transport" section of the config.
+std::string TransportConfig(const ZenohTuning& tuning) {
+  std::vector<std::string> transport;
+
+  std::vector<std::string> unicast;
+  if (tuning.low_latency.has_value()) {
+    unicast.push_back(JsonMember("lowlatency", JsonBool(*tuning.low_latency)));
+  }
+  if (tuning.qos.has_value()) {
+    unicast.push_back(JsonMember(
+        "qos", JsonObject({JsonMember("enabled", JsonBool(*tuning.qos))})));
+  }
+  if (!unicast.empty()) {
+    transport.push_back(JsonMember("unicast", JsonObject(unicast)));
+  }
+
+  std::vector<std::string> tx;
+  if (tuning.batch_size.has_value()) {
+    tx.push_back(JsonMember("batch_size", absl::StrCat(*tuning.batch_size)));
+  }
+  if (tuning.data_queue_size.has_value()) {
+    const size_t size = *tuning.data_queue_size;
+    tx.push_back(JsonMember(
+        "queue",
+        JsonObject({JsonMember(
+            "size",
+            absl::StrCat("{", kControlQueueSizes, ", \"data_high\": ", size,
+                         ", \"data\": ", size, ", \"data_low\": ", size,
+                         "}"))})));
+  }
+  if (tuning.tx_threads.has_value()) {
+    tx.push_back(JsonMember("threads", absl::StrCat(*tuning.tx_threads)));
+  }
+  std::vector<std::string> link;
+  if (!tx.empty()) {
+    link.push_back(JsonMember("tx", JsonObject(tx)));
+  }
+  if (tuning.rx_buffer_size.has_value()) {
+    link.push_back(JsonMember(
+        "rx", JsonObject({JsonMember(
+                  "buffer_size", absl::StrCat(*tuning.rx_buffer_size))})));
+  }
+  if (!link.empty()) {
+    transport.push_back(JsonMember("link", JsonObject(link)));
+  }
+
+  transport.push_back(JsonMember(
+      "shared_memory",
+      JsonObject({JsonMember("enabled", JsonBool(tuning.shared_memory))})));
+  return JsonObject(transport);
+}
+
+}  // namespace
+
+std::string GetZenohPeerConfig() {
+  std::string config;
+
+  std::string config_path =
+      "/intrinsic/platform/pubsub/zenoh_util/peer_config.json";
+  std::string runfiles_path;
+
+  if (!RunningInKubernetes()) {
+    runfiles_path =
+        bazel::tools::cpp::runfiles::Runfiles::Create("")->Rlocation(
+            "ai_intrinsic_sdks");
+  }
+  std::ifstream file(runfiles_path + config_path);
+  if (file.is_open()) {
+    // Read the entire file into a string
+    file.seekg(0, std::ios::end);
+    config.resize(file.tellg());
+    file.seekg(0, std::ios::beg);
+    file.read(&config[0], config.size());
+    file.close();
+  } else {
+    LOG(ERROR) << "Could not open config file: " << runfiles_path + config_path;
+  }
+
+  if (!config.empty()) {
+    if (RunningUnderTest()) {
+      // Remove listen endpoints when running in test. (go/forge-limits#ipv4)
+      std::string listenIp("\"tcp/0.0.0.0:0\"");
+      size_t pos = config.find(listenIp);
+      config.replace(pos, listenIp.length(), std::string(""));
+    } else if (const char* allowed_ip = getenv("ALLOWED_PUBSUB_IPv4");
+               allowed_ip != nullptr) {
+      std::string listenIp(kDefaultListenIp);
+      size_t pos = config.find(listenIp);
+      config.replace(pos, listenIp.length(), std::string(allowed_ip));
+    }
+  }
+
+  // If requested by the zenoh_router flag, try to alter the default router
+  // connection provided in peer_config.json
+  if (!absl::GetFlag(FLAGS_zenoh_router).empty()) {
+    std::string router_endpoint(kDefaultRouterEndpoint);
+    size_t pos = config.find(router_endpoint);
+    if (pos != std::string::npos) {
+      config.replace(pos, router_endpoint.length(),
+                     absl::GetFlag(FLAGS_zenoh_router));
+    }
+  }
+  return config;
+}
+
+ZenohTuning ZenohTuning::ForProfile(Profile profile) {
+  ZenohTuning tuning;
+  switch (profile) {
+    case Profile::kDefault:
+      break;
+    case Profile::kLowLatencyLocal:
+      tuning.low_latency = true;
+      tuning.qos = false;
+      break;
+    case Profile::kHighThroughputBulk:
+      tuning.batch_size = kMaxBatchSize;
+      tuning.data_queue_size = kMaxQueueSize;
+      tuning.tx_threads = 4;
+      tuning.rx_buffer_size = 16 << 20;
+      break;
+  }
+  return tuning;
+}
+
+absl::Status ZenohTuning::Validate() const {
+  if (batch_size.has_value() &&
+      (*batch_size == 0 || *batch_size > kMaxBatchSize)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "batch_size must be between 1 and ", kMaxBatchSize, ", got ",
+        *batch_size));
+  }
+  if (data_queue_size.has_value() &&
+      (*data_queue_size == 0 || *data_queue_size > kMaxQueueSize)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "data_queue_size must be between 1 and ", kMaxQueueSize, ", got ",
+        *data_queue_size));
+  }
+  if (tx_threads.has_value() && *tx_threads == 0) {
+    return absl::InvalidArgumentError("tx_threads must be at least 1");
+  }
+  if (rx_buffer_size.has_value() &&
+      *rx_buffer_size < batch_size.value_or(kMaxBatchSize)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "rx_buffer_size must be at least the batch size of ",
+        batch_size.value_or(kMaxBatchSize), ", got ", *rx_buffer_size));
+  }
+  // The middleware enables priorities by default.
+  if (low_latency.value_or(false) && qos.value_or(true)) {
+    return absl::InvalidArgumentError(
+        "low_latency requires qos to be disabled");
+  }
+  return absl::OkStatus();
+}
+
+std::string ZenohTuning::DebugString() const {
+  return absl::StrCat(
+      "batch_size: ", OptionalToString(batch_size),
+      ", data_queue_size: ", OptionalToString(data_queue_size),
+      ", tx_threads: ", OptionalToString(tx_threads),
+      ", rx_buffer_size: ", OptionalToString(rx_buffer_size),
+      ", low_latency: ", OptionalToString(low_latency),
+      ", qos: ", OptionalToString(qos),
+      ", shared_memory: ", JsonBool(shared_memory));
+}
+
+ZenohConfigBuilder::ZenohConfigBuilder()
+    : connect_endpoints_({std::string(kDefaultRouterEndpoint)}) {
+  if (!absl::GetFlag(FLAGS_zenoh_router).empty()) {
+    connect_endpoints_ = {absl::GetFlag(FLAGS_zenoh_router)};
+  }
+  if (RunningUnderTest()) {
+    // See GetZenohPeerConfig().
+    return;
+  }
+  const char* allowed_ip = getenv("ALLOWED_PUBSUB_IPv4");
+  listen_endpoints_ = {absl::StrCat(
+      "tcp/", allowed_ip != nullptr ? allowed_ip : kDefaultListenIp, ":0")};
+}
+
+ZenohConfigBuilder& ZenohConfigBuilder::SetConnectEndpoints(
+    std::vector<std::string> endpoints) {
+  connect_endpoints_ = std::move(endpoints);
+  return *this;
+}
+
+ZenohConfigBuilder& ZenohConfigBuilder::SetListenEndpoints(
+    std::vector<std::string> endpoints) {
+  listen_endpoints_ = std::move(endpoints);
+  return *this;
+}
+
+ZenohConfigBuilder& ZenohConfigBuilder::SetTuning(const ZenohTuning& tuning) {
+  tuning_ = tuning;
+  return *this;
+}
+
+absl::StatusOr<std::string> ZenohConfigBuilder::Build() const {
+  INTR_RETURN_IF_ERROR(ValidateEndpoints("connect", connect_endpoints_));
+  INTR_RETURN_IF_ERROR(ValidateEndpoints("listen", listen_endpoints_));
+  INTR_RETURN_IF_ERROR(tuning_.Validate());
+  LOG(INFO) << "Zenoh tuning: " << tuning_.DebugString();
+
+  // Apart from the endpoints and the transport, this matches
+  // peer_config.json.
+  return JsonObject({
+      JsonMember("mode", JsonString("peer")),
+      JsonMember("connect", JsonObject({JsonMember(
+                                "endpoints",
+                                JsonStringArray(connect_endpoints_))})),
+      JsonMember("imw", R"({"introspection": {"enable": true}})"),
+      JsonMember("listen", JsonObject({JsonMember(
+                               "endpoints",
+                               JsonStringArray(listen_endpoints_))})),
+      JsonMember("scouting",
+                 R"({"multicast": {"enabled": false}, )"
+                 R"("gossip": {"enabled": true, "multihop": true, )"
+                 R"("autoconnect": {"peer": "peer|router"}}})"),
+      JsonMember("plugins", "{}"),
+      JsonMember("transport", TransportConfig(tuning_)),
+  });
+}
+
+}  // namespace intrinsic
@@ -3,71 +3,107 @@
 #ifndef INTRINSIC_PLATFORM_PUBSUB_ZENOH_UTIL_ZENOH_CONFIG_H_
 #define INTRINSIC_PLATFORM_PUBSUB_ZENOH_UTIL_ZENOH_CONFIG_H_
 
-#include <fstream>
-#include <ios>
-#include <iostream>
+#include <cstddef>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "absl/flags/declare.h"
-#include "absl/flags/flag.h"
-#include "absl/log/log.h"
-#include "intrinsic/platform/pubsub/zenoh_util/zenoh_helpers.h"
-#include "tools/cpp/runfiles/runfiles.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
 
 ABSL_DECLARE_FLAG(std::string, zenoh_router);
 
 namespace intrinsic {
 
-inline std::string GetZenohPeerConfig() {
-  std::string config;
+// Returns the contents of peer_config.json, adjusted for the environment:
+// without listen endpoints when running under test, listening only on
+// ALLOWED_PUBSUB_IPv4 if set, and connecting to --zenoh_router if set.
+std::string GetZenohPeerConfig();
 
-  std::string config_path =
-      "/intrinsic/platform/pubsub/zenoh_util/peer_config.json";
-  std::string runfiles_path;
+// Transport settings of a zenoh session, which trade latency against
+// throughput and resource usage. Unset fields keep the defaults of the
+// middleware.
+struct ZenohTuning {
+  enum class Profile {
+    // The settings of peer_config.json.
+    kDefault,
+    // For small, frequent messages between processes on the same host, such
+    // as control loops. Sends every message right away instead of batching it
+    // with other messages, and disables priorities.
+    kLowLatencyLocal,
+    // For large messages and high message rates, such as camera images and
+    // point clouds. Uses the largest batches, deep queues, several sending
+    // threads and large receive buffers.
+    kHighThroughputBulk,
+  };
 
-  if (!RunningInKubernetes()) {
-    runfiles_path =
-        bazel::tools::cpp::runfiles::Runfiles::Create("")->Rlocation(
-            "ai_intrinsic_sdks");
-  }
-  std::ifstream file(runfiles_path + config_path);
-  if (file.is_open()) {
-    // Read the entire file into a string
-    file.seekg(0, std::ios::end);
-    config.resize(file.tellg());
-    file.seekg(0, std::ios::beg);
-    file.read(&config[0], config.size());
-    file.close();
-  } else {
-    LOG(ERROR) << "Could not open config file: " << runfiles_path + config_path;
-  }
+  static ZenohTuning ForProfile(Profile profile);
 
-  if (!config.empty()) {
-    if (RunningUnderTest()) {
-      // Remove listen endpoints when running in test. (go/forge-limits#ipv4)
-      std::string listenIp("\"tcp/0.0.0.0:0\"");
-      size_t pos = config.find(listenIp);
-      config.replace(pos, listenIp.length(), std::string(""));
-    } else if (const char* allowed_ip = getenv("ALLOWED_PUBSUB_IPv4");
-               allowed_ip != nullptr) {
-      std::string listenIp("0.0.0.0");
-      size_t pos = config.find(listenIp);
-      config.replace(pos, listenIp.length(), std::string(allowed_ip));
-    }
-  }
+  // Maximum size in bytes of a batch of messages that is sent at once. Between
+  // 1 and 65535.
+  std::optional<size_t> batch_size;
+  // Capacity in batches of the queues of the data priorities, which carry
+  // published messages. Between 1 and 16.
+  std::optional<size_t> data_queue_size;
+  // Number of threads that send batches. At least 1.
+  std::optional<size_t> tx_threads;
+  // Size in bytes of the receive buffer of every link. At least `batch_size`.
+  std::optional<size_t> rx_buffer_size;
+  // Whether messages bypass batching and queueing. Requires `qos` to be false.
+  std::optional<bool> low_latency;
+  // Whether messages are sent with priorities.
+  std::optional<bool> qos;
+  // Whether peers on the same host exchange payloads through zenoh's shared
+  // memory. Requires a middleware that was built with shared memory support.
+  bool shared_memory = false;
+
+  // Returns an error if the middleware would reject the settings.
+  absl::Status Validate() const;
+
+  // Lists all fields, with "default" for unset fields.
+  std::string DebugString() const;
+};
+
+// Builds the config of a zenoh peer session.
+//
+// Example:
+//
+//   INTR_ASSIGN_OR_RETURN(
+//       std::string config,
+//       ZenohConfigBuilder()
+//           .SetProfile(ZenohTuning::Profile::kHighThroughputBulk)
+//           .Build());
+//   PubSub pubsub("my_participant", config);
+class ZenohConfigBuilder {
+ public:
+  // Starts from the settings of GetZenohPeerConfig().
+  ZenohConfigBuilder();
 
-  // If requested by the zenoh_router flag, try to alter the default router
-  // connection provided in peer_config.json
-  if (!absl::GetFlag(FLAGS_zenoh_router).empty()) {
-    std::string router_endpoint("tcp/zenoh-router.app-intrinsic-base:7447");
-    size_t pos = config.find(router_endpoint);
-    if (pos != std::string::npos) {
-      config.replace(pos, router_endpoint.length(),
-                     absl::GetFlag(FLAGS_zenoh_router));
-    }
+  // Endpoints of the routers and peers to connect to, e.g.
+  // "tcp/zenoh-router.app-intrinsic-base:7447".
+  ZenohConfigBuilder& SetConnectEndpoints(std::vector<std::string> endpoints);
+
+  // Endpoints on which the session accepts connections, e.g. "tcp/0.0.0.0:0".
+  ZenohConfigBuilder& SetListenEndpoints(std::vector<std::string> endpoints);
+
+  ZenohConfigBuilder& SetTuning(const ZenohTuning& tuning);
+
+  ZenohConfigBuilder& SetProfile(ZenohTuning::Profile profile) {
+    return SetTuning(ZenohTuning::ForProfile(profile));
   }
-  return config;
-}
+
+  const ZenohTuning& tuning() const { return tuning_; }
+
+  // Returns the config as JSON, or an error if the settings are invalid. Logs
+  // the effective tuning.
+  absl::StatusOr<std::string> Build() const;
+
+ private:
+  std::vector<std::string> connect_endpoints_;
+  std::vector<std::string> listen_endpoints_;
+  ZenohTuning tuning_;
+};
 
 }  // namespace intrinsic
 
@@ -8,9 +8,15 @@
 #include <string>
 
 #include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "intrinsic/util/testing/gtest_wrapper.h"
 
+using ::intrinsic::testing::IsOk;
+using ::intrinsic::testing::StatusIs;
+using ::testing::AllOf;
 using ::testing::HasSubstr;
+using ::testing::Not;
 
 namespace intrinsic {
 
@@ -21,4 +27,77 @@ TEST(ZenohConfigTest, TestRouterFlag) {
   EXPECT_THAT(config, HasSubstr(test_router_endpoint));
 }
 
+TEST(ZenohConfigBuilderTest, DefaultProfileOnlySetsSharedMemory) {
+  absl::StatusOr<std::string> config = ZenohConfigBuilder().Build();
+  ASSERT_THAT(config.status(), IsOk());
+  EXPECT_THAT(*config,
+              AllOf(HasSubstr(R"("mode": "peer")"),
+                    HasSubstr(R"("transport": {"shared_memory": )"
+                              R"({"enabled": false}})")));
+}
+
+TEST(ZenohConfigBuilderTest, LowLatencyLocal) {
+  absl::StatusOr<std::string> config =
+      ZenohConfigBuilder()
+          .SetProfile(ZenohTuning::Profile::kLowLatencyLocal)
+          .Build();
+  ASSERT_THAT(config.status(), IsOk());
+  EXPECT_THAT(*config, HasSubstr(R"("unicast": {"lowlatency": true, )"
+                                 R"("qos": {"enabled": false}})"));
+}
+
+TEST(ZenohConfigBuilderTest, HighThroughputBulk) {
+  absl::StatusOr<std::string> config =
+      ZenohConfigBuilder()
+          .SetProfile(ZenohTuning::Profile::kHighThroughputBulk)
+          .Build();
+  ASSERT_THAT(config.status(), IsOk());
+  EXPECT_THAT(*config, AllOf(HasSubstr(R"("batch_size": 65535)"),
+                             HasSubstr(R"("data": 16)"),
+                             HasSubstr(R"("threads": 4)"),
+                             HasSubstr(R"("buffer_size": 16777216)"),
+                             Not(HasSubstr("lowlatency"))));
+}
+
+TEST(ZenohConfigBuilderTest, SetsEndpoints) {
+  absl::StatusOr<std::string> config =
+      ZenohConfigBuilder()
+          .SetConnectEndpoints({"tcp/router:7447", "tcp/other:7447"})
+          .SetListenEndpoints({"tcp/127.0.0.1:0"})
+          .Build();
+  ASSERT_THAT(config.status(), IsOk());
+  EXPECT_THAT(
+      *config,
+      AllOf(HasSubstr(R"("connect": {"endpoints": ["tcp/router:7447", )"
+                      R"("tcp/other:7447"]})"),
+            HasSubstr(R"("listen": {"endpoints": ["tcp/127.0.0.1:0"]})")));
+}
+
+TEST(ZenohConfigBuilderTest, RejectsInvalidEndpoint) {
+  EXPECT_THAT(ZenohConfigBuilder().SetConnectEndpoints({"router"}).Build(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ZenohConfigBuilderTest, RejectsInvalidTuning) {
+  ZenohTuning tuning;
+  tuning.batch_size = 65536;
+  EXPECT_THAT(ZenohConfigBuilder().SetTuning(tuning).Build(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  tuning = ZenohTuning();
+  tuning.data_queue_size = 0;
+  EXPECT_THAT(tuning.Validate(), StatusIs(absl::StatusCode::kInvalidArgument));
+
+  tuning = ZenohTuning();
+  tuning.batch_size = 8192;
+  tuning.rx_buffer_size = 4096;
+  EXPECT_THAT(tuning.Validate(), StatusIs(absl::StatusCode::kInvalidArgument));
+
+  tuning = ZenohTuning();
+  tuning.low_latency = true;
+  EXPECT_THAT(tuning.Validate(), StatusIs(absl::StatusCode::kInvalidArgument));
+  tuning.qos = false;
+  EXPECT_THAT(tuning.Validate(), IsOk());
+}
+
 }  // namespace intrinsic
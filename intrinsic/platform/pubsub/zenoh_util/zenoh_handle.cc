@@ -5,6 +5,7 @@
 #include <dlfcn.h>
 
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 
 #include "absl/log/log.h"
 #include "absl/status/status.h"
@@ -44,6 +45,15 @@ void zenoh_static_callback(const char* keyexpr, const void* blob,
   (*static_cast<imw_callback_functor_t*>(fptr))(keyexpr, blob, blob_len);
 }
 
+void zenoh_queryable_static_callback(const char* keyexpr,
+                                     const void* query_bytes,
+                                     const size_t query_bytes_len,
+                                     const void* query_context, void* fptr) {
+  (*static_cast<imw_queryable_functor_t*>(fptr))(keyexpr, query_bytes,
+                                                 query_bytes_len,
+                                                 query_context);
+}
+
 ZenohHandle* ZenohHandle::CreateZenohHandle() {
   auto* zenoh = new ZenohHandle();
   zenoh->Initialize();
@@ -142,4 +152,9 @@ const ZenohHandle& Zenoh() {
   return *zenoh_handle;
 }
 
+void PreloadZenoh() {
+  // Concurrent calls to Zenoh() wait until the handle is initialized.
+  std::thread([]() { (void)Zenoh(); }).detach();
+}
+
 }  // namespace intrinsic
@@ -42,6 +42,16 @@ typedef std::function<void(const char *, const void *, const size_t)>
 void zenoh_static_callback(const char *keyexpr, const void *blob,
                            size_t blob_len, void *fptr);
 
+typedef std::function<void(const char *, const void *, const size_t,
+                           const void *)>
+    imw_queryable_functor_t;
+
+// Calls the imw_queryable_functor_t `fptr` with the query.
+void zenoh_queryable_static_callback(const char *keyexpr,
+                                     const void *query_bytes,
+                                     size_t query_bytes_len,
+                                     const void *query_context, void *fptr);
+
 // ZenohHandle loads the zenoh shared library and provides an interface for
 // necessary PubSub calls to the shared library.
 struct ZenohHandle {
@@ -113,6 +123,12 @@ struct ZenohHandle {
 
 const ZenohHandle &Zenoh();
 
+// Starts loading the shared library on a background thread and returns right
+// away, so that the first call to Zenoh(), e.g., by the first PubSub
+// constructor, waits less or not at all. Optional; meant to be called early in
+// main(), before flags are parsed and other initialization work is done.
+void PreloadZenoh();
+
 }  // namespace intrinsic
 
 #endif  // INTRINSIC_PLATFORM_PUBSUB_ZENOH_UTIL_ZENOH_HANDLE_H_
@@ -0,0 +1,83 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/zenoh_util/zenoh_session.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "intrinsic/platform/pubsub/zenoh_util/zenoh_handle.h"
+
+namespace intrinsic::internal {
+
+ZenohSession& ZenohSession::Get() {
+  static auto* session = []() {
+    auto* session = new ZenohSession(Zenoh().imw_init, Zenoh().imw_fini);
+    // Closes the session at exit unless a PubSub instance still uses it.
+    std::atexit([]() { Get().CloseIfIdle(); });
+    return session;
+  }();
+  return *session;
+}
+
+ZenohSession::ZenohSession(InitFunction init, FiniFunction fini)
+    : init_(init), fini_(fini) {}
+
+absl::Status ZenohSession::Acquire(absl::string_view config) {
+  absl::MutexLock lock(&mutex_);
+  if (config_.has_value() && *config_ != config) {
+    if (num_users_ > 0) {
+      LOG(WARNING) << "A zenoh session with a different config is open, which "
+                      "is shared instead of opening a session with config "
+                   << config;
+      ++num_users_;
+      return absl::OkStatus();
+    }
+    (void)fini_();
+    config_.reset();
+  }
+  if (!config_.has_value()) {
+    const std::string config_string(config);
+    if (init_(config_string.c_str()) != IMW_OK) {
+      return absl::InternalError(absl::StrCat(
+          "Error creating a zenoh session with config ", config));
+    }
+    config_ = config_string;
+  }
+  ++num_users_;
+  return absl::OkStatus();
+}
+
+void ZenohSession::Release() {
+  absl::MutexLock lock(&mutex_);
+  if (num_users_ == 0) {
+    LOG(ERROR) << "Released a zenoh session without users";
+    return;
+  }
+  --num_users_;
+}
+
+void ZenohSession::CloseIfIdle() {
+  absl::MutexLock lock(&mutex_);
+  if (config_.has_value() && num_users_ == 0) {
+    (void)fini_();
+    config_.reset();
+  }
+}
+
+size_t ZenohSession::num_users() const {
+  absl::MutexLock lock(&mutex_);
+  return num_users_;
+}
+
+bool ZenohSession::is_open() const {
+  absl::MutexLock lock(&mutex_);
+  return config_.has_value();
+}
+
+}  // namespace intrinsic::internal
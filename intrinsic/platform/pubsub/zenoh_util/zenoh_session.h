@@ -0,0 +1,70 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_PLATFORM_PUBSUB_ZENOH_UTIL_ZENOH_SESSION_H_
+#define INTRINSIC_PLATFORM_PUBSUB_ZENOH_UTIL_ZENOH_SESSION_H_
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "intrinsic/platform/pubsub/zenoh_util/zenoh_handle.h"
+
+namespace intrinsic::internal {
+
+// Shares the middleware session among all PubSub instances of a process.
+//
+// The middleware has a single session per process, which imw_init() opens and
+// imw_fini() closes. Both are expensive, so the session is reference-counted:
+// Acquire() opens it for the first user and later users share it. Release()
+// keeps the session open after the last user is gone, so that processes which
+// create many short-lived PubSub instances, such as tests and tools, open the
+// session only once. An idle session is closed when it is acquired with a
+// different config, by CloseIfIdle(), or at exit.
+//
+// This class is thread-safe.
+class ZenohSession {
+ public:
+  using InitFunction = imw_ret_t (*)(const char* config);
+  using FiniFunction = imw_ret_t (*)();
+
+  // Returns the session of the process, which uses Zenoh().
+  static ZenohSession& Get();
+
+  ZenohSession(InitFunction init, FiniFunction fini);
+
+  ZenohSession(const ZenohSession&) = delete;
+  ZenohSession& operator=(const ZenohSession&) = delete;
+
+  // Opens the session with `config` unless it is open already. Every
+  // successful call must be matched by a call to Release().
+  //
+  // Users that request a config that differs from the one of the open session
+  // share the open session, since there is only one per process. This is
+  // logged.
+  absl::Status Acquire(absl::string_view config);
+
+  void Release();
+
+  // Closes the session if it has no users.
+  void CloseIfIdle();
+
+  size_t num_users() const;
+  bool is_open() const;
+
+ private:
+  const InitFunction init_;
+  const FiniFunction fini_;
+
+  mutable absl::Mutex mutex_;
+  // The config of the open session, if any.
+  std::optional<std::string> config_ ABSL_GUARDED_BY(mutex_);
+  size_t num_users_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace intrinsic::internal
+
+#endif  // INTRINSIC_PLATFORM_PUBSUB_ZENOH_UTIL_ZENOH_SESSION_H_
@@ -0,0 +1,113 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/platform/pubsub/zenoh_util/zenoh_session.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "intrinsic/platform/pubsub/zenoh_util/zenoh_handle.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic::internal {
+namespace {
+
+using ::intrinsic::testing::IsOk;
+using ::intrinsic::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+// Records the calls to the fake middleware. Only one test runs at a time.
+std::vector<std::string>* calls = nullptr;
+imw_ret_t init_result = IMW_OK;
+
+imw_ret_t FakeInit(const char* config) {
+  calls->push_back(std::string("init ") + config);
+  return init_result;
+}
+
+imw_ret_t FakeFini() {
+  calls->push_back("fini");
+  return IMW_OK;
+}
+
+class ZenohSessionTest : public ::testing::Test {
+ protected:
+  ZenohSessionTest() {
+    calls = &calls_;
+    init_result = IMW_OK;
+  }
+  ~ZenohSessionTest() override { calls = nullptr; }
+
+  std::vector<std::string> calls_;
+  ZenohSession session_{&FakeInit, &FakeFini};
+};
+
+TEST_F(ZenohSessionTest, SharesSessionAmongUsers) {
+  ASSERT_THAT(session_.Acquire("a"), IsOk());
+  ASSERT_THAT(session_.Acquire("a"), IsOk());
+  EXPECT_EQ(session_.num_users(), 2);
+  session_.Release();
+  session_.Release();
+
+  EXPECT_THAT(calls_, ElementsAre("init a"));
+  EXPECT_EQ(session_.num_users(), 0);
+}
+
+TEST_F(ZenohSessionTest, ReusesIdleSession) {
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_THAT(session_.Acquire("a"), IsOk());
+    session_.Release();
+  }
+
+  EXPECT_THAT(calls_, ElementsAre("init a"));
+  EXPECT_TRUE(session_.is_open());
+}
+
+TEST_F(ZenohSessionTest, ReopensIdleSessionWithDifferentConfig) {
+  ASSERT_THAT(session_.Acquire("a"), IsOk());
+  session_.Release();
+  ASSERT_THAT(session_.Acquire("b"), IsOk());
+
+  EXPECT_THAT(calls_, ElementsAre("init a", "fini", "init b"));
+}
+
+TEST_F(ZenohSessionTest, SharesUsedSessionWithDifferentConfig) {
+  ASSERT_THAT(session_.Acquire("a"), IsOk());
+  ASSERT_THAT(session_.Acquire("b"), IsOk());
+
+  EXPECT_THAT(calls_, ElementsAre("init a"));
+  EXPECT_EQ(session_.num_users(), 2);
+}
+
+TEST_F(ZenohSessionTest, CloseIfIdle) {
+  ASSERT_THAT(session_.Acquire("a"), IsOk());
+  session_.CloseIfIdle();
+  EXPECT_TRUE(session_.is_open());
+
+  session_.Release();
+  session_.CloseIfIdle();
+  EXPECT_FALSE(session_.is_open());
+  EXPECT_THAT(calls_, ElementsAre("init a", "fini"));
+}
+
+TEST_F(ZenohSessionTest, ReturnsInitError) {
+  init_result = IMW_ERROR;
+  EXPECT_THAT(session_.Acquire("a"), StatusIs(absl::StatusCode::kInternal));
+  EXPECT_FALSE(session_.is_open());
+  EXPECT_EQ(session_.num_users(), 0);
+
+  session_.CloseIfIdle();
+  EXPECT_THAT(calls_, ElementsAre("init a"));
+}
+
+TEST_F(ZenohSessionTest, DoesNothingWithoutSession) {
+  session_.CloseIfIdle();
+  EXPECT_THAT(calls_, IsEmpty());
+}
+
+}  // namespace
+}  // namespace intrinsic::internal
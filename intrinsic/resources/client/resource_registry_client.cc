@@ -2,15 +2,25 @@
 
 #include "intrinsic/resources/client/resource_registry_client.h"
 
-#include <iterator>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "grpcpp/client_context.h"
 #include "intrinsic/resources/proto/resource_registry.grpc.pb.h"
 #include "intrinsic/resources/proto/resource_registry.pb.h"
@@ -21,54 +31,172 @@
 namespace intrinsic {
 namespace resources {
 
+namespace {
+
+using ::intrinsic_proto::resources::ListResourceInstanceRequest;
+using ::intrinsic_proto::resources::ResourceInstance;
+
+// The largest page the service returns. Larger pages mean fewer round trips
+// when listing large cells.
+constexpr int64_t kListPageSize = 200;
+
+}  // namespace
+
 absl::StatusOr<std::unique_ptr<ResourceRegistryClient>>
 CreateResourceRegistryClient(absl::string_view grpc_address,
                              absl::Duration timeout,
-                             absl::Duration connection_timeout) {
+                             absl::Duration connection_timeout,
+                             absl::Duration cache_max_age) {
   INTR_ASSIGN_OR_RETURN(
       std::shared_ptr<grpc::Channel> channel,
       CreateClientChannel(grpc_address, absl::Now() + connection_timeout));
   return std::make_unique<ResourceRegistryClient>(
-      intrinsic_proto::resources::ResourceRegistry::NewStub(channel), timeout);
+      intrinsic_proto::resources::ResourceRegistry::NewStub(channel), timeout,
+      cache_max_age);
 }
 
-absl::StatusOr<std::vector<intrinsic_proto::resources::ResourceInstance>>
+absl::StatusOr<std::vector<ResourceInstance>>
 ResourceRegistryClient::ListResources(
-    const intrinsic_proto::resources::ListResourceInstanceRequest::StrictFilter
-        &filter) const {
-  std::vector<intrinsic_proto::resources::ResourceInstance> resource_instances;
+    const ListResourceInstanceRequest::StrictFilter &filter) const {
+  std::vector<ResourceInstance> resource_instances;
+  INTR_RETURN_IF_ERROR(
+      ForEachResource(filter, [&](ResourceInstance instance) {
+        resource_instances.push_back(std::move(instance));
+        return absl::OkStatus();
+      }));
+  return resource_instances;
+}
+
+absl::Status ResourceRegistryClient::ForEachResource(
+    const ListResourceInstanceRequest::StrictFilter &filter,
+    absl::FunctionRef<absl::Status(ResourceInstance instance)> fn) const {
   std::string page_token;
   auto deadline = absl::ToChronoTime(absl::Now() + timeout_);
   do {
     ::grpc::ClientContext context;
     context.set_deadline(deadline);
-    intrinsic_proto::resources::ListResourceInstanceRequest req;
+    ListResourceInstanceRequest req;
     intrinsic_proto::resources::ListResourceInstanceResponse resp;
+    req.set_page_size(kListPageSize);
     req.set_page_token(page_token);
     *req.mutable_strict_filter() = filter;
     INTR_RETURN_IF_ERROR(
         ToAbslStatus(stub_->ListResourceInstances(&context, req, &resp)));
-    resource_instances.insert(resource_instances.end(),
-                              std::make_move_iterator(resp.instances().begin()),
-                              std::make_move_iterator(resp.instances().end()));
+    const absl::Time fetch_time = absl::Now();
+    for (ResourceInstance &instance : *resp.mutable_instances()) {
+      Cache(instance, fetch_time);
+      INTR_RETURN_IF_ERROR(fn(std::move(instance)));
+    }
     page_token = resp.next_page_token();
   } while (!page_token.empty());
 
-  return resource_instances;
+  return absl::OkStatus();
 }
 
-absl::StatusOr<intrinsic_proto::resources::ResourceInstance>
-ResourceRegistryClient::GetResource(absl::string_view name) const {
+absl::StatusOr<ResourceInstance> ResourceRegistryClient::GetResource(
+    absl::string_view name) const {
+  if (cache_max_age_ > absl::ZeroDuration()) {
+    absl::ReaderMutexLock lock(&cache_mutex_);
+    if (const ResourceInstance *cached = FindCached(name, absl::Now());
+        cached != nullptr) {
+      return *cached;
+    }
+  }
+
   ::grpc::ClientContext context;
   context.set_deadline(absl::ToChronoTime(absl::Now() + timeout_));
 
   intrinsic_proto::resources::GetResourceInstanceRequest req;
-  intrinsic_proto::resources::ResourceInstance instance;
+  ResourceInstance instance;
   req.set_name(name);
   INTR_RETURN_IF_ERROR(
       ToAbslStatus(stub_->GetResourceInstance(&context, req, &instance)));
+  Cache(instance, absl::Now());
   return instance;
 }
 
+absl::StatusOr<std::vector<ResourceInstance>>
+ResourceRegistryClient::GetResources(
+    absl::Span<const std::string> names) const {
+  std::vector<ResourceInstance> instances(names.size());
+  // Indices into `names` of the instances to fetch, by name.
+  absl::flat_hash_map<absl::string_view, std::vector<size_t>> missing;
+  {
+    absl::ReaderMutexLock lock(&cache_mutex_);
+    const absl::Time now = absl::Now();
+    for (size_t i = 0; i < names.size(); ++i) {
+      if (const ResourceInstance *cached = FindCached(names[i], now);
+          cached != nullptr) {
+        instances[i] = *cached;
+      } else {
+        missing[names[i]].push_back(i);
+      }
+    }
+  }
+  if (missing.empty()) {
+    return instances;
+  }
+  if (missing.size() == 1) {
+    const auto &[name, indices] = *missing.begin();
+    INTR_ASSIGN_OR_RETURN(ResourceInstance instance, GetResource(name));
+    for (size_t i : indices) {
+      instances[i] = instance;
+    }
+    return instances;
+  }
+
+  // A single listing of all instances takes one round trip per 200 instances,
+  // rather than one per missing instance.
+  INTR_RETURN_IF_ERROR(ForEachResource(
+      ListResourceInstanceRequest::StrictFilter(),
+      [&](ResourceInstance instance) {
+        auto it = missing.find(instance.name());
+        if (it == missing.end()) {
+          return absl::OkStatus();
+        }
+        for (size_t i : it->second) {
+          instances[i] = instance;
+        }
+        missing.erase(it);
+        return absl::OkStatus();
+      }));
+  if (!missing.empty()) {
+    std::vector<absl::string_view> missing_names;
+    missing_names.reserve(missing.size());
+    for (const auto &[name, indices] : missing) {
+      missing_names.push_back(name);
+    }
+    std::sort(missing_names.begin(), missing_names.end());
+    return absl::NotFoundError(
+        absl::StrCat("Resource instances not found: ",
+                     absl::StrJoin(missing_names, ", ")));
+  }
+  return instances;
+}
+
+void ResourceRegistryClient::InvalidateCache() const {
+  absl::MutexLock lock(&cache_mutex_);
+  cache_.clear();
+}
+
+const ResourceInstance *ResourceRegistryClient::FindCached(
+    absl::string_view name, absl::Time now) const {
+  auto it = cache_.find(name);
+  if (it == cache_.end() || now - it->second.fetch_time > cache_max_age_) {
+    return nullptr;
+  }
+  return &it->second.instance;
+}
+
+void ResourceRegistryClient::Cache(const ResourceInstance &instance,
+                                   absl::Time fetch_time) const {
+  if (cache_max_age_ <= absl::ZeroDuration()) {
+    return;
+  }
+  absl::MutexLock lock(&cache_mutex_);
+  cache_.insert_or_assign(instance.name(), CacheEntry{.instance = instance,
+                                                     .fetch_time = fetch_time});
+}
+
 }  // namespace resources
 }  // namespace intrinsic
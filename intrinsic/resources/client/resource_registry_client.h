@@ -4,12 +4,19 @@
 #define INTRINSIC_RESOURCES_CLIENT_RESOURCE_REGISTRY_CLIENT_H_
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "intrinsic/resources/client/resource_registry_client_interface.h"
 #include "intrinsic/resources/proto/resource_registry.grpc.pb.h"
 #include "intrinsic/resources/proto/resource_registry.pb.h"
@@ -23,33 +30,89 @@ class ResourceRegistryClient;
 // Creates a client that connects to the public resource registry service.
 // Parameter connection_timeout is used when establishing the initial connection
 // to the service. Parameter timeout is the timeout used for every request.
+// Parameter cache_max_age is how long the client may answer from its cache of
+// resource instances; see ResourceRegistryClient.
 absl::StatusOr<std::unique_ptr<ResourceRegistryClient>>
-CreateResourceRegistryClient(absl::string_view grpc_address,
-                             absl::Duration timeout = absl::Seconds(60),
-                             absl::Duration connection_timeout =
-                                 intrinsic::kGrpcClientConnectDefaultTimeout);
+CreateResourceRegistryClient(
+    absl::string_view grpc_address, absl::Duration timeout = absl::Seconds(60),
+    absl::Duration connection_timeout =
+        intrinsic::kGrpcClientConnectDefaultTimeout,
+    absl::Duration cache_max_age = absl::ZeroDuration());
 
 // A client for the public resource registry service.
+//
+// If `cache_max_age` is positive, the client remembers every resource instance
+// it receives and answers GetResource() and GetResources() from memory for
+// that long. Resource instances only change when a solution is (re)deployed,
+// so callers that resolve the same resources repeatedly, e.g., for every
+// skill execution, should enable the cache and call InvalidateCache() when
+// they learn of a deployment. ListResources() always queries the service.
+//
+// Thread safe.
 class ResourceRegistryClient : public ResourceRegistryClientInterface {
  public:
   explicit ResourceRegistryClient(
       std::unique_ptr<
           intrinsic_proto::resources::ResourceRegistry::StubInterface>
           stub,
-      absl::Duration timeout)
-      : stub_(std::move(stub)), timeout_(timeout) {}
+      absl::Duration timeout,
+      absl::Duration cache_max_age = absl::ZeroDuration())
+      : stub_(std::move(stub)),
+        timeout_(timeout),
+        cache_max_age_(cache_max_age) {}
 
   absl::StatusOr<std::vector<intrinsic_proto::resources::ResourceInstance>>
   ListResources(const intrinsic_proto::resources::ListResourceInstanceRequest::
                     StrictFilter &filter) const override;
 
+  // Calls `fn` for every resource instance that matches `filter`, one page of
+  // the listing at a time, without collecting all instances first. Stops and
+  // returns the error if `fn` returns one.
+  absl::Status ForEachResource(
+      const intrinsic_proto::resources::ListResourceInstanceRequest::
+          StrictFilter &filter,
+      absl::FunctionRef<absl::Status(
+          intrinsic_proto::resources::ResourceInstance instance)>
+          fn) const;
+
   absl::StatusOr<intrinsic_proto::resources::ResourceInstance> GetResource(
       absl::string_view name) const override;
 
+  // Returns the resource instances with `names`, in the same order. Fetches
+  // all instances that are not cached with a single listing instead of one
+  // request per name.
+  //
+  // Returns NotFoundError if any of `names` does not exist.
+  absl::StatusOr<std::vector<intrinsic_proto::resources::ResourceInstance>>
+  GetResources(absl::Span<const std::string> names) const override;
+
+  // Forgets all cached resource instances.
+  void InvalidateCache() const;
+
  private:
+  struct CacheEntry {
+    intrinsic_proto::resources::ResourceInstance instance;
+    absl::Time fetch_time;
+  };
+
+  // Returns the cached instance with `name`, or nullptr if there is none or
+  // it is too old.
+  const intrinsic_proto::resources::ResourceInstance *FindCached(
+      absl::string_view name, absl::Time now) const
+      ABSL_SHARED_LOCKS_REQUIRED(cache_mutex_);
+
+  // Adds `instance` to the cache if caching is enabled.
+  void Cache(const intrinsic_proto::resources::ResourceInstance &instance,
+             absl::Time fetch_time) const;
+
   std::unique_ptr<intrinsic_proto::resources::ResourceRegistry::StubInterface>
       stub_;
   const absl::Duration timeout_;
+  const absl::Duration cache_max_age_;
+
+  mutable absl::Mutex cache_mutex_;
+  mutable absl::flat_hash_map<std::string, CacheEntry> cache_
+      ABSL_GUARDED_BY(cache_mutex_);
 };
 
 }  // namespace resources
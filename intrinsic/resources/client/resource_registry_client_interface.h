@@ -3,10 +3,14 @@
 #ifndef INTRINSIC_RESOURCES_CLIENT_RESOURCE_REGISTRY_CLIENT_INTERFACE_H_
 #define INTRINSIC_RESOURCES_CLIENT_RESOURCE_REGISTRY_CLIENT_INTERFACE_H_
 
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "intrinsic/util/status/status_macros.h"
 #include "intrinsic/resources/proto/resource_registry.pb.h"
 
 namespace intrinsic {
@@ -24,6 +28,24 @@ class ResourceRegistryClientInterface {
 
   virtual absl::StatusOr<intrinsic_proto::resources::ResourceInstance>
   GetResource(absl::string_view id) const = 0;
+
+  // Returns the resource instances with `names`, in the same order.
+  //
+  // The default implementation calls GetResource() for every name;
+  // implementations should override it to need fewer round trips.
+  virtual absl::StatusOr<
+      std::vector<intrinsic_proto::resources::ResourceInstance>>
+  GetResources(absl::Span<const std::string> names) const {
+    std::vector<intrinsic_proto::resources::ResourceInstance> instances;
+    instances.reserve(names.size());
+    for (const std::string& name : names) {
+      INTR_ASSIGN_OR_RETURN(
+          intrinsic_proto::resources::ResourceInstance instance,
+          GetResource(name));
+      instances.push_back(std::move(instance));
+    }
+    return instances;
+  }
 };
 
 }  // namespace resources
@@ -2,13 +2,20 @@
 
 #include "intrinsic/skills/cc/equipment_pack.h"
 
+#include <memory>
 #include <string>
+#include <tuple>
+#include <utility>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
 #include "intrinsic/resources/proto/resource_handle.pb.h"
 #include "intrinsic/skills/proto/equipment.pb.h"
 #include "intrinsic/skills/proto/skill_service.pb.h"
@@ -17,11 +24,25 @@
 namespace intrinsic {
 namespace skills {
 
+struct EquipmentPack::UnpackCache {
+  // Slot key, equipment type and message type of the contents.
+  using Key =
+      std::tuple<std::string, std::string, const google::protobuf::Descriptor*>;
+
+  absl::Mutex mutex;
+  absl::flat_hash_map<Key, std::shared_ptr<const google::protobuf::Message>>
+      contents ABSL_GUARDED_BY(mutex);
+};
+
+EquipmentPack::EquipmentPack()
+    : unpack_cache_(std::make_shared<UnpackCache>()) {}
+
 EquipmentPack::EquipmentPack(
     const google::protobuf::Map<std::string,
                                 intrinsic_proto::resources::ResourceHandle>&
         resource_handles)
-    : equipment_map_(resource_handles.begin(), resource_handles.end()) {}
+    : equipment_map_(resource_handles.begin(), resource_handles.end()),
+      unpack_cache_(std::make_shared<UnpackCache>()) {}
 
 absl::StatusOr<EquipmentPack> EquipmentPack::GetEquipmentPack(
     const intrinsic_proto::skills::PredictRequest& request) {
@@ -76,6 +97,7 @@ absl::Status EquipmentPack::Remove(absl::string_view key) {
   if (equipment_map_.erase(key) == 0) {
     return internal::MissingEquipmentError(key);
   }
+  unpack_cache_ = std::make_shared<UnpackCache>();
   return absl::OkStatus();
 }
 
@@ -87,9 +109,74 @@ absl::Status EquipmentPack::Add(
   }
 
   equipment_map_[key] = handle;
+  unpack_cache_ = std::make_shared<UnpackCache>();
   return absl::OkStatus();
 }
 
+absl::StatusOr<std::shared_ptr<const google::protobuf::Message>>
+EquipmentPack::GetUnpackedMessage(
+    absl::string_view key, absl::string_view type,
+    const google::protobuf::Message& prototype) const {
+  auto handle = equipment_map_.find(key);
+  if (handle == equipment_map_.end()) {
+    return internal::MissingEquipmentError(key);
+  }
+
+  const auto& resource_data = handle->second.resource_data();
+  auto data = resource_data.find(std::string(type));
+  if (data == resource_data.end()) {
+    return absl::NotFoundError(absl::StrCat("Could not find equipment typed '",
+                                            type, "' with slot key '", key,
+                                            "'"));
+  }
+
+  UnpackCache::Key cache_key(key, type, prototype.GetDescriptor());
+  {
+    absl::MutexLock lock(&unpack_cache_->mutex);
+    if (auto cached = unpack_cache_->contents.find(cache_key);
+        cached != unpack_cache_->contents.end()) {
+      return cached->second;
+    }
+  }
+
+  // Unpacks without the lock. Concurrent lookups of the same contents may
+  // both unpack them, and keep the first.
+  std::shared_ptr<google::protobuf::Message> equipment(prototype.New());
+  if (!data->second.contents().UnpackTo(equipment.get())) {
+    return internal::EquipmentContentsTypeError();
+  }
+  absl::MutexLock lock(&unpack_cache_->mutex);
+  return unpack_cache_->contents.try_emplace(cache_key, std::move(equipment))
+      .first->second;
+}
+
+void EquipmentPack::UnpackAll() const {
+  for (const auto& [key, handle] : equipment_map_) {
+    for (const auto& [type, data] : handle.resource_data()) {
+      std::string message_name;
+      if (!google::protobuf::Any::ParseAnyTypeUrl(data.contents().type_url(),
+                                                  &message_name)) {
+        continue;
+      }
+      const google::protobuf::Descriptor* descriptor =
+          google::protobuf::DescriptorPool::generated_pool()
+              ->FindMessageTypeByName(message_name);
+      if (descriptor == nullptr) {
+        continue;
+      }
+      // The generated prototype has the type that GetUnpacked<>() casts to.
+      const google::protobuf::Message* prototype =
+          google::protobuf::MessageFactory::generated_factory()->GetPrototype(
+              descriptor);
+      if (prototype == nullptr) {
+        continue;
+      }
+      // Errors are reported again when the contents are looked up.
+      GetUnpackedMessage(key, type, *prototype).IgnoreError();
+    }
+  }
+}
+
 namespace internal {
 
 absl::Status MissingEquipmentError(absl::string_view key) {
@@ -3,6 +3,7 @@
 #ifndef INTRINSIC_SKILLS_CC_EQUIPMENT_PACK_H_
 #define INTRINSIC_SKILLS_CC_EQUIPMENT_PACK_H_
 
+#include <memory>
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
@@ -11,6 +12,7 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "google/protobuf/any.pb.h"
+#include "google/protobuf/message.h"
 #include "intrinsic/resources/proto/resource_handle.pb.h"
 #include "intrinsic/skills/proto/equipment.pb.h"
 #include "intrinsic/skills/proto/skill_service.pb.h"
@@ -20,6 +22,9 @@ namespace skills {
 
 // Provides easy access to the contents of a proto::ResourceHandle map, based
 // on the equipment key.
+//
+// Unpacked contents are cached, so that each is parsed at most once, and
+// shared between copies of the pack until they are modified.
 class EquipmentPack {
  private:
   using EquipmentMap =
@@ -28,7 +33,7 @@ class EquipmentPack {
   using EquipmentIterator = EquipmentMap::const_iterator;
 
  public:
-  EquipmentPack() = default;
+  EquipmentPack();
   explicit EquipmentPack(
       const google::protobuf::Map<std::string,
                                   intrinsic_proto::resources::ResourceHandle>&
@@ -53,6 +58,19 @@ class EquipmentPack {
   absl::StatusOr<EquipmentType> Unpack(absl::string_view key,
                                        absl::string_view type) const;
 
+  // Like Unpack(), but returns the cached contents instead of a copy. Prefer
+  // this for contents that are read repeatedly.
+  //
+  // Thread safe.
+  template <typename EquipmentType>
+  absl::StatusOr<std::shared_ptr<const EquipmentType>> GetUnpacked(
+      absl::string_view key, absl::string_view type) const;
+
+  // Unpacks the contents of all equipment into the cache, so that later
+  // lookups do not parse. Skips contents whose message type is not linked into
+  // the binary, or that cannot be parsed; looking those up reports the error.
+  void UnpackAll() const;
+
   // Returns the resource handle itself for the given key. This is useful if
   // you need something other than the content of the equipment.
   absl::StatusOr<intrinsic_proto::resources::ResourceHandle> GetHandle(
@@ -70,7 +88,17 @@ class EquipmentPack {
   EquipmentIterator end() const { return equipment_map_.end(); }
 
  private:
+  struct UnpackCache;
+
+  // Returns the contents of type `type` of the equipment at `key`, unpacked
+  // into a new instance of `prototype`'s type, and caches them.
+  absl::StatusOr<std::shared_ptr<const google::protobuf::Message>>
+  GetUnpackedMessage(absl::string_view key, absl::string_view type,
+                     const google::protobuf::Message& prototype) const;
+
   EquipmentMap equipment_map_;
+  // Replaced when the equipment changes, so that copies keep theirs.
+  std::shared_ptr<UnpackCache> unpack_cache_;
 };
 
 namespace internal {
@@ -83,23 +111,25 @@ absl::Status EquipmentContentsTypeError();
 template <typename EquipmentType>
 absl::StatusOr<EquipmentType> EquipmentPack::Unpack(
     absl::string_view key, absl::string_view type) const {
-  if (!equipment_map_.contains(key)) {
-    return internal::MissingEquipmentError(key);
-  }
-
-  const auto& resource_data = equipment_map_.at(key).resource_data();
-  if (!resource_data.contains(std::string(type))) {
-    return absl::NotFoundError(absl::StrCat("Could not find equipment typed '",
-                                            type, "' with slot key '", key,
-                                            "'"));
+  absl::StatusOr<std::shared_ptr<const EquipmentType>> equipment =
+      GetUnpacked<EquipmentType>(key, type);
+  if (!equipment.ok()) {
+    return equipment.status();
   }
+  return **equipment;
+}
 
-  EquipmentType equipment;
-  if (!resource_data.at(std::string(type)).contents().UnpackTo(&equipment)) {
-    return internal::EquipmentContentsTypeError();
+template <typename EquipmentType>
+absl::StatusOr<std::shared_ptr<const EquipmentType>>
+EquipmentPack::GetUnpacked(absl::string_view key,
+                           absl::string_view type) const {
+  absl::StatusOr<std::shared_ptr<const google::protobuf::Message>> equipment =
+      GetUnpackedMessage(key, type, EquipmentType::default_instance());
+  if (!equipment.ok()) {
+    return equipment.status();
   }
-
-  return equipment;
+  // Cached contents are instances of the prototype's type.
+  return std::static_pointer_cast<const EquipmentType>(*std::move(equipment));
 }
 
 }  // namespace skills
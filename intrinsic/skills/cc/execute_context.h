@@ -5,6 +5,7 @@
 #define INTRINSIC_SKILLS_CC_EXECUTE_CONTEXT_H_
 
 #include "absl/status/statusor.h"
+#include "google/protobuf/message.h"
 #include "intrinsic/logging/proto/context.pb.h"
 #include "intrinsic/motion_planning/motion_planner_client.h"
 #include "intrinsic/skills/cc/equipment_pack.h"
@@ -44,6 +45,16 @@ class ExecuteContext {
 
   // A client for interacting with the object world.
   virtual world::ObjectWorldClient& object_world() = 0;
+
+  // Reports the fraction of the work that is done, between 0 and 1, to the
+  // clients that watch the operation.
+  virtual void ReportProgress(double progress) {}
+
+  // Reports a partial result, e.g., the objects detected so far, to the
+  // clients that watch the operation, so that they can act on it before the
+  // skill finishes. Partial results are not included in the final result.
+  virtual void ReportPartialResult(
+      const google::protobuf::Message& partial_result) {}
 };
 
 }  // namespace skills
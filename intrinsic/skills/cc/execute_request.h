@@ -3,6 +3,7 @@
 #ifndef INTRINSIC_SKILLS_CC_EXECUTE_REQUEST_H_
 #define INTRINSIC_SKILLS_CC_EXECUTE_REQUEST_H_
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <utility>
@@ -13,6 +14,7 @@
 #include "google/protobuf/any.pb.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
+#include "intrinsic/skills/internal/default_parameters.h"
 #include "intrinsic/util/proto/any.h"
 
 namespace intrinsic {
@@ -28,8 +30,10 @@ class ExecuteRequest {
       ::google::protobuf::Message* param_defaults = nullptr) {
     params_any_.PackFrom(params);
     if (param_defaults != nullptr) {
-      param_defaults_any_ = google::protobuf::Any();
-      param_defaults_any_->PackFrom(*param_defaults);
+      google::protobuf::Any param_defaults_any;
+      param_defaults_any.PackFrom(*param_defaults);
+      param_defaults_ =
+          std::make_shared<const ParameterDefaults>(param_defaults_any);
     }
   }
 
@@ -42,12 +46,26 @@ class ExecuteRequest {
   explicit ExecuteRequest(google::protobuf::Any params,
                           std::optional<::google::protobuf::Any> param_defaults)
       : params_any_(std::move(params)),
-        param_defaults_any_(std::move(param_defaults)) {}
+        param_defaults_(param_defaults.has_value()
+                            ? std::make_shared<const ParameterDefaults>(
+                                  *std::move(param_defaults))
+                            : nullptr) {}
+
+  // Like above, with the defaults of the skill, which are compiled once for
+  // all of its requests.
+  explicit ExecuteRequest(
+      google::protobuf::Any params,
+      std::shared_ptr<const ParameterDefaults> param_defaults)
+      : params_any_(std::move(params)),
+        param_defaults_(std::move(param_defaults)) {}
 
   // The skill parameters proto.
   template <class TParams>
   absl::StatusOr<TParams> params() const {
-    return UnpackAnyAndMerge<TParams>(params_any_, param_defaults_any_);
+    if (param_defaults_ == nullptr) {
+      return UnpackAny<TParams>(params_any_);
+    }
+    return param_defaults_->Unpack<TParams>(params_any_);
   }
 
   // The skill parameters proto as an Any.
@@ -55,7 +73,7 @@ class ExecuteRequest {
 
  private:
   ::google::protobuf::Any params_any_;
-  std::optional<::google::protobuf::Any> param_defaults_any_;
+  std::shared_ptr<const ParameterDefaults> param_defaults_;
 };
 
 }  // namespace skills
@@ -2,14 +2,23 @@
 
 #include "intrinsic/skills/cc/skill_canceller.h"
 
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
 
 #include "absl/functional/any_invocable.h"
+#include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
 #include "absl/time/time.h"
 #include "intrinsic/util/status/status_macros.h"
 
@@ -17,8 +26,23 @@ namespace intrinsic {
 namespace skills {
 
 SkillCancellationManager::SkillCancellationManager(
-    const absl::Duration ready_timeout, const absl::string_view operation_name)
-    : ready_timeout_(ready_timeout), operation_name_(operation_name) {}
+    const absl::Duration ready_timeout, const absl::string_view operation_name,
+    const absl::Duration callback_timeout)
+    : ready_timeout_(ready_timeout),
+      callback_timeout_(callback_timeout),
+      cancelled_fd_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)),
+      operation_name_(operation_name) {
+  if (cancelled_fd_ < 0) {
+    LOG(WARNING) << "Creating the cancellation eventfd of " << operation_name_
+                 << " failed: " << std::strerror(errno);
+  }
+}
+
+SkillCancellationManager::~SkillCancellationManager() {
+  if (cancelled_fd_ >= 0) {
+    close(cancelled_fd_);
+  }
+}
 
 absl::Status SkillCancellationManager::Cancel() {
   INTR_RETURN_IF_ERROR(WaitForReady());
@@ -33,15 +57,46 @@ absl::Status SkillCancellationManager::Cancel() {
     }
 
     cancelled_.Notify();
+    if (cancelled_fd_ >= 0) {
+      // The counter is never reset, so the fd stays readable.
+      const uint64_t value = 1;
+      if (write(cancelled_fd_, &value, sizeof(value)) != sizeof(value)) {
+        LOG(WARNING) << "Signaling the cancellation eventfd of "
+                     << operation_name_ << " failed: " << std::strerror(errno);
+      }
+    }
   }
 
   if (callback_ != nullptr) {
-    INTR_RETURN_IF_ERROR((*callback_)());
+    if (callback_timeout_ == absl::InfiniteDuration()) {
+      INTR_RETURN_IF_ERROR((*callback_)());
+    } else {
+      INTR_RETURN_IF_ERROR(CallCallbackWithTimeout());
+    }
   }
 
   return absl::OkStatus();
 }
 
+absl::Status SkillCancellationManager::CallCallbackWithTimeout() {
+  struct Result {
+    absl::Notification done;
+    absl::Status status;
+  };
+  auto result = std::make_shared<Result>();
+  std::thread([callback = callback_, result]() {
+    result->status = (*callback)();
+    result->done.Notify();
+  }).detach();
+
+  if (!result->done.WaitForNotificationWithTimeout(callback_timeout_)) {
+    return absl::DeadlineExceededError(absl::Substitute(
+        "The cancellation callback of $0 did not return within $1.",
+        operation_name_, absl::FormatDuration(callback_timeout_)));
+  }
+  return result->status;
+}
+
 absl::Status SkillCancellationManager::RegisterCallback(
     absl::AnyInvocable<absl::Status() const> callback) {
   absl::MutexLock lock(&cancel_mu_);
@@ -54,7 +109,7 @@ absl::Status SkillCancellationManager::RegisterCallback(
   if (callback_ != nullptr) {
     return absl::AlreadyExistsError("A callback was already registered.");
   }
-  callback_ = std::make_unique<absl::AnyInvocable<absl::Status() const>>(
+  callback_ = std::make_shared<absl::AnyInvocable<absl::Status() const>>(
       std::move(callback));
 
   return absl::OkStatus();
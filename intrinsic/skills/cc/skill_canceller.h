@@ -25,10 +25,12 @@ namespace skills {
 //
 // The skill must call Ready() once it is ready to be cancelled.
 //
-// A skill can implement cancellation in one of two ways:
+// A skill can implement cancellation in one of three ways:
 // 1) Poll cancelled(), and safely cancel if and when it becomes true.
 // 2) Register a callback via RegisterCallback(). This callback will be invoked
 //    when the skill receives a cancellation request.
+// 3) Wait for cancellation_fd() to become readable in its own event loop,
+//    together with sockets, queues and other file descriptors.
 class SkillCanceller {
  public:
   virtual ~SkillCanceller() = default;
@@ -50,18 +52,34 @@ class SkillCanceller {
   //
   // Returns true if the skill was cancelled.
   virtual bool Wait(absl::Duration timeout) = 0;
+
+  // Returns a file descriptor that becomes readable once the skill is
+  // cancelled, for use with poll(2), select(2) or epoll(7). It stays readable
+  // afterwards and must neither be read from nor closed.
+  //
+  // Returns -1 if the canceller does not provide a file descriptor.
+  virtual int cancellation_fd() const { return -1; }
 };
 
 // A SkillCanceller used by the skill service to cancel skills.
 class SkillCancellationManager : public SkillCanceller {
  public:
+  // Cancel() waits for up to `ready_timeout` for the skill to become ready,
+  // and then for up to `callback_timeout` for the registered callback.
   explicit SkillCancellationManager(
       absl::Duration ready_timeout,
-      absl::string_view operation_name = "operation");
+      absl::string_view operation_name = "operation",
+      absl::Duration callback_timeout = absl::InfiniteDuration());
+
+  ~SkillCancellationManager() override;
 
   bool cancelled() override { return cancelled_.HasBeenNotified(); };
 
-  // Sets the cancelled flag and calls the callback (if set).
+  // Sets the cancelled flag, signals cancellation_fd() and calls the callback
+  // (if set).
+  //
+  // Returns DeadlineExceededError if the callback does not return within the
+  // callback timeout. The callback keeps running in the background then.
   absl::Status Cancel();
 
   void Ready() override { ready_.Notify(); };
@@ -73,15 +91,27 @@ class SkillCancellationManager : public SkillCanceller {
     return cancelled_.WaitForNotificationWithTimeout(timeout);
   };
 
+  int cancellation_fd() const override { return cancelled_fd_; }
+
   // Waits for the skill to be ready for cancellation.
   absl::Status WaitForReady();
 
  private:
+  // Calls the callback on a separate thread and waits for it for up to
+  // `callback_timeout_`.
+  absl::Status CallCallbackWithTimeout();
+
   absl::Mutex cancel_mu_;
   absl::Notification ready_;
   absl::Duration ready_timeout_;
+  absl::Duration callback_timeout_;
   absl::Notification cancelled_;
-  std::unique_ptr<absl::AnyInvocable<absl::Status() const>> callback_;
+  // An eventfd that is signaled on cancellation, or -1 if it could not be
+  // created.
+  int cancelled_fd_;
+  // Shared with the thread of CallCallbackWithTimeout(), which may outlive
+  // this object.
+  std::shared_ptr<absl::AnyInvocable<absl::Status() const>> callback_;
 
   std::string operation_name_;
 };
@@ -16,8 +16,12 @@ import (
 )
 
 type templateCCParameters struct {
-	CCHeaderPaths     []string
-	CreateSkillMethod string
+	CCHeaderPaths      []string
+	CreateSkillMethod  string
+	MaxIdleInstances   uint32
+	PrewarmedInstances uint32
+	ResetSkillMethod   string
+	WarmUpSkillMethod  string
 }
 
 type templatePyParameters struct {
@@ -115,10 +119,15 @@ func WriteSkillServiceCC(manifestPath string, ccHeaderPaths []string, out string
 		return fmt.Errorf("cannot read manifest: %v", err)
 	}
 
+	ccConfig := manifest.GetOptions().GetCcConfig()
 	return writeCCTemplateOutput(
 		templateCCParameters{
-			CCHeaderPaths:     ccHeaderPaths,
-			CreateSkillMethod: manifest.GetOptions().GetCcConfig().GetCreateSkill(),
+			CCHeaderPaths:      ccHeaderPaths,
+			CreateSkillMethod:  ccConfig.GetCreateSkill(),
+			MaxIdleInstances:   ccConfig.GetInstancePool().GetMaxIdleInstances(),
+			PrewarmedInstances: ccConfig.GetInstancePool().GetPrewarmedInstances(),
+			ResetSkillMethod:   ccConfig.GetInstancePool().GetResetSkill(),
+			WarmUpSkillMethod:  ccConfig.GetInstancePool().GetWarmUpSkill(),
 		},
 		out,
 	)
@@ -73,7 +73,17 @@ int main(int argc, char** argv) {
   // clang-format off
   SingleSkillFactory skill_factory(
       *runtime_data,
-      {{.CreateSkillMethod}});
+      {{.CreateSkillMethod}},
+      {
+          .max_idle_instances = {{.MaxIdleInstances}},
+          .num_prewarmed_instances = {{.PrewarmedInstances}},
+{{- if .ResetSkillMethod }}
+          .reset_skill = {{.ResetSkillMethod}},
+{{- end }}
+{{- if .WarmUpSkillMethod }}
+          .warm_up_skill = {{.WarmUpSkillMethod}},
+{{- end }}
+      });
   // clang-format on
   QCHECK_OK(SkillInit(
       *service_config, absl::GetFlag(FLAGS_data_logger_grpc_service_address),
@@ -3,14 +3,196 @@
 #include "intrinsic/skills/internal/default_parameters.h"
 
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "absl/base/call_once.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "google/protobuf/any.pb.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "google/protobuf/message.h"
 #include "intrinsic/skills/proto/skills.pb.h"
 #include "intrinsic/util/proto/merge.h"
 #include "intrinsic/util/status/status_macros.h"
 
-namespace intrinsic::skills {}  // namespace intrinsic::skills
+namespace intrinsic::skills {
+
+namespace {
+
+using ::google::protobuf::Any;
+using ::google::protobuf::FieldDescriptor;
+using ::google::protobuf::Message;
+using ::google::protobuf::Reflection;
+using ::google::protobuf::io::ArrayInputStream;
+using ::google::protobuf::io::ConcatenatingInputStream;
+using ::google::protobuf::io::ZeroCopyInputStream;
+
+// Returns the full name of the message type of `any`.
+absl::string_view TypeName(const Any& any) {
+  absl::string_view type_url = any.type_url();
+  return type_url.substr(type_url.rfind('/') + 1);
+}
+
+absl::Status CheckType(const Any& any, const Message& message) {
+  if (any.type_url().empty()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Cannot unpack empty Any to ",
+                     message.GetDescriptor()->full_name()));
+  }
+  if (TypeName(any) != message.GetDescriptor()->full_name()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Cannot unpack Any of type ", any.type_url(), " to ",
+                     message.GetDescriptor()->full_name(), "."));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ParseError(const Any& any, const Message& message) {
+  return absl::InternalError(
+      absl::StrCat("Failed to unpack Any of type ", any.type_url(), " to ",
+                   message.GetDescriptor()->full_name(), "."));
+}
+
+// Whether parsing `field` from the wire format over a set value replaces the
+// value, as MergeUnset() keeps a set value, instead of appending to or merging
+// into it.
+bool ParsingReplaces(const FieldDescriptor* field) {
+  return !field->is_repeated() &&
+         field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE;
+}
+
+}  // namespace
+
+ParameterDefaults::ParameterDefaults(Any defaults)
+    : defaults_(std::move(defaults)) {}
+
+void ParameterDefaults::Compile(const Message& prototype) const {
+  descriptor_ = prototype.GetDescriptor();
+  compile_status_ = CheckType(defaults_, prototype);
+  if (!compile_status_.ok()) {
+    return;
+  }
+  std::unique_ptr<Message> defaults(prototype.New());
+  if (!defaults->ParsePartialFromString(defaults_.value())) {
+    compile_status_ = ParseError(defaults_, prototype);
+    return;
+  }
+  const Reflection* reflection = defaults->GetReflection();
+  // MergeUnset() does not copy unknown fields.
+  reflection->MutableUnknownFields(defaults.get())->Clear();
+
+  std::vector<const FieldDescriptor*> fields;
+  reflection->ListFields(*defaults, &fields);
+  std::unique_ptr<Message> scalar_defaults(defaults->New());
+  bool has_unset_defaults = false;
+  for (const FieldDescriptor* field : fields) {
+    if (ParsingReplaces(field)) {
+      reflection->SwapFields(defaults.get(), scalar_defaults.get(), {field});
+    } else {
+      has_unset_defaults = true;
+    }
+  }
+  wire_prefix_ = scalar_defaults->SerializePartialAsString();
+  if (has_unset_defaults) {
+    unset_defaults_ = std::move(defaults);
+  }
+}
+
+absl::Status ParameterDefaults::Unpack(const Any& params,
+                                       Message& message) const {
+  INTR_RETURN_IF_ERROR(CheckType(params, message));
+  absl::call_once(compile_once_, [this, &message]() { Compile(message); });
+  INTR_RETURN_IF_ERROR(compile_status_);
+
+  if (message.GetDescriptor() != descriptor_) {
+    // A type of the same name from another pool, which the compiled defaults
+    // cannot be merged into.
+    std::unique_ptr<Message> defaults(message.New());
+    if (!defaults->ParsePartialFromString(defaults_.value())) {
+      return ParseError(defaults_, message);
+    }
+    if (!message.ParseFromString(params.value())) {
+      return ParseError(params, message);
+    }
+    return MergeUnset(*defaults, message);
+  }
+
+  if (wire_prefix_.empty()) {
+    if (!message.ParsePartialFromString(params.value())) {
+      return ParseError(params, message);
+    }
+  } else {
+    // Parses the parameters after the scalar defaults, without copying them
+    // into one buffer.
+    ArrayInputStream prefix(wire_prefix_.data(), wire_prefix_.size());
+    ArrayInputStream value(params.value().data(), params.value().size());
+    ZeroCopyInputStream* streams[] = {&prefix, &value};
+    ConcatenatingInputStream input(streams, 2);
+    if (!message.ParsePartialFromZeroCopyStream(&input)) {
+      return ParseError(params, message);
+    }
+  }
+  if (unset_defaults_ != nullptr) {
+    INTR_RETURN_IF_ERROR(MergeUnset(*unset_defaults_, message));
+  }
+  if (!message.IsInitialized()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Parameters of type ",
+                     message.GetDescriptor()->full_name(),
+                     " are missing required fields: ",
+                     message.InitializationErrorString()));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ParameterDefaults::Precompile() const {
+  const google::protobuf::Descriptor* descriptor =
+      google::protobuf::DescriptorPool::generated_pool()->FindMessageTypeByName(
+          std::string(TypeName(defaults_)));
+  if (descriptor == nullptr) {
+    return absl::NotFoundError(
+        absl::StrCat("The message type ", defaults_.type_url(),
+                     " of the default parameters is not linked in."));
+  }
+  const Message* prototype =
+      google::protobuf::MessageFactory::generated_factory()->GetPrototype(
+          descriptor);
+  absl::call_once(compile_once_, [this, prototype]() { Compile(*prototype); });
+  return compile_status_;
+}
+
+absl::StatusOr<std::unique_ptr<Message>> ApplyDefaults(const Any& defaults,
+                                                       const Message& params) {
+  INTR_RETURN_IF_ERROR(CheckType(defaults, params));
+  std::unique_ptr<Message> unpacked_defaults(params.New());
+  if (!defaults.UnpackTo(unpacked_defaults.get())) {
+    return ParseError(defaults, params);
+  }
+  std::unique_ptr<Message> merged(params.New());
+  merged->CopyFrom(params);
+  INTR_RETURN_IF_ERROR(MergeUnset(*unpacked_defaults, *merged));
+  return merged;
+}
+
+absl::StatusOr<Any> PackParametersWithDefaults(
+    const intrinsic_proto::skills::SkillInstance& instance,
+    const Message& params) {
+  Any packed;
+  if (!instance.has_default_parameters()) {
+    packed.PackFrom(params);
+    return packed;
+  }
+  INTR_ASSIGN_OR_RETURN(std::unique_ptr<Message> merged,
+                        ApplyDefaults(instance.default_parameters(), params));
+  packed.PackFrom(*merged);
+  return packed;
+}
+
+}  // namespace intrinsic::skills
@@ -4,13 +4,79 @@
 #define INTRINSIC_SKILLS_INTERNAL_DEFAULT_PARAMETERS_H_
 
 #include <memory>
+#include <string>
 
+#include "absl/base/call_once.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "google/protobuf/any.pb.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
 #include "intrinsic/skills/proto/skills.pb.h"
+#include "intrinsic/util/status/status_macros.h"
 
 namespace intrinsic::skills {
 
+// The default parameters of a skill, compiled once for all of its requests.
+//
+// Unpack() applies the defaults with the semantics of MergeUnset(), but
+// without merging through reflection where the wire format gives the same
+// result: singular scalar defaults are serialized into a prefix, which is
+// parsed before the request bytes, so that set parameters override them, and
+// a set member of a oneof clears a default member of the same oneof. Only
+// repeated and message defaults, which parsing would append to or merge into
+// the parameters, are still merged with MergeUnset().
+//
+// The defaults are compiled on the first call to Unpack(), since the
+// parameter type is only known then. Thread safe.
+class ParameterDefaults {
+ public:
+  // `defaults` is the packed default parameters of a skill.
+  explicit ParameterDefaults(google::protobuf::Any defaults);
+
+  ParameterDefaults(const ParameterDefaults&) = delete;
+  ParameterDefaults& operator=(const ParameterDefaults&) = delete;
+
+  const google::protobuf::Any& defaults() const { return defaults_; }
+
+  // Unpacks `params` into `message` and applies the defaults to its unset
+  // fields.
+  //
+  // Returns InvalidArgumentError if the type of `params` or of the defaults
+  // does not match `message`.
+  absl::Status Unpack(const google::protobuf::Any& params,
+                      google::protobuf::Message& message) const;
+
+  template <typename ParamT>
+  absl::StatusOr<ParamT> Unpack(const google::protobuf::Any& params) const {
+    ParamT unpacked;
+    INTR_RETURN_IF_ERROR(Unpack(params, unpacked));
+    return unpacked;
+  }
+
+  // Compiles the defaults ahead of the first call to Unpack(), for the
+  // generated message type named by the defaults.
+  //
+  // Returns NotFoundError if that type is not linked into the binary, and the
+  // error of compiling the defaults otherwise.
+  absl::Status Precompile() const;
+
+ private:
+  // Compiles the defaults for the type of `prototype`.
+  void Compile(const google::protobuf::Message& prototype) const;
+
+  const google::protobuf::Any defaults_;
+
+  mutable absl::once_flag compile_once_;
+  // The type the defaults were compiled for.
+  mutable const google::protobuf::Descriptor* descriptor_ = nullptr;
+  mutable absl::Status compile_status_;
+  // The serialized singular scalar defaults.
+  mutable std::string wire_prefix_;
+  // The repeated and message defaults, or nullptr if there are none.
+  mutable std::unique_ptr<google::protobuf::Message> unset_defaults_;
+};
+
 // Extracts the parameters, then applies defaults to parameters.
 absl::StatusOr<std::unique_ptr<google::protobuf::Message>> ApplyDefaults(
     const google::protobuf::Any& defaults,
@@ -58,7 +58,7 @@ absl::Status ToAbslStatusWithErrorInfo(const ::grpc::Status& grpc_status) {
 
 void SetErrorInfo(const intrinsic_proto::skills::SkillErrorInfo& error_info,
                   absl::Status& status) {
-  status.SetPayload(AddTypeUrlPrefix(error_info.GetTypeName()),
+  status.SetPayload(TypeUrl<intrinsic_proto::skills::SkillErrorInfo>(),
                     absl::Cord(error_info.SerializeAsString()));
 }
 
@@ -66,8 +66,7 @@ intrinsic_proto::skills::SkillErrorInfo GetErrorInfo(
     const absl::Status& status) {
   intrinsic_proto::skills::SkillErrorInfo error_info;
   std::optional<absl::Cord> error_info_cord =
-      status.GetPayload(AddTypeUrlPrefix(
-          intrinsic_proto::skills::SkillErrorInfo::descriptor()->full_name()));
+      status.GetPayload(TypeUrl<intrinsic_proto::skills::SkillErrorInfo>());
   if (error_info_cord) {
     error_info.ParseFromString(std::string(error_info_cord.value()));  // NOLINT
   }
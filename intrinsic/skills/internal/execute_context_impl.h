@@ -3,17 +3,20 @@
 #ifndef INTRINSIC_SKILLS_INTERNAL_EXECUTE_CONTEXT_IMPL_H_
 #define INTRINSIC_SKILLS_INTERNAL_EXECUTE_CONTEXT_IMPL_H_
 
+#include <functional>
 #include <memory>
 #include <utility>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "google/protobuf/message.h"
 #include "intrinsic/logging/proto/context.pb.h"
 #include "intrinsic/motion_planning/motion_planner_client.h"
 #include "intrinsic/skills/cc/equipment_pack.h"
 #include "intrinsic/skills/cc/skill_canceller.h"
 #include "intrinsic/skills/cc/skill_interface.h"
 #include "intrinsic/skills/cc/skill_logging_context.h"
+#include "intrinsic/skills/proto/skill_service.pb.h"
 #include "intrinsic/world/objects/object_world_client.h"
 
 namespace intrinsic {
@@ -22,16 +25,22 @@ namespace skills {
 // Implementation of ExecuteContext used by the skill service.
 class ExecuteContextImpl : public ExecuteContext {
  public:
+  // Receives the updates that the skill reports.
+  using UpdateCallback =
+      std::function<void(intrinsic_proto::skills::OperationUpdate update)>;
+
   ExecuteContextImpl(std::shared_ptr<SkillCanceller> canceller,
                      EquipmentPack equipment,
                      SkillLoggingContext logging_context,
                      motion_planning::MotionPlannerClient motion_planner,
-                     world::ObjectWorldClient object_world)
+                     world::ObjectWorldClient object_world,
+                     UpdateCallback update_callback = nullptr)
       : canceller_(canceller),
         equipment_(std::move(equipment)),
         logging_context_(logging_context),
         motion_planner_(std::move(motion_planner)),
-        object_world_(std::move(object_world)) {}
+        object_world_(std::move(object_world)),
+        update_callback_(std::move(update_callback)) {}
 
   SkillCanceller& canceller() const override { return *canceller_; }
 
@@ -47,12 +56,28 @@ class ExecuteContextImpl : public ExecuteContext {
 
   world::ObjectWorldClient& object_world() override { return object_world_; }
 
+  void ReportProgress(double progress) override {
+    if (update_callback_ == nullptr) return;
+    intrinsic_proto::skills::OperationUpdate update;
+    update.set_progress(progress);
+    update_callback_(std::move(update));
+  }
+
+  void ReportPartialResult(
+      const google::protobuf::Message& partial_result) override {
+    if (update_callback_ == nullptr) return;
+    intrinsic_proto::skills::OperationUpdate update;
+    update.mutable_partial_result()->PackFrom(partial_result);
+    update_callback_(std::move(update));
+  }
+
  private:
   std::shared_ptr<SkillCanceller> canceller_;
   EquipmentPack equipment_;
   SkillLoggingContext logging_context_;
   motion_planning::MotionPlannerClient motion_planner_;
   world::ObjectWorldClient object_world_;
+  UpdateCallback update_callback_;
 };
 
 }  // namespace skills
@@ -0,0 +1,73 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/skills/internal/footprint_cache.h"
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "intrinsic/skills/proto/footprint.pb.h"
+#include "intrinsic/skills/proto/skill_service.pb.h"
+
+namespace intrinsic::skills::internal {
+
+std::string FootprintCache::Key(
+    absl::string_view world_version,
+    intrinsic_proto::skills::GetFootprintRequest request) {
+  request.clear_context();
+  request.mutable_instance()->clear_instance_name();
+  std::string serialized;
+  {
+    google::protobuf::io::StringOutputStream stream(&serialized);
+    google::protobuf::io::CodedOutputStream coded_stream(&stream);
+    // Maps, such as the resource handles, are serialized in a stable order, so
+    // equal requests have equal keys.
+    coded_stream.SetSerializationDeterministic(true);
+    request.SerializeToCodedStream(&coded_stream);
+  }
+  return absl::StrCat(world_version.size(), ":", world_version, serialized);
+}
+
+std::optional<intrinsic_proto::skills::Footprint> FootprintCache::Find(
+    const std::string& key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return std::nullopt;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->footprint;
+}
+
+void FootprintCache::Insert(
+    const std::string& key,
+    const intrinsic_proto::skills::Footprint& footprint) {
+  if (max_entries_ == 0) {
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  if (auto it = index_.find(key); it != index_.end()) {
+    it->second->footprint = footprint;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+  if (entries_.size() >= max_entries_) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+  }
+  entries_.push_front({.key = key, .footprint = footprint});
+  index_[key] = entries_.begin();
+}
+
+size_t FootprintCache::size() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+}  // namespace intrinsic::skills::internal
@@ -0,0 +1,65 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_SKILLS_INTERNAL_FOOTPRINT_CACHE_H_
+#define INTRINSIC_SKILLS_INTERNAL_FOOTPRINT_CACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <optional>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "intrinsic/skills/proto/footprint.pb.h"
+#include "intrinsic/skills/proto/skill_service.pb.h"
+
+namespace intrinsic::skills::internal {
+
+// Footprints returned by a skill, of which the least recently used are dropped
+// first. Used by the skill service for skills that opt into caching with
+// `footprint_cache` in their manifest. Thread-safe.
+class FootprintCache {
+ public:
+  // Returns the key of the footprint of `request` on the world with
+  // `world_version`, see ObjectWorldClient::GetWorldVersion(). Requests with
+  // equal parameters, equipment and world have equal keys. The logging
+  // context and the instance name do not change the footprint, so they are
+  // not part of the key.
+  static std::string Key(absl::string_view world_version,
+                         intrinsic_proto::skills::GetFootprintRequest request);
+
+  // Creates a cache of at most `max_entries` footprints.
+  explicit FootprintCache(size_t max_entries) : max_entries_(max_entries) {}
+
+  // Returns the footprint cached under `key`, if any, and marks it as recently
+  // used.
+  std::optional<intrinsic_proto::skills::Footprint> Find(
+      const std::string& key) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Caches `footprint` under `key`, dropping the least recently used
+  // footprint if the cache is full.
+  void Insert(const std::string& key,
+              const intrinsic_proto::skills::Footprint& footprint)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  size_t size() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Entry {
+    std::string key;
+    intrinsic_proto::skills::Footprint footprint;
+  };
+
+  const size_t max_entries_;
+  mutable absl::Mutex mutex_;
+  // Most recently used first.
+  std::list<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, std::list<Entry>::iterator> index_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace intrinsic::skills::internal
+
+#endif  // INTRINSIC_SKILLS_INTERNAL_FOOTPRINT_CACHE_H_
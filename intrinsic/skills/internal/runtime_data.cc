@@ -2,6 +2,7 @@
 
 #include "intrinsic/skills/internal/runtime_data.h"
 
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
@@ -18,6 +19,7 @@
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/descriptor.pb.h"
 #include "google/protobuf/descriptor_database.h"
+#include "intrinsic/skills/internal/default_parameters.h"
 #include "intrinsic/skills/proto/equipment.pb.h"
 #include "intrinsic/skills/proto/skill_service_config.pb.h"
 #include "intrinsic/skills/proto/skills.pb.h"
@@ -28,7 +30,9 @@ namespace intrinsic::skills::internal {
 namespace {}  // namespace
 
 ParameterData::ParameterData(const google::protobuf::Any& default_value)
-    : default_(default_value) {}
+    : default_(default_value),
+      compiled_default_(
+          std::make_shared<const ParameterDefaults>(default_value)) {}
 
 ExecutionOptions::ExecutionOptions(bool supports_cancellation)
     : supports_cancellation_(supports_cancellation) {}
@@ -38,6 +42,13 @@ ExecutionOptions::ExecutionOptions(bool supports_cancellation,
     : supports_cancellation_(supports_cancellation),
       cancellation_ready_timeout_(cancellation_ready_timeout) {}
 
+ExecutionOptions::ExecutionOptions(bool supports_cancellation,
+                                   absl::Duration cancellation_ready_timeout,
+                                   size_t footprint_cache_max_entries)
+    : supports_cancellation_(supports_cancellation),
+      cancellation_ready_timeout_(cancellation_ready_timeout),
+      footprint_cache_max_entries_(footprint_cache_max_entries) {}
+
 ResourceData::ResourceData(
     const absl::flat_hash_map<std::string,
                               intrinsic_proto::skills::ResourceSelector>&
@@ -66,17 +77,17 @@ absl::StatusOr<SkillRuntimeData> GetRuntimeDataFrom(
                               .default_value())
           : ParameterData(),
       ReturnTypeData(),
-      skill_service_config.execution_service_options()
-              .has_cancellation_ready_timeout()
-          ? ExecutionOptions(
-                skill_service_config.skill_description()
-                    .execution_options()
-                    .supports_cancellation(),
-                FromProto(skill_service_config.execution_service_options()
-                              .cancellation_ready_timeout()))
-          : ExecutionOptions(skill_service_config.skill_description()
-                                 .execution_options()
-                                 .supports_cancellation()),
+      ExecutionOptions(
+          skill_service_config.skill_description()
+              .execution_options()
+              .supports_cancellation(),
+          skill_service_config.execution_service_options()
+                  .has_cancellation_ready_timeout()
+              ? FromProto(skill_service_config.execution_service_options()
+                              .cancellation_ready_timeout())
+              : ExecutionOptions().GetCancellationReadyTimeout(),
+          skill_service_config.execution_service_options()
+              .footprint_cache_max_entries()),
       ResourceData({skill_service_config.skill_description()
                         .resource_selectors()
                         .begin(),
@@ -7,6 +7,8 @@
 #ifndef INTRINSIC_SKILLS_INTERNAL_RUNTIME_DATA_H_
 #define INTRINSIC_SKILLS_INTERNAL_RUNTIME_DATA_H_
 
+#include <cstddef>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -18,6 +20,7 @@
 #include "absl/types/span.h"
 #include "google/protobuf/any.pb.h"
 #include "google/protobuf/descriptor.h"
+#include "intrinsic/skills/internal/default_parameters.h"
 #include "intrinsic/skills/proto/equipment.pb.h"
 #include "intrinsic/skills/proto/skill_service_config.pb.h"
 
@@ -37,8 +40,15 @@ class ParameterData {
     return default_;
   }
 
+  // The default value, compiled once for all requests of the skill and shared
+  // by copies, or nullptr if there is no default value.
+  const std::shared_ptr<const ParameterDefaults>& GetCompiledDefault() const {
+    return compiled_default_;
+  }
+
  private:
   std::optional<google::protobuf::Any> default_ = std::nullopt;
+  std::shared_ptr<const ParameterDefaults> compiled_default_;
 };
 
 // Contains data about return types that is required by the skill service at
@@ -59,6 +69,9 @@ class ExecutionOptions {
   explicit ExecutionOptions(bool supports_cancellation);
   ExecutionOptions(bool supports_cancellation,
                    absl::Duration cancellation_ready_timeout);
+  ExecutionOptions(bool supports_cancellation,
+                   absl::Duration cancellation_ready_timeout,
+                   size_t footprint_cache_max_entries);
 
   ExecutionOptions(const ExecutionOptions& other) = default;
   ExecutionOptions& operator=(const ExecutionOptions& other) = default;
@@ -70,9 +83,16 @@ class ExecutionOptions {
     return cancellation_ready_timeout_;
   }
 
+  // Returns the maximum number of footprints of the skill that the skill
+  // service caches, or zero if it does not cache them.
+  size_t GetFootprintCacheMaxEntries() const {
+    return footprint_cache_max_entries_;
+  }
+
  private:
   bool supports_cancellation_ = false;
   absl::Duration cancellation_ready_timeout_ = absl::Seconds(30);
+  size_t footprint_cache_max_entries_ = 0;
 };
 
 // Contains data about resources for a skill that are relevant to the
@@ -2,20 +2,28 @@
 
 #include "intrinsic/skills/internal/single_skill_factory.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/log/check.h"
+#include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "google/protobuf/message.h"
 #include "intrinsic/assets/id_utils.h"
 #include "intrinsic/skills/cc/skill_interface.h"
 #include "intrinsic/skills/internal/runtime_data.h"
+#include "intrinsic/skills/proto/footprint.pb.h"
+#include "intrinsic/util/status/status_macros.h"
 
 namespace intrinsic::skills::internal {
 
@@ -34,15 +42,142 @@ std::string NameFromIdOrDie(absl::string_view id) {
 
 }  // namespace
 
+// Idle skill instances, and the instances handed out that return to them.
+class SingleSkillFactory::InstancePool
+    : public std::enable_shared_from_this<InstancePool> {
+ public:
+  InstancePool(size_t max_idle_instances,
+               std::function<absl::Status(SkillInterface&)> reset_skill)
+      : max_idle_instances_(max_idle_instances),
+        reset_skill_(std::move(reset_skill)) {}
+
+  // Returns an idle instance, or nullptr if there is none.
+  std::unique_ptr<SkillInterface> TakeIdle() ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    if (idle_.empty()) {
+      return nullptr;
+    }
+    std::unique_ptr<SkillInterface> skill = std::move(idle_.back());
+    idle_.pop_back();
+    return skill;
+  }
+
+  // Keeps `skill` as an idle instance unless there are enough already.
+  void AddIdle(std::unique_ptr<SkillInterface> skill)
+      ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    if (idle_.size() < max_idle_instances_) {
+      idle_.push_back(std::move(skill));
+    }
+    // Otherwise `skill` is destroyed after releasing the lock.
+  }
+
+  size_t num_idle() const ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    return idle_.size();
+  }
+
+  // Returns `skill` wrapped so that it returns to this pool when the wrapper
+  // is destroyed.
+  std::unique_ptr<SkillInterface> Lend(std::unique_ptr<SkillInterface> skill);
+
+  // Resets `skill` and keeps it as an idle instance.
+  void Return(std::unique_ptr<SkillInterface> skill)
+      ABSL_LOCKS_EXCLUDED(mutex_) {
+    if (reset_skill_ != nullptr) {
+      if (absl::Status status = reset_skill_(*skill); !status.ok()) {
+        LOG(WARNING) << "Discarding skill instance that failed to reset: "
+                     << status;
+        return;
+      }
+    }
+    AddIdle(std::move(skill));
+  }
+
+ private:
+  class LentSkill;
+
+  const size_t max_idle_instances_;
+  const std::function<absl::Status(SkillInterface&)> reset_skill_;
+
+  mutable absl::Mutex mutex_;
+  std::vector<std::unique_ptr<SkillInterface>> idle_ ABSL_GUARDED_BY(mutex_);
+};
+
+// A skill instance lent from an InstancePool, which it returns to once it is
+// destroyed.
+class SingleSkillFactory::InstancePool::LentSkill : public SkillInterface {
+ public:
+  LentSkill(std::unique_ptr<SkillInterface> skill,
+            std::shared_ptr<InstancePool> pool)
+      : skill_(std::move(skill)), pool_(std::move(pool)) {}
+
+  ~LentSkill() override { pool_->Return(std::move(skill_)); }
+
+  absl::StatusOr<intrinsic_proto::skills::Footprint> GetFootprint(
+      const GetFootprintRequest& request,
+      GetFootprintContext& context) const override {
+    return skill_->GetFootprint(request, context);
+  }
+
+  absl::StatusOr<std::unique_ptr<google::protobuf::Message>> Execute(
+      const ExecuteRequest& request, ExecuteContext& context) override {
+    return skill_->Execute(request, context);
+  }
+
+  absl::StatusOr<std::unique_ptr<google::protobuf::Message>> Preview(
+      const PreviewRequest& request, PreviewContext& context) override {
+    return skill_->Preview(request, context);
+  }
+
+ private:
+  std::unique_ptr<SkillInterface> skill_;
+  std::shared_ptr<InstancePool> pool_;
+};
+
+std::unique_ptr<SkillInterface> SingleSkillFactory::InstancePool::Lend(
+    std::unique_ptr<SkillInterface> skill) {
+  return std::make_unique<LentSkill>(std::move(skill), shared_from_this());
+}
+
 SingleSkillFactory::SingleSkillFactory(
     const SkillRuntimeData& skill_runtime_data,
-    const std::function<absl::StatusOr<std::unique_ptr<SkillInterface>>()>&
-        create_skill)
+    const CreateSkillFunction& create_skill)
+    : SingleSkillFactory(skill_runtime_data, create_skill,
+                         InstancePoolOptions()) {}
+
+SingleSkillFactory::SingleSkillFactory(
+    const SkillRuntimeData& skill_runtime_data,
+    const CreateSkillFunction& create_skill,
+    const InstancePoolOptions& pool_options)
     : skill_runtime_data_(skill_runtime_data),
       // SkillRuntimeData should always have a valid ID after construction, so
       // this should never die.
       skill_alias_(NameFromIdOrDie(skill_runtime_data.GetId())),
-      create_skill_(create_skill) {}
+      create_skill_(create_skill),
+      pool_(pool_options.max_idle_instances > 0
+                ? std::make_shared<InstancePool>(
+                      pool_options.max_idle_instances, pool_options.reset_skill)
+                : nullptr),
+      num_prewarmed_instances_(std::min(pool_options.num_prewarmed_instances,
+                                        pool_options.max_idle_instances)),
+      warm_up_skill_(pool_options.warm_up_skill) {}
+
+absl::StatusOr<std::unique_ptr<SkillInterface>>
+SingleSkillFactory::AcquireSkill() {
+  std::unique_ptr<SkillInterface> skill;
+  if (pool_ != nullptr) {
+    skill = pool_->TakeIdle();
+  }
+  if (skill == nullptr) {
+    absl::MutexLock l(&create_skill_mutex_);
+    INTR_ASSIGN_OR_RETURN(skill, create_skill_());
+  }
+  if (pool_ == nullptr) {
+    return skill;
+  }
+  return pool_->Lend(std::move(skill));
+}
 
 absl::StatusOr<std::unique_ptr<SkillInterface>> SingleSkillFactory::GetSkill(
     absl::string_view skill_alias) {
@@ -50,8 +185,7 @@ absl::StatusOr<std::unique_ptr<SkillInterface>> SingleSkillFactory::GetSkill(
     return SkillAliasNotFound(skill_alias);
   }
 
-  absl::MutexLock l(&create_skill_mutex_);
-  return create_skill_();
+  return AcquireSkill();
 }
 
 std::vector<std::string> SingleSkillFactory::GetSkillAliases() const {
@@ -64,8 +198,7 @@ SingleSkillFactory::GetSkillExecute(absl::string_view skill_alias) {
     return SkillAliasNotFound(skill_alias);
   }
 
-  absl::MutexLock l(&create_skill_mutex_);
-  return create_skill_();
+  return AcquireSkill();
 }
 
 absl::StatusOr<std::unique_ptr<SkillProjectInterface>>
@@ -74,8 +207,7 @@ SingleSkillFactory::GetSkillProject(absl::string_view skill_alias) {
     return SkillAliasNotFound(skill_alias);
   }
 
-  absl::MutexLock l(&create_skill_mutex_);
-  return create_skill_();
+  return AcquireSkill();
 }
 
 absl::StatusOr<internal::SkillRuntimeData>
@@ -87,4 +219,32 @@ SingleSkillFactory::GetSkillRuntimeData(absl::string_view skill_alias) {
   return skill_runtime_data_;
 }
 
+absl::Status SingleSkillFactory::Prewarm() {
+  // Defaults that fail to compile fail again on the first call, and report
+  // the error there.
+  if (const auto& defaults =
+          skill_runtime_data_.GetParameterData().GetCompiledDefault();
+      defaults != nullptr) {
+    if (absl::Status status = defaults->Precompile(); !status.ok()) {
+      LOG(WARNING) << "Failed to compile the default parameters of "
+                   << skill_alias_ << ": " << status;
+    }
+  }
+  if (pool_ == nullptr) {
+    return absl::OkStatus();
+  }
+  for (size_t i = pool_->num_idle(); i < num_prewarmed_instances_; ++i) {
+    std::unique_ptr<SkillInterface> skill;
+    {
+      absl::MutexLock l(&create_skill_mutex_);
+      INTR_ASSIGN_OR_RETURN(skill, create_skill_());
+    }
+    if (warm_up_skill_ != nullptr) {
+      INTR_RETURN_IF_ERROR(warm_up_skill_(*skill));
+    }
+    pool_->AddIdle(std::move(skill));
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace intrinsic::skills::internal
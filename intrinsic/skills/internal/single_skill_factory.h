@@ -3,12 +3,14 @@
 #ifndef INTRINSIC_SKILLS_INTERNAL_SINGLE_SKILL_FACTORY_H_
 #define INTRINSIC_SKILLS_INTERNAL_SINGLE_SKILL_FACTORY_H_
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
@@ -20,16 +22,42 @@ namespace intrinsic::skills::internal {
 
 // SingleSkillFactory implements a SkillRepository that is only able to serve
 // a single skill.
+//
+// By default, every call creates a new skill instance. Skills that are
+// expensive to construct can opt into reusing instances with
+// InstancePoolOptions: instances are then returned to a pool of idle instances
+// when the caller releases them, optionally reset, and handed out again.
 class SingleSkillFactory : public SkillRepository {
  public:
+  using CreateSkillFunction =
+      std::function<absl::StatusOr<std::unique_ptr<SkillInterface>>()>;
+
+  struct InstancePoolOptions {
+    // Maximum number of idle instances kept for reuse. Zero disables reuse.
+    size_t max_idle_instances = 0;
+    // Number of instances Prewarm() creates. At most `max_idle_instances`.
+    size_t num_prewarmed_instances = 0;
+    // Called on an instance before it is reused. If it fails, the instance is
+    // destroyed instead. If not set, instances are reused as they are, so
+    // skills must not keep state between calls.
+    std::function<absl::Status(SkillInterface&)> reset_skill;
+    // Called by Prewarm() on each instance it creates. If it fails, the
+    // instance is destroyed and Prewarm() fails.
+    std::function<absl::Status(SkillInterface&)> warm_up_skill;
+  };
+
   // Creates a SingleSkillFactory.
   //
   // Uses the data from `skill_runtime_data` and the `create_skill` function to
   // create new skills when requested.
-  SingleSkillFactory(
-      const SkillRuntimeData& skill_runtime_data,
-      const std::function<absl::StatusOr<std::unique_ptr<SkillInterface>>()>&
-          create_skill);
+  SingleSkillFactory(const SkillRuntimeData& skill_runtime_data,
+                     const CreateSkillFunction& create_skill);
+
+  // Creates a SingleSkillFactory that reuses skills according to
+  // `pool_options`.
+  SingleSkillFactory(const SkillRuntimeData& skill_runtime_data,
+                     const CreateSkillFunction& create_skill,
+                     const InstancePoolOptions& pool_options);
 
   // Not copyable or movable
   SingleSkillFactory(const SingleSkillFactory&) = delete;
@@ -49,14 +77,31 @@ class SingleSkillFactory : public SkillRepository {
   absl::StatusOr<internal::SkillRuntimeData> GetSkillRuntimeData(
       absl::string_view skill_alias) override;
 
+  // Compiles the default parameters and creates
+  // InstancePoolOptions::num_prewarmed_instances idle instances, warmed up
+  // with InstancePoolOptions::warm_up_skill, so that the first calls do not
+  // pay for constructing the skill.
+  absl::Status Prewarm() override;
+
  private:
+  class InstancePool;
+
+  // Returns an idle instance if there is one, and a new one otherwise.
+  absl::StatusOr<std::unique_ptr<SkillInterface>> AcquireSkill()
+      ABSL_LOCKS_EXCLUDED(create_skill_mutex_);
+
   SkillRuntimeData skill_runtime_data_;
 
   std::string skill_alias_;
 
   absl::Mutex create_skill_mutex_;
-  std::function<absl::StatusOr<std::unique_ptr<SkillInterface>>()> create_skill_
-      ABSL_GUARDED_BY(create_skill_mutex_);
+  CreateSkillFunction create_skill_ ABSL_GUARDED_BY(create_skill_mutex_);
+
+  // Set if instances are reused. Shared with the instances handed out, which
+  // may outlive the factory.
+  std::shared_ptr<InstancePool> pool_;
+  size_t num_prewarmed_instances_;
+  std::function<absl::Status(SkillInterface&)> warm_up_skill_;
 };
 
 }  // namespace intrinsic::skills::internal
@@ -8,30 +8,43 @@
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/flags/flag.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "google/protobuf/descriptor.h"
 #include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/empty.pb.h"
+#include "google/protobuf/message.h"
 #include "grpc/grpc.h"
 #include "grpcpp/channel.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/health_check_service_interface.h"
 #include "grpcpp/security/server_credentials.h"
 #include "grpcpp/server.h"
 #include "grpcpp/server_builder.h"
+#include "grpcpp/support/channel_arguments.h"
 #include "intrinsic/icon/release/file_helpers.h"
 #include "intrinsic/logging/data_logger_client.h"
 #include "intrinsic/motion_planning/proto/motion_planner_service.grpc.pb.h"
 #include "intrinsic/skills/internal/skill_registry_client.h"
 #include "intrinsic/skills/internal/skill_repository.h"
 #include "intrinsic/skills/internal/skill_service_impl.h"
+#include "intrinsic/skills/proto/skill_service.grpc.pb.h"
+#include "intrinsic/skills/proto/skill_service.pb.h"
 #include "intrinsic/skills/proto/skill_service_config.pb.h"
 #include "intrinsic/skills/proto/skills.pb.h"
 #include "intrinsic/util/grpc/grpc.h"
+#include "intrinsic/util/status/status_conversion_grpc.h"
 #include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
 #include "intrinsic/world/proto/object_world_service.grpc.pb.h"
 
 namespace intrinsic::skills {
@@ -52,6 +65,104 @@ CreateMotionPlannerServiceStub(absl::string_view motion_planner_service_address,
       channel);
 }
 
+// Runs the independent steps of the skill service startup concurrently, and
+// records how long each of them takes.
+class StartupPhases {
+ public:
+  StartupPhases() : start_(absl::Now()) {}
+
+  ~StartupPhases() { Join(); }
+
+  // Runs `phase` on its own thread, or on the calling thread if no thread can
+  // be started.
+  void Run(absl::string_view name, absl::AnyInvocable<void() &&> phase) {
+    // Shared with the thread, so that the phase is still there to run on the
+    // calling thread if the thread cannot be started.
+    auto timed_phase = std::make_shared<absl::AnyInvocable<void() &&>>(
+        [this, name = std::string(name), phase = std::move(phase)]() mutable {
+          const absl::Time start = absl::Now();
+          std::move(phase)();
+          Record(name, start);
+        });
+    const std::string thread_name = absl::StrCat("startup_", threads_.size());
+    Thread thread;
+    if (absl::Status status =
+            thread.Start(Thread::Options().SetName(thread_name),
+                         [timed_phase]() { std::move(*timed_phase)(); });
+        !status.ok()) {
+      LOG(WARNING) << "Running startup phase " << name
+                   << " on the calling thread: " << status;
+      std::move(*timed_phase)();
+      return;
+    }
+    threads_.push_back(std::move(thread));
+  }
+
+  // Waits until all phases started with Run() are done.
+  void Join() {
+    for (Thread& thread : threads_) {
+      thread.Join();
+    }
+    threads_.clear();
+  }
+
+  // Records that the phase `name` ran from `start` until now.
+  void Record(absl::string_view name, absl::Time start)
+      ABSL_LOCKS_EXCLUDED(mutex_) {
+    const absl::Duration duration = absl::Now() - start;
+    absl::MutexLock lock(&mutex_);
+    durations_.emplace_back(name, duration);
+  }
+
+  void LogProfile() const ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    LOG(INFO) << "Skill service started in " << absl::Now() - start_ << ":";
+    for (const auto& [name, duration] : durations_) {
+      LOG(INFO) << "\t" << name << ": " << duration;
+    }
+  }
+
+ private:
+  const absl::Time start_;
+  std::vector<Thread> threads_;
+
+  mutable absl::Mutex mutex_;
+  std::vector<std::pair<std::string, absl::Duration>> durations_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+// Looks up the parameter and return value types of the skill, so that their
+// descriptors are built before the first call instead of lazily by it.
+void BuildDescriptors(const intrinsic_proto::skills::Skill& skill) {
+  for (const std::string& name :
+       {skill.parameter_description().parameter_message_full_name(),
+        skill.return_value_description().return_value_message_full_name()}) {
+    if (name.empty()) continue;
+    if (const google::protobuf::Descriptor* descriptor =
+            google::protobuf::DescriptorPool::generated_pool()
+                ->FindMessageTypeByName(name);
+        descriptor != nullptr) {
+      google::protobuf::MessageFactory::generated_factory()->GetPrototype(
+          descriptor);
+    } else {
+      LOG(WARNING) << "Message type " << name << " is not linked in.";
+    }
+  }
+}
+
+// Calls the skill service in-process, through the same server code as a
+// remote call, so that the first remote call does not set it up.
+absl::Status WarmUpServer(grpc::Server& server, absl::Duration timeout) {
+  std::unique_ptr<intrinsic_proto::skills::SkillInformation::Stub> stub =
+      intrinsic_proto::skills::SkillInformation::NewStub(
+          server.InProcessChannel(grpc::ChannelArguments()));
+  grpc::ClientContext context;
+  context.set_deadline(absl::ToChronoTime(absl::Now() + timeout));
+  google::protobuf::Empty request;
+  intrinsic_proto::skills::SkillInformationResult result;
+  return ToAbslStatus(stub->GetSkillInfo(&context, request, &result));
+}
+
 }  // namespace
 
 absl::Status SkillInit(
@@ -63,43 +174,87 @@ absl::Status SkillInit(
     absl::string_view skill_registry_service_address,
     int32_t skill_service_port, absl::Duration connection_timeout,
     SkillRepository& skill_repository) {
+  // Connecting to the services and constructing the skills are independent,
+  // and mostly wait, so they run concurrently.
+  StartupPhases phases;
+
   // Start DataLogger if the endpoint is configured by flags. Do not fail if
   // the logger is unavailable.
   if (!data_logger_grpc_service_address.empty()) {
-    if (auto s = intrinsic::data_logger::StartUpIntrinsicLoggerViaGrpc(
-            data_logger_grpc_service_address, connection_timeout);
-        !s.ok()) {
-      LOG(ERROR) << "Failed to connect to data logger: " << s;
-    }
+    phases.Run("data logger", [data_logger_grpc_service_address,
+                               connection_timeout]() {
+      if (auto s = intrinsic::data_logger::StartUpIntrinsicLoggerViaGrpc(
+              data_logger_grpc_service_address, connection_timeout);
+          !s.ok()) {
+        LOG(ERROR) << "Failed to connect to data logger: " << s;
+      }
+    });
   }
 
   // Set up world service.
-  INTR_ASSIGN_OR_RETURN(
-      const std::shared_ptr<grpc::Channel> world_service_channel,
-      CreateClientChannel(world_service_address,
-                          absl::Now() + connection_timeout));
-
-  std::shared_ptr<ObjectWorldService::StubInterface> object_world_service =
-      ObjectWorldService::NewStub(world_service_channel);
+  absl::StatusOr<std::shared_ptr<grpc::Channel>> world_service_channel;
+  phases.Run("world service", [&world_service_channel, world_service_address,
+                               connection_timeout]() {
+    world_service_channel = CreateClientChannel(
+        world_service_address, absl::Now() + connection_timeout);
+  });
 
-  INTR_ASSIGN_OR_RETURN(
-      std::shared_ptr<MotionPlannerService::StubInterface>
-          motion_planner_service,
-      CreateMotionPlannerServiceStub(motion_planner_service_address,
-                                     connection_timeout));
+  absl::StatusOr<std::shared_ptr<MotionPlannerService::Stub>>
+      motion_planner_service_stub;
+  phases.Run("motion planner service",
+             [&motion_planner_service_stub, motion_planner_service_address,
+              connection_timeout]() {
+               motion_planner_service_stub = CreateMotionPlannerServiceStub(
+                   motion_planner_service_address, connection_timeout);
+             });
 
   // Set up the skill registry client.
-  INTR_ASSIGN_OR_RETURN(
-      std::unique_ptr<SkillRegistryClient> skill_registry_client,
-      CreateSkillRegistryClient(skill_registry_service_address));
+  absl::StatusOr<std::unique_ptr<SkillRegistryClient>> skill_registry_client;
+  phases.Run("skill registry client", [&skill_registry_client,
+                                       skill_registry_service_address]() {
+    skill_registry_client =
+        CreateSkillRegistryClient(skill_registry_service_address);
+  });
+
+  // Construct and warm up skill instances before serving, so that the first
+  // calls do not pay for it. Skills that fail to construct now fail again on
+  // their first call, and report the error there.
+  phases.Run("skill prewarming", [&skill_repository]() {
+    if (absl::Status status = skill_repository.Prewarm(); !status.ok()) {
+      LOG(WARNING) << "Failed to prewarm skills: " << status;
+    }
+  });
+
+  if (!service_config.has_skill_description()) {
+    LOG(FATAL) << "skill_description was not present in the SkillServiceConfig";
+  }
+  const intrinsic_proto::skills::Skill& skill_description =
+      service_config.skill_description();
+  phases.Run("descriptors",
+             [&skill_description]() { BuildDescriptors(skill_description); });
 
+  phases.Join();
+  INTR_RETURN_IF_ERROR(world_service_channel.status());
+  INTR_RETURN_IF_ERROR(motion_planner_service_stub.status());
+  INTR_RETURN_IF_ERROR(skill_registry_client.status());
+
+  std::shared_ptr<ObjectWorldService::StubInterface> object_world_service =
+      ObjectWorldService::NewStub(*world_service_channel);
+  std::shared_ptr<MotionPlannerService::StubInterface> motion_planner_service =
+      *std::move(motion_planner_service_stub);
+
+  const absl::Time services_start = absl::Now();
   SkillProjectorServiceImpl project_service(
       skill_repository, object_world_service, motion_planner_service);
   SkillExecutorServiceImpl execute_service(
       skill_repository, object_world_service, motion_planner_service);
+  phases.Record("skill services", services_start);
 
   std::string server_address = absl::StrCat("0.0.0.0:", skill_service_port);
 
+  // Answers health checks, which report the service as not serving until it
+  // is warmed up below.
+  grpc::EnableDefaultHealthCheckService(true);
   grpc::ServerBuilder builder;
   std::shared_ptr<grpc::ServerCredentials> creds =
       grpc::InsecureServerCredentials();  // NOLINT (insecure)
@@ -108,19 +263,25 @@ absl::Status SkillInit(
   builder.RegisterService(&project_service);
   builder.RegisterService(&execute_service);
 
-  if (!service_config.has_skill_description()) {
-    LOG(FATAL) << "skill_description was not present in the SkillServiceConfig";
-  }
-  intrinsic_proto::skills::Skill skill_description =
-      service_config.skill_description();
-
   auto skill_information_service =
       std::make_unique<SkillInformationServiceImpl>(skill_description);
   builder.RegisterService(skill_information_service.get());
+  const absl::Time server_start = absl::Now();
   std::unique_ptr<::grpc::Server> server(builder.BuildAndStart());
   if (server == nullptr) {
     LOG(FATAL) << "Cannot create skill service " << server_address;
   }
+  grpc::HealthCheckServiceInterface* health = server->GetHealthCheckService();
+  health->SetServingStatus(false);
+  phases.Record("gRPC server", server_start);
+
+  const absl::Time warm_up_start = absl::Now();
+  if (absl::Status status = WarmUpServer(*server, connection_timeout);
+      !status.ok()) {
+    LOG(WARNING) << "Failed to warm up the skill service: " << status;
+  }
+  health->SetServingStatus(true);
+  phases.Record("server warm-up", warm_up_start);
 
   std::vector<std::string> skill_names = skill_repository.GetSkillAliases();
   absl::c_sort(skill_names);
@@ -133,6 +294,7 @@ absl::Status SkillInit(
   LOG(INFO) << "--------------------------------";
   LOG(INFO) << "-- Skill service listening on " << server_address;
   LOG(INFO) << "--------------------------------";
+  phases.LogProfile();
 
   server->Wait();
   return absl::OkStatus();
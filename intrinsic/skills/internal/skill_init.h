@@ -27,6 +27,12 @@ namespace intrinsic::skills {
 // The skills services are configured using the proto data contained in the
 // service_config.
 //
+// Warms up before serving: prewarms `skill_repository` (see
+// SkillRepository::Prewarm()), builds the descriptors of the skill's
+// parameters and return value, and calls the started server in-process. The
+// server answers gRPC health checks, which report it as serving only after
+// the warm-up.
+//
 // If setup passes, this method does not return until the gRPC skill server is
 // shutdown. This normally occurs when the process is killed.
 //
@@ -0,0 +1,120 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/skills/internal/skill_operation_executor.h"
+
+#include <algorithm>
+#include <deque>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+namespace skills {
+namespace internal {
+
+SkillOperationExecutor::SkillOperationExecutor(const Options& options)
+    : options_(options),
+      max_workers_(std::max(options.max_workers, 1)) {
+  absl::MutexLock lock(&mutex_);
+  workers_.reserve(max_workers_);
+}
+
+SkillOperationExecutor::~SkillOperationExecutor() {
+  std::vector<Thread> workers;
+  {
+    absl::MutexLock lock(&mutex_);
+    stop_ = true;
+    workers = std::move(workers_);
+  }
+  for (Thread& worker : workers) {
+    worker.Join();
+  }
+}
+
+absl::Status SkillOperationExecutor::Submit(absl::string_view skill_id,
+                                            Job job) {
+  absl::MutexLock lock(&mutex_);
+  if (queue_.size() >= options_.max_queued_operations) {
+    return absl::ResourceExhaustedError(absl::StrFormat(
+        "Cannot start an operation of %s, since %d operations are already "
+        "waiting to run.",
+        skill_id, queue_.size()));
+  }
+  queue_.push_back({.skill_id = std::string(skill_id), .job = std::move(job)});
+  if (num_idle_workers_ < queue_.size() && workers_.size() < max_workers_) {
+    Thread worker;
+    if (absl::Status status = worker.Start(
+            Thread::Options().SetName(
+                absl::StrCat("skill_op_", workers_.size())),
+            &SkillOperationExecutor::RunWorker, this);
+        !status.ok()) {
+      // Keeps the operation queued if another worker can run it.
+      if (workers_.empty()) {
+        queue_.pop_back();
+        return status;
+      }
+    } else {
+      workers_.push_back(std::move(worker));
+    }
+  }
+  return absl::OkStatus();
+}
+
+std::deque<SkillOperationExecutor::Entry>::iterator
+SkillOperationExecutor::FindRunnable() {
+  if (options_.max_operations_per_skill <= 0) {
+    return queue_.begin();
+  }
+  for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+    auto running = num_running_.find(it->skill_id);
+    if (running == num_running_.end() ||
+        running->second < options_.max_operations_per_skill) {
+      return it;
+    }
+  }
+  return queue_.end();
+}
+
+void SkillOperationExecutor::RunWorker() {
+  std::optional<std::string> finished_skill_id;
+  while (true) {
+    Entry entry;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (finished_skill_id.has_value()) {
+        if (auto running = num_running_.find(*finished_skill_id);
+            --running->second == 0) {
+          num_running_.erase(running);
+        }
+      }
+      ++num_idle_workers_;
+      auto has_work = [this]() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+        return FindRunnable() != queue_.end() || (stop_ && queue_.empty());
+      };
+      mutex_.Await(absl::Condition(&has_work));
+      --num_idle_workers_;
+      auto it = FindRunnable();
+      if (it == queue_.end()) {
+        return;
+      }
+      entry = std::move(*it);
+      queue_.erase(it);
+      ++num_running_[entry.skill_id];
+    }
+    std::move(entry.job)();
+    finished_skill_id = std::move(entry.skill_id);
+  }
+}
+
+}  // namespace internal
+}  // namespace skills
+}  // namespace intrinsic
@@ -0,0 +1,92 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_SKILLS_INTERNAL_SKILL_OPERATION_EXECUTOR_H_
+#define INTRINSIC_SKILLS_INTERNAL_SKILL_OPERATION_EXECUTOR_H_
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+namespace skills {
+namespace internal {
+
+// Runs skill operations on a bounded set of reused worker threads, so that
+// short skills do not pay for creating and joining a thread each.
+//
+// Workers are started on demand, up to Options::max_workers, and are kept
+// until the executor is destroyed. Operations that find no idle worker, or
+// whose skill already runs Options::max_operations_per_skill operations, wait
+// in a queue and run in the order they were submitted.
+//
+// Thread safe.
+class SkillOperationExecutor {
+ public:
+  using Job = absl::AnyInvocable<void() &&>;
+
+  struct Options {
+    // Maximum number of operations that run at the same time, each on its own
+    // worker thread. At least one.
+    int max_workers = 32;
+    // Maximum number of operations of the same skill that run at the same
+    // time. Zero means no limit other than `max_workers`.
+    int max_operations_per_skill = 0;
+    // Maximum number of operations that wait to run.
+    size_t max_queued_operations = 256;
+  };
+
+  explicit SkillOperationExecutor(const Options& options);
+
+  // Runs all submitted operations, then stops the workers.
+  ~SkillOperationExecutor();
+
+  SkillOperationExecutor(const SkillOperationExecutor&) = delete;
+  SkillOperationExecutor& operator=(const SkillOperationExecutor&) = delete;
+
+  // Schedules `job`, an operation of the skill `skill_id`.
+  //
+  // Returns ResourceExhaustedError, and drops `job`, if
+  // Options::max_queued_operations operations wait to run, and the error of
+  // Thread::Start() if a needed worker cannot be started.
+  absl::Status Submit(absl::string_view skill_id, Job job)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Entry {
+    std::string skill_id;
+    Job job;
+  };
+
+  // Returns the first queued operation whose skill is below its limit, or
+  // queue_.end().
+  std::deque<Entry>::iterator FindRunnable()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void RunWorker() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  const Options options_;
+  const size_t max_workers_;
+
+  absl::Mutex mutex_;
+  std::deque<Entry> queue_ ABSL_GUARDED_BY(mutex_);
+  // Number of running operations per skill.
+  absl::flat_hash_map<std::string, int> num_running_ ABSL_GUARDED_BY(mutex_);
+  // Number of workers that wait for an operation.
+  size_t num_idle_workers_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool stop_ ABSL_GUARDED_BY(mutex_) = false;
+  std::vector<Thread> workers_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace internal
+}  // namespace skills
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_SKILLS_INTERNAL_SKILL_OPERATION_EXECUTOR_H_
@@ -20,6 +20,7 @@
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/descriptor.pb.h"
 #include "google/protobuf/message.h"
+#include "intrinsic/assets/id_utils.h"
 #include "intrinsic/assets/proto/documentation.pb.h"
 #include "intrinsic/assets/proto/id.pb.h"
 #include "intrinsic/skills/proto/equipment.pb.h"
@@ -27,20 +28,10 @@
 #include "intrinsic/skills/proto/skills.pb.h"
 #include "intrinsic/util/proto/source_code_info_view.h"
 #include "intrinsic/util/status/status_macros.h"
-#include "re2/re2.h"
 
 namespace intrinsic {
 namespace skills {
 
-namespace {
-
-// This is the recommended regex for semver. It is copied from
-// https://semver.org/#is-there-a-suggested-regular-expression-regex-to-check-a-semver-string
-constexpr LazyRE2 kSemverRegex = {
-    R"reg(^(?P<major>0|[1-9]\d*)\.(?P<minor>0|[1-9]\d*)\.(?P<patch>0|[1-9]\d*)(?:-(?P<prerelease>(?:0|[1-9]\d*|\d*[a-zA-Z-][0-9a-zA-Z-]*)(?:\.(?:0|[1-9]\d*|\d*[a-zA-Z-][0-9a-zA-Z-]*))*))?(?:\+(?P<buildmetadata>[0-9a-zA-Z-]+(?:\.[0-9a-zA-Z-]+)*))?$)reg"};
-
-}  // namespace
-
 void StripSourceCodeInfo(
     google::protobuf::FileDescriptorSet& file_descriptor_set) {
   for (google::protobuf::FileDescriptorProto& file :
@@ -162,7 +153,7 @@ absl::StatusOr<intrinsic_proto::skills::Skill> BuildSkillProto(
   skill.set_id(manifest.id().package() + "." + manifest.id().name());
   skill.set_package_name(manifest.id().package());
   if (semver_version.has_value()) {
-    if (!RE2::FullMatch(*semver_version, *kSemverRegex)) {
+    if (!assets::IsVersion(*semver_version)) {
       return absl::InvalidArgumentError(
           absl::StrCat("semver_version: ", *semver_version,
                        " is not a valid semver version."));
@@ -2,18 +2,26 @@
 
 #include "intrinsic/skills/internal/skill_registry_client.h"
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "google/protobuf/empty.pb.h"
 #include "grpcpp/channel.h"
 #include "grpcpp/client_context.h"
@@ -32,6 +40,8 @@
 #include "intrinsic/skills/proto/skill_registry.pb.h"
 #include "intrinsic/skills/proto/skill_registry_config.pb.h"
 #include "intrinsic/skills/proto/skills.pb.h"
+#include "intrinsic/util/grpc/channel.h"
+#include "intrinsic/util/grpc/connection_params.h"
 #include "intrinsic/util/grpc/grpc.h"
 #include "intrinsic/util/status/annotate.h"
 #include "intrinsic/util/status/status_conversion_grpc.h"
@@ -40,8 +50,101 @@
 namespace intrinsic {
 namespace skills {
 
+namespace {
+
+// Full names of the read methods, which select their CallPolicy.
+constexpr char kGetSkillsMethod[] =
+    "/intrinsic_proto.skills.SkillRegistry/GetSkills";
+constexpr char kGetSkillMethod[] =
+    "/intrinsic_proto.skills.SkillRegistry/GetSkill";
+constexpr char kGetBehaviorTreeMethod[] =
+    "/intrinsic_proto.skills.BehaviorTreeRegistryInternal/GetBehaviorTree";
+
+// Returns `policy` with a deadline of `timeout` for each attempt.
+CallPolicy WithTimeout(CallPolicy policy, absl::Duration timeout) {
+  policy.timeout = timeout;
+  return policy;
+}
+
+// Values fetched by id, until they expire.
+template <typename T>
+class ExpiringCache {
+ public:
+  explicit ExpiringCache(absl::Duration ttl) : ttl_(ttl) {}
+
+  std::optional<T> Find(absl::string_view id) ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+      return std::nullopt;
+    }
+    if (it->second.expiry <= absl::Now()) {
+      entries_.erase(it);
+      return std::nullopt;
+    }
+    return it->second.value;
+  }
+
+  void Insert(absl::string_view id, T value) ABSL_LOCKS_EXCLUDED(mutex_) {
+    const absl::Time expiry = absl::Now() + ttl_;
+    absl::MutexLock lock(&mutex_);
+    entries_.insert_or_assign(id, Entry{.expiry = expiry,
+                                        .value = std::move(value)});
+  }
+
+  void Clear() ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    entries_.clear();
+  }
+
+ private:
+  struct Entry {
+    absl::Time expiry;
+    T value;
+  };
+
+  const absl::Duration ttl_;
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, Entry> entries_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Starts a call for each of `requests` at once with `start_call`, which has
+// the signature of a callback stub method, and waits until all are done.
+// Returns the status of each call, and writes its response to the same index
+// of `responses`.
+template <typename Request, typename Response, typename StartCall>
+std::vector<::grpc::Status> CallConcurrently(
+    const std::vector<Request>& requests, absl::Duration timeout,
+    StartCall start_call, std::vector<Response>& responses) {
+  const auto deadline = absl::ToChronoTime(absl::Now() + timeout);
+  std::vector<::grpc::ClientContext> contexts(requests.size());
+  std::vector<::grpc::Status> statuses(requests.size());
+  responses.resize(requests.size());
+  absl::BlockingCounter pending(static_cast<int>(requests.size()));
+  for (size_t i = 0; i < requests.size(); ++i) {
+    contexts[i].set_deadline(deadline);
+    start_call(&contexts[i], &requests[i], &responses[i],
+               [&statuses, &pending, i](::grpc::Status status) {
+                 statuses[i] = std::move(status);
+                 pending.DecrementCount();
+               });
+  }
+  pending.Wait();
+  return statuses;
+}
+
+}  // namespace
+
+struct SkillRegistryClient::Cache {
+  explicit Cache(absl::Duration ttl) : skills(ttl), behavior_trees(ttl) {}
+
+  ExpiringCache<intrinsic_proto::skills::Skill> skills;
+  ExpiringCache<intrinsic_proto::executive::BehaviorTree> behavior_trees;
+};
+
 absl::StatusOr<std::unique_ptr<SkillRegistryClient>> CreateSkillRegistryClient(
-    absl::string_view grpc_address, absl::Duration timeout) {
+    absl::string_view grpc_address, absl::Duration timeout,
+    absl::Duration cache_ttl) {
   grpc::ChannelArguments channel_args = DefaultGrpcChannelArgs();
 
   // The skill registry may need to call out to one or more skill information
@@ -74,9 +177,37 @@ absl::StatusOr<std::unique_ptr<SkillRegistryClient>> CreateSkillRegistryClient(
       intrinsic_proto::skills::SkillRegistryInternal::NewStub(channel),
       intrinsic_proto::skills::SkillRegistry::NewStub(channel),
       intrinsic_proto::skills::BehaviorTreeRegistryInternal::NewStub(channel),
-      intrinsic_proto::skills::BehaviorTreeRegistry::NewStub(channel));
+      intrinsic_proto::skills::BehaviorTreeRegistry::NewStub(channel),
+      cache_ttl);
 }
 
+SkillRegistryClient::SkillRegistryClient(
+    std::unique_ptr<
+        intrinsic_proto::skills::SkillRegistryInternal::StubInterface>
+        stub_internal,
+    std::unique_ptr<intrinsic_proto::skills::SkillRegistry::StubInterface>
+        stub,
+    std::unique_ptr<
+        intrinsic_proto::skills::BehaviorTreeRegistryInternal::StubInterface>
+        bt_stub_internal,
+    std::unique_ptr<
+        intrinsic_proto::skills::BehaviorTreeRegistry::StubInterface>
+        bt_stub,
+    absl::Duration cache_ttl)
+    : stub_internal_(std::move(stub_internal)),
+      stub_(std::move(stub)),
+      bt_stub_internal_(std::move(bt_stub_internal)),
+      bt_stub_(std::move(bt_stub)),
+      cache_(cache_ttl > absl::ZeroDuration()
+                 ? std::make_unique<Cache>(cache_ttl)
+                 : nullptr) {}
+
+SkillRegistryClient::~SkillRegistryClient() = default;
+
+SkillRegistryClient::SkillRegistryClient(SkillRegistryClient&&) = default;
+SkillRegistryClient& SkillRegistryClient::operator=(SkillRegistryClient&&) =
+    default;
+
 absl::StatusOr<std::vector<intrinsic_proto::skills::Skill>>
 SkillRegistryClient::GetSkills() const {
   return GetSkills(kClientDefaultTimeout);
@@ -84,37 +215,109 @@ SkillRegistryClient::GetSkills() const {
 
 absl::StatusOr<std::vector<intrinsic_proto::skills::Skill>>
 SkillRegistryClient::GetSkills(absl::Duration timeout) const {
-  ::grpc::ClientContext context;
-  context.set_deadline(absl::ToChronoTime(absl::Now() + timeout));
-
   google::protobuf::Empty request;
-  intrinsic_proto::skills::GetSkillsResponse response;
-
-  ::grpc::Status status = stub_->GetSkills(&context, request, &response);
-  if (!status.ok()) {
+  absl::StatusOr<intrinsic_proto::skills::GetSkillsResponse> response =
+      CallWithPolicy<intrinsic_proto::skills::GetSkillsResponse>(
+          WithTimeout(call_policies_.For(kGetSkillsMethod), timeout),
+          [&](::grpc::ClientContext* context,
+              intrinsic_proto::skills::GetSkillsResponse* response_proto) {
+            return stub_->GetSkills(context, request, response_proto);
+          });
+  if (!response.ok()) {
     return AnnotateError(
-        ToAbslStatus(status),
-        absl::StrCat(
-            "SkillRegistryClient::GetSkills gRPC call failed; (",
-            absl::StatusCodeToString(absl::StatusCode(status.error_code())),
-            ")"));
+        response.status(),
+        absl::StrCat("SkillRegistryClient::GetSkills gRPC call failed; (",
+                     absl::StatusCodeToString(response.status().code()),
+                     ")"));
   }
 
   // Convert to std::vector.
-  return std::vector<intrinsic_proto::skills::Skill>(response.skills().begin(),
-                                                     response.skills().end());
+  return std::vector<intrinsic_proto::skills::Skill>(
+      response->skills().begin(), response->skills().end());
 }
 
 absl::StatusOr<intrinsic_proto::skills::Skill>
 SkillRegistryClient::GetSkillById(absl::string_view skill_id) const {
-  ::grpc::ClientContext context;
+  if (cache_ != nullptr) {
+    if (std::optional<intrinsic_proto::skills::Skill> skill =
+            cache_->skills.Find(skill_id);
+        skill.has_value()) {
+      return *std::move(skill);
+    }
+  }
+
   intrinsic_proto::skills::GetSkillRequest req;
   req.set_id(std::string(skill_id));
-  intrinsic_proto::skills::GetSkillResponse resp;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(stub_->GetSkill(&context, req, &resp)));
+  INTR_ASSIGN_OR_RETURN(
+      intrinsic_proto::skills::GetSkillResponse resp,
+      CallWithPolicy<intrinsic_proto::skills::GetSkillResponse>(
+          call_policies_.For(kGetSkillMethod),
+          [&](::grpc::ClientContext* context,
+              intrinsic_proto::skills::GetSkillResponse* response) {
+            return stub_->GetSkill(context, req, response);
+          }));
+  if (cache_ != nullptr) {
+    cache_->skills.Insert(skill_id, resp.skill());
+  }
   return resp.skill();
 }
 
+absl::StatusOr<std::vector<intrinsic_proto::skills::Skill>>
+SkillRegistryClient::GetSkillsById(
+    absl::Span<const std::string> skill_ids) const {
+  return GetSkillsById(skill_ids, kClientDefaultTimeout);
+}
+
+absl::StatusOr<std::vector<intrinsic_proto::skills::Skill>>
+SkillRegistryClient::GetSkillsById(absl::Span<const std::string> skill_ids,
+                                   absl::Duration timeout) const {
+  std::vector<intrinsic_proto::skills::Skill> skills(skill_ids.size());
+  // Indices of the skills that are not cached.
+  std::vector<size_t> to_fetch;
+  for (size_t i = 0; i < skill_ids.size(); ++i) {
+    std::optional<intrinsic_proto::skills::Skill> skill;
+    if (cache_ != nullptr) {
+      skill = cache_->skills.Find(skill_ids[i]);
+    }
+    if (skill.has_value()) {
+      skills[i] = *std::move(skill);
+    } else {
+      to_fetch.push_back(i);
+    }
+  }
+
+  std::vector<intrinsic_proto::skills::GetSkillRequest> requests(
+      to_fetch.size());
+  for (size_t i = 0; i < to_fetch.size(); ++i) {
+    requests[i].set_id(skill_ids[to_fetch[i]]);
+  }
+  std::vector<intrinsic_proto::skills::GetSkillResponse> responses;
+  std::vector<::grpc::Status> statuses = CallConcurrently(
+      requests, timeout,
+      [this](::grpc::ClientContext* context,
+             const intrinsic_proto::skills::GetSkillRequest* request,
+             intrinsic_proto::skills::GetSkillResponse* response,
+             std::function<void(::grpc::Status)> on_done) {
+        stub_->async()->GetSkill(context, request, response,
+                                 std::move(on_done));
+      },
+      responses);
+
+  for (size_t i = 0; i < to_fetch.size(); ++i) {
+    const std::string& skill_id = skill_ids[to_fetch[i]];
+    if (!statuses[i].ok()) {
+      return AnnotateError(ToAbslStatus(statuses[i]),
+                           absl::StrCat("SkillRegistryClient::GetSkillsById(",
+                                        skill_id, ") gRPC call failed"));
+    }
+    if (cache_ != nullptr) {
+      cache_->skills.Insert(skill_id, responses[i].skill());
+    }
+    skills[to_fetch[i]] = std::move(*responses[i].mutable_skill());
+  }
+  return skills;
+}
+
 namespace {
 
 intrinsic_proto::skills::GetInstanceRequest CreateGetInstanceRequest(
@@ -191,24 +394,93 @@ SkillRegistryClient::GetBehaviorTree(absl::string_view skill_id) const {
 absl::StatusOr<intrinsic_proto::executive::BehaviorTree>
 SkillRegistryClient::GetBehaviorTree(absl::string_view skill_id,
                                      absl::Duration timeout) const {
-  ::grpc::ClientContext context;
-  context.set_deadline(absl::ToChronoTime(absl::Now() + timeout));
+  if (cache_ != nullptr) {
+    if (std::optional<intrinsic_proto::executive::BehaviorTree> behavior_tree =
+            cache_->behavior_trees.Find(skill_id);
+        behavior_tree.has_value()) {
+      return *std::move(behavior_tree);
+    }
+  }
 
   intrinsic_proto::skills::GetBehaviorTreeRequest req;
   req.set_id(std::string(skill_id));
-  intrinsic_proto::skills::GetBehaviorTreeResponse resp;
-  ::grpc::Status status =
-      bt_stub_internal_->GetBehaviorTree(&context, req, &resp);
-  if (!status.ok()) {
+  absl::StatusOr<intrinsic_proto::skills::GetBehaviorTreeResponse> resp =
+      CallWithPolicy<intrinsic_proto::skills::GetBehaviorTreeResponse>(
+          WithTimeout(call_policies_.For(kGetBehaviorTreeMethod), timeout),
+          [&](::grpc::ClientContext* context,
+              intrinsic_proto::skills::GetBehaviorTreeResponse* response) {
+            return bt_stub_internal_->GetBehaviorTree(context, req, response);
+          });
+  if (!resp.ok()) {
     return AnnotateError(
-        ToAbslStatus(status),
-        absl::StrCat(
-            "SkillRegistryClient::GetBehaviorTree gRPC call failed; (",
-            absl::StatusCodeToString(absl::StatusCode(status.error_code())),
-            ")"));
+        resp.status(),
+        absl::StrCat("SkillRegistryClient::GetBehaviorTree gRPC call failed; (",
+                     absl::StatusCodeToString(resp.status().code()), ")"));
+  }
+
+  if (cache_ != nullptr) {
+    cache_->behavior_trees.Insert(skill_id, resp->behavior_tree());
+  }
+  return resp->behavior_tree();
+}
+
+absl::StatusOr<std::vector<intrinsic_proto::executive::BehaviorTree>>
+SkillRegistryClient::GetBehaviorTrees(
+    absl::Span<const std::string> skill_ids) const {
+  return GetBehaviorTrees(skill_ids, kClientDefaultTimeout);
+}
+
+absl::StatusOr<std::vector<intrinsic_proto::executive::BehaviorTree>>
+SkillRegistryClient::GetBehaviorTrees(absl::Span<const std::string> skill_ids,
+                                      absl::Duration timeout) const {
+  std::vector<intrinsic_proto::executive::BehaviorTree> behavior_trees(
+      skill_ids.size());
+  // Indices of the behavior trees that are not cached.
+  std::vector<size_t> to_fetch;
+  for (size_t i = 0; i < skill_ids.size(); ++i) {
+    std::optional<intrinsic_proto::executive::BehaviorTree> behavior_tree;
+    if (cache_ != nullptr) {
+      behavior_tree = cache_->behavior_trees.Find(skill_ids[i]);
+    }
+    if (behavior_tree.has_value()) {
+      behavior_trees[i] = *std::move(behavior_tree);
+    } else {
+      to_fetch.push_back(i);
+    }
   }
 
-  return resp.behavior_tree();
+  std::vector<intrinsic_proto::skills::GetBehaviorTreeRequest> requests(
+      to_fetch.size());
+  for (size_t i = 0; i < to_fetch.size(); ++i) {
+    requests[i].set_id(skill_ids[to_fetch[i]]);
+  }
+  std::vector<intrinsic_proto::skills::GetBehaviorTreeResponse> responses;
+  std::vector<::grpc::Status> statuses = CallConcurrently(
+      requests, timeout,
+      [this](::grpc::ClientContext* context,
+             const intrinsic_proto::skills::GetBehaviorTreeRequest* request,
+             intrinsic_proto::skills::GetBehaviorTreeResponse* response,
+             std::function<void(::grpc::Status)> on_done) {
+        bt_stub_internal_->async()->GetBehaviorTree(context, request, response,
+                                                    std::move(on_done));
+      },
+      responses);
+
+  for (size_t i = 0; i < to_fetch.size(); ++i) {
+    const std::string& skill_id = skill_ids[to_fetch[i]];
+    if (!statuses[i].ok()) {
+      return AnnotateError(
+          ToAbslStatus(statuses[i]),
+          absl::StrCat("SkillRegistryClient::GetBehaviorTrees(", skill_id,
+                       ") gRPC call failed"));
+    }
+    if (cache_ != nullptr) {
+      cache_->behavior_trees.Insert(skill_id, responses[i].behavior_tree());
+    }
+    behavior_trees[to_fetch[i]] =
+        std::move(*responses[i].mutable_behavior_tree());
+  }
+  return behavior_trees;
 }
 
 absl::Status SkillRegistryClient::RegisterOrUpdateSkill(
@@ -222,6 +494,10 @@ absl::Status SkillRegistryClient::RegisterOrUpdateSkill(
   ::grpc::ClientContext context;
   context.set_deadline(absl::ToChronoTime(absl::Now() + timeout));
 
+  if (cache_ != nullptr) {
+    cache_->skills.Clear();
+  }
+
   intrinsic_proto::skills::RegisterOrUpdateSkillRequest request;
   *request.mutable_skill_registration() = skill_registration;
 
@@ -244,6 +520,10 @@ absl::Status SkillRegistryClient::RegisterOrUpdateBehaviorTree(
   ::grpc::ClientContext context;
   context.set_deadline(absl::ToChronoTime(absl::Now() + timeout));
 
+  if (cache_ != nullptr) {
+    cache_->behavior_trees.Clear();
+  }
+
   intrinsic_proto::skills::RegisterOrUpdateBehaviorTreeRequest request;
   *request.mutable_registration() = behavior_tree_registration;
 
@@ -13,6 +13,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "grpcpp/grpcpp.h"
 #include "grpcpp/impl/channel_interface.h"
 #include "intrinsic/skills/cc/equipment_pack.h"
@@ -24,6 +25,7 @@
 #include "intrinsic/skills/proto/skill_registry.grpc.pb.h"
 #include "intrinsic/skills/proto/skill_registry_config.pb.h"
 #include "intrinsic/skills/proto/skills.pb.h"
+#include "intrinsic/util/grpc/connection_params.h"
 #include "intrinsic/util/grpc/grpc.h"
 
 namespace intrinsic {
@@ -35,13 +37,20 @@ namespace skills {
 class SkillRegistryClient;
 
 // Creates a client that connects to the Skill Registry GRPC service at address
-// `grpc_address`.
+// `grpc_address`. See SkillRegistryClient for `cache_ttl`.
 absl::StatusOr<std::unique_ptr<SkillRegistryClient>> CreateSkillRegistryClient(
     absl::string_view grpc_address,
-    absl::Duration timeout = intrinsic::kGrpcClientConnectDefaultTimeout);
+    absl::Duration timeout = intrinsic::kGrpcClientConnectDefaultTimeout,
+    absl::Duration cache_ttl = absl::ZeroDuration());
 
 // A client for the Skill Registry service.
 //
+// If `cache_ttl` is positive, skills and BehaviorTrees fetched by id are
+// cached for that long, so that repeated lookups do not make a request.
+// Registering a skill or BehaviorTree through this client drops the cached
+// skills or BehaviorTrees, respectively; changes made by other clients are
+// seen once the entries expire.
+//
 // This object is moveable but not copyable.
 class SkillRegistryClient : public SkillRegistryClientInterface {
  public:
@@ -57,11 +66,22 @@ class SkillRegistryClient : public SkillRegistryClientInterface {
           bt_stub_internal,
       std::unique_ptr<
           intrinsic_proto::skills::BehaviorTreeRegistry::StubInterface>
-          bt_stub)
-      : stub_internal_(std::move(stub_internal)),
-        stub_(std::move(stub)),
-        bt_stub_internal_(std::move(bt_stub_internal)),
-        bt_stub_(std::move(bt_stub)) {}
+          bt_stub,
+      absl::Duration cache_ttl = absl::ZeroDuration());
+
+  ~SkillRegistryClient() override;
+
+  SkillRegistryClient(SkillRegistryClient&&);
+  SkillRegistryClient& operator=(SkillRegistryClient&&);
+
+  // Sets the retries and hedging of the reads of skills and BehaviorTrees by
+  // id and of all skills. Not thread-safe, so call it before using the client.
+  // The timeout arguments of the methods override the timeouts of the
+  // policies. Policies are looked up by the full method name, e.g.,
+  // "/intrinsic_proto.skills.SkillRegistry/GetSkill".
+  void SetCallPolicies(CallPolicies call_policies) {
+    call_policies_ = std::move(call_policies);
+  }
 
   absl::StatusOr<std::vector<intrinsic_proto::skills::Skill>> GetSkills()
       const final;
@@ -72,6 +92,12 @@ class SkillRegistryClient : public SkillRegistryClientInterface {
   absl::StatusOr<intrinsic_proto::skills::Skill> GetSkillById(
       absl::string_view skill_id) const final;
 
+  absl::StatusOr<std::vector<intrinsic_proto::skills::Skill>> GetSkillsById(
+      absl::Span<const std::string> skill_ids) const final;
+  absl::StatusOr<std::vector<intrinsic_proto::skills::Skill>> GetSkillsById(
+      absl::Span<const std::string> skill_ids,
+      absl::Duration timeout) const final;
+
   absl::StatusOr<intrinsic_proto::skills::SkillInstance> GetInstance(
       absl::string_view id, const EquipmentPack& equipment) const final;
 
@@ -92,6 +118,12 @@ class SkillRegistryClient : public SkillRegistryClientInterface {
   absl::StatusOr<intrinsic_proto::executive::BehaviorTree> GetBehaviorTree(
       absl::string_view skill_id, absl::Duration timeout) const final;
 
+  absl::StatusOr<std::vector<intrinsic_proto::executive::BehaviorTree>>
+  GetBehaviorTrees(absl::Span<const std::string> skill_ids) const final;
+  absl::StatusOr<std::vector<intrinsic_proto::executive::BehaviorTree>>
+  GetBehaviorTrees(absl::Span<const std::string> skill_ids,
+                   absl::Duration timeout) const final;
+
   absl::Status RegisterOrUpdateSkill(intrinsic_proto::skills::SkillRegistration
                                          skill_registration) const final;
   absl::Status RegisterOrUpdateSkill(
@@ -110,6 +142,8 @@ class SkillRegistryClient : public SkillRegistryClientInterface {
   absl::Status ResetInstanceIds(absl::Duration timeout) const final;
 
  private:
+  struct Cache;
+
   std::shared_ptr<::grpc::ChannelInterface> channel_;
   std::unique_ptr<intrinsic_proto::skills::SkillRegistryInternal::StubInterface>
       stub_internal_;
@@ -119,6 +153,9 @@ class SkillRegistryClient : public SkillRegistryClientInterface {
       bt_stub_internal_;
   std::unique_ptr<intrinsic_proto::skills::BehaviorTreeRegistry::StubInterface>
       bt_stub_;
+  // Null if caching is disabled.
+  std::unique_ptr<Cache> cache_;
+  CallPolicies call_policies_;
 };
 
 }  // namespace skills
@@ -11,6 +11,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "intrinsic/skills/cc/equipment_pack.h"
 #include "intrinsic/skills/proto/equipment.pb.h"
 #include "intrinsic/skills/proto/skill_registry_config.pb.h"
@@ -51,6 +52,21 @@ class SkillRegistryClientInterface {
   virtual absl::StatusOr<intrinsic_proto::skills::Skill> GetSkillById(
       absl::string_view skill_id) const = 0;
 
+  // Fetches the Skills with `skill_ids`, in the same order.
+  //
+  // All requests are in flight at the same time, so this takes about as long
+  // as a single one.
+  //
+  // Returns `DeadlineExceededError` if the requests haven't completed after
+  // `timeout`.
+  //
+  // Returns the first error of any of the requests, annotated with its id.
+  virtual absl::StatusOr<std::vector<intrinsic_proto::skills::Skill>>
+  GetSkillsById(absl::Span<const std::string> skill_ids) const = 0;
+  virtual absl::StatusOr<std::vector<intrinsic_proto::skills::Skill>>
+  GetSkillsById(absl::Span<const std::string> skill_ids,
+                absl::Duration timeout) const = 0;
+
   // Fetches a skill instance matching the given request. `id` is the
   // id of the skill to get an instance of. `equipment` describes which
   // equipment should be used for which equipment slots.
@@ -101,6 +117,22 @@ class SkillRegistryClientInterface {
   virtual absl::StatusOr<intrinsic_proto::executive::BehaviorTree>
   GetBehaviorTree(absl::string_view skill_id, absl::Duration timeout) const = 0;
 
+  // Returns the BehaviorTrees that are registered for the skills with
+  // `skill_ids`, in the same order.
+  //
+  // All requests are in flight at the same time, so this takes about as long
+  // as a single one.
+  //
+  // Returns `DeadlineExceededError` if the requests haven't completed after
+  // `timeout`.
+  //
+  // Returns the first error of any of the requests, annotated with its id.
+  virtual absl::StatusOr<std::vector<intrinsic_proto::executive::BehaviorTree>>
+  GetBehaviorTrees(absl::Span<const std::string> skill_ids) const = 0;
+  virtual absl::StatusOr<std::vector<intrinsic_proto::executive::BehaviorTree>>
+  GetBehaviorTrees(absl::Span<const std::string> skill_ids,
+                   absl::Duration timeout) const = 0;
+
   // Registers a new skill (or updates an existing one). Skill registrations are
   // stored and retrieved by their skill name. If the registry already has a
   // skill registered by skill name then this call will update its registration.
@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "intrinsic/skills/cc/skill_interface.h"
@@ -49,6 +50,10 @@ class SkillRepository {
 
   // Returns the aliases of all Skills registered to this repository.
   virtual std::vector<std::string> GetSkillAliases() const = 0;
+
+  // Prepares skill instances and the data of their calls, e.g., compiled
+  // default parameters, ahead of the first call. Does nothing by default.
+  virtual absl::Status Prewarm() { return absl::OkStatus(); }
 };
 
 }  // namespace skills
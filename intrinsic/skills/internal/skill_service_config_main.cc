@@ -46,6 +46,9 @@ absl::Status MainImpl() {
          ->mutable_cancellation_ready_timeout() =
         manifest.options().cancellation_ready_timeout();
   }
+  service_config.mutable_execution_service_options()
+      ->set_footprint_cache_max_entries(
+          manifest.options().footprint_cache().max_entries());
 
   const std::string proto_descriptor_filename =
       absl::GetFlag(FLAGS_proto_descriptor_filename);
@@ -2,6 +2,9 @@
 
 #include "intrinsic/skills/internal/skill_service_impl.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -9,7 +12,9 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/functional/any_invocable.h"
+#include "absl/hash/hash.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -17,15 +22,21 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "google/protobuf/any.pb.h"
+#include "google/protobuf/duration.pb.h"
 #include "google/protobuf/empty.pb.h"
 #include "google/rpc/status.pb.h"
+#include "grpcpp/alarm.h"
 #include "grpcpp/grpcpp.h"
+#include "grpcpp/support/server_callback.h"
 #include "grpcpp/support/status.h"
 #include "intrinsic/assets/id_utils.h"
+#include "intrinsic/icon/utils/trace_event.h"
 #include "intrinsic/logging/proto/context.pb.h"
 #include "intrinsic/motion_planning/motion_planner_client.h"
 #include "intrinsic/motion_planning/proto/motion_planner_service.grpc.pb.h"
@@ -35,19 +46,24 @@
 #include "intrinsic/skills/internal/equipment_utilities.h"
 #include "intrinsic/skills/internal/error_utils.h"
 #include "intrinsic/skills/internal/execute_context_impl.h"
+#include "intrinsic/skills/internal/footprint_cache.h"
 #include "intrinsic/skills/internal/get_footprint_context_impl.h"
 #include "intrinsic/skills/internal/preview_context_impl.h"
 #include "intrinsic/skills/internal/runtime_data.h"
+#include "intrinsic/skills/internal/skill_operation_executor.h"
 #include "intrinsic/skills/internal/skill_repository.h"
+#include "intrinsic/skills/internal/skill_service_metrics.h"
 #include "intrinsic/skills/proto/error.pb.h"
+#include "intrinsic/skills/proto/footprint.pb.h"
 #include "intrinsic/skills/proto/skill_service.pb.h"
 #include "intrinsic/skills/proto/skills.pb.h"
 #include "intrinsic/util/proto/type_url.h"
+#include "intrinsic/util/proto_time.h"
 #include "intrinsic/util/status/extended_status.pb.h"
 #include "intrinsic/util/status/status_conversion_grpc.h"
 #include "intrinsic/util/status/status_macros.h"
 #include "intrinsic/util/status/status_macros_grpc.h"
-#include "intrinsic/util/thread/thread.h"
+#include "intrinsic/util/thread/thread_pool.h"
 #include "intrinsic/world/objects/object_world_client.h"
 #include "intrinsic/world/proto/object_world_service.grpc.pb.h"
 
@@ -122,7 +138,7 @@ absl::Status UpdateExtendedStatusOnError(
     std::optional<intrinsic_proto::data_logger::Context> log_context) {
   intrinsic_proto::status::ExtendedStatus es;
   std::optional<absl::Cord> extended_status_payload =
-      status.GetPayload(AddTypeUrlPrefix(es));
+      status.GetPayload(TypeUrl<intrinsic_proto::status::ExtendedStatus>());
   if (extended_status_payload) {
     // This should not happen, but since we cannot control the data a skill
     // developer could put anything. Hence, if we fail to interpret the data
@@ -161,56 +177,375 @@ absl::Status UpdateExtendedStatusOnError(
   }
 
   // Update the extended status with the modified version
-  status.SetPayload(AddTypeUrlPrefix(es), es.SerializeAsCord());
+  status.SetPayload(TypeUrl<intrinsic_proto::status::ExtendedStatus>(),
+                    es.SerializeAsCord());
 
   return status;
 }
 
+// Finishes a unary RPC once any of a set of operations is finished, or at a
+// deadline, without blocking a thread while it waits.
+class WaitAnyOperationReactor : public grpc::ServerUnaryReactor {
+ public:
+  // Starts waiting for `operations`. Once the wait ends, `fill_result` is
+  // called to fill the result of the RPC, unless the RPC is cancelled.
+  static grpc::ServerUnaryReactor* Start(
+      std::vector<std::shared_ptr<internal::SkillOperation>> operations,
+      absl::Time deadline, absl::AnyInvocable<void() &&> fill_result) {
+    auto* reactor = new WaitAnyOperationReactor(std::move(operations),
+                                                std::move(fill_result));
+    reactor->Wait(deadline);
+    return reactor;
+  }
+
+  void OnCancel() override { state_->End(grpc::Status::CANCELLED); }
+
+  void OnDone() override { delete this; }
+
+ private:
+  // Shared with the waiters and the alarm, which may outlive the reactor.
+  struct State {
+    absl::Mutex mutex;
+    WaitAnyOperationReactor* reactor;
+    // Whether all waiters are added, so that the wait can end.
+    bool waiting ABSL_GUARDED_BY(mutex) = false;
+    // Set if the wait should end while waiters are still added.
+    std::optional<grpc::Status> pending_status ABSL_GUARDED_BY(mutex);
+    bool ended ABSL_GUARDED_BY(mutex) = false;
+
+    // Ends the wait with `status`, unless it ended already.
+    void End(const grpc::Status& status) {
+      {
+        absl::MutexLock lock(&mutex);
+        if (ended) {
+          return;
+        }
+        if (!waiting) {
+          if (!pending_status.has_value()) {
+            pending_status = status;
+          }
+          return;
+        }
+        ended = true;
+      }
+      // Only the caller that ends the wait accesses the reactor, which is
+      // deleted after it finishes.
+      reactor->EndWait(status);
+    }
+  };
+
+  WaitAnyOperationReactor(
+      std::vector<std::shared_ptr<internal::SkillOperation>> operations,
+      absl::AnyInvocable<void() &&> fill_result)
+      : operations_(std::move(operations)),
+        fill_result_(std::move(fill_result)),
+        state_(std::make_shared<State>()) {
+    state_->reactor = this;
+  }
+
+  void Wait(absl::Time deadline) {
+    for (const std::shared_ptr<internal::SkillOperation>& operation :
+         operations_) {
+      waiter_ids_.push_back(operation->AddFinishedWaiter(
+          [state = state_]() { state->End(grpc::Status::OK); }));
+    }
+    if (deadline != absl::InfiniteFuture()) {
+      alarm_.Set(absl::ToChronoTime(deadline),
+                 [state = std::weak_ptr<State>(state_)](bool ok) {
+                   if (std::shared_ptr<State> locked = state.lock();
+                       ok && locked != nullptr) {
+                     locked->End(grpc::Status::OK);
+                   }
+                 });
+    }
+    grpc::Status status;
+    {
+      absl::MutexLock lock(&state_->mutex);
+      state_->waiting = true;
+      if (!state_->pending_status.has_value()) {
+        return;
+      }
+      state_->ended = true;
+      status = *state_->pending_status;
+    }
+    EndWait(status);
+  }
+
+  void EndWait(const grpc::Status& status) {
+    for (size_t i = 0; i < operations_.size(); ++i) {
+      if (waiter_ids_[i] >= 0) {
+        operations_[i]->RemoveFinishedWaiter(waiter_ids_[i]);
+      }
+    }
+    alarm_.Cancel();
+    if (status.ok()) {
+      std::move(fill_result_)();
+    }
+    Finish(status);
+  }
+
+  std::vector<std::shared_ptr<internal::SkillOperation>> operations_;
+  std::vector<int64_t> waiter_ids_;
+  absl::AnyInvocable<void() &&> fill_result_;
+  std::shared_ptr<State> state_;
+  grpc::Alarm alarm_;
+};
+
+// Returns the deadline of a wait that times out after `timeout`, if set, or
+// at the deadline of the RPC.
+absl::Time WaitDeadline(const grpc::CallbackServerContext& context,
+                        const google::protobuf::Duration* timeout) {
+  absl::Time deadline = absl::FromChrono(context.deadline());
+  if (timeout != nullptr) {
+    deadline = std::min(deadline, absl::Now() + FromProto(*timeout));
+  }
+  return deadline;
+}
+
+grpc::ServerUnaryReactor* FinishWithError(grpc::CallbackServerContext* context,
+                                          const absl::Status& status) {
+  grpc::ServerUnaryReactor* reactor = context->DefaultReactor();
+  reactor->Finish(ToGrpcStatus(status));
+  return reactor;
+}
+
+// Streams the updates of an operation until it is finished, without blocking a
+// thread while it waits for updates.
+class WatchOperationReactor
+    : public grpc::ServerWriteReactor<
+          intrinsic_proto::skills::OperationUpdate> {
+ public:
+  static grpc::ServerWriteReactor<intrinsic_proto::skills::OperationUpdate>*
+  Start(std::shared_ptr<internal::SkillOperation> operation) {
+    auto* reactor = new WatchOperationReactor(std::move(operation));
+    reactor->watcher_id_ = reactor->operation_->AddUpdateWatcher(
+        [reactor]() { reactor->WriteNext(); });
+    {
+      absl::MutexLock lock(&reactor->mutex_);
+      reactor->started_ = true;
+    }
+    reactor->WriteNext();
+    return reactor;
+  }
+
+  // Finishes the stream with `status` right away.
+  static grpc::ServerWriteReactor<intrinsic_proto::skills::OperationUpdate>*
+  FinishWithError(const absl::Status& status) {
+    auto* reactor = new WatchOperationReactor(/*operation=*/nullptr);
+    reactor->Finish(ToGrpcStatus(status));
+    return reactor;
+  }
+
+  void OnWriteDone(bool ok) override {
+    {
+      absl::MutexLock lock(&mutex_);
+      writing_ = false;
+      if (!ok) {
+        cancelled_ = true;
+      }
+    }
+    WriteNext();
+  }
+
+  void OnCancel() override {
+    {
+      absl::MutexLock lock(&mutex_);
+      cancelled_ = true;
+    }
+    WriteNext();
+  }
+
+  void OnDone() override {
+    if (operation_ != nullptr) {
+      operation_->RemoveUpdateWatcher(watcher_id_);
+    }
+    delete this;
+  }
+
+ private:
+  explicit WatchOperationReactor(
+      std::shared_ptr<internal::SkillOperation> operation)
+      : operation_(std::move(operation)) {}
+
+  // Writes the next update unless a write is in flight, and finishes the
+  // stream after the last one.
+  void WriteNext() {
+    absl::MutexLock lock(&mutex_);
+    if (!started_ || writing_ || finished_) {
+      return;
+    }
+    if (cancelled_) {
+      finished_ = true;
+      Finish(grpc::Status::CANCELLED);
+      return;
+    }
+    switch (operation_->GetUpdate(next_index_, &update_)) {
+      case internal::SkillOperation::UpdateState::kAvailable:
+        ++next_index_;
+        writing_ = true;
+        StartWrite(&update_);
+        return;
+      case internal::SkillOperation::UpdateState::kPending:
+        return;
+      case internal::SkillOperation::UpdateState::kEnded:
+        finished_ = true;
+        Finish(grpc::Status::OK);
+        return;
+    }
+  }
+
+  const std::shared_ptr<internal::SkillOperation> operation_;
+  int64_t watcher_id_ = -1;
+
+  absl::Mutex mutex_;
+  // Whether the watcher is added, so that the stream can finish.
+  bool started_ ABSL_GUARDED_BY(mutex_) = false;
+  bool writing_ ABSL_GUARDED_BY(mutex_) = false;
+  bool cancelled_ ABSL_GUARDED_BY(mutex_) = false;
+  bool finished_ ABSL_GUARDED_BY(mutex_) = false;
+  size_t next_index_ ABSL_GUARDED_BY(mutex_) = 0;
+  // The update that is being written.
+  intrinsic_proto::skills::OperationUpdate update_ ABSL_GUARDED_BY(mutex_);
+};
+
 }  // namespace
 
 namespace internal {
 
 absl::Status SkillOperation::Start(
+    SkillOperationExecutor& executor,
     absl::AnyInvocable<
         absl::StatusOr<std::unique_ptr<::google::protobuf::Message>>()>
         op,
     absl::string_view op_name) {
   {
-    absl::MutexLock lock(&thread_mutex_);
+    absl::MutexLock lock(&operation_mutex_);
 
-    if (thread_ != nullptr) {
+    if (started_) {
       return absl::FailedPreconditionError(
-          "An execution thread already exists.");
+          "The operation has already been started.");
     }
-    thread_ = std::make_unique<Thread>(
-        [this,
-         op = std::make_unique<absl::AnyInvocable<
-             absl::StatusOr<std::unique_ptr<::google::protobuf::Message>>()>>(
-             std::move(op)),
-         op_name]() -> absl::Status {
-          absl::StatusOr<std::unique_ptr<::google::protobuf::Message>> result =
-              (*op)();
-
-          {
-            absl::MutexLock lock(&operation_mutex_);
-
-            if (result.ok()) {
-              operation_.mutable_response()->PackFrom(**result);
-            } else {
-              operation_.mutable_error()->MergeFrom(HandleSkillErrorGoogleRpc(
-                  result.status(), runtime_data().GetId(), op_name));
-            }
-
-            operation_.set_done(true);
-          }
+    started_ = true;
+  }
+
+  absl::Status status = executor.Submit(
+      runtime_data().GetId(),
+      [this, op = std::move(op), op_name = std::string(op_name),
+       submit_time = absl::Now()]() mutable {
+        const absl::string_view skill_id = runtime_data().GetId();
+        const absl::Time start_time = absl::Now();
+        RecordSkillRequestStage(skill_id, SkillRequestStage::kQueue,
+                                start_time - submit_time);
+        absl::StatusOr<std::unique_ptr<::google::protobuf::Message>> result =
+            op();
+        const absl::Time return_time = absl::Now();
+        RecordSkillRequestStage(skill_id,
+                                op_name == "Preview"
+                                    ? SkillRequestStage::kPreview
+                                    : SkillRequestStage::kExecute,
+                                return_time - start_time);
+        // Deletes the skill and its context before the operation counts as
+        // finished.
+        op = nullptr;
+        RecordSkillRequestStage(skill_id, SkillRequestStage::kCleanup,
+                                absl::Now() - return_time);
+        Finish(result, op_name);
+      });
+  if (!status.ok()) {
+    Finish(status, op_name);
+  }
+  return status;
+}
 
-          finished_notification_.Notify();
+void SkillOperation::Finish(
+    const absl::StatusOr<std::unique_ptr<::google::protobuf::Message>>& result,
+    absl::string_view op_name) {
+  absl::flat_hash_map<int64_t, absl::AnyInvocable<void() &&>> waiters;
+  {
+    absl::MutexLock lock(&operation_mutex_);
 
-          return absl::OkStatus();
-        });
+    if (result.ok()) {
+      operation_.mutable_response()->PackFrom(**result);
+    } else {
+      operation_.mutable_error()->MergeFrom(HandleSkillErrorGoogleRpc(
+          result.status(), runtime_data().GetId(), op_name));
+    }
+
+    operation_.set_done(true);
+    *updates_.emplace_back().mutable_operation() = operation_;
+    waiters_called_ = true;
+    waiters.swap(finished_waiters_);
   }
 
-  return absl::OkStatus();
+  NotifyUpdateWatchers();
+  if (finished_callback_ != nullptr) {
+    std::move(finished_callback_)();
+  }
+  for (auto& [_, waiter] : waiters) {
+    std::move(waiter)();
+  }
+  // The operation may be deleted once waiters are notified.
+  finished_notification_.Notify();
+}
+
+int64_t SkillOperation::AddFinishedWaiter(
+    absl::AnyInvocable<void() &&> waiter) {
+  {
+    absl::MutexLock lock(&operation_mutex_);
+    if (!waiters_called_) {
+      const int64_t id = next_waiter_id_++;
+      finished_waiters_.emplace(id, std::move(waiter));
+      return id;
+    }
+  }
+  std::move(waiter)();
+  return -1;
+}
+
+void SkillOperation::RemoveFinishedWaiter(int64_t id) {
+  absl::MutexLock lock(&operation_mutex_);
+  finished_waiters_.erase(id);
+}
+
+void SkillOperation::AddUpdate(
+    intrinsic_proto::skills::OperationUpdate update) {
+  {
+    absl::MutexLock lock(&operation_mutex_);
+    if (operation_.done()) {
+      return;
+    }
+    updates_.push_back(std::move(update));
+  }
+  NotifyUpdateWatchers();
+}
+
+SkillOperation::UpdateState SkillOperation::GetUpdate(
+    size_t index, intrinsic_proto::skills::OperationUpdate* update) {
+  absl::MutexLock lock(&operation_mutex_);
+  if (index < updates_.size()) {
+    *update = updates_[index];
+    return UpdateState::kAvailable;
+  }
+  return operation_.done() ? UpdateState::kEnded : UpdateState::kPending;
+}
+
+int64_t SkillOperation::AddUpdateWatcher(absl::AnyInvocable<void()> watcher) {
+  absl::MutexLock lock(&update_watchers_mutex_);
+  const int64_t id = next_update_watcher_id_++;
+  update_watchers_.emplace(id, std::move(watcher));
+  return id;
+}
+
+void SkillOperation::RemoveUpdateWatcher(int64_t id) {
+  absl::MutexLock lock(&update_watchers_mutex_);
+  update_watchers_.erase(id);
+}
+
+void SkillOperation::NotifyUpdateWatchers() {
+  absl::MutexLock lock(&update_watchers_mutex_);
+  for (auto& [_, watcher] : update_watchers_) {
+    watcher();
+  }
 }
 
 absl::Status SkillOperation::RequestCancellation() {
@@ -239,141 +574,112 @@ absl::StatusOr<google::longrunning::Operation> SkillOperation::WaitExecution(
 }
 
 void SkillOperation::WaitOperation(absl::string_view caller_name) {
-  // Wait for the skill operation to finish.
+  // Wait for the skill operation to finish. The skill and its context are
+  // deleted before `finished_notification_` is notified.
   LOG(INFO) << caller_name << " waiting for operation to finish: \"" << name()
             << "\".";
   finished_notification_.WaitForNotification();
 
-  // Wait until the thread that executed the operation is finished. This wait
-  // shouldn't take long, since `finished_notification_` is notified as the
-  // last step of execution.
-  {
-    absl::MutexLock lock(&thread_mutex_);
-    if (thread_ != nullptr && thread_->Joinable()) {
-      LOG(INFO) << caller_name << " joining operation thread: \"" << name()
-                << "\".";
-      thread_->Join();
-      thread_.reset();
-    }
-  }
-
   LOG(INFO) << caller_name << " finished waiting for operation: \"" << name()
             << "\".";
 }
 
 absl::Status SkillOperationCleaner::Watch(
     std::shared_ptr<SkillOperation> operation) {
-  bool start_processing_queue = false;
-  {
-    absl::MutexLock lock(&queue_mutex_);
-
-    queue_.push_back(operation);
+  absl::MutexLock lock(&mutex_);
 
-    if (queue_processed_->HasBeenNotified()) {
-      start_processing_queue = true;
-      queue_processed_ = std::make_shared<absl::Notification>();
-    }
-  }
-
-  if (start_processing_queue) {
-    {
-      absl::MutexLock lock(&thread_mutex_);
-
-      WaitThread();
-      thread_ = std::make_unique<Thread>([this]() { ProcessQueue(); });
-    }
-  }
+  std::erase_if(operations_,
+                [](const std::shared_ptr<SkillOperation>& operation) {
+                  return operation->finished();
+                });
+  operations_.push_back(std::move(operation));
 
   return absl::OkStatus();
 }
 
 void SkillOperationCleaner::WaitOperations(const std::string& caller_name) {
-  std::shared_ptr<absl::Notification> queue_processed;
+  std::vector<std::shared_ptr<SkillOperation>> operations;
   {
-    absl::MutexLock lock(&queue_mutex_);
+    absl::MutexLock lock(&mutex_);
     LOG(INFO) << caller_name << " waiting for cleaner to process "
-              << queue_.size() << " operation(s)).";
+              << operations_.size() << " operation(s)).";
 
-    queue_processed = queue_processed_;
+    operations.swap(operations_);
   }
-  queue_processed->WaitForNotification();
-
-  {
-    absl::MutexLock lock(&thread_mutex_);
-    WaitThread(caller_name);
+  for (const std::shared_ptr<SkillOperation>& operation : operations) {
+    operation->WaitOperation(caller_name);
   }
 
   LOG(INFO) << caller_name << " finished waiting.";
 }
 
-void SkillOperationCleaner::ProcessQueue() {
-  while (true) {
-    std::shared_ptr<SkillOperation> operation;
-    {
-      absl::MutexLock lock(&queue_mutex_);
-      if (queue_.empty()) {
-        queue_processed_->Notify();
-        return;
-      }
-
-      LOG(INFO) << "Cleaner queue has " << queue_.size() << " operation(s).";
-
-      operation = queue_.front();
-      queue_.pop_front();
-    }
+SkillOperations::Shard& SkillOperations::GetShard(absl::string_view name) {
+  return shards_[absl::Hash<absl::string_view>{}(name) % kNumShards];
+}
 
-    operation->WaitOperation("Cleaner");
+void SkillOperations::Remove(const std::shared_ptr<SkillOperation>& operation) {
+  const std::string name = operation->name();
+  Shard& shard = GetShard(name);
+  absl::MutexLock lock(&shard.mutex);
+  if (auto it = shard.operations.find(name);
+      it != shard.operations.end() && it->second == operation) {
+    shard.operations.erase(it);
   }
 }
 
-void SkillOperationCleaner::WaitThread(const std::string& caller_name) {
-  if (thread_ != nullptr) {
-    if (!caller_name.empty()) {
-      LOG(INFO) << caller_name << " joining cleaner thread.";
-    }
-    thread_->Join();
-    thread_.reset();
-  }
+void SkillOperations::OnFinished(std::shared_ptr<SkillOperation> operation) {
+  absl::MutexLock lock(&finished_mutex_);
+  finished_.push_back(std::move(operation));
 }
 
 absl::Status SkillOperations::Add(std::shared_ptr<SkillOperation> operation) {
-  absl::MutexLock lock(&update_mutex_);
+  absl::ReaderMutexLock clear_lock(&clear_mutex_);
 
-  // First remove the oldest finished operation if we've reached our limit of
-  // tracked operations.
-  while (operation_names_.size() >= kMaxNumOperations) {
-    bool finished_operation_found = false;
-    for (auto name_it = operation_names_.begin(), end = operation_names_.end();
-         name_it != end; ++name_it) {
-      auto op_it = operations_.find(*name_it);
-      if (op_it == operations_.end()) {
-        return absl::InternalError(absl::StrFormat(
-            "%s found in operation_names_ but not in operations_.", *name_it));
-      }
-      if (op_it->second->finished()) {
-        finished_operation_found = true;
-        operation_names_.erase(name_it);
-        operations_.erase(op_it);
-        break;
-      }
-    }
-    if (!finished_operation_found) {
-      return absl::FailedPreconditionError(
-          absl::StrFormat("Cannot add operation %s, since there are already %d "
-                          "unfinished operations.",
-                          operation->name(), operations_.size()));
+  std::string operation_name = operation->name();
+  {
+    Shard& shard = GetShard(operation_name);
+    absl::MutexLock lock(&shard.mutex);
+    if (auto [_, inserted] =
+            shard.operations.emplace(operation_name, operation);
+        !inserted) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "An operation already exists with name '%s'.", operation_name));
     }
   }
 
-  std::string operation_name = operation->name();
-
-  if (auto [_, inserted] = operations_.emplace(operation_name, operation);
-      !inserted) {
-    return absl::InvalidArgumentError(absl::StrFormat(
-        "An operation already exists with name '%s'.", operation_name));
+  // Remove the operation that finished first if we've reached our limit of
+  // tracked operations.
+  std::shared_ptr<SkillOperation> evicted;
+  std::optional<int32_t> num_unfinished;
+  {
+    absl::MutexLock lock(&finished_mutex_);
+    if (num_operations_ < kMaxNumOperations) {
+      ++num_operations_;
+    } else if (!finished_.empty()) {
+      evicted = std::move(finished_.front());
+      finished_.pop_front();
+    } else {
+      num_unfinished = num_operations_;
+    }
+  }
+  if (num_unfinished.has_value()) {
+    Remove(operation);
+    return absl::FailedPreconditionError(
+        absl::StrFormat("Cannot add operation %s, since there are already %d "
+                        "unfinished operations.",
+                        operation_name, *num_unfinished));
+  }
+  if (evicted != nullptr) {
+    Remove(evicted);
   }
 
-  operation_names_.push_back(operation_name);
+  operation->SetFinishedCallback(
+      [this, weak_operation = std::weak_ptr<SkillOperation>(operation)]() {
+        if (std::shared_ptr<SkillOperation> operation = weak_operation.lock();
+            operation != nullptr) {
+          OnFinished(std::move(operation));
+        }
+      });
 
   INTR_RETURN_IF_ERROR(cleaner_.Watch(operation));
 
@@ -382,9 +688,10 @@ absl::Status SkillOperations::Add(std::shared_ptr<SkillOperation> operation) {
 
 absl::StatusOr<std::shared_ptr<SkillOperation>> SkillOperations::Get(
     absl::string_view name) {
-  absl::MutexLock lock(&update_mutex_);
-  auto itr = operations_.find(name);
-  if (itr == operations_.end()) {
+  Shard& shard = GetShard(name);
+  absl::MutexLock lock(&shard.mutex);
+  auto itr = shard.operations.find(name);
+  if (itr == shard.operations.end()) {
     return absl::NotFoundError(
         absl::StrFormat("No operation found with name '%s'.", name));
   }
@@ -392,12 +699,20 @@ absl::StatusOr<std::shared_ptr<SkillOperation>> SkillOperations::Get(
 }
 
 absl::Status SkillOperations::Clear(bool wait_for_operations) {
-  absl::MutexLock lock(&update_mutex_);
+  absl::MutexLock clear_lock(&clear_mutex_);
+
+  std::vector<std::shared_ptr<SkillOperation>> operations;
+  for (Shard& shard : shards_) {
+    absl::MutexLock lock(&shard.mutex);
+    for (const auto& [_, operation] : shard.operations) {
+      operations.push_back(operation);
+    }
+  }
 
   std::vector<std::string> unfinished_operation_names;
-  for (auto& [_, operation] : operations_) {
+  for (const std::shared_ptr<SkillOperation>& operation : operations) {
     if (operation->finished() || wait_for_operations) {
-      // Wait until the operation thread is finished.
+      // Wait until the operation is finished.
       operation->WaitOperation("Clear operations");
     } else {
       unfinished_operation_names.push_back(operation->name());
@@ -409,10 +724,17 @@ absl::Status SkillOperations::Clear(bool wait_for_operations) {
                         absl::StrJoin(unfinished_operation_names, ", ")));
   }
 
-  operations_ = {};
-  operation_names_ = {};
+  for (Shard& shard : shards_) {
+    absl::MutexLock lock(&shard.mutex);
+    shard.operations = {};
+  }
+  {
+    absl::MutexLock lock(&finished_mutex_);
+    finished_ = {};
+    num_operations_ = 0;
+  }
 
-  // Wait until the cleaner thread is finished.
+  // Wait until all watched operations are finished.
   cleaner_.WaitOperations("Clear operations");
 
   return absl::OkStatus();
@@ -423,23 +745,111 @@ absl::Status SkillOperations::Clear(bool wait_for_operations) {
 SkillProjectorServiceImpl::SkillProjectorServiceImpl(
     SkillRepository& skill_repository,
     std::shared_ptr<ObjectWorldService::StubInterface> object_world_service,
-    std::shared_ptr<MotionPlannerService::StubInterface> motion_planner_service)
+    std::shared_ptr<MotionPlannerService::StubInterface> motion_planner_service,
+    int batch_concurrency)
     : object_world_service_(std::move(object_world_service)),
       motion_planner_service_(std::move(motion_planner_service)),
       skill_repository_(skill_repository),
-      message_factory_(google::protobuf::MessageFactory::generated_factory()) {}
+      message_factory_(google::protobuf::MessageFactory::generated_factory()),
+      batch_concurrency_(std::max(batch_concurrency, 1)) {}
+
+internal::FootprintCache* SkillProjectorServiceImpl::GetFootprintCache(
+    absl::string_view skill_name, size_t max_entries) {
+  if (max_entries == 0) {
+    return nullptr;
+  }
+  absl::MutexLock lock(&footprint_caches_mutex_);
+  std::unique_ptr<internal::FootprintCache>& cache =
+      footprint_caches_[skill_name];
+  if (cache == nullptr) {
+    cache = std::make_unique<internal::FootprintCache>(max_entries);
+  }
+  return cache.get();
+}
 
-absl::StatusOr<GetFootprintRequest>
-SkillProjectorServiceImpl::ProtoToGetFootprintRequest(
+absl::StatusOr<SkillProjectorServiceImpl::FootprintInputs>
+SkillProjectorServiceImpl::GetFootprintInputs(
     const intrinsic_proto::skills::GetFootprintRequest& request) {
-  INTR_ASSIGN_OR_RETURN(std::string id,
+  FootprintInputs inputs;
+  INTR_ASSIGN_OR_RETURN(inputs.skill_id,
                         RemoveVersionFrom(request.instance().id_version()));
-  INTR_ASSIGN_OR_RETURN(std::string skill_name, NameFrom(id));
-  INTR_ASSIGN_OR_RETURN(internal::SkillRuntimeData runtime_data,
-                        skill_repository_.GetSkillRuntimeData(skill_name));
+  INTR_ASSIGN_OR_RETURN(inputs.skill_name, NameFrom(inputs.skill_id));
+  INTR_ASSIGN_OR_RETURN(
+      inputs.runtime_data,
+      skill_repository_.GetSkillRuntimeData(inputs.skill_name));
+  INTR_ASSIGN_OR_RETURN(inputs.equipment,
+                        EquipmentPack::GetEquipmentPack(request));
+  INTR_ASSIGN_OR_RETURN(
+      inputs.resource_reservations,
+      ReserveEquipmentRequired(
+          inputs.runtime_data.GetResourceData().GetRequiredResources(),
+          request.instance().resource_handles()));
+
+  // Skills that opt into caching return the same footprint for the same
+  // request on the same world, so repeated requests, e.g., of a planner that
+  // searches a behavior tree, do not call the skill again.
+  inputs.footprint_cache = GetFootprintCache(
+      inputs.skill_name,
+      inputs.runtime_data.GetExecutionOptions().GetFootprintCacheMaxEntries());
+  if (inputs.footprint_cache != nullptr) {
+    INTR_ASSIGN_OR_RETURN(
+        inputs.world_version,
+        world::ObjectWorldClient(request.world_id(), object_world_service_)
+            .GetWorldVersion());
+  }
+  return inputs;
+}
 
-  return GetFootprintRequest(request.parameters(),
-                             runtime_data.GetParameterData().GetDefault());
+absl::Status SkillProjectorServiceImpl::ComputeFootprint(
+    const FootprintInputs& inputs,
+    const intrinsic_proto::skills::GetFootprintRequest& request,
+    absl::StatusOr<intrinsic_proto::skills::Footprint>& footprint) {
+  std::string cache_key;
+  if (inputs.footprint_cache != nullptr) {
+    cache_key = internal::FootprintCache::Key(inputs.world_version, request);
+    if (std::optional<intrinsic_proto::skills::Footprint> cached =
+            inputs.footprint_cache->Find(cache_key);
+        cached.has_value()) {
+      footprint = *std::move(cached);
+      return absl::OkStatus();
+    }
+  }
+
+  INTR_ASSIGN_OR_RETURN(std::unique_ptr<SkillProjectInterface> skill,
+                        skill_repository_.GetSkillProject(inputs.skill_name));
+  GetFootprintRequest get_footprint_request(
+      request.parameters(),
+      inputs.runtime_data.GetParameterData().GetCompiledDefault());
+  GetFootprintContextImpl footprint_context(
+      inputs.equipment,
+      /*motion_planner=*/
+      motion_planning::MotionPlannerClient(request.world_id(),
+                                           motion_planner_service_),
+      /*object_world=*/
+      world::ObjectWorldClient(request.world_id(), object_world_service_));
+  footprint = skill->GetFootprint(get_footprint_request, footprint_context);
+  if (!footprint.ok()) {
+    return absl::OkStatus();
+  }
+
+  // Populate the footprint with equipment reservations.
+  for (const auto& resource_reservation : inputs.resource_reservations) {
+    *footprint->add_resource_reservation() = resource_reservation;
+  }
+  if (inputs.footprint_cache != nullptr) {
+    inputs.footprint_cache->Insert(cache_key, *footprint);
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<ThreadPool*> SkillProjectorServiceImpl::GetBatchPool() {
+  absl::MutexLock lock(&batch_pool_mutex_);
+  if (batch_pool_ == nullptr) {
+    ThreadPool::Options options{.num_workers = batch_concurrency_};
+    options.worker_options.SetName("projector_batch");
+    INTR_ASSIGN_OR_RETURN(batch_pool_, ThreadPool::Create(options));
+  }
+  return batch_pool_.get();
 }
 
 grpc::Status SkillProjectorServiceImpl::GetFootprint(
@@ -451,52 +861,110 @@ grpc::Status SkillProjectorServiceImpl::GetFootprint(
             << request->world_id() << "'";
 
   INTR_RETURN_IF_ERROR_GRPC(ValidateRequest(*request));
+  INTR_ASSIGN_OR_RETURN_GRPC(FootprintInputs inputs,
+                             GetFootprintInputs(*request));
+
+  LOG(INFO) << "Calling GetFootprint for skill name: " << inputs.skill_name;
+  absl::StatusOr<intrinsic_proto::skills::Footprint> footprint;
+  INTR_RETURN_IF_ERROR_GRPC(ComputeFootprint(inputs, *request, footprint));
+  if (!footprint.ok()) {
+    return HandleSkillErrorGrpc(footprint.status(), inputs.skill_id,
+                                "GetFootprint");
+  }
+  *result->mutable_footprint() = *std::move(footprint);
+  return ::grpc::Status::OK;
+}
 
-  INTR_ASSIGN_OR_RETURN_GRPC(const std::string skill_name,
-                             NameFrom(request->instance().id_version()));
-  LOG(INFO) << "Calling GetFootprint for skill name: " << skill_name;
-  INTR_ASSIGN_OR_RETURN_GRPC(std::unique_ptr<SkillProjectInterface> skill,
-                             skill_repository_.GetSkillProject(skill_name));
-
-  INTR_ASSIGN_OR_RETURN_GRPC(GetFootprintRequest get_footprint_request,
-                             ProtoToGetFootprintRequest(*request));
+grpc::Status SkillProjectorServiceImpl::GetFootprintBatch(
+    grpc::ServerContext* context,
+    const intrinsic_proto::skills::GetFootprintBatchRequest* request,
+    grpc::ServerWriter<intrinsic_proto::skills::GetFootprintBatchResult>*
+        writer) {
+  LOG(INFO) << "Attempting to get " << request->parameters_size()
+            << " footprints of '" << request->instance().id_version()
+            << "' skill with world id '" << request->world_id() << "'";
 
-  INTR_ASSIGN_OR_RETURN_GRPC(EquipmentPack equipment,
-                             EquipmentPack::GetEquipmentPack(*request));
+  INTR_RETURN_IF_ERROR_GRPC(ValidateRequest(*request));
 
-  GetFootprintContextImpl footprint_context(
-      std::move(equipment),
-      /*motion_planner=*/
-      motion_planning::MotionPlannerClient(request->world_id(),
-                                           motion_planner_service_),
-      /*object_world=*/
-      world::ObjectWorldClient(request->world_id(), object_world_service_));
-  auto skill_result =
-      skill->GetFootprint(get_footprint_request, footprint_context);
-
-  if (!skill_result.ok()) {
-    INTR_ASSIGN_OR_RETURN_GRPC(
-        const std::string skill_id,
-        RemoveVersionFrom(request->instance().id_version()));
-    return HandleSkillErrorGrpc(skill_result.status(), skill_id,
-                                "GetFootprint");
+  // All candidates share everything but the parameters, so the skill, its
+  // equipment and the world version are only resolved once.
+  intrinsic_proto::skills::GetFootprintRequest shared_request;
+  shared_request.set_world_id(request->world_id());
+  *shared_request.mutable_instance() = request->instance();
+  *shared_request.mutable_context() = request->context();
+  INTR_ASSIGN_OR_RETURN_GRPC(const FootprintInputs inputs,
+                             GetFootprintInputs(shared_request));
+
+  const int num_candidates = request->parameters_size();
+  if (num_candidates == 0) {
+    return ::grpc::Status::OK;
+  }
+  int num_workers = std::min(batch_concurrency_, num_candidates);
+  if (request->max_concurrency() > 0) {
+    num_workers =
+        std::min(num_workers, static_cast<int>(request->max_concurrency()));
   }
 
-  INTR_ASSIGN_OR_RETURN_GRPC(internal::SkillRuntimeData runtime_data,
-                             skill_repository_.GetSkillRuntimeData(skill_name));
+  // Each worker projects the next candidate that no worker has taken yet, so
+  // that slow candidates do not hold up the others. Results are streamed in
+  // the order in which they complete.
+  std::atomic<int> next_index = 0;
+  absl::Mutex writer_mutex;
+  auto project_candidates = [&]() {
+    intrinsic_proto::skills::GetFootprintRequest candidate = shared_request;
+    for (int index = next_index++;
+         index < num_candidates && !context->IsCancelled();
+         index = next_index++) {
+      *candidate.mutable_parameters() = request->parameters(index);
+      intrinsic_proto::skills::GetFootprintBatchResult result;
+      result.set_index(index);
+      absl::StatusOr<intrinsic_proto::skills::Footprint> footprint;
+      if (absl::Status status = ComputeFootprint(inputs, candidate, footprint);
+          !status.ok()) {
+        intrinsic_proto::skills::SkillErrorInfo error_info;
+        error_info.set_error_type(
+            intrinsic_proto::skills::SkillErrorInfo::ERROR_TYPE_GRPC);
+        *result.mutable_error() = ToGoogleRpcStatus(status, error_info);
+      } else if (!footprint.ok()) {
+        *result.mutable_error() = HandleSkillErrorGoogleRpc(
+            footprint.status(), inputs.skill_id, "GetFootprint");
+      } else {
+        *result.mutable_result()->mutable_footprint() = *std::move(footprint);
+      }
+      absl::MutexLock lock(&writer_mutex);
+      writer->Write(result);
+    }
+  };
 
-  // Populate the footprint in the result with equipment reservations.
-  *result->mutable_footprint() = std::move(skill_result).value();
-  INTR_ASSIGN_OR_RETURN_GRPC(
-      auto resource_reservations,
-      ReserveEquipmentRequired(
-          runtime_data.GetResourceData().GetRequiredResources(),
-          request->instance().resource_handles()));
-  for (const auto& resource_reservation : resource_reservations) {
-    *result->mutable_footprint()->add_resource_reservation() =
-        resource_reservation;
+  // The handler thread is one of the workers, so a batch makes progress even
+  // if the pool is busy with other batches.
+  int num_submitted = 0;
+  absl::BlockingCounter pool_workers_done(num_workers - 1);
+  if (num_workers > 1) {
+    INTR_ASSIGN_OR_RETURN_GRPC(ThreadPool * pool, GetBatchPool());
+    for (; num_submitted < num_workers - 1; ++num_submitted) {
+      absl::Status submitted =
+          pool->Submit([&project_candidates, &pool_workers_done]() {
+            project_candidates();
+            pool_workers_done.DecrementCount();
+          });
+      if (!submitted.ok()) {
+        // The pool is full, the remaining candidates are projected by fewer
+        // workers.
+        break;
+      }
+    }
   }
+  for (int i = num_submitted; i < num_workers - 1; ++i) {
+    pool_workers_done.DecrementCount();
+  }
+  project_candidates();
+  pool_workers_done.Wait();
 
+  if (context->IsCancelled()) {
+    return ::grpc::Status(::grpc::StatusCode::CANCELLED,
+                          "GetFootprintBatch was cancelled");
+  }
   return ::grpc::Status::OK;
 }
 
@@ -509,16 +977,38 @@ grpc::Status SkillProjectorServiceImpl::Predict(
   return ::grpc::Status::OK;
 }
 
+grpc::Status SkillProjectorServiceImpl::PredictBatch(
+    grpc::ServerContext* context,
+    const intrinsic_proto::skills::PredictBatchRequest* request,
+    grpc::ServerWriter<intrinsic_proto::skills::PredictBatchResult>* writer) {
+  // Like Predict(), every candidate has a single outcome, so there is nothing
+  // to parallelize.
+  intrinsic_proto::skills::PredictBatchResult result;
+  result.mutable_result()->set_internal_data(request->internal_data());
+  result.mutable_result()->add_outcomes()->set_probability(1.0);
+  for (int index = 0; index < request->parameters_size(); ++index) {
+    if (context->IsCancelled()) {
+      return ::grpc::Status(::grpc::StatusCode::CANCELLED,
+                            "PredictBatch was cancelled");
+    }
+    result.set_index(index);
+    writer->Write(result);
+  }
+  return ::grpc::Status::OK;
+}
+
 SkillExecutorServiceImpl::SkillExecutorServiceImpl(
     SkillRepository& skill_repository,
     std::shared_ptr<ObjectWorldService::StubInterface> object_world_service,
     std::shared_ptr<MotionPlannerService::StubInterface> motion_planner_service,
-    RequestWatcher* request_watcher)
+    RequestWatcher* request_watcher,
+    const internal::SkillOperationExecutor::Options& executor_options)
     : skill_repository_(skill_repository),
       object_world_service_(std::move(object_world_service)),
       motion_planner_service_(std::move(motion_planner_service)),
       request_watcher_(request_watcher),
-      message_factory_(google::protobuf::MessageFactory::generated_factory()) {}
+      message_factory_(google::protobuf::MessageFactory::generated_factory()),
+      executor_(executor_options) {}
 
 SkillExecutorServiceImpl::~SkillExecutorServiceImpl() {
   operations_.Clear(true).IgnoreError();
@@ -548,13 +1038,24 @@ grpc::Status SkillExecutorServiceImpl::StartExecute(
   INTR_ASSIGN_OR_RETURN_GRPC(std::unique_ptr<SkillExecuteInterface> skill,
                              skill_repository_.GetSkillExecute(skill_name));
 
+  const absl::string_view skill_id = operation->runtime_data().GetId();
+  const absl::Time parameters_start = absl::Now();
   auto skill_request = std::make_unique<ExecuteRequest>(
       /*params=*/request->parameters(),
       /*param_defaults=*/
-      operation->runtime_data().GetParameterData().GetDefault());
+      operation->runtime_data().GetParameterData().GetCompiledDefault());
+  const absl::Time equipment_start = absl::Now();
+  internal::RecordSkillRequestStage(skill_id,
+                                    internal::SkillRequestStage::kParameters,
+                                    equipment_start - parameters_start);
 
   INTR_ASSIGN_OR_RETURN_GRPC(EquipmentPack equipment,
                              EquipmentPack::GetEquipmentPack(*request));
+  // Parses the equipment once, instead of whenever the skill reads it.
+  equipment.UnpackAll();
+  internal::RecordSkillRequestStage(skill_id,
+                                    internal::SkillRequestStage::kEquipment,
+                                    absl::Now() - equipment_start);
 
   SkillLoggingContext logging_context = {
       .data_logger_context = request->context(),
@@ -568,15 +1069,23 @@ grpc::Status SkillExecutorServiceImpl::StartExecute(
       motion_planning::MotionPlannerClient(request->world_id(),
                                            motion_planner_service_),
       /*object_world=*/
-      world::ObjectWorldClient(request->world_id(), object_world_service_));
+      world::ObjectWorldClient(request->world_id(), object_world_service_),
+      // The context is deleted before the operation finishes.
+      /*update_callback=*/
+      [operation = operation.get()](
+          intrinsic_proto::skills::OperationUpdate update) {
+        operation->AddUpdate(std::move(update));
+      });
 
   INTR_RETURN_IF_ERROR_GRPC(operation->Start(
+      executor_,
       [skill = std::move(skill),
        skill_id = std::string(operation->runtime_data().GetId()),
        skill_request = std::move(skill_request),
        skill_context = std::move(skill_context), request = *request]()
           -> absl::StatusOr<
               std::unique_ptr<intrinsic_proto::skills::ExecuteResult>> {
+        INTRINSIC_TRACE_SCOPE("skills", "Execute");
         INTR_ASSIGN_OR_RETURN(
             std::unique_ptr<::google::protobuf::Message> skill_result,
             skill->Execute(*skill_request, *skill_context),
@@ -628,13 +1137,24 @@ grpc::Status SkillExecutorServiceImpl::StartPreview(
   INTR_ASSIGN_OR_RETURN_GRPC(std::unique_ptr<SkillExecuteInterface> skill,
                              skill_repository_.GetSkillExecute(skill_name));
 
+  const absl::string_view skill_id = operation->runtime_data().GetId();
+  const absl::Time parameters_start = absl::Now();
   auto skill_request = std::make_unique<PreviewRequest>(
       /*params=*/request->parameters(),
       /*param_defaults=*/
-      operation->runtime_data().GetParameterData().GetDefault());
+      operation->runtime_data().GetParameterData().GetCompiledDefault());
+  const absl::Time equipment_start = absl::Now();
+  internal::RecordSkillRequestStage(skill_id,
+                                    internal::SkillRequestStage::kParameters,
+                                    equipment_start - parameters_start);
 
   INTR_ASSIGN_OR_RETURN_GRPC(EquipmentPack equipment,
                              EquipmentPack::GetEquipmentPack(*request));
+  // Parses the equipment once, instead of whenever the skill reads it.
+  equipment.UnpackAll();
+  internal::RecordSkillRequestStage(skill_id,
+                                    internal::SkillRequestStage::kEquipment,
+                                    absl::Now() - equipment_start);
 
   SkillLoggingContext logging_context = {
       .data_logger_context = request->context(),
@@ -654,6 +1174,7 @@ grpc::Status SkillExecutorServiceImpl::StartPreview(
   );
 
   INTR_RETURN_IF_ERROR_GRPC(operation->Start(
+      executor_,
       [skill = std::move(skill), skill_request = std::move(skill_request),
        skill_context = std::move(skill_context)]()
           -> absl::StatusOr<
@@ -705,17 +1226,64 @@ grpc::Status SkillExecutorServiceImpl::CancelOperation(
   return grpc::Status::OK;
 }
 
-grpc::Status SkillExecutorServiceImpl::WaitOperation(
-    grpc::ServerContext* context,
+grpc::ServerUnaryReactor* SkillExecutorServiceImpl::WaitOperation(
+    grpc::CallbackServerContext* context,
     const google::longrunning::WaitOperationRequest* request,
     google::longrunning::Operation* result) {
-  INTR_ASSIGN_OR_RETURN_GRPC(
-      std::shared_ptr<internal::SkillOperation> operation,
-      operations_.Get(request->name()));
-  INTR_ASSIGN_OR_RETURN_GRPC(
-      *result, operation->WaitExecution(absl::FromChrono(context->deadline())));
+  absl::StatusOr<std::shared_ptr<internal::SkillOperation>> operation =
+      operations_.Get(request->name());
+  if (!operation.ok()) {
+    return FinishWithError(context, operation.status());
+  }
 
-  return grpc::Status::OK;
+  return WaitAnyOperationReactor::Start(
+      {*operation},
+      WaitDeadline(*context,
+                   request->has_timeout() ? &request->timeout() : nullptr),
+      [result, operation = *operation]() { *result = operation->operation(); });
+}
+
+grpc::ServerUnaryReactor* SkillExecutorServiceImpl::WaitAnyOperation(
+    grpc::CallbackServerContext* context,
+    const intrinsic_proto::skills::WaitAnyOperationRequest* request,
+    intrinsic_proto::skills::WaitAnyOperationResponse* result) {
+  if (request->names().empty()) {
+    return FinishWithError(context, absl::InvalidArgumentError(
+                                        "No operation names were given."));
+  }
+  std::vector<std::shared_ptr<internal::SkillOperation>> operations;
+  operations.reserve(request->names_size());
+  for (const std::string& name : request->names()) {
+    absl::StatusOr<std::shared_ptr<internal::SkillOperation>> operation =
+        operations_.Get(name);
+    if (!operation.ok()) {
+      return FinishWithError(context, operation.status());
+    }
+    operations.push_back(*std::move(operation));
+  }
+
+  return WaitAnyOperationReactor::Start(
+      operations,
+      WaitDeadline(*context,
+                   request->has_timeout() ? &request->timeout() : nullptr),
+      [result, operations]() {
+        for (const std::shared_ptr<internal::SkillOperation>& operation :
+             operations) {
+          *result->add_operations() = operation->operation();
+        }
+      });
+}
+
+grpc::ServerWriteReactor<intrinsic_proto::skills::OperationUpdate>*
+SkillExecutorServiceImpl::WatchOperation(
+    grpc::CallbackServerContext* context,
+    const intrinsic_proto::skills::WatchOperationRequest* request) {
+  absl::StatusOr<std::shared_ptr<internal::SkillOperation>> operation =
+      operations_.Get(request->name());
+  if (!operation.ok()) {
+    return WatchOperationReactor::FinishWithError(operation.status());
+  }
+  return WatchOperationReactor::Start(*std::move(operation));
 }
 
 grpc::Status SkillExecutorServiceImpl::ClearOperations(
@@ -724,6 +1292,14 @@ grpc::Status SkillExecutorServiceImpl::ClearOperations(
   return ToGrpcStatus(operations_.Clear(false));
 }
 
+absl::StatusOr<google::longrunning::Operation>
+SkillExecutorServiceImpl::WaitOperationInProcess(absl::string_view name,
+                                                 absl::Time deadline) {
+  INTR_ASSIGN_OR_RETURN(std::shared_ptr<internal::SkillOperation> operation,
+                        operations_.Get(name));
+  return operation->WaitExecution(deadline);
+}
+
 absl::StatusOr<std::shared_ptr<internal::SkillOperation>>
 SkillExecutorServiceImpl::MakeOperation(absl::string_view name,
                                         absl::string_view skill_name,
@@ -3,6 +3,7 @@
 #ifndef INTRINSIC_SKILLS_INTERNAL_SKILL_SERVICE_IMPL_H_
 #define INTRINSIC_SKILLS_INTERNAL_SKILL_SERVICE_IMPL_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <deque>
 #include <memory>
@@ -22,17 +23,24 @@
 #include "google/longrunning/operations.pb.h"
 #include "google/protobuf/empty.pb.h"
 #include "google/protobuf/message.h"
+#include "google/protobuf/repeated_ptr_field.h"
 #include "grpcpp/server_context.h"
+#include "grpcpp/support/server_callback.h"
 #include "grpcpp/support/status.h"
+#include "grpcpp/support/sync_stream.h"
 #include "intrinsic/motion_planning/proto/motion_planner_service.grpc.pb.h"
+#include "intrinsic/skills/cc/equipment_pack.h"
 #include "intrinsic/skills/cc/skill_canceller.h"
 #include "intrinsic/skills/cc/skill_interface.h"
+#include "intrinsic/skills/internal/footprint_cache.h"
 #include "intrinsic/skills/internal/runtime_data.h"
+#include "intrinsic/skills/internal/skill_operation_executor.h"
 #include "intrinsic/skills/internal/skill_repository.h"
+#include "intrinsic/skills/proto/footprint.pb.h"
 #include "intrinsic/skills/proto/skill_service.grpc.pb.h"
 #include "intrinsic/skills/proto/skill_service.pb.h"
 #include "intrinsic/skills/proto/skills.pb.h"
-#include "intrinsic/util/thread/thread.h"
+#include "intrinsic/util/thread/thread_pool.h"
 #include "intrinsic/world/proto/object_world_service.grpc.pb.h"
 
 namespace intrinsic {
@@ -81,12 +89,64 @@ class SkillOperation {
     return runtime_data_;
   }
 
-  // Starts executing the skill operation.
+  // Starts executing the skill operation on `executor`.
+  //
+  // If the executor cannot take the operation, the operation finishes with
+  // the error, which is returned as well.
   absl::Status Start(
+      SkillOperationExecutor& executor,
       absl::AnyInvocable<
           absl::StatusOr<std::unique_ptr<::google::protobuf::Message>>()>
           op,
-      absl::string_view op_name) ABSL_LOCKS_EXCLUDED(thread_mutex_);
+      absl::string_view op_name) ABSL_LOCKS_EXCLUDED(operation_mutex_);
+
+  // Sets a callback that is called once the operation finishes, before
+  // waiters are notified. Must be called before Start().
+  void SetFinishedCallback(absl::AnyInvocable<void() &&> callback) {
+    finished_callback_ = std::move(callback);
+  }
+
+  // Calls `waiter` once the operation is finished, or right away if it
+  // already is. Returns an id for RemoveFinishedWaiter(), or -1 if `waiter` was
+  // called right away.
+  //
+  // Unlike WaitExecution(), this does not block a thread while waiting.
+  int64_t AddFinishedWaiter(absl::AnyInvocable<void() &&> waiter)
+      ABSL_LOCKS_EXCLUDED(operation_mutex_);
+
+  // Removes a waiter added with AddFinishedWaiter(), unless it is called
+  // already.
+  void RemoveFinishedWaiter(int64_t id) ABSL_LOCKS_EXCLUDED(operation_mutex_);
+
+  // Adds an update reported by the skill. Updates are kept until the operation
+  // is removed, so that watchers that start late receive all of them.
+  void AddUpdate(intrinsic_proto::skills::OperationUpdate update)
+      ABSL_LOCKS_EXCLUDED(operation_mutex_, update_watchers_mutex_);
+
+  enum class UpdateState {
+    // `update` was set to the requested update.
+    kAvailable,
+    // The requested update was not added yet.
+    kPending,
+    // The operation is finished and all updates, the last of which carries
+    // the finished operation, were requested.
+    kEnded,
+  };
+
+  // Gets the update at `index`, in the order in which updates were added.
+  UpdateState GetUpdate(size_t index,
+                        intrinsic_proto::skills::OperationUpdate* update)
+      ABSL_LOCKS_EXCLUDED(operation_mutex_);
+
+  // Calls `watcher` whenever an update is added, including the last one.
+  // Returns an id for RemoveUpdateWatcher().
+  int64_t AddUpdateWatcher(absl::AnyInvocable<void()> watcher)
+      ABSL_LOCKS_EXCLUDED(update_watchers_mutex_);
+
+  // Removes a watcher added with AddUpdateWatcher(). The watcher is not called
+  // anymore once this returns.
+  void RemoveUpdateWatcher(int64_t id)
+      ABSL_LOCKS_EXCLUDED(update_watchers_mutex_);
 
   // Requests cancellation of the operation.
   absl::Status RequestCancellation();
@@ -100,78 +160,88 @@ class SkillOperation {
   // Waits for the entire operation to finish.
   //
   // This wait is similar to `WaitExecution`, except that it also waits for
-  // post-execution cleanup, like joining and deleting the thread that executed
-  // the skill.
+  // post-execution cleanup, like deleting the skill and its context.
   //
   // `caller_name` is specified for logging.
-  void WaitOperation(absl::string_view caller_name)
-      ABSL_LOCKS_EXCLUDED(thread_mutex_);
+  void WaitOperation(absl::string_view caller_name);
 
  private:
+  // Calls all update watchers.
+  void NotifyUpdateWatchers() ABSL_LOCKS_EXCLUDED(update_watchers_mutex_);
+
+  // Records the result of the operation and notifies waiters.
+  void Finish(
+      const absl::StatusOr<std::unique_ptr<::google::protobuf::Message>>&
+          result,
+      absl::string_view op_name) ABSL_LOCKS_EXCLUDED(operation_mutex_);
+
   std::shared_ptr<SkillCancellationManager> canceller_;
 
   absl::Mutex operation_mutex_;
   google::longrunning::Operation operation_ ABSL_GUARDED_BY(operation_mutex_);
+  bool started_ ABSL_GUARDED_BY(operation_mutex_) = false;
+  // Waiters that are called once the operation is finished.
+  absl::flat_hash_map<int64_t, absl::AnyInvocable<void() &&>> finished_waiters_
+      ABSL_GUARDED_BY(operation_mutex_);
+  int64_t next_waiter_id_ ABSL_GUARDED_BY(operation_mutex_) = 0;
+  bool waiters_called_ ABSL_GUARDED_BY(operation_mutex_) = false;
+  // Updates reported by the skill. Once the operation is finished, the last
+  // one carries the finished operation.
+  std::vector<intrinsic_proto::skills::OperationUpdate> updates_
+      ABSL_GUARDED_BY(operation_mutex_);
+
+  // Held while update watchers are called, so that a removed watcher is not
+  // called anymore.
+  absl::Mutex update_watchers_mutex_;
+  absl::flat_hash_map<int64_t, absl::AnyInvocable<void()>> update_watchers_
+      ABSL_GUARDED_BY(update_watchers_mutex_);
+  int64_t next_update_watcher_id_ ABSL_GUARDED_BY(update_watchers_mutex_) = 0;
 
   internal::SkillRuntimeData runtime_data_;
 
-  // Notified when the operation is finished.
-  absl::Notification finished_notification_;
+  absl::AnyInvocable<void() &&> finished_callback_;
 
-  absl::Mutex thread_mutex_;
-  std::unique_ptr<Thread> thread_ ABSL_GUARDED_BY(thread_mutex_);
+  // Notified when the operation is finished and its skill and context are
+  // deleted.
+  absl::Notification finished_notification_;
 };
 
-// Cleans up skill execution operations once they are finished.
+// Tracks skill execution operations until they are finished.
+//
+// Operations run on a SkillOperationExecutor and clean up after themselves,
+// so the cleaner needs no thread of its own. Finished operations are dropped
+// whenever another one is watched.
 class SkillOperationCleaner {
  public:
-  SkillOperationCleaner() {
-    absl::MutexLock lock(&queue_mutex_);
-    queue_processed_ = std::make_shared<absl::Notification>();
-    queue_processed_->Notify();
-  }
-
-  // Start watching an operation, and clean it up when it finishes.
+  // Start watching an operation, and drop finished ones.
   absl::Status Watch(std::shared_ptr<SkillOperation> operation)
-      ABSL_LOCKS_EXCLUDED(queue_mutex_, thread_mutex_);
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
-  // Waits for all operations to be cleaned up and for the queue processing
-  // thread to finish.
+  // Waits for all watched operations to finish.
   //
   // `caller_name` is specified for logging.
   void WaitOperations(const std::string& caller_name)
-      ABSL_LOCKS_EXCLUDED(queue_mutex_, thread_mutex_);
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
  private:
-  // Process the queue of operations.
-  void ProcessQueue() ABSL_LOCKS_EXCLUDED(queue_mutex_);
-
-  // Wait for the queue processing thread to finish.
-  //
-  // `caller_name` is specified for logging.
-  void WaitThread(const std::string& caller_name = "")
-      ABSL_SHARED_LOCKS_REQUIRED(thread_mutex_);
-
-  absl::Mutex queue_mutex_;
-  std::deque<std::shared_ptr<SkillOperation>> queue_
-      ABSL_GUARDED_BY(queue_mutex_);
-  std::shared_ptr<absl::Notification> queue_processed_
-      ABSL_GUARDED_BY(queue_mutex_);
-
-  absl::Mutex thread_mutex_;
-  std::unique_ptr<Thread> thread_ ABSL_GUARDED_BY(thread_mutex_);
+  absl::Mutex mutex_;
+  std::vector<std::shared_ptr<SkillOperation>> operations_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 // A collection of skill operations.
 class SkillOperations {
  public:
-  // Adds an operation to the collection.
+  // Adds an operation to the collection. Must be called before the operation
+  // is started.
+  //
+  // If the collection is full, the operation that finished first is removed.
   absl::Status Add(std::shared_ptr<SkillOperation> operation)
-      ABSL_LOCKS_EXCLUDED(update_mutex_);
+      ABSL_LOCKS_EXCLUDED(clear_mutex_, finished_mutex_);
 
-  // Gets an operation by name.
-  absl::StatusOr<std::shared_ptr<SkillOperation>> Get(absl::string_view name)
-      ABSL_LOCKS_EXCLUDED(update_mutex_);
+  // Gets an operation by name. Only locks the shard of `name`, so that calls
+  // for different operations rarely contend.
+  absl::StatusOr<std::shared_ptr<SkillOperation>> Get(absl::string_view name);
 
   // Clears all operations in the collection.
   //
@@ -179,20 +249,40 @@ class SkillOperations {
   // finished before clearing them. If any operation is not yet finished, no
   // operations will be cleared, and an error status will be returned.
   absl::Status Clear(bool wait_for_operations)
-      ABSL_LOCKS_EXCLUDED(update_mutex_);
+      ABSL_LOCKS_EXCLUDED(clear_mutex_, finished_mutex_);
 
  private:
-  // Protects access while updates occur.
-  mutable absl::Mutex update_mutex_;
+  static constexpr int kNumShards = 16;
+
+  struct Shard {
+    absl::Mutex mutex;
+    absl::flat_hash_map<std::string, std::shared_ptr<SkillOperation>>
+        operations ABSL_GUARDED_BY(mutex);
+  };
+
+  Shard& GetShard(absl::string_view name);
+
+  // Removes `operation` from its shard, unless the shard has another operation
+  // with the same name.
+  void Remove(const std::shared_ptr<SkillOperation>& operation);
+
+  // Called when `operation` finishes.
+  void OnFinished(std::shared_ptr<SkillOperation> operation)
+      ABSL_LOCKS_EXCLUDED(finished_mutex_);
 
-  // Tracked operation names, in order of addition, so we can remove the oldest
-  // finished operation whenever operations_ is full.
-  std::vector<std::string> operation_names_ ABSL_GUARDED_BY(update_mutex_);
+  // Held shared by Add(), so that Clear() does not miss added operations.
+  absl::Mutex clear_mutex_;
 
-  // Map from operation name to operation. Limited in `Add` to have at most
-  // kMaxNumOperations elements.
-  absl::flat_hash_map<std::string, std::shared_ptr<SkillOperation>> operations_
-      ABSL_GUARDED_BY(update_mutex_);
+  Shard shards_[kNumShards];
+
+  absl::Mutex finished_mutex_;
+  // Number of operations in all shards. Limited in `Add` to at most
+  // kMaxNumOperations.
+  int32_t num_operations_ ABSL_GUARDED_BY(finished_mutex_) = 0;
+  // Finished operations, in the order they finished, so that the one that
+  // finished first is removed in O(1) whenever the collection is full.
+  std::deque<std::shared_ptr<SkillOperation>> finished_
+      ABSL_GUARDED_BY(finished_mutex_);
 
   SkillOperationCleaner cleaner_;
 };
@@ -253,13 +343,19 @@ class SkillProjectorServiceImpl
       ::intrinsic_proto::motion_planning::MotionPlannerService;
 
  public:
+  // Number of candidates of a batch that are projected concurrently, unless
+  // the request asks for fewer.
+  static constexpr int kDefaultBatchConcurrency = 4;
+
   // All of the given references will be kept for the lifetime of the created
-  // instance.
+  // instance. Batches are projected on up to `batch_concurrency` threads,
+  // which are shared by all batch requests.
   explicit SkillProjectorServiceImpl(
       SkillRepository& skill_repository,
       std::shared_ptr<ObjectWorldService::StubInterface> object_world_service,
       std::shared_ptr<MotionPlannerService::StubInterface>
-          motion_planner_service);
+          motion_planner_service,
+      int batch_concurrency = kDefaultBatchConcurrency);
 
   grpc::Status GetFootprint(
       grpc::ServerContext* context,
@@ -270,10 +366,57 @@ class SkillProjectorServiceImpl
                        const intrinsic_proto::skills::PredictRequest* request,
                        intrinsic_proto::skills::PredictResult* result) override;
 
+  grpc::Status GetFootprintBatch(
+      grpc::ServerContext* context,
+      const intrinsic_proto::skills::GetFootprintBatchRequest* request,
+      grpc::ServerWriter<intrinsic_proto::skills::GetFootprintBatchResult>*
+          writer) override;
+
+  grpc::Status PredictBatch(
+      grpc::ServerContext* context,
+      const intrinsic_proto::skills::PredictBatchRequest* request,
+      grpc::ServerWriter<intrinsic_proto::skills::PredictBatchResult>* writer)
+      override;
+
  private:
-  absl::StatusOr<GetFootprintRequest> ProtoToGetFootprintRequest(
+  // What the footprints of a skill instance on a world depend on, apart from
+  // the parameters. Resolved once per request, so that the candidates of a
+  // batch share it.
+  struct FootprintInputs {
+    std::string skill_name;
+    std::string skill_id;
+    internal::SkillRuntimeData runtime_data;
+    EquipmentPack equipment;
+    google::protobuf::RepeatedPtrField<
+        intrinsic_proto::skills::ResourceReservation>
+        resource_reservations;
+    // Null if the skill does not cache its footprints.
+    internal::FootprintCache* footprint_cache = nullptr;
+    // Only set if `footprint_cache` is.
+    std::string world_version;
+  };
+
+  // Resolves the inputs of `request`, whose parameters are ignored.
+  absl::StatusOr<FootprintInputs> GetFootprintInputs(
       const intrinsic_proto::skills::GetFootprintRequest& request);
 
+  // Sets `footprint` to the footprint of `request`, or to the error of the
+  // skill. Returns an error if the skill could not be called.
+  absl::Status ComputeFootprint(
+      const FootprintInputs& inputs,
+      const intrinsic_proto::skills::GetFootprintRequest& request,
+      absl::StatusOr<intrinsic_proto::skills::Footprint>& footprint);
+
+  // Returns the pool that projects batches, starting it on first use.
+  absl::StatusOr<ThreadPool*> GetBatchPool()
+      ABSL_LOCKS_EXCLUDED(batch_pool_mutex_);
+
+  // Returns the footprint cache of the skill named `skill_name`, creating it
+  // with `max_entries` on first use, or nullptr if `max_entries` is zero.
+  internal::FootprintCache* GetFootprintCache(absl::string_view skill_name,
+                                              size_t max_entries)
+      ABSL_LOCKS_EXCLUDED(footprint_caches_mutex_);
+
   std::shared_ptr<ObjectWorldService::StubInterface> object_world_service_;
   std::shared_ptr<MotionPlannerService::StubInterface> motion_planner_service_;
   SkillRepository& skill_repository_;
@@ -282,10 +425,29 @@ class SkillProjectorServiceImpl
       ABSL_GUARDED_BY(message_mutex_);
   absl::flat_hash_map<std::string, const google::protobuf::Message* const>
       message_prototype_by_skill_name_ ABSL_GUARDED_BY(message_mutex_);
+  absl::Mutex footprint_caches_mutex_;
+  absl::flat_hash_map<std::string, std::unique_ptr<internal::FootprintCache>>
+      footprint_caches_ ABSL_GUARDED_BY(footprint_caches_mutex_);
+  const int batch_concurrency_;
+  absl::Mutex batch_pool_mutex_;
+  std::unique_ptr<ThreadPool> batch_pool_ ABSL_GUARDED_BY(batch_pool_mutex_);
 };
 
-class SkillExecutorServiceImpl
-    : public intrinsic_proto::skills::Executor::Service {
+namespace internal {
+
+// WaitOperation, WaitAnyOperation and WatchOperation use the callback API, so
+// that waiting clients do not tie up threads of the server.
+using ExecutorServiceBase = ::intrinsic_proto::skills::Executor::
+    WithCallbackMethod_WaitOperation<
+        ::intrinsic_proto::skills::Executor::
+            WithCallbackMethod_WaitAnyOperation<
+                ::intrinsic_proto::skills::Executor::
+                    WithCallbackMethod_WatchOperation<
+                        ::intrinsic_proto::skills::Executor::Service>>>;
+
+}  // namespace internal
+
+class SkillExecutorServiceImpl : public internal::ExecutorServiceBase {
   using ObjectWorldService = ::intrinsic_proto::world::ObjectWorldService;
   using MotionPlannerService =
       ::intrinsic_proto::motion_planning::MotionPlannerService;
@@ -296,12 +458,16 @@ class SkillExecutorServiceImpl
   //
   // A request watcher can be specified for testing. The service will use it to
   // record all requests that it handles.
+  //
+  // Skill operations run on a shared pool of threads that is limited by
+  // `executor_options`.
   explicit SkillExecutorServiceImpl(
       SkillRepository& skill_repository,
       std::shared_ptr<ObjectWorldService::StubInterface> object_world_service,
       std::shared_ptr<MotionPlannerService::StubInterface>
           motion_planner_service,
-      RequestWatcher* request_watcher = nullptr);
+      RequestWatcher* request_watcher = nullptr,
+      const internal::SkillOperationExecutor::Options& executor_options = {});
 
   ~SkillExecutorServiceImpl() override;
 
@@ -325,15 +491,31 @@ class SkillExecutorServiceImpl
       const google::longrunning::CancelOperationRequest* request,
       google::protobuf::Empty* result) override;
 
-  grpc::Status WaitOperation(
-      grpc::ServerContext* context,
+  grpc::ServerUnaryReactor* WaitOperation(
+      grpc::CallbackServerContext* context,
       const google::longrunning::WaitOperationRequest* request,
       google::longrunning::Operation* result) override;
 
+  grpc::ServerUnaryReactor* WaitAnyOperation(
+      grpc::CallbackServerContext* context,
+      const intrinsic_proto::skills::WaitAnyOperationRequest* request,
+      intrinsic_proto::skills::WaitAnyOperationResponse* result) override;
+
+  grpc::ServerWriteReactor<intrinsic_proto::skills::OperationUpdate>*
+  WatchOperation(
+      grpc::CallbackServerContext* context,
+      const intrinsic_proto::skills::WatchOperationRequest* request) override;
+
   grpc::Status ClearOperations(grpc::ServerContext* context,
                                const google::protobuf::Empty* request,
                                google::protobuf::Empty* result) override;
 
+  // Waits until the operation `name` is finished or `deadline` passes, and
+  // returns its state. Like WaitOperation(), but blocks the calling thread
+  // instead of serving a call, e.g., for in-process benchmarks.
+  absl::StatusOr<google::longrunning::Operation> WaitOperationInProcess(
+      absl::string_view name, absl::Time deadline);
+
  private:
   absl::StatusOr<std::shared_ptr<internal::SkillOperation>> MakeOperation(
       absl::string_view name, absl::string_view skill_name,
@@ -349,6 +531,9 @@ class SkillExecutorServiceImpl
       ABSL_GUARDED_BY(message_mutex_);
   absl::flat_hash_map<std::string, const google::protobuf::Message* const>
       message_prototype_by_skill_name_ ABSL_GUARDED_BY(message_mutex_);
+  // Declared before `operations_`, which waits for all operations when it is
+  // cleared on destruction.
+  internal::SkillOperationExecutor executor_;
   internal::SkillOperations operations_;
 };
 
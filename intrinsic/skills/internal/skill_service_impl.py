@@ -574,6 +574,63 @@ class SkillExecutorServicer(skill_service_pb2_grpc.ExecutorServicer):
         else None
     )
 
+  def WaitAnyOperation(
+      self,
+      wait_request: skill_service_pb2.WaitAnyOperationRequest,
+      context: grpc.ServicerContext,
+  ) -> skill_service_pb2.WaitAnyOperationResponse:
+    """Waits for any of several skill execution operations to finish.
+
+    Args:
+      wait_request: Wait request with the skill operation names.
+      context: gRPC servicer context.
+
+    Returns:
+      The states of the requested operations, in the order of the request.
+
+    Raises:
+      grpc.RpcError:
+        INVALID_ARGUMENT: If no operation names are given.
+        NOT_FOUND: If any of the operations is not found.
+    """
+    if not wait_request.names:
+      _abort_with_status(
+          context=context,
+          code=status.StatusCode.INVALID_ARGUMENT,
+          message='No operation names were given.',
+          skill_error_info=error_pb2.SkillErrorInfo(
+              error_type=error_pb2.SkillErrorInfo.ERROR_TYPE_GRPC
+          ),
+      )
+    try:
+      operations = [self._operations.get(name) for name in wait_request.names]
+    except self._operations.OperationNotFoundError as err:
+      _abort_with_status(
+          context=context,
+          code=status.StatusCode.NOT_FOUND,
+          message=str(err),
+          skill_error_info=error_pb2.SkillErrorInfo(
+              error_type=error_pb2.SkillErrorInfo.ERROR_TYPE_GRPC
+          ),
+      )
+
+    any_finished = threading.Event()
+    for operation in operations:
+      operation.add_finished_callback(any_finished.set)
+    try:
+      any_finished.wait(
+          timeout=wait_request.timeout.ToNanoseconds() / 1e9
+          if wait_request.HasField('timeout')
+          else None
+      )
+    finally:
+      for operation in operations:
+        operation.remove_finished_callback(any_finished.set)
+
+    return skill_service_pb2.WaitAnyOperationResponse(
+        operations=[operation.operation for operation in operations]
+    )
+
   def ClearOperations(
       self, clear_request: empty_pb2.Empty, context: grpc.ServicerContext
   ) -> empty_pb2.Empty:
@@ -825,6 +882,7 @@ class _SkillOperation:
     self._started = False
     self._cancelled = False
     self._finished_event = threading.Event()
+    self._finished_callbacks: list[Callable[[], None]] = []
     self._lock = threading.RLock()
 
     self._pool = futures.ThreadPoolExecutor()
@@ -884,6 +942,20 @@ class _SkillOperation:
 
     self.canceller.cancel()
 
+  def add_finished_callback(self, callback: Callable[[], None]) -> None:
+    """Calls `callback` once the operation finishes, or now if it has."""
+    with self._lock:
+      if not self.finished:
+        self._finished_callbacks.append(callback)
+        return
+    callback()
+
+  def remove_finished_callback(self, callback: Callable[[], None]) -> None:
+    """Removes a callback added with add_finished_callback, if not called."""
+    with self._lock:
+      if callback in self._finished_callbacks:
+        self._finished_callbacks.remove(callback)
+
   def wait(self, timeout: Optional[float] = None) -> operations_pb2.Operation:
     """Waits for the operation to finish.
 
@@ -935,9 +1007,13 @@ class _SkillOperation:
     if result is not None:
       self.operation.response.Pack(result)
 
-    self.operation.done = True
+    with self._lock:
+      self.operation.done = True
+      self._finished_event.set()
+      callbacks, self._finished_callbacks = self._finished_callbacks, []
 
-    self._finished_event.set()
+    for callback in callbacks:
+      callback()
 
 
 def _skill_error_to_code_and_action(
@@ -0,0 +1,102 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/skills/internal/skill_service_metrics.h"
+
+#include <atomic>
+
+#include "absl/base/attributes.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "opencensus/stats/stats.h"
+#include "opencensus/tags/tag_key.h"
+
+namespace intrinsic {
+namespace skills {
+namespace internal {
+
+namespace {
+
+constexpr absl::string_view kMeasureName =
+    "intrinsic.skills/request_stage_latency_ms";
+
+struct Metrics {
+  opencensus::stats::MeasureDouble latency_ms;
+  opencensus::tags::TagKey skill_id;
+  opencensus::tags::TagKey stage;
+};
+
+// Registers the measure and the view on first use.
+const Metrics& GetMetrics() {
+  static const Metrics* const metrics = []() {
+    auto* metrics = new Metrics{
+        .latency_ms = opencensus::stats::MeasureDouble::Register(
+            kMeasureName,
+            "Duration of a stage of handling a skill request, apart from the "
+            "work of the skill.",
+            "ms"),
+        .skill_id = opencensus::tags::TagKey::Register("skill_id"),
+        .stage = opencensus::tags::TagKey::Register("stage"),
+    };
+    // From 10 us to about 45 minutes, since executing a skill may take long.
+    opencensus::stats::ViewDescriptor()
+        .set_name(kSkillRequestStageLatencyView)
+        .set_measure(kMeasureName)
+        .set_aggregation(opencensus::stats::Aggregation::Distribution(
+            opencensus::stats::BucketBoundaries::Exponential(
+                /*num_finite_buckets=*/28, /*scale=*/0.01,
+                /*growth_factor=*/2)))
+        .add_column(metrics->skill_id)
+        .add_column(metrics->stage)
+        .set_description(
+            "Distribution of the durations of the stages of skill requests by "
+            "skill and stage.")
+        .RegisterForExport();
+    return metrics;
+  }();
+  return *metrics;
+}
+
+ABSL_CONST_INIT std::atomic<SkillRequestStageObserver*> stage_observer{
+    nullptr};
+
+}  // namespace
+
+absl::string_view SkillRequestStageName(SkillRequestStage stage) {
+  switch (stage) {
+    case SkillRequestStage::kQueue:
+      return "queue";
+    case SkillRequestStage::kParameters:
+      return "parameters";
+    case SkillRequestStage::kEquipment:
+      return "equipment";
+    case SkillRequestStage::kExecute:
+      return "execute";
+    case SkillRequestStage::kPreview:
+      return "preview";
+    case SkillRequestStage::kCleanup:
+      return "cleanup";
+  }
+  return "unknown";
+}
+
+void RecordSkillRequestStage(absl::string_view skill_id,
+                             SkillRequestStage stage, absl::Duration duration) {
+  const Metrics& metrics = GetMetrics();
+  opencensus::stats::Record(
+      {{metrics.latency_ms, absl::ToDoubleMilliseconds(duration)}},
+      {{metrics.skill_id, skill_id},
+       {metrics.stage, SkillRequestStageName(stage)}});
+  if (SkillRequestStageObserver* observer =
+          stage_observer.load(std::memory_order_acquire);
+      observer != nullptr) {
+    observer->OnSkillRequestStage(skill_id, stage, duration);
+  }
+}
+
+void SetSkillRequestStageObserver(SkillRequestStageObserver* observer) {
+  stage_observer.store(observer, std::memory_order_release);
+}
+
+}  // namespace internal
+}  // namespace skills
+}  // namespace intrinsic
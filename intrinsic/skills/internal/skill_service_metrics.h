@@ -0,0 +1,61 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_SKILLS_INTERNAL_SKILL_SERVICE_METRICS_H_
+#define INTRINSIC_SKILLS_INTERNAL_SKILL_SERVICE_METRICS_H_
+
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+
+namespace intrinsic {
+namespace skills {
+namespace internal {
+
+// Name of the exported distribution of the durations of the stages of skill
+// requests, in milliseconds, by skill id and stage.
+inline constexpr absl::string_view kSkillRequestStageLatencyView =
+    "intrinsic.skills/request_stage_latency";
+
+// The stages of handling a skill request, apart from the work of the skill.
+enum class SkillRequestStage {
+  // From accepting the operation until a worker starts it.
+  kQueue,
+  // Packing the parameters and their defaults into the skill request.
+  kParameters,
+  // Resolving and unpacking the equipment.
+  kEquipment,
+  // Skill::Execute() and Skill::Preview().
+  kExecute,
+  kPreview,
+  // Deleting the skill and its context after it returned.
+  kCleanup,
+};
+
+// The value of the "stage" tag of `stage`, e.g., "queue".
+absl::string_view SkillRequestStageName(SkillRequestStage stage);
+
+// Records the duration of a stage of a request for the skill `skill_id`.
+void RecordSkillRequestStage(absl::string_view skill_id,
+                             SkillRequestStage stage, absl::Duration duration);
+
+// Receives the recorded durations of stages in addition to the exported view,
+// e.g., to report them from a benchmark.
+class SkillRequestStageObserver {
+ public:
+  virtual ~SkillRequestStageObserver() = default;
+
+  // Called on the thread that records the stage, so must be thread-safe.
+  virtual void OnSkillRequestStage(absl::string_view skill_id,
+                                   SkillRequestStage stage,
+                                   absl::Duration duration) = 0;
+};
+
+// Sets the observer of all skill requests of the process, or removes it if
+// `observer` is nullptr. The observer must outlive all requests that are
+// handled while it is set.
+void SetSkillRequestStageObserver(SkillRequestStageObserver* observer);
+
+}  // namespace internal
+}  // namespace skills
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_SKILLS_INTERNAL_SKILL_SERVICE_METRICS_H_
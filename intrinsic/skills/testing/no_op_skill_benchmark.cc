@@ -0,0 +1,61 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+// Measures the overhead of the skill framework per Execute call, using the
+// no-op skill, so that all of the measured time is spent in the framework.
+//
+// Besides time per call, reports the mean duration of each phase of a call in
+// microseconds (see SkillBenchmarkStats) and the number of heap allocations
+// per call as `allocations`.
+//
+// Run with:
+//   bazel run -c opt //intrinsic/skills/testing:no_op_skill_benchmark
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/log/check.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "benchmark/benchmark.h"
+#include "intrinsic/skills/testing/no_op_skill.h"
+#include "intrinsic/skills/testing/no_op_skill.pb.h"
+#include "intrinsic/skills/testing/skill_benchmark.h"
+
+namespace intrinsic::skills {
+namespace {
+
+constexpr int kNumPhaseInvocations = 1000;
+
+void BM_ExecuteNoOpSkill(benchmark::State& state) {
+  absl::StatusOr<std::unique_ptr<SkillExecuteBenchmark>> harness =
+      SkillExecuteBenchmark::Create(&NoOpSkill::CreateSkill);
+  CHECK_OK(harness.status());
+  const intrinsic_proto::skills::NoOpSkillParams params;
+
+  for (auto _ : state) {
+    CHECK_OK((*harness)->Execute(params).status());
+  }
+
+  // Breaks a call down into its phases, outside of the timed loop.
+  absl::StatusOr<SkillBenchmarkStats> stats =
+      (*harness)->Run(params, kNumPhaseInvocations);
+  CHECK_OK(stats.status());
+  for (const auto& [name, duration] :
+       {std::pair<absl::string_view, absl::Duration>{"request_us",
+                                                     stats->request},
+        {"parameters_us", stats->parameters},
+        {"equipment_us", stats->equipment},
+        {"queue_us", stats->queue},
+        {"execute_us", stats->execute},
+        {"cleanup_us", stats->cleanup},
+        {"bookkeeping_us", stats->bookkeeping}}) {
+    state.counters[std::string(name)] = absl::ToDoubleMicroseconds(duration);
+  }
+  state.counters["allocations"] = stats->allocations;
+}
+BENCHMARK(BM_ExecuteNoOpSkill)->UseRealTime();
+
+}  // namespace
+}  // namespace intrinsic::skills
@@ -0,0 +1,261 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/skills/testing/skill_benchmark.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "google/longrunning/operations.pb.h"
+#include "google/protobuf/message.h"
+#include "grpcpp/server_builder.h"
+#include "grpcpp/server_context.h"
+#include "grpcpp/support/channel_arguments.h"
+#include "grpcpp/support/status.h"
+#include "intrinsic/skills/internal/runtime_data.h"
+#include "intrinsic/skills/internal/single_skill_factory.h"
+#include "intrinsic/skills/internal/skill_service_impl.h"
+#include "intrinsic/skills/internal/skill_service_metrics.h"
+#include "intrinsic/util/allocation_tracking.h"
+#include "intrinsic/util/status/status_conversion_grpc.h"
+#include "intrinsic/util/status/status_conversion_rpc.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic::skills {
+
+using ::intrinsic::skills::internal::SkillRequestStage;
+
+namespace {
+
+constexpr absl::string_view kAllocationTagName = "skill_benchmark";
+
+}  // namespace
+
+int64_t GetAllocationCount() {
+  // Attributes the allocations of reading the counters to a tag of their own,
+  // which is left out, so that they do not count towards the measured calls.
+  static const AllocationTag tag = AllocationTag::Get(kAllocationTagName);
+  ScopedAllocationTag scoped_tag(tag);
+  int64_t count = 0;
+  for (const AllocationStats& stats : GetAllocationStats()) {
+    if (stats.tag != kAllocationTagName) {
+      count += stats.allocations;
+    }
+  }
+  return count;
+}
+
+std::string SkillBenchmarkStats::ToString() const {
+  std::string out = absl::StrFormat("%d invocations, mean per invocation:\n",
+                                    num_invocations);
+  for (const auto& [name, duration] :
+       {std::pair<absl::string_view, absl::Duration>{"request", request},
+        {"parameters", parameters},
+        {"equipment", equipment},
+        {"queue", queue},
+        {"execute", execute},
+        {"cleanup", cleanup},
+        {"bookkeeping", bookkeeping},
+        {"total", total}}) {
+    absl::StrAppendFormat(&out, "  %-12s %10.2f us\n", name,
+                          absl::ToDoubleMicroseconds(duration));
+  }
+  absl::StrAppendFormat(&out, "  %-12s %10.1f\n", "allocations", allocations);
+  return out;
+}
+
+// Sums the durations of the stages of the benchmarked skill.
+class SkillExecuteBenchmark::StageCollector
+    : public internal::SkillRequestStageObserver {
+ public:
+  static constexpr int kNumStages =
+      static_cast<int>(SkillRequestStage::kCleanup) + 1;
+
+  explicit StageCollector(absl::string_view skill_id) : skill_id_(skill_id) {}
+
+  void OnSkillRequestStage(absl::string_view skill_id, SkillRequestStage stage,
+                           absl::Duration duration) override {
+    if (skill_id != skill_id_) return;
+    absl::MutexLock lock(&mutex_);
+    totals_[static_cast<int>(stage)] += duration;
+  }
+
+  // Returns the sums since the last call, and resets them.
+  std::array<absl::Duration, kNumStages> TakeTotals() {
+    absl::MutexLock lock(&mutex_);
+    std::array<absl::Duration, kNumStages> totals = totals_;
+    totals_.fill(absl::ZeroDuration());
+    return totals;
+  }
+
+ private:
+  const std::string skill_id_;
+  absl::Mutex mutex_;
+  std::array<absl::Duration, kNumStages> totals_ ABSL_GUARDED_BY(mutex_) = {};
+};
+
+SkillExecuteBenchmark::SkillExecuteBenchmark(const Options& options)
+    : options_(options),
+      stages_(std::make_unique<StageCollector>(options.skill_id)) {}
+
+SkillExecuteBenchmark::~SkillExecuteBenchmark() {
+  internal::SetSkillRequestStageObserver(nullptr);
+}
+
+absl::StatusOr<std::unique_ptr<SkillExecuteBenchmark>>
+SkillExecuteBenchmark::Create(
+    const internal::SingleSkillFactory::CreateSkillFunction& create_skill) {
+  return Create(create_skill, Options());
+}
+
+absl::StatusOr<std::unique_ptr<SkillExecuteBenchmark>>
+SkillExecuteBenchmark::Create(
+    const internal::SingleSkillFactory::CreateSkillFunction& create_skill,
+    const Options& options) {
+  auto benchmark = absl::WrapUnique(new SkillExecuteBenchmark(options));
+
+  grpc::ServerBuilder builder;
+  builder.RegisterService(options.world_service != nullptr
+                              ? options.world_service
+                              : &benchmark->default_world_service_);
+  builder.RegisterService(&benchmark->motion_planner_service_);
+  benchmark->server_ = builder.BuildAndStart();
+  if (benchmark->server_ == nullptr) {
+    return absl::InternalError("Could not start the in-process services.");
+  }
+  std::shared_ptr<grpc::Channel> channel =
+      benchmark->server_->InProcessChannel(grpc::ChannelArguments());
+
+  internal::SkillRuntimeData runtime_data(
+      options.default_parameters.has_value()
+          ? internal::ParameterData(*options.default_parameters)
+          : internal::ParameterData(),
+      internal::ReturnTypeData(), internal::ExecutionOptions(),
+      internal::ResourceData(), options.skill_id);
+  benchmark->repository_ = std::make_unique<internal::SingleSkillFactory>(
+      runtime_data, create_skill);
+  benchmark->service_ = std::make_unique<SkillExecutorServiceImpl>(
+      *benchmark->repository_,
+      intrinsic_proto::world::ObjectWorldService::NewStub(channel),
+      intrinsic_proto::motion_planning::MotionPlannerService::NewStub(channel),
+      /*request_watcher=*/nullptr, options.executor_options);
+
+  intrinsic_proto::skills::ExecuteRequest& request = benchmark->request_;
+  request.set_world_id("world");
+  request.mutable_instance()->set_id_version(options.skill_id);
+  for (const auto& [slot, handle] : options.equipment) {
+    (*request.mutable_instance()->mutable_resource_handles())[slot] = handle;
+  }
+
+  internal::SetSkillRequestStageObserver(benchmark->stages_.get());
+  return benchmark;
+}
+
+absl::StatusOr<google::longrunning::Operation> SkillExecuteBenchmark::Execute(
+    const google::protobuf::Message& parameters) {
+  request_.mutable_parameters()->PackFrom(parameters);
+  Sample sample;
+  return ExecuteOnce(sample);
+}
+
+absl::StatusOr<SkillBenchmarkStats> SkillExecuteBenchmark::Run(
+    const google::protobuf::Message& parameters, int num_invocations) {
+  if (num_invocations <= 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Expected a positive number of invocations, got ", num_invocations));
+  }
+  request_.mutable_parameters()->PackFrom(parameters);
+
+  auto execute = [this](Sample& sample) -> absl::Status {
+    INTR_ASSIGN_OR_RETURN(google::longrunning::Operation operation,
+                          ExecuteOnce(sample));
+    if (operation.has_error()) {
+      return ToAbslStatus(operation.error());
+    }
+    return absl::OkStatus();
+  };
+  Sample warm_up;
+  INTR_RETURN_IF_ERROR(execute(warm_up));
+  stages_->TakeTotals();
+
+  SkillBenchmarkStats stats;
+  stats.num_invocations = num_invocations;
+  absl::Duration start;
+  int64_t allocations = 0;
+  for (int i = 0; i < num_invocations; ++i) {
+    Sample sample;
+    INTR_RETURN_IF_ERROR(execute(sample));
+    start += sample.start;
+    stats.total += sample.total;
+    allocations += sample.allocations;
+  }
+
+  const auto totals = stages_->TakeTotals();
+  auto stage_total = [&totals](SkillRequestStage stage) {
+    return totals[static_cast<int>(stage)];
+  };
+  stats.parameters = stage_total(SkillRequestStage::kParameters);
+  stats.equipment = stage_total(SkillRequestStage::kEquipment);
+  stats.request = start - stats.parameters - stats.equipment;
+  stats.queue = stage_total(SkillRequestStage::kQueue);
+  stats.execute = stage_total(SkillRequestStage::kExecute);
+  stats.cleanup = stage_total(SkillRequestStage::kCleanup);
+  stats.bookkeeping =
+      stats.total - start - stats.queue - stats.execute - stats.cleanup;
+  for (absl::Duration* duration :
+       {&stats.request, &stats.parameters, &stats.equipment, &stats.queue,
+        &stats.execute, &stats.cleanup, &stats.bookkeeping, &stats.total}) {
+    *duration /= num_invocations;
+  }
+  stats.allocations = static_cast<double>(allocations) / num_invocations;
+  return stats;
+}
+
+absl::StatusOr<google::longrunning::Operation>
+SkillExecuteBenchmark::ExecuteOnce(Sample& sample) {
+  // Operations are kept after they finish, so every call needs a new name.
+  request_.mutable_instance()->set_instance_name(
+      absl::StrCat("benchmark-", num_operations_++));
+  grpc::ServerContext context;
+  google::longrunning::Operation operation;
+
+  const int64_t allocations_before = GetAllocationCount();
+  const absl::Time start_time = absl::Now();
+  const grpc::Status started =
+      service_->StartExecute(&context, &request_, &operation);
+  const absl::Time started_time = absl::Now();
+  absl::StatusOr<google::longrunning::Operation> finished;
+  if (started.ok()) {
+    finished = service_->WaitOperationInProcess(
+        operation.name(), started_time + options_.timeout);
+  }
+  const absl::Time finished_time = absl::Now();
+  sample.allocations = GetAllocationCount() - allocations_before;
+
+  if (!started.ok()) {
+    return ToAbslStatus(started);
+  }
+  INTR_RETURN_IF_ERROR(finished.status());
+  if (!finished->done()) {
+    return absl::DeadlineExceededError(
+        absl::StrCat("Operation ", operation.name(), " did not finish within ",
+                     absl::FormatDuration(options_.timeout)));
+  }
+  sample.start = started_time - start_time;
+  sample.total = finished_time - start_time;
+  return finished;
+}
+
+}  // namespace intrinsic::skills
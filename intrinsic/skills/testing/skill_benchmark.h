@@ -0,0 +1,162 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_SKILLS_TESTING_SKILL_BENCHMARK_H_
+#define INTRINSIC_SKILLS_TESTING_SKILL_BENCHMARK_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "google/longrunning/operations.pb.h"
+#include "google/protobuf/any.pb.h"
+#include "google/protobuf/message.h"
+#include "grpcpp/server.h"
+#include "intrinsic/motion_planning/proto/motion_planner_service.grpc.pb.h"
+#include "intrinsic/resources/proto/resource_handle.pb.h"
+#include "intrinsic/skills/internal/single_skill_factory.h"
+#include "intrinsic/skills/internal/skill_operation_executor.h"
+#include "intrinsic/skills/internal/skill_service_impl.h"
+#include "intrinsic/skills/proto/skill_service.pb.h"
+#include "intrinsic/world/proto/object_world_service.grpc.pb.h"
+
+namespace intrinsic::skills {
+
+// The mean cost of one Execute call through SkillExecutorServiceImpl, by
+// phase. The phases add up to `total`.
+struct SkillBenchmarkStats {
+  int num_invocations = 0;
+
+  // StartExecute(), apart from `parameters` and `equipment`: validating the
+  // request, getting the skill from the repository, and creating the
+  // operation and the execute context.
+  absl::Duration request;
+  // Packing the parameters and their defaults into the skill's request.
+  absl::Duration parameters;
+  // Resolving and unpacking the equipment.
+  absl::Duration equipment;
+  // Waiting for a worker of the operation executor.
+  absl::Duration queue;
+  // The skill's Execute().
+  absl::Duration execute;
+  // Deleting the skill and its context.
+  absl::Duration cleanup;
+  // The rest, i.e., finishing the operation and waking up the waiter.
+  absl::Duration bookkeeping;
+  // From calling StartExecute() until the operation is finished.
+  absl::Duration total;
+
+  // Number of heap allocations, by all threads of the process. 0 unless the
+  // binary links //intrinsic/util:allocation_tracking_hooks, see
+  // GetAllocationCount().
+  double allocations = 0;
+
+  // Returns the stats as a table, e.g., for logging.
+  std::string ToString() const;
+};
+
+// Runs a skill through the execute path of SkillExecutorServiceImpl
+// in-process, to measure the overhead of the framework per skill call.
+//
+// The skill is served by a SingleSkillFactory in place of the registry, with
+// the given equipment handles, which are not resolved anywhere. Its world and
+// motion planner clients talk to in-process services, which answer every call
+// with UNIMPLEMENTED unless another world service is given.
+//
+// Example:
+//
+//   INTR_ASSIGN_OR_RETURN(
+//       std::unique_ptr<SkillExecuteBenchmark> benchmark,
+//       SkillExecuteBenchmark::Create(&NoOpSkill::CreateSkill));
+//   INTR_ASSIGN_OR_RETURN(
+//       SkillBenchmarkStats stats,
+//       benchmark->Run(intrinsic_proto::skills::NoOpSkillParams(), 1000));
+//   LOG(INFO) << stats.ToString();
+//
+// The phases are taken from the stage metrics of skill requests (see
+// skill_service_metrics.h), which are observed for the whole process. So only
+// one benchmark may exist at a time.
+class SkillExecuteBenchmark {
+ public:
+  struct Options {
+    // Id of the skill.
+    std::string skill_id = "ai.intrinsic.benchmark_skill";
+    // Default parameters of the skill, if any.
+    std::optional<google::protobuf::Any> default_parameters;
+    // Equipment of the skill instance, by slot.
+    absl::flat_hash_map<std::string, intrinsic_proto::resources::ResourceHandle>
+        equipment;
+    // The world service that the skill talks to, e.g., a fake with the
+    // objects the skill reads. Not owned.
+    intrinsic_proto::world::ObjectWorldService::Service* world_service =
+        nullptr;
+    internal::SkillOperationExecutor::Options executor_options;
+    // Maximum time to wait for a single call.
+    absl::Duration timeout = absl::Seconds(10);
+  };
+
+  static absl::StatusOr<std::unique_ptr<SkillExecuteBenchmark>> Create(
+      const internal::SingleSkillFactory::CreateSkillFunction& create_skill);
+  static absl::StatusOr<std::unique_ptr<SkillExecuteBenchmark>> Create(
+      const internal::SingleSkillFactory::CreateSkillFunction& create_skill,
+      const Options& options);
+
+  ~SkillExecuteBenchmark();
+
+  SkillExecuteBenchmark(const SkillExecuteBenchmark&) = delete;
+  SkillExecuteBenchmark& operator=(const SkillExecuteBenchmark&) = delete;
+
+  // Executes the skill once with `parameters` and returns the finished
+  // operation, which holds the error if the skill failed.
+  //
+  // Returns an error if the operation could not be started or did not finish
+  // within the timeout.
+  absl::StatusOr<google::longrunning::Operation> Execute(
+      const google::protobuf::Message& parameters);
+
+  // Executes the skill `num_invocations` times, after one call to warm up,
+  // and returns the mean cost per call.
+  //
+  // Returns an error if any call fails, including calls in which the skill
+  // failed.
+  absl::StatusOr<SkillBenchmarkStats> Run(
+      const google::protobuf::Message& parameters, int num_invocations);
+
+ private:
+  class StageCollector;
+
+  // The measurements of a single call.
+  struct Sample {
+    absl::Duration start;
+    absl::Duration total;
+    int64_t allocations = 0;
+  };
+
+  explicit SkillExecuteBenchmark(const Options& options);
+
+  // Executes `request_` under a new operation name.
+  absl::StatusOr<google::longrunning::Operation> ExecuteOnce(Sample& sample);
+
+  const Options options_;
+  std::unique_ptr<StageCollector> stages_;
+  intrinsic_proto::world::ObjectWorldService::Service default_world_service_;
+  intrinsic_proto::motion_planning::MotionPlannerService::Service
+      motion_planner_service_;
+  std::unique_ptr<grpc::Server> server_;
+  std::unique_ptr<internal::SingleSkillFactory> repository_;
+  std::unique_ptr<SkillExecutorServiceImpl> service_;
+  intrinsic_proto::skills::ExecuteRequest request_;
+  int64_t num_operations_ = 0;
+};
+
+// Returns the number of heap allocations by all threads of this process so
+// far. Counts nothing, i.e., always returns 0, unless the binary links
+// //intrinsic/util:allocation_tracking_hooks.
+int64_t GetAllocationCount();
+
+}  // namespace intrinsic::skills
+
+#endif  // INTRINSIC_SKILLS_TESTING_SKILL_BENCHMARK_H_
@@ -0,0 +1,145 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/allocation_tracking.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/const_init.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace intrinsic {
+namespace {
+
+struct TagCounters {
+  std::atomic<uint64_t> allocations;
+  std::atomic<uint64_t> deallocations;
+  std::atomic<uint64_t> allocated_bytes;
+  std::atomic<uint64_t> freed_bytes;
+};
+
+// Zero-initialized before any dynamic initialization, so that the hooks can
+// count allocations of static initializers.
+TagCounters counters[AllocationTag::kMaxTags];
+std::atomic<bool> tracking_enabled = false;
+thread_local uint32_t current_tag = 0;
+
+ABSL_CONST_INIT absl::Mutex names_mutex(absl::kConstInit);
+
+// Index i holds the name of tag i. Index 0 is the untagged one.
+std::vector<std::string>& TagNames()
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(names_mutex) {
+  static std::vector<std::string>* names = new std::vector<std::string>{""};
+  return *names;
+}
+
+}  // namespace
+
+AllocationTag AllocationTag::Get(absl::string_view name) {
+  absl::MutexLock lock(&names_mutex);
+  std::vector<std::string>& names = TagNames();
+  for (uint32_t i = 0; i < names.size(); ++i) {
+    if (names[i] == name) {
+      return AllocationTag(i);
+    }
+  }
+  if (names.size() >= kMaxTags) {
+    return AllocationTag();
+  }
+  names.emplace_back(name);
+  return AllocationTag(names.size() - 1);
+}
+
+AllocationTag LazyAllocationTag::Get() const {
+  uint32_t index = index_.load(std::memory_order_relaxed);
+  if (index == kUnregistered) {
+    // Concurrent first calls register the same tag, so either store wins.
+    index = AllocationTag::Get(name_).index();
+    index_.store(index, std::memory_order_relaxed);
+  }
+  return AllocationTag(index);
+}
+
+ScopedAllocationTag::ScopedAllocationTag(AllocationTag tag)
+    : previous_(current_tag) {
+  current_tag = tag.index();
+}
+
+ScopedAllocationTag::~ScopedAllocationTag() { current_tag = previous_; }
+
+bool AllocationTrackingEnabled() {
+  return tracking_enabled.load(std::memory_order_relaxed);
+}
+
+std::vector<AllocationStats> GetAllocationStats() {
+  std::vector<std::string> names;
+  {
+    absl::MutexLock lock(&names_mutex);
+    names = TagNames();
+  }
+  std::vector<AllocationStats> stats;
+  stats.reserve(names.size());
+  for (uint32_t i = 0; i < names.size(); ++i) {
+    const TagCounters& tag_counters = counters[i];
+    stats.push_back(
+        {.tag = std::move(names[i]),
+         .allocations =
+             tag_counters.allocations.load(std::memory_order_relaxed),
+         .deallocations =
+             tag_counters.deallocations.load(std::memory_order_relaxed),
+         .allocated_bytes =
+             tag_counters.allocated_bytes.load(std::memory_order_relaxed),
+         .freed_bytes =
+             tag_counters.freed_bytes.load(std::memory_order_relaxed)});
+  }
+  return stats;
+}
+
+std::string AllocationStatsToJson() {
+  std::string json = absl::StrCat(
+      "{\"enabled\": ", AllocationTrackingEnabled() ? "true" : "false",
+      ", \"tags\": [");
+  bool first = true;
+  for (const AllocationStats& stats : GetAllocationStats()) {
+    // Tag names are identifiers chosen in code, so they need no escaping.
+    absl::StrAppend(&json, first ? "" : ", ", "{\"tag\": \"", stats.tag,
+                    "\", \"allocations\": ", stats.allocations,
+                    ", \"deallocations\": ", stats.deallocations,
+                    ", \"allocated_bytes\": ", stats.allocated_bytes,
+                    ", \"freed_bytes\": ", stats.freed_bytes,
+                    ", \"live_bytes\": ", stats.live_bytes(), "}");
+    first = false;
+  }
+  json.append("]}");
+  return json;
+}
+
+namespace internal {
+
+uint32_t CurrentAllocationTag() { return current_tag; }
+
+void RecordAllocation(uint32_t tag, size_t size) {
+  TagCounters& tag_counters = counters[tag];
+  tag_counters.allocations.fetch_add(1, std::memory_order_relaxed);
+  tag_counters.allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void RecordDeallocation(uint32_t tag, size_t size) {
+  TagCounters& tag_counters = counters[tag];
+  tag_counters.deallocations.fetch_add(1, std::memory_order_relaxed);
+  tag_counters.freed_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void SetAllocationTrackingEnabled() {
+  tracking_enabled.store(true, std::memory_order_relaxed);
+}
+
+}  // namespace internal
+}  // namespace intrinsic
@@ -0,0 +1,142 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_UTIL_ALLOCATION_TRACKING_H_
+#define INTRINSIC_UTIL_ALLOCATION_TRACKING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace intrinsic {
+
+// Attributes the heap allocations of a process to subsystems, e.g. to see how
+// much memory PubSub or the structured logging client hold under load and
+// whether that grows over a long run.
+//
+// Code defines a tag per subsystem and marks the scopes in which it allocates
+// on behalf of that subsystem:
+//
+//   ABSL_CONST_INIT LazyAllocationTag kPubSubAllocationTag("pubsub");
+//
+//   void Publisher::Publish(...) {
+//     ScopedAllocationTag tag(kPubSubAllocationTag);
+//     ...
+//   }
+//
+// Allocations are only counted if the binary links
+// //intrinsic/util:allocation_tracking_hooks, which replaces the global
+// operator new and delete. Without it, tags cost a thread-local store per
+// scope and all counters stay zero. The hooks remember the tag of each
+// allocation, so memory freed outside of the scope, or on another thread, is
+// still subtracted from the tag that allocated it.
+//
+// The hooks conflict with other replacements of operator new, such as
+// tcmalloc.
+
+// A subsystem to which allocations are attributed. Cheap to copy.
+class AllocationTag {
+ public:
+  // Maximum number of tags per process, including the untagged one.
+  static constexpr size_t kMaxTags = 64;
+
+  // Allocations outside of any ScopedAllocationTag.
+  AllocationTag() = default;
+
+  // Thread-safe. Returns the tag named `name`, registering it on first use.
+  // Returns the untagged tag once kMaxTags tags are registered. Looks up the
+  // name under a lock, so use a LazyAllocationTag in hot code.
+  static AllocationTag Get(absl::string_view name);
+
+  uint32_t index() const { return index_; }
+
+ private:
+  friend class LazyAllocationTag;
+
+  explicit AllocationTag(uint32_t index) : index_(index) {}
+
+  uint32_t index_ = 0;
+};
+
+// A tag that is looked up on first use and then cached, for definitions at
+// namespace scope with ABSL_CONST_INIT. Tags shared by several files can be
+// defined as inline variables in a header.
+class LazyAllocationTag {
+ public:
+  constexpr explicit LazyAllocationTag(absl::string_view name) : name_(name) {}
+
+  LazyAllocationTag(const LazyAllocationTag&) = delete;
+  LazyAllocationTag& operator=(const LazyAllocationTag&) = delete;
+
+  // Thread-safe. Same as AllocationTag::Get(name) but only takes the lock on
+  // the first call.
+  AllocationTag Get() const;
+
+ private:
+  static constexpr uint32_t kUnregistered = AllocationTag::kMaxTags;
+
+  absl::string_view name_;
+  mutable std::atomic<uint32_t> index_ = kUnregistered;
+};
+
+// Attributes the allocations of the current thread to `tag` until
+// destruction, then restores the previous tag. Scopes nest.
+class ScopedAllocationTag {
+ public:
+  explicit ScopedAllocationTag(AllocationTag tag);
+  explicit ScopedAllocationTag(const LazyAllocationTag& tag)
+      : ScopedAllocationTag(tag.Get()) {}
+  ~ScopedAllocationTag();
+
+  ScopedAllocationTag(const ScopedAllocationTag&) = delete;
+  ScopedAllocationTag& operator=(const ScopedAllocationTag&) = delete;
+
+ private:
+  uint32_t previous_;
+};
+
+// Allocation counters of a tag since the start of the process.
+struct AllocationStats {
+  std::string tag;
+  uint64_t allocations = 0;
+  uint64_t deallocations = 0;
+  uint64_t allocated_bytes = 0;
+  uint64_t freed_bytes = 0;
+
+  // Bytes allocated under the tag that are not freed yet.
+  int64_t live_bytes() const {
+    return static_cast<int64_t>(allocated_bytes - freed_bytes);
+  }
+};
+
+// Whether the binary links the hooks, i.e. whether allocations are counted.
+bool AllocationTrackingEnabled();
+
+// Thread-safe. Returns the counters of all registered tags, starting with
+// the untagged one. The counters of a tag are read one by one, so they may be
+// slightly inconsistent while other threads allocate.
+std::vector<AllocationStats> GetAllocationStats();
+
+// Returns GetAllocationStats() as a JSON object of the form
+//
+//   {"enabled": true,
+//    "tags": [{"tag": "", "allocations": 12, "deallocations": 10,
+//              "allocated_bytes": 640, "freed_bytes": 512,
+//              "live_bytes": 128}, ...]}
+std::string AllocationStatsToJson();
+
+namespace internal {
+
+// Used by the hooks. Must not allocate.
+uint32_t CurrentAllocationTag();
+void RecordAllocation(uint32_t tag, size_t size);
+void RecordDeallocation(uint32_t tag, size_t size);
+void SetAllocationTrackingEnabled();
+
+}  // namespace internal
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_UTIL_ALLOCATION_TRACKING_H_
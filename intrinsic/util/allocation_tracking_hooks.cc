@@ -0,0 +1,162 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+// Replaces the global operator new and delete to count allocations per
+// AllocationTag, see allocation_tracking.h.
+//
+// Each allocation is preceded by a header with its size and tag, so that the
+// deallocation is attributed to the tag that allocated it.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "intrinsic/util/allocation_tracking.h"
+
+namespace intrinsic {
+namespace {
+
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) Header {
+  size_t size;
+  uint32_t tag;
+};
+
+// Distance from the start of the block to the returned pointer. At least the
+// header size, and a multiple of `alignment` so that the pointer stays
+// aligned.
+size_t Offset(size_t alignment) {
+  return alignment > sizeof(Header) ? alignment : sizeof(Header);
+}
+
+Header* HeaderOf(void* ptr) { return static_cast<Header*>(ptr) - 1; }
+
+// Returns nullptr if out of memory.
+void* Allocate(size_t size, size_t alignment) {
+  const size_t offset = Offset(alignment);
+  void* block;
+  if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    block = std::malloc(offset + size);
+  } else {
+    // aligned_alloc needs the size to be a multiple of the alignment.
+    block = std::aligned_alloc(
+        alignment, (offset + size + alignment - 1) / alignment * alignment);
+  }
+  if (block == nullptr) {
+    return nullptr;
+  }
+  void* ptr = static_cast<char*>(block) + offset;
+  const uint32_t tag = internal::CurrentAllocationTag();
+  *HeaderOf(ptr) = {.size = size, .tag = tag};
+  internal::RecordAllocation(tag, size);
+  return ptr;
+}
+
+void* AllocateOrFail(size_t size, size_t alignment) {
+  while (true) {
+    if (void* ptr = Allocate(size, alignment)) {
+      return ptr;
+    }
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) {
+#ifdef __cpp_exceptions
+      throw std::bad_alloc();
+#else
+      std::abort();
+#endif
+    }
+    handler();
+  }
+}
+
+void* AllocateNoThrow(size_t size, size_t alignment) noexcept {
+#ifdef __cpp_exceptions
+  try {
+    return AllocateOrFail(size, alignment);
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+#else
+  return Allocate(size, alignment);
+#endif
+}
+
+void Deallocate(void* ptr, size_t alignment) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  const Header header = *HeaderOf(ptr);
+  internal::RecordDeallocation(header.tag, header.size);
+  std::free(static_cast<char*>(ptr) - Offset(alignment));
+}
+
+constexpr size_t kDefault = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+const bool kRegistered = [] {
+  internal::SetAllocationTrackingEnabled();
+  return true;
+}();
+
+}  // namespace
+}  // namespace intrinsic
+
+using ::intrinsic::AllocateNoThrow;
+using ::intrinsic::AllocateOrFail;
+using ::intrinsic::Deallocate;
+using ::intrinsic::kDefault;
+
+void* operator new(size_t size) { return AllocateOrFail(size, kDefault); }
+void* operator new[](size_t size) { return AllocateOrFail(size, kDefault); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return AllocateNoThrow(size, kDefault);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return AllocateNoThrow(size, kDefault);
+}
+void* operator new(size_t size, std::align_val_t alignment) {
+  return AllocateOrFail(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+  return AllocateOrFail(size, static_cast<size_t>(alignment));
+}
+void* operator new(size_t size, std::align_val_t alignment,
+                   const std::nothrow_t&) noexcept {
+  return AllocateNoThrow(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+  return AllocateNoThrow(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept { Deallocate(ptr, kDefault); }
+void operator delete[](void* ptr) noexcept { Deallocate(ptr, kDefault); }
+void operator delete(void* ptr, size_t) noexcept { Deallocate(ptr, kDefault); }
+void operator delete[](void* ptr, size_t) noexcept {
+  Deallocate(ptr, kDefault);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  Deallocate(ptr, kDefault);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  Deallocate(ptr, kDefault);
+}
+void operator delete(void* ptr, std::align_val_t alignment) noexcept {
+  Deallocate(ptr, static_cast<size_t>(alignment));
+}
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept {
+  Deallocate(ptr, static_cast<size_t>(alignment));
+}
+void operator delete(void* ptr, size_t, std::align_val_t alignment) noexcept {
+  Deallocate(ptr, static_cast<size_t>(alignment));
+}
+void operator delete[](void* ptr, size_t,
+                       std::align_val_t alignment) noexcept {
+  Deallocate(ptr, static_cast<size_t>(alignment));
+}
+void operator delete(void* ptr, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+  Deallocate(ptr, static_cast<size_t>(alignment));
+}
+void operator delete[](void* ptr, std::align_val_t alignment,
+                       const std::nothrow_t&) noexcept {
+  Deallocate(ptr, static_cast<size_t>(alignment));
+}
@@ -0,0 +1,111 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/allocation_tracking.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/strings/string_view.h"
+
+namespace intrinsic {
+namespace {
+
+using ::testing::HasSubstr;
+
+AllocationStats StatsOf(absl::string_view tag) {
+  for (AllocationStats& stats : GetAllocationStats()) {
+    if (stats.tag == tag) return stats;
+  }
+  return AllocationStats();
+}
+
+// Calls the allocation functions directly, since the compiler may remove a
+// `delete new T` pair.
+void AllocateAndFree() { ::operator delete(::operator new(sizeof(int))); }
+
+struct alignas(64) OverAligned {
+  char data[64];
+};
+
+TEST(AllocationTrackingTest, CountsTaggedAllocations) {
+  ASSERT_TRUE(AllocationTrackingEnabled());
+  const AllocationTag tag = AllocationTag::Get("counts_tagged");
+  EXPECT_EQ(AllocationTag::Get("counts_tagged").index(), tag.index());
+
+  std::unique_ptr<char[]> buffer;
+  std::unique_ptr<OverAligned> aligned;
+  {
+    ScopedAllocationTag scope(tag);
+    buffer = std::make_unique<char[]>(100);
+    aligned = std::make_unique<OverAligned>();
+  }
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned.get()) % 64, 0);
+  AllocationStats stats = StatsOf("counts_tagged");
+  EXPECT_EQ(stats.allocations, 2);
+  EXPECT_EQ(stats.deallocations, 0);
+  EXPECT_EQ(stats.allocated_bytes, 100 + sizeof(OverAligned));
+  EXPECT_EQ(stats.live_bytes(), 100 + sizeof(OverAligned));
+
+  // Freed outside of the scope, but still attributed to the tag.
+  buffer.reset();
+  aligned.reset();
+  stats = StatsOf("counts_tagged");
+  EXPECT_EQ(stats.deallocations, 2);
+  EXPECT_EQ(stats.live_bytes(), 0);
+}
+
+TEST(AllocationTrackingTest, ScopesNestAndAreThreadLocal) {
+  const AllocationTag outer = AllocationTag::Get("nest_outer");
+  const AllocationTag inner = AllocationTag::Get("nest_inner");
+  {
+    ScopedAllocationTag outer_scope(outer);
+    {
+      ScopedAllocationTag inner_scope(inner);
+      AllocateAndFree();
+    }
+    AllocateAndFree();
+    // Not attributed to `outer`, which is only set on this thread.
+    std::thread([]() { AllocateAndFree(); }).join();
+  }
+  EXPECT_EQ(StatsOf("nest_inner").allocations, 1);
+  // The std::thread itself may allocate under `outer`, so count at least one.
+  EXPECT_GE(StatsOf("nest_outer").allocations, 1);
+  EXPECT_EQ(StatsOf("nest_outer").live_bytes(), 0);
+}
+
+ABSL_CONST_INIT LazyAllocationTag kLazyTag("lazy");
+
+TEST(AllocationTrackingTest, LazyTagRegistersOnFirstUse) {
+  EXPECT_EQ(StatsOf("lazy").tag, "");
+  const AllocationTag tag = kLazyTag.Get();
+  EXPECT_EQ(AllocationTag::Get("lazy").index(), tag.index());
+  EXPECT_EQ(kLazyTag.Get().index(), tag.index());
+  {
+    ScopedAllocationTag scope(kLazyTag);
+    AllocateAndFree();
+  }
+  EXPECT_EQ(StatsOf("lazy").allocations, 1);
+}
+
+TEST(AllocationTrackingTest, WritesJson) {
+  const AllocationTag tag = AllocationTag::Get("json");
+  std::vector<int> values;
+  {
+    ScopedAllocationTag scope(tag);
+    values.resize(4);
+  }
+  EXPECT_THAT(AllocationStatsToJson(),
+              HasSubstr("{\"tag\": \"json\", \"allocations\": 1, "
+                        "\"deallocations\": 0, \"allocated_bytes\": 16, "
+                        "\"freed_bytes\": 0, \"live_bytes\": 16}"));
+}
+
+}  // namespace
+}  // namespace intrinsic
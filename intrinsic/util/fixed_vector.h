@@ -3,10 +3,14 @@
 #ifndef INTRINSIC_UTIL_FIXED_VECTOR_H_
 #define INTRINSIC_UTIL_FIXED_VECTOR_H_
 
+#include <algorithm>
 #include <cstddef>
+#include <initializer_list>
 #include <type_traits>
 
+#include "absl/base/macros.h"
 #include "absl/container/inlined_vector.h"  // IWYU pragma: export
+#include "absl/log/check.h"
 #include "absl/log/log.h"
 
 namespace intrinsic {
@@ -65,6 +69,93 @@ class NoopAllocator {
 template <typename T, size_t N>
 using FixedVector =
     absl::InlinedVector<T, N, fixed_vector_details::NoopAllocator<T>>;
+
+// Alignment of AlignedFixedVector by default: a cache line, which also
+// satisfies aligned loads of all SIMD register widths up to AVX-512.
+inline constexpr size_t kSimdAlignment = 64;
+
+// A FixedVector of trivial elements whose data() is aligned to `Alignment`
+// bytes, e.g., for aligned SIMD loads or mapping with Eigen::Map<...,
+// Eigen::AlignedMax>. FixedVector only aligns its elements to alignof(T).
+//
+// Like FixedVector, it never allocates and fails a runtime assert when its
+// capacity is exceeded. Only provides the subset of the std::vector interface
+// that makes sense for trivial elements; pass it on as absl::Span.
+template <typename T, size_t N, size_t Alignment = kSimdAlignment>
+class AlignedFixedVector {
+ public:
+  static_assert(std::is_trivial_v<T>,
+                "AlignedFixedVector only holds trivial types");
+  static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0,
+                "Alignment must be a power of two of at least alignof(T)");
+
+  using value_type = T;
+  using size_type = size_t;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  AlignedFixedVector() = default;
+  // Creates a vector of `size` copies of `value`.
+  explicit AlignedFixedVector(size_t size, const T& value = T()) {
+    resize(size, value);
+  }
+  AlignedFixedVector(std::initializer_list<T> values) {
+    CHECK_LE(values.size(), N) << "[AlignedFixedVector] Capacity exceeded";
+    std::copy(values.begin(), values.end(), data_);
+    size_ = values.size();
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  static constexpr size_t capacity() { return N; }
+  static constexpr size_t max_size() { return N; }
+
+  T* data() { return data_; }
+  const T* data() const { return data_; }
+
+  T& operator[](size_t i) {
+    ABSL_HARDENING_ASSERT(i < size_);
+    return data_[i];
+  }
+  const T& operator[](size_t i) const {
+    ABSL_HARDENING_ASSERT(i < size_);
+    return data_[i];
+  }
+
+  iterator begin() { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+
+  void push_back(const T& value) {
+    CHECK_LT(size_, N) << "[AlignedFixedVector] Capacity exceeded";
+    data_[size_++] = value;
+  }
+
+  // Resizes to `size` elements. New elements are copies of `value`.
+  void resize(size_t size, const T& value = T()) {
+    CHECK_LE(size, N) << "[AlignedFixedVector] Capacity exceeded";
+    if (size > size_) {
+      std::fill(data_ + size_, data_ + size, value);
+    }
+    size_ = size;
+  }
+
+  void clear() { size_ = 0; }
+
+  friend bool operator==(const AlignedFixedVector& lhs,
+                         const AlignedFixedVector& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+  friend bool operator!=(const AlignedFixedVector& lhs,
+                         const AlignedFixedVector& rhs) {
+    return !(lhs == rhs);
+  }
+
+ private:
+  alignas(Alignment) T data_[N];
+  size_t size_ = 0;
+};
 }  // namespace intrinsic
 
 #endif  // INTRINSIC_UTIL_FIXED_VECTOR_H_
@@ -2,19 +2,142 @@
 
 #include "intrinsic/util/grpc/channel.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
 #include <utility>
 
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "grpc/compression.h"
 #include "grpcpp/channel.h"
+#include "grpcpp/client_context.h"
+#include "intrinsic/util/grpc/channel_interface.h"
 #include "intrinsic/util/grpc/connection_params.h"
 #include "intrinsic/util/grpc/grpc.h"
+#include "intrinsic/util/status/status_conversion_grpc.h"
 #include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
 
 namespace intrinsic {
 
+namespace {
+
+grpc_compression_algorithm ToGrpc(CompressionPolicy::Algorithm algorithm) {
+  switch (algorithm) {
+    case CompressionPolicy::Algorithm::kNone:
+      return GRPC_COMPRESS_NONE;
+    case CompressionPolicy::Algorithm::kGzip:
+      return GRPC_COMPRESS_GZIP;
+    case CompressionPolicy::Algorithm::kDeflate:
+      return GRPC_COMPRESS_DEFLATE;
+  }
+  return GRPC_COMPRESS_NONE;
+}
+
+std::unique_ptr<::grpc::ClientContext> MakeContext(
+    const CallPolicy& policy, const ClientContextFactory& context_factory,
+    absl::Duration delay) {
+  std::unique_ptr<::grpc::ClientContext> context = context_factory();
+  if (policy.timeout != absl::InfiniteDuration()) {
+    context->set_deadline(absl::ToChronoTime(absl::Now() + delay +
+                                             policy.timeout));
+  }
+  return context;
+}
+
+// Makes an attempt whose response goes into slot 0. If it has not finished
+// after the hedging delay, makes a second one into slot 1 and cancels the
+// slower one once the other succeeds.
+//
+// The hedge runs on a thread started for each attempt, also when no hedge is
+// sent. Starting it costs in the order of tens of microseconds, which is small
+// against hedging delays of milliseconds. A shared pool would save that cost,
+// but a slow hedge would then occupy one of its threads until the deadline.
+absl::Status HedgedAttempt(
+    const CallPolicy& policy, const ClientContextFactory& context_factory,
+    absl::FunctionRef<::grpc::Status(::grpc::ClientContext*, int)> call,
+    int& winning_slot) {
+  std::unique_ptr<::grpc::ClientContext> primary =
+      MakeContext(policy, context_factory, absl::ZeroDuration());
+  // Created up front so that the primary can cancel it at any time. Calls on a
+  // cancelled context fail immediately.
+  std::unique_ptr<::grpc::ClientContext> hedge =
+      MakeContext(policy, context_factory, policy.hedging_delay);
+  absl::Notification primary_done;
+  bool hedge_sent = false;
+  absl::Status hedge_status;
+  Thread hedge_thread([&]() {
+    if (primary_done.WaitForNotificationWithTimeout(policy.hedging_delay)) {
+      return;
+    }
+    hedge_sent = true;
+    hedge_status = ToAbslStatus(call(hedge.get(), 1));
+    if (hedge_status.ok()) {
+      primary->TryCancel();
+    }
+  });
+  const absl::Status primary_status = ToAbslStatus(call(primary.get(), 0));
+  primary_done.Notify();
+  if (primary_status.ok()) {
+    hedge->TryCancel();
+  }
+  hedge_thread.Join();
+
+  if (primary_status.ok()) {
+    winning_slot = 0;
+    return absl::OkStatus();
+  }
+  if (hedge_sent && hedge_status.ok()) {
+    winning_slot = 1;
+    return absl::OkStatus();
+  }
+  return primary_status;
+}
+
+}  // namespace
+
+namespace internal {
+
+absl::Status CallWithPolicy(
+    const CallPolicy& policy, const ClientContextFactory& context_factory,
+    absl::FunctionRef<::grpc::Status(::grpc::ClientContext*, int)> call,
+    int& winning_slot) {
+  absl::Duration backoff = policy.initial_backoff;
+  absl::Status status;
+  for (int attempt = 1;; ++attempt) {
+    if (policy.hedging_delay == absl::InfiniteDuration()) {
+      winning_slot = 0;
+      status = ToAbslStatus(
+          call(MakeContext(policy, context_factory, absl::ZeroDuration()).get(),
+               0));
+    } else {
+      status = HedgedAttempt(policy, context_factory, call, winning_slot);
+    }
+    if (status.ok() || attempt >= policy.max_attempts ||
+        !policy.IsRetryable(status.code())) {
+      return status;
+    }
+    absl::SleepFor(backoff);
+    backoff = std::min(backoff * policy.backoff_multiplier, policy.max_backoff);
+  }
+}
+
+}  // namespace internal
+
+void ApplyCompression(const CompressionPolicy& policy, size_t request_bytes,
+                      ::grpc::ClientContext& context) {
+  const CompressionPolicy::Algorithm algorithm =
+      policy.AlgorithmFor(request_bytes);
+  if (algorithm != CompressionPolicy::Algorithm::kNone) {
+    context.set_compression_algorithm(ToGrpc(algorithm));
+  }
+}
+
 absl::StatusOr<std::shared_ptr<Channel>> Channel::Make(
     const ConnectionParams& params, absl::Duration timeout) {
   // Set the max message size to unlimited to allow longer trajectories.
@@ -36,6 +159,11 @@ ClientContextFactory Channel::GetClientContextFactory() const {
     for (const auto& [header, value] : params.Metadata()) {
       context->AddMetadata(header, value);
     }
+    if (params.compression.algorithm != CompressionPolicy::Algorithm::kNone &&
+        params.compression.min_request_bytes == 0) {
+      context->set_compression_algorithm(
+          ToGrpc(params.compression.algorithm));
+    }
     return context;
   };
 }
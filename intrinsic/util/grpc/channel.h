@@ -3,16 +3,22 @@
 #ifndef INTRINSIC_UTIL_GRPC_CHANNEL_H_
 #define INTRINSIC_UTIL_GRPC_CHANNEL_H_
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <utility>
 
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "grpcpp/channel.h"
+#include "grpcpp/client_context.h"
 #include "intrinsic/util/grpc/channel_interface.h"
 #include "intrinsic/util/grpc/connection_params.h"
 #include "intrinsic/util/grpc/grpc.h"
+#include "intrinsic/util/status/status_macros.h"
 
 namespace intrinsic {
 
@@ -38,8 +44,14 @@ class Channel : public ChannelInterface {
 
   std::shared_ptr<grpc::Channel> GetChannel() const override;
 
+  // Returns a factory of client contexts with the metadata of the connection
+  // parameters. The contexts compress requests if the compression policy of
+  // the parameters has no size threshold.
   ClientContextFactory GetClientContextFactory() const override;
 
+  // Returns the call policies of the connection parameters.
+  const CallPolicies& GetCallPolicies() const { return params_.call_policies; }
+
  private:
   std::shared_ptr<grpc::Channel> channel_;
 
@@ -47,6 +59,59 @@ class Channel : public ChannelInterface {
   ConnectionParams params_;
 };
 
+// Sets the compression of the call of `context` according to `policy`, for a
+// request of `request_bytes`, e.g., `request.ByteSizeLong()`.
+void ApplyCompression(const CompressionPolicy& policy, size_t request_bytes,
+                      ::grpc::ClientContext& context);
+
+namespace internal {
+
+// Implements CallWithPolicy(). `call` makes a call with the given context and
+// writes the response into the slot with the given index, 0 or 1. On success,
+// sets `winning_slot` to the slot of the response to use.
+absl::Status CallWithPolicy(
+    const CallPolicy& policy, const ClientContextFactory& context_factory,
+    absl::FunctionRef<::grpc::Status(::grpc::ClientContext*, int)> call,
+    int& winning_slot);
+
+}  // namespace internal
+
+// Makes a unary call according to `policy`: sets the deadline of each attempt,
+// retries failed attempts with exponential backoff and hedges slow attempts.
+// `call` makes one attempt with the given context, which comes from
+// `context_factory`, e.g.:
+//
+//   INTR_ASSIGN_OR_RETURN(
+//       GetObjectResponse response,
+//       CallWithPolicy<GetObjectResponse>(
+//           policies.For("/my_package.MyService/GetObject"),
+//           [&](grpc::ClientContext* context, GetObjectResponse* response) {
+//             return stub->GetObject(context, request, response);
+//           },
+//           context_factory));
+//
+// If the policy hedges, `call` runs concurrently on two threads with separate
+// responses, so it must only share thread-safe state such as the stub and a
+// const request. Returns the response of the first successful attempt, or the
+// error of the last attempt.
+template <typename Response>
+absl::StatusOr<Response> CallWithPolicy(
+    const CallPolicy& policy,
+    absl::FunctionRef<::grpc::Status(::grpc::ClientContext*, Response*)> call,
+    const ClientContextFactory& context_factory = DefaultClientContextFactory) {
+  Response responses[2];
+  int winning_slot = 0;
+  INTR_RETURN_IF_ERROR(internal::CallWithPolicy(
+      policy, context_factory,
+      [&](::grpc::ClientContext* context, int slot) {
+        // Clear the response of a previous attempt.
+        responses[slot] = Response();
+        return call(context, &responses[slot]);
+      },
+      winning_slot));
+  return std::move(responses[winning_slot]);
+}
+
 namespace icon {
 using ::intrinsic::Channel;
 }  // namespace icon
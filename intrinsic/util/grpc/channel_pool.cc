@@ -0,0 +1,82 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/grpc/channel_pool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "grpcpp/channel.h"
+#include "grpcpp/support/channel_arguments.h"
+#include "intrinsic/util/grpc/channel.h"
+#include "intrinsic/util/grpc/connection_params.h"
+#include "intrinsic/util/grpc/grpc.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic {
+
+namespace {
+
+// Channels with different arguments never share a connection. gRPC ignores
+// arguments it does not know.
+constexpr char kChannelPoolIndexArg[] = "intrinsic.channel_pool_index";
+
+}  // namespace
+
+::grpc::ChannelArguments ChannelPoolArgs(int index) {
+  ::grpc::ChannelArguments channel_args =
+      UnlimitedMessageSizeGrpcChannelArgs();
+  // Otherwise, channels to the same address share subchannels and thereby
+  // connections process-wide.
+  channel_args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+  channel_args.SetInt(kChannelPoolIndexArg, index);
+  return channel_args;
+}
+
+absl::StatusOr<std::shared_ptr<ChannelPool>> ChannelPool::Make(
+    const ConnectionParams& params, int size, absl::Duration timeout) {
+  if (size < 1) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("A channel pool needs at least one channel, got ", size));
+  }
+  std::vector<std::shared_ptr<grpc::Channel>> channels;
+  channels.reserve(size);
+  for (int i = 0; i < size; ++i) {
+    INTR_ASSIGN_OR_RETURN(
+        std::shared_ptr<grpc::Channel> channel,
+        CreateClientChannel(params.address, absl::Now() + timeout,
+                            ChannelPoolArgs(i)));
+    channels.push_back(std::move(channel));
+  }
+  return std::make_shared<ChannelPool>(std::move(channels), params);
+}
+
+ChannelPool::ChannelPool(std::vector<std::shared_ptr<grpc::Channel>> channels,
+                         const ConnectionParams& params)
+    : channels_(std::move(channels)), params_(params) {
+  CHECK(!channels_.empty()) << "A channel pool needs at least one channel";
+}
+
+std::shared_ptr<grpc::Channel> ChannelPool::GetChannel() const {
+  return channels_[next_channel_.fetch_add(1, std::memory_order_relaxed) %
+                   channels_.size()];
+}
+
+std::shared_ptr<Channel> ChannelPool::Pin(int index) const {
+  return std::make_shared<Channel>(channels_[index], params_);
+}
+
+ClientContextFactory ChannelPool::GetClientContextFactory() const {
+  // Same as for a single channel.
+  return Channel(channels_.front(), params_).GetClientContextFactory();
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,90 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_UTIL_GRPC_CHANNEL_POOL_H_
+#define INTRINSIC_UTIL_GRPC_CHANNEL_POOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "grpcpp/channel.h"
+#include "intrinsic/util/grpc/channel.h"
+#include "intrinsic/util/grpc/channel_interface.h"
+#include "intrinsic/util/grpc/connection_params.h"
+#include "intrinsic/util/grpc/grpc.h"
+
+namespace intrinsic {
+
+// Channels to an Intrinsic gRPC service, each with its own HTTP/2 connection.
+//
+// All calls on a single channel share one connection, so a large transfer,
+// e.g., of a trajectory or a point cloud, delays every call behind it. A pool
+// lets such transfers use other connections than latency-sensitive calls:
+//
+//   INTR_ASSIGN_OR_RETURN(std::shared_ptr<ChannelPool> pool,
+//                         ChannelPool::Make(params, /*size=*/3));
+//   // Keep the first connection for ICON calls.
+//   icon::Client icon_client(pool->Pin(0));
+//   // Spread bulk transfers over the other connections.
+//   auto stub = MyBulkService::NewStub(pool->GetChannel(1 + i % 2));
+//
+// GetChannel() without an index spreads calls over all connections.
+class ChannelPool : public ChannelInterface {
+ public:
+  // Creates a pool of `size` channels to the service described by `params`.
+  // `timeout` is the maximum amount of time to wait for each channel to
+  // connect.
+  //
+  // Returns InvalidArgumentError if `size` is less than 1, and the error of
+  // creating a channel otherwise.
+  static absl::StatusOr<std::shared_ptr<ChannelPool>> Make(
+      const ConnectionParams& params, int size,
+      absl::Duration timeout = kGrpcClientConnectDefaultTimeout);
+
+  // Constructs a pool from `channels`, which must not be empty. The channels
+  // only use separate connections if they were created with different channel
+  // arguments or with GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, see
+  // ChannelPoolArgs().
+  ChannelPool(std::vector<std::shared_ptr<grpc::Channel>> channels,
+              const ConnectionParams& params);
+
+  // Returns the channels in turn, so that successive calls and streams are
+  // spread over all connections of the pool.
+  std::shared_ptr<grpc::Channel> GetChannel() const override;
+
+  // Returns the channel with `index`, which must be in [0, size()).
+  std::shared_ptr<grpc::Channel> GetChannel(int index) const {
+    return channels_[index];
+  }
+
+  // Returns a ChannelInterface that always uses the channel with `index`,
+  // which must be in [0, size()), e.g., to keep a client on a connection that
+  // carries no bulk traffic.
+  std::shared_ptr<Channel> Pin(int index) const;
+
+  ClientContextFactory GetClientContextFactory() const override;
+
+  // Returns the call policies of the connection parameters.
+  const CallPolicies& GetCallPolicies() const { return params_.call_policies; }
+
+  int size() const { return static_cast<int>(channels_.size()); }
+
+ private:
+  std::vector<std::shared_ptr<grpc::Channel>> channels_;
+  mutable std::atomic<size_t> next_channel_ = 0;
+
+  // Parameters specifying how to connect to an Intrinsic gRPC service.
+  ConnectionParams params_;
+};
+
+// Returns the arguments for the channel with `index` of a pool, which make
+// gRPC open a separate connection for it. Based on
+// UnlimitedMessageSizeGrpcChannelArgs().
+::grpc::ChannelArguments ChannelPoolArgs(int index);
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_UTIL_GRPC_CHANNEL_POOL_H_
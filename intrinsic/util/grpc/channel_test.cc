@@ -0,0 +1,232 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/grpc/channel.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "google/protobuf/empty.pb.h"
+#include "grpcpp/channel.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/security/server_credentials.h"
+#include "grpcpp/server.h"
+#include "grpcpp/server_builder.h"
+#include "grpcpp/server_context.h"
+#include "grpcpp/support/channel_arguments.h"
+#include "grpcpp/support/status.h"
+#include "intrinsic/util/grpc/connection_params.h"
+#include "intrinsic/util/grpc/testing/ping.grpc.pb.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic {
+namespace {
+
+using ::google::protobuf::Empty;
+using ::intrinsic::testing::StatusIs;
+using ::intrinsic_proto::test::PingService;
+
+constexpr absl::Duration kTimeout = absl::Seconds(10);
+
+// Answers each ping with the status returned by `handler` for the index of the
+// call, counted from 0.
+class FakePingService : public PingService::Service {
+ public:
+  using Handler = std::function<grpc::Status(grpc::ServerContext*, int)>;
+
+  explicit FakePingService(Handler handler) : handler_(std::move(handler)) {}
+
+  grpc::Status Ping(grpc::ServerContext* context, const Empty* request,
+                    Empty* response) override {
+    return handler_(context, num_calls_++);
+  }
+
+  int num_calls() const { return num_calls_; }
+
+ private:
+  Handler handler_;
+  std::atomic<int> num_calls_ = 0;
+};
+
+// Blocks until the client cancels the call of `context`.
+grpc::Status WaitUntilCancelled(grpc::ServerContext* context) {
+  const absl::Time deadline = absl::Now() + kTimeout;
+  while (!context->IsCancelled() && absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  return grpc::Status(grpc::StatusCode::CANCELLED, "cancelled");
+}
+
+// Runs a FakePingService in process.
+class CallWithPolicyTest : public ::testing::Test {
+ protected:
+  void StartServer(FakePingService::Handler handler) {
+    service_ = std::make_unique<FakePingService>(std::move(handler));
+    grpc::ServerBuilder builder;
+    builder.RegisterService(service_.get());
+    server_ = builder.BuildAndStart();
+    ASSERT_NE(server_, nullptr);
+    stub_ = PingService::NewStub(
+        server_->InProcessChannel(grpc::ChannelArguments()));
+  }
+
+  void TearDown() override {
+    if (server_ != nullptr) {
+      server_->Shutdown(absl::ToChronoTime(absl::Now() + kTimeout));
+    }
+  }
+
+  absl::Status Ping(const CallPolicy& policy) {
+    return CallWithPolicy<Empty>(
+               policy,
+               [this](grpc::ClientContext* context, Empty* response) {
+                 return stub_->Ping(context, Empty(), response);
+               })
+        .status();
+  }
+
+  std::unique_ptr<FakePingService> service_;
+  std::unique_ptr<grpc::Server> server_;
+  std::unique_ptr<PingService::Stub> stub_;
+};
+
+TEST(CallPoliciesTest, ForMatchesMethodsAndServicePrefixes) {
+  const CallPolicies policies = {
+      .default_policy = {.max_attempts = 1},
+      .methods = {
+          {"/pkg.Service/Get", {.max_attempts = 2}},
+          {"/pkg.Service/", {.max_attempts = 3}},
+          {"/pkg.Other/Get", {.max_attempts = 4}},
+          {"/pkg.Other/", {.max_attempts = 5}},
+      }};
+
+  EXPECT_EQ(policies.For("/pkg.Service/Get").max_attempts, 2);
+  EXPECT_EQ(policies.For("/pkg.Service/List").max_attempts, 3);
+  EXPECT_EQ(policies.For("/pkg.Service/Getter").max_attempts, 3);
+  EXPECT_EQ(policies.For("/pkg.Other/Get").max_attempts, 4);
+  EXPECT_EQ(policies.For("/pkg.Other/List").max_attempts, 5);
+  // Method names only match in full, service prefixes only up to the "/".
+  EXPECT_EQ(policies.For("/pkg.ServiceV2/Get").max_attempts, 1);
+  EXPECT_EQ(policies.For("/pkg.Service").max_attempts, 1);
+  EXPECT_EQ(policies.For("").max_attempts, 1);
+}
+
+TEST(CallPoliciesTest, ForReturnsFirstMatch) {
+  const CallPolicies policies = {
+      .methods = {
+          {"/pkg.Service/", {.max_attempts = 2}},
+          {"/pkg.Service/Get", {.max_attempts = 3}},
+      }};
+
+  EXPECT_EQ(policies.For("/pkg.Service/Get").max_attempts, 2);
+}
+
+TEST_F(CallWithPolicyTest, SucceedsAfterRetries) {
+  StartServer([](grpc::ServerContext*, int call) {
+    return call < 2 ? grpc::Status(grpc::StatusCode::UNAVAILABLE, "down")
+                    : grpc::Status::OK;
+  });
+
+  EXPECT_OK(
+      Ping({.max_attempts = 3, .initial_backoff = absl::Milliseconds(1)}));
+  EXPECT_EQ(service_->num_calls(), 3);
+}
+
+TEST_F(CallWithPolicyTest, StopsAtMaxAttempts) {
+  StartServer([](grpc::ServerContext*, int) {
+    return grpc::Status(grpc::StatusCode::UNAVAILABLE, "down");
+  });
+
+  EXPECT_THAT(
+      Ping({.max_attempts = 3, .initial_backoff = absl::Milliseconds(1)}),
+      StatusIs(absl::StatusCode::kUnavailable));
+  EXPECT_EQ(service_->num_calls(), 3);
+}
+
+TEST_F(CallWithPolicyTest, DoesNotRetryNonRetryableCodes) {
+  StartServer([](grpc::ServerContext*, int) {
+    return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "bad request");
+  });
+
+  EXPECT_THAT(
+      Ping({.max_attempts = 3, .initial_backoff = absl::Milliseconds(1)}),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(service_->num_calls(), 1);
+}
+
+TEST_F(CallWithPolicyTest, RetriesConfiguredCodes) {
+  StartServer([](grpc::ServerContext*, int call) {
+    return call == 0 ? grpc::Status(grpc::StatusCode::ABORTED, "conflict")
+                     : grpc::Status::OK;
+  });
+
+  EXPECT_OK(Ping({.max_attempts = 2,
+                  .initial_backoff = absl::Milliseconds(1),
+                  .retryable_codes = {absl::StatusCode::kAborted}}));
+  EXPECT_EQ(service_->num_calls(), 2);
+}
+
+TEST_F(CallWithPolicyTest, AppliesTimeoutToEachAttempt) {
+  StartServer([](grpc::ServerContext* context, int) {
+    return WaitUntilCancelled(context);
+  });
+
+  const absl::Time start = absl::Now();
+  EXPECT_THAT(Ping({.timeout = absl::Milliseconds(50)}),
+              StatusIs(absl::StatusCode::kDeadlineExceeded));
+  EXPECT_LT(absl::Now() - start, kTimeout / 2);
+  EXPECT_EQ(service_->num_calls(), 1);
+}
+
+TEST_F(CallWithPolicyTest, HedgeWinsAndCancelsSlowAttempt) {
+  absl::Notification slow_attempt_cancelled;
+  StartServer([&slow_attempt_cancelled](grpc::ServerContext* context,
+                                        int call) {
+    if (call > 0) {
+      return grpc::Status::OK;
+    }
+    grpc::Status status = WaitUntilCancelled(context);
+    if (context->IsCancelled()) {
+      slow_attempt_cancelled.Notify();
+    }
+    return status;
+  });
+
+  const absl::Time start = absl::Now();
+  EXPECT_OK(Ping({.hedging_delay = absl::Milliseconds(10)}));
+  EXPECT_LT(absl::Now() - start, kTimeout / 2);
+  EXPECT_TRUE(slow_attempt_cancelled.WaitForNotificationWithTimeout(kTimeout));
+  EXPECT_EQ(service_->num_calls(), 2);
+}
+
+TEST_F(CallWithPolicyTest, DoesNotHedgeFastAttempts) {
+  StartServer([](grpc::ServerContext*, int) { return grpc::Status::OK; });
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_OK(Ping({.hedging_delay = kTimeout}));
+  }
+  EXPECT_EQ(service_->num_calls(), 10);
+}
+
+TEST_F(CallWithPolicyTest, RetriesFailedHedgedAttempts) {
+  StartServer([](grpc::ServerContext*, int call) {
+    return call == 0 ? grpc::Status(grpc::StatusCode::UNAVAILABLE, "down")
+                     : grpc::Status::OK;
+  });
+
+  EXPECT_OK(Ping({.max_attempts = 2,
+                  .initial_backoff = absl::Milliseconds(1),
+                  .hedging_delay = kTimeout}));
+  EXPECT_EQ(service_->num_calls(), 2);
+}
+
+}  // namespace
+}  // namespace intrinsic
@@ -0,0 +1,100 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/grpc/chunked_transfer.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/message_lite.h"
+
+namespace intrinsic {
+
+namespace {
+
+// Passes everything written to it to a chunk writer. Writes come in blocks of
+// the size of the CopyingOutputStreamAdaptor that wraps it, i.e., in chunks.
+class ChunkOutputStream : public google::protobuf::io::CopyingOutputStream {
+ public:
+  explicit ChunkOutputStream(
+      absl::FunctionRef<absl::Status(absl::string_view chunk)> write)
+      : write_(write) {}
+
+  bool Write(const void* buffer, int size) override {
+    status_ = write_(absl::string_view(static_cast<const char*>(buffer), size));
+    return status_.ok();
+  }
+
+  const absl::Status& status() const { return status_; }
+
+ private:
+  absl::FunctionRef<absl::Status(absl::string_view chunk)> write_;
+  absl::Status status_;
+};
+
+}  // namespace
+
+absl::Status WriteMessageInChunks(
+    const google::protobuf::MessageLite& message, size_t chunk_bytes,
+    absl::FunctionRef<absl::Status(absl::string_view chunk)> write) {
+  if (chunk_bytes == 0) {
+    return absl::InvalidArgumentError("Chunk size must be positive");
+  }
+  ChunkOutputStream chunk_stream(write);
+  {
+    google::protobuf::io::CopyingOutputStreamAdaptor adaptor(
+        &chunk_stream, static_cast<int>(chunk_bytes));
+    if (!message.SerializeToZeroCopyStream(&adaptor) || !adaptor.Flush()) {
+      if (!chunk_stream.status().ok()) {
+        return chunk_stream.status();
+      }
+      return absl::InternalError(absl::StrCat(
+          "Failed to serialize message of type ", message.GetTypeName()));
+    }
+  }
+  return chunk_stream.status();
+}
+
+void ChunkedMessageReader::Append(std::string chunk) {
+  size_bytes_ += chunk.size();
+  chunks_.push_back(std::move(chunk));
+}
+
+absl::Status ChunkedMessageReader::ParseInto(
+    google::protobuf::MessageLite& message) const {
+  std::vector<std::unique_ptr<google::protobuf::io::ArrayInputStream>>
+      chunk_streams;
+  chunk_streams.reserve(chunks_.size());
+  std::vector<google::protobuf::io::ZeroCopyInputStream*> streams;
+  streams.reserve(chunks_.size());
+  for (const std::string& chunk : chunks_) {
+    chunk_streams.push_back(
+        std::make_unique<google::protobuf::io::ArrayInputStream>(
+            chunk.data(), static_cast<int>(chunk.size())));
+    streams.push_back(chunk_streams.back().get());
+  }
+  google::protobuf::io::ConcatenatingInputStream input(
+      streams.data(), static_cast<int>(streams.size()));
+  if (!message.ParseFromZeroCopyStream(&input)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Chunks of ", size_bytes_,
+                     " bytes are not a serialized ", message.GetTypeName()));
+  }
+  return absl::OkStatus();
+}
+
+void ChunkedMessageReader::Clear() {
+  chunks_.clear();
+  size_bytes_ = 0;
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,82 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_UTIL_GRPC_CHUNKED_TRANSFER_H_
+#define INTRINSIC_UTIL_GRPC_CHUNKED_TRANSFER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/message_lite.h"
+
+namespace intrinsic {
+
+// Helpers to send a large message as a stream of chunks, e.g., with a server
+// streaming RPC whose response has a `bytes` field for the chunk:
+//
+//   // Server.
+//   return ToGrpcStatus(WriteMessageInChunks(
+//       world, kDefaultChunkBytes, [&](absl::string_view chunk) {
+//         WorldChunk response;
+//         response.set_data(std::string(chunk));
+//         return writer->Write(response)
+//                    ? absl::OkStatus()
+//                    : absl::CancelledError("Stream closed");
+//       }));
+//
+//   // Client.
+//   ChunkedMessageReader chunks;
+//   WorldChunk response;
+//   while (reader->Read(&response)) {
+//     chunks.Append(std::move(*response.mutable_data()));
+//   }
+//   INTR_RETURN_IF_ERROR(ToAbslStatus(reader->Finish()));
+//   INTR_RETURN_IF_ERROR(chunks.ParseInto(world));
+//
+// Neither side holds the serialized message as a whole: the writer serializes
+// one chunk at a time, and the reader parses the chunks in place.
+
+// A chunk size that keeps per-chunk overhead negligible, and well below the
+// default message size limit of gRPC.
+constexpr size_t kDefaultChunkBytes = 1 << 20;
+
+// Serializes `message` and passes the result to `write` in consecutive chunks
+// of at most `chunk_bytes` bytes. Only one chunk is held in memory at a time.
+//
+// Returns InvalidArgumentError if `chunk_bytes` is 0, and the first error of
+// `write` otherwise, after which `write` is not called again.
+absl::Status WriteMessageInChunks(
+    const google::protobuf::MessageLite& message, size_t chunk_bytes,
+    absl::FunctionRef<absl::Status(absl::string_view chunk)> write);
+
+// Collects the chunks of a message from WriteMessageInChunks() and parses
+// them without concatenating them first.
+class ChunkedMessageReader {
+ public:
+  // Appends the next chunk. Pass the chunk of a received message with
+  // std::move(*response.mutable_data()) to avoid copying it.
+  void Append(std::string chunk);
+
+  // Returns the total size of the chunks so far.
+  size_t size_bytes() const { return size_bytes_; }
+
+  // Parses the chunks into `message`.
+  //
+  // Returns InvalidArgumentError if the chunks are not a serialized message of
+  // the type of `message`.
+  absl::Status ParseInto(google::protobuf::MessageLite& message) const;
+
+  // Drops all chunks.
+  void Clear();
+
+ private:
+  std::vector<std::string> chunks_;
+  size_t size_bytes_ = 0;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_UTIL_GRPC_CHUNKED_TRANSFER_H_
@@ -8,6 +8,9 @@
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_format.h"
 
 namespace intrinsic {
@@ -44,6 +47,20 @@ ConnectionParams ConnectionParams::LocalPort(int port) {
   return NoIngress(absl::StrFormat("localhost:%d", port));
 }
 
+bool CallPolicy::IsRetryable(absl::StatusCode code) const {
+  return absl::c_linear_search(retryable_codes, code);
+}
+
+const CallPolicy& CallPolicies::For(std::string_view method) const {
+  for (const auto& [name, policy] : methods) {
+    if (name == method || (absl::EndsWith(name, "/") &&
+                           method.substr(0, name.size()) == name)) {
+      return policy;
+    }
+  }
+  return default_policy;
+}
+
 std::vector<std::pair<std::string, std::string>> ConnectionParams::Metadata()
     const {
   if (header.empty() || instance_name.empty()) {
@@ -3,6 +3,7 @@
 #ifndef INTRINSIC_UTIL_GRPC_CONNECTION_PARAMS_H_
 #define INTRINSIC_UTIL_GRPC_CONNECTION_PARAMS_H_
 
+#include <cstddef>
 #include <iosfwd>
 #include <ostream>
 #include <string>
@@ -10,8 +11,144 @@
 #include <utility>
 #include <vector>
 
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+
 namespace intrinsic {
 
+// When and how to compress the requests of a client.
+struct CompressionPolicy {
+  enum class Algorithm { kNone, kGzip, kDeflate };
+
+  // Returns a policy that compresses requests of at least `min_request_bytes`
+  // with gzip.
+  static CompressionPolicy Gzip(size_t min_request_bytes = 0) {
+    return {.algorithm = Algorithm::kGzip,
+            .min_request_bytes = min_request_bytes};
+  }
+
+  // Returns the algorithm for a request of `request_bytes`.
+  Algorithm AlgorithmFor(size_t request_bytes) const {
+    return request_bytes >= min_request_bytes ? algorithm : Algorithm::kNone;
+  }
+
+  Algorithm algorithm = Algorithm::kNone;
+  // Smaller requests are not compressed, since compressing them costs more
+  // time than sending them uncompressed. 0 compresses all requests.
+  size_t min_request_bytes = 0;
+
+  friend bool operator==(const CompressionPolicy& lhs,
+                         const CompressionPolicy& rhs) {
+    return lhs.algorithm == rhs.algorithm &&
+           lhs.min_request_bytes == rhs.min_request_bytes;
+  }
+
+  friend bool operator!=(const CompressionPolicy& lhs,
+                         const CompressionPolicy& rhs) {
+    return !(lhs == rhs);
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const CompressionPolicy& p) {
+    return H::combine(std::move(h), p.algorithm, p.min_request_bytes);
+  }
+};
+
+// How a client makes the calls of a method: the deadline of each attempt,
+// whether failed attempts are retried, and whether a slow attempt is hedged
+// with a second, concurrent one. Applied with CallWithPolicy() (see
+// channel.h).
+//
+// Only use retries and hedging for idempotent methods, such as reads: the
+// server may run a request several times.
+struct CallPolicy {
+  // Returns a policy for an idempotent read that is retried up to
+  // `max_attempts` times in total while the server is unavailable, each
+  // attempt with a deadline of `timeout`.
+  static CallPolicy IdempotentRead(absl::Duration timeout,
+                                   int max_attempts = 3) {
+    return {.timeout = timeout, .max_attempts = max_attempts};
+  }
+
+  // Returns whether a failed attempt with `code` is retried, given that
+  // attempts are left.
+  bool IsRetryable(absl::StatusCode code) const;
+
+  // Deadline of each attempt, counted from its start. InfiniteDuration()
+  // sets no deadline.
+  absl::Duration timeout = absl::InfiniteDuration();
+  // Number of attempts including the first one. 1 disables retries.
+  int max_attempts = 1;
+  // Wait before the first retry, multiplied by `backoff_multiplier` for each
+  // further retry up to `max_backoff`.
+  absl::Duration initial_backoff = absl::Milliseconds(20);
+  double backoff_multiplier = 2.0;
+  absl::Duration max_backoff = absl::Seconds(1);
+  // Codes of failed attempts that are retried.
+  std::vector<absl::StatusCode> retryable_codes = {
+      absl::StatusCode::kUnavailable};
+  // If finite, an attempt that has not finished after this delay is hedged:
+  // a second request is sent, the first response wins and the other request
+  // is cancelled. Trades server load for tail latency, so only use it for
+  // cheap, latency-critical reads. Each attempt starts a thread for the
+  // hedge, even if it is not sent, which adds tens of microseconds per
+  // attempt; keep the delay well above that.
+  absl::Duration hedging_delay = absl::InfiniteDuration();
+
+  friend bool operator==(const CallPolicy& lhs, const CallPolicy& rhs) {
+    return lhs.timeout == rhs.timeout && lhs.max_attempts == rhs.max_attempts &&
+           lhs.initial_backoff == rhs.initial_backoff &&
+           lhs.backoff_multiplier == rhs.backoff_multiplier &&
+           lhs.max_backoff == rhs.max_backoff &&
+           lhs.retryable_codes == rhs.retryable_codes &&
+           lhs.hedging_delay == rhs.hedging_delay;
+  }
+
+  friend bool operator!=(const CallPolicy& lhs, const CallPolicy& rhs) {
+    return !(lhs == rhs);
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const CallPolicy& p) {
+    return H::combine(std::move(h), p.timeout, p.max_attempts,
+                      p.initial_backoff, p.backoff_multiplier, p.max_backoff,
+                      p.retryable_codes, p.hedging_delay);
+  }
+};
+
+// The call policies of the methods of a connection.
+//
+//   ConnectionParams params = ConnectionParams::ResourceInstance("world");
+//   params.call_policies.methods.push_back(
+//       {"/intrinsic_proto.world.ObjectWorldService/GetObject",
+//        {.timeout = absl::Seconds(1), .max_attempts = 3,
+//         .hedging_delay = absl::Milliseconds(50)}});
+struct CallPolicies {
+  // Returns the policy of the full gRPC method name `method`, e.g.,
+  // "/intrinsic_proto.world.ObjectWorldService/GetObject".
+  const CallPolicy& For(std::string_view method) const;
+
+  // Used for methods that match no entry of `methods`.
+  CallPolicy default_policy;
+  // Policies by full method name, or by service if the name ends with "/",
+  // e.g., "/intrinsic_proto.world.ObjectWorldService/". The first match wins.
+  std::vector<std::pair<std::string, CallPolicy>> methods;
+
+  friend bool operator==(const CallPolicies& lhs, const CallPolicies& rhs) {
+    return lhs.default_policy == rhs.default_policy &&
+           lhs.methods == rhs.methods;
+  }
+
+  friend bool operator!=(const CallPolicies& lhs, const CallPolicies& rhs) {
+    return !(lhs == rhs);
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const CallPolicies& p) {
+    return H::combine(std::move(h), p.default_policy, p.methods);
+  }
+};
+
 struct ConnectionParams {
   // Constructs ConnectionParams to connect to a resource using the
   // cluster ingress on `xfa.lan:17080`. This is the default when running on a
@@ -41,6 +178,15 @@ struct ConnectionParams {
   // The header to be used when establishing a gRPC connection to the ingress.
   // The header's value will be instance_name.
   std::string header;
+  // Compression of requests. The client contexts of a Channel apply it to all
+  // calls if it has no size threshold; otherwise, apply it to individual calls
+  // with ApplyCompression() (see channel.h). Servers choose the compression
+  // of their responses independently.
+  CompressionPolicy compression;
+  // Deadlines, retries and hedging of the calls of clients on this
+  // connection, see CallPolicy. Clients that support call policies take them
+  // from Channel::GetCallPolicies().
+  CallPolicies call_policies;
 
   // Returns the metadata required by the connection to talk to the server, if
   // it is necessary.  Each pair represents the key, and value of the metadata,
@@ -50,7 +196,9 @@ struct ConnectionParams {
   friend bool operator==(const ConnectionParams& lhs,
                          const ConnectionParams& rhs) {
     return lhs.address == rhs.address &&
-           lhs.instance_name == rhs.instance_name && lhs.header == rhs.header;
+           lhs.instance_name == rhs.instance_name &&
+           lhs.header == rhs.header && lhs.compression == rhs.compression &&
+           lhs.call_policies == rhs.call_policies;
   }
 
   friend bool operator!=(const ConnectionParams& lhs,
@@ -60,13 +208,16 @@ struct ConnectionParams {
 
   template <typename H>
   friend H AbslHashValue(H h, const ConnectionParams& p) {
-    return H::combine(std::move(h), p.address, p.instance_name, p.header);
+    return H::combine(std::move(h), p.address, p.instance_name, p.header,
+                      p.compression, p.call_policies);
   }
 
   friend std::ostream& operator<<(std::ostream& os, const ConnectionParams& p);
 };
 
 namespace icon {
+using ::intrinsic::CallPolicies;
+using ::intrinsic::CallPolicy;
 using ::intrinsic::ConnectionParams;
 }  // namespace icon
 }  // namespace intrinsic
@@ -2,6 +2,7 @@
 
 #include "intrinsic/util/grpc/grpc.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>  //NOLINT
 #include <climits>
@@ -9,6 +10,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/log/log.h"
@@ -20,9 +22,13 @@
 #include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "grpcpp/alarm.h"
 #include "grpcpp/grpcpp.h"
 #include "intrinsic/icon/release/grpc_time_support.h"
+#include "intrinsic/util/shutdown_coordinator.h"
 #include "intrinsic/util/status/status_conversion_grpc.h"
+#include "intrinsic/util/status/status_macros.h"
 #include "intrinsic/util/thread/thread.h"
 #include "src/proto/grpc/health/v1/health.grpc.pb.h"
 
@@ -33,51 +39,180 @@ namespace {
 using ::grpc::health::v1::HealthCheckRequest;
 using ::grpc::health::v1::HealthCheckResponse;
 
-// Returns OK if the server responds to a noop RPC. This ensures that the
-// channel can be used for other RPCs.
-absl::Status CheckChannelHealth(std::shared_ptr<::grpc::Channel> channel,
-                                absl::Duration timeout) {
-  // Try an arbitrary RPC (we use the Health service but could use anything that
-  // responds quickly without side-effects). Use the async client because the
-  // sync client doesn't seem to respect the deadline for certain channels.
-  auto health_stub = grpc::health::v1::Health::NewStub(channel);
-
-  grpc::CompletionQueue cq;
-  absl::Time deadline = absl::Now() + timeout;
-  grpc::ClientContext ctx;
-  ctx.set_deadline(deadline);
-  HealthCheckResponse resp;
-  grpc::Status status;
-  std::unique_ptr<grpc::ClientAsyncResponseReader<HealthCheckResponse>> rpc(
-      health_stub->AsyncCheck(&ctx, HealthCheckRequest(), &cq));
-  int tag = 1;
-  rpc->Finish(&resp, &status, &tag);
-
-  // Wait for the response. If it succeeds or returns "unimplemented", then we
-  // know the channel is healthy.
-  void* got_tag;
-  bool ok = false;
-  if (cq.AsyncNext(&got_tag, &ok, deadline) !=
-          grpc::CompletionQueue::GOT_EVENT ||
-      *static_cast<int*>(got_tag) != tag || !ok) {
-    return absl::DeadlineExceededError(
-        "deadline exceeded when checking channel health");
+// Timeout of a health check of a connected channel. Short, to allow for a
+// retry if the server is not running yet.
+constexpr absl::Duration kHealthCheckTimeout = absl::Seconds(1);
+// Time to wait before retrying an unhealthy channel.
+constexpr absl::Duration kHealthCheckRetryDelay = absl::Milliseconds(100);
+
+std::string ChannelStateName(grpc_connectivity_state state) {
+  switch (state) {
+    case GRPC_CHANNEL_READY:
+      return "GRPC_CHANNEL_READY";
+    case GRPC_CHANNEL_IDLE:
+      return "GRPC_CHANNEL_IDLE";
+    case GRPC_CHANNEL_CONNECTING:
+      return "GRPC_CHANNEL_CONNECTING";
+    case GRPC_CHANNEL_TRANSIENT_FAILURE:
+      return "GRPC_CHANNEL_TRANSIENT_FAILURE";
+    case GRPC_CHANNEL_SHUTDOWN:
+      return "GRPC_CHANNEL_SHUTDOWN";
+  }
+  return "";
+}
+
+// Connects a channel to one target, driven by the events of a completion
+// queue that it shares with the connectors of other targets. Like
+// CreateClientChannel(), waits for the channel to be connected, then checks
+// its health, and starts over with a new channel if it is unhealthy. Each
+// connector has at most one operation pending on the queue, whose tag is the
+// connector.
+class ChannelConnector {
+ public:
+  ChannelConnector(const ClientChannelTarget& target, absl::Time deadline,
+                   ::grpc::CompletionQueue* cq)
+      : target_(target), deadline_(deadline), cq_(cq) {}
+
+  // Starts connecting. Returns true if done already.
+  bool Start() {
+    LOG(INFO) << "Connecting to " << target_.address;
+    if (absl::Now() >= deadline_) {
+      return Finish(absl::DeadlineExceededError(
+          "Deadline in past in CreateClientChannel"));
+    }
+    return Connect();
+  }
+
+  // Handles the completion of the pending operation. Returns true if done.
+  bool Proceed(bool ok) {
+    switch (pending_) {
+      case Pending::kStateChange:
+        if (!ok) {
+          // The deadline passed.
+          return Finish(absl::UnavailableError(absl::StrCat(
+              "gRPC channel to ", target_.address,
+              " is unavailable.  State is ",
+              ChannelStateName(channel_->GetState(false)))));
+        }
+        return WatchState();
+      case Pending::kHealthCheck:
+        if (health_status_.ok() ||
+            health_status_.error_code() == ::grpc::StatusCode::UNIMPLEMENTED) {
+          return Finish(channel_);
+        }
+        LOG(ERROR) << "Unhealthy channel: " << ToAbslStatus(health_status_);
+        return Retry(ToAbslStatus(health_status_));
+      case Pending::kRetry:
+        return Connect();
+    }
+    return Finish(absl::InternalError("Unexpected channel connector event"));
+  }
+
+  absl::StatusOr<std::shared_ptr<::grpc::Channel>> result() && {
+    return std::move(result_);
+  }
+
+ private:
+  enum class Pending { kStateChange, kHealthCheck, kRetry };
+
+  bool Connect() {
+    if (target_.use_default_application_credentials) {
+      channel_ = ::grpc::CreateCustomChannel(target_.address,
+                                             grpc::GoogleDefaultCredentials(),
+                                             target_.channel_args);
+    } else {
+      channel_ = ::grpc::CreateCustomChannel(
+          target_.address,
+          ::grpc::                       // NOLINTNEXTLINE
+          InsecureChannelCredentials(),  // NO_LINT(grpc_insecure_credential_linter)
+          target_.channel_args);
+    }
+    return WatchState();
+  }
+
+  // Checks the health of the channel once it is connected.
+  bool WatchState() {
+    const grpc_connectivity_state state = channel_->GetState(true);
+    if (state != GRPC_CHANNEL_READY) {
+      pending_ = Pending::kStateChange;
+      channel_->NotifyOnStateChange(state, deadline_, cq_, this);
+      return false;
+    }
+    // Health checks do not work when using application default credentials.
+    // They return "UNKNOWN: Received http2 header with status: 302".
+    if (target_.use_default_application_credentials) {
+      return Finish(channel_);
+    }
+    // The channel can be connected even though the server is not running
+    // yet, so check that it responds to an arbitrary RPC.
+    pending_ = Pending::kHealthCheck;
+    health_stub_ = grpc::health::v1::Health::NewStub(channel_);
+    health_context_ = std::make_unique<::grpc::ClientContext>();
+    health_context_->set_deadline(
+        std::min(deadline_, absl::Now() + kHealthCheckTimeout));
+    health_rpc_ = health_stub_->AsyncCheck(health_context_.get(),
+                                           HealthCheckRequest(), cq_);
+    health_rpc_->Finish(&health_response_, &health_status_, this);
+    return false;
+  }
+
+  bool Retry(absl::Status status) {
+    if (absl::Now() + kHealthCheckRetryDelay >= deadline_) {
+      return Finish(std::move(status));
+    }
+    pending_ = Pending::kRetry;
+    retry_alarm_.Set(cq_, absl::Now() + kHealthCheckRetryDelay, this);
+    return false;
+  }
+
+  bool Finish(absl::StatusOr<std::shared_ptr<::grpc::Channel>> result) {
+    if (result.ok()) {
+      LOG(INFO) << "Successfully connected to " << target_.address;
+    }
+    result_ = std::move(result);
+    return true;
   }
 
-  if (!status.ok() && status.error_code() != grpc::StatusCode::UNIMPLEMENTED) {
-    return ToAbslStatus(status);
+  const ClientChannelTarget& target_;
+  const absl::Time deadline_;
+  ::grpc::CompletionQueue* cq_;
+
+  Pending pending_ = Pending::kStateChange;
+  std::shared_ptr<::grpc::Channel> channel_;
+  std::unique_ptr<grpc::health::v1::Health::Stub> health_stub_;
+  std::unique_ptr<::grpc::ClientContext> health_context_;
+  std::unique_ptr<grpc::ClientAsyncResponseReader<HealthCheckResponse>>
+      health_rpc_;
+  HealthCheckResponse health_response_;
+  ::grpc::Status health_status_;
+  ::grpc::Alarm retry_alarm_;
+  absl::StatusOr<std::shared_ptr<::grpc::Channel>> result_ =
+      absl::UnknownError("Not connected");
+};
+
+absl::Status ValidateServerOptions(const ServerOptions& options) {
+  if (options.num_completion_queues < 0 || options.min_pollers < 0 ||
+      options.max_pollers < 0 || options.max_threads < 0 ||
+      options.max_memory_bytes < 0) {
+    return absl::InvalidArgumentError("Server options must not be negative");
+  }
+  if (options.min_pollers > 0 && options.max_pollers > 0 &&
+      options.min_pollers > options.max_pollers) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Server option min_pollers (", options.min_pollers,
+        ") exceeds max_pollers (", options.max_pollers, ")"));
   }
   return absl::OkStatus();
 }
 
-}  // namespace
-
 /**
  * Create a grpc server using the given address and the set of services provided
  */
 absl::StatusOr<std::unique_ptr<::grpc::Server>> CreateServer(
     const absl::string_view address,
-    const std::vector<::grpc::Service*>& services) {
+    const std::vector<::grpc::Service*>& services,
+    const ServerOptions& options) {
+  INTR_RETURN_IF_ERROR(ValidateServerOptions(options));
   ::grpc::ServerBuilder builder;
   builder.AddListeningPort(
       std::string(address),
@@ -87,6 +222,32 @@ absl::StatusOr<std::unique_ptr<::grpc::Server>> CreateServer(
     builder.RegisterService(service);
   }
 
+  if (options.num_completion_queues > 0) {
+    builder.SetSyncServerOption(
+        ::grpc::ServerBuilder::SyncServerOption::NUM_CQS,
+        options.num_completion_queues);
+  }
+  if (options.min_pollers > 0) {
+    builder.SetSyncServerOption(
+        ::grpc::ServerBuilder::SyncServerOption::MIN_POLLERS,
+        options.min_pollers);
+  }
+  if (options.max_pollers > 0) {
+    builder.SetSyncServerOption(
+        ::grpc::ServerBuilder::SyncServerOption::MAX_POLLERS,
+        options.max_pollers);
+  }
+  if (options.max_threads > 0 || options.max_memory_bytes > 0) {
+    ::grpc::ResourceQuota quota(absl::StrCat("server_", address));
+    if (options.max_threads > 0) {
+      quota.SetMaxThreads(options.max_threads);
+    }
+    if (options.max_memory_bytes > 0) {
+      quota.Resize(static_cast<size_t>(options.max_memory_bytes));
+    }
+    builder.SetResourceQuota(quota);
+  }
+
   std::unique_ptr<::grpc::Server> server(builder.BuildAndStart());
   if (server == nullptr) {
     return absl::InternalError("Could not start the server.");
@@ -95,10 +256,18 @@ absl::StatusOr<std::unique_ptr<::grpc::Server>> CreateServer(
   return server;
 }
 
+}  // namespace
+
 absl::StatusOr<std::unique_ptr<::grpc::Server>> CreateServer(
     uint16_t listen_port, const std::vector<::grpc::Service*>& services) {
+  return CreateServer(listen_port, services, ServerOptions());
+}
+
+absl::StatusOr<std::unique_ptr<::grpc::Server>> CreateServer(
+    uint16_t listen_port, const std::vector<::grpc::Service*>& services,
+    const ServerOptions& options) {
   std::string address = "0.0.0.0:" + std::to_string(listen_port);
-  return CreateServer(address, services);
+  return CreateServer(address, services, options);
 }
 
 void ConfigureClientContext(::grpc::ClientContext* client_context) {
@@ -115,26 +284,12 @@ absl::Status WaitForChannelConnected(absl::string_view address,
   } else {
     channel->WaitForConnected(absl::ToChronoTime(deadline));
     grpc_connectivity_state channel_state = channel->GetState(false);
-    std::string channel_state_string;
-    switch (channel_state) {
-      case GRPC_CHANNEL_READY:
-        return absl::OkStatus();
-      case GRPC_CHANNEL_IDLE:
-        channel_state_string = "GRPC_CHANNEL_IDLE";
-        break;
-      case GRPC_CHANNEL_CONNECTING:
-        channel_state_string = "GRPC_CHANNEL_CONNECTING";
-        break;
-      case GRPC_CHANNEL_TRANSIENT_FAILURE:
-        channel_state_string = "GRPC_CHANNEL_TRANSIENT_FAILURE";
-        break;
-      case GRPC_CHANNEL_SHUTDOWN:
-        channel_state_string = "GRPC_CHANNEL_SHUTDOWN";
-        break;
+    if (channel_state == GRPC_CHANNEL_READY) {
+      return absl::OkStatus();
     }
-    return absl::UnavailableError(absl::StrCat("gRPC channel to ", address,
-                                               " is unavailable.  State is ",
-                                               channel_state_string));
+    return absl::UnavailableError(
+        absl::StrCat("gRPC channel to ", address, " is unavailable.  State is ",
+                     ChannelStateName(channel_state)));
   }
 }
 
@@ -173,49 +328,53 @@ absl::StatusOr<std::shared_ptr<::grpc::Channel>> CreateClientChannel(
     const absl::string_view address, absl::Time deadline,
     const ::grpc::ChannelArguments& channel_args,
     bool use_default_application_credentials) {
-  LOG(INFO) << "Connecting to " << address;
-  absl::Status status =
-      absl::DeadlineExceededError("Deadline in past in CreateClientChannel");
-  while (absl::Now() < deadline) {
-    std::shared_ptr<::grpc::Channel> channel;
-    if (use_default_application_credentials) {
-      channel = ::grpc::CreateCustomChannel(
-          std::string(address), grpc::GoogleDefaultCredentials(), channel_args);
-    } else {
-      channel = ::grpc::CreateCustomChannel(
-          std::string(address),
-          ::grpc::                       // NOLINTNEXTLINE
-          InsecureChannelCredentials(),  // NO_LINT(grpc_insecure_credential_linter)
-          channel_args);
-    }
+  const ClientChannelTarget target = {
+      .address = std::string(address),
+      .timeout = deadline - absl::Now(),
+      .channel_args = channel_args,
+      .use_default_application_credentials =
+          use_default_application_credentials};
+  return std::move(CreateClientChannels({target}).front());
+}
 
-    status = WaitForChannelConnected(address, channel, deadline);
-    if (!status.ok()) continue;
-
-    // CheckChannelHealth does not work when using application default
-    // credentials. It returns "UNKNOWN: Received http2 header with status:
-    // 302".
-    if (!use_default_application_credentials) {
-      // For some reason, WaitForChannelConnected can return "ok" even when the
-      // server is not yet running. When checking for this case,
-      // use a short timeout to allow time to retry after.
-      status = CheckChannelHealth(channel, /*timeout=*/absl::Seconds(1));
-      if (!status.ok()) {
-        LOG(ERROR) << "Unhealthy channel: " << status;
-        continue;
-      }
+std::vector<absl::StatusOr<std::shared_ptr<::grpc::Channel>>>
+CreateClientChannels(absl::Span<const ClientChannelTarget> targets) {
+  ::grpc::CompletionQueue cq;
+  const absl::Time start = absl::Now();
+  std::vector<std::unique_ptr<ChannelConnector>> connectors;
+  connectors.reserve(targets.size());
+  int num_pending = 0;
+  for (const ClientChannelTarget& target : targets) {
+    connectors.push_back(std::make_unique<ChannelConnector>(
+        target, start + target.timeout, &cq));
+    if (!connectors.back()->Start()) {
+      ++num_pending;
+    }
+  }
+  // Every pending operation has a deadline, so this terminates.
+  void* tag;
+  bool ok;
+  while (num_pending > 0 && cq.Next(&tag, &ok)) {
+    if (static_cast<ChannelConnector*>(tag)->Proceed(ok)) {
+      --num_pending;
     }
-
-    LOG(INFO) << "Successfully connected to " << address;
-    return channel;
+  }
+  cq.Shutdown();
+  while (cq.Next(&tag, &ok)) {
   }
 
-  return status;
+  std::vector<absl::StatusOr<std::shared_ptr<::grpc::Channel>>> channels;
+  channels.reserve(connectors.size());
+  for (std::unique_ptr<ChannelConnector>& connector : connectors) {
+    channels.push_back(std::move(*connector).result());
+  }
+  return channels;
 }
 
 ShutdownParams ShutdownParams::Aggressive() {
   return {.health_grace_duration = absl::ZeroDuration(),
-          .shutdown_timeout = absl::Milliseconds(250)};
+          .shutdown_timeout = absl::Milliseconds(250),
+          .drain_timeout = absl::Milliseconds(250)};
 }
 
 absl::Status RegisterSignalHandlerAndWait(
@@ -269,6 +428,9 @@ absl::Status RegisterSignalHandlerAndWait(
       absl::SleepFor(params.health_grace_duration);
     }
     server->Shutdown(absl::Now() + params.shutdown_timeout);
+    if (params.drains != nullptr) {
+      params.drains->Drain(absl::Now() + params.drain_timeout);
+    }
   });
 
   server->Wait();
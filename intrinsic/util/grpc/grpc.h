@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -13,7 +14,9 @@
 #include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "grpcpp/grpcpp.h"
+#include "intrinsic/util/shutdown_coordinator.h"
 
 namespace intrinsic {
 
@@ -21,6 +24,29 @@ namespace intrinsic {
 // initial GRPC connection made by client libraries.
 constexpr absl::Duration kGrpcClientConnectDefaultTimeout = absl::Seconds(5);
 
+// Options for the threads and resources of a server from CreateServer(). The
+// defaults are those of gRPC.
+//
+// Synchronous services block a thread for every call in progress, so a
+// server with many concurrent long-running calls, e.g., WaitOperation, runs
+// out of threads. Callback services, i.e., the Foo::CallbackService of a
+// service Foo, do not; they are passed to CreateServer() like any other
+// service and scale to many calls without a thread each.
+struct ServerOptions {
+  // Number of completion queues of the synchronous server, or 0 for the
+  // default, which is one per core.
+  int num_completion_queues = 0;
+  // Minimum and maximum number of threads per completion queue that poll for
+  // new synchronous calls, or 0 for the defaults.
+  int min_pollers = 0;
+  int max_pollers = 0;
+  // Limits of the server's resource quota, or 0 for no limit. `max_threads`
+  // limits the threads of synchronous services; a call that would exceed it
+  // fails with RESOURCE_EXHAUSTED.
+  int max_threads = 0;
+  int64_t max_memory_bytes = 0;
+};
+
 /**
  * Create a grpc server using the listen port on the default interface
  * and the set of services provided
@@ -28,6 +54,14 @@ constexpr absl::Duration kGrpcClientConnectDefaultTimeout = absl::Seconds(5);
 absl::StatusOr<std::unique_ptr<::grpc::Server>> CreateServer(
     uint16_t listen_port, const std::vector<::grpc::Service*>& services);
 
+// Same as above, with `options` for the server's threads and resources.
+//
+// Returns InvalidArgumentError if an option is negative or min_pollers exceeds
+// max_pollers.
+absl::StatusOr<std::unique_ptr<::grpc::Server>> CreateServer(
+    uint16_t listen_port, const std::vector<::grpc::Service*>& services,
+    const ServerOptions& options);
+
 /**
  * Apply the default configuration of our project to the given ClientContext.
  */
@@ -56,6 +90,24 @@ absl::StatusOr<std::shared_ptr<::grpc::Channel>> CreateClientChannel(
     const ::grpc::ChannelArguments& channel_args = DefaultGrpcChannelArgs(),
     bool use_default_application_credentials = false);
 
+// A service to connect to with CreateClientChannels().
+struct ClientChannelTarget {
+  std::string address;
+  // Maximum time to wait for the service, counted from the start of
+  // CreateClientChannels().
+  absl::Duration timeout = kGrpcClientConnectDefaultTimeout;
+  ::grpc::ChannelArguments channel_args = DefaultGrpcChannelArgs();
+  bool use_default_application_credentials = false;
+};
+
+// Same as CreateClientChannel() for each of `targets`, but connects to all of
+// them concurrently, so that it takes as long as the slowest target instead of
+// the sum of all. Returns one channel or error per target, in the order of
+// `targets`. A single completion queue serves the connection and health checks
+// of all targets.
+std::vector<absl::StatusOr<std::shared_ptr<::grpc::Channel>>>
+CreateClientChannels(absl::Span<const ClientChannelTarget> targets);
+
 // Parameters to configure the shutdown behavior of a gRPC server.
 struct ShutdownParams {
   // Duration to wait for the grpc's health service state (if relevant) to
@@ -63,6 +115,11 @@ struct ShutdownParams {
   absl::Duration health_grace_duration;
   // Timeout passed into grpc::Server::Shutdown on a sigterm.
   absl::Duration shutdown_timeout;
+  // Drains to run once the server has shut down, e.g. to flush queued logs
+  // and pubsub messages. Not owned.
+  ShutdownCoordinator* drains = nullptr;
+  // Overall deadline for `drains`, counted from when the server has shut down.
+  absl::Duration drain_timeout = absl::Seconds(5);
 
   // Returns params that aggressively shutdowns the server.
   static ShutdownParams Aggressive();
@@ -70,7 +127,8 @@ struct ShutdownParams {
 
 // Registers a custom signal handler for SIGTERM, serves the server and blocks
 // till it is shutdown. The custom handler is left registered when the function
-// returns.
+// returns. On a SIGTERM, also runs ShutdownParams::drains after the server has
+// shut down.
 //
 // `handlers_registered` notification is triggered once the signal handler is
 // registered. This is mainly useful in unit tests to know when it is okay to
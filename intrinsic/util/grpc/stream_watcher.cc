@@ -0,0 +1,111 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/grpc/stream_watcher.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "grpcpp/client_context.h"
+
+namespace intrinsic {
+
+StreamWatcher::StreamWatcher(StreamFn stream, Options options)
+    : stream_(std::move(stream)), options_(std::move(options)) {
+  // Start the thread only once all members are initialized.
+  thread_ = Thread(&StreamWatcher::Run, this);
+}
+
+StreamWatcher::~StreamWatcher() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stop_.Notify();
+    if (context_ != nullptr) {
+      context_->TryCancel();
+    }
+  }
+  thread_.Join();
+}
+
+absl::Status StreamWatcher::status() const {
+  absl::MutexLock lock(&mutex_);
+  return status_;
+}
+
+absl::Status StreamWatcher::Stream() {
+  std::unique_ptr<::grpc::ClientContext> context =
+      options_.client_context_factory();
+  {
+    absl::MutexLock lock(&mutex_);
+    if (stop_.HasBeenNotified()) {
+      return absl::CancelledError("Watcher destroyed");
+    }
+    context_ = context.get();
+  }
+  absl::Status status = stream_(context.get());
+  absl::MutexLock lock(&mutex_);
+  context_ = nullptr;
+  return status;
+}
+
+absl::Status StreamWatcher::Poll() {
+  absl::Time next_poll = absl::Now();
+  while (!stop_.HasBeenNotified()) {
+    next_poll += options_.poll_period;
+    if (absl::Status status = options_.poll(next_poll); !status.ok()) {
+      return status;
+    }
+    if (stop_.WaitForNotificationWithDeadline(next_poll)) {
+      break;
+    }
+    // Don't try to catch up on polls that were missed because the server was
+    // slow.
+    next_poll = std::max(next_poll, absl::Now() - options_.poll_period);
+  }
+  return absl::OkStatus();
+}
+
+bool StreamWatcher::IsPermanent(const absl::Status& status) {
+  return absl::IsUnimplemented(status) ||
+         (options_.is_permanent != nullptr && options_.is_permanent(status));
+}
+
+void StreamWatcher::Run() {
+  absl::Status status;
+  while (true) {
+    status = Stream();
+    if (stop_.HasBeenNotified()) {
+      return;
+    }
+    if (absl::IsUnimplemented(status) && options_.poll != nullptr) {
+      LOG(INFO) << "Server cannot stream the " << options_.name
+                << ", polling it every "
+                << absl::FormatDuration(options_.poll_period) << " instead";
+      status = Poll();
+      break;
+    }
+    if (IsPermanent(status)) {
+      break;
+    }
+    LOG(WARNING) << "Stream of the " << options_.name
+                 << " ended, reopening it in "
+                 << absl::FormatDuration(options_.retry_delay) << ": "
+                 << status;
+    if (stop_.WaitForNotificationWithTimeout(options_.retry_delay)) {
+      return;
+    }
+  }
+  if (status.ok()) {
+    return;
+  }
+  LOG(ERROR) << "Stopped watching the " << options_.name << ": " << status;
+  absl::MutexLock lock(&mutex_);
+  status_ = std::move(status);
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,116 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_UTIL_GRPC_STREAM_WATCHER_H_
+#define INTRINSIC_UTIL_GRPC_STREAM_WATCHER_H_
+
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/support/sync_stream.h"
+#include "intrinsic/util/grpc/channel_interface.h"
+#include "intrinsic/util/status/status_conversion_grpc.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+
+// Lower bound for the delay before a broken stream is reopened, for watchers
+// that sample at a short period, so that they do not hammer a server that is
+// down.
+inline constexpr absl::Duration kMinStreamRetryDelay = absl::Seconds(1);
+
+// Reads a server-streaming RPC on a background thread, and reopens the stream
+// whenever it breaks.
+//
+// The stream function opens the stream with the given ClientContext, reads it
+// until it ends and returns its final status, e.g. with ReadStream(). If the
+// stream ends with an error, the watcher opens it again after `retry_delay`.
+// If the server does not implement the stream, the watcher calls the poll
+// function every `poll_period` instead. Errors that reopening the stream does
+// not fix stop the watcher, see status().
+//
+// Destroying the watcher cancels the open stream, and waits for the stream or
+// poll function to return. Owners should declare the watcher as their last
+// member, so that it stops before the members used by these functions are
+// destroyed.
+class StreamWatcher {
+ public:
+  // Opens the stream with `context`, reads it until it ends, and returns its
+  // final status.
+  using StreamFn =
+      absl::AnyInvocable<absl::Status(::grpc::ClientContext* context)>;
+  // Polls the server once, waiting at most until `deadline`. Returns an error
+  // only if the watcher should stop.
+  using PollFn = absl::AnyInvocable<absl::Status(absl::Time deadline)>;
+
+  struct Options {
+    // What is watched, for log messages, e.g. "operational status".
+    std::string name;
+    // Creates the ClientContext of each stream.
+    ClientContextFactory client_context_factory = DefaultClientContextFactory;
+    // Delay before a broken stream is opened again. Must be positive.
+    absl::Duration retry_delay;
+    // Called every `poll_period` if the server does not implement the stream.
+    // If null, UnimplementedError stops the watcher instead.
+    PollFn poll;
+    // Must be positive if `poll` is set.
+    absl::Duration poll_period;
+    // Returns true for stream errors besides UnimplementedError that reopening
+    // the stream does not fix, and that stop the watcher. May be null.
+    absl::AnyInvocable<bool(const absl::Status&)> is_permanent;
+  };
+
+  // Starts reading the stream with `stream` on a new thread.
+  StreamWatcher(StreamFn stream, Options options);
+
+  ~StreamWatcher();
+
+  StreamWatcher(const StreamWatcher&) = delete;
+  StreamWatcher& operator=(const StreamWatcher&) = delete;
+
+  // Returns the error that stopped the watcher, or OkStatus while it runs.
+  absl::Status status() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  // Opens and reads one stream, unless the watcher is being destroyed.
+  absl::Status Stream() ABSL_LOCKS_EXCLUDED(mutex_);
+  // Polls until the watcher is destroyed or the poll function fails.
+  absl::Status Poll();
+  // Returns true if reopening the stream does not fix `status`.
+  bool IsPermanent(const absl::Status& status);
+  void Run();
+
+  StreamFn stream_;
+  Options options_;
+
+  mutable absl::Mutex mutex_;
+  // The context of the open stream, if any, so that the destructor can cancel
+  // it.
+  ::grpc::ClientContext* context_ ABSL_GUARDED_BY(mutex_) = nullptr;
+  absl::Status status_ ABSL_GUARDED_BY(mutex_);
+  // Notified with `mutex_` held, so that no stream is opened after the
+  // destructor cancelled `context_`.
+  absl::Notification stop_;
+  Thread thread_;
+};
+
+// Reads `reader` until the stream ends, calls `on_response` with each
+// response, and returns the final status of the stream.
+template <typename Response, typename OnResponse>
+absl::Status ReadStream(::grpc::ClientReaderInterface<Response>& reader,
+                        OnResponse on_response) {
+  Response response;
+  while (reader.Read(&response)) {
+    on_response(response);
+  }
+  return ToAbslStatus(reader.Finish());
+}
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_UTIL_GRPC_STREAM_WATCHER_H_
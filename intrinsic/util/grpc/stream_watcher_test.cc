@@ -0,0 +1,172 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/grpc/stream_watcher.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "google/protobuf/empty.pb.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/server.h"
+#include "grpcpp/server_builder.h"
+#include "grpcpp/server_context.h"
+#include "grpcpp/support/channel_arguments.h"
+#include "grpcpp/support/status.h"
+#include "intrinsic/util/grpc/testing/ping.grpc.pb.h"
+#include "intrinsic/util/status/status_conversion_grpc.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic {
+namespace {
+
+using ::google::protobuf::Empty;
+using ::intrinsic::testing::StatusIs;
+using ::intrinsic_proto::test::PingService;
+
+constexpr absl::Duration kTimeout = absl::Seconds(10);
+constexpr absl::Duration kShortDelay = absl::Milliseconds(1);
+
+// Waits until `watcher` stopped with an error, and returns it.
+absl::Status WaitUntilStopped(const StreamWatcher& watcher) {
+  const absl::Time deadline = absl::Now() + kTimeout;
+  while (watcher.status().ok() && absl::Now() < deadline) {
+    absl::SleepFor(kShortDelay);
+  }
+  return watcher.status();
+}
+
+TEST(StreamWatcherTest, ReopensBrokenStream) {
+  std::atomic<int> num_streams = 0;
+  absl::Notification reopened;
+  StreamWatcher watcher(
+      [&](::grpc::ClientContext*) {
+        if (++num_streams == 3) {
+          reopened.Notify();
+        }
+        return absl::UnavailableError("down");
+      },
+      {.name = "test stream", .retry_delay = kShortDelay});
+
+  EXPECT_TRUE(reopened.WaitForNotificationWithTimeout(kTimeout));
+  EXPECT_OK(watcher.status());
+}
+
+TEST(StreamWatcherTest, PollsIfStreamIsUnimplemented) {
+  std::atomic<int> num_streams = 0;
+  std::atomic<int> num_polls = 0;
+  absl::Notification polled;
+  StreamWatcher watcher(
+      [&](::grpc::ClientContext*) {
+        ++num_streams;
+        return absl::UnimplementedError("no stream");
+      },
+      {.name = "test stream",
+       .retry_delay = kShortDelay,
+       .poll =
+           [&](absl::Time) {
+             if (++num_polls == 3) {
+               polled.Notify();
+             }
+             return absl::OkStatus();
+           },
+       .poll_period = kShortDelay});
+
+  EXPECT_TRUE(polled.WaitForNotificationWithTimeout(kTimeout));
+  EXPECT_EQ(num_streams, 1);
+  EXPECT_OK(watcher.status());
+}
+
+TEST(StreamWatcherTest, StopsOnPermanentError) {
+  std::atomic<int> num_streams = 0;
+  StreamWatcher watcher(
+      [&](::grpc::ClientContext*) {
+        ++num_streams;
+        return absl::NotFoundError("unknown handle");
+      },
+      {.name = "test stream",
+       .retry_delay = kShortDelay,
+       .is_permanent = [](const absl::Status& status) {
+         return absl::IsNotFound(status);
+       }});
+
+  EXPECT_THAT(WaitUntilStopped(watcher),
+              StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_EQ(num_streams, 1);
+}
+
+TEST(StreamWatcherTest, StopsIfUnimplementedWithoutPoll) {
+  StreamWatcher watcher(
+      [](::grpc::ClientContext*) {
+        return absl::UnimplementedError("no stream");
+      },
+      {.name = "test stream", .retry_delay = kShortDelay});
+
+  EXPECT_THAT(WaitUntilStopped(watcher),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+TEST(StreamWatcherTest, StopsWhenPollFails) {
+  StreamWatcher watcher(
+      [](::grpc::ClientContext*) {
+        return absl::UnimplementedError("no stream");
+      },
+      {.name = "test stream",
+       .retry_delay = kShortDelay,
+       .poll = [](absl::Time) { return absl::AbortedError("ended"); },
+       .poll_period = kShortDelay});
+
+  EXPECT_THAT(WaitUntilStopped(watcher),
+              StatusIs(absl::StatusCode::kAborted));
+}
+
+// Blocks each ping until the client cancels it.
+class BlockingPingService : public PingService::Service {
+ public:
+  grpc::Status Ping(grpc::ServerContext* context, const Empty* request,
+                    Empty* response) override {
+    started_.Notify();
+    const absl::Time deadline = absl::Now() + kTimeout;
+    while (!context->IsCancelled() && absl::Now() < deadline) {
+      absl::SleepFor(kShortDelay);
+    }
+    return grpc::Status(grpc::StatusCode::CANCELLED, "cancelled");
+  }
+
+  absl::Notification& started() { return started_; }
+
+ private:
+  absl::Notification started_;
+};
+
+TEST(StreamWatcherTest, DestructorCancelsOpenStream) {
+  BlockingPingService service;
+  grpc::ServerBuilder builder;
+  builder.RegisterService(&service);
+  std::unique_ptr<grpc::Server> server = builder.BuildAndStart();
+  ASSERT_NE(server, nullptr);
+  std::unique_ptr<PingService::Stub> stub =
+      PingService::NewStub(server->InProcessChannel(grpc::ChannelArguments()));
+
+  auto watcher = std::make_unique<StreamWatcher>(
+      [&stub](::grpc::ClientContext* context) {
+        Empty response;
+        return ToAbslStatus(stub->Ping(context, Empty(), &response));
+      },
+      StreamWatcher::Options{.name = "test stream", .retry_delay = kTimeout});
+  ASSERT_TRUE(service.started().WaitForNotificationWithTimeout(kTimeout));
+
+  const absl::Time start = absl::Now();
+  watcher.reset();
+  EXPECT_LT(absl::Now() - start, kTimeout / 2);
+  server->Shutdown(absl::ToChronoTime(absl::Now() + kTimeout));
+}
+
+}  // namespace
+}  // namespace intrinsic
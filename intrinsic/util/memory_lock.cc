@@ -0,0 +1,201 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/memory_lock.h"
+
+#include <alloca.h>
+#include <errno.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic {
+namespace {
+
+constexpr size_t kHugePageSize = size_t{2} << 20;
+
+size_t PageSize() { return static_cast<size_t>(sysconf(_SC_PAGESIZE)); }
+
+// Returns the status for a failed mlock() or mmap() with `errnum`.
+absl::Status LockError(absl::string_view what, int errnum) {
+  const std::string message = absl::StrCat(what, ": ", strerror(errnum));
+  if (errnum == EPERM) {
+    return absl::PermissionDeniedError(message);
+  }
+  return absl::ResourceExhaustedError(message);
+}
+
+// Returns the bytes of stack below the current frame of the calling thread.
+absl::StatusOr<size_t> RemainingStack() {
+  pthread_attr_t attr;
+  if (int errnum = pthread_getattr_np(pthread_self(), &attr); errnum != 0) {
+    return absl::InternalError(absl::StrCat(
+        "Failed to get the stack of the thread: ", strerror(errnum)));
+  }
+  void* stack_address = nullptr;
+  size_t stack_size = 0;
+  const int errnum = pthread_attr_getstack(&attr, &stack_address, &stack_size);
+  pthread_attr_destroy(&attr);
+  if (errnum != 0) {
+    return absl::InternalError(absl::StrCat(
+        "Failed to get the stack of the thread: ", strerror(errnum)));
+  }
+  const auto frame = reinterpret_cast<uintptr_t>(__builtin_frame_address(0));
+  return frame - reinterpret_cast<uintptr_t>(stack_address);
+}
+
+// Touches and locks `bytes` of stack in its own frame. Not inlined, so that
+// the frame is released when it returns.
+__attribute__((noinline)) absl::Status TouchAndLockStack(size_t bytes) {
+  volatile char* stack = static_cast<volatile char*>(alloca(bytes));
+  // Each write faults in a page. For the main thread, this also grows the
+  // stack mapping, which mlock() alone would not.
+  const size_t page_size = PageSize();
+  for (size_t i = 0; i < bytes; i += page_size) {
+    stack[i] = 0;
+  }
+  return LockRegion(const_cast<char*>(stack), bytes);
+}
+
+}  // namespace
+
+absl::Status ApplyMemoryLockProfile(const MemoryLockProfile& profile) {
+  if (profile.lock_all && mlockall(MCL_CURRENT | MCL_FUTURE) < 0) {
+    return LockError("Failed to lock memory", errno);
+  }
+  if (profile.heap_prefault_bytes > 0) {
+    // See LockMemory() for why malloc must neither use mmap nor trim.
+    mallopt(M_MMAP_MAX, 0);
+    mallopt(M_TRIM_THRESHOLD, -1);
+    char* heap_prefault =
+        static_cast<char*>(malloc(profile.heap_prefault_bytes));
+    if (heap_prefault == nullptr) {
+      return absl::ResourceExhaustedError(
+          "Unable to allocate heap memory to lock in RAM.");
+    }
+    // The pages stay locked after free(), since the heap is not trimmed.
+    absl::Status status =
+        LockRegion(heap_prefault, profile.heap_prefault_bytes);
+    free(heap_prefault);
+    INTR_RETURN_IF_ERROR(status);
+  }
+  if (profile.stack_prefault_bytes > 0) {
+    INTR_RETURN_IF_ERROR(
+        PrefaultCurrentThreadStack(profile.stack_prefault_bytes));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status PrefaultCurrentThreadStack(size_t bytes) {
+  if (bytes == 0) {
+    return absl::OkStatus();
+  }
+  INTR_ASSIGN_OR_RETURN(size_t remaining, RemainingStack());
+  // Leaves room for the frames of TouchAndLockStack() and mlock().
+  constexpr size_t kReserve = 16 << 10;
+  if (bytes + kReserve > remaining) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Cannot prefault ", bytes, " bytes of stack, only ",
+                     remaining, " bytes are left"));
+  }
+  return TouchAndLockStack(bytes);
+}
+
+absl::Status LockRegion(const void* address, size_t size) {
+  if (size == 0) {
+    return absl::OkStatus();
+  }
+  // mlock() rounds `address` down to a page boundary and prefaults all pages.
+  if (mlock(address, size) < 0) {
+    return LockError(absl::StrCat("Failed to lock ", size, " bytes"), errno);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status UnlockRegion(const void* address, size_t size) {
+  if (size == 0) {
+    return absl::OkStatus();
+  }
+  if (munlock(address, size) < 0) {
+    return absl::InternalError(absl::StrCat("Failed to unlock ", size,
+                                            " bytes: ", strerror(errno)));
+  }
+  return absl::OkStatus();
+}
+
+// static
+absl::StatusOr<std::unique_ptr<LockedArena>> LockedArena::Create(
+    size_t size, bool use_huge_pages) {
+  if (size == 0) {
+    return absl::InvalidArgumentError("Arena size must be positive");
+  }
+  const size_t page_size = use_huge_pages ? kHugePageSize : PageSize();
+  const size_t capacity = (size + page_size - 1) / page_size * page_size;
+
+  void* data = MAP_FAILED;
+  bool has_explicit_huge_pages = false;
+  if (use_huge_pages) {
+    data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    has_explicit_huge_pages = data != MAP_FAILED;
+  }
+  if (data == MAP_FAILED) {
+    data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+      return LockError(absl::StrCat("Failed to map ", capacity, " bytes"),
+                       errno);
+    }
+    if (use_huge_pages) {
+      // Best effort, transparent huge pages may be disabled.
+      madvise(data, capacity, MADV_HUGEPAGE);
+    }
+  }
+  if (absl::Status status = LockRegion(data, capacity); !status.ok()) {
+    munmap(data, capacity);
+    return status;
+  }
+  return absl::WrapUnique(new LockedArena(static_cast<char*>(data), capacity,
+                                          has_explicit_huge_pages));
+}
+
+LockedArena::LockedArena(char* data, size_t capacity,
+                         bool has_explicit_huge_pages)
+    : data_(data),
+      capacity_(capacity),
+      has_explicit_huge_pages_(has_explicit_huge_pages) {}
+
+LockedArena::~LockedArena() { munmap(data_, capacity_); }
+
+void* LockedArena::Allocate(size_t size, size_t alignment) {
+  const auto base = reinterpret_cast<uintptr_t>(data_);
+  size_t used = used_.load(std::memory_order_relaxed);
+  size_t begin = 0;
+  do {
+    begin = ((base + used + alignment - 1) & ~(alignment - 1)) - base;
+    if (begin > capacity_ || size > capacity_ - begin) {
+      return nullptr;
+    }
+  } while (!used_.compare_exchange_weak(used, begin + size,
+                                        std::memory_order_relaxed));
+  return data_ + begin;
+}
+
+void LockedArena::Reset() { used_.store(0, std::memory_order_relaxed); }
+
+}  // namespace intrinsic
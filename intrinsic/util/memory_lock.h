@@ -6,13 +6,22 @@
 #include <malloc.h>
 #include <sys/mman.h>
 
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "intrinsic/icon/testing/realtime_annotations.h"
 
 namespace intrinsic {
 
 // Locks and prefaults a specified amount of stack and heap memory.
 // Returns absl::InternalError if the system is unable to lock memory to RAM.
 // This is most likely due to unavailable capabilities.
+//
+// Locks all memory of the process, including that of non-real-time threads.
+// For large processes, prefer ApplyMemoryLockProfile() without `lock_all`.
 template <int STACK_SIZE, int HEAP_SIZE>
 inline absl::Status LockMemory() {
   // Configure malloc to use only heap memory.
@@ -52,6 +61,107 @@ inline absl::Status LockMemory() {
   return absl::OkStatus();
 }
 
+// Which memory of the process to prefault and lock in RAM.
+//
+// Locking everything, like LockMemory(), is simple, but slows down the start
+// of large processes and keeps memory resident that real-time threads never
+// touch. Instead, a process can lock only what its real-time threads use:
+// - the heap they allocate from, with `heap_prefault_bytes`,
+// - their stacks, with Thread::Options::SetStackPrefault(),
+// - their pools, with a LockedArena,
+// - and other buffers, with LockRegion().
+struct MemoryLockProfile {
+  // If true, locks all current and future mappings of the process with
+  // mlockall(MCL_CURRENT | MCL_FUTURE).
+  bool lock_all = false;
+  // Bytes of heap to prefault and lock. If positive, malloc is configured to
+  // neither use mmap nor trim the heap, so that freed memory stays prefaulted
+  // and later allocations reuse it.
+  size_t heap_prefault_bytes = 0;
+  // Bytes of the stack of the calling thread to prefault and lock.
+  size_t stack_prefault_bytes = 0;
+};
+
+// Not real-time safe. Prefaults and locks memory as described by `profile`.
+//
+// Returns ResourceExhaustedError if the memory cannot be allocated or locked,
+// e.g. because of RLIMIT_MEMLOCK, PermissionDeniedError if the process may
+// not lock memory, and InvalidArgumentError if the stack is too small.
+absl::Status ApplyMemoryLockProfile(const MemoryLockProfile& profile);
+
+// Not real-time safe. Prefaults and locks `bytes` of the stack of the calling
+// thread below the current stack frame. Real-time threads should call this
+// before entering their loop, or use Thread::Options::SetStackPrefault().
+//
+// Returns InvalidArgumentError if `bytes` exceed the remaining stack, and the
+// errors of LockRegion().
+absl::Status PrefaultCurrentThreadStack(size_t bytes);
+
+// Not real-time safe. Prefaults and locks the pages of [address, address +
+// size) in RAM, e.g. for a buffer that a real-time thread shares with others.
+//
+// Returns ResourceExhaustedError if the memory cannot be locked, e.g. because
+// of RLIMIT_MEMLOCK, and PermissionDeniedError if the process may not lock
+// memory.
+absl::Status LockRegion(const void* address, size_t size);
+
+// Not real-time safe. Unlocks the pages of [address, address + size). Locks do
+// not nest, so this also unlocks pages shared with other locked regions.
+absl::Status UnlockRegion(const void* address, size_t size);
+
+// A fixed-size, prefaulted and locked memory arena for the allocations of a
+// real-time pool, so that only the pool's memory is locked rather than the
+// whole heap:
+//
+//   INTR_ASSIGN_OR_RETURN(
+//       std::unique_ptr<LockedArena> arena,
+//       LockedArena::Create(64 << 20, /*use_huge_pages=*/true));
+//   void* buffer = arena->Allocate(4096);
+//
+// With huge pages, the arena needs fewer TLB entries. It prefers explicit huge
+// pages (MAP_HUGETLB), which must be reserved in
+// /proc/sys/vm/nr_hugepages, and otherwise asks for transparent huge pages.
+//
+// Allocations are never freed individually; Reset() frees all of them.
+class LockedArena {
+ public:
+  // Not real-time safe. Maps, prefaults and locks at least `size` bytes.
+  //
+  // Returns InvalidArgumentError if `size` is zero, and ResourceExhaustedError
+  // if the memory cannot be mapped or locked.
+  static absl::StatusOr<std::unique_ptr<LockedArena>> Create(
+      size_t size, bool use_huge_pages = false) INTRINSIC_NON_REALTIME_ONLY;
+
+  // Not real-time safe. Unmaps the arena.
+  ~LockedArena();
+
+  LockedArena(const LockedArena&) = delete;
+  LockedArena& operator=(const LockedArena&) = delete;
+
+  // Thread safe and real-time safe. Returns `size` bytes aligned to
+  // `alignment`, which must be a power of two, or nullptr if the arena is
+  // exhausted.
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+      INTRINSIC_CHECK_REALTIME_SAFE;
+
+  // Real-time safe. Frees all allocations. Must not be called concurrently
+  // with Allocate() or while allocations are in use.
+  void Reset() INTRINSIC_CHECK_REALTIME_SAFE;
+
+  size_t capacity() const { return capacity_; }
+  size_t used() const { return used_.load(std::memory_order_relaxed); }
+  // Whether the arena is backed by explicit huge pages.
+  bool has_explicit_huge_pages() const { return has_explicit_huge_pages_; }
+
+ private:
+  LockedArena(char* data, size_t capacity, bool has_explicit_huge_pages);
+
+  char* const data_;
+  const size_t capacity_;
+  const bool has_explicit_huge_pages_;
+  std::atomic<size_t> used_ = 0;
+};
+
 }  // namespace intrinsic
 
 #endif  // INTRINSIC_UTIL_MEMORY_LOCK_H_
@@ -13,6 +13,7 @@
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
 #include "intrinsic/util/proto/merge.h"
+#include "intrinsic/util/proto/type_url.h"
 #include "intrinsic/util/status/status_macros.h"
 
 namespace intrinsic {
@@ -30,7 +31,7 @@ absl::Status UnpackAny(const google::protobuf::Any& any, MsgT& unpacked) {
     return absl::InvalidArgumentError(absl::StrFormat(
         "Cannot unpack empty Any to %s", MsgT::descriptor()->full_name()));
   }
-  if (!any.Is<MsgT>()) {
+  if (!IsTypeUrlOf<MsgT>(any.type_url())) {
     return absl::InvalidArgumentError(
         absl::StrFormat("Cannot unpack Any of type %s to %s.", any.type_url(),
                         MsgT::descriptor()->full_name()));
@@ -0,0 +1,91 @@
+# Copyright 2023 Intrinsic Innovation LLC
+
+"""Defines a build rule for precompiling text protos to binary protos."""
+
+def _import_path(proto_info, source):
+    """Returns the path under which `source` is imported by other protos."""
+    if proto_info.proto_source_root == ".":
+        return source.short_path
+    prefix = proto_info.proto_source_root + "/"
+    if source.path.startswith(prefix):
+        return source.path[len(prefix):]
+    return source.path
+
+def _binary_text_proto_impl(ctx):
+    descriptor_sets = depset(transitive = [
+        dep[ProtoInfo].transitive_descriptor_sets
+        for dep in ctx.attr.deps
+    ])
+    proto_files = [
+        _import_path(dep[ProtoInfo], source)
+        for dep in ctx.attr.deps
+        for source in dep[ProtoInfo].direct_sources
+    ]
+    output_file = ctx.actions.declare_file(ctx.label.name + ".binpb")
+
+    args = ctx.actions.args()
+    args.add("--encode=" + ctx.attr.message)
+    args.add_joined(
+        "--descriptor_set_in",
+        descriptor_sets,
+        join_with = ":",
+    )
+    args.add_all(proto_files)
+
+    ctx.actions.run_shell(
+        outputs = [output_file],
+        inputs = depset([ctx.file.src], transitive = [descriptor_sets]),
+        tools = [ctx.executable._protoc],
+        mnemonic = "EncodeTextProto",
+        progress_message = "Encoding text proto %s" % ctx.file.src.short_path,
+        command = "{protoc} \"$@\" <{src} >{output}".format(
+            protoc = ctx.executable._protoc.path,
+            src = ctx.file.src.path,
+            output = output_file.path,
+        ),
+        arguments = [args],
+    )
+    return DefaultInfo(
+        files = depset([output_file]),
+        runfiles = ctx.runfiles(files = [output_file]),
+    )
+
+# binary_text_proto encodes a text proto file as a binary proto file at build
+# time, so that processes which load it, e.g., with GetTextProto() or
+# GetCachedTextProto() from //intrinsic/util/proto:get_text_proto, do not
+# spend their startup time on parsing text.
+#
+# Example usage:
+#
+#     binary_text_proto(
+#         name = "part_config",
+#         src = "part_config.textproto",
+#         message = "intrinsic_proto.icon.GenericPartConfig",
+#         deps = ["//intrinsic/icon/proto:generic_part_config_proto"],
+#     )
+#
+# Outputs a file named: part_config.binpb
+binary_text_proto = rule(
+    implementation = _binary_text_proto_impl,
+    attrs = {
+        "src": attr.label(
+            allow_single_file = True,
+            mandatory = True,
+            doc = "The text proto file to encode.",
+        ),
+        "message": attr.string(
+            mandatory = True,
+            doc = "Full name of the message type of `src`.",
+        ),
+        "deps": attr.label_list(
+            providers = [ProtoInfo],
+            mandatory = True,
+            doc = "proto_library targets that define `message`.",
+        ),
+        "_protoc": attr.label(
+            executable = True,
+            default = Label("@com_google_protobuf//:protoc"),
+            cfg = "exec",
+        ),
+    },
+)
@@ -2,54 +2,179 @@
 
 #include "intrinsic/util/proto/descriptors.h"
 
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/container/node_hash_map.h"
+#include "absl/synchronization/mutex.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/descriptor.pb.h"
 
 namespace intrinsic {
 namespace {
-// Recursively adds `current_file` and all files it imports to
-// `file_descriptors`.
+
+using ::google::protobuf::Descriptor;
+using ::google::protobuf::DescriptorPool;
+using ::google::protobuf::FileDescriptor;
+using ::google::protobuf::FileDescriptorProto;
+using ::google::protobuf::FileDescriptorSet;
+
+// Appends `current_file` and all files it imports to `files`, imports first.
 //
-// `file_descriptors` is keyed by filename, so that we avoid adding an import
-// multiple times.
-void AddFileAndImports(
-    absl::flat_hash_map<std::string, const google::protobuf::FileDescriptor*>*
-        file_descriptors,
-    const google::protobuf::FileDescriptor& current_file) {
-  // Add current file.
-  if (!file_descriptors->insert({current_file.name(), &current_file}).second) {
-    // There's already a file descriptor with that name, so the dependencies
-    // will be there too. Bail out.
+// `visited` avoids adding an import multiple times.
+void AddFileAndImports(const FileDescriptor& current_file,
+                       absl::flat_hash_set<const FileDescriptor*>& visited,
+                       std::vector<const FileDescriptor*>& files) {
+  if (!visited.insert(&current_file).second) {
+    // The file was already added, so its imports were too. Bail out.
     return;
   }
 
   // Add imports, recursively.
   for (int i = 0; i < current_file.dependency_count(); i++) {
-    AddFileAndImports(file_descriptors, *current_file.dependency(i));
+    AddFileAndImports(*current_file.dependency(i), visited, files);
   }
+  files.push_back(&current_file);
 }
-}  // namespace
 
-google::protobuf::FileDescriptorSet GenFileDescriptorSet(
-    const google::protobuf::Descriptor& descriptor) {
+// Returns the files of the dependency closure of `descriptor`, imports first.
+std::vector<const FileDescriptor*> FileClosure(const Descriptor& descriptor) {
+  absl::flat_hash_set<const FileDescriptor*> visited;
+  std::vector<const FileDescriptor*> files;
+  AddFileAndImports(*descriptor.file(), visited, files);
+  return files;
+}
 
-  // Keyed by filename.
-  absl::flat_hash_map<std::string, const google::protobuf::FileDescriptor*>
-      file_descriptors;
+// A file of the generated pool, converted once.
+struct InternedFile {
+  FileDescriptorProto proto;
+  // A FileDescriptorSet with only `proto`, serialized. Concatenating these
+  // yields the serialized FileDescriptorSet of all their files.
+  std::string serialized_set_entry;
+};
+
+// The dependency closure of a message type of the generated pool, which
+// references the files it shares with other message types.
+struct InternedClosure {
+  std::vector<std::shared_ptr<const InternedFile>> files;
+  // Assembled on first use.
+  std::shared_ptr<const std::string> serialized;
+};
+
+// Interns the files and closures of message types of the generated pool.
+// Descriptors of other pools are never cached, since such pools may be
+// destroyed and their descriptors' addresses reused.
+class DescriptorSetCache {
+ public:
+  static DescriptorSetCache& Get() {
+    static auto* cache = new DescriptorSetCache();
+    return *cache;
+  }
+
+  static bool IsCacheable(const Descriptor& descriptor) {
+    return descriptor.file()->pool() == DescriptorPool::generated_pool();
+  }
+
+  // Returns the files of the closure of `descriptor`, which must be
+  // cacheable. They are immutable, and may be used without the lock.
+  std::vector<std::shared_ptr<const InternedFile>> GetFiles(
+      const Descriptor& descriptor) ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    return GetClosure(descriptor).files;
+  }
+
+  // Returns the serialized FileDescriptorSet of the closure of `descriptor`,
+  // which must be cacheable.
+  std::shared_ptr<const std::string> GetSerialized(
+      const Descriptor& descriptor) ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    InternedClosure& closure = GetClosure(descriptor);
+    if (closure.serialized == nullptr) {
+      size_t size = 0;
+      for (const std::shared_ptr<const InternedFile>& file : closure.files) {
+        size += file->serialized_set_entry.size();
+      }
+      std::string serialized;
+      serialized.reserve(size);
+      for (const std::shared_ptr<const InternedFile>& file : closure.files) {
+        serialized.append(file->serialized_set_entry);
+      }
+      closure.serialized =
+          std::make_shared<const std::string>(std::move(serialized));
+    }
+    return closure.serialized;
+  }
 
-  // Add root file and imports, recursively.
-  AddFileAndImports(&file_descriptors, *descriptor.file());
+ private:
+  DescriptorSetCache() = default;
 
-  // Convert to FileDescriptorSet proto.
-  google::protobuf::FileDescriptorSet out;
-  for (auto& [name, file_descriptor] : file_descriptors) {
-    file_descriptor->CopyTo(out.add_file());
+  InternedClosure& GetClosure(const Descriptor& descriptor)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    auto [it, inserted] = closures_.try_emplace(&descriptor);
+    if (inserted) {
+      for (const FileDescriptor* file : FileClosure(descriptor)) {
+        it->second.files.push_back(GetFile(*file));
+      }
+    }
+    return it->second;
+  }
+
+  std::shared_ptr<const InternedFile> GetFile(const FileDescriptor& file)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    std::shared_ptr<const InternedFile>& interned = files_[&file];
+    if (interned == nullptr) {
+      auto new_file = std::make_shared<InternedFile>();
+      file.CopyTo(&new_file->proto);
+      FileDescriptorSet set;
+      *set.add_file() = new_file->proto;
+      new_file->serialized_set_entry = set.SerializeAsString();
+      interned = std::move(new_file);
+    }
+    return interned;
+  }
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<const FileDescriptor*,
+                      std::shared_ptr<const InternedFile>>
+      files_ ABSL_GUARDED_BY(mutex_);
+  // Values are kept at stable addresses by node_hash_map.
+  absl::node_hash_map<const Descriptor*, InternedClosure> closures_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace
+
+FileDescriptorSet GenFileDescriptorSet(const Descriptor& descriptor) {
+  FileDescriptorSet out;
+  if (!DescriptorSetCache::IsCacheable(descriptor)) {
+    for (const FileDescriptor* file : FileClosure(descriptor)) {
+      file->CopyTo(out.add_file());
+    }
+    return out;
+  }
+
+  std::vector<std::shared_ptr<const InternedFile>> files =
+      DescriptorSetCache::Get().GetFiles(descriptor);
+  out.mutable_file()->Reserve(files.size());
+  for (const std::shared_ptr<const InternedFile>& file : files) {
+    *out.add_file() = file->proto;
   }
   return out;
 }
 
+std::shared_ptr<const std::string> GenSerializedFileDescriptorSet(
+    const Descriptor& descriptor) {
+  if (!DescriptorSetCache::IsCacheable(descriptor)) {
+    return std::make_shared<const std::string>(
+        GenFileDescriptorSet(descriptor).SerializeAsString());
+  }
+  return DescriptorSetCache::Get().GetSerialized(descriptor);
+}
+
 }  // namespace intrinsic
@@ -3,6 +3,8 @@
 #ifndef INTRINSIC_UTIL_PROTO_DESCRIPTORS_H_
 #define INTRINSIC_UTIL_PROTO_DESCRIPTORS_H_
 
+#include <memory>
+#include <string>
 #include <type_traits>
 
 #include "google/protobuf/descriptor.h"
@@ -12,7 +14,12 @@
 namespace intrinsic {
 
 // Generates a FileDescriptorSet given a Descriptor. The returned
-// FileDescriptorSet includes all transitive dependencies of the descriptor.
+// FileDescriptorSet includes all transitive dependencies of the descriptor,
+// each file after the files it imports.
+//
+// For descriptors of the generated pool, the dependency closure and the
+// FileDescriptorProto of each file are computed once per process and shared
+// between all message types.
 google::protobuf::FileDescriptorSet GenFileDescriptorSet(
     const google::protobuf::Descriptor& descriptor);
 
@@ -24,6 +31,21 @@ google::protobuf::FileDescriptorSet GenFileDescriptorSet() {
   return GenFileDescriptorSet(*ProtoT::GetDescriptor());
 }
 
+// Returns GenFileDescriptorSet(descriptor) in serialized form.
+//
+// For descriptors of the generated pool, the result is assembled from the
+// serialized files it shares with other message types, once per process, and
+// the same string is returned on later calls.
+std::shared_ptr<const std::string> GenSerializedFileDescriptorSet(
+    const google::protobuf::Descriptor& descriptor);
+
+// Returns the serialized FileDescriptorSet for message type ProtoT.
+template <class ProtoT, typename = std::enable_if_t<std::is_base_of_v<
+                            google::protobuf::Message, ProtoT>>>
+std::shared_ptr<const std::string> GenSerializedFileDescriptorSet() {
+  return GenSerializedFileDescriptorSet(*ProtoT::GetDescriptor());
+}
+
 }  // namespace intrinsic
 
 #endif  // INTRINSIC_UTIL_PROTO_DESCRIPTORS_H_
@@ -5,17 +5,29 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <string.h>
+#include <sys/stat.h>
 
+#include <memory>
 #include <string>
+#include <tuple>
 
+#include "absl/base/const_init.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "google/protobuf/any.pb.h"
 #include "google/protobuf/io/tokenizer.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 #include "google/protobuf/message.h"
 #include "google/protobuf/text_format.h"
+#include "intrinsic/util/proto/type_url.h"
+#include "intrinsic/util/status/status_macros.h"
 
 namespace intrinsic {
 namespace internal {
@@ -52,6 +64,68 @@ class StringErrorCollector : public google::protobuf::io::ErrorCollector {
   std::string warnings_;
 };
 
+// Identifies a file by its modification time and size, so that cached
+// messages are parsed again when the file changes.
+struct FileVersion {
+  struct timespec mtime;
+  off_t size;
+
+  bool operator==(const FileVersion& other) const {
+    return mtime.tv_sec == other.mtime.tv_sec &&
+           mtime.tv_nsec == other.mtime.tv_nsec && size == other.size;
+  }
+};
+
+absl::StatusOr<FileVersion> GetFileVersion(const std::string& filename) {
+  struct stat file_stat;
+  if (stat(filename.c_str(), &file_stat) != 0) {
+    return absl::NotFoundError(
+        absl::StrCat("error reading file ", filename, ": ", strerror(errno)));
+  }
+  return FileVersion{.mtime = file_stat.st_mtim, .size = file_stat.st_size};
+}
+
+struct CachedTextProto {
+  FileVersion version;
+  std::shared_ptr<const google::protobuf::Message> proto;
+};
+
+// Keyed by file name, message type and whether an Any was allowed.
+using TextProtoCache =
+    absl::flat_hash_map<std::tuple<std::string, std::string, bool>,
+                        CachedTextProto>;
+
+ABSL_CONST_INIT absl::Mutex text_proto_cache_mutex(absl::kConstInit);
+
+TextProtoCache& GetTextProtoCache()
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(text_proto_cache_mutex) {
+  static TextProtoCache* cache = new TextProtoCache();
+  return *cache;
+}
+
+// Like GetTextProtoAllowingAny(), but for a message type that is only known at
+// runtime.
+absl::Status GetTextProtoAllowingAny(absl::string_view filename,
+                                     google::protobuf::Message& proto) {
+  if (GetTextProtoPortable(filename, proto).ok()) {
+    return absl::OkStatus();
+  }
+  google::protobuf::Any any;
+  INTR_RETURN_IF_ERROR(GetTextProtoPortable(filename, any));
+  const absl::string_view full_name = proto.GetDescriptor()->full_name();
+  if (StripTypeUrlPrefix(any.type_url()) != full_name) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Cannot unpack Any of type ", any.type_url(), " to ",
+                     full_name, "."));
+  }
+  if (!proto.ParseFromString(any.value())) {
+    return absl::InternalError(absl::StrCat(
+        "Failed to unpack Any of type ", any.type_url(), " to ", full_name,
+        "."));
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 absl::Status GetTextProtoPortable(absl::string_view filename,
@@ -62,6 +136,14 @@ absl::Status GetTextProtoPortable(absl::string_view filename,
         absl::StrCat("error reading file ", filename, ": ", strerror(errno)));
   }
   google::protobuf::io::FileInputStream fstream(fd);
+  fstream.SetCloseOnDelete(true);
+  if (absl::EndsWith(filename, kBinaryProtoExtension)) {
+    if (!proto.ParseFromZeroCopyStream(&fstream)) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("failed to parse binary proto ", filename));
+    }
+    return absl::OkStatus();
+  }
   StringErrorCollector error_collector;
   google::protobuf::TextFormat::Parser parser;
   parser.RecordErrorsTo(&error_collector);
@@ -77,6 +159,37 @@ absl::Status GetTextProtoPortable(absl::string_view filename,
   return absl::OkStatus();
 }
 
+absl::StatusOr<std::shared_ptr<const google::protobuf::Message>>
+GetCachedTextProto(absl::string_view filename,
+                   const google::protobuf::Message& prototype, bool allow_any) {
+  std::tuple<std::string, std::string, bool> key(
+      filename, prototype.GetDescriptor()->full_name(), allow_any);
+  INTR_ASSIGN_OR_RETURN(const FileVersion version,
+                        GetFileVersion(std::get<0>(key)));
+  {
+    absl::MutexLock lock(&text_proto_cache_mutex);
+    TextProtoCache& cache = GetTextProtoCache();
+    if (auto it = cache.find(key);
+        it != cache.end() && it->second.version == version) {
+      return it->second.proto;
+    }
+  }
+
+  // Parses without holding the lock, so that loading one large file does not
+  // block loading others. Concurrent first loads of the same file may both
+  // parse it, and the last one is kept.
+  std::shared_ptr<google::protobuf::Message> proto(prototype.New());
+  if (allow_any) {
+    INTR_RETURN_IF_ERROR(GetTextProtoAllowingAny(filename, *proto));
+  } else {
+    INTR_RETURN_IF_ERROR(GetTextProtoPortable(filename, *proto));
+  }
+  absl::MutexLock lock(&text_proto_cache_mutex);
+  CachedTextProto& cached = GetTextProtoCache()[std::move(key)];
+  cached = {.version = version, .proto = std::move(proto)};
+  return cached.proto;
+}
+
 }  // namespace internal
 
 absl::Status GetTextProto(absl::string_view filename,
@@ -3,7 +3,9 @@
 #ifndef INTRINSIC_UTIL_PROTO_GET_TEXT_PROTO_H_
 #define INTRINSIC_UTIL_PROTO_GET_TEXT_PROTO_H_
 
+#include <memory>
 #include <type_traits>
+#include <utility>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -15,7 +17,13 @@
 
 namespace intrinsic {
 
-// Loads a text proto file and parses it into proto.
+// Extension of binary proto files, which GetTextProto() reads like text
+// proto files. See binary_text_proto() in build_defs/text_proto.bzl to
+// precompile text protos at build time.
+inline constexpr absl::string_view kBinaryProtoExtension = ".binpb";
+
+// Loads a text proto file and parses it into proto. Files ending in
+// kBinaryProtoExtension are parsed as binary protos instead.
 //
 // Returns a NotFoundError if the file cannot be read.  Returns an
 // InvalidArgumentError if parsing fails. Errors during parsing are reported in
@@ -45,8 +53,43 @@ absl::StatusOr<T> GetTextProtoAllowingAny(absl::string_view filename) {
 namespace internal {
 absl::Status GetTextProtoPortable(absl::string_view filename,
                                   google::protobuf::Message& proto);
+
+absl::StatusOr<std::shared_ptr<const google::protobuf::Message>>
+GetCachedTextProto(absl::string_view filename,
+                   const google::protobuf::Message& prototype, bool allow_any);
 }  // namespace internal
 
+// Like GetTextProto(), but returns a parsed message that is shared by all
+// callers in the process which load the same file as the same type. The file
+// is parsed again only if its modification time or size changed. Use this for
+// large configs that several components load, such as robot configs.
+template <typename T>
+absl::StatusOr<std::shared_ptr<const T>> GetCachedTextProto(
+    absl::string_view filename) {
+  static_assert(std::is_base_of<google::protobuf::Message, T>::value,
+                "GetCachedTextProto() template parameter T must be a "
+                "google::protobuf::Message.");
+  INTR_ASSIGN_OR_RETURN(std::shared_ptr<const google::protobuf::Message> proto,
+                        internal::GetCachedTextProto(
+                            filename, T::default_instance(),
+                            /*allow_any=*/false));
+  return std::static_pointer_cast<const T>(std::move(proto));
+}
+
+// Like GetTextProtoAllowingAny(), but cached like GetCachedTextProto().
+template <typename T>
+absl::StatusOr<std::shared_ptr<const T>> GetCachedTextProtoAllowingAny(
+    absl::string_view filename) {
+  static_assert(std::is_base_of<google::protobuf::Message, T>::value,
+                "GetCachedTextProtoAllowingAny() template parameter T must be "
+                "a google::protobuf::Message.");
+  INTR_ASSIGN_OR_RETURN(std::shared_ptr<const google::protobuf::Message> proto,
+                        internal::GetCachedTextProto(
+                            filename, T::default_instance(),
+                            /*allow_any=*/true));
+  return std::static_pointer_cast<const T>(std::move(proto));
+}
+
 }  // namespace intrinsic
 
 #endif  // INTRINSIC_UTIL_PROTO_GET_TEXT_PROTO_H_
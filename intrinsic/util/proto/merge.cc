@@ -2,12 +2,14 @@
 
 #include "intrinsic/util/proto/merge.h"
 
-#include <memory>
+#include <optional>
 #include <vector>
 
-#include "absl/container/flat_hash_set.h"
+#include "absl/base/const_init.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
-#include "absl/types/span.h"
+#include "absl/synchronization/mutex.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
 
@@ -15,18 +17,174 @@ namespace intrinsic {
 
 namespace {
 
-absl::flat_hash_set<const google::protobuf::OneofDescriptor*> OneofsSet(
-    absl::Span<const google::protobuf::FieldDescriptor* const>
-        field_descriptors) {
-  absl::flat_hash_set<const google::protobuf::OneofDescriptor*> oneofs_set;
-  for (const auto* field : field_descriptors) {
-    if (const google::protobuf::OneofDescriptor* one_of =
-            field->containing_oneof();
-        one_of != nullptr) {
-      oneofs_set.insert(one_of);
+using ::google::protobuf::Descriptor;
+using ::google::protobuf::DescriptorPool;
+using ::google::protobuf::FieldDescriptor;
+using ::google::protobuf::Message;
+using ::google::protobuf::OneofDescriptor;
+using ::google::protobuf::Reflection;
+
+// The fields MergeUnset() checks for a message type, compiled from its
+// descriptor once, so that merging does not list, hash or sort fields.
+struct MergePlan {
+  const Descriptor* descriptor;
+  // Fields that are not members of a oneof. Includes proto3 optional fields,
+  // which are the only members of their synthetic oneof.
+  std::vector<const FieldDescriptor*> fields;
+  // Oneofs, of which at most one member is copied.
+  std::vector<const OneofDescriptor*> oneofs;
+  // Whether set extensions need to be listed.
+  bool has_extensions;
+};
+
+MergePlan CompileMergePlan(const Descriptor* descriptor) {
+  MergePlan plan = {.descriptor = descriptor,
+                    .has_extensions = descriptor->extension_range_count() > 0};
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const FieldDescriptor* field = descriptor->field(i);
+    if (field->real_containing_oneof() == nullptr) {
+      plan.fields.push_back(field);
     }
   }
-  return oneofs_set;
+  for (int i = 0; i < descriptor->oneof_decl_count(); ++i) {
+    const OneofDescriptor* oneof = descriptor->oneof_decl(i);
+    if (!oneof->is_synthetic()) {
+      plan.oneofs.push_back(oneof);
+    }
+  }
+  return plan;
+}
+
+// Returns the cached plan of `descriptor`, or nullptr if `descriptor` is not
+// from the generated pool. Other pools may be destroyed, and their
+// descriptors' addresses reused, so their plans are not cached.
+const MergePlan* GetCachedMergePlan(const Descriptor* descriptor) {
+  if (descriptor->file()->pool() != DescriptorPool::generated_pool()) {
+    return nullptr;
+  }
+  // Avoids the lookup when the same type is merged over and over.
+  thread_local const MergePlan* last_plan = nullptr;
+  if (last_plan != nullptr && last_plan->descriptor == descriptor) {
+    return last_plan;
+  }
+
+  ABSL_CONST_INIT static absl::Mutex mutex(absl::kConstInit);
+  static auto* plans =
+      new absl::flat_hash_map<const Descriptor*, const MergePlan*>();
+  {
+    absl::ReaderMutexLock lock(&mutex);
+    if (auto it = plans->find(descriptor); it != plans->end()) {
+      last_plan = it->second;
+      return last_plan;
+    }
+  }
+  absl::MutexLock lock(&mutex);
+  auto [it, inserted] = plans->try_emplace(descriptor, nullptr);
+  if (inserted) {
+    it->second = new MergePlan(CompileMergePlan(descriptor));
+  }
+  last_plan = it->second;
+  return last_plan;
+}
+
+bool IsSet(const Reflection& reflection, const Message& message,
+           const FieldDescriptor* field) {
+  return field->is_repeated() ? reflection.FieldSize(message, field) > 0
+                              : reflection.HasField(message, field);
+}
+
+// Copies `field` from `from` to `to`, in which it is not set.
+void CopyField(const Reflection& from_reflection, const Message& from,
+               const Reflection& to_reflection, Message& to,
+               const FieldDescriptor* field) {
+  if (field->is_repeated()) {
+    const int size = from_reflection.FieldSize(from, field);
+    for (int i = 0; i < size; ++i) {
+      switch (field->cpp_type()) {
+        case FieldDescriptor::CPPTYPE_INT32:
+          to_reflection.AddInt32(
+              &to, field, from_reflection.GetRepeatedInt32(from, field, i));
+          break;
+        case FieldDescriptor::CPPTYPE_INT64:
+          to_reflection.AddInt64(
+              &to, field, from_reflection.GetRepeatedInt64(from, field, i));
+          break;
+        case FieldDescriptor::CPPTYPE_UINT32:
+          to_reflection.AddUInt32(
+              &to, field, from_reflection.GetRepeatedUInt32(from, field, i));
+          break;
+        case FieldDescriptor::CPPTYPE_UINT64:
+          to_reflection.AddUInt64(
+              &to, field, from_reflection.GetRepeatedUInt64(from, field, i));
+          break;
+        case FieldDescriptor::CPPTYPE_DOUBLE:
+          to_reflection.AddDouble(
+              &to, field, from_reflection.GetRepeatedDouble(from, field, i));
+          break;
+        case FieldDescriptor::CPPTYPE_FLOAT:
+          to_reflection.AddFloat(
+              &to, field, from_reflection.GetRepeatedFloat(from, field, i));
+          break;
+        case FieldDescriptor::CPPTYPE_BOOL:
+          to_reflection.AddBool(
+              &to, field, from_reflection.GetRepeatedBool(from, field, i));
+          break;
+        case FieldDescriptor::CPPTYPE_ENUM:
+          to_reflection.AddEnumValue(
+              &to, field,
+              from_reflection.GetRepeatedEnumValue(from, field, i));
+          break;
+        case FieldDescriptor::CPPTYPE_STRING:
+          to_reflection.AddString(
+              &to, field, from_reflection.GetRepeatedString(from, field, i));
+          break;
+        case FieldDescriptor::CPPTYPE_MESSAGE:
+          to_reflection.AddMessage(&to, field)
+              ->CopyFrom(from_reflection.GetRepeatedMessage(from, field, i));
+          break;
+      }
+    }
+    return;
+  }
+
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      to_reflection.SetInt32(&to, field, from_reflection.GetInt32(from, field));
+      break;
+    case FieldDescriptor::CPPTYPE_INT64:
+      to_reflection.SetInt64(&to, field, from_reflection.GetInt64(from, field));
+      break;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      to_reflection.SetUInt32(&to, field,
+                              from_reflection.GetUInt32(from, field));
+      break;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      to_reflection.SetUInt64(&to, field,
+                              from_reflection.GetUInt64(from, field));
+      break;
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      to_reflection.SetDouble(&to, field,
+                              from_reflection.GetDouble(from, field));
+      break;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      to_reflection.SetFloat(&to, field, from_reflection.GetFloat(from, field));
+      break;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      to_reflection.SetBool(&to, field, from_reflection.GetBool(from, field));
+      break;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      to_reflection.SetEnumValue(&to, field,
+                                 from_reflection.GetEnumValue(from, field));
+      break;
+    case FieldDescriptor::CPPTYPE_STRING:
+      to_reflection.SetString(&to, field,
+                              from_reflection.GetString(from, field));
+      break;
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      to_reflection.MutableMessage(&to, field)
+          ->CopyFrom(from_reflection.GetMessage(from, field));
+      break;
+  }
 }
 
 }  // namespace
@@ -37,41 +195,41 @@ absl::Status MergeUnset(const google::protobuf::Message& from,
     return absl::InvalidArgumentError("`from` and `to` must be the same type");
   }
 
-  const google::protobuf::Reflection* to_reflection = to.GetReflection();
-
-  std::vector<const google::protobuf::FieldDescriptor*> to_fields;
-  to_reflection->ListFields(to, &to_fields);
-  std::vector<const google::protobuf::FieldDescriptor*> from_fields;
-  from.GetReflection()->ListFields(from, &from_fields);
-
-  const absl::flat_hash_set<const google::protobuf::FieldDescriptor*>
-      to_field_set = {to_fields.begin(), to_fields.end()};
-
-  const absl::flat_hash_set<const google::protobuf::OneofDescriptor*>
-      to_field_set_oneofs = OneofsSet(to_fields);
-
-  absl::flat_hash_set<const google::protobuf::FieldDescriptor*>
-      fields_set_in_from_but_not_to = {from_fields.begin(), from_fields.end()};
-
-  absl::erase_if(
-      fields_set_in_from_but_not_to,
-      [&to_field_set,
-       &to_field_set_oneofs](const google::protobuf::FieldDescriptor* field) {
-        return to_field_set.contains(field) ||
-               // Don't overwrite oneof fields of which a different member of
-               // the oneof is set.
-               (field->containing_oneof() != nullptr &&
-                to_field_set_oneofs.contains(field->containing_oneof()));
-      });
-
-  std::vector<const google::protobuf::FieldDescriptor*>
-      in_from_set_not_in_to_set_vec = {fields_set_in_from_but_not_to.begin(),
-                                       fields_set_in_from_but_not_to.end()};
-
-  std::unique_ptr<google::protobuf::Message> swap_space(from.New());
-  swap_space->CopyFrom(from);
-  to_reflection->SwapFields(swap_space.get(), &to,
-                            in_from_set_not_in_to_set_vec);
+  std::optional<MergePlan> uncached_plan;
+  const MergePlan* plan = GetCachedMergePlan(to.GetDescriptor());
+  if (plan == nullptr) {
+    plan = &uncached_plan.emplace(CompileMergePlan(to.GetDescriptor()));
+  }
+
+  const Reflection& from_reflection = *from.GetReflection();
+  const Reflection& to_reflection = *to.GetReflection();
+  for (const FieldDescriptor* field : plan->fields) {
+    if (IsSet(from_reflection, from, field) &&
+        !IsSet(to_reflection, to, field)) {
+      CopyField(from_reflection, from, to_reflection, to, field);
+    }
+  }
+  for (const OneofDescriptor* oneof : plan->oneofs) {
+    // Don't overwrite oneof fields of which a different member of the oneof
+    // is set.
+    if (to_reflection.HasOneof(to, oneof)) {
+      continue;
+    }
+    if (const FieldDescriptor* field =
+            from_reflection.GetOneofFieldDescriptor(from, oneof);
+        field != nullptr) {
+      CopyField(from_reflection, from, to_reflection, to, field);
+    }
+  }
+  if (plan->has_extensions) {
+    std::vector<const FieldDescriptor*> from_fields;
+    from_reflection.ListFields(from, &from_fields);
+    for (const FieldDescriptor* field : from_fields) {
+      if (field->is_extension() && !IsSet(to_reflection, to, field)) {
+        CopyField(from_reflection, from, to_reflection, to, field);
+      }
+    }
+  }
 
   return absl::OkStatus();
 }
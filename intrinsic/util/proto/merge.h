@@ -17,6 +17,10 @@ namespace intrinsic {
 // google::protobuf::Reflection::HasField(field) would return true, and repeated
 // fields will only be listed if google::protobuf::Reflection::FieldSize(field)
 // would return non-zero.
+//
+// The fields to check are compiled once per message type of the generated
+// pool and cached, so that merging the same type again does not list, hash or
+// sort fields.
 absl::Status MergeUnset(const google::protobuf::Message& from,
                         google::protobuf::Message& to);
 
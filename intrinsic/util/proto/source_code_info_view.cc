@@ -5,7 +5,10 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
 
+#include "absl/base/call_once.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
@@ -18,6 +21,39 @@
 
 namespace intrinsic {
 
+namespace {
+
+// Adds the leading comments of `descriptor`, if it has a source location.
+template <typename DescriptorT>
+void AddLeadingComments(
+    const DescriptorT& descriptor,
+    absl::flat_hash_map<std::string, std::string>& leading_comments) {
+  google::protobuf::SourceLocation source_location;
+  if (descriptor.GetSourceLocation(&source_location)) {
+    leading_comments.insert_or_assign(
+        descriptor.full_name(), std::move(source_location.leading_comments));
+  }
+}
+
+// Adds the leading comments of `message`, and of its fields, extensions and
+// nested messages.
+void AddMessageLeadingComments(
+    const google::protobuf::Descriptor& message,
+    absl::flat_hash_map<std::string, std::string>& leading_comments) {
+  AddLeadingComments(message, leading_comments);
+  for (int i = 0; i < message.field_count(); ++i) {
+    AddLeadingComments(*message.field(i), leading_comments);
+  }
+  for (int i = 0; i < message.extension_count(); ++i) {
+    AddLeadingComments(*message.extension(i), leading_comments);
+  }
+  for (int i = 0; i < message.nested_type_count(); ++i) {
+    AddMessageLeadingComments(*message.nested_type(i), leading_comments);
+  }
+}
+
+}  // namespace
+
 absl::Status SourceCodeInfoView::Init(
     const google::protobuf::FileDescriptorSet& file_descriptor_set) {
   pool_ = std::make_unique<Pool>();
@@ -31,10 +67,38 @@ absl::Status SourceCodeInfoView::Init(
     return absl::InvalidArgumentError(
         "`file_descriptor_set` contains duplicate files.");
   }
+  pool_->file_names.reserve(file_descriptor_set.file_size());
+  for (const google::protobuf::FileDescriptorProto& file :
+       file_descriptor_set.file()) {
+    pool_->file_names.push_back(file.name());
+  }
 
   return absl::OkStatus();
 }
 
+const absl::flat_hash_map<std::string, std::string>&
+SourceCodeInfoView::LeadingComments() const {
+  absl::call_once(pool_->leading_comments_once, [pool = pool_.get()]() {
+    for (const std::string& file_name : pool->file_names) {
+      const google::protobuf::FileDescriptor* file =
+          pool->descriptor_pool.FindFileByName(file_name);
+      if (file == nullptr) {
+        // The file cannot be built, for example because an import is
+        // missing. Lookups report it.
+        continue;
+      }
+      for (int i = 0; i < file->message_type_count(); ++i) {
+        AddMessageLeadingComments(*file->message_type(i),
+                                  pool->leading_comments);
+      }
+      for (int i = 0; i < file->extension_count(); ++i) {
+        AddLeadingComments(*file->extension(i), pool->leading_comments);
+      }
+    }
+  });
+  return pool_->leading_comments;
+}
+
 absl::Status SourceCodeInfoView::InitStrict(
     const google::protobuf::FileDescriptorSet& file_descriptor_set) {
   for (const google::protobuf::FileDescriptorProto& file :
@@ -54,6 +118,12 @@ absl::StatusOr<std::string> SourceCodeInfoView::GetLeadingCommentsByMessageType(
     return absl::FailedPreconditionError("SourceCodeInfoView not Init()ed.");
   }
 
+  if (auto it = LeadingComments().find(message_name);
+      it != LeadingComments().end()) {
+    return it->second;
+  }
+
+  // Not indexed, find out why.
   const google::protobuf::Descriptor* const message =
       // Need the std::string(.) conversion here because the external version of
       // the function does not have a version that takes absl::string_view.
@@ -79,6 +149,12 @@ absl::StatusOr<std::string> SourceCodeInfoView::GetLeadingCommentsByFieldName(
     return absl::FailedPreconditionError("SourceCodeInfoView not Init()ed.");
   }
 
+  if (auto it = LeadingComments().find(field_name);
+      it != LeadingComments().end()) {
+    return it->second;
+  }
+
+  // Not indexed, find out why.
   const google::protobuf::FieldDescriptor* const field =
       // Need the std::string(.) conversion here because the external version of
       // the function does not have a version that takes absl::string_view.
@@ -98,6 +174,18 @@ absl::StatusOr<std::string> SourceCodeInfoView::GetLeadingCommentsByFieldName(
   return source_location.leading_comments;
 }
 
+absl::StatusOr<google::protobuf::Map<std::string, std::string>>
+SourceCodeInfoView::GetAllLeadingComments() const {
+  if (pool_ == nullptr) {
+    return absl::FailedPreconditionError("SourceCodeInfoView not Init()ed.");
+  }
+
+  const absl::flat_hash_map<std::string, std::string>& leading_comments =
+      LeadingComments();
+  return google::protobuf::Map<std::string, std::string>(
+      leading_comments.begin(), leading_comments.end());
+}
+
 absl::StatusOr<google::protobuf::Map<std::string, std::string>>
 SourceCodeInfoView::GetNestedFieldCommentMap(absl::string_view message_name) {
   if (pool_ == nullptr) {
@@ -5,7 +5,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "absl/base/call_once.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -55,6 +57,9 @@ class SourceCodeInfoView {
   // Retrieves the leading comments for a field, specified by the full name of
   // the field. Returns an error if the field does not exist, or the
   // corresponding FileDescriptorProto does not contain `source_code_info`.
+  //
+  // The first lookup indexes the comments of all messages and fields, so that
+  // later ones are constant time.
   absl::StatusOr<std::string> GetLeadingCommentsByFieldName(
       absl::string_view field_name) const;
 
@@ -64,6 +69,12 @@ class SourceCodeInfoView {
   absl::StatusOr<std::string> GetLeadingCommentsByMessageType(
       absl::string_view message_name) const;
 
+  // Retrieves the leading comments of all messages and fields, including
+  // nested ones and extensions, of all files that contain `source_code_info`.
+  // The keys of the map are the full names of the messages and fields.
+  absl::StatusOr<google::protobuf::Map<std::string, std::string>>
+  GetAllLeadingComments() const;
+
   // Retrieves all field comments and message comments of the given message and
   // all of its nested submessages. They keys of the map are the full name of
   // the message or field that the comment applies to, the value is the comment.
@@ -79,8 +90,17 @@ class SourceCodeInfoView {
     Pool() : descriptor_pool(&descriptor_database) {}
     google::protobuf::SimpleDescriptorDatabase descriptor_database;
     google::protobuf::DescriptorPool descriptor_pool;
+    std::vector<std::string> file_names;
+
+    // Leading comments by full name of message or field, for those that have
+    // a source location. Built on first use.
+    absl::once_flag leading_comments_once;
+    absl::flat_hash_map<std::string, std::string> leading_comments;
   };
 
+  // Returns the index of leading comments, building it if needed.
+  const absl::flat_hash_map<std::string, std::string>& LeadingComments() const;
+
   std::unique_ptr<Pool> pool_;
 };
 
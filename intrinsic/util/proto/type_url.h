@@ -32,10 +32,37 @@ inline std::string_view StripTypeUrlPrefix(
   return type_url.substr(pos + 1);
 }
 
+// Returns the type URL of message type M, e.g.,
+// "type.googleapis.com/google.protobuf.Int64Value". The URL is built once per
+// type and lives until the end of the program, so that code which handles
+// many Any protos does not allocate a string per message.
+template <typename M, typename = std::enable_if_t<
+                          std::is_base_of_v<google::protobuf::Message, M>>>
+std::string_view TypeUrl() {
+  static const std::string* const kTypeUrl =
+      new std::string(AddTypeUrlPrefix(M::descriptor()->full_name()));
+  return *kTypeUrl;
+}
+
+// Returns true if `type_url` names message type M, with any prefix, like
+// google::protobuf::Any::Is<M>(). URLs with the default prefix, which are the
+// common case, take a single comparison with TypeUrl<M>().
+template <typename M, typename = std::enable_if_t<
+                          std::is_base_of_v<google::protobuf::Message, M>>>
+bool IsTypeUrlOf(std::string_view type_url) {
+  if (type_url == TypeUrl<M>()) {
+    return true;
+  }
+  const std::string_view full_name = M::descriptor()->full_name();
+  return type_url.size() > full_name.size() &&
+         type_url.ends_with(full_name) &&
+         type_url[type_url.size() - full_name.size() - 1] == kTypeUrlSeparator;
+}
+
 template <typename M, typename = std::enable_if_t<
                           std::is_base_of_v<google::protobuf::Message, M>>>
 inline std::string AddTypeUrlPrefix() {
-  return AddTypeUrlPrefix(M::descriptor()->full_name());
+  return std::string(TypeUrl<M>());
 }
 
 inline std::string AddTypeUrlPrefix(const google::protobuf::Message& m) {
@@ -5,6 +5,7 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <string_view>
 
 #include "google/protobuf/wrappers.pb.h"
 
@@ -41,6 +42,25 @@ TEST(TypeUrl, AddPrefixMessagePointer) {
             "type.googleapis.com/google.protobuf.Int64Value");
 }
 
+TEST(TypeUrl, TypeUrlIsStable) {
+  const std::string_view type_url = TypeUrl<google::protobuf::Int64Value>();
+  EXPECT_EQ(type_url, "type.googleapis.com/google.protobuf.Int64Value");
+  EXPECT_EQ(TypeUrl<google::protobuf::Int64Value>().data(), type_url.data());
+}
+
+TEST(TypeUrl, IsTypeUrlOf) {
+  EXPECT_TRUE(IsTypeUrlOf<google::protobuf::Int64Value>(
+      "type.googleapis.com/google.protobuf.Int64Value"));
+  EXPECT_TRUE(IsTypeUrlOf<google::protobuf::Int64Value>(
+      "example.com/types/google.protobuf.Int64Value"));
+  EXPECT_FALSE(IsTypeUrlOf<google::protobuf::Int64Value>(
+      "type.googleapis.com/google.protobuf.Int32Value"));
+  EXPECT_FALSE(IsTypeUrlOf<google::protobuf::Int64Value>(
+      "type.googleapis.com/other.google.protobuf.Int64Value"));
+  EXPECT_FALSE(IsTypeUrlOf<google::protobuf::Int64Value>(
+      "google.protobuf.Int64Value"));
+}
+
 TEST(TypeUrl, StripPrefix) {
   EXPECT_EQ(
       StripTypeUrlPrefix("type.googleapis.com/google.protobuf.Int64Value"),
@@ -5,12 +5,15 @@
 #include <algorithm>
 #include <cstdint>
 #include <ctime>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "google/protobuf/repeated_ptr_field.h"
 
 namespace intrinsic {
 
@@ -60,21 +63,35 @@ absl::Status Validate(const google::protobuf::Timestamp& timestamp) {
   return status;
 }
 
-void ToProtoNoValidation(absl::Time time,
-                         google::protobuf::Timestamp* timestamp) {
-  const int64_t s = absl::ToUnixSeconds(time);
-  timestamp->set_seconds(s);
-  timestamp->set_nanos((time - absl::FromUnixSeconds(s)) /
-                       absl::Nanoseconds(1));
-}
-
 }  // namespace
 
 absl::Status ToProto(absl::Time time, google::protobuf::Timestamp* timestamp) {
-  ToProtoNoValidation(time, timestamp);
+  ToProtoUnchecked(time, timestamp);
   return Validate(*timestamp);
 }
 
+absl::Status ToProto(
+    absl::Span<const absl::Time> times,
+    google::protobuf::RepeatedPtrField<google::protobuf::Timestamp>*
+        timestamps) {
+  if (times.empty()) {
+    return absl::OkStatus();
+  }
+  // The range is contiguous, so the batch is valid if its extremes are.
+  const auto [min_time, max_time] =
+      std::minmax_element(times.begin(), times.end());
+  google::protobuf::Timestamp extreme;
+  absl::Status status = ToProto(*min_time, &extreme);
+  if (!status.ok()) return status;
+  status = ToProto(*max_time, &extreme);
+  if (!status.ok()) return status;
+  timestamps->Reserve(timestamps->size() + times.size());
+  for (absl::Time time : times) {
+    ToProtoUnchecked(time, timestamps->Add());
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<google::protobuf::Timestamp> ToProto(absl::Time time) {
   google::protobuf::Timestamp timestamp;
   auto status = ToProto(time, &timestamp);
@@ -88,15 +105,29 @@ google::protobuf::Timestamp ToProtoClampToValidRange(absl::Time time) {
   time = std::clamp(time, absl::TimeFromTimespec(kMinProtoTimestamp),
                     absl::TimeFromTimespec(kMaxProtoTimestamp));
   google::protobuf::Timestamp out;
-  ToProtoNoValidation(time, &out);
+  ToProtoUnchecked(time, &out);
   return out;
 }
 
 absl::StatusOr<absl::Time> FromProto(const google::protobuf::Timestamp& proto) {
   absl::Status status = Validate(proto);
   if (!status.ok()) return status;
-  return absl::FromUnixSeconds(proto.seconds()) +
-         absl::Nanoseconds(proto.nanos());
+  return FromProtoUnchecked(proto);
+}
+
+absl::Status FromProto(
+    const google::protobuf::RepeatedPtrField<google::protobuf::Timestamp>&
+        timestamps,
+    std::vector<absl::Time>* times) {
+  for (const google::protobuf::Timestamp& timestamp : timestamps) {
+    absl::Status status = Validate(timestamp);
+    if (!status.ok()) return status;
+  }
+  times->reserve(times->size() + timestamps.size());
+  for (const google::protobuf::Timestamp& timestamp : timestamps) {
+    times->push_back(FromProtoUnchecked(timestamp));
+  }
+  return absl::OkStatus();
 }
 
 absl::Duration FromProto(const google::protobuf::Duration& proto) {
@@ -104,11 +135,9 @@ absl::Duration FromProto(const google::protobuf::Duration& proto) {
 }
 
 google::protobuf::Timestamp GetCurrentTimeProto() {
-  auto time_or = ToProto(absl::Now());
-  if (!time_or.ok()) {
-    return google::protobuf::Timestamp();
-  }
-  return *time_or;
+  google::protobuf::Timestamp now;
+  ToProtoUnchecked(absl::Now(), &now);
+  return now;
 }
 
 absl::StatusOr<google::protobuf::Duration> ToProto(absl::Duration d) {
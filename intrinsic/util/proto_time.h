@@ -3,10 +3,15 @@
 #ifndef INTRINSIC_UTIL_PROTO_TIME_H_
 #define INTRINSIC_UTIL_PROTO_TIME_H_
 
+#include <cstdint>
+#include <vector>
+
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "google/protobuf/duration.pb.h"
+#include "google/protobuf/repeated_ptr_field.h"
 #include "google/protobuf/timestamp.pb.h"
 
 namespace intrinsic {
@@ -17,6 +22,29 @@ namespace intrinsic {
 absl::Status ToProto(absl::Time time, google::protobuf::Timestamp* timestamp);
 absl::StatusOr<google::protobuf::Timestamp> ToProto(absl::Time time);
 
+// Like ToProto(), but without checking that `time` is in the range of
+// google::protobuf::Timestamp. Only for times known to be valid, such as
+// absl::Now(); out of range times give invalid timestamps. Writes into
+// `timestamp`, so that hot paths, e.g., timestamping every published message,
+// do not construct a StatusOr.
+inline void ToProtoUnchecked(absl::Time time,
+                             google::protobuf::Timestamp* timestamp) {
+  const int64_t seconds = absl::ToUnixSeconds(time);
+  timestamp->set_seconds(seconds);
+  timestamp->set_nanos(static_cast<int32_t>(
+      (time - absl::FromUnixSeconds(seconds)) / absl::Nanoseconds(1)));
+}
+
+// Converts all of `times` and appends them to `timestamps`, e.g., for the
+// timestamps of a batch of log items. The range is checked once for the
+// whole batch.
+//
+// Returns an error, and leaves `timestamps` unchanged, if any time is invalid.
+absl::Status ToProto(
+    absl::Span<const absl::Time> times,
+    google::protobuf::RepeatedPtrField<google::protobuf::Timestamp>*
+        timestamps);
+
 // Converts an absl:Time to a google::protobuf::Timestamp, clamping to the valid
 // time range allowed in `protobuf/timestamp.proto`. This allows
 // absl::InfiniteFuture() and absl::InfinitePast() to be used. Note that
@@ -29,6 +57,21 @@ google::protobuf::Timestamp ToProtoClampToValidRange(absl::Time time);
 // Returns an error if the timestamp given is invalid.
 absl::StatusOr<absl::Time> FromProto(const google::protobuf::Timestamp& proto);
 
+// Like FromProto(), but without checking that `proto` is valid. Only for
+// timestamps known to be valid, e.g., ones written by ToProto().
+inline absl::Time FromProtoUnchecked(const google::protobuf::Timestamp& proto) {
+  return absl::FromUnixSeconds(proto.seconds()) +
+         absl::Nanoseconds(proto.nanos());
+}
+
+// Converts all of `timestamps` and appends them to `times`.
+//
+// Returns an error, and leaves `times` unchanged, if any timestamp is invalid.
+absl::Status FromProto(
+    const google::protobuf::RepeatedPtrField<google::protobuf::Timestamp>&
+        timestamps,
+    std::vector<absl::Time>* times);
+
 // Converts a google::protobuf::Duration to its equivalent absl::Duration.
 absl::Duration FromProto(const google::protobuf::Duration& proto);
 
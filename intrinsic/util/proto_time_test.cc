@@ -0,0 +1,62 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/proto_time.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "google/protobuf/repeated_ptr_field.h"
+#include "google/protobuf/timestamp.pb.h"
+
+namespace intrinsic {
+namespace {
+
+TEST(ProtoTimeTest, UncheckedConversionsMatchCheckedOnes) {
+  for (absl::Time time :
+       {absl::UnixEpoch(), absl::FromUnixNanos(1'700'000'000'123'456'789),
+        absl::FromUnixNanos(-1)}) {
+    google::protobuf::Timestamp checked;
+    ASSERT_TRUE(ToProto(time, &checked).ok());
+    google::protobuf::Timestamp unchecked;
+    ToProtoUnchecked(time, &unchecked);
+    EXPECT_EQ(unchecked.seconds(), checked.seconds());
+    EXPECT_EQ(unchecked.nanos(), checked.nanos());
+    EXPECT_EQ(FromProtoUnchecked(unchecked), time);
+  }
+}
+
+TEST(ProtoTimeTest, ConvertsBatches) {
+  const std::vector<absl::Time> times = {absl::FromUnixSeconds(2),
+                                         absl::FromUnixMillis(1500),
+                                         absl::FromUnixSeconds(3)};
+  google::protobuf::RepeatedPtrField<google::protobuf::Timestamp> timestamps;
+  ASSERT_TRUE(ToProto(times, &timestamps).ok());
+  ASSERT_EQ(timestamps.size(), 3);
+  EXPECT_EQ(timestamps[1].seconds(), 1);
+  EXPECT_EQ(timestamps[1].nanos(), 500'000'000);
+
+  std::vector<absl::Time> round_trip;
+  ASSERT_TRUE(FromProto(timestamps, &round_trip).ok());
+  EXPECT_EQ(round_trip, times);
+}
+
+TEST(ProtoTimeTest, RejectsBatchesWithInvalidTimes) {
+  google::protobuf::RepeatedPtrField<google::protobuf::Timestamp> timestamps;
+  EXPECT_EQ(ToProto({absl::UnixEpoch(), absl::InfiniteFuture()}, &timestamps)
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_TRUE(timestamps.empty());
+
+  timestamps.Add()->set_seconds(1);
+  timestamps.Add()->set_nanos(-1);
+  std::vector<absl::Time> times;
+  EXPECT_EQ(FromProto(timestamps, &times).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_TRUE(times.empty());
+}
+
+}  // namespace
+}  // namespace intrinsic
@@ -0,0 +1,25 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/realtime_arena.h"
+
+#include <cstddef>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "absl/types/span.h"
+
+namespace intrinsic {
+
+RealtimeArena::RealtimeArena(size_t capacity)
+    : owned_data_(std::make_unique<std::byte[]>(capacity)),
+      data_(owned_data_.get()),
+      capacity_(capacity) {}
+
+RealtimeArena::RealtimeArena(absl::Span<std::byte> buffer)
+    : data_(buffer.data()), capacity_(buffer.size()) {}
+
+void RealtimeArena::BindToCurrentThread() {
+  owner_ = std::this_thread::get_id();
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,174 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_UTIL_REALTIME_ARENA_H_
+#define INTRINSIC_UTIL_REALTIME_ARENA_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <thread>  // NOLINT(build/c++11)
+#include <type_traits>
+
+#include "absl/log/log.h"
+#include "absl/types/span.h"
+#include "intrinsic/icon/testing/realtime_annotations.h"
+
+namespace intrinsic {
+
+// A preallocated, monotonic memory arena for variable-size containers in
+// real-time code, e.g. maps and strings that are rebuilt every cycle.
+//
+// Allocation bumps a pointer and deallocation does nothing. Reset() frees all
+// allocations at once, typically at the start of each cycle:
+//
+//   RealtimeArena arena(64 << 10);
+//   arena.BindToCurrentThread();
+//   while (running) {
+//     arena.Reset();
+//     std::pmr::map<int, std::pmr::string> names(&arena);
+//     names.emplace(1, "joint_1");
+//     std::vector<double, RealtimeArenaAllocator<double>> values(
+//         RealtimeArenaAllocator<double>(arena));
+//     ...
+//   }
+//
+// The arena is a std::pmr::memory_resource, for std::pmr containers, and
+// RealtimeArenaAllocator is a plain STL allocator without virtual calls. For
+// protos, carve the initial block of a google::protobuf::Arena out of the
+// arena with TryAllocate(), and set ArenaOptions::max_block_size so that the
+// proto arena does not fall back to malloc.
+//
+// Like FixedVector, the arena fails a runtime assert instead of allocating
+// when its capacity is exceeded, so callers must size it for the worst cycle.
+// high_water_mark() helps with that.
+//
+// Not thread safe. The arena belongs to one thread at a time; once bound with
+// BindToCurrentThread(), allocating from another thread fails an assert.
+class RealtimeArena final : public std::pmr::memory_resource {
+ public:
+  // Not real-time safe. Allocates `capacity` bytes up front.
+  explicit RealtimeArena(size_t capacity) INTRINSIC_NON_REALTIME_ONLY;
+
+  // Allocates from `buffer`, which must outlive the arena, e.g. memory of a
+  // LockedArena.
+  explicit RealtimeArena(absl::Span<std::byte> buffer);
+
+  RealtimeArena(const RealtimeArena&) = delete;
+  RealtimeArena& operator=(const RealtimeArena&) = delete;
+
+  // Binds the arena to the calling thread. Allocations from other threads
+  // then fail an assert.
+  void BindToCurrentThread();
+
+  // Real-time safe. Returns `bytes` aligned to `alignment`, which must be a
+  // power of two, or nullptr if the arena is exhausted.
+  void* TryAllocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+      INTRINSIC_CHECK_REALTIME_SAFE {
+    CheckThread();
+    const uintptr_t begin =
+        (reinterpret_cast<uintptr_t>(data_) + used_ + alignment - 1) &
+        ~(alignment - 1);
+    const size_t offset = begin - reinterpret_cast<uintptr_t>(data_);
+    if (offset > capacity_ || bytes > capacity_ - offset) {
+      return nullptr;
+    }
+    used_ = offset + bytes;
+    high_water_mark_ = std::max(high_water_mark_, used_);
+    return data_ + offset;
+  }
+
+  // Real-time safe. Frees all allocations. Containers that use the arena
+  // must not be accessed afterwards.
+  void Reset() INTRINSIC_CHECK_REALTIME_SAFE { used_ = 0; }
+
+  size_t capacity() const { return capacity_; }
+  size_t used() const { return used_; }
+  // The largest `used()` since construction.
+  size_t high_water_mark() const { return high_water_mark_; }
+
+ private:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    void* result = TryAllocate(bytes, alignment);
+    if (result == nullptr) {
+      LOG(FATAL) << "[RealtimeArena] Out of memory allocating " << bytes
+                 << " bytes, " << used_ << " of " << capacity_
+                 << " bytes are used";
+    }
+    return result;
+  }
+
+  void do_deallocate(void*, size_t, size_t) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const
+      noexcept override {
+    return this == &other;
+  }
+
+  void CheckThread() const {
+    if (owner_ != std::thread::id() &&
+        owner_ != std::this_thread::get_id()) [[unlikely]] {
+      LOG(FATAL) << "[RealtimeArena] Allocating from a thread the arena is "
+                    "not bound to";
+    }
+  }
+
+  std::unique_ptr<std::byte[]> owned_data_;
+  std::byte* const data_;
+  const size_t capacity_;
+  size_t used_ = 0;
+  size_t high_water_mark_ = 0;
+  std::thread::id owner_;
+};
+
+// An STL allocator that allocates from a RealtimeArena. Unlike
+// std::pmr::polymorphic_allocator, it does not call through a virtual
+// function.
+template <typename T>
+class RealtimeArenaAllocator {
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using is_always_equal = std::false_type;
+  using propagate_on_container_swap = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_copy_assignment = std::true_type;
+
+  explicit RealtimeArenaAllocator(RealtimeArena& arena) : arena_(&arena) {}
+
+  template <typename U>
+  RealtimeArenaAllocator(  // NOLINT(google-explicit-constructor)
+      const RealtimeArenaAllocator<U>& other)
+      : arena_(other.arena()) {}
+
+  T* allocate(size_type n) {
+    void* result = arena_->TryAllocate(n * sizeof(T), alignof(T));
+    if (result == nullptr) {
+      LOG(FATAL) << "[RealtimeArenaAllocator] Out of memory allocating " << n
+                 << " elements of " << sizeof(T) << " bytes";
+    }
+    return static_cast<T*>(result);
+  }
+
+  void deallocate(T*, size_type) {}
+
+  RealtimeArena* arena() const { return arena_; }
+
+  template <typename U>
+  bool operator==(const RealtimeArenaAllocator<U>& other) const {
+    return arena_ == other.arena();
+  }
+  template <typename U>
+  bool operator!=(const RealtimeArenaAllocator<U>& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  RealtimeArena* arena_;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_UTIL_REALTIME_ARENA_H_
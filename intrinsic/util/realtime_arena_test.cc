@@ -0,0 +1,83 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/realtime_arena.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic {
+namespace {
+
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+TEST(RealtimeArenaTest, AllocatesAlignedUntilExhausted) {
+  RealtimeArena arena(64);
+  void* first = arena.TryAllocate(1, 1);
+  ASSERT_NE(first, nullptr);
+  void* second = arena.TryAllocate(8, 16);
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % 16, 0);
+  EXPECT_EQ(arena.TryAllocate(64, 1), nullptr);
+  EXPECT_LE(arena.used(), arena.capacity());
+}
+
+TEST(RealtimeArenaTest, ResetFreesAllAllocations) {
+  RealtimeArena arena(64);
+  ASSERT_NE(arena.TryAllocate(48, 1), nullptr);
+  EXPECT_EQ(arena.TryAllocate(48, 1), nullptr);
+  arena.Reset();
+  EXPECT_EQ(arena.used(), 0);
+  EXPECT_NE(arena.TryAllocate(48, 1), nullptr);
+  EXPECT_EQ(arena.high_water_mark(), 48);
+}
+
+TEST(RealtimeArenaTest, UsesExternalBuffer) {
+  alignas(std::max_align_t) std::byte buffer[32];
+  RealtimeArena arena{absl::Span<std::byte>(buffer)};
+  EXPECT_EQ(arena.TryAllocate(16, 1), buffer);
+  EXPECT_EQ(arena.capacity(), 32);
+}
+
+TEST(RealtimeArenaTest, WorksAsMemoryResource) {
+  RealtimeArena arena(4096);
+  arena.BindToCurrentThread();
+  std::pmr::map<int, std::pmr::string> names(&arena);
+  names.emplace(1, "a joint name that does not fit into the SSO buffer");
+  names.emplace(2, "j2");
+  EXPECT_THAT(names,
+              UnorderedElementsAre(
+                  Pair(1, "a joint name that does not fit into the SSO buffer"),
+                  Pair(2, "j2")));
+  EXPECT_GT(arena.used(), 0);
+}
+
+TEST(RealtimeArenaTest, WorksAsStlAllocator) {
+  RealtimeArena arena(4096);
+  std::vector<double, RealtimeArenaAllocator<double>> values(
+      RealtimeArenaAllocator<double>{arena});
+  for (int i = 0; i < 100; ++i) {
+    values.push_back(i);
+  }
+  EXPECT_EQ(values.back(), 99);
+  EXPECT_GE(arena.used(), 100 * sizeof(double));
+}
+
+TEST(RealtimeArenaDeathTest, FailsWhenExhausted) {
+  RealtimeArena arena(16);
+  std::pmr::vector<int> values(&arena);
+  EXPECT_DEATH(values.resize(100), "Out of memory");
+}
+
+}  // namespace
+}  // namespace intrinsic
@@ -0,0 +1,102 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/shutdown_coordinator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace intrinsic {
+
+absl::StatusOr<int64_t> ShutdownCoordinator::Register(absl::string_view name,
+                                                      int priority,
+                                                      absl::Duration timeout,
+                                                      DrainFn drain) {
+  if (timeout < absl::ZeroDuration()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Timeout of drain '", name,
+                     "' must not be negative, got ",
+                     absl::FormatDuration(timeout)));
+  }
+  absl::MutexLock lock(&mutex_);
+  if (drain_started_) {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "Cannot register drain '", name, "', shutdown already started"));
+  }
+  const int64_t id = next_id_++;
+  entries_.push_back({.id = id,
+                      .name = std::string(name),
+                      .priority = priority,
+                      .timeout = timeout,
+                      .drain = std::move(drain)});
+  return id;
+}
+
+void ShutdownCoordinator::Unregister(int64_t id) {
+  absl::MutexLock lock(&mutex_);
+  std::erase_if(entries_, [id](const Entry& entry) { return entry.id == id; });
+}
+
+bool ShutdownCoordinator::drain_started() const {
+  absl::MutexLock lock(&mutex_);
+  return drain_started_;
+}
+
+std::vector<DrainResult> ShutdownCoordinator::Drain(absl::Time deadline) {
+  // Holds the lock while draining, so that Unregister() does not destroy a
+  // drain that runs.
+  absl::MutexLock lock(&mutex_);
+  if (drain_started_) {
+    return {};
+  }
+  drain_started_ = true;
+  std::stable_sort(entries_.begin(), entries_.end(),
+                   [](const Entry& lhs, const Entry& rhs) {
+                     return lhs.priority > rhs.priority;
+                   });
+
+  std::vector<DrainResult> results;
+  results.reserve(entries_.size());
+  for (Entry& entry : entries_) {
+    DrainResult& result = results.emplace_back(
+        DrainResult{.name = entry.name, .priority = entry.priority});
+    const absl::Time start = absl::Now();
+    if (start >= deadline) {
+      result.status = absl::DeadlineExceededError(
+          absl::StrCat("Skipped drain '", entry.name,
+                       "', the shutdown deadline has passed"));
+      LOG(WARNING) << result.status;
+      continue;
+    }
+    const absl::Time drain_deadline = std::min(start + entry.timeout, deadline);
+    result.status = entry.drain(drain_deadline);
+    const absl::Time end = absl::Now();
+    result.duration = end - start;
+    if (result.status.ok() && end > drain_deadline) {
+      result.status = absl::DeadlineExceededError(absl::StrCat(
+          "Drain '", entry.name, "' took ", absl::FormatDuration(end - start),
+          ", overrunning its deadline by ",
+          absl::FormatDuration(end - drain_deadline)));
+    }
+    if (!result.status.ok()) {
+      LOG(WARNING) << "Drain '" << entry.name
+                   << "' failed: " << result.status;
+    }
+  }
+  // The drains ran, release what they hold.
+  entries_.clear();
+  return results;
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,106 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_UTIL_SHUTDOWN_COORDINATOR_H_
+#define INTRINSIC_UTIL_SHUTDOWN_COORDINATOR_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace intrinsic {
+
+// Outcome of a single drain of a ShutdownCoordinator.
+struct DrainResult {
+  std::string name;
+  int priority = 0;
+  // The status the drain returned. DeadlineExceededError if it returned after
+  // its deadline, or was skipped because the overall deadline had passed.
+  absl::Status status;
+  // Time the drain took, zero if it was skipped.
+  absl::Duration duration;
+};
+
+// Flushes in-flight work, e.g. queued async logs or pubsub messages, when a
+// process shuts down, with bounded latency.
+//
+// Components register drains, each with a priority and a timeout. Drain()
+// runs them by decreasing priority, in registration order for equal
+// priorities. Each drain gets a deadline, the earlier of its own timeout and
+// the overall deadline, and must return by then; drains are cooperative and
+// are not interrupted. Drains that would start after the overall deadline are
+// skipped, so a process does not block far longer than its shutdown timeout:
+//
+//   ShutdownCoordinator coordinator;
+//   INTR_RETURN_IF_ERROR(coordinator.Register(
+//       "log_flush", ShutdownCoordinator::kFlushLogs, absl::Milliseconds(500),
+//       [&logger](absl::Time deadline) { return logger.Flush(deadline); }));
+//   ...
+//   coordinator.Drain(absl::Now() + absl::Seconds(2));
+//
+// RegisterSignalHandlerAndWait() runs the drains of ShutdownParams::drains
+// once the gRPC server has shut down.
+//
+// Thread safe. Drains must not call Register() or Unregister().
+class ShutdownCoordinator {
+ public:
+  // Flushes the work it is given before its deadline.
+  using DrainFn = absl::AnyInvocable<absl::Status(absl::Time deadline)>;
+
+  // Suggested priorities, in the order the drains should run.
+  // Stops accepting new work, e.g. new requests or subscriptions.
+  static constexpr int kStopAcceptingWork = 300;
+  // Finishes or flushes queued work, e.g. outgoing pubsub messages.
+  static constexpr int kFlushQueues = 200;
+  // Flushes logs, last, so that the other drains can still log.
+  static constexpr int kFlushLogs = 100;
+
+  ShutdownCoordinator() = default;
+  ShutdownCoordinator(const ShutdownCoordinator&) = delete;
+  ShutdownCoordinator& operator=(const ShutdownCoordinator&) = delete;
+
+  // Registers `drain` under `name`, and returns an id for Unregister().
+  //
+  // Returns InvalidArgumentError if `timeout` is negative, and
+  // FailedPreconditionError if Drain() was called already.
+  absl::StatusOr<int64_t> Register(absl::string_view name, int priority,
+                                   absl::Duration timeout, DrainFn drain);
+
+  // Removes the drain with `id`, e.g. when the component it flushes is
+  // destroyed before shutdown. Waits for Drain() if it is running. Has no
+  // effect if there is no such drain.
+  void Unregister(int64_t id);
+
+  // Runs the registered drains, see the class comment, and logs drains that
+  // failed or overran. Only the first call runs the drains; later calls
+  // return an empty vector.
+  std::vector<DrainResult> Drain(absl::Time deadline = absl::InfiniteFuture());
+
+  // Returns true once Drain() was called.
+  bool drain_started() const;
+
+ private:
+  struct Entry {
+    int64_t id;
+    std::string name;
+    int priority;
+    absl::Duration timeout;
+    DrainFn drain;
+  };
+
+  mutable absl::Mutex mutex_;
+  std::vector<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  int64_t next_id_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool drain_started_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_UTIL_SHUTDOWN_COORDINATOR_H_
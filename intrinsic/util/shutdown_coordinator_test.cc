@@ -0,0 +1,121 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/shutdown_coordinator.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+
+namespace intrinsic {
+namespace {
+
+using ::intrinsic::testing::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::SizeIs;
+
+TEST(ShutdownCoordinatorTest, RunsDrainsByPriority) {
+  ShutdownCoordinator coordinator;
+  std::vector<std::string> order;
+  auto record = [&order](std::string name) {
+    return [&order, name](absl::Time) {
+      order.push_back(name);
+      return absl::OkStatus();
+    };
+  };
+  ASSERT_OK(coordinator.Register("logs", ShutdownCoordinator::kFlushLogs,
+                                 absl::Seconds(1), record("logs")));
+  ASSERT_OK(coordinator.Register("rpc", ShutdownCoordinator::kStopAcceptingWork,
+                                 absl::Seconds(1), record("rpc")));
+  ASSERT_OK(coordinator.Register("pubsub", ShutdownCoordinator::kFlushQueues,
+                                 absl::Seconds(1), record("pubsub")));
+  ASSERT_OK(coordinator.Register("queue", ShutdownCoordinator::kFlushQueues,
+                                 absl::Seconds(1), record("queue")));
+
+  std::vector<DrainResult> results = coordinator.Drain();
+  EXPECT_THAT(order, ElementsAre("rpc", "pubsub", "queue", "logs"));
+  ASSERT_THAT(results, SizeIs(4));
+  for (const DrainResult& result : results) {
+    EXPECT_OK(result.status);
+  }
+  EXPECT_THAT(coordinator.Drain(), IsEmpty());
+}
+
+TEST(ShutdownCoordinatorTest, PassesTheEarlierDeadline) {
+  ShutdownCoordinator coordinator;
+  absl::Time short_deadline;
+  absl::Time long_deadline;
+  ASSERT_OK(coordinator.Register("short", 1, absl::Milliseconds(10),
+                                 [&](absl::Time deadline) {
+                                   short_deadline = deadline;
+                                   return absl::OkStatus();
+                                 }));
+  ASSERT_OK(coordinator.Register("long", 0, absl::Hours(1),
+                                 [&](absl::Time deadline) {
+                                   long_deadline = deadline;
+                                   return absl::OkStatus();
+                                 }));
+  const absl::Time overall_deadline = absl::Now() + absl::Seconds(10);
+  coordinator.Drain(overall_deadline);
+  EXPECT_LT(short_deadline, overall_deadline);
+  EXPECT_EQ(long_deadline, overall_deadline);
+}
+
+TEST(ShutdownCoordinatorTest, ReportsOverrunsAndSkipsAfterDeadline) {
+  ShutdownCoordinator coordinator;
+  bool late_drain_ran = false;
+  ASSERT_OK(coordinator.Register("slow", 1, absl::Milliseconds(1),
+                                 [](absl::Time deadline) {
+                                   absl::SleepFor(absl::Milliseconds(20));
+                                   return absl::OkStatus();
+                                 }));
+  ASSERT_OK(coordinator.Register("late", 0, absl::Seconds(1),
+                                 [&late_drain_ran](absl::Time) {
+                                   late_drain_ran = true;
+                                   return absl::OkStatus();
+                                 }));
+  std::vector<DrainResult> results =
+      coordinator.Drain(absl::Now() + absl::Milliseconds(10));
+  ASSERT_THAT(results, SizeIs(2));
+  EXPECT_THAT(results[0].status,
+              StatusIs(absl::StatusCode::kDeadlineExceeded));
+  EXPECT_THAT(results[1].status,
+              StatusIs(absl::StatusCode::kDeadlineExceeded));
+  EXPECT_FALSE(late_drain_ran);
+}
+
+TEST(ShutdownCoordinatorTest, UnregisteredDrainsDoNotRun) {
+  ShutdownCoordinator coordinator;
+  bool ran = false;
+  ASSERT_OK_AND_ASSIGN(int64_t id,
+                       coordinator.Register("drain", 0, absl::Seconds(1),
+                                            [&ran](absl::Time) {
+                                              ran = true;
+                                              return absl::OkStatus();
+                                            }));
+  coordinator.Unregister(id);
+  EXPECT_THAT(coordinator.Drain(), IsEmpty());
+  EXPECT_FALSE(ran);
+}
+
+TEST(ShutdownCoordinatorTest, RejectsRegistrationAfterDrain) {
+  ShutdownCoordinator coordinator;
+  coordinator.Drain();
+  EXPECT_TRUE(coordinator.drain_started());
+  EXPECT_THAT(coordinator.Register("drain", 0, absl::Seconds(1),
+                                   [](absl::Time) { return absl::OkStatus(); }),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  EXPECT_THAT(coordinator.Register("drain", 0, -absl::Seconds(1),
+                                   [](absl::Time) { return absl::OkStatus(); }),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace intrinsic
@@ -53,13 +53,10 @@ std::string GetSymbolizedStackTraceAsString(int max_depth = 50,
 }  // namespace
 
 StatusBuilder::Rep::Rep(const Rep& r)
-    : logging_mode(r.logging_mode),
-      log_severity(r.log_severity),
-      n(r.n),
+    : n(r.n),
       period(r.period),
       stream(r.stream.str()),
       should_log_stack_trace(r.should_log_stack_trace),
-      message_join_style(r.message_join_style),
       sink(r.sink) {}
 
 absl::Status StatusBuilder::JoinMessageToStatus(absl::Status s,
@@ -80,16 +77,16 @@ absl::Status StatusBuilder::JoinMessageToStatus(absl::Status s,
 }
 
 void StatusBuilder::ConditionallyLog(const absl::Status& status) const {
-  if (rep_->logging_mode == Rep::LoggingMode::kDisabled) {
+  if (logging_mode_ == LoggingMode::kDisabled) {
     return;
   }
 
-  absl::LogSeverity severity = rep_->log_severity;
-  switch (rep_->logging_mode) {
-    case Rep::LoggingMode::kDisabled:
-    case Rep::LoggingMode::kLog:
+  absl::LogSeverity severity = log_severity_;
+  switch (logging_mode_) {
+    case LoggingMode::kDisabled:
+    case LoggingMode::kLog:
       break;
-    case Rep::LoggingMode::kLogEveryN: {
+    case LoggingMode::kLogEveryN: {
       struct LogSites {
         absl::Mutex mutex;
         absl::flat_hash_map<std::pair<const void*, uint>, uint>
@@ -108,7 +105,7 @@ void StatusBuilder::ConditionallyLog(const absl::Status& status) const {
       }
       break;
     }
-    case Rep::LoggingMode::kLogEveryPeriod: {
+    case LoggingMode::kLogEveryPeriod: {
       struct LogSites {
         absl::Mutex mutex;
         absl::flat_hash_map<std::pair<const void*, uint>, absl::Time>
@@ -129,9 +126,10 @@ void StatusBuilder::ConditionallyLog(const absl::Status& status) const {
     }
   }
 
-  absl::LogSink* const sink = rep_->sink;
+  // Log() and the message join style do not create `rep_`.
+  absl::LogSink* const sink = rep_ != nullptr ? rep_->sink : nullptr;
   const std::string maybe_stack_trace =
-      rep_->should_log_stack_trace
+      rep_ != nullptr && rep_->should_log_stack_trace
           ? absl::StrCat("\n", GetSymbolizedStackTraceAsString(
                                    /*max_depth=*/50, /*skip_count=*/1))
           : "";
@@ -192,14 +190,18 @@ absl::Status StatusBuilder::AnnotateStatus(const absl::Status& s,
 }
 
 absl::Status StatusBuilder::CreateStatusAndConditionallyLog() && {
-  absl::Status result = JoinMessageToStatus(
-      std::move(status_), rep_->stream.str(), rep_->message_join_style);
+  absl::Status result =
+      rep_ == nullptr
+          ? std::move(status_)
+          : JoinMessageToStatus(std::move(status_), rep_->stream.str(),
+                                message_join_style_);
 
   ConditionallyLog(result);
 
   // We consumed the status above, we set it to some error just to prevent
   // people relying on it become OK or something.
   status_ = absl::UnknownError("");
+  logging_mode_ = LoggingMode::kDisabled;
   rep_ = nullptr;
   return result;
 }
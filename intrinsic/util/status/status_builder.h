@@ -259,12 +259,19 @@ class ABSL_MUST_USE_RESULT StatusBuilder {
  private:
   // Specifies how to join the error message in the original status and any
   // additional message that has been streamed into the builder.
-  enum class MessageJoinStyle {
+  enum class MessageJoinStyle : uint8_t {
     kAnnotate,
     kAppend,
     kPrepend,
   };
 
+  enum class LoggingMode : uint8_t {
+    kDisabled,
+    kLog,
+    kLogEveryN,
+    kLogEveryPeriod,
+  };
+
   // Creates a new status based on an old one by joining the message from the
   // original to an additional message.
   static absl::Status JoinMessageToStatus(absl::Status s, std::string_view msg,
@@ -316,47 +323,54 @@ class ABSL_MUST_USE_RESULT StatusBuilder {
   // This is primarily an issue for debug builds, which do not necessarily
   // re-use stack space within a function across the sub-scopes used by
   // status macros.
+  //
+  // The options that fit into the padding of the builder (logging mode,
+  // severity and join style) are kept inline instead, so that propagating an
+  // error with Log*(), SetAppend() or SetPrepend() does not allocate either.
   struct Rep {
     explicit Rep() = default;
     Rep(const Rep& r);
 
-    enum class LoggingMode { kDisabled, kLog, kLogEveryN, kLogEveryPeriod };
-    LoggingMode logging_mode = LoggingMode::kDisabled;
-
-    // Corresponds to the levels in `absl::LogSeverity`.
-    absl::LogSeverity log_severity;
-
     // Only log every N invocations.
-    // Only used when `logging_mode == LoggingMode::kLogEveryN`.
+    // Only used when `logging_mode_ == LoggingMode::kLogEveryN`.
     int n;
 
     // Only log once per period.
-    // Only used when `logging_mode == LoggingMode::kLogEveryPeriod`.
+    // Only used when `logging_mode_ == LoggingMode::kLogEveryPeriod`.
     absl::Duration period;
 
     // Gathers additional messages added with `<<` for use in the final status.
     std::ostringstream stream;
 
-    // Whether to log stack trace.  Only used when `logging_mode !=
+    // Whether to log stack trace.  Only used when `logging_mode_ !=
     // LoggingMode::kDisabled`.
     bool should_log_stack_trace = false;
 
-    // Specifies how to join the message in `status_` and `stream`.
-    MessageJoinStyle message_join_style = MessageJoinStyle::kAnnotate;
-
     // If not nullptr, specifies the log sink where log output should be also
-    // sent to.  Only used when `logging_mode != LoggingMode::kDisabled`.
+    // sent to.  Only used when `logging_mode_ != LoggingMode::kDisabled`.
     absl::LogSink* sink = nullptr;
   };
 
+  // Returns `rep_`, creating it if needed.
+  Rep& MutableRep();
+
   // The status that the result will be based on.
   absl::Status status_;
 
   // The location to record if this status is logged.
   intrinsic::SourceLocation loc_;
 
-  // nullptr if the result status will be OK.  Extra fields moved to the heap to
-  // minimize stack space.
+  LoggingMode logging_mode_ = LoggingMode::kDisabled;
+
+  // Specifies how to join the message in `status_` and `rep_->stream`.
+  MessageJoinStyle message_join_style_ = MessageJoinStyle::kAnnotate;
+
+  // Corresponds to the levels in `absl::LogSeverity`.  Only used when
+  // `logging_mode_ != LoggingMode::kDisabled`.
+  absl::LogSeverity log_severity_ = absl::LogSeverity::kInfo;
+
+  // nullptr unless one of the options in `Rep` was set.  Extra fields moved to
+  // the heap to minimize stack space.
   std::unique_ptr<Rep> rep_;
 };
 
@@ -472,7 +486,11 @@ inline StatusBuilder::StatusBuilder(absl::StatusCode code,
     : status_(code, ""), loc_(location) {}
 
 inline StatusBuilder::StatusBuilder(const StatusBuilder& sb)
-    : status_(sb.status_), loc_(sb.loc_) {
+    : status_(sb.status_),
+      loc_(sb.loc_),
+      logging_mode_(sb.logging_mode_),
+      message_join_style_(sb.message_join_style_),
+      log_severity_(sb.log_severity_) {
   if (sb.rep_ != nullptr) {
     rep_ = std::make_unique<Rep>(*sb.rep_);
   }
@@ -481,6 +499,9 @@ inline StatusBuilder::StatusBuilder(const StatusBuilder& sb)
 inline StatusBuilder& StatusBuilder::operator=(const StatusBuilder& sb) {
   status_ = sb.status_;
   loc_ = sb.loc_;
+  logging_mode_ = sb.logging_mode_;
+  message_join_style_ = sb.message_join_style_;
+  log_severity_ = sb.log_severity_;
   if (sb.rep_ != nullptr) {
     rep_ = std::make_unique<Rep>(*sb.rep_);
   } else {
@@ -493,11 +514,7 @@ inline StatusBuilder& StatusBuilder::SetPrepend() & {
   if (status_.ok()) {
     return *this;
   }
-  if (rep_ == nullptr) {
-    rep_ = std::make_unique<Rep>();
-  }
-
-  rep_->message_join_style = MessageJoinStyle::kPrepend;
+  message_join_style_ = MessageJoinStyle::kPrepend;
   return *this;
 }
 
@@ -509,10 +526,7 @@ inline StatusBuilder& StatusBuilder::SetAppend() & {
   if (status_.ok()) {
     return *this;
   }
-  if (rep_ == nullptr) {
-    rep_ = std::make_unique<Rep>();
-  }
-  rep_->message_join_style = MessageJoinStyle::kAppend;
+  message_join_style_ = MessageJoinStyle::kAppend;
   return *this;
 }
 
@@ -521,8 +535,8 @@ inline StatusBuilder&& StatusBuilder::SetAppend() && {
 }
 
 inline StatusBuilder& StatusBuilder::SetNoLogging() & {
+  logging_mode_ = LoggingMode::kDisabled;
   if (rep_ != nullptr) {
-    rep_->logging_mode = Rep::LoggingMode::kDisabled;
     rep_->should_log_stack_trace = false;
   }
   return *this;
@@ -536,11 +550,8 @@ inline StatusBuilder& StatusBuilder::Log(absl::LogSeverity level) & {
   if (status_.ok()) {
     return *this;
   }
-  if (rep_ == nullptr) {
-    rep_ = std::make_unique<Rep>();
-  }
-  rep_->logging_mode = Rep::LoggingMode::kLog;
-  rep_->log_severity = level;
+  logging_mode_ = LoggingMode::kLog;
+  log_severity_ = level;
   return *this;
 }
 
@@ -556,12 +567,9 @@ inline StatusBuilder& StatusBuilder::LogEveryN(absl::LogSeverity level,
   if (n < 1) {
     return Log(level);
   }
-  if (rep_ == nullptr) {
-    rep_ = std::make_unique<Rep>();
-  }
-  rep_->logging_mode = Rep::LoggingMode::kLogEveryN;
-  rep_->log_severity = level;
-  rep_->n = n;
+  MutableRep().n = n;
+  logging_mode_ = LoggingMode::kLogEveryN;
+  log_severity_ = level;
   return *this;
 }
 inline StatusBuilder&& StatusBuilder::LogEveryN(absl::LogSeverity level,
@@ -577,12 +585,9 @@ inline StatusBuilder& StatusBuilder::LogEvery(absl::LogSeverity level,
   if (period <= absl::ZeroDuration()) {
     return Log(level);
   }
-  if (rep_ == nullptr) {
-    rep_ = std::make_unique<Rep>();
-  }
-  rep_->logging_mode = Rep::LoggingMode::kLogEveryPeriod;
-  rep_->log_severity = level;
-  rep_->period = period;
+  MutableRep().period = period;
+  logging_mode_ = LoggingMode::kLogEveryPeriod;
+  log_severity_ = level;
   return *this;
 }
 
@@ -595,13 +600,12 @@ inline StatusBuilder& StatusBuilder::EmitStackTrace() & {
   if (status_.ok()) {
     return *this;
   }
-  if (rep_ == nullptr) {
-    rep_ = std::make_unique<Rep>();
+  if (logging_mode_ == LoggingMode::kDisabled) {
     // Default to INFO logging, otherwise nothing would be emitted.
-    rep_->logging_mode = Rep::LoggingMode::kLog;
-    rep_->log_severity = absl::LogSeverity::kInfo;
+    logging_mode_ = LoggingMode::kLog;
+    log_severity_ = absl::LogSeverity::kInfo;
   }
-  rep_->should_log_stack_trace = true;
+  MutableRep().should_log_stack_trace = true;
   return *this;
 }
 
@@ -613,10 +617,7 @@ inline StatusBuilder& StatusBuilder::AlsoOutputToSink(absl::LogSink* sink) & {
   if (status_.ok()) {
     return *this;
   }
-  if (rep_ == nullptr) {
-    rep_ = std::make_unique<Rep>();
-  }
-  rep_->sink = sink;
+  MutableRep().sink = sink;
   return *this;
 }
 inline StatusBuilder&& StatusBuilder::AlsoOutputToSink(absl::LogSink* sink) && {
@@ -628,10 +629,7 @@ StatusBuilder& StatusBuilder::operator<<(const T& value) & {
   if (status_.ok()) {
     return *this;
   }
-  if (rep_ == nullptr) {
-    rep_ = std::make_unique<Rep>();
-  }
-  rep_->stream << value;
+  MutableRep().stream << value;
   return *this;
 }
 
@@ -667,14 +665,14 @@ inline bool StatusBuilder::ok() const { return status_.ok(); }
 inline absl::StatusCode StatusBuilder::code() const { return status_.code(); }
 
 inline StatusBuilder::operator absl::Status() const& {
-  if (rep_ == nullptr) {
+  if (rep_ == nullptr && logging_mode_ == LoggingMode::kDisabled) {
     return status_;
   }
   return StatusBuilder(*this).CreateStatusAndConditionallyLog();
 }
 
 inline StatusBuilder::operator absl::Status() && {
-  if (rep_ == nullptr) {
+  if (rep_ == nullptr && logging_mode_ == LoggingMode::kDisabled) {
     return std::move(status_);
   }
   return std::move(*this).CreateStatusAndConditionallyLog();
@@ -684,6 +682,13 @@ inline intrinsic::SourceLocation StatusBuilder::source_location() const {
   return loc_;
 }
 
+inline StatusBuilder::Rep& StatusBuilder::MutableRep() {
+  if (rep_ == nullptr) {
+    rep_ = std::make_unique<Rep>();
+  }
+  return *rep_;
+}
+
 }  // namespace intrinsic
 
 #endif  // INTRINSIC_UTIL_STATUS_STATUS_BUILDER_H_
@@ -0,0 +1,84 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+// Measures the cost of propagating an error through INTR_RETURN_IF_ERROR and
+// INTR_ASSIGN_OR_RETURN, with and without the common StatusBuilder options.
+//
+// Run with:
+//   bazel run -c opt //intrinsic/util/status:status_macros_benchmark
+
+#include "absl/base/attributes.h"
+#include "absl/base/log_severity.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
+#include "benchmark/benchmark.h"
+#include "intrinsic/util/status/status_macros.h"
+
+namespace intrinsic {
+namespace {
+
+ABSL_ATTRIBUTE_NOINLINE absl::Status Fail(bool fail) {
+  if (fail) {
+    return absl::UnavailableError("Resource is busy");
+  }
+  return absl::OkStatus();
+}
+
+ABSL_ATTRIBUTE_NOINLINE absl::StatusOr<int> FailOr(bool fail) {
+  if (fail) {
+    return absl::UnavailableError("Resource is busy");
+  }
+  return 42;
+}
+
+ABSL_ATTRIBUTE_NOINLINE absl::Status ReturnIfError(bool fail) {
+  INTR_RETURN_IF_ERROR(Fail(fail));
+  return absl::OkStatus();
+}
+
+ABSL_ATTRIBUTE_NOINLINE absl::Status ReturnIfErrorSetAppend(bool fail) {
+  INTR_RETURN_IF_ERROR(Fail(fail)).SetAppend();
+  return absl::OkStatus();
+}
+
+ABSL_ATTRIBUTE_NOINLINE absl::Status ReturnIfErrorLogEveryN(bool fail) {
+  // Logs once per benchmark run, so this measures the builder, not logging.
+  INTR_RETURN_IF_ERROR(Fail(fail))
+      .LogEveryN(absl::LogSeverity::kInfo, 1 << 30);
+  return absl::OkStatus();
+}
+
+ABSL_ATTRIBUTE_NOINLINE absl::Status ReturnIfErrorWithMessage(bool fail) {
+  INTR_RETURN_IF_ERROR(Fail(fail)) << "while retrying";
+  return absl::OkStatus();
+}
+
+ABSL_ATTRIBUTE_NOINLINE absl::Status ReturnIfErrorWithPayload(bool fail) {
+  INTR_RETURN_IF_ERROR(Fail(fail))
+      .SetPayload("type.googleapis.com/intrinsic.Retry", absl::Cord("1"));
+  return absl::OkStatus();
+}
+
+ABSL_ATTRIBUTE_NOINLINE absl::Status AssignOrReturn(bool fail) {
+  INTR_ASSIGN_OR_RETURN(int value, FailOr(fail));
+  benchmark::DoNotOptimize(value);
+  return absl::OkStatus();
+}
+
+template <absl::Status (*kPropagate)(bool)>
+void BM_Propagate(benchmark::State& state) {
+  const bool fail = state.range(0) != 0;
+  for (auto s : state) {
+    absl::Status status = kPropagate(fail);
+    benchmark::DoNotOptimize(status);
+  }
+}
+BENCHMARK(BM_Propagate<ReturnIfError>)->ArgName("fail")->Arg(0)->Arg(1);
+BENCHMARK(BM_Propagate<ReturnIfErrorSetAppend>)->ArgName("fail")->Arg(1);
+BENCHMARK(BM_Propagate<ReturnIfErrorLogEveryN>)->ArgName("fail")->Arg(1);
+BENCHMARK(BM_Propagate<ReturnIfErrorWithMessage>)->ArgName("fail")->Arg(1);
+BENCHMARK(BM_Propagate<ReturnIfErrorWithPayload>)->ArgName("fail")->Arg(1);
+BENCHMARK(BM_Propagate<AssignOrReturn>)->ArgName("fail")->Arg(0)->Arg(1);
+
+}  // namespace
+}  // namespace intrinsic
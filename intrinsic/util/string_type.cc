@@ -0,0 +1,42 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/string_type.h"
+
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/node_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace intrinsic::internal {
+
+namespace {
+
+struct InternTable {
+  absl::Mutex mutex;
+  // A node_hash_set, so that the strings do not move on rehashing.
+  absl::node_hash_set<std::string> strings ABSL_GUARDED_BY(mutex);
+};
+
+InternTable& GetInternTable() {
+  static auto* table = new InternTable();
+  return *table;
+}
+
+}  // namespace
+
+const std::string* InternString(absl::string_view value) {
+  InternTable& table = GetInternTable();
+  {
+    // Most strings are interned already, which only needs a shared lock.
+    absl::ReaderMutexLock lock(&table.mutex);
+    if (auto it = table.strings.find(value); it != table.strings.end()) {
+      return &*it;
+    }
+  }
+  absl::MutexLock lock(&table.mutex);
+  return &*table.strings.emplace(value).first;
+}
+
+}  // namespace intrinsic::internal
@@ -295,6 +295,70 @@ class SharedPtrStringRepresentation {
   std::shared_ptr<const std::string> value_;
 };
 
+namespace internal {
+// Returns the canonical copy of `value` in a global intern table, adding it if
+// needed. The copy is never freed, so that the pointer stays valid for the
+// lifetime of the process. Thread safe.
+const std::string* InternString(absl::string_view value);
+}  // namespace internal
+
+// InternedStringRepresentation holds a pointer into a global, never shrinking
+// table with one copy of every distinct string. Equal strings have equal
+// pointers, so comparing for equality, hashing and copying are as cheap as for
+// a pointer, and no copy allocates. Constructing one looks the string up in
+// the table, which takes a lock and hashes the string.
+//
+// Use it for names out of a bounded set that are compared or looked up far more
+// often than created, e.g., the names of objects and frames. Every distinct
+// string ever interned stays in memory until the process exits, so do not use
+// it for unbounded sets of strings, e.g., generated ids.
+//
+// The order of interned strings is the lexicographic order of their values,
+// like for all other representations. Hashes are not, and differ between
+// processes.
+class InternedStringRepresentation {
+ public:
+  InternedStringRepresentation() = default;
+
+  template <typename T,
+            typename = absl::enable_if_t<
+                std::is_constructible<absl::string_view, T&&>::value>>
+  explicit InternedStringRepresentation(T&& value)
+      : value_(internal::IsNullOrEmpty(value)
+                   ? nullptr
+                   : internal::InternString(std::forward<T>(value))) {}
+
+  const std::string& value() const {
+    if (value_ == nullptr) return internal::GlobalEmptyString();
+    return *value_;
+  }
+
+  bool empty() const { return value_ == nullptr; }
+
+  int compare(const InternedStringRepresentation& other) const {
+    if (value_ == other.value_) return 0;
+    return value().compare(other.value());
+  }
+
+  friend bool operator==(const InternedStringRepresentation& left,
+                         const InternedStringRepresentation& right) {
+    return left.value_ == right.value_;
+  }
+  friend bool operator<(const InternedStringRepresentation& left,
+                        const InternedStringRepresentation& right) {
+    return left.compare(right) < 0;
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const InternedStringRepresentation& s) {
+    return H::combine(std::move(h), s.value_);
+  }
+
+ private:
+  // nullptr for the empty string.
+  const std::string* value_ = nullptr;
+};
+
 }  // namespace intrinsic
 
 #endif  // INTRINSIC_UTIL_STRING_TYPE_H_
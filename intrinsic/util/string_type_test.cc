@@ -0,0 +1,77 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/string_type.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/hash/hash.h"
+#include "absl/strings/str_cat.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+namespace {
+
+INTRINSIC_DEFINE_STRING_TYPE_AS(InternedName,
+                                intrinsic::InternedStringRepresentation);
+
+TEST(InternedStringRepresentationTest, EqualStringsShareOneCopy) {
+  const std::string value = "gripper";
+  InternedName a(value);
+  InternedName b("gripper");
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(&a.value(), &b.value());
+  EXPECT_EQ(a.value(), "gripper");
+  EXPECT_EQ(absl::Hash<InternedName>()(a), absl::Hash<InternedName>()(b));
+  EXPECT_NE(a, InternedName("camera"));
+}
+
+TEST(InternedStringRepresentationTest, Empty) {
+  EXPECT_TRUE(InternedName().empty());
+  EXPECT_TRUE(InternedName("").empty());
+  EXPECT_EQ(InternedName(), InternedName(""));
+  EXPECT_EQ(InternedName().value(), "");
+  EXPECT_FALSE(InternedName("a").empty());
+}
+
+TEST(InternedStringRepresentationTest, OrdersLexicographically) {
+  EXPECT_LT(InternedName("a"), InternedName("b"));
+  EXPECT_GT(InternedName("b"), InternedName("a"));
+  EXPECT_LT(InternedName(), InternedName("a"));
+  EXPECT_EQ(InternedName("a").compare(InternedName("a")), 0);
+  EXPECT_LT(InternedName("a").compare(InternedName("ab")), 0);
+}
+
+TEST(InternedStringRepresentationTest, WorksAsHashKey) {
+  absl::flat_hash_set<InternedName> names = {InternedName("a"),
+                                             InternedName("b")};
+  EXPECT_TRUE(names.contains(InternedName(std::string("a"))));
+  EXPECT_FALSE(names.contains(InternedName("c")));
+}
+
+TEST(InternedStringRepresentationTest, InternsConcurrently) {
+  std::vector<Thread> threads;
+  std::vector<const std::string*> values(8);
+  for (size_t i = 0; i < values.size(); ++i) {
+    threads.emplace_back([&values, i] {
+      for (int j = 0; j < 100; ++j) {
+        InternedName(absl::StrCat("name_", j));
+      }
+      values[i] = &InternedName("shared").value();
+    });
+  }
+  for (Thread& thread : threads) {
+    thread.Join();
+  }
+  for (const std::string* value : values) {
+    EXPECT_EQ(value, values.front());
+  }
+}
+
+}  // namespace
+}  // namespace intrinsic
@@ -0,0 +1,325 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/thread/cpu_topology.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/util.h"
+
+namespace intrinsic {
+namespace {
+
+// Returns the contents of the sysfs file at `path` without surrounding
+// whitespace, or nullopt if it cannot be read.
+std::optional<std::string> ReadSysfsFile(const std::string& path) {
+  std::ifstream input_stream(path);
+  if (!input_stream.is_open()) {
+    return std::nullopt;
+  }
+  std::string contents((std::istreambuf_iterator<char>(input_stream)),
+                       std::istreambuf_iterator<char>());
+  return std::string(absl::StripAsciiWhitespace(contents));
+}
+
+// Returns the sorted CPUs of the CPU list at `path`, or NotFoundError if it
+// cannot be read. Treats "(null)", which nohz_full contains if unset, as
+// empty.
+absl::StatusOr<std::vector<int>> ReadCpuList(const std::string& path) {
+  std::optional<std::string> list = ReadSysfsFile(path);
+  if (!list.has_value()) {
+    return absl::NotFoundError(absl::StrCat("Cannot read ", path));
+  }
+  if (list->empty() || *list == "(null)") {
+    return std::vector<int>();
+  }
+  INTR_ASSIGN_OR_RETURN(absl::flat_hash_set<int> cpu_set, ParseCpuList(*list));
+  std::vector<int> cpus(cpu_set.begin(), cpu_set.end());
+  std::sort(cpus.begin(), cpus.end());
+  return cpus;
+}
+
+// Like ReadCpuList(), but returns an empty list if the file is missing.
+absl::StatusOr<std::vector<int>> ReadOptionalCpuList(const std::string& path) {
+  absl::StatusOr<std::vector<int>> cpus = ReadCpuList(path);
+  if (absl::IsNotFound(cpus.status())) {
+    return std::vector<int>();
+  }
+  return cpus;
+}
+
+}  // namespace
+
+// static
+absl::StatusOr<CpuTopology> CpuTopology::Read(absl::string_view sysfs_root) {
+  const std::string cpu_root = absl::StrCat(sysfs_root, "/cpu");
+  INTR_ASSIGN_OR_RETURN(std::vector<int> online,
+                        ReadCpuList(absl::StrCat(cpu_root, "/online")));
+
+  absl::flat_hash_set<int> isolated;
+  for (absl::string_view file : {"/isolated", "/nohz_full"}) {
+    INTR_ASSIGN_OR_RETURN(std::vector<int> cpus,
+                          ReadOptionalCpuList(absl::StrCat(cpu_root, file)));
+    isolated.insert(cpus.begin(), cpus.end());
+  }
+
+  absl::flat_hash_map<int, int> numa_nodes;
+  const std::string node_root = absl::StrCat(sysfs_root, "/node");
+  INTR_ASSIGN_OR_RETURN(
+      std::vector<int> nodes,
+      ReadOptionalCpuList(absl::StrCat(node_root, "/online")));
+  for (int node : nodes) {
+    INTR_ASSIGN_OR_RETURN(std::vector<int> cpus,
+                          ReadOptionalCpuList(absl::StrCat(
+                              node_root, "/node", node, "/cpulist")));
+    for (int cpu : cpus) {
+      numa_nodes[cpu] = node;
+    }
+  }
+
+  std::vector<Cpu> cpus;
+  for (int id : online) {
+    const std::string root = absl::StrCat(cpu_root, "/cpu", id);
+    Cpu cpu = {.id = id, .isolated = isolated.contains(id)};
+    if (auto it = numa_nodes.find(id); it != numa_nodes.end()) {
+      cpu.numa_node = it->second;
+    }
+    INTR_ASSIGN_OR_RETURN(
+        std::vector<int> siblings,
+        ReadOptionalCpuList(
+            absl::StrCat(root, "/topology/thread_siblings_list")));
+    cpu.l2_group = siblings.empty() ? id : siblings.front();
+    for (int index = 0;; ++index) {
+      const std::string cache = absl::StrCat(root, "/cache/index", index);
+      std::optional<std::string> level_string =
+          ReadSysfsFile(absl::StrCat(cache, "/level"));
+      int level = 0;
+      if (!level_string.has_value() ||
+          !absl::SimpleAtoi(*level_string, &level)) {
+        break;
+      }
+      if (ReadSysfsFile(absl::StrCat(cache, "/type")) == "Instruction" ||
+          (level != 2 && level != 3)) {
+        continue;
+      }
+      INTR_ASSIGN_OR_RETURN(
+          std::vector<int> shared,
+          ReadOptionalCpuList(absl::StrCat(cache, "/shared_cpu_list")));
+      if (shared.empty()) {
+        continue;
+      }
+      (level == 2 ? cpu.l2_group : cpu.l3_group) = shared.front();
+    }
+    cpus.push_back(cpu);
+  }
+  return CpuTopology(std::move(cpus));
+}
+
+CpuTopology::CpuTopology(std::vector<Cpu> cpus) : cpus_(std::move(cpus)) {
+  std::sort(cpus_.begin(), cpus_.end(),
+            [](const Cpu& lhs, const Cpu& rhs) { return lhs.id < rhs.id; });
+}
+
+CpuLease::CpuLease(CpuLeaseManager* manager, std::vector<int> groups,
+                   std::vector<int> cpus, std::vector<int> primary_cpus)
+    : manager_(manager),
+      groups_(std::move(groups)),
+      cpus_(std::move(cpus)),
+      primary_cpus_(std::move(primary_cpus)) {}
+
+CpuLease::CpuLease(CpuLease&& other)
+    : manager_(std::exchange(other.manager_, nullptr)),
+      groups_(std::move(other.groups_)),
+      cpus_(std::move(other.cpus_)),
+      primary_cpus_(std::move(other.primary_cpus_)) {}
+
+CpuLease& CpuLease::operator=(CpuLease&& other) {
+  if (this != &other) {
+    if (manager_ != nullptr) {
+      manager_->Release(groups_);
+    }
+    manager_ = std::exchange(other.manager_, nullptr);
+    groups_ = std::move(other.groups_);
+    cpus_ = std::move(other.cpus_);
+    primary_cpus_ = std::move(other.primary_cpus_);
+  }
+  return *this;
+}
+
+CpuLease::~CpuLease() {
+  if (manager_ != nullptr) {
+    manager_->Release(groups_);
+  }
+}
+
+CpuLeaseManager::CpuLeaseManager(CpuTopology topology)
+    : topology_(std::move(topology)) {
+  absl::flat_hash_map<int, size_t> core_index;
+  for (const CpuTopology::Cpu& cpu : topology_.cpus()) {
+    auto [it, inserted] = core_index.try_emplace(cpu.l2_group, cores_.size());
+    if (inserted) {
+      cores_.push_back({.group = cpu.l2_group,
+                        .numa_node = cpu.numa_node,
+                        .l3_group = cpu.l3_group,
+                        .isolated = true});
+    }
+    Core& core = cores_[it->second];
+    core.cpus.push_back(cpu.id);
+    core.isolated = core.isolated && cpu.isolated;
+  }
+  std::sort(cores_.begin(), cores_.end(), [](const Core& lhs, const Core& rhs) {
+    return lhs.group < rhs.group;
+  });
+}
+
+template <typename Better>
+std::vector<const CpuLeaseManager::Core*> CpuLeaseManager::FreeCores(
+    Better better) const {
+  std::vector<const Core*> free_cores;
+  for (const Core& core : cores_) {
+    if (!leased_groups_.contains(core.group)) {
+      free_cores.push_back(&core);
+    }
+  }
+  std::stable_sort(free_cores.begin(), free_cores.end(),
+                   [&better](const Core* lhs, const Core* rhs) {
+                     return better(*lhs, *rhs);
+                   });
+  return free_cores;
+}
+
+CpuLease CpuLeaseManager::Grant(const std::vector<const Core*>& cores) {
+  std::vector<int> groups;
+  std::vector<int> cpus;
+  std::vector<int> primary_cpus;
+  for (const Core* core : cores) {
+    leased_groups_.insert(core->group);
+    groups.push_back(core->group);
+    cpus.insert(cpus.end(), core->cpus.begin(), core->cpus.end());
+    primary_cpus.push_back(core->cpus.front());
+  }
+  std::sort(cpus.begin(), cpus.end());
+  std::sort(primary_cpus.begin(), primary_cpus.end());
+  return CpuLease(this, std::move(groups), std::move(cpus),
+                  std::move(primary_cpus));
+}
+
+void CpuLeaseManager::Release(const std::vector<int>& groups) {
+  absl::MutexLock lock(&mutex_);
+  for (int group : groups) {
+    leased_groups_.erase(group);
+  }
+}
+
+absl::StatusOr<CpuLease> CpuLeaseManager::LeaseRealtimeCores(
+    int num_cores, std::optional<int> numa_node) {
+  if (num_cores <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Number of cores must be positive, got ", num_cores));
+  }
+  absl::MutexLock lock(&mutex_);
+  if (!numa_node.has_value()) {
+    // Picks the node that can hold the whole lease, with as many isolated
+    // cores as possible.
+    absl::flat_hash_map<int, std::pair<int, int>> free_per_node;
+    for (const Core& core : cores_) {
+      if (!leased_groups_.contains(core.group)) {
+        auto& [num_free, num_isolated] = free_per_node[core.numa_node];
+        ++num_free;
+        num_isolated += core.isolated ? 1 : 0;
+      }
+    }
+    std::tuple<bool, int, int> best_key;
+    for (const auto& [node, counts] : free_per_node) {
+      const std::tuple<bool, int, int> key = {
+          counts.first >= num_cores, std::min(counts.second, num_cores),
+          counts.first};
+      if (!numa_node.has_value() || key > best_key ||
+          (key == best_key && node < *numa_node)) {
+        numa_node = node;
+        best_key = key;
+      }
+    }
+  }
+  std::vector<const Core*> cores =
+      FreeCores([node = numa_node.value_or(0)](const Core& lhs,
+                                               const Core& rhs) {
+        return std::make_tuple(lhs.isolated, lhs.numa_node == node) >
+               std::make_tuple(rhs.isolated, rhs.numa_node == node);
+      });
+  if (cores.size() < static_cast<size_t>(num_cores)) {
+    return absl::ResourceExhaustedError(
+        absl::StrCat("Requested ", num_cores, " real-time cores, but only ",
+                     cores.size(), " cores are free"));
+  }
+  cores.resize(num_cores);
+  return Grant(cores);
+}
+
+absl::StatusOr<CpuLease> CpuLeaseManager::LeaseCompanionCore(
+    const CpuLease& realtime_lease) {
+  if (realtime_lease.manager_ != this || realtime_lease.groups_.empty()) {
+    return absl::InvalidArgumentError(
+        "The real-time lease is not from this manager");
+  }
+  absl::MutexLock lock(&mutex_);
+  const Core& reference = *std::lower_bound(
+      cores_.begin(), cores_.end(), realtime_lease.groups_.front(),
+      [](const Core& core, int group) { return core.group < group; });
+  std::vector<const Core*> cores =
+      FreeCores([&reference](const Core& lhs, const Core& rhs) {
+        const auto key = [&reference](const Core& core) {
+          return std::make_tuple(
+              reference.l3_group >= 0 && core.l3_group == reference.l3_group,
+              core.numa_node == reference.numa_node, !core.isolated);
+        };
+        return key(lhs) > key(rhs);
+      });
+  if (cores.empty()) {
+    return absl::ResourceExhaustedError("No free core for a companion thread");
+  }
+  cores.resize(1);
+  return Grant(cores);
+}
+
+absl::StatusOr<CpuLease> CpuLeaseManager::LeaseBackgroundCores(
+    std::optional<int> max_cores) {
+  if (max_cores.has_value() && *max_cores <= 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Maximum number of cores must be positive, got ", *max_cores));
+  }
+  absl::MutexLock lock(&mutex_);
+  std::vector<const Core*> cores =
+      FreeCores([](const Core& lhs, const Core& rhs) {
+        return lhs.isolated < rhs.isolated;
+      });
+  cores.erase(std::find_if(cores.begin(), cores.end(),
+                           [](const Core* core) { return core->isolated; }),
+              cores.end());
+  if (cores.empty()) {
+    return absl::ResourceExhaustedError(
+        "No free core without isolated CPUs for background threads");
+  }
+  if (max_cores.has_value() && cores.size() > static_cast<size_t>(*max_cores)) {
+    cores.resize(*max_cores);
+  }
+  return Grant(cores);
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,160 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_UTIL_THREAD_CPU_TOPOLOGY_H_
+#define INTRINSIC_UTIL_THREAD_CPU_TOPOLOGY_H_
+
+#include <optional>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace intrinsic {
+
+// The CPUs of the machine, and which caches and nodes they share.
+class CpuTopology {
+ public:
+  struct Cpu {
+    int id = 0;
+    int numa_node = 0;
+    // Smallest CPU that shares the L2 cache with this CPU. CPUs without L2
+    // information are grouped with their SMT siblings.
+    int l2_group = 0;
+    // Smallest CPU that shares the L3 cache with this CPU, or -1 if unknown.
+    int l3_group = -1;
+    // Whether the CPU is in isolcpus or nohz_full.
+    bool isolated = false;
+  };
+
+  // Reads the topology of the online CPUs from sysfs. `sysfs_root` can point
+  // to a copy of /sys/devices/system for testing.
+  //
+  // Returns NotFoundError if the list of online CPUs cannot be read, and
+  // FailedPreconditionError if a CPU list cannot be parsed. Missing cache,
+  // NUMA or isolation information is treated as absent.
+  static absl::StatusOr<CpuTopology> Read(
+      absl::string_view sysfs_root = "/sys/devices/system");
+
+  // Creates a topology from `cpus`, e.g. for testing.
+  explicit CpuTopology(std::vector<Cpu> cpus);
+
+  // Ordered by id.
+  const std::vector<Cpu>& cpus() const { return cpus_; }
+
+ private:
+  std::vector<Cpu> cpus_;
+};
+
+class CpuLeaseManager;
+
+// A set of CPUs handed out by a CpuLeaseManager. Returns the CPUs to the
+// manager when destroyed. Movable, but not copyable.
+class CpuLease {
+ public:
+  CpuLease(CpuLease&& other);
+  CpuLease& operator=(CpuLease&& other);
+  CpuLease(const CpuLease&) = delete;
+  CpuLease& operator=(const CpuLease&) = delete;
+  ~CpuLease();
+
+  // All CPUs of the lease, sorted. Use with Thread::Options::SetAffinity() for
+  // threads that may run on any of them.
+  const std::vector<int>& cpus() const { return cpus_; }
+  // One CPU per leased core, sorted. Pin one real-time thread to each and
+  // leave their SMT siblings idle.
+  const std::vector<int>& primary_cpus() const { return primary_cpus_; }
+
+ private:
+  friend class CpuLeaseManager;
+
+  CpuLease(CpuLeaseManager* manager, std::vector<int> groups,
+           std::vector<int> cpus, std::vector<int> primary_cpus);
+
+  CpuLeaseManager* manager_;
+  // The L2 groups of the lease.
+  std::vector<int> groups_;
+  std::vector<int> cpus_;
+  std::vector<int> primary_cpus_;
+};
+
+// Hands out non-overlapping CPU leases for real-time threads, their companion
+// threads and background work, so that they do not share caches they should
+// not share.
+//
+// The unit of a lease is a core, i.e. all CPUs that share an L2 cache. A CPU
+// is thus never leased twice, and threads of different leases never share an
+// L2 cache. For example, a real-time control thread does not share its L2
+// cache with a log drain in a background pool:
+//
+//   INTR_ASSIGN_OR_RETURN(CpuTopology topology, CpuTopology::Read());
+//   CpuLeaseManager leases(std::move(topology));
+//   INTR_ASSIGN_OR_RETURN(CpuLease rt, leases.LeaseRealtimeCores(1));
+//   INTR_ASSIGN_OR_RETURN(CpuLease io, leases.LeaseCompanionCore(rt));
+//   INTR_ASSIGN_OR_RETURN(CpuLease background, leases.LeaseBackgroundCores());
+//   Thread::Options rt_options = Thread::Options()
+//                                    .SetRealtimeHighPriorityAndScheduler()
+//                                    .SetAffinity(rt.primary_cpus());
+//
+// Thread safe. Must outlive all its leases.
+class CpuLeaseManager {
+ public:
+  explicit CpuLeaseManager(CpuTopology topology);
+
+  // Leases `num_cores` cores for real-time threads. Prefers cores whose CPUs
+  // are all isolated, and cores of `numa_node` if given, otherwise of a
+  // single NUMA node if possible.
+  //
+  // Returns ResourceExhaustedError if fewer cores are free.
+  absl::StatusOr<CpuLease> LeaseRealtimeCores(
+      int num_cores, std::optional<int> numa_node = std::nullopt);
+
+  // Leases a core for a thread that works closely with the threads of
+  // `realtime_lease`, e.g. for I/O. Prefers cores that share the L3 cache, or
+  // else the NUMA node, of `realtime_lease`, and cores that are not isolated.
+  //
+  // Returns ResourceExhaustedError if no core is free.
+  absl::StatusOr<CpuLease> LeaseCompanionCore(const CpuLease& realtime_lease);
+
+  // Leases up to `max_cores` free cores, or all free cores if not given, whose
+  // CPUs are not isolated, for background threads.
+  //
+  // Returns ResourceExhaustedError if no such core is free.
+  absl::StatusOr<CpuLease> LeaseBackgroundCores(
+      std::optional<int> max_cores = std::nullopt);
+
+  const CpuTopology& topology() const { return topology_; }
+
+ private:
+  friend class CpuLease;
+
+  struct Core {
+    int group;
+    int numa_node;
+    int l3_group;
+    bool isolated;
+    std::vector<int> cpus;
+  };
+
+  // Returns the free cores ordered from most to least preferred by `better`,
+  // which compares two cores. Stable with respect to core order.
+  template <typename Better>
+  std::vector<const Core*> FreeCores(Better better) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  CpuLease Grant(const std::vector<const Core*>& cores)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Returns the cores of `lease` to the free cores.
+  void Release(const std::vector<int>& groups);
+
+  const CpuTopology topology_;
+  // Ordered by group.
+  std::vector<Core> cores_;
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_set<int> leased_groups_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_UTIL_THREAD_CPU_TOPOLOGY_H_
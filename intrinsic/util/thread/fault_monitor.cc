@@ -0,0 +1,268 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/thread/fault_monitor.h"
+
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+namespace {
+
+constexpr auto kRelaxed = std::memory_order_relaxed;
+
+ThreadFaultCounters Subtract(const ThreadFaultCounters& lhs,
+                             const ThreadFaultCounters& rhs) {
+  return {
+      .minor_faults = lhs.minor_faults - rhs.minor_faults,
+      .major_faults = lhs.major_faults - rhs.major_faults,
+      .voluntary_context_switches =
+          lhs.voluntary_context_switches - rhs.voluntary_context_switches,
+      .involuntary_context_switches =
+          lhs.involuntary_context_switches - rhs.involuntary_context_switches,
+  };
+}
+
+// Reads the schedstat of thread `tid` into `stats`. Leaves `stats` unchanged
+// if the thread has exited or the kernel lacks schedstats.
+void ReadSchedstat(pid_t tid, ThreadFaultStats& stats) {
+  std::ifstream input_stream(
+      absl::StrCat("/proc/self/task/", tid, "/schedstat"));
+  uint64_t cpu_time_ns = 0;
+  uint64_t run_delay_ns = 0;
+  uint64_t num_timeslices = 0;
+  if (input_stream >> cpu_time_ns >> run_delay_ns >> num_timeslices) {
+    stats.cpu_time_ns = cpu_time_ns;
+    stats.run_delay_ns = run_delay_ns;
+    stats.num_timeslices = num_timeslices;
+  }
+}
+
+void LogFault(const ThreadFaultStats& stats) {
+  LOG(WARNING) << "Thread '" << stats.name << "' (tid " << stats.tid
+               << ") faulted in " << stats.num_faulting_cycles
+               << " cycles after its warm-up, last in cycle "
+               << stats.last_faulting_cycle.value_or(0) << ": "
+               << stats.after_warmup.minor_faults << " minor and "
+               << stats.after_warmup.major_faults
+               << " major faults, up to " << stats.max_faults_per_cycle
+               << " per cycle.";
+}
+
+}  // namespace
+
+ThreadFaultCounters GetCurrentThreadFaultCounters() {
+  rusage usage;
+  getrusage(RUSAGE_THREAD, &usage);
+  return {
+      .minor_faults = static_cast<uint64_t>(usage.ru_minflt),
+      .major_faults = static_cast<uint64_t>(usage.ru_majflt),
+      .voluntary_context_switches = static_cast<uint64_t>(usage.ru_nvcsw),
+      .involuntary_context_switches = static_cast<uint64_t>(usage.ru_nivcsw),
+  };
+}
+
+void ThreadFaultMonitor::AtomicCounters::Add(const ThreadFaultCounters& delta) {
+  // Only the monitored thread writes, so there is no need for fetch_add().
+  minor_faults.store(minor_faults.load(kRelaxed) + delta.minor_faults,
+                     kRelaxed);
+  major_faults.store(major_faults.load(kRelaxed) + delta.major_faults,
+                     kRelaxed);
+  voluntary_context_switches.store(
+      voluntary_context_switches.load(kRelaxed) +
+          delta.voluntary_context_switches,
+      kRelaxed);
+  involuntary_context_switches.store(
+      involuntary_context_switches.load(kRelaxed) +
+          delta.involuntary_context_switches,
+      kRelaxed);
+}
+
+void ThreadFaultMonitor::AtomicCounters::Reset() {
+  minor_faults.store(0, kRelaxed);
+  major_faults.store(0, kRelaxed);
+  voluntary_context_switches.store(0, kRelaxed);
+  involuntary_context_switches.store(0, kRelaxed);
+}
+
+ThreadFaultCounters ThreadFaultMonitor::AtomicCounters::Load() const {
+  return {
+      .minor_faults = minor_faults.load(kRelaxed),
+      .major_faults = major_faults.load(kRelaxed),
+      .voluntary_context_switches = voluntary_context_switches.load(kRelaxed),
+      .involuntary_context_switches =
+          involuntary_context_switches.load(kRelaxed),
+  };
+}
+
+// static
+absl::StatusOr<std::unique_ptr<ThreadFaultMonitor>> ThreadFaultMonitor::Create(
+    Options options) {
+  if (options.poll_interval <= absl::ZeroDuration()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Poll interval must be positive, got ",
+                     absl::FormatDuration(options.poll_interval)));
+  }
+  const Thread::Options thread_options = options.thread_options;
+  auto monitor = absl::WrapUnique(new ThreadFaultMonitor(std::move(options)));
+  if (monitor->poll_interval_ != absl::InfiniteDuration()) {
+    INTR_RETURN_IF_ERROR(monitor->monitor_thread_.Start(
+        thread_options, &ThreadFaultMonitor::RunMonitor, monitor.get()));
+  }
+  return monitor;
+}
+
+ThreadFaultMonitor::ThreadFaultMonitor(Options options)
+    : warmup_cycles_(options.warmup_cycles),
+      poll_interval_(options.poll_interval),
+      on_fault_(options.on_fault ? std::move(options.on_fault)
+                                 : AlertFn(&LogFault)) {}
+
+ThreadFaultMonitor::~ThreadFaultMonitor() {
+  stop_.Notify();
+  if (monitor_thread_.Joinable()) {
+    monitor_thread_.Join();
+  }
+}
+
+absl::StatusOr<int> ThreadFaultMonitor::RegisterCurrentThread(
+    absl::string_view name) {
+  absl::MutexLock lock(&mutex_);
+  for (int handle = 0; handle < kMaxThreads; ++handle) {
+    Slot& slot = slots_[handle];
+    if (slot.registered) {
+      continue;
+    }
+    slot.registered = true;
+    slot.name = std::string(name);
+    slot.tid = static_cast<pid_t>(syscall(SYS_gettid));
+    slot.alerted_faulting_cycles = 0;
+    slot.previous = GetCurrentThreadFaultCounters();
+    slot.total.Reset();
+    slot.after_warmup.Reset();
+    slot.num_cycles.store(0, kRelaxed);
+    slot.num_faulting_cycles.store(0, kRelaxed);
+    slot.max_faults_per_cycle.store(0, kRelaxed);
+    slot.last_faulting_cycle.store(0, kRelaxed);
+    return handle;
+  }
+  return absl::ResourceExhaustedError(absl::StrCat(
+      "Cannot register thread '", name, "', ", kMaxThreads,
+      " threads are already registered"));
+}
+
+void ThreadFaultMonitor::Unregister(int handle) {
+  if (handle < 0 || handle >= kMaxThreads) {
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  slots_[handle].registered = false;
+}
+
+void ThreadFaultMonitor::EndCycle(int handle, uint64_t cycle) {
+  if (handle < 0 || handle >= kMaxThreads) {
+    return;
+  }
+  Slot& slot = slots_[handle];
+  const ThreadFaultCounters now = GetCurrentThreadFaultCounters();
+  const ThreadFaultCounters delta = Subtract(now, slot.previous);
+  slot.previous = now;
+
+  const uint64_t num_cycles = slot.num_cycles.load(kRelaxed) + 1;
+  slot.total.Add(delta);
+  if (num_cycles > warmup_cycles_) {
+    slot.after_warmup.Add(delta);
+    const uint64_t faults = delta.minor_faults + delta.major_faults;
+    if (faults > 0) {
+      slot.last_faulting_cycle.store(cycle, kRelaxed);
+      slot.max_faults_per_cycle.store(
+          std::max(slot.max_faults_per_cycle.load(kRelaxed), faults),
+          kRelaxed);
+      // Published last, so that a reader that sees the new count also sees
+      // the cycle.
+      slot.num_faulting_cycles.store(
+          slot.num_faulting_cycles.load(kRelaxed) + 1,
+          std::memory_order_release);
+    }
+  }
+  slot.num_cycles.store(num_cycles, std::memory_order_release);
+}
+
+ThreadFaultStats ThreadFaultMonitor::ReadStats(const Slot& slot) const {
+  ThreadFaultStats stats = {
+      .name = slot.name,
+      .tid = slot.tid,
+      .num_cycles = slot.num_cycles.load(std::memory_order_acquire),
+      .num_faulting_cycles =
+          slot.num_faulting_cycles.load(std::memory_order_acquire),
+  };
+  stats.total = slot.total.Load();
+  stats.after_warmup = slot.after_warmup.Load();
+  stats.max_faults_per_cycle = slot.max_faults_per_cycle.load(kRelaxed);
+  if (stats.num_faulting_cycles > 0) {
+    stats.last_faulting_cycle = slot.last_faulting_cycle.load(kRelaxed);
+  }
+  ReadSchedstat(slot.tid, stats);
+  return stats;
+}
+
+std::vector<ThreadFaultStats> ThreadFaultMonitor::GetStats() const {
+  absl::ReaderMutexLock lock(&mutex_);
+  std::vector<ThreadFaultStats> stats;
+  for (const Slot& slot : slots_) {
+    if (slot.registered) {
+      stats.push_back(ReadStats(slot));
+    }
+  }
+  return stats;
+}
+
+void ThreadFaultMonitor::Poll() {
+  std::vector<ThreadFaultStats> alerts;
+  {
+    absl::MutexLock lock(&mutex_);
+    for (Slot& slot : slots_) {
+      if (!slot.registered) {
+        continue;
+      }
+      ThreadFaultStats stats = ReadStats(slot);
+      if (stats.num_faulting_cycles > slot.alerted_faulting_cycles) {
+        slot.alerted_faulting_cycles = stats.num_faulting_cycles;
+        alerts.push_back(std::move(stats));
+      }
+    }
+  }
+  // Without holding the lock, so that the callback may call GetStats().
+  for (const ThreadFaultStats& stats : alerts) {
+    on_fault_(stats);
+  }
+}
+
+void ThreadFaultMonitor::RunMonitor() {
+  while (!stop_.WaitForNotificationWithTimeout(poll_interval_)) {
+    Poll();
+  }
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,201 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_UTIL_THREAD_FAULT_MONITOR_H_
+#define INTRINSIC_UTIL_THREAD_FAULT_MONITOR_H_
+
+#include <sys/types.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/testing/realtime_annotations.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+
+// Page fault and context switch counters of a thread.
+struct ThreadFaultCounters {
+  uint64_t minor_faults = 0;
+  uint64_t major_faults = 0;
+  uint64_t voluntary_context_switches = 0;
+  uint64_t involuntary_context_switches = 0;
+};
+
+// Real-time safe. Returns the counters of the calling thread, as reported by
+// getrusage(RUSAGE_THREAD). Unlike GetPagefaultInfo(), keeps no state.
+ThreadFaultCounters GetCurrentThreadFaultCounters()
+    INTRINSIC_CHECK_REALTIME_SAFE;
+
+// What a ThreadFaultMonitor knows about one registered thread.
+struct ThreadFaultStats {
+  std::string name;
+  pid_t tid = 0;
+  // Number of ThreadFaultMonitor::EndCycle() calls since registration.
+  uint64_t num_cycles = 0;
+  // Counters since registration.
+  ThreadFaultCounters total;
+  // Counters of the cycles after the warm-up.
+  ThreadFaultCounters after_warmup;
+  // Number of cycles after the warm-up in which the thread faulted.
+  uint64_t num_faulting_cycles = 0;
+  // Largest number of faults in a single cycle after the warm-up.
+  uint64_t max_faults_per_cycle = 0;
+  // The last cycle after the warm-up in which the thread faulted.
+  std::optional<uint64_t> last_faulting_cycle;
+  // From /proc/self/task/<tid>/schedstat, or zero if it cannot be read: the
+  // time spent on the CPU and waiting on a run queue, and the number of
+  // timeslices.
+  uint64_t cpu_time_ns = 0;
+  uint64_t run_delay_ns = 0;
+  uint64_t num_timeslices = 0;
+};
+
+// Continuously monitors page faults and context switches of registered
+// threads, attributes them to cycles, and raises an alert when a thread faults
+// after its warm-up, e.g. because it touches memory that was not locked or
+// pre-faulted.
+//
+// Each monitored thread registers itself before entering its loop, and ends
+// every cycle with EndCycle():
+//
+//   INTR_ASSIGN_OR_RETURN(std::unique_ptr<ThreadFaultMonitor> monitor,
+//                         ThreadFaultMonitor::Create({.warmup_cycles = 1000}));
+//   ...
+//   // On the real-time thread:
+//   INTR_ASSIGN_OR_RETURN(int handle,
+//                         monitor->RegisterCurrentThread("control_loop"));
+//   while (running) {
+//     ...
+//     monitor->EndCycle(handle, Cycle::GetCurrentCycle());
+//   }
+//   monitor->Unregister(handle);
+//
+// EndCycle() calls getrusage(RUSAGE_THREAD) and updates atomic counters, so it
+// does not lock or allocate. A monitor thread polls the counters and the
+// schedstat of the registered threads every Options::poll_interval, and calls
+// Options::on_fault for each thread that faulted after its warm-up since the
+// last poll. The counters of a thread are read one by one, so a snapshot may
+// mix two consecutive cycles.
+class ThreadFaultMonitor {
+ public:
+  static constexpr int kMaxThreads = 32;
+
+  using AlertFn = absl::AnyInvocable<void(const ThreadFaultStats&)>;
+
+  struct Options {
+    // Number of cycles after registration in which faults are expected, e.g.
+    // while a thread touches its stack and buffers for the first time.
+    uint64_t warmup_cycles = 1000;
+    // Period of the monitor thread. If infinite, no monitor thread is started
+    // and Poll() must be called instead.
+    absl::Duration poll_interval = absl::Seconds(1);
+    // Options of the monitor thread.
+    Thread::Options thread_options = Thread::Options().SetName("fault_mon");
+    // Called with the stats of a thread that faulted after its warm-up. Runs
+    // on the thread that polls. Logs a warning if unset.
+    AlertFn on_fault;
+  };
+
+  // Not real-time safe. Starts the monitor thread.
+  //
+  // Returns InvalidArgumentError if `poll_interval` is not positive, and the
+  // error of Thread::Start() if the monitor thread cannot be started.
+  static absl::StatusOr<std::unique_ptr<ThreadFaultMonitor>> Create(
+      Options options) INTRINSIC_NON_REALTIME_ONLY;
+
+  // Not real-time safe. Stops the monitor thread.
+  ~ThreadFaultMonitor();
+
+  ThreadFaultMonitor(const ThreadFaultMonitor&) = delete;
+  ThreadFaultMonitor& operator=(const ThreadFaultMonitor&) = delete;
+
+  // Not real-time safe. Registers the calling thread under `name` and returns
+  // the handle to pass to EndCycle() on this thread.
+  //
+  // Returns ResourceExhaustedError if kMaxThreads threads are registered.
+  absl::StatusOr<int> RegisterCurrentThread(absl::string_view name)
+      INTRINSIC_NON_REALTIME_ONLY;
+
+  // Not real-time safe. Stops monitoring the thread of `handle`. The thread
+  // must not call EndCycle() with `handle` afterwards.
+  void Unregister(int handle) INTRINSIC_NON_REALTIME_ONLY;
+
+  // Real-time safe. Attributes the faults and context switches of the calling
+  // thread since the previous call, or since registration, to `cycle`. Must be
+  // called from the thread that registered `handle`. Has no effect if `handle`
+  // is out of range.
+  void EndCycle(int handle, uint64_t cycle) INTRINSIC_CHECK_REALTIME_SAFE;
+
+  // Not real-time safe. Returns the stats of all registered threads.
+  std::vector<ThreadFaultStats> GetStats() const INTRINSIC_NON_REALTIME_ONLY;
+
+  // Not real-time safe. Calls Options::on_fault for every thread that faulted
+  // after its warm-up since the last poll. Called by the monitor thread, so
+  // only call it directly if Options::poll_interval is infinite.
+  void Poll() INTRINSIC_NON_REALTIME_ONLY;
+
+ private:
+  // Counters written by the monitored thread and read by the monitor.
+  struct AtomicCounters {
+    std::atomic<uint64_t> minor_faults = 0;
+    std::atomic<uint64_t> major_faults = 0;
+    std::atomic<uint64_t> voluntary_context_switches = 0;
+    std::atomic<uint64_t> involuntary_context_switches = 0;
+
+    void Add(const ThreadFaultCounters& delta);
+    void Reset();
+    ThreadFaultCounters Load() const;
+  };
+
+  struct Slot {
+    // Guarded by `mutex_`.
+    bool registered = false;
+    std::string name;
+    pid_t tid = 0;
+    // `num_faulting_cycles` at the last alert.
+    uint64_t alerted_faulting_cycles = 0;
+
+    // Only accessed by the monitored thread.
+    ThreadFaultCounters previous;
+
+    AtomicCounters total;
+    AtomicCounters after_warmup;
+    std::atomic<uint64_t> num_cycles = 0;
+    std::atomic<uint64_t> num_faulting_cycles = 0;
+    std::atomic<uint64_t> max_faults_per_cycle = 0;
+    std::atomic<uint64_t> last_faulting_cycle = 0;
+  };
+
+  explicit ThreadFaultMonitor(Options options);
+
+  ThreadFaultStats ReadStats(const Slot& slot) const
+      ABSL_SHARED_LOCKS_REQUIRED(mutex_);
+  void RunMonitor();
+
+  const uint64_t warmup_cycles_;
+  const absl::Duration poll_interval_;
+  AlertFn on_fault_;
+
+  mutable absl::Mutex mutex_;
+  std::array<Slot, kMaxThreads> slots_;
+
+  absl::Notification stop_;
+  Thread monitor_thread_;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_UTIL_THREAD_FAULT_MONITOR_H_
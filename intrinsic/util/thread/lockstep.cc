@@ -10,13 +10,20 @@
 #include "intrinsic/icon/utils/log.h"
 #include "intrinsic/icon/utils/realtime_status.h"
 #include "intrinsic/icon/utils/realtime_status_macro.h"
+#include "intrinsic/icon/utils/trace_event.h"
 
 namespace intrinsic {
+Lockstep::Lockstep(absl::Duration spin_duration)
+    : a_finished_(/*posted=*/false, spin_duration),
+      b_finished_(/*posted=*/true, spin_duration) {}
+
 Lockstep &Lockstep::operator=(Lockstep &&other) {
   if (this != &other) {
-    a_finished_ = std::exchange(other.a_finished_, icon::BinaryFutex(false));
-    b_finished_ =
-        std::exchange(other.b_finished_, icon::BinaryFutex(/*posted=*/true));
+    const absl::Duration spin_duration = other.a_finished_.spin_duration();
+    a_finished_ = std::exchange(other.a_finished_,
+                                icon::BinaryFutex(false, spin_duration));
+    b_finished_ = std::exchange(
+        other.b_finished_, icon::BinaryFutex(/*posted=*/true, spin_duration));
     state_.store(other.state_.load());
   }
   return *this;
@@ -35,6 +42,7 @@ icon::RealtimeStatus Lockstep::StartOperationAWithDeadline(
     return icon::FailedPreconditionError("Expected State::kBFinished");
   }
   state_ = State::kARunning;
+  icon::TraceBegin("lockstep", "OperationA");
   return icon::OkStatus();
 }
 
@@ -52,6 +60,7 @@ icon::RealtimeStatus Lockstep::EndOperationA() {
         "Mismatched call to EndOperationA. Did you call StartOperationA...?");
   }
   state_ = State::kAFinished;
+  icon::TraceEnd("lockstep", "OperationA");
   return a_finished_.Post();
 }
 
@@ -68,6 +77,7 @@ icon::RealtimeStatus Lockstep::StartOperationBWithDeadline(
     return icon::FailedPreconditionError("Expected State::kAFinished");
   }
   state_ = State::kBRunning;
+  icon::TraceBegin("lockstep", "OperationB");
   return icon::OkStatus();
 }
 
@@ -85,6 +95,7 @@ icon::RealtimeStatus Lockstep::EndOperationB() {
         "Mismatched call to EndOperationB. Did you call StartOperationB...?");
   }
   state_ = State::kBFinished;
+  icon::TraceEnd("lockstep", "OperationB");
   return b_finished_.Post();
 }
 
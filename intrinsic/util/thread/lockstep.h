@@ -47,11 +47,17 @@ namespace intrinsic {
 //
 // The implementation is designed to be efficient (using low-level futexes) and
 // is intended for realtime use.
+//
+// When both threads run on dedicated cores and hand off within microseconds,
+// pass a `spin_duration` to the constructor, so that `StartOperation...()`
+// busy-waits for the other operation to end for up to that long before it
+// blocks on the futex (see BinaryFutex).
 class Lockstep {
  public:
   static constexpr absl::Duration kResetTimeout = absl::Seconds(1);
 
   Lockstep() = default;
+  explicit Lockstep(absl::Duration spin_duration);
   Lockstep(Lockstep &other) = delete;
   Lockstep &operator=(const Lockstep &other) = delete;
   Lockstep(Lockstep &&other) = delete;
@@ -0,0 +1,95 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/thread/lockstep_pipeline.h"
+
+#include <atomic>
+#include <cstdint>
+
+#include "absl/log/check.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/interprocess/futex_event_group.h"
+#include "intrinsic/icon/utils/log.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+#include "intrinsic/icon/utils/realtime_status_macro.h"
+
+namespace intrinsic {
+
+LockstepPipeline::LockstepPipeline(int num_stages) : num_stages_(num_stages) {
+  CHECK(num_stages >= 1 && num_stages <= kMaxStages)
+      << "LockstepPipeline supports 1 to " << kMaxStages
+      << " stages, got " << num_stages;
+}
+
+icon::RealtimeStatus LockstepPipeline::StartStageWithDeadline(
+    int stage, absl::Time deadline) {
+  if (stage < 0 || stage >= num_stages_) {
+    return icon::InvalidArgumentError(icon::RealtimeStatus::StrCat(
+        "Stage ", stage, " is out of range [0, ", num_stages_, ")"));
+  }
+  // Consuming the flag of `stage` lets only one concurrent caller through.
+  INTRINSIC_RT_ASSIGN_OR_RETURN(
+      const uint32_t flags,
+      ready_.ConsumeUntil(StageFlag(stage) | kCancelledFlag, deadline));
+  if ((flags & kCancelledFlag) != 0) {
+    // Put back what we consumed, so that other waiters see the cancellation
+    // too. Ignore error because returning Aborted to the caller is more
+    // important.
+    (void)ready_.Set(flags);
+    return icon::AbortedError(icon::RealtimeStatus::StrCat(
+        "Not starting stage ", stage, ": pipeline has been cancelled"));
+  }
+  running_stage_ = stage;
+  return icon::OkStatus();
+}
+
+icon::RealtimeStatus LockstepPipeline::StartStageWithTimeout(
+    int stage, absl::Duration timeout) {
+  return StartStageWithDeadline(stage, absl::Now() + timeout);
+}
+
+icon::RealtimeStatus LockstepPipeline::EndStage(int stage) {
+  return EndStageAndSkipTo(stage, (stage + 1) % num_stages_);
+}
+
+icon::RealtimeStatus LockstepPipeline::EndStageAndSkipTo(int stage,
+                                                         int next_stage) {
+  if ((ready_.Value() & kCancelledFlag) != 0) {
+    return icon::OkStatus();
+  }
+  if (next_stage < 0 || next_stage >= num_stages_) {
+    return icon::InvalidArgumentError(icon::RealtimeStatus::StrCat(
+        "Next stage ", next_stage, " is out of range [0, ", num_stages_, ")"));
+  }
+  int expected = stage;
+  if (!running_stage_.compare_exchange_strong(expected, kNoStage)) {
+    return icon::FailedPreconditionError(icon::RealtimeStatus::StrCat(
+        "Mismatched call to EndStage(", stage,
+        "). Did you call StartStage...(", stage, ")?"));
+  }
+  if (next_stage <= stage) {
+    cycle_.fetch_add(1, std::memory_order_release);
+  }
+  return ready_.Set(StageFlag(next_stage));
+}
+
+void LockstepPipeline::Cancel() {
+  if (auto status = ready_.Set(kCancelledFlag); !status.ok()) {
+    INTRINSIC_RT_LOG_THROTTLED(ERROR) << status.message();
+  }
+}
+
+icon::RealtimeStatus LockstepPipeline::Reset() {
+  if ((ready_.Value() & kCancelledFlag) == 0) {
+    return icon::FailedPreconditionError(
+        "Reset expects a cancelled pipeline.");
+  }
+  running_stage_ = kNoStage;
+  cycle_.store(0, std::memory_order_release);
+  // Clearing all flags at once makes every `StartStage...` wait until stage 0
+  // has been let through below.
+  ready_.Clear(~uint32_t{0});
+  return ready_.Set(StageFlag(0));
+}
+
+}  // namespace intrinsic
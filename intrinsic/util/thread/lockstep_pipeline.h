@@ -0,0 +1,128 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_UTIL_THREAD_LOCKSTEP_PIPELINE_H_
+#define INTRINSIC_UTIL_THREAD_LOCKSTEP_PIPELINE_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "absl/time/time.h"
+#include "intrinsic/icon/interprocess/futex_event_group.h"
+#include "intrinsic/icon/utils/realtime_status.h"
+
+namespace intrinsic {
+
+// LockstepPipeline generalizes Lockstep to a ring of N stages, e.g. sensor
+// emulation -> control -> physics -> render, each typically running on its
+// own thread.
+//
+// Code between `StartStage...(i)` and `EndStage(i)` is referred to as
+// "Stage i". The pipeline ensures that the stages are performed (to
+// completion, with mutual exclusion) in the order
+//
+//    Stage 0
+//    Stage 1
+//    ...
+//    Stage N-1
+//    Stage 0
+//    ...
+//
+// Attempts to perform the stages in any other order block in
+// `StartStage...()`. Stage 0 goes first.
+//
+// All stages share one FutexEventGroup with a flag per stage, so ending a
+// stage costs a single wake-up of exactly the thread that waits for the next
+// stage. Chaining N-1 Lockstep instances instead costs two futex round trips
+// per stage boundary.
+//
+// `cycle()` counts how often the ring wrapped around. Stages that only have
+// work in some cycles, e.g. rendering every tenth physics step, can be
+// skipped with `EndStageAndSkipTo()`, so that their threads are not woken up
+// at all in the other cycles.
+//
+// The implementation is designed to be efficient (using low-level futexes) and
+// is intended for realtime use.
+class LockstepPipeline {
+ public:
+  // One futex flag is used per stage and one for cancellation.
+  static constexpr int kMaxStages = 31;
+
+  // `num_stages` must be in [1, kMaxStages].
+  explicit LockstepPipeline(int num_stages);
+  LockstepPipeline(const LockstepPipeline &other) = delete;
+  LockstepPipeline &operator=(const LockstepPipeline &other) = delete;
+
+  int num_stages() const { return num_stages_; }
+
+  // Blocks the current thread until `stage` is ready to begin or the timeout
+  // has expired. Similar to StartStageWithDeadline except that this uses a
+  // timeout instead of a deadline.
+  //
+  // Returns early when `Cancel()` has been called.
+  // For concurrent calls with the same `stage`, only one returns.
+  //
+  // Returns `OkStatus` on success. Otherwise, returns an error, in which case
+  // user code *should not* perform the stage. Returns `kAborted` if `Cancel()`
+  // has been called, `kInvalidArgument` if `stage` is out of range, and
+  // `kDeadlineExceeded` if the underlying futex wait timed out or `kInternal`
+  // in case of an internal futex error.
+  icon::RealtimeStatus StartStageWithTimeout(int stage, absl::Duration timeout);
+
+  // Blocks the current thread until `stage` is ready to begin or the deadline
+  // has expired. Similar to StartStageWithTimeout except that this uses a
+  // deadline instead of a timeout.
+  //
+  // Returns the same errors as StartStageWithTimeout().
+  icon::RealtimeStatus StartStageWithDeadline(int stage, absl::Time deadline);
+
+  // Signals that `stage` has completed, potentially waking the thread that is
+  // waiting to start the next stage in the ring.
+  //
+  // Returns `OkStatus` on success (including if `Cancel()` has been called).
+  // Returns `kFailedPrecondition` if a matching StartStage...(stage) has not
+  // been called.
+  icon::RealtimeStatus EndStage(int stage);
+
+  // Like EndStage(), but lets `next_stage` begin instead of the stage after
+  // `stage`. The stages in between are skipped for this round of the ring and
+  // their threads keep sleeping. If `next_stage` is not after `stage`, i.e.
+  // `next_stage <= stage`, the ring wraps around and `cycle()` increases.
+  //
+  // Additionally returns `kInvalidArgument` if `next_stage` is out of range.
+  icon::RealtimeStatus EndStageAndSkipTo(int stage, int next_stage);
+
+  // Returns how often the ring has wrapped around, i.e. the number of started
+  // cycles minus one. Stage 0 of the first cycle runs in cycle zero.
+  //
+  // The returned value is only exact inside a stage; it does not change while
+  // a stage runs.
+  uint64_t cycle() const { return cycle_.load(std::memory_order_acquire); }
+
+  // Signals to all threads waiting on `StartStage...()` to wake up and return
+  // `kAborted`. All subsequent calls to `StartStage...()` will return
+  // `kAborted` until `Reset()` is called.
+  void Cancel();
+
+  // Resets the pipeline to its initial state, where Stage 0 of cycle zero goes
+  // first. Must only be called after `Cancel`, and thus should not be called
+  // inside any stage. Returns `kFailedPrecondition` if the pipeline is not
+  // cancelled.
+  icon::RealtimeStatus Reset();
+
+ private:
+  static constexpr int kNoStage = -1;
+  static constexpr uint32_t kCancelledFlag = uint32_t{1} << kMaxStages;
+  static constexpr uint32_t StageFlag(int stage) {
+    return uint32_t{1} << stage;
+  }
+
+  const int num_stages_;
+  // Holds the flag of the stage that may start next, and `kCancelledFlag`.
+  icon::FutexEventGroup ready_{StageFlag(0)};
+  std::atomic<int> running_stage_ = kNoStage;
+  std::atomic<uint64_t> cycle_ = 0;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_UTIL_THREAD_LOCKSTEP_PIPELINE_H_
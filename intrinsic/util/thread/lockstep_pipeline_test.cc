@@ -0,0 +1,163 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/thread/lockstep_pipeline.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+namespace {
+
+using ::testing::ElementsAreArray;
+
+constexpr absl::Duration kTimeout = absl::Seconds(10);
+constexpr absl::Duration kShortTimeout = absl::Milliseconds(50);
+
+// A stage that ran, and the cycle in which it ran.
+struct Step {
+  int stage;
+  uint64_t cycle;
+
+  bool operator==(const Step& other) const {
+    return stage == other.stage && cycle == other.cycle;
+  }
+};
+
+TEST(LockstepPipelineTest, RunsStagesOfManyThreadsInOrder) {
+  constexpr int kNumStages = 3;
+  constexpr int kNumCycles = 200;
+  LockstepPipeline pipeline(kNumStages);
+  // Only written inside of stages, which exclude each other.
+  std::vector<Step> steps;
+  std::vector<Thread> threads;
+  for (int stage = kNumStages - 1; stage >= 0; --stage) {
+    threads.emplace_back([&pipeline, &steps, stage] {
+      for (int i = 0; i < kNumCycles; ++i) {
+        ASSERT_TRUE(pipeline.StartStageWithTimeout(stage, kTimeout).ok());
+        steps.push_back({stage, pipeline.cycle()});
+        ASSERT_TRUE(pipeline.EndStage(stage).ok());
+      }
+    });
+  }
+  for (Thread& thread : threads) {
+    thread.Join();
+  }
+
+  std::vector<Step> expected;
+  for (int cycle = 0; cycle < kNumCycles; ++cycle) {
+    for (int stage = 0; stage < kNumStages; ++stage) {
+      expected.push_back({stage, static_cast<uint64_t>(cycle)});
+    }
+  }
+  EXPECT_THAT(steps, ElementsAreArray(expected));
+}
+
+TEST(LockstepPipelineTest, SkipsStages) {
+  LockstepPipeline pipeline(3);
+  ASSERT_TRUE(pipeline.StartStageWithTimeout(0, kTimeout).ok());
+  ASSERT_TRUE(pipeline.EndStageAndSkipTo(0, 2).ok());
+  EXPECT_EQ(pipeline.StartStageWithTimeout(1, kShortTimeout).code(),
+            absl::StatusCode::kDeadlineExceeded);
+  ASSERT_TRUE(pipeline.StartStageWithTimeout(2, kTimeout).ok());
+  EXPECT_EQ(pipeline.cycle(), 0);
+  // Wraps around to stage 1 of the next cycle.
+  ASSERT_TRUE(pipeline.EndStageAndSkipTo(2, 1).ok());
+  EXPECT_EQ(pipeline.cycle(), 1);
+  EXPECT_EQ(pipeline.StartStageWithTimeout(0, kShortTimeout).code(),
+            absl::StatusCode::kDeadlineExceeded);
+  EXPECT_TRUE(pipeline.StartStageWithTimeout(1, kTimeout).ok());
+}
+
+TEST(LockstepPipelineTest, RejectsMisuse) {
+  LockstepPipeline pipeline(2);
+  EXPECT_EQ(pipeline.StartStageWithTimeout(2, kTimeout).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(pipeline.StartStageWithTimeout(-1, kTimeout).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(pipeline.EndStage(0).code(),
+            absl::StatusCode::kFailedPrecondition);
+  EXPECT_EQ(pipeline.StartStageWithTimeout(1, kShortTimeout).code(),
+            absl::StatusCode::kDeadlineExceeded);
+  ASSERT_TRUE(pipeline.StartStageWithTimeout(0, kTimeout).ok());
+  EXPECT_EQ(pipeline.EndStage(1).code(),
+            absl::StatusCode::kFailedPrecondition);
+  EXPECT_EQ(pipeline.EndStageAndSkipTo(0, 2).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_TRUE(pipeline.EndStage(0).ok());
+  EXPECT_EQ(pipeline.Reset().code(), absl::StatusCode::kFailedPrecondition);
+}
+
+TEST(LockstepPipelineTest, CancelWakesBlockedStages) {
+  LockstepPipeline pipeline(3);
+  ASSERT_TRUE(pipeline.StartStageWithTimeout(0, kTimeout).ok());
+
+  // Stage 0 never ends, so both of these block until the cancellation.
+  std::vector<absl::StatusCode> codes(2);
+  std::vector<Thread> threads;
+  for (int stage : {1, 2}) {
+    threads.emplace_back([&pipeline, &codes, stage] {
+      codes[stage - 1] = pipeline.StartStageWithTimeout(stage, kTimeout).code();
+    });
+  }
+  absl::SleepFor(kShortTimeout);
+  const absl::Time cancel_time = absl::Now();
+  pipeline.Cancel();
+  for (Thread& thread : threads) {
+    thread.Join();
+  }
+  EXPECT_LT(absl::Now() - cancel_time, kTimeout / 2);
+  EXPECT_EQ(codes[0], absl::StatusCode::kAborted);
+  EXPECT_EQ(codes[1], absl::StatusCode::kAborted);
+
+  // Stays cancelled, and ending the running stage is not an error.
+  EXPECT_EQ(pipeline.StartStageWithTimeout(1, kTimeout).code(),
+            absl::StatusCode::kAborted);
+  EXPECT_TRUE(pipeline.EndStage(0).ok());
+
+  ASSERT_TRUE(pipeline.Reset().ok());
+  EXPECT_EQ(pipeline.cycle(), 0);
+  EXPECT_EQ(pipeline.StartStageWithTimeout(1, kShortTimeout).code(),
+            absl::StatusCode::kDeadlineExceeded);
+  ASSERT_TRUE(pipeline.StartStageWithTimeout(0, kTimeout).ok());
+  EXPECT_TRUE(pipeline.EndStage(0).ok());
+}
+
+TEST(LockstepPipelineTest, CancelStopsRunningPipeline) {
+  constexpr int kNumStages = 2;
+  LockstepPipeline pipeline(kNumStages);
+  absl::Notification running;
+  std::vector<int> num_steps(kNumStages);
+  std::vector<Thread> threads;
+  for (int stage = 0; stage < kNumStages; ++stage) {
+    threads.emplace_back([&, stage] {
+      while (pipeline.StartStageWithTimeout(stage, kTimeout).ok()) {
+        if (++num_steps[stage] == 100 && stage == 0) {
+          running.Notify();
+        }
+        (void)pipeline.EndStage(stage);
+      }
+    });
+  }
+  ASSERT_TRUE(running.WaitForNotificationWithTimeout(kTimeout));
+  pipeline.Cancel();
+  for (Thread& thread : threads) {
+    thread.Join();
+  }
+  // Stage 1 ran after every step of stage 0 but possibly the last one.
+  EXPECT_GE(num_steps[0], 100);
+  EXPECT_GE(num_steps[1], num_steps[0] - 1);
+  EXPECT_LE(num_steps[1], num_steps[0]);
+}
+
+}  // namespace
+}  // namespace intrinsic
@@ -13,8 +13,12 @@
 #include <errno.h>
 #include <pthread.h>
 #include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #endif
 
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <optional>
 #include <string>
@@ -27,8 +31,11 @@
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "intrinsic/icon/utils/log.h"
 #include "intrinsic/icon/utils/realtime_guard.h"
+#include "intrinsic/icon/utils/trace_event.h"
+#include "intrinsic/util/memory_lock.h"
 #include "intrinsic/util/status/status_macros.h"
 
 namespace intrinsic {
@@ -42,6 +49,70 @@ absl::string_view ShortName(absl::string_view name) {
                            Thread::GetMaxNameLength() - 1);
 }
 
+#if defined(__linux__)
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE 6
+#endif
+
+// Mirrors the kernel's struct sched_attr, which older C libraries lack, like
+// they lack a sched_setattr() wrapper.
+struct SchedAttr {
+  uint32_t size;
+  uint32_t sched_policy;
+  uint64_t sched_flags;
+  int32_t sched_nice;
+  uint32_t sched_priority;
+  uint64_t sched_runtime;
+  uint64_t sched_deadline;
+  uint64_t sched_period;
+};
+
+// Children of the thread start under the normal scheduler. Without this, the
+// kernel refuses to fork() deadline threads.
+constexpr uint64_t kSchedFlagResetOnFork = 0x01;
+
+// Applies `schedule` to the calling thread.
+absl::Status SetCurrentThreadDeadlineSchedule(
+    const Thread::DeadlineSchedule& schedule) {
+  SchedAttr attr = {};
+  attr.size = sizeof(attr);
+  attr.sched_policy = SCHED_DEADLINE;
+  attr.sched_flags = kSchedFlagResetOnFork;
+  attr.sched_runtime = absl::ToInt64Nanoseconds(schedule.runtime);
+  attr.sched_deadline = absl::ToInt64Nanoseconds(schedule.deadline);
+  attr.sched_period = absl::ToInt64Nanoseconds(schedule.period);
+  if (syscall(SYS_sched_setattr, 0, &attr, 0) == 0) {
+    return absl::OkStatus();
+  }
+  const int errnum = errno;
+  constexpr char kFailed[] = "Failed to set the deadline schedule.";
+  switch (errnum) {
+    case ENOSYS:
+      return absl::UnimplementedError(absl::StrCat(
+          kFailed, " The kernel does not support SCHED_DEADLINE."));
+    case EINVAL:
+      // Also covers values that pass Validate(), e.g. a runtime below the
+      // kernel's resolution or a period above its limit.
+      return absl::InvalidArgumentError(absl::StrCat(
+          kFailed, " The kernel rejected the schedule, runtime: ",
+          absl::FormatDuration(schedule.runtime),
+          ", deadline: ", absl::FormatDuration(schedule.deadline),
+          ", period: ", absl::FormatDuration(schedule.period)));
+    case EPERM:
+      return absl::PermissionDeniedError(absl::StrCat(
+          kFailed, " The caller does not have appropriate privileges."));
+    case EBUSY:
+      return absl::ResourceExhaustedError(absl::StrCat(
+          kFailed, " Admission control rejected the budget, runtime: ",
+          absl::FormatDuration(schedule.runtime),
+          ", period: ", absl::FormatDuration(schedule.period)));
+    default:
+      return absl::InternalError(
+          absl::StrCat(kFailed, " ", std::strerror(errnum)));
+  }
+}
+#endif
+
 }  // namespace
 
 // The settings are platform-dependent on Linux.
@@ -80,6 +151,20 @@ Thread::Options& Thread::Options::SetAffinity(const std::vector<int>& cpus) {
   return *this;
 }
 
+Thread::Options& Thread::Options::SetDeadlineScheduler(
+    const DeadlineSchedule& schedule) {
+  deadline_schedule_ = schedule;
+  if (deadline_schedule_->period == absl::ZeroDuration()) {
+    deadline_schedule_->period = deadline_schedule_->deadline;
+  }
+  return *this;
+}
+
+Thread::Options& Thread::Options::SetStackPrefault(size_t bytes) {
+  stack_prefault_ = bytes;
+  return *this;
+}
+
 Thread::Options& Thread::Options::SetName(absl::string_view name) {
   name_ = std::string(name);
   return *this;
@@ -117,6 +202,8 @@ absl::Status Thread::SetupAndStart(const Options& options,
     return absl::FailedPreconditionError("Thread can only be Start()ed once.");
   }
 
+  INTR_RETURN_IF_ERROR(Validate(options));
+
   std::shared_ptr<ThreadSetup> thread_setup = std::make_shared<ThreadSetup>();
   thread_impl_ =
       std::thread(&Thread::ThreadBody, std::move(f), options, thread_setup);
@@ -132,6 +219,88 @@ absl::Status Thread::SetupAndStart(const Options& options,
     Join();
     return setup_status;
   }
+  if (options.GetStackPrefault() > 0 ||
+      options.GetDeadlineSchedule().has_value()) {
+    absl::Status in_thread_status;
+    {
+      absl::MutexLock lock(&thread_setup->mutex);
+      thread_setup->mutex.Await(absl::Condition(
+          +[](const std::optional<absl::Status>* status) {
+            return status->has_value();
+          },
+          &thread_setup->in_thread_status));
+      in_thread_status = *thread_setup->in_thread_status;
+    }
+    if (!in_thread_status.ok()) {
+      Join();
+      return in_thread_status;
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status Thread::Validate(const Options& options) {
+  if (!options.GetDeadlineSchedule().has_value()) {
+    return absl::OkStatus();
+  }
+  const DeadlineSchedule& schedule = *options.GetDeadlineSchedule();
+  if (options.GetPriority().has_value() ||
+      options.GetSchedulePolicy().has_value()) {
+    return absl::InvalidArgumentError(
+        "A deadline schedule excludes a priority and a schedule policy.");
+  }
+  if (!options.GetCpuSet().empty()) {
+    return absl::InvalidArgumentError(
+        "A deadline schedule excludes a CPU affinity, since the kernel only "
+        "admits deadline threads that may run on all CPUs of their root "
+        "domain.");
+  }
+  if (schedule.runtime <= absl::ZeroDuration() ||
+      schedule.runtime > schedule.deadline ||
+      schedule.deadline > schedule.period) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "A deadline schedule requires 0 < runtime <= deadline <= period, got "
+        "runtime: ",
+        absl::FormatDuration(schedule.runtime),
+        ", deadline: ", absl::FormatDuration(schedule.deadline),
+        ", period: ", absl::FormatDuration(schedule.period)));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status Thread::SetupInThread(const Options& options) {
+  // Prefaults the stack before the deadline schedule applies, so that the
+  // prefault does not count against the budget.
+  if (options.GetStackPrefault() > 0) {
+    INTR_RETURN_IF_ERROR(
+        PrefaultCurrentThreadStack(options.GetStackPrefault()));
+  }
+  if (!options.GetDeadlineSchedule().has_value()) {
+    return absl::OkStatus();
+  }
+#if !defined(__linux__)
+  absl::Status status = absl::UnimplementedError(
+      "Deadline scheduling is not currently supported for this platform.");
+#else
+  absl::Status status =
+      SetCurrentThreadDeadlineSchedule(*options.GetDeadlineSchedule());
+#endif
+  if (status.ok() || options.GetDeadlineSchedule()->required) {
+    return status;
+  }
+  LOG(WARNING) << "Running thread '" << options.GetName().value_or("")
+               << "' under the normal scheduler instead: " << status;
+#if defined(__linux__)
+  // Don't inherit a real-time schedule from the creating thread.
+  sched_param sch;
+  sch.sched_priority = 0;
+  if (int errnum = pthread_setschedparam(pthread_self(), SCHED_OTHER, &sch);
+      errnum != 0) {
+    return absl::InternalError(
+        absl::StrCat("Failed to fall back to the normal scheduler. ",
+                     std::strerror(errnum)));
+  }
+#endif
   return absl::OkStatus();
 }
 
@@ -253,7 +422,7 @@ absl::Status Thread::SetName(const Options& options) {
 }
 
 void Thread::ThreadBody(absl::AnyInvocable<void()> f, const Options& options,
-                        std::shared_ptr<const ThreadSetup> thread_setup) {
+                        std::shared_ptr<ThreadSetup> thread_setup) {
   // Don't do work that can fail here, since we can't return a status from
   // `thread_impl_`'s thread of execution.
   {
@@ -268,9 +437,25 @@ void Thread::ThreadBody(absl::AnyInvocable<void()> f, const Options& options,
     }
   }
 
+  // Prefaults the stack and applies the deadline schedule here, since only the
+  // thread itself can, and reports the result to Start().
+  if (options.GetStackPrefault() > 0 ||
+      options.GetDeadlineSchedule().has_value()) {
+    absl::Status in_thread_status = SetupInThread(options);
+    const bool in_thread_ok = in_thread_status.ok();
+    {
+      absl::MutexLock lock(&thread_setup->mutex);
+      thread_setup->in_thread_status = std::move(in_thread_status);
+    }
+    if (!in_thread_ok) {
+      return;
+    }
+  }
+
   const std::string short_name(ShortName(options.GetName().value_or("")));
 
   RtLogInitForThisThread();
+  icon::TraceInitForThisThread(short_name.empty() ? "thread" : short_name);
 
   f();
 }
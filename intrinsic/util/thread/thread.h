@@ -3,6 +3,7 @@
 #ifndef INTRINSIC_UTIL_THREAD_THREAD_H_
 #define INTRINSIC_UTIL_THREAD_THREAD_H_
 
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
@@ -16,6 +17,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "absl/types/optional.h"
 #include "intrinsic/icon/utils/realtime_guard.h"
 
@@ -25,6 +27,26 @@ namespace intrinsic {
 // multiple functions to execute concurrently.
 class Thread {
  public:
+  // Budget of a thread under the SCHED_DEADLINE policy: the thread gets
+  // `runtime` of CPU time within `deadline` of the start of every `period`.
+  // See https://docs.kernel.org/scheduler/sched-deadline.html.
+  struct DeadlineSchedule {
+    absl::Duration runtime;
+    absl::Duration deadline;
+    // Defaults to `deadline` if zero.
+    absl::Duration period = absl::ZeroDuration();
+    // If false, and the kernel does not support SCHED_DEADLINE, the process
+    // may not use it, the kernel rejects the values or its admission control
+    // rejects the budget, the thread logs a warning and runs under the normal
+    // scheduler instead. If true, Start() fails in that case.
+    bool required = false;
+
+    bool operator==(const DeadlineSchedule& other) const {
+      return runtime == other.runtime && deadline == other.deadline &&
+             period == other.period && required == other.required;
+    }
+  };
+
   // Options for the thread. These allow for non-default behavior of the thread.
   class Options {
    public:
@@ -71,6 +93,25 @@ class Thread {
     // your code.
     Options& SetSchedulePolicy(int policy);
 
+    // Runs the thread under the SCHED_DEADLINE policy with `schedule`. Suits
+    // periodic, non-critical workers such as log drains and status publishers:
+    // the kernel limits them to their budget, so they can neither starve nor
+    // disturb the real-time threads.
+    //
+    // Excludes SetPriority(), SetSchedulePolicy(), the Set*Scheduler() methods
+    // and SetAffinity(), since the kernel only admits deadline threads that
+    // may run on all CPUs of their root domain. Isolated CPUs (isolcpus) are
+    // not part of that domain, so deadline threads never run on the CPUs of
+    // isolated control threads. Start() returns InvalidArgumentError for such
+    // combinations, and for a `schedule` that does not satisfy
+    // 0 < runtime <= deadline <= period.
+    Options& SetDeadlineScheduler(const DeadlineSchedule& schedule);
+
+    // Prefaults and locks `bytes` of the thread's stack before running its
+    // function, so that a real-time thread does not fault on its stack without
+    // locking all memory of the process. See PrefaultCurrentThreadStack().
+    Options& SetStackPrefault(size_t bytes);
+
     // Returns the priority, which may be unset.
     std::optional<int> GetPriority() const { return priority_; }
 
@@ -83,6 +124,14 @@ class Thread {
     // Returns an empty vector if the affinity is unset.
     const std::vector<int>& GetCpuSet() const { return cpus_; }
 
+    // Returns 0 if no stack prefault is set.
+    size_t GetStackPrefault() const { return stack_prefault_; }
+
+    // Returns the deadline schedule, which may be unset.
+    const std::optional<DeadlineSchedule>& GetDeadlineSchedule() const {
+      return deadline_schedule_;
+    }
+
    private:
     std::optional<int> priority_;
     std::optional<int> policy_;
@@ -93,6 +142,8 @@ class Thread {
     // a zero-sized vector is considered to be unset, since it makes no sense to
     // specify that a thread runs on no cpus.
     std::vector<int> cpus_;
+    size_t stack_prefault_ = 0;
+    std::optional<DeadlineSchedule> deadline_schedule_;
   };
 
   // Default constructs a Thread object, no new thread of execution is created
@@ -144,6 +195,10 @@ class Thread {
     enum class State { kInitializing, kFailed, kSucceeded };
     mutable absl::Mutex mutex;
     State state ABSL_GUARDED_BY(mutex) = State::kInitializing;
+    // Set by the new thread of execution once it applied the options that only
+    // it can apply, if Options::SetStackPrefault() or
+    // Options::SetDeadlineScheduler() was used.
+    std::optional<absl::Status> in_thread_status ABSL_GUARDED_BY(mutex);
   };
 
   // maximum length that can be used for a posix thread name.
@@ -163,12 +218,18 @@ class Thread {
   absl::Status SetAffinity(const Options& options);
   absl::Status SetName(const Options& options);
 
+  // Returns InvalidArgumentError for contradicting `options`.
+  static absl::Status Validate(const Options& options);
+  // Applies the options that the new thread of execution must apply to
+  // itself. Runs in that thread.
+  static absl::Status SetupInThread(const Options& options);
+
   // Runs in the new thread of execution `thread_impl_`. Waits until thread
   // setup is done, then either proceeds to run the user provided function `f`,
   // or in case of setup failure, join the `thread_impl_` and finish executing
   // the thread without running `f`.
   static void ThreadBody(absl::AnyInvocable<void()> f, const Options& options,
-                         std::shared_ptr<const ThreadSetup> thread_setup);
+                         std::shared_ptr<ThreadSetup> thread_setup);
 
   std::thread thread_impl_;  // The new thread of execution
 };
@@ -190,7 +251,8 @@ Thread::Thread(Function&& f, Args&&... args)
 inline bool operator==(const Thread::Options& lhs, const Thread::Options& rhs) {
   return lhs.GetPriority() == rhs.GetPriority() &&
          lhs.GetSchedulePolicy() == rhs.GetSchedulePolicy() &&
-         lhs.GetCpuSet() == rhs.GetCpuSet();
+         lhs.GetCpuSet() == rhs.GetCpuSet() &&
+         lhs.GetDeadlineSchedule() == rhs.GetDeadlineSchedule();
 }
 
 inline bool operator!=(const Thread::Options& lhs, const Thread::Options& rhs) {
@@ -0,0 +1,328 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/thread/thread_pool.h"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/optimization.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+#include "intrinsic/icon/interprocess/binary_futex.h"
+#include "intrinsic/platform/common/buffers/rt_mpsc_queue.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+namespace {
+
+constexpr uint32_t kNoSlot = std::numeric_limits<uint32_t>::max();
+constexpr uint64_t kSlotMask = std::numeric_limits<uint32_t>::max();
+
+// A bounded Chase-Lev deque of job slots, following "Correct and Efficient
+// Work-Stealing for Weak Memory Models" (Lê et al., PPoPP 2013). The owner
+// pushes and pops at the bottom, other threads steal from the top.
+class WorkStealingDeque {
+ public:
+  explicit WorkStealingDeque(size_t min_capacity)
+      : mask_(std::bit_ceil(min_capacity) - 1),
+        slots_(std::make_unique<std::atomic<uint32_t>[]>(mask_ + 1)) {}
+
+  // Owner only. The deque must have space, which holds if it is at least as
+  // large as the number of job slots.
+  void Push(uint32_t slot) {
+    const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    slots_[bottom & mask_].store(slot, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  // Owner only. Returns the newest slot, or -1 if empty.
+  int64_t Pop() {
+    const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return -1;
+    }
+    int64_t slot = slots_[bottom & mask_].load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // Last element, race against thieves.
+      if (!top_.compare_exchange_strong(top, top + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        slot = -1;
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return slot;
+  }
+
+  // Thread safe. Returns the oldest slot, or -1 if empty or if another thread
+  // took it first.
+  int64_t Steal() {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return -1;
+    }
+    const uint32_t slot = slots_[top & mask_].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return -1;
+    }
+    return slot;
+  }
+
+  // Thread safe, but may be outdated immediately.
+  bool Empty() const {
+    return top_.load(std::memory_order_relaxed) >=
+           bottom_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  const size_t mask_;
+  std::unique_ptr<std::atomic<uint32_t>[]> slots_;
+  ABSL_CACHELINE_ALIGNED std::atomic<int64_t> top_ = 0;
+  ABSL_CACHELINE_ALIGNED std::atomic<int64_t> bottom_ = 0;
+};
+
+// The pool and index of the worker running on this thread, if any.
+thread_local const ThreadPool* s_current_pool = nullptr;
+thread_local int s_current_worker = -1;
+
+}  // namespace
+
+struct ThreadPool::Worker {
+  explicit Worker(size_t capacity) : inbox(capacity), deque(capacity) {}
+
+  // Jobs submitted from outside of the pool. Only the owner takes them out
+  // and moves them to `deque`, where other workers can steal them.
+  RealtimeMpscQueue<uint32_t> inbox;
+  WorkStealingDeque deque;
+  // Set while the worker is about to wait for `wake`.
+  std::atomic<bool> sleeping = false;
+  icon::BinaryFutex wake;
+  Thread thread;
+};
+
+// static
+absl::StatusOr<std::unique_ptr<ThreadPool>> ThreadPool::Create(
+    const Options& options) {
+  if (options.num_workers <= 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Number of workers must be positive, got ", options.num_workers));
+  }
+  if (options.capacity == 0 || options.capacity >= kNoSlot) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Capacity must be in [1, ", kNoSlot, "), got ", options.capacity));
+  }
+  if (options.pin_workers_to_cpus &&
+      options.worker_options.GetCpuSet().empty()) {
+    return absl::InvalidArgumentError(
+        "Cannot pin workers to CPUs without a CPU set in the worker options");
+  }
+  // Private constructor, so no make_unique.
+  std::unique_ptr<ThreadPool> pool = absl::WrapUnique(new ThreadPool(options));
+  // On errors, the destructor joins the workers that started.
+  INTR_RETURN_IF_ERROR(pool->Start(options));
+  return pool;
+}
+
+ThreadPool::ThreadPool(const Options& options)
+    : num_workers_(options.num_workers),
+      capacity_(options.capacity),
+      jobs_(std::make_unique<Job[]>(options.capacity)),
+      next_free_(
+          std::make_unique<std::atomic<uint32_t>[]>(options.capacity)),
+      free_head_(0) {
+  for (size_t i = 0; i < capacity_; ++i) {
+    next_free_[i].store(i + 1 < capacity_ ? i + 1 : kNoSlot,
+                        std::memory_order_relaxed);
+  }
+  workers_.reserve(num_workers_);
+  for (int i = 0; i < num_workers_; ++i) {
+    workers_.push_back(std::make_unique<Worker>(capacity_));
+  }
+}
+
+ThreadPool::~ThreadPool() { Stop(); }
+
+absl::Status ThreadPool::Start(const Options& options) {
+  const std::vector<int>& cpus = options.worker_options.GetCpuSet();
+  for (int i = 0; i < num_workers_; ++i) {
+    Thread::Options worker_options = options.worker_options;
+    if (std::optional<std::string> name = worker_options.GetName();
+        name.has_value()) {
+      worker_options.SetName(absl::StrCat(*name, "_", i));
+    }
+    if (options.pin_workers_to_cpus) {
+      worker_options.SetAffinity({cpus[i % cpus.size()]});
+    }
+    INTR_RETURN_IF_ERROR(workers_[i]->thread.Start(
+        worker_options, &ThreadPool::RunWorker, this, i));
+  }
+  return absl::OkStatus();
+}
+
+void ThreadPool::Stop() {
+  stop_.store(true, std::memory_order_release);
+  for (std::unique_ptr<Worker>& worker : workers_) {
+    (void)worker->wake.Post();
+  }
+  for (std::unique_ptr<Worker>& worker : workers_) {
+    if (worker->thread.Joinable()) {
+      worker->thread.Join();
+    }
+  }
+}
+
+bool ThreadPool::TrySubmit(Job job) {
+  const int64_t slot = AllocateSlot();
+  if (slot < 0) {
+    return false;
+  }
+  jobs_[slot] = std::move(job);
+  if (s_current_pool == this) {
+    // Keeps the job local, and lets the next worker steal it if it is idle.
+    workers_[s_current_worker]->deque.Push(slot);
+    if (num_workers_ > 1) {
+      Wake(*workers_[(s_current_worker + 1) % num_workers_]);
+    }
+    return true;
+  }
+  Worker& worker =
+      *workers_[next_worker_.fetch_add(1, std::memory_order_relaxed) %
+                num_workers_];
+  // Cannot fail, since the inbox has room for all slots.
+  if (!worker.inbox.Insert(static_cast<uint32_t>(slot))) [[unlikely]] {
+    jobs_[slot] = nullptr;
+    FreeSlot(slot);
+    return false;
+  }
+  Wake(worker);
+  return true;
+}
+
+absl::Status ThreadPool::Submit(Job job) {
+  if (!TrySubmit(std::move(job))) {
+    return absl::ResourceExhaustedError(
+        absl::StrCat("Thread pool is full with ", capacity_, " jobs"));
+  }
+  return absl::OkStatus();
+}
+
+int64_t ThreadPool::AllocateSlot() {
+  uint64_t head = free_head_.load(std::memory_order_acquire);
+  while (true) {
+    const uint32_t slot = head & kSlotMask;
+    if (slot == kNoSlot) {
+      return -1;
+    }
+    // May read the link of a slot that another thread just took, but then
+    // the tag changed, and the exchange fails.
+    const uint64_t next = next_free_[slot].load(std::memory_order_relaxed);
+    const uint64_t tag = (head >> 32) + 1;
+    if (free_head_.compare_exchange_weak(head, (tag << 32) | next,
+                                         std::memory_order_acquire,
+                                         std::memory_order_acquire)) {
+      return slot;
+    }
+  }
+}
+
+void ThreadPool::FreeSlot(uint32_t slot) {
+  uint64_t head = free_head_.load(std::memory_order_relaxed);
+  while (true) {
+    next_free_[slot].store(head & kSlotMask, std::memory_order_relaxed);
+    const uint64_t tag = (head >> 32) + 1;
+    if (free_head_.compare_exchange_weak(head, (tag << 32) | slot,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+
+int64_t ThreadPool::FindJob(int worker_index) {
+  Worker& self = *workers_[worker_index];
+  // Moves submitted jobs to the deque, so that other workers can steal them.
+  bool moved_jobs = false;
+  while (std::optional<uint32_t> slot = self.inbox.Pop()) {
+    self.deque.Push(*slot);
+    moved_jobs = true;
+  }
+  const int64_t slot = self.deque.Pop();
+  if (moved_jobs && !self.deque.Empty() && num_workers_ > 1) {
+    Wake(*workers_[(worker_index + 1) % num_workers_]);
+  }
+  if (slot >= 0) {
+    return slot;
+  }
+  for (int i = 1; i < num_workers_; ++i) {
+    const int64_t stolen =
+        workers_[(worker_index + i) % num_workers_]->deque.Steal();
+    if (stolen >= 0) {
+      return stolen;
+    }
+  }
+  return -1;
+}
+
+// static
+void ThreadPool::Wake(Worker& worker) {
+  // Pairs with the fence in RunWorker(): Either the worker sees the new job,
+  // or this sees that the worker sleeps.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (worker.sleeping.load(std::memory_order_relaxed)) {
+    (void)worker.wake.Post();
+  }
+}
+
+void ThreadPool::RunWorker(int worker_index) {
+  s_current_pool = this;
+  s_current_worker = worker_index;
+  Worker& self = *workers_[worker_index];
+  while (true) {
+    int64_t slot = FindJob(worker_index);
+    if (slot < 0) {
+      self.sleeping.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      slot = FindJob(worker_index);
+      if (slot < 0) {
+        if (stop_.load(std::memory_order_acquire)) {
+          break;
+        }
+        (void)self.wake.WaitUntil(absl::InfiniteFuture());
+      }
+      self.sleeping.store(false, std::memory_order_relaxed);
+      if (slot < 0) {
+        continue;
+      }
+    }
+    // Frees the slot before running the job, so that it can submit itself
+    // again.
+    Job job = std::move(jobs_[slot]);
+    jobs_[slot] = nullptr;
+    FreeSlot(slot);
+    std::move(job)();
+  }
+  s_current_pool = nullptr;
+  s_current_worker = -1;
+}
+
+}  // namespace intrinsic
@@ -0,0 +1,132 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_UTIL_THREAD_THREAD_POOL_H_
+#define INTRINSIC_UTIL_THREAD_THREAD_POOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "intrinsic/icon/testing/realtime_annotations.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+
+// A work-stealing pool of threads that runs short-lived jobs, so that they do
+// not pay the cost of creating a Thread each.
+//
+// The workers are started with the same Thread::Options as single threads,
+// so they can run with real-time priority and on a set of CPUs, e.g. the one
+// from ReadCpuAffinitySetFromCommandLine():
+//
+//   INTR_ASSIGN_OR_RETURN(absl::flat_hash_set<int> cpu_set,
+//                         ReadCpuAffinitySetFromCommandLine());
+//   std::vector<int> cpus(cpu_set.begin(), cpu_set.end());
+//   absl::c_sort(cpus);
+//   INTR_ASSIGN_OR_RETURN(
+//       std::unique_ptr<ThreadPool> pool,
+//       ThreadPool::Create({
+//           .num_workers = static_cast<int>(cpus.size()),
+//           .worker_options = Thread::Options()
+//                                 .SetName("rt_pool")
+//                                 .SetRealtimeLowPriorityAndScheduler()
+//                                 .SetAffinity(cpus),
+//           .pin_workers_to_cpus = true,
+//       }));
+//   if (!pool->TrySubmit([&counter] { ++counter; })) {
+//     // The pool already has Options::capacity jobs.
+//   }
+//
+// Each worker has a deque of jobs. A worker runs the newest job of its own
+// deque, and steals the oldest job of another worker's deque when its own is
+// empty. Jobs submitted from outside of the pool are handed to the workers in
+// turn through lock-free queues; jobs submitted from a job go to the deque of
+// its worker.
+//
+// Submitting does not lock and does not allocate, since all jobs live in
+// preallocated slots, so it is real-time safe. Only wrapping a callable with
+// large captures into a Job may allocate, which real-time code must avoid.
+class ThreadPool {
+ public:
+  using Job = absl::AnyInvocable<void()>;
+
+  struct Options {
+    // Number of worker threads. Must be positive.
+    int num_workers = 1;
+    // Options of the worker threads. If a name is set, worker `i` is named
+    // "<name>_<i>".
+    Thread::Options worker_options;
+    // If true, worker `i` only runs on the CPU
+    // worker_options.GetCpuSet()[i % size] instead of on all of them.
+    bool pin_workers_to_cpus = false;
+    // Maximum number of jobs that wait to run. Must be positive.
+    size_t capacity = 1024;
+  };
+
+  // Not real-time safe. Starts the workers.
+  //
+  // Returns InvalidArgumentError if the options are invalid, and the error of
+  // Thread::Start() if a worker cannot be started.
+  static absl::StatusOr<std::unique_ptr<ThreadPool>> Create(
+      const Options& options) INTRINSIC_NON_REALTIME_ONLY;
+
+  // Not real-time safe. Runs all submitted jobs, then stops the workers.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Thread safe and real-time safe. Schedules `job` to run on one of the
+  // workers. Returns false, and drops `job`, if Options::capacity jobs wait to
+  // run.
+  ABSL_MUST_USE_RESULT bool TrySubmit(Job job) INTRINSIC_CHECK_REALTIME_SAFE;
+
+  // Thread safe. Like TrySubmit(), but returns ResourceExhaustedError if the
+  // pool is full.
+  absl::Status Submit(Job job);
+
+  int num_workers() const { return num_workers_; }
+
+ private:
+  struct Worker;
+
+  explicit ThreadPool(const Options& options);
+
+  // Starts the threads of the workers.
+  absl::Status Start(const Options& options);
+  // Stops and joins all started workers.
+  void Stop();
+
+  // Returns the index of a free job slot, or -1.
+  int64_t AllocateSlot();
+  void FreeSlot(uint32_t slot);
+
+  // Returns the slot of a job for worker `worker_index`, or -1 if there is
+  // none.
+  int64_t FindJob(int worker_index);
+  // Wakes `worker` if it waits for jobs.
+  static void Wake(Worker& worker);
+  void RunWorker(int worker_index);
+
+  const int num_workers_;
+  const size_t capacity_;
+  std::unique_ptr<Job[]> jobs_;
+  // Free list of job slots. The lower 32 bits of `free_head_` are the first
+  // free slot, the upper bits a tag against ABA races.
+  std::unique_ptr<std::atomic<uint32_t>[]> next_free_;
+  std::atomic<uint64_t> free_head_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // Worker that receives the next job submitted from outside of the pool.
+  std::atomic<uint32_t> next_worker_ = 0;
+  std::atomic<bool> stop_ = false;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_UTIL_THREAD_THREAD_POOL_H_
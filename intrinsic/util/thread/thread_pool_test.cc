@@ -0,0 +1,180 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/util/thread/thread_pool.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "intrinsic/util/testing/gtest_wrapper.h"
+#include "intrinsic/util/thread/thread.h"
+
+namespace intrinsic {
+namespace {
+
+using ::intrinsic::testing::StatusIs;
+
+constexpr absl::Duration kTimeout = absl::Seconds(10);
+
+std::unique_ptr<ThreadPool> CreatePool(int num_workers, size_t capacity) {
+  absl::StatusOr<std::unique_ptr<ThreadPool>> pool = ThreadPool::Create(
+      {.num_workers = num_workers, .capacity = capacity});
+  EXPECT_OK(pool.status());
+  return *std::move(pool);
+}
+
+TEST(ThreadPoolTest, RejectsInvalidOptions) {
+  EXPECT_THAT(ThreadPool::Create({.num_workers = 0}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ThreadPool::Create({.capacity = 0}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ThreadPool::Create({.pin_workers_to_cpus = true}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ThreadPoolTest, RunsJobsSubmittedConcurrentlyFromManyThreads) {
+  constexpr int kNumSubmitters = 8;
+  constexpr int kJobsPerSubmitter = 2000;
+  std::atomic<int> num_runs = 0;
+  {
+    std::unique_ptr<ThreadPool> pool =
+        CreatePool(/*num_workers=*/4,
+                   /*capacity=*/kNumSubmitters * kJobsPerSubmitter);
+    std::vector<Thread> submitters;
+    for (int i = 0; i < kNumSubmitters; ++i) {
+      submitters.emplace_back([&pool, &num_runs] {
+        for (int j = 0; j < kJobsPerSubmitter; ++j) {
+          EXPECT_TRUE(pool->TrySubmit([&num_runs] { ++num_runs; }));
+        }
+      });
+    }
+    for (Thread& submitter : submitters) {
+      submitter.Join();
+    }
+  }
+  EXPECT_EQ(num_runs, kNumSubmitters * kJobsPerSubmitter);
+}
+
+TEST(ThreadPoolTest, IdleWorkerStealsJobOfBlockedWorker) {
+  std::unique_ptr<ThreadPool> pool =
+      CreatePool(/*num_workers=*/2, /*capacity=*/8);
+  absl::Notification stolen_job_ran;
+  std::thread::id blocked_worker;
+  std::thread::id stealing_worker;
+  absl::Notification done;
+  ASSERT_TRUE(pool->TrySubmit([&] {
+    blocked_worker = std::this_thread::get_id();
+    // Goes to the deque of this worker, which does not return to it before the
+    // job ran, so only the other worker can run it.
+    EXPECT_TRUE(pool->TrySubmit([&] {
+      stealing_worker = std::this_thread::get_id();
+      stolen_job_ran.Notify();
+    }));
+    EXPECT_TRUE(stolen_job_ran.WaitForNotificationWithTimeout(kTimeout));
+    done.Notify();
+  }));
+  ASSERT_TRUE(done.WaitForNotificationWithTimeout(kTimeout));
+  EXPECT_NE(stealing_worker, blocked_worker);
+}
+
+TEST(ThreadPoolTest, TrySubmitReturnsFalseAtCapacity) {
+  constexpr size_t kCapacity = 4;
+  std::unique_ptr<ThreadPool> pool =
+      CreatePool(/*num_workers=*/1, kCapacity);
+  absl::Notification started;
+  absl::Notification release;
+  ASSERT_TRUE(pool->TrySubmit([&] {
+    started.Notify();
+    release.WaitForNotification();
+  }));
+  // The running job no longer takes a slot.
+  ASSERT_TRUE(started.WaitForNotificationWithTimeout(kTimeout));
+
+  std::atomic<int> num_runs = 0;
+  for (size_t i = 0; i < kCapacity; ++i) {
+    EXPECT_TRUE(pool->TrySubmit([&num_runs] { ++num_runs; }));
+  }
+  EXPECT_FALSE(pool->TrySubmit([&num_runs] { ++num_runs; }));
+  EXPECT_THAT(pool->Submit([&num_runs] { ++num_runs; }),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+
+  release.Notify();
+  pool.reset();
+  EXPECT_EQ(num_runs, kCapacity);
+}
+
+TEST(ThreadPoolTest, JobsSubmitJobs) {
+  constexpr int kNumChildren = 100;
+  constexpr int kChainLength = 1000;
+  std::unique_ptr<ThreadPool> pool =
+      CreatePool(/*num_workers=*/3, /*capacity=*/2 * kNumChildren);
+
+  // Fans out into children from a job.
+  std::atomic<int> num_children = 0;
+  ASSERT_TRUE(pool->TrySubmit([&] {
+    for (int i = 0; i < kNumChildren; ++i) {
+      EXPECT_TRUE(pool->TrySubmit([&num_children] { ++num_children; }));
+    }
+  }));
+
+  // Resubmits itself, which frees its slot before running.
+  std::atomic<int> chain_length = 0;
+  absl::Notification chain_done;
+  absl::AnyInvocable<void()> link = [&] {
+    if (++chain_length == kChainLength) {
+      chain_done.Notify();
+      return;
+    }
+    EXPECT_TRUE(pool->TrySubmit([&link] { link(); }));
+  };
+  ASSERT_TRUE(pool->TrySubmit([&link] { link(); }));
+  ASSERT_TRUE(chain_done.WaitForNotificationWithTimeout(kTimeout));
+
+  pool.reset();
+  EXPECT_EQ(num_children, kNumChildren);
+  EXPECT_EQ(chain_length, kChainLength);
+}
+
+TEST(ThreadPoolTest, DestructorRunsAllQueuedJobs) {
+  constexpr int kNumJobs = 500;
+  std::atomic<int> num_runs = 0;
+  absl::BlockingCounter started(2);
+  absl::Notification release;
+  std::unique_ptr<ThreadPool> pool =
+      CreatePool(/*num_workers=*/2, /*capacity=*/kNumJobs + 2);
+  // Blocks both workers, so that all other jobs are still queued when the
+  // destructor starts.
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(pool->TrySubmit([&] {
+      started.DecrementCount();
+      release.WaitForNotification();
+    }));
+  }
+  started.Wait();
+  for (int i = 0; i < kNumJobs; ++i) {
+    ASSERT_TRUE(pool->TrySubmit([&num_runs] { ++num_runs; }));
+  }
+
+  Thread releaser([&release] {
+    absl::SleepFor(absl::Milliseconds(50));
+    release.Notify();
+  });
+  pool.reset();
+  releaser.Join();
+  EXPECT_EQ(num_runs, kNumJobs);
+}
+
+}  // namespace
+}  // namespace intrinsic
@@ -2,14 +2,21 @@
 
 #include "intrinsic/util/thread/util.h"
 
+#include <poll.h>
 #include <sched.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <cerrno>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <ios>
 #include <iterator>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
@@ -25,6 +32,7 @@
 #include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "intrinsic/util/status/status_macros.h"
 #include "re2/re2.h"
 
@@ -66,28 +74,33 @@ absl::StatusOr<absl::flat_hash_set<int>> ReadCpuAffinitySetFromCommandLine(
   INTR_ASSIGN_OR_RETURN(std::string rcu_nocbs,
                         ReadFileToString(path_for_testing));
 
-  // Can be a single entry, a range, or a mix.
-  // https://man7.org/linux/man-pages/man7/cpuset.7.html
-  //  Examples of the List Format:
-  //    0-4,9           # bits 0, 1, 2, 3, 4, and 9 set
-  //    0-2,7,12-14     # bits 0, 1, 2, 7, 12, 13, and 14 set
   // External build is broken when using absl::string_view.
   std::string entries = "";
 
   // Group1 is the affinity definition.
   const RE2 kRCU_NOCBSRegex(R"(rcu_nocbs=([^\s]+))");
-  // Every comma separated affinity entry matches one of those regexes.
-  // The regex ensures that the CPU index cannot be negative.
-  const RE2 kSingleEntryRegex(R"(([\d]+))");
-  const RE2 kRangeRegex(R"(([\d]+)-([\d]+))");
 
   if (!RE2::PartialMatch(rcu_nocbs, kRCU_NOCBSRegex, &entries)) {
     return absl::FailedPreconditionError(
         absl::StrCat("Failed to parse [", path_for_testing,
                      "]. 'rcu_nocbs' is not defined."));
   }
+  return ParseCpuList(entries);
+}
+
+absl::StatusOr<absl::flat_hash_set<int>> ParseCpuList(absl::string_view list) {
+  // Can be a single entry, a range, or a mix.
+  // https://man7.org/linux/man-pages/man7/cpuset.7.html
+  //  Examples of the List Format:
+  //    0-4,9           # bits 0, 1, 2, 3, 4, and 9 set
+  //    0-2,7,12-14     # bits 0, 1, 2, 7, 12, 13, and 14 set
+  // Every comma separated affinity entry matches one of those regexes.
+  // The regex ensures that the CPU index cannot be negative.
+  const RE2 kSingleEntryRegex(R"(([\d]+))");
+  const RE2 kRangeRegex(R"(([\d]+)-([\d]+))");
+
   std::vector<std::string> cpu_strings =
-      absl::StrSplit(entries, ',', absl::SkipWhitespace());
+      absl::StrSplit(list, ',', absl::SkipWhitespace());
   absl::flat_hash_set<int> values;
   for (const absl::string_view entry : cpu_strings) {
     // Removes the AsciiWhitespace that may be present.
@@ -145,4 +158,105 @@ bool WaitForNotificationWithDeadlineAndInterrupt(
   return notification.HasBeenNotified();
 }
 
+// static
+absl::StatusOr<FdNotification> FdNotification::Create() {
+  const int fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (fd < 0) {
+    return absl::InternalError(
+        absl::StrCat("Creating an eventfd failed: ", std::strerror(errno)));
+  }
+  return FdNotification(fd);
+}
+
+FdNotification::FdNotification(FdNotification&& other)
+    : fd_(std::exchange(other.fd_, -1)) {}
+
+FdNotification& FdNotification::operator=(FdNotification&& other) {
+  if (this != &other) {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+    fd_ = std::exchange(other.fd_, -1);
+  }
+  return *this;
+}
+
+FdNotification::~FdNotification() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void FdNotification::Notify() {
+  if (fd_ < 0) {
+    return;
+  }
+  // The counter is never reset, so the fd stays readable.
+  const uint64_t value = 1;
+  if (write(fd_, &value, sizeof(value)) != sizeof(value)) {
+    LOG(WARNING) << "Signaling an eventfd failed: " << std::strerror(errno);
+  }
+}
+
+bool FdNotification::HasBeenNotified() const {
+  if (fd_ < 0) {
+    return false;
+  }
+  pollfd poll_fd = {.fd = fd_, .events = POLLIN};
+  return poll(&poll_fd, 1, /*timeout=*/0) == 1;
+}
+
+absl::StatusOr<size_t> WaitForReadableFd(absl::Span<const int> fds,
+                                         absl::Time deadline) {
+  if (fds.empty()) {
+    return absl::InvalidArgumentError("No file descriptors to wait for");
+  }
+  std::vector<pollfd> poll_fds;
+  poll_fds.reserve(fds.size());
+  for (int fd : fds) {
+    if (fd < 0) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Cannot wait for file descriptor ", fd));
+    }
+    poll_fds.push_back({.fd = fd, .events = POLLIN});
+  }
+  while (true) {
+    timespec timeout;
+    timespec* timeout_ptr = nullptr;
+    if (deadline != absl::InfiniteFuture()) {
+      timeout = absl::ToTimespec(
+          std::max(deadline - absl::Now(), absl::ZeroDuration()));
+      timeout_ptr = &timeout;
+    }
+    const int ready =
+        ppoll(poll_fds.data(), poll_fds.size(), timeout_ptr, nullptr);
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return absl::InternalError(
+          absl::StrCat("poll failed: ", std::strerror(errno)));
+    }
+    for (size_t i = 0; i < poll_fds.size(); ++i) {
+      if (poll_fds[i].revents != 0) {
+        return i;
+      }
+    }
+    if (absl::Now() >= deadline) {
+      return absl::DeadlineExceededError(
+          "No file descriptor became readable before the deadline");
+    }
+  }
+}
+
+bool WaitForNotificationWithInterrupt(const FdNotification& notification,
+                                      int interrupt_fd, absl::Time deadline) {
+  const int fds[] = {notification.fd(), interrupt_fd};
+  if (absl::Status status = WaitForReadableFd(fds, deadline).status();
+      !status.ok() && !absl::IsDeadlineExceeded(status)) {
+    LOG(WARNING) << "Waiting for a notification failed: " << status;
+  }
+  return notification.HasBeenNotified();
+}
+
 }  // namespace intrinsic
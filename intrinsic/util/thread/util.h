@@ -6,6 +6,7 @@
 #include <sched.h>
 #include <unistd.h>
 
+#include <cstddef>
 #include <string>
 
 #include "absl/base/attributes.h"
@@ -15,6 +16,7 @@
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/notification.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 
 namespace intrinsic {
 
@@ -26,10 +28,18 @@ namespace intrinsic {
 absl::StatusOr<absl::flat_hash_set<int>> ReadCpuAffinitySetFromCommandLine(
     absl::string_view path_for_testing = "/proc/cmdline");
 
+// Parses a CPU list in the List Format of cpuset(7), e.g. "0-2,7,12-14", as
+// used by the kernel command line and sysfs.
+// Returns FailedPreconditionError on parsing errors and duplicate CPUs.
+absl::StatusOr<absl::flat_hash_set<int>> ParseCpuList(absl::string_view list);
+
 // Like Notification::WaitForNotification, but the user also provides a function
 // that is polled periodically to determine whether to quit waiting. If the
 // function returns false, we stop waiting and return the current value of
 // notification.HasBeenNotified(). If it returns true, we keep waiting.
+//
+// Wakes up every `poll_interval`. Prefer the FdNotification overload below,
+// which only wakes up when the notification or the interrupt fires.
 bool WaitForNotificationWithInterrupt(
     absl::Notification& notification, absl::AnyInvocable<bool()> should_quit,
     absl::Duration poll_interval = absl::Milliseconds(100));
@@ -44,6 +54,55 @@ bool WaitForNotificationWithDeadlineAndInterrupt(
     absl::AnyInvocable<bool()> should_quit,
     absl::Duration poll_interval = absl::Milliseconds(100));
 
+// A one-shot notification, like absl::Notification, backed by an eventfd. A
+// thread can wait for several of them, and for other file descriptors such as
+// SkillCanceller::cancellation_fd(), at once with WaitForReadableFd(). Unlike
+// the polling functions above, the waiting thread only wakes up once one of
+// them fires.
+class FdNotification {
+ public:
+  // Returns an InternalError if the eventfd cannot be created.
+  static absl::StatusOr<FdNotification> Create();
+
+  FdNotification(FdNotification&& other);
+  FdNotification& operator=(FdNotification&& other);
+  ~FdNotification();
+
+  // Marks the notification as notified and makes fd() readable. Repeated calls
+  // have no effect.
+  void Notify();
+
+  bool HasBeenNotified() const;
+
+  // Becomes readable once notified, and stays readable afterwards. Must
+  // neither be read from nor closed.
+  int fd() const { return fd_; }
+
+ private:
+  explicit FdNotification(int fd) : fd_(fd) {}
+
+  int fd_;
+};
+
+// Waits until one of `fds` becomes readable, or until `deadline`, without
+// waking up in between. Returns the index of the first readable file
+// descriptor in `fds`.
+//
+// Returns DeadlineExceededError if none became readable before `deadline`,
+// InvalidArgumentError if `fds` is empty or contains a negative file
+// descriptor, and InternalError if poll(2) fails.
+absl::StatusOr<size_t> WaitForReadableFd(
+    absl::Span<const int> fds, absl::Time deadline = absl::InfiniteFuture());
+
+// Event-driven variant of WaitForNotificationWithDeadlineAndInterrupt(): waits
+// until `notification` is notified, until `interrupt_fd` becomes readable
+// (e.g. the fd() of another FdNotification, or
+// SkillCanceller::cancellation_fd()), or until `deadline`, and returns
+// notification.HasBeenNotified().
+bool WaitForNotificationWithInterrupt(
+    const FdNotification& notification, int interrupt_fd,
+    absl::Time deadline = absl::InfiniteFuture());
+
 }  // namespace intrinsic
 
 #endif  // INTRINSIC_UTIL_THREAD_UTIL_H_
@@ -0,0 +1,166 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/world/objects/collision_rule_matrix.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/world/objects/object_world_ids.h"
+#include "intrinsic/world/objects/world_object.h"
+#include "intrinsic/world/proto/collision_settings.pb.h"
+
+namespace intrinsic {
+namespace world {
+
+namespace {
+
+// Object ids, object names and entity ids are interned in the same index, so
+// they are told apart by a prefix.
+std::string ObjectIdKey(absl::string_view id) {
+  return absl::StrCat("object:", id);
+}
+std::string ObjectNameKey(absl::string_view name) {
+  return absl::StrCat("name:", name);
+}
+std::string EntityIdKey(absl::string_view id) {
+  return absl::StrCat("entity:", id);
+}
+
+absl::StatusOr<std::string> ReferenceKey(
+    const intrinsic_proto::world::ObjectOrEntityReference& reference) {
+  switch (reference.type_case()) {
+    case intrinsic_proto::world::ObjectOrEntityReference::kObject:
+      if (reference.object().has_by_name()) {
+        return ObjectNameKey(reference.object().by_name().object_name());
+      }
+      if (!reference.object().id().empty()) {
+        return ObjectIdKey(reference.object().id());
+      }
+      break;
+    case intrinsic_proto::world::ObjectOrEntityReference::kEntity:
+      if (!reference.entity().id().empty()) {
+        return EntityIdKey(reference.entity().id());
+      }
+      break;
+    default:
+      break;
+  }
+  return absl::InvalidArgumentError(absl::StrCat(
+      "Collision rule references neither an object nor an entity: ",
+      reference.ShortDebugString()));
+}
+
+}  // namespace
+
+absl::StatusOr<CollisionRuleMatrix> CollisionRuleMatrix::Create(
+    const intrinsic_proto::world::CollisionSettings& settings) {
+  CollisionRuleMatrix matrix;
+  matrix.collision_checking_disabled_ = settings.disable_collision_checking();
+
+  // Intern all keys first, so that the matrix is allocated once.
+  struct Rule {
+    std::vector<uint32_t> left;
+    std::vector<uint32_t> right;
+  };
+  std::vector<Rule> rules;
+  for (const auto& collision_rule : settings.collision_rules()) {
+    if (!collision_rule.collision_action().is_excluded()) {
+      continue;
+    }
+    Rule& rule = rules.emplace_back();
+    for (const auto& reference : collision_rule.left()) {
+      INTR_ASSIGN_OR_RETURN(const std::string key, ReferenceKey(reference));
+      rule.left.push_back(matrix.Intern(key));
+    }
+    for (const auto& reference : collision_rule.right()) {
+      INTR_ASSIGN_OR_RETURN(const std::string key, ReferenceKey(reference));
+      rule.right.push_back(matrix.Intern(key));
+    }
+  }
+
+  matrix.words_per_row_ = (matrix.size() + 63) / 64;
+  matrix.bits_.assign(matrix.size() * matrix.words_per_row_, 0);
+  matrix.excluded_from_all_.assign(matrix.size(), false);
+  for (const Rule& rule : rules) {
+    for (uint32_t left : rule.left) {
+      if (rule.right.empty()) {
+        matrix.excluded_from_all_[left] = true;
+      }
+      for (uint32_t right : rule.right) {
+        matrix.Exclude(left, right);
+      }
+    }
+  }
+  return matrix;
+}
+
+CollisionRuleMatrix::Node CollisionRuleMatrix::GetNode(
+    const WorldObject& object) const {
+  Node node;
+  node.indices[0] = Index(ObjectIdKey(object.Id().value()));
+  node.indices[1] = Index(ObjectNameKey(object.Name().value()));
+  return node;
+}
+
+CollisionRuleMatrix::Node CollisionRuleMatrix::GetNode(
+    const WorldObject& object, const ObjectWorldResourceId& entity_id) const {
+  Node node = GetNode(object);
+  node.indices[2] = Index(EntityIdKey(entity_id.value()));
+  return node;
+}
+
+CollisionRuleMatrix::Node CollisionRuleMatrix::GetNode(
+    const ObjectWorldResourceId& object_id,
+    const ObjectWorldResourceId& entity_id) const {
+  Node node;
+  node.indices[0] = Index(ObjectIdKey(object_id.value()));
+  node.indices[2] = Index(EntityIdKey(entity_id.value()));
+  return node;
+}
+
+bool CollisionRuleMatrix::IsExcluded(const Node& a, const Node& b) const {
+  if (collision_checking_disabled_) {
+    return true;
+  }
+  for (const Node* node : {&a, &b}) {
+    for (uint32_t index : node->indices) {
+      if (index != Node::kNone && excluded_from_all_[index]) {
+        return true;
+      }
+    }
+  }
+  for (uint32_t index_a : a.indices) {
+    if (index_a == Node::kNone) {
+      continue;
+    }
+    for (uint32_t index_b : b.indices) {
+      if (index_b != Node::kNone && Test(index_a, index_b)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+uint32_t CollisionRuleMatrix::Index(const std::string& key) const {
+  auto it = index_by_key_.find(key);
+  return it == index_by_key_.end() ? Node::kNone : it->second;
+}
+
+uint32_t CollisionRuleMatrix::Intern(const std::string& key) {
+  return index_by_key_.try_emplace(key, index_by_key_.size()).first->second;
+}
+
+void CollisionRuleMatrix::Exclude(uint32_t a, uint32_t b) {
+  bits_[a * words_per_row_ + b / 64] |= uint64_t{1} << (b % 64);
+  bits_[b * words_per_row_ + a / 64] |= uint64_t{1} << (a % 64);
+}
+
+}  // namespace world
+}  // namespace intrinsic
@@ -0,0 +1,109 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_WORLD_OBJECTS_COLLISION_RULE_MATRIX_H_
+#define INTRINSIC_WORLD_OBJECTS_COLLISION_RULE_MATRIX_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "intrinsic/world/objects/object_world_ids.h"
+#include "intrinsic/world/objects/world_object.h"
+#include "intrinsic/world/proto/collision_settings.pb.h"
+
+namespace intrinsic {
+namespace world {
+
+// The collision exclusion rules of a CollisionSettings, compiled into a
+// symmetric bit matrix for fast local queries, e.g.:
+//
+//   INTR_ASSIGN_OR_RETURN(const auto settings, world.GetCollisionSettings());
+//   INTR_ASSIGN_OR_RETURN(const CollisionRuleMatrix rules,
+//                         CollisionRuleMatrix::Create(settings));
+//   const CollisionRuleMatrix::Node gripper = rules.GetNode(gripper_object);
+//   for (const WorldObject& object : objects) {
+//     if (!rules.IsExcluded(gripper, rules.GetNode(object))) ...
+//   }
+//
+// Every object id, object name and entity id that a rule references is
+// interned into a dense index. A query looks each side up once with GetNode(),
+// after which IsExcluded() tests at most nine bits, independent of the number
+// of rules.
+//
+// Only exclusion rules are compiled. Margin rules, and the minimum margin, do
+// not exclude collisions and are ignored. A matrix is a snapshot: after
+// changing the collision settings of the world, e.g., with
+// ObjectWorldUpdateBuilder::DisableCollisions(), create a new one.
+//
+// Thread-compatible: const methods may be called concurrently.
+class CollisionRuleMatrix {
+ public:
+  // A side of a query: the interned indices of an object id, object name and
+  // entity id, or kNone for those that no rule references.
+  struct Node {
+    static constexpr uint32_t kNone = UINT32_MAX;
+    std::array<uint32_t, 3> indices = {kNone, kNone, kNone};
+  };
+
+  // Compiles the exclusion rules of `settings`.
+  //
+  // Returns InvalidArgumentError if a rule references an object or entity
+  // without an id or name.
+  static absl::StatusOr<CollisionRuleMatrix> Create(
+      const intrinsic_proto::world::CollisionSettings& settings);
+
+  // Returns the node of `object` as a whole.
+  Node GetNode(const WorldObject& object) const;
+
+  // Returns the node of the entity `entity_id` of `object`, which matches
+  // rules that reference the entity or the object.
+  Node GetNode(const WorldObject& object,
+               const ObjectWorldResourceId& entity_id) const;
+
+  // Returns the node of an entity or object, given only its id, which matches
+  // rules that reference either by id.
+  Node GetNode(const ObjectWorldResourceId& object_id,
+               const ObjectWorldResourceId& entity_id) const;
+
+  // Returns true if collisions between `a` and `b` are excluded by a rule, or
+  // collision checking is disabled altogether.
+  bool IsExcluded(const Node& a, const Node& b) const;
+
+  // Returns true if collision checking is disabled for the whole world.
+  bool collision_checking_disabled() const {
+    return collision_checking_disabled_;
+  }
+
+  // Returns the number of interned object ids, object names and entity ids.
+  size_t size() const { return index_by_key_.size(); }
+
+ private:
+  CollisionRuleMatrix() = default;
+
+  // Returns the index of `key`, or Node::kNone if no rule references it.
+  uint32_t Index(const std::string& key) const;
+  // Returns the index of `key`, adding it if it is new.
+  uint32_t Intern(const std::string& key);
+
+  void Exclude(uint32_t a, uint32_t b);
+  bool Test(uint32_t a, uint32_t b) const {
+    return (bits_[a * words_per_row_ + b / 64] >> (b % 64)) & 1;
+  }
+
+  bool collision_checking_disabled_ = false;
+  absl::flat_hash_map<std::string, uint32_t> index_by_key_;
+  size_t words_per_row_ = 0;
+  // Row-major and symmetric, size() rows of `words_per_row_` words.
+  std::vector<uint64_t> bits_;
+  // Keys that are excluded from colliding with anything.
+  std::vector<bool> excluded_from_all_;
+};
+
+}  // namespace world
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_WORLD_OBJECTS_COLLISION_RULE_MATRIX_H_
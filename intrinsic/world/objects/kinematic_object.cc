@@ -87,9 +87,8 @@ std::optional<KinematicObject> KinematicObject::FromTransformNode(
 KinematicObject::KinematicObject(std::shared_ptr<const Data> data)
     : WorldObject(data) {}
 
-eigenmath::VectorXd KinematicObject::JointPositions() const {
-  return RepeatedDoubleToVectorXd(
-      GetData().Proto().kinematic_object_component().joint_positions());
+const eigenmath::VectorXd& KinematicObject::JointPositions() const {
+  return GetData().JointPositions();
 }
 
 const JointLimitsXd& KinematicObject::JointSystemLimits() const {
@@ -100,39 +99,21 @@ const JointLimitsXd& KinematicObject::JointApplicationLimits() const {
   return GetData().JointApplicationLimits();
 }
 
-std::vector<ObjectWorldResourceId> KinematicObject::IsoFlangeFrameIds() const {
-  std::vector<ObjectWorldResourceId> result;
-  for (const intrinsic_proto::world::IdAndName& id_and_name :
-       GetData().Proto().kinematic_object_component().iso_flange_frames()) {
-    result.push_back(ObjectWorldResourceId(id_and_name.id()));
-  }
-  return result;
+const std::vector<ObjectWorldResourceId>& KinematicObject::IsoFlangeFrameIds()
+    const {
+  return GetData().IsoFlangeFrameIds();
 }
 
-std::vector<FrameName> KinematicObject::IsoFlangeFrameNames() const {
-  std::vector<FrameName> result;
-  for (const intrinsic_proto::world::IdAndName& id_and_name :
-       GetData().Proto().kinematic_object_component().iso_flange_frames()) {
-    result.push_back(FrameName(id_and_name.name()));
-  }
-  return result;
+const std::vector<FrameName>& KinematicObject::IsoFlangeFrameNames() const {
+  return GetData().IsoFlangeFrameNames();
 }
 
-std::vector<Frame> KinematicObject::IsoFlangeFrames() const {
-  std::vector<ObjectWorldResourceId> flange_ids = IsoFlangeFrameIds();
-
-  std::vector<Frame> result;
-  result.reserve(flange_ids.size());
-  for (const Frame& frame : GetData().Frames()) {
-    if (absl::c_find(flange_ids, frame.Id()) != flange_ids.end()) {
-      result.push_back(frame);
-    }
-  }
-  return result;
+const std::vector<Frame>& KinematicObject::IsoFlangeFrames() const {
+  return GetData().IsoFlangeFrames();
 }
 
 absl::StatusOr<Frame> KinematicObject::GetSingleIsoFlangeFrame() const {
-  std::vector<Frame> frames = IsoFlangeFrames();
+  const std::vector<Frame>& frames = IsoFlangeFrames();
   if (frames.empty()) {
     return absl::NotFoundError(
         absl::Substitute("Kinematic object \"$0\" does not have any flange "
@@ -183,7 +164,24 @@ KinematicObject::Data::Data(WorldObject::Data data,
       joint_application_limits_(std::move(joint_application_limits)),
       cartesian_limits_(std::move(cartesian_limits)),
       control_frequency_hz_(std::move(control_frequency_hz)),
-      mounted_payload_(std::move(mounted_payload)) {}
+      mounted_payload_(std::move(mounted_payload)),
+      joint_positions_(RepeatedDoubleToVectorXd(
+          Proto().kinematic_object_component().joint_positions())) {
+  for (const intrinsic_proto::world::IdAndName& id_and_name :
+       Proto().kinematic_object_component().iso_flange_frames()) {
+    iso_flange_frame_ids_.emplace_back(id_and_name.id());
+    iso_flange_frame_names_.emplace_back(id_and_name.name());
+  }
+  for (const Frame& frame : Frames()) {
+    if (absl::c_linear_search(iso_flange_frame_ids_, frame.Id())) {
+      iso_flange_frames_.push_back(frame);
+    }
+  }
+}
+
+const eigenmath::VectorXd& KinematicObject::Data::JointPositions() const {
+  return joint_positions_;
+}
 
 const JointLimitsXd& KinematicObject::Data::JointSystemLimits() const {
   return joint_system_limits_;
@@ -207,5 +205,19 @@ const std::optional<RobotPayload>& KinematicObject::Data::MountedPayload()
   return mounted_payload_;
 }
 
+const std::vector<ObjectWorldResourceId>&
+KinematicObject::Data::IsoFlangeFrameIds() const {
+  return iso_flange_frame_ids_;
+}
+
+const std::vector<FrameName>& KinematicObject::Data::IsoFlangeFrameNames()
+    const {
+  return iso_flange_frame_names_;
+}
+
+const std::vector<Frame>& KinematicObject::Data::IsoFlangeFrames() const {
+  return iso_flange_frames_;
+}
+
 }  // namespace world
 }  // namespace intrinsic
@@ -7,6 +7,7 @@
 #include <optional>
 #include <vector>
 
+#include "absl/base/attributes.h"
 #include "absl/status/statusor.h"
 #include "intrinsic/eigenmath/types.h"
 #include "intrinsic/kinematics/types/cartesian_limits.h"
@@ -45,7 +46,8 @@ class KinematicObject : public WorldObject {
 
   // Returns the joint positions in radians (for revolute joints) or meters
   // (for prismatic joints).
-  eigenmath::VectorXd JointPositions() const;
+  const eigenmath::VectorXd& JointPositions() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
   // Returns the system joint limits.
   const JointLimitsXd& JointSystemLimits() const;
@@ -57,9 +59,12 @@ class KinematicObject : public WorldObject {
   // flanges according to the ISO 9787 standard. Not every kinematic object has
   // flange frames, but callers can expect this method to return one flange
   // frame for every "robot arm" contained in the kinematic object.
-  std::vector<ObjectWorldResourceId> IsoFlangeFrameIds() const;
-  std::vector<FrameName> IsoFlangeFrameNames() const;
-  std::vector<Frame> IsoFlangeFrames() const;
+  const std::vector<ObjectWorldResourceId>& IsoFlangeFrameIds() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND;
+  const std::vector<FrameName>& IsoFlangeFrameNames() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND;
+  const std::vector<Frame>& IsoFlangeFrames() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
   // If IsoFlangeFrames() returns exactly one flange frame, returns this flange
   // frame. Otherwise returns an error.
@@ -84,11 +89,15 @@ class KinematicObject : public WorldObject {
          std::optional<double> control_frequency_hz,
          std::optional<RobotPayload> mounted_payload);
 
+    const eigenmath::VectorXd& JointPositions() const;
     const JointLimitsXd& JointSystemLimits() const;
     const JointLimitsXd& JointApplicationLimits() const;
     const intrinsic::CartesianLimits& CartesianLimits() const;
     const std::optional<double>& ControlFrequencyHz() const;
     const std::optional<RobotPayload>& MountedPayload() const;
+    const std::vector<ObjectWorldResourceId>& IsoFlangeFrameIds() const;
+    const std::vector<FrameName>& IsoFlangeFrameNames() const;
+    const std::vector<Frame>& IsoFlangeFrames() const;
 
    private:
     JointLimitsXd joint_system_limits_;
@@ -96,6 +105,11 @@ class KinematicObject : public WorldObject {
     intrinsic::CartesianLimits cartesian_limits_;
     std::optional<double> control_frequency_hz_;
     std::optional<RobotPayload> mounted_payload_;
+    // Derived from Proto() and Frames().
+    eigenmath::VectorXd joint_positions_;
+    std::vector<ObjectWorldResourceId> iso_flange_frame_ids_;
+    std::vector<FrameName> iso_flange_frame_names_;
+    std::vector<Frame> iso_flange_frames_;
   };
 
   explicit KinematicObject(std::shared_ptr<const Data> data);
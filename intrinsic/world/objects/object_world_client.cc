@@ -2,17 +2,28 @@
 
 #include "intrinsic/world/objects/object_world_client.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/base/attributes.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "grpcpp/client_context.h"
 #include "grpcpp/support/status.h"
 #include "intrinsic/eigenmath/types.h"
@@ -27,7 +38,10 @@
 #include "intrinsic/math/proto_conversion.h"
 #include "intrinsic/resources/proto/resource_handle.pb.h"
 #include "intrinsic/skills/proto/equipment.pb.h"
+#include "intrinsic/util/allocation_tracking.h"
 #include "intrinsic/util/eigen.h"
+#include "intrinsic/util/grpc/channel.h"
+#include "intrinsic/util/grpc/connection_params.h"
 #include "intrinsic/util/status/status_conversion_grpc.h"
 #include "intrinsic/util/status/status_macros.h"
 #include "intrinsic/world/objects/frame.h"
@@ -36,12 +50,14 @@
 #include "intrinsic/world/objects/object_world_ids.h"
 #include "intrinsic/world/objects/transform_node.h"
 #include "intrinsic/world/objects/world_object.h"
+#include "intrinsic/world/objects/world_watcher.h"
 #include "intrinsic/world/proto/collision_settings.pb.h"
 #include "intrinsic/world/proto/object_world_refs.pb.h"
 #include "intrinsic/world/proto/object_world_service.grpc.pb.h"
 #include "intrinsic/world/proto/object_world_service.pb.h"
 #include "intrinsic/world/proto/object_world_updates.pb.h"
 #include "intrinsic/world/robot_payload/robot_payload.h"
+#include "intrinsic/world/robot_payload/robot_payload_library.h"
 
 namespace intrinsic {
 namespace world {
@@ -53,25 +69,34 @@ using ::intrinsic_proto::world::TransformNodeReferenceByName;
 
 namespace {
 
+// Full names of the read methods, which select their CallPolicy.
+constexpr char kGetObjectMethod[] =
+    "/intrinsic_proto.world.ObjectWorldService/GetObject";
+constexpr char kGetFrameMethod[] =
+    "/intrinsic_proto.world.ObjectWorldService/GetFrame";
+constexpr char kListObjectsMethod[] =
+    "/intrinsic_proto.world.ObjectWorldService/ListObjects";
+constexpr char kGetWorldMethod[] =
+    "/intrinsic_proto.world.ObjectWorldService/GetWorld";
+constexpr char kGetTransformMethod[] =
+    "/intrinsic_proto.world.ObjectWorldService/GetTransform";
+
+ABSL_CONST_INIT LazyAllocationTag kWorldAllocationTag("object_world_client");
+
 absl::StatusOr<intrinsic_proto::world::Object> CallGetObjectUsingFullView(
-    intrinsic_proto::world::GetObjectRequest request,
+    intrinsic_proto::world::GetObjectRequest request, const CallPolicy& policy,
     intrinsic_proto::world::ObjectWorldService::StubInterface&
         object_world_service) {
-  grpc::ClientContext ctx;
-  intrinsic_proto::world::Object response;
   request.set_view(intrinsic_proto::world::ObjectView::FULL);
-  INTR_RETURN_IF_ERROR(
-      ToAbslStatus(object_world_service.GetObject(&ctx, request, &response)));
-  return response;
+  return CallWithPolicy<intrinsic_proto::world::Object>(
+      policy, [&](grpc::ClientContext* ctx,
+                  intrinsic_proto::world::Object* response) {
+        return object_world_service.GetObject(ctx, request, response);
+      });
 }
 
-absl::StatusOr<WorldObject> GetObjectAsWorldObject(
-    intrinsic_proto::world::GetObjectRequest request,
-    intrinsic_proto::world::ObjectWorldService::StubInterface&
-        object_world_service) {
-  INTR_ASSIGN_OR_RETURN(
-      intrinsic_proto::world::Object proto,
-      CallGetObjectUsingFullView(std::move(request), object_world_service));
+absl::StatusOr<WorldObject> ToWorldObject(
+    intrinsic_proto::world::Object proto) {
   if (proto.type() == intrinsic_proto::world::ObjectType::KINEMATIC_OBJECT) {
     INTR_ASSIGN_OR_RETURN(KinematicObject kinematic_object,
                           KinematicObject::Create(std::move(proto)));
@@ -80,15 +105,55 @@ absl::StatusOr<WorldObject> GetObjectAsWorldObject(
   return WorldObject::Create(std::move(proto));
 }
 
-absl::StatusOr<Frame> CallGetFrame(
+absl::StatusOr<intrinsic_proto::world::Frame> CallGetFrame(
     const intrinsic_proto::world::GetFrameRequest& request,
+    const CallPolicy& policy,
     intrinsic_proto::world::ObjectWorldService::StubInterface&
         object_world_service) {
-  grpc::ClientContext ctx;
-  intrinsic_proto::world::Frame response;
-  INTR_RETURN_IF_ERROR(
-      ToAbslStatus(object_world_service.GetFrame(&ctx, request, &response)));
-  return Frame::Create(std::move(response));
+  return CallWithPolicy<intrinsic_proto::world::Frame>(
+      policy, [&](grpc::ClientContext* ctx,
+                  intrinsic_proto::world::Frame* response) {
+        return object_world_service.GetFrame(ctx, request, response);
+      });
+}
+
+// Starts a call for each of `requests` with `start_call`, which must invoke its
+// last argument once the call has finished, and waits for all of them. Returns
+// the responses in order, or the error of the first call that failed. Each
+// call has a deadline of `timeout`.
+template <typename Response, typename Request, typename StartCall>
+absl::StatusOr<std::vector<Response>> CallConcurrently(
+    const std::vector<Request>& requests, absl::Duration timeout,
+    StartCall start_call) {
+  std::vector<grpc::ClientContext> contexts(requests.size());
+  if (timeout != absl::InfiniteDuration()) {
+    const absl::Time deadline = absl::Now() + timeout;
+    for (grpc::ClientContext& context : contexts) {
+      context.set_deadline(absl::ToChronoTime(deadline));
+    }
+  }
+  std::vector<grpc::Status> statuses(requests.size());
+  std::vector<Response> responses(requests.size());
+  absl::BlockingCounter pending(static_cast<int>(requests.size()));
+  for (size_t i = 0; i < requests.size(); ++i) {
+    start_call(&contexts[i], &requests[i], &responses[i],
+               [&statuses, &pending, i](grpc::Status status) {
+                 statuses[i] = std::move(status);
+                 pending.DecrementCount();
+               });
+  }
+  pending.Wait();
+  for (const grpc::Status& status : statuses) {
+    INTR_RETURN_IF_ERROR(ToAbslStatus(status));
+  }
+  return responses;
+}
+
+// Returns a string that changes whenever the world is updated.
+std::string WorldVersion(const intrinsic_proto::world::WorldMetadata& world) {
+  return absl::StrCat(world.last_update().seconds(), ".",
+                      world.last_update().nanos(), "/",
+                      world.world_structure_hash());
 }
 
 absl::Status CallUpdateTransform(
@@ -151,12 +216,378 @@ absl::Status CallCreateFrame(
 
 }  // namespace
 
+// Objects and frames read from one version of the world.
+struct ObjectWorldClient::SnapshotCache {
+  explicit SnapshotCache(const SnapshotCacheOptions& options)
+      : options(options) {}
+
+  const WorldObject* FindObject(const ObjectReference& reference) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    const std::string* id = &reference.id();
+    if (reference.has_by_name()) {
+      auto it = object_ids_by_name.find(reference.by_name().object_name());
+      if (it == object_ids_by_name.end()) {
+        return nullptr;
+      }
+      id = &it->second;
+    }
+    auto it = objects.find(*id);
+    return it == objects.end() ? nullptr : &it->second;
+  }
+
+  void AddObject(const ObjectReference& reference, const WorldObject& object)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    if (reference.has_by_name()) {
+      object_ids_by_name.insert_or_assign(reference.by_name().object_name(),
+                                          object.Id().value());
+    }
+    objects.insert_or_assign(object.Id().value(), object);
+  }
+
+  const intrinsic_proto::world::Frame* FindFrame(
+      const FrameReference& reference) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    const std::string* id = &reference.id();
+    if (reference.has_by_name()) {
+      auto it = frame_ids_by_name.find(
+          std::make_pair(reference.by_name().object_name(),
+                         reference.by_name().frame_name()));
+      if (it == frame_ids_by_name.end()) {
+        return nullptr;
+      }
+      id = &it->second;
+    }
+    auto it = frames.find(*id);
+    return it == frames.end() ? nullptr : &it->second;
+  }
+
+  void AddFrame(const FrameReference& reference,
+                const intrinsic_proto::world::Frame& frame)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    if (reference.has_by_name()) {
+      frame_ids_by_name.insert_or_assign(
+          std::make_pair(reference.by_name().object_name(),
+                         reference.by_name().frame_name()),
+          frame.id());
+    }
+    frames.insert_or_assign(frame.id(), frame);
+  }
+
+  void Clear() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    objects.clear();
+    object_ids_by_name.clear();
+    frames.clear();
+    frame_ids_by_name.clear();
+    ++generation;
+  }
+
+  const SnapshotCacheOptions options;
+
+  absl::Mutex mutex;
+  // Version of the world that the entries were read from, and when to check it
+  // again.
+  std::string world_version ABSL_GUARDED_BY(mutex);
+  absl::Time next_version_check ABSL_GUARDED_BY(mutex) = absl::InfinitePast();
+  // Incremented whenever the entries are dropped, so that reads which started
+  // before are not added.
+  uint64_t generation ABSL_GUARDED_BY(mutex) = 0;
+  // Full views of objects by id, and ids of objects read by name. Copies of
+  // the objects share their data, e.g., their index of frames by name.
+  absl::flat_hash_map<std::string, WorldObject> objects ABSL_GUARDED_BY(mutex);
+  absl::flat_hash_map<std::string, std::string> object_ids_by_name
+      ABSL_GUARDED_BY(mutex);
+  // Frames by id, and ids of frames read by object and frame name.
+  absl::flat_hash_map<std::string, intrinsic_proto::world::Frame> frames
+      ABSL_GUARDED_BY(mutex);
+  absl::flat_hash_map<std::pair<std::string, std::string>, std::string>
+      frame_ids_by_name ABSL_GUARDED_BY(mutex);
+};
+
 ObjectWorldClient::ObjectWorldClient(
     absl::string_view world_id,
     std::shared_ptr<ObjectWorldService::StubInterface> object_world_service)
     : world_id_(world_id),
       object_world_service_(std::move(object_world_service)) {}
 
+ObjectWorldClient::ObjectWorldClient(
+    absl::string_view world_id,
+    std::shared_ptr<ObjectWorldService::StubInterface> object_world_service,
+    const SnapshotCacheOptions& snapshot_cache_options)
+    : world_id_(world_id),
+      object_world_service_(std::move(object_world_service)),
+      snapshot_cache_(std::make_shared<SnapshotCache>(snapshot_cache_options)) {
+}
+
+void ObjectWorldClient::InvalidateSnapshotCache() const {
+  if (snapshot_cache_ == nullptr) {
+    return;
+  }
+  absl::MutexLock lock(&snapshot_cache_->mutex);
+  snapshot_cache_->Clear();
+  // The version is stale as well, since the world has most likely changed.
+  snapshot_cache_->next_version_check = absl::InfinitePast();
+}
+
+absl::Status ObjectWorldClient::FinishUpdate(absl::Status status) const {
+  InvalidateSnapshotCache();
+  return status;
+}
+
+absl::StatusOr<uint64_t> ObjectWorldClient::ValidateSnapshotCache() const {
+  SnapshotCache& cache = *snapshot_cache_;
+  uint64_t generation;
+  {
+    absl::MutexLock lock(&cache.mutex);
+    if (absl::Now() < cache.next_version_check) {
+      return cache.generation;
+    }
+    generation = cache.generation;
+  }
+  const absl::Time check_time = absl::Now();
+  INTR_ASSIGN_OR_RETURN(std::string version, GetWorldVersion());
+
+  absl::MutexLock lock(&cache.mutex);
+  if (cache.generation != generation) {
+    // Invalidated while checking. The next read checks again.
+    return cache.generation;
+  }
+  if (version != cache.world_version) {
+    cache.Clear();
+    cache.world_version = std::move(version);
+  }
+  cache.next_version_check = check_time + cache.options.version_check_interval;
+  return cache.generation;
+}
+
+absl::StatusOr<WorldObject> ObjectWorldClient::GetFullObject(
+    intrinsic_proto::world::GetObjectRequest request) const {
+  ScopedAllocationTag allocation_tag(kWorldAllocationTag);
+  if (snapshot_cache_ == nullptr || !request.has_object()) {
+    INTR_ASSIGN_OR_RETURN(
+        intrinsic_proto::world::Object proto,
+        CallGetObjectUsingFullView(std::move(request),
+                                   call_policies_.For(kGetObjectMethod),
+                                   *object_world_service_));
+    return ToWorldObject(std::move(proto));
+  }
+  INTR_ASSIGN_OR_RETURN(const uint64_t generation, ValidateSnapshotCache());
+  SnapshotCache& cache = *snapshot_cache_;
+  {
+    absl::MutexLock lock(&cache.mutex);
+    if (const WorldObject* object = cache.FindObject(request.object());
+        object != nullptr) {
+      return *object;
+    }
+  }
+  const ObjectReference reference = request.object();
+  INTR_ASSIGN_OR_RETURN(
+      intrinsic_proto::world::Object proto,
+      CallGetObjectUsingFullView(std::move(request),
+                                 call_policies_.For(kGetObjectMethod),
+                                 *object_world_service_));
+  INTR_ASSIGN_OR_RETURN(WorldObject object, ToWorldObject(std::move(proto)));
+  absl::MutexLock lock(&cache.mutex);
+  if (cache.generation == generation) {
+    cache.AddObject(reference, object);
+  }
+  return object;
+}
+
+absl::StatusOr<std::vector<WorldObject>> ObjectWorldClient::GetFullObjects(
+    std::vector<intrinsic_proto::world::GetObjectRequest> requests) const {
+  ScopedAllocationTag allocation_tag(kWorldAllocationTag);
+  std::vector<std::optional<WorldObject>> objects(requests.size());
+  uint64_t generation = 0;
+  // Indices of the objects that are not cached.
+  std::vector<size_t> to_fetch;
+  if (snapshot_cache_ != nullptr) {
+    INTR_ASSIGN_OR_RETURN(generation, ValidateSnapshotCache());
+    absl::MutexLock lock(&snapshot_cache_->mutex);
+    for (size_t i = 0; i < requests.size(); ++i) {
+      if (const WorldObject* object =
+              snapshot_cache_->FindObject(requests[i].object());
+          object != nullptr) {
+        objects[i] = *object;
+      } else {
+        to_fetch.push_back(i);
+      }
+    }
+  } else {
+    for (size_t i = 0; i < requests.size(); ++i) {
+      to_fetch.push_back(i);
+    }
+  }
+
+  std::vector<intrinsic_proto::world::GetObjectRequest> fetch_requests;
+  fetch_requests.reserve(to_fetch.size());
+  for (size_t i : to_fetch) {
+    requests[i].set_view(intrinsic_proto::world::ObjectView::FULL);
+    fetch_requests.push_back(requests[i]);
+  }
+  INTR_ASSIGN_OR_RETURN(
+      std::vector<intrinsic_proto::world::Object> fetched,
+      CallConcurrently<intrinsic_proto::world::Object>(
+          fetch_requests, call_policies_.For(kGetObjectMethod).timeout,
+          [this](grpc::ClientContext* ctx,
+                 const intrinsic_proto::world::GetObjectRequest* request,
+                 intrinsic_proto::world::Object* response,
+                 std::function<void(grpc::Status)> on_done) {
+            // Stubs without an asynchronous interface, such as mocks, are
+            // called one after the other.
+            if (auto* async = object_world_service_->async();
+                async != nullptr) {
+              async->GetObject(ctx, request, response, std::move(on_done));
+            } else {
+              on_done(object_world_service_->GetObject(ctx, *request,
+                                                       response));
+            }
+          }));
+  for (size_t i = 0; i < to_fetch.size(); ++i) {
+    INTR_ASSIGN_OR_RETURN(objects[to_fetch[i]],
+                          ToWorldObject(std::move(fetched[i])));
+  }
+
+  if (snapshot_cache_ != nullptr) {
+    absl::MutexLock lock(&snapshot_cache_->mutex);
+    if (snapshot_cache_->generation == generation) {
+      for (size_t i = 0; i < to_fetch.size(); ++i) {
+        snapshot_cache_->AddObject(fetch_requests[i].object(),
+                                   *objects[to_fetch[i]]);
+      }
+    }
+  }
+  std::vector<WorldObject> result;
+  result.reserve(objects.size());
+  for (std::optional<WorldObject>& object : objects) {
+    result.push_back(*std::move(object));
+  }
+  return result;
+}
+
+absl::StatusOr<WorldObject> ObjectWorldClient::GetObjectWithView(
+    intrinsic_proto::world::GetObjectRequest request,
+    intrinsic_proto::world::ObjectView view) const {
+  if (view == intrinsic_proto::world::ObjectView::FULL) {
+    return GetFullObject(std::move(request));
+  }
+  ScopedAllocationTag allocation_tag(kWorldAllocationTag);
+  request.set_view(view);
+  INTR_ASSIGN_OR_RETURN(
+      intrinsic_proto::world::Object response,
+      CallWithPolicy<intrinsic_proto::world::Object>(
+          call_policies_.For(kGetObjectMethod), [&](grpc::ClientContext* ctx,
+                                 intrinsic_proto::world::Object* response) {
+            return object_world_service_->GetObject(ctx, request, response);
+          }));
+  WorldObject::FullViewLoader load_full_view =
+      MakeFullViewLoader(ObjectWorldResourceId(response.id()));
+  return WorldObject::Create(std::move(response), view,
+                             std::move(load_full_view));
+}
+
+WorldObject::FullViewLoader ObjectWorldClient::MakeFullViewLoader(
+    const ObjectWorldResourceId& id) const {
+  intrinsic_proto::world::GetObjectRequest request;
+  request.set_world_id(world_id_);
+  request.mutable_object()->set_id(id.value());
+  return [request = std::move(request),
+          policy = call_policies_.For(kGetObjectMethod),
+          object_world_service = object_world_service_]() {
+    return CallGetObjectUsingFullView(request, policy, *object_world_service);
+  };
+}
+
+absl::StatusOr<intrinsic_proto::world::Frame> ObjectWorldClient::GetFrameProto(
+    const intrinsic_proto::world::GetFrameRequest& request) const {
+  ScopedAllocationTag allocation_tag(kWorldAllocationTag);
+  if (snapshot_cache_ == nullptr) {
+    return CallGetFrame(request, call_policies_.For(kGetFrameMethod),
+                        *object_world_service_);
+  }
+  INTR_ASSIGN_OR_RETURN(const uint64_t generation, ValidateSnapshotCache());
+  SnapshotCache& cache = *snapshot_cache_;
+  {
+    absl::MutexLock lock(&cache.mutex);
+    if (const intrinsic_proto::world::Frame* frame =
+            cache.FindFrame(request.frame());
+        frame != nullptr) {
+      return *frame;
+    }
+  }
+  INTR_ASSIGN_OR_RETURN(
+      intrinsic_proto::world::Frame frame,
+      CallGetFrame(request, call_policies_.For(kGetFrameMethod),
+                   *object_world_service_));
+  absl::MutexLock lock(&cache.mutex);
+  if (cache.generation == generation) {
+    cache.AddFrame(request.frame(), frame);
+  }
+  return frame;
+}
+
+absl::StatusOr<std::vector<intrinsic_proto::world::Frame>>
+ObjectWorldClient::GetFrameProtos(
+    const std::vector<intrinsic_proto::world::GetFrameRequest>& requests)
+    const {
+  ScopedAllocationTag allocation_tag(kWorldAllocationTag);
+  std::vector<intrinsic_proto::world::Frame> frames(requests.size());
+  uint64_t generation = 0;
+  // Indices of the frames that are not cached.
+  std::vector<size_t> to_fetch;
+  if (snapshot_cache_ != nullptr) {
+    INTR_ASSIGN_OR_RETURN(generation, ValidateSnapshotCache());
+    absl::MutexLock lock(&snapshot_cache_->mutex);
+    for (size_t i = 0; i < requests.size(); ++i) {
+      if (const intrinsic_proto::world::Frame* frame =
+              snapshot_cache_->FindFrame(requests[i].frame());
+          frame != nullptr) {
+        frames[i] = *frame;
+      } else {
+        to_fetch.push_back(i);
+      }
+    }
+  } else {
+    for (size_t i = 0; i < requests.size(); ++i) {
+      to_fetch.push_back(i);
+    }
+  }
+
+  std::vector<intrinsic_proto::world::GetFrameRequest> fetch_requests;
+  fetch_requests.reserve(to_fetch.size());
+  for (size_t i : to_fetch) {
+    fetch_requests.push_back(requests[i]);
+  }
+  INTR_ASSIGN_OR_RETURN(
+      std::vector<intrinsic_proto::world::Frame> fetched,
+      CallConcurrently<intrinsic_proto::world::Frame>(
+          fetch_requests, call_policies_.For(kGetFrameMethod).timeout,
+          [this](grpc::ClientContext* ctx,
+                 const intrinsic_proto::world::GetFrameRequest* request,
+                 intrinsic_proto::world::Frame* response,
+                 std::function<void(grpc::Status)> on_done) {
+            if (auto* async = object_world_service_->async();
+                async != nullptr) {
+              async->GetFrame(ctx, request, response, std::move(on_done));
+            } else {
+              on_done(
+                  object_world_service_->GetFrame(ctx, *request, response));
+            }
+          }));
+
+  if (snapshot_cache_ != nullptr) {
+    absl::MutexLock lock(&snapshot_cache_->mutex);
+    if (snapshot_cache_->generation == generation) {
+      for (size_t i = 0; i < to_fetch.size(); ++i) {
+        snapshot_cache_->AddFrame(fetch_requests[i].frame(), fetched[i]);
+      }
+    }
+  }
+  for (size_t i = 0; i < to_fetch.size(); ++i) {
+    frames[to_fetch[i]] = std::move(fetched[i]);
+  }
+  return frames;
+}
+
 namespace {
 
 absl::StatusOr<TransformNode> GetTransformNodeById(
@@ -235,7 +666,7 @@ absl::StatusOr<WorldObject> ObjectWorldClient::GetObject(
   intrinsic_proto::world::GetObjectRequest request;
   request.set_world_id(world_id_);
   request.mutable_object()->set_id(id.value());
-  return GetObjectAsWorldObject(std::move(request), *object_world_service_);
+  return GetFullObject(std::move(request));
 }
 
 absl::StatusOr<WorldObject> ObjectWorldClient::GetObject(
@@ -243,7 +674,25 @@ absl::StatusOr<WorldObject> ObjectWorldClient::GetObject(
   intrinsic_proto::world::GetObjectRequest request;
   request.set_world_id(world_id_);
   request.mutable_object()->mutable_by_name()->set_object_name(name.value());
-  return GetObjectAsWorldObject(std::move(request), *object_world_service_);
+  return GetFullObject(std::move(request));
+}
+
+absl::StatusOr<WorldObject> ObjectWorldClient::GetObject(
+    const ObjectWorldResourceId& id,
+    intrinsic_proto::world::ObjectView view) const {
+  intrinsic_proto::world::GetObjectRequest request;
+  request.set_world_id(world_id_);
+  request.mutable_object()->set_id(id.value());
+  return GetObjectWithView(std::move(request), view);
+}
+
+absl::StatusOr<WorldObject> ObjectWorldClient::GetObject(
+    const WorldObjectName& name,
+    intrinsic_proto::world::ObjectView view) const {
+  intrinsic_proto::world::GetObjectRequest request;
+  request.set_world_id(world_id_);
+  request.mutable_object()->mutable_by_name()->set_object_name(name.value());
+  return GetObjectWithView(std::move(request), view);
 }
 
 absl::StatusOr<WorldObject> ObjectWorldClient::GetObject(
@@ -251,7 +700,7 @@ absl::StatusOr<WorldObject> ObjectWorldClient::GetObject(
   intrinsic_proto::world::GetObjectRequest request;
   request.set_world_id(world_id_);
   request.set_resource_handle_name(resource_handle.name());
-  return GetObjectAsWorldObject(std::move(request), *object_world_service_);
+  return GetFullObject(std::move(request));
 }
 
 absl::StatusOr<WorldObject> ObjectWorldClient::GetObject(
@@ -259,34 +708,95 @@ absl::StatusOr<WorldObject> ObjectWorldClient::GetObject(
   return GetObject(object.Id());
 }
 
+absl::StatusOr<std::vector<WorldObject>> ObjectWorldClient::GetObjects(
+    absl::Span<const ObjectWorldResourceId> ids) const {
+  std::vector<intrinsic_proto::world::GetObjectRequest> requests(ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    requests[i].set_world_id(world_id_);
+    requests[i].mutable_object()->set_id(ids[i].value());
+  }
+  return GetFullObjects(std::move(requests));
+}
+
+absl::StatusOr<std::vector<WorldObject>> ObjectWorldClient::GetObjects(
+    absl::Span<const WorldObjectName> names) const {
+  std::vector<intrinsic_proto::world::GetObjectRequest> requests(names.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    requests[i].set_world_id(world_id_);
+    requests[i].mutable_object()->mutable_by_name()->set_object_name(
+        names[i].value());
+  }
+  return GetFullObjects(std::move(requests));
+}
+
 absl::StatusOr<std::vector<WorldObject>> ObjectWorldClient::ListObjects()
     const {
+  return ListObjects(intrinsic_proto::world::ObjectView::FULL);
+}
+
+absl::StatusOr<std::vector<WorldObject>> ObjectWorldClient::ListObjects(
+    intrinsic_proto::world::ObjectView view) const {
+  ScopedAllocationTag allocation_tag(kWorldAllocationTag);
   intrinsic_proto::world::ListObjectsRequest request;
   request.set_world_id(world_id_);
-  request.set_view(intrinsic_proto::world::ObjectView::FULL);
-  grpc::ClientContext ctx;
-  intrinsic_proto::world::ListObjectsResponse response;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(
-      object_world_service_->ListObjects(&ctx, request, &response)));
+  request.set_view(view);
+  INTR_ASSIGN_OR_RETURN(
+      intrinsic_proto::world::ListObjectsResponse response,
+      CallWithPolicy<intrinsic_proto::world::ListObjectsResponse>(
+          call_policies_.For(kListObjectsMethod),
+          [&](grpc::ClientContext* ctx,
+              intrinsic_proto::world::ListObjectsResponse* response) {
+            return object_world_service_->ListObjects(ctx, request, response);
+          }));
   std::vector<WorldObject> objects;
   objects.reserve(response.objects_size());
   for (auto&& object_proto : *response.mutable_objects()) {
-    INTR_ASSIGN_OR_RETURN(WorldObject object,
-                          WorldObject::Create(std::move(object_proto)));
+    WorldObject::FullViewLoader load_full_view =
+        MakeFullViewLoader(ObjectWorldResourceId(object_proto.id()));
+    INTR_ASSIGN_OR_RETURN(
+        WorldObject object,
+        WorldObject::Create(std::move(object_proto), view,
+                            std::move(load_full_view)));
     objects.push_back(std::move(object));
   }
   return objects;
 }
 
+absl::StatusOr<std::unique_ptr<WorldWatcher>> ObjectWorldClient::Watch(
+    absl::Duration period, WorldWatcher::ChangeCallback callback) const {
+  return WorldWatcher::Create(
+      period,
+      [this]() { return GetWorldVersion(); },
+      [this]() { return ListObjects(); }, std::move(callback));
+}
+
+absl::StatusOr<std::string> ObjectWorldClient::GetWorldVersion() const {
+  intrinsic_proto::world::GetWorldRequest request;
+  request.set_world_id(world_id_);
+  INTR_ASSIGN_OR_RETURN(
+      intrinsic_proto::world::WorldMetadata response,
+      CallWithPolicy<intrinsic_proto::world::WorldMetadata>(
+          call_policies_.For(kGetWorldMethod),
+          [&](grpc::ClientContext* ctx,
+              intrinsic_proto::world::WorldMetadata* response) {
+            return object_world_service_->GetWorld(ctx, request, response);
+          }));
+  return WorldVersion(response);
+}
+
 absl::StatusOr<std::vector<WorldObjectName>>
 ObjectWorldClient::ListObjectNames() const {
   intrinsic_proto::world::ListObjectsRequest request;
   request.set_world_id(world_id_);
   request.set_view(intrinsic_proto::world::ObjectView::BASIC);
-  grpc::ClientContext ctx;
-  intrinsic_proto::world::ListObjectsResponse response;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(
-      object_world_service_->ListObjects(&ctx, request, &response)));
+  INTR_ASSIGN_OR_RETURN(
+      intrinsic_proto::world::ListObjectsResponse response,
+      CallWithPolicy<intrinsic_proto::world::ListObjectsResponse>(
+          call_policies_.For(kListObjectsMethod),
+          [&](grpc::ClientContext* ctx,
+              intrinsic_proto::world::ListObjectsResponse* response) {
+            return object_world_service_->ListObjects(ctx, request, response);
+          }));
   std::vector<WorldObjectName> objects;
   objects.reserve(response.objects_size());
   for (const auto& object_proto : response.objects()) {
@@ -303,9 +813,8 @@ absl::Status ObjectWorldClient::DeleteObject(const WorldObject& object,
   request.set_force(option == ForceDeleteOption::kForce);
   grpc::ClientContext ctx;
   google::protobuf::Empty response;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(
+  return FinishUpdate(ToAbslStatus(
       object_world_service_->DeleteObject(&ctx, request, &response)));
-  return absl::OkStatus();
 }
 
 absl::StatusOr<KinematicObject> ObjectWorldClient::GetKinematicObject(
@@ -326,15 +835,16 @@ absl::StatusOr<KinematicObject> ObjectWorldClient::GetKinematicObject(
   intrinsic_proto::world::GetObjectRequest request;
   request.set_world_id(world_id_);
   request.mutable_object()->set_id(id.value());
-  INTR_ASSIGN_OR_RETURN(
-      intrinsic_proto::world::Object proto,
-      CallGetObjectUsingFullView(std::move(request), *object_world_service_));
-  if (proto.type() != intrinsic_proto::world::ObjectType::KINEMATIC_OBJECT) {
+  INTR_ASSIGN_OR_RETURN(WorldObject object,
+                        GetFullObject(std::move(request)));
+  std::optional<KinematicObject> kinematic_object =
+      KinematicObject::FromTransformNode(object);
+  if (!kinematic_object.has_value()) {
     return absl::InvalidArgumentError(
         absl::StrCat("The object with id \"", id.value(),
                      "\" exists but it is not a kinematic object."));
   }
-  return KinematicObject::Create(std::move(proto));
+  return *std::move(kinematic_object);
 }
 
 absl::StatusOr<KinematicObject> ObjectWorldClient::GetKinematicObject(
@@ -342,15 +852,16 @@ absl::StatusOr<KinematicObject> ObjectWorldClient::GetKinematicObject(
   intrinsic_proto::world::GetObjectRequest request;
   request.set_world_id(world_id_);
   request.mutable_object()->mutable_by_name()->set_object_name(name.value());
-  INTR_ASSIGN_OR_RETURN(
-      intrinsic_proto::world::Object proto,
-      CallGetObjectUsingFullView(std::move(request), *object_world_service_));
-  if (proto.type() != intrinsic_proto::world::ObjectType::KINEMATIC_OBJECT) {
+  INTR_ASSIGN_OR_RETURN(WorldObject object,
+                        GetFullObject(std::move(request)));
+  std::optional<KinematicObject> kinematic_object =
+      KinematicObject::FromTransformNode(object);
+  if (!kinematic_object.has_value()) {
     return absl::InvalidArgumentError(
         absl::StrCat("The object with name \"", name.value(),
                      "\" exists but it is not a kinematic object."));
   }
-  return KinematicObject::Create(std::move(proto));
+  return *std::move(kinematic_object);
 }
 
 absl::StatusOr<KinematicObject> ObjectWorldClient::GetKinematicObject(
@@ -375,15 +886,16 @@ absl::StatusOr<KinematicObject> ObjectWorldClient::GetKinematicObject(
           icon_position_part.world_robot_collection_name());
     }
   }
-  INTR_ASSIGN_OR_RETURN(
-      intrinsic_proto::world::Object proto,
-      CallGetObjectUsingFullView(std::move(request), *object_world_service_));
-  if (proto.type() != intrinsic_proto::world::ObjectType::KINEMATIC_OBJECT) {
+  INTR_ASSIGN_OR_RETURN(WorldObject object,
+                        GetFullObject(std::move(request)));
+  std::optional<KinematicObject> kinematic_object =
+      KinematicObject::FromTransformNode(object);
+  if (!kinematic_object.has_value()) {
     return absl::InvalidArgumentError(absl::StrCat(
         "The object associated with the resource handle name \"",
         resource_handle.name(), "\" exists but it is not a kinematic object."));
   }
-  return KinematicObject::Create(std::move(proto));
+  return *std::move(kinematic_object);
 }
 
 absl::StatusOr<KinematicObject> ObjectWorldClient::GetKinematicObject(
@@ -409,7 +921,27 @@ absl::StatusOr<Frame> ObjectWorldClient::GetFrame(
   intrinsic_proto::world::GetFrameRequest request;
   request.set_world_id(world_id_);
   request.mutable_frame()->set_id(id.value());
-  return CallGetFrame(request, *object_world_service_);
+  INTR_ASSIGN_OR_RETURN(intrinsic_proto::world::Frame proto,
+                        GetFrameProto(request));
+  return Frame::Create(std::move(proto));
+}
+
+absl::StatusOr<std::vector<Frame>> ObjectWorldClient::GetFrames(
+    absl::Span<const ObjectWorldResourceId> ids) const {
+  std::vector<intrinsic_proto::world::GetFrameRequest> requests(ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    requests[i].set_world_id(world_id_);
+    requests[i].mutable_frame()->set_id(ids[i].value());
+  }
+  INTR_ASSIGN_OR_RETURN(std::vector<intrinsic_proto::world::Frame> protos,
+                        GetFrameProtos(requests));
+  std::vector<Frame> frames;
+  frames.reserve(protos.size());
+  for (intrinsic_proto::world::Frame& proto : protos) {
+    INTR_ASSIGN_OR_RETURN(Frame frame, Frame::Create(std::move(proto)));
+    frames.push_back(std::move(frame));
+  }
+  return frames;
 }
 
 absl::StatusOr<Frame> ObjectWorldClient::GetFrame(
@@ -420,7 +952,23 @@ absl::StatusOr<Frame> ObjectWorldClient::GetFrame(
       object_name.value());
   request.mutable_frame()->mutable_by_name()->set_frame_name(
       frame_name.value());
-  return CallGetFrame(request, *object_world_service_);
+  if (snapshot_cache_ != nullptr) {
+    INTR_RETURN_IF_ERROR(ValidateSnapshotCache().status());
+    ObjectReference object_reference;
+    object_reference.mutable_by_name()->set_object_name(object_name.value());
+    absl::MutexLock lock(&snapshot_cache_->mutex);
+    // A cached object finds its frames by name without another read.
+    if (snapshot_cache_->FindFrame(request.frame()) == nullptr) {
+      if (const WorldObject* object =
+              snapshot_cache_->FindObject(object_reference);
+          object != nullptr) {
+        return object->GetFrame(frame_name);
+      }
+    }
+  }
+  INTR_ASSIGN_OR_RETURN(intrinsic_proto::world::Frame proto,
+                        GetFrameProto(request));
+  return Frame::Create(std::move(proto));
 }
 
 absl::StatusOr<Frame> ObjectWorldClient::GetFrame(
@@ -441,8 +989,9 @@ absl::Status ObjectWorldClient::CreateFrame(const FrameName& new_frame_name,
                                             const Pose3d& parent_t_new_frame) {
   intrinsic_proto::world::CreateFrameRequest request;
   request.mutable_parent_object()->set_id(parent_object.Id().value());
-  return CallCreateFrame(std::move(request), new_frame_name, parent_t_new_frame,
-                         world_id_, *object_world_service_);
+  return FinishUpdate(CallCreateFrame(std::move(request), new_frame_name,
+                                      parent_t_new_frame, world_id_,
+                                      *object_world_service_));
 }
 
 absl::Status ObjectWorldClient::CreateFrame(const FrameName& new_frame_name,
@@ -450,8 +999,9 @@ absl::Status ObjectWorldClient::CreateFrame(const FrameName& new_frame_name,
                                             const Pose3d& parent_t_new_frame) {
   intrinsic_proto::world::CreateFrameRequest request;
   request.mutable_parent_frame()->set_id(parent_frame.Id().value());
-  return CallCreateFrame(std::move(request), new_frame_name, parent_t_new_frame,
-                         world_id_, *object_world_service_);
+  return FinishUpdate(CallCreateFrame(std::move(request), new_frame_name,
+                                      parent_t_new_frame, world_id_,
+                                      *object_world_service_));
 }
 
 absl::Status ObjectWorldClient::UpdateObjectName(
@@ -467,9 +1017,8 @@ absl::Status ObjectWorldClient::UpdateObjectName(
   request.set_name_is_global_alias(name_type ==
                                    WorldObjectNameType::kNameIsGlobalAlias);
   intrinsic_proto::world::Object response;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(
+  return FinishUpdate(ToAbslStatus(
       object_world_service_->UpdateObjectName(&ctx, request, &response)));
-  return absl::OkStatus();
 }
 
 absl::Status ObjectWorldClient::UpdateFrameName(const Frame& frame,
@@ -480,9 +1029,8 @@ absl::Status ObjectWorldClient::UpdateFrameName(const Frame& frame,
   request.mutable_frame()->set_id(frame.Id().value());
   request.set_name(new_name.value());
   intrinsic_proto::world::Frame response;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(
+  return FinishUpdate(ToAbslStatus(
       object_world_service_->UpdateFrameName(&ctx, request, &response)));
-  return absl::OkStatus();
 }
 
 absl::StatusOr<Pose3d> ObjectWorldClient::GetTransform(
@@ -495,7 +1043,6 @@ absl::StatusOr<Pose3d> ObjectWorldClient::GetTransform(
     std::optional<ObjectEntityFilter> node_a_filter,
     const TransformNode& node_b,
     std::optional<ObjectEntityFilter> node_b_filter) const {
-  grpc::ClientContext ctx;
   intrinsic_proto::world::GetTransformRequest request;
   request.set_world_id(world_id_);
   request.mutable_node_a()->set_id(node_a.Id().value());
@@ -508,26 +1055,31 @@ absl::StatusOr<Pose3d> ObjectWorldClient::GetTransform(
     *request.mutable_node_b_filter() = node_b_filter->ToProto();
   }
 
-  intrinsic_proto::world::GetTransformResponse response;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(
-      object_world_service_->GetTransform(&ctx, request, &response)));
+  INTR_ASSIGN_OR_RETURN(
+      intrinsic_proto::world::GetTransformResponse response,
+      CallWithPolicy<intrinsic_proto::world::GetTransformResponse>(
+          call_policies_.For(kGetTransformMethod),
+          [&](grpc::ClientContext* ctx,
+              intrinsic_proto::world::GetTransformResponse* response) {
+            return object_world_service_->GetTransform(ctx, request, response);
+          }));
   return intrinsic_proto::FromProto(response.a_t_b());
 }
 
 absl::Status ObjectWorldClient::UpdateTransform(const TransformNode& node_a,
                                                 const TransformNode& node_b,
                                                 const Pose3d& a_t_b) {
-  return CallUpdateTransform(node_a.Id(), std::nullopt, node_b.Id(),
-                             std::nullopt, std::nullopt, std::nullopt, a_t_b,
-                             world_id_, *object_world_service_);
+  return FinishUpdate(CallUpdateTransform(
+      node_a.Id(), std::nullopt, node_b.Id(), std::nullopt, std::nullopt,
+      std::nullopt, a_t_b, world_id_, *object_world_service_));
 }
 
 absl::Status ObjectWorldClient::UpdateTransform(
     const TransformNode& node_a, const TransformNode& node_b,
     const TransformNode& node_to_update, const Pose3d& a_t_b) {
-  return CallUpdateTransform(node_a.Id(), std::nullopt, node_b.Id(),
-                             std::nullopt, node_to_update.Id(), std::nullopt,
-                             a_t_b, world_id_, *object_world_service_);
+  return FinishUpdate(CallUpdateTransform(
+      node_a.Id(), std::nullopt, node_b.Id(), std::nullopt, node_to_update.Id(),
+      std::nullopt, a_t_b, world_id_, *object_world_service_));
 }
 
 absl::Status ObjectWorldClient::UpdateTransform(
@@ -535,10 +1087,10 @@ absl::Status ObjectWorldClient::UpdateTransform(
     const TransformNode& node_b, const ObjectEntityFilter& node_b_filter,
     const TransformNode& node_to_update,
     const ObjectEntityFilter& node_to_update_filter, const Pose3d& a_t_b) {
-  return CallUpdateTransform(node_a.Id(), node_a_filter, node_b.Id(),
-                             node_b_filter, node_to_update.Id(),
-                             node_to_update_filter, a_t_b, world_id_,
-                             *object_world_service_);
+  return FinishUpdate(CallUpdateTransform(
+      node_a.Id(), node_a_filter, node_b.Id(), node_b_filter,
+      node_to_update.Id(), node_to_update_filter, a_t_b, world_id_,
+      *object_world_service_));
 }
 
 absl::Status ObjectWorldClient::UpdateJointPositions(
@@ -552,9 +1104,8 @@ absl::Status ObjectWorldClient::UpdateJointPositions(
   // Use minimalistic view since we are ignoring the response.
   request.set_view(intrinsic_proto::world::ObjectView::BASIC);
   intrinsic_proto::world::Object response;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(
+  return FinishUpdate(ToAbslStatus(
       object_world_service_->UpdateObjectJoints(&ctx, request, &response)));
-  return absl::OkStatus();
 }
 
 absl::Status ObjectWorldClient::UpdateJointApplicationLimits(
@@ -569,9 +1120,8 @@ absl::Status ObjectWorldClient::UpdateJointApplicationLimits(
   // Use minimalistic view since we are ignoring the response.
   request.set_view(intrinsic_proto::world::ObjectView::BASIC);
   intrinsic_proto::world::Object response;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(
+  return FinishUpdate(ToAbslStatus(
       object_world_service_->UpdateObjectJoints(&ctx, request, &response)));
-  return absl::OkStatus();
 }
 
 absl::Status ObjectWorldClient::UpdateJointSystemLimits(
@@ -585,9 +1135,8 @@ absl::Status ObjectWorldClient::UpdateJointSystemLimits(
   // Use minimalistic view since we are ignoring the response.
   request.set_view(intrinsic_proto::world::ObjectView::BASIC);
   intrinsic_proto::world::Object response;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(
+  return FinishUpdate(ToAbslStatus(
       object_world_service_->UpdateObjectJoints(&ctx, request, &response)));
-  return absl::OkStatus();
 }
 
 absl::Status ObjectWorldClient::UpdateJointLimits(
@@ -605,9 +1154,8 @@ absl::Status ObjectWorldClient::UpdateJointLimits(
   // Use minimalistic view since we are ignoring the response.
   request.set_view(intrinsic_proto::world::ObjectView::BASIC);
   intrinsic_proto::world::Object response;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(
+  return FinishUpdate(ToAbslStatus(
       object_world_service_->UpdateObjectJoints(&ctx, request, &response)));
-  return absl::OkStatus();
 }
 
 absl::Status ObjectWorldClient::UpdateCartesianLimits(
@@ -622,10 +1170,9 @@ absl::Status ObjectWorldClient::UpdateCartesianLimits(
   // Use minimalistic view since we are ignoring the response.
   request.set_view(intrinsic_proto::world::ObjectView::BASIC);
   intrinsic_proto::world::Object response;
-  INTR_RETURN_IF_ERROR(
+  return FinishUpdate(
       ToAbslStatus(object_world_service_->UpdateKinematicObjectProperties(
           &ctx, request, &response)));
-  return absl::OkStatus();
 }
 
 absl::Status ObjectWorldClient::UpdateMountedPayload(
@@ -638,10 +1185,43 @@ absl::Status ObjectWorldClient::UpdateMountedPayload(
   // Use minimalistic view since we are ignoring the response.
   request.set_view(intrinsic_proto::world::ObjectView::BASIC);
   intrinsic_proto::world::Object response;
-  INTR_RETURN_IF_ERROR(
+  return FinishUpdate(
       ToAbslStatus(object_world_service_->UpdateKinematicObjectProperties(
           &ctx, request, &response)));
-  return absl::OkStatus();
+}
+
+absl::Status ObjectWorldClient::UpdateMountedPayload(
+    const KinematicObject& kinematic_object,
+    const PrecomputedRobotPayload& payload) {
+  grpc::ClientContext ctx;
+  intrinsic_proto::world::UpdateKinematicObjectPropertiesRequest request;
+  request.set_world_id(world_id_);
+  request.mutable_object()->set_id(kinematic_object.Id().value());
+  *request.mutable_mounted_payload() = payload.proto();
+  // Use minimalistic view since we are ignoring the response.
+  request.set_view(intrinsic_proto::world::ObjectView::BASIC);
+  intrinsic_proto::world::Object response;
+  return FinishUpdate(
+      ToAbslStatus(object_world_service_->UpdateKinematicObjectProperties(
+          &ctx, request, &response)));
+}
+
+absl::Status ObjectWorldClient::UpdateMountedPayloadAndJointLimits(
+    const KinematicObject& kinematic_object,
+    const PrecomputedRobotPayload& payload,
+    const JointLimitsXd& joint_application_limits) {
+  intrinsic_proto::world::ObjectWorldUpdates updates;
+  intrinsic_proto::world::UpdateKinematicObjectPropertiesRequest&
+      payload_request =
+          *updates.add_updates()->mutable_update_kinematic_object_properties();
+  payload_request.mutable_object()->set_id(kinematic_object.Id().value());
+  *payload_request.mutable_mounted_payload() = payload.proto();
+  intrinsic_proto::world::UpdateObjectJointsRequest& joints_request =
+      *updates.add_updates()->mutable_update_object_joints();
+  joints_request.mutable_object()->set_id(kinematic_object.Id().value());
+  *joints_request.mutable_joint_application_limits() =
+      ToJointLimitsUpdate(joint_application_limits);
+  return BatchUpdate(updates);
 }
 
 absl::Status ObjectWorldClient::BatchUpdate(
@@ -653,9 +1233,8 @@ absl::Status ObjectWorldClient::BatchUpdate(
   request.set_view(intrinsic_proto::world::ObjectView::BASIC);
   *request.mutable_world_updates() = updates;
   intrinsic_proto::world::UpdateWorldResourcesResponse response;
-  INTR_RETURN_IF_ERROR(ToAbslStatus(
-      object_world_service_->UpdateWorldResources(&ctx, request, &response)));
-  return absl::OkStatus();
+  return FinishUpdate(ToAbslStatus(object_world_service_->UpdateWorldResources(
+      &ctx, request, &response)));
 }
 
 namespace {
@@ -693,8 +1272,8 @@ absl::Status ObjectWorldClient::ReparentObject(const WorldObject& object,
 absl::Status ObjectWorldClient::ReparentObject(
     const WorldObject& object, const WorldObject& new_parent,
     const ObjectEntityFilter& filter) {
-  return CallReparentObject(object, new_parent, filter.ToProto(), world_id_,
-                            *object_world_service_);
+  return FinishUpdate(CallReparentObject(
+      object, new_parent, filter.ToProto(), world_id_, *object_world_service_));
 }
 
 absl::Status ObjectWorldClient::ReparentObjectToFinalEntity(
@@ -747,38 +1326,32 @@ absl::Status CallToggleCollisions(
 
 absl::Status ObjectWorldClient::DisableCollisions(const WorldObject& object_a,
                                                   const WorldObject& object_b) {
-  return CallToggleCollisions(
-      object_a, ObjectEntityFilter().IncludeAllEntities(), object_b,
-      ObjectEntityFilter().IncludeAllEntities(),
-      intrinsic_proto::world::TOGGLE_MODE_DISABLE, world_id_,
-      *object_world_service_);
+  return DisableCollisions(object_a, ObjectEntityFilter().IncludeAllEntities(),
+                           object_b, ObjectEntityFilter().IncludeAllEntities());
 }
 
 absl::Status ObjectWorldClient::DisableCollisions(
     const WorldObject& object_a, const ObjectEntityFilter& entity_filter_a,
     const WorldObject& object_b, const ObjectEntityFilter& entity_filter_b) {
-  return CallToggleCollisions(object_a, entity_filter_a, object_b,
-                              entity_filter_b,
-                              intrinsic_proto::world::TOGGLE_MODE_DISABLE,
-                              world_id_, *object_world_service_);
+  return FinishUpdate(CallToggleCollisions(
+      object_a, entity_filter_a, object_b, entity_filter_b,
+      intrinsic_proto::world::TOGGLE_MODE_DISABLE, world_id_,
+      *object_world_service_));
 }
 
 absl::Status ObjectWorldClient::EnableCollisions(const WorldObject& object_a,
                                                  const WorldObject& object_b) {
-  return CallToggleCollisions(
-      object_a, ObjectEntityFilter().IncludeAllEntities(), object_b,
-      ObjectEntityFilter().IncludeAllEntities(),
-      intrinsic_proto::world::TOGGLE_MODE_ENABLE, world_id_,
-      *object_world_service_);
+  return EnableCollisions(object_a, ObjectEntityFilter().IncludeAllEntities(),
+                          object_b, ObjectEntityFilter().IncludeAllEntities());
 }
 
 absl::Status ObjectWorldClient::EnableCollisions(
     const WorldObject& object_a, const ObjectEntityFilter& entity_filter_a,
     const WorldObject& object_b, const ObjectEntityFilter& entity_filter_b) {
-  return CallToggleCollisions(object_a, entity_filter_a, object_b,
-                              entity_filter_b,
-                              intrinsic_proto::world::TOGGLE_MODE_ENABLE,
-                              world_id_, *object_world_service_);
+  return FinishUpdate(CallToggleCollisions(
+      object_a, entity_filter_a, object_b, entity_filter_b,
+      intrinsic_proto::world::TOGGLE_MODE_ENABLE, world_id_,
+      *object_world_service_));
 }
 
 }  // namespace world
@@ -3,20 +3,25 @@
 #ifndef INTRINSIC_WORLD_OBJECTS_OBJECT_WORLD_CLIENT_H_
 #define INTRINSIC_WORLD_OBJECTS_OBJECT_WORLD_CLIENT_H_
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "intrinsic/eigenmath/types.h"
 #include "intrinsic/kinematics/types/cartesian_limits.h"
 #include "intrinsic/kinematics/types/joint_limits_xd.h"
 #include "intrinsic/math/pose3.h"
 #include "intrinsic/resources/proto/resource_handle.pb.h"
 #include "intrinsic/skills/proto/equipment.pb.h"
+#include "intrinsic/util/grpc/connection_params.h"
 #include "intrinsic/util/status/status_macros.h"
 #include "intrinsic/world/objects/frame.h"
 #include "intrinsic/world/objects/kinematic_object.h"
@@ -24,12 +29,15 @@
 #include "intrinsic/world/objects/object_world_ids.h"
 #include "intrinsic/world/objects/transform_node.h"
 #include "intrinsic/world/objects/world_object.h"
+#include "intrinsic/world/objects/world_watcher.h"
 #include "intrinsic/world/proto/collision_settings.pb.h"
 #include "intrinsic/world/proto/geometry_component.pb.h"
 #include "intrinsic/world/proto/object_world_refs.pb.h"
 #include "intrinsic/world/proto/object_world_service.grpc.pb.h"
+#include "intrinsic/world/proto/object_world_service.pb.h"
 #include "intrinsic/world/proto/object_world_updates.pb.h"
 #include "intrinsic/world/robot_payload/robot_payload.h"
+#include "intrinsic/world/robot_payload/robot_payload_library.h"
 
 namespace intrinsic {
 namespace world {
@@ -38,21 +46,61 @@ namespace world {
 //
 // Uses the object-based-view onto a world, i.e., a world is exposed in the
 // form of objects and frames.
+//
+// Optionally keeps a snapshot of the objects and frames it has read, see
+// SnapshotCacheOptions.
 class ObjectWorldClient {
   using ObjectWorldService = ::intrinsic_proto::world::ObjectWorldService;
 
  public:
+  // Options of the snapshot cache, which serves repeated GetObject(),
+  // GetKinematicObject() and GetFrame() calls by id or by name locally, as long
+  // as the world does not change.
+  //
+  // The cache is dropped when the `last_update` or the structure hash of the
+  // world changes, and whenever this client updates the world. Objects and
+  // frames requested by resource handle are not cached.
+  struct SnapshotCacheOptions {
+    // How long a check of the world version is relied upon. Reads within this
+    // interval after the last check do not make any request, so they may miss
+    // updates made by other clients during the interval.
+    absl::Duration version_check_interval = absl::Milliseconds(100);
+  };
+
   // Creates a client for the world with the given id.
   ObjectWorldClient(
       absl::string_view world_id,
       std::shared_ptr<ObjectWorldService::StubInterface> object_world_service);
 
+  // Creates a client for the world with the given id, which caches the objects
+  // and frames it reads.
+  ObjectWorldClient(
+      absl::string_view world_id,
+      std::shared_ptr<ObjectWorldService::StubInterface> object_world_service,
+      const SnapshotCacheOptions& snapshot_cache_options);
+
   ObjectWorldClient(ObjectWorldClient&& other) = default;
   ObjectWorldClient& operator=(ObjectWorldClient&& other) = default;
 
   // Returns the ID of the world.
   absl::string_view GetWorldID() const { return world_id_; }
 
+  // Sets the deadlines, retries and hedging of the reads of this client, e.g.,
+  // from Channel::GetCallPolicies(). Not thread-safe, so call it before using
+  // the client. By default, reads have no deadline and are not retried.
+  //
+  // Policies are looked up by the full name of the read method, such as
+  // "/intrinsic_proto.world.ObjectWorldService/GetObject". Reads of several
+  // objects or frames at once only use the timeout of GetObject or GetFrame.
+  // Updates are not idempotent and ignore the policies.
+  void SetCallPolicies(CallPolicies call_policies) {
+    call_policies_ = std::move(call_policies);
+  }
+
+  // Drops the snapshot cache, e.g., when the caller knows that another client
+  // has updated the world. Has no effect if the cache is not enabled.
+  void InvalidateSnapshotCache() const;
+
   // Returns a local copy of the transform node identified by the given
   // reference.
   absl::StatusOr<TransformNode> GetTransformNode(
@@ -71,6 +119,24 @@ class ObjectWorldClient {
   // Returns a local copy of the object identified by the given name.
   absl::StatusOr<WorldObject> GetObject(const WorldObjectName& name) const;
 
+  // Returns a local copy of the object identified by the given resource id,
+  // retrieved with the given view. Unless `view` is ObjectView::FULL, the
+  // returned object reads the rest of the object from the world when it is
+  // first accessed (see WorldObject), so callers that only need the id, name,
+  // place in the hierarchy or pose of an object transfer much less data.
+  //
+  // Objects retrieved with a smaller view are not kinematic objects and are
+  // not added to the snapshot cache.
+  absl::StatusOr<WorldObject> GetObject(
+      const ObjectWorldResourceId& id,
+      intrinsic_proto::world::ObjectView view) const;
+
+  // Returns a local copy of the object identified by the given name, retrieved
+  // with the given view. See GetObject(id, view).
+  absl::StatusOr<WorldObject> GetObject(
+      const WorldObjectName& name,
+      intrinsic_proto::world::ObjectView view) const;
+
   // Returns a local copy of the object associated with the name of the given
   // resource handle.
   absl::StatusOr<WorldObject> GetObject(
@@ -83,9 +149,55 @@ class ObjectWorldClient {
   //   INTR_ASSIGN_OR_RETURN(object, world->GetObject(object));
   absl::StatusOr<WorldObject> GetObject(const WorldObject& object) const;
 
+  // Returns local copies of the objects with the given resource ids, in the
+  // same order. The objects are read with concurrent requests, so this takes
+  // about as long as a single GetObject() call rather than one per object.
+  //
+  // Returns the error of the first object, in the order of `ids`, that could
+  // not be read.
+  absl::StatusOr<std::vector<WorldObject>> GetObjects(
+      absl::Span<const ObjectWorldResourceId> ids) const;
+
+  // Returns local copies of the objects with the given names, in the same
+  // order. See GetObjects(ids).
+  absl::StatusOr<std::vector<WorldObject>> GetObjects(
+      absl::Span<const WorldObjectName> names) const;
+
   // Returns all objects in the world.
   absl::StatusOr<std::vector<WorldObject>> ListObjects() const;
 
+  // Returns all objects in the world, retrieved with the given view. See
+  // GetObject(id, view).
+  absl::StatusOr<std::vector<WorldObject>> ListObjects(
+      intrinsic_proto::world::ObjectView view) const;
+
+  // Returns a watcher that keeps a local mirror of all objects in the world,
+  // and calls `callback` with the objects that were added, updated or removed.
+  // N.B. The world service has no change stream yet, so the watcher checks the
+  // version of the world once per `period`, and lists all objects again only
+  // after it changed.
+  //
+  // The watcher must not outlive this client, and this client must not be
+  // moved while the watcher exists.
+  //
+  // Example:
+  //
+  //  INTR_ASSIGN_OR_RETURN(
+  //      std::unique_ptr<WorldWatcher> watcher,
+  //      world.Watch(absl::Milliseconds(100),
+  //                  [](absl::Span<const WorldObjectChange> changes) {
+  //                    for (const WorldObjectChange& change : changes) {
+  //                      LOG(INFO) << change.id;
+  //                    }
+  //                  }));
+  absl::StatusOr<std::unique_ptr<WorldWatcher>> Watch(
+      absl::Duration period, WorldWatcher::ChangeCallback callback) const;
+
+  // Returns a string that changes whenever the world is updated. Results that
+  // are computed from the world, such as planned trajectories, can be keyed by
+  // it and reused as long as it stays the same.
+  absl::StatusOr<std::string> GetWorldVersion() const;
+
   // Returns all object names in the world.
   absl::StatusOr<std::vector<WorldObjectName>> ListObjectNames() const;
 
@@ -136,6 +248,11 @@ class ObjectWorldClient {
   // Returns a local copy of the frame with the given resource id.
   absl::StatusOr<Frame> GetFrame(const ObjectWorldResourceId& id) const;
 
+  // Returns local copies of the frames with the given resource ids, in the
+  // same order. See GetObjects(ids).
+  absl::StatusOr<std::vector<Frame>> GetFrames(
+      absl::Span<const ObjectWorldResourceId> ids) const;
+
   // Returns a local copy of the frame with the given name under the object with
   // the given name.
   absl::StatusOr<Frame> GetFrame(const WorldObjectName& object_name,
@@ -260,6 +377,18 @@ class ObjectWorldClient {
   absl::Status UpdateMountedPayload(const KinematicObject& kinematic_object,
                                     const RobotPayload& payload);
 
+  // Same as above, with a precomputed payload, which is not converted again.
+  absl::Status UpdateMountedPayload(const KinematicObject& kinematic_object,
+                                    const PrecomputedRobotPayload& payload);
+
+  // Sets the mounted payload and the joint application limits of the given
+  // kinematic object with a single BatchUpdate(), e.g., when a gripper picks
+  // or places an object, instead of one call for each. The update is atomic.
+  absl::Status UpdateMountedPayloadAndJointLimits(
+      const KinematicObject& kinematic_object,
+      const PrecomputedRobotPayload& payload,
+      const JointLimitsXd& joint_application_limits);
+
   // Performs a sequence of update operations on various resources in a single
   // world.
   //
@@ -343,8 +472,46 @@ class ObjectWorldClient {
                                 const ObjectEntityFilter& entity_filter_b);
 
  private:
+  struct SnapshotCache;
+
+  // Returns the full view of the requested object, from the snapshot cache if
+  // possible.
+  absl::StatusOr<WorldObject> GetFullObject(
+      intrinsic_proto::world::GetObjectRequest request) const;
+  // Returns the full views of the requested objects, in order, from the
+  // snapshot cache if possible. Reads the others concurrently.
+  absl::StatusOr<std::vector<WorldObject>> GetFullObjects(
+      std::vector<intrinsic_proto::world::GetObjectRequest> requests) const;
+  // Returns the requested object, retrieved with the given view.
+  absl::StatusOr<WorldObject> GetObjectWithView(
+      intrinsic_proto::world::GetObjectRequest request,
+      intrinsic_proto::world::ObjectView view) const;
+  // Returns a function that reads the full view of the object with the given
+  // id, and that stays valid after this client is destroyed.
+  WorldObject::FullViewLoader MakeFullViewLoader(
+      const ObjectWorldResourceId& id) const;
+  // Returns the requested frame, from the snapshot cache if possible.
+  absl::StatusOr<intrinsic_proto::world::Frame> GetFrameProto(
+      const intrinsic_proto::world::GetFrameRequest& request) const;
+  // Returns the requested frames, in order, from the snapshot cache if
+  // possible. Reads the others concurrently.
+  absl::StatusOr<std::vector<intrinsic_proto::world::Frame>> GetFrameProtos(
+      const std::vector<intrinsic_proto::world::GetFrameRequest>& requests)
+      const;
+  // Drops the snapshot cache if the world has changed since it was last
+  // checked. Returns the generation of the cache, which only entries read
+  // while it is current may be added to.
+  absl::StatusOr<uint64_t> ValidateSnapshotCache() const;
+  // Drops the snapshot cache after an update of the world, whether the update
+  // succeeded or not, and returns its `status`.
+  absl::Status FinishUpdate(absl::Status status) const;
+
   std::string world_id_;
   std::shared_ptr<ObjectWorldService::StubInterface> object_world_service_;
+  // Null unless the snapshot cache is enabled. Shared so that the client stays
+  // movable.
+  std::shared_ptr<SnapshotCache> snapshot_cache_;
+  CallPolicies call_policies_;
 };
 
 }  // namespace world
@@ -0,0 +1,432 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+// Benchmarks for ObjectWorldClient.
+//
+// The client talks to a fake ObjectWorldService over an in-process channel.
+// The fake serves a generated world with `objects` objects below the root,
+// every fourth of which is a kinematic object with six joints, and `frames`
+// frames per object. It answers from memory, so the time of the client
+// benchmarks is the time the client spends outside the network: building
+// requests, gRPC serialization and the conversion of the responses. The
+// conversion alone is measured by the *Create benchmarks.
+//
+// Besides time, the client benchmarks report the number of RPCs per call as
+// `rpcs_per_call` and the serialized size of all requests and responses per
+// call as `bytes_per_call`. The `cache` argument enables the snapshot cache of
+// the client; the world never changes, so cached reads make no RPCs after the
+// first one.
+//
+// Run with:
+//   bazel run -c opt //intrinsic/world/objects:object_world_client_benchmark
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+#include "benchmark/benchmark.h"
+#include "grpcpp/grpcpp.h"
+#include "intrinsic/kinematics/types/joint_limits_xd.h"
+#include "intrinsic/math/pose3.h"
+#include "intrinsic/math/proto_conversion.h"
+#include "intrinsic/world/objects/frame.h"
+#include "intrinsic/world/objects/kinematic_object.h"
+#include "intrinsic/world/objects/object_world_client.h"
+#include "intrinsic/world/objects/object_world_ids.h"
+#include "intrinsic/world/objects/world_object.h"
+#include "intrinsic/world/proto/object_world_service.grpc.pb.h"
+#include "intrinsic/world/proto/object_world_service.pb.h"
+
+namespace intrinsic {
+namespace world {
+namespace {
+
+using ::intrinsic_proto::world::GetFrameRequest;
+using ::intrinsic_proto::world::GetObjectRequest;
+using ::intrinsic_proto::world::GetWorldRequest;
+using ::intrinsic_proto::world::ListObjectsRequest;
+using ::intrinsic_proto::world::ListObjectsResponse;
+using ::intrinsic_proto::world::ObjectView;
+using ::intrinsic_proto::world::WorldMetadata;
+
+constexpr char kWorldId[] = "world";
+constexpr char kRootId[] = "root";
+constexpr int kNumJoints = 6;
+
+std::string MakeObjectName(int object) {
+  return absl::StrCat("object_", object);
+}
+std::string MakeFrameName(int frame) { return absl::StrCat("frame_", frame); }
+
+// Returns the full view of the given object of the generated world.
+intrinsic_proto::world::Object MakeObject(int object, int num_frames) {
+  intrinsic_proto::world::Object proto;
+  proto.set_world_id(kWorldId);
+  proto.set_id(absl::StrCat("id_", MakeObjectName(object)));
+  proto.set_name(MakeObjectName(object));
+  proto.mutable_parent()->set_id(kRootId);
+  proto.mutable_parent()->set_name(kRootId);
+  *proto.mutable_object_component()->mutable_parent_t_this() =
+      ToProto(Pose3d(eigenmath::Vector3d(object, 0, 0)));
+  for (int i = 0; i < num_frames; ++i) {
+    intrinsic_proto::world::Frame& frame = *proto.add_frames();
+    frame.set_world_id(kWorldId);
+    frame.set_id(absl::StrCat(proto.id(), "/", MakeFrameName(i)));
+    frame.set_name(MakeFrameName(i));
+    frame.mutable_object()->set_id(proto.id());
+    frame.mutable_object()->set_name(proto.name());
+    *frame.mutable_parent_t_this() =
+        ToProto(Pose3d(eigenmath::Vector3d(0, 0, i)));
+  }
+  if (object % 4 == 0) {
+    proto.set_type(intrinsic_proto::world::KINEMATIC_OBJECT);
+    intrinsic_proto::world::KinematicObjectComponent& kinematics =
+        *proto.mutable_kinematic_object_component();
+    for (int i = 0; i < kNumJoints; ++i) {
+      kinematics.add_joint_positions(0.1 * i);
+    }
+    *kinematics.mutable_joint_system_limits() =
+        ToProto(JointLimitsXd::Unlimited(kNumJoints));
+    *kinematics.mutable_joint_application_limits() =
+        ToProto(JointLimitsXd::Unlimited(kNumJoints));
+    if (num_frames > 0) {
+      kinematics.add_iso_flange_frames()->set_id(proto.frames(0).id());
+      kinematics.mutable_iso_flange_frames(0)->set_name(
+          proto.frames(0).name());
+    }
+  } else {
+    proto.set_type(intrinsic_proto::world::PHYSICAL_OBJECT);
+  }
+  return proto;
+}
+
+// Returns the given full view of an object reduced to the basic view.
+intrinsic_proto::world::Object ToBasicView(
+    const intrinsic_proto::world::Object& full) {
+  intrinsic_proto::world::Object basic = full;
+  basic.clear_kinematic_object_component();
+  basic.clear_entities();
+  *basic.mutable_object_component() = {};
+  *basic.mutable_object_component()->mutable_parent_t_this() =
+      full.object_component().parent_t_this();
+  for (intrinsic_proto::world::Frame& frame : *basic.mutable_frames()) {
+    frame.clear_parent_t_this();
+  }
+  return basic;
+}
+
+// Serves a generated world from memory and counts RPCs and transferred bytes.
+class FakeObjectWorldService
+    : public intrinsic_proto::world::ObjectWorldService::Service {
+ public:
+  FakeObjectWorldService(int num_objects, int num_frames) {
+    intrinsic_proto::world::Object& root = objects_.emplace_back();
+    root.set_world_id(kWorldId);
+    root.set_id(kRootId);
+    root.set_name(kRootId);
+    root.set_type(intrinsic_proto::world::ROOT);
+    for (int i = 0; i < num_objects; ++i) {
+      intrinsic_proto::world::IdAndName& child = *root.add_children();
+      child.set_id(absl::StrCat("id_", MakeObjectName(i)));
+      child.set_name(MakeObjectName(i));
+    }
+    for (int i = 0; i < num_objects; ++i) {
+      objects_.push_back(MakeObject(i, num_frames));
+    }
+    for (size_t i = 0; i < objects_.size(); ++i) {
+      object_index_.try_emplace(objects_[i].id(), i);
+      object_index_.try_emplace(absl::StrCat("name:", objects_[i].name()), i);
+      for (const intrinsic_proto::world::Frame& frame : objects_[i].frames()) {
+        frames_.try_emplace(frame.id(), frame);
+        frames_.try_emplace(
+            absl::StrCat("name:", objects_[i].name(), "/", frame.name()),
+            frame);
+      }
+    }
+  }
+
+  grpc::Status GetWorld(grpc::ServerContext* context,
+                        const GetWorldRequest* request,
+                        WorldMetadata* response) override {
+    response->set_id(kWorldId);
+    response->mutable_last_update()->set_seconds(1);
+    Count(*request, *response);
+    return grpc::Status::OK;
+  }
+
+  grpc::Status GetObject(grpc::ServerContext* context,
+                         const GetObjectRequest* request,
+                         intrinsic_proto::world::Object* response) override {
+    const std::string key =
+        request->object().has_by_name()
+            ? absl::StrCat("name:", request->object().by_name().object_name())
+            : request->object().id();
+    auto it = object_index_.find(key);
+    if (it == object_index_.end()) {
+      return grpc::Status(grpc::StatusCode::NOT_FOUND, key);
+    }
+    *response = request->view() == ObjectView::BASIC
+                    ? ToBasicView(objects_[it->second])
+                    : objects_[it->second];
+    Count(*request, *response);
+    return grpc::Status::OK;
+  }
+
+  grpc::Status ListObjects(grpc::ServerContext* context,
+                           const ListObjectsRequest* request,
+                           ListObjectsResponse* response) override {
+    for (const intrinsic_proto::world::Object& object : objects_) {
+      *response->add_objects() =
+          request->view() == ObjectView::BASIC ? ToBasicView(object) : object;
+    }
+    Count(*request, *response);
+    return grpc::Status::OK;
+  }
+
+  grpc::Status GetFrame(grpc::ServerContext* context,
+                        const GetFrameRequest* request,
+                        intrinsic_proto::world::Frame* response) override {
+    const std::string key =
+        request->frame().has_by_name()
+            ? absl::StrCat("name:", request->frame().by_name().object_name(),
+                           "/", request->frame().by_name().frame_name())
+            : request->frame().id();
+    auto it = frames_.find(key);
+    if (it == frames_.end()) {
+      return grpc::Status(grpc::StatusCode::NOT_FOUND, key);
+    }
+    *response = it->second;
+    Count(*request, *response);
+    return grpc::Status::OK;
+  }
+
+  int64_t rpcs() const { return rpcs_.load(std::memory_order_relaxed); }
+  int64_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+ private:
+  void Count(const google::protobuf::Message& request,
+             const google::protobuf::Message& response) {
+    rpcs_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(request.ByteSizeLong() + response.ByteSizeLong(),
+                     std::memory_order_relaxed);
+  }
+
+  // All objects, the root object first.
+  std::vector<intrinsic_proto::world::Object> objects_;
+  // Index into `objects_` by id and by "name:<name>".
+  absl::flat_hash_map<std::string, size_t> object_index_;
+  // Frames by id and by "name:<object name>/<frame name>".
+  absl::flat_hash_map<std::string, intrinsic_proto::world::Frame> frames_;
+
+  std::atomic<int64_t> rpcs_ = 0;
+  std::atomic<int64_t> bytes_ = 0;
+};
+
+// A FakeObjectWorldService behind an in-process gRPC server, and a client for
+// it.
+class FakeWorld {
+ public:
+  FakeWorld(int num_objects, int num_frames, bool cache)
+      : service_(num_objects, num_frames) {
+    grpc::ServerBuilder builder;
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+    CHECK(server_ != nullptr);
+    std::shared_ptr<intrinsic_proto::world::ObjectWorldService::StubInterface>
+        stub = intrinsic_proto::world::ObjectWorldService::NewStub(
+            server_->InProcessChannel(grpc::ChannelArguments()));
+    client_ =
+        cache ? std::make_unique<ObjectWorldClient>(
+                    kWorldId, stub,
+                    ObjectWorldClient::SnapshotCacheOptions{
+                        .version_check_interval = absl::InfiniteDuration()})
+              : std::make_unique<ObjectWorldClient>(kWorldId, stub);
+  }
+
+  ~FakeWorld() { server_->Shutdown(); }
+
+  const ObjectWorldClient& client() const { return *client_; }
+
+  // Starts counting RPCs and bytes for ReportCounters().
+  void StartCounting() {
+    start_rpcs_ = service_.rpcs();
+    start_bytes_ = service_.bytes();
+  }
+
+  // Reports the RPCs and bytes since StartCounting() per iteration.
+  void ReportCounters(benchmark::State& state) const {
+    state.counters["rpcs_per_call"] =
+        benchmark::Counter(service_.rpcs() - start_rpcs_,
+                           benchmark::Counter::kAvgIterations);
+    state.counters["bytes_per_call"] =
+        benchmark::Counter(service_.bytes() - start_bytes_,
+                           benchmark::Counter::kAvgIterations);
+  }
+
+ private:
+  FakeObjectWorldService service_;
+  std::unique_ptr<grpc::Server> server_;
+  std::unique_ptr<ObjectWorldClient> client_;
+  int64_t start_rpcs_ = 0;
+  int64_t start_bytes_ = 0;
+};
+
+// Conversion of the full view of a physical object. Argument: frames.
+void BM_WorldObjectCreate(benchmark::State& state) {
+  const intrinsic_proto::world::Object proto =
+      MakeObject(/*object=*/1, state.range(0));
+  for (auto _ : state) {
+    absl::StatusOr<WorldObject> object = WorldObject::Create(proto);
+    CHECK_OK(object.status());
+    benchmark::DoNotOptimize(object);
+  }
+  state.SetBytesProcessed(state.iterations() * proto.ByteSizeLong());
+}
+BENCHMARK(BM_WorldObjectCreate)->ArgName("frames")->Range(1, 256);
+
+// Conversion of the full view of a kinematic object. Argument: frames.
+void BM_KinematicObjectCreate(benchmark::State& state) {
+  const intrinsic_proto::world::Object proto =
+      MakeObject(/*object=*/0, state.range(0));
+  for (auto _ : state) {
+    absl::StatusOr<KinematicObject> object = KinematicObject::Create(proto);
+    CHECK_OK(object.status());
+    benchmark::DoNotOptimize(object);
+  }
+  state.SetBytesProcessed(state.iterations() * proto.ByteSizeLong());
+}
+BENCHMARK(BM_KinematicObjectCreate)->ArgName("frames")->Range(1, 256);
+
+// Conversion of a single frame.
+void BM_FrameCreate(benchmark::State& state) {
+  const intrinsic_proto::world::Frame proto =
+      MakeObject(/*object=*/1, /*num_frames=*/1).frames(0);
+  for (auto _ : state) {
+    absl::StatusOr<Frame> frame = Frame::Create(proto);
+    CHECK_OK(frame.status());
+    benchmark::DoNotOptimize(frame);
+  }
+  state.SetBytesProcessed(state.iterations() * proto.ByteSizeLong());
+}
+BENCHMARK(BM_FrameCreate);
+
+// GetObject() by name of a physical object. Arguments: frames, cache.
+void BM_GetObject(benchmark::State& state) {
+  FakeWorld world(/*num_objects=*/2, state.range(0), state.range(1));
+  const WorldObjectName name(MakeObjectName(1));
+  world.StartCounting();
+  for (auto _ : state) {
+    absl::StatusOr<WorldObject> object = world.client().GetObject(name);
+    CHECK_OK(object.status());
+    benchmark::DoNotOptimize(object);
+  }
+  world.ReportCounters(state);
+}
+BENCHMARK(BM_GetObject)
+    ->ArgNames({"frames", "cache"})
+    ->ArgsProduct({{1, 16, 256}, {0, 1}});
+
+// GetObject() by name with the basic view, without reading the rest of the
+// object. Argument: frames.
+void BM_GetObjectBasicView(benchmark::State& state) {
+  FakeWorld world(/*num_objects=*/2, state.range(0), /*cache=*/false);
+  const WorldObjectName name(MakeObjectName(1));
+  world.StartCounting();
+  for (auto _ : state) {
+    absl::StatusOr<WorldObject> object =
+        world.client().GetObject(name, ObjectView::BASIC);
+    CHECK_OK(object.status());
+    benchmark::DoNotOptimize(object->ParentTThis());
+  }
+  world.ReportCounters(state);
+}
+BENCHMARK(BM_GetObjectBasicView)->ArgName("frames")->Arg(1)->Arg(16)->Arg(256);
+
+// GetKinematicObject() by name. Arguments: frames, cache.
+void BM_GetKinematicObject(benchmark::State& state) {
+  FakeWorld world(/*num_objects=*/2, state.range(0), state.range(1));
+  const WorldObjectName name(MakeObjectName(0));
+  world.StartCounting();
+  for (auto _ : state) {
+    absl::StatusOr<KinematicObject> object =
+        world.client().GetKinematicObject(name);
+    CHECK_OK(object.status());
+    benchmark::DoNotOptimize(object);
+  }
+  world.ReportCounters(state);
+}
+BENCHMARK(BM_GetKinematicObject)
+    ->ArgNames({"frames", "cache"})
+    ->ArgsProduct({{1, 16, 256}, {0, 1}});
+
+// GetObjects() of all objects below the root by id. Arguments: objects,
+// frames, cache.
+void BM_GetObjects(benchmark::State& state) {
+  FakeWorld world(state.range(0), state.range(1), state.range(2));
+  std::vector<ObjectWorldResourceId> ids;
+  for (int i = 0; i < state.range(0); ++i) {
+    ids.emplace_back(absl::StrCat("id_", MakeObjectName(i)));
+  }
+  world.StartCounting();
+  for (auto _ : state) {
+    absl::StatusOr<std::vector<WorldObject>> objects =
+        world.client().GetObjects(ids);
+    CHECK_OK(objects.status());
+    benchmark::DoNotOptimize(objects);
+  }
+  world.ReportCounters(state);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetObjects)
+    ->ArgNames({"objects", "frames", "cache"})
+    ->ArgsProduct({{16, 128}, {1, 16}, {0, 1}})
+    ->UseRealTime();
+
+// ListObjects() of the whole world. Arguments: objects, frames.
+void BM_ListObjects(benchmark::State& state) {
+  FakeWorld world(state.range(0), state.range(1), /*cache=*/false);
+  world.StartCounting();
+  for (auto _ : state) {
+    absl::StatusOr<std::vector<WorldObject>> objects =
+        world.client().ListObjects();
+    CHECK_OK(objects.status());
+    benchmark::DoNotOptimize(objects);
+  }
+  world.ReportCounters(state);
+  state.SetItemsProcessed(state.iterations() * (state.range(0) + 1));
+}
+BENCHMARK(BM_ListObjects)
+    ->ArgNames({"objects", "frames"})
+    ->ArgsProduct({{16, 128, 1024}, {1, 16}});
+
+// GetFrame() by object and frame name. Arguments: frames, cache.
+void BM_GetFrameByName(benchmark::State& state) {
+  FakeWorld world(/*num_objects=*/2, state.range(0), state.range(1));
+  const WorldObjectName object_name(MakeObjectName(1));
+  const FrameName frame_name(MakeFrameName(state.range(0) - 1));
+  // With the cache, frames are found in the cached object.
+  CHECK_OK(world.client().GetObject(object_name).status());
+  world.StartCounting();
+  for (auto _ : state) {
+    absl::StatusOr<Frame> frame =
+        world.client().GetFrame(object_name, frame_name);
+    CHECK_OK(frame.status());
+    benchmark::DoNotOptimize(frame);
+  }
+  world.ReportCounters(state);
+}
+BENCHMARK(BM_GetFrameByName)
+    ->ArgNames({"frames", "cache"})
+    ->ArgsProduct({{1, 16, 256}, {0, 1}});
+
+}  // namespace
+}  // namespace world
+}  // namespace intrinsic
@@ -24,9 +24,10 @@ const ObjectWorldResourceId& RootObjectId();
 const ObjectWorldResourceId& RootEntityId();
 
 // A human-readable name for an object in the object-based world view
-// (see ObjectWorld).
+// (see ObjectWorld). Interned, since names are few and mostly used as lookup
+// keys.
 INTRINSIC_DEFINE_STRING_TYPE_AS(WorldObjectName,
-                                intrinsic::SharedPtrStringRepresentation);
+                                intrinsic::InternedStringRepresentation);
 
 // The name of the root object which is present in every object world.
 const WorldObjectName& RootObjectName();
@@ -38,8 +39,9 @@ enum class WorldObjectNameType {
 
 // A human-readable name for a frame in the object-based world view (see
 // ObjectWorld). The name is unique amongst all frames under one object.
+// Interned like WorldObjectName.
 INTRINSIC_DEFINE_STRING_TYPE_AS(FrameName,
-                                intrinsic::SharedPtrStringRepresentation);
+                                intrinsic::InternedStringRepresentation);
 
 // Frame name marking the flange of a robot arm according to the ISO 9787
 // standard. This should be used by convention for flange frames on kinematic
@@ -0,0 +1,272 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/world/objects/object_world_update_builder.h"
+
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "intrinsic/eigenmath/types.h"
+#include "intrinsic/icon/proto/cart_space_conversion.h"
+#include "intrinsic/kinematics/types/cartesian_limits.h"
+#include "intrinsic/kinematics/types/joint_limits_xd.h"
+#include "intrinsic/math/pose3.h"
+#include "intrinsic/math/proto_conversion.h"
+#include "intrinsic/util/eigen.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/world/objects/kinematic_object.h"
+#include "intrinsic/world/objects/object_entity_filter.h"
+#include "intrinsic/world/objects/object_world_client.h"
+#include "intrinsic/world/objects/transform_node.h"
+#include "intrinsic/world/objects/world_object.h"
+#include "intrinsic/world/proto/object_world_updates.pb.h"
+#include "intrinsic/world/robot_payload/robot_payload.h"
+#include "intrinsic/world/robot_payload/robot_payload_library.h"
+
+namespace intrinsic {
+namespace world {
+
+namespace {
+
+// Returns a key that identifies the given node and entity filter.
+std::string NodeKey(const TransformNode& node,
+                    const ObjectEntityFilter* filter) {
+  if (filter == nullptr) {
+    return node.Id().value();
+  }
+  return absl::StrCat(node.Id().value(), "/",
+                      filter->ToProto().SerializeAsString());
+}
+
+std::string JointsKey(const KinematicObject& kinematic_object) {
+  return absl::StrCat("joints:", kinematic_object.Id().value());
+}
+
+std::string KinematicPropertiesKey(const KinematicObject& kinematic_object) {
+  return absl::StrCat("kinematic_properties:", kinematic_object.Id().value());
+}
+
+}  // namespace
+
+ObjectWorldUpdateBuilder& ObjectWorldUpdateBuilder::UpdateTransform(
+    const TransformNode& node_a, const TransformNode& node_b,
+    const Pose3d& a_t_b) {
+  // Without an explicit node to update, the child of the two nodes is updated,
+  // whichever order they are given in.
+  std::string key_a = NodeKey(node_a, nullptr);
+  std::string key_b = NodeKey(node_b, nullptr);
+  if (key_b < key_a) {
+    std::swap(key_a, key_b);
+  }
+  intrinsic_proto::world::UpdateTransformRequest& request =
+      *Merge(absl::StrCat("transform:", key_a, "|", key_b))
+           .mutable_update_transform();
+  request.Clear();
+  request.mutable_node_a()->set_id(node_a.Id().value());
+  request.mutable_node_b()->set_id(node_b.Id().value());
+  *request.mutable_a_t_b() = ToProto(a_t_b);
+  return *this;
+}
+
+ObjectWorldUpdateBuilder& ObjectWorldUpdateBuilder::UpdateTransform(
+    const TransformNode& node_a, const TransformNode& node_b,
+    const TransformNode& node_to_update, const Pose3d& a_t_b) {
+  intrinsic_proto::world::UpdateTransformRequest& request =
+      *Merge(absl::StrCat("transform:", NodeKey(node_to_update, nullptr)))
+           .mutable_update_transform();
+  request.Clear();
+  request.mutable_node_a()->set_id(node_a.Id().value());
+  request.mutable_node_b()->set_id(node_b.Id().value());
+  request.mutable_node_to_update()->set_id(node_to_update.Id().value());
+  *request.mutable_a_t_b() = ToProto(a_t_b);
+  return *this;
+}
+
+ObjectWorldUpdateBuilder& ObjectWorldUpdateBuilder::UpdateTransform(
+    const TransformNode& node_a, const ObjectEntityFilter& node_a_filter,
+    const TransformNode& node_b, const ObjectEntityFilter& node_b_filter,
+    const TransformNode& node_to_update,
+    const ObjectEntityFilter& node_to_update_filter, const Pose3d& a_t_b) {
+  intrinsic_proto::world::UpdateTransformRequest& request =
+      *Merge(absl::StrCat("transform:",
+                          NodeKey(node_to_update, &node_to_update_filter)))
+           .mutable_update_transform();
+  request.Clear();
+  request.mutable_node_a()->set_id(node_a.Id().value());
+  *request.mutable_node_a_filter() = node_a_filter.ToProto();
+  request.mutable_node_b()->set_id(node_b.Id().value());
+  *request.mutable_node_b_filter() = node_b_filter.ToProto();
+  request.mutable_node_to_update()->set_id(node_to_update.Id().value());
+  *request.mutable_node_to_update_filter() = node_to_update_filter.ToProto();
+  *request.mutable_a_t_b() = ToProto(a_t_b);
+  return *this;
+}
+
+ObjectWorldUpdateBuilder& ObjectWorldUpdateBuilder::UpdateJointPositions(
+    const KinematicObject& kinematic_object,
+    const eigenmath::VectorXd& joint_positions) {
+  intrinsic_proto::world::UpdateObjectJointsRequest& request =
+      *Merge(JointsKey(kinematic_object)).mutable_update_object_joints();
+  request.mutable_object()->set_id(kinematic_object.Id().value());
+  VectorXdToRepeatedDouble(joint_positions, request.mutable_joint_positions());
+  return *this;
+}
+
+ObjectWorldUpdateBuilder&
+ObjectWorldUpdateBuilder::UpdateJointApplicationLimits(
+    const KinematicObject& kinematic_object,
+    const JointLimitsXd& joint_limits) {
+  intrinsic_proto::world::UpdateObjectJointsRequest& request =
+      *Merge(JointsKey(kinematic_object)).mutable_update_object_joints();
+  request.mutable_object()->set_id(kinematic_object.Id().value());
+  *request.mutable_joint_application_limits() =
+      ToJointLimitsUpdate(joint_limits);
+  return *this;
+}
+
+ObjectWorldUpdateBuilder& ObjectWorldUpdateBuilder::UpdateJointSystemLimits(
+    const KinematicObject& kinematic_object,
+    const JointLimitsXd& joint_limits) {
+  intrinsic_proto::world::UpdateObjectJointsRequest& request =
+      *Merge(JointsKey(kinematic_object)).mutable_update_object_joints();
+  request.mutable_object()->set_id(kinematic_object.Id().value());
+  *request.mutable_joint_system_limits() = ToJointLimitsUpdate(joint_limits);
+  return *this;
+}
+
+ObjectWorldUpdateBuilder& ObjectWorldUpdateBuilder::UpdateCartesianLimits(
+    const KinematicObject& kinematic_object,
+    const CartesianLimits& cartesian_limits) {
+  intrinsic_proto::world::UpdateKinematicObjectPropertiesRequest& request =
+      *Merge(KinematicPropertiesKey(kinematic_object))
+           .mutable_update_kinematic_object_properties();
+  request.mutable_object()->set_id(kinematic_object.Id().value());
+  *request.mutable_cartesian_limits() =
+      intrinsic::icon::ToProto(cartesian_limits);
+  return *this;
+}
+
+ObjectWorldUpdateBuilder& ObjectWorldUpdateBuilder::UpdateMountedPayload(
+    const KinematicObject& kinematic_object, const RobotPayload& payload) {
+  intrinsic_proto::world::UpdateKinematicObjectPropertiesRequest& request =
+      *Merge(KinematicPropertiesKey(kinematic_object))
+           .mutable_update_kinematic_object_properties();
+  request.mutable_object()->set_id(kinematic_object.Id().value());
+  *request.mutable_mounted_payload() = ToProto(payload);
+  return *this;
+}
+
+ObjectWorldUpdateBuilder& ObjectWorldUpdateBuilder::UpdateMountedPayload(
+    const KinematicObject& kinematic_object,
+    const PrecomputedRobotPayload& payload) {
+  intrinsic_proto::world::UpdateKinematicObjectPropertiesRequest& request =
+      *Merge(KinematicPropertiesKey(kinematic_object))
+           .mutable_update_kinematic_object_properties();
+  request.mutable_object()->set_id(kinematic_object.Id().value());
+  *request.mutable_mounted_payload() = payload.proto();
+  return *this;
+}
+
+ObjectWorldUpdateBuilder& ObjectWorldUpdateBuilder::DisableCollisions(
+    const WorldObject& object_a, const ObjectEntityFilter& entity_filter_a,
+    const WorldObject& object_b, const ObjectEntityFilter& entity_filter_b) {
+  return ToggleCollisions(object_a, entity_filter_a, object_b, entity_filter_b,
+                          intrinsic_proto::world::TOGGLE_MODE_DISABLE);
+}
+
+ObjectWorldUpdateBuilder& ObjectWorldUpdateBuilder::DisableCollisions(
+    const WorldObject& object_a, const WorldObject& object_b) {
+  return DisableCollisions(object_a, ObjectEntityFilter::AllEntities(),
+                           object_b, ObjectEntityFilter::AllEntities());
+}
+
+ObjectWorldUpdateBuilder& ObjectWorldUpdateBuilder::EnableCollisions(
+    const WorldObject& object_a, const ObjectEntityFilter& entity_filter_a,
+    const WorldObject& object_b, const ObjectEntityFilter& entity_filter_b) {
+  return ToggleCollisions(object_a, entity_filter_a, object_b, entity_filter_b,
+                          intrinsic_proto::world::TOGGLE_MODE_ENABLE);
+}
+
+ObjectWorldUpdateBuilder& ObjectWorldUpdateBuilder::EnableCollisions(
+    const WorldObject& object_a, const WorldObject& object_b) {
+  return EnableCollisions(object_a, ObjectEntityFilter::AllEntities(),
+                          object_b, ObjectEntityFilter::AllEntities());
+}
+
+ObjectWorldUpdateBuilder& ObjectWorldUpdateBuilder::Add(
+    intrinsic_proto::world::ObjectWorldUpdate update) {
+  updates_.push_back(std::move(update));
+  return *this;
+}
+
+void ObjectWorldUpdateBuilder::Clear() {
+  updates_.clear();
+  num_merged_ = 0;
+  index_by_key_.clear();
+}
+
+intrinsic_proto::world::ObjectWorldUpdates ObjectWorldUpdateBuilder::Build()
+    const {
+  intrinsic_proto::world::ObjectWorldUpdates updates;
+  updates.mutable_updates()->Reserve(size());
+  for (const std::optional<intrinsic_proto::world::ObjectWorldUpdate>& update :
+       updates_) {
+    if (update.has_value()) {
+      *updates.add_updates() = *update;
+    }
+  }
+  return updates;
+}
+
+absl::Status ObjectWorldUpdateBuilder::Commit(ObjectWorldClient& world) {
+  if (empty()) {
+    return absl::OkStatus();
+  }
+  INTR_RETURN_IF_ERROR(world.BatchUpdate(Build()));
+  Clear();
+  return absl::OkStatus();
+}
+
+ObjectWorldUpdateBuilder& ObjectWorldUpdateBuilder::ToggleCollisions(
+    const WorldObject& object_a, const ObjectEntityFilter& entity_filter_a,
+    const WorldObject& object_b, const ObjectEntityFilter& entity_filter_b,
+    intrinsic_proto::world::ToggleMode toggle_mode) {
+  // The last toggle of a pair wins, whichever order its objects are given in.
+  std::string key_a = NodeKey(object_a, &entity_filter_a);
+  std::string key_b = NodeKey(object_b, &entity_filter_b);
+  if (key_b < key_a) {
+    std::swap(key_a, key_b);
+  }
+  intrinsic_proto::world::ToggleCollisionsRequest& request =
+      *Merge(absl::StrCat("collisions:", key_a, "|", key_b))
+           .mutable_toggle_collisions();
+  request.Clear();
+  request.set_toggle_mode(toggle_mode);
+  *request.mutable_object_a() =
+      object_a.ObjectReferenceWithEntityFilter(entity_filter_a);
+  *request.mutable_object_b() =
+      object_b.ObjectReferenceWithEntityFilter(entity_filter_b);
+  // Use minimalistic view since the response is ignored.
+  request.set_view(intrinsic_proto::world::ObjectView::BASIC);
+  return *this;
+}
+
+intrinsic_proto::world::ObjectWorldUpdate& ObjectWorldUpdateBuilder::Merge(
+    const std::string& key) {
+  auto [it, inserted] = index_by_key_.try_emplace(key, updates_.size());
+  if (inserted) {
+    return updates_.emplace_back().emplace();
+  }
+  std::optional<intrinsic_proto::world::ObjectWorldUpdate>& previous =
+      updates_[it->second];
+  intrinsic_proto::world::ObjectWorldUpdate update = *std::move(previous);
+  previous.reset();
+  ++num_merged_;
+  it->second = updates_.size();
+  return updates_.emplace_back(std::move(update)).value();
+}
+
+}  // namespace world
+}  // namespace intrinsic
@@ -0,0 +1,170 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_WORLD_OBJECTS_OBJECT_WORLD_UPDATE_BUILDER_H_
+#define INTRINSIC_WORLD_OBJECTS_OBJECT_WORLD_UPDATE_BUILDER_H_
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "intrinsic/eigenmath/types.h"
+#include "intrinsic/kinematics/types/cartesian_limits.h"
+#include "intrinsic/kinematics/types/joint_limits_xd.h"
+#include "intrinsic/math/pose3.h"
+#include "intrinsic/world/objects/kinematic_object.h"
+#include "intrinsic/world/objects/object_entity_filter.h"
+#include "intrinsic/world/objects/object_world_client.h"
+#include "intrinsic/world/objects/transform_node.h"
+#include "intrinsic/world/objects/world_object.h"
+#include "intrinsic/world/proto/object_world_updates.pb.h"
+#include "intrinsic/world/robot_payload/robot_payload.h"
+#include "intrinsic/world/robot_payload/robot_payload_library.h"
+
+namespace intrinsic {
+namespace world {
+
+// Records updates of a world and applies them atomically with a single
+// ObjectWorldClient::BatchUpdate() call, e.g.:
+//
+//   ObjectWorldUpdateBuilder updates;
+//   updates.UpdateJointPositions(robot, joint_positions)
+//       .UpdateTransform(root, workpiece, root_t_workpiece);
+//   INTR_RETURN_IF_ERROR(updates.Commit(world));
+//
+// Writes to the same property of the same node are merged, and the last write
+// wins: a repeated transform update replaces the previous one for the same
+// node, and joint or kinematic property updates of the same object are
+// combined into a single update. A merged update is applied at the position of
+// its latest write, so the batch stays as long as the number of distinct
+// properties written. Enabling and disabling collisions between the same
+// entities is merged the same way. Do not record updates that depend on an intermediate
+// value which is overwritten later in the same batch.
+//
+// Not thread safe.
+class ObjectWorldUpdateBuilder {
+ public:
+  ObjectWorldUpdateBuilder() = default;
+
+  // Records an update of the pose between 'node_a' and 'node_b'. See
+  // ObjectWorldClient::UpdateTransform().
+  ObjectWorldUpdateBuilder& UpdateTransform(const TransformNode& node_a,
+                                            const TransformNode& node_b,
+                                            const Pose3d& a_t_b);
+
+  // Records an update of the pose of 'node_to_update', such that the pose
+  // between 'node_a' and 'node_b' becomes 'a_t_b'. See
+  // ObjectWorldClient::UpdateTransform().
+  ObjectWorldUpdateBuilder& UpdateTransform(const TransformNode& node_a,
+                                            const TransformNode& node_b,
+                                            const TransformNode& node_to_update,
+                                            const Pose3d& a_t_b);
+
+  // Same as above, with the given entity filters for each node.
+  ObjectWorldUpdateBuilder& UpdateTransform(
+      const TransformNode& node_a, const ObjectEntityFilter& node_a_filter,
+      const TransformNode& node_b, const ObjectEntityFilter& node_b_filter,
+      const TransformNode& node_to_update,
+      const ObjectEntityFilter& node_to_update_filter, const Pose3d& a_t_b);
+
+  // Records an update of the joint positions of the given kinematic object.
+  ObjectWorldUpdateBuilder& UpdateJointPositions(
+      const KinematicObject& kinematic_object,
+      const eigenmath::VectorXd& joint_positions);
+
+  // Records an update of the joint application limits of the given kinematic
+  // object.
+  ObjectWorldUpdateBuilder& UpdateJointApplicationLimits(
+      const KinematicObject& kinematic_object,
+      const JointLimitsXd& joint_limits);
+
+  // Records an update of the joint system limits of the given kinematic
+  // object.
+  ObjectWorldUpdateBuilder& UpdateJointSystemLimits(
+      const KinematicObject& kinematic_object,
+      const JointLimitsXd& joint_limits);
+
+  // Records an update of the cartesian limits of the given kinematic object.
+  ObjectWorldUpdateBuilder& UpdateCartesianLimits(
+      const KinematicObject& kinematic_object,
+      const CartesianLimits& cartesian_limits);
+
+  // Records an update of the mounted payload of the given kinematic object.
+  ObjectWorldUpdateBuilder& UpdateMountedPayload(
+      const KinematicObject& kinematic_object, const RobotPayload& payload);
+
+  // Same as above, with a precomputed payload, which is not converted again.
+  ObjectWorldUpdateBuilder& UpdateMountedPayload(
+      const KinematicObject& kinematic_object,
+      const PrecomputedRobotPayload& payload);
+
+  // Records disabling collisions between the entities of 'object_a' and
+  // 'object_b' that the filters select. See
+  // ObjectWorldClient::DisableCollisions().
+  ObjectWorldUpdateBuilder& DisableCollisions(
+      const WorldObject& object_a, const ObjectEntityFilter& entity_filter_a,
+      const WorldObject& object_b, const ObjectEntityFilter& entity_filter_b);
+
+  // Same as above, for all entities of both objects.
+  ObjectWorldUpdateBuilder& DisableCollisions(const WorldObject& object_a,
+                                              const WorldObject& object_b);
+
+  // Records enabling collisions between the entities of 'object_a' and
+  // 'object_b' that the filters select. See
+  // ObjectWorldClient::EnableCollisions().
+  ObjectWorldUpdateBuilder& EnableCollisions(
+      const WorldObject& object_a, const ObjectEntityFilter& entity_filter_a,
+      const WorldObject& object_b, const ObjectEntityFilter& entity_filter_b);
+
+  // Same as above, for all entities of both objects.
+  ObjectWorldUpdateBuilder& EnableCollisions(const WorldObject& object_a,
+                                             const WorldObject& object_b);
+
+  // Records the given update as is. It is applied in order and never merged
+  // with other updates.
+  ObjectWorldUpdateBuilder& Add(
+      intrinsic_proto::world::ObjectWorldUpdate update);
+
+  // Returns true if no updates are recorded.
+  bool empty() const { return size() == 0; }
+
+  // Returns the number of updates that Build() returns.
+  size_t size() const { return updates_.size() - num_merged_; }
+
+  // Drops all recorded updates.
+  void Clear();
+
+  // Returns the recorded updates, with redundant writes merged.
+  intrinsic_proto::world::ObjectWorldUpdates Build() const;
+
+  // Applies the recorded updates to `world` with a single BatchUpdate() call,
+  // and drops them if that succeeded. Does nothing if no updates are
+  // recorded.
+  absl::Status Commit(ObjectWorldClient& world);
+
+ private:
+  // Returns the update recorded under `key`, moved to the end of the batch, or
+  // a new update at the end of the batch.
+  intrinsic_proto::world::ObjectWorldUpdate& Merge(const std::string& key);
+
+  // Records enabling or disabling collisions between the given entities.
+  ObjectWorldUpdateBuilder& ToggleCollisions(
+      const WorldObject& object_a, const ObjectEntityFilter& entity_filter_a,
+      const WorldObject& object_b, const ObjectEntityFilter& entity_filter_b,
+      intrinsic_proto::world::ToggleMode toggle_mode);
+
+  // Recorded updates in order. Updates that were merged into a later one are
+  // empty.
+  std::vector<std::optional<intrinsic_proto::world::ObjectWorldUpdate>>
+      updates_;
+  size_t num_merged_ = 0;
+  // Index into `updates_` of the latest write of each merged property.
+  absl::flat_hash_map<std::string, size_t> index_by_key_;
+};
+
+}  // namespace world
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_WORLD_OBJECTS_OBJECT_WORLD_UPDATE_BUILDER_H_
@@ -2,6 +2,8 @@
 
 #include "intrinsic/world/objects/world_object.h"
 
+#include <atomic>
+#include <cstddef>
 #include <iterator>
 #include <memory>
 #include <optional>
@@ -10,7 +12,10 @@
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/base/call_once.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
+#include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/substitute.h"
@@ -23,10 +28,44 @@
 #include "intrinsic/world/objects/transform_node.h"
 #include "intrinsic/world/proto/object_world_refs.pb.h"
 #include "intrinsic/world/proto/object_world_service.pb.h"
+#include "intrinsic/world/proto/object_world_updates.pb.h"
 
 namespace intrinsic {
 namespace world {
 
+struct WorldObject::LazyFullView {
+  explicit LazyFullView(FullViewLoader load) : load(std::move(load)) {}
+
+  const absl::StatusOr<std::shared_ptr<const Data>>& Get() {
+    absl::call_once(once, [this]() {
+      absl::StatusOr<intrinsic_proto::world::Object> proto = load();
+      if (proto.ok()) {
+        data = CreateWorldObjectData(*std::move(proto));
+      } else {
+        data = proto.status();
+      }
+      if (!data.ok()) {
+        LOG(ERROR) << "Failed to read the full view of an object: "
+                   << data.status();
+      }
+      load = nullptr;
+      loaded.store(data.ok(), std::memory_order_release);
+    });
+    return data;
+  }
+
+  FullViewLoader load;
+  absl::once_flag once;
+  absl::StatusOr<std::shared_ptr<const Data>> data;
+  // Whether `data` holds the full view.
+  std::atomic<bool> loaded = false;
+};
+
+struct WorldObject::FrameIndex {
+  absl::once_flag once;
+  absl::flat_hash_map<FrameName, size_t> index_by_name;
+};
+
 absl::StatusOr<std::shared_ptr<const WorldObject::Data>>
 WorldObject::CreateWorldObjectData(intrinsic_proto::world::Object proto) {
   Pose3d parent_t_this;
@@ -56,6 +95,28 @@ absl::StatusOr<WorldObject> WorldObject::Create(
   return WorldObject(std::move(data));
 }
 
+absl::StatusOr<WorldObject> WorldObject::Create(
+    intrinsic_proto::world::Object proto,
+    intrinsic_proto::world::ObjectView view, FullViewLoader load_full_view) {
+  if (view == intrinsic_proto::world::ObjectView::FULL) {
+    return Create(std::move(proto));
+  }
+  // Smaller views have the pose of the object, but not the poses of its
+  // frames.
+  Pose3d parent_t_this;
+  if (proto.type() != intrinsic_proto::world::ObjectType::ROOT) {
+    if (!proto.has_object_component()) {
+      return absl::InternalError("Missing object_component");
+    }
+    INTR_ASSIGN_OR_RETURN(
+        parent_t_this,
+        intrinsic_proto::FromProto(proto.object_component().parent_t_this()));
+  }
+  return WorldObject(std::make_shared<const Data>(
+      std::move(proto), parent_t_this, std::vector<Frame>(),
+      std::make_shared<LazyFullView>(std::move(load_full_view))));
+}
+
 std::optional<WorldObject> WorldObject::FromTransformNode(
     const TransformNode& node) {
   std::shared_ptr<const Data> object_data =
@@ -87,90 +148,52 @@ WorldObjectName WorldObject::ParentName() const {
   return WorldObjectName(GetData().Proto().parent().name());
 }
 
-std::vector<ObjectWorldResourceId> WorldObject::ChildIds() const {
-  std::vector<ObjectWorldResourceId> result;
-  for (const intrinsic_proto::world::IdAndName& child :
-       GetData().Proto().children()) {
-    result.emplace_back(child.id());
-  }
-  return result;
+const std::vector<ObjectWorldResourceId>& WorldObject::ChildIds() const {
+  return GetData().ChildIds();
 }
 
-std::vector<WorldObjectName> WorldObject::ChildNames() const {
-  std::vector<WorldObjectName> result;
-  for (const intrinsic_proto::world::IdAndName& child :
-       GetData().Proto().children()) {
-    result.emplace_back(child.name());
-  }
-  return result;
+const std::vector<WorldObjectName>& WorldObject::ChildNames() const {
+  return GetData().ChildNames();
 }
 
-std::vector<ObjectWorldResourceId> WorldObject::FrameIds() const {
-  std::vector<ObjectWorldResourceId> result;
-  for (const intrinsic_proto::world::Frame& frame :
-       GetData().Proto().frames()) {
-    result.emplace_back(frame.id());
-  }
-  return result;
+const std::vector<ObjectWorldResourceId>& WorldObject::FrameIds() const {
+  return GetData().FrameIds();
 }
 
-std::vector<FrameName> WorldObject::FrameNames() const {
-  std::vector<FrameName> result;
-  for (const intrinsic_proto::world::Frame& frame :
-       GetData().Proto().frames()) {
-    result.emplace_back(frame.name());
-  }
-  return result;
+const std::vector<FrameName>& WorldObject::FrameNames() const {
+  return GetData().FrameNames();
 }
 
-std::vector<ObjectWorldResourceId> WorldObject::ChildFrameIds() const {
-  std::vector<ObjectWorldResourceId> result;
-  result.reserve(GetData().Proto().frames_size());
-  for (const intrinsic_proto::world::Frame& frame :
-       GetData().Proto().frames()) {
-    if (frame.has_parent_frame()) continue;
-    result.emplace_back(frame.id());
-  }
-  return result;
+const std::vector<ObjectWorldResourceId>& WorldObject::ChildFrameIds() const {
+  return GetData().ChildFrameIds();
 }
 
-std::vector<FrameName> WorldObject::ChildFrameNames() const {
-  std::vector<FrameName> result;
-  result.reserve(GetData().Proto().frames_size());
-  for (const intrinsic_proto::world::Frame& frame :
-       GetData().Proto().frames()) {
-    if (frame.has_parent_frame()) continue;
-    result.emplace_back(frame.name());
-  }
-  return result;
+const std::vector<FrameName>& WorldObject::ChildFrameNames() const {
+  return GetData().ChildFrameNames();
 }
 
-std::vector<Frame> WorldObject::Frames() const { return GetData().Frames(); }
+const std::vector<Frame>& WorldObject::Frames() const {
+  return GetData().FullViewOrThis().Frames();
+}
 
 absl::StatusOr<Frame> WorldObject::GetFrame(const FrameName& name) const {
-  for (const Frame& frame : GetData().Frames()) {
-    if (frame.Name() == name) {
-      return frame;
-    }
+  INTR_ASSIGN_OR_RETURN(const Data* data, GetData().FullView());
+  if (const Frame* frame = data->FindFrame(name); frame != nullptr) {
+    return *frame;
   }
   return absl::NotFoundError(
       absl::Substitute("Frame \"$0\" not found under object \"$1\".",
                        name.value(), Name().value()));
 }
 
-std::vector<Frame> WorldObject::ChildFrames() const {
-  std::vector<Frame> result;
-  result.reserve(GetData().Frames().size());
-  absl::c_copy_if(
-      GetData().Frames(), std::back_inserter(result),
-      [](const Frame& frame) { return !frame.ParentFrameId().has_value(); });
-  return result;
+const std::vector<Frame>& WorldObject::ChildFrames() const {
+  return GetData().FullViewOrThis().ChildFrames();
 }
 
 std::optional<const intrinsic_proto::world::SpawnerComponent*>
 WorldObject::GetSpawnerComponent() const {
   const intrinsic_proto::world::ObjectComponent& proto =
-      GetData().Proto().object_component();
+      GetData().FullViewOrThis().Proto().object_component();
   if (proto.has_spawner_component()) {
     return &proto.spawner_component();
   }
@@ -180,7 +203,7 @@ WorldObject::GetSpawnerComponent() const {
 std::optional<const intrinsic_proto::world::OutfeedComponent*>
 WorldObject::GetOutfeedComponent() const {
   const intrinsic_proto::world::ObjectComponent& proto =
-      GetData().Proto().object_component();
+      GetData().FullViewOrThis().Proto().object_component();
   if (proto.has_outfeed_component()) {
     return &proto.outfeed_component();
   }
@@ -203,9 +226,11 @@ WorldObject::ObjectReferenceWithEntityFilter(
 }
 
 const intrinsic_proto::world::Object& WorldObject::Proto() const {
-  return GetData().Proto();
+  return GetData().FullViewOrThis().Proto();
 }
 
+bool WorldObject::HasFullView() const { return GetData().HasFullView(); }
+
 const WorldObject::Data& WorldObject::GetData() const {
   // This has to succeed because instances of WorldObject are always only
   // created with an instance of WorldObject::Data or a subclass thereof.
@@ -213,10 +238,33 @@ const WorldObject::Data& WorldObject::GetData() const {
 }
 
 WorldObject::Data::Data(intrinsic_proto::world::Object proto,
-                        const Pose3d& parent_t_this, std::vector<Frame> frames)
+                        const Pose3d& parent_t_this, std::vector<Frame> frames,
+                        std::shared_ptr<LazyFullView> lazy_full_view)
     : proto_(std::move(proto)),
       parent_t_this_(parent_t_this),
-      frames_(std::move(frames)) {}
+      frames_(std::move(frames)),
+      frame_index_(std::make_shared<FrameIndex>()),
+      lazy_full_view_(std::move(lazy_full_view)) {
+  child_ids_.reserve(proto_.children_size());
+  child_names_.reserve(proto_.children_size());
+  for (const intrinsic_proto::world::IdAndName& child : proto_.children()) {
+    child_ids_.emplace_back(child.id());
+    child_names_.emplace_back(child.name());
+  }
+  frame_ids_.reserve(proto_.frames_size());
+  frame_names_.reserve(proto_.frames_size());
+  for (const intrinsic_proto::world::Frame& frame : proto_.frames()) {
+    frame_ids_.emplace_back(frame.id());
+    frame_names_.emplace_back(frame.name());
+    if (!frame.has_parent_frame()) {
+      child_frame_ids_.emplace_back(frame.id());
+      child_frame_names_.emplace_back(frame.name());
+    }
+  }
+  absl::c_copy_if(
+      frames_, std::back_inserter(child_frames_),
+      [](const Frame& frame) { return !frame.ParentFrameId().has_value(); });
+}
 
 ObjectWorldResourceId WorldObject::Data::Id() const {
   return ObjectWorldResourceId(proto_.id());
@@ -237,5 +285,71 @@ const intrinsic_proto::world::Object& WorldObject::Data::Proto() const {
 
 const std::vector<Frame>& WorldObject::Data::Frames() const { return frames_; }
 
+const std::vector<ObjectWorldResourceId>& WorldObject::Data::ChildIds() const {
+  return child_ids_;
+}
+
+const std::vector<WorldObjectName>& WorldObject::Data::ChildNames() const {
+  return child_names_;
+}
+
+const std::vector<ObjectWorldResourceId>& WorldObject::Data::FrameIds() const {
+  return frame_ids_;
+}
+
+const std::vector<FrameName>& WorldObject::Data::FrameNames() const {
+  return frame_names_;
+}
+
+const std::vector<ObjectWorldResourceId>& WorldObject::Data::ChildFrameIds()
+    const {
+  return child_frame_ids_;
+}
+
+const std::vector<FrameName>& WorldObject::Data::ChildFrameNames() const {
+  return child_frame_names_;
+}
+
+const std::vector<Frame>& WorldObject::Data::ChildFrames() const {
+  return child_frames_;
+}
+
+const Frame* WorldObject::Data::FindFrame(const FrameName& name) const {
+  absl::call_once(frame_index_->once, [this]() {
+    frame_index_->index_by_name.reserve(frames_.size());
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      // Keeps the first frame if names repeat, as a linear search would.
+      frame_index_->index_by_name.try_emplace(frames_[i].Name(), i);
+    }
+  });
+  auto it = frame_index_->index_by_name.find(name);
+  return it == frame_index_->index_by_name.end() ? nullptr
+                                                 : &frames_[it->second];
+}
+
+absl::StatusOr<const WorldObject::Data*> WorldObject::Data::FullView() const {
+  if (lazy_full_view_ == nullptr) {
+    return this;
+  }
+  const absl::StatusOr<std::shared_ptr<const Data>>& data =
+      lazy_full_view_->Get();
+  if (!data.ok()) {
+    return data.status();
+  }
+  return data->get();
+}
+
+const WorldObject::Data& WorldObject::Data::FullViewOrThis() const {
+  absl::StatusOr<const Data*> data = FullView();
+  return data.ok() ? **data : *this;
+}
+
+bool WorldObject::Data::HasFullView() const {
+  if (lazy_full_view_ == nullptr) {
+    return true;
+  }
+  return lazy_full_view_->loaded.load(std::memory_order_acquire);
+}
+
 }  // namespace world
 }  // namespace intrinsic
@@ -3,10 +3,12 @@
 #ifndef INTRINSIC_WORLD_OBJECTS_WORLD_OBJECT_H_
 #define INTRINSIC_WORLD_OBJECTS_WORLD_OBJECT_H_
 
+#include <functional>
 #include <memory>
 #include <optional>
 #include <vector>
 
+#include "absl/base/attributes.h"
 #include "absl/status/statusor.h"
 #include "intrinsic/math/pose3.h"
 #include "intrinsic/world/objects/frame.h"
@@ -15,6 +17,7 @@
 #include "intrinsic/world/objects/transform_node.h"
 #include "intrinsic/world/proto/object_world_refs.pb.h"
 #include "intrinsic/world/proto/object_world_service.pb.h"
+#include "intrinsic/world/proto/object_world_updates.pb.h"
 #include "intrinsic/world/proto/outfeed_component.pb.h"
 #include "intrinsic/world/proto/spawner_component.pb.h"
 
@@ -29,14 +32,34 @@ namespace world {
 //
 // Effectively, this is a convenience wrapper around an immutable
 // intrinsic_proto::world::Object.
+//
+// A local copy read with ObjectView::BASIC holds the place of the object in the
+// world and its pose, and reads the rest of the object, i.e., the poses of its
+// frames and its components, once they are first accessed.
+//
+// The lists of children and frames are built once when the object is created,
+// and are shared by all copies of it. The returned references stay valid as
+// long as this object or a copy of it exists.
 class WorldObject : public TransformNode {
  public:
+  // Reads the full view of an object that was read with a smaller view.
+  using FullViewLoader =
+      std::function<absl::StatusOr<intrinsic_proto::world::Object>()>;
+
   // Creates a new instance from the given proto. The caller must ensure that
   // the object is either the root object or has a set 'object_component' (i.e.,
   // it was retrieved with an apppropriately detailed ObjectView).
   static absl::StatusOr<WorldObject> Create(
       intrinsic_proto::world::Object proto);
 
+  // Creates a new instance from the given proto, which was retrieved with the
+  // given view. Unless `view` is ObjectView::FULL, the frames, the components
+  // and Proto() are taken from the result of `load_full_view`, which is called
+  // when one of them is first accessed.
+  static absl::StatusOr<WorldObject> Create(
+      intrinsic_proto::world::Object proto,
+      intrinsic_proto::world::ObjectView view, FullViewLoader load_full_view);
+
   // Returns the given TransformNode "downcasted" to a WorldObject or returns
   // std::nullopt if the given TransformNode is not a world object.
   static std::optional<WorldObject> FromTransformNode(
@@ -55,38 +78,48 @@ class WorldObject : public TransformNode {
   WorldObjectName ParentName() const;
 
   // Returns the ids of the child objects.
-  std::vector<ObjectWorldResourceId> ChildIds() const;
+  const std::vector<ObjectWorldResourceId>& ChildIds() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
   // Returns the names of the child objects.
-  std::vector<WorldObjectName> ChildNames() const;
+  const std::vector<WorldObjectName>& ChildNames() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
   // Returns the ids of all frames under this object, including ones that are
   // attached indirectly to this object via another frame.
-  std::vector<ObjectWorldResourceId> FrameIds() const;
+  const std::vector<ObjectWorldResourceId>& FrameIds() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
   // Returns the names of all frames under this object, including ones that are
   // attached indirectly to this object via another frame.
-  std::vector<FrameName> FrameNames() const;
+  const std::vector<FrameName>& FrameNames() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
   // Returns all frames under this object, including ones that are attached
-  // indirectly to this object via another frame.
-  std::vector<Frame> Frames() const;
+  // indirectly to this object via another frame. Empty if the full view of
+  // the object cannot be read.
+  const std::vector<Frame>& Frames() const ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
   // Returns the frame with the given name under this object. Returns an error
-  // if no such frame exists.
+  // if no such frame exists, or if the full view of the object cannot be read.
+  //
+  // Looks the name up in an index of the frames, which is built on the first
+  // call and shared by all copies of this object.
   absl::StatusOr<Frame> GetFrame(const FrameName& name) const;
 
   // Returns the ids of all immediate child frames of this object, excluding
   // ones that are attached indirectly to this object via another frame.
-  std::vector<ObjectWorldResourceId> ChildFrameIds() const;
+  const std::vector<ObjectWorldResourceId>& ChildFrameIds() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
   // Returns the names of all immediate child frames of this object, excluding
   // ones that are attached indirectly to this object via another frame.
-  std::vector<FrameName> ChildFrameNames() const;
+  const std::vector<FrameName>& ChildFrameNames() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
   // Returns all immediate child frames of this object, excluding ones that are
   // attached indirectly to this object via another frame.
-  std::vector<Frame> ChildFrames() const;
+  const std::vector<Frame>& ChildFrames() const ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
   // Returns the spawner component corresponding to this world object. This is
   // only set if the object was added to the world as a spawner.
@@ -108,14 +141,25 @@ class WorldObject : public TransformNode {
   intrinsic_proto::world::ObjectReferenceWithEntityFilter
   ObjectReferenceWithEntityFilter(const ObjectEntityFilter& filter) const;
 
-  // Returns the underlying object proto.
+  // Returns the underlying object proto, which is the retrieved view if the
+  // full view of the object cannot be read.
   const intrinsic_proto::world::Object& Proto() const;
 
+  // Returns true if this local copy holds the full view of the object, or has
+  // already read it.
+  bool HasFullView() const;
+
  protected:
+  // The full view of an object, read on first use.
+  struct LazyFullView;
+  // Indices into Data::Frames() by frame name, built on first use.
+  struct FrameIndex;
+
   class Data : public TransformNode::Data {
    public:
     explicit Data(intrinsic_proto::world::Object proto,
-                  const Pose3d& parent_t_this, std::vector<Frame> frames);
+                  const Pose3d& parent_t_this, std::vector<Frame> frames,
+                  std::shared_ptr<LazyFullView> lazy_full_view = nullptr);
     ObjectWorldResourceId Id() const override;
     Pose3d ParentTThis() const override;
     intrinsic_proto::world::TransformNodeReference TransformNodeReference()
@@ -123,11 +167,40 @@ class WorldObject : public TransformNode {
 
     const intrinsic_proto::world::Object& Proto() const;
     const std::vector<Frame>& Frames() const;
+    const std::vector<ObjectWorldResourceId>& ChildIds() const;
+    const std::vector<WorldObjectName>& ChildNames() const;
+    const std::vector<ObjectWorldResourceId>& FrameIds() const;
+    const std::vector<FrameName>& FrameNames() const;
+    const std::vector<ObjectWorldResourceId>& ChildFrameIds() const;
+    const std::vector<FrameName>& ChildFrameNames() const;
+    const std::vector<Frame>& ChildFrames() const;
+    // Returns the frame with the given name, or nullptr if there is none.
+    const Frame* FindFrame(const FrameName& name) const;
+
+    // Returns the data of the full view, which reads it if needed, or the
+    // error of reading it.
+    absl::StatusOr<const Data*> FullView() const;
+    // Returns the data of the full view, or this data if the full view cannot
+    // be read.
+    const Data& FullViewOrThis() const;
+    bool HasFullView() const;
 
    private:
     intrinsic_proto::world::Object proto_;
     Pose3d parent_t_this_;
     std::vector<Frame> frames_;
+    // Derived from `proto_` and `frames_`.
+    std::vector<ObjectWorldResourceId> child_ids_;
+    std::vector<WorldObjectName> child_names_;
+    std::vector<ObjectWorldResourceId> frame_ids_;
+    std::vector<FrameName> frame_names_;
+    std::vector<ObjectWorldResourceId> child_frame_ids_;
+    std::vector<FrameName> child_frame_names_;
+    std::vector<Frame> child_frames_;
+    // Shared, since copies of the data must keep the index alive.
+    std::shared_ptr<FrameIndex> frame_index_;
+    // Null if `proto_` is the full view.
+    std::shared_ptr<LazyFullView> lazy_full_view_;
   };
 
   static absl::StatusOr<std::shared_ptr<const Data>> CreateWorldObjectData(
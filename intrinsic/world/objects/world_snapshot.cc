@@ -0,0 +1,381 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/world/objects/world_snapshot.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "flatbuffers/detached_buffer.h"
+#include "flatbuffers/flatbuffer_builder.h"
+#include "flatbuffers/verifier.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "intrinsic/icon/flatbuffers/transform_types_generated.h"
+#include "intrinsic/math/pose3.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/world/objects/object_world_client.h"
+#include "intrinsic/world/objects/object_world_ids.h"
+#include "intrinsic/world/objects/world_object.h"
+#include "intrinsic/world/objects/world_snapshot_generated.h"
+#include "intrinsic/world/proto/object_world_service.pb.h"
+#include "intrinsic/world/proto/object_world_updates.pb.h"
+
+namespace intrinsic {
+namespace world {
+
+namespace {
+
+using ::intrinsic_fbs::world::SnapshotObject;
+using ::intrinsic_fbs::world::SnapshotObjectName;
+
+absl::string_view ToStringView(const flatbuffers::String* string) {
+  return absl::string_view(string->c_str(), string->size());
+}
+
+absl::Status ErrnoToStatus(absl::string_view what, absl::string_view path) {
+  return absl::InternalError(
+      absl::StrCat(what, " ", path, " failed: ", std::strerror(errno)));
+}
+
+// Serializes `object` without its world id, which the snapshot holds once, so
+// that equal objects of different worlds have equal bytes.
+std::string SerializeObject(intrinsic_proto::world::Object object) {
+  object.clear_world_id();
+  std::string serialized;
+  {
+    google::protobuf::io::StringOutputStream stream(&serialized);
+    google::protobuf::io::CodedOutputStream coded_stream(&stream);
+    // Maps, such as the entities, are serialized in a stable order.
+    coded_stream.SetSerializationDeterministic(true);
+    object.SerializeToCodedStream(&coded_stream);
+  }
+  return serialized;
+}
+
+intrinsic_fbs::Transform ToFbsTransform(const Pose3d& pose) {
+  const eigenmath::Quaterniond& rotation = pose.quaternion();
+  return intrinsic_fbs::Transform(
+      intrinsic_fbs::Point(pose.translation().x(), pose.translation().y(),
+                           pose.translation().z()),
+      intrinsic_fbs::Rotation(rotation.x(), rotation.y(), rotation.z(),
+                              rotation.w()));
+}
+
+// Returns the index of the first element of `entries` whose key is not less
+// than `key`.
+template <typename T, typename KeyFn>
+size_t LowerBound(const flatbuffers::Vector<flatbuffers::Offset<T>>& entries,
+                  absl::string_view key, KeyFn key_fn) {
+  size_t begin = 0;
+  size_t end = entries.size();
+  while (begin < end) {
+    const size_t middle = begin + (end - begin) / 2;
+    if (key_fn(*entries.Get(middle)) < key) {
+      begin = middle + 1;
+    } else {
+      end = middle;
+    }
+  }
+  return begin;
+}
+
+bool HaveEqualProtos(const SnapshotObject& a, const SnapshotObject& b) {
+  return a.proto()->size() == b.proto()->size() &&
+         std::memcmp(a.proto()->data(), b.proto()->data(), a.proto()->size()) ==
+             0;
+}
+
+}  // namespace
+
+absl::StatusOr<flatbuffers::DetachedBuffer> ExportWorldSnapshot(
+    const ObjectWorldClient& world) {
+  INTR_ASSIGN_OR_RETURN(
+      const std::vector<WorldObject> objects,
+      world.ListObjects(intrinsic_proto::world::ObjectView::FULL));
+  return BuildWorldSnapshot(world.GetWorldID(), objects);
+}
+
+absl::StatusOr<flatbuffers::DetachedBuffer> BuildWorldSnapshot(
+    absl::string_view world_id, absl::Span<const WorldObject> objects) {
+  std::vector<const WorldObject*> sorted;
+  sorted.reserve(objects.size());
+  for (const WorldObject& object : objects) {
+    sorted.push_back(&object);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const WorldObject* a, const WorldObject* b) {
+              return a->Id().value() < b->Id().value();
+            });
+  for (size_t i = 1; i < sorted.size(); ++i) {
+    if (sorted[i - 1]->Id() == sorted[i]->Id()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Duplicate object id ", sorted[i]->Id().value()));
+    }
+  }
+
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<SnapshotObject>> snapshot_objects;
+  std::vector<flatbuffers::Offset<SnapshotObjectName>> names;
+  std::vector<absl::string_view> sorted_names;
+  snapshot_objects.reserve(sorted.size());
+  names.reserve(sorted.size());
+  sorted_names.reserve(sorted.size());
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    const WorldObject& object = *sorted[i];
+    const std::string serialized = SerializeObject(object.Proto());
+    const auto id = builder.CreateString(object.Id().value());
+    // Shared by the object and the index entry.
+    const auto name = builder.CreateString(object.Name().value());
+    const auto parent_id = builder.CreateString(object.ParentId().value());
+    const auto proto = builder.CreateVector(
+        reinterpret_cast<const uint8_t*>(serialized.data()), serialized.size());
+    const intrinsic_fbs::Transform parent_t_this =
+        ToFbsTransform(object.ParentTThis());
+    snapshot_objects.push_back(intrinsic_fbs::world::CreateSnapshotObject(
+        builder, id, name, parent_id, &parent_t_this, proto));
+    names.push_back(intrinsic_fbs::world::CreateSnapshotObjectName(
+        builder, name, static_cast<uint32_t>(i)));
+    sorted_names.push_back(object.Name().value());
+  }
+  std::sort(sorted_names.begin(), sorted_names.end());
+  if (auto it = std::adjacent_find(sorted_names.begin(), sorted_names.end());
+      it != sorted_names.end()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Duplicate object name ", *it));
+  }
+
+  const auto world_id_offset =
+      builder.CreateString(world_id.data(), world_id.size());
+  const auto objects_offset = builder.CreateVector(snapshot_objects);
+  const auto names_offset = builder.CreateVectorOfSortedTables(&names);
+  builder.Finish(intrinsic_fbs::world::CreateWorldSnapshot(
+                     builder, world_id_offset, objects_offset, names_offset),
+                 intrinsic_fbs::world::WorldSnapshotIdentifier());
+  return builder.Release();
+}
+
+absl::Status WriteWorldSnapshot(absl::string_view path,
+                                const flatbuffers::DetachedBuffer& snapshot) {
+  const std::string final_path(path);
+  const std::string temp_path = absl::StrCat(path, ".tmp");
+  const int fd =
+      open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return ErrnoToStatus("Creating world snapshot", temp_path);
+  }
+  const uint8_t* data = snapshot.data();
+  size_t remaining = snapshot.size();
+  while (remaining > 0) {
+    const ssize_t written = write(fd, data, remaining);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      const absl::Status status =
+          ErrnoToStatus("Writing world snapshot", temp_path);
+      close(fd);
+      unlink(temp_path.c_str());
+      return status;
+    }
+    data += written;
+    remaining -= written;
+  }
+  const bool synced = fsync(fd) == 0;
+  if (close(fd) != 0 || !synced) {
+    const absl::Status status =
+        ErrnoToStatus("Writing world snapshot", temp_path);
+    unlink(temp_path.c_str());
+    return status;
+  }
+  if (rename(temp_path.c_str(), final_path.c_str()) != 0) {
+    const absl::Status status =
+        ErrnoToStatus("Renaming world snapshot", temp_path);
+    unlink(temp_path.c_str());
+    return status;
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<WorldSnapshotView> WorldSnapshotView::Create(
+    absl::Span<const uint8_t> data) {
+  flatbuffers::Verifier verifier(data.data(), data.size());
+  // Also checks the file identifier.
+  if (!intrinsic_fbs::world::VerifyWorldSnapshotBuffer(verifier)) {
+    return absl::InvalidArgumentError("Not a valid world snapshot");
+  }
+  return WorldSnapshotView(intrinsic_fbs::world::GetWorldSnapshot(data.data()));
+}
+
+absl::string_view WorldSnapshotView::world_id() const {
+  return snapshot_->world_id() == nullptr ? absl::string_view()
+                                          : ToStringView(snapshot_->world_id());
+}
+
+const SnapshotObject* WorldSnapshotView::Find(
+    const ObjectWorldResourceId& id) const {
+  const auto& objects = *snapshot_->objects();
+  const size_t index =
+      LowerBound(objects, id.value(), [](const SnapshotObject& object) {
+        return ToStringView(object.id());
+      });
+  if (index == objects.size() ||
+      ToStringView(objects.Get(index)->id()) != id.value()) {
+    return nullptr;
+  }
+  return objects.Get(index);
+}
+
+const SnapshotObject* WorldSnapshotView::Find(
+    const WorldObjectName& name) const {
+  const auto& names = *snapshot_->objects_by_name();
+  const size_t index =
+      LowerBound(names, name.value(), [](const SnapshotObjectName& entry) {
+        return ToStringView(entry.name());
+      });
+  if (index == names.size() ||
+      ToStringView(names.Get(index)->name()) != name.value() ||
+      names.Get(index)->object() >= size()) {
+    return nullptr;
+  }
+  return snapshot_->objects()->Get(names.Get(index)->object());
+}
+
+absl::StatusOr<WorldObject> WorldSnapshotView::GetObject(
+    const ObjectWorldResourceId& id) const {
+  const SnapshotObject* object = Find(id);
+  if (object == nullptr) {
+    return absl::NotFoundError(
+        absl::StrCat("No object with id ", id.value(), " in world snapshot"));
+  }
+  return ToWorldObject(*object);
+}
+
+absl::StatusOr<WorldObject> WorldSnapshotView::GetObject(
+    const WorldObjectName& name) const {
+  const SnapshotObject* object = Find(name);
+  if (object == nullptr) {
+    return absl::NotFoundError(absl::StrCat(
+        "No object with name ", name.value(), " in world snapshot"));
+  }
+  return ToWorldObject(*object);
+}
+
+absl::StatusOr<std::vector<WorldObject>> WorldSnapshotView::ListObjects()
+    const {
+  std::vector<WorldObject> result;
+  result.reserve(size());
+  for (const SnapshotObject* object : *snapshot_->objects()) {
+    INTR_ASSIGN_OR_RETURN(WorldObject world_object, ToWorldObject(*object));
+    result.push_back(std::move(world_object));
+  }
+  return result;
+}
+
+absl::StatusOr<WorldObject> WorldSnapshotView::ToWorldObject(
+    const SnapshotObject& object) const {
+  intrinsic_proto::world::Object proto;
+  if (!proto.ParseFromArray(object.proto()->data(), object.proto()->size())) {
+    return absl::DataLossError(absl::StrCat("Cannot parse object ",
+                                            ToStringView(object.id()),
+                                            " of world snapshot"));
+  }
+  proto.set_world_id(std::string(world_id()));
+  return WorldObject::Create(std::move(proto));
+}
+
+// static
+absl::StatusOr<std::unique_ptr<WorldSnapshotFile>> WorldSnapshotFile::Open(
+    absl::string_view path) {
+  const std::string path_string(path);
+  const int fd = open(path_string.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return ErrnoToStatus("Opening world snapshot", path);
+  }
+  struct stat stat_buffer;
+  if (fstat(fd, &stat_buffer) != 0) {
+    const absl::Status status = ErrnoToStatus("Reading world snapshot", path);
+    close(fd);
+    return status;
+  }
+  const size_t size = stat_buffer.st_size;
+  if (size == 0) {
+    close(fd);
+    return absl::InvalidArgumentError(
+        absl::StrCat("World snapshot ", path, " is empty"));
+  }
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return ErrnoToStatus("Mapping world snapshot", path);
+  }
+  absl::StatusOr<WorldSnapshotView> view = WorldSnapshotView::Create(
+      absl::MakeConstSpan(static_cast<const uint8_t*>(data), size));
+  if (!view.ok()) {
+    munmap(data, size);
+    return view.status();
+  }
+  // Private constructor, so no make_unique.
+  return absl::WrapUnique(new WorldSnapshotFile(data, size, *view));
+}
+
+WorldSnapshotFile::~WorldSnapshotFile() {
+  munmap(const_cast<void*>(data_), size_);
+}
+
+WorldSnapshotDiff DiffWorldSnapshots(const WorldSnapshotView& from,
+                                     const WorldSnapshotView& to) {
+  WorldSnapshotDiff diff;
+  const auto& from_objects = from.objects();
+  const auto& to_objects = to.objects();
+  size_t i = 0;
+  size_t j = 0;
+  while (i < from_objects.size() || j < to_objects.size()) {
+    if (j == to_objects.size()) {
+      diff.removed.emplace_back(from_objects.Get(i++)->id()->str());
+      continue;
+    }
+    if (i == from_objects.size()) {
+      diff.added.emplace_back(to_objects.Get(j++)->id()->str());
+      continue;
+    }
+    const SnapshotObject& a = *from_objects.Get(i);
+    const SnapshotObject& b = *to_objects.Get(j);
+    const absl::string_view a_id = ToStringView(a.id());
+    const absl::string_view b_id = ToStringView(b.id());
+    if (a_id < b_id) {
+      diff.removed.emplace_back(std::string(a_id));
+      ++i;
+    } else if (b_id < a_id) {
+      diff.added.emplace_back(std::string(b_id));
+      ++j;
+    } else {
+      if (!HaveEqualProtos(a, b)) {
+        diff.changed.emplace_back(std::string(a_id));
+      }
+      ++i;
+      ++j;
+    }
+  }
+  return diff;
+}
+
+}  // namespace world
+}  // namespace intrinsic
@@ -0,0 +1,150 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_WORLD_OBJECTS_WORLD_SNAPSHOT_H_
+#define INTRINSIC_WORLD_OBJECTS_WORLD_SNAPSHOT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "flatbuffers/detached_buffer.h"
+#include "intrinsic/world/objects/object_world_client.h"
+#include "intrinsic/world/objects/object_world_ids.h"
+#include "intrinsic/world/objects/world_object.h"
+#include "intrinsic/world/objects/world_snapshot_generated.h"
+
+namespace intrinsic {
+namespace world {
+
+// Binary snapshots of all objects of a world, for tools, simulators and test
+// fixtures that open large worlds without a round trip per object.
+//
+// A snapshot is a WorldSnapshot FlatBuffer (see world_snapshot.fbs), which is
+// read in place, e.g., from a file mapped into memory with WorldSnapshotFile:
+//
+//   INTR_ASSIGN_OR_RETURN(flatbuffers::DetachedBuffer snapshot,
+//                         ExportWorldSnapshot(world));
+//   INTR_RETURN_IF_ERROR(WriteWorldSnapshot(path, snapshot));
+//   ...
+//   INTR_ASSIGN_OR_RETURN(std::unique_ptr<WorldSnapshotFile> file,
+//                         WorldSnapshotFile::Open(path));
+//   INTR_ASSIGN_OR_RETURN(WorldObject robot,
+//                         file->view().GetObject(WorldObjectName("robot")));
+
+// Reads all objects of `world` with the full view and returns them as a
+// snapshot.
+absl::StatusOr<flatbuffers::DetachedBuffer> ExportWorldSnapshot(
+    const ObjectWorldClient& world);
+
+// Returns a snapshot of the given objects, e.g., to build a test fixture.
+//
+// Returns InvalidArgumentError if two objects have the same id or name.
+absl::StatusOr<flatbuffers::DetachedBuffer> BuildWorldSnapshot(
+    absl::string_view world_id, absl::Span<const WorldObject> objects);
+
+// Writes `snapshot` to the file at `path`, replacing it atomically.
+absl::Status WriteWorldSnapshot(absl::string_view path,
+                                const flatbuffers::DetachedBuffer& snapshot);
+
+// A read-only view of a snapshot, which does not own its bytes.
+//
+// Lookups by id and name are binary searches in the snapshot. Objects are
+// only parsed into WorldObjects when GetObject() or ListObjects() is called.
+class WorldSnapshotView {
+ public:
+  using SnapshotObject = ::intrinsic_fbs::world::SnapshotObject;
+
+  // Verifies `data` and returns a view of it. `data` must outlive the view.
+  //
+  // Returns InvalidArgumentError if `data` is not a valid snapshot.
+  static absl::StatusOr<WorldSnapshotView> Create(
+      absl::Span<const uint8_t> data);
+
+  absl::string_view world_id() const;
+
+  // Returns the number of objects.
+  size_t size() const { return snapshot_->objects()->size(); }
+
+  // Returns the objects, sorted by id.
+  const flatbuffers::Vector<flatbuffers::Offset<SnapshotObject>>& objects()
+      const {
+    return *snapshot_->objects();
+  }
+
+  // Returns the object with the given id or name, or nullptr if there is
+  // none.
+  const SnapshotObject* Find(const ObjectWorldResourceId& id) const;
+  const SnapshotObject* Find(const WorldObjectName& name) const;
+
+  // Returns the object with the given id or name.
+  //
+  // Returns NotFoundError if there is none.
+  absl::StatusOr<WorldObject> GetObject(const ObjectWorldResourceId& id) const;
+  absl::StatusOr<WorldObject> GetObject(const WorldObjectName& name) const;
+
+  // Returns all objects, sorted by id.
+  absl::StatusOr<std::vector<WorldObject>> ListObjects() const;
+
+  // Parses the given object of this snapshot.
+  absl::StatusOr<WorldObject> ToWorldObject(const SnapshotObject& object) const;
+
+ private:
+  explicit WorldSnapshotView(
+      const ::intrinsic_fbs::world::WorldSnapshot* snapshot)
+      : snapshot_(snapshot) {}
+
+  const ::intrinsic_fbs::world::WorldSnapshot* snapshot_;
+};
+
+// A snapshot file, mapped into memory read-only.
+class WorldSnapshotFile {
+ public:
+  // Maps the file at `path` and verifies it.
+  //
+  // Returns InvalidArgumentError if the file is not a valid snapshot.
+  static absl::StatusOr<std::unique_ptr<WorldSnapshotFile>> Open(
+      absl::string_view path);
+
+  ~WorldSnapshotFile();
+
+  WorldSnapshotFile(const WorldSnapshotFile&) = delete;
+  WorldSnapshotFile& operator=(const WorldSnapshotFile&) = delete;
+
+  const WorldSnapshotView& view() const { return view_; }
+
+ private:
+  WorldSnapshotFile(const void* data, size_t size, WorldSnapshotView view)
+      : data_(data), size_(size), view_(view) {}
+
+  const void* data_;
+  size_t size_;
+  WorldSnapshotView view_;
+};
+
+// The objects that differ between two snapshots, each sorted by id.
+struct WorldSnapshotDiff {
+  std::vector<ObjectWorldResourceId> added;
+  std::vector<ObjectWorldResourceId> removed;
+  // Objects whose proto differs, e.g., because they were moved or renamed.
+  std::vector<ObjectWorldResourceId> changed;
+
+  bool empty() const {
+    return added.empty() && removed.empty() && changed.empty();
+  }
+};
+
+// Returns the objects that were added, removed or changed from `from` to
+// `to`. Walks both snapshots once, and compares the bytes of objects with the
+// same id, without parsing them.
+WorldSnapshotDiff DiffWorldSnapshots(const WorldSnapshotView& from,
+                                     const WorldSnapshotView& to);
+
+}  // namespace world
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_WORLD_OBJECTS_WORLD_SNAPSHOT_H_
@@ -0,0 +1,227 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/world/objects/world_transform_tree.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "intrinsic/math/pose3.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/world/objects/frame.h"
+#include "intrinsic/world/objects/object_world_client.h"
+#include "intrinsic/world/objects/object_world_ids.h"
+#include "intrinsic/world/objects/transform_node.h"
+#include "intrinsic/world/objects/world_object.h"
+
+namespace intrinsic {
+namespace world {
+
+// static
+absl::StatusOr<std::unique_ptr<WorldTransformTree>> WorldTransformTree::Create(
+    const ObjectWorldClient& world) {
+  INTR_ASSIGN_OR_RETURN(std::vector<WorldObject> objects, world.ListObjects());
+  return Create(objects);
+}
+
+// static
+absl::StatusOr<std::unique_ptr<WorldTransformTree>> WorldTransformTree::Create(
+    absl::Span<const WorldObject> objects) {
+  auto tree = absl::WrapUnique(new WorldTransformTree());
+  absl::MutexLock lock(&tree->mutex_);
+  tree->nodes_[RootObjectId().value()].root_t_this = Pose3d::Identity();
+  std::vector<NodeUpdate> updates;
+  for (const WorldObject& object : objects) {
+    tree->nodes_[object.Id().value()].frame_ids =
+        AppendUpdates(object, updates);
+  }
+  INTR_RETURN_IF_ERROR(tree->ApplyUpdates(updates));
+  return tree;
+}
+
+absl::StatusOr<Pose3d> WorldTransformTree::GetTransform(
+    const TransformNode& node_a, const TransformNode& node_b) const {
+  return GetTransform(node_a.Id(), node_b.Id());
+}
+
+absl::StatusOr<Pose3d> WorldTransformTree::GetTransform(
+    const ObjectWorldResourceId& node_a,
+    const ObjectWorldResourceId& node_b) const {
+  absl::MutexLock lock(&mutex_);
+  INTR_ASSIGN_OR_RETURN(const Pose3d root_t_a, RootTNode(node_a.value()));
+  INTR_ASSIGN_OR_RETURN(const Pose3d root_t_b, RootTNode(node_b.value()));
+  return root_t_a.inverse() * root_t_b;
+}
+
+absl::Status WorldTransformTree::Update(const WorldObject& object) {
+  absl::MutexLock lock(&mutex_);
+  return UpdateLocked(object);
+}
+
+absl::Status WorldTransformTree::Refresh(
+    const ObjectWorldClient& world, const ObjectWorldResourceId& object_id) {
+  INTR_ASSIGN_OR_RETURN(WorldObject object, world.GetObject(object_id));
+  INTR_ASSIGN_OR_RETURN(std::vector<WorldObject> children,
+                        world.GetObjects(object.ChildIds()));
+
+  absl::MutexLock lock(&mutex_);
+  INTR_RETURN_IF_ERROR(UpdateLocked(object));
+  for (const WorldObject& child : children) {
+    INTR_RETURN_IF_ERROR(UpdateLocked(child));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status WorldTransformTree::UpdateLocked(const WorldObject& object) {
+  std::vector<NodeUpdate> updates;
+  std::vector<std::string> frame_ids = AppendUpdates(object, updates);
+  INTR_RETURN_IF_ERROR(ApplyUpdates(updates));
+
+  Node& node = nodes_[object.Id().value()];
+  const absl::flat_hash_set<std::string> kept_frame_ids(frame_ids.begin(),
+                                                        frame_ids.end());
+  std::vector<std::string> removed_frame_ids;
+  for (const std::string& frame_id : node.frame_ids) {
+    if (!kept_frame_ids.contains(frame_id)) {
+      removed_frame_ids.push_back(frame_id);
+    }
+  }
+  node.frame_ids = std::move(frame_ids);
+  for (const std::string& frame_id : removed_frame_ids) {
+    RemoveNode(frame_id);
+  }
+  return absl::OkStatus();
+}
+
+// static
+std::vector<std::string> WorldTransformTree::AppendUpdates(
+    const WorldObject& object, std::vector<NodeUpdate>& updates) {
+  if (object.Id() != RootObjectId()) {
+    updates.push_back({.id = object.Id().value(),
+                       .parent_id = object.ParentId().value(),
+                       .parent_t_this = object.ParentTThis()});
+  }
+  std::vector<std::string> frame_ids;
+  for (const Frame& frame : object.Frames()) {
+    updates.push_back({.id = frame.Id().value(),
+                       .parent_id = frame.ParentFrameId().has_value()
+                                        ? frame.ParentFrameId()->value()
+                                        : object.Id().value(),
+                       .parent_t_this = frame.ParentTThis()});
+    frame_ids.push_back(frame.Id().value());
+  }
+  return frame_ids;
+}
+
+absl::Status WorldTransformTree::ApplyUpdates(
+    absl::Span<const NodeUpdate> updates) {
+  absl::flat_hash_set<std::string> updated_ids;
+  for (const NodeUpdate& update : updates) {
+    updated_ids.insert(update.id);
+  }
+  for (const NodeUpdate& update : updates) {
+    if (!nodes_.contains(update.parent_id) &&
+        !updated_ids.contains(update.parent_id)) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("The parent \"", update.parent_id, "\" of \"",
+                       update.id, "\" is not in the transform tree."));
+    }
+  }
+
+  // Adds all new nodes first, since inserting into nodes_ moves its values.
+  for (const NodeUpdate& update : updates) {
+    nodes_.try_emplace(update.id);
+  }
+  for (const NodeUpdate& update : updates) {
+    Node& node = nodes_.find(update.id)->second;
+    if (node.parent_id != update.parent_id) {
+      Unlink(update.id, node.parent_id);
+      node.parent_id = update.parent_id;
+      nodes_.find(update.parent_id)->second.child_ids.push_back(update.id);
+    }
+    node.parent_t_this = update.parent_t_this;
+    Invalidate(update.id);
+  }
+  return absl::OkStatus();
+}
+
+void WorldTransformTree::RemoveNode(const std::string& id) {
+  auto it = nodes_.find(id);
+  if (it == nodes_.end()) {
+    return;
+  }
+  Unlink(id, it->second.parent_id);
+  nodes_.erase(it);
+}
+
+void WorldTransformTree::Unlink(const std::string& id,
+                                const std::string& parent_id) {
+  auto parent = nodes_.find(parent_id);
+  if (parent == nodes_.end()) {
+    return;
+  }
+  std::vector<std::string>& child_ids = parent->second.child_ids;
+  if (auto it = absl::c_find(child_ids, id); it != child_ids.end()) {
+    child_ids.erase(it);
+  }
+}
+
+void WorldTransformTree::Invalidate(const std::string& id) {
+  std::vector<const std::string*> pending = {&id};
+  while (!pending.empty()) {
+    auto it = nodes_.find(*pending.back());
+    pending.pop_back();
+    // Nodes below a node without a memoized pose have none either.
+    if (it == nodes_.end() || !it->second.root_t_this.has_value()) {
+      continue;
+    }
+    it->second.root_t_this.reset();
+    for (const std::string& child_id : it->second.child_ids) {
+      pending.push_back(&child_id);
+    }
+  }
+}
+
+absl::StatusOr<Pose3d> WorldTransformTree::RootTNode(
+    const std::string& id) const {
+  // Walks up to the first node with a memoized pose, which is at the latest
+  // the root object.
+  std::vector<const Node*> path;
+  const std::string* current_id = &id;
+  Pose3d root_t_node;
+  while (true) {
+    auto it = nodes_.find(*current_id);
+    if (it == nodes_.end()) {
+      return absl::NotFoundError(absl::StrCat(
+          "The node \"", *current_id, "\" is not in the transform tree."));
+    }
+    if (it->second.root_t_this.has_value()) {
+      root_t_node = *it->second.root_t_this;
+      break;
+    }
+    if (path.size() >= nodes_.size()) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          "The node \"", id, "\" is its own ancestor in the transform tree."));
+    }
+    path.push_back(&it->second);
+    current_id = &it->second.parent_id;
+  }
+  for (auto node = path.rbegin(); node != path.rend(); ++node) {
+    root_t_node = root_t_node * (*node)->parent_t_this;
+    (*node)->root_t_this = root_t_node;
+  }
+  return root_t_node;
+}
+
+}  // namespace world
+}  // namespace intrinsic
@@ -0,0 +1,137 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_WORLD_OBJECTS_WORLD_TRANSFORM_TREE_H_
+#define INTRINSIC_WORLD_OBJECTS_WORLD_TRANSFORM_TREE_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "intrinsic/math/pose3.h"
+#include "intrinsic/world/objects/object_world_client.h"
+#include "intrinsic/world/objects/object_world_ids.h"
+#include "intrinsic/world/objects/transform_node.h"
+#include "intrinsic/world/objects/world_object.h"
+
+namespace intrinsic {
+namespace world {
+
+// A local copy of the transform tree of a world, i.e., of the poses of all
+// objects and frames relative to their parents, which computes transforms
+// between them without requests to the world service.
+//
+// The pose of each node in the space of the root object is composed once and
+// memoized, so that a transform query takes two lookups once the paths of its
+// nodes are known. Updating a node only drops the memoized poses of the nodes
+// below it.
+//
+// The tree does not follow the remote world by itself. Call Refresh() after
+// the joint positions of a kinematic object, or the pose of an object, changed,
+// and create a new tree after larger changes.
+//
+// Thread safe.
+class WorldTransformTree {
+ public:
+  // Creates a tree of all objects and frames of the world of `world`, which
+  // takes a single request.
+  static absl::StatusOr<std::unique_ptr<WorldTransformTree>> Create(
+      const ObjectWorldClient& world);
+
+  // Creates a tree of the given objects and their frames. The objects must
+  // form a tree below the root object, which is added if it is missing.
+  //
+  // Returns InvalidArgumentError if an object or frame has an unknown parent.
+  static absl::StatusOr<std::unique_ptr<WorldTransformTree>> Create(
+      absl::Span<const WorldObject> objects);
+
+  WorldTransformTree(const WorldTransformTree&) = delete;
+  WorldTransformTree& operator=(const WorldTransformTree&) = delete;
+
+  // Returns the transform 'a_t_b', i.e., the pose of 'node_b' in the space of
+  // 'node_a'. Equivalent to ObjectWorldClient::GetTransform(node_a, node_b) on
+  // the world the tree was read from.
+  //
+  // Returns NotFoundError if either node is not in the tree, and
+  // FailedPreconditionError if updates from different versions of the world
+  // have made either node its own ancestor.
+  absl::StatusOr<Pose3d> GetTransform(const TransformNode& node_a,
+                                      const TransformNode& node_b) const;
+
+  // Returns the transform 'a_t_b' between the nodes with the given ids.
+  absl::StatusOr<Pose3d> GetTransform(
+      const ObjectWorldResourceId& node_a,
+      const ObjectWorldResourceId& node_b) const;
+
+  // Replaces the pose and the frames of `object` with the given local copy,
+  // which may also have a different parent.
+  //
+  // Returns InvalidArgumentError, and leaves the tree unchanged, if the object
+  // or one of its frames would get an unknown parent.
+  absl::Status Update(const WorldObject& object);
+
+  // Re-reads the object with the given id and its child objects from `world`,
+  // and updates them as by Update(). Call this after the joint positions of a
+  // kinematic object changed, since those move the frames and child objects
+  // attached to its moving parts.
+  absl::Status Refresh(const ObjectWorldClient& world,
+                       const ObjectWorldResourceId& object_id);
+
+ private:
+  struct Node {
+    // Empty for the root object.
+    std::string parent_id;
+    Pose3d parent_t_this;
+    std::vector<std::string> child_ids;
+    // Ids of all frames under an object. Empty for frames.
+    std::vector<std::string> frame_ids;
+    // Memoized pose in the space of the root object.
+    mutable std::optional<Pose3d> root_t_this;
+  };
+
+  // The parent and pose of a node to be added or updated.
+  struct NodeUpdate {
+    std::string id;
+    std::string parent_id;
+    Pose3d parent_t_this;
+  };
+
+  WorldTransformTree() = default;
+
+  // Appends the updates of `object` and its frames to `updates`, and returns
+  // the ids of the frames.
+  static std::vector<std::string> AppendUpdates(
+      const WorldObject& object, std::vector<NodeUpdate>& updates);
+  // Updates `object` and its frames, and removes its frames that are gone.
+  absl::Status UpdateLocked(const WorldObject& object)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Sets the parents and poses of the given nodes, and adds the new ones. Fails
+  // without changes if a parent is neither in the tree nor in `updates`.
+  absl::Status ApplyUpdates(absl::Span<const NodeUpdate> updates)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Removes the node `id` from the tree.
+  void RemoveNode(const std::string& id) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Removes `id` from the children of `parent_id`.
+  void Unlink(const std::string& id, const std::string& parent_id)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Drops the memoized poses of `id` and of all nodes below it.
+  void Invalidate(const std::string& id) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Returns the pose of the node `id` in the space of the root object, and
+  // memoizes it along the path to the root.
+  absl::StatusOr<Pose3d> RootTNode(const std::string& id) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, Node> nodes_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace world
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_WORLD_OBJECTS_WORLD_TRANSFORM_TREE_H_
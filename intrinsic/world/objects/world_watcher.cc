@@ -0,0 +1,151 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/world/objects/world_watcher.h"
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "google/protobuf/util/message_differencer.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/util/thread/thread.h"
+#include "intrinsic/world/objects/object_world_ids.h"
+#include "intrinsic/world/objects/world_object.h"
+
+namespace intrinsic {
+namespace world {
+
+// static
+absl::StatusOr<std::unique_ptr<WorldWatcher>> WorldWatcher::Create(
+    absl::Duration period, VersionFn version, ListFn list,
+    ChangeCallback callback) {
+  if (period <= absl::ZeroDuration()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Period must be positive, got ", absl::FormatDuration(period)));
+  }
+  INTR_ASSIGN_OR_RETURN(std::string initial_version, version());
+  INTR_ASSIGN_OR_RETURN(std::vector<WorldObject> objects, list());
+  // Private constructor, so no make_unique.
+  auto watcher = absl::WrapUnique(new WorldWatcher(
+      period, std::move(version), std::move(list), std::move(callback)));
+  watcher->last_version_ = std::move(initial_version);
+  watcher->Update(std::move(objects));
+  // Start the thread only once the mirror is initialized.
+  watcher->thread_ = Thread(&WorldWatcher::Run, watcher.get());
+  return watcher;
+}
+
+WorldWatcher::WorldWatcher(absl::Duration period, VersionFn version,
+                           ListFn list, ChangeCallback callback)
+    : period_(period),
+      version_(std::move(version)),
+      list_(std::move(list)),
+      callback_(std::move(callback)) {}
+
+WorldWatcher::~WorldWatcher() {
+  stop_.Notify();
+  if (thread_.Joinable()) {
+    thread_.Join();
+  }
+}
+
+std::vector<WorldObject> WorldWatcher::Objects() const {
+  absl::MutexLock lock(&mutex_);
+  std::vector<WorldObject> objects;
+  objects.reserve(objects_.size());
+  for (const auto& [id, object] : objects_) {
+    objects.push_back(object);
+  }
+  return objects;
+}
+
+std::optional<WorldObject> WorldWatcher::GetObject(
+    const ObjectWorldResourceId& id) const {
+  absl::MutexLock lock(&mutex_);
+  if (auto it = objects_.find(id); it != objects_.end()) {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
+std::vector<WorldObjectChange> WorldWatcher::Update(
+    std::vector<WorldObject> objects) {
+  absl::flat_hash_map<ObjectWorldResourceId, WorldObject> new_objects;
+  new_objects.reserve(objects.size());
+  for (WorldObject& object : objects) {
+    ObjectWorldResourceId id = object.Id();
+    new_objects.insert_or_assign(std::move(id), std::move(object));
+  }
+
+  std::vector<WorldObjectChange> changes;
+  absl::MutexLock lock(&mutex_);
+  for (const auto& [id, object] : new_objects) {
+    auto it = objects_.find(id);
+    if (it == objects_.end()) {
+      changes.push_back({.type = WorldObjectChange::Type::kAdded,
+                         .id = id,
+                         .object = object});
+    } else if (!google::protobuf::util::MessageDifferencer::Equals(
+                   it->second.Proto(), object.Proto())) {
+      changes.push_back({.type = WorldObjectChange::Type::kUpdated,
+                         .id = id,
+                         .object = object});
+    }
+  }
+  for (const auto& [id, object] : objects_) {
+    if (!new_objects.contains(id)) {
+      changes.push_back({.type = WorldObjectChange::Type::kRemoved, .id = id});
+    }
+  }
+  objects_ = std::move(new_objects);
+  return changes;
+}
+
+void WorldWatcher::Run() {
+  absl::Time next_check = absl::Now();
+  while (true) {
+    next_check += period_;
+    if (stop_.WaitForNotificationWithDeadline(next_check)) {
+      break;
+    }
+    // Don't try to catch up on checks that were missed because the server was
+    // slow.
+    next_check = std::max(next_check, absl::Now() - period_);
+
+    absl::StatusOr<std::string> version = version_();
+    if (!version.ok()) {
+      LOG_EVERY_N_SEC(WARNING, 10)
+          << "Failed to check the world version: " << version.status();
+      continue;
+    }
+    if (*version == last_version_) {
+      continue;
+    }
+    absl::StatusOr<std::vector<WorldObject>> objects = list_();
+    if (!objects.ok()) {
+      LOG_EVERY_N_SEC(WARNING, 10)
+          << "Failed to list the world objects: " << objects.status();
+      continue;
+    }
+    last_version_ = *std::move(version);
+    std::vector<WorldObjectChange> changes = Update(*std::move(objects));
+    if (!changes.empty()) {
+      callback_(changes);
+    }
+  }
+}
+
+}  // namespace world
+}  // namespace intrinsic
@@ -0,0 +1,109 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_WORLD_OBJECTS_WORLD_WATCHER_H_
+#define INTRINSIC_WORLD_OBJECTS_WORLD_WATCHER_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "intrinsic/util/thread/thread.h"
+#include "intrinsic/world/objects/object_world_ids.h"
+#include "intrinsic/world/objects/world_object.h"
+
+namespace intrinsic {
+namespace world {
+
+// A change of a single object, which includes changes of its pose, its frames
+// and, for kinematic objects, its joint positions.
+struct WorldObjectChange {
+  enum class Type { kAdded, kUpdated, kRemoved };
+
+  Type type;
+  ObjectWorldResourceId id;
+  // The object after the change. Unset for kRemoved.
+  std::optional<WorldObject> object;
+};
+
+// Keeps a local mirror of all objects of a world, and reports the objects that
+// changed.
+//
+// A single thread checks the version of the world once per `period`, which is
+// a small request, and only lists the objects again after the world changed.
+// The listed objects are compared with the mirror, and the callback is called
+// once with all objects that were added, updated or removed.
+//
+// Obtain a WorldWatcher from ObjectWorldClient::Watch(). Destroying the
+// watcher waits for an outstanding check and callback to finish.
+class WorldWatcher {
+ public:
+  // Returns a string that changes whenever the world is updated.
+  using VersionFn = absl::AnyInvocable<absl::StatusOr<std::string>()>;
+  // Lists the full views of all objects of the world.
+  using ListFn =
+      absl::AnyInvocable<absl::StatusOr<std::vector<WorldObject>>()>;
+  // Called on the thread of the watcher. Must not block for long, since that
+  // delays the next check.
+  using ChangeCallback =
+      absl::AnyInvocable<void(absl::Span<const WorldObjectChange>)>;
+
+  // Reads all objects with `list` into the mirror, then starts checking the
+  // version with `version` every `period`, and calls `callback` with the
+  // objects that changed since. Failed checks are skipped.
+  //
+  // Returns InvalidArgumentError if `period` is not positive, and the error of
+  // `version` or `list` if the initial read fails.
+  static absl::StatusOr<std::unique_ptr<WorldWatcher>> Create(
+      absl::Duration period, VersionFn version, ListFn list,
+      ChangeCallback callback);
+
+  ~WorldWatcher();
+
+  WorldWatcher(const WorldWatcher&) = delete;
+  WorldWatcher& operator=(const WorldWatcher&) = delete;
+
+  // Returns local copies of all objects in the mirror.
+  std::vector<WorldObject> Objects() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns a local copy of the object with the given id, or nullopt if the
+  // mirror has no such object.
+  std::optional<WorldObject> GetObject(const ObjectWorldResourceId& id) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  WorldWatcher(absl::Duration period, VersionFn version, ListFn list,
+               ChangeCallback callback);
+
+  // Replaces the mirror with `objects`, and returns the changes.
+  std::vector<WorldObjectChange> Update(std::vector<WorldObject> objects)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  void Run();
+
+  const absl::Duration period_;
+  VersionFn version_;
+  ListFn list_;
+  ChangeCallback callback_;
+  // Only accessed by the thread after Create().
+  std::string last_version_;
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<ObjectWorldResourceId, WorldObject> objects_
+      ABSL_GUARDED_BY(mutex_);
+
+  absl::Notification stop_;
+  Thread thread_;
+};
+
+}  // namespace world
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_WORLD_OBJECTS_WORLD_WATCHER_H_
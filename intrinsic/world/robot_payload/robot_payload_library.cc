@@ -0,0 +1,62 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#include "intrinsic/world/robot_payload/robot_payload_library.h"
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "intrinsic/eigenmath/types.h"
+#include "intrinsic/util/status/status_macros.h"
+#include "intrinsic/world/proto/robot_payload.pb.h"
+#include "intrinsic/world/robot_payload/robot_payload.h"
+#include "intrinsic/world/robot_payload/robot_payload_base.h"
+
+namespace intrinsic {
+
+eigenmath::Matrix3d TipInertia(const RobotPayloadBase& payload) {
+  const eigenmath::Matrix3d rotation = payload.tip_t_cog().rotationMatrix();
+  const eigenmath::Vector3d& offset = payload.tip_t_cog().translation();
+  // Rotates the inertia into the tip frame and shifts it to the tip frame
+  // origin with the parallel axis theorem.
+  return rotation * payload.inertia() * rotation.transpose() +
+         payload.mass() *
+             (offset.squaredNorm() * eigenmath::Matrix3d::Identity() -
+              offset * offset.transpose());
+}
+
+PrecomputedRobotPayload::PrecomputedRobotPayload(const RobotPayload& payload)
+    : payload_(payload),
+      tip_inertia_(TipInertia(payload)),
+      proto_(ToProto(payload)) {}
+
+absl::Status RobotPayloadLibrary::Add(absl::string_view name,
+                                      const RobotPayload& payload) {
+  if (payloads_.contains(name)) {
+    return absl::AlreadyExistsError(
+        absl::StrCat("The payload library already contains a payload \"",
+                     name, "\"."));
+  }
+  payloads_.try_emplace(name, payload);
+  return absl::OkStatus();
+}
+
+absl::Status RobotPayloadLibrary::Add(
+    absl::string_view name, const intrinsic_proto::world::RobotPayload& proto) {
+  INTR_ASSIGN_OR_RETURN(RobotPayload payload, FromProto(proto));
+  return Add(name, payload);
+}
+
+absl::StatusOr<const PrecomputedRobotPayload*> RobotPayloadLibrary::Get(
+    absl::string_view name) const {
+  auto it = payloads_.find(name);
+  if (it == payloads_.end()) {
+    return absl::NotFoundError(absl::StrCat(
+        "The payload library does not contain a payload \"", name, "\"."));
+  }
+  return &it->second;
+}
+
+}  // namespace intrinsic
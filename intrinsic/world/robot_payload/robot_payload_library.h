@@ -0,0 +1,80 @@
+// Copyright 2023 Intrinsic Innovation LLC
+
+#ifndef INTRINSIC_WORLD_ROBOT_PAYLOAD_ROBOT_PAYLOAD_LIBRARY_H_
+#define INTRINSIC_WORLD_ROBOT_PAYLOAD_ROBOT_PAYLOAD_LIBRARY_H_
+
+#include <cstddef>
+#include <string>
+
+#include "absl/container/node_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "intrinsic/eigenmath/types.h"
+#include "intrinsic/world/proto/robot_payload.pb.h"
+#include "intrinsic/world/robot_payload/robot_payload.h"
+#include "intrinsic/world/robot_payload/robot_payload_base.h"
+
+namespace intrinsic {
+
+// Returns the inertia of `payload` about the origin of the robot flange/tip
+// frame, expressed in the tip frame. Unit is kg*m^2.
+eigenmath::Matrix3d TipInertia(const RobotPayloadBase& payload);
+
+// A robot payload together with the values derived from it, which are
+// computed once on construction instead of whenever the payload is applied.
+class PrecomputedRobotPayload {
+ public:
+  explicit PrecomputedRobotPayload(const RobotPayload& payload);
+
+  const RobotPayload& payload() const { return payload_; }
+
+  // See TipInertia().
+  const eigenmath::Matrix3d& tip_inertia() const { return tip_inertia_; }
+
+  // The payload as a proto, e.g., for updates of the world.
+  const intrinsic_proto::world::RobotPayload& proto() const { return proto_; }
+
+ private:
+  RobotPayload payload_;
+  eigenmath::Matrix3d tip_inertia_;
+  intrinsic_proto::world::RobotPayload proto_;
+};
+
+// A set of named robot payloads, e.g., of the objects a gripper picks, which
+// are precomputed when added, so that switching between them does not convert
+// or transform anything.
+//
+// Not thread safe.
+class RobotPayloadLibrary {
+ public:
+  RobotPayloadLibrary() = default;
+
+  RobotPayloadLibrary(const RobotPayloadLibrary&) = delete;
+  RobotPayloadLibrary& operator=(const RobotPayloadLibrary&) = delete;
+
+  // Adds `payload` under `name`.
+  //
+  // Returns AlreadyExistsError if the library contains a payload of that
+  // name.
+  absl::Status Add(absl::string_view name, const RobotPayload& payload);
+
+  // Adds the payload of `proto` under `name`. Fails as FromProto() and Add().
+  absl::Status Add(absl::string_view name,
+                   const intrinsic_proto::world::RobotPayload& proto);
+
+  // Returns the payload of the given name, which stays valid as long as the
+  // library, or NotFoundError.
+  absl::StatusOr<const PrecomputedRobotPayload*> Get(
+      absl::string_view name) const;
+
+  // Returns the number of payloads.
+  size_t size() const { return payloads_.size(); }
+
+ private:
+  absl::node_hash_map<std::string, PrecomputedRobotPayload> payloads_;
+};
+
+}  // namespace intrinsic
+
+#endif  // INTRINSIC_WORLD_ROBOT_PAYLOAD_ROBOT_PAYLOAD_LIBRARY_H_